@@ -183,7 +183,7 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
         if (isHashable()) {
             out.println("////////////////////////////////////////////////////////////////////////////////");
             out.println("int " + getClassName() + "::getHashCode() const {");
-            out.println("    return decaf::util::HashCode<std::string>()(this->toString());");
+            generateHashCodeBody(out);
             out.println("}");
             out.println("");
         }
@@ -466,12 +466,20 @@ public class CommandSourceGenerator extends CommandCodeGenerator {
             }
             out.println("////////////////////////////////////////////////////////////////////////////////");
             out.println("void " + getClassName() + "::" + setter+"(" + constNess + type+ " " + parameterName +") {");
-            out.println("    this->"+parameterName+" = "+parameterName+";");
+            generateSetterBody(out, property, parameterName);
             out.println("}");
             out.println("");
         }
     }
 
+    protected void generateSetterBody( PrintWriter out, JProperty property, String parameterName ) {
+        out.println("    this->"+parameterName+" = "+parameterName+";");
+    }
+
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("    return decaf::util::HashCode<std::string>()(this->toString());");
+    }
+
     protected void generateCompareToBody( PrintWriter out ) {
         for( JProperty property : getProperties() ) {
 
@@ -58,17 +58,16 @@ public class ConsumerIdSourceGenerator extends CommandSourceGenerator {
         super.populateIncludeFilesSet();
 
         Set<String> includes = getIncludeFiles();
+        includes.add("<activemq/commands/IdSupport.h>");
         includes.add("<sstream>");
     }
 
     protected void generateToStringBody( PrintWriter out ) {
-        out.println("    ostringstream stream;" );
+        out.println("    std::string result;");
+        out.println("    result.reserve(this->connectionId.length() + 42);");
+        out.println("    IdSupport::appendId(result, this->connectionId, this->sessionId, this->value);");
         out.println("");
-        out.println("    stream << this->connectionId << \":\"");
-        out.println("           << this->sessionId << \":\"");
-        out.println("           << this->value;");
-        out.println("");
-        out.println("    return stream.str();");
+        out.println("    return result;");
     }
 
 }
@@ -52,7 +52,15 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("");
         out.println("        // Message properties, these are Marshaled and Unmarshaled from the Message");
         out.println("        // Command's marshaledProperties vector.");
-        out.println("        activemq::util::PrimitiveMap properties;");
+        out.println("        mutable activemq::util::PrimitiveMap properties;");
+        out.println("");
+        out.println("        // Indicates that the marshaledProperties of a received Message have not yet");
+        out.println("        // been unmarshaled into the properties map, that waits until they are used.");
+        out.println("        mutable bool propertiesUnmarshalPending;");
+        out.println("");
+        out.println("        // Indicates that the properties of a received Message haven't been changed so");
+        out.println("        // its marshaledProperties can be sent on again as they are.");
+        out.println("        bool propertiesUnchanged;");
         out.println("");
         out.println("        // Indicates if the Message Properties are Read Only");
         out.println("        bool readOnlyProperties;");
@@ -165,18 +173,37 @@ public class MessageHeaderGenerator extends CommandHeaderGenerator {
         out.println("");
         out.println("        /**");
         out.println("         * Gets a reference to the Message's Properties object, allows the derived");
-        out.println("         * classes to get and set their own specific properties.");
+        out.println("         * classes to get and set their own specific properties.  Since the properties");
+        out.println("         * may be changed through the returned reference they are marshaled again when");
+        out.println("         * the Message is next sent, read only callers should use the const version.");
         out.println("         *");
         out.println("         * @return a reference to the Primitive Map that holds message properties.");
         out.println("         */");
         out.println("        util::PrimitiveMap& getMessageProperties() {");
+        out.println("            if (this->propertiesUnmarshalPending) {");
+        out.println("                unmarshalProperties();");
+        out.println("            }");
+        out.println("            this->propertiesUnchanged = false;");
         out.println("            return this->properties;");
         out.println("        }");
         out.println("        const util::PrimitiveMap& getMessageProperties() const {");
+        out.println("            if (this->propertiesUnmarshalPending) {");
+        out.println("                unmarshalProperties();");
+        out.println("            }");
         out.println("            return this->properties;");
         out.println("        }");
         out.println("");
         out.println("        /**");
+        out.println("         * Unmarshals the marshaled properties of a received Message into the properties");
+        out.println("         * map if that has not been done yet, does nothing otherwise.  Received Messages");
+        out.println("         * put this off until the properties are first accessed so that a Message whose");
+        out.println("         * properties are never read doesn't pay for decoding them.");
+        out.println("         *");
+        out.println("         * @throws IOException if the marshaled properties can't be read.");
+        out.println("         */");
+        out.println("        void unmarshalProperties() const;");
+        out.println("");
+        out.println("        /**");
         out.println("         * Returns if the Message Properties Are Read Only");
         out.println("         * @return true if Message Properties are Read Only.");
         out.println("         */");
@@ -19,6 +19,8 @@ package org.apache.activemq.openwire.tool.commands;
 import java.io.PrintWriter;
 import java.util.Set;
 
+import org.codehaus.jam.JProperty;
+
 public class MessageIdSourceGenerator extends CommandSourceGenerator {
 
     protected void generateAdditionalConstructors( PrintWriter out ) {
@@ -66,18 +68,12 @@ public class MessageIdSourceGenerator extends CommandSourceGenerator {
         out.println("////////////////////////////////////////////////////////////////////////////////");
         out.println("void MessageId::setValue(const std::string& key) {");
         out.println("");
-        out.println("    std::string messageKey = key;");
-        out.println("");
         out.println("    // Parse off the sequenceId");
-        out.println("    std::size_t p = messageKey.rfind( ':' );");
-        out.println("");
-        out.println("    if (p != std::string::npos) {");
-        out.println("        producerSequenceId = Long::parseLong(messageKey.substr(p + 1, std::string::npos));");
-        out.println("        messageKey = messageKey.substr(0, p);");
-        out.println("    }");
+        out.println("    std::size_t p = IdSupport::parseLastNumber(key, key.length(), this->producerSequenceId);");
         out.println("");
-        out.println("    this->producerId.reset(new ProducerId(messageKey));");
-        out.println("    this->key = messageKey;");
+        out.println("    // The rest names the producer, the one parsed last on this thread is shared.");
+        out.println("    this->producerId = IdSupport::parseProducerId(key, p != std::string::npos ? p : key.length());");
+        out.println("    this->key = \"\";");
         out.println("}");
         out.println("");
 
@@ -89,10 +85,36 @@ public class MessageIdSourceGenerator extends CommandSourceGenerator {
         super.populateIncludeFilesSet();
 
         Set<String> includes = getIncludeFiles();
+        includes.add("<activemq/commands/IdSupport.h>");
         includes.add("<decaf/lang/Long.h>");
         includes.add("<sstream>");
     }
 
+    protected void generateSetterBody( PrintWriter out, JProperty property, String parameterName ) {
+        super.generateSetterBody(out, property, parameterName);
+
+        // The cached string form is built from these fields.
+        if( parameterName.equals("textView") ||
+            parameterName.equals("producerId") ||
+            parameterName.equals("producerSequenceId") ) {
+            out.println("    this->key = \"\";");
+        }
+    }
+
+    protected void generateHashCodeBody( PrintWriter out ) {
+        out.println("");
+        out.println("    // Hashes the fields that equals compares so no string has to be formatted.");
+        out.println("    int result = 0;");
+        out.println("    if (!this->textView.empty()) {");
+        out.println("        result = decaf::util::HashCode<std::string>()(this->textView);");
+        out.println("    }");
+        out.println("    if (this->producerId != NULL) {");
+        out.println("        result = 31 * result + this->producerId->getHashCode();");
+        out.println("    }");
+        out.println("    result = 31 * result + (int) (this->producerSequenceId ^ (long long) ((unsigned long long) this->producerSequenceId >> 32));");
+        out.println("    return result;");
+    }
+
     protected void generateToStringBody( PrintWriter out ) {
         out.println("    if (key.empty()) {");
         out.println("        if (!textView.empty()) {");
@@ -102,8 +124,11 @@ public class MessageIdSourceGenerator extends CommandSourceGenerator {
         out.println("                key = \"ID:\" + textView;");
         out.println("            }");
         out.println("        } else {");
-        out.println("            this->key = this->producerId->toString() + \":\" + ");
-        out.println("                        Long::toString(this->producerSequenceId);");
+        out.println("            this->key.reserve(this->producerId->getConnectionId().length() + 64);");
+        out.println("            IdSupport::appendId(this->key, this->producerId->getConnectionId(),");
+        out.println("                                this->producerId->getSessionId(), this->producerId->getValue());");
+        out.println("            this->key.append(1, ':');");
+        out.println("            IdSupport::appendNumber(this->key, this->producerSequenceId);");
         out.println("        }");
         out.println("    }");
         out.println("");
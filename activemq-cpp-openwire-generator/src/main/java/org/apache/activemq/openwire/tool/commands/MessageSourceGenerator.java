@@ -37,6 +37,8 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         result.append(super.generateInitializerList());
         result.append(", ackHandler(NULL)");
         result.append(", properties()");
+        result.append(", propertiesUnmarshalPending(false)");
+        result.append(", propertiesUnchanged(false)");
         result.append(", readOnlyProperties(false)");
         result.append(", readOnlyBody(false)");
         result.append(", connection(NULL)");
@@ -48,6 +50,8 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         super.generateCopyDataStructureBody(out);
 
         out.println("    this->properties.copy(srcPtr->properties);");
+        out.println("    this->propertiesUnmarshalPending = srcPtr->propertiesUnmarshalPending;");
+        out.println("    this->propertiesUnchanged = srcPtr->propertiesUnchanged;");
         out.println("    this->setAckHandler(srcPtr->getAckHandler());");
         out.println("    this->setReadOnlyBody(srcPtr->isReadOnlyBody());");
         out.println("    this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());");
@@ -65,7 +69,7 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("        return false;");
         out.println("    }");
         out.println("");
-        out.println("    if (!properties.equals(valuePtr->properties)) {");
+        out.println("    if (!getMessageProperties().equals(valuePtr->getMessageProperties())) {");
         out.println("        return false;");
         out.println("    }");
         out.println("");
@@ -112,6 +116,13 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {");
         out.println("");
         out.println("    try {");
+        out.println("");
+        out.println("        // Properties that haven't changed since they were received are sent on in");
+        out.println("        // the marshaled form they arrived in.");
+        out.println("        if (propertiesUnchanged) {");
+        out.println("            return;");
+        out.println("        }");
+        out.println("");
         out.println("        marshalledProperties.clear();");
         out.println("        if (!properties.isEmpty()) {");
         out.println("            wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(");
@@ -126,9 +137,22 @@ public class MessageSourceGenerator extends CommandSourceGenerator {
         out.println("////////////////////////////////////////////////////////////////////////////////");
         out.println("void Message::afterUnmarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {");
         out.println("");
+        out.println("    // The properties are unmarshaled on first use, see unmarshalProperties.");
+        out.println("    propertiesUnmarshalPending = !marshalledProperties.empty();");
+        out.println("    propertiesUnchanged = true;");
+        out.println("}");
+        out.println("");
+        out.println("////////////////////////////////////////////////////////////////////////////////");
+        out.println("void Message::unmarshalProperties() const {");
+        out.println("");
+        out.println("    if (!propertiesUnmarshalPending) {");
+        out.println("        return;");
+        out.println("    }");
+        out.println("");
         out.println("    try {");
         out.println("        wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(");
         out.println("            &properties, marshalledProperties);");
+        out.println("        propertiesUnmarshalPending = false;");
         out.println("    }");
         out.println("    AMQ_CATCH_RETHROW(decaf::io::IOException)");
         out.println("    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)");
@@ -37,11 +37,10 @@ public class ProducerIdSourceGenerator extends CommandSourceGenerator {
         out.println("    " + generateInitializerList() + " {");
         out.println("");
         out.println("    // Parse off the producerId");
-        out.println("    std::size_t p = producerKey.rfind( ':' );");
+        out.println("    std::size_t p = IdSupport::parseLastNumber(producerKey, producerKey.length(), this->value);");
         out.println("");
         out.println("    if (p != std::string::npos) {");
-        out.println("        value = Long::parseLong(producerKey.substr(p + 1, std::string::npos));");
-        out.println("        producerKey = producerKey.substr(0, p);");
+        out.println("        producerKey.erase(p);");
         out.println("    }");
         out.println("");
         out.println("    setProducerSessionKey(producerKey);");
@@ -68,15 +67,10 @@ public class ProducerIdSourceGenerator extends CommandSourceGenerator {
         out.println("void ProducerId::setProducerSessionKey( std::string sessionKey ) {");
         out.println("");
         out.println("    // Parse off the value");
-        out.println("    std::size_t p = sessionKey.rfind( ':' );");
-        out.println("");
-        out.println("    if (p != std::string::npos) {");
-        out.println("        this->sessionId = Long::parseLong(sessionKey.substr(p + 1, std::string::npos));");
-        out.println("        sessionKey = sessionKey.substr(0, p);");
-        out.println("    }");
+        out.println("    std::size_t p = IdSupport::parseLastNumber(sessionKey, sessionKey.length(), this->sessionId);");
         out.println("");
         out.println("    // The rest is the value");
-        out.println("    this->connectionId = sessionKey;");
+        out.println("    this->connectionId.assign(sessionKey, 0, p != std::string::npos ? p : sessionKey.length());");
         out.println("}");
 
         super.generateAdditionalMethods(out);
@@ -87,17 +81,25 @@ public class ProducerIdSourceGenerator extends CommandSourceGenerator {
         super.populateIncludeFilesSet();
 
         Set<String> includes = getIncludeFiles();
+        includes.add("<activemq/commands/IdSupport.h>");
         includes.add("<decaf/lang/Long.h>");
         includes.add("<sstream>");
     }
 
     protected void generateToStringBody( PrintWriter out ) {
-        out.println("    ostringstream stream;" );
+        out.println("    std::string result;");
+        out.println("    result.reserve(this->connectionId.length() + 42);");
+        out.println("    IdSupport::appendId(result, this->connectionId, this->sessionId, this->value);");
         out.println("");
-        out.println("    stream << this->connectionId << \":\"");
-        out.println("           << this->sessionId << \":\"");
-        out.println("           << this->value;");
+        out.println("    return result;");
+    }
+
+    protected void generateHashCodeBody( PrintWriter out ) {
         out.println("");
-        out.println("    return stream.str();");
+        out.println("    // Hashes the fields that equals compares so no string has to be formatted.");
+        out.println("    int result = decaf::util::HashCode<std::string>()(this->connectionId);");
+        out.println("    result = 31 * result + (int) (this->sessionId ^ (long long) ((unsigned long long) this->sessionId >> 32));");
+        out.println("    result = 31 * result + (int) (this->value ^ (long long) ((unsigned long long) this->value >> 32));");
+        out.println("    return result;");
     }
 }
@@ -171,14 +171,15 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
             out.println(indent + "info->" + setter + "(tightUnmarshalLong(wireFormat, dataIn, bs));");
         }
         else if( type.equals("String") ) {
-            out.println(indent + "info->" + setter + "(tightUnmarshalString(dataIn, bs));");
+            out.println(indent + "info->" + setter + "(tightUnmarshalString(wireFormat, dataIn, bs));");
         }
         else if( type.equals("byte[]") || type.equals("ByteSequence") ) {
             if( size != null ) {
                 out.println(indent + "info->" + setter + "(tightUnmarshalConstByteArray(dataIn, bs, "+ size.asInt() +"));");
             }
             else {
-                out.println(indent + "info->" + setter + "(tightUnmarshalByteArray(dataIn, bs));");
+                String getter = property.getGetter().getSimpleName();
+                out.println(indent + "tightUnmarshalByteArray(dataIn, bs, info->" + getter + "());");
             }
         }
         else if( isThrowable( property.getType() ) ) {
@@ -432,14 +433,15 @@ public class AmqCppMarshallingClassesGenerator extends AmqCppMarshallingHeadersG
             out.println(indent + "info->" + setter + "(looseUnmarshalLong(wireFormat, dataIn));");
         }
         else if (type.equals("String")) {
-            out.println(indent + "info->" + setter + "(looseUnmarshalString(dataIn));");
+            out.println(indent + "info->" + setter + "(looseUnmarshalString(wireFormat, dataIn));");
         }
         else if (type.equals("byte[]") || type.equals("ByteSequence")) {
             if (size != null) {
                 out.println(indent + "info->" + setter + "(looseUnmarshalConstByteArray(dataIn, " + size.asInt() + "));");
             }
             else {
-                out.println(indent + "info->" + setter + "(looseUnmarshalByteArray(dataIn));");
+                String getter = property.getGetter().getSimpleName();
+                out.println(indent + "looseUnmarshalByteArray(dataIn, info->" + getter + "());");
             }
         }
         else if (isThrowable(property.getType())) {
@@ -623,7 +625,7 @@ out.println("");
 
         String properClassName = getProperClassName( jclass.getSimpleName() );
 out.println("        "+properClassName+"* info =");
-out.println("            dynamic_cast<"+properClassName+"*>(dataStructure);");
+out.println("            static_cast<"+properClassName+"*>(dataStructure);");
     }
 
     if( marshallerAware ) {
@@ -659,7 +661,7 @@ out.println("");
     if( checkNeedsInfoPointerTM1() ) {
         String properClassName = getProperClassName( jclass.getSimpleName() );
 out.println("        "+properClassName+"* info =");
-out.println("            dynamic_cast<"+properClassName+"*>(dataStructure);");
+out.println("            static_cast<"+properClassName+"*>(dataStructure);");
 out.println("");
     }
 
@@ -696,7 +698,7 @@ out.println("");
     if( checkNeedsInfoPointerTM2() ) {
         String properClassName = getProperClassName( jclass.getSimpleName() );
 out.println("        "+properClassName+"* info =");
-out.println("            dynamic_cast<"+properClassName+"*>(dataStructure);");
+out.println("            static_cast<"+properClassName+"*>(dataStructure);");
     }
 
     if( checkNeedsWireFormatVersion() ) {
@@ -727,7 +729,7 @@ out.println("        "+baseClass+"::looseUnmarshal(wireFormat, dataStructure, da
     if( !properties.isEmpty() || marshallerAware ) {
         String properClassName = getProperClassName( jclass.getSimpleName() );
 out.println("        "+properClassName+"* info =");
-out.println("            dynamic_cast<"+properClassName+"*>(dataStructure);");
+out.println("            static_cast<"+properClassName+"*>(dataStructure);");
     }
 
     if( marshallerAware ) {
@@ -761,7 +763,7 @@ out.println("");
     if( !properties.isEmpty() || marshallerAware ) {
         String properClassName = getProperClassName( jclass.getSimpleName() );
 out.println("        "+properClassName+"* info =");
-out.println("            dynamic_cast<"+properClassName+"*>(dataStructure);");
+out.println("            static_cast<"+properClassName+"*>(dataStructure);");
     }
 
     if( marshallerAware ) {
@@ -824,11 +826,11 @@ out.println("using namespace activemq::wireformat::openwire::marshal;");
 out.println("using namespace activemq::wireformat::openwire::marshal::generated;");
 out.println("");
 out.println("///////////////////////////////////////////////////////////////////////////////");
-out.println("void MarshallerFactory::configure(OpenWireFormat* format) {");
+out.println("void MarshallerFactory::configure(MarshallerTable* table) {");
 out.println("");
 
         for ( JClass jclass : list ) {
-out.println("    format->addMarshaller(new "+jclass.getSimpleName()+"Marshaller());");
+out.println("    table->add(new "+jclass.getSimpleName()+"Marshaller());");
         }
 
 out.println("}");
@@ -328,7 +328,7 @@ out.println("#ifdef _MSC_VER");
 out.println("#pragma warning( disable : 4290 )");
 out.println("#endif");
 out.println("");
-out.println("#include <activemq/wireformat/openwire/OpenWireFormat.h>");
+out.println("#include <activemq/wireformat/openwire/marshal/MarshallerTable.h>");
 out.println("");
 out.println("namespace activemq {");
 out.println("namespace wireformat {");
@@ -349,7 +349,7 @@ out.println("    public:");
 out.println("");
 out.println("        virtual ~MarshallerFactory() {};");
 out.println("");
-out.println("        virtual void configure(OpenWireFormat* format);");
+out.println("        virtual void configure(MarshallerTable* table);");
 out.println("");
 out.println("    };");
 out.println("");
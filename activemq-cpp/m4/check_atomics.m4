@@ -72,6 +72,47 @@ AC_DEFUN([DECAF_CHECK_FOR_ATOMIC_BUILTINS], [
 
 ])dnl
 
+dnl
+dnl DECAF_CHECK_FOR_ATOMIC_MEMORY_MODEL in GCC 4.7+ and Clang
+dnl
+AC_DEFUN([DECAF_CHECK_FOR_ATOMIC_MEMORY_MODEL], [
+
+    AC_CACHE_CHECK([whether the compiler provides memory model aware atomic builtins], [ap_cv_atomic_memory_model],
+    [AC_TRY_RUN([
+    int main()
+    {
+        int val = 1010;
+        int expect = 2020;
+        void* ptr = 0;
+
+        if (__atomic_fetch_add(&val, 1010, __ATOMIC_RELAXED) != 1010 || val != 2020)
+            return 1;
+
+        if (__atomic_sub_fetch(&val, 1010, __ATOMIC_RELEASE) != 1010)
+            return 1;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_compare_exchange_n(&val, &expect, 3030, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) || expect != 1010)
+            return 1;
+
+        if (__atomic_exchange_n(&val, 4040, __ATOMIC_SEQ_CST) != 1010)
+            return 1;
+
+        __atomic_store_n(&ptr, &val, __ATOMIC_RELEASE);
+
+        if (__atomic_load_n(&ptr, __ATOMIC_ACQUIRE) != &val)
+            return 1;
+
+        return 0;
+    }], [ap_cv_atomic_memory_model=yes], [ap_cv_atomic_memory_model=no], [ap_cv_atomic_memory_model=no])])
+
+    if test "$ap_cv_atomic_memory_model" = "yes"; then
+        AC_DEFINE(HAVE_ATOMIC_MEMORY_MODEL, 1, [Define if compiler provides the __atomic builtins with explicit memory ordering])
+    fi
+
+])dnl
+
 dnl ---------------------------------------------------------------------------
 dnl Checks for atomic operations support and the various features that are
 dnl needed in order to build the DECAF Code that uses atomics provided by
@@ -83,4 +124,7 @@ AC_DEFUN([DECAF_CHECK_ATOMICS], [
     dnl Attempts to enable atomic builtins compilation on this platform.
     DECAF_CHECK_FOR_ATOMIC_BUILTINS
 
+    dnl Prefers the builtins that take an explicit memory order when available.
+    DECAF_CHECK_FOR_ATOMIC_MEMORY_MODEL
+
 ])
@@ -185,7 +185,7 @@ AC_DEFUN([DECAF_CHECK_PTHREAD_EXTRAS], [
     fi
 
     dnl ----------------------------- Check for non-posix pthreads methods
-    AC_CHECK_FUNCS([pthread_tryjoin_np pthread_timedjoin_np])
+    AC_CHECK_FUNCS([pthread_tryjoin_np pthread_timedjoin_np pthread_setaffinity_np])
 
 ])
 
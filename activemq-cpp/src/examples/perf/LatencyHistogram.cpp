@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <iomanip>
+#include <sstream>
+
+using namespace cms;
+using namespace cms::perf;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Values below 128 have a bucket each, above that every power of two range is
+    // split in 64 buckets, 56 ranges reach the largest long long.
+    const int SUB_BUCKETS = 64;
+    const int BUCKET_COUNT = 2 * SUB_BUCKETS + 56 * SUB_BUCKETS;
+
+    int highestBit(unsigned long long value) {
+        int bit = -1;
+        while (value != 0) {
+            value >>= 1;
+            bit++;
+        }
+        return bit;
+    }
+
+    double micros(long long nanos) {
+        return (double) nanos / 1000.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram() : counts(BUCKET_COUNT, 0), count(0), min(0), max(0), sum(0.0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::~LatencyHistogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LatencyHistogram::indexOf(long long value) {
+
+    if (value < 2 * SUB_BUCKETS) {
+        return (int) value;
+    }
+
+    int shift = highestBit((unsigned long long) value) - 6;
+    return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + (int) ((value >> shift) - SUB_BUCKETS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::highestValueAt(int index) {
+
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+
+    int shift = (index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+    long long sub = (index - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    return (sub << shift) + ((1LL << shift) - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::record(long long nanos) {
+
+    if (nanos < 0) {
+        nanos = 0;
+    }
+
+    this->counts[indexOf(nanos)]++;
+
+    if (this->count == 0 || nanos < this->min) {
+        this->min = nanos;
+    }
+    if (nanos > this->max) {
+        this->max = nanos;
+    }
+
+    this->count++;
+    this->sum += (double) nanos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::add(const LatencyHistogram& other) {
+
+    if (other.count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        this->counts[i] += other.counts[i];
+    }
+
+    if (this->count == 0 || other.min < this->min) {
+        this->min = other.min;
+    }
+    if (other.max > this->max) {
+        this->max = other.max;
+    }
+
+    this->count += other.count;
+    this->sum += other.sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getValueAtPercentile(double percentile) const {
+
+    if (this->count == 0) {
+        return 0;
+    }
+
+    long long wanted = (long long) ((percentile / 100.0) * (double) this->count + 0.5);
+    if (wanted < 1) {
+        wanted = 1;
+    }
+
+    long long seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += this->counts[i];
+        if (seen >= wanted) {
+            long long value = highestValueAt(i);
+            return value < this->max ? value : this->max;
+        }
+    }
+
+    return this->max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LatencyHistogram::toJson() const {
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3)
+         << "{\"count\": " << this->count
+         << ", \"min_us\": " << micros(getMin())
+         << ", \"mean_us\": " << getMean() / 1000.0
+         << ", \"p50_us\": " << micros(getValueAtPercentile(50.0))
+         << ", \"p90_us\": " << micros(getValueAtPercentile(90.0))
+         << ", \"p99_us\": " << micros(getValueAtPercentile(99.0))
+         << ", \"p99_9_us\": " << micros(getValueAtPercentile(99.9))
+         << ", \"p99_99_us\": " << micros(getValueAtPercentile(99.99))
+         << ", \"max_us\": " << micros(this->max) << "}";
+
+    return json.str();
+}
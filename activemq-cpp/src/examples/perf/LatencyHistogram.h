@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CMS_PERF_LATENCYHISTOGRAM_H_
+#define _CMS_PERF_LATENCYHISTOGRAM_H_
+
+#include <decaf/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace cms {
+namespace perf {
+
+    /**
+     * Counts latencies in nanoseconds in buckets whose width grows with the value, so
+     * every recorded value is kept to within 1/64 of itself whatever its magnitude,
+     * from nanoseconds up to hours, in a fixed amount of memory.
+     *
+     * The histogram itself doesn't correct for coordinated omission, the tool does by
+     * measuring each latency from the time the message was meant to be sent by the
+     * configured rate rather than from the time a stalled sender got to send it.
+     */
+    class LatencyHistogram {
+    private:
+
+        std::vector<long long> counts;
+        long long count;
+        long long min;
+        long long max;
+        double sum;
+
+    public:
+
+        LatencyHistogram();
+
+        virtual ~LatencyHistogram();
+
+        /**
+         * Records one latency, negative values count as zero.
+         *
+         * @param nanos
+         *      The latency in nanoseconds.
+         */
+        void record(long long nanos);
+
+        /**
+         * Adds the values recorded by another histogram to this one.
+         *
+         * @param other
+         *      The histogram whose values are added.
+         */
+        void add(const LatencyHistogram& other);
+
+        long long getCount() const {
+            return this->count;
+        }
+
+        long long getMin() const {
+            return this->count == 0 ? 0 : this->min;
+        }
+
+        long long getMax() const {
+            return this->max;
+        }
+
+        double getMean() const {
+            return this->count == 0 ? 0.0 : this->sum / (double) this->count;
+        }
+
+        /**
+         * @param percentile
+         *      The percentile wanted, from 0 to 100.
+         *
+         * @return the largest value in the bucket holding the given percentile of the
+         *         recorded values, or 0 when nothing was recorded.
+         */
+        long long getValueAtPercentile(double percentile) const;
+
+        /**
+         * @return the histogram summarized as a JSON object, values in microseconds.
+         */
+        std::string toJson() const;
+
+    private:
+
+        static int indexOf(long long value);
+
+        static long long highestValueAt(int index);
+
+    };
+
+}}
+
+#endif /* _CMS_PERF_LATENCYHISTOGRAM_H_ */
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerfConsumer.h"
+#include "PerfProducer.h"
+
+#include <cms/CMSException.h>
+
+#include <decaf/lang/System.h>
+
+#include <stdio.h>
+
+using namespace cms;
+using namespace cms::perf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+PerfConsumer::PerfConsumer(cms::Connection* connection, const PerfOptions& options, CountDownLatch* done) :
+    MessageListener(), connection(connection), options(options), done(done), session(), consumer(),
+    latency(), received(0), lastReceiveTime(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PerfConsumer::~PerfConsumer() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfConsumer::start() {
+
+    this->session.reset(this->connection->createSession(this->options.ackMode));
+    Pointer<Destination> destination(this->options.topic ?
+        (Destination*) this->session->createTopic(this->options.destination) :
+        (Destination*) this->session->createQueue(this->options.destination));
+
+    this->consumer.reset(this->session->createConsumer(destination.get()));
+    this->consumer->setMessageListener(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfConsumer::stop() {
+
+    if (this->consumer == NULL) {
+        return;
+    }
+
+    this->consumer->close();
+    if (this->options.ackMode == Session::SESSION_TRANSACTED) {
+        this->session->commit();
+    }
+    this->session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfConsumer::onMessage(const cms::Message* message) {
+
+    long long now = System::nanoTime();
+
+    try {
+
+        long long intended = message->getLongProperty(PerfProducer::INTENDED_TIME_PROPERTY);
+        if (intended != 0) {
+            this->latency.record(now - intended);
+        }
+
+        this->received++;
+        this->lastReceiveTime = now;
+
+        switch (this->options.ackMode) {
+            case Session::CLIENT_ACKNOWLEDGE:
+                // The last message of the run acknowledges the rest of the batch.
+                if (this->received % this->options.transactionBatch == 0 || this->done->getCount() <= 1) {
+                    message->acknowledge();
+                }
+                break;
+            case Session::INDIVIDUAL_ACKNOWLEDGE:
+                message->acknowledge();
+                break;
+            case Session::SESSION_TRANSACTED:
+                if (this->received % this->options.transactionBatch == 0) {
+                    this->session->commit();
+                }
+                break;
+            default:
+                break;
+        }
+
+    } catch (CMSException& ex) {
+        fprintf(stderr, "Consumer failed: %s\n", ex.getMessage().c_str());
+    }
+
+    this->done->countDown();
+}
@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CMS_PERF_PERFCONSUMER_H_
+#define _CMS_PERF_PERFCONSUMER_H_
+
+#include <decaf/util/Config.h>
+
+#include <cms/Connection.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageListener.h>
+#include <cms/Session.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+
+#include "LatencyHistogram.h"
+#include "PerfOptions.h"
+
+namespace cms {
+namespace perf {
+
+    /**
+     * Receives from its own session and records the latency of each measured message,
+     * from the time the producer scheduled it to the time it reaches the listener.
+     *
+     * Every message received counts down the shared latch, the run is complete when all
+     * the consumers together have received everything they should.
+     */
+    class PerfConsumer : public cms::MessageListener {
+    private:
+
+        cms::Connection* connection;
+        const PerfOptions& options;
+        decaf::util::concurrent::CountDownLatch* done;
+
+        decaf::lang::Pointer<cms::Session> session;
+        decaf::lang::Pointer<cms::MessageConsumer> consumer;
+
+        LatencyHistogram latency;
+        long long received;
+        long long lastReceiveTime;
+
+    private:
+
+        PerfConsumer(const PerfConsumer&);
+        PerfConsumer& operator=(const PerfConsumer&);
+
+    public:
+
+        PerfConsumer(cms::Connection* connection, const PerfOptions& options,
+                     decaf::util::concurrent::CountDownLatch* done);
+
+        virtual ~PerfConsumer();
+
+        /**
+         * Creates the session and consumer, messages are delivered once the connection
+         * is started.
+         */
+        void start();
+
+        /**
+         * Commits or acknowledges whatever the ack mode left outstanding and closes the
+         * consumer.
+         */
+        void stop();
+
+        virtual void onMessage(const cms::Message* message);
+
+        /**
+         * The latencies recorded, only read once the consumer is stopped.
+         */
+        const LatencyHistogram& getLatency() const {
+            return this->latency;
+        }
+
+        long long getReceived() const {
+            return this->received;
+        }
+
+        /**
+         * @return the nanoTime the last message was received at.
+         */
+        long long getLastReceiveTime() const {
+            return this->lastReceiveTime;
+        }
+
+    };
+
+}}
+
+#endif /* _CMS_PERF_PERFCONSUMER_H_ */
@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <activemq/library/ActiveMQCPP.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+
+#include <cms/CMSException.h>
+#include <cms/Connection.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+
+#include "LatencyHistogram.h"
+#include "PerfConsumer.h"
+#include "PerfOptions.h"
+#include "PerfProducer.h"
+
+#include <stdio.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cms;
+using namespace cms::perf;
+using namespace activemq::core;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    double perSecond(long long count, long long nanos) {
+        return nanos <= 0 ? 0.0 : (double) count * 1000000000.0 / (double) nanos;
+    }
+
+    int runBenchmark(const PerfOptions& options) {
+
+        ActiveMQConnectionFactory factory(options.brokerURI);
+        factory.setUseAsyncSend(options.asyncSend);
+        factory.setUseCompression(options.compression);
+
+        // Producers and consumers get connections of their own so the traffic of one
+        // side doesn't queue behind the other on a shared transport.
+        Pointer<Connection> producerConnection(factory.createConnection());
+        Pointer<Connection> consumerConnection(factory.createConnection());
+
+        long long perProducer = (long long) options.messages + options.warmup;
+        long long expected = perProducer * options.producers;
+        if (options.topic) {
+            expected *= options.consumers;
+        }
+        if (options.consumers == 0) {
+            expected = 0;
+        }
+
+        CountDownLatch done((int) expected);
+
+        std::vector<PerfConsumer*> consumers;
+        for (int i = 0; i < options.consumers; ++i) {
+            consumers.push_back(new PerfConsumer(consumerConnection.get(), options, &done));
+            consumers.back()->start();
+        }
+
+        // Topic subscriptions exist once the connection is started, before anything is sent.
+        consumerConnection->start();
+        producerConnection->start();
+
+        std::vector<PerfProducer*> producers;
+        std::vector<Thread*> threads;
+        for (int i = 0; i < options.producers; ++i) {
+            producers.push_back(new PerfProducer(producerConnection.get(), options));
+            threads.push_back(new Thread(producers.back(), "PerfProducer"));
+        }
+
+        long long begin = System::nanoTime();
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i]->start();
+        }
+        for (std::size_t i = 0; i < threads.size(); ++i) {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        bool complete = done.await(options.timeout, TimeUnit::SECONDS);
+
+        LatencyHistogram latency;
+        LatencyHistogram sendLatency;
+        long long sent = 0;
+        long long received = 0;
+        long long sendStart = 0;
+        long long sendEnd = begin;
+        long long receiveEnd = begin;
+
+        for (std::size_t i = 0; i < consumers.size(); ++i) {
+            consumers[i]->stop();
+            latency.add(consumers[i]->getLatency());
+            received += consumers[i]->getReceived();
+            if (consumers[i]->getLastReceiveTime() > receiveEnd) {
+                receiveEnd = consumers[i]->getLastReceiveTime();
+            }
+            delete consumers[i];
+        }
+
+        int failed = 0;
+        for (std::size_t i = 0; i < producers.size(); ++i) {
+            PerfProducer* producer = producers[i];
+            if (!producer->getError().empty()) {
+                fprintf(stderr, "Producer failed: %s\n", producer->getError().c_str());
+                failed++;
+            }
+            sendLatency.add(producer->getSendLatency());
+            sent += producer->getSent();
+            if (sendStart == 0 || (producer->getStartTime() != 0 && producer->getStartTime() < sendStart)) {
+                sendStart = producer->getStartTime();
+            }
+            if (producer->getEndTime() > sendEnd) {
+                sendEnd = producer->getEndTime();
+            }
+            delete producer;
+        }
+
+        producerConnection->close();
+        consumerConnection->close();
+
+        // Throughput counts the measured messages only, from the end of the warm up.
+        if (sendStart == 0) {
+            sendStart = begin;
+        }
+        long long measuredSent = (long long) options.messages * options.producers;
+
+        std::ostringstream json;
+        json.setf(std::ios::fixed);
+        json.precision(1);
+        json << "{\"config\": " << options.toJson()
+             << ", \"complete\": " << (complete ? "true" : "false")
+             << ", \"sent\": " << sent
+             << ", \"received\": " << received
+             << ", \"elapsed_ms\": " << (double) (receiveEnd > sendEnd ? receiveEnd - begin : sendEnd - begin) / 1000000.0
+             << ", \"send_msgs_per_sec\": " << perSecond(measuredSent, sendEnd - sendStart)
+             << ", \"receive_msgs_per_sec\": " << perSecond(latency.getCount(), receiveEnd - sendStart)
+             << ", \"latency\": " << latency.toJson()
+             << ", \"send_latency\": " << sendLatency.toJson() << "}";
+
+        printf("%s\n", json.str().c_str());
+
+        return complete && failed == 0 ? 0 : 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv) {
+
+    PerfOptions options;
+    if (!options.parse(argc, argv)) {
+        PerfOptions::printUsage(argv[0]);
+        return 2;
+    }
+
+    activemq::library::ActiveMQCPP::initializeLibrary();
+
+    int result = 1;
+    try {
+        result = runBenchmark(options);
+    } catch (CMSException& ex) {
+        fprintf(stderr, "Benchmark failed: %s\n", ex.getMessage().c_str());
+    }
+
+    activemq::library::ActiveMQCPP::shutdownLibrary();
+
+    return result;
+}
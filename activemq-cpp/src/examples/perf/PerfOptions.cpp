@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerfOptions.h"
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/NumberFormatException.h>
+
+#include <stdio.h>
+#include <sstream>
+
+using namespace cms;
+using namespace cms::perf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    bool parseInt(const std::string& name, const std::string& value, int& result) {
+        try {
+            result = Integer::parseInt(value);
+            return true;
+        } catch (NumberFormatException& ex) {
+            fprintf(stderr, "--%s needs a number: %s\n", name.c_str(), value.c_str());
+            return false;
+        }
+    }
+
+    bool parseBoolean(const std::string& value) {
+        return value.empty() || value == "true" || value == "on" || value == "1";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PerfOptions::PerfOptions() : brokerURI("failover:(tcp://127.0.0.1:61616)"),
+                             destination("amqcpp.perf"),
+                             topic(false),
+                             producers(1),
+                             consumers(1),
+                             messages(100000),
+                             warmup(1000),
+                             rate(0),
+                             messageSize(1024),
+                             messageType("bytes"),
+                             persistent(false),
+                             ackMode(cms::Session::AUTO_ACKNOWLEDGE),
+                             transactionBatch(100),
+                             asyncSend(false),
+                             compression(false),
+                             timeout(120) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PerfOptions::parse(int argc, char** argv) {
+
+    for (int i = 1; i < argc; ++i) {
+
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+
+        std::string name = arg.substr(2);
+        std::string value;
+        std::string::size_type equals = name.find('=');
+        if (equals != std::string::npos) {
+            value = name.substr(equals + 1);
+            name = name.substr(0, equals);
+        }
+
+        bool ok = true;
+
+        if (name == "help") {
+            return false;
+        } else if (name == "url") {
+            brokerURI = value;
+        } else if (name == "destination") {
+            destination = value;
+        } else if (name == "topic") {
+            topic = parseBoolean(value);
+        } else if (name == "producers") {
+            ok = parseInt(name, value, producers);
+        } else if (name == "consumers") {
+            ok = parseInt(name, value, consumers);
+        } else if (name == "messages") {
+            ok = parseInt(name, value, messages);
+        } else if (name == "warmup") {
+            ok = parseInt(name, value, warmup);
+        } else if (name == "rate") {
+            ok = parseInt(name, value, rate);
+        } else if (name == "size") {
+            ok = parseInt(name, value, messageSize);
+        } else if (name == "type") {
+            messageType = value;
+            ok = value == "bytes" || value == "text" || value == "map" || value == "stream";
+        } else if (name == "persistent") {
+            persistent = parseBoolean(value);
+        } else if (name == "ack") {
+            if (value == "auto") {
+                ackMode = cms::Session::AUTO_ACKNOWLEDGE;
+            } else if (value == "dups") {
+                ackMode = cms::Session::DUPS_OK_ACKNOWLEDGE;
+            } else if (value == "client") {
+                ackMode = cms::Session::CLIENT_ACKNOWLEDGE;
+            } else if (value == "individual") {
+                ackMode = cms::Session::INDIVIDUAL_ACKNOWLEDGE;
+            } else if (value == "transacted") {
+                ackMode = cms::Session::SESSION_TRANSACTED;
+            } else {
+                ok = false;
+            }
+        } else if (name == "tx-batch") {
+            ok = parseInt(name, value, transactionBatch);
+        } else if (name == "async-send") {
+            asyncSend = parseBoolean(value);
+        } else if (name == "compress") {
+            compression = parseBoolean(value);
+        } else if (name == "timeout") {
+            ok = parseInt(name, value, timeout);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Invalid argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    if (producers < 1 || consumers < 0 || messages < 0 || warmup < 0 || rate < 0 ||
+        messageSize < 0 || transactionBatch < 1 || timeout < 1) {
+        fprintf(stderr, "Counts, sizes and rates can't be negative.\n");
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string PerfOptions::getAckModeName() const {
+
+    switch (ackMode) {
+        case cms::Session::DUPS_OK_ACKNOWLEDGE:
+            return "dups";
+        case cms::Session::CLIENT_ACKNOWLEDGE:
+            return "client";
+        case cms::Session::INDIVIDUAL_ACKNOWLEDGE:
+            return "individual";
+        case cms::Session::SESSION_TRANSACTED:
+            return "transacted";
+        default:
+            return "auto";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string PerfOptions::toJson() const {
+
+    std::ostringstream json;
+    json << "{\"url\": \"" << brokerURI << "\""
+         << ", \"destination\": \"" << destination << "\""
+         << ", \"topic\": " << (topic ? "true" : "false")
+         << ", \"producers\": " << producers
+         << ", \"consumers\": " << consumers
+         << ", \"messages\": " << messages
+         << ", \"warmup\": " << warmup
+         << ", \"rate\": " << rate
+         << ", \"size\": " << messageSize
+         << ", \"type\": \"" << messageType << "\""
+         << ", \"persistent\": " << (persistent ? "true" : "false")
+         << ", \"ack\": \"" << getAckModeName() << "\""
+         << ", \"tx_batch\": " << transactionBatch
+         << ", \"async_send\": " << (asyncSend ? "true" : "false")
+         << ", \"compress\": " << (compression ? "true" : "false") << "}";
+
+    return json.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfOptions::printUsage(const char* program) {
+
+    printf("Usage: %s [--option=value ...]\n", program);
+    printf(" --url=uri          Broker URI (default failover:(tcp://127.0.0.1:61616))\n");
+    printf(" --destination=name Queue or topic name (default amqcpp.perf)\n");
+    printf(" --topic            Use a topic rather than a queue\n");
+    printf(" --producers=#      Producer threads, each with its own session (default 1)\n");
+    printf(" --consumers=#      Consumers, each with its own session (default 1)\n");
+    printf(" --messages=#       Messages each producer sends and measures (default 100000)\n");
+    printf(" --warmup=#         Unmeasured messages each producer sends first (default 1000)\n");
+    printf(" --rate=#           Messages per second per producer, 0 is unthrottled (default 0)\n");
+    printf(" --size=#           Payload bytes per message (default 1024)\n");
+    printf(" --type=t           bytes, text, map or stream (default bytes)\n");
+    printf(" --persistent       Send persistent messages\n");
+    printf(" --ack=mode         auto, dups, client, individual or transacted (default auto)\n");
+    printf(" --tx-batch=#       Messages per transaction or client ack (default 100)\n");
+    printf(" --async-send       Send without waiting for the broker\n");
+    printf(" --compress         Compress message bodies\n");
+    printf(" --timeout=#        Seconds to wait for all messages to arrive (default 120)\n");
+    printf("\n");
+    printf("Results are written to stdout as JSON.  With a rate set, latencies are measured\n");
+    printf("from the time each message was scheduled to be sent, so stalls of the sender\n");
+    printf("show up in the results instead of being hidden (coordinated omission).\n");
+}
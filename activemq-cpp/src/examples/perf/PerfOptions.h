@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CMS_PERF_PERFOPTIONS_H_
+#define _CMS_PERF_PERFOPTIONS_H_
+
+#include <decaf/util/Config.h>
+
+#include <cms/Session.h>
+
+#include <string>
+
+namespace cms {
+namespace perf {
+
+    /**
+     * The settings of a run, read from --name=value command line arguments.
+     */
+    class PerfOptions {
+    public:
+
+        std::string brokerURI;
+        std::string destination;
+        bool topic;
+
+        int producers;
+        int consumers;
+
+        // Messages each producer sends, after its warm up messages.
+        int messages;
+        int warmup;
+
+        // Messages per second each producer sends, 0 sends as fast as it can.
+        int rate;
+
+        int messageSize;
+        std::string messageType;
+
+        bool persistent;
+        cms::Session::AcknowledgeMode ackMode;
+
+        // Messages per transaction, or per acknowledge in client ack mode.
+        int transactionBatch;
+
+        bool asyncSend;
+        bool compression;
+
+        // Seconds to wait for the consumers to receive everything.
+        int timeout;
+
+    public:
+
+        PerfOptions();
+
+        /**
+         * Applies the given command line arguments.
+         *
+         * @return false with a message on stderr if an argument isn't understood.
+         */
+        bool parse(int argc, char** argv);
+
+        /**
+         * @return the name of the configured ack mode.
+         */
+        std::string getAckModeName() const;
+
+        /**
+         * @return the options as a JSON object.
+         */
+        std::string toJson() const;
+
+        static void printUsage(const char* program);
+
+    };
+
+}}
+
+#endif /* _CMS_PERF_PERFOPTIONS_H_ */
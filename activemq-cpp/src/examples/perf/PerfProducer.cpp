@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerfProducer.h"
+
+#include <cms/BytesMessage.h>
+#include <cms/CMSException.h>
+#include <cms/MapMessage.h>
+#include <cms/MessageProducer.h>
+#include <cms/StreamMessage.h>
+#include <cms/TextMessage.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+
+using namespace cms;
+using namespace cms::perf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string PerfProducer::INTENDED_TIME_PROPERTY = "PerfIntendedNanos";
+
+////////////////////////////////////////////////////////////////////////////////
+PerfProducer::PerfProducer(cms::Connection* connection, const PerfOptions& options) :
+    Runnable(), connection(connection), options(options), payload(), sendLatency(),
+    sent(0), startTime(0), endTime(0), error() {
+
+    this->payload.resize(options.messageSize);
+    for (std::size_t i = 0; i < this->payload.size(); ++i) {
+        this->payload[i] = (unsigned char) ('a' + i % 26);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PerfProducer::~PerfProducer() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfProducer::run() {
+
+    try {
+
+        Pointer<Session> session(this->connection->createSession(this->options.ackMode));
+        Pointer<Destination> destination(this->options.topic ?
+            (Destination*) session->createTopic(this->options.destination) :
+            (Destination*) session->createQueue(this->options.destination));
+        Pointer<MessageProducer> producer(session->createProducer(destination.get()));
+        producer->setDeliveryMode(this->options.persistent ?
+            DeliveryMode::PERSISTENT : DeliveryMode::NON_PERSISTENT);
+
+        for (int i = 0; i < this->options.warmup; ++i) {
+            send(session.get(), producer.get(), 0);
+        }
+
+        long long interval = this->options.rate > 0 ? 1000000000LL / this->options.rate : 0;
+        this->startTime = System::nanoTime();
+
+        for (int i = 0; i < this->options.messages; ++i) {
+
+            long long intended = System::nanoTime();
+            if (interval > 0) {
+                intended = this->startTime + i * interval;
+
+                // Sleep while the slot is far off, spin through the last millisecond.
+                long long now = System::nanoTime();
+                while (now < intended) {
+                    long long wait = intended - now;
+                    if (wait > 2000000) {
+                        Thread::sleep((wait - 1000000) / 1000000);
+                    } else {
+                        Thread::yield();
+                    }
+                    now = System::nanoTime();
+                }
+            }
+
+            send(session.get(), producer.get(), intended);
+            this->sendLatency.record(System::nanoTime() - intended);
+        }
+
+        if (this->options.ackMode == Session::SESSION_TRANSACTED) {
+            session->commit();
+        }
+
+        this->endTime = System::nanoTime();
+
+        producer->close();
+        session->close();
+
+    } catch (CMSException& ex) {
+        this->error = ex.getMessage();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* PerfProducer::createMessage(cms::Session* session) {
+
+    const std::string& type = this->options.messageType;
+
+    if (type == "text") {
+        return session->createTextMessage(std::string(this->payload.begin(), this->payload.end()));
+    } else if (type == "map") {
+        MapMessage* message = session->createMapMessage();
+        message->setBytes("payload", this->payload);
+        return message;
+    } else if (type == "stream") {
+        StreamMessage* message = session->createStreamMessage();
+        message->writeBytes(this->payload);
+        return message;
+    }
+
+    return session->createBytesMessage(
+        this->payload.empty() ? NULL : &this->payload[0], (int) this->payload.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PerfProducer::send(cms::Session* session, cms::MessageProducer* producer, long long intended) {
+
+    Pointer<Message> message(createMessage(session));
+    message->setLongProperty(INTENDED_TIME_PROPERTY, intended);
+
+    producer->send(message.get());
+    this->sent++;
+
+    if (this->options.ackMode == Session::SESSION_TRANSACTED &&
+        this->sent % this->options.transactionBatch == 0) {
+        session->commit();
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CMS_PERF_PERFPRODUCER_H_
+#define _CMS_PERF_PERFPRODUCER_H_
+
+#include <decaf/util/Config.h>
+
+#include <cms/Connection.h>
+#include <cms/Message.h>
+#include <cms/Session.h>
+
+#include <decaf/lang/Runnable.h>
+
+#include "LatencyHistogram.h"
+#include "PerfOptions.h"
+
+#include <string>
+#include <vector>
+
+namespace cms {
+namespace perf {
+
+    /**
+     * Sends the warm up and measured messages of one producer from its own session.
+     *
+     * With a rate set each message has a slot on a fixed schedule and is stamped with
+     * the time of its slot, the consumers and the send latency both measure from that
+     * time.  A send that stalls then counts against every message scheduled behind it,
+     * as it would for a real application producing at that rate.
+     */
+    class PerfProducer : public decaf::lang::Runnable {
+    public:
+
+        /**
+         * Name of the long property holding the nanoTime a message was scheduled for,
+         * zero on warm up messages.
+         */
+        static const std::string INTENDED_TIME_PROPERTY;
+
+    private:
+
+        cms::Connection* connection;
+        const PerfOptions& options;
+
+        std::vector<unsigned char> payload;
+
+        LatencyHistogram sendLatency;
+        long long sent;
+        long long startTime;
+        long long endTime;
+        std::string error;
+
+    private:
+
+        PerfProducer(const PerfProducer&);
+        PerfProducer& operator=(const PerfProducer&);
+
+    public:
+
+        PerfProducer(cms::Connection* connection, const PerfOptions& options);
+
+        virtual ~PerfProducer();
+
+        virtual void run();
+
+        const LatencyHistogram& getSendLatency() const {
+            return this->sendLatency;
+        }
+
+        /**
+         * @return the number of messages sent, including the warm up messages.
+         */
+        long long getSent() const {
+            return this->sent;
+        }
+
+        /**
+         * @return the nanoTime the first measured message was sent at.
+         */
+        long long getStartTime() const {
+            return this->startTime;
+        }
+
+        /**
+         * @return the nanoTime the last message was sent at.
+         */
+        long long getEndTime() const {
+            return this->endTime;
+        }
+
+        /**
+         * @return the error that ended the run early, empty if there was none.
+         */
+        const std::string& getError() const {
+            return this->error;
+        }
+
+    private:
+
+        cms::Message* createMessage(cms::Session* session);
+
+        void send(cms::Session* session, cms::MessageProducer* producer, long long intended);
+
+    };
+
+}}
+
+#endif /* _CMS_PERF_PERFPRODUCER_H_ */
@@ -87,6 +87,7 @@ CmsTemplate::CmsTemplate() : CmsDestinationAccessor(),
                              deliveryMode(0),
                              priority(0),
                              timeToLive(0),
+                             sessionThreadAffinity(true),
                              initialized(false) {
 
     initDefaults();
@@ -106,6 +107,7 @@ CmsTemplate::CmsTemplate( cms::ConnectionFactory* connectionFactory ) : CmsDesti
                                                                         deliveryMode(0),
                                                                         priority(0),
                                                                         timeToLive(0),
+                                                                        sessionThreadAffinity(true),
                                                                         initialized(false) {
 
     initDefaults();
@@ -133,6 +135,7 @@ void CmsTemplate::initDefaults() {
     deliveryMode = cms::DeliveryMode::PERSISTENT;
     priority = DEFAULT_PRIORITY;
     timeToLive = DEFAULT_TIME_TO_LIVE;
+    sessionThreadAffinity = true;
 
     // Initialize the connection object.
     connection = NULL;
@@ -154,6 +157,7 @@ void CmsTemplate::createSessionPools() {
      */
     for (int ix = 0; ix < NUM_SESSION_POOLS; ++ix) {
         sessionPools[ix] = new SessionPool(connection, (cms::Session::AcknowledgeMode) ix, getResourceLifecycleManager());
+        sessionPools[ix]->setThreadAffinity(sessionThreadAffinity);
     }
 }
 
@@ -269,6 +269,8 @@ namespace cmsutil {
 
         long long timeToLive;
 
+        bool sessionThreadAffinity;
+
         bool initialized;
 
     private:
@@ -481,6 +483,32 @@ namespace cmsutil {
             return this->timeToLive;
         }
 
+        /**
+         * Sets whether each thread using the template is handed back the session it
+         * used last, along with that session's cached producers, without taking the
+         * session pool's lock.  Takes effect when the connection is created.
+         *
+         * @param sessionThreadAffinity
+         *      true to keep a session per thread, the default.
+         */
+        virtual void setSessionThreadAffinity(bool sessionThreadAffinity) {
+            this->sessionThreadAffinity = sessionThreadAffinity;
+        }
+
+        virtual bool isSessionThreadAffinity() const {
+            return this->sessionThreadAffinity;
+        }
+
+        /**
+         * Gets the pool of the sessions used with the current acknowledge mode, which
+         * keeps the statistics of the template's session and producer caching.
+         *
+         * @return the session pool, or NULL until the template's connection is created.
+         */
+        virtual const SessionPool* getSessionPool() const {
+            return this->sessionPools[getSessionAcknowledgeMode()];
+        }
+
         /**
          * Executes the given action within a CMS Session.
          * @param action
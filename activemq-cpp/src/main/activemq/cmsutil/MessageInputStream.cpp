@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageInputStream.h"
+
+#include <cms/CMSException.h>
+#include <cms/Message.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+MessageInputStream::MessageInputStream(cms::MessageConsumer* consumer, int timeout) :
+    InputStream(), consumer(consumer), timeout(timeout), streamId(), current(),
+    remaining(0), sequence(0), endOfStream(false), closed(false) {
+
+    if (consumer == NULL) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "The consumer can't be NULL");
+    }
+
+    if (timeout < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Invalid timeout: %d", timeout);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageInputStream::~MessageInputStream() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageInputStream::available() const {
+    return this->closed ? 0 : this->remaining;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageInputStream::close() {
+    this->closed = true;
+    this->current.reset(NULL);
+    this->remaining = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageInputStream::doReadByte() {
+
+    unsigned char value = 0;
+    int result = doReadArrayBounded(&value, 1, 0, 1);
+
+    return result == -1 ? -1 : (int) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageInputStream::doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return 0;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Buffer pointer passed was NULL.");
+    }
+
+    if (size < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+    }
+
+    if (offset > size || offset < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+    }
+
+    if (length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+    }
+
+    checkClosed();
+
+    if (this->remaining == 0 && !nextChunk()) {
+        return -1;
+    }
+
+    try {
+
+        int amount = length < this->remaining ? length : this->remaining;
+        int read = this->current->readBytes(buffer + offset, amount);
+
+        if (read != amount) {
+            throw IOException(__FILE__, __LINE__, "Part %d of the message stream is truncated", this->sequence);
+        }
+
+        this->remaining -= read;
+        return read;
+
+    } catch (cms::CMSException& ex) {
+        throw IOException(__FILE__, __LINE__, "Failed to read the message stream: %s", ex.getMessage().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageInputStream::checkClosed() const {
+    if (this->closed) {
+        throw IOException(__FILE__, __LINE__, "The message stream is closed");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MessageInputStream::nextChunk() {
+
+    try {
+
+        while (!this->endOfStream) {
+
+            this->current.reset(NULL);
+
+            std::auto_ptr<cms::Message> message(this->timeout == 0 ?
+                this->consumer->receive() : this->consumer->receive(this->timeout));
+
+            if (message.get() == NULL) {
+                throw IOException(__FILE__, __LINE__,
+                    "Timed out waiting for part %d of the message stream", this->sequence + 1);
+            }
+
+            cms::BytesMessage* bytesMessage = dynamic_cast<cms::BytesMessage*>(message.get());
+
+            if (bytesMessage == NULL || !message->propertyExists("JMSXGroupID") ||
+                !message->propertyExists("JMSXGroupSeq")) {
+
+                throw IOException(__FILE__, __LINE__, "Received a message that isn't part of a message stream");
+            }
+
+            std::string groupId = message->getStringProperty("JMSXGroupID");
+            int groupSeq = message->getIntProperty("JMSXGroupSeq");
+
+            if (this->sequence == 0) {
+                this->streamId = groupId;
+            } else if (groupId != this->streamId) {
+                throw IOException(__FILE__, __LINE__, "Received part of message stream %s while reading %s",
+                                  groupId.c_str(), this->streamId.c_str());
+            }
+
+            if (groupSeq == -1) {
+                this->endOfStream = true;
+                break;
+            }
+
+            if (groupSeq != this->sequence + 1) {
+                throw IOException(__FILE__, __LINE__, "Received part %d of the message stream when expecting part %d",
+                                  groupSeq, this->sequence + 1);
+            }
+
+            this->sequence = groupSeq;
+            this->remaining = bytesMessage->getBodyLength();
+            this->current.reset(bytesMessage);
+            message.release();
+
+            if (this->remaining > 0) {
+                return true;
+            }
+        }
+
+        return false;
+
+    } catch (cms::CMSException& ex) {
+        throw IOException(__FILE__, __LINE__, "Failed to receive the message stream: %s", ex.getMessage().c_str());
+    }
+}
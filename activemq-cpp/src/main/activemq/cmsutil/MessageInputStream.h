@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CMSUTIL_MESSAGEINPUTSTREAM_H_
+#define _ACTIVEMQ_CMSUTIL_MESSAGEINPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/MessageConsumer.h>
+
+#include <decaf/io/InputStream.h>
+
+#include <memory>
+#include <string>
+
+namespace activemq {
+namespace cmsutil {
+
+    /**
+     * An InputStream that reads a stream sent by a MessageOutputStream back from the
+     * messages it was chunked into, receiving each chunk only when the previous one has
+     * been read.  Only one chunk is held at a time, a consumer's prefetchMemoryLimit
+     * bounds the memory taken by the chunks prefetched ahead of it.
+     *
+     * The stream is the message group of the first chunk received.  Chunks are checked
+     * to belong to that group and to arrive in order, a chunk that doesn't, or a
+     * receive that times out, fails the read with an IOException.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MessageInputStream : public decaf::io::InputStream {
+    private:
+
+        cms::MessageConsumer* consumer;
+
+        int timeout;
+
+        std::string streamId;
+
+        std::auto_ptr<cms::BytesMessage> current;
+
+        int remaining;
+
+        int sequence;
+
+        bool endOfStream;
+
+        bool closed;
+
+    private:
+
+        MessageInputStream(const MessageInputStream&);
+        MessageInputStream& operator= (const MessageInputStream&);
+
+    public:
+
+        /**
+         * Creates a stream that receives its chunks from the given consumer.
+         *
+         * @param consumer
+         *      The consumer to receive the chunks with, not owned by the stream.
+         * @param timeout
+         *      The time in milliseconds to wait for each chunk, zero waits forever.
+         *
+         * @throws IllegalArgumentException if the consumer is NULL or the timeout negative.
+         */
+        MessageInputStream(cms::MessageConsumer* consumer, int timeout = 0);
+
+        virtual ~MessageInputStream();
+
+        /**
+         * @return the id of the stream being read, empty until its first chunk arrived.
+         */
+        const std::string& getStreamId() const {
+            return this->streamId;
+        }
+
+        /**
+         * @return the number of bytes left in the chunk being read.
+         */
+        virtual int available() const;
+
+        virtual void close();
+
+    protected:
+
+        virtual int doReadByte();
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length);
+
+    private:
+
+        void checkClosed() const;
+
+        // Receives chunks until one with data to read, returns false at the end of the stream.
+        bool nextChunk();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CMSUTIL_MESSAGEINPUTSTREAM_H_ */
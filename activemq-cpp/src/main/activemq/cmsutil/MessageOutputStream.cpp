@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageOutputStream.h"
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/util/CopyOnWriteBytes.h>
+
+#include <cms/BytesMessage.h>
+#include <cms/CMSException.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Math.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/UUID.h>
+
+#include <memory>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::commands;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+const int MessageOutputStream::DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ChunkReleaser : public CopyOnWriteBytes::Releaser {
+    public:
+
+        virtual ~ChunkReleaser() {}
+
+        virtual void release(const unsigned char* bytes, std::size_t length AMQCPP_UNUSED) {
+            delete [] bytes;
+        }
+    };
+
+    ChunkReleaser CHUNK_RELEASER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageOutputStream::MessageOutputStream(cms::Session* session, cms::MessageProducer* producer, int chunkSize) :
+    OutputStream(), session(session), producer(producer), streamId(), chunkSize(chunkSize),
+    chunk(NULL), count(0), sequence(0), closed(false) {
+
+    if (session == NULL || producer == NULL) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "The session and producer can't be NULL");
+    }
+
+    if (chunkSize < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Invalid chunk size: %d", chunkSize);
+    }
+
+    this->streamId = "ID:" + UUID::randomUUID().toString();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageOutputStream::~MessageOutputStream() {
+    try {
+        close();
+    } catch (...) {
+    }
+
+    delete [] this->chunk;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::flush() {
+
+    try {
+        checkClosed();
+
+        if (this->count > 0) {
+            sendChunk();
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::close() {
+
+    if (this->closed) {
+        return;
+    }
+
+    try {
+
+        if (this->count > 0) {
+            sendChunk();
+        }
+
+        this->closed = true;
+
+        std::auto_ptr<cms::BytesMessage> message(this->session->createBytesMessage());
+        message->setStringProperty("JMSXGroupID", this->streamId);
+        message->setIntProperty("JMSXGroupSeq", -1);
+        this->producer->send(message.get());
+
+    } catch (cms::CMSException& ex) {
+        throw IOException(__FILE__, __LINE__, "Failed to end the message stream: %s", ex.getMessage().c_str());
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::doWriteByte(unsigned char value) {
+    doWriteArrayBounded(&value, 1, 0, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length) {
+
+    if (length == 0) {
+        return;
+    }
+
+    if (buffer == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "passed buffer is null");
+    }
+
+    if (size < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "size parameter out of Bounds: %d.", size);
+    }
+
+    if (offset > size || offset < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "offset parameter out of Bounds: %d.", offset);
+    }
+
+    if (length < 0 || length > size - offset) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", length);
+    }
+
+    try {
+
+        checkClosed();
+
+        while (length > 0) {
+
+            if (this->chunk == NULL) {
+                this->chunk = new unsigned char[this->chunkSize];
+            }
+
+            int amount = Math::min(length, this->chunkSize - this->count);
+            System::arraycopy(buffer, offset, this->chunk, this->count, amount);
+            this->count += amount;
+            offset += amount;
+            length -= amount;
+
+            if (this->count == this->chunkSize) {
+                sendChunk();
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::checkClosed() const {
+    if (this->closed) {
+        throw IOException(__FILE__, __LINE__, "The message stream is closed");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageOutputStream::sendChunk() {
+
+    try {
+
+        std::auto_ptr<cms::BytesMessage> message(this->session->createBytesMessage());
+
+        ActiveMQBytesMessage* amqMessage = dynamic_cast<ActiveMQBytesMessage*>(message.get());
+        if (amqMessage != NULL) {
+            // The message owns the chunk from here on, even if sending fails.
+            amqMessage->attachBodyBytes(this->chunk, this->count, &CHUNK_RELEASER);
+            this->chunk = NULL;
+        } else {
+            message->writeBytes(this->chunk, 0, this->count);
+        }
+
+        this->count = 0;
+
+        message->setStringProperty("JMSXGroupID", this->streamId);
+        message->setIntProperty("JMSXGroupSeq", this->sequence + 1);
+        this->producer->send(message.get());
+        this->sequence++;
+
+    } catch (cms::CMSException& ex) {
+        throw IOException(__FILE__, __LINE__, "Failed to send part of the message stream: %s", ex.getMessage().c_str());
+    }
+}
@@ -0,0 +1,143 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CMSUTIL_MESSAGEOUTPUTSTREAM_H_
+#define _ACTIVEMQ_CMSUTIL_MESSAGEOUTPUTSTREAM_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
+
+#include <decaf/io/OutputStream.h>
+
+#include <string>
+
+namespace activemq {
+namespace cmsutil {
+
+    /**
+     * An OutputStream that sends what is written to it as a sequence of BytesMessages,
+     * so a body of any size can be sent while only one chunk of it is held in memory.
+     * A MessageInputStream on the receiving side puts the stream back together.
+     *
+     * Every chunk is sent with the stream's id as its JMSXGroupID and its position in
+     * the stream, counting from one, as its JMSXGroupSeq.  A queue therefore hands all
+     * the chunks of a stream to the same consumer, in order.  Closing the stream sends
+     * an empty message with a JMSXGroupSeq of -1, which marks the end of the stream and
+     * closes the group on the broker.
+     *
+     * Chunks are attached to ActiveMQ messages without copying them, each chunk is
+     * freed once the message sending it has been written out.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MessageOutputStream : public decaf::io::OutputStream {
+    public:
+
+        /**
+         * The default size of the chunks, in bytes.
+         */
+        static const int DEFAULT_CHUNK_SIZE;
+
+    private:
+
+        cms::Session* session;
+
+        cms::MessageProducer* producer;
+
+        std::string streamId;
+
+        int chunkSize;
+
+        // The chunk being filled, handed to its message when the chunk is sent.
+        unsigned char* chunk;
+
+        int count;
+
+        int sequence;
+
+        bool closed;
+
+    private:
+
+        MessageOutputStream(const MessageOutputStream&);
+        MessageOutputStream& operator= (const MessageOutputStream&);
+
+    public:
+
+        /**
+         * Creates a stream that sends its chunks with the given producer.
+         *
+         * @param session
+         *      The session to create the chunk messages with, not owned by the stream.
+         * @param producer
+         *      The producer to send the chunks with, not owned by the stream.
+         * @param chunkSize
+         *      The number of bytes sent in each message.
+         *
+         * @throws IllegalArgumentException if either is NULL or the chunk size is below one.
+         */
+        MessageOutputStream(cms::Session* session, cms::MessageProducer* producer,
+                            int chunkSize = DEFAULT_CHUNK_SIZE);
+
+        /**
+         * Closes the stream if it wasn't already, ignoring any error doing so.
+         */
+        virtual ~MessageOutputStream();
+
+        /**
+         * @return the JMSXGroupID the chunks of this stream are sent with.
+         */
+        const std::string& getStreamId() const {
+            return this->streamId;
+        }
+
+        /**
+         * @return the number of chunks sent so far, the end of stream marker excluded.
+         */
+        int getChunksSent() const {
+            return this->sequence;
+        }
+
+        /**
+         * Sends what was written since the last chunk as a chunk of its own.
+         */
+        virtual void flush();
+
+        /**
+         * Sends what remains to be sent followed by the end of stream marker.
+         */
+        virtual void close();
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value);
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
+
+    private:
+
+        void checkClosed() const;
+
+        void sendChunk();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CMSUTIL_MESSAGEOUTPUTSTREAM_H_ */
@@ -0,0 +1,269 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageSelectorRouter.h"
+
+#include <cms/CMSException.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelectorRouter::MessageSelectorRouter() :
+    mutex(), routes(new RouteList()), unmatchedListener(NULL), exceptionListener(NULL) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelectorRouter::~MessageSelectorRouter() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::addRoute(const std::string& selector, cms::MessageListener* listener) {
+
+    if (listener == NULL) {
+        throw cms::CMSException("The listener of a route can't be NULL");
+    }
+
+    synchronized(&mutex) {
+
+        Pointer<RouteList> updated(new RouteList(*this->routes));
+
+        RouteList::iterator route = updated->begin();
+        for (; route != updated->end(); ++route) {
+            if (route->selector->getSelector() == selector) {
+                break;
+            }
+        }
+
+        if (route == updated->end()) {
+            // Compiled outside of the list so an invalid selector leaves it untouched.
+            Route added;
+            added.selector.reset(new MessageSelector(selector));
+            updated->push_back(added);
+            route = updated->end() - 1;
+        }
+
+        route->listeners.push_back(listener);
+        this->routes = updated;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MessageSelectorRouter::removeRoute(const std::string& selector, cms::MessageListener* listener) {
+
+    synchronized(&mutex) {
+
+        Pointer<RouteList> updated(new RouteList(*this->routes));
+
+        RouteList::iterator route = updated->begin();
+        for (; route != updated->end(); ++route) {
+
+            if (route->selector->getSelector() != selector) {
+                continue;
+            }
+
+            std::vector<cms::MessageListener*>::iterator found =
+                std::find(route->listeners.begin(), route->listeners.end(), listener);
+
+            if (found == route->listeners.end()) {
+                return false;
+            }
+
+            route->listeners.erase(found);
+            if (route->listeners.empty()) {
+                updated->erase(route);
+            }
+
+            this->routes = updated;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageSelectorRouter::removeListener(cms::MessageListener* listener) {
+
+    int removed = 0;
+
+    synchronized(&mutex) {
+
+        Pointer<RouteList> updated(new RouteList());
+
+        RouteList::const_iterator route = this->routes->begin();
+        for (; route != this->routes->end(); ++route) {
+
+            Route kept;
+            kept.selector = route->selector;
+
+            std::vector<cms::MessageListener*>::const_iterator iter = route->listeners.begin();
+            for (; iter != route->listeners.end(); ++iter) {
+                if (*iter == listener) {
+                    removed++;
+                } else {
+                    kept.listeners.push_back(*iter);
+                }
+            }
+
+            if (!kept.listeners.empty()) {
+                updated->push_back(kept);
+            }
+        }
+
+        if (removed > 0) {
+            this->routes = updated;
+        }
+    }
+
+    return removed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageSelectorRouter::getRouteCount() const {
+
+    int count = 0;
+
+    synchronized(&mutex) {
+        RouteList::const_iterator route = this->routes->begin();
+        for (; route != this->routes->end(); ++route) {
+            count += (int) route->listeners.size();
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::setUnmatchedListener(cms::MessageListener* listener) {
+    synchronized(&mutex) {
+        this->unmatchedListener = listener;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::MessageListener* MessageSelectorRouter::getUnmatchedListener() const {
+    synchronized(&mutex) {
+        return this->unmatchedListener;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::setExceptionListener(cms::ExceptionListener* listener) {
+    synchronized(&mutex) {
+        this->exceptionListener = listener;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::ExceptionListener* MessageSelectorRouter::getExceptionListener() const {
+    synchronized(&mutex) {
+        return this->exceptionListener;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int MessageSelectorRouter::route(const cms::Message* message) {
+
+    if (message == NULL) {
+        return 0;
+    }
+
+    Pointer<RouteList> current;
+    cms::MessageListener* unmatched = NULL;
+
+    synchronized(&mutex) {
+        current = this->routes;
+        unmatched = this->unmatchedListener;
+    }
+
+    // Listeners already handed this message, so each gets it at most once.
+    std::vector<cms::MessageListener*> delivered;
+
+    RouteList::const_iterator route = current->begin();
+    for (; route != current->end(); ++route) {
+
+        bool matches = false;
+        try {
+            matches = route->selector->matches(message);
+        } catch (cms::CMSException& ex) {
+            fireException(ex);
+        }
+
+        if (!matches) {
+            continue;
+        }
+
+        std::vector<cms::MessageListener*>::const_iterator listener = route->listeners.begin();
+        for (; listener != route->listeners.end(); ++listener) {
+            if (std::find(delivered.begin(), delivered.end(), *listener) == delivered.end()) {
+                delivered.push_back(*listener);
+                deliver(*listener, message);
+            }
+        }
+    }
+
+    if (delivered.empty() && unmatched != NULL) {
+        deliver(unmatched, message);
+        return 1;
+    }
+
+    return (int) delivered.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::onMessage(const cms::Message* message) {
+    this->route(message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::deliver(cms::MessageListener* listener, const cms::Message* message) {
+
+    try {
+        listener->onMessage(message);
+    } catch (cms::CMSException& ex) {
+        fireException(ex);
+    } catch (std::exception& ex) {
+        fireException(cms::CMSException(ex.what()));
+    } catch (...) {
+        fireException(cms::CMSException("Unknown error thrown by a routed MessageListener"));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouter::fireException(const cms::CMSException& ex) {
+
+    cms::ExceptionListener* listener = this->getExceptionListener();
+
+    if (listener != NULL) {
+        try {
+            listener->onException(ex);
+        } catch (...) {
+        }
+    }
+}
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CMSUTIL_MESSAGESELECTORROUTER_H_
+#define _ACTIVEMQ_CMSUTIL_MESSAGESELECTORROUTER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/MessageSelector.h>
+
+#include <cms/ExceptionListener.h>
+#include <cms/Message.h>
+#include <cms/MessageListener.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace cmsutil {
+
+    /**
+     * A MessageListener that fans the messages of a single consumer out to any number of
+     * listeners, each registered with a message selector that is evaluated in process.
+     * One wildcard consumer can so serve many handlers without a broker subscription
+     * per handler.
+     *
+     * Every listener whose selector matches a message receives it, once even if more
+     * than one of its selectors match, in the order the routes were added.  Selectors
+     * are compiled when a route is added and listeners sharing a selector share its
+     * evaluation.  Messages no route matched go to the unmatched listener when there is
+     * one.
+     *
+     * Routes may be added and removed while messages are routed, a message is routed
+     * with the routes in place when its routing started.  Errors reading a message or
+     * thrown by a listener never leave onMessage, they are passed to the exception
+     * listener when one is set and routing continues with the next route.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MessageSelectorRouter : public cms::MessageListener {
+    private:
+
+        struct Route {
+            decaf::lang::Pointer<util::MessageSelector> selector;
+            std::vector<cms::MessageListener*> listeners;
+
+            Route() : selector(), listeners() {}
+        };
+
+        typedef std::vector<Route> RouteList;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        // Replaced as a whole when the routes change, never modified in place.
+        decaf::lang::Pointer<RouteList> routes;
+
+        cms::MessageListener* unmatchedListener;
+
+        cms::ExceptionListener* exceptionListener;
+
+    private:
+
+        MessageSelectorRouter(const MessageSelectorRouter&);
+        MessageSelectorRouter& operator= (const MessageSelectorRouter&);
+
+    public:
+
+        MessageSelectorRouter();
+
+        virtual ~MessageSelectorRouter();
+
+        /**
+         * Routes the messages matching the given selector to the listener.
+         *
+         * @param selector
+         *      The message selector, an empty selector matches every message.
+         * @param listener
+         *      The listener to deliver the messages to, not owned by the router.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         * @throws CMSException if the listener is NULL.
+         */
+        void addRoute(const std::string& selector, cms::MessageListener* listener);
+
+        /**
+         * Removes a route added with addRoute.
+         *
+         * @param selector
+         *      The selector the route was added with.
+         * @param listener
+         *      The listener the route was added with.
+         *
+         * @return true if the route existed.
+         */
+        bool removeRoute(const std::string& selector, cms::MessageListener* listener);
+
+        /**
+         * Removes every route to the given listener.
+         *
+         * @param listener
+         *      The listener to remove.
+         *
+         * @return the number of routes removed.
+         */
+        int removeListener(cms::MessageListener* listener);
+
+        /**
+         * @return the number of routes, a listener added under two selectors counts twice.
+         */
+        int getRouteCount() const;
+
+        /**
+         * Sets the listener that receives the messages no route matched, NULL drops them.
+         *
+         * @param listener
+         *      The listener for unmatched messages, not owned by the router.
+         */
+        void setUnmatchedListener(cms::MessageListener* listener);
+
+        cms::MessageListener* getUnmatchedListener() const;
+
+        /**
+         * Sets the listener that is told of errors raised while routing a message.
+         *
+         * @param listener
+         *      The listener for routing errors, not owned by the router.
+         */
+        void setExceptionListener(cms::ExceptionListener* listener);
+
+        cms::ExceptionListener* getExceptionListener() const;
+
+        /**
+         * Delivers the message to every listener whose selector matches it.
+         *
+         * @param message
+         *      The message to route.
+         *
+         * @return the number of listeners the message was delivered to, the unmatched
+         *         listener included.
+         */
+        int route(const cms::Message* message);
+
+        virtual void onMessage(const cms::Message* message);
+
+    private:
+
+        void fireException(const cms::CMSException& ex);
+
+        void deliver(cms::MessageListener* listener, const cms::Message* message);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CMSUTIL_MESSAGESELECTORROUTER_H_ */
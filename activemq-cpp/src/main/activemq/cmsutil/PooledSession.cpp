@@ -41,12 +41,17 @@ using namespace activemq::cmsutil;
 
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession::PooledSession(SessionPool* pool, cms::Session* session) :
-    pool(pool), session(session), producerCache(), consumerCache() {
+    pool(pool), session(session), producerCache(), consumerCache(), producersByIdentity() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession::~PooledSession() {
 
+    std::map<const cms::Destination*, CachedDestination>::iterator identity = producersByIdentity.begin();
+    for (; identity != producersByIdentity.end(); ++identity) {
+        delete identity->second.destination;
+    }
+
     // Destroy cached producers.
     std::auto_ptr<Iterator<CachedProducer*> > producers(producerCache.values().iterator());
     while (producers->hasNext()) {
@@ -91,14 +96,33 @@ cms::MessageProducer* PooledSession::createCachedProducer(const cms::Destination
             throw CMSException("destination is NULL", NULL);
         }
 
+        // Destinations resolved by the template are reused, their address finds the
+        // producer without building the destination's name.
+        CachedDestination& identity = producersByIdentity[destination];
+        if (identity.destination != NULL && identity.destination->equals(*destination)) {
+            if (pool != NULL) {
+                pool->producerCacheHits.incrementAndGet();
+            }
+            return identity.producer;
+        }
+
         std::string key = getUniqueDestName(destination);
 
         // Check the cache - add it if necessary.
         CachedProducer* cachedProducer = NULL;
         try {
             cachedProducer = producerCache.get(key);
+
+            if (pool != NULL) {
+                pool->producerCacheHits.incrementAndGet();
+            }
+
         } catch (decaf::util::NoSuchElementException& e) {
 
+            if (pool != NULL) {
+                pool->producerCacheMisses.incrementAndGet();
+            }
+
             // No producer exists for this destination - start by creating
             // a new producer resource.
             cms::MessageProducer* p = session->createProducer(destination);
@@ -113,6 +137,11 @@ cms::MessageProducer* PooledSession::createCachedProducer(const cms::Destination
             producerCache.put(key, cachedProducer);
         }
 
+        delete identity.destination;
+        identity.destination = NULL;
+        identity.destination = destination->clone();
+        identity.producer = cachedProducer;
+
         return cachedProducer;
     }
     CMSTEMPLATE_CATCHALL()
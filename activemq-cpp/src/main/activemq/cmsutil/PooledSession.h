@@ -24,6 +24,8 @@
 #include <activemq/cmsutil/CachedConsumer.h>
 #include <activemq/util/Config.h>
 
+#include <map>
+
 namespace activemq {
 namespace cmsutil {
 
@@ -45,6 +47,17 @@ namespace cmsutil {
 
         decaf::util::StlMap<std::string, CachedConsumer*> consumerCache;
 
+        struct CachedDestination {
+            cms::Destination* destination;
+            CachedProducer* producer;
+
+            CachedDestination() : destination(NULL), producer(NULL) {}
+        };
+
+        // Cached producers by the address of the destination they were last requested
+        // for, the copy of that destination guards against the address being reused.
+        std::map<const cms::Destination*, CachedDestination> producersByIdentity;
+
     private:
 
         PooledSession(const PooledSession&);
@@ -0,0 +1,485 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Requestor.h"
+
+#include <activemq/threads/TimingWheel.h>
+
+#include <cms/CMSException.h>
+
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/util/UUID.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <memory>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::threads;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+const int Requestor::DEFAULT_MAX_PENDING_REQUESTS = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace cmsutil {
+
+    /**
+     * The requests waiting for replies, shared with the timeout tasks so they can run
+     * after the requestor is gone.  Each slot has its own lock, a request and its reply
+     * only contend when they map to the same slot.
+     */
+    class RequestorImpl {
+    private:
+
+        struct Slot {
+            Mutex mutex;
+            unsigned int sequence;
+            Pointer<Requestor::Reply> reply;
+            Pointer<TimingWheel::Timeout> timeout;
+
+            Slot() : mutex(), sequence(0), reply(), timeout() {}
+        };
+
+        Slot* slots;
+
+        unsigned int mask;
+
+        AtomicInteger nextSequence;
+
+        AtomicInteger pending;
+
+        AtomicBoolean closed;
+
+    private:
+
+        RequestorImpl(const RequestorImpl&);
+        RequestorImpl& operator= (const RequestorImpl&);
+
+    public:
+
+        std::string prefix;
+
+        RequestorImpl(int capacity) : slots(NULL), mask(0), nextSequence(), pending(), closed(), prefix() {
+            unsigned int size = 1;
+            while (size < (unsigned int) capacity) {
+                size <<= 1;
+            }
+
+            this->slots = new Slot[size];
+            this->mask = size - 1;
+            this->prefix = "ID:" + UUID::randomUUID().toString() + ":";
+        }
+
+        ~RequestorImpl() {
+            delete [] this->slots;
+        }
+
+        int getPendingCount() const {
+            return this->pending.get();
+        }
+
+        Pointer<Requestor::Reply> add(const Pointer<RequestorImpl>& self, long long timeout);
+
+        // Completes the request with the given sequence if it is still waiting, taking
+        // ownership of the message only when it returns true.
+        bool complete(unsigned int sequence, Requestor::Reply::State state, cms::Message* message);
+
+        bool complete(const std::string& correlationId, Requestor::Reply::State state, cms::Message* message);
+
+        void close();
+
+    };
+
+    class ReplyTimeoutTask : public Runnable {
+    private:
+
+        Pointer<RequestorImpl> impl;
+
+        unsigned int sequence;
+
+    private:
+
+        ReplyTimeoutTask(const ReplyTimeoutTask&);
+        ReplyTimeoutTask& operator= (const ReplyTimeoutTask&);
+
+    public:
+
+        ReplyTimeoutTask(const Pointer<RequestorImpl>& impl, unsigned int sequence) :
+            Runnable(), impl(impl), sequence(sequence) {}
+
+        virtual ~ReplyTimeoutTask() {}
+
+        virtual void run() {
+            this->impl->complete(this->sequence, Requestor::Reply::TIMED_OUT, NULL);
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Requestor::Reply> RequestorImpl::add(const Pointer<RequestorImpl>& self, long long timeout) {
+
+    if (this->closed.get()) {
+        throw cms::CMSException("The Requestor is closed");
+    }
+
+    // A slot still waiting on an older request is skipped for the next sequence.
+    for (unsigned int attempt = 0; attempt <= this->mask; ++attempt) {
+
+        unsigned int sequence = (unsigned int) this->nextSequence.incrementAndGet();
+        Slot& slot = this->slots[sequence & this->mask];
+
+        synchronized(&slot.mutex) {
+
+            if (slot.reply == NULL) {
+                Pointer<Requestor::Reply> reply(new Requestor::Reply(this->prefix + Long::toString(sequence)));
+                reply->self = reply;
+
+                // Scheduled with the slot locked so the timeout can't find it half filled.
+                if (timeout > 0) {
+                    slot.timeout = TimingWheel::getSharedInstance().schedule(
+                        Pointer<Runnable>(new ReplyTimeoutTask(self, sequence)), timeout);
+                }
+
+                slot.sequence = sequence;
+                slot.reply = reply;
+                this->pending.incrementAndGet();
+
+                return reply;
+            }
+        }
+    }
+
+    throw cms::CMSException("Too many requests are waiting for replies");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RequestorImpl::complete(unsigned int sequence, Requestor::Reply::State state, cms::Message* message) {
+
+    Slot& slot = this->slots[sequence & this->mask];
+
+    Pointer<Requestor::Reply> reply;
+    Pointer<TimingWheel::Timeout> timeout;
+
+    synchronized(&slot.mutex) {
+
+        if (slot.reply == NULL || slot.sequence != sequence) {
+            return false;
+        }
+
+        reply.swap(slot.reply);
+        timeout.swap(slot.timeout);
+        this->pending.decrementAndGet();
+    }
+
+    if (timeout != NULL) {
+        timeout->cancel();
+    }
+
+    return reply->complete(state, message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RequestorImpl::complete(const std::string& correlationId, Requestor::Reply::State state, cms::Message* message) {
+
+    if (correlationId.size() <= this->prefix.size() ||
+        correlationId.compare(0, this->prefix.size(), this->prefix) != 0) {
+
+        return false;
+    }
+
+    unsigned long long sequence = 0;
+    for (std::size_t i = this->prefix.size(); i < correlationId.size(); ++i) {
+        char digit = correlationId[i];
+        if (digit < '0' || digit > '9' || sequence > 0xFFFFFFFFULL) {
+            return false;
+        }
+        sequence = sequence * 10 + (unsigned long long) (digit - '0');
+    }
+
+    if (sequence > 0xFFFFFFFFULL) {
+        return false;
+    }
+
+    return complete((unsigned int) sequence, state, message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorImpl::close() {
+
+    this->closed.set(true);
+
+    for (unsigned int i = 0; i <= this->mask; ++i) {
+
+        unsigned int sequence = 0;
+        bool waiting = false;
+
+        synchronized(&this->slots[i].mutex) {
+            sequence = this->slots[i].sequence;
+            waiting = this->slots[i].reply != NULL;
+        }
+
+        if (waiting) {
+            complete(sequence, Requestor::Reply::FAILED, NULL);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Requestor::Reply::Reply(const std::string& correlationId) :
+    mutex(), correlationId(correlationId), message(NULL), state(PENDING), self() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Requestor::Reply::~Reply() {
+    delete this->message;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Requestor::Reply::State Requestor::Reply::getState() const {
+
+    synchronized(&mutex) {
+        return this->state;
+    }
+
+    return PENDING;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Requestor::Reply::isDone() const {
+    return getState() != PENDING;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* Requestor::Reply::getReply() {
+
+    synchronized(&mutex) {
+        while (this->state == PENDING) {
+            mutex.wait();
+        }
+    }
+
+    return takeReply();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* Requestor::Reply::getReply(long long millisecs) {
+
+    synchronized(&mutex) {
+        if (this->state == PENDING && millisecs > 0) {
+            mutex.wait(millisecs);
+        }
+
+        if (this->state == PENDING) {
+            return NULL;
+        }
+    }
+
+    return takeReply();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* Requestor::Reply::takeReply() {
+
+    synchronized(&mutex) {
+
+        if (this->state == TIMED_OUT) {
+            throw cms::CMSException("No reply was received before the request timed out");
+        } else if (this->state == FAILED) {
+            throw cms::CMSException("The request failed before its reply was received");
+        }
+
+        cms::Message* reply = this->message;
+        this->message = NULL;
+        return reply;
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Requestor::Reply::complete(State state, cms::Message* message) {
+
+    Pointer<Reply> keep;
+
+    synchronized(&mutex) {
+
+        if (this->state != PENDING) {
+            return false;
+        }
+
+        this->state = state;
+        this->message = message;
+        keep.swap(this->self);
+        mutex.notifyAll();
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Requestor::Requestor(cms::Connection* connection, int maxPendingRequests) :
+    MessageListener(), impl(), session(NULL), replySession(NULL), producer(NULL),
+    replyQueue(NULL), consumer(NULL), sendMutex(), closed(false) {
+
+    if (connection == NULL) {
+        throw cms::CMSException("The connection can't be NULL");
+    }
+
+    if (maxPendingRequests < 1) {
+        throw cms::CMSException("The number of pending requests must be at least one");
+    }
+
+    this->impl.reset(new RequestorImpl(maxPendingRequests));
+
+    try {
+        this->session = connection->createSession(cms::Session::AUTO_ACKNOWLEDGE);
+        this->producer = this->session->createProducer(NULL);
+
+        this->replySession = connection->createSession(cms::Session::AUTO_ACKNOWLEDGE);
+        this->replyQueue = this->replySession->createTemporaryQueue();
+        if (this->replyQueue == NULL) {
+            throw cms::CMSException("Failed to create the reply queue");
+        }
+
+        this->consumer = this->replySession->createConsumer(this->replyQueue);
+        this->consumer->setMessageListener(this);
+
+    } catch (...) {
+        delete this->consumer;
+        delete this->replyQueue;
+        delete this->replySession;
+        delete this->producer;
+        delete this->session;
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Requestor::~Requestor() {
+
+    try {
+        close();
+    } catch (...) {
+    }
+
+    delete this->consumer;
+    delete this->replyQueue;
+    delete this->replySession;
+    delete this->producer;
+    delete this->session;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Requestor::Reply> Requestor::request(const cms::Destination* destination,
+                                             cms::Message* message, long long timeout) {
+
+    if (destination == NULL || message == NULL) {
+        throw cms::CMSException("The destination and message can't be NULL");
+    }
+
+    Pointer<Reply> reply = this->impl->add(this->impl, timeout);
+
+    try {
+
+        message->setCMSReplyTo(this->replyQueue);
+        message->setCMSCorrelationID(reply->getCorrelationId());
+
+        synchronized(&sendMutex) {
+            this->producer->send(destination, message);
+        }
+
+    } catch (...) {
+        this->impl->complete(reply->getCorrelationId(), Reply::FAILED, NULL);
+        throw;
+    }
+
+    return reply;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* Requestor::sendAndReceive(const cms::Destination* destination,
+                                        cms::Message* message, long long timeout) {
+
+    return request(destination, message, timeout)->getReply();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const cms::Destination* Requestor::getReplyDestination() const {
+    return this->replyQueue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Requestor::getPendingCount() const {
+    return this->impl->getPendingCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Requestor::close() {
+
+    if (this->closed) {
+        return;
+    }
+
+    this->closed = true;
+
+    try {
+        this->consumer->close();
+        this->impl->close();
+
+        synchronized(&sendMutex) {
+            this->producer->close();
+        }
+
+        this->replyQueue->destroy();
+        this->replySession->close();
+        this->session->close();
+
+    } catch (...) {
+        this->impl->close();
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Requestor::onMessage(const cms::Message* message) {
+
+    if (message == NULL) {
+        return;
+    }
+
+    try {
+
+        std::string correlationId = message->getCMSCorrelationID();
+        std::auto_ptr<cms::Message> reply(message->clone());
+
+        if (this->impl->complete(correlationId, Reply::REPLIED, reply.get())) {
+            reply.release();
+        }
+
+    } catch (...) {
+        // A reply that can't be read is treated as one for an unknown request.
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CMSUTIL_REQUESTOR_H_
+#define _ACTIVEMQ_CMSUTIL_REQUESTOR_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/Connection.h>
+#include <cms/Destination.h>
+#include <cms/Message.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageListener.h>
+#include <cms/MessageProducer.h>
+#include <cms/Session.h>
+#include <cms/TemporaryQueue.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <string>
+
+namespace activemq {
+namespace cmsutil {
+
+    class RequestorImpl;
+
+    /**
+     * Sends requests and matches them with their replies, with any number of requests
+     * waiting for replies at once.  A single Requestor is meant to be shared by all the
+     * threads of an application making requests on a connection, it consumes all the
+     * replies from one temporary queue created when it is constructed.
+     *
+     * Each request is sent with the reply queue as its CMSReplyTo and a correlation id
+     * made of the requestor's id and a sequence number, which the responder must copy
+     * into the reply's CMSCorrelationID.  The sequence number picks the slot the request
+     * waits in, so matching a reply takes no shared lock.  Request timeouts are kept on
+     * the shared TimingWheel, a reply arriving after its request timed out is dropped.
+     *
+     * The connection must be started for replies to be received.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API Requestor : public cms::MessageListener {
+    public:
+
+        /**
+         * The default number of requests that can be waiting for replies at once.
+         */
+        static const int DEFAULT_MAX_PENDING_REQUESTS;
+
+        /**
+         * The reply to a request, completed when the reply arrives, the request times
+         * out or the requestor is closed.
+         */
+        class AMQCPP_API Reply {
+        public:
+
+            enum State {
+                PENDING,
+                REPLIED,
+                TIMED_OUT,
+                FAILED
+            };
+
+        private:
+
+            mutable decaf::util::concurrent::Mutex mutex;
+
+            std::string correlationId;
+
+            cms::Message* message;
+
+            State state;
+
+            // Keeps the reply alive while it is pending, cleared once it completes.
+            decaf::lang::Pointer<Reply> self;
+
+        private:
+
+            Reply(const Reply&);
+            Reply& operator= (const Reply&);
+
+            friend class RequestorImpl;
+
+        public:
+
+            Reply(const std::string& correlationId);
+
+            virtual ~Reply();
+
+            /**
+             * @return the correlation id the request was sent with.
+             */
+            const std::string& getCorrelationId() const {
+                return this->correlationId;
+            }
+
+            State getState() const;
+
+            /**
+             * @return true once the reply is no longer pending.
+             */
+            bool isDone() const;
+
+            /**
+             * Waits for the reply.  The caller takes ownership of the reply message,
+             * later calls return NULL.
+             *
+             * @return the reply message.
+             *
+             * @throws CMSException if the request timed out or failed.
+             */
+            cms::Message* getReply();
+
+            /**
+             * Waits for the reply for at most the given time.  The caller takes ownership
+             * of the reply message, later calls return NULL.
+             *
+             * @param millisecs
+             *      The time in milliseconds to wait for the reply.
+             *
+             * @return the reply message, or NULL if it is still pending.
+             *
+             * @throws CMSException if the request timed out or failed.
+             */
+            cms::Message* getReply(long long millisecs);
+
+        private:
+
+            // Takes ownership of the message only when it completes the reply.
+            bool complete(State state, cms::Message* message);
+
+            cms::Message* takeReply();
+
+        };
+
+    private:
+
+        decaf::lang::Pointer<RequestorImpl> impl;
+
+        cms::Session* session;
+
+        cms::Session* replySession;
+
+        cms::MessageProducer* producer;
+
+        cms::TemporaryQueue* replyQueue;
+
+        cms::MessageConsumer* consumer;
+
+        decaf::util::concurrent::Mutex sendMutex;
+
+        bool closed;
+
+    private:
+
+        Requestor(const Requestor&);
+        Requestor& operator= (const Requestor&);
+
+    public:
+
+        /**
+         * Creates a requestor with its own sessions, producer and reply queue.
+         *
+         * @param connection
+         *      The connection to make requests on, not owned by the requestor.
+         * @param maxPendingRequests
+         *      The number of requests that can be waiting for replies at once, rounded
+         *      up to a power of two.
+         *
+         * @throws CMSException if the sessions or reply queue can't be created.
+         */
+        Requestor(cms::Connection* connection, int maxPendingRequests = DEFAULT_MAX_PENDING_REQUESTS);
+
+        /**
+         * Closes the requestor if it wasn't already, ignoring any error doing so.
+         */
+        virtual ~Requestor();
+
+        /**
+         * Sends a request without waiting for its reply.
+         *
+         * @param destination
+         *      The destination to send the request to.
+         * @param message
+         *      The request, its CMSReplyTo and CMSCorrelationID are replaced.
+         * @param timeout
+         *      The time in milliseconds to wait for the reply, zero or less waits forever.
+         *
+         * @return the reply to the request.
+         *
+         * @throws CMSException if the request can't be sent, the requestor is closed or
+         *         too many requests are waiting for replies.
+         */
+        decaf::lang::Pointer<Reply> request(const cms::Destination* destination,
+                                            cms::Message* message, long long timeout);
+
+        /**
+         * Sends a request and waits for its reply.
+         *
+         * @param destination
+         *      The destination to send the request to.
+         * @param message
+         *      The request, its CMSReplyTo and CMSCorrelationID are replaced.
+         * @param timeout
+         *      The time in milliseconds to wait for the reply, zero or less waits forever.
+         *
+         * @return the reply message, owned by the caller.
+         *
+         * @throws CMSException if the request can't be sent or times out.
+         */
+        cms::Message* sendAndReceive(const cms::Destination* destination,
+                                     cms::Message* message, long long timeout);
+
+        /**
+         * @return the temporary queue the replies are received from.
+         */
+        const cms::Destination* getReplyDestination() const;
+
+        /**
+         * @return the number of requests waiting for replies.
+         */
+        int getPendingCount() const;
+
+        /**
+         * Stops receiving replies and fails the requests still waiting for them.
+         *
+         * @throws CMSException if the requestor's resources fail to close.
+         */
+        void close();
+
+        /**
+         * Completes the request the given reply belongs to.
+         */
+        virtual void onMessage(const cms::Message* message);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CMSUTIL_REQUESTOR_H_ */
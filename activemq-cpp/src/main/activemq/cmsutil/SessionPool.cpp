@@ -30,7 +30,13 @@ SessionPool::SessionPool(cms::Connection* connection,
       mutex(),
       available(),
       sessions(),
-      acknowledgeMode(ackMode) {
+      acknowledgeMode(ackMode),
+      threadSession(),
+      threadAffinity(true),
+      threadSessionTakes(),
+      sharedSessionTakes(),
+      producerCacheHits(),
+      producerCacheMisses() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +60,20 @@ SessionPool::~SessionPool() {
 ////////////////////////////////////////////////////////////////////////////////
 PooledSession* SessionPool::takeSession() {
 
+    if (threadAffinity) {
+
+        // Take back the session this thread returned last, no other thread can.
+        PooledSession*& kept = threadSession.get();
+        if (kept != NULL) {
+            PooledSession* pooledSession = kept;
+            kept = NULL;
+            threadSessionTakes.incrementAndGet();
+            return pooledSession;
+        }
+    }
+
+    sharedSessionTakes.incrementAndGet();
+
     synchronized(&mutex) {
 
         PooledSession* pooledSession = NULL;
@@ -93,8 +113,28 @@ PooledSession* SessionPool::takeSession() {
 ////////////////////////////////////////////////////////////////////////////////
 void SessionPool::returnSession(PooledSession* session) {
 
+    if (threadAffinity) {
+
+        // Keep the session for this thread's next take if it isn't keeping one.
+        PooledSession*& kept = threadSession.get();
+        if (kept == NULL) {
+            kept = session;
+            return;
+        }
+    }
+
     synchronized(&mutex) {
         // Add to the available list.
         available.push_back(session);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+int SessionPool::getSessionCount() const {
+
+    synchronized(&mutex) {
+        return (int) sessions.size();
+    }
+
+    return 0;
+}
@@ -19,7 +19,9 @@
 #define _ACTIVEMQ_CMSUTIL_SESSIONPOOL_H_
 
 #include <activemq/cmsutil/PooledSession.h>
+#include <decaf/lang/ThreadLocal.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <cms/Connection.h>
 #include <list>
 #include <activemq/util/Config.h>
@@ -35,6 +37,12 @@ namespace cmsutil {
      * acknowledge mode.  Internal session resources are managed through a
      * provided <code>ResourceLifecycleManager</code>, not by this pool.  This
      * class is thread-safe.
+     *
+     * With thread affinity, the default, a thread returning a session keeps it and
+     * takes the same session back the next time without taking the pool's lock, so
+     * its cached producers stay warm.  Only the sessions a thread can't keep are
+     * shared through the pool.  A session kept by a thread that never uses the pool
+     * again is only released when the pool is destroyed.
      */
     class AMQCPP_API SessionPool {
     private:
@@ -43,7 +51,7 @@ namespace cmsutil {
 
         ResourceLifecycleManager* resourceLifecycleManager;
 
-        decaf::util::concurrent::Mutex mutex;
+        mutable decaf::util::concurrent::Mutex mutex;
 
         std::list<PooledSession*> available;
 
@@ -51,8 +59,23 @@ namespace cmsutil {
 
         cms::Session::AcknowledgeMode acknowledgeMode;
 
+        // The session the current thread returned last, if it hasn't taken it back.
+        decaf::lang::ThreadLocal<PooledSession*> threadSession;
+
+        bool threadAffinity;
+
+        decaf::util::concurrent::atomic::AtomicInteger threadSessionTakes;
+
+        decaf::util::concurrent::atomic::AtomicInteger sharedSessionTakes;
+
+        decaf::util::concurrent::atomic::AtomicInteger producerCacheHits;
+
+        decaf::util::concurrent::atomic::AtomicInteger producerCacheMisses;
+
     private:
 
+        friend class PooledSession;
+
         SessionPool(const SessionPool&);
         SessionPool& operator=(const SessionPool&);
 
@@ -99,6 +122,54 @@ namespace cmsutil {
             return resourceLifecycleManager;
         }
 
+        /**
+         * Sets whether threads keep the sessions they return, must be set before the
+         * pool is first used.
+         *
+         * @param threadAffinity
+         *          true to hand a thread back the session it returned last.
+         */
+        void setThreadAffinity(bool threadAffinity) {
+            this->threadAffinity = threadAffinity;
+        }
+
+        bool isThreadAffinity() const {
+            return this->threadAffinity;
+        }
+
+        /**
+         * @return the number of sessions the pool has created.
+         */
+        int getSessionCount() const;
+
+        /**
+         * @return the number of takes served by the session the taking thread kept.
+         */
+        int getThreadSessionTakes() const {
+            return this->threadSessionTakes.get();
+        }
+
+        /**
+         * @return the number of takes that went through the shared pool.
+         */
+        int getSharedSessionTakes() const {
+            return this->sharedSessionTakes.get();
+        }
+
+        /**
+         * @return the number of cached producer requests served from a session's cache.
+         */
+        int getProducerCacheHits() const {
+            return this->producerCacheHits.get();
+        }
+
+        /**
+         * @return the number of cached producer requests that created a producer.
+         */
+        int getProducerCacheMisses() const {
+            return this->producerCacheMisses.get();
+        }
+
     };
 
 }}
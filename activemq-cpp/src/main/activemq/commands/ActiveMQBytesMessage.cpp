@@ -16,7 +16,9 @@
  */
 #include <activemq/commands/ActiveMQBytesMessage.h>
 
+#include <activemq/util/BlockCompressionCodec.h>
 #include <activemq/util/CMSExceptionSupport.h>
+#include <activemq/util/CompressionCodec.h>
 
 #include <decaf/io/FilterOutputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
@@ -69,11 +71,41 @@ namespace {
         }
 
     };
+
+    // Appends whatever is written to it onto the end of a vector.
+    class VectorOutputStream : public OutputStream {
+    private:
+
+        std::vector<unsigned char>* target;
+
+    private:
+
+        VectorOutputStream(const VectorOutputStream&);
+        VectorOutputStream& operator= (const VectorOutputStream&);
+
+    public:
+
+        VectorOutputStream(std::vector<unsigned char>* target) : OutputStream(), target(target) {
+        }
+
+        virtual ~VectorOutputStream() {}
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value) {
+            this->target->push_back(value);
+        }
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size DECAF_UNUSED, int offset, int length) {
+            this->target->insert(this->target->end(), buffer + offset, buffer + offset + length);
+        }
+
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQBytesMessage::ActiveMQBytesMessage() :
-    ActiveMQMessageTemplate<cms::BytesMessage>(), bytesOut(NULL), dataIn(), dataOut(), length(0) {
+    ActiveMQMessageTemplate<cms::BytesMessage>(), bytesOut(NULL), dataIn(), dataOut(), deflater(NULL), uncompressed(), length(0) {
 
     this->clearBody();
 }
@@ -81,7 +113,12 @@ ActiveMQBytesMessage::ActiveMQBytesMessage() :
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQBytesMessage::~ActiveMQBytesMessage() throw() {
     try {
-        this->reset();
+        // The connection may already be gone, so an unfinished body's compression
+        // context is deleted here rather than handed back to its pool.
+        this->dataIn.reset(NULL);
+        this->dataOut.reset(NULL);
+        this->bytesOut = NULL;
+        delete this->deflater;
     }
     AMQ_CATCHALL_NOTHROW()
 }
@@ -148,6 +185,32 @@ void ActiveMQBytesMessage::setBodyBytes(const unsigned char* buffer, int numByte
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessage::attachBodyBytes(const unsigned char* buffer, int numBytes,
+                                           util::CopyOnWriteBytes::Releaser* releaser) {
+
+    try {
+
+        this->failIfReadOnlyBody();
+
+        if (numBytes < 0) {
+            throw cms::CMSException("The length of an attached body can't be negative");
+        }
+
+        // Drop whatever was written so far, the attached bytes are the whole body.
+        this->dataOut.reset(NULL);
+        this->bytesOut = NULL;
+        this->releaseDeflater();
+        this->dataIn.reset(NULL);
+        this->uncompressed.clear();
+        this->length = 0;
+
+        this->compressed = false;
+        this->content.attach(buffer, (std::size_t) numBytes, releaser);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned char* ActiveMQBytesMessage::getBodyBytes() const {
 
@@ -168,6 +231,36 @@ unsigned char* ActiveMQBytesMessage::getBodyBytes() const {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* ActiveMQBytesMessage::getBodyView(int& length) const {
+
+    try {
+
+        initializeReading();
+
+        length = this->length;
+        if (length == 0) {
+            return NULL;
+        }
+
+        if (!this->isCompressed()) {
+            return this->getContentBytes().data();
+        }
+
+        // Most codecs were decoded whole by initializeReading, zlib bodies and block
+        // compressed bodies read incrementally are decoded as they are read so the view
+        // needs its own decoded copy.
+        if (this->uncompressed.size() != (std::size_t) length) {
+            std::vector<unsigned char> body;
+            this->decompressContent(4, body, length);
+            this->uncompressed.swap(body);
+        }
+
+        return &this->uncompressed[0];
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ActiveMQBytesMessage::getBodyLength() const {
 
@@ -186,7 +279,9 @@ void ActiveMQBytesMessage::clearBody() {
 
     this->dataOut.reset(NULL);
     this->bytesOut = NULL;
+    this->releaseDeflater();
     this->dataIn.reset(NULL);
+    this->uncompressed.clear();
     this->length = 0;
 }
 
@@ -204,6 +299,8 @@ void ActiveMQBytesMessage::reset() {
         this->bytesOut = NULL;
         this->dataIn.reset(NULL);
         this->dataOut.reset(NULL);
+        this->releaseDeflater();
+        this->uncompressed.clear();
         this->length = 0;
         this->setReadOnlyBody(true);
     }
@@ -599,30 +696,71 @@ void ActiveMQBytesMessage::storeContent() {
                 this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
                 delete[] array.first;
 
-            } else {
+            } else if (this->deflater == NULL) {
 
-                ByteArrayOutputStream buffer;
-                DataOutputStream doBuffer(&buffer);
+                // Written uncompressed, the connection's codec compresses it in one go
+                // after the length of the written data.
+                std::pair<unsigned char*, int> array = this->bytesOut->toByteArray();
+                this->length = array.second;
 
-                // Start by writing the length of the written data before compression.
-                doBuffer.writeInt((int) this->length);
+                std::vector<unsigned char>& content = this->getContent();
+                content.clear();
+                content.push_back((unsigned char) ((this->length >> 24) & 0xFF));
+                content.push_back((unsigned char) ((this->length >> 16) & 0xFF));
+                content.push_back((unsigned char) ((this->length >> 8) & 0xFF));
+                content.push_back((unsigned char) (this->length & 0xFF));
 
-                // Now write the Compressed bytes.
-                this->bytesOut->writeTo(&doBuffer);
+                try {
+                    const unsigned char* buffers[1] = { array.first };
+                    this->compressContent(buffers, &array.second, 1);
+                } catch (...) {
+                    delete[] array.first;
+                    throw;
+                }
 
-                // Now store the annotated content.
-                std::pair<unsigned char*, int> array = buffer.toByteArray();
-                this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
                 delete[] array.first;
+
+            } else {
+
+                // Start with the length of the written data before compression, then
+                // the compressed bytes, building the annotated content in place.
+                std::vector<unsigned char>& content = this->getContent();
+                content.clear();
+                content.reserve(4 + (std::size_t) this->bytesOut->size());
+
+                content.push_back((unsigned char) ((this->length >> 24) & 0xFF));
+                content.push_back((unsigned char) ((this->length >> 16) & 0xFF));
+                content.push_back((unsigned char) ((this->length >> 8) & 0xFF));
+                content.push_back((unsigned char) (this->length & 0xFF));
+
+                VectorOutputStream target(&content);
+                this->bytesOut->writeTo(&target);
+
+                this->setCompressionCodecName(CompressionCodec::ZLIB);
             }
 
             this->dataOut.reset(NULL);
             this->bytesOut = NULL;
+            this->releaseDeflater();
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessage::releaseDeflater() {
+
+    // Only called once the streams that used the Deflater have been destroyed.
+    if (this->deflater != NULL) {
+        if (this->connection != NULL) {
+            this->connection->getCompressionPool().returnDeflater(this->deflater);
+        } else {
+            delete this->deflater;
+        }
+        this->deflater = NULL;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQBytesMessage::initializeReading() const {
 
@@ -638,10 +776,37 @@ void ActiveMQBytesMessage::initializeReading() const {
                     DataInputStream dis(is);
                     this->length = dis.readInt();
                 } catch (IOException& ex) {
+                    delete is;
                     throw CMSExceptionSupport::create(ex);
                 }
 
-                is = new InflaterInputStream(is, true);
+                // zlib bodies are inflated as they are read, as are block compressed
+                // bodies a block at a time when the connection asks for it, other codecs
+                // decode the whole body up front.
+                std::string codecName = this->getCompressionCodecName();
+                if (codecName == CompressionCodec::ZLIB) {
+                    is = new InflaterInputStream(is, true);
+                } else {
+                    delete is;
+                    is = NULL;
+
+                    BlockCompressionCodec* blockCodec = NULL;
+                    if (this->connection != NULL && this->connection->isIncrementalDecompression() &&
+                        BlockCompressionCodec::isBlockCodecName(codecName)) {
+                        blockCodec = dynamic_cast<BlockCompressionCodec*>(
+                            &this->connection->getCompressionCodecInstance(codecName));
+                    }
+
+                    if (blockCodec != NULL) {
+                        const std::vector<unsigned char>& content = this->getContent();
+                        is = blockCodec->createInputStream(
+                            content.size() > 4 ? &content[4] : NULL, (int) content.size() - 4, this->length);
+                    } else {
+                        this->uncompressed.clear();
+                        this->decompressContent(4, this->uncompressed, this->length);
+                        is = new ByteArrayInputStream(this->uncompressed);
+                    }
+                }
 
             } else {
                 this->length = (int) this->getContent().size();
@@ -666,13 +831,27 @@ void ActiveMQBytesMessage::initializeWriting() {
             if (this->connection != NULL && this->connection->isUseCompression()) {
                 this->compressed = true;
 
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
+                // zlib compresses as the body is written, other codecs compress the whole
+                // body when it is stored, as does zlib when large bodies may be compressed
+                // in blocks.
+                if (this->connection->getCompressionCodec() == CompressionCodec::ZLIB &&
+                    this->connection->getCompressionBlockSize() == 0) {
+                    this->deflater = this->connection->getCompressionPool().takeDeflater(
+                        this->connection->getCompressionLevel());
 
-                os = new DeflaterOutputStream(os, deflator, true, true);
-                os = new ByteCounterOutputStream(&length, os, true);
+                    os = new DeflaterOutputStream(os, this->deflater, false, true);
+                    os = new ByteCounterOutputStream(&length, os, true);
+                }
             }
 
             this->dataOut.reset(new DataOutputStream(os, true));
+
+            // Writing after a body was attached appends to it.
+            if (this->content.isAttached()) {
+                int size = (int) this->content.size();
+                this->dataOut->write(this->content.data(), size, 0, size);
+                this->content.clear();
+            }
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -23,6 +23,7 @@
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
+#include <decaf/util/zip/Deflater.h>
 #include <cms/BytesMessage.h>
 #include <vector>
 #include <string>
@@ -50,6 +51,17 @@ namespace commands {
          */
         std::auto_ptr<decaf::io::DataOutputStream> dataOut;
 
+        /**
+         * Compression context taken from the connection's pool while a compressed
+         * body is being written, handed back once the body is stored.
+         */
+        decaf::util::zip::Deflater* deflater;
+
+        /**
+         * Body decoded up front when it was compressed with a codec other than zlib.
+         */
+        mutable std::vector<unsigned char> uncompressed;
+
         /**
          * Tracks the actual length of the Message when compressed.
          */
@@ -88,6 +100,48 @@ namespace commands {
 
         virtual void onSend();
 
+        /**
+         * Makes the given bytes the body of this message without copying them, they are
+         * shared by the copies of the message made while sending it and written from
+         * where they are to the transport.  The bytes must stay valid and unchanged
+         * until the releaser is called, which happens once the message and every copy
+         * of it are destroyed or their bodies are replaced.
+         *
+         * An attached body is always sent uncompressed.  Reading the body, or writing
+         * more to it, copies the bytes into the message first.
+         *
+         * @param buffer
+         *      The bytes of the body.
+         * @param numBytes
+         *      The number of bytes in the body.
+         * @param releaser
+         *      Told when the bytes are no longer used, or NULL when the caller keeps them
+         *      valid for as long as the message and its copies may use them.
+         *
+         * @throws CMSException if numBytes is negative.
+         * @throws MessageNotWriteableException if the body is read only.
+         */
+        void attachBodyBytes(const unsigned char* buffer, int numBytes, util::CopyOnWriteBytes::Releaser* releaser);
+
+        /**
+         * Returns the body of the message without copying it, unlike getBodyBytes which
+         * returns a new copy each time.  A compressed body is decompressed once and kept
+         * for later calls.  Reading the body through the view doesn't move the position
+         * the read methods read from.
+         *
+         * The bytes are valid until the body is cleared, reset or written to, or the
+         * message is destroyed.
+         *
+         * @param length
+         *      Set to the number of bytes in the body.
+         *
+         * @return the first byte of the body, or NULL if the body is empty.
+         *
+         * @throws CMSException if the body can't be decompressed.
+         * @throws MessageNotReadableException if the message is in write only mode.
+         */
+        const unsigned char* getBodyView(int& length) const;
+
     public:   // CMS BytesMessage
 
         virtual void setBodyBytes(const unsigned char* buffer, int numBytes);
@@ -158,6 +212,8 @@ namespace commands {
 
         void initializeWriting();
 
+        void releaseDeflater();
+
     };
 
 }}
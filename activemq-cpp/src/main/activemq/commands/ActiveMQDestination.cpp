@@ -93,6 +93,7 @@ ActiveMQDestination::~ActiveMQDestination() throw() {
 void ActiveMQDestination::setPhysicalName(const std::string& physicalName) {
 
     this->physicalName = physicalName;
+    this->options.clear();
 
     size_t pos = physicalName.find_first_of('?');
     if (pos != std::string::npos) {
@@ -156,7 +157,7 @@ bool ActiveMQDestination::equals(const DataStructure* value) const {
         return false;
     }
 
-    return this->getPhysicalName() == valuePtr->getPhysicalName();
+    return this->equals(*valuePtr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,15 +283,66 @@ int ActiveMQDestination::compareTo(const ActiveMQDestination& value) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQDestination::equals(const ActiveMQDestination& value) const {
-    return this->getPhysicalName() == value.getPhysicalName();
+
+    // Interned destinations are the same instance, names that hash apart can't match.
+    if (this == &value) {
+        return true;
+    }
+
+    return this->hashCode == value.hashCode && this->getPhysicalName() == value.getPhysicalName();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQDestination::operator==(const ActiveMQDestination& value) const {
-    return this->getPhysicalName() == value.getPhysicalName();
+    return this->equals(value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQDestination::operator<(const ActiveMQDestination& value) const {
     return this->compareTo(value) < 0;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQDestination::matchesWildcard(const std::string& pattern, const std::string& name) {
+
+    std::string::size_type patternStart = 0;
+    std::string::size_type nameStart = 0;
+
+    // Walks both paths an element at a time in place, the names of a large destination
+    // set are matched without splitting them up.
+    while (true) {
+
+        std::string::size_type patternEnd = pattern.find('.', patternStart);
+        if (patternEnd == std::string::npos) {
+            patternEnd = pattern.size();
+        }
+
+        std::string::size_type length = patternEnd - patternStart;
+        if (pattern.compare(patternStart, length, DestinationFilter::ANY_CHILD) == 0) {
+            return true;
+        }
+
+        std::string::size_type nameEnd = name.find('.', nameStart);
+        if (nameEnd == std::string::npos) {
+            nameEnd = name.size();
+        }
+
+        if (pattern.compare(patternStart, length, DestinationFilter::ANY_DESCENDENT) != 0 &&
+            pattern.compare(patternStart, length, name, nameStart, nameEnd - nameStart) != 0) {
+            return false;
+        }
+
+        bool patternDone = patternEnd == pattern.size();
+        bool nameDone = nameEnd == name.size();
+
+        if (nameDone) {
+            return patternDone ||
+                   pattern.compare(patternEnd + 1, std::string::npos, DestinationFilter::ANY_CHILD) == 0;
+        } else if (patternDone) {
+            return false;
+        }
+
+        patternStart = patternEnd + 1;
+        nameStart = nameEnd + 1;
+    }
+}
@@ -112,7 +112,7 @@ namespace commands {
          * Fetch this destination's physical name
          * @return const string containing the name
          */
-        virtual std::string getPhysicalName() const {
+        virtual const std::string& getPhysicalName() const {
             return this->physicalName;
         }
 
@@ -311,6 +311,20 @@ namespace commands {
          */
         static Pointer<ActiveMQDestination> createDestination(int type, const std::string& name);
 
+        /**
+         * Tells if a destination name matches a wildcard pattern.  Both are paths of
+         * elements separated by dots, a '*' element of the pattern matches any one element
+         * of the name and a final '>' element matches whatever is left of it.
+         *
+         * @param pattern
+         *      The wildcard pattern, a plain name only matches itself.
+         * @param name
+         *      The physical name of the destination.
+         *
+         * @return true if the name matches the pattern.
+         */
+        static bool matchesWildcard(const std::string& pattern, const std::string& name);
+
     };
 
 }}
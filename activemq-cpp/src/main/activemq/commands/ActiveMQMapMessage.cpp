@@ -22,11 +22,8 @@
 
 #include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/io/ByteArrayOutputStream.h>
-#include <decaf/io/BufferedInputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
 
 using namespace std;
 using namespace decaf;
@@ -47,7 +44,8 @@ using namespace activemq::wireformat::openwire::marshal;
 const unsigned char ActiveMQMapMessage::ID_ACTIVEMQMAPMESSAGE = 25;
 
 ////////////////////////////////////////////////////////////////////////////////
-ActiveMQMapMessage::ActiveMQMapMessage() : ActiveMQMessageTemplate<cms::MapMessage>(), map() {
+ActiveMQMapMessage::ActiveMQMapMessage() :
+    ActiveMQMessageTemplate<cms::MapMessage>(), map(), index(), indexed(), uncompressed(), modified(false) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,8 +78,13 @@ void ActiveMQMapMessage::copyDataStructure(const DataStructure* src) {
 
     const ActiveMQMapMessage* srcMap = dynamic_cast<const ActiveMQMapMessage*>(src);
 
-    if (srcMap != NULL && srcMap->map.get() != NULL) {
-        this->map.reset(new util::PrimitiveMap(*srcMap->map));
+    this->index.reset(NULL);
+    this->indexed.reset(NULL);
+    this->uncompressed.clear();
+
+    if (srcMap != NULL) {
+        this->map.reset(srcMap->map.get() != NULL ? new util::PrimitiveMap(*srcMap->map) : NULL);
+        this->modified = srcMap->modified;
     }
 }
 
@@ -112,33 +115,48 @@ void ActiveMQMapMessage::beforeMarshal(WireFormat* wireFormat) {
 
     try {
 
-        // Let the base class do its thing.
-        ActiveMQMessageTemplate<cms::MapMessage>::beforeMarshal(wireFormat);
+        // A map that was never changed still has the content it arrived with.
+        if (map.get() == NULL || !this->modified) {
+            ActiveMQMessageTemplate<cms::MapMessage>::beforeMarshal(wireFormat);
+            return;
+        }
 
-        if (map.get() != NULL && !map->isEmpty()) {
+        if (!map->isEmpty()) {
 
-            ByteArrayOutputStream* bytesOut = new ByteArrayOutputStream();
+            ByteArrayOutputStream bytesOut;
+            DataOutputStream dataOut(&bytesOut);
+            PrimitiveTypesMarshaller::marshalMap(map.get(), dataOut);
+            dataOut.close();
 
-            OutputStream* os = bytesOut;
+            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
 
-            if (this->connection != NULL && this->connection->isUseCompression()) {
-                this->compressed = true;
+            try {
 
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
+                if (this->connection != NULL && this->connection->isUseCompression()) {
+                    this->compressed = true;
 
-                os = new DeflaterOutputStream(os, deflator, true, true);
-            }
+                    const unsigned char* buffers[1] = { array.first };
+                    this->getContent().clear();
+                    this->compressContent(buffers, &array.second, 1);
+                } else {
+                    this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
+                }
 
-            DataOutputStream dataOut(os, true);
-            PrimitiveTypesMarshaller::marshalMap(map.get(), dataOut);
-            dataOut.close();
+            } catch (...) {
+                delete[] array.first;
+                throw;
+            }
 
-            std::pair<unsigned char*, int> array = bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
             delete[] array.first;
         } else {
             clearBody();
         }
+
+        this->modified = false;
+
+        // Let the base class do its thing, last as compressing the body may have set
+        // the codec property.
+        ActiveMQMessageTemplate<cms::MapMessage>::beforeMarshal(wireFormat);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
@@ -150,6 +168,9 @@ PrimitiveMap& ActiveMQMapMessage::getMap() {
 
     try {
         this->checkMapIsUnmarshalled();
+
+        // Handed out to be changed, the content has to be encoded again.
+        this->modified = true;
         return *map;
     }
     AMQ_CATCH_RETHROW(NullPointerException)
@@ -176,11 +197,14 @@ void ActiveMQMapMessage::checkMapIsUnmarshalled() const {
 
         if (map.get() == NULL && !getContent().empty()) {
 
-            InputStream* is = new ByteArrayInputStream(getContent());
+            std::vector<unsigned char> uncompressed;
+            InputStream* is = NULL;
 
             if (isCompressed()) {
-                is = new InflaterInputStream(is, true);
-                is = new BufferedInputStream(is, true);
+                this->decompressContent(0, uncompressed);
+                is = new ByteArrayInputStream(uncompressed);
+            } else {
+                is = new ByteArrayInputStream(getContent());
             }
 
             DataInputStream dataIn(is, true);
@@ -195,17 +219,69 @@ void ActiveMQMapMessage::checkMapIsUnmarshalled() const {
         } else if (map.get() == NULL) {
             map.reset(new PrimitiveMap());
         }
+
+        // Reads go to the whole map from now on.
+        this->index.reset(NULL);
+        this->indexed.reset(NULL);
+        this->uncompressed.clear();
     }
     AMQ_CATCH_RETHROW(NullPointerException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, NullPointerException)
     AMQ_CATCHALL_THROW(NullPointerException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMapMessage::checkMapIsIndexed() const {
+
+    if (map.get() != NULL || index.get() != NULL) {
+        return;
+    }
+
+    std::auto_ptr< std::map<std::string, int> > offsets(new std::map<std::string, int>());
+
+    if (!getContent().empty()) {
+
+        if (isCompressed() && this->uncompressed.empty()) {
+            this->decompressContent(0, this->uncompressed);
+        }
+
+        const std::vector<unsigned char>& buffer = isCompressed() ? this->uncompressed : getContent();
+        if (!buffer.empty()) {
+            PrimitiveTypesMarshaller::indexMap(&buffer[0], (int) buffer.size(), *offsets);
+        }
+    }
+
+    this->indexed.reset(new PrimitiveMap());
+    this->index = offsets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const PrimitiveMap& ActiveMQMapMessage::getEntries(const std::string& name) const {
+
+    checkMapIsIndexed();
+
+    if (map.get() != NULL) {
+        return *map;
+    }
+
+    if (!this->indexed->containsKey(name)) {
+        std::map<std::string, int>::const_iterator entry = this->index->find(name);
+        if (entry != this->index->end()) {
+            const std::vector<unsigned char>& buffer = isCompressed() ? this->uncompressed : getContent();
+            this->indexed->put(name, PrimitiveTypesMarshaller::unmarshalPrimitive(
+                &buffer[0], (int) buffer.size(), entry->second));
+        }
+    }
+
+    return *this->indexed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQMapMessage::isEmpty() const {
 
     try {
-        return getMap().isEmpty();
+        checkMapIsIndexed();
+        return map.get() != NULL ? map->isEmpty() : index->empty();
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -214,7 +290,19 @@ bool ActiveMQMapMessage::isEmpty() const {
 std::vector<std::string> ActiveMQMapMessage::getMapNames() const {
 
     try {
-        return getMap().keySet().toArray();
+        checkMapIsIndexed();
+
+        if (map.get() != NULL) {
+            return map->keySet().toArray();
+        }
+
+        std::vector<std::string> names;
+        std::map<std::string, int>::const_iterator entry = index->begin();
+        for (; entry != index->end(); ++entry) {
+            names.push_back(entry->first);
+        }
+
+        return names;
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -223,7 +311,8 @@ std::vector<std::string> ActiveMQMapMessage::getMapNames() const {
 bool ActiveMQMapMessage::itemExists(const std::string& name) const {
 
     try {
-        return getMap().containsKey(name);
+        checkMapIsIndexed();
+        return map.get() != NULL ? map->containsKey(name) : index->find(name) != index->end();
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -232,7 +321,7 @@ bool ActiveMQMapMessage::itemExists(const std::string& name) const {
 cms::Message::ValueType ActiveMQMapMessage::getValueType(const std::string& key) const {
 
     try {
-        util::PrimitiveValueNode::PrimitiveType type = this->getMap().getValueType(key);
+        util::PrimitiveValueNode::PrimitiveType type = this->getEntries(key).getValueType(key);
 
         switch (type) {
             case util::PrimitiveValueNode::NULL_TYPE:
@@ -271,7 +360,7 @@ cms::Message::ValueType ActiveMQMapMessage::getValueType(const std::string& key)
 bool ActiveMQMapMessage::getBoolean(const std::string& name) const {
 
     try {
-        return getMap().getBool(name);
+        return getEntries(name).getBool(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -292,7 +381,7 @@ void ActiveMQMapMessage::setBoolean(const std::string& name, bool value) {
 unsigned char ActiveMQMapMessage::getByte(const std::string& name) const {
 
     try {
-        return getMap().getByte(name);
+        return getEntries(name).getByte(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -313,7 +402,7 @@ void ActiveMQMapMessage::setByte(const std::string& name, unsigned char value) {
 std::vector<unsigned char> ActiveMQMapMessage::getBytes(const std::string& name) const {
 
     try {
-        return getMap().getByteArray(name);
+        return getEntries(name).getByteArray(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -334,7 +423,7 @@ void ActiveMQMapMessage::setBytes(const std::string& name, const std::vector<uns
 char ActiveMQMapMessage::getChar(const std::string& name) const {
 
     try {
-        return getMap().getChar(name);
+        return getEntries(name).getChar(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -355,7 +444,7 @@ void ActiveMQMapMessage::setChar(const std::string& name, char value) {
 double ActiveMQMapMessage::getDouble(const std::string& name) const {
 
     try {
-        return getMap().getDouble(name);
+        return getEntries(name).getDouble(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -376,7 +465,7 @@ void ActiveMQMapMessage::setDouble(const std::string& name, double value) {
 float ActiveMQMapMessage::getFloat(const std::string& name) const {
 
     try {
-        return getMap().getFloat(name);
+        return getEntries(name).getFloat(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -397,7 +486,7 @@ void ActiveMQMapMessage::setFloat(const std::string& name, float value) {
 int ActiveMQMapMessage::getInt(const std::string& name) const {
 
     try {
-        return getMap().getInt(name);
+        return getEntries(name).getInt(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -418,7 +507,7 @@ void ActiveMQMapMessage::setInt(const std::string& name, int value) {
 long long ActiveMQMapMessage::getLong(const std::string& name) const {
 
     try {
-        return getMap().getLong(name);
+        return getEntries(name).getLong(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -439,7 +528,7 @@ void ActiveMQMapMessage::setLong(const std::string& name, long long value) {
 short ActiveMQMapMessage::getShort(const std::string& name) const {
 
     try {
-        return getMap().getShort(name);
+        return getEntries(name).getShort(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -460,7 +549,7 @@ void ActiveMQMapMessage::setShort(const std::string& name, short value) {
 std::string ActiveMQMapMessage::getString(const std::string& name) const {
 
     try {
-        return getMap().getString(name);
+        return getEntries(name).getString(name);
     } catch (UnsupportedOperationException& ex) {
         throw CMSExceptionSupport::createMessageFormatException(ex);
     }
@@ -23,6 +23,7 @@
 #include <activemq/util/PrimitiveMap.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <cms/MapMessage.h>
+#include <map>
 #include <vector>
 #include <string>
 #include <memory>
@@ -36,6 +37,20 @@ namespace commands {
         // Map Structure to hold unmarshaled Map Data
         mutable std::auto_ptr<util::PrimitiveMap> map;
 
+        // Offsets of the values in the content by key, built on the first read of a
+        // received map so that reading a few entries only decodes those entries.
+        mutable std::auto_ptr< std::map<std::string, int> > index;
+
+        // The entries decoded through the index so far.
+        mutable std::auto_ptr<util::PrimitiveMap> indexed;
+
+        // The uncompressed content the index refers to when the content is compressed.
+        mutable std::vector<unsigned char> uncompressed;
+
+        // Set once the map is handed out for changes, the content of a map that wasn't
+        // changed is sent as it is instead of being encoded again.
+        bool modified;
+
     public:
 
         const static unsigned char ID_ACTIVEMQMAPMESSAGE;
@@ -143,6 +158,15 @@ namespace commands {
          */
         virtual void checkMapIsUnmarshalled() const;
 
+    private:
+
+        // Builds the index of the content if the map hasn't been unmarshaled.
+        void checkMapIsIndexed() const;
+
+        // The map to read the named entry from, the whole map once it has been
+        // unmarshaled, otherwise the entries decoded through the index.
+        const util::PrimitiveMap& getEntries(const std::string& name) const;
+
     };
 
 }}
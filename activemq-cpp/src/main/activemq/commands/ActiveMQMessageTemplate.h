@@ -26,6 +26,7 @@
 #include <activemq/wireformat/openwire/utils/MessagePropertyInterceptor.h>
 #include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
 #include <activemq/util/CMSExceptionSupport.h>
+#include <activemq/util/BlockCompressionCodec.h>
 
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 
@@ -382,7 +383,9 @@ namespace commands {
 
         virtual std::string getCMSMessageID() const {
             try {
-                return wireformat::openwire::marshal::BaseDataStreamMarshaller::toString(this->getMessageId().get());
+                // The MessageId caches its string form so repeated calls don't reformat it.
+                const Pointer<MessageId>& id = this->getMessageId();
+                return id != NULL ? id->toString() : "";
             }
             AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
         }
@@ -468,6 +471,81 @@ namespace commands {
             }
         }
 
+        /**
+         * Appends the given arrays, compressed as one unit with the connection's codec, to
+         * the content of this message and records the codec used.  Bodies larger than the
+         * connection's compression block size are compressed in blocks.  Must only be
+         * called when the message has a connection.
+         */
+        void compressContent(const unsigned char* const* buffers, const int* lengths, int count) {
+
+            std::string name = this->connection->getCompressionCodec();
+
+            int blockSize = this->connection->getCompressionBlockSize();
+            if (blockSize > 0) {
+                long long total = 0;
+                for (int i = 0; i < count; ++i) {
+                    total += lengths[i];
+                }
+
+                if (total > blockSize) {
+                    name = util::BlockCompressionCodec::toBlockCodecName(name);
+                }
+            }
+
+            util::CompressionCodec& codec = this->connection->getCompressionCodecInstance(name);
+            codec.compress(this->connection->getCompressionLevel(), buffers, lengths, count, this->getContent());
+            this->setCompressionCodecName(codec.getName());
+        }
+
+        /**
+         * Records the codec the body of this message is compressed with, zlib is recorded
+         * by the absence of the codec property so that other clients can read the message.
+         */
+        void setCompressionCodecName(const std::string& name) {
+            if (name != util::CompressionCodec::ZLIB) {
+                this->getMessageProperties().setString(util::CompressionCodec::CODEC_PROPERTY, name);
+            } else if (this->getMessageProperties().containsKey(util::CompressionCodec::CODEC_PROPERTY)) {
+                this->getMessageProperties().remove(util::CompressionCodec::CODEC_PROPERTY);
+            }
+        }
+
+        /**
+         * @return the name of the codec the body of this message is compressed with.
+         */
+        std::string getCompressionCodecName() const {
+            const util::PrimitiveMap& properties = this->getMessageProperties();
+            if (properties.containsKey(util::CompressionCodec::CODEC_PROPERTY)) {
+                return properties.getString(util::CompressionCodec::CODEC_PROPERTY);
+            }
+
+            return util::CompressionCodec::ZLIB;
+        }
+
+        /**
+         * Appends the decompressed content of this message, starting at the given offset,
+         * to the given vector.  Uses the codec named by the message's codec property, zlib
+         * when there is none, taken from the connection when the message has one.
+         */
+        void decompressContent(std::size_t offset, std::vector<unsigned char>& out, int expected = 0) const {
+
+            const std::vector<unsigned char>& content = this->getContent();
+            const unsigned char* buffer = offset < content.size() ? &content[offset] : NULL;
+            int length = offset < content.size() ? (int) (content.size() - offset) : 0;
+
+            std::string name = this->getCompressionCodecName();
+
+            if (this->connection != NULL) {
+                this->connection->getCompressionCodecInstance(name).decompress(buffer, length, out, expected);
+            } else if (name == util::CompressionCodec::ZLIB) {
+                util::CompressionPool pool(0);
+                pool.decompress(buffer, length, out, expected);
+            } else {
+                std::auto_ptr<util::CompressionCodec> codec(util::CompressionCodec::create(name));
+                codec->decompress(buffer, length, out, expected);
+            }
+        }
+
     };
 
 }
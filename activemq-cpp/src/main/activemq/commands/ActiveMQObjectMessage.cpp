@@ -19,14 +19,9 @@
 #include <activemq/util/CMSExceptionSupport.h>
 
 #include <decaf/io/FilterOutputStream.h>
-#include <decaf/io/ByteArrayInputStream.h>
-#include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/EOFException.h>
 #include <decaf/io/IOException.h>
 
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
-
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
@@ -93,14 +88,18 @@ void ActiveMQObjectMessage::setObjectBytes(const std::vector<unsigned char>& byt
         if (this->connection != NULL && this->connection->isUseCompression()) {
             this->compressed = true;
 
-            ByteArrayOutputStream bytesOut;
-            Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-            DeflaterOutputStream out(&bytesOut, deflator, false, true);
-            out.write(&bytes[0], (int)bytes.size());
+            int length = (int) bytes.size();
+
+            // The length of the uncompressed bytes comes first, then the compressed bytes.
+            std::vector<unsigned char>& content = this->getContent();
+            content.clear();
+            content.push_back((unsigned char) ((length >> 24) & 0xFF));
+            content.push_back((unsigned char) ((length >> 16) & 0xFF));
+            content.push_back((unsigned char) ((length >> 8) & 0xFF));
+            content.push_back((unsigned char) (length & 0xFF));
 
-            std::pair<unsigned char*, int> array = bytesOut.toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-            delete[] array.first;
+            const unsigned char* buffers[1] = { &bytes[0] };
+            this->compressContent(buffers, &length, 1);
         } else {
             this->setContent(bytes);
         }
@@ -116,27 +115,22 @@ std::vector<unsigned char> ActiveMQObjectMessage::getObjectBytes() const {
 
         if (this->isCompressed()) {
 
-            int length = 0;
-            ByteArrayInputStream is(this->getContent());
+            const std::vector<unsigned char>& content = this->getContent();
             std::vector<unsigned char> uncompressed;
 
-            try {
-
-                DataInputStream dis(&is);
-                length = dis.readInt();
+            if (content.size() < 4) {
+                throw CMSExceptionSupport::create(
+                    IOException(__FILE__, __LINE__, "Compressed object body is truncated."));
+            }
 
-                if (length == 0) {
-                    return std::vector<unsigned char>();
-                }
+            int length = ((content[0] & 0xFF) << 24) | ((content[1] & 0xFF) << 16) |
+                         ((content[2] & 0xFF) << 8) | (content[3] & 0xFF);
 
-                uncompressed.resize(length);
-            } catch (IOException& ex) {
-                throw CMSExceptionSupport::create(ex);
+            if (length <= 0) {
+                return uncompressed;
             }
 
-            InflaterInputStream inflater(&is, false);
-            inflater.read(&uncompressed[0], length);
-            inflater.close();
+            this->decompressContent(4, uncompressed, length);
 
             return uncompressed;
         } else {
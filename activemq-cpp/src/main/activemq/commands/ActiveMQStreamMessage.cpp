@@ -14,10 +14,11 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+
 #include <activemq/commands/ActiveMQStreamMessage.h>
 #include <activemq/util/PrimitiveValueNode.h>
 #include <activemq/util/CMSExceptionSupport.h>
-#include <activemq/util/MarshallingSupport.h>
+#include <activemq/util/CompressionCodec.h>
 
 #include <cms/MessageEOFException.h>
 #include <cms/MessageFormatException.h>
@@ -25,6 +26,7 @@
 #include <cms/MessageNotWriteableException.h>
 
 #include <algorithm>
+#include <cstring>
 
 #include <decaf/lang/Math.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
@@ -36,11 +38,6 @@
 #include <decaf/lang/Long.h>
 #include <decaf/lang/Double.h>
 #include <decaf/lang/Float.h>
-#include <decaf/io/ByteArrayOutputStream.h>
-#include <decaf/io/ByteArrayInputStream.h>
-#include <decaf/io/BufferedInputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
 
 using namespace std;
 using namespace cms;
@@ -51,11 +48,9 @@ using namespace activemq::exceptions;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
 using namespace decaf;
-using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util;
-using namespace decaf::util::zip;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
@@ -69,18 +64,111 @@ namespace commands {
 
     public:
 
-        ActiveMQStreamMessageImpl() : bytesOut(NULL), remainingBytes(-1) {}
+        ActiveMQStreamMessageImpl() : body(), writing(false), uncompressed(), buffer(NULL),
+                                      length(0), position(-1), remainingBytes(-1) {}
         ~ActiveMQStreamMessageImpl() {}
 
     public:
 
-        // Holds the contents of the message once written.
-        decaf::io::ByteArrayOutputStream* bytesOut;
+        // The values written since writing started, encoded as they are written.  Its
+        // storage is kept once stored so the next body is written without growing it.
+        std::vector<unsigned char> body;
+
+        // True from the first write until the body is stored as the content.
+        bool writing;
+
+        // The decompressed body that is read from when the content is compressed.
+        mutable std::vector<unsigned char> uncompressed;
+
+        // The body being read, the offset of the next value in it or -1 until reading
+        // starts.
+        mutable const unsigned char* buffer;
+        mutable int length;
+        mutable int position;
 
         // When reading an array of bytes this value indicates how many bytes
         // are left unread since the last readBytes call.
         mutable int remainingBytes;
 
+    public:
+
+        void writeType(unsigned char type) {
+            body.push_back(type);
+        }
+
+        void writeValue(unsigned long long value, int size) {
+            for (int shift = (size - 1) * 8; shift >= 0; shift -= 8) {
+                body.push_back((unsigned char) (value >> shift));
+            }
+        }
+
+        void writeBytes(const unsigned char* bytes, int size) {
+            body.insert(body.end(), bytes, bytes + size);
+        }
+
+        // The type of the next value without moving past it, -1 at the end of the body.
+        int peekType() const {
+            return position < length ? buffer[position] : -1;
+        }
+
+        int readType() const {
+            require(1);
+            return buffer[position++];
+        }
+
+        void require(int size) const {
+            if (length - position < size) {
+                throw MessageEOFException("reached end of data", NULL);
+            }
+        }
+
+        unsigned long long readValue(int size) const {
+            require(size);
+            unsigned long long value = 0;
+            for (int i = 0; i < size; ++i) {
+                value = (value << 8) | buffer[position++];
+            }
+            return value;
+        }
+
+        short readShort() const {
+            return (short) readValue(2);
+        }
+
+        int readInt() const {
+            return (int) readValue(4);
+        }
+
+        long long readLong() const {
+            return (long long) readValue(8);
+        }
+
+        float readFloat() const {
+            unsigned int bits = (unsigned int) readValue(4);
+            float value = 0.0f;
+            memcpy(&value, &bits, sizeof(float));
+            return value;
+        }
+
+        double readDouble() const {
+            unsigned long long bits = readValue(8);
+            double value = 0.0;
+            memcpy(&value, &bits, sizeof(double));
+            return value;
+        }
+
+        // Strings are held as their bytes after a short length, an int length when big.
+        std::string readString(bool big) const {
+            int size = big ? readInt() : readShort();
+            if (size <= 0) {
+                return "";
+            }
+            require(size);
+            std::string value((const char*) buffer + position, size);
+            position += size;
+            return value;
+        }
+
     };
 }}
 
@@ -89,16 +177,13 @@ const unsigned char ActiveMQStreamMessage::ID_ACTIVEMQSTREAMMESSAGE = 27;
 
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQStreamMessage::ActiveMQStreamMessage() : ActiveMQMessageTemplate<cms::StreamMessage>(),
-                                                 impl(new ActiveMQStreamMessageImpl()),
-                                                 dataIn(),
-                                                 dataOut() {
+                                                 impl(new ActiveMQStreamMessageImpl()) {
     this->clearBody();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQStreamMessage::~ActiveMQStreamMessage() throw () {
     try {
-        this->reset();
         delete impl;
     }
     AMQ_CATCHALL_NOTHROW()
@@ -142,6 +227,11 @@ void ActiveMQStreamMessage::copyDataStructure(const DataStructure* src) {
     nonConstSrc->storeContent();
 
     ActiveMQMessageTemplate<cms::StreamMessage>::copyDataStructure(src);
+
+    // Any read in progress was over the content just replaced.
+    this->impl->uncompressed.clear();
+    this->impl->position = -1;
+    this->impl->remainingBytes = -1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -160,9 +250,10 @@ void ActiveMQStreamMessage::clearBody() {
     // Invoke base class's version.
     ActiveMQMessageTemplate<cms::StreamMessage>::clearBody();
 
-    this->dataIn.reset(NULL);
-    this->dataOut.reset(NULL);
-    this->impl->bytesOut = NULL;
+    this->impl->body.clear();
+    this->impl->writing = false;
+    this->impl->uncompressed.clear();
+    this->impl->position = -1;
     this->impl->remainingBytes = -1;
 }
 
@@ -178,9 +269,8 @@ void ActiveMQStreamMessage::reset() {
 
     try {
         storeContent();
-        this->impl->bytesOut = NULL;
-        this->dataIn.reset(NULL);
-        this->dataOut.reset(NULL);
+        this->impl->uncompressed.clear();
+        this->impl->position = -1;
         this->impl->remainingBytes = -1;
         this->setReadOnlyBody(true);
     }
@@ -190,37 +280,30 @@ void ActiveMQStreamMessage::reset() {
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQStreamMessage::readBoolean() const {
 
+    initializeReading();
+    int mark = this->impl->position;
     try {
 
-        initializeReading();
-
-        this->dataIn->mark(10);
-
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("Reached the end of the Stream", NULL);
-        }
         if (type == PrimitiveValueNode::BOOLEAN_TYPE) {
-            return this->dataIn->readBoolean();
+            return this->impl->readValue(1) != 0;
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Boolean::valueOf(this->dataIn->readUTF()).booleanValue();
+            return Boolean::valueOf(this->impl->readString(false)).booleanValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to boolean.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException("not a boolean type", NULL);
         }
 
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -230,8 +313,8 @@ void ActiveMQStreamMessage::writeBoolean(bool value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::BOOLEAN_TYPE);
-        this->dataOut->writeBoolean(value);
+        this->impl->writeType(PrimitiveValueNode::BOOLEAN_TYPE);
+        this->impl->writeValue(value ? 1 : 0, 1);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -240,44 +323,32 @@ void ActiveMQStreamMessage::writeBoolean(bool value) {
 unsigned char ActiveMQStreamMessage::readByte() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(10);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return this->dataIn->readByte();
+            return (unsigned char) this->impl->readValue(1);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Byte::valueOf(this->dataIn->readUTF()).byteValue();
+            return Byte::valueOf(this->impl->readString(false)).byteValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to byte.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a byte type", NULL);
         }
 
     } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& e) {
-            throw CMSExceptionSupport::create(e);
-        }
-
+        this->impl->position = mark;
         throw CMSExceptionSupport::createMessageFormatException(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -287,8 +358,8 @@ void ActiveMQStreamMessage::writeByte(unsigned char value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::BYTE_TYPE);
-        this->dataOut->writeByte(value);
+        this->impl->writeType(PrimitiveValueNode::BYTE_TYPE);
+        this->impl->writeValue(value, 1);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -310,9 +381,11 @@ void ActiveMQStreamMessage::writeBytes(const std::vector<unsigned char>& value)
     try {
 
         int size = (int) value.size();
-        this->dataOut->write(PrimitiveValueNode::BYTE_ARRAY_TYPE);
-        this->dataOut->writeInt((int) size);
-        this->dataOut->write(&value[0], size, 0, size);
+        this->impl->writeType(PrimitiveValueNode::BYTE_ARRAY_TYPE);
+        this->impl->writeValue(size, 4);
+        if (size > 0) {
+            this->impl->writeBytes(&value[0], size);
+        }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -329,8 +402,7 @@ int ActiveMQStreamMessage::readBytes(unsigned char* buffer, int length) const {
 
         if (this->impl->remainingBytes == -1) {
 
-            this->dataIn->mark((int) length + 1);
-            int type = this->dataIn->read();
+            int type = this->impl->peekType();
 
             if (type == -1) {
                 throw MessageEOFException("reached end of data", NULL);
@@ -340,29 +412,25 @@ int ActiveMQStreamMessage::readBytes(unsigned char* buffer, int length) const {
                 throw MessageFormatException("Not a byte array", NULL);
             }
 
-            this->impl->remainingBytes = this->dataIn->readInt();
+            this->impl->require(5);
+            this->impl->position++;
+            this->impl->remainingBytes = this->impl->readInt();
 
         } else if (this->impl->remainingBytes == 0) {
             this->impl->remainingBytes = -1;
             return -1;
         }
 
-        if (length <= this->impl->remainingBytes) {
-            // small buffer
-            this->impl->remainingBytes -= (int) length;
-            this->dataIn->readFully(buffer, length);
-            return length;
-        } else {
-            // big buffer
-            int rc = this->dataIn->read(buffer, length, 0, this->impl->remainingBytes);
-            this->impl->remainingBytes = 0;
-            return rc;
-        }
+        int count = Math::min(length, this->impl->remainingBytes);
+
+        this->impl->require(count);
+        memcpy(buffer, this->impl->buffer + this->impl->position, count);
+        this->impl->position += count;
+
+        this->impl->remainingBytes = count < length ? 0 : this->impl->remainingBytes - count;
+
+        return count;
 
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
     } catch (Exception& e) {
         throw CMSExceptionSupport::create(e);
     }
@@ -373,9 +441,11 @@ void ActiveMQStreamMessage::writeBytes(const unsigned char* value, int offset, i
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::BYTE_ARRAY_TYPE);
-        this->dataOut->writeInt((int) length);
-        this->dataOut->write(value, length, offset, length);
+        this->impl->writeType(PrimitiveValueNode::BYTE_ARRAY_TYPE);
+        this->impl->writeValue(length, 4);
+        if (length > 0) {
+            this->impl->writeBytes(value + offset, length);
+        }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -384,42 +454,26 @@ void ActiveMQStreamMessage::writeBytes(const unsigned char* value, int offset, i
 char ActiveMQStreamMessage::readChar() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(17);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::CHAR_TYPE) {
-            return this->dataIn->readChar();
+            return (char) this->impl->readValue(1);
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to char.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a char type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& ioe) {
-            throw CMSExceptionSupport::create(ioe);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-        ;
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -429,8 +483,8 @@ void ActiveMQStreamMessage::writeChar(char value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::CHAR_TYPE);
-        this->dataOut->writeChar(value);
+        this->impl->writeType(PrimitiveValueNode::CHAR_TYPE);
+        this->impl->writeValue((unsigned char) value, 1);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -439,44 +493,29 @@ void ActiveMQStreamMessage::writeChar(char value) {
 float ActiveMQStreamMessage::readFloat() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(33);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::FLOAT_TYPE) {
-            return this->dataIn->readFloat();
+            return this->impl->readFloat();
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Float::valueOf(this->dataIn->readUTF()).floatValue();
+            return Float::valueOf(this->impl->readString(false)).floatValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to float.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a float type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& ioe) {
-            throw CMSExceptionSupport::create(ioe);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -486,8 +525,10 @@ void ActiveMQStreamMessage::writeFloat(float value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::FLOAT_TYPE);
-        this->dataOut->writeFloat(value);
+        unsigned int bits = 0;
+        memcpy(&bits, &value, sizeof(float));
+        this->impl->writeType(PrimitiveValueNode::FLOAT_TYPE);
+        this->impl->writeValue(bits, 4);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -496,47 +537,32 @@ void ActiveMQStreamMessage::writeFloat(float value) {
 double ActiveMQStreamMessage::readDouble() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(33);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::DOUBLE_TYPE) {
-            return this->dataIn->readDouble();
+            return this->impl->readDouble();
         }
         if (type == PrimitiveValueNode::FLOAT_TYPE) {
-            return this->dataIn->readFloat();
+            return this->impl->readFloat();
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Double::valueOf(this->dataIn->readUTF()).doubleValue();
+            return Double::valueOf(this->impl->readString(false)).doubleValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to double.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a double type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& ioe) {
-            throw CMSExceptionSupport::create(ioe);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -546,8 +572,10 @@ void ActiveMQStreamMessage::writeDouble(double value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::DOUBLE_TYPE);
-        this->dataOut->writeDouble(value);
+        unsigned long long bits = 0;
+        memcpy(&bits, &value, sizeof(double));
+        this->impl->writeType(PrimitiveValueNode::DOUBLE_TYPE);
+        this->impl->writeValue(bits, 8);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -556,47 +584,32 @@ void ActiveMQStreamMessage::writeDouble(double value) {
 short ActiveMQStreamMessage::readShort() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(17);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::SHORT_TYPE) {
-            return this->dataIn->readShort();
+            return this->impl->readShort();
         }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return this->dataIn->readByte();
+            return (short) (signed char) this->impl->readValue(1);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Short::valueOf(this->dataIn->readUTF()).shortValue();
+            return Short::valueOf(this->impl->readString(false)).shortValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to short.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a short type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& e) {
-            throw CMSExceptionSupport::create(e);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -606,8 +619,8 @@ void ActiveMQStreamMessage::writeShort(short value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::SHORT_TYPE);
-        this->dataOut->writeShort(value);
+        this->impl->writeType(PrimitiveValueNode::SHORT_TYPE);
+        this->impl->writeValue((unsigned short) value, 2);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -616,47 +629,32 @@ void ActiveMQStreamMessage::writeShort(short value) {
 unsigned short ActiveMQStreamMessage::readUnsignedShort() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(17);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::SHORT_TYPE) {
-            return this->dataIn->readUnsignedShort();
+            return (unsigned short) this->impl->readValue(2);
         }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return this->dataIn->readByte();
+            return (unsigned short) (signed char) this->impl->readValue(1);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Short::valueOf(this->dataIn->readUTF()).shortValue();
+            return Short::valueOf(this->impl->readString(false)).shortValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to short.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a short type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& e) {
-            throw CMSExceptionSupport::create(e);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -666,8 +664,8 @@ void ActiveMQStreamMessage::writeUnsignedShort(unsigned short value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::SHORT_TYPE);
-        this->dataOut->writeUnsignedShort(value);
+        this->impl->writeType(PrimitiveValueNode::SHORT_TYPE);
+        this->impl->writeValue(value, 2);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -676,50 +674,35 @@ void ActiveMQStreamMessage::writeUnsignedShort(unsigned short value) {
 int ActiveMQStreamMessage::readInt() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(33);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::INTEGER_TYPE) {
-            return this->dataIn->readInt();
+            return this->impl->readInt();
         }
         if (type == PrimitiveValueNode::SHORT_TYPE) {
-            return this->dataIn->readShort();
+            return this->impl->readShort();
         }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return this->dataIn->readByte();
+            return (signed char) this->impl->readValue(1);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Integer::valueOf(this->dataIn->readUTF()).intValue();
+            return Integer::valueOf(this->impl->readString(false)).intValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to int.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a int type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& e) {
-            throw CMSExceptionSupport::create(e);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -729,8 +712,8 @@ void ActiveMQStreamMessage::writeInt(int value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::INTEGER_TYPE);
-        this->dataOut->writeInt(value);
+        this->impl->writeType(PrimitiveValueNode::INTEGER_TYPE);
+        this->impl->writeValue((unsigned int) value, 4);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -739,53 +722,38 @@ void ActiveMQStreamMessage::writeInt(int value) {
 long long ActiveMQStreamMessage::readLong() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(65);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::LONG_TYPE) {
-            return this->dataIn->readLong();
+            return this->impl->readLong();
         }
         if (type == PrimitiveValueNode::INTEGER_TYPE) {
-            return this->dataIn->readInt();
+            return this->impl->readInt();
         }
         if (type == PrimitiveValueNode::SHORT_TYPE) {
-            return this->dataIn->readShort();
+            return this->impl->readShort();
         }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return this->dataIn->readByte();
+            return (signed char) this->impl->readValue(1);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return Long::valueOf(this->dataIn->readUTF()).longValue();
+            return Long::valueOf(this->impl->readString(false)).longValue();
         }
 
         if (type == PrimitiveValueNode::NULL_TYPE) {
-            this->dataIn->reset();
             throw NullPointerException(__FILE__, __LINE__, "Cannot convert NULL value to long.");
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a long type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& e) {
-            throw CMSExceptionSupport::create(e);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -795,8 +763,8 @@ void ActiveMQStreamMessage::writeLong(long long value) {
 
     initializeWriting();
     try {
-        this->dataOut->write(PrimitiveValueNode::LONG_TYPE);
-        this->dataOut->writeLong(value);
+        this->impl->writeType(PrimitiveValueNode::LONG_TYPE);
+        this->impl->writeValue((unsigned long long) value, 8);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -805,67 +773,53 @@ void ActiveMQStreamMessage::writeLong(long long value) {
 std::string ActiveMQStreamMessage::readString() const {
 
     initializeReading();
+    int mark = this->impl->position;
     try {
 
-        this->dataIn->mark(65);
-        int type = this->dataIn->read();
+        int type = this->impl->readType();
 
-        if (type == -1) {
-            throw MessageEOFException("reached end of data", NULL);
-        }
         if (type == PrimitiveValueNode::NULL_TYPE) {
             return "";
         }
         if (type == PrimitiveValueNode::BIG_STRING_TYPE) {
-            return MarshallingSupport::readString32(*this->dataIn);
+            return this->impl->readString(true);
         }
         if (type == PrimitiveValueNode::STRING_TYPE) {
-            return MarshallingSupport::readString16(*this->dataIn);
+            return this->impl->readString(false);
         }
         if (type == PrimitiveValueNode::LONG_TYPE) {
-            return Long(this->dataIn->readLong()).toString();
+            return Long(this->impl->readLong()).toString();
         }
         if (type == PrimitiveValueNode::INTEGER_TYPE) {
-            return Integer(this->dataIn->readInt()).toString();
+            return Integer(this->impl->readInt()).toString();
         }
         if (type == PrimitiveValueNode::SHORT_TYPE) {
-            return Short(this->dataIn->readShort()).toString();
+            return Short(this->impl->readShort()).toString();
         }
         if (type == PrimitiveValueNode::BYTE_TYPE) {
-            return Byte(this->dataIn->readByte()).toString();
+            return Byte((unsigned char) this->impl->readValue(1)).toString();
         }
         if (type == PrimitiveValueNode::FLOAT_TYPE) {
-            return Float(this->dataIn->readFloat()).toString();
+            return Float(this->impl->readFloat()).toString();
         }
         if (type == PrimitiveValueNode::DOUBLE_TYPE) {
-            return Double(this->dataIn->readDouble()).toString();
+            return Double(this->impl->readDouble()).toString();
         }
         if (type == PrimitiveValueNode::BOOLEAN_TYPE) {
-            return (this->dataIn->readBoolean() ? Boolean::_TRUE : Boolean::_FALSE).toString();
+            return (this->impl->readValue(1) != 0 ? Boolean::_TRUE : Boolean::_FALSE).toString();
         }
 
         if (type == PrimitiveValueNode::CHAR_TYPE) {
-            return Character(this->dataIn->readChar()).toString();
+            return Character((char) this->impl->readValue(1)).toString();
         } else {
-            this->dataIn->reset();
             throw MessageFormatException(" not a String type", NULL);
         }
 
-    } catch (NumberFormatException& ex) {
-
-        try {
-            this->dataIn->reset();
-        } catch (IOException& ioe) {
-            throw CMSExceptionSupport::create(ioe);
-        }
-
-        throw CMSExceptionSupport::create(ex);
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
+    } catch (CMSException&) {
+        this->impl->position = mark;
+        throw;
     } catch (Exception& e) {
+        this->impl->position = mark;
         throw CMSExceptionSupport::create(e);
     }
 }
@@ -875,7 +829,18 @@ void ActiveMQStreamMessage::writeString(const std::string& value) {
 
     initializeWriting();
     try {
-        MarshallingSupport::writeString(*this->dataOut, value);
+
+        int size = (int) value.length();
+
+        if (size <= Short::MAX_VALUE / 4) {
+            this->impl->writeType(PrimitiveValueNode::STRING_TYPE);
+            this->impl->writeValue((unsigned short) size, 2);
+        } else {
+            this->impl->writeType(PrimitiveValueNode::BIG_STRING_TYPE);
+            this->impl->writeValue((unsigned int) size, 4);
+        }
+
+        this->impl->writeBytes((const unsigned char*) value.c_str(), size);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -884,76 +849,71 @@ void ActiveMQStreamMessage::writeString(const std::string& value) {
 cms::Message::ValueType ActiveMQStreamMessage::getNextValueType() const {
 
     initializeReading();
-    try {
 
-        if (this->impl->remainingBytes != -1) {
-            throw cms::IllegalStateException(
-                "Cannot read the next type during an byte array read operation, complete the read first.");
-        }
+    if (this->impl->remainingBytes != -1) {
+        throw cms::IllegalStateException(
+            "Cannot read the next type during an byte array read operation, complete the read first.");
+    }
 
-        this->dataIn->mark(10);
-        int type = this->dataIn->read();
+    int type = this->impl->peekType();
 
-        if (type == -1) {
+    switch(type) {
+        case -1:
             throw MessageEOFException("reached end of data", NULL);
-        }
-
-        this->dataIn->reset();
-
-        switch(type) {
-            case util::PrimitiveValueNode::NULL_TYPE:
-                return cms::Message::NULL_TYPE;
-            case util::PrimitiveValueNode::BOOLEAN_TYPE:
-                return cms::Message::BOOLEAN_TYPE;
-            case util::PrimitiveValueNode::BYTE_TYPE:
-                return cms::Message::BYTE_TYPE;
-            case util::PrimitiveValueNode::BYTE_ARRAY_TYPE:
-                return cms::Message::BYTE_ARRAY_TYPE;
-            case util::PrimitiveValueNode::CHAR_TYPE:
-                return cms::Message::CHAR_TYPE;
-            case util::PrimitiveValueNode::SHORT_TYPE:
-                return cms::Message::SHORT_TYPE;
-            case util::PrimitiveValueNode::INTEGER_TYPE:
-                return cms::Message::INTEGER_TYPE;
-            case util::PrimitiveValueNode::LONG_TYPE:
-                return cms::Message::LONG_TYPE;
-            case util::PrimitiveValueNode::DOUBLE_TYPE:
-                return cms::Message::DOUBLE_TYPE;
-            case util::PrimitiveValueNode::FLOAT_TYPE:
-                return cms::Message::FLOAT_TYPE;
-            case util::PrimitiveValueNode::STRING_TYPE:
-            case util::PrimitiveValueNode::BIG_STRING_TYPE:
-                return cms::Message::STRING_TYPE;
-            default:
-                throw MessageFormatException("Unknown type found in stream", NULL);
-        }
-
-        return cms::Message::UNKNOWN_TYPE;
-
-    } catch (EOFException& e) {
-        throw CMSExceptionSupport::createMessageEOFException(e);
-    } catch (IOException& e) {
-        throw CMSExceptionSupport::createMessageFormatException(e);
-    } catch (Exception& e) {
-        throw CMSExceptionSupport::create(e);
-    }
+        case util::PrimitiveValueNode::NULL_TYPE:
+            return cms::Message::NULL_TYPE;
+        case util::PrimitiveValueNode::BOOLEAN_TYPE:
+            return cms::Message::BOOLEAN_TYPE;
+        case util::PrimitiveValueNode::BYTE_TYPE:
+            return cms::Message::BYTE_TYPE;
+        case util::PrimitiveValueNode::BYTE_ARRAY_TYPE:
+            return cms::Message::BYTE_ARRAY_TYPE;
+        case util::PrimitiveValueNode::CHAR_TYPE:
+            return cms::Message::CHAR_TYPE;
+        case util::PrimitiveValueNode::SHORT_TYPE:
+            return cms::Message::SHORT_TYPE;
+        case util::PrimitiveValueNode::INTEGER_TYPE:
+            return cms::Message::INTEGER_TYPE;
+        case util::PrimitiveValueNode::LONG_TYPE:
+            return cms::Message::LONG_TYPE;
+        case util::PrimitiveValueNode::DOUBLE_TYPE:
+            return cms::Message::DOUBLE_TYPE;
+        case util::PrimitiveValueNode::FLOAT_TYPE:
+            return cms::Message::FLOAT_TYPE;
+        case util::PrimitiveValueNode::STRING_TYPE:
+        case util::PrimitiveValueNode::BIG_STRING_TYPE:
+            return cms::Message::STRING_TYPE;
+        default:
+            throw MessageFormatException("Unknown type found in stream", NULL);
+    }
+
+    return cms::Message::UNKNOWN_TYPE;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQStreamMessage::storeContent() {
 
-    if (this->dataOut.get() != NULL) {
+    if (this->impl->writing) {
+
+        std::vector<unsigned char>& body = this->impl->body;
 
-        this->dataOut->close();
+        if (!body.empty()) {
+
+            if (this->compressed) {
+                this->content.clear();
+                const unsigned char* buffers[1] = { &body[0] };
+                int lengths[1] = { (int) body.size() };
+                this->compressContent(buffers, lengths, 1);
+            } else {
+                // Handed over as the content, the old content's storage takes its place.
+                this->content.clear();
+                this->content.edit().swap(body);
+            }
 
-        if (this->impl->bytesOut->size() > 0) {
-            std::pair<unsigned char*, int> array = this->impl->bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-            delete[] array.first;
+            body.clear();
         }
 
-        this->dataOut.reset(NULL);
-        this->impl->bytesOut = NULL;
+        this->impl->writing = false;
     }
 }
 
@@ -962,15 +922,19 @@ void ActiveMQStreamMessage::initializeReading() const {
 
     this->failIfWriteOnlyBody();
     try {
-        if (this->dataIn.get() == NULL) {
-            InputStream* is = new ByteArrayInputStream(this->getContent());
+        if (this->impl->position == -1) {
 
             if (isCompressed()) {
-                is = new InflaterInputStream(is, true);
-                is = new BufferedInputStream(is, true);
+                this->impl->uncompressed.clear();
+                this->decompressContent(0, this->impl->uncompressed);
+                this->impl->buffer = this->impl->uncompressed.empty() ? NULL : &this->impl->uncompressed[0];
+                this->impl->length = (int) this->impl->uncompressed.size();
+            } else {
+                this->impl->buffer = this->getContentBytes().data();
+                this->impl->length = (int) this->getContentBytes().size();
             }
 
-            this->dataIn.reset(new DataInputStream(is, true));
+            this->impl->position = 0;
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -981,20 +945,14 @@ void ActiveMQStreamMessage::initializeWriting() {
 
     this->failIfReadOnlyBody();
     try {
-        if (this->dataOut.get() == NULL) {
-            this->impl->bytesOut = new ByteArrayOutputStream();
-
-            OutputStream* os = this->impl->bytesOut;
+        if (!this->impl->writing) {
+            this->impl->body.clear();
+            this->impl->writing = true;
 
+            // The body is compressed in one go by the connection's codec when stored.
             if (this->connection != NULL && this->connection->isUseCompression()) {
                 this->compressed = true;
-
-                Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-
-                os = new DeflaterOutputStream(os, deflator, true, true);
             }
-
-            this->dataOut.reset(new DataOutputStream(os, true));
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -27,9 +27,8 @@
 #include <cms/MessageFormatException.h>
 #include <cms/MessageEOFException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
-#include <decaf/io/DataInputStream.h>
-#include <decaf/io/DataOutputStream.h>
 #include <string>
+#include <vector>
 #include <memory>
 
 namespace activemq {
@@ -37,14 +36,17 @@ namespace commands {
 
     class ActiveMQStreamMessageImpl;
 
+    /**
+     * The body of a StreamMessage is written in place into a buffer that becomes the
+     * content of the message when it is sent or reset, and read with a cursor over the
+     * content, or its decompressed copy, that peeks at each value's type before moving.
+     * A read that fails leaves the cursor on the value it could not read.
+     */
     class AMQCPP_API ActiveMQStreamMessage: public ActiveMQMessageTemplate<cms::StreamMessage> {
     private:
 
         ActiveMQStreamMessageImpl* impl;
 
-        mutable std::auto_ptr<decaf::io::DataInputStream> dataIn;
-        mutable std::auto_ptr<decaf::io::DataOutputStream> dataOut;
-
     public:
 
         const static unsigned char ID_ACTIVEMQSTREAMMESSAGE;
@@ -16,14 +16,8 @@
  */
 #include <activemq/commands/ActiveMQTextMessage.h>
 
-#include <decaf/io/ByteArrayInputStream.h>
-#include <decaf/io/ByteArrayOutputStream.h>
-#include <decaf/io/DataOutputStream.h>
-#include <decaf/io/DataInputStream.h>
-#include <decaf/util/zip/DeflaterOutputStream.h>
-#include <decaf/util/zip/InflaterInputStream.h>
-
-#include <activemq/util/MarshallingSupport.h>
+#include <decaf/io/IOException.h>
+
 #include <activemq/util/CMSExceptionSupport.h>
 #include <cms/CMSException.h>
 
@@ -99,12 +93,11 @@ std::string ActiveMQTextMessage::toString() const {
 
     try {
 
-        std::string text = getText();
+        const std::string& text = getTextView();
 
         if (text != "" && text.length() > 63) {
-
-            text = text.substr(0, 45) + "..." + text.substr(text.length() - 12);
-            return ActiveMQMessageTemplate<cms::TextMessage>::toString() + "Text = " + text;
+            return ActiveMQMessageTemplate<cms::TextMessage>::toString() + "Text = " +
+                   text.substr(0, 45) + "..." + text.substr(text.length() - 12);
         }
 
     } catch (cms::CMSException& e) {
@@ -127,37 +120,40 @@ void ActiveMQTextMessage::clearBody() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQTextMessage::beforeMarshal(wireformat::WireFormat* wireFormat) {
 
-    ActiveMQMessageTemplate<cms::TextMessage>::beforeMarshal(wireFormat);
-
     if (this->text.get() != NULL) {
 
-        ByteArrayOutputStream* bytesOut = new ByteArrayOutputStream;
-        OutputStream* os = bytesOut;
+        const std::string& value = *(this->text);
+        int length = (int) value.length();
+
+        // The body is the text prefixed by its four byte big endian length, built in
+        // place so the text is copied into the content only once.
+        unsigned char header[4];
+        header[0] = (unsigned char) ((length >> 24) & 0xFF);
+        header[1] = (unsigned char) ((length >> 16) & 0xFF);
+        header[2] = (unsigned char) ((length >> 8) & 0xFF);
+        header[3] = (unsigned char) (length & 0xFF);
 
         if (this->connection != NULL && this->connection->isUseCompression()) {
             this->compressed = true;
-            Deflater* deflator = new Deflater(this->connection->getCompressionLevel());
-            os = new DeflaterOutputStream(os, deflator, true, true);
-        }
 
-        DataOutputStream dataOut(os, true);
+            const unsigned char* buffers[2] = { header, (const unsigned char*) value.data() };
+            int lengths[2] = { 4, length };
 
-        if (this->text.get() == NULL) {
-            dataOut.writeInt(-1);
+            this->getContent().clear();
+            this->compressContent(buffers, lengths, 2);
         } else {
-            MarshallingSupport::writeString32(dataOut, *(this->text));
-        }
-
-        dataOut.close();
-
-        if (bytesOut->size() > 0) {
-            std::pair<unsigned char*, int> array = bytesOut->toByteArray();
-            this->setContent(std::vector<unsigned char>(array.first, array.first + array.second));
-            delete[] array.first;
+            std::vector<unsigned char>& content = this->getContent();
+            content.clear();
+            content.reserve(4 + value.length());
+            content.insert(content.end(), header, header + 4);
+            content.insert(content.end(), value.begin(), value.end());
         }
 
         this->text.reset(NULL);
     }
+
+    // Last, compressing the body may have set the codec property.
+    ActiveMQMessageTemplate<cms::TextMessage>::beforeMarshal(wireFormat);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -178,29 +174,65 @@ unsigned int ActiveMQTextMessage::getSize() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string ActiveMQTextMessage::getText() const {
 
+    try {
+        return getTextView();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& ActiveMQTextMessage::getTextView() const {
+
     try {
 
         if (this->text.get() != NULL) {
             return *(this->text.get());
         } else {
 
-            if (this->getContent().size() <= 4) {
-                return "";
+            const std::vector<unsigned char>& content = this->getContent();
+
+            if (content.size() <= 4) {
+                this->text.reset(new std::string());
+                return *(this->text.get());
             }
 
-            try {
+            if (!isCompressed()) {
 
-                InputStream* is = new ByteArrayInputStream(getContent());
+                // The body is a length prefixed string, when it is well formed the text
+                // is taken straight from the content without streaming through a copy.
+                int utfLength = ((content[0] & 0xFF) << 24) | ((content[1] & 0xFF) << 16) |
+                                ((content[2] & 0xFF) << 8) | (content[3] & 0xFF);
 
-                if (isCompressed()) {
-                    is = new InflaterInputStream(is, true);
+                if (utfLength <= 0) {
+                    this->text.reset(new std::string());
+                    return *(this->text.get());
+                } else if ((std::size_t) utfLength <= content.size() - 4) {
+                    this->text.reset(new std::string((const char*) &content[4], (std::size_t) utfLength));
+                    return *(this->text.get());
                 }
 
-                DataInputStream dataIn(is, true);
+                throw CMSExceptionSupport::create(
+                    IOException(__FILE__, __LINE__, "Text body is truncated."));
+            }
 
-                this->text.reset(new std::string(MarshallingSupport::readString32(dataIn)));
+            try {
+
+                std::vector<unsigned char> body;
+                this->decompressContent(0, body);
+
+                if (body.size() < 4) {
+                    throw IOException(__FILE__, __LINE__, "Compressed text body is truncated.");
+                }
+
+                int utfLength = ((body[0] & 0xFF) << 24) | ((body[1] & 0xFF) << 16) |
+                                ((body[2] & 0xFF) << 8) | (body[3] & 0xFF);
 
-                dataIn.close();
+                if (utfLength <= 0) {
+                    this->text.reset(new std::string());
+                } else if ((std::size_t) utfLength <= body.size() - 4) {
+                    this->text.reset(new std::string((const char*) &body[4], (std::size_t) utfLength));
+                } else {
+                    throw IOException(__FILE__, __LINE__, "Compressed text body is truncated.");
+                }
 
             } catch (IOException& ioe) {
                 throw CMSExceptionSupport::create(ioe);
@@ -62,6 +62,20 @@ namespace commands {
 
         virtual unsigned int getSize() const;
 
+        /**
+         * Returns the text of the message without copying it.  A received body is decoded
+         * the first time the text is read and kept, the same as getText does, so later
+         * calls of either method don't decode it again.
+         *
+         * The reference is valid until the text is set, the body is cleared or the
+         * message is sent or destroyed.
+         *
+         * @return a reference to the text of the message.
+         *
+         * @throws CMSException if the body can't be decoded.
+         */
+        const std::string& getTextView() const;
+
     public: // CMS Message
 
         virtual cms::TextMessage* clone() const;
@@ -20,6 +20,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/DataStructurePool.h>
 
 #include <string>
 #include <sstream>
@@ -35,6 +36,18 @@ namespace commands{
 
         virtual ~BaseDataStructure() {}
 
+        /**
+         * Commands are allocated through the DataStructurePool so that a connection
+         * that recycles its commands can draw them from its pool, see DataStructurePool.
+         */
+        static void* operator new(std::size_t size) {
+            return DataStructurePool::allocate(size);
+        }
+
+        static void operator delete(void* memory) {
+            DataStructurePool::deallocate(memory);
+        }
+
         virtual bool isMarshalAware() const {
             return false;
         }
@@ -16,6 +16,7 @@
  */
 
 #include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/IdSupport.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
 #include <decaf/internal/util/StringUtils.h>
@@ -109,13 +110,11 @@ unsigned char ConsumerId::getDataStructureType() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string ConsumerId::toString() const {
 
-    ostringstream stream;
+    std::string result;
+    result.reserve(this->connectionId.length() + 42);
+    IdSupport::appendId(result, this->connectionId, this->sessionId, this->value);
 
-    stream << this->connectionId << ":"
-           << this->sessionId << ":"
-           << this->value;
-
-    return stream.str();
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,11 +20,17 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/wireformat/MarshalAware.h>
+#include <decaf/util/concurrent/atomic/AtomicRefCounted.h>
 
 namespace activemq{
 namespace commands{
 
-    class AMQCPP_API DataStructure : public wireformat::MarshalAware {
+    /**
+     * Interface of the OpenWire data structures.  Data structures carry their own
+     * reference count, the Pointers that hold one share it rather than allocating one.
+     */
+    class AMQCPP_API DataStructure : public wireformat::MarshalAware,
+                                     public decaf::util::concurrent::atomic::AtomicRefCounted {
     public:
 
         virtual ~DataStructure() {}
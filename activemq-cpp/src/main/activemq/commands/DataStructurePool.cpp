@@ -0,0 +1,263 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataStructurePool.h"
+
+#include <decaf/lang/ThreadLocal.h>
+
+#include <new>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Every block starts with a header naming the pool it came from, the header is
+    // padded to keep the object that follows it suitably aligned.
+    struct BlockHeader {
+        DataStructurePool* pool;
+        std::size_t sizeClass;
+    };
+
+    const std::size_t HEADER_SIZE = 16;
+    const std::size_t GRANULARITY = 16;
+    const std::size_t MAX_POOLED_SIZE = 1024;
+    const std::size_t NUM_SIZE_CLASSES = MAX_POOLED_SIZE / GRANULARITY;
+
+    class PoolKernel {
+    private:
+
+        PoolKernel(const PoolKernel&);
+        PoolKernel& operator=(const PoolKernel&);
+
+    public:
+
+        ThreadLocal<DataStructurePool*> current;
+
+        // Number of Scopes open on any thread, while zero nothing can be pooled and the
+        // thread local lookup is skipped.
+        AtomicInteger activeScopes;
+
+        PoolKernel() : current(), activeScopes(0) {}
+    };
+
+    PoolKernel* kernel = NULL;
+
+    inline std::size_t blockSize(std::size_t sizeClass) {
+        return HEADER_SIZE + (sizeClass + 1) * GRANULARITY;
+    }
+
+    inline void* heapAllocate(std::size_t size) {
+        BlockHeader* header = static_cast<BlockHeader*>(::operator new(HEADER_SIZE + size));
+        header->pool = NULL;
+        header->sizeClass = 0;
+        return reinterpret_cast<unsigned char*>(header) + HEADER_SIZE;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const int DataStructurePool::DEFAULT_MAX_CACHED_BLOCKS = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructurePool::DataStructurePool(int maxCachedBlocks) :
+    mutex(), sizeClasses(NUM_SIZE_CLASSES), maxCachedBlocks(maxCachedBlocks), closed(false), references(1) {
+
+    for (std::size_t i = 0; i < this->sizeClasses.size(); ++i) {
+        this->sizeClasses[i].free = NULL;
+        this->sizeClasses[i].count = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructurePool::~DataStructurePool() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::close() {
+
+    synchronized(&mutex) {
+        if (this->closed) {
+            return;
+        }
+
+        this->closed = true;
+
+        for (std::size_t i = 0; i < this->sizeClasses.size(); ++i) {
+            FreeBlock* block = this->sizeClasses[i].free;
+            while (block != NULL) {
+                FreeBlock* next = block->next;
+                ::operator delete(block);
+                block = next;
+            }
+            this->sizeClasses[i].free = NULL;
+            this->sizeClasses[i].count = 0;
+        }
+    }
+
+    this->release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DataStructurePool::getCachedBlockCount() const {
+
+    int result = 0;
+
+    synchronized(&mutex) {
+        for (std::size_t i = 0; i < this->sizeClasses.size(); ++i) {
+            result += this->sizeClasses[i].count;
+        }
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DataStructurePool::getActiveBlockCount() const {
+    return this->references.get() - (this->closed ? 0 : 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* DataStructurePool::allocateBlock(std::size_t sizeClass) {
+
+    this->references.incrementAndGet();
+
+    void* block = NULL;
+
+    synchronized(&mutex) {
+        SizeClass& entry = this->sizeClasses[sizeClass];
+        if (entry.free != NULL) {
+            block = entry.free;
+            entry.free = entry.free->next;
+            entry.count--;
+        }
+    }
+
+    if (block == NULL) {
+        try {
+            block = ::operator new(blockSize(sizeClass));
+        } catch (std::bad_alloc&) {
+            this->release();
+            throw;
+        }
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*>(block);
+    header->pool = this;
+    header->sizeClass = sizeClass;
+
+    return reinterpret_cast<unsigned char*>(block) + HEADER_SIZE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::releaseBlock(void* block, std::size_t sizeClass) {
+
+    bool cached = false;
+
+    synchronized(&mutex) {
+        SizeClass& entry = this->sizeClasses[sizeClass];
+        if (!this->closed && entry.count < this->maxCachedBlocks) {
+            FreeBlock* free = static_cast<FreeBlock*>(block);
+            free->next = entry.free;
+            entry.free = free;
+            entry.count++;
+            cached = true;
+        }
+    }
+
+    if (!cached) {
+        ::operator delete(block);
+    }
+
+    this->release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::release() {
+    if (this->references.decrementAndGet() == 0) {
+        delete this;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* DataStructurePool::allocate(std::size_t size) {
+
+    if (kernel == NULL || kernel->activeScopes.get() == 0 || size > MAX_POOLED_SIZE) {
+        return heapAllocate(size);
+    }
+
+    DataStructurePool* pool = kernel->current.get();
+    if (pool == NULL) {
+        return heapAllocate(size);
+    }
+
+    std::size_t sizeClass = size == 0 ? 0 : (size - 1) / GRANULARITY;
+    return pool->allocateBlock(sizeClass);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::deallocate(void* memory) {
+
+    if (memory == NULL) {
+        return;
+    }
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<unsigned char*>(memory) - HEADER_SIZE);
+
+    if (header->pool != NULL) {
+        header->pool->releaseBlock(header, header->sizeClass);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructurePool::Scope::Scope(DataStructurePool* pool) : slot(NULL), previous(NULL) {
+
+    if (kernel != NULL && pool != NULL) {
+        this->slot = &(kernel->current.get());
+        this->previous = *(this->slot);
+        *(this->slot) = pool;
+        kernel->activeScopes.incrementAndGet();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructurePool::Scope::~Scope() {
+
+    if (this->slot != NULL) {
+        *(this->slot) = this->previous;
+        kernel->activeScopes.decrementAndGet();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::initialize() {
+    kernel = new PoolKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePool::shutdown() {
+    PoolKernel* old = kernel;
+    kernel = NULL;
+    delete old;
+}
@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_
+#define _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace commands {
+
+    /**
+     * Recycles the memory of the DataStructure objects the wire format creates when it
+     * unmarshals a command.  A pool belongs to one connection's wire format, while the
+     * wire format is unmarshaling it installs its pool as the current pool of the reading
+     * thread and every DataStructure allocated in that window is drawn from the pool.
+     * When such an object is deleted, on whatever thread is holding its last reference,
+     * its memory goes back to the pool's free list for the next command rather than
+     * back to the heap.
+     *
+     * Objects allocated while no pool is installed use the heap as before.  Each block
+     * records the pool it came from so a pool stays valid until the last of its objects
+     * is gone, even after its owner has closed it.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API DataStructurePool {
+    public:
+
+        /**
+         * Default number of free blocks kept for each block size.
+         */
+        static const int DEFAULT_MAX_CACHED_BLOCKS;
+
+    private:
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct SizeClass {
+            FreeBlock* free;
+            int count;
+        };
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::vector<SizeClass> sizeClasses;
+
+        int maxCachedBlocks;
+
+        bool closed;
+
+        // One for the owner plus one for each block currently handed out.
+        decaf::util::concurrent::atomic::AtomicInteger references;
+
+    private:
+
+        DataStructurePool(const DataStructurePool&);
+        DataStructurePool& operator=(const DataStructurePool&);
+
+        ~DataStructurePool();
+
+    public:
+
+        /**
+         * Creates a new pool, the caller owns it and must close it when done.
+         *
+         * @param maxCachedBlocks
+         *      The number of free blocks kept for each block size, blocks returned
+         *      beyond that are released to the heap.
+         */
+        DataStructurePool(int maxCachedBlocks = DEFAULT_MAX_CACHED_BLOCKS);
+
+        /**
+         * Releases the owner's hold on the pool.  Free blocks are returned to the heap,
+         * objects still alive stay valid and are freed to the heap when deleted.  The
+         * pool goes away once its last object does, it must not be used after this.
+         */
+        void close();
+
+        /**
+         * @return the number of free blocks currently waiting to be reused.
+         */
+        int getCachedBlockCount() const;
+
+        /**
+         * @return the number of blocks handed out by this pool that are still in use.
+         */
+        int getActiveBlockCount() const;
+
+    public:
+
+        /**
+         * Makes a pool the current pool of the calling thread for the lifetime of this
+         * object, restoring whatever was current before when it goes out of scope.
+         */
+        class AMQCPP_API Scope {
+        private:
+
+            DataStructurePool** slot;
+            DataStructurePool* previous;
+
+        private:
+
+            Scope(const Scope&);
+            Scope& operator=(const Scope&);
+
+        public:
+
+            Scope(DataStructurePool* pool);
+
+            ~Scope();
+        };
+
+    public:
+
+        /**
+         * Allocates the memory for a DataStructure, taken from the calling thread's
+         * current pool if there is one, otherwise from the heap.
+         *
+         * @param size
+         *      The size of the object being created.
+         *
+         * @return the memory for the object.
+         */
+        static void* allocate(std::size_t size);
+
+        /**
+         * Releases memory obtained from allocate, to the pool it was drawn from if
+         * there was one.
+         *
+         * @param memory
+         *      The memory to free, may be NULL.
+         */
+        static void deallocate(void* memory);
+
+    private:
+
+        void* allocateBlock(std::size_t sizeClass);
+
+        void releaseBlock(void* block, std::size_t sizeClass);
+
+        void release();
+
+        static void initialize();
+
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_DATASTRUCTUREPOOL_H_ */
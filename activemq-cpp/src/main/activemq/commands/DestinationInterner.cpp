@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DestinationInterner.h"
+
+#include <decaf/internal/util/concurrent/SharedMutex.h>
+
+#include <map>
+#include <string>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    typedef std::map<std::string, Pointer<ActiveMQDestination> > NameMap;
+
+    class InternerKernel {
+    private:
+
+        InternerKernel(const InternerKernel&);
+        InternerKernel& operator=(const InternerKernel&);
+
+    public:
+
+        // Lookups take the read lock, only a name seen for the first time takes the
+        // write lock.  Neither is held across a call that could lock again so the
+        // platform lock serves without the hold tracking of ReentrantReadWriteLock.
+        SharedMutex lock;
+
+        NameMap queues;
+        NameMap topics;
+
+        InternerKernel() : lock(), queues(), topics() {}
+
+        NameMap& namesOf(const ActiveMQDestination& destination) {
+            return destination.getDestinationType() == cms::Destination::QUEUE ? queues : topics;
+        }
+    };
+
+    InternerKernel* kernel = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const int DestinationInterner::MAX_INTERNED = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+bool DestinationInterner::isInternable(const ActiveMQDestination& destination) {
+
+    cms::Destination::DestinationType type = destination.getDestinationType();
+    if (type != cms::Destination::QUEUE && type != cms::Destination::TOPIC) {
+        return false;
+    }
+
+    return !destination.isComposite() && destination.getOptions().isEmpty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQDestination* DestinationInterner::intern(const ActiveMQDestination& destination) {
+
+    if (kernel == NULL || !isInternable(destination)) {
+        return NULL;
+    }
+
+    NameMap& names = kernel->namesOf(destination);
+
+    kernel->lock.readLock();
+    try {
+        NameMap::const_iterator found = names.find(destination.getPhysicalName());
+        if (found != names.end()) {
+            ActiveMQDestination* interned = found->second.get();
+            kernel->lock.unlock();
+            return interned;
+        }
+    } catch (...) {
+        kernel->lock.unlock();
+        throw;
+    }
+    kernel->lock.unlock();
+
+    kernel->lock.writeLock();
+    try {
+
+        ActiveMQDestination* interned = NULL;
+
+        // Another thread may have interned the name since the lookup.
+        NameMap::const_iterator found = names.find(destination.getPhysicalName());
+        if (found != names.end()) {
+            interned = found->second.get();
+        } else if ((int) (kernel->queues.size() + kernel->topics.size()) < MAX_INTERNED) {
+            Pointer<ActiveMQDestination> canonical(destination.cloneDataStructure());
+            names.insert(std::make_pair(destination.getPhysicalName(), canonical));
+            interned = canonical.get();
+        }
+
+        kernel->lock.unlock();
+        return interned;
+
+    } catch (...) {
+        kernel->lock.unlock();
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DestinationInterner::getInternedCount() {
+
+    if (kernel == NULL) {
+        return 0;
+    }
+
+    kernel->lock.readLock();
+    int count = (int) (kernel->queues.size() + kernel->topics.size());
+    kernel->lock.unlock();
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationInterner::initialize() {
+    kernel = new InternerKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DestinationInterner::shutdown() {
+    InternerKernel* old = kernel;
+    kernel = NULL;
+    delete old;
+}
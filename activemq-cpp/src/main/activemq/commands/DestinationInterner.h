@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_DESTINATIONINTERNER_H_
+#define _ACTIVEMQ_COMMANDS_DESTINATIONINTERNER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/ActiveMQDestination.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace commands {
+
+    /**
+     * Process wide registry holding one canonical instance of each queue and topic seen,
+     * keyed by type and physical name.  The wire format hands out the canonical instance
+     * for every queue or topic it decodes, so the destinations of all received messages
+     * for one name are the same object, their hash computed once and equality decided
+     * by the pointer compare in ActiveMQDestination::equals.
+     *
+     * Only plain names are interned, temporary destinations come and go with their
+     * connections and composite names or names carrying options keep state of their
+     * own.  The registry never forgets a name, once it holds MAX_INTERNED names new
+     * ones are no longer interned.  Canonical instances are shared between threads and
+     * must not be modified.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API DestinationInterner {
+    public:
+
+        /**
+         * Number of names the registry holds at most.
+         */
+        static const int MAX_INTERNED;
+
+    private:
+
+        DestinationInterner();
+        DestinationInterner(const DestinationInterner&);
+        DestinationInterner& operator=(const DestinationInterner&);
+
+    public:
+
+        /**
+         * @return true if the destination is of a type and name that can be interned.
+         */
+        static bool isInternable(const ActiveMQDestination& destination);
+
+        /**
+         * Returns the canonical instance for the destination's type and name, it becomes
+         * a copy of the given destination if there was none.  The registry keeps its own
+         * reference, callers share the instance through Pointers as usual.
+         *
+         * @param destination
+         *      The destination to find the canonical instance of.
+         *
+         * @return the canonical instance, or NULL if the destination can't be interned,
+         *         the registry is full or the library isn't initialized.
+         */
+        static ActiveMQDestination* intern(const ActiveMQDestination& destination);
+
+        /**
+         * @return the number of names currently interned.
+         */
+        static int getInternedCount();
+
+    private:
+
+        static void initialize();
+
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_DESTINATIONINTERNER_H_ */
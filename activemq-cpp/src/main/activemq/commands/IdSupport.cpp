@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IdSupport.h"
+
+#include <activemq/commands/ProducerId.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/ThreadLocal.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Longer numbers could overflow the fast path, Long decides about them.
+    const std::size_t MAX_FAST_DIGITS = 18;
+
+    struct LastProducer {
+        std::string text;
+        Pointer<ProducerId> id;
+
+        LastProducer() : text(), id() {}
+    };
+
+    class IdSupportKernel {
+    private:
+
+        IdSupportKernel(const IdSupportKernel&);
+        IdSupportKernel& operator=(const IdSupportKernel&);
+
+    public:
+
+        ThreadLocal<LastProducer> lastProducer;
+
+        IdSupportKernel() : lastProducer() {}
+    };
+
+    IdSupportKernel* kernel = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t IdSupport::parseLastNumber(const std::string& text, std::size_t length, long long& value) {
+
+    if (length == 0) {
+        return std::string::npos;
+    }
+
+    std::size_t separator = text.rfind(':', length - 1);
+    if (separator == std::string::npos) {
+        return std::string::npos;
+    }
+
+    std::size_t start = separator + 1;
+    bool negative = start < length && text[start] == '-';
+    std::size_t digits = negative ? start + 1 : start;
+
+    if (digits < length && length - digits <= MAX_FAST_DIGITS) {
+
+        long long result = 0;
+        std::size_t i = digits;
+        for (; i < length; ++i) {
+            char c = text[i];
+            if (c < '0' || c > '9') {
+                break;
+            }
+            result = result * 10 + (c - '0');
+        }
+
+        if (i == length) {
+            value = negative ? -result : result;
+            return separator;
+        }
+    }
+
+    // Anything unusual is parsed, or refused, the way Long does it.
+    value = Long::parseLong(text.substr(start, length - start));
+    return separator;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupport::appendNumber(std::string& buffer, long long value) {
+
+    char digits[24];
+    std::size_t position = sizeof(digits);
+
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long) value : (unsigned long long) value;
+    do {
+        digits[--position] = (char) ('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0) {
+        digits[--position] = '-';
+    }
+
+    buffer.append(digits + position, sizeof(digits) - position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupport::appendId(std::string& buffer, const std::string& connectionId, long long sessionId, long long value) {
+    buffer.append(connectionId);
+    buffer.append(1, ':');
+    appendNumber(buffer, sessionId);
+    buffer.append(1, ':');
+    appendNumber(buffer, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ProducerId> IdSupport::parseProducerId(const std::string& text, std::size_t length) {
+
+    LastProducer* last = NULL;
+    if (kernel != NULL) {
+        last = &kernel->lastProducer.get();
+        if (last->id != NULL && last->text.length() == length && text.compare(0, length, last->text) == 0) {
+            return last->id;
+        }
+    }
+
+    Pointer<ProducerId> id(new ProducerId());
+
+    long long number = 0;
+    std::size_t end = parseLastNumber(text, length, number);
+    if (end != std::string::npos) {
+        id->setValue(number);
+
+        std::size_t sessionEnd = parseLastNumber(text, end, number);
+        if (sessionEnd != std::string::npos) {
+            id->setSessionId(number);
+            end = sessionEnd;
+        }
+    } else {
+        end = length;
+    }
+
+    id->setConnectionId(text.substr(0, end));
+
+    if (last != NULL) {
+        last->text.assign(text, 0, length);
+        last->id = id;
+    }
+
+    return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupport::initialize() {
+    kernel = new IdSupportKernel();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupport::shutdown() {
+    IdSupportKernel* old = kernel;
+    kernel = NULL;
+    delete old;
+}
@@ -0,0 +1,110 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_IDSUPPORT_H_
+#define _ACTIVEMQ_COMMANDS_IDSUPPORT_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace commands {
+
+    class ProducerId;
+
+    /**
+     * Parsing and formatting shared by the id commands, working on the strings in place
+     * rather than through substrings, tokenizers and streams.
+     *
+     * Message ids arriving as strings tend to come from a handful of producers, so each
+     * thread keeps the ProducerId it parsed last along with its text.  A MessageId string
+     * naming the same producer shares that ProducerId instead of parsing the prefix and
+     * copying the connection id again.  Shared ProducerIds must not be modified.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API IdSupport {
+    private:
+
+        IdSupport();
+        IdSupport(const IdSupport&);
+        IdSupport& operator=(const IdSupport&);
+
+    public:
+
+        /**
+         * Parses the number that follows the last ':' within the first length characters
+         * of the text.
+         *
+         * @param text
+         *      The text to parse.
+         * @param length
+         *      The number of characters of the text to consider.
+         * @param value
+         *      Set to the number if there is a ':', left unchanged otherwise.
+         *
+         * @return the position of the ':' or std::string::npos if there is none.
+         *
+         * @throws NumberFormatException if what follows the ':' is not a number.
+         */
+        static std::size_t parseLastNumber(const std::string& text, std::size_t length, long long& value);
+
+        /**
+         * Appends the decimal form of the value to the buffer.
+         */
+        static void appendNumber(std::string& buffer, long long value);
+
+        /**
+         * Appends "connectionId:sessionId:value", the form the producer, consumer and
+         * session scoped ids print as.
+         */
+        static void appendId(std::string& buffer, const std::string& connectionId, long long sessionId, long long value);
+
+        /**
+         * Returns the ProducerId named by the first length characters of the text, the
+         * producer part of a MessageId string.  The ProducerId the calling thread parsed
+         * last is returned when the text is the same as it was then.
+         *
+         * @param text
+         *      The text holding the producer id.
+         * @param length
+         *      The number of characters of the text that make up the producer id.
+         *
+         * @return the ProducerId, shared with other MessageIds parsed from its text.
+         *
+         * @throws NumberFormatException if the session or producer value is not a number.
+         */
+        static decaf::lang::Pointer<ProducerId> parseProducerId(const std::string& text, std::size_t length);
+
+    private:
+
+        static void initialize();
+
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_COMMANDS_IDSUPPORT_H_ */
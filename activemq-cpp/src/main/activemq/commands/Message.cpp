@@ -32,6 +32,39 @@ using namespace activemq::commands;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace commands {
+
+    class MessageRareFields {
+    public:
+
+        Pointer<ActiveMQDestination> originalDestination;
+        Pointer<TransactionId> originalTransactionId;
+        std::string groupID;
+        int groupSequence;
+        std::string correlationId;
+        Pointer<ActiveMQDestination> replyTo;
+        std::string type;
+        Pointer<DataStructure> dataStructure;
+        Pointer<ConsumerId> targetConsumerId;
+        std::vector< Pointer<BrokerId> > brokerPath;
+        std::string userID;
+        std::vector< Pointer<BrokerId> > cluster;
+
+        MessageRareFields() : originalDestination(NULL), originalTransactionId(NULL), groupID(), groupSequence(0),
+                              correlationId(), replyTo(NULL), type(), dataStructure(NULL), targetConsumerId(NULL),
+                              brokerPath(), userID(), cluster() {}
+    };
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Read by the getters of a Message whose rare fields were never set, never written.
+    const MessageRareFields NO_RARE_FIELDS;
+}
+
 /*
  *
  *  Command code for OpenWire format for Message
@@ -44,16 +77,16 @@ using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 Message::Message() :
-    BaseCommand(), producerId(NULL), destination(NULL), transactionId(NULL), originalDestination(NULL), messageId(NULL), originalTransactionId(NULL), 
-      groupID(""), groupSequence(0), correlationId(""), persistent(false), expiration(0), priority(0), replyTo(NULL), timestamp(0), 
-      type(""), content(), marshalledProperties(), dataStructure(NULL), targetConsumerId(NULL), compressed(false), redeliveryCounter(0), 
-      brokerPath(), arrival(0), userID(""), recievedByDFBridge(false), droppable(false), cluster(), brokerInTime(0), brokerOutTime(0), 
-      jMSXGroupFirstForConsumer(false), ackHandler(NULL), properties(), readOnlyProperties(false), readOnlyBody(false), connection(NULL) {
+    BaseCommand(), producerId(NULL), destination(NULL), transactionId(NULL), messageId(NULL), persistent(false), expiration(0), 
+      priority(0), timestamp(0), content(), marshalledProperties(), compressed(false), redeliveryCounter(0), arrival(0), 
+      recievedByDFBridge(false), droppable(false), brokerInTime(0), brokerOutTime(0), jMSXGroupFirstForConsumer(false), 
+      rareFields(NULL), ackHandler(NULL), properties(), propertiesUnmarshalPending(false), propertiesUnchanged(false), readOnlyProperties(false), readOnlyBody(false), connection(NULL) {
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Message::~Message() {
+    delete this->rareFields;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,34 +121,39 @@ void Message::copyDataStructure(const DataStructure* src) {
     this->setProducerId(srcPtr->getProducerId());
     this->setDestination(srcPtr->getDestination());
     this->setTransactionId(srcPtr->getTransactionId());
-    this->setOriginalDestination(srcPtr->getOriginalDestination());
+    // The rare fields are copied as one block, if the source has any.
+    if (srcPtr->rareFields != NULL) {
+        this->editRareFields() = *srcPtr->rareFields;
+    } else if (this->rareFields != NULL) {
+        delete this->rareFields;
+        this->rareFields = NULL;
+    }
     this->setMessageId(srcPtr->getMessageId());
-    this->setOriginalTransactionId(srcPtr->getOriginalTransactionId());
-    this->setGroupID(srcPtr->getGroupID());
-    this->setGroupSequence(srcPtr->getGroupSequence());
-    this->setCorrelationId(srcPtr->getCorrelationId());
     this->setPersistent(srcPtr->isPersistent());
     this->setExpiration(srcPtr->getExpiration());
     this->setPriority(srcPtr->getPriority());
-    this->setReplyTo(srcPtr->getReplyTo());
     this->setTimestamp(srcPtr->getTimestamp());
-    this->setType(srcPtr->getType());
-    this->setContent(srcPtr->getContent());
-    this->setMarshalledProperties(srcPtr->getMarshalledProperties());
-    this->setDataStructure(srcPtr->getDataStructure());
-    this->setTargetConsumerId(srcPtr->getTargetConsumerId());
+    // The body and marshaled properties are shared until either message changes them.
+    this->content = srcPtr->content;
+    this->marshalledProperties = srcPtr->marshalledProperties;
     this->setCompressed(srcPtr->isCompressed());
     this->setRedeliveryCounter(srcPtr->getRedeliveryCounter());
-    this->setBrokerPath(srcPtr->getBrokerPath());
     this->setArrival(srcPtr->getArrival());
-    this->setUserID(srcPtr->getUserID());
     this->setRecievedByDFBridge(srcPtr->isRecievedByDFBridge());
     this->setDroppable(srcPtr->isDroppable());
-    this->setCluster(srcPtr->getCluster());
     this->setBrokerInTime(srcPtr->getBrokerInTime());
     this->setBrokerOutTime(srcPtr->getBrokerOutTime());
     this->setJMSXGroupFirstForConsumer(srcPtr->isJMSXGroupFirstForConsumer());
-    this->properties.copy(srcPtr->properties);
+    // Unchanged properties are read from the shared marshaled bytes if the copy ever
+    // uses them instead of being copied.
+    if (srcPtr->propertiesUnchanged) {
+        this->properties.clear();
+        this->propertiesUnmarshalPending = !this->marshalledProperties.isEmpty();
+    } else {
+        this->properties.copy(srcPtr->properties);
+        this->propertiesUnmarshalPending = srcPtr->propertiesUnmarshalPending;
+    }
+    this->propertiesUnchanged = srcPtr->propertiesUnchanged;
     this->setAckHandler(srcPtr->getAckHandler());
     this->setReadOnlyBody(srcPtr->isReadOnlyBody());
     this->setReadOnlyProperties(srcPtr->isReadOnlyProperties());
@@ -440,7 +478,7 @@ bool Message::equals(const DataStructure* value) const {
         return false;
     }
 
-    if (!properties.equals(valuePtr->properties)) {
+    if (!getMessageProperties().equals(valuePtr->getMessageProperties())) {
         return false;
     }
 
@@ -505,17 +543,19 @@ void Message::setTransactionId(const decaf::lang::Pointer<TransactionId>& transa
 
 ////////////////////////////////////////////////////////////////////////////////
 const decaf::lang::Pointer<ActiveMQDestination>& Message::getOriginalDestination() const {
-    return originalDestination;
+    return getRareFields().originalDestination;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<ActiveMQDestination>& Message::getOriginalDestination() {
-    return originalDestination;
+    return editRareFields().originalDestination;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setOriginalDestination(const decaf::lang::Pointer<ActiveMQDestination>& originalDestination) {
-    this->originalDestination = originalDestination;
+    if (this->rareFields != NULL || originalDestination != NULL) {
+        editRareFields().originalDestination = originalDestination;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -535,57 +575,65 @@ void Message::setMessageId(const decaf::lang::Pointer<MessageId>& messageId) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const decaf::lang::Pointer<TransactionId>& Message::getOriginalTransactionId() const {
-    return originalTransactionId;
+    return getRareFields().originalTransactionId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<TransactionId>& Message::getOriginalTransactionId() {
-    return originalTransactionId;
+    return editRareFields().originalTransactionId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setOriginalTransactionId(const decaf::lang::Pointer<TransactionId>& originalTransactionId) {
-    this->originalTransactionId = originalTransactionId;
+    if (this->rareFields != NULL || originalTransactionId != NULL) {
+        editRareFields().originalTransactionId = originalTransactionId;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::string& Message::getGroupID() const {
-    return groupID;
+    return getRareFields().groupID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& Message::getGroupID() {
-    return groupID;
+    return editRareFields().groupID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setGroupID(const std::string& groupID) {
-    this->groupID = groupID;
+    if (this->rareFields != NULL || !groupID.empty()) {
+        editRareFields().groupID = groupID;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Message::getGroupSequence() const {
-    return groupSequence;
+    return getRareFields().groupSequence;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setGroupSequence(int groupSequence) {
-    this->groupSequence = groupSequence;
+    if (this->rareFields != NULL || groupSequence != 0) {
+        editRareFields().groupSequence = groupSequence;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::string& Message::getCorrelationId() const {
-    return correlationId;
+    return getRareFields().correlationId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& Message::getCorrelationId() {
-    return correlationId;
+    return editRareFields().correlationId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setCorrelationId(const std::string& correlationId) {
-    this->correlationId = correlationId;
+    if (this->rareFields != NULL || !correlationId.empty()) {
+        editRareFields().correlationId = correlationId;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -620,17 +668,19 @@ void Message::setPriority(unsigned char priority) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const decaf::lang::Pointer<ActiveMQDestination>& Message::getReplyTo() const {
-    return replyTo;
+    return getRareFields().replyTo;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<ActiveMQDestination>& Message::getReplyTo() {
-    return replyTo;
+    return editRareFields().replyTo;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setReplyTo(const decaf::lang::Pointer<ActiveMQDestination>& replyTo) {
-    this->replyTo = replyTo;
+    if (this->rareFields != NULL || replyTo != NULL) {
+        editRareFields().replyTo = replyTo;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -645,27 +695,29 @@ void Message::setTimestamp(long long timestamp) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::string& Message::getType() const {
-    return type;
+    return getRareFields().type;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& Message::getType() {
-    return type;
+    return editRareFields().type;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setType(const std::string& type) {
-    this->type = type;
+    if (this->rareFields != NULL || !type.empty()) {
+        editRareFields().type = type;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector<unsigned char>& Message::getContent() const {
-    return content;
+    return content.get();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<unsigned char>& Message::getContent() {
-    return content;
+    return content.edit();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -675,12 +727,12 @@ void Message::setContent(const std::vector<unsigned char>& content) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector<unsigned char>& Message::getMarshalledProperties() const {
-    return marshalledProperties;
+    return marshalledProperties.get();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<unsigned char>& Message::getMarshalledProperties() {
-    return marshalledProperties;
+    return marshalledProperties.edit();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -690,32 +742,36 @@ void Message::setMarshalledProperties(const std::vector<unsigned char>& marshall
 
 ////////////////////////////////////////////////////////////////////////////////
 const decaf::lang::Pointer<DataStructure>& Message::getDataStructure() const {
-    return dataStructure;
+    return getRareFields().dataStructure;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<DataStructure>& Message::getDataStructure() {
-    return dataStructure;
+    return editRareFields().dataStructure;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setDataStructure(const decaf::lang::Pointer<DataStructure>& dataStructure) {
-    this->dataStructure = dataStructure;
+    if (this->rareFields != NULL || dataStructure != NULL) {
+        editRareFields().dataStructure = dataStructure;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 const decaf::lang::Pointer<ConsumerId>& Message::getTargetConsumerId() const {
-    return targetConsumerId;
+    return getRareFields().targetConsumerId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<ConsumerId>& Message::getTargetConsumerId() {
-    return targetConsumerId;
+    return editRareFields().targetConsumerId;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setTargetConsumerId(const decaf::lang::Pointer<ConsumerId>& targetConsumerId) {
-    this->targetConsumerId = targetConsumerId;
+    if (this->rareFields != NULL || targetConsumerId != NULL) {
+        editRareFields().targetConsumerId = targetConsumerId;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -740,17 +796,19 @@ void Message::setRedeliveryCounter(int redeliveryCounter) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector< decaf::lang::Pointer<BrokerId> >& Message::getBrokerPath() const {
-    return brokerPath;
+    return getRareFields().brokerPath;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::vector< decaf::lang::Pointer<BrokerId> >& Message::getBrokerPath() {
-    return brokerPath;
+    return editRareFields().brokerPath;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setBrokerPath(const std::vector< decaf::lang::Pointer<BrokerId> >& brokerPath) {
-    this->brokerPath = brokerPath;
+    if (this->rareFields != NULL || !brokerPath.empty()) {
+        editRareFields().brokerPath = brokerPath;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -765,17 +823,19 @@ void Message::setArrival(long long arrival) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::string& Message::getUserID() const {
-    return userID;
+    return getRareFields().userID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::string& Message::getUserID() {
-    return userID;
+    return editRareFields().userID;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setUserID(const std::string& userID) {
-    this->userID = userID;
+    if (this->rareFields != NULL || !userID.empty()) {
+        editRareFields().userID = userID;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -800,17 +860,19 @@ void Message::setDroppable(bool droppable) {
 
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector< decaf::lang::Pointer<BrokerId> >& Message::getCluster() const {
-    return cluster;
+    return getRareFields().cluster;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 std::vector< decaf::lang::Pointer<BrokerId> >& Message::getCluster() {
-    return cluster;
+    return editRareFields().cluster;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Message::setCluster(const std::vector< decaf::lang::Pointer<BrokerId> >& cluster) {
-    this->cluster = cluster;
+    if (this->rareFields != NULL || !cluster.empty()) {
+        editRareFields().cluster = cluster;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -843,6 +905,19 @@ void Message::setJMSXGroupFirstForConsumer(bool jMSXGroupFirstForConsumer) {
     this->jMSXGroupFirstForConsumer = jMSXGroupFirstForConsumer;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const MessageRareFields& Message::getRareFields() const {
+    return this->rareFields != NULL ? *this->rareFields : NO_RARE_FIELDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageRareFields& Message::editRareFields() {
+    if (this->rareFields == NULL) {
+        this->rareFields = new MessageRareFields();
+    }
+    return *this->rareFields;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 decaf::lang::Pointer<commands::Command> Message::visit(activemq::state::CommandVisitor* visitor) {
     return visitor->processMessage(this);
@@ -850,8 +925,12 @@ decaf::lang::Pointer<commands::Command> Message::visit(activemq::state::CommandV
 
 ////////////////////////////////////////////////////////////////////////////////
 bool Message::isExpired() const {
+    return this->isExpired(decaf::lang::System::coarseTimeMillis());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Message::isExpired(long long currentTime) const {
     long long expireTime = this->getExpiration();
-    long long currentTime = decaf::lang::System::currentTimeMillis();
     if (expireTime > 0 && currentTime > expireTime) {
         return true;
     }
@@ -863,8 +942,8 @@ unsigned int Message::getSize() const {
 
     unsigned int size = DEFAULT_MESSAGE_SIZE;
 
-    size += (unsigned int)this->getContent().size();
-    size += (unsigned int)this->getMarshalledProperties().size();
+    size += (unsigned int)this->content.size();
+    size += (unsigned int)this->marshalledProperties.size();
 
     return size;
 }
@@ -873,10 +952,17 @@ unsigned int Message::getSize() const {
 void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
 
     try {
+
+        // Properties that haven't changed since they were received are sent on in
+        // the marshaled form they arrived in.
+        if (propertiesUnchanged) {
+            return;
+        }
+
         marshalledProperties.clear();
         if (!properties.isEmpty()) {
             wireformat::openwire::marshal::PrimitiveTypesMarshaller::marshal(
-                &properties, marshalledProperties );
+                &properties, marshalledProperties.edit() );
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -884,12 +970,31 @@ void Message::beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
     AMQ_CATCHALL_THROW(decaf::io::IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Message::storeMarshaledForm() {
+    this->beforeMarshal(NULL);
+    this->propertiesUnchanged = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Message::afterUnmarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED) {
 
+    // The properties are unmarshaled on first use, see unmarshalProperties.
+    propertiesUnmarshalPending = !marshalledProperties.isEmpty();
+    propertiesUnchanged = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Message::unmarshalProperties() const {
+
+    if (!propertiesUnmarshalPending) {
+        return;
+    }
+
     try {
         wireformat::openwire::marshal::PrimitiveTypesMarshaller::unmarshal(
-            &properties, marshalledProperties);
+            &properties, marshalledProperties.get());
+        propertiesUnmarshalPending = false;
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
@@ -33,6 +33,7 @@
 #include <activemq/commands/TransactionId.h>
 #include <activemq/core/ActiveMQAckHandler.h>
 #include <activemq/util/Config.h>
+#include <activemq/util/CopyOnWriteBytes.h>
 #include <activemq/util/PrimitiveMap.h>
 #include <decaf/lang/Pointer.h>
 #include <string>
@@ -47,6 +48,8 @@ namespace commands{
 
     using decaf::lang::Pointer;
 
+    class MessageRareFields;
+
     /*
      *
      *  Command code for OpenWire format for Message
@@ -62,30 +65,18 @@ namespace commands{
         Pointer<ProducerId> producerId;
         Pointer<ActiveMQDestination> destination;
         Pointer<TransactionId> transactionId;
-        Pointer<ActiveMQDestination> originalDestination;
         Pointer<MessageId> messageId;
-        Pointer<TransactionId> originalTransactionId;
-        std::string groupID;
-        int groupSequence;
-        std::string correlationId;
         bool persistent;
         long long expiration;
         unsigned char priority;
-        Pointer<ActiveMQDestination> replyTo;
         long long timestamp;
-        std::string type;
-        std::vector<unsigned char> content;
-        std::vector<unsigned char> marshalledProperties;
-        Pointer<DataStructure> dataStructure;
-        Pointer<ConsumerId> targetConsumerId;
+        activemq::util::CopyOnWriteBytes content;
+        activemq::util::CopyOnWriteBytes marshalledProperties;
         bool compressed;
         int redeliveryCounter;
-        std::vector< decaf::lang::Pointer<BrokerId> > brokerPath;
         long long arrival;
-        std::string userID;
         bool recievedByDFBridge;
         bool droppable;
-        std::vector< decaf::lang::Pointer<BrokerId> > cluster;
         long long brokerInTime;
         long long brokerOutTime;
         bool jMSXGroupFirstForConsumer;
@@ -96,13 +87,27 @@ namespace commands{
 
     private:
 
+        // The fields most messages leave empty, the original destination and transaction,
+        // group, correlation id, reply to, type, data structure, target consumer, broker
+        // path, user id and cluster.  Allocated by the first setter given a value that
+        // isn't the default, until then the getters return the defaults.
+        MessageRareFields* rareFields;
+
         // Used to allow a client to call Message::acknowledge when in the Client
         // Ack mode.
         Pointer<core::ActiveMQAckHandler> ackHandler;
 
         // Message properties, these are Marshaled and Unmarshaled from the Message
         // Command's marshaledProperties vector.
-        activemq::util::PrimitiveMap properties;
+        mutable activemq::util::PrimitiveMap properties;
+
+        // Indicates that the marshaledProperties of a received Message have not yet
+        // been unmarshaled into the properties map, that waits until they are used.
+        mutable bool propertiesUnmarshalPending;
+
+        // Indicates that the properties of a received Message haven't been changed so
+        // its marshaledProperties can be sent on again as they are.
+        bool propertiesUnchanged;
 
         // Indicates if the Message Properties are Read Only
         bool readOnlyProperties;
@@ -157,6 +162,16 @@ namespace commands{
          */
         virtual void beforeMarshal(wireformat::WireFormat* wireFormat AMQCPP_UNUSED);
 
+        /**
+         * Marshals the body and properties of a Message that is about to be sent now, so
+         * that the copies made of it to send it to several destinations share the bytes
+         * instead of each marshaling them again.  The properties count as unchanged until
+         * they are next modified.  The body must already be stored, see onSend.
+         *
+         * @throws IOException if the body or properties can't be marshaled.
+         */
+        void storeMarshaledForm();
+
         /**
          * Called after unmarshaling is started to cleanup the object being
          * unmarshaled.
@@ -222,6 +237,17 @@ namespace commands{
          */
         virtual bool isExpired() const;
 
+        /**
+         * Returns if this message had expired at the given time, so that a batch of
+         * messages can be checked against a single reading of the clock.
+         *
+         * @param currentTime
+         *      The time to check against, in milliseconds since the epoch.
+         *
+         * @return true if the message's Expiration time is before the given time.
+         */
+        bool isExpired(long long currentTime) const;
+
         /**
          * Allows derived Message classes to perform tasks before a message is sent.
          */
@@ -229,17 +255,36 @@ namespace commands{
 
         /**
          * Gets a reference to the Message's Properties object, allows the derived
-         * classes to get and set their own specific properties.
+         * classes to get and set their own specific properties.  Since the properties
+         * may be changed through the returned reference they are marshaled again when
+         * the Message is next sent, read only callers should use the const version.
          *
          * @return a reference to the Primitive Map that holds message properties.
          */
         util::PrimitiveMap& getMessageProperties() {
+            if (this->propertiesUnmarshalPending) {
+                unmarshalProperties();
+            }
+            this->propertiesUnchanged = false;
             return this->properties;
         }
         const util::PrimitiveMap& getMessageProperties() const {
+            if (this->propertiesUnmarshalPending) {
+                unmarshalProperties();
+            }
             return this->properties;
         }
 
+        /**
+         * Unmarshals the marshaled properties of a received Message into the properties
+         * map if that has not been done yet, does nothing otherwise.  Received Messages
+         * put this off until the properties are first accessed so that a Message whose
+         * properties are never read doesn't pay for decoding them.
+         *
+         * @throws IOException if the marshaled properties can't be read.
+         */
+        void unmarshalProperties() const;
+
         /**
          * Returns if the Message Properties Are Read Only
          * @return true if Message Properties are Read Only.
@@ -331,6 +376,14 @@ namespace commands{
         virtual std::vector<unsigned char>& getContent();
         virtual void setContent(const std::vector<unsigned char>& content);
 
+        /**
+         * @return the content without copying bytes that were attached to the message,
+         *         which getContent has to copy into a vector.
+         */
+        const activemq::util::CopyOnWriteBytes& getContentBytes() const {
+            return this->content;
+        }
+
         virtual const std::vector<unsigned char>& getMarshalledProperties() const;
         virtual std::vector<unsigned char>& getMarshalledProperties();
         virtual void setMarshalledProperties(const std::vector<unsigned char>& marshalledProperties);
@@ -388,6 +441,14 @@ namespace commands{
 
         virtual Pointer<Command> visit(activemq::state::CommandVisitor* visitor);
 
+    private:
+
+        // The rare fields, or a shared block of defaults if none has been set.
+        const MessageRareFields& getRareFields() const;
+
+        // The rare fields, allocating them on first use.
+        MessageRareFields& editRareFields();
+
     };
 
 }}
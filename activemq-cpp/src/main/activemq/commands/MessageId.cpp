@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <activemq/commands/IdSupport.h>
 #include <activemq/commands/MessageId.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
@@ -141,8 +142,11 @@ std::string MessageId::toString() const {
                 key = "ID:" + textView;
             }
         } else {
-            this->key = this->producerId->toString() + ":" + 
-                        Long::toString(this->producerSequenceId);
+            this->key.reserve(this->producerId->getConnectionId().length() + 64);
+            IdSupport::appendId(this->key, this->producerId->getConnectionId(),
+                                this->producerId->getSessionId(), this->producerId->getValue());
+            this->key.append(1, ':');
+            IdSupport::appendNumber(this->key, this->producerSequenceId);
         }
     }
 
@@ -197,6 +201,7 @@ std::string& MessageId::getTextView() {
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setTextView(const std::string& textView) {
     this->textView = textView;
+    this->key = "";
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -212,6 +217,7 @@ decaf::lang::Pointer<ProducerId>& MessageId::getProducerId() {
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setProducerId(const decaf::lang::Pointer<ProducerId>& producerId) {
     this->producerId = producerId;
+    this->key = "";
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,6 +228,7 @@ long long MessageId::getProducerSequenceId() const {
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setProducerSequenceId(long long producerSequenceId) {
     this->producerSequenceId = producerSequenceId;
+    this->key = "";
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -289,23 +296,27 @@ MessageId& MessageId::operator= (const MessageId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int MessageId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Hashes the fields that equals compares so no string has to be formatted.
+    int result = 0;
+    if (!this->textView.empty()) {
+        result = decaf::util::HashCode<std::string>()(this->textView);
+    }
+    if (this->producerId != NULL) {
+        result = 31 * result + this->producerId->getHashCode();
+    }
+    result = 31 * result + (int) (this->producerSequenceId ^ (long long) ((unsigned long long) this->producerSequenceId >> 32));
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void MessageId::setValue(const std::string& key) {
 
-    std::string messageKey = key;
-
     // Parse off the sequenceId
-    std::size_t p = messageKey.rfind( ':' );
-
-    if (p != std::string::npos) {
-        producerSequenceId = Long::parseLong(messageKey.substr(p + 1, std::string::npos));
-        messageKey = messageKey.substr(0, p);
-    }
+    std::size_t p = IdSupport::parseLastNumber(key, key.length(), this->producerSequenceId);
 
-    this->producerId.reset(new ProducerId(messageKey));
-    this->key = messageKey;
+    // The rest names the producer, the one parsed last on this thread is shared.
+    this->producerId = IdSupport::parseProducerId(key, p != std::string::npos ? p : key.length());
+    this->key = "";
 }
 
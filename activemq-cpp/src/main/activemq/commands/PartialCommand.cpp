@@ -39,7 +39,7 @@ using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 PartialCommand::PartialCommand() :
-    BaseDataStructure(), commandId(0), data() {
+    BaseCommand(), commandId(0), data() {
 
 }
 
@@ -74,7 +74,7 @@ void PartialCommand::copyDataStructure(const DataStructure* src) {
     }
 
     // Copy the data of the base class or classes
-    BaseDataStructure::copyDataStructure(src);
+    BaseCommand::copyDataStructure(src);
 
     this->setCommandId(srcPtr->getCommandId());
     this->setData(srcPtr->getData());
@@ -129,7 +129,7 @@ bool PartialCommand::equals(const DataStructure* value) const {
             return false;
         }
     }
-    if (!BaseDataStructure::equals(value)) {
+    if (!BaseCommand::equals(value)) {
         return false;
     }
     return true;
@@ -160,3 +160,8 @@ void PartialCommand::setData(const std::vector<unsigned char>& data) {
     this->data = data;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+decaf::lang::Pointer<commands::Command> PartialCommand::visit(activemq::state::CommandVisitor* visitor AMQCPP_UNUSED) {
+    throw ActiveMQException(__FILE__, __LINE__,
+        "PartialCommand::visit - partial commands should have been joined by the transport");
+}
@@ -23,7 +23,7 @@
 #pragma warning( disable : 4290 )
 #endif
 
-#include <activemq/commands/BaseDataStructure.h>
+#include <activemq/commands/BaseCommand.h>
 #include <activemq/util/Config.h>
 #include <decaf/lang/Pointer.h>
 #include <string>
@@ -43,7 +43,7 @@ namespace commands {
      *         in the activemq-cpp-openwire-generator module
      *
      */
-    class AMQCPP_API PartialCommand : public BaseDataStructure {
+    class AMQCPP_API PartialCommand : public BaseCommand {
     protected:
 
         int commandId;
@@ -81,6 +81,14 @@ namespace commands {
         virtual std::vector<unsigned char>& getData();
         virtual void setData(const std::vector<unsigned char>& data);
 
+        /**
+         * Partial commands are joined back into the command they carry by the transport,
+         * none should reach a visitor.
+         *
+         * @throws ActiveMQException always.
+         */
+        virtual Pointer<Command> visit(activemq::state::CommandVisitor* visitor);
+
     };
 
 }}
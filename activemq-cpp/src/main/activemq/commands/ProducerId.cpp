@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <activemq/commands/IdSupport.h>
 #include <activemq/commands/ProducerId.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/state/CommandVisitor.h>
@@ -69,11 +70,10 @@ ProducerId::ProducerId(std::string producerKey) :
     BaseDataStructure(), connectionId(""), value(0), sessionId(0), parentId() {
 
     // Parse off the producerId
-    std::size_t p = producerKey.rfind( ':' );
+    std::size_t p = IdSupport::parseLastNumber(producerKey, producerKey.length(), this->value);
 
     if (p != std::string::npos) {
-        value = Long::parseLong(producerKey.substr(p + 1, std::string::npos));
-        producerKey = producerKey.substr(0, p);
+        producerKey.erase(p);
     }
 
     setProducerSessionKey(producerKey);
@@ -125,13 +125,11 @@ unsigned char ProducerId::getDataStructureType() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string ProducerId::toString() const {
 
-    ostringstream stream;
+    std::string result;
+    result.reserve(this->connectionId.length() + 42);
+    IdSupport::appendId(result, this->connectionId, this->sessionId, this->value);
 
-    stream << this->connectionId << ":"
-           << this->sessionId << ":"
-           << this->value;
-
-    return stream.str();
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +245,12 @@ ProducerId& ProducerId::operator= (const ProducerId& other) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ProducerId::getHashCode() const {
-    return decaf::util::HashCode<std::string>()(this->toString());
+
+    // Hashes the fields that equals compares so no string has to be formatted.
+    int result = decaf::util::HashCode<std::string>()(this->connectionId);
+    result = 31 * result + (int) (this->sessionId ^ (long long) ((unsigned long long) this->sessionId >> 32));
+    result = 31 * result + (int) (this->value ^ (long long) ((unsigned long long) this->value >> 32));
+    return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -262,13 +265,8 @@ const Pointer<SessionId>& ProducerId::getParentId() const {
 void ProducerId::setProducerSessionKey( std::string sessionKey ) {
 
     // Parse off the value
-    std::size_t p = sessionKey.rfind( ':' );
-
-    if (p != std::string::npos) {
-        this->sessionId = Long::parseLong(sessionKey.substr(p + 1, std::string::npos));
-        sessionKey = sessionKey.substr(0, p);
-    }
+    std::size_t p = IdSupport::parseLastNumber(sessionKey, sessionKey.length(), this->sessionId);
 
     // The rest is the value
-    this->connectionId = sessionKey;
+    this->connectionId.assign(sessionKey, 0, p != std::string::npos ? p : sessionKey.length());
 }
@@ -208,6 +208,14 @@ namespace commands{
             return marshalledProperties;
         }
 
+        /**
+         * Get the marshalledProperties field
+         * @return reference to a std::vector<char>
+         */
+        std::vector<unsigned char>& getMarshalledProperties() {
+            return marshalledProperties;
+        }
+
         /**
          * Sets the value of the marshalledProperties field
          * @param marshalledProperties
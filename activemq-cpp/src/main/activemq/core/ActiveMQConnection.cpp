@@ -26,16 +26,26 @@
 #include <activemq/core/ActiveMQDestinationSource.h>
 #include <activemq/core/AdvisoryConsumer.h>
 #include <activemq/core/ConnectionAudit.h>
+#include <activemq/core/ConsumerPressureMonitor.h>
+#include <activemq/core/SubscriptionMultiplexer.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
+#include <activemq/core/kernels/ActiveMQConsumerKernel.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 #include <activemq/core/policies/DefaultPrefetchPolicy.h>
 #include <activemq/core/policies/DefaultRedeliveryPolicy.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/exceptions/BrokerException.h>
 #include <activemq/exceptions/ConnectionFailedException.h>
+#include <activemq/util/BlockCompressionCodec.h>
 #include <activemq/util/CMSExceptionSupport.h>
 #include <activemq/util/IdGenerator.h>
+#include <activemq/util/MemoryUsage.h>
+#include <activemq/threads/DedicatedTaskRunner.h>
+#include <activemq/threads/KeyedSerialExecutor.h>
+#include <activemq/threads/TaskRunnerPool.h>
+#include <activemq/threads/ThreadPlacement.h>
 #include <activemq/transport/failover/FailoverTransport.h>
+#include <activemq/transport/IOTransport.h>
 #include <activemq/transport/ResponseCallback.h>
 #include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
@@ -43,11 +53,14 @@
 #include <decaf/lang/Math.h>
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
 #include <decaf/util/Iterator.h>
 #include <decaf/util/Set.h>
 #include <decaf/util/Collection.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/UUID.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/ConcurrentStlMap.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
@@ -55,9 +68,13 @@
 #include <decaf/util/concurrent/LinkedBlockingQueue.h>
 #include <decaf/util/concurrent/locks/ReentrantReadWriteLock.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/concurrent/atomic/AtomicReference.h>
+#include <decaf/lang/ThreadLocal.h>
 
 #include <activemq/commands/Command.h>
 #include <activemq/commands/ActiveMQMessage.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTempTopic.h>
 #include <activemq/commands/BrokerInfo.h>
 #include <activemq/commands/BrokerError.h>
 #include <activemq/commands/ConnectionId.h>
@@ -74,6 +91,8 @@
 #include <activemq/commands/SessionInfo.h>
 #include <activemq/commands/WireFormatInfo.h>
 
+#include <deque>
+
 using namespace std;
 using namespace cms;
 using namespace activemq;
@@ -102,10 +121,17 @@ namespace core {
     private:
 
         std::string connectionId;
+        const std::vector<int>* affinity;
+
+    private:
+
+        ConnectionThreadFactory(const ConnectionThreadFactory&);
+        ConnectionThreadFactory& operator= (const ConnectionThreadFactory&);
 
     public:
 
-        ConnectionThreadFactory(std::string connectionId) : connectionId(connectionId) {
+        ConnectionThreadFactory(std::string connectionId, const std::vector<int>* affinity) :
+            connectionId(connectionId), affinity(affinity) {
             if (connectionId.empty()) {
                 throw NullPointerException(__FILE__, __LINE__, "Connection Id must be set.");
             }
@@ -118,11 +144,139 @@ namespace core {
 
             std::string name = prefix + connectionId;
             Thread* thread = new Thread(runnable, name);
+            if (!affinity->empty()) {
+                thread->setAffinity(*affinity);
+            }
             return thread;
         }
 
     };
 
+    /**
+     * An immutable open addressed table from the session id and value of a consumer or
+     * producer to the object handling it.  All the consumers and producers of a
+     * connection share its connection id, so the two numbers alone identify one and a
+     * lookup is a single hash probe.
+     */
+    template <typename V>
+    class IdIndex {
+    private:
+
+        struct Entry {
+            long long sessionId;
+            long long value;
+            V item;
+            bool used;
+
+            Entry() : sessionId(0), value(0), item(), used(false) {}
+        };
+
+        std::vector<Entry> entries;
+        std::size_t mask;
+        std::size_t count;
+
+    private:
+
+        IdIndex(const IdIndex&);
+        IdIndex& operator= (const IdIndex&);
+
+        static std::size_t hash(long long sessionId, long long value) {
+            unsigned int hash = (unsigned int) (sessionId * 31 + value);
+            hash ^= hash >> 16;
+            hash *= 0x45d9f3bU;
+            hash ^= hash >> 16;
+            return (std::size_t) hash;
+        }
+
+        void insert(long long sessionId, long long value, const V& item) {
+            std::size_t slot = hash(sessionId, value) & this->mask;
+            while (this->entries[slot].used) {
+                slot = (slot + 1) & this->mask;
+            }
+
+            this->entries[slot].sessionId = sessionId;
+            this->entries[slot].value = value;
+            this->entries[slot].item = item;
+            this->entries[slot].used = true;
+            this->count++;
+        }
+
+    public:
+
+        // Sized for the given number of entries at no more than half full.
+        IdIndex(std::size_t expected) : entries(), mask(0), count(0) {
+            std::size_t size = 8;
+            while (size < expected * 2) {
+                size <<= 1;
+            }
+
+            this->entries.resize(size);
+            this->mask = size - 1;
+        }
+
+        template <typename ID>
+        bool tryGet(const ID& id, V& item) const {
+            long long sessionId = id.getSessionId();
+            long long value = id.getValue();
+
+            std::size_t slot = hash(sessionId, value) & this->mask;
+            while (this->entries[slot].used) {
+                const Entry& entry = this->entries[slot];
+                if (entry.value == value && entry.sessionId == sessionId) {
+                    item = entry.item;
+                    return true;
+                }
+                slot = (slot + 1) & this->mask;
+            }
+
+            return false;
+        }
+
+        /**
+         * Returns a new index holding this one's entries with the given id's replaced by
+         * the item, or removed when there is no item.
+         */
+        template <typename ID>
+        IdIndex* update(const ID& id, const V* item) const {
+            long long sessionId = id.getSessionId();
+            long long value = id.getValue();
+
+            std::auto_ptr<IdIndex> updated(new IdIndex(this->count + 1));
+
+            typename std::vector<Entry>::const_iterator entry = this->entries.begin();
+            for (; entry != this->entries.end(); ++entry) {
+                if (entry->used && (entry->value != value || entry->sessionId != sessionId)) {
+                    updated->insert(entry->sessionId, entry->value, entry->item);
+                }
+            }
+
+            if (item != NULL) {
+                updated->insert(sessionId, value, *item);
+            }
+
+            return updated.release();
+        }
+    };
+
+    /**
+     * A dispatcher in the index and the number of dispatches to it in progress.  The
+     * count is taken while the index is read and the dispatch itself runs after the
+     * read ends, so a listener can add and remove consumers while it runs.
+     */
+    class DispatcherRef {
+    private:
+
+        DispatcherRef(const DispatcherRef&);
+        DispatcherRef& operator= (const DispatcherRef&);
+
+    public:
+
+        Dispatcher* dispatcher;
+        AtomicInteger dispatching;
+
+        DispatcherRef(Dispatcher* dispatcher) : dispatcher(dispatcher), dispatching() {}
+    };
+
     class ConnectionConfig {
     private:
 
@@ -131,13 +285,8 @@ namespace core {
 
     public:
 
-        typedef decaf::util::StlMap< Pointer<commands::ConsumerId>,
-                                     Dispatcher*,
-                                     commands::ConsumerId::COMPARATOR > DispatcherMap;
-
-        typedef decaf::util::StlMap< Pointer<commands::ProducerId>,
-                                     Pointer<ActiveMQProducerKernel>,
-                                     commands::ProducerId::COMPARATOR > ProducerMap;
+        typedef IdIndex< Pointer<DispatcherRef> > DispatcherIndex;
+        typedef IdIndex< Pointer<ActiveMQProducerKernel> > ProducerIndex;
 
         typedef decaf::util::concurrent::ConcurrentStlMap< Pointer<commands::ActiveMQTempDestination>,
                                                            Pointer<commands::ActiveMQTempDestination>,
@@ -153,6 +302,8 @@ namespace core {
         Pointer<util::IdGenerator> clientIdGenerator;
         Pointer<Scheduler> scheduler;
         Pointer<ExecutorService> executor;
+        Pointer<TaskRunnerPool> sessionDispatchPool;
+        Pointer<KeyedSerialExecutor> asyncCallbackExecutor;
 
         util::LongSequenceGenerator sessionIds;
         util::LongSequenceGenerator consumerIdGenerator;
@@ -166,6 +317,11 @@ namespace core {
         bool userSpecifiedClientID;
 
         decaf::util::concurrent::Mutex ensureConnectionInfoSentMutex;
+
+        // The transport a commit write holds unflushed and when the write was opened.
+        decaf::util::concurrent::Mutex commitWriteLock;
+        IOTransport* commitWriteTransport;
+        long long commitWriteStarted;
         decaf::util::concurrent::Mutex onExceptionLock;
         decaf::util::concurrent::Mutex mutex;
 
@@ -174,6 +330,18 @@ namespace core {
         bool useAsyncSend;
         bool sendAcksAsync;
         bool messagePrioritySupported;
+        bool memoryAccountingEnabled;
+        bool pipelinedStartup;
+        bool useRingDispatchChannel;
+        bool aggregateSessionAcks;
+        bool useBorrowedMessages;
+        bool multiplexTopicSubscriptions;
+        int sessionDispatchPoolSize;
+        int asyncCallbackPoolSize;
+        int groupDispatchLanes;
+        int parallelListenerThreads;
+        threads::ThreadPlacement::Policy threadPlacement;
+        std::vector<int> threadAffinity;
         bool watchTopicAdvisories;
         bool useCompression;
         bool useRetroactiveConsumer;
@@ -183,14 +351,21 @@ namespace core {
         bool transactedIndividualAck;
         bool nonBlockingRedelivery;
         bool alwaysSessionAsync;
+        bool directDispatch;
+        int tempDestinationBatchSize;
+        bool deleteTempDestinationsAsync;
         int compressionLevel;
         unsigned int sendTimeout;
         unsigned int closeTimeout;
         unsigned int producerWindowSize;
+        int maxPendingSends;
         int auditDepth;
         int auditMaximumProducerNumber;
         long long optimizeAcknowledgeTimeOut;
         long long optimizedAckScheduledAckInterval;
+        int ackCoalesceCount;
+        long long ackCoalesceDelay;
+        long long commitBatchWindow;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
 
@@ -199,6 +374,7 @@ namespace core {
 
         cms::ExceptionListener* exceptionListener;
         cms::MessageTransformer* transformer;
+        util::MessageTracer* tracer;
 
         Pointer<commands::ConnectionInfo> connectionInfo;
         Pointer<commands::BrokerInfo> brokerInfo;
@@ -207,11 +383,23 @@ namespace core {
         Pointer<AtomicInteger> protocolVersion;
         Pointer<CountDownLatch> brokerInfoReceived;
         Pointer<AdvisoryConsumer> advisoryConsumer;
+        Pointer<SubscriptionMultiplexer> subscriptionMultiplexer;
 
         Pointer<Exception> firstFailureError;
 
-        DispatcherMap dispatchers;
-        ProducerMap activeProducers;
+        // Dispatch and producer acks search these indexes without a lock, an index is
+        // replaced instead of modified when a dispatcher or producer is added or removed.
+        // Each read is counted in the epoch it started in and a replaced index is deleted
+        // once both epochs have drained of the reads that may still be using it.  A read
+        // covers only the lookup so it never waits on anything while counted.
+        AtomicReference<DispatcherIndex> dispatcherIndex;
+        AtomicReference<ProducerIndex> producerIndex;
+        AtomicInteger indexEpoch;
+        AtomicInteger activeIndexReads[2];
+        decaf::util::concurrent::Mutex indexLock;
+
+        // The dispatcher the current thread is dispatching to, if any.
+        ThreadLocal<DispatcherRef*> currentDispatch;
 
         decaf::util::concurrent::locks::ReentrantReadWriteLock sessionsLock;
         decaf::util::LinkedList< Pointer<ActiveMQSessionKernel> > activeSessions;
@@ -219,8 +407,43 @@ namespace core {
 
         TempDestinationMap activeTempDestinations;
 
+        // Temporary destinations registered with the broker ahead of being asked for.
+        Mutex tempDestinationLock;
+        std::deque< Pointer<ActiveMQTempDestination> > spareTempQueues;
+        std::deque< Pointer<ActiveMQTempDestination> > spareTempTopics;
+
         ConnectionAudit connectionAudit;
 
+        ConnectionMetrics metrics;
+
+        util::CompressionPool compressionPool;
+
+        // Codecs other than zlib are created when first needed, codecs replaced by a new
+        // dictionary or block size are kept until the connection is destroyed as messages
+        // may still be using them.
+        std::string compressionCodec;
+        std::vector<unsigned char> compressionDictionary;
+        int compressionBlockSize;
+        bool incrementalDecompression;
+        std::map<std::string, util::CompressionCodec*> compressionCodecs;
+        std::vector<util::CompressionCodec*> retiredCompressionCodecs;
+        decaf::util::concurrent::Mutex compressionCodecsLock;
+
+        // Startup commands written without waiting, their count and the ones the
+        // broker refused along with its error, in the order the responses came.
+        decaf::util::concurrent::Mutex startupLock;
+        int pendingStartupRequests;
+        std::vector< std::pair< Pointer<Command>, Pointer<BrokerError> > > startupFailures;
+
+        // The bytes the consumers report holding against the budget they share, the
+        // monitor the application supplied, whether the consumers are suspended and
+        // whether a pass that suspends or resumes them is queued on the executor.
+        util::MemoryUsage consumerMemoryUsage;
+        ConsumerPressureMonitor* consumerPressureMonitor;
+        volatile bool consumersSuspended;
+        AtomicBoolean consumerPressurePending;
+        decaf::util::concurrent::Mutex consumerPressureLock;
+
         ConnectionConfig(const Pointer<transport::Transport> transport,
                          const Pointer<decaf::util::Properties> properties) :
                              properties(properties),
@@ -228,6 +451,8 @@ namespace core {
                              clientIdGenerator(),
                              scheduler(),
                              executor(),
+                             sessionDispatchPool(),
+                             asyncCallbackExecutor(),
                              sessionIds(),
                              consumerIdGenerator(),
                              tempDestinationIds(),
@@ -237,6 +462,9 @@ namespace core {
                              isConnectionInfoSentToBroker(false),
                              userSpecifiedClientID(false),
                              ensureConnectionInfoSentMutex(),
+                             commitWriteLock(),
+                             commitWriteTransport(NULL),
+                             commitWriteStarted(0),
                              onExceptionLock(),
                              mutex(),
                              dispatchAsync(true),
@@ -244,6 +472,18 @@ namespace core {
                              useAsyncSend(false),
                              sendAcksAsync(true),
                              messagePrioritySupported(false),
+                             memoryAccountingEnabled(false),
+                             pipelinedStartup(false),
+                             useRingDispatchChannel(false),
+                             aggregateSessionAcks(true),
+                             useBorrowedMessages(false),
+                             multiplexTopicSubscriptions(false),
+                             sessionDispatchPoolSize(0),
+                             asyncCallbackPoolSize(0),
+                             groupDispatchLanes(0),
+                             parallelListenerThreads(0),
+                             threadPlacement(threads::ThreadPlacement::NONE),
+                             threadAffinity(),
                              watchTopicAdvisories(true),
                              useCompression(false),
                              useRetroactiveConsumer(false),
@@ -253,33 +493,68 @@ namespace core {
                              transactedIndividualAck(false),
                              nonBlockingRedelivery(false),
                              alwaysSessionAsync(true),
+                             directDispatch(false),
+                             tempDestinationBatchSize(1),
+                             deleteTempDestinationsAsync(false),
                              compressionLevel(-1),
                              sendTimeout(0),
                              closeTimeout(15000),
                              producerWindowSize(0),
+                             maxPendingSends(0),
                              auditDepth(ActiveMQMessageAudit::DEFAULT_WINDOW_SIZE),
                              auditMaximumProducerNumber(ActiveMQMessageAudit::MAXIMUM_PRODUCER_COUNT),
                              optimizeAcknowledgeTimeOut(300),
                              optimizedAckScheduledAckInterval(0),
+                             ackCoalesceCount(0),
+                             ackCoalesceDelay(1000),
+                             commitBatchWindow(0),
                              consumerFailoverRedeliveryWaitPeriod(0),
                              consumerExpiryCheckEnabled(true),
                              defaultPrefetchPolicy(NULL),
                              defaultRedeliveryPolicy(NULL),
                              exceptionListener(NULL),
                              transformer(NULL),
+                             tracer(NULL),
                              connectionInfo(),
                              brokerInfo(),
                              brokerWireFormatInfo(),
                              transportInterruptionProcessingComplete(),
                              brokerInfoReceived(),
                              advisoryConsumer(),
+                             subscriptionMultiplexer(),
                              firstFailureError(),
-                             dispatchers(),
-                             activeProducers(),
+                             dispatcherIndex(new DispatcherIndex(0)),
+                             producerIndex(new ProducerIndex(0)),
+                             indexEpoch(),
+                             activeIndexReads(),
+                             indexLock(),
+                             currentDispatch(),
                              sessionsLock(),
                              activeSessions(),
                              transportListeners(),
-                             activeTempDestinations() {
+                             activeTempDestinations(),
+                             tempDestinationLock(),
+                             spareTempQueues(),
+                             spareTempTopics(),
+                             metrics(),
+                             compressionPool(),
+                             compressionCodec(util::CompressionCodec::ZLIB),
+                             compressionDictionary(),
+                             compressionBlockSize(0),
+                             incrementalDecompression(false),
+                             compressionCodecs(),
+                             retiredCompressionCodecs(),
+                             compressionCodecsLock(),
+                             startupLock(),
+                             pendingStartupRequests(0),
+                             startupFailures(),
+                             consumerMemoryUsage(),
+                             consumerPressureMonitor(NULL),
+                             consumersSuspended(false),
+                             consumerPressurePending(),
+                             consumerPressureLock() {
+
+            this->indexLock.setProfilingSite("activemq.core.ActiveMQConnection.dispatchers");
 
             this->defaultPrefetchPolicy.reset(new DefaultPrefetchPolicy());
             this->defaultRedeliveryPolicy.reset(new DefaultRedeliveryPolicy());
@@ -297,7 +572,7 @@ namespace core {
             this->executor.reset(
                 new ThreadPoolExecutor(1, 1, 5, TimeUnit::SECONDS,
                     new LinkedBlockingQueue<Runnable*>(),
-                    new ConnectionThreadFactory(connectionId->toString())));
+                    new ConnectionThreadFactory(connectionId->toString(), &this->threadAffinity)));
 
             this->connectionInfo->setConnectionId(connectionId);
             this->scheduler.reset(new Scheduler(std::string("ActiveMQConnection[")+uniqueId+"] Scheduler"));
@@ -310,11 +585,120 @@ namespace core {
                     this->scheduler->shutdown();
                     this->executor->shutdown();
                     this->executor->awaitTermination(10, TimeUnit::MINUTES);
+                    if (this->sessionDispatchPool != NULL) {
+                        this->sessionDispatchPool->shutdown();
+                    }
+                    if (this->asyncCallbackExecutor != NULL) {
+                        this->asyncCallbackExecutor->shutdown();
+                    }
+                }
+
+                std::map<std::string, util::CompressionCodec*>::iterator codec = this->compressionCodecs.begin();
+                for (; codec != this->compressionCodecs.end(); ++codec) {
+                    delete codec->second;
+                }
+
+                std::vector<util::CompressionCodec*>::iterator retired = this->retiredCompressionCodecs.begin();
+                for (; retired != this->retiredCompressionCodecs.end(); ++retired) {
+                    delete *retired;
                 }
+
+                delete this->dispatcherIndex.get();
+                delete this->producerIndex.get();
             }
             AMQ_CATCHALL_NOTHROW()
         }
 
+        /**
+         * Marks the start of a read of the indexes, the indexes read after this stay
+         * valid until the matching call to endIndexRead.
+         *
+         * @return the epoch to pass to endIndexRead.
+         */
+        int beginIndexRead() {
+            int epoch = this->indexEpoch.get() & 1;
+            this->activeIndexReads[epoch].incrementAndGet();
+            return epoch;
+        }
+
+        void endIndexRead(int epoch) {
+            this->activeIndexReads[epoch].decrementAndGet();
+        }
+
+        /**
+         * Replaces the dispatcher of the given consumer, a NULL dispatcher removes it.
+         * Returns once no dispatch to the replaced dispatcher is in progress, other than
+         * one the calling thread is making so a consumer may be closed from its listener.
+         */
+        void updateDispatcher(const commands::ConsumerId& id, Dispatcher* dispatcher) {
+
+            Pointer<DispatcherRef> replaced;
+
+            synchronized(&this->indexLock) {
+                Pointer<DispatcherRef> ref;
+                if (dispatcher != NULL) {
+                    ref.reset(new DispatcherRef(dispatcher));
+                }
+
+                DispatcherIndex* previous = this->dispatcherIndex.get();
+                previous->tryGet(id, replaced);
+                this->dispatcherIndex.set(previous->update(id, dispatcher != NULL ? &ref : NULL));
+                awaitIndexReads();
+                delete previous;
+            }
+
+            // Without the lock held, the listener being waited for may itself add or
+            // remove a consumer.  A dispatch counted itself before its lookup ended so
+            // none can start on the replaced dispatcher once the old index is gone.
+            if (replaced != NULL) {
+                int own = this->currentDispatch.get() == replaced.get() ? 1 : 0;
+                for (int spins = 0; replaced->dispatching.get() > own; ++spins) {
+                    if (spins < 64) {
+                        Thread::yield();
+                    } else {
+                        Thread::sleep(1);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Replaces the producer with the given id, a NULL producer removes it.  An ack
+         * being applied to the replaced producer holds its own reference to it and isn't
+         * waited for.
+         */
+        void updateProducer(const commands::ProducerId& id, const Pointer<ActiveMQProducerKernel>* producer) {
+            synchronized(&this->indexLock) {
+                ProducerIndex* previous = this->producerIndex.get();
+                this->producerIndex.set(previous->update(id, producer));
+                awaitIndexReads();
+                delete previous;
+            }
+        }
+
+    private:
+
+        /**
+         * Returns once no thread can be reading an index replaced before the call.  Reads
+         * are lookups that never block so the wait is short.  Called with the index lock
+         * held, which keeps the epoch flips of two updates from interleaving.
+         */
+        void awaitIndexReads() {
+
+            // A read that loaded the epoch just before a flip can count itself in the
+            // old one after it was checked, flipping twice also waits for it.
+            for (int phase = 0; phase < 2; ++phase) {
+                int epoch = this->indexEpoch.get() & 1;
+                this->indexEpoch.set(epoch ^ 1);
+
+                while (this->activeIndexReads[epoch].get() > 0) {
+                    Thread::yield();
+                }
+            }
+        }
+
+    public:
+
         void waitForBrokerInfo() {
             this->brokerInfoReceived->await();
         }
@@ -324,6 +708,56 @@ namespace core {
     util::IdGenerator ConnectionConfig::CONNECTION_ID_GENERATOR;
     DefaultTransportListener ConnectionConfig::DO_NOTHING_TRANSPORT_LISTENER;
 
+    class IndexReadScope {
+    private:
+
+        ConnectionConfig* config;
+        int epoch;
+
+    private:
+
+        IndexReadScope(const IndexReadScope&);
+        IndexReadScope& operator= (const IndexReadScope&);
+
+    public:
+
+        IndexReadScope(ConnectionConfig* config) : config(config), epoch(config->beginIndexRead()) {}
+
+        ~IndexReadScope() {
+            this->config->endIndexRead(this->epoch);
+        }
+    };
+
+    /**
+     * Marks the current thread as dispatching to a dispatcher whose count was taken
+     * during the lookup, and releases the count when done.
+     */
+    class DispatchScope {
+    private:
+
+        ConnectionConfig* config;
+        DispatcherRef* ref;
+        DispatcherRef* outer;
+
+    private:
+
+        DispatchScope(const DispatchScope&);
+        DispatchScope& operator= (const DispatchScope&);
+
+    public:
+
+        DispatchScope(ConnectionConfig* config, DispatcherRef* ref) :
+            config(config), ref(ref), outer(config->currentDispatch.get()) {
+
+            this->config->currentDispatch.get() = ref;
+        }
+
+        ~DispatchScope() {
+            this->config->currentDispatch.get() = this->outer;
+            this->ref->dispatching.decrementAndGet();
+        }
+    };
+
     class ConnectionErrorRunnable : public Runnable {
     private:
 
@@ -350,6 +784,47 @@ namespace core {
         }
     };
 
+    class ConsumerPressureRunnable : public Runnable {
+    private:
+
+        ActiveMQConnection* connection;
+        ConnectionConfig* config;
+
+    private:
+
+        ConsumerPressureRunnable(const ConsumerPressureRunnable&);
+        ConsumerPressureRunnable& operator= (const ConsumerPressureRunnable&);
+
+    public:
+
+        ConsumerPressureRunnable(ActiveMQConnection* connection, ConnectionConfig* config) :
+            Runnable(), connection(connection), config(config) {}
+        virtual ~ConsumerPressureRunnable() {}
+
+        virtual void run() {
+            try {
+
+                // A change made after this point queues another pass.
+                this->config->consumerPressurePending.set(false);
+                bool suspend = this->config->consumersSuspended;
+
+                ArrayList< Pointer<ActiveMQSessionKernel> > sessions = this->connection->getSessions();
+                Pointer< Iterator< Pointer<ActiveMQSessionKernel> > > session(sessions.iterator());
+                while (session->hasNext()) {
+                    ArrayList< Pointer<ActiveMQConsumerKernel> > consumers = session->next()->getConsumers();
+                    Pointer< Iterator< Pointer<ActiveMQConsumerKernel> > > consumer(consumers.iterator());
+                    while (consumer->hasNext()) {
+                        if (suspend) {
+                            consumer->next()->suspend();
+                        } else {
+                            consumer->next()->resume();
+                        }
+                    }
+                }
+            } catch(Exception& ex) {}
+        }
+    };
+
     class OnAsyncExceptionRunnable : public Runnable {
     private:
 
@@ -438,24 +913,24 @@ namespace core {
         }
     };
 
-    class AsyncResponseCallback : public ResponseCallback {
+    class StartupResponseCallback : public ResponseCallback {
     private:
 
         ConnectionConfig* config;
-        cms::AsyncCallback* callback;
+        Pointer<Command> command;
 
     private:
 
-        AsyncResponseCallback(const AsyncResponseCallback&);
-        AsyncResponseCallback& operator= (const AsyncResponseCallback&);
+        StartupResponseCallback(const StartupResponseCallback&);
+        StartupResponseCallback& operator= (const StartupResponseCallback&);
 
     public:
 
-        AsyncResponseCallback(ConnectionConfig* config, cms::AsyncCallback* callback) :
-            ResponseCallback(), config(config), callback(callback) {
+        StartupResponseCallback(ConnectionConfig* config, Pointer<Command> command) :
+            ResponseCallback(), config(config), command(command) {
         }
 
-        virtual ~AsyncResponseCallback() {
+        virtual ~StartupResponseCallback() {
         }
 
         virtual void onComplete(Pointer<commands::Response> response) {
@@ -463,18 +938,163 @@ namespace core {
             commands::ExceptionResponse* exceptionResponse =
                 dynamic_cast<ExceptionResponse*> (response.get());
 
-            if (exceptionResponse != NULL) {
+            synchronized(&this->config->startupLock) {
+                if (exceptionResponse != NULL) {
+                    this->config->startupFailures.push_back(
+                        std::make_pair(this->command, exceptionResponse->getException()));
+                }
+
+                this->config->pendingStartupRequests--;
+                this->config->startupLock.notifyAll();
+            }
+        }
+    };
+
+    /**
+     * Collects the responses to a group of requests that were written without waiting
+     * on each other, the errors are kept by the position of their request.
+     */
+    class RequestGroup {
+    private:
+
+        RequestGroup(const RequestGroup&);
+        RequestGroup& operator= (const RequestGroup&);
+
+    public:
+
+        Mutex mutex;
+        int pending;
+        std::vector< Pointer<BrokerError> > errors;
+
+    public:
+
+        RequestGroup(std::size_t size) : mutex(), pending(0), errors(size) {}
+
+        void sent() {
+            synchronized(&this->mutex) {
+                this->pending++;
+            }
+        }
+
+        void complete(std::size_t index, Pointer<BrokerError> error) {
+            synchronized(&this->mutex) {
+                this->errors[index] = error;
+                this->pending--;
+                this->mutex.notifyAll();
+            }
+        }
 
-                Exception ex = exceptionResponse->getException()->createExceptionObject();
-                const cms::CMSException* cmsError = dynamic_cast<const cms::CMSException*>(ex.getCause());
-                if (cmsError != NULL) {
-                    this->callback->onException(*cmsError);
-                } else {
-                    BrokerException error = BrokerException(__FILE__, __LINE__, exceptionResponse->getException()->getMessage().c_str());
-                    this->callback->onException(error.convertToCMSException());
+        void await() {
+            synchronized(&this->mutex) {
+                while (this->pending > 0) {
+                    this->mutex.wait();
                 }
+            }
+        }
+    };
+
+    class RequestGroupCallback : public ResponseCallback {
+    private:
+
+        Pointer<RequestGroup> group;
+        std::size_t index;
+
+    private:
+
+        RequestGroupCallback(const RequestGroupCallback&);
+        RequestGroupCallback& operator= (const RequestGroupCallback&);
+
+    public:
+
+        RequestGroupCallback(Pointer<RequestGroup> group, std::size_t index) :
+            ResponseCallback(), group(group), index(index) {
+        }
+
+        virtual ~RequestGroupCallback() {
+        }
+
+        virtual void onComplete(Pointer<commands::Response> response) {
+
+            commands::ExceptionResponse* exceptionResponse =
+                dynamic_cast<ExceptionResponse*> (response.get());
+
+            this->group->complete(this->index, exceptionResponse != NULL ?
+                exceptionResponse->getException() : Pointer<BrokerError>());
+        }
+    };
+
+    void notifyAsyncCallback(cms::AsyncCallback* callback, Pointer<commands::Response> response) {
+
+        commands::ExceptionResponse* exceptionResponse =
+            dynamic_cast<ExceptionResponse*> (response.get());
+
+        if (exceptionResponse != NULL) {
+
+            Exception ex = exceptionResponse->getException()->createExceptionObject();
+            const cms::CMSException* cmsError = dynamic_cast<const cms::CMSException*>(ex.getCause());
+            if (cmsError != NULL) {
+                callback->onException(*cmsError);
+            } else {
+                BrokerException error = BrokerException(__FILE__, __LINE__, exceptionResponse->getException()->getMessage().c_str());
+                callback->onException(error.convertToCMSException());
+            }
+        } else {
+            callback->onSuccess();
+        }
+    }
+
+    class AsyncCallbackRunnable : public Runnable {
+    private:
+
+        cms::AsyncCallback* callback;
+        Pointer<commands::Response> response;
+
+    private:
+
+        AsyncCallbackRunnable(const AsyncCallbackRunnable&);
+        AsyncCallbackRunnable& operator= (const AsyncCallbackRunnable&);
+
+    public:
+
+        AsyncCallbackRunnable(cms::AsyncCallback* callback, Pointer<commands::Response> response) :
+            Runnable(), callback(callback), response(response) {
+        }
+
+        virtual ~AsyncCallbackRunnable() {}
+
+        virtual void run() {
+            notifyAsyncCallback(this->callback, this->response);
+        }
+    };
+
+    class AsyncResponseCallback : public ResponseCallback {
+    private:
+
+        cms::AsyncCallback* callback;
+
+        // When set the callback is run on the executor in the order of the key.
+        Pointer<KeyedSerialExecutor> executor;
+        int key;
+
+    private:
+
+        AsyncResponseCallback(const AsyncResponseCallback&);
+        AsyncResponseCallback& operator= (const AsyncResponseCallback&);
+
+    public:
+
+        AsyncResponseCallback(cms::AsyncCallback* callback, Pointer<KeyedSerialExecutor> executor, int key) :
+            ResponseCallback(), callback(callback), executor(executor), key(key) {
+        }
+
+        virtual ~AsyncResponseCallback() {
+        }
+
+        virtual void onComplete(Pointer<commands::Response> response) {
+            if (this->executor != NULL) {
+                this->executor->execute(this->key, new AsyncCallbackRunnable(this->callback, response));
             } else {
-                this->callback->onSuccess();
+                notifyAsyncCallback(this->callback, response);
             }
         }
     };
@@ -498,6 +1118,8 @@ ActiveMQConnection::ActiveMQConnection(const Pointer<transport::Transport> trans
     configuration->connectionInfo->setFaultTolerant(transport->isFaultTolerant());
 
     configuration->connectionAudit.setCheckForDuplicates(transport->isFaultTolerant());
+    configuration->subscriptionMultiplexer.reset(
+        new SubscriptionMultiplexer(this, &configuration->consumerIdGenerator));
 
     this->config = configuration.release();
 }
@@ -521,9 +1143,7 @@ ActiveMQConnection::~ActiveMQConnection() {
 void ActiveMQConnection::addDispatcher(const decaf::lang::Pointer<ConsumerId>& consumer, Dispatcher* dispatcher) {
 
     try {
-        synchronized(&this->config->dispatchers) {
-            this->config->dispatchers.put(consumer, dispatcher);
-        }
+        this->config->updateDispatcher(*consumer, dispatcher);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -532,9 +1152,9 @@ void ActiveMQConnection::addDispatcher(const decaf::lang::Pointer<ConsumerId>& c
 void ActiveMQConnection::removeDispatcher(const decaf::lang::Pointer<ConsumerId>& consumer) {
 
     try {
-        synchronized(&this->config->dispatchers) {
-            this->config->dispatchers.remove(consumer);
-        }
+        // Waits for dispatches in progress, once this returns no dispatch to the removed
+        // one is running on another thread.
+        this->config->updateDispatcher(*consumer, NULL);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -615,9 +1235,7 @@ void ActiveMQConnection::removeSession(Pointer<ActiveMQSessionKernel> session) {
 void ActiveMQConnection::addProducer(Pointer<ActiveMQProducerKernel> producer) {
 
     try {
-        synchronized(&this->config->activeProducers) {
-            this->config->activeProducers.put(producer->getProducerInfo()->getProducerId(), producer);
-        }
+        this->config->updateProducer(*producer->getProducerInfo()->getProducerId(), &producer);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -626,9 +1244,7 @@ void ActiveMQConnection::addProducer(Pointer<ActiveMQProducerKernel> producer) {
 void ActiveMQConnection::removeProducer(const decaf::lang::Pointer<ProducerId>& producerId) {
 
     try {
-        synchronized(&this->config->activeProducers) {
-            this->config->activeProducers.remove(producerId);
-        }
+        this->config->updateProducer(*producerId, NULL);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -748,23 +1364,23 @@ void ActiveMQConnection::close() {
             }
         }
 
+        // Closing the sessions has emptied the shared subscriptions unless a consumer
+        // failed to close.
+        this->config->subscriptionMultiplexer->close();
+
         // As TemporaryQueue and TemporaryTopic instances are bound to a connection
         // we should just delete them after the connection is closed to free up memory
         if (this->config->advisoryConsumer != NULL) {
             this->config->advisoryConsumer->dispose();
         }
 
-        ArrayList<Pointer<ActiveMQTempDestination> > tempDests(this->config->activeTempDestinations.values());
-        Pointer<Iterator<Pointer<ActiveMQTempDestination> > > iterator(tempDests.iterator());
-
+        // Removed from the broker together along with those registered ahead and not used.
         try {
-            while (iterator->hasNext()) {
-                Pointer<ActiveMQTempDestination> dest = iterator->next();
-                dest->close();
-            }
-        } catch (cms::CMSException& error) {
+            this->deleteTempDestinations(true);
+        } catch (Exception& error) {
             if (!hasException) {
-                ex = ActiveMQException(error.clone());
+                ex = error;
+                ex.setMark(__FILE__, __LINE__);
                 hasException = true;
             }
         }
@@ -781,6 +1397,23 @@ void ActiveMQConnection::close() {
             }
         }
 
+        // The sessions are disposed so nothing is left to run on the dispatch pool.
+        try {
+            Pointer<TaskRunnerPool> pool;
+            synchronized(&this->config->mutex) {
+                pool = this->config->sessionDispatchPool;
+            }
+            if (pool != NULL) {
+                pool->shutdown();
+            }
+        } catch (Exception& error) {
+            if (!hasException) {
+                ex = error;
+                ex.setMark(__FILE__, __LINE__);
+                hasException = true;
+            }
+        }
+
         // Now inform the Broker we are shutting down.
         try {
             this->disconnect(lastDeliveredSequenceId);
@@ -792,12 +1425,30 @@ void ActiveMQConnection::close() {
             }
         }
 
-        // Once current deliveries are done this stops the delivery
-        // of any new messages.
-        this->started.set(false);
-        this->closed.set(true);
-
-        if (hasException) {
+        // The transport is down so no more completions arrive, those still queued
+        // are run here.
+        try {
+            Pointer<KeyedSerialExecutor> callbacks;
+            synchronized(&this->config->mutex) {
+                callbacks = this->config->asyncCallbackExecutor;
+            }
+            if (callbacks != NULL) {
+                callbacks->shutdown();
+            }
+        } catch (Exception& error) {
+            if (!hasException) {
+                ex = error;
+                ex.setMark(__FILE__, __LINE__);
+                hasException = true;
+            }
+        }
+
+        // Once current deliveries are done this stops the delivery
+        // of any new messages.
+        this->started.set(false);
+        this->closed.set(true);
+
+        if (hasException) {
             throw ex;
         }
     }
@@ -857,6 +1508,9 @@ void ActiveMQConnection::start() {
         checkClosedOrFailed();
         ensureConnectionInfoSent();
 
+        // Whatever the broker refused is closed before delivery starts.
+        awaitPipelinedStartup();
+
         try {
             // This starts or restarts the delivery of all incoming messages
             // messages delivered while this connection is stopped are dropped
@@ -1051,44 +1705,55 @@ void ActiveMQConnection::onCommand(const Pointer<Command> command) {
 
             Pointer<MessageDispatch> dispatch = command.dynamicCast<MessageDispatch>();
 
+            trace(util::MessageTracer::CONNECTION_DISPATCH, *dispatch);
+
             // Check first to see if we are recovering.
             waitForTransportInterruptionProcessingToComplete();
 
-            // Look up the dispatcher.
-            Dispatcher* dispatcher = NULL;
-            synchronized(&this->config->dispatchers) {
-
-                dispatcher = this->config->dispatchers.get(dispatch->getConsumerId());
+            // Look up the dispatcher and count the dispatch before the lookup ends, it
+            // can't be removed before the dispatch is done.
+            Pointer<DispatcherRef> ref;
+            {
+                IndexReadScope scope(this->config);
+                if (this->config->dispatcherIndex.get()->tryGet(*dispatch->getConsumerId(), ref)) {
+                    ref->dispatching.incrementAndGet();
+                }
+            }
 
-                // If we have no registered dispatcher, the consumer was probably
-                // just closed.
-                if (dispatcher != NULL) {
+            // If we have no registered dispatcher, the consumer was probably
+            // just closed.
+            if (ref != NULL) {
 
-                    Pointer<commands::Message> message = dispatch->getMessage();
+                DispatchScope dispatching(this->config, ref.get());
 
-                    // Message == NULL to signal the end of a Queue Browse.
-                    if (message != NULL) {
-                        message->setReadOnlyBody(true);
-                        message->setReadOnlyProperties(true);
-                        message->setRedeliveryCounter(dispatch->getRedeliveryCounter());
-                        message->setConnection(this);
-                    }
+                Pointer<commands::Message> message = dispatch->getMessage();
 
-                    dispatcher->dispatch(dispatch);
+                // Message == NULL to signal the end of a Queue Browse.
+                if (message != NULL) {
+                    this->config->metrics.getMessagesReceived().increment();
+                    message->setReadOnlyBody(true);
+                    message->setReadOnlyProperties(true);
+                    message->setRedeliveryCounter(dispatch->getRedeliveryCounter());
+                    message->setConnection(this);
                 }
+
+                ref->dispatcher->dispatch(dispatch);
             }
 
         } else if (command->isProducerAck()) {
 
             ProducerAck* producerAck = dynamic_cast<ProducerAck*>(command.get());
 
-            // Get the consumer info object for this consumer.
+            // The index holds the producer by reference so the copy taken during the
+            // lookup keeps it alive while the ack is applied outside the read.
             Pointer<ActiveMQProducerKernel> producer;
-            synchronized(&this->config->activeProducers) {
-                producer = this->config->activeProducers.get(producerAck->getProducerId());
-                if (producer != NULL) {
-                    producer->onProducerAck(*producerAck);
-                }
+            {
+                IndexReadScope scope(this->config);
+                this->config->producerIndex.get()->tryGet(*producerAck->getProducerId(), producer);
+            }
+
+            if (producer != NULL) {
+                producer->onProducerAck(*producerAck);
             }
 
         } else if (command->isWireFormatInfo()) {
@@ -1212,6 +1877,7 @@ void ActiveMQConnection::onClientInternalException(const decaf::lang::Exception&
 void ActiveMQConnection::transportInterrupted() {
 
     this->config->transportInterruptionProcessingComplete->set(0);
+    this->config->subscriptionMultiplexer->transportInterrupted();
 
     this->config->sessionsLock.readLock().lock();
     try {
@@ -1239,6 +1905,10 @@ void ActiveMQConnection::transportInterrupted() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::transportResumed() {
 
+    if (this->config->tracer != NULL) {
+        this->setMessageTracer(this->config->tracer);
+    }
+
     synchronized(&this->config->transportListeners) {
         Pointer<Iterator<TransportListener*> > iter(this->config->transportListeners.iterator());
         while (iter->hasNext()) {
@@ -1271,6 +1941,7 @@ Pointer<Response> ActiveMQConnection::syncRequest(Pointer<Command> command, unsi
         checkClosedOrFailed();
 
         Pointer<Response> response;
+        long long start = System::nanoTime();
 
         if (timeout == 0) {
             response = this->config->transport->request(command);
@@ -1278,6 +1949,8 @@ Pointer<Response> ActiveMQConnection::syncRequest(Pointer<Command> command, unsi
             response = this->config->transport->request(command, timeout);
         }
 
+        this->config->metrics.getSyncRequestTime().record((System::nanoTime() - start) / 1000);
+
         commands::ExceptionResponse* exceptionResponse = dynamic_cast<ExceptionResponse*>(response.get());
 
         if (exceptionResponse != NULL) {
@@ -1305,7 +1978,31 @@ void ActiveMQConnection::asyncRequest(Pointer<Command> command, cms::AsyncCallba
 
         checkClosedOrFailed();
 
-        Pointer<ResponseCallback> callback(new AsyncResponseCallback(this->config, onComplete));
+        // Completions for one producer keep their order, those of different producers
+        // may run at the same time.
+        Pointer<KeyedSerialExecutor> executor;
+        int key = 0;
+        if (this->config->asyncCallbackPoolSize > 0) {
+            synchronized(&this->config->mutex) {
+                if (this->config->asyncCallbackExecutor == NULL) {
+                    this->config->asyncCallbackExecutor.reset(new KeyedSerialExecutor(
+                        this->config->asyncCallbackPoolSize,
+                        std::string("ActiveMQConnection[") +
+                            this->config->connectionInfo->getConnectionId()->getValue() + "] Async Callbacks",
+                        this->config->threadAffinity));
+                }
+                executor = this->config->asyncCallbackExecutor;
+            }
+
+            if (command->isMessage()) {
+                Pointer<commands::Message> message = command.dynamicCast<commands::Message>();
+                if (message->getProducerId() != NULL) {
+                    key = message->getProducerId()->getHashCode();
+                }
+            }
+        }
+
+        Pointer<ResponseCallback> callback(new AsyncResponseCallback(onComplete, executor, key));
         this->config->transport->asyncRequest(command, callback);
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1315,6 +2012,179 @@ void ActiveMQConnection::asyncRequest(Pointer<Command> command, cms::AsyncCallba
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::startupRequest(Pointer<Command> command) {
+
+    try {
+
+        if (!this->config->pipelinedStartup) {
+            this->syncRequest(command);
+            return;
+        }
+
+        checkClosedOrFailed();
+
+        synchronized(&this->config->startupLock) {
+            this->config->pendingStartupRequests++;
+        }
+
+        try {
+            Pointer<ResponseCallback> callback(new StartupResponseCallback(this->config, command));
+            this->config->transport->asyncRequest(command, callback);
+        } catch (Exception& ex) {
+            synchronized(&this->config->startupLock) {
+                this->config->pendingStartupRequests--;
+                this->config->startupLock.notifyAll();
+            }
+            throw;
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(IOException, ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::exceptions::UnsupportedOperationException, ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::awaitPipelinedStartup() {
+
+    try {
+
+        std::vector< std::pair< Pointer<Command>, Pointer<BrokerError> > > failures;
+
+        // Every request completes, a transport failure completes the ones still
+        // waiting with an error.
+        synchronized(&this->config->startupLock) {
+            while (this->config->pendingStartupRequests > 0) {
+                this->config->startupLock.wait();
+            }
+
+            failures.swap(this->config->startupFailures);
+        }
+
+        if (failures.empty()) {
+            return;
+        }
+
+        std::vector< std::pair< Pointer<Command>, Pointer<BrokerError> > >::iterator failure = failures.begin();
+        for (; failure != failures.end(); ++failure) {
+            Exception error = failure->second->createExceptionObject();
+            closeFailedStartup(failure->first, error);
+        }
+
+        throw failures.front().second->createExceptionObject();
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::closeFailedStartup(Pointer<Command> command, Exception& error) {
+
+    ConsumerInfo* consumerInfo = dynamic_cast<ConsumerInfo*>(command.get());
+    ProducerInfo* producerInfo = dynamic_cast<ProducerInfo*>(command.get());
+
+    if (consumerInfo == NULL && producerInfo == NULL) {
+        return;
+    }
+
+    ArrayList< Pointer<ActiveMQSessionKernel> > sessions = this->getSessions();
+    Pointer< Iterator< Pointer<ActiveMQSessionKernel> > > iter(sessions.iterator());
+    while (iter->hasNext()) {
+        Pointer<ActiveMQSessionKernel> session = iter->next();
+
+        try {
+            if (consumerInfo != NULL) {
+                Pointer<ActiveMQConsumerKernel> consumer = session->lookupConsumerKernel(consumerInfo->getConsumerId());
+                if (consumer != NULL) {
+                    consumer->setFailureError(&error);
+                    consumer->dispose();
+                    return;
+                }
+            } else {
+                Pointer<ActiveMQProducerKernel> producer = session->lookupProducerKernel(producerInfo->getProducerId());
+                if (producer != NULL) {
+                    producer->dispose();
+                    return;
+                }
+            }
+        } catch (Exception& ex) {
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::beginCommitWrite() {
+
+    try {
+
+        IOTransport* io = dynamic_cast<IOTransport*>(this->config->transport->narrow(typeid(IOTransport)));
+        if (io == NULL) {
+            return false;
+        }
+
+        synchronized(&this->config->commitWriteLock) {
+
+            // Another commit or a batch send has the flush deferred, this one rides along.
+            if (io->isFlushDeferred()) {
+                return false;
+            }
+
+            io->setFlushDeferred(true);
+            this->config->commitWriteTransport = io;
+            this->config->commitWriteStarted = System::nanoTime();
+        }
+
+        return true;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::endCommitWrite() {
+
+    try {
+
+        IOTransport* io = NULL;
+        long long started = 0;
+
+        synchronized(&this->config->commitWriteLock) {
+            io = this->config->commitWriteTransport;
+            started = this->config->commitWriteStarted;
+        }
+
+        if (io == NULL) {
+            return;
+        }
+
+        long long window = this->config->commitBatchWindow;
+        if (window > 0) {
+            long long remaining = window * 1000 - (System::nanoTime() - started);
+            if (remaining > 0) {
+                try {
+                    Thread::sleep(remaining / 1000000, (int) (remaining % 1000000));
+                } catch (InterruptedException& ex) {
+                    // Flush now, the batch still has to go out.
+                    Thread::currentThread()->interrupt();
+                }
+            }
+        }
+
+        synchronized(&this->config->commitWriteLock) {
+            this->config->commitWriteTransport = NULL;
+        }
+
+        io->setFlushDeferred(false);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::checkClosed() const {
     if (this->isClosed()) {
@@ -1354,7 +2224,7 @@ void ActiveMQConnection::ensureConnectionInfoSent() {
             }
 
             // Now we ping the broker and see if we get an ack / nack
-            syncRequest(this->config->connectionInfo);
+            startupRequest(this->config->connectionInfo);
 
             this->config->isConnectionInfoSentToBroker = true;
 
@@ -1567,6 +2437,134 @@ int ActiveMQConnection::getCompressionLevel() const {
     return this->config->compressionLevel;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+activemq::util::CompressionPool& ActiveMQConnection::getCompressionPool() const {
+    return this->config->compressionPool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnection::getCompressionCodec() const {
+    synchronized(&this->config->compressionCodecsLock) {
+        return this->config->compressionCodec;
+    }
+
+    return util::CompressionCodec::ZLIB;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCompressionCodec(const std::string& value) {
+
+    if (!util::CompressionCodec::isKnown(value)) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Unknown compression codec: %s", value.c_str());
+    }
+
+    // Fall back to zlib, which every client can read, when this build lacks the codec.
+    std::string name = util::CompressionCodec::isSupported(value) ? value : util::CompressionCodec::ZLIB;
+
+    synchronized(&this->config->compressionCodecsLock) {
+        this->config->compressionCodec = name;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char> ActiveMQConnection::getCompressionDictionary() const {
+    synchronized(&this->config->compressionCodecsLock) {
+        return this->config->compressionDictionary;
+    }
+
+    return std::vector<unsigned char>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCompressionDictionary(const std::vector<unsigned char>& value) {
+
+    synchronized(&this->config->compressionCodecsLock) {
+
+        this->config->compressionDictionary = value;
+
+        std::map<std::string, util::CompressionCodec*>::iterator codec = this->config->compressionCodecs.begin();
+        for (; codec != this->config->compressionCodecs.end(); ++codec) {
+            this->config->retiredCompressionCodecs.push_back(codec->second);
+        }
+
+        this->config->compressionCodecs.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getCompressionBlockSize() const {
+    synchronized(&this->config->compressionCodecsLock) {
+        return this->config->compressionBlockSize;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isIncrementalDecompression() const {
+    return this->config->incrementalDecompression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setIncrementalDecompression(bool value) {
+    this->config->incrementalDecompression = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCompressionBlockSize(int value) {
+
+    if (value < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression block size cannot be negative: %d", value);
+    }
+
+    synchronized(&this->config->compressionCodecsLock) {
+
+        this->config->compressionBlockSize = value;
+
+        std::map<std::string, util::CompressionCodec*>::iterator codec = this->config->compressionCodecs.begin();
+        while (codec != this->config->compressionCodecs.end()) {
+            if (util::BlockCompressionCodec::isBlockCodecName(codec->first)) {
+                this->config->retiredCompressionCodecs.push_back(codec->second);
+                this->config->compressionCodecs.erase(codec++);
+            } else {
+                ++codec;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+activemq::util::CompressionCodec& ActiveMQConnection::getCompressionCodecInstance(const std::string& name) const {
+
+    if (name == util::CompressionCodec::ZLIB) {
+        return this->config->compressionPool;
+    }
+
+    synchronized(&this->config->compressionCodecsLock) {
+
+        std::map<std::string, util::CompressionCodec*>::iterator iter = this->config->compressionCodecs.find(name);
+        if (iter != this->config->compressionCodecs.end()) {
+            return *(iter->second);
+        }
+
+        util::CompressionCodec* codec = NULL;
+
+        // Block sizes only matter when compressing, any block size decompresses.
+        if (util::BlockCompressionCodec::isBlockCodecName(name) && this->config->compressionBlockSize > 0) {
+            codec = new util::BlockCompressionCodec(util::CompressionCodec::create(
+                util::BlockCompressionCodec::toWrappedCodecName(name), this->config->compressionDictionary),
+                this->config->compressionBlockSize);
+        } else {
+            codec = util::CompressionCodec::create(name, this->config->compressionDictionary);
+        }
+
+        this->config->compressionCodecs.insert(std::make_pair(name, codec));
+        return *codec;
+    }
+
+    return this->config->compressionPool;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConnection::setCompressionLevel(int value) {
 
@@ -1607,6 +2605,16 @@ void ActiveMQConnection::setProducerWindowSize(unsigned int windowSize) {
     this->config->producerWindowSize = windowSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getMaxPendingSends() const {
+    return this->config->maxPendingSends;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setMaxPendingSends(int value) {
+    this->config->maxPendingSends = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long ActiveMQConnection::getNextTempDestinationId() {
     return this->config->tempDestinationIds.getNextSequenceId();
@@ -1638,60 +2646,428 @@ void ActiveMQConnection::setMessagePrioritySupported(bool value) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ActiveMQConnection::setFirstFailureError(decaf::lang::Exception* error) {
-
-    this->transportFailed.set(true);
-
-    if (this->config->firstFailureError == NULL) {
-        this->config->firstFailureError.reset(error);
-    } else {
-        delete error;
-    }
+bool ActiveMQConnection::isPipelinedStartup() const {
+    return this->config->pipelinedStartup;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-decaf::lang::Exception* ActiveMQConnection::getFirstFailureError() const {
-    return this->config->firstFailureError.get();
+void ActiveMQConnection::setPipelinedStartup(bool value) {
+    this->config->pipelinedStartup = value;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string ActiveMQConnection::getResourceManagerId() const {
-    try {
-        this->config->waitForBrokerInfo();
-
-        if (this->config->brokerInfo == NULL) {
-            throw CMSException("Connection failed before Broker info was received.");
-        }
-
-        return this->config->brokerInfo->getBrokerId()->getValue();
-    }
-    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+bool ActiveMQConnection::isMemoryAccountingEnabled() const {
+    return this->config->memoryAccountingEnabled;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const decaf::util::Properties& ActiveMQConnection::getProperties() const {
-    return *(this->config->properties);
+void ActiveMQConnection::setMemoryAccountingEnabled(bool value) {
+    this->config->memoryAccountingEnabled = value;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-ExecutorService* ActiveMQConnection::getExecutor() const {
-    return this->config->executor.get();
+long long ActiveMQConnection::getConsumerMemoryLimit() const {
+    return (long long) this->config->consumerMemoryUsage.getLimit();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-ArrayList< Pointer<ActiveMQSessionKernel> > ActiveMQConnection::getSessions() const {
-    ArrayList< Pointer<ActiveMQSessionKernel> > result;
+void ActiveMQConnection::setConsumerMemoryLimit(long long value) {
+    this->config->consumerMemoryUsage.setLimit(value > 0 ? (unsigned long long) value : 0);
 
-    this->config->sessionsLock.readLock().lock();
-    try {
-        result.addAll(this->config->activeSessions);
-        this->config->sessionsLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->sessionsLock.readLock().unlock();
-        throw;
-    }
+    // A raised or removed budget may let the suspended consumers resume right away.
+    checkConsumerPressure();
+}
 
-    return result;
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getConsumerMemoryUsage() const {
+    return (long long) this->config->consumerMemoryUsage.getUsage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setConsumerPressureMonitor(ConsumerPressureMonitor* monitor) {
+    this->config->consumerPressureMonitor = monitor;
+    checkConsumerPressure();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConsumerPressureMonitor* ActiveMQConnection::getConsumerPressureMonitor() const {
+    return this->config->consumerPressureMonitor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isConsumersSuspended() const {
+    return this->config->consumersSuspended;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::checkConsumerPressure() {
+    updateConsumerMemoryUsage(NULL, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::updateConsumerMemoryUsage(ActiveMQConsumerKernel* consumer, long long delta) {
+
+    util::MemoryUsage& usage = this->config->consumerMemoryUsage;
+    if (delta > 0) {
+        usage.increaseUsage((unsigned long long) delta);
+    } else if (delta < 0) {
+        usage.decreaseUsage((unsigned long long) -delta);
+    }
+
+    if (usage.getLimit() == 0 && this->config->consumerPressureMonitor == NULL &&
+        !this->config->consumersSuspended) {
+        return;
+    }
+
+    // The decision is made under the lock from the usage as it is then, a decision made
+    // from an older reading could leave the consumers suspended with nothing arriving
+    // that would check again.
+    bool suspend = false;
+    bool changed = false;
+    synchronized(&this->config->consumerPressureLock) {
+
+        long long current = (long long) usage.getUsage();
+        long long limit = (long long) usage.getLimit();
+        ConsumerPressureMonitor* monitor = this->config->consumerPressureMonitor;
+        bool suspended = this->config->consumersSuspended;
+
+        // Resuming at half the budget keeps a steady stream of messages from flipping
+        // the consumers between stopped and running on every message.
+        if (monitor != NULL && monitor->isUnderPressure(current)) {
+            suspend = true;
+        } else if (limit > 0) {
+            suspend = suspended ? current > limit / 2 : current > limit;
+        }
+
+        changed = suspend != suspended;
+        this->config->consumersSuspended = suspend;
+    }
+
+    // A consumer created while the others were suspended joins them.
+    if (!changed && !(suspend && consumer != NULL && !consumer->isSuspended())) {
+        return;
+    }
+
+    // The consumers are suspended and resumed on the executor, the caller may hold the
+    // locks of its own consumer and the thread that runs the pass holds none.  One pass
+    // at a time is queued, it applies whatever state is current when it runs.
+    if (!this->isClosed() && !this->closing.get() &&
+        this->config->consumerPressurePending.compareAndSet(false, true)) {
+        this->config->executor->execute(new ConsumerPressureRunnable(this, this->config));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isUseRingDispatchChannel() const {
+    return this->config->useRingDispatchChannel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setUseRingDispatchChannel(bool value) {
+    this->config->useRingDispatchChannel = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isAggregateSessionAcks() const {
+    return this->config->aggregateSessionAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setAggregateSessionAcks(bool value) {
+    this->config->aggregateSessionAcks = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isUseBorrowedMessages() const {
+    return this->config->useBorrowedMessages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setUseBorrowedMessages(bool value) {
+    this->config->useBorrowedMessages = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isMultiplexTopicSubscriptions() const {
+    return this->config->multiplexTopicSubscriptions;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setMultiplexTopicSubscriptions(bool value) {
+    this->config->multiplexTopicSubscriptions = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SubscriptionMultiplexer& ActiveMQConnection::getSubscriptionMultiplexer() const {
+    return *this->config->subscriptionMultiplexer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getSessionDispatchPoolSize() const {
+    return this->config->sessionDispatchPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setSessionDispatchPoolSize(int value) {
+    this->config->sessionDispatchPoolSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getAsyncCallbackPoolSize() const {
+    return this->config->asyncCallbackPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setAsyncCallbackPoolSize(int value) {
+    this->config->asyncCallbackPoolSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getGroupDispatchLanes() const {
+    return this->config->groupDispatchLanes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setGroupDispatchLanes(int value) {
+    this->config->groupDispatchLanes = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getParallelListenerThreads() const {
+    return this->config->parallelListenerThreads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setParallelListenerThreads(int value) {
+    this->config->parallelListenerThreads = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnection::getThreadPlacement() const {
+    return ThreadPlacement::toString(this->config->threadPlacement);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setThreadPlacement(const std::string& value) {
+
+    ThreadPlacement::Policy policy = ThreadPlacement::parse(value);
+
+    synchronized(&this->config->mutex) {
+
+        if (policy == this->config->threadPlacement) {
+            return;
+        }
+
+        this->config->threadPlacement = policy;
+        this->config->threadAffinity = ThreadPlacement::nextPlacement(policy);
+
+        IOTransport* io = dynamic_cast<IOTransport*>(this->config->transport->narrow(typeid(IOTransport)));
+        if (io != NULL) {
+            io->setThreadAffinity(this->config->threadAffinity);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<int> ActiveMQConnection::getThreadAffinity() const {
+    std::vector<int> result;
+    synchronized(&this->config->mutex) {
+        result = this->config->threadAffinity;
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TaskRunner> ActiveMQConnection::createSessionTaskRunner(Task* task) {
+
+    try {
+
+        if (this->config->sessionDispatchPoolSize <= 0) {
+            return Pointer<TaskRunner>(new DedicatedTaskRunner(task, this->config->threadAffinity));
+        }
+
+        Pointer<TaskRunnerPool> pool;
+        synchronized(&this->config->mutex) {
+            if (this->config->sessionDispatchPool == NULL) {
+                this->config->sessionDispatchPool.reset(new TaskRunnerPool(
+                    this->config->sessionDispatchPoolSize,
+                    std::string("ActiveMQConnection[") +
+                        this->config->connectionInfo->getConnectionId()->getValue() + "] Session Dispatch",
+                    this->config->threadAffinity));
+            }
+            pool = this->config->sessionDispatchPool;
+        }
+
+        return pool->createTaskRunner(task);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setFirstFailureError(decaf::lang::Exception* error) {
+
+    this->transportFailed.set(true);
+
+    if (this->config->firstFailureError == NULL) {
+        this->config->firstFailureError.reset(error);
+    } else {
+        delete error;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+decaf::lang::Exception* ActiveMQConnection::getFirstFailureError() const {
+    return this->config->firstFailureError.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnection::getResourceManagerId() const {
+    try {
+        this->config->waitForBrokerInfo();
+
+        if (this->config->brokerInfo == NULL) {
+            throw CMSException("Connection failed before Broker info was received.");
+        }
+
+        return this->config->brokerInfo->getBrokerId()->getValue();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const decaf::util::Properties& ActiveMQConnection::getProperties() const {
+    return *(this->config->properties);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ExecutorService* ActiveMQConnection::getExecutor() const {
+    return this->config->executor.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ArrayList< Pointer<ActiveMQSessionKernel> > ActiveMQConnection::getSessions() const {
+    ArrayList< Pointer<ActiveMQSessionKernel> > result;
+
+    this->config->sessionsLock.readLock().lock();
+    try {
+        result.addAll(this->config->activeSessions);
+        this->config->sessionsLock.readLock().unlock();
+    } catch (Exception& ex) {
+        this->config->sessionsLock.readLock().unlock();
+        throw;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConnectionMetrics& ActiveMQConnection::getMetrics() const {
+    return this->config->metrics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::map<std::string, long long> ActiveMQConnection::getMetricsSnapshot() const {
+
+    std::map<std::string, long long> values;
+    this->config->metrics.snapshot(values);
+
+    IOTransport* io = NULL;
+    if (this->config->transport != NULL) {
+        io = dynamic_cast<IOTransport*>(this->config->transport->narrow(typeid(IOTransport)));
+    }
+
+    values["transport.commandsSent"] = io != NULL ? io->getCommandsSent() : 0;
+    values["transport.commandsReceived"] = io != NULL ? io->getCommandsReceived() : 0;
+    values["transport.bytesSent"] = io != NULL ? io->getBytesSent() : 0;
+    values["transport.bytesReceived"] = io != NULL ? io->getBytesReceived() : 0;
+
+    if (this->config->memoryAccountingEnabled) {
+        collectMemoryUsage(values);
+    }
+
+    return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::collectMemoryUsage(std::map<std::string, long long>& values) const {
+
+    long long prefetch = 0;
+    long long delivered = 0;
+    long long dispatchQueue = 0;
+
+    ArrayList< Pointer<ActiveMQSessionKernel> > sessions = this->getSessions();
+    Pointer< Iterator< Pointer<ActiveMQSessionKernel> > > session(sessions.iterator());
+    while (session->hasNext()) {
+        Pointer<ActiveMQSessionKernel> kernel = session->next();
+        dispatchQueue += kernel->getDispatchQueueMemoryUsage();
+
+        ArrayList< Pointer<ActiveMQConsumerKernel> > consumers = kernel->getConsumers();
+        Pointer< Iterator< Pointer<ActiveMQConsumerKernel> > > consumer(consumers.iterator());
+        while (consumer->hasNext()) {
+            Pointer<ActiveMQConsumerKernel> next = consumer->next();
+            prefetch += next->getPrefetchMemoryUsage();
+            delivered += next->getDeliveredMemoryUsage();
+        }
+    }
+
+    long long stateTracker = 0;
+    if (this->config->transport != NULL) {
+        FailoverTransport* failover =
+            dynamic_cast<FailoverTransport*>(this->config->transport->narrow(typeid(FailoverTransport)));
+        if (failover != NULL) {
+            stateTracker = failover->getStateTracker().getMemoryUsage();
+        }
+    }
+
+    long long audit = this->config->connectionAudit.getMemoryUsage();
+
+    long long compression = this->config->compressionPool.getMemoryUsage();
+    synchronized(&this->config->compressionCodecsLock) {
+        std::map<std::string, util::CompressionCodec*>::const_iterator codec = this->config->compressionCodecs.begin();
+        for (; codec != this->config->compressionCodecs.end(); ++codec) {
+            compression += codec->second->getMemoryUsage();
+        }
+        std::vector<util::CompressionCodec*>::const_iterator retired = this->config->retiredCompressionCodecs.begin();
+        for (; retired != this->config->retiredCompressionCodecs.end(); ++retired) {
+            compression += (*retired)->getMemoryUsage();
+        }
+    }
+
+    values["memory.prefetch"] = prefetch;
+    values["memory.delivered"] = delivered;
+    values["memory.dispatchQueue"] = dispatchQueue;
+    values["memory.stateTracker"] = stateTracker;
+    values["memory.audit"] = audit;
+    values["memory.compression"] = compression;
+    values["memory.total"] = prefetch + delivered + dispatchQueue + stateTracker + audit + compression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setMessageTracer(util::MessageTracer* tracer) {
+
+    this->config->tracer = tracer;
+
+    if (this->config->transport != NULL) {
+        IOTransport* io = dynamic_cast<IOTransport*>(this->config->transport->narrow(typeid(IOTransport)));
+        if (io != NULL) {
+            io->setMessageTracer(tracer);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+activemq::util::MessageTracer* ActiveMQConnection::getMessageTracer() const {
+    return this->config->tracer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::trace(util::MessageTracer::TracePoint point, const commands::Command& command) const {
+    util::MessageTracer* tracer = this->config->tracer;
+    if (tracer != NULL) {
+        tracer->onTrace(point, command, System::nanoTime());
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1794,6 +3170,36 @@ void ActiveMQConnection::setOptimizedAckScheduledAckInterval(long long optimized
     this->config->optimizedAckScheduledAckInterval = optimizedAckScheduledAckInterval;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getAckCoalesceCount() const {
+    return this->config->ackCoalesceCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setAckCoalesceCount(int value) {
+    this->config->ackCoalesceCount = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getAckCoalesceDelay() const {
+    return this->config->ackCoalesceDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setAckCoalesceDelay(long long value) {
+    this->config->ackCoalesceDelay = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnection::getCommitBatchWindow() const {
+    return this->config->commitBatchWindow;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setCommitBatchWindow(long long value) {
+    this->config->commitBatchWindow = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long ActiveMQConnection::getConsumerFailoverRedeliveryWaitPeriod() const {
     return this->config->consumerFailoverRedeliveryWaitPeriod;
@@ -1846,20 +3252,8 @@ void ActiveMQConnection::deleteTempDestination(Pointer<ActiveMQTempDestination>
         checkClosedOrFailed();
         ensureConnectionInfoSent();
 
-        this->config->sessionsLock.readLock().lock();
-        try {
-            Pointer<Iterator<Pointer<ActiveMQSessionKernel> > > iterator(this->config->activeSessions.iterator());
-            while (iterator->hasNext()) {
-                Pointer<ActiveMQSessionKernel> session = iterator->next();
-                if (session->isInUse(destination)) {
-                    this->config->sessionsLock.readLock().unlock();
-                    throw ActiveMQException(__FILE__, __LINE__, "A consumer is consuming from the temporary destination");
-                }
-            }
-            this->config->sessionsLock.readLock().unlock();
-        } catch (Exception& ex) {
-            this->config->sessionsLock.readLock().unlock();
-            throw;
+        if (isTempDestinationInUse(destination)) {
+            throw ActiveMQException(__FILE__, __LINE__, "A consumer is consuming from the temporary destination");
         }
 
         this->config->activeTempDestinations.remove(destination);
@@ -1870,8 +3264,12 @@ void ActiveMQConnection::deleteTempDestination(Pointer<ActiveMQTempDestination>
         command->setOperationType(ActiveMQConstants::DESTINATION_REMOVE_OPERATION);
         command->setDestination(Pointer<ActiveMQDestination>(destination->cloneDataStructure()));
 
-        // Send the message to the broker.
-        syncRequest(command);
+        // Send the message to the broker, without waiting for it to be done if so configured.
+        if (this->config->deleteTempDestinationsAsync) {
+            oneway(command);
+        } else {
+            syncRequest(command);
+        }
     }
     AMQ_CATCH_RETHROW(NullPointerException)
     AMQ_CATCH_RETHROW(decaf::lang::exceptions::IllegalStateException)
@@ -1887,23 +3285,217 @@ void ActiveMQConnection::cleanUpTempDestinations() {
         return;
     }
 
-    ArrayList< Pointer<ActiveMQTempDestination> > tempDests(this->config->activeTempDestinations.values());
-    Pointer<Iterator<Pointer<ActiveMQTempDestination> > > iterator(tempDests.iterator());
-    while (iterator->hasNext()) {
-        Pointer<ActiveMQTempDestination> dest = iterator->next();
+    try {
+        this->deleteTempDestinations(false);
+    } catch (Exception& ex) {
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::deleteTempDestinations(bool includeSpares) {
 
-        try {
-            // Only delete this temporary destination if it was created from this connection, since the
-            // advisory consumer tracks all temporary destinations there can be others in our mapping that
-            // this connection did not create.
-            std::string thisConnectionId =
-                    this->config->connectionInfo->getConnectionId() != NULL ? this->config->connectionInfo->getConnectionId()->toString() : "";
-            if (dest->getConnectionId() == thisConnectionId) {
-                this->deleteTempDestination(dest);
+    try {
+
+        std::vector< Pointer<ActiveMQTempDestination> > removed;
+
+        ArrayList< Pointer<ActiveMQTempDestination> > tempDests(this->config->activeTempDestinations.values());
+        Pointer<Iterator<Pointer<ActiveMQTempDestination> > > iterator(tempDests.iterator());
+
+        // Only delete the temporary destinations created from this connection, since the advisory
+        // consumer tracks all temporary destinations there can be others in our mapping that this
+        // connection did not create.
+        std::string thisConnectionId =
+                this->config->connectionInfo->getConnectionId() != NULL ? this->config->connectionInfo->getConnectionId()->toString() : "";
+
+        while (iterator->hasNext()) {
+            Pointer<ActiveMQTempDestination> dest = iterator->next();
+            if (dest->getConnectionId() == thisConnectionId && !isTempDestinationInUse(dest)) {
+                removed.push_back(dest);
+            }
+        }
+
+        if (includeSpares) {
+            synchronized(&this->config->tempDestinationLock) {
+                removed.insert(removed.end(), this->config->spareTempQueues.begin(), this->config->spareTempQueues.end());
+                removed.insert(removed.end(), this->config->spareTempTopics.begin(), this->config->spareTempTopics.end());
+                this->config->spareTempQueues.clear();
+                this->config->spareTempTopics.clear();
+            }
+        }
+
+        if (removed.empty()) {
+            return;
+        }
+
+        checkClosedOrFailed();
+
+        std::vector< Pointer<Command> > commands;
+        std::vector< Pointer<ActiveMQTempDestination> >::const_iterator dest = removed.begin();
+        for (; dest != removed.end(); ++dest) {
+            this->config->activeTempDestinations.remove(*dest);
+            commands.push_back(createTempDestinationInfo(*dest, ActiveMQConstants::DESTINATION_REMOVE_OPERATION));
+        }
+
+        // One round trip for all of them, the first refusal is reported once all are answered.
+        std::vector< Pointer<BrokerError> > errors = requestAll(commands);
+        std::vector< Pointer<BrokerError> >::const_iterator error = errors.begin();
+        for (; error != errors.end(); ++error) {
+            if (*error != NULL) {
+                throw (*error)->createExceptionObject();
             }
-        } catch (Exception& ex) {
         }
     }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQTempDestination* ActiveMQConnection::createTempDestination(cms::Destination::DestinationType type) {
+
+    try {
+
+        checkClosedOrFailed();
+        ensureConnectionInfoSent();
+
+        std::deque< Pointer<ActiveMQTempDestination> >& spares =
+            type == cms::Destination::TEMPORARY_TOPIC ? this->config->spareTempTopics : this->config->spareTempQueues;
+
+        Pointer<ActiveMQTempDestination> destination;
+        synchronized(&this->config->tempDestinationLock) {
+            if (!spares.empty()) {
+                destination = spares.front();
+                spares.pop_front();
+            }
+        }
+
+        if (destination == NULL) {
+            destination = registerTempDestinations(type);
+        }
+
+        // Now that its setup, link it to this Connection so it can be closed.
+        destination->setConnection(this);
+        this->addTempDestination(Pointer<ActiveMQTempDestination>(destination->cloneDataStructure()));
+
+        return destination->cloneDataStructure();
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTempDestination> ActiveMQConnection::registerTempDestinations(cms::Destination::DestinationType type) {
+
+    int batchSize = Math::max(1, this->config->tempDestinationBatchSize);
+
+    std::vector< Pointer<ActiveMQTempDestination> > destinations;
+    std::vector< Pointer<Command> > commands;
+
+    for (int i = 0; i < batchSize; ++i) {
+
+        std::string name = this->getConnectionId().getValue() + ":" + Long::toString(this->getNextTempDestinationId());
+
+        Pointer<ActiveMQTempDestination> destination;
+        if (type == cms::Destination::TEMPORARY_TOPIC) {
+            destination.reset(new ActiveMQTempTopic(name));
+        } else {
+            destination.reset(new ActiveMQTempQueue(name));
+        }
+
+        destinations.push_back(destination);
+        commands.push_back(createTempDestinationInfo(destination, ActiveMQConstants::DESTINATION_ADD_OPERATION));
+    }
+
+    if (batchSize == 1) {
+        this->syncRequest(commands.front());
+        return destinations.front();
+    }
+
+    // The batch costs one round trip, what is not handed out now is kept for later.
+    std::vector< Pointer<BrokerError> > errors = requestAll(commands);
+
+    std::deque< Pointer<ActiveMQTempDestination> >& spares =
+        type == cms::Destination::TEMPORARY_TOPIC ? this->config->spareTempTopics : this->config->spareTempQueues;
+
+    Pointer<ActiveMQTempDestination> result;
+    synchronized(&this->config->tempDestinationLock) {
+        for (std::size_t i = 0; i < destinations.size(); ++i) {
+            if (errors[i] != NULL) {
+                continue;
+            } else if (result == NULL) {
+                result = destinations[i];
+            } else {
+                spares.push_back(destinations[i]);
+            }
+        }
+    }
+
+    if (result == NULL) {
+        throw errors.front()->createExceptionObject();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Command> ActiveMQConnection::createTempDestinationInfo(Pointer<ActiveMQTempDestination> destination, int operation) const {
+
+    Pointer<DestinationInfo> command(new DestinationInfo());
+    command->setConnectionId(this->config->connectionInfo->getConnectionId());
+    command->setOperationType((unsigned char) operation);
+    command->setDestination(Pointer<ActiveMQDestination>(destination->cloneDataStructure()));
+
+    return command;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isTempDestinationInUse(Pointer<ActiveMQTempDestination> destination) {
+
+    this->config->sessionsLock.readLock().lock();
+    try {
+        Pointer<Iterator<Pointer<ActiveMQSessionKernel> > > iterator(this->config->activeSessions.iterator());
+        while (iterator->hasNext()) {
+            Pointer<ActiveMQSessionKernel> session = iterator->next();
+            if (session->isInUse(destination)) {
+                this->config->sessionsLock.readLock().unlock();
+                return true;
+            }
+        }
+        this->config->sessionsLock.readLock().unlock();
+    } catch (Exception& ex) {
+        this->config->sessionsLock.readLock().unlock();
+        throw;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector< Pointer<BrokerError> > ActiveMQConnection::requestAll(const std::vector< Pointer<Command> >& commands) {
+
+    Pointer<RequestGroup> group(new RequestGroup(commands.size()));
+
+    try {
+        for (std::size_t i = 0; i < commands.size(); ++i) {
+            group->sent();
+            try {
+                Pointer<ResponseCallback> callback(new RequestGroupCallback(group, i));
+                this->config->transport->asyncRequest(commands[i], callback);
+            } catch (Exception& ex) {
+                group->complete(i, Pointer<BrokerError>());
+                throw;
+            }
+        }
+    } catch (Exception& ex) {
+        // Those already written are answered, or failed along with the transport.
+        group->await();
+        throw;
+    }
+
+    group->await();
+
+    return group->errors;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1946,6 +3538,36 @@ void ActiveMQConnection::setAlwaysSessionAsync(bool alwaysSessionAsync) {
     this->config->alwaysSessionAsync = alwaysSessionAsync;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isDirectDispatch() const {
+    return this->config->directDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setDirectDispatch(bool directDispatch) {
+    this->config->directDispatch = directDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnection::getTempDestinationBatchSize() const {
+    return this->config->tempDestinationBatchSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setTempDestinationBatchSize(int tempDestinationBatchSize) {
+    this->config->tempDestinationBatchSize = tempDestinationBatchSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnection::isDeleteTempDestinationsAsync() const {
+    return this->config->deleteTempDestinationsAsync;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnection::setDeleteTempDestinationsAsync(bool deleteTempDestinationsAsync) {
+    this->config->deleteTempDestinationsAsync = deleteTempDestinationsAsync;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ActiveMQConnection::getProtocolVersion() const {
     return this->config->protocolVersion->get();
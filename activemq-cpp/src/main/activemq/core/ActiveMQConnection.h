@@ -21,7 +21,12 @@
 #include <cms/EnhancedConnection.h>
 #include <activemq/util/Config.h>
 #include <activemq/core/Dispatcher.h>
+#include <activemq/core/ConnectionMetrics.h>
+#include <activemq/util/CompressionCodec.h>
+#include <activemq/util/CompressionPool.h>
+#include <activemq/util/MessageTracer.h>
 #include <activemq/commands/ActiveMQTempDestination.h>
+#include <activemq/commands/BrokerError.h>
 #include <activemq/commands/ConnectionInfo.h>
 #include <activemq/commands/ConsumerInfo.h>
 #include <activemq/commands/SessionId.h>
@@ -29,6 +34,8 @@
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/threads/Scheduler.h>
+#include <activemq/threads/Task.h>
+#include <activemq/threads/TaskRunner.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <decaf/util/Properties.h>
@@ -41,6 +48,8 @@
 
 #include <string>
 #include <memory>
+#include <map>
+#include <vector>
 
 namespace activemq {
 namespace core {
@@ -49,8 +58,10 @@ namespace core {
 
     class ActiveMQSession;
     class ConnectionConfig;
+    class ConsumerPressureMonitor;
     class PrefetchPolicy;
     class RedeliveryPolicy;
+    class SubscriptionMultiplexer;
 
     /**
      * Concrete connection used for all connectors to the
@@ -493,6 +504,101 @@ namespace core {
          */
         int getCompressionLevel() const;
 
+        /**
+         * Returns the pool of zlib contexts that messages created by this connection use to
+         * compress and decompress their bodies, so that a context is reused from message to
+         * message rather than created for each one.
+         *
+         * @return the compression context pool of this connection.
+         */
+        util::CompressionPool& getCompressionPool() const;
+
+        /**
+         * @return the name of the codec used to compress Message bodies.
+         */
+        std::string getCompressionCodec() const;
+
+        /**
+         * Sets the codec used to compress Message bodies when compression is enabled, one of
+         * "zlib", the default, "lz4" or "zstd".  Only zlib compressed messages can be read
+         * by clients other than ActiveMQ-CPP, the others are marked with the codec's name in
+         * a message property.  When this build of the library lacks the requested codec zlib
+         * is used instead.
+         *
+         * @param value
+         *      The name of the compression codec.
+         *
+         * @throws IllegalArgumentException if the codec name is unknown.
+         */
+        void setCompressionCodec(const std::string& value);
+
+        /**
+         * @return a copy of the dictionary the lz4 and zstd codecs compress against.
+         */
+        std::vector<unsigned char> getCompressionDictionary() const;
+
+        /**
+         * Sets the dictionary that the lz4 and zstd codecs compress against, the receivers
+         * of the messages must be given the same dictionary.  An empty dictionary, the
+         * default, turns dictionary compression off.  This should be set before the
+         * Connection sends or receives any compressed message.
+         *
+         * @param value
+         *      The dictionary data, typically trained on sample message bodies.
+         */
+        void setCompressionDictionary(const std::vector<unsigned char>& value);
+
+        /**
+         * @return the size above which Message bodies are compressed in blocks, zero if
+         *         they never are.
+         */
+        int getCompressionBlockSize() const;
+
+        /**
+         * Sets the size above which Message bodies are split into blocks of that size that
+         * are compressed, and later decompressed, on several threads at once.  Such bodies
+         * are marked with the name of the block codec, see BlockCompressionCodec, so only
+         * ActiveMQ-CPP clients can read them.  Zero, the default, never splits bodies.
+         *
+         * @param value
+         *      The block size in bytes, or zero.
+         *
+         * @throws IllegalArgumentException if the value is negative.
+         */
+        void setCompressionBlockSize(int value);
+
+        /**
+         * @return true if block compressed BytesMessage bodies are decompressed a block at
+         *         a time as they are read.
+         */
+        bool isIncrementalDecompression() const;
+
+        /**
+         * Sets whether the reads of a BytesMessage whose body was compressed in blocks
+         * decompress one block at a time as they reach it, so that the memory used stays
+         * at one block whatever the size of the body, rather than decompressing the whole
+         * body on several threads when first read.  Bodies compressed whole with zlib are
+         * always inflated as they are read.  The default is false.
+         *
+         * @param value
+         *      True to decompress block compressed bodies as they are read.
+         */
+        void setIncrementalDecompression(bool value);
+
+        /**
+         * Returns this Connection's instance of the named codec, creating it on first use.
+         * The instance lives as long as the Connection does.
+         *
+         * @param name
+         *      The name of the codec.
+         *
+         * @return the codec.
+         *
+         * @throws IllegalArgumentException if the codec is not known.
+         * @throws UnsupportedOperationException if this build does not support the codec.
+         */
+        util::CompressionCodec& getCompressionCodecInstance(const std::string& name) const;
+
         /**
          * Gets the assigned send timeout for this Connector
          * @return the send timeout configured in the connection uri
@@ -535,6 +641,25 @@ namespace core {
          */
         void setProducerWindowSize(unsigned int windowSize);
 
+        /**
+         * @return the number of persistent sends each Producer created from this
+         *         Connection can have waiting for the broker, zero if sends block.
+         */
+        int getMaxPendingSends() const;
+
+        /**
+         * Sets the number of persistent sends each Producer created from this Connection
+         * can have waiting for their response from the broker.  When zero, the default,
+         * a persistent send blocks until the broker has stored the message, otherwise
+         * the sends are pipelined and a Producer only blocks once this many are waiting,
+         * every message is still confirmed by the broker and failures are thrown from a
+         * later call on the Producer.
+         *
+         * @param value
+         *      The number of pipelined sends per Producer, or zero to disable pipelining.
+         */
+        void setMaxPendingSends(int value);
+
         /**
          * @return true if the Connections that this factory creates should support the
          * message based priority settings.
@@ -550,6 +675,317 @@ namespace core {
          */
         void setMessagePrioritySupported(bool value);
 
+        /**
+         * @return true if the metrics snapshot of this Connection includes the memory
+         *         held by its subsystems.
+         */
+        bool isMemoryAccountingEnabled() const;
+
+        /**
+         * Sets whether getMetricsSnapshot reports the bytes held by the prefetch buffers,
+         * the delivered messages, the session dispatch queues, the failover state tracker,
+         * the audits and the compression codecs.  It is off by default, nothing is
+         * counted until a snapshot is taken.
+         *
+         * @param value
+         *      Boolean indicating if the snapshot includes the memory usage.
+         */
+        void setMemoryAccountingEnabled(bool value);
+
+        /**
+         * @return the bytes of waiting messages all the consumers of this Connection may
+         *         hold before they are suspended, zero or less if there is no budget.
+         */
+        long long getConsumerMemoryLimit() const;
+
+        /**
+         * Sets the bytes of messages waiting to be consumed that the consumers of this
+         * Connection may hold between them.  Once the budget is exceeded every consumer is
+         * suspended, the broker is sent a prefetch of zero for each so dispatch stops
+         * without blocking the sessions, and the consumers are resumed with their prefetch
+         * once the messages they hold have drained to half the budget.  Bursts that would
+         * otherwise fill the prefetch buffers of many consumers at once are held at the
+         * broker instead.  Zero, the default, sets no budget.
+         *
+         * @param value
+         *      The budget in bytes, zero or less for none.
+         */
+        void setConsumerMemoryLimit(long long value);
+
+        /**
+         * @return the bytes of messages the consumers of this Connection hold waiting to
+         *         be consumed, as last reported by each of them.
+         */
+        long long getConsumerMemoryUsage() const;
+
+        /**
+         * Sets the monitor asked whether the consumers of this Connection should be
+         * suspended, the connection does not take ownership.  The consumers are
+         * suspended while either the monitor reports pressure or the consumer memory
+         * budget is exceeded.
+         *
+         * @param monitor
+         *      The monitor to ask, or NULL for none.
+         */
+        void setConsumerPressureMonitor(ConsumerPressureMonitor* monitor);
+
+        /**
+         * @return the monitor asked whether the consumers should be suspended, or NULL.
+         */
+        ConsumerPressureMonitor* getConsumerPressureMonitor() const;
+
+        /**
+         * @return true if the consumers of this Connection are suspended because the
+         *         consumer memory budget was exceeded or the monitor reported pressure.
+         */
+        bool isConsumersSuspended() const;
+
+        /**
+         * Decides again whether the consumers of this Connection should be suspended,
+         * suspending or resuming them all on the Connection's executor if that changed.
+         * It is done as messages arrive and are consumed, an application whose pressure
+         * monitor no longer reports pressure calls it so that consumers with nothing left
+         * to consume resume.
+         */
+        void checkConsumerPressure();
+
+        /**
+         * Adds the change in the bytes a consumer holds waiting to be consumed to the
+         * consumer memory usage, then checks the pressure on the consumers.  A consumer
+         * created after the others were suspended is suspended along with them.
+         *
+         * @param consumer
+         *      The consumer whose usage changed, or NULL.
+         * @param delta
+         *      The bytes the consumer's usage grew by, negative if it shrank.
+         */
+        void updateConsumerMemoryUsage(kernels::ActiveMQConsumerKernel* consumer, long long delta);
+
+        /**
+         * @return true if this Connection writes the info commands that create its
+         *         consumers and producers without waiting for each response.
+         */
+        bool isPipelinedStartup() const;
+
+        /**
+         * Sets whether creating consumers and producers waits for the broker's response
+         * to each of their info commands.  When pipelined they are written back to back
+         * and their responses are collected by start() or awaitPipelinedStartup(), which
+         * close whatever the broker refused and throw its error.  The ConnectionInfo is
+         * pipelined too, only the wire format negotiation still waits for the broker.
+         *
+         * @param value
+         *      Boolean indicating if startup commands are pipelined.
+         */
+        void setPipelinedStartup(bool value);
+
+        /**
+         * @return true if consumers created from this Connection buffer their prefetched
+         *         messages in a ring buffer backed dispatch channel.
+         */
+        bool isUseRingDispatchChannel() const;
+
+        /**
+         * Sets whether consumers created from this Connection buffer their prefetched
+         * messages in a ring buffer sized to their prefetch instead of a linked list,
+         * this avoids an allocation per message.  Ignored when message priority is
+         * supported since priority ordering needs its own channel.
+         *
+         * @param value
+         *      Boolean indicating if the ring buffer dispatch channel should be used.
+         */
+        void setUseRingDispatchChannel(bool value);
+
+        /**
+         * @return true if the acks that a Session's consumers send while it dispatches a
+         *         round of messages are held and written together at the end of the round.
+         */
+        bool isAggregateSessionAcks() const;
+
+        /**
+         * Sets whether the asynchronous acks that the consumers of an AUTO_ACKNOWLEDGE or
+         * DUPS_OK_ACKNOWLEDGE Session send from its dispatch thread are held until the
+         * round of messages being dispatched is done, then written one after another and
+         * flushed once.  Without it each ack is its own write and flush.  Default is true.
+         *
+         * @param value
+         *      Boolean indicating if a Session's acks are aggregated.
+         */
+        void setAggregateSessionAcks(bool value);
+
+        /**
+         * @return true if MessageListeners of consumers created from this Connection are
+         *         handed the dispatched message itself instead of a copy of it.
+         */
+        bool isUseBorrowedMessages() const;
+
+        /**
+         * Sets whether MessageListeners of consumers created from this Connection are
+         * handed the dispatched message itself instead of a deep copy, which saves copying
+         * the body of every delivered message.
+         *
+         * A borrowed message is immutable, it is shared with the consumer which may
+         * deliver it again after a rollback, and it is only valid until onMessage returns.
+         * A listener that needs the message afterwards must clone it.  Consumers in
+         * INDIVIDUAL_ACKNOWLEDGE sessions, consumers with a MessageTransformer and
+         * synchronous receive calls are always given a copy.
+         *
+         * @param value
+         *      Boolean indicating if listeners should be handed borrowed messages.
+         */
+        void setUseBorrowedMessages(bool value);
+
+        /**
+         * @return true if consumers created from this Connection that subscribe to the
+         *         same topic with the same selector share one broker subscription.
+         */
+        bool isMultiplexTopicSubscriptions() const;
+
+        /**
+         * Sets whether consumers created from this Connection that subscribe to the same
+         * topic with the same selector and noLocal setting share one subscription on the
+         * broker, which then sends each message once for all of them instead of once per
+         * consumer.  Only consumers of AUTO_ACKNOWLEDGE and DUPS_OK_ACKNOWLEDGE sessions
+         * on topics without destination options share, durable subscribers never do.
+         *
+         * The broker sees one consumer, advisories and statistics count the subscription
+         * and not the consumers, and it holds back messages until the slowest of them has
+         * consumed enough to ack.  Consumers already created are not affected.
+         *
+         * @param value
+         *      Boolean indicating if topic subscriptions should be shared.
+         */
+        void setMultiplexTopicSubscriptions(bool value);
+
+        /**
+         * @return the number of threads the sessions of this Connection share to
+         *         dispatch their messages, zero when each session has its own thread.
+         */
+        int getSessionDispatchPoolSize() const;
+
+        /**
+         * Sets the number of threads the sessions of this Connection share to dispatch
+         * their messages.  When zero, the default, each session that dispatches
+         * asynchronously starts a thread of its own, otherwise the sessions are run as
+         * tasks on a pool of this many threads that is created with the first session
+         * that needs it.  Messages of a session are still dispatched in order.
+         *
+         * @param value
+         *      The number of dispatch threads, or zero for a thread per session.
+         */
+        void setSessionDispatchPoolSize(int value);
+
+        /**
+         * @return the number of threads that run the AsyncCallbacks of sends made on
+         *         this Connection, zero when they run on the transport's thread.
+         */
+        int getAsyncCallbackPoolSize() const;
+
+        /**
+         * Sets the number of threads that run the AsyncCallbacks of sends made on this
+         * Connection.  When zero, the default, each callback runs on the thread that
+         * reads the broker's response, so a slow callback holds up every response that
+         * follows it.  Otherwise the callbacks run on a pool of this many threads that is
+         * created with the first send that needs it, the callbacks of one producer still
+         * run one at a time in the order of the sends.
+         *
+         * @param value
+         *      The number of callback threads, or zero to run callbacks on the transport thread.
+         */
+        void setAsyncCallbackPoolSize(int value);
+
+        /**
+         * @return the number of threads each asynchronous consumer of an auto or dups ok
+         *         acknowledge session of this Connection delivers on, zero when the
+         *         session's thread delivers every message.
+         */
+        int getGroupDispatchLanes() const;
+
+        /**
+         * Sets the number of threads each asynchronous consumer of an auto or dups ok
+         * acknowledge session delivers its messages on.  When zero, the default, the
+         * session's dispatch thread calls the MessageListener for each message in turn.
+         * Otherwise the messages are spread over a pool of this many threads by their
+         * JMSXGroupID, so the listener is called for several groups at once while the
+         * messages of one group, and those without a group, are still delivered one at a
+         * time in order.  The MessageListener must then be thread safe.
+         *
+         * A consumer can override this with the consumer.groupDispatchLanes option of its
+         * destination.  Transacted, client and individual acknowledge sessions always
+         * deliver on the session's thread.
+         *
+         * @param value
+         *      The number of delivery threads per consumer, or zero for the session's thread.
+         */
+        void setGroupDispatchLanes(int value);
+
+        /**
+         * @return the number of threads the MessageListener of each individual acknowledge
+         *         consumer of this Connection is called from, zero for the session's thread.
+         */
+        int getParallelListenerThreads() const;
+
+        /**
+         * Sets the number of threads the MessageListener of each asynchronous consumer of
+         * an individual acknowledge session is called from.  When zero, the default, the
+         * session's dispatch thread calls the listener for each message in turn.
+         * Otherwise the messages of the consumer's prefetch are handed in turn to a pool
+         * of this many threads and the listener, which must be thread safe, consumes them
+         * in no particular order.
+         *
+         * The acks the listener makes are coalesced, those that complete a run of acked
+         * messages in dispatch order go to the broker as one ranged ack.  An ack that
+         * can't join a range yet is held back until it can, or until half the prefetch is
+         * held back, and is sent at the latest when the consumer closes.
+         *
+         * A consumer can override this with the consumer.parallelListenerThreads option
+         * of its destination.
+         *
+         * @param value
+         *      The number of listener threads per consumer, or zero for the session's thread.
+         */
+        void setParallelListenerThreads(int value);
+
+        /**
+         * @return the name of the policy used to place this Connection's threads.
+         */
+        std::string getThreadPlacement() const;
+
+        /**
+         * Sets the policy that places this Connection's threads, "none", the default,
+         * leaves them free to run on any processor.  With "core" or "node" the transport's
+         * reader threads, the session dispatch threads and the Connection's executor are
+         * all restricted to one core or to the processors of one NUMA node, successive
+         * Connections being spread over the cores or nodes of the machine.  This should
+         * be set before the Connection is started or has any sessions.
+         *
+         * @param value
+         *      The name of the placement policy, "none", "core" or "node".
+         *
+         * @throws IllegalArgumentException if the policy name is unknown.
+         */
+        void setThreadPlacement(const std::string& value);
+
+        /**
+         * @return the processors this Connection's threads are restricted to, empty when
+         *         they may run on any processor.
+         */
+        std::vector<int> getThreadAffinity() const;
+
+        /**
+         * Creates the TaskRunner a session of this Connection uses to dispatch its
+         * messages, either one with a thread of its own or one that runs the Task on
+         * this Connection's dispatch pool depending on the session dispatch pool size.
+         *
+         * @param task
+         *      The Task that is to be run, it must outlive the returned TaskRunner.
+         *
+         * @return a new TaskRunner for the given Task.
+         *
+         * @throws ActiveMQException if the runner can't be created.
+         */
+        Pointer<threads::TaskRunner> createSessionTaskRunner(threads::Task* task);
+
         /**
          * Get the Next Temporary Destination Id
          * @return the next id in the sequence.
@@ -745,6 +1181,65 @@ namespace core {
          */
         void setOptimizedAckScheduledAckInterval(long long optimizedAckScheduledAckInterval);
 
+        /**
+         * @return the most consumed messages an AUTO_ACKNOWLEDGE consumer coalesces into
+         *         a single acknowledgement, zero or one if every message is acked.
+         */
+        int getAckCoalesceCount() const;
+
+        /**
+         * Sets the most consumed messages that an AUTO_ACKNOWLEDGE consumer of this Connection
+         * acknowledges with a single range MessageAck.  While more prefetched messages
+         * are waiting to be consumed the acks are held back until this many have been
+         * consumed or the coalesce delay has passed, as soon as the consumer has nothing
+         * more to deliver the outstanding ack is sent so a quiet consumer acks every
+         * message right away.  The count is capped at half the consumer's prefetch so the
+         * broker never stops dispatching for want of an ack.  Zero, the default, sends an
+         * ack for each message.  Ignored for consumers using optimizeAcknowledge.
+         *
+         * @param value
+         *      The number of messages to coalesce, zero or one to ack every message.
+         */
+        void setAckCoalesceCount(int value);
+
+        /**
+         * @return the longest time in microseconds that an AUTO_ACKNOWLEDGE consumer holds
+         *         back a coalesced acknowledgement.
+         */
+        long long getAckCoalesceDelay() const;
+
+        /**
+         * Sets the longest time in microseconds that an AUTO_ACKNOWLEDGE consumer of this Connection
+         * holds back a coalesced acknowledgement, the time is measured from the first
+         * message it covers and is checked as messages are consumed.  Zero limits the
+         * acks only by the coalesce count.
+         *
+         * @param value
+         *      The time in microseconds to hold back a coalesced ack.
+         */
+        void setAckCoalesceDelay(long long value);
+
+        /**
+         * @return the time in microseconds that a transaction commit holds the transport's
+         *         flush open for the commits of other sessions, zero if commits aren't batched.
+         */
+        long long getCommitBatchWindow() const;
+
+        /**
+         * Sets the time in microseconds that a commit of one of this Connection's transacted
+         * sessions keeps the transport from flushing, so that the acks and commits other
+         * sessions write in the meantime leave in the same socket write and their answers
+         * come back together.  The first commit of a batch waits out the window before it
+         * flushes, the others join the open batch and wait only for their answer.  Anything
+         * else written during the window is held back with the batch.  Zero, the default,
+         * flushes each commit as soon as it is written.  Only transports that write
+         * through an IOTransport batch commits.
+         *
+         * @param value
+         *      The time in microseconds to hold a batch of commits open.
+         */
+        void setCommitBatchWindow(long long value);
+
         /**
          * Should all created consumers be retroactive.
          *
@@ -808,6 +1303,55 @@ namespace core {
          */
         void setAlwaysSessionAsync(bool alwaysSessionAsync);
 
+        /**
+         * @return Returns the directDispatch configuration setting.
+         */
+        bool isDirectDispatch() const;
+
+        /**
+         * When set the consumers of a Session that does not dispatch on its own thread are
+         * handed their messages straight from the transport thread, the Session and its
+         * executor are not passed through.  Only has an effect for Sessions created after
+         * it is set, and only when alwaysSessionAsync is false.  By default this value is
+         * false.
+         *
+         * @param directDispatch
+         *      The directDispatch value to use when creating new sessions.
+         */
+        void setDirectDispatch(bool directDispatch);
+
+        /**
+         * @return the number of temporary destinations registered with the broker at a time.
+         */
+        int getTempDestinationBatchSize() const;
+
+        /**
+         * Sets how many temporary destinations of a kind are registered with the broker when
+         * one is created and none are left over from before.  The registrations of a batch are
+         * written together and cost one round trip, the destinations not handed out right away
+         * are kept for the next temporary queues or topics created.  Those never used are
+         * removed from the broker when the connection closes.  By default this value is 1.
+         *
+         * @param tempDestinationBatchSize
+         *      The number of temporary destinations to register at a time.
+         */
+        void setTempDestinationBatchSize(int tempDestinationBatchSize);
+
+        /**
+         * @return true if deleting a temporary destination does not wait for the broker.
+         */
+        bool isDeleteTempDestinationsAsync() const;
+
+        /**
+         * When set deleting a temporary destination sends its removal to the broker without
+         * waiting for the broker to confirm it, a removal the broker refuses goes unreported.
+         * By default this value is false.
+         *
+         * @param deleteTempDestinationsAsync
+         *      True if temporary destinations are deleted without waiting for the broker.
+         */
+        void setDeleteTempDestinationsAsync(bool deleteTempDestinationsAsync);
+
         /**
          * @return true if the consumer will skip checking messages for expiration.
          */
@@ -963,6 +1507,49 @@ namespace core {
          */
         void asyncRequest(Pointer<commands::Command> command, cms::AsyncCallback* onComplete);
 
+        /**
+         * Sends one of the commands that set up the connection, its sessions, consumers
+         * and producers.  Without pipelined startup this is a syncRequest.  With it the
+         * command is written without waiting and its response is collected later, the
+         * next call to awaitPipelinedStartup reports the first error any of them got.
+         *
+         * @param command
+         *      The ConnectionInfo, ConsumerInfo or ProducerInfo to send.
+         *
+         * @throws BrokerException if the response is an error, only when not pipelined.
+         * @throws ActiveMQException if any other error occurs while sending the Command.
+         */
+        void startupRequest(Pointer<commands::Command> command);
+
+        /**
+         * Waits for the responses to every command sent with startupRequest so far.  The
+         * consumers and producers whose info the broker refused are closed, after which
+         * the first error received is thrown.  Does nothing without pipelined startup.
+         * Called by start(), a connection started before its consumers and producers
+         * are created calls it itself once they are.
+         *
+         * @throws BrokerException if the broker refused any of the commands.
+         * @throws ActiveMQException if the connection failed before all responses came.
+         */
+        void awaitPipelinedStartup();
+
+        /**
+         * Opens the write of a transaction commit and the acks that precede it, until
+         * endCommitWrite is called the transport leaves what is written unflushed.
+         *
+         * @return true if this call opened the write and must close it with endCommitWrite,
+         *         false if the commit joined a write that is already open.
+         */
+        bool beginCommitWrite();
+
+        /**
+         * Closes a commit write opened by beginCommitWrite, waiting out what is left of the
+         * commit batch window before the transport is flushed.
+         *
+         * @throws ActiveMQException if the flush fails.
+         */
+        void endCommitWrite();
+
         /**
          * Notify the exception listener
          * @param ex the exception to fire
@@ -1040,6 +1627,20 @@ namespace core {
          */
         void addTempDestination(Pointer<commands::ActiveMQTempDestination> destination);
 
+        /**
+         * Creates a temporary destination that is registered with the Broker and tracked by
+         * this Connection, registering a batch of them if none are left from the last batch.
+         *
+         * @param type
+         *      Either TEMPORARY_QUEUE or TEMPORARY_TOPIC.
+         *
+         * @return a new temporary destination owned by the caller.
+         *
+         * @throws ActiveMQException if the Broker refuses the destination or the Connection
+         *         has failed.
+         */
+        commands::ActiveMQTempDestination* createTempDestination(cms::Destination::DestinationType type);
+
         /**
          * Removes the given Temporary Destination to this Connections collection of known
          * Temporary Destinations.
@@ -1084,6 +1685,67 @@ namespace core {
          */
         decaf::util::ArrayList< Pointer<activemq::core::kernels::ActiveMQSessionKernel> > getSessions() const;
 
+        /**
+         * Returns the metrics that this connection and its sessions, producers and consumers
+         * record into.  They are always collected and can be read or reset at any time.
+         *
+         * @return the metrics of this connection.
+         */
+        ConnectionMetrics& getMetrics() const;
+
+        /**
+         * @return the SubscriptionMultiplexer that holds the topic subscriptions shared by
+         *         the consumers of this connection.
+         */
+        SubscriptionMultiplexer& getSubscriptionMultiplexer() const;
+
+        /**
+         * Returns the current value of every metric of this connection, along with the
+         * counters of the transport that is currently connected to the broker under the
+         * transport.commandsSent, transport.commandsReceived, transport.bytesSent and
+         * transport.bytesReceived names.  The transport counters start again at zero each
+         * time the connection reconnects.
+         *
+         * When memory accounting is enabled the map also holds the bytes currently held
+         * by the connection's subsystems: memory.prefetch for the messages waiting in the
+         * consumers' prefetch buffers, memory.delivered for the delivered messages not yet
+         * acknowledged, memory.dispatchQueue for the messages queued in the sessions'
+         * executors, memory.stateTracker for the messages the failover state tracker
+         * holds for replay, memory.audit for the duplicate detection audits,
+         * memory.compression for the state of the compression codecs and memory.total for
+         * their sum.  The values are read from the sizes each subsystem already keeps when
+         * the snapshot is taken, they are close estimates rather than exact heap counts.
+         *
+         * @return a map of metric names to their current values.
+         */
+        std::map<std::string, long long> getMetricsSnapshot() const;
+
+        /**
+         * Sets the tracer that is notified as messages sent and received by this
+         * connection pass each trace point, the connection does not take ownership.  The
+         * tracer is also handed to the transport that is connected to the broker, and to
+         * each transport connected after a reconnect.
+         *
+         * @param tracer
+         *      The tracer to notify, or NULL to stop tracing.
+         */
+        void setMessageTracer(util::MessageTracer* tracer);
+
+        /**
+         * @return the tracer notified as messages pass each trace point, or NULL if none is set.
+         */
+        util::MessageTracer* getMessageTracer() const;
+
+        /**
+         * Notifies the tracer, if one is set, that the command has passed the given point.
+         *
+         * @param point
+         *      The trace point that was passed.
+         * @param command
+         *      The command that passed it.
+         */
+        void trace(util::MessageTracer::TracePoint point, const commands::Command& command) const;
+
     protected:
 
         /**
@@ -1109,6 +1771,31 @@ namespace core {
         // Process the ControlCommand command
         void onControlCommand(Pointer<commands::Command> command);
 
+        // Closes the consumer or producer the failed startup command created.
+        void closeFailedStartup(Pointer<commands::Command> command, decaf::lang::Exception& error);
+
+        // Writes the commands without waiting on each and then waits for all their responses,
+        // the errors are returned by position with NULL for those that succeeded.
+        std::vector< Pointer<commands::BrokerError> > requestAll(const std::vector< Pointer<commands::Command> >& commands);
+
+        // Registers a batch of temporary destinations of the given type, returning the first
+        // the broker accepted and keeping the rest as spares.
+        Pointer<commands::ActiveMQTempDestination> registerTempDestinations(cms::Destination::DestinationType type);
+
+        // Removes the temporary destinations this connection created and that are not in use
+        // from the broker with one round trip, along with the spares if asked to.
+        void deleteTempDestinations(bool includeSpares);
+
+        // Creates the DestinationInfo that adds or removes the given temporary destination.
+        Pointer<commands::Command> createTempDestinationInfo(Pointer<commands::ActiveMQTempDestination> destination,
+                                                             int operation) const;
+
+        // Checks whether a consumer of any session consumes from the destination.
+        bool isTempDestinationInUse(Pointer<commands::ActiveMQTempDestination> destination);
+
+        // Adds the memory.* entries of the metrics snapshot to the given map.
+        void collectMemoryUsage(std::map<std::string, long long>& values) const;
+
         // Process the ConnectionControl command
         void onConnectionControl(Pointer<commands::Command> command);
 
@@ -26,7 +26,10 @@
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Math.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/internal/io/MappedFile.h>
 #include <activemq/exceptions/ExceptionDefines.h>
+#include <activemq/threads/ThreadPlacement.h>
 #include <activemq/transport/TransportRegistry.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/core/ActiveMQConstants.h>
@@ -35,7 +38,10 @@
 #include <activemq/core/policies/DefaultRedeliveryPolicy.h>
 #include <activemq/util/URISupport.h>
 #include <activemq/util/CompositeData.h>
+#include <activemq/util/CompressionCodec.h>
+#include <map>
 #include <memory>
+#include <vector>
 
 using namespace std;
 using namespace activemq;
@@ -43,6 +49,7 @@ using namespace activemq::util;
 using namespace activemq::core;
 using namespace activemq::core::policies;
 using namespace activemq::exceptions;
+using namespace activemq::threads;
 using namespace activemq::transport;
 using namespace decaf;
 using namespace decaf::net;
@@ -68,6 +75,8 @@ namespace core{
 
         Mutex configLock;
 
+        // The options of the broker URI, shared with every factory that uses the same
+        // URI and never modified.
         Pointer<Properties> properties;
 
         std::string username;
@@ -81,6 +90,17 @@ namespace core{
         bool useAsyncSend;
         bool sendAcksAsync;
         bool messagePrioritySupported;
+        bool memoryAccountingEnabled;
+        bool pipelinedStartup;
+        bool useRingDispatchChannel;
+        bool aggregateSessionAcks;
+        bool useBorrowedMessages;
+        bool multiplexTopicSubscriptions;
+        int sessionDispatchPoolSize;
+        int asyncCallbackPoolSize;
+        int groupDispatchLanes;
+        int parallelListenerThreads;
+        std::string threadPlacement;
         bool useCompression;
         bool useRetroactiveConsumer;
         bool watchTopicAdvisories;
@@ -90,18 +110,31 @@ namespace core{
         bool transactedIndividualAck;
         bool nonBlockingRedelivery;
         bool alwaysSessionAsync;
+        bool directDispatch;
+        int tempDestinationBatchSize;
+        bool deleteTempDestinationsAsync;
         int compressionLevel;
+        std::string compressionCodec;
+        std::string compressionDictionaryFile;
+        int compressionBlockSize;
+        bool incrementalDecompression;
         unsigned int sendTimeout;
         unsigned int closeTimeout;
         unsigned int producerWindowSize;
+        int maxPendingSends;
         int auditDepth;
         int auditMaximumProducerNumber;
         long long optimizeAcknowledgeTimeOut;
         long long optimizedAckScheduledAckInterval;
+        int ackCoalesceCount;
+        long long ackCoalesceDelay;
+        long long commitBatchWindow;
         long long consumerFailoverRedeliveryWaitPeriod;
         bool consumerExpiryCheckEnabled;
+        long long consumerMemoryLimit;
 
         cms::ExceptionListener* defaultListener;
+        ConsumerPressureMonitor* defaultPressureMonitor;
         cms::MessageTransformer* defaultTransformer;
         std::auto_ptr<PrefetchPolicy> defaultPrefetchPolicy;
         std::auto_ptr<RedeliveryPolicy> defaultRedeliveryPolicy;
@@ -117,6 +150,17 @@ namespace core{
                             useAsyncSend(false),
                             sendAcksAsync(true),
                             messagePrioritySupported(false),
+                            memoryAccountingEnabled(false),
+                            pipelinedStartup(false),
+                            useRingDispatchChannel(false),
+                            aggregateSessionAcks(true),
+                            useBorrowedMessages(false),
+                            multiplexTopicSubscriptions(false),
+                            sessionDispatchPoolSize(0),
+                            asyncCallbackPoolSize(0),
+                            groupDispatchLanes(0),
+                            parallelListenerThreads(0),
+                            threadPlacement("none"),
                             useCompression(false),
                             useRetroactiveConsumer(false),
                             watchTopicAdvisories(true),
@@ -126,26 +170,101 @@ namespace core{
                             transactedIndividualAck(false),
                             nonBlockingRedelivery(false),
                             alwaysSessionAsync(true),
+                            directDispatch(false),
+                            tempDestinationBatchSize(1),
+                            deleteTempDestinationsAsync(false),
                             compressionLevel(-1),
+                            compressionCodec(CompressionCodec::ZLIB),
+                            compressionDictionaryFile(),
+                            compressionBlockSize(0),
+                            incrementalDecompression(false),
                             sendTimeout(0),
                             closeTimeout(15000),
                             producerWindowSize(0),
+                            maxPendingSends(0),
                             auditDepth(ActiveMQMessageAudit::DEFAULT_WINDOW_SIZE),
                             auditMaximumProducerNumber(ActiveMQMessageAudit::MAXIMUM_PRODUCER_COUNT),
                             optimizeAcknowledgeTimeOut(300),
                             optimizedAckScheduledAckInterval(0),
+                            ackCoalesceCount(0),
+                            ackCoalesceDelay(1000),
+                            commitBatchWindow(0),
                             consumerFailoverRedeliveryWaitPeriod(0),
                             consumerExpiryCheckEnabled(true),
+                            consumerMemoryLimit(0),
                             defaultListener(NULL),
+                            defaultPressureMonitor(NULL),
                             defaultTransformer(NULL),
                             defaultPrefetchPolicy(new DefaultPrefetchPolicy()),
                             defaultRedeliveryPolicy(new DefaultRedeliveryPolicy()) {
         }
 
-        void updateConfiguration(const URI& uri) {
+        void updateConfiguration(const URI& uri);
 
-            this->brokerURI = uri;
-            this->properties->clear();
+        static URI createURI(const std::string& uriString) {
+            try {
+                return URI(uriString);
+            } catch (URISyntaxException& ex) {
+                throw cms::CMSException("Invalid Connection Uri detected.");
+            }
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // One option given in a broker URI, its value already converted and the setting
+    // that it is assigned to.
+    struct OptionBinding {
+
+        bool FactorySettings::* boolSetting;
+        int FactorySettings::* intSetting;
+        unsigned int FactorySettings::* unsignedSetting;
+        long long FactorySettings::* longSetting;
+        std::string FactorySettings::* stringSetting;
+
+        bool boolValue;
+        long long numberValue;
+        std::string stringValue;
+
+        OptionBinding() : boolSetting(NULL), intSetting(NULL), unsignedSetting(NULL), longSetting(NULL),
+                          stringSetting(NULL), boolValue(false), numberValue(0), stringValue() {}
+
+        void apply(FactorySettings& settings) const {
+            if (boolSetting != NULL) {
+                settings.*boolSetting = boolValue;
+            } else if (intSetting != NULL) {
+                settings.*intSetting = (int) numberValue;
+            } else if (unsignedSetting != NULL) {
+                settings.*unsignedSetting = (unsigned int) numberValue;
+            } else if (longSetting != NULL) {
+                settings.*longSetting = numberValue;
+            } else if (stringSetting != NULL) {
+                settings.*stringSetting = stringValue;
+            }
+        }
+    };
+
+    // The options of one broker URI, parsed and converted once.  Creating a connection
+    // only assigns the options the URI actually gives, without looking any of them up
+    // by name.  Instances are shared through the cache and never modified.
+    class CompiledOptions {
+    private:
+
+        CompiledOptions(const CompiledOptions&);
+        CompiledOptions& operator=(const CompiledOptions&);
+
+    public:
+
+        Pointer<Properties> properties;
+
+        std::vector<OptionBinding> bindings;
+
+    public:
+
+        CompiledOptions(const URI& uri) : properties(new Properties()), bindings() {
 
             if (uri.getQuery() != "") {
                 // Not a composite URI so this works fine.
@@ -162,83 +281,195 @@ namespace core{
                 }
             }
 
+            if (this->properties->isEmpty()) {
+                return;
+            }
+
             // Check the connection options
-            this->alwaysSyncSend = Boolean::parseBoolean(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_ALWAYSSYNCSEND), Boolean::toString(alwaysSyncSend)));
-            this->useAsyncSend = Boolean::parseBoolean(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_USEASYNCSEND), Boolean::toString(useAsyncSend)));
-            this->useCompression = Boolean::parseBoolean(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_USECOMPRESSION), Boolean::toString(useCompression)));
-            this->compressionLevel = Integer::parseInt(
-                properties->getProperty("connection.compressionLevel", Integer::toString(compressionLevel)));
-            this->messagePrioritySupported = Boolean::parseBoolean(
-                properties->getProperty("connection.messagePrioritySupported", Boolean::toString(messagePrioritySupported)));
-            this->checkForDuplicates = Boolean::parseBoolean(
-                properties->getProperty("connection.checkForDuplicates", Boolean::toString(checkForDuplicates)));
-            this->auditDepth = Integer::parseInt(
-                properties->getProperty("connection.auditDepth", Integer::toString(auditDepth)));
-            this->auditMaximumProducerNumber = Integer::parseInt(
-                properties->getProperty("connection.auditMaximumProducerNumber", Integer::toString(auditMaximumProducerNumber)));
-            this->dispatchAsync = Boolean::parseBoolean(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_DISPATCHASYNC), Boolean::toString(dispatchAsync)));
-            this->producerWindowSize = Integer::parseInt(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_PRODUCERWINDOWSIZE), Integer::toString(producerWindowSize)));
-            this->sendTimeout = decaf::lang::Integer::parseInt(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_SENDTIMEOUT), Integer::toString(sendTimeout)));
-            this->closeTimeout = decaf::lang::Integer::parseInt(
-                properties->getProperty(core::ActiveMQConstants::toString(
-                    core::ActiveMQConstants::CONNECTION_CLOSETIMEOUT), Integer::toString(closeTimeout)));
-            this->clientId = properties->getProperty(
-                core::ActiveMQConstants::toString(core::ActiveMQConstants::PARAM_CLIENTID), clientId);
-            this->username = properties->getProperty(
-                core::ActiveMQConstants::toString(core::ActiveMQConstants::PARAM_USERNAME), username);
-            this->password = properties->getProperty(
-                core::ActiveMQConstants::toString(core::ActiveMQConstants::PARAM_PASSWORD), password);
-            this->optimizeAcknowledge = Boolean::parseBoolean(
-                properties->getProperty("connection.optimizeAcknowledge", Boolean::toString(optimizeAcknowledge)));
-            this->exclusiveConsumer = Boolean::parseBoolean(
-                properties->getProperty("connection.exclusiveConsumer", Boolean::toString(exclusiveConsumer)));
-            this->transactedIndividualAck = Boolean::parseBoolean(
-                properties->getProperty("connection.transactedIndividualAck", Boolean::toString(transactedIndividualAck)));
-            this->useRetroactiveConsumer = Boolean::parseBoolean(
-                properties->getProperty("connection.useRetroactiveConsumer", Boolean::toString(useRetroactiveConsumer)));
-            this->sendAcksAsync = Boolean::parseBoolean(
-                properties->getProperty("connection.sendAcksAsync", Boolean::toString(sendAcksAsync)));
-            this->optimizeAcknowledgeTimeOut = Long::parseLong(
-                properties->getProperty("connection.optimizeAcknowledgeTimeOut", Long::toString(optimizeAcknowledgeTimeOut)));
-            this->optimizedAckScheduledAckInterval = Long::parseLong(
-                properties->getProperty("connection.optimizedAckScheduledAckInterval", Long::toString(optimizedAckScheduledAckInterval)));
-            this->consumerFailoverRedeliveryWaitPeriod = Long::parseLong(
-                properties->getProperty("connection.consumerFailoverRedeliveryWaitPeriod", Long::toString(consumerFailoverRedeliveryWaitPeriod)));
-            this->nonBlockingRedelivery = Boolean::parseBoolean(
-                properties->getProperty("connection.nonBlockingRedelivery", Boolean::toString(nonBlockingRedelivery)));
-            this->watchTopicAdvisories = Boolean::parseBoolean(
-                properties->getProperty("connection.watchTopicAdvisories", Boolean::toString(watchTopicAdvisories)));
-            this->alwaysSessionAsync = Boolean::parseBoolean(
-                properties->getProperty("connection.alwaysSessionAsync", Boolean::toString(alwaysSessionAsync)));
-            this->consumerExpiryCheckEnabled = Boolean::parseBoolean(
-                properties->getProperty("connection.consumerExpiryCheckEnabled", Boolean::toString(consumerExpiryCheckEnabled)));
-
-            this->defaultPrefetchPolicy->configure(*properties);
-            this->defaultRedeliveryPolicy->configure(*properties);
+            bindBoolean(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_ALWAYSSYNCSEND), &FactorySettings::alwaysSyncSend);
+            bindBoolean(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_USEASYNCSEND), &FactorySettings::useAsyncSend);
+            bindBoolean(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_USECOMPRESSION), &FactorySettings::useCompression);
+            bindInteger("connection.compressionLevel", &FactorySettings::compressionLevel);
+            bindString("connection.compressionCodec", &FactorySettings::compressionCodec);
+            bindString("connection.compressionDictionaryFile", &FactorySettings::compressionDictionaryFile);
+            bindInteger("connection.compressionBlockSize", &FactorySettings::compressionBlockSize);
+            bindBoolean("connection.incrementalDecompression", &FactorySettings::incrementalDecompression);
+            bindBoolean("connection.messagePrioritySupported", &FactorySettings::messagePrioritySupported);
+            bindBoolean("connection.memoryAccountingEnabled", &FactorySettings::memoryAccountingEnabled);
+            bindBoolean("connection.pipelinedStartup", &FactorySettings::pipelinedStartup);
+            bindBoolean("connection.useRingDispatchChannel", &FactorySettings::useRingDispatchChannel);
+            bindBoolean("connection.aggregateSessionAcks", &FactorySettings::aggregateSessionAcks);
+            bindBoolean("connection.useBorrowedMessages", &FactorySettings::useBorrowedMessages);
+            bindBoolean("connection.multiplexTopicSubscriptions", &FactorySettings::multiplexTopicSubscriptions);
+            bindInteger("connection.sessionDispatchPoolSize", &FactorySettings::sessionDispatchPoolSize);
+            bindInteger("connection.asyncCallbackPoolSize", &FactorySettings::asyncCallbackPoolSize);
+            bindInteger("connection.groupDispatchLanes", &FactorySettings::groupDispatchLanes);
+            bindInteger("connection.parallelListenerThreads", &FactorySettings::parallelListenerThreads);
+            bindString("connection.threadPlacement", &FactorySettings::threadPlacement);
+            bindBoolean("connection.checkForDuplicates", &FactorySettings::checkForDuplicates);
+            bindInteger("connection.auditDepth", &FactorySettings::auditDepth);
+            bindInteger("connection.auditMaximumProducerNumber", &FactorySettings::auditMaximumProducerNumber);
+            bindBoolean(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_DISPATCHASYNC), &FactorySettings::dispatchAsync);
+            bindUnsigned(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_PRODUCERWINDOWSIZE), &FactorySettings::producerWindowSize);
+            bindInteger("connection.maxPendingSends", &FactorySettings::maxPendingSends);
+            bindUnsigned(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_SENDTIMEOUT), &FactorySettings::sendTimeout);
+            bindUnsigned(ActiveMQConstants::toString(ActiveMQConstants::CONNECTION_CLOSETIMEOUT), &FactorySettings::closeTimeout);
+            bindString(ActiveMQConstants::toString(ActiveMQConstants::PARAM_CLIENTID), &FactorySettings::clientId);
+            bindString(ActiveMQConstants::toString(ActiveMQConstants::PARAM_USERNAME), &FactorySettings::username);
+            bindString(ActiveMQConstants::toString(ActiveMQConstants::PARAM_PASSWORD), &FactorySettings::password);
+            bindBoolean("connection.optimizeAcknowledge", &FactorySettings::optimizeAcknowledge);
+            bindBoolean("connection.exclusiveConsumer", &FactorySettings::exclusiveConsumer);
+            bindBoolean("connection.transactedIndividualAck", &FactorySettings::transactedIndividualAck);
+            bindBoolean("connection.useRetroactiveConsumer", &FactorySettings::useRetroactiveConsumer);
+            bindBoolean("connection.sendAcksAsync", &FactorySettings::sendAcksAsync);
+            bindLong("connection.optimizeAcknowledgeTimeOut", &FactorySettings::optimizeAcknowledgeTimeOut);
+            bindLong("connection.optimizedAckScheduledAckInterval", &FactorySettings::optimizedAckScheduledAckInterval);
+            bindInteger("connection.ackCoalesceCount", &FactorySettings::ackCoalesceCount);
+            bindLong("connection.ackCoalesceDelay", &FactorySettings::ackCoalesceDelay);
+            bindLong("connection.commitBatchWindow", &FactorySettings::commitBatchWindow);
+            bindLong("connection.consumerFailoverRedeliveryWaitPeriod", &FactorySettings::consumerFailoverRedeliveryWaitPeriod);
+            bindLong("connection.consumerMemoryLimit", &FactorySettings::consumerMemoryLimit);
+            bindBoolean("connection.nonBlockingRedelivery", &FactorySettings::nonBlockingRedelivery);
+            bindBoolean("connection.watchTopicAdvisories", &FactorySettings::watchTopicAdvisories);
+            bindBoolean("connection.alwaysSessionAsync", &FactorySettings::alwaysSessionAsync);
+            bindBoolean("connection.directDispatch", &FactorySettings::directDispatch);
+            bindInteger("connection.tempDestinationBatchSize", &FactorySettings::tempDestinationBatchSize);
+            bindBoolean("connection.deleteTempDestinationsAsync", &FactorySettings::deleteTempDestinationsAsync);
+            bindBoolean("connection.consumerExpiryCheckEnabled", &FactorySettings::consumerExpiryCheckEnabled);
         }
 
-        static URI createURI(const std::string& uriString) {
-            try {
-                return URI(uriString);
-            } catch (URISyntaxException& ex) {
-                throw cms::CMSException("Invalid Connection Uri detected.");
+    private:
+
+        void bindBoolean(const std::string& name, bool FactorySettings::* setting) {
+            if (this->properties->hasProperty(name)) {
+                OptionBinding binding;
+                binding.boolSetting = setting;
+                binding.boolValue = Boolean::parseBoolean(this->properties->getProperty(name));
+                this->bindings.push_back(binding);
+            }
+        }
+
+        void bindInteger(const std::string& name, int FactorySettings::* setting) {
+            if (this->properties->hasProperty(name)) {
+                OptionBinding binding;
+                binding.intSetting = setting;
+                binding.numberValue = Integer::parseInt(this->properties->getProperty(name));
+                this->bindings.push_back(binding);
+            }
+        }
+
+        void bindUnsigned(const std::string& name, unsigned int FactorySettings::* setting) {
+            if (this->properties->hasProperty(name)) {
+                OptionBinding binding;
+                binding.unsignedSetting = setting;
+                binding.numberValue = (unsigned int) Integer::parseInt(this->properties->getProperty(name));
+                this->bindings.push_back(binding);
+            }
+        }
+
+        void bindLong(const std::string& name, long long FactorySettings::* setting) {
+            if (this->properties->hasProperty(name)) {
+                OptionBinding binding;
+                binding.longSetting = setting;
+                binding.numberValue = Long::parseLong(this->properties->getProperty(name));
+                this->bindings.push_back(binding);
+            }
+        }
+
+        void bindString(const std::string& name, std::string FactorySettings::* setting) {
+            if (this->properties->hasProperty(name)) {
+                OptionBinding binding;
+                binding.stringSetting = setting;
+                binding.stringValue = this->properties->getProperty(name);
+                this->bindings.push_back(binding);
             }
         }
     };
 
-}}
+    // Number of URIs the cache holds before it starts over.
+    const std::size_t MAX_COMPILED_URIS = 64;
+
+    // The compiled options of the broker URIs in use, shared by every factory in the
+    // process.  A service that creates a factory and a connection per request uses the
+    // same few URIs over and over, it pays for parsing each of them once.
+    class CompiledOptionsCache {
+    private:
+
+        CompiledOptionsCache(const CompiledOptionsCache&);
+        CompiledOptionsCache& operator=(const CompiledOptionsCache&);
+
+    private:
+
+        Mutex mutex;
+
+        std::map<std::string, Pointer<CompiledOptions> > entries;
+
+    public:
+
+        CompiledOptionsCache() : mutex(), entries() {}
+
+        Pointer<CompiledOptions> get(const URI& uri) {
+
+            std::string key = uri.toString();
+
+            synchronized(&mutex) {
+                std::map<std::string, Pointer<CompiledOptions> >::const_iterator found = entries.find(key);
+                if (found != entries.end()) {
+                    return found->second;
+                }
+            }
+
+            // Compiled outside the lock, a URI with a malformed option throws here and
+            // is never cached.
+            Pointer<CompiledOptions> compiled(new CompiledOptions(uri));
+
+            synchronized(&mutex) {
+                if (entries.size() >= MAX_COMPILED_URIS) {
+                    entries.clear();
+                }
+                entries[key] = compiled;
+            }
+
+            return compiled;
+        }
+    };
+
+    CompiledOptionsCache* optionsCache = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FactorySettings::updateConfiguration(const URI& uri) {
+
+    Pointer<CompiledOptions> options;
+    if (optionsCache != NULL) {
+        options = optionsCache->get(uri);
+    } else {
+        options.reset(new CompiledOptions(uri));
+    }
+
+    this->brokerURI = uri;
+    this->properties = options->properties;
+
+    std::vector<OptionBinding>::const_iterator binding = options->bindings.begin();
+    for (; binding != options->bindings.end(); ++binding) {
+        binding->apply(*this);
+    }
+
+    this->defaultPrefetchPolicy->configure(*properties);
+    this->defaultRedeliveryPolicy->configure(*properties);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::initialize() {
+    optionsCache = new CompiledOptionsCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::shutdown() {
+    CompiledOptionsCache* old = optionsCache;
+    optionsCache = NULL;
+    delete old;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 cms::ConnectionFactory* cms::ConnectionFactory::createCMSConnectionFactory(const std::string& brokerURI) {
@@ -400,12 +631,32 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setUseAsyncSend(this->settings->useAsyncSend);
     connection->setUseCompression(this->settings->useCompression);
     connection->setCompressionLevel(this->settings->compressionLevel);
+    connection->setCompressionCodec(this->settings->compressionCodec);
+    if (!this->settings->compressionDictionaryFile.empty()) {
+        decaf::internal::io::MappedFile dictionary(this->settings->compressionDictionaryFile);
+        connection->setCompressionDictionary(std::vector<unsigned char>(
+            dictionary.getAddress(), dictionary.getAddress() + dictionary.getSize()));
+    }
+    connection->setCompressionBlockSize(this->settings->compressionBlockSize);
+    connection->setIncrementalDecompression(this->settings->incrementalDecompression);
     connection->setSendTimeout(this->settings->sendTimeout);
     connection->setCloseTimeout(this->settings->closeTimeout);
     connection->setProducerWindowSize(this->settings->producerWindowSize);
+    connection->setMaxPendingSends(this->settings->maxPendingSends);
     connection->setPrefetchPolicy(this->settings->defaultPrefetchPolicy->clone());
     connection->setRedeliveryPolicy(this->settings->defaultRedeliveryPolicy->clone());
     connection->setMessagePrioritySupported(this->settings->messagePrioritySupported);
+    connection->setMemoryAccountingEnabled(this->settings->memoryAccountingEnabled);
+    connection->setPipelinedStartup(this->settings->pipelinedStartup);
+    connection->setUseRingDispatchChannel(this->settings->useRingDispatchChannel);
+    connection->setAggregateSessionAcks(this->settings->aggregateSessionAcks);
+    connection->setUseBorrowedMessages(this->settings->useBorrowedMessages);
+    connection->setMultiplexTopicSubscriptions(this->settings->multiplexTopicSubscriptions);
+    connection->setSessionDispatchPoolSize(this->settings->sessionDispatchPoolSize);
+    connection->setAsyncCallbackPoolSize(this->settings->asyncCallbackPoolSize);
+    connection->setGroupDispatchLanes(this->settings->groupDispatchLanes);
+    connection->setParallelListenerThreads(this->settings->parallelListenerThreads);
+    connection->setThreadPlacement(this->settings->threadPlacement);
     connection->setWatchTopicAdvisories(this->settings->watchTopicAdvisories);
     connection->setCheckForDuplicates(this->settings->checkForDuplicates);
     connection->setAuditDepth(this->settings->auditDepth);
@@ -413,6 +664,9 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setOptimizeAcknowledge(this->settings->optimizeAcknowledge);
     connection->setOptimizeAcknowledgeTimeOut(this->settings->optimizeAcknowledgeTimeOut);
     connection->setOptimizedAckScheduledAckInterval(this->settings->optimizedAckScheduledAckInterval);
+    connection->setAckCoalesceCount(this->settings->ackCoalesceCount);
+    connection->setAckCoalesceDelay(this->settings->ackCoalesceDelay);
+    connection->setCommitBatchWindow(this->settings->commitBatchWindow);
     connection->setSendAcksAsync(this->settings->sendAcksAsync);
     connection->setExclusiveConsumer(this->settings->exclusiveConsumer);
     connection->setTransactedIndividualAck(this->settings->transactedIndividualAck);
@@ -420,12 +674,20 @@ void ActiveMQConnectionFactory::configureConnection(ActiveMQConnection* connecti
     connection->setNonBlockingRedelivery(this->settings->nonBlockingRedelivery);
     connection->setConsumerFailoverRedeliveryWaitPeriod(this->settings->consumerFailoverRedeliveryWaitPeriod);
     connection->setAlwaysSessionAsync(this->settings->alwaysSessionAsync);
+    connection->setDirectDispatch(this->settings->directDispatch);
+    connection->setTempDestinationBatchSize(this->settings->tempDestinationBatchSize);
+    connection->setDeleteTempDestinationsAsync(this->settings->deleteTempDestinationsAsync);
     connection->setConsumerExpiryCheckEnabled(this->settings->consumerExpiryCheckEnabled);
+    connection->setConsumerMemoryLimit(this->settings->consumerMemoryLimit);
 
     if (this->settings->defaultListener) {
         connection->setExceptionListener(this->settings->defaultListener);
     }
 
+    if (this->settings->defaultPressureMonitor) {
+        connection->setConsumerPressureMonitor(this->settings->defaultPressureMonitor);
+    }
+
     if (this->settings->defaultTransformer) {
         connection->setMessageTransformer(this->settings->defaultTransformer);
     }
@@ -583,6 +845,56 @@ void ActiveMQConnectionFactory::setCompressionLevel(int value) {
     this->settings->compressionLevel = Math::min(value, 9);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnectionFactory::getCompressionCodec() const {
+    return this->settings->compressionCodec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCompressionCodec(const std::string& value) {
+
+    if (!CompressionCodec::isKnown(value)) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Unknown compression codec: %s", value.c_str());
+    }
+
+    this->settings->compressionCodec = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnectionFactory::getCompressionDictionaryFile() const {
+    return this->settings->compressionDictionaryFile;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCompressionDictionaryFile(const std::string& value) {
+    this->settings->compressionDictionaryFile = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getCompressionBlockSize() const {
+    return this->settings->compressionBlockSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCompressionBlockSize(int value) {
+
+    if (value < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression block size cannot be negative: %d", value);
+    }
+
+    this->settings->compressionBlockSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isIncrementalDecompression() const {
+    return this->settings->incrementalDecompression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setIncrementalDecompression(bool value) {
+    this->settings->incrementalDecompression = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int ActiveMQConnectionFactory::getSendTimeout() const {
     return this->settings->sendTimeout;
@@ -613,6 +925,16 @@ void ActiveMQConnectionFactory::setProducerWindowSize(unsigned int windowSize) {
     this->settings->producerWindowSize = windowSize;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getMaxPendingSends() const {
+    return this->settings->maxPendingSends;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setMaxPendingSends(int value) {
+    this->settings->maxPendingSends = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isMessagePrioritySupported() const {
     return this->settings->messagePrioritySupported;
@@ -623,6 +945,116 @@ void ActiveMQConnectionFactory::setMessagePrioritySupported(bool value) {
     this->settings->messagePrioritySupported = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isMemoryAccountingEnabled() const {
+    return this->settings->memoryAccountingEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setMemoryAccountingEnabled(bool value) {
+    this->settings->memoryAccountingEnabled = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isPipelinedStartup() const {
+    return this->settings->pipelinedStartup;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setPipelinedStartup(bool value) {
+    this->settings->pipelinedStartup = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isUseRingDispatchChannel() const {
+    return this->settings->useRingDispatchChannel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setUseRingDispatchChannel(bool value) {
+    this->settings->useRingDispatchChannel = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isAggregateSessionAcks() const {
+    return this->settings->aggregateSessionAcks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setAggregateSessionAcks(bool value) {
+    this->settings->aggregateSessionAcks = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isUseBorrowedMessages() const {
+    return this->settings->useBorrowedMessages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setUseBorrowedMessages(bool value) {
+    this->settings->useBorrowedMessages = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isMultiplexTopicSubscriptions() const {
+    return this->settings->multiplexTopicSubscriptions;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setMultiplexTopicSubscriptions(bool value) {
+    this->settings->multiplexTopicSubscriptions = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ActiveMQConnectionFactory::getThreadPlacement() const {
+    return this->settings->threadPlacement;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setThreadPlacement(const std::string& value) {
+    this->settings->threadPlacement = ThreadPlacement::toString(ThreadPlacement::parse(value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getSessionDispatchPoolSize() const {
+    return this->settings->sessionDispatchPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setSessionDispatchPoolSize(int value) {
+    this->settings->sessionDispatchPoolSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getAsyncCallbackPoolSize() const {
+    return this->settings->asyncCallbackPoolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setAsyncCallbackPoolSize(int value) {
+    this->settings->asyncCallbackPoolSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getGroupDispatchLanes() const {
+    return this->settings->groupDispatchLanes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setGroupDispatchLanes(int value) {
+    this->settings->groupDispatchLanes = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getParallelListenerThreads() const {
+    return this->settings->parallelListenerThreads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setParallelListenerThreads(int value) {
+    this->settings->parallelListenerThreads = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isWatchTopicAdvisories() const {
     return this->settings->watchTopicAdvisories;
@@ -713,6 +1145,56 @@ void ActiveMQConnectionFactory::setOptimizedAckScheduledAckInterval(long long op
     this->settings->optimizedAckScheduledAckInterval = optimizedAckScheduledAckInterval;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getAckCoalesceCount() const {
+    return this->settings->ackCoalesceCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setAckCoalesceCount(int value) {
+    this->settings->ackCoalesceCount = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getAckCoalesceDelay() const {
+    return this->settings->ackCoalesceDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setAckCoalesceDelay(long long value) {
+    this->settings->ackCoalesceDelay = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getConsumerMemoryLimit() const {
+    return this->settings->consumerMemoryLimit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setConsumerMemoryLimit(long long value) {
+    this->settings->consumerMemoryLimit = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConsumerPressureMonitor* ActiveMQConnectionFactory::getConsumerPressureMonitor() const {
+    return this->settings->defaultPressureMonitor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setConsumerPressureMonitor(ConsumerPressureMonitor* monitor) {
+    this->settings->defaultPressureMonitor = monitor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConnectionFactory::getCommitBatchWindow() const {
+    return this->settings->commitBatchWindow;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setCommitBatchWindow(long long value) {
+    this->settings->commitBatchWindow = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long ActiveMQConnectionFactory::getConsumerFailoverRedeliveryWaitPeriod() const {
     return this->settings->consumerFailoverRedeliveryWaitPeriod;
@@ -753,6 +1235,36 @@ void ActiveMQConnectionFactory::setAlwaysSessionAsync(bool alwaysSessionAsync) {
     this->settings->alwaysSessionAsync = alwaysSessionAsync;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isDirectDispatch() const {
+    return this->settings->directDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setDirectDispatch(bool directDispatch) {
+    this->settings->directDispatch = directDispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConnectionFactory::getTempDestinationBatchSize() const {
+    return this->settings->tempDestinationBatchSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setTempDestinationBatchSize(int tempDestinationBatchSize) {
+    this->settings->tempDestinationBatchSize = tempDestinationBatchSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConnectionFactory::isDeleteTempDestinationsAsync() const {
+    return this->settings->deleteTempDestinationsAsync;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactory::setDeleteTempDestinationsAsync(bool deleteTempDestinationsAsync) {
+    this->settings->deleteTempDestinationsAsync = deleteTempDestinationsAsync;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConnectionFactory::isConsumerExpiryCheckEnabled() {
     return this->settings->consumerExpiryCheckEnabled;
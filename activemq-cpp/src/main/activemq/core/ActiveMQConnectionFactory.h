@@ -28,11 +28,15 @@
 #include <decaf/util/Properties.h>
 
 namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
 namespace core {
 
     using decaf::lang::Pointer;
 
     class ActiveMQConnection;
+    class ConsumerPressureMonitor;
     class FactorySettings;
     class PrefetchPolicy;
     class RedeliveryPolicy;
@@ -367,6 +371,72 @@ namespace core {
          */
         int getCompressionLevel() const;
 
+        /**
+         * @return the name of the codec that created Connections compress Message bodies with.
+         */
+        std::string getCompressionCodec() const;
+
+        /**
+         * Sets the codec that created Connections compress Message bodies with when
+         * compression is enabled, one of "zlib", the default, "lz4" or "zstd".  Connections
+         * fall back to zlib when this build of the library lacks the requested codec, see
+         * ActiveMQConnection::setCompressionCodec.
+         *
+         * @param value
+         *      The name of the compression codec.
+         *
+         * @throws IllegalArgumentException if the codec name is unknown.
+         */
+        void setCompressionCodec(const std::string& value);
+
+        /**
+         * @return the path of the file holding the compression dictionary, empty if none.
+         */
+        std::string getCompressionDictionaryFile() const;
+
+        /**
+         * Sets the path of a file whose contents created Connections use as the dictionary
+         * of the lz4 and zstd codecs, such as one trained with "zstd --train".  The file is
+         * read each time a Connection is created, an empty path means no dictionary.
+         *
+         * @param value
+         *      The path of the dictionary file.
+         */
+        void setCompressionDictionaryFile(const std::string& value);
+
+        /**
+         * @return the size above which created Connections compress Message bodies in blocks.
+         */
+        int getCompressionBlockSize() const;
+
+        /**
+         * Sets the size above which created Connections split Message bodies into blocks
+         * that are compressed on several threads at once, zero, the default, never splits
+         * them.  See ActiveMQConnection::setCompressionBlockSize.
+         *
+         * @param value
+         *      The block size in bytes, or zero.
+         *
+         * @throws IllegalArgumentException if the value is negative.
+         */
+        void setCompressionBlockSize(int value);
+
+        /**
+         * @return true if created Connections decompress block compressed BytesMessage
+         *         bodies a block at a time as they are read.
+         */
+        bool isIncrementalDecompression() const;
+
+        /**
+         * Sets whether created Connections decompress block compressed BytesMessage bodies
+         * a block at a time as they are read.  See
+         * ActiveMQConnection::setIncrementalDecompression.
+         *
+         * @param value
+         *      True to decompress block compressed bodies as they are read.
+         */
+        void setIncrementalDecompression(bool value);
+
         /**
          * Gets the assigned send timeout for this Connector
          * @return the send timeout configured in the connection uri
@@ -409,6 +479,23 @@ namespace core {
          */
         void setProducerWindowSize(unsigned int windowSize);
 
+        /**
+         * @return the number of persistent sends each Producer of the Connections this
+         *         factory creates can have waiting for the broker, zero if sends block.
+         */
+        int getMaxPendingSends() const;
+
+        /**
+         * Sets the number of persistent sends each Producer of the Connections this
+         * factory creates can have waiting for their response from the broker, zero,
+         * the default, makes every persistent send block until the broker has stored
+         * the message.
+         *
+         * @param value
+         *      The number of pipelined sends per Producer, or zero to disable pipelining.
+         */
+        void setMaxPendingSends(int value);
+
         /**
          * @return true if the Connections that this factory creates should support the
          * message based priority settings.
@@ -424,6 +511,191 @@ namespace core {
          */
         void setMessagePrioritySupported(bool value);
 
+        /**
+         * @return true if the Connections that this factory creates report the memory held
+         *         by their subsystems in their metrics snapshot.
+         */
+        bool isMemoryAccountingEnabled() const;
+
+        /**
+         * Sets whether the Connections that this factory creates report the memory held by
+         * their subsystems in their metrics snapshot.
+         *
+         * @param value
+         *      Boolean indicating if memory accounting should be enabled.
+         */
+        void setMemoryAccountingEnabled(bool value);
+
+        /**
+         * @return true if the Connections that this factory creates pipeline the commands
+         *         that create their consumers and producers.
+         */
+        bool isPipelinedStartup() const;
+
+        /**
+         * Sets whether the Connections that this factory creates write the commands that
+         * create their consumers and producers without waiting for each response, the
+         * responses are collected when the connection is started.
+         *
+         * @param value
+         *      Boolean indicating if startup commands are pipelined.
+         */
+        void setPipelinedStartup(bool value);
+
+        /**
+         * @return true if the Connections that this factory creates have their consumers
+         *         buffer prefetched messages in a ring buffer backed dispatch channel.
+         */
+        bool isUseRingDispatchChannel() const;
+
+        /**
+         * Sets whether the Connections that this factory creates have their consumers
+         * buffer prefetched messages in a ring buffer sized to their prefetch instead
+         * of a linked list.
+         *
+         * @param value
+         *      Boolean indicating if the ring buffer dispatch channel should be used.
+         */
+        void setUseRingDispatchChannel(bool value);
+
+        /**
+         * @return true if the Connections that this factory creates have their Sessions
+         *         write the acks of a dispatch round together.
+         */
+        bool isAggregateSessionAcks() const;
+
+        /**
+         * Sets whether the Connections that this factory creates have their Sessions hold
+         * the asynchronous acks sent while a round of messages is dispatched and write
+         * them together, flushed once, when the round is done.
+         *
+         * @param value
+         *      Boolean indicating if a Session's acks are aggregated.
+         */
+        void setAggregateSessionAcks(bool value);
+
+        /**
+         * @return true if the Connections that this factory creates hand their consumers'
+         *         MessageListeners the dispatched message instead of a copy of it.
+         */
+        bool isUseBorrowedMessages() const;
+
+        /**
+         * Sets whether the Connections that this factory creates hand their consumers'
+         * MessageListeners the dispatched message, immutable and only valid until
+         * onMessage returns, instead of a copy of it.
+         *
+         * @param value
+         *      Boolean indicating if listeners should be handed borrowed messages.
+         *
+         * @see ActiveMQConnection::setUseBorrowedMessages
+         */
+        void setUseBorrowedMessages(bool value);
+
+        /**
+         * @return true if the consumers of the Connections that this factory creates share
+         *         a broker subscription when they subscribe to the same topic.
+         */
+        bool isMultiplexTopicSubscriptions() const;
+
+        /**
+         * Sets whether the consumers of the Connections that this factory creates that
+         * subscribe to the same topic with the same selector share one broker subscription.
+         *
+         * @param value
+         *      Boolean indicating if topic subscriptions should be shared.
+         *
+         * @see ActiveMQConnection::setMultiplexTopicSubscriptions
+         */
+        void setMultiplexTopicSubscriptions(bool value);
+
+        /**
+         * @return the number of threads the sessions of each Connection this factory
+         *         creates share to dispatch their messages, zero for a thread per session.
+         */
+        int getSessionDispatchPoolSize() const;
+
+        /**
+         * Sets the number of threads the sessions of each Connection this factory creates
+         * share to dispatch their messages, zero, the default, gives every session that
+         * dispatches asynchronously a thread of its own.
+         *
+         * @param value
+         *      The number of dispatch threads per Connection, or zero for a thread per session.
+         */
+        void setSessionDispatchPoolSize(int value);
+
+        /**
+         * @return the number of threads that run the AsyncCallbacks of sends on each
+         *         Connection this factory creates, zero for the transport's thread.
+         */
+        int getAsyncCallbackPoolSize() const;
+
+        /**
+         * Sets the number of threads that run the AsyncCallbacks of sends on each
+         * Connection this factory creates, zero, the default, runs them on the thread
+         * that reads the broker's responses.
+         *
+         * @param value
+         *      The number of callback threads per Connection, or zero for the transport thread.
+         *
+         * @see ActiveMQConnection::setAsyncCallbackPoolSize
+         */
+        void setAsyncCallbackPoolSize(int value);
+
+        /**
+         * @return the number of threads each asynchronous consumer of the Connections
+         *         this factory creates delivers on, zero for the session's thread.
+         */
+        int getGroupDispatchLanes() const;
+
+        /**
+         * Sets the number of threads each asynchronous consumer of an auto or dups ok
+         * acknowledge session delivers on, spread by message group.  Zero, the default,
+         * delivers every message on the session's thread.
+         *
+         * @param value
+         *      The number of delivery threads per consumer, or zero for the session's thread.
+         *
+         * @see ActiveMQConnection::setGroupDispatchLanes
+         */
+        void setGroupDispatchLanes(int value);
+
+        /**
+         * @return the number of threads the MessageListener of each individual acknowledge
+         *         consumer of the Connections this factory creates is called from.
+         */
+        int getParallelListenerThreads() const;
+
+        /**
+         * Sets the number of threads the MessageListener of each asynchronous consumer of
+         * an individual acknowledge session is called from, zero, the default, calls it
+         * from the session's thread.
+         *
+         * @param value
+         *      The number of listener threads per consumer, or zero for the session's thread.
+         *
+         * @see ActiveMQConnection::setParallelListenerThreads
+         */
+        void setParallelListenerThreads(int value);
+
+        /**
+         * @return the name of the policy used to place the threads of each Connection
+         *         this factory creates.
+         */
+        std::string getThreadPlacement() const;
+
+        /**
+         * Sets the policy used to place the threads of each Connection this factory
+         * creates, see ActiveMQConnection::setThreadPlacement.
+         *
+         * @param value
+         *      The name of the placement policy, "none", "core" or "node".
+         *
+         * @throws IllegalArgumentException if the policy name is unknown.
+         */
+        void setThreadPlacement(const std::string& value);
+
         /**
          * Should all created consumers be retroactive.
          *
@@ -640,6 +912,96 @@ namespace core {
          */
         void setOptimizedAckScheduledAckInterval(long long optimizedAckScheduledAckInterval);
 
+        /**
+         * @return the most consumed messages an AUTO_ACKNOWLEDGE consumer of the Connections
+         *         this factory creates coalesces into
+         *         a single acknowledgement, zero or one if every message is acked.
+         */
+        int getAckCoalesceCount() const;
+
+        /**
+         * Sets the most consumed messages that an AUTO_ACKNOWLEDGE consumer of the Connections this factory creates
+         * acknowledges with a single range MessageAck.  While more prefetched messages
+         * are waiting to be consumed the acks are held back until this many have been
+         * consumed or the coalesce delay has passed, as soon as the consumer has nothing
+         * more to deliver the outstanding ack is sent so a quiet consumer acks every
+         * message right away.  The count is capped at half the consumer's prefetch so the
+         * broker never stops dispatching for want of an ack.  Zero, the default, sends an
+         * ack for each message.  Ignored for consumers using optimizeAcknowledge.
+         *
+         * @param value
+         *      The number of messages to coalesce, zero or one to ack every message.
+         */
+        void setAckCoalesceCount(int value);
+
+        /**
+         * @return the longest time in microseconds that an AUTO_ACKNOWLEDGE consumer holds
+         *         back a coalesced acknowledgement.
+         */
+        long long getAckCoalesceDelay() const;
+
+        /**
+         * Sets the longest time in microseconds that an AUTO_ACKNOWLEDGE consumer of the Connections this factory creates
+         * holds back a coalesced acknowledgement, the time is measured from the first
+         * message it covers and is checked as messages are consumed.  Zero limits the
+         * acks only by the coalesce count.
+         *
+         * @param value
+         *      The time in microseconds to hold back a coalesced ack.
+         */
+        void setAckCoalesceDelay(long long value);
+
+        /**
+         * @return the bytes of waiting messages the consumers of each Connection this
+         *         factory creates may hold before they are suspended, zero for no budget.
+         */
+        long long getConsumerMemoryLimit() const;
+
+        /**
+         * Sets the bytes of messages waiting to be consumed that the consumers of each
+         * Connection this factory creates may hold between them before the broker is told
+         * to stop dispatching to them, see ActiveMQConnection::setConsumerMemoryLimit.
+         *
+         * @param value
+         *      The budget in bytes, zero or less for none.
+         */
+        void setConsumerMemoryLimit(long long value);
+
+        /**
+         * @return the monitor set on each new Connection to decide when its consumers are
+         *         suspended, or NULL if not set.
+         */
+        ConsumerPressureMonitor* getConsumerPressureMonitor() const;
+
+        /**
+         * Sets the monitor asked whether the consumers of each Connection this factory
+         * creates should be suspended, see ActiveMQConnection::setConsumerPressureMonitor.
+         * The factory does not take ownership, the monitor must outlive the connections.
+         *
+         * @param monitor
+         *      The monitor to set on each new Connection, or NULL for none.
+         */
+        void setConsumerPressureMonitor(ConsumerPressureMonitor* monitor);
+
+        /**
+         * @return the time in microseconds that a commit holds the transport's flush open
+         *         for the commits of other sessions, zero if commits aren't batched.
+         */
+        long long getCommitBatchWindow() const;
+
+        /**
+         * Sets the time in microseconds that a commit of a transacted session of the Connections
+         * this factory creates holds the transport's flush open, so the commits other sessions
+         * of the Connection write in the meantime share its socket write.  Zero, the default,
+         * flushes each commit as soon as it is written.
+         *
+         * @param value
+         *      The time in microseconds to hold a batch of commits open.
+         *
+         * @see ActiveMQConnection::setCommitBatchWindow
+         */
+        void setCommitBatchWindow(long long value);
+
         /**
          * Returns the current value of the always session async option.
          *
@@ -658,6 +1020,51 @@ namespace core {
          */
         void setAlwaysSessionAsync(bool alwaysSessionAsync);
 
+        /**
+         * Returns the current value of the direct dispatch option.
+         *
+         * @return Returns the directDispatch configuration setting.
+         */
+        bool isDirectDispatch() const;
+
+        /**
+         * When set 'true' the consumers of a Session that dispatches on the transport thread,
+         * see setAlwaysSessionAsync, are handed their messages straight from that thread with
+         * no pass through the Session or its executor.  By default this value is false.
+         *
+         * @param directDispatch
+         *      The directDispatch value to use when creating new connections.
+         */
+        void setDirectDispatch(bool directDispatch);
+
+        /**
+         * @return the number of temporary destinations new connections register at a time.
+         */
+        int getTempDestinationBatchSize() const;
+
+        /**
+         * Sets how many temporary destinations of a kind a connection registers with the broker
+         * in one round trip when it has none left over, see ActiveMQConnection.
+         *
+         * @param tempDestinationBatchSize
+         *      The number of temporary destinations to register at a time, 1 by default.
+         */
+        void setTempDestinationBatchSize(int tempDestinationBatchSize);
+
+        /**
+         * @return true if new connections delete temporary destinations without waiting.
+         */
+        bool isDeleteTempDestinationsAsync() const;
+
+        /**
+         * Sets whether new connections send the removal of a deleted temporary destination
+         * without waiting for the broker to confirm it.
+         *
+         * @param deleteTempDestinationsAsync
+         *      True if temporary destinations are deleted asynchronously, false by default.
+         */
+        void setDeleteTempDestinationsAsync(bool deleteTempDestinationsAsync);
+
         /**
          * @return true if the consumer will skip checking messages for expiration.
          */
@@ -717,6 +1124,14 @@ namespace core {
 
         void configureConnection(ActiveMQConnection* connection);
 
+    private:
+
+        static void initialize();
+
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
     };
 
 }}
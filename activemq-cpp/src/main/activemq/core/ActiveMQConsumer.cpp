@@ -149,6 +149,24 @@ cms::Message* ActiveMQConsumer::receiveNoWait() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumer::receive(std::vector<cms::Message*>& messages, int max, int millisecs) {
+
+    try {
+        return this->config->kernel->receive(messages, max, millisecs);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::receiveAsync(ReceiveCallback* callback, int millisecs) {
+
+    try {
+        this->config->kernel->receiveAsync(callback, millisecs);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumer::setMessageListener(cms::MessageListener* listener) {
 
@@ -218,6 +236,31 @@ void ActiveMQConsumer::setOptimizedAckScheduledAckInterval(long long value) {
     this->config->kernel->setOptimizedAckScheduledAckInterval(value);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::setPrefetchMemoryLimit(long long value) {
+    this->config->kernel->setPrefetchMemoryLimit(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumer::getPrefetchMemoryLimit() const {
+    return this->config->kernel->getPrefetchMemoryLimit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::setPullBatchSize(int value) {
+    this->config->kernel->setPullBatchSize(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumer::getPullBatchSize() const {
+    return this->config->kernel->getPullBatchSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumer::getTunedPrefetchSize() const {
+    return this->config->kernel->getTunedPrefetchSize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConsumer::isOptimizeAcknowledge() const {
     return this->config->kernel->isOptimizeAcknowledge();
@@ -227,3 +270,23 @@ bool ActiveMQConsumer::isOptimizeAcknowledge() const {
 void ActiveMQConsumer::setOptimizeAcknowledge(bool value) {
     this->config->kernel->setOptimizeAcknowledge(value);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumer::getAckCoalesceCount() const {
+    return this->config->kernel->getAckCoalesceCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::setAckCoalesceCount(int value) {
+    this->config->kernel->setAckCoalesceCount(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumer::getAckCoalesceDelay() const {
+    return this->config->kernel->getAckCoalesceDelay();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumer::setAckCoalesceDelay(long long value) {
+    this->config->kernel->setAckCoalesceDelay(value);
+}
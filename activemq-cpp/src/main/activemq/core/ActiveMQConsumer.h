@@ -25,6 +25,7 @@
 #include <activemq/util/Config.h>
 #include <activemq/core/kernels/ActiveMQConsumerKernel.h>
 #include <activemq/commands/ConsumerInfo.h>
+#include <activemq/core/ReceiveCallback.h>
 #include <activemq/core/RedeliveryPolicy.h>
 
 #include <decaf/lang/Pointer.h>
@@ -157,6 +158,81 @@ namespace core {
          */
         void setOptimizedAckScheduledAckInterval(long long value);
 
+        /**
+         * Sets the maximum number of bytes of prefetched messages this consumer holds
+         * before the broker is told to stop dispatching to it.
+         *
+         * @param value
+         *      The prefetch memory limit in bytes, zero or less disables it.
+         */
+        void setPrefetchMemoryLimit(long long value);
+
+        /**
+         * @return the prefetch memory limit in bytes, zero or less if there is no limit.
+         */
+        long long getPrefetchMemoryLimit() const;
+
+        /**
+         * Sets the number of messages this consumer pulls at once when its prefetch is
+         * zero, so each round trip to the broker can bring a small window of messages.
+         *
+         * @param value
+         *      The number of messages pulled at once, one or less pulls one at a time.
+         */
+        void setPullBatchSize(int value);
+
+        /**
+         * @return the number of messages this consumer pulls at once with a zero prefetch.
+         */
+        int getPullBatchSize() const;
+
+        /**
+         * @return the prefetch this consumer asked the broker for after tuning it to the
+         *         rate messages are processed at, or the configured prefetch when the
+         *         prefetch isn't tuned.
+         */
+        int getTunedPrefetchSize() const;
+
+        /**
+         * Synchronously receives up to max messages at once.  The call waits for the first
+         * message as receive(int) would, then takes whatever else is already prefetched
+         * without waiting, locking the prefetch buffer once and updating the ack window
+         * once for the whole batch.
+         *
+         * @param messages
+         *      The vector the received messages are appended to, the caller owns them and
+         *      must delete them.
+         * @param max
+         *      The maximum number of messages to receive, must be at least one.
+         * @param millisecs
+         *      The time to wait for the first message, zero waits indefinitely and a
+         *      negative value doesn't wait at all.
+         *
+         * @return the number of messages appended to the vector, zero if none arrived in time.
+         *
+         * @throws CMSException if max is less than one or an internal error occurs.
+         */
+        int receive(std::vector<cms::Message*>& messages, int max, int millisecs);
+
+        /**
+         * Receives the next message without waiting for it.  The callback is called with
+         * the message once one is available, or with NULL if none arrives within the given
+         * time or the consumer is closed first, so a thread is not tied up for each receive
+         * that is outstanding.  Outstanding receives are completed in the order they were
+         * made.
+         *
+         * @param callback
+         *      The callback to complete the receive with, it must stay valid until it has
+         *      been called.
+         * @param millisecs
+         *      The time to wait for a message, zero waits indefinitely and a negative
+         *      value completes the receive at once if no message is prefetched.
+         *
+         * @throws CMSException if the consumer is closed, has a MessageListener or the
+         *         callback is NULL.
+         */
+        void receiveAsync(ReceiveCallback* callback, int millisecs);
+
         /**
          * @return true if this consumer is using optimize acknowledge mode.
          */
@@ -170,6 +246,38 @@ namespace core {
          */
         void setOptimizeAcknowledge(bool value);
 
+        /**
+         * @return the most consumed messages this consumer acknowledges with a single
+         *         MessageAck, zero or one if every message is acked on its own.
+         */
+        int getAckCoalesceCount() const;
+
+        /**
+         * Sets the most consumed messages this consumer acknowledges with a single range
+         * MessageAck when it auto acknowledges, the ack is sent early when there are no
+         * more messages waiting to be consumed or the coalesce delay has passed.
+         *
+         * @see ActiveMQConnection::setAckCoalesceCount
+         *
+         * @param value
+         *      The number of messages to coalesce, zero or one to ack every message.
+         */
+        void setAckCoalesceCount(int value);
+
+        /**
+         * @return the longest time in microseconds a coalesced ack is held back.
+         */
+        long long getAckCoalesceDelay() const;
+
+        /**
+         * Sets the longest time in microseconds this consumer holds back a coalesced ack,
+         * zero limits the acks only by the coalesce count.
+         *
+         * @param value
+         *      The time in microseconds to hold back a coalesced ack.
+         */
+        void setAckCoalesceDelay(long long value);
+
     };
 
 }}
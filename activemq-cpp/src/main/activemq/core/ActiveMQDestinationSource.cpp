@@ -25,11 +25,12 @@
 
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
-#include <decaf/util/HashSet.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
 #include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQDestinationEvent.h>
 #include <activemq/util/AdvisorySupport.h>
 #include <activemq/commands/ActiveMQDestination.h>
@@ -39,6 +40,10 @@
 #include <activemq/commands/ActiveMQTempQueue.h>
 #include <activemq/commands/DestinationInfo.h>
 
+#include <set>
+#include <string>
+#include <vector>
+
 using namespace cms;
 using namespace activemq;
 using namespace activemq::util;
@@ -67,17 +72,24 @@ namespace core {
         ActiveMQConnection* connection;
         Pointer<Session> session;
 
+        // The session as its own type, to learn whether more advisories are waiting.
+        ActiveMQSession* amqSession;
+
         Pointer<MessageConsumer> topicConsumer;
         Pointer<MessageConsumer> queueConsumer;
         Pointer<MessageConsumer> tempTopicConsumer;
         Pointer<MessageConsumer> tempQueueConsumer;
 
-        HashSet< Pointer<ActiveMQDestination> > queues;
-        HashSet< Pointer<ActiveMQDestination> > topics;
-        HashSet< Pointer<ActiveMQDestination> > tempQueues;
-        HashSet< Pointer<ActiveMQDestination> > tempTopics;
+        // The physical names of the known destinations by destination type, the
+        // destinations themselves are only built when asked for.
+        std::set<std::string> names[4];
+        std::vector<std::string> filters;
+        Mutex stateLock;
 
         DestinationListener* listener;
+        ActiveMQDestinationSource::BatchListener* batchListener;
+        int maxBatchSize;
+        std::vector< Pointer<ActiveMQDestinationEvent> > batch;
         Mutex listenerLock;
 
     public:
@@ -85,11 +97,18 @@ namespace core {
         DestinationSourceImpl() : started(false),
                                   connection(),
                                   session(),
+                                  amqSession(NULL),
                                   topicConsumer(),
                                   queueConsumer(),
                                   tempTopicConsumer(),
                                   tempQueueConsumer(),
+                                  names(),
+                                  filters(),
+                                  stateLock(),
                                   listener(),
+                                  batchListener(NULL),
+                                  maxBatchSize(1),
+                                  batch(),
                                   listenerLock() {
 
         }
@@ -104,6 +123,7 @@ namespace core {
         void start() {
             if (started.compareAndSet(false, true)) {
                 session.reset(connection->createSession(Session::AUTO_ACKNOWLEDGE));
+                amqSession = dynamic_cast<ActiveMQSession*>(session.get());
 
                 Pointer<ActiveMQDestination> queueAdvisories(AdvisorySupport::getQueueAdvisoryTopic());
                 Pointer<ActiveMQDestination> topicAdvisories(AdvisorySupport::getTopicAdvisoryTopic());
@@ -134,8 +154,13 @@ namespace core {
                     tempQueueConsumer.reset(NULL);
                     tempTopicConsumer.reset(NULL);
 
+                    amqSession = NULL;
                     session.reset(NULL);
                 }
+
+                synchronized(&listenerLock) {
+                    flushBatch();
+                }
             }
         }
 
@@ -146,126 +171,138 @@ namespace core {
             }
 
             const commands::Message* amqMessage = dynamic_cast<const commands::Message*>(message);
-            if (amqMessage != NULL) {
-                Pointer<DataStructure> payload = amqMessage->getDataStructure();
-                try {
-                    Pointer<DestinationInfo> destinationInfo = payload.dynamicCast<DestinationInfo>();
-                    ActiveMQDestinationEvent event(destinationInfo);
-                    handleDestinationEvent(event);
-                } catch(ClassCastException& ex) {
-                }
+            if (amqMessage == NULL) {
+                return;
             }
+
+            Pointer<DataStructure> payload = amqMessage->getDataStructure();
+            if (payload == NULL || payload->getDataStructureType() != DestinationInfo::ID_DESTINATIONINFO) {
+                return;
+            }
+
+            Pointer<DestinationInfo> destinationInfo = payload.staticCast<DestinationInfo>();
+            Pointer<ActiveMQDestination> dest = destinationInfo->getDestination();
+            if (dest == NULL || !isTracked(dest->getPhysicalName())) {
+                return;
+            }
+
+            Pointer<ActiveMQDestinationEvent> event(new ActiveMQDestinationEvent(destinationInfo));
+            handleDestinationEvent(event);
         }
 
-        void handleDestinationEvent(ActiveMQDestinationEvent& event) {
+        bool isTracked(const std::string& name) {
 
-            Pointer<ActiveMQDestination> dest = event.getDestinationInfo()->getDestination();
+            synchronized(&stateLock) {
+                if (filters.empty()) {
+                    return true;
+                }
 
-            if (dest->isTopic()) {
-                if (dest->isTemporary()) {
-                    synchronized(&tempTopics) {
-                        if (event.isAddOperation()) {
-                            tempTopics.add(dest);
-                        } else {
-                            tempTopics.remove(dest);
-                        }
-                    }
-                } else {
-                    synchronized(&topics) {
-                        if (event.isAddOperation()) {
-                            topics.add(dest);
-                        } else {
-                            topics.remove(dest);
-                        }
+                std::vector<std::string>::const_iterator filter = filters.begin();
+                for (; filter != filters.end(); ++filter) {
+                    if (ActiveMQDestination::matchesWildcard(*filter, name)) {
+                        return true;
                     }
                 }
-            } else {
-                if (dest->isTemporary()) {
-                    synchronized(&tempQueues) {
-                        if (event.isAddOperation()) {
-                            tempQueues.add(dest);
-                        } else {
-                            tempQueues.remove(dest);
-                        }
-                    }
+            }
+
+            return false;
+        }
+
+        void handleDestinationEvent(Pointer<ActiveMQDestinationEvent> event) {
+
+            Pointer<ActiveMQDestination> dest = event->getDestinationInfo()->getDestination();
+
+            synchronized(&stateLock) {
+                std::set<std::string>& known = names[dest->getDestinationType()];
+                if (event->isAddOperation()) {
+                    known.insert(dest->getPhysicalName());
                 } else {
-                    synchronized(&queues) {
-                        if (event.isAddOperation()) {
-                            queues.add(dest);
-                        } else {
-                            queues.remove(dest);
-                        }
-                    }
+                    known.erase(dest->getPhysicalName());
                 }
             }
 
             synchronized(&listenerLock) {
                 if (listener != NULL) {
-                    listener->onDestinationEvent(&event);
+                    listener->onDestinationEvent(event.get());
+                }
+
+                if (batchListener != NULL) {
+                    batch.push_back(event);
+
+                    // The dispatch queue is empty once the last advisory of a burst is
+                    // being handled.
+                    if ((int) batch.size() >= maxBatchSize ||
+                        amqSession == NULL || amqSession->getDispatchQueueSize() == 0) {
+                        flushBatch();
+                    }
                 }
             }
         }
 
-        std::vector<cms::Queue*> getQueues() {
+        // Hands the pending events to the batch listener, called with the listener lock held.
+        void flushBatch() {
 
-            std::vector<cms::Queue*> result;
-
-            synchronized(&queues) {
-                Pointer< Iterator<Pointer<ActiveMQDestination> > > iter(queues.iterator());
-                while (iter->hasNext()) {
-                    cms::Destination* copy = iter->next()->getCMSDestination()->clone();
-                    result.push_back(dynamic_cast<cms::Queue*>(copy));
-                }
+            if (batch.empty()) {
+                return;
             }
 
-            return result;
-        }
+            std::vector< Pointer<ActiveMQDestinationEvent> > pending;
+            pending.swap(batch);
 
-        std::vector<cms::Topic*> getTopics() {
-            std::vector<cms::Topic*> result;
+            if (batchListener == NULL) {
+                return;
+            }
 
-            synchronized(&topics) {
-                Pointer< Iterator<Pointer<ActiveMQDestination> > > iter(topics.iterator());
-                while (iter->hasNext()) {
-                    cms::Destination* copy = iter->next()->getCMSDestination()->clone();
-                    result.push_back(dynamic_cast<cms::Topic*>(copy));
-                }
+            std::vector<const cms::DestinationEvent*> events;
+            events.reserve(pending.size());
+            std::vector< Pointer<ActiveMQDestinationEvent> >::const_iterator iter = pending.begin();
+            for (; iter != pending.end(); ++iter) {
+                events.push_back(iter->get());
             }
 
-            return result;
+            batchListener->onDestinationEvents(events);
         }
 
-        std::vector<cms::TemporaryQueue*> getTemporaryQueues() {
-            std::vector<cms::TemporaryQueue*> result;
+        template<typename T, typename Impl>
+        std::vector<T*> getDestinations(cms::Destination::DestinationType type) {
+
+            std::vector<T*> result;
 
-            synchronized(&tempQueues) {
-                Pointer< Iterator<Pointer<ActiveMQDestination> > > iter(tempQueues.iterator());
-                while (iter->hasNext()) {
-                    cms::Destination* copy = iter->next()->getCMSDestination()->clone();
-                    result.push_back(dynamic_cast<cms::TemporaryQueue*>(copy));
+            synchronized(&stateLock) {
+                const std::set<std::string>& known = names[type];
+                result.reserve(known.size());
+                std::set<std::string>::const_iterator name = known.begin();
+                for (; name != known.end(); ++name) {
+                    result.push_back(new Impl(*name));
                 }
             }
 
             return result;
         }
 
-        std::vector<cms::TemporaryTopic*> getTemporaryTopics() {
-            std::vector<cms::TemporaryTopic*> result;
+        std::vector<cms::Queue*> getQueues() {
+            return getDestinations<cms::Queue, ActiveMQQueue>(cms::Destination::QUEUE);
+        }
 
-            synchronized(&tempTopics) {
-                Pointer< Iterator<Pointer<ActiveMQDestination> > > iter(tempTopics.iterator());
-                while (iter->hasNext()) {
-                    cms::Destination* copy = iter->next()->getCMSDestination()->clone();
-                    result.push_back(dynamic_cast<cms::TemporaryTopic*>(copy));
-                }
-            }
+        std::vector<cms::Topic*> getTopics() {
+            return getDestinations<cms::Topic, ActiveMQTopic>(cms::Destination::TOPIC);
+        }
 
-            return result;
+        std::vector<cms::TemporaryQueue*> getTemporaryQueues() {
+            return getDestinations<cms::TemporaryQueue, ActiveMQTempQueue>(cms::Destination::TEMPORARY_QUEUE);
+        }
+
+        std::vector<cms::TemporaryTopic*> getTemporaryTopics() {
+            return getDestinations<cms::TemporaryTopic, ActiveMQTempTopic>(cms::Destination::TEMPORARY_TOPIC);
         }
     };
 
 }}
 
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQDestinationSource::BatchListener::~BatchListener() {
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQDestinationSource::ActiveMQDestinationSource(ActiveMQConnection* connection) :
     DestinationSource(), impl(new DestinationSourceImpl()) {
@@ -326,3 +363,36 @@ std::vector<cms::TemporaryQueue*> ActiveMQDestinationSource::getTemporaryQueues(
 std::vector<cms::TemporaryTopic*> ActiveMQDestinationSource::getTemporaryTopics() const {
     return this->impl->getTemporaryTopics();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQDestinationSource::addFilter(const std::string& pattern) {
+    synchronized(&this->impl->stateLock) {
+        this->impl->filters.push_back(pattern);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQDestinationSource::clearFilters() {
+    synchronized(&this->impl->stateLock) {
+        this->impl->filters.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQDestinationSource::setBatchListener(BatchListener* listener, int maxBatchSize) {
+
+    if (listener != NULL && maxBatchSize < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Max batch size must be at least one");
+    }
+
+    synchronized(&this->impl->listenerLock) {
+        this->impl->flushBatch();
+        this->impl->batchListener = listener;
+        this->impl->maxBatchSize = listener != NULL ? maxBatchSize : 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQDestinationSource::BatchListener* ActiveMQDestinationSource::getBatchListener() const {
+    return this->impl->batchListener;
+}
@@ -19,16 +19,51 @@
 #define _ACTIVEMQ_CORE_ACTIVEMQDESTINATIONSOURCE_H_
 
 #include <cms/DestinationSource.h>
+#include <cms/DestinationEvent.h>
 
 #include <activemq/util/Config.h>
 
+#include <string>
+#include <vector>
+
 namespace activemq {
 namespace core {
 
     class DestinationSourceImpl;
     class ActiveMQConnection;
 
+    /**
+     * Tracks the destinations of the broker from its destination advisories.
+     *
+     * Advisories for destinations that match none of the filters added are dropped as
+     * they arrive, before any event is built or the known destinations are updated.  A
+     * BatchListener receives the events in batches instead of one call per advisory.
+     */
     class AMQCPP_API ActiveMQDestinationSource : public cms::DestinationSource {
+    public:
+
+        /**
+         * Receives the destination events of a source in batches.  A batch is handed over
+         * once it holds the maximum number of events or when no more advisories are
+         * waiting to be dispatched, so a burst of advisories makes few calls while a lone
+         * one is still handed over at once.
+         */
+        class AMQCPP_API BatchListener {
+        public:
+
+            virtual ~BatchListener();
+
+            /**
+             * Called with the events gathered since the last call, in order of arrival.
+             * The events are only valid for the duration of the call.
+             *
+             * @param events
+             *      The destination events of the batch, never empty.
+             */
+            virtual void onDestinationEvents(const std::vector<const cms::DestinationEvent*>& events) = 0;
+
+        };
+
     private:
 
         ActiveMQDestinationSource(ActiveMQDestinationSource&);
@@ -62,6 +97,40 @@ namespace core {
 
         virtual std::vector<cms::TemporaryTopic*> getTemporaryTopics() const;
 
+    public:
+
+        /**
+         * Restricts the destinations tracked to those whose physical name matches one of
+         * the filters added, of any destination type.  Without filters every destination
+         * is tracked.  Destinations already known are kept.
+         *
+         * @param pattern
+         *      A destination name, possibly holding the '*' and '>' wildcards.
+         */
+        void addFilter(const std::string& pattern);
+
+        /**
+         * Removes all filters, every destination is tracked again.
+         */
+        void clearFilters();
+
+        /**
+         * Sets the listener that receives the destination events in batches, it is called
+         * besides the DestinationListener if both are set.  Events pending for the previous
+         * batch listener are handed to it first.
+         *
+         * @param listener
+         *      The batch listener, or NULL to stop batching.
+         * @param maxBatchSize
+         *      The most events handed over in one call.
+         */
+        void setBatchListener(BatchListener* listener, int maxBatchSize);
+
+        /**
+         * @return the batch listener, or NULL if none is set.
+         */
+        BatchListener* getBatchListener() const;
+
     };
 
 }}
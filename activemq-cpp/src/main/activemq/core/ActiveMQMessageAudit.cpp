@@ -21,11 +21,12 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/commands/ProducerId.h>
 
-#include <decaf/util/LRUCache.h>
-#include <decaf/util/BitSet.h>
+#include <decaf/lang/Long.h>
 #include <decaf/util/concurrent/Mutex.h>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace activemq;
@@ -46,6 +47,69 @@ const int ActiveMQMessageAudit::MAXIMUM_PRODUCER_COUNT = 64;
 namespace activemq {
 namespace core {
 
+    /**
+     * Identifies a producer without copying its id, string Message Ids are keyed by
+     * the seed that precedes their sequence number and MessageId instances by the
+     * fields of their ProducerId.
+     */
+    struct AuditKey {
+
+        const std::string* name;
+        std::size_t length;
+        long long sessionId;
+        long long value;
+        bool seeded;
+        unsigned int hash;
+
+        AuditKey(const std::string& seed, std::size_t length) :
+            name(&seed), length(length), sessionId(-1), value(-1), seeded(true), hash(0) {
+            computeHash();
+        }
+
+        AuditKey(const ProducerId& id) :
+            name(&id.getConnectionId()), length(id.getConnectionId().length()),
+            sessionId(id.getSessionId()), value(id.getValue()), seeded(false), hash(0) {
+            computeHash();
+        }
+
+        void computeHash() {
+            // FNV-1a over the name then the two numeric parts of the id.
+            unsigned int result = 2166136261U;
+            for (std::size_t i = 0; i < length; ++i) {
+                result = (result ^ (unsigned char) (*name)[i]) * 16777619U;
+            }
+            result = (result ^ (unsigned int) sessionId) * 16777619U;
+            result = (result ^ (unsigned int) value) * 16777619U;
+            hash = result;
+        }
+    };
+
+    /**
+     * The tracking state of one producer, the bits of its window live in the slab
+     * the audit allocates up front.  Bit i of the window stands for the sequence id
+     * at base + i, the window is a ring of words so it slides without copying.
+     */
+    struct ProducerWindow {
+
+        std::string name;
+        long long sessionId;
+        long long value;
+        bool seeded;
+        unsigned int hash;
+        bool used;
+        long long base;
+        long long lastUsed;
+
+        ProducerWindow() : name(), sessionId(-1), value(-1), seeded(false), hash(0), used(false), base(0), lastUsed(0) {
+        }
+
+        bool matches(const AuditKey& key) const {
+            return this->hash == key.hash && this->seeded == key.seeded &&
+                   this->sessionId == key.sessionId && this->value == key.value &&
+                   this->name.length() == key.length && this->name.compare(0, key.length, *key.name, 0, key.length) == 0;
+        }
+    };
+
     class MessageAuditImpl {
     private:
 
@@ -54,43 +118,312 @@ namespace core {
 
     public:
 
+        static const int BITS_PER_WORD = 64;
+
         int auditDepth;
         int maximumNumberOfProducersToTrack;
         Mutex mutex;
 
-        LRUCache<std::string, Pointer<BitSet> > map;
-
-        MessageAuditImpl() : auditDepth(2048),
-                             maximumNumberOfProducersToTrack(64),
-                             mutex(),
-                             map() {
+        // Words in each window, one more than the depth needs so that a full auditDepth
+        // of ids behind the newest one is always covered.
+        int windowWords;
+        std::vector<unsigned long long> slab;
+        std::vector<ProducerWindow> producers;
+
+        // Open addressed index from the hash of a producer to its slot in producers.
+        std::vector<int> table;
+        unsigned int tableMask;
+        long long clock;
+
+        MessageAuditImpl() : auditDepth(ActiveMQMessageAudit::DEFAULT_WINDOW_SIZE),
+                             maximumNumberOfProducersToTrack(ActiveMQMessageAudit::MAXIMUM_PRODUCER_COUNT),
+                             mutex(), windowWords(0), slab(), producers(), table(), tableMask(0), clock(0) {
+            allocate();
         }
 
         MessageAuditImpl(int auditDepth, int maximumNumberOfProducersToTrack) :
             auditDepth(auditDepth),
             maximumNumberOfProducersToTrack(maximumNumberOfProducersToTrack),
-            mutex(),
-            map() {
+            mutex(), windowWords(0), slab(), producers(), table(), tableMask(0), clock(0) {
+            allocate();
         }
 
-        void adjustMaxProducersToTrack(int value) {
-            // When value is smaller than current we need to move the entries
-            // to a new cache with that setting so that old ones are pruned
-            // since putAll will access the entries in the right order,
-            // this shouldn't result in wrong cache entries being removed
-            if (value < maximumNumberOfProducersToTrack) {
-                LRUCache<std::string, Pointer<BitSet> > newMap(0, value, 0.75f, true);
-                newMap.putAll(this->map);
-                this->map.clear();
-                this->map.putAll(newMap);
+        /**
+         * Sizes the slab and index for the current settings, dropping anything tracked.
+         */
+        void allocate() {
+
+            int depth = auditDepth > 0 ? auditDepth : 1;
+            int count = maximumNumberOfProducersToTrack > 0 ? maximumNumberOfProducersToTrack : 1;
+
+            this->windowWords = (depth + BITS_PER_WORD - 1) / BITS_PER_WORD + 1;
+            this->slab.assign((std::size_t) windowWords * count, 0);
+            this->producers.clear();
+            this->producers.resize(count);
+
+            std::size_t tableSize = 4;
+            while (tableSize < (std::size_t) count * 2) {
+                tableSize <<= 1;
             }
-            this->map.setMaxCacheSize(value);
+            this->table.assign(tableSize, -1);
+            this->tableMask = (unsigned int) tableSize - 1;
+            this->clock = 0;
+        }
+
+        void adjustMaxProducersToTrack(int value) {
+
+            // Carry over the most recently used producers with their windows intact.
+            std::vector<ProducerWindow> oldProducers(this->producers);
+            std::vector<unsigned long long> oldSlab(this->slab);
+
             this->maximumNumberOfProducersToTrack = value;
+            allocate();
+
+            std::vector<int> order;
+            for (std::size_t i = 0; i < oldProducers.size(); ++i) {
+                if (oldProducers[i].used) {
+                    order.push_back((int) i);
+                }
+            }
+
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                for (std::size_t j = i + 1; j < order.size(); ++j) {
+                    if (oldProducers[order[j]].lastUsed > oldProducers[order[i]].lastUsed) {
+                        std::swap(order[i], order[j]);
+                    }
+                }
+            }
+
+            std::size_t kept = std::min(order.size(), this->producers.size());
+            for (std::size_t i = 0; i < kept; ++i) {
+                int slot = (int) (kept - 1 - i);
+                const ProducerWindow& source = oldProducers[order[i]];
+                this->producers[slot] = source;
+                std::copy(oldSlab.begin() + (std::size_t) order[i] * windowWords,
+                          oldSlab.begin() + (std::size_t) (order[i] + 1) * windowWords,
+                          this->slab.begin() + (std::size_t) slot * windowWords);
+                insertIndex(slot);
+            }
+            this->clock = kept > 0 ? oldProducers[order[0]].lastUsed : 0;
+        }
+
+        void setAuditDepth(int value) {
+            this->auditDepth = value;
+            allocate();
+        }
+
+        /**
+         * @return the slot of the producer or -1 if it isn't being tracked.
+         */
+        int find(const AuditKey& key) const {
+            unsigned int index = key.hash & tableMask;
+            while (table[index] != -1) {
+                if (producers[table[index]].matches(key)) {
+                    return table[index];
+                }
+                index = (index + 1) & tableMask;
+            }
+            return -1;
+        }
+
+        /**
+         * @return the slot of the producer, evicting the least recently used one to make
+         *         room if it wasn't being tracked yet.
+         */
+        int findOrCreate(const AuditKey& key) {
+
+            int slot = find(key);
+            if (slot >= 0) {
+                return slot;
+            }
+
+            for (std::size_t i = 0; i < producers.size(); ++i) {
+                if (!producers[i].used) {
+                    slot = (int) i;
+                    break;
+                }
+                if (slot < 0 || producers[i].lastUsed < producers[slot].lastUsed) {
+                    slot = (int) i;
+                }
+            }
+
+            ProducerWindow& window = producers[slot];
+            if (window.used) {
+                removeIndex(slot);
+            }
+
+            window.name.assign(*key.name, 0, key.length);
+            window.sessionId = key.sessionId;
+            window.value = key.value;
+            window.seeded = key.seeded;
+            window.hash = key.hash;
+            window.used = true;
+            window.base = 0;
+            std::fill(slab.begin() + (std::size_t) slot * windowWords,
+                      slab.begin() + (std::size_t) (slot + 1) * windowWords, 0ULL);
+
+            insertIndex(slot);
+            return slot;
+        }
+
+        void insertIndex(int slot) {
+            unsigned int index = producers[slot].hash & tableMask;
+            while (table[index] != -1) {
+                index = (index + 1) & tableMask;
+            }
+            table[index] = slot;
+        }
+
+        void removeIndex(int slot) {
+
+            unsigned int index = producers[slot].hash & tableMask;
+            while (table[index] != slot) {
+                index = (index + 1) & tableMask;
+            }
+            table[index] = -1;
+
+            // Shift back any entry whose probe sequence ran through the freed position.
+            unsigned int next = index;
+            while (true) {
+                next = (next + 1) & tableMask;
+                if (table[next] == -1) {
+                    break;
+                }
+
+                unsigned int home = producers[table[next]].hash & tableMask;
+                bool stays = index <= next ? (index < home && home <= next) : (index < home || home <= next);
+                if (!stays) {
+                    table[index] = table[next];
+                    table[next] = -1;
+                    index = next;
+                }
+            }
+        }
+
+        unsigned long long& word(int slot, long long sequence) {
+            return slab[(std::size_t) slot * windowWords + (std::size_t) ((sequence / BITS_PER_WORD) % windowWords)];
+        }
+
+        /**
+         * Slides the window of the producer forward so that it covers the sequence.
+         */
+        void advance(int slot, long long sequence) {
+
+            ProducerWindow& window = producers[slot];
+            long long span = (long long) windowWords * BITS_PER_WORD;
+            if (sequence < window.base + span) {
+                return;
+            }
+
+            long long newBase = (sequence / BITS_PER_WORD - (windowWords - 1)) * BITS_PER_WORD;
+            if (newBase - window.base >= span) {
+                std::fill(slab.begin() + (std::size_t) slot * windowWords,
+                          slab.begin() + (std::size_t) (slot + 1) * windowWords, 0ULL);
+            } else {
+                for (long long dropped = window.base; dropped < newBase; dropped += BITS_PER_WORD) {
+                    word(slot, dropped) = 0;
+                }
+            }
+
+            window.base = newBase;
+        }
+
+        /**
+         * Marks the sequence as seen.
+         *
+         * @return true if it had already been seen, ids older than the window can no
+         *         longer be told apart and are never reported as duplicates.
+         */
+        bool testAndSet(int slot, long long sequence) {
+
+            producers[slot].lastUsed = ++clock;
+            advance(slot, sequence);
+
+            if (sequence < producers[slot].base) {
+                return false;
+            }
+
+            unsigned long long mask = 1ULL << (sequence % BITS_PER_WORD);
+            unsigned long long& bits = word(slot, sequence);
+            bool answer = (bits & mask) != 0;
+            bits |= mask;
+            return answer;
+        }
+
+        void clearBit(int slot, long long sequence) {
+
+            const ProducerWindow& window = producers[slot];
+            if (sequence < window.base || sequence >= window.base + (long long) windowWords * BITS_PER_WORD) {
+                return;
+            }
+
+            word(slot, sequence) &= ~(1ULL << (sequence % BITS_PER_WORD));
+        }
+
+        /**
+         * @return the highest sequence marked as seen within the window, or -1.
+         */
+        long long highestSeen(int slot) {
+
+            const ProducerWindow& window = producers[slot];
+            long long first = window.base / BITS_PER_WORD;
+
+            for (long long index = first + windowWords - 1; index >= first; --index) {
+
+                unsigned long long bits = word(slot, index * BITS_PER_WORD);
+                if (bits != 0) {
+
+                    int bit = 0;
+                    for (int shift = 32; shift > 0; shift >>= 1) {
+                        if ((bits >> shift) != 0) {
+                            bits >>= shift;
+                            bit += shift;
+                        }
+                    }
+
+                    return index * BITS_PER_WORD + bit;
+                }
+            }
+
+            return -1;
         }
     };
 
 }}
 
+namespace {
+
+    /**
+     * Splits a string Message Id into the seed before its last ':' and the sequence
+     * after it without allocating.
+     *
+     * @return the length of the seed including the ':' or zero if there is none.
+     */
+    std::size_t parseId(const std::string& id, long long& sequence) {
+
+        sequence = -1;
+
+        std::size_t index = id.find_last_of(':');
+        if (index == std::string::npos || index + 1 >= id.length()) {
+            return 0;
+        }
+
+        long long result = 0;
+        for (std::size_t i = index + 1; i < id.length(); ++i) {
+            char digit = id[i];
+            if (digit < '0' || digit > '9' || result > (Long::MAX_VALUE - 9) / 10) {
+                // Leave the unusual cases to the same parser the rest of the code uses.
+                sequence = IdGenerator::getSequenceFromId(id);
+                return index + 1;
+            }
+            result = result * 10 + (digit - '0');
+        }
+
+        sequence = result;
+        return index + 1;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQMessageAudit::ActiveMQMessageAudit() : impl(new MessageAuditImpl) {
 }
@@ -115,7 +448,9 @@ int ActiveMQMessageAudit::getAuditDepth() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQMessageAudit::setAuditDepth(int value) {
-    this->impl->auditDepth = value;
+    synchronized(&this->impl->mutex) {
+        this->impl->setAuditDepth(value);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,37 +460,22 @@ int ActiveMQMessageAudit::getMaximumNumberOfProducersToTrack() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQMessageAudit::getMaximumNumberOfProducersToTrack(int value) {
-    this->impl->adjustMaxProducersToTrack(value);
+    synchronized(&this->impl->mutex) {
+        this->impl->adjustMaxProducersToTrack(value);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQMessageAudit::isDuplicate(const std::string& id) const {
     bool answer = false;
-    std::string seed = IdGenerator::getSeedFromId(id);
-    if (!seed.empty()) {
+    long long index = -1;
+    std::size_t seedLength = parseId(id, index);
+    if (seedLength > 0 && index >= 0) {
 
-        synchronized(&this->impl->mutex) {
+        AuditKey key(id, seedLength);
 
-            Pointer<BitSet> bits;
-            try {
-                bits = this->impl->map.get(seed);
-            } catch (NoSuchElementException& ex) {
-                bits.reset(new BitSet(this->impl->auditDepth));
-                this->impl->map.put(seed, bits);
-            }
-
-            long long index = IdGenerator::getSequenceFromId(id);
-            if (index >= 0) {
-                int scaledIndex = (int) index;
-                if (index > Integer::MAX_VALUE) {
-                    scaledIndex = (int)(index - Integer::MAX_VALUE);
-                }
-
-                answer = bits->get(scaledIndex);
-                if (!answer) {
-                    bits->set(scaledIndex, true);
-                }
-            }
+        synchronized(&this->impl->mutex) {
+            answer = this->impl->testAndSet(this->impl->findOrCreate(key), index);
         }
     }
     return answer;
@@ -166,34 +486,14 @@ bool ActiveMQMessageAudit::isDuplicate(decaf::lang::Pointer<MessageId> msgId) co
     bool answer = false;
 
     if (msgId != NULL) {
-        Pointer<ProducerId> pid = msgId->getProducerId();
-        if (pid != NULL) {
-            std::string seed = pid->toString();
-            if (!seed.empty()) {
+        const Pointer<ProducerId>& pid = msgId->getProducerId();
+        long long index = msgId->getProducerSequenceId();
+        if (pid != NULL && index >= 0) {
 
-                synchronized(&this->impl->mutex) {
-
-                    Pointer<BitSet> bits;
-                    try {
-                        bits = this->impl->map.get(seed);
-                    } catch (NoSuchElementException& ex) {
-                        bits.reset(new BitSet(this->impl->auditDepth));
-                        this->impl->map.put(seed, bits);
-                    }
+            AuditKey key(*pid);
 
-                    long long index = msgId->getProducerSequenceId();
-                    if (index >= 0) {
-                        int scaledIndex = (int) index;
-                        if (index > Integer::MAX_VALUE) {
-                            scaledIndex = (int)(index - Integer::MAX_VALUE);
-                        }
-
-                        answer = bits->get(scaledIndex);
-                        if (!answer) {
-                            bits->set(scaledIndex, true);
-                        }
-                    }
-                }
+            synchronized(&this->impl->mutex) {
+                answer = this->impl->testAndSet(this->impl->findOrCreate(key), index);
             }
         }
     }
@@ -202,27 +502,16 @@ bool ActiveMQMessageAudit::isDuplicate(decaf::lang::Pointer<MessageId> msgId) co
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQMessageAudit::rollback(const std::string& msgId) {
-    std::string seed = IdGenerator::getSeedFromId(msgId);
-    if (!seed.empty()) {
+    long long index = -1;
+    std::size_t seedLength = parseId(msgId, index);
+    if (seedLength > 0 && index >= 0) {
 
-        synchronized(&this->impl->mutex) {
+        AuditKey key(msgId, seedLength);
 
-            Pointer<BitSet> bits;
-            try {
-                bits = this->impl->map.get(seed);
-            } catch (NoSuchElementException& ex) {
-            }
-
-            if (bits != NULL) {
-                long long index = IdGenerator::getSequenceFromId(msgId);
-                if (index >= 0) {
-                    int scaledIndex = (int) index;
-                    if (index > Integer::MAX_VALUE) {
-                        scaledIndex = (int)(index - Integer::MAX_VALUE);
-                    }
-
-                    bits->set(scaledIndex, false);
-                }
+        synchronized(&this->impl->mutex) {
+            int slot = this->impl->find(key);
+            if (slot >= 0) {
+                this->impl->clearBit(slot, index);
             }
         }
     }
@@ -231,30 +520,16 @@ void ActiveMQMessageAudit::rollback(const std::string& msgId) {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQMessageAudit::rollback(decaf::lang::Pointer<commands::MessageId> msgId) {
     if (msgId != NULL) {
-        Pointer<ProducerId> pid = msgId->getProducerId();
-        if (pid != NULL) {
-            std::string seed = pid->toString();
-            if (!seed.empty()) {
+        const Pointer<ProducerId>& pid = msgId->getProducerId();
+        long long index = msgId->getProducerSequenceId();
+        if (pid != NULL && index >= 0) {
 
-                synchronized(&this->impl->mutex) {
+            AuditKey key(*pid);
 
-                    Pointer<BitSet> bits;
-                    try {
-                        bits = this->impl->map.get(seed);
-                    } catch (NoSuchElementException& ex) {
-                    }
-
-                    if (bits != NULL) {
-                        long long index = msgId->getProducerSequenceId();
-                        if (index >= 0) {
-                            int scaledIndex = (int) index;
-                            if (index > Integer::MAX_VALUE) {
-                                scaledIndex = (int)(index - Integer::MAX_VALUE);
-                            }
-
-                            bits->set(scaledIndex, false);
-                        }
-                    }
+            synchronized(&this->impl->mutex) {
+                int slot = this->impl->find(key);
+                if (slot >= 0) {
+                    this->impl->clearBit(slot, index);
                 }
             }
         }
@@ -265,30 +540,16 @@ void ActiveMQMessageAudit::rollback(decaf::lang::Pointer<commands::MessageId> ms
 bool ActiveMQMessageAudit::isInOrder(const std::string& msgId) const {
     bool answer = true;
 
-    if (!msgId.empty()) {
-        std::string seed = IdGenerator::getSeedFromId(msgId);
-        if (!seed.empty()) {
+    long long index = -1;
+    std::size_t seedLength = parseId(msgId, index);
+    if (seedLength > 0) {
 
-            synchronized(&this->impl->mutex) {
-
-                Pointer<BitSet> bits;
-                try {
-                    bits = this->impl->map.get(seed);
-                } catch (NoSuchElementException& ex) {
-                    bits.reset(new BitSet(this->impl->auditDepth));
-                    this->impl->map.put(seed, bits);
-                }
-
-                long long index = IdGenerator::getSequenceFromId(msgId);
-                if (index >= 0) {
+        AuditKey key(msgId, seedLength);
 
-                    int scaledIndex = (int) index;
-                    if (index > Integer::MAX_VALUE) {
-                        scaledIndex = (int)(index - Integer::MAX_VALUE);
-                    }
-
-                    answer = ((bits->length() - 1) == scaledIndex);
-                }
+        synchronized(&this->impl->mutex) {
+            int slot = this->impl->findOrCreate(key);
+            if (index >= 0) {
+                answer = this->impl->highestSeen(slot) == index;
             }
         }
     }
@@ -300,29 +561,16 @@ bool ActiveMQMessageAudit::isInOrder(decaf::lang::Pointer<commands::MessageId> m
     bool answer = false;
 
     if (msgId != NULL) {
-        Pointer<ProducerId> pid = msgId->getProducerId();
+        const Pointer<ProducerId>& pid = msgId->getProducerId();
         if (pid != NULL) {
-            std::string seed = pid->toString();
-            if (!seed.empty()) {
 
-                synchronized(&this->impl->mutex) {
+            AuditKey key(*pid);
 
-                    Pointer<BitSet> bits;
-                    try {
-                        bits = this->impl->map.get(seed);
-                    } catch (NoSuchElementException& ex) {
-                        bits.reset(new BitSet(this->impl->auditDepth));
-                        this->impl->map.put(seed, bits);
-                    }
-
-                    long long index = msgId->getProducerSequenceId();
-                    if (index >= 0) {
-                        int scaledIndex = (int) index;
-                        if (index > Integer::MAX_VALUE) {
-                            scaledIndex = (int)(index - Integer::MAX_VALUE);
-                        }
-                        answer = ((bits->length() - 1) == scaledIndex);
-                    }
+            synchronized(&this->impl->mutex) {
+                int slot = this->impl->findOrCreate(key);
+                long long index = msgId->getProducerSequenceId();
+                if (index >= 0) {
+                    answer = this->impl->highestSeen(slot) == index;
                 }
             }
         }
@@ -332,29 +580,43 @@ bool ActiveMQMessageAudit::isInOrder(decaf::lang::Pointer<commands::MessageId> m
 
 ////////////////////////////////////////////////////////////////////////////////
 long long ActiveMQMessageAudit::getLastSeqId(decaf::lang::Pointer<commands::ProducerId> id) const {
-    long result = -1;
+    long long result = -1;
     if (id != NULL) {
-        std::string seed = id->toString();
-        if (!seed.empty()) {
 
-            synchronized(&this->impl->mutex) {
-
-                Pointer<BitSet> bits;
-                try {
-                    bits = this->impl->map.get(seed);
-                } catch (NoSuchElementException& ex) {
-                }
+        AuditKey key(*id);
 
-                if (bits != NULL) {
-                    result = bits->length() - 1;
-                }
+        synchronized(&this->impl->mutex) {
+            int slot = this->impl->find(key);
+            if (slot >= 0) {
+                result = this->impl->highestSeen(slot);
             }
         }
     }
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQMessageAudit::getMemoryUsage() const {
+
+    long long usage = 0;
+
+    synchronized(&this->impl->mutex) {
+        usage += (long long) (this->impl->slab.capacity() * sizeof(unsigned long long));
+        usage += (long long) (this->impl->producers.capacity() * sizeof(ProducerWindow));
+        usage += (long long) (this->impl->table.capacity() * sizeof(int));
+
+        std::vector<ProducerWindow>::const_iterator producer = this->impl->producers.begin();
+        for (; producer != this->impl->producers.end(); ++producer) {
+            usage += (long long) producer->name.capacity();
+        }
+    }
+
+    return usage;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQMessageAudit::clear() {
-    this->impl->map.clear();
+    synchronized(&this->impl->mutex) {
+        this->impl->allocate();
+    }
 }
@@ -29,6 +29,16 @@ namespace core {
 
     class MessageAuditImpl;
 
+    /**
+     * Tracks the Message Ids seen from each producer so that duplicates can be spotted.
+     *
+     * Every producer gets a fixed size window of bits covering the last auditDepth
+     * sequence ids, the windows of all producers are allocated together when the
+     * audit is created so that checking an id never allocates.  Producers are found
+     * by a hash of their id, once more than maximumNumberOfProducersToTrack are seen
+     * the least recently used one is forgotten.  Ids that have fallen behind the
+     * window of their producer are not reported as duplicates.
+     */
     class AMQCPP_API ActiveMQMessageAudit {
     private:
 
@@ -68,7 +78,8 @@ namespace core {
         int getAuditDepth() const;
 
         /**
-         * Sets a new Audit Depth value.
+         * Sets a new Audit Depth value, the windows are resized so anything audited
+         * so far is forgotten.
          *
          * @param value
          *      The range of ids to track.
@@ -150,6 +161,11 @@ namespace core {
          */
         long long getLastSeqId(decaf::lang::Pointer<commands::ProducerId> id) const;
 
+        /**
+         * @return the bytes held by the producer windows and the index of this Audit.
+         */
+        long long getMemoryUsage() const;
+
         /**
          * Clears this Audit.
          */
@@ -128,3 +128,87 @@ void ActiveMQProducer::send(const cms::Destination* destination, cms::Message* m
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const std::vector<cms::Message*>& messages) {
+
+    try {
+        this->kernel->send(messages);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const cms::Destination* destination, const std::vector<cms::Message*>& messages,
+                            int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        this->kernel->send(destination, messages, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const std::vector<const cms::Destination*>& destinations, cms::Message* message) {
+
+    try {
+        this->kernel->send(destinations, message);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const std::vector<const cms::Destination*>& destinations, cms::Message* message,
+                            int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        this->kernel->send(destinations, message, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage* ActiveMQProducer::prepare(cms::Message* message) {
+
+    try {
+        return this->kernel->prepare(message);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage* ActiveMQProducer::prepare(const cms::Destination* destination, cms::Message* message,
+                                           int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+        return this->kernel->prepare(destination, message, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const PreparedMessage& prepared, const std::string& text) {
+
+    try {
+        this->kernel->send(prepared, text);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::send(const PreparedMessage& prepared, const unsigned char* body, int size) {
+
+    try {
+        this->kernel->send(prepared, body, size);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducer::awaitPendingSends() {
+
+    try {
+        this->kernel->awaitPendingSends();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
@@ -24,6 +24,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/ProducerInfo.h>
+#include <activemq/core/PreparedMessage.h>
 #include <activemq/core/kernels/ActiveMQProducerKernel.h>
 
 namespace activemq {
@@ -78,6 +79,126 @@ namespace core {
         virtual void send(const cms::Destination* destination, cms::Message* message,
                           int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback);
 
+    public:
+
+        /**
+         * Sends a batch of messages to this producer's destination using the producer's
+         * default delivery mode, priority and time to live.
+         *
+         * @see send(const cms::Destination*, const std::vector<cms::Message*>&, int, int, long long)
+         */
+        void send(const std::vector<cms::Message*>& messages);
+
+        /**
+         * Sends a batch of messages and waits once for the broker to acknowledge all of
+         * them, so that the batch costs about one round trip to the broker instead of one
+         * per message.  The messages are marshaled back to back and have all been accepted
+         * by the broker when this method returns, without the batch needing a transaction.
+         *
+         * @param destination
+         *      The destination to send the messages to.
+         * @param messages
+         *      The messages to send, in order.
+         * @param deliveryMode
+         *      The delivery mode to send the messages with.
+         * @param priority
+         *      The priority to send the messages with.
+         * @param timeToLive
+         *      The time to live to send the messages with.
+         *
+         * @throws CMSException if a message can't be sent, the broker rejects one of them,
+         *         or the send timeout expires before every message is acknowledged.
+         */
+        void send(const cms::Destination* destination, const std::vector<cms::Message*>& messages,
+                  int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends one message to each of several destinations using the producer's default
+         * delivery mode, priority and time to live.
+         *
+         * @see send(const std::vector<const cms::Destination*>&, cms::Message*, int, int, long long)
+         */
+        void send(const std::vector<const cms::Destination*>& destinations, cms::Message* message);
+
+        /**
+         * Sends the message to each of the given destinations, marshaling its body and
+         * properties only once, and waits once for the broker to acknowledge all of the
+         * copies.  Each copy has its own message id, the message given is left with the id
+         * and destination of the last one.  Only a producer created without a destination
+         * can send to several.
+         *
+         * @param destinations
+         *      The destinations to send the message to, in order.
+         * @param message
+         *      The message to send.
+         * @param deliveryMode
+         *      The delivery mode to send the message with.
+         * @param priority
+         *      The priority to send the message with.
+         * @param timeToLive
+         *      The time to live to send the message with.
+         *
+         * @throws CMSException if a copy can't be sent, the broker rejects one of them,
+         *         or the send timeout expires before every copy is acknowledged.
+         * @throws UnsupportedOperationException if this producer has a destination.
+         */
+        void send(const std::vector<const cms::Destination*>& destinations, cms::Message* message,
+                  int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Prepares a message to be sent to this producer's destination with the producer's
+         * default delivery mode, priority and time to live.
+         *
+         * @see prepare(const cms::Destination*, cms::Message*, int, int, long long)
+         */
+        PreparedMessage* prepare(cms::Message* message);
+
+        /**
+         * Fixes the headers and properties of a TextMessage or BytesMessage, with the
+         * destination and send options, into a PreparedMessage.  Its properties are
+         * marshaled once here and each send of the PreparedMessage only gives a copy
+         * of it a body, a message id and a timestamp.
+         *
+         * @param destination
+         *      The destination the prepared message is sent to.
+         * @param message
+         *      The message whose headers and properties are used, it is not changed.
+         * @param deliveryMode
+         *      The delivery mode to send the message with.
+         * @param priority
+         *      The priority to send the message with.
+         * @param timeToLive
+         *      The time to live to send the message with.
+         *
+         * @return a new PreparedMessage that the caller owns.
+         *
+         * @throws CMSException if the message can't be prepared.
+         * @throws UnsupportedOperationException if the message is neither a TextMessage nor
+         *         a BytesMessage, or the destination isn't one this producer can send to.
+         */
+        PreparedMessage* prepare(const cms::Destination* destination, cms::Message* message,
+                                 int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends a prepared TextMessage with the given text as its body.
+         *
+         * @throws CMSException if the message can't be sent.
+         * @throws IllegalStateException if another producer prepared the message.
+         * @throws MessageFormatException if the message wasn't prepared from a TextMessage.
+         */
+        void send(const PreparedMessage& prepared, const std::string& text);
+
+        /**
+         * Sends a prepared BytesMessage with a copy of the given bytes as its body.
+         *
+         * @throws CMSException if the message can't be sent.
+         * @throws IllegalStateException if another producer prepared the message.
+         * @throws MessageFormatException if the message wasn't prepared from a BytesMessage.
+         */
+        void send(const PreparedMessage& prepared, const unsigned char* body, int size);
+
+    public:
+
         /**
          * Sets the delivery mode for this Producer
          * @param mode - The DeliveryMode to use for Message sends.
@@ -184,6 +305,41 @@ namespace core {
 
     public:
 
+        /**
+         * Sets the number of persistent sends that this Producer can have waiting for
+         * their response from the broker, a value of zero or less disables pipelining.
+         *
+         * @see ActiveMQProducerKernel::setMaxPendingSends
+         *
+         * @param value
+         *      The maximum number of pipelined sends.
+         */
+        void setMaxPendingSends(int value) {
+            this->kernel->setMaxPendingSends(value);
+        }
+
+        /**
+         * @return the maximum number of pipelined sends awaiting a broker response.
+         */
+        int getMaxPendingSends() const {
+            return this->kernel->getMaxPendingSends();
+        }
+
+        /**
+         * @return the number of pipelined sends currently waiting for their response.
+         */
+        int getPendingSendCount() const {
+            return this->kernel->getPendingSendCount();
+        }
+
+        /**
+         * Waits for every pipelined send to be acknowledged by the broker.
+         *
+         * @throws CMSException if the broker rejected one of the sends, or if the send
+         *         timeout expires.
+         */
+        void awaitPendingSends();
+
         /**
          * @return true if this Producer has been closed.
          */
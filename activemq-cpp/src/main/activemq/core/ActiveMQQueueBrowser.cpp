@@ -27,8 +27,11 @@
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/util/CMSExceptionSupport.h>
 
+#include <decaf/lang/Math.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
+#include <deque>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::core;
@@ -232,6 +235,106 @@ cms::Message* ActiveMQQueueBrowser::nextMessage() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQQueueBrowser::nextBatch(std::vector< Pointer<cms::Message> >& batch, int max) {
+
+    try {
+
+        if (max < 1) {
+            throw ActiveMQException(__FILE__, __LINE__, "Can't browse a batch of less than one message: %d", max);
+        }
+
+        while (true) {
+
+            synchronized(&mutex) {
+                if (this->browser == NULL) {
+                    return 0;
+                }
+            }
+
+            try {
+
+                int count = this->browser->receiveBorrowed(batch, max, -1);
+                if (count > 0) {
+                    return count;
+                }
+
+            } catch (cms::CMSException& e) {
+                return 0;
+            }
+
+            if (this->browseDone.get() || !this->session->isStarted()) {
+                destroyConsumer();
+                return 0;
+            }
+
+            waitForMessageAvailable();
+        }
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQQueueBrowser::sampleHead(std::vector< Pointer<cms::Message> >& head, int count) {
+
+    try {
+
+        checkClosed();
+
+        synchronized(&mutex) {
+            if (this->browser == NULL) {
+                this->browser = createConsumer(count);
+            }
+        }
+
+        int taken = 0;
+        while (taken < count) {
+            int received = nextBatch(head, count - taken);
+            if (received == 0) {
+                return taken;
+            }
+            taken += received;
+        }
+
+        // The rest of the queue isn't wanted, stop the broker sending it.
+        synchronized(&mutex) {
+            destroyConsumer();
+        }
+
+        return taken;
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQQueueBrowser::sampleTail(std::vector< Pointer<cms::Message> >& tail, int count) {
+
+    try {
+
+        this->getEnumeration();
+
+        if (count < 1) {
+            return 0;
+        }
+
+        int prefetch = this->session->getConnection()->getPrefetchPolicy()->getQueueBrowserPrefetch();
+
+        std::deque< Pointer<cms::Message> > last;
+        std::vector< Pointer<cms::Message> > batch;
+        while (nextBatch(batch, Math::max(prefetch, 1)) > 0) {
+            last.insert(last.end(), batch.begin(), batch.end());
+            batch.clear();
+            while ((int) last.size() > count) {
+                last.pop_front();
+            }
+        }
+
+        tail.insert(tail.end(), last.begin(), last.end());
+        return (int) last.size();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQQueueBrowser::notifyMessageAvailable() {
     synchronized(&wait) {
@@ -247,11 +350,14 @@ void ActiveMQQueueBrowser::waitForMessageAvailable() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<ActiveMQConsumerKernel> ActiveMQQueueBrowser::createConsumer() {
+Pointer<ActiveMQConsumerKernel> ActiveMQQueueBrowser::createConsumer(int maxPrefetch) {
 
     this->browseDone.set(false);
 
     int prefetch = this->session->getConnection()->getPrefetchPolicy()->getQueueBrowserPrefetch();
+    if (maxPrefetch > 0) {
+        prefetch = Math::min(prefetch, maxPrefetch);
+    }
 
     Pointer<ActiveMQConsumerKernel> consumer(new Browser(this, session, consumerId, destination, "", selector, prefetch, 0, false, true, dispatchAsync, NULL));
 
@@ -31,6 +31,7 @@
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
 #include <string>
+#include <vector>
 
 namespace activemq {
 namespace core {
@@ -92,13 +93,62 @@ namespace kernels {
 
         virtual cms::Message* nextMessage();
 
+        /**
+         * Takes the next messages of the enumeration started by getEnumeration in one go.
+         * The messages are not copied, each is the read only message the broker sent,
+         * shared with the caller until it drops its Pointer.  The call waits for the
+         * first message as nextMessage does and takes whatever else has already arrived.
+         *
+         * @param batch
+         *      The vector the messages are appended to.
+         * @param max
+         *      The maximum number of messages to take, must be at least one.
+         *
+         * @return the number of messages appended, zero once the browse is done.
+         *
+         * @throws CMSException if max is less than one or an internal error occurs.
+         */
+        int nextBatch(std::vector< Pointer<cms::Message> >& batch, int max);
+
+        /**
+         * Browses the first messages of the queue.  When no enumeration is in progress
+         * the broker is asked for no more messages than are wanted, the browse ends once
+         * they have arrived.  The messages are shared as in nextBatch.
+         *
+         * @param head
+         *      The vector the messages are appended to.
+         * @param count
+         *      The number of messages to browse at most.
+         *
+         * @return the number of messages appended.
+         *
+         * @throws CMSException if the browser is closed or an internal error occurs.
+         */
+        int sampleHead(std::vector< Pointer<cms::Message> >& head, int count);
+
+        /**
+         * Browses the rest of the queue and keeps only its last messages, so the memory
+         * it takes is bounded by the count whatever the queue's depth.  The messages are
+         * shared as in nextBatch.
+         *
+         * @param tail
+         *      The vector the messages are appended to, oldest first.
+         * @param count
+         *      The number of messages to keep at most.
+         *
+         * @return the number of messages appended.
+         *
+         * @throws CMSException if the browser is closed or an internal error occurs.
+         */
+        int sampleTail(std::vector< Pointer<cms::Message> >& tail, int count);
+
     private:
 
         void checkClosed();
         void notifyMessageAvailable();
         void waitForMessageAvailable();
 
-        Pointer<activemq::core::kernels::ActiveMQConsumerKernel> createConsumer();
+        Pointer<activemq::core::kernels::ActiveMQConsumerKernel> createConsumer(int maxPrefetch = -1);
         void destroyConsumer();
 
     };
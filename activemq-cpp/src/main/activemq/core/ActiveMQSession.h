@@ -137,6 +137,63 @@ namespace core {
 
    public:  // ActiveMQSession specific Methods
 
+        /**
+         * Commits the current transaction without waiting for the broker to answer.  The
+         * consumers' acks leave in the same flush as the commit and the caller can go on
+         * with its work while the commit is in flight, the session waits for the outcome
+         * before it delivers another message.  A failed commit is reported only through
+         * the returned future.
+         *
+         * @return the future that reports the outcome of the commit.
+         *
+         * @throws CMSException if the session is closed or not transacted.
+         */
+        Pointer<ActiveMQTransactionContext::CommitFuture> commitAsync() {
+            return this->kernel->commitAsync();
+        }
+
+        /**
+         * Creates a consumer without waiting for the broker to accept it, the consumer
+         * is taken from the returned future.  See ActiveMQSessionKernel::ConsumerFuture.
+         *
+         * @param destination
+         *      The destination to consume from.
+         * @param selector
+         *      The message selector, empty for none.
+         * @param noLocal
+         *      Whether messages sent on this session's connection are filtered out.
+         *
+         * @return the future that hands out the consumer.
+         *
+         * @throws CMSException if the session is closed or the ConsumerInfo can't be sent.
+         */
+        Pointer<activemq::core::kernels::ActiveMQSessionKernel::ConsumerFuture> createConsumerAsync(
+            const cms::Destination* destination, const std::string& selector = "", bool noLocal = false) {
+            return this->kernel->createConsumerAsync(destination, selector, noLocal);
+        }
+
+        /**
+         * Closes a consumer of this session without waiting for the broker to confirm
+         * its removal.  The caller still deletes the consumer.
+         *
+         * @param consumer
+         *      A consumer created by this session.
+         *
+         * @return the future that reports the broker's answer.
+         *
+         * @throws CMSException if the RemoveInfo can't be sent.
+         */
+        Pointer<activemq::core::kernels::ActiveMQSessionKernel::CloseFuture> closeConsumerAsync(cms::MessageConsumer* consumer) {
+            return this->kernel->closeConsumerAsync(consumer);
+        }
+
+        /**
+         * @return the number of messages queued for dispatch to this session's consumers.
+         */
+        int getDispatchQueueSize() const {
+            return this->kernel->getDispatchQueueSize();
+        }
+
         /**
          * This method gets any registered exception listener of this sessions
          * connection and returns it.  Mainly intended for use by the objects
@@ -22,9 +22,9 @@
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/FifoMessageDispatchChannel.h>
+#include <activemq/core/RingMessageDispatchChannel.h>
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
 #include <activemq/commands/ConsumerInfo.h>
-#include <activemq/threads/DedicatedTaskRunner.h>
 
 using namespace std;
 using namespace activemq;
@@ -36,15 +36,27 @@ using namespace decaf::lang;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The most messages iterate takes from the session queue at a time.
+    const int MAX_DISPATCH_BATCH = 64;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQSessionExecutor::ActiveMQSessionExecutor(ActiveMQSessionKernel* session) :
-    session(session), messageQueue(), taskRunner() {
+    session(session), messageQueue(), taskRunner(), dispatchBatch() {
 
     if (this->session->getConnection()->isMessagePrioritySupported()) {
         this->messageQueue.reset(new SimplePriorityMessageDispatchChannel());
+    } else if (this->session->getConnection()->isUseRingDispatchChannel()) {
+        this->messageQueue.reset(new RingMessageDispatchChannel(0));
     } else {
         this->messageQueue.reset(new FifoMessageDispatchChannel());
     }
+
+    // Reported apart from the consumers' channels, every message of the session passes here.
+    this->messageQueue->setProfilingSite("activemq.core.ActiveMQSessionExecutor");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,7 +122,7 @@ void ActiveMQSessionExecutor::wakeup() {
             if (!messageQueue->isRunning()) {
                 return;
             }
-            this->taskRunner.reset(new DedicatedTaskRunner(this));
+            this->taskRunner = this->session->getConnection()->createSessionTaskRunner(this);
             this->taskRunner->start();
         }
 
@@ -180,19 +192,22 @@ bool ActiveMQSessionExecutor::iterate() {
 
     try {
 
-        if (this->session->iterateConsumers()) {
-            return true;
-        }
+        // The acks the consumers send during the round are written together at its end.
+        this->session->beginAckBatch();
 
-        // No messages left queued on the listeners.. so now dispatch messages
-        // queued on the session
-        Pointer<MessageDispatch> message = messageQueue->dequeueNoWait();
-        if (message != NULL) {
-            dispatch(message);
-            return !messageQueue->isEmpty();
+        bool more = false;
+        try {
+            more = this->session->iterateConsumers() || dispatchQueued();
+        } catch (...) {
+            try {
+                this->session->endAckBatch();
+            } catch (...) {
+            }
+            throw;
         }
 
-        return false;
+        this->session->endAckBatch();
+        return more;
 
     } catch (decaf::lang::Exception& ex) {
         ex.setMark(__FILE__, __LINE__);
@@ -208,3 +223,27 @@ bool ActiveMQSessionExecutor::iterate() {
         return true;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQSessionExecutor::dispatchQueued() {
+
+    // No messages left queued on the listeners.. so now dispatch messages
+    // queued on the session, a batch is taken with one lock of the queue.
+    dispatchBatch.clear();
+    if (messageQueue->dequeueAll(dispatchBatch, MAX_DISPATCH_BATCH) == 0) {
+        return false;
+    }
+
+    std::size_t next = 0;
+    for (; next < dispatchBatch.size() && messageQueue->isRunning(); ++next) {
+        dispatch(dispatchBatch[next]);
+    }
+
+    // Stopped part way through, put the rest back in order for the restart.
+    for (std::size_t i = dispatchBatch.size(); i > next; --i) {
+        messageQueue->enqueueFirst(dispatchBatch[i - 1]);
+    }
+
+    dispatchBatch.clear();
+    return !messageQueue->isEmpty();
+}
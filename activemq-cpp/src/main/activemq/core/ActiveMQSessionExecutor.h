@@ -26,6 +26,8 @@
 #include <activemq/threads/TaskRunner.h>
 #include <decaf/lang/Pointer.h>
 
+#include <vector>
+
 namespace activemq {
 namespace core {
 namespace kernels {
@@ -53,6 +55,9 @@ namespace kernels {
         /** The Dispatcher TaskRunner */
         Pointer<activemq::threads::TaskRunner> taskRunner;
 
+        /** Messages taken from the queue in one batch, only used from iterate. */
+        std::vector< Pointer<MessageDispatch> > dispatchBatch;
+
     private:
 
         ActiveMQSessionExecutor(const ActiveMQSessionExecutor&);
@@ -142,6 +147,20 @@ namespace kernels {
             this->messageQueue->clear();
         }
 
+        /**
+         * @return the number of messages waiting to be dispatched.
+         */
+        virtual int size() const {
+            return this->messageQueue->size();
+        }
+
+        /**
+         * @return the bytes of the messages waiting to be dispatched.
+         */
+        long long getMemoryUsage() const {
+            return this->messageQueue->getMemoryUsage();
+        }
+
         /**
          * Iterates on the MessageDispatchChannel sending all pending messages
          * to the Consumers they are destined for.
@@ -166,6 +185,13 @@ namespace kernels {
          */
         virtual void dispatch(const Pointer<MessageDispatch>& data);
 
+        /**
+         * Dispatches a batch of the messages queued on the Session.
+         *
+         * @return true if messages are still queued.
+         */
+        bool dispatchQueued();
+
     };
 
 }}
@@ -25,16 +25,21 @@
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/commands/TransactionInfo.h>
 #include <activemq/commands/Response.h>
+#include <activemq/commands/ExceptionResponse.h>
 #include <activemq/commands/IntegerResponse.h>
 #include <activemq/commands/DataArrayResponse.h>
 #include <activemq/commands/LocalTransactionId.h>
 #include <activemq/commands/XATransactionId.h>
+#include <activemq/transport/ResponseCallback.h>
 #include <activemq/util/CMSExceptionSupport.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
 #include <decaf/util/Iterator.h>
 #include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
 
 using namespace std;
 using namespace cms;
@@ -43,6 +48,7 @@ using namespace activemq::core;
 using namespace activemq::core::kernels;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
+using namespace activemq::transport;
 using namespace activemq::util;
 using namespace decaf;
 using namespace decaf::lang;
@@ -50,10 +56,341 @@ using namespace decaf::lang::exceptions;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Records the broker's answer to a TransactionInfo, owned jointly by the pending
+     * operation and the transport which may answer after the operation was forgotten.
+     */
+    class TransactionResponse : public ResponseCallback {
+    private:
+
+        TransactionResponse(const TransactionResponse&);
+        TransactionResponse& operator= (const TransactionResponse&);
+
+    public:
+
+        CountDownLatch answered;
+        Pointer<Response> response;
+
+    public:
+
+        TransactionResponse() : ResponseCallback(), answered(1), response() {}
+
+        virtual ~TransactionResponse() {}
+
+        virtual void onComplete(Pointer<commands::Response> response) {
+            this->response = response;
+            this->answered.countDown();
+        }
+    };
+
+    /**
+     * Holds a commit write of the connection open for as long as it is in scope.
+     */
+    class CommitWrite {
+    private:
+
+        CommitWrite(const CommitWrite&);
+        CommitWrite& operator= (const CommitWrite&);
+
+    private:
+
+        ActiveMQConnection* connection;
+
+    public:
+
+        CommitWrite(ActiveMQConnection* connection) : connection(NULL) {
+            if (connection->beginCommitWrite()) {
+                this->connection = connection;
+            }
+        }
+
+        ~CommitWrite() {
+            try {
+                end();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        void end() {
+            if (this->connection != NULL) {
+                ActiveMQConnection* opened = this->connection;
+                this->connection = NULL;
+                opened->endCommitWrite();
+            }
+        }
+    };
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq{
 namespace core{
 
+    /**
+     * A commit that was sent to the broker along with the Synchronizations of the
+     * transaction it ended, which are run once by whoever first waits for the answer.
+     */
+    class PendingCommit : public ActiveMQTransactionContext::CommitFuture {
+    private:
+
+        PendingCommit(const PendingCommit&);
+        PendingCommit& operator= (const PendingCommit&);
+
+    private:
+
+        Pointer<TransactionResponse> answer;
+        StlSet< Pointer<Synchronization> > synchronizations;
+        Mutex mutex;
+        bool finished;
+        Pointer<ActiveMQException> error;
+
+    public:
+
+        // A commit with nothing to send, complete from the start.
+        PendingCommit() : answer(new TransactionResponse()), synchronizations(), mutex(), finished(true), error() {
+            this->answer->answered.countDown();
+        }
+
+        PendingCommit(const StlSet< Pointer<Synchronization> >& synchronizations) :
+            answer(new TransactionResponse()), synchronizations(synchronizations), mutex(), finished(false), error() {
+        }
+
+        virtual ~PendingCommit() {}
+
+        Pointer<ResponseCallback> getCallback() const {
+            return this->answer;
+        }
+
+        // The commit never reached the broker, the first failure wins over a late answer.
+        void failed(const Exception& ex) {
+            synchronized(&this->mutex) {
+                if (this->answer->answered.getCount() > 0 && this->error == NULL) {
+                    this->error.reset(new ActiveMQException(ex));
+                }
+            }
+            this->answer->answered.countDown();
+        }
+
+        virtual bool isDone() const {
+            return this->answer->answered.getCount() == 0;
+        }
+
+        virtual void await() {
+            try {
+                finish();
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+        }
+
+        virtual bool await(long long millisecs) {
+            try {
+                if (!this->answer->answered.await(millisecs)) {
+                    return false;
+                }
+                finish();
+                return true;
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+        }
+
+        /**
+         * Waits for the answer, runs the Synchronizations the first time through and
+         * throws the commit's error every time.
+         */
+        void finish() {
+
+            synchronized(&this->mutex) {
+
+                if (!this->finished) {
+                    this->finished = true;
+
+                    this->answer->answered.await();
+
+                    if (this->error == NULL) {
+                        ExceptionResponse* exceptionResponse =
+                            dynamic_cast<ExceptionResponse*>(this->answer->response.get());
+                        if (exceptionResponse != NULL) {
+                            this->error.reset(new ActiveMQException(
+                                exceptionResponse->getException()->createExceptionObject()));
+                        } else if (this->answer->response == NULL) {
+                            this->error.reset(new ActiveMQException(__FILE__, __LINE__,
+                                "No valid response received for the commit, check broker."));
+                        }
+                    }
+
+                    notifySynchronizations(this->error == NULL);
+                }
+            }
+
+            if (this->error != NULL) {
+                throw ActiveMQException(*this->error);
+            }
+        }
+
+    private:
+
+        void notifySynchronizations(bool committed) {
+
+            std::auto_ptr<decaf::util::Iterator< Pointer<Synchronization> > > iter(
+                this->synchronizations.iterator());
+
+            try {
+                while (iter->hasNext()) {
+                    if (committed) {
+                        iter->next()->afterCommit();
+                    } else {
+                        iter->next()->afterRollback();
+                    }
+                }
+            } catch (...) {
+                this->synchronizations.clear();
+                throw;
+            }
+
+            this->synchronizations.clear();
+        }
+    };
+
+    /**
+     * An XA request that was sent to the broker, the Synchronizations its outcome calls
+     * for are run by the first call to get.
+     */
+    class PendingXAOperation : public ActiveMQTransactionContext::XAFuture {
+    private:
+
+        PendingXAOperation(const PendingXAOperation&);
+        PendingXAOperation& operator= (const PendingXAOperation&);
+
+    private:
+
+        ActiveMQTransactionContext* context;
+        int type;
+        Pointer<TransactionResponse> answer;
+        Mutex mutex;
+        bool finished;
+        int result;
+        Pointer<ActiveMQException> sendError;
+        Pointer<XAException> error;
+
+    public:
+
+        PendingXAOperation(ActiveMQTransactionContext* context, int type) :
+            context(context), type(type), answer(new TransactionResponse()), mutex(),
+            finished(false), result(XAResource::XA_OK), sendError(), error() {
+        }
+
+        virtual ~PendingXAOperation() {}
+
+        void send(Pointer<TransactionInfo> info) {
+            try {
+                this->context->connection->checkClosedOrFailed();
+                this->context->connection->ensureConnectionInfoSent();
+                this->context->connection->getTransport().asyncRequest(info, this->answer);
+            } catch (Exception& ex) {
+                this->sendError.reset(new ActiveMQException(ex));
+                this->answer->answered.countDown();
+            }
+        }
+
+        virtual bool isDone() const {
+            return this->answer->answered.getCount() == 0;
+        }
+
+        virtual bool await(long long millisecs) {
+            try {
+                return this->answer->answered.await(millisecs);
+            } catch (InterruptedException& ex) {
+                Thread::currentThread()->interrupt();
+                throw XAException(XAException::XAER_RMFAIL);
+            }
+        }
+
+        virtual int get() {
+
+            synchronized(&this->mutex) {
+                if (!this->finished) {
+                    this->finished = true;
+                    try {
+                        this->answer->answered.await();
+                    } catch (InterruptedException& ex) {
+                        Thread::currentThread()->interrupt();
+                        this->sendError.reset(new ActiveMQException(ex));
+                    }
+                    settle();
+                }
+            }
+
+            if (this->error != NULL) {
+                throw XAException(*this->error);
+            }
+
+            return this->result;
+        }
+
+    private:
+
+        void settle() {
+
+            try {
+
+                if (this->sendError != NULL) {
+                    throw ActiveMQException(*this->sendError);
+                }
+
+                Pointer<Response> response = this->answer->response;
+                ExceptionResponse* exceptionResponse = dynamic_cast<ExceptionResponse*>(response.get());
+
+                if (exceptionResponse != NULL) {
+                    throw exceptionResponse->getException()->createExceptionObject();
+                } else if (response == NULL) {
+                    throw ActiveMQException(__FILE__, __LINE__, "No valid response received, check broker.");
+                }
+
+                if (this->type == ActiveMQConstants::TRANSACTION_STATE_PREPARE) {
+                    Pointer<IntegerResponse> vote = response.dynamicCast<IntegerResponse>();
+                    this->result = vote->getResult();
+                    if (this->result == XAResource::XA_RDONLY) {
+                        // transaction stops now, may be syncs that need a callback
+                        this->context->afterCommit();
+                    }
+                } else if (this->type == ActiveMQConstants::TRANSACTION_STATE_ROLLBACK) {
+                    this->context->afterRollback();
+                } else {
+                    this->context->afterCommit();
+                }
+
+            } catch (Exception& ex) {
+                fail(ex);
+            } catch (CMSException& ex) {
+                fail(ex);
+            }
+        }
+
+        template<typename E>
+        void fail(E& ex) {
+
+            if (this->type != ActiveMQConstants::TRANSACTION_STATE_ROLLBACK) {
+                try {
+                    this->context->afterRollback();
+                } catch (...) {
+                }
+            }
+
+            this->error.reset(new XAException(this->context->toXAException(ex)));
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    ActiveMQTransactionContext::CommitFuture::~CommitFuture() {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    ActiveMQTransactionContext::XAFuture::~XAFuture() {
+    }
+
     class TxContextData {
     private:
 
@@ -69,7 +406,10 @@ namespace core{
         Pointer<Xid> associatedXid;
         int beforeEndIndex;
 
-        TxContextData() : transactionId(), associatedXid(), beforeEndIndex() {
+        // The last commitAsync until the session has waited for it.
+        Pointer<PendingCommit> pendingCommit;
+
+        TxContextData() : transactionId(), associatedXid(), beforeEndIndex(), pendingCommit() {
         }
 
     };
@@ -191,30 +531,34 @@ void ActiveMQTransactionContext::commit() {
             throw cms::TransactionInProgressException("Cannot Commit a local transaction while an XA Transaction is in progress.");
         }
 
-        try {
-            this->beforeEnd();
-        } catch (cms::CMSException& ex) {
-            rollback();
-            throw;
+        completePendingCommit();
+        startCommit()->finish();
+    }
+    AMQ_CATCH_RETHROW(cms::CMSException)
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTransactionContext::CommitFuture> ActiveMQTransactionContext::commitAsync() {
+
+    try{
+
+        if (isInXATransaction()) {
+            throw cms::TransactionInProgressException("Cannot Commit a local transaction while an XA Transaction is in progress.");
         }
 
-        if (isInTransaction()) {
-            Pointer<TransactionInfo> info(new TransactionInfo());
-            info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
-            info->setTransactionId(this->context->transactionId);
-            info->setType(ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE);
+        // The consumers must see the previous outcome before this transaction's acks.
+        completePendingCommit();
 
-            // Before we send the command NULL the id in case of an exception.
-            this->context->transactionId.reset(NULL);
+        Pointer<PendingCommit> pending = startCommit();
 
-            try {
-                this->connection->syncRequest(info);
-                this->afterCommit();
-            } catch(cms::CMSException& ex) {
-                this->afterRollback();
-                throw;
-            }
+        synchronized(&this->synchronizations) {
+            this->context->pendingCommit = pending;
         }
+
+        return pending;
     }
     AMQ_CATCH_RETHROW(cms::CMSException)
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -222,6 +566,68 @@ void ActiveMQTransactionContext::commit() {
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQTransactionContext::completePendingCommit() {
+
+    Pointer<PendingCommit> pending;
+
+    synchronized(&this->synchronizations) {
+        pending.swap(this->context->pendingCommit);
+    }
+
+    if (pending != NULL) {
+        try {
+            pending->finish();
+        } catch (ActiveMQException& ex) {
+            // Reported through the commit's future.
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<PendingCommit> ActiveMQTransactionContext::startCommit() {
+
+    // The acks the consumers send from beforeEnd leave in the same flush as the commit,
+    // along with the commits of other sessions when the connection batches them.
+    CommitWrite write(this->connection);
+
+    try {
+        this->beforeEnd();
+    } catch (cms::CMSException& ex) {
+        write.end();
+        rollback();
+        throw;
+    }
+
+    if (!isInTransaction()) {
+        return Pointer<PendingCommit>(new PendingCommit());
+    }
+
+    Pointer<TransactionInfo> info(new TransactionInfo());
+    info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
+    info->setTransactionId(this->context->transactionId);
+    info->setType(ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE);
+
+    // Before we send the command NULL the id in case of an exception.
+    this->context->transactionId.reset(NULL);
+
+    // The next transaction registers its own Synchronizations while this one is in flight.
+    Pointer<PendingCommit> pending;
+    synchronized(&this->synchronizations) {
+        pending.reset(new PendingCommit(this->synchronizations));
+        this->synchronizations.clear();
+    }
+
+    try {
+        this->connection->getTransport().asyncRequest(info, pending->getCallback());
+        write.end();
+    } catch (Exception& ex) {
+        pending->failed(ex);
+    }
+
+    return pending;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQTransactionContext::rollback() {
 
@@ -231,6 +637,8 @@ void ActiveMQTransactionContext::rollback() {
             throw cms::TransactionInProgressException("Cannot Rollback a local transaction while an XA Transaction is in progress.");
         }
 
+        completePendingCommit();
+
         try {
             this->beforeEnd();
         } catch (cms::TransactionRolledBackException& ex) {
@@ -409,6 +817,11 @@ void ActiveMQTransactionContext::start(const Xid* xid, int flags) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int ActiveMQTransactionContext::prepare(const Xid* xid) {
+    return prepareAsync(xid)->get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTransactionContext::XAFuture> ActiveMQTransactionContext::prepareAsync(const Xid* xid) {
 
     // We allow interleaving multiple transactions, so we don't limit prepare to the associated xid.
     Pointer<XATransactionId> x;
@@ -420,50 +833,25 @@ int ActiveMQTransactionContext::prepare(const Xid* xid) {
         x.reset(new XATransactionId(xid));
     }
 
-    try {
-
-        Pointer<TransactionInfo> info(new TransactionInfo());
-        info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
-        info->setTransactionId(x);
-        info->setType(ActiveMQConstants::TRANSACTION_STATE_PREPARE);
-
-        // Find out if the server wants to commit or rollback.
-        Pointer<Response> response = this->connection->syncRequest(info);
-
-        Pointer<IntegerResponse> intResponse = response.dynamicCast<IntegerResponse>();
-
-        if (XAResource::XA_RDONLY == intResponse->getResult()) {
-
-            // transaction stops now, may be syncs that need a callback
-            this->afterCommit();
-        }
-
-        return intResponse->getResult();
-
-    } catch (Exception& e) {
-
-        try {
-            this->afterRollback();
-        } catch (...) {
-        }
-
-        throw toXAException(e);
-
-    } catch (CMSException& e) {
-
-        try {
-            this->afterRollback();
-        } catch (...) {
-        }
+    // Find out if the server wants to commit or rollback.
+    Pointer<TransactionInfo> info(new TransactionInfo());
+    info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
+    info->setTransactionId(x);
+    info->setType(ActiveMQConstants::TRANSACTION_STATE_PREPARE);
 
-        throw toXAException(e);
-    }
+    Pointer<PendingXAOperation> pending(new PendingXAOperation(this, ActiveMQConstants::TRANSACTION_STATE_PREPARE));
+    pending->send(info);
 
-    return 0;
+    return pending;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQTransactionContext::commit(const Xid* xid, bool onePhase) {
+    commitAsync(xid, onePhase)->get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTransactionContext::XAFuture> ActiveMQTransactionContext::commitAsync(const Xid* xid, bool onePhase) {
 
     // We allow interleaving multiple transactions, so we don't limit prepare to the associated xid.
     Pointer<XATransactionId> x;
@@ -475,43 +863,27 @@ void ActiveMQTransactionContext::commit(const Xid* xid, bool onePhase) {
         x.reset(new XATransactionId(xid));
     }
 
-    try {
-
-        this->connection->checkClosedOrFailed();
-        this->connection->ensureConnectionInfoSent();
-
-        // Let the server know that the tx is rollback.
-        Pointer<TransactionInfo> info(new TransactionInfo());
-        info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
-        info->setTransactionId(x);
-        info->setType(onePhase ? ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE : ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE);
-
-        this->connection->syncRequest(info);
-
-        this->afterCommit();
-
-    } catch (Exception& ex) {
-
-        try {
-            this->afterRollback();
-        } catch (...) {
-        }
-
-        throw toXAException(ex);
+    int type = onePhase ? ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE :
+                          ActiveMQConstants::TRANSACTION_STATE_COMMITTWOPHASE;
 
-    } catch (CMSException& e) {
+    Pointer<TransactionInfo> info(new TransactionInfo());
+    info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
+    info->setTransactionId(x);
+    info->setType(type);
 
-        try {
-            this->afterRollback();
-        } catch (...) {
-        }
+    Pointer<PendingXAOperation> pending(new PendingXAOperation(this, type));
+    pending->send(info);
 
-        throw toXAException(e);
-    }
+    return pending;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQTransactionContext::rollback(const Xid* xid) {
+    rollbackAsync(xid)->get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTransactionContext::XAFuture> ActiveMQTransactionContext::rollbackAsync(const Xid* xid) {
 
     // We allow interleaving multiple transactions, so we don't limit prepare to the associated xid.
     Pointer<XATransactionId> x;
@@ -526,25 +898,86 @@ void ActiveMQTransactionContext::rollback(const Xid* xid) {
         x.reset(new XATransactionId(xid));
     }
 
-    try {
+    // Let the server know that the tx is rollback.
+    Pointer<TransactionInfo> info(new TransactionInfo());
+    info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
+    info->setTransactionId(x);
+    info->setType(ActiveMQConstants::TRANSACTION_STATE_ROLLBACK);
 
-        this->connection->checkClosedOrFailed();
-        this->connection->ensureConnectionInfoSent();
+    Pointer<PendingXAOperation> pending(new PendingXAOperation(this, ActiveMQConstants::TRANSACTION_STATE_ROLLBACK));
+    pending->send(info);
 
-        // Let the server know that the tx is rollback.
-        Pointer<TransactionInfo> info(new TransactionInfo());
-        info->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
-        info->setTransactionId(x);
-        info->setType(ActiveMQConstants::TRANSACTION_STATE_ROLLBACK);
+    return pending;
+}
 
-        this->connection->syncRequest(info);
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQTransactionContext::commitBranches(const std::vector<ActiveMQTransactionContext*>& resources,
+                                                const std::vector<const Xid*>& xids) {
 
-        this->afterRollback();
+    if (resources.size() != xids.size()) {
+        throw XAException(XAException::XAER_INVAL);
+    }
 
-    } catch (Exception& ex) {
-        throw toXAException(ex);
-    } catch (CMSException& e) {
-        throw toXAException(e);
+    if (resources.empty()) {
+        return;
+    }
+
+    // A lone branch has nobody to agree with.
+    if (resources.size() == 1) {
+        resources[0]->commit(xids[0], true);
+        return;
+    }
+
+    std::vector< Pointer<XAFuture> > votes;
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        votes.push_back(resources[i]->prepareAsync(xids[i]));
+    }
+
+    // A branch that failed to prepare was rolled back by the broker already.
+    std::vector<bool> prepared(resources.size(), false);
+    std::auto_ptr<XAException> failure;
+
+    for (std::size_t i = 0; i < votes.size(); ++i) {
+        try {
+            prepared[i] = votes[i]->get() == XAResource::XA_OK;
+        } catch (XAException& ex) {
+            if (failure.get() == NULL) {
+                failure.reset(new XAException(ex));
+            }
+        }
+    }
+
+    std::vector< Pointer<XAFuture> > outcomes;
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        if (!prepared[i]) {
+            continue;
+        }
+
+        try {
+            if (failure.get() == NULL) {
+                outcomes.push_back(resources[i]->commitAsync(xids[i], false));
+            } else {
+                outcomes.push_back(resources[i]->rollbackAsync(xids[i]));
+            }
+        } catch (XAException& ex) {
+            if (failure.get() == NULL) {
+                failure.reset(new XAException(ex));
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < outcomes.size(); ++i) {
+        try {
+            outcomes[i]->get();
+        } catch (XAException& ex) {
+            if (failure.get() == NULL) {
+                failure.reset(new XAException(ex));
+            }
+        }
+    }
+
+    if (failure.get() != NULL) {
+        throw XAException(*failure);
     }
 }
 
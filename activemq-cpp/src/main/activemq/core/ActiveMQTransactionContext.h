@@ -18,6 +18,7 @@
 #define _ACTIVEMQ_CORE_ACTIVEMQTRANSACTIONCONTEXT_H_
 
 #include <memory>
+#include <vector>
 
 #include <cms/Message.h>
 #include <cms/XAResource.h>
@@ -46,6 +47,8 @@ namespace kernels {
     class LocalTransactionEventListener;
     class ActiveMQConnection;
     class TxContextData;
+    class PendingCommit;
+    class PendingXAOperation;
 
     /**
      * Transaction Management class, hold messages that are to be redelivered
@@ -57,8 +60,90 @@ namespace kernels {
      * @since 2.0
      */
     class AMQCPP_API ActiveMQTransactionContext : public cms::XAResource {
+    public:
+
+        /**
+         * The outcome of a local transaction commit started with commitAsync.
+         *
+         * The Synchronizations of the committed transaction are not run by the thread
+         * that receives the broker's answer, they are run by the first call that waits
+         * for the outcome.  That is await, or the session itself before it delivers the
+         * next message, commits or rolls back again, or closes.  A failed commit is only
+         * reported through the future.
+         */
+        class AMQCPP_API CommitFuture {
+        public:
+
+            virtual ~CommitFuture();
+
+            /**
+             * @return true once the broker has answered the commit.
+             */
+            virtual bool isDone() const = 0;
+
+            /**
+             * Waits for the broker to answer the commit.
+             *
+             * @throws CMSException if the commit failed and the transaction was rolled back.
+             */
+            virtual void await() = 0;
+
+            /**
+             * Waits at most the given time for the broker to answer the commit.
+             *
+             * @param millisecs
+             *      The time to wait in milliseconds.
+             *
+             * @return true if the commit completed, false if the time ran out first.
+             *
+             * @throws CMSException if the commit failed and the transaction was rolled back.
+             */
+            virtual bool await(long long millisecs) = 0;
+
+        };
+
+        /**
+         * The outcome of an XA prepare, commit or rollback started without waiting for the
+         * broker's answer.  As with CommitFuture the Synchronizations the outcome calls for
+         * are run by the first call to get, on the caller's thread.  A future is only valid
+         * while the session of the transaction context that created it is open.
+         */
+        class AMQCPP_API XAFuture {
+        public:
+
+            virtual ~XAFuture();
+
+            /**
+             * @return true once the broker has answered the request.
+             */
+            virtual bool isDone() const = 0;
+
+            /**
+             * Waits at most the given time for the broker to answer the request.
+             *
+             * @param millisecs
+             *      The time to wait in milliseconds.
+             *
+             * @return true if the answer arrived, get then returns without blocking.
+             */
+            virtual bool await(long long millisecs) = 0;
+
+            /**
+             * Waits for the broker to answer the request.
+             *
+             * @return the vote of a prepare, XA_OK or XA_RDONLY, and XA_OK for a commit
+             *         or rollback.
+             *
+             * @throws XAException if the request failed.
+             */
+            virtual int get() = 0;
+
+        };
+
     private:
 
+        friend class PendingXAOperation;
+
         // Internal structure to hold all class TX data.
         TxContextData* context;
 
@@ -115,6 +200,25 @@ namespace kernels {
          */
         virtual void commit();
 
+        /**
+         * Commits the current Transaction without waiting for the broker's answer.  The
+         * acks of the transaction's consumers and the commit leave in one flush, the
+         * session may start its next transaction while the commit is in flight but won't
+         * deliver another message until the commit has completed.
+         *
+         * @return the future that reports the outcome of the commit.
+         *
+         * @throw ActiveMQException if the commit can't be sent.
+         */
+        virtual Pointer<CommitFuture> commitAsync();
+
+        /**
+         * Waits for a commit started with commitAsync to complete and runs the
+         * Synchronizations of its transaction, does nothing when there is none.  Errors
+         * are left for the commit's future to report.
+         */
+        virtual void completePendingCommit();
+
         /**
          * Rollback the current Transaction
          * @throw ActiveMQException
@@ -153,6 +257,62 @@ namespace kernels {
          */
         virtual bool isInXATransaction() const;
 
+        /**
+         * Sends the prepare of an XA transaction branch without waiting for the vote.
+         *
+         * @param xid
+         *      The Xid of the branch, which must have been ended.
+         *
+         * @return the future that reports the vote.
+         *
+         * @throws XAException if the request can't be made.
+         */
+        virtual Pointer<XAFuture> prepareAsync(const cms::Xid* xid);
+
+        /**
+         * Sends the commit of an XA transaction branch without waiting for the outcome.
+         *
+         * @param xid
+         *      The Xid of the branch, which must have been ended.
+         * @param onePhase
+         *      True to commit a branch that wasn't prepared in a single phase.
+         *
+         * @return the future that reports the outcome.
+         *
+         * @throws XAException if the request can't be made.
+         */
+        virtual Pointer<XAFuture> commitAsync(const cms::Xid* xid, bool onePhase);
+
+        /**
+         * Sends the rollback of an XA transaction branch without waiting for the outcome.
+         *
+         * @param xid
+         *      The Xid of the branch.
+         *
+         * @return the future that reports the outcome.
+         *
+         * @throws XAException if the request can't be made.
+         */
+        virtual Pointer<XAFuture> rollbackAsync(const cms::Xid* xid);
+
+        /**
+         * Completes a global transaction whose branches are all ActiveMQ resources, each
+         * phase is sent to every branch before the answers of any are awaited so that the
+         * transaction costs about one round trip per phase however many branches it has.
+         * A transaction with a single branch is committed in one phase.  If a branch votes
+         * to roll back, or fails to prepare, the prepared branches are rolled back.
+         *
+         * @param resources
+         *      The transaction contexts the branches were run on.
+         * @param xids
+         *      The Xid of each branch, in the order of the resources.
+         *
+         * @throws XAException with the error of the first branch that failed, after every
+         *         branch has answered.
+         */
+        static void commitBranches(const std::vector<ActiveMQTransactionContext*>& resources,
+                                   const std::vector<const cms::Xid*>& xids);
+
     public:  // XAResource implementation.
 
         virtual void commit(const cms::Xid* xid, bool onePhase);
@@ -183,6 +343,8 @@ namespace kernels {
         cms::XAException toXAException(cms::CMSException& ex);
         cms::XAException toXAException(decaf::lang::Exception& ex);
 
+        Pointer<PendingCommit> startCommit();
+
         void beforeEnd();
         void afterCommit();
         void afterRollback();
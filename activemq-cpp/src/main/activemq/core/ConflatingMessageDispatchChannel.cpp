@@ -0,0 +1,291 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConflatingMessageDispatchChannel.h"
+
+#include <activemq/commands/Message.h>
+#include <activemq/util/PrimitiveMap.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+ConflatingMessageDispatchChannel::ConflatingMessageDispatchChannel(const std::string& keyProperty) :
+    keyProperty(keyProperty), closed(false), running(false), mutex(), entries(), keys(), superseded(), memoryUsage(0) {
+    this->mutex.setProfilingSite(DEFAULT_PROFILING_SITE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConflatingMessageDispatchChannel::~ConflatingMessageDispatchChannel() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ConflatingMessageDispatchChannel::keyOf(const Pointer<MessageDispatch>& message, std::string& key) const {
+
+    // Read only access so a forwarded message keeps its marshaled properties.
+    const Message* payload = message->getMessage().get();
+    if (payload == NULL) {
+        return false;
+    }
+
+    if (this->keyProperty == "JMSXGroupID") {
+        key = payload->getGroupID();
+        return !key.empty();
+    }
+
+    const util::PrimitiveMap& properties = payload->getMessageProperties();
+    if (!properties.containsKey(this->keyProperty)) {
+        return false;
+    }
+
+    key = properties.get(this->keyProperty).toString();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
+
+    Entry entry(message);
+    entry.keyed = keyOf(message, entry.key);
+
+    synchronized(&mutex) {
+
+        if (entry.keyed) {
+            std::map<std::string, EntryList::iterator>::iterator pending = this->keys.find(entry.key);
+            if (pending != this->keys.end()) {
+                Pointer<MessageDispatch>& replaced = pending->second->dispatch;
+                this->memoryUsage += getMemorySize(message) - getMemorySize(replaced);
+                this->superseded.push_back(replaced);
+                replaced = message;
+                return;
+            }
+        }
+
+        this->entries.push_back(entry);
+        if (entry.keyed) {
+            this->keys[entry.key] = --this->entries.end();
+        }
+        this->memoryUsage += getMemorySize(message);
+        this->mutex.notify();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
+
+    // Put back ahead of everything, it stands for no key since a newer value of its key
+    // may be pending already and must not be replaced by this older one.
+    synchronized(&mutex) {
+        this->entries.push_front(Entry(message));
+        this->memoryUsage += getMemorySize(message);
+        this->mutex.notify();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ConflatingMessageDispatchChannel::takeSuperseded(std::vector< Pointer<MessageDispatch> >& buffer) {
+
+    int count = 0;
+
+    synchronized(&mutex) {
+        count = (int) this->superseded.size();
+        buffer.insert(buffer.end(), this->superseded.begin(), this->superseded.end());
+        this->superseded.clear();
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ConflatingMessageDispatchChannel::isEmpty() const {
+    synchronized(&mutex) {
+        return this->entries.empty();
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> ConflatingMessageDispatchChannel::dequeue(long long timeout) {
+
+    synchronized(&mutex) {
+        // Wait until the channel is ready to deliver messages.
+        while (timeout != 0 && !closed && (this->entries.empty() || !running)) {
+            if (timeout == -1) {
+                this->mutex.wait();
+            } else {
+                this->mutex.wait((unsigned long) timeout);
+                break;
+            }
+        }
+
+        if (closed || !running || this->entries.empty()) {
+            return Pointer<MessageDispatch>();
+        }
+
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> ConflatingMessageDispatchChannel::dequeueNoWait() {
+    synchronized(&mutex) {
+        if (closed || !running || this->entries.empty()) {
+            return Pointer<MessageDispatch>();
+        }
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ConflatingMessageDispatchChannel::dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max) {
+    int count = 0;
+
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+
+        while (count < max && !this->entries.empty()) {
+            buffer.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> ConflatingMessageDispatchChannel::peek() const {
+    synchronized(&mutex) {
+        if (closed || !running || this->entries.empty()) {
+            return Pointer<MessageDispatch>();
+        }
+        return this->entries.front().dispatch;
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::start() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = true;
+            this->mutex.notifyAll();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::stop() {
+    synchronized(&mutex) {
+        running = false;
+        this->mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::close() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = false;
+            closed = true;
+        }
+        this->mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::clear() {
+    synchronized(&mutex) {
+        this->entries.clear();
+        this->keys.clear();
+        this->memoryUsage = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ConflatingMessageDispatchChannel::size() const {
+    synchronized(&mutex) {
+        return (int) this->entries.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ConflatingMessageDispatchChannel::getMemoryUsage() const {
+    synchronized(&mutex) {
+        return this->memoryUsage;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<Pointer<MessageDispatch> > ConflatingMessageDispatchChannel::removeAll() {
+    std::vector<Pointer<MessageDispatch> > result;
+
+    synchronized(&mutex) {
+        result.reserve(this->entries.size());
+        EntryList::const_iterator iter = this->entries.begin();
+        for (; iter != this->entries.end(); ++iter) {
+            result.push_back(iter->dispatch);
+        }
+        this->entries.clear();
+        this->keys.clear();
+        this->memoryUsage = 0;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> ConflatingMessageDispatchChannel::removeFirst() {
+
+    EntryList::iterator first = this->entries.begin();
+    Pointer<MessageDispatch> result = first->dispatch;
+
+    // An entry put back with enqueueFirst has no key, the key of a pending one is
+    // only forgotten if it still points here.
+    if (first->keyed) {
+        std::map<std::string, EntryList::iterator>::iterator pending = this->keys.find(first->key);
+        if (pending != this->keys.end() && pending->second == first) {
+            this->keys.erase(pending);
+        }
+    }
+
+    this->entries.pop_front();
+    this->memoryUsage -= getMemorySize(result);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannel::setProfilingSite(const std::string& site) {
+    this->mutex.setProfilingSite(site);
+}
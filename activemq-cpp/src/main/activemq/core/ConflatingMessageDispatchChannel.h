@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_CONFLATINGMESSAGEDISPATCHCHANNEL_H_
+#define _ACTIVEMQ_CORE_CONFLATINGMESSAGEDISPATCHCHANNEL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/core/MessageDispatchChannel.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * A MessageDispatchChannel that keeps only the latest pending message for each key.
+     * The key of a message is the value of a configured message property, or its group
+     * when the property is JMSXGroupID.  A message whose key is already pending replaces
+     * the pending one in its place in the queue, so a consumer that falls behind goes
+     * straight to the latest values and the channel holds at most one message per key.
+     * Messages without the key are queued as in a FIFO channel.
+     *
+     * The messages replaced were never delivered, they are kept until the consumer
+     * takes them with takeSuperseded so it can acknowledge them together.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ConflatingMessageDispatchChannel : public MessageDispatchChannel {
+    private:
+
+        struct Entry {
+
+            Pointer<MessageDispatch> dispatch;
+            std::string key;
+            bool keyed;
+
+            Entry(const Pointer<MessageDispatch>& dispatch) : dispatch(dispatch), key(), keyed(false) {}
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::string keyProperty;
+
+        bool closed;
+        bool running;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        EntryList entries;
+        std::map<std::string, EntryList::iterator> keys;
+        std::vector< Pointer<MessageDispatch> > superseded;
+
+        // Total size of the queued messages.
+        long long memoryUsage;
+
+    private:
+
+        ConflatingMessageDispatchChannel(const ConflatingMessageDispatchChannel&);
+        ConflatingMessageDispatchChannel& operator=(const ConflatingMessageDispatchChannel&);
+
+    public:
+
+        /**
+         * Creates a new channel conflating the messages on the given key.
+         *
+         * @param keyProperty
+         *      The name of the message property holding the key, or JMSXGroupID.
+         */
+        ConflatingMessageDispatchChannel(const std::string& keyProperty);
+
+        virtual ~ConflatingMessageDispatchChannel();
+
+        /**
+         * @return the name of the property the messages are conflated on.
+         */
+        const std::string& getKeyProperty() const {
+            return this->keyProperty;
+        }
+
+        /**
+         * Moves the messages that were replaced by newer ones since the last call into
+         * the given vector, in the order they were replaced.
+         *
+         * @param buffer
+         *      The vector the replaced messages are appended to.
+         *
+         * @return the number of messages appended.
+         */
+        int takeSuperseded(std::vector< Pointer<MessageDispatch> >& buffer);
+
+        virtual void enqueue(const Pointer<MessageDispatch>& message);
+
+        virtual void enqueueFirst(const Pointer<MessageDispatch>& message);
+
+        virtual bool isEmpty() const;
+
+        virtual bool isClosed() const {
+            return this->closed;
+        }
+
+        virtual bool isRunning() const {
+            return this->running;
+        }
+
+        virtual Pointer<MessageDispatch> dequeue(long long timeout);
+
+        virtual Pointer<MessageDispatch> dequeueNoWait();
+
+        virtual int dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max);
+
+        virtual Pointer<MessageDispatch> peek() const;
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void clear();
+
+        virtual int size() const;
+
+        virtual long long getMemoryUsage() const;
+
+        virtual std::vector<Pointer<MessageDispatch> > removeAll();
+
+        virtual void setProfilingSite(const std::string& site);
+
+    public:
+
+        virtual void lock() {
+            mutex.lock();
+        }
+
+        virtual bool tryLock() {
+            return mutex.tryLock();
+        }
+
+        virtual void unlock() {
+            mutex.unlock();
+        }
+
+        virtual void wait() {
+            mutex.wait();
+        }
+
+        virtual void wait(long long millisecs) {
+            mutex.wait(millisecs);
+        }
+
+        virtual void wait(long long millisecs, int nanos) {
+            mutex.wait(millisecs, nanos);
+        }
+
+        virtual void notify() {
+            mutex.notify();
+        }
+
+        virtual void notifyAll() {
+            mutex.notifyAll();
+        }
+
+    private:
+
+        bool keyOf(const Pointer<MessageDispatch>& message, std::string& key) const;
+
+        Pointer<MessageDispatch> removeFirst();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_CONFLATINGMESSAGEDISPATCHCHANNEL_H_ */
@@ -17,8 +17,7 @@
 
 #include "ConnectionAudit.h"
 
-#include <decaf/util/LinkedHashMap.h>
-#include <decaf/util/StlMap.h>
+#include <decaf/util/concurrent/ConcurrentLRUCache.h>
 
 #include <activemq/core/Dispatcher.h>
 #include <activemq/core/ActiveMQMessageAudit.h>
@@ -40,6 +39,32 @@ using namespace decaf::util::concurrent;
 namespace activemq {
 namespace core {
 
+    /**
+     * Map key that matches destinations by name using the hash each destination
+     * computes once when its name is set, every message carries its own instance
+     * of the destination so the pointers themselves can't be compared.
+     */
+    class DestinationKey {
+    private:
+
+        Pointer<ActiveMQDestination> destination;
+
+    public:
+
+        DestinationKey() : destination() {}
+
+        DestinationKey(const Pointer<ActiveMQDestination>& destination) : destination(destination) {}
+
+        int getHashCode() const {
+            return this->destination->getHashCode();
+        }
+
+        bool operator==(const DestinationKey& other) const {
+            return this->destination->getHashCode() == other.destination->getHashCode() &&
+                   this->destination->getPhysicalName() == other.destination->getPhysicalName();
+        }
+    };
+
     class ConnectionAuditImpl {
     private:
 
@@ -48,12 +73,27 @@ namespace core {
 
     public:
 
-        Mutex mutex;
+        // Audits are kept for this many of the most recently used queues, and as many
+        // dispatchers for topics, as the Java client does.
+        static const int MAXIMUM_AUDITS = 1000;
 
-        StlMap<Pointer<ActiveMQDestination>, Pointer<ActiveMQMessageAudit>, ActiveMQDestination::COMPARATOR> destinations;
-        LinkedHashMap<Dispatcher*, Pointer<ActiveMQMessageAudit> > dispatchers;
+        // Queue audits are found by destination and topic audits by dispatcher, each
+        // cache is segmented so that sessions working on different ones don't share a
+        // lock and a lookup doesn't reorder anything.
+        ConcurrentLRUCache<DestinationKey, Pointer<ActiveMQMessageAudit> > destinations;
+        ConcurrentLRUCache<Dispatcher*, Pointer<ActiveMQMessageAudit> > dispatchers;
 
-        ConnectionAuditImpl() : mutex(), destinations(), dispatchers(1000) {
+        ConnectionAuditImpl() : destinations(MAXIMUM_AUDITS), dispatchers(MAXIMUM_AUDITS) {
+        }
+
+        Pointer<ActiveMQMessageAudit> find(Dispatcher* dispatcher, const Pointer<ActiveMQDestination>& destination) {
+            Pointer<ActiveMQMessageAudit> audit;
+            if (destination->isQueue()) {
+                destinations.get(DestinationKey(destination), audit);
+            } else {
+                dispatchers.get(dispatcher, audit);
+            }
+            return audit;
         }
     };
 }}
@@ -83,41 +123,26 @@ ConnectionAudit::~ConnectionAudit() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionAudit::removeDispatcher(Dispatcher* dispatcher) {
-    synchronized(&this->impl->mutex) {
-        try {
-            this->impl->dispatchers.remove(dispatcher);
-        } catch (NoSuchElementException& ex) {
-        }
-    }
+    this->impl->dispatchers.remove(dispatcher);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool ConnectionAudit::isDuplicate(Dispatcher* dispatcher, Pointer<commands::Message> message) {
-    synchronized(&this->impl->mutex) {
-        if (checkForDuplicates && message != NULL) {
-            Pointer<ActiveMQDestination> destination = message->getDestination();
-            if (destination != NULL) {
+    if (checkForDuplicates && message != NULL) {
+        Pointer<ActiveMQDestination> destination = message->getDestination();
+        if (destination != NULL) {
+            Pointer<ActiveMQMessageAudit> audit = this->impl->find(dispatcher, destination);
+            if (audit == NULL) {
+                audit.reset(new ActiveMQMessageAudit(auditDepth, auditMaximumProducerNumber));
                 if (destination->isQueue()) {
-                    Pointer<ActiveMQMessageAudit> audit;
-                    try {
-                        audit = this->impl->destinations.get(destination);
-                    } catch (NoSuchElementException& ex) {
-                        audit.reset(new ActiveMQMessageAudit(auditDepth, auditMaximumProducerNumber));
-                        this->impl->destinations.put(destination, audit);
-                    }
-                    bool result = audit->isDuplicate(message->getMessageId());
-                    return result;
-                }
-                Pointer<ActiveMQMessageAudit> audit;
-                try {
-                    audit = this->impl->dispatchers.get(dispatcher);
-                } catch (NoSuchElementException& ex) {
-                    audit.reset(new ActiveMQMessageAudit(auditDepth, auditMaximumProducerNumber));
-                    this->impl->dispatchers.put(dispatcher, audit);
+                    audit = this->impl->destinations.putIfAbsent(DestinationKey(destination), audit);
+                } else {
+                    audit = this->impl->dispatchers.putIfAbsent(dispatcher, audit);
                 }
-                bool result = audit->isDuplicate(message->getMessageId());
-                return result;
             }
+
+            // The audit has a lock of its own, the cache is only needed to find it.
+            return audit->isDuplicate(message->getMessageId());
         }
     }
     return false;
@@ -125,22 +150,30 @@ bool ConnectionAudit::isDuplicate(Dispatcher* dispatcher, Pointer<commands::Mess
 
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionAudit::rollbackDuplicate(Dispatcher* dispatcher, Pointer<commands::Message> message) {
-    synchronized(&this->impl->mutex) {
-        if (checkForDuplicates && message != NULL) {
-            Pointer<ActiveMQDestination> destination = message->getDestination();
-            if (destination != NULL) {
-                if (destination->isQueue()) {
-                    try {
-                        Pointer<ActiveMQMessageAudit> audit = this->impl->destinations.get(destination);
-                        audit->rollback(message->getMessageId());
-                    } catch (NoSuchElementException& ex) {}
-                } else {
-                    try {
-                        Pointer<ActiveMQMessageAudit> audit = this->impl->dispatchers.get(dispatcher);
-                        audit->rollback(message->getMessageId());
-                    } catch (NoSuchElementException& ex) {}
-                }
+    if (checkForDuplicates && message != NULL) {
+        Pointer<ActiveMQDestination> destination = message->getDestination();
+        if (destination != NULL) {
+            Pointer<ActiveMQMessageAudit> audit = this->impl->find(dispatcher, destination);
+            if (audit != NULL) {
+                audit->rollback(message->getMessageId());
             }
         }
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ConnectionAudit::getMemoryUsage() const {
+
+    std::vector< Pointer<ActiveMQMessageAudit> > audits = this->impl->destinations.values();
+    std::vector< Pointer<ActiveMQMessageAudit> > dispatchers = this->impl->dispatchers.values();
+    audits.insert(audits.end(), dispatchers.begin(), dispatchers.end());
+
+    // Each audit takes its own lock, they are added up outside the cache's locks.
+    long long usage = 0;
+    std::vector< Pointer<ActiveMQMessageAudit> >::const_iterator audit = audits.begin();
+    for (; audit != audits.end(); ++audit) {
+        usage += (*audit)->getMemoryUsage();
+    }
+
+    return usage;
+}
@@ -65,6 +65,11 @@ namespace core {
 
         void rollbackDuplicate(Dispatcher* dispatcher, decaf::lang::Pointer<commands::Message> message);
 
+        /**
+         * @return the bytes held by the audits of every destination and dispatcher.
+         */
+        long long getMemoryUsage() const;
+
     public:
 
         bool isCheckForDuplicates() const {
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConnectionMetrics.h"
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void addHistogram(std::map<std::string, long long>& values, const std::string& name,
+                      const LatencyHistogram& histogram) {
+
+        values[name + ".count"] = histogram.getCount();
+        values[name + ".min"] = histogram.getMin();
+        values[name + ".max"] = histogram.getMax();
+        values[name + ".mean"] = (long long) histogram.getMean();
+        values[name + ".p50"] = histogram.getValueAtPercentile(50.0);
+        values[name + ".p90"] = histogram.getValueAtPercentile(90.0);
+        values[name + ".p99"] = histogram.getValueAtPercentile(99.0);
+        values[name + ".p999"] = histogram.getValueAtPercentile(99.9);
+    }
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConnectionMetrics::ConnectionMetrics() : messagesSent(), messagesReceived(), acksSent(), syncRequestTime(),
+                                         ackSendTime(), flowControlBlockTime(), prefetchFill(), dispatchQueueDepth() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConnectionMetrics::~ConnectionMetrics() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionMetrics::snapshot(std::map<std::string, long long>& values) const {
+
+    values["messages.sent"] = this->messagesSent.get();
+    values["messages.received"] = this->messagesReceived.get();
+    values["acks.sent"] = this->acksSent.get();
+
+    addHistogram(values, "syncRequest.time", this->syncRequestTime);
+    addHistogram(values, "ack.sendTime", this->ackSendTime);
+    addHistogram(values, "flowControl.blockTime", this->flowControlBlockTime);
+    addHistogram(values, "consumer.prefetchFill", this->prefetchFill);
+    addHistogram(values, "session.dispatchQueueDepth", this->dispatchQueueDepth);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionMetrics::reset() {
+
+    this->messagesSent.reset();
+    this->messagesReceived.reset();
+    this->acksSent.reset();
+
+    this->syncRequestTime.reset();
+    this->ackSendTime.reset();
+    this->flowControlBlockTime.reset();
+    this->prefetchFill.reset();
+    this->dispatchQueueDepth.reset();
+}
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_CONNECTIONMETRICS_H_
+#define _ACTIVEMQ_CORE_CONNECTIONMETRICS_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/LatencyHistogram.h>
+#include <activemq/util/StripedCounter.h>
+
+#include <map>
+#include <string>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Counters and latency histograms that a connection and its sessions, producers and
+     * consumers update as they send and receive, they are always enabled as every update
+     * is a few uncontended atomic operations.  All times are recorded in microseconds.
+     *
+     * The snapshot method exports every value under a fixed name so that the whole set
+     * can be logged or published in one call, each histogram contributes its count, min,
+     * max, mean and the 50th, 90th, 99th and 99.9th percentiles.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ConnectionMetrics {
+    private:
+
+        util::StripedCounter messagesSent;
+        util::StripedCounter messagesReceived;
+        util::StripedCounter acksSent;
+
+        util::LatencyHistogram syncRequestTime;
+        util::LatencyHistogram ackSendTime;
+        util::LatencyHistogram flowControlBlockTime;
+        util::LatencyHistogram prefetchFill;
+        util::LatencyHistogram dispatchQueueDepth;
+
+    private:
+
+        ConnectionMetrics(const ConnectionMetrics&);
+        ConnectionMetrics& operator= (const ConnectionMetrics&);
+
+    public:
+
+        ConnectionMetrics();
+
+        virtual ~ConnectionMetrics();
+
+        /**
+         * @return the count of messages sent by the connection's producers.
+         */
+        util::StripedCounter& getMessagesSent() {
+            return this->messagesSent;
+        }
+
+        /**
+         * @return the count of messages dispatched to the connection's consumers.
+         */
+        util::StripedCounter& getMessagesReceived() {
+            return this->messagesReceived;
+        }
+
+        /**
+         * @return the count of acknowledgements sent by the connection's consumers.
+         */
+        util::StripedCounter& getAcksSent() {
+            return this->acksSent;
+        }
+
+        /**
+         * @return the time taken by each synchronous request to get its response.
+         */
+        util::LatencyHistogram& getSyncRequestTime() {
+            return this->syncRequestTime;
+        }
+
+        /**
+         * @return the time taken to send each acknowledgement.
+         */
+        util::LatencyHistogram& getAckSendTime() {
+            return this->ackSendTime;
+        }
+
+        /**
+         * @return the time each send was blocked waiting for space in a full producer window.
+         */
+        util::LatencyHistogram& getFlowControlBlockTime() {
+            return this->flowControlBlockTime;
+        }
+
+        /**
+         * @return the number of prefetched messages a consumer holds, sampled on each dispatch.
+         */
+        util::LatencyHistogram& getPrefetchFill() {
+            return this->prefetchFill;
+        }
+
+        /**
+         * @return the number of messages queued in a session's dispatch queue, sampled
+         *         each time a message is queued.
+         */
+        util::LatencyHistogram& getDispatchQueueDepth() {
+            return this->dispatchQueueDepth;
+        }
+
+        /**
+         * Adds the current value of every metric to the given map, replacing any values
+         * already stored under the same names.
+         *
+         * @param values
+         *      The map to add the values to.
+         */
+        void snapshot(std::map<std::string, long long>& values) const;
+
+        /**
+         * Sets every metric back to zero.
+         */
+        void reset();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_CONNECTIONMETRICS_H_ */
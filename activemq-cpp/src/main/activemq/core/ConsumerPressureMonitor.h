@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_CONSUMERPRESSUREMONITOR_H_
+#define _ACTIVEMQ_CORE_CONSUMERPRESSUREMONITOR_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Lets the application decide when the consumers of a Connection should stop taking
+     * messages from the broker, for instance when its own work queues or heap are full.
+     * While the monitor reports pressure every consumer of the Connection is suspended,
+     * the broker is sent a prefetch of zero so it stops dispatching without the session
+     * blocking, and the consumers are resumed with their prefetch once it no longer does.
+     *
+     * The monitor is asked as messages arrive and are consumed, it must be quick, must
+     * not block and may be called from several threads at once.  Once the consumers are
+     * suspended no messages may be arriving, so the application should call the
+     * Connection's checkConsumerPressure method when the pressure it reports is relieved.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ConsumerPressureMonitor {
+    public:
+
+        virtual ~ConsumerPressureMonitor();
+
+        /**
+         * @param usage
+         *      The bytes of the messages the Connection's consumers hold waiting to be
+         *      consumed.
+         *
+         * @return true if the consumers should be suspended, false if they may run.
+         */
+        virtual bool isUnderPressure(long long usage) = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_CONSUMERPRESSUREMONITOR_H_ */
@@ -0,0 +1,402 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DeliveredMessageList.h"
+
+#include <activemq/commands/Message.h>
+#include <activemq/exceptions/ExceptionDefines.h>
+
+#include <decaf/util/ConcurrentModificationException.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+
+    class DeliveredMessageList::ListIterator : public Iterator< Pointer<MessageDispatch> > {
+    private:
+
+        DeliveredMessageList* list;
+        DeliveredMessageList::Node* nextNode;
+        DeliveredMessageList::Node* lastReturned;
+        int expectedModCount;
+        bool readOnly;
+
+    private:
+
+        ListIterator(const ListIterator&);
+        ListIterator& operator=(const ListIterator&);
+
+    public:
+
+        ListIterator(DeliveredMessageList* list, bool readOnly) :
+            Iterator< Pointer<MessageDispatch> >(), list(list), nextNode(list->head),
+            lastReturned(NULL), expectedModCount(list->modCount), readOnly(readOnly) {
+        }
+
+        virtual ~ListIterator() {}
+
+        virtual Pointer<MessageDispatch> next() {
+
+            if (this->expectedModCount != this->list->modCount) {
+                throw ConcurrentModificationException(
+                    __FILE__, __LINE__, "List modified outside of this Iterator.");
+            }
+
+            if (this->nextNode == NULL) {
+                throw NoSuchElementException(
+                    __FILE__, __LINE__, "No more elements to return from next()");
+            }
+
+            this->lastReturned = this->nextNode;
+            this->nextNode = this->nextNode->next;
+
+            return this->lastReturned->value;
+        }
+
+        virtual bool hasNext() const {
+            return this->nextNode != NULL;
+        }
+
+        virtual void remove() {
+
+            if (this->readOnly) {
+                throw UnsupportedOperationException(
+                    __FILE__, __LINE__, "Cannot write to a const Iterator.");
+            }
+
+            if (this->expectedModCount != this->list->modCount) {
+                throw ConcurrentModificationException(
+                    __FILE__, __LINE__, "List modified outside of this Iterator.");
+            }
+
+            if (this->lastReturned == NULL) {
+                throw IllegalStateException(
+                    __FILE__, __LINE__, "Invalid State to call remove, must call next() before remove()");
+            }
+
+            this->list->unlink(this->lastReturned);
+            this->lastReturned = NULL;
+            this->expectedModCount = this->list->modCount;
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::MessageIdKey::operator==(const MessageIdKey& other) const {
+
+    if (this->id == other.id) {
+        return true;
+    }
+
+    // Cheap checks first, the full compare only runs on a hash collision or a match.
+    if (this->id->getProducerSequenceId() != other.id->getProducerSequenceId() ||
+        this->id->getBrokerSequenceId() != other.id->getBrokerSequenceId()) {
+        return false;
+    }
+
+    return this->id->equals(*(other.id));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int DeliveredMessageList::MessageIdKeyHash::operator()(const MessageIdKey& key) const {
+    long long producerSequence = key.id->getProducerSequenceId();
+    long long brokerSequence = key.id->getBrokerSequenceId();
+
+    int hash = (int) (producerSequence ^ ((unsigned long long) producerSequence >> 32));
+    hash = 31 * hash + (int) (brokerSequence ^ ((unsigned long long) brokerSequence >> 32));
+    return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::DeliveredMessageList() :
+    AbstractCollection< Pointer<MessageDispatch> >(), head(NULL), tail(NULL), count(0), unindexed(0), modCount(0), index() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::~DeliveredMessageList() {
+    try {
+        this->clear();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::addFirst(const Pointer<MessageDispatch>& dispatch) {
+
+    Node* node = new Node(dispatch);
+
+    node->next = this->head;
+    if (this->head != NULL) {
+        this->head->prev = node;
+    } else {
+        this->tail = node;
+    }
+    this->head = node;
+
+    this->count++;
+    this->modCount++;
+    indexNode(node);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::addLast(const Pointer<MessageDispatch>& dispatch) {
+
+    Node* node = new Node(dispatch);
+
+    node->prev = this->tail;
+    if (this->tail != NULL) {
+        this->tail->next = node;
+    } else {
+        this->head = node;
+    }
+    this->tail = node;
+
+    this->count++;
+    this->modCount++;
+    indexNode(node);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::add(const Pointer<MessageDispatch>& dispatch) {
+    this->addLast(dispatch);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::getFirst() const {
+    if (this->head == NULL) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    return this->head->value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::getLast() const {
+    if (this->tail == NULL) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    return this->tail->value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::removeFirst() {
+    if (this->head == NULL) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    Pointer<MessageDispatch> result = this->head->value;
+    unlink(this->head);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::removeLast() {
+    if (this->tail == NULL) {
+        throw NoSuchElementException(__FILE__, __LINE__, "The list is Empty");
+    }
+
+    Pointer<MessageDispatch> result = this->tail->value;
+    unlink(this->tail);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::get(const MessageId& id) const {
+    Node* node = find(id);
+    if (node == NULL) {
+        return Pointer<MessageDispatch>();
+    }
+
+    return node->value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> DeliveredMessageList::remove(const MessageId& id) {
+    Node* node = find(id);
+    if (node == NULL) {
+        return Pointer<MessageDispatch>();
+    }
+
+    Pointer<MessageDispatch> result = node->value;
+    unlink(node);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::contains(const Pointer<MessageDispatch>& dispatch) const {
+    return find(dispatch) != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DeliveredMessageList::remove(const Pointer<MessageDispatch>& dispatch) {
+    Node* node = find(dispatch);
+    if (node == NULL) {
+        return false;
+    }
+
+    unlink(node);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::clear() {
+
+    Node* node = this->head;
+    while (node != NULL) {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+
+    this->head = NULL;
+    this->tail = NULL;
+    this->count = 0;
+    this->unindexed = 0;
+    this->modCount++;
+    this->index.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Iterator< Pointer<MessageDispatch> >* DeliveredMessageList::iterator() {
+    return new ListIterator(this, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Iterator< Pointer<MessageDispatch> >* DeliveredMessageList::iterator() const {
+    return new ListIterator(const_cast<DeliveredMessageList*>(this), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const MessageId* DeliveredMessageList::messageIdOf(const Pointer<MessageDispatch>& dispatch) {
+
+    if (dispatch == NULL || dispatch->getMessage() == NULL) {
+        return NULL;
+    }
+
+    return dispatch->getMessage()->getMessageId().get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::Node* DeliveredMessageList::find(const Pointer<MessageDispatch>& dispatch) const {
+
+    const MessageId* id = messageIdOf(dispatch);
+    if (id != NULL) {
+        MessageIdKey key(id);
+        if (this->index.containsKey(key)) {
+            Node* node = this->index.get(key);
+            if (node->value == dispatch) {
+                return node;
+            }
+        }
+    }
+
+    // Only entries that aren't in the index need to be searched for.
+    if (this->unindexed > 0) {
+        for (Node* node = this->head; node != NULL; node = node->next) {
+            if (!node->indexed && node->value == dispatch) {
+                return node;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageList::Node* DeliveredMessageList::find(const MessageId& id) const {
+
+    MessageIdKey key(&id);
+    if (this->index.containsKey(key)) {
+        return this->index.get(key);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::indexNode(Node* node) {
+
+    const MessageId* id = messageIdOf(node->value);
+    if (id != NULL) {
+        MessageIdKey key(id);
+        if (!this->index.containsKey(key)) {
+            this->index.put(key, node);
+            node->indexed = true;
+            return;
+        }
+    }
+
+    // Either there is no id or it is a duplicate of an entry already in the list, the
+    // earlier entry keeps the index slot and this one is only reachable by scanning.
+    this->unindexed++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageList::unlink(Node* node) {
+
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        this->head = node->next;
+    }
+
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        this->tail = node->prev;
+    }
+
+    this->count--;
+    this->modCount++;
+
+    if (node->indexed) {
+        MessageIdKey key(messageIdOf(node->value));
+        this->index.remove(key);
+
+        // Hand the slot to a duplicate of the removed entry if there is one.
+        if (this->unindexed > 0) {
+            for (Node* other = this->head; other != NULL; other = other->next) {
+                const MessageId* otherId = messageIdOf(other->value);
+                if (!other->indexed && otherId != NULL && MessageIdKey(otherId) == key) {
+                    this->index.put(MessageIdKey(otherId), other);
+                    other->indexed = true;
+                    this->unindexed--;
+                    break;
+                }
+            }
+        }
+    } else {
+        this->unindexed--;
+    }
+
+    delete node;
+}
@@ -0,0 +1,280 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_
+#define _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/AbstractCollection.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/util/Iterator.h>
+
+#include <cstddef>
+#include <iterator>
+
+namespace activemq {
+namespace core {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::MessageDispatch;
+    using activemq::commands::MessageId;
+
+    /**
+     * Ordered collection of the MessageDispatch instances a consumer has delivered but
+     * not yet acknowledged.  New deliveries are added at the front so the first element
+     * is the most recently delivered message and the last is the oldest, the same order
+     * the consumer used to keep in a LinkedList.
+     *
+     * Each entry is also indexed by the MessageId of its message so that looking up or
+     * removing a single delivery doesn't have to walk the list, which matters for large
+     * prefetch windows acked individually.  Removing from either end of the list is
+     * constant time as well.
+     *
+     * Like the other decaf collections this class is not thread safe, callers lock the
+     * collection itself for the duration of any access.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API DeliveredMessageList : public decaf::util::AbstractCollection< Pointer<MessageDispatch> > {
+    private:
+
+        struct Node {
+            Pointer<MessageDispatch> value;
+            Node* prev;
+            Node* next;
+            bool indexed;
+
+            Node(const Pointer<MessageDispatch>& value) : value(value), prev(NULL), next(NULL), indexed(false) {}
+
+        private:
+
+            Node(const Node&);
+            Node& operator=(const Node&);
+        };
+
+        /**
+         * Index key, refers to the MessageId held by the message of the entry it
+         * indexes so it is valid for as long as that entry is in the list.
+         */
+        struct MessageIdKey {
+            const MessageId* id;
+
+            MessageIdKey() : id(NULL) {}
+            MessageIdKey(const MessageId* id) : id(id) {}
+
+            bool operator==(const MessageIdKey& other) const;
+        };
+
+        struct MessageIdKeyHash : public decaf::util::HashCodeUnaryBase<const MessageIdKey&> {
+            int operator()(const MessageIdKey& key) const;
+        };
+
+        class ListIterator;
+        friend class ListIterator;
+
+    private:
+
+        Node* head;
+        Node* tail;
+        int count;
+
+        // Number of entries with no MessageId or whose MessageId was already indexed.
+        int unindexed;
+
+        int modCount;
+
+        decaf::util::HashMap<MessageIdKey, Node*, MessageIdKeyHash> index;
+
+    private:
+
+        DeliveredMessageList(const DeliveredMessageList&);
+        DeliveredMessageList& operator=(const DeliveredMessageList&);
+
+    public:
+
+        DeliveredMessageList();
+
+        virtual ~DeliveredMessageList();
+
+        /**
+         * Adds the dispatch at the front of the list, making it the most recent delivery.
+         *
+         * @param dispatch
+         *      The MessageDispatch that was delivered.
+         */
+        void addFirst(const Pointer<MessageDispatch>& dispatch);
+
+        /**
+         * Adds the dispatch at the end of the list, making it the oldest delivery.
+         *
+         * @param dispatch
+         *      The MessageDispatch that was delivered.
+         */
+        void addLast(const Pointer<MessageDispatch>& dispatch);
+
+        /**
+         * @return the most recently delivered entry.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> getFirst() const;
+
+        /**
+         * @return the oldest delivered entry.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> getLast() const;
+
+        /**
+         * Removes and returns the most recently delivered entry.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> removeFirst();
+
+        /**
+         * Removes and returns the oldest delivered entry.
+         *
+         * @throws NoSuchElementException if the list is empty.
+         */
+        Pointer<MessageDispatch> removeLast();
+
+        /**
+         * Finds the entry whose message has the given MessageId.
+         *
+         * @param id
+         *      The MessageId to search for.
+         *
+         * @return the matching MessageDispatch or NULL if there isn't one.
+         */
+        Pointer<MessageDispatch> get(const MessageId& id) const;
+
+        /**
+         * Removes the entry whose message has the given MessageId.
+         *
+         * @param id
+         *      The MessageId of the entry to remove.
+         *
+         * @return the removed MessageDispatch or NULL if there was no such entry.
+         */
+        Pointer<MessageDispatch> remove(const MessageId& id);
+
+    public:
+
+        virtual decaf::util::Iterator< Pointer<MessageDispatch> >* iterator();
+
+        virtual decaf::util::Iterator< Pointer<MessageDispatch> >* iterator() const;
+
+        /**
+         * An iterator from the most recently delivered message to the oldest that is
+         * held by value, unlike the one returned from iterator() it needs no allocation
+         * and its calls are not virtual.  It is invalidated by any change to the list.
+         */
+        class const_iterator {
+        public:
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Pointer<MessageDispatch> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Pointer<MessageDispatch>* pointer;
+            typedef const Pointer<MessageDispatch>& reference;
+
+        private:
+
+            const Node* node;
+
+        public:
+
+            const_iterator() : node(NULL) {}
+
+            explicit const_iterator(const Node* node) : node(node) {}
+
+            const Pointer<MessageDispatch>& operator*() const {
+                return this->node->value;
+            }
+
+            const Pointer<MessageDispatch>* operator->() const {
+                return &this->node->value;
+            }
+
+            const_iterator& operator++() {
+                this->node = this->node->next;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result(*this);
+                this->node = this->node->next;
+                return result;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return this->node == other.node;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return this->node != other.node;
+            }
+        };
+
+        const_iterator begin() const {
+            return const_iterator(this->head);
+        }
+
+        const_iterator end() const {
+            return const_iterator(NULL);
+        }
+
+        virtual bool add(const Pointer<MessageDispatch>& dispatch);
+
+        virtual bool contains(const Pointer<MessageDispatch>& dispatch) const;
+
+        virtual bool remove(const Pointer<MessageDispatch>& dispatch);
+
+        virtual void clear();
+
+        virtual bool isEmpty() const {
+            return this->count == 0;
+        }
+
+        virtual int size() const {
+            return this->count;
+        }
+
+    private:
+
+        static const MessageId* messageIdOf(const Pointer<MessageDispatch>& dispatch);
+
+        Node* find(const Pointer<MessageDispatch>& dispatch) const;
+
+        Node* find(const MessageId& id) const;
+
+        void indexNode(Node* node);
+
+        void unlink(Node* node);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_DELIVEREDMESSAGELIST_H_ */
@@ -28,7 +28,17 @@ using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-FifoMessageDispatchChannel::FifoMessageDispatchChannel() : closed(false), running(false), channel() {
+namespace {
+
+    // Nodes the channel keeps for reuse, a consumer's messages flow through the
+    // channel steadily so most are enqueued without allocating a node.
+    const int CHANNEL_NODE_CACHE_SIZE = 256;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FifoMessageDispatchChannel::FifoMessageDispatchChannel() : closed(false), running(false), mutex(), channel(), memoryUsage(0) {
+    this->mutex.setProfilingSite(DEFAULT_PROFILING_SITE);
+    this->channel.setNodeCacheSize(CHANNEL_NODE_CACHE_SIZE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,23 +47,25 @@ FifoMessageDispatchChannel::~FifoMessageDispatchChannel() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         channel.addLast(message);
-        channel.notify();
+        memoryUsage += getMemorySize(message);
+        mutex.notify();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         channel.addFirst(message);
-        channel.notify();
+        memoryUsage += getMemorySize(message);
+        mutex.notify();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool FifoMessageDispatchChannel::isEmpty() const {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         return channel.isEmpty();
     }
 
@@ -63,13 +75,13 @@ bool FifoMessageDispatchChannel::isEmpty() const {
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeue(long long timeout) {
 
-    synchronized(&channel) {
+    synchronized(&mutex) {
         // Wait until the channel is ready to deliver messages.
         while (timeout != 0 && !closed && (channel.isEmpty() || !running)) {
             if (timeout == -1) {
-                channel.wait();
+                mutex.wait();
             } else {
-                channel.wait((unsigned long) timeout);
+                mutex.wait((unsigned long) timeout);
                 break;
             }
         }
@@ -78,7 +90,7 @@ Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeue(long long timeout)
             return Pointer<MessageDispatch>();
         }
 
-        return channel.pop();
+        return removeFirst();
     }
 
     return Pointer<MessageDispatch>();
@@ -86,19 +98,37 @@ Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeue(long long timeout)
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> FifoMessageDispatchChannel::dequeueNoWait() {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         if (closed || !running || channel.isEmpty()) {
             return Pointer<MessageDispatch>();
         }
-        return channel.pop();
+        return removeFirst();
     }
 
     return Pointer<MessageDispatch>();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int FifoMessageDispatchChannel::dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max) {
+    int count = 0;
+
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+
+        while (count < max && !channel.isEmpty()) {
+            buffer.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> FifoMessageDispatchChannel::peek() const {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         if (closed || !running || channel.isEmpty()) {
             return Pointer<MessageDispatch>();
         }
@@ -110,57 +140,80 @@ Pointer<MessageDispatch> FifoMessageDispatchChannel::peek() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::start() {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         if (!closed) {
             running = true;
-            channel.notifyAll();
+            mutex.notifyAll();
         }
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::stop() {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         running = false;
-        channel.notifyAll();
+        mutex.notifyAll();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::close() {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         if (!closed) {
             running = false;
             closed = true;
         }
-        channel.notifyAll();
+        mutex.notifyAll();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void FifoMessageDispatchChannel::clear() {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         channel.clear();
+        memoryUsage = 0;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int FifoMessageDispatchChannel::size() const {
-    synchronized(&channel) {
+    synchronized(&mutex) {
         return (int) channel.size();
     }
 
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long FifoMessageDispatchChannel::getMemoryUsage() const {
+    synchronized(&mutex) {
+        return memoryUsage;
+    }
+
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<Pointer<MessageDispatch> > FifoMessageDispatchChannel::removeAll() {
     std::vector<Pointer<MessageDispatch> > result;
 
-    synchronized(&channel) {
+    synchronized(&mutex) {
         result = channel.toArray();
         channel.clear();
+        memoryUsage = 0;
     }
 
     return result;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> FifoMessageDispatchChannel::removeFirst() {
+    Pointer<MessageDispatch> result = channel.pop();
+    memoryUsage -= getMemorySize(result);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FifoMessageDispatchChannel::setProfilingSite(const std::string& site) {
+    this->mutex.setProfilingSite(site);
+}
@@ -22,6 +22,7 @@
 #include <activemq/core/MessageDispatchChannel.h>
 
 #include <decaf/util/LinkedList.h>
+#include <decaf/util/concurrent/Mutex.h>
 #include <decaf/lang/Pointer.h>
 
 namespace activemq {
@@ -33,8 +34,13 @@ namespace core {
         bool closed;
         bool running;
 
+        mutable decaf::util::concurrent::Mutex mutex;
+
         mutable decaf::util::LinkedList< Pointer<MessageDispatch> > channel;
 
+        // Total size of the queued messages, guarded by the channel's lock.
+        long long memoryUsage;
+
     private:
 
         FifoMessageDispatchChannel(const FifoMessageDispatchChannel&);
@@ -64,6 +70,8 @@ namespace core {
 
         virtual Pointer<MessageDispatch> dequeueNoWait();
 
+        virtual int dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max);
+
         virtual Pointer<MessageDispatch> peek() const;
 
         virtual void start();
@@ -76,42 +84,50 @@ namespace core {
 
         virtual int size() const;
 
+        virtual long long getMemoryUsage() const;
+
         virtual std::vector<Pointer<MessageDispatch> > removeAll();
 
+        virtual void setProfilingSite(const std::string& site);
+
     public:
 
         virtual void lock() {
-            channel.lock();
+            mutex.lock();
         }
 
         virtual bool tryLock() {
-            return channel.tryLock();
+            return mutex.tryLock();
         }
 
         virtual void unlock() {
-            channel.unlock();
+            mutex.unlock();
         }
 
         virtual void wait() {
-            channel.wait();
+            mutex.wait();
         }
 
         virtual void wait(long long millisecs) {
-            channel.wait(millisecs);
+            mutex.wait(millisecs);
         }
 
         virtual void wait(long long millisecs, int nanos) {
-            channel.wait(millisecs, nanos);
+            mutex.wait(millisecs, nanos);
         }
 
         virtual void notify() {
-            channel.notify();
+            mutex.notify();
         }
 
         virtual void notifyAll() {
-            channel.notifyAll();
+            mutex.notifyAll();
         }
 
+    private:
+
+        Pointer<MessageDispatch> removeFirst();
+
     };
 
 }}
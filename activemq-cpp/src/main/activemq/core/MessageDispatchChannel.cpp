@@ -19,6 +19,20 @@
 
 using namespace activemq;
 using namespace activemq::core;
+using namespace activemq::commands;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string MessageDispatchChannel::DEFAULT_PROFILING_SITE = "activemq.core.MessageDispatchChannel";
 
 ////////////////////////////////////////////////////////////////////////////////
 MessageDispatchChannel::~MessageDispatchChannel() {}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MessageDispatchChannel::getMemorySize(const Pointer<MessageDispatch>& dispatch) {
+
+    if (dispatch == NULL || dispatch->getMessage() == NULL) {
+        return 0;
+    }
+
+    return (long long) dispatch->getMessage()->getSize();
+}
@@ -25,6 +25,8 @@
 #include <decaf/util/concurrent/Synchronizable.h>
 #include <decaf/lang/Pointer.h>
 
+#include <string>
+
 namespace activemq {
 namespace core {
 
@@ -32,6 +34,13 @@ namespace core {
     using activemq::commands::MessageDispatch;
 
     class AMQCPP_API MessageDispatchChannel: public decaf::util::concurrent::Synchronizable {
+    public:
+
+        /**
+         * The LockProfiler site a Channel's lock is reported under until it is given one.
+         */
+        static const std::string DEFAULT_PROFILING_SITE;
+
     public:
 
         virtual ~MessageDispatchChannel();
@@ -86,6 +95,21 @@ namespace core {
          */
         virtual Pointer<MessageDispatch> dequeueNoWait() = 0;
 
+        /**
+         * Removes up to max of the messages that are queued right now and appends them
+         * to the given buffer in the order they would have been dequeued, the Channel
+         * is locked once for the whole batch.  Nothing is removed if the Channel is
+         * closed or isn't running.
+         *
+         * @param buffer
+         *      The vector that the removed messages are appended to.
+         * @param max
+         *      The maximum number of messages to remove.
+         *
+         * @return the number of messages that were appended to the buffer.
+         */
+        virtual int dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max) = 0;
+
         /**
          * Peek in the Queue and return the first message in the Channel without removing
          * it from the channel.
@@ -119,6 +143,12 @@ namespace core {
          */
         virtual int size() const = 0;
 
+        /**
+         * @return the total size in bytes of the Messages currently in the Channel, as
+         *         reported by each Message's getSize method.
+         */
+        virtual long long getMemoryUsage() const = 0;
+
         /**
          * Remove all messages that are currently in the Channel and return them as
          * a list of Messages.
@@ -127,6 +157,21 @@ namespace core {
          */
         virtual std::vector<Pointer<MessageDispatch> > removeAll() = 0;
 
+        /**
+         * Reports the waits for and holds of the Channel's lock under the named site of
+         * the LockProfiler, by default they are reported with all other Channels.
+         *
+         * @param site
+         *      The name the lock's waits and holds are reported under.
+         */
+        virtual void setProfilingSite(const std::string& site) = 0;
+
+        /**
+         * @return the number of bytes the given dispatch counts for in the Channel's
+         *         memory usage, zero when it carries no Message.
+         */
+        static long long getMemorySize(const Pointer<MessageDispatch>& dispatch);
+
     };
 
 }}
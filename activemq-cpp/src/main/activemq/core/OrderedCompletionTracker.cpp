@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OrderedCompletionTracker.h"
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+OrderedCompletionTracker::OrderedCompletionTracker() : entries(), head(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OrderedCompletionTracker::~OrderedCompletionTracker() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long OrderedCompletionTracker::add(const Pointer<MessageDispatch>& dispatch) {
+    this->entries.push_back(Entry(dispatch));
+    return this->head + (long long) this->entries.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OrderedCompletionTracker::complete(long long sequence, Pointer<MessageDispatch>& first, Pointer<MessageDispatch>& last) {
+    return mark(sequence, false, first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OrderedCompletionTracker::exclude(long long sequence, Pointer<MessageDispatch>& first, Pointer<MessageDispatch>& last) {
+    return mark(sequence, true, first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OrderedCompletionTracker::mark(long long sequence, bool excluded,
+                                   Pointer<MessageDispatch>& first, Pointer<MessageDispatch>& last) {
+
+    if (sequence < this->head || sequence >= this->head + (long long) this->entries.size()) {
+        return 0;
+    }
+
+    Entry& entry = this->entries[(std::size_t) (sequence - this->head)];
+    if (entry.completed) {
+        return 0;
+    }
+
+    entry.completed = true;
+    entry.excluded = excluded;
+
+    int released = 0;
+    while (!this->entries.empty() && this->entries.front().completed) {
+        if (!this->entries.front().excluded) {
+            if (released == 0) {
+                first = this->entries.front().dispatch;
+            }
+            last = this->entries.front().dispatch;
+            released++;
+        }
+        this->entries.pop_front();
+        this->head++;
+    }
+
+    return released;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTracker::clear() {
+    this->head += (long long) this->entries.size();
+    this->entries.clear();
+}
@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ORDEREDCOMPLETIONTRACKER_H_
+#define _ACTIVEMQ_CORE_ORDEREDCOMPLETIONTRACKER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageDispatch.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <deque>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Tracks messages that are consumed out of the order they were dispatched in, such as
+     * those a consumer hands to several threads, and tells when the oldest of them are
+     * all consumed.  Standard acks acknowledge every message from the first to the last
+     * of a range in dispatch order, so a consumer in this position may only ack the run
+     * of consumed messages at the head, a message that is still being consumed holds back
+     * the acks for every message dispatched after it.
+     *
+     * Each message is given a sequence number as it is added, completing that number
+     * releases the run of completed messages at the head, if any.  A message that was
+     * acknowledged on its own, such as an expired one, is excluded instead, it no longer
+     * holds back the others but isn't part of the run reported when it is released.
+     *
+     * The class is not thread safe, callers serialize access to it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API OrderedCompletionTracker {
+    private:
+
+        struct Entry {
+            decaf::lang::Pointer<commands::MessageDispatch> dispatch;
+            bool completed;
+            bool excluded;
+
+            Entry(const decaf::lang::Pointer<commands::MessageDispatch>& dispatch) :
+                dispatch(dispatch), completed(false), excluded(false) {}
+        };
+
+        std::deque<Entry> entries;
+
+        // The sequence number of the entry at the head.
+        long long head;
+
+    private:
+
+        int mark(long long sequence, bool excluded,
+                 decaf::lang::Pointer<commands::MessageDispatch>& first,
+                 decaf::lang::Pointer<commands::MessageDispatch>& last);
+
+    private:
+
+        OrderedCompletionTracker(const OrderedCompletionTracker&);
+        OrderedCompletionTracker& operator= (const OrderedCompletionTracker&);
+
+    public:
+
+        OrderedCompletionTracker();
+
+        virtual ~OrderedCompletionTracker();
+
+        /**
+         * Adds a message after all those added before it.
+         *
+         * @param dispatch
+         *      The message that was dispatched.
+         *
+         * @return the sequence number to complete the message with.
+         */
+        long long add(const decaf::lang::Pointer<commands::MessageDispatch>& dispatch);
+
+        /**
+         * Marks the message with the given sequence number consumed and releases the run
+         * of consumed messages at the head.  Numbers that aren't tracked, because they
+         * were completed or cleared before, are ignored.
+         *
+         * @param sequence
+         *      The number add returned for the message.
+         * @param first
+         *      Set to the first message released, if any.
+         * @param last
+         *      Set to the last message released, if any.
+         *
+         * @return the number of messages released, zero when an older message is still
+         *         being consumed.
+         */
+        int complete(long long sequence,
+                     decaf::lang::Pointer<commands::MessageDispatch>& first,
+                     decaf::lang::Pointer<commands::MessageDispatch>& last);
+
+        /**
+         * Marks the message with the given sequence number consumed without making it part
+         * of a released run, and releases the run of consumed messages at the head.
+         *
+         * @param sequence
+         *      The number add returned for the message.
+         * @param first
+         *      Set to the first message released that wasn't excluded, if any.
+         * @param last
+         *      Set to the last message released that wasn't excluded, if any.
+         *
+         * @return the number of messages released that weren't excluded.
+         */
+        int exclude(long long sequence,
+                    decaf::lang::Pointer<commands::MessageDispatch>& first,
+                    decaf::lang::Pointer<commands::MessageDispatch>& last);
+
+        /**
+         * @return the sequence number of the oldest message not yet released, or of the
+         *         next message added when there is none.
+         */
+        long long getHeadSequence() const {
+            return this->head;
+        }
+
+        /**
+         * @return the number of messages added and not yet released.
+         */
+        int size() const {
+            return (int) this->entries.size();
+        }
+
+        /**
+         * @return true if every message added has been released.
+         */
+        bool isEmpty() const {
+            return this->entries.empty();
+        }
+
+        /**
+         * Forgets every message not yet released, completing them later has no effect.
+         */
+        void clear();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_ORDEREDCOMPLETIONTRACKER_H_ */
@@ -18,6 +18,7 @@
 #include "PrefetchPolicy.h"
 
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
 
 using namespace activemq;
 using namespace activemq::core;
@@ -66,6 +67,18 @@ void PrefetchPolicy::configure(const decaf::util::Properties& properties) {
             this->setTopicPrefetch(Integer::parseInt(
                 properties.getProperty("cms.prefetchPolicy.topicPrefetch")));
         }
+        if (properties.hasProperty("cms.prefetchPolicy.prefetchMemoryLimit")) {
+            this->setPrefetchMemoryLimit(Long::parseLong(
+                properties.getProperty("cms.prefetchPolicy.prefetchMemoryLimit")));
+        }
+        if (properties.hasProperty("cms.prefetchPolicy.prefetchTargetLatency")) {
+            this->setPrefetchTargetLatency(Long::parseLong(
+                properties.getProperty("cms.prefetchPolicy.prefetchTargetLatency")));
+        }
+        if (properties.hasProperty("cms.prefetchPolicy.pullBatchSize")) {
+            this->setPullBatchSize(Integer::parseInt(
+                properties.getProperty("cms.prefetchPolicy.pullBatchSize")));
+        }
 
         if (properties.hasProperty("cms.prefetchPolicy.all")) {
             int value = Integer::parseInt(properties.getProperty("cms.prefetchPolicy.all"));
@@ -105,6 +105,59 @@ namespace core {
          */
         virtual int getTopicPrefetch() const = 0;
 
+        /**
+         * Sets the maximum number of bytes of prefetched messages a consumer holds before
+         * it asks the broker to stop dispatching to it, zero or less disables the limit.
+         * The count based prefetch still applies, the limit only keeps a consumer of large
+         * messages from buffering its whole prefetch.
+         *
+         * @param value
+         *      The maximum size in bytes of a consumer's prefetched messages.
+         */
+        virtual void setPrefetchMemoryLimit(long long value) = 0;
+
+        /**
+         * Gets the maximum number of bytes of prefetched messages a consumer holds.
+         *
+         * @return the prefetch memory limit in bytes, zero or less if there is no limit.
+         */
+        virtual long long getPrefetchMemoryLimit() const = 0;
+
+        /**
+         * Sets the time a prefetched message should wait before it is consumed, a value
+         * greater than zero makes each consumer tune its prefetch to the rate it processes
+         * messages at.  The configured prefetch is then the largest the consumer asks for.
+         *
+         * @param value
+         *      The target latency in milliseconds, zero or less keeps a fixed prefetch.
+         */
+        virtual void setPrefetchTargetLatency(long long value) = 0;
+
+        /**
+         * Gets the time a prefetched message should wait before it is consumed.
+         *
+         * @return the target latency in milliseconds, zero or less for a fixed prefetch.
+         */
+        virtual long long getPrefetchTargetLatency() const = 0;
+
+        /**
+         * Sets the number of messages a consumer with a prefetch of zero asks the broker
+         * for at once.  Each receive that finds nothing waiting sends as many pulls as it
+         * takes to have this many outstanding, so a pulling consumer gets a small window
+         * of messages per round trip instead of one.
+         *
+         * @param value
+         *      The number of messages pulled at once, one or less pulls one at a time.
+         */
+        virtual void setPullBatchSize(int value) = 0;
+
+        /**
+         * Gets the number of messages a consumer with a prefetch of zero pulls at once.
+         *
+         * @return the pull batch size, one or less when pulling one message at a time.
+         */
+        virtual int getPullBatchSize() const = 0;
+
         /**
          * Sets the prefetch value on all available prefetch configuration options.
          *
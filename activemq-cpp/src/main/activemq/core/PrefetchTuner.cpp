@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PrefetchTuner.h"
+
+#include <decaf/lang/Math.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+const int PrefetchTuner::MIN_SAMPLES = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+PrefetchTuner::PrefetchTuner(int maximumPrefetch, long long targetLatency) :
+    maximumPrefetch(maximumPrefetch), targetLatency(targetLatency), prefetch(maximumPrefetch),
+    averageTime(0), samples(0) {
+
+    if (maximumPrefetch < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Prefetch must be at least one: %d", maximumPrefetch);
+    }
+
+    if (targetLatency < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Target latency must be at least one millisecond.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PrefetchTuner::~PrefetchTuner() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PrefetchTuner::recordProcessingTime(long long nanos) {
+
+    if (nanos < 0) {
+        return false;
+    }
+
+    // An average over roughly the last eight samples, quick to follow a consumer that
+    // slows down without jumping on a single slow message.
+    if (this->averageTime == 0) {
+        this->averageTime = Math::max(nanos, 1LL);
+    } else {
+        this->averageTime += (nanos - this->averageTime) / 8;
+        this->averageTime = Math::max(this->averageTime, 1LL);
+    }
+
+    // Reconsidered about four times per prefetch window.
+    if (++this->samples < Math::max(MIN_SAMPLES, this->prefetch / 4)) {
+        return false;
+    }
+
+    this->samples = 0;
+
+    long long wanted = (this->targetLatency * 1000000LL) / this->averageTime;
+    int proposed = (int) Math::max(1LL, Math::min(wanted, (long long) this->maximumPrefetch));
+
+    // Small changes aren't worth a round trip to the broker, the bounds always are.
+    int difference = Math::abs(proposed - this->prefetch);
+    if (proposed == this->prefetch ||
+        (difference * 4 < this->prefetch && proposed != 1 && proposed != this->maximumPrefetch)) {
+        return false;
+    }
+
+    this->prefetch = proposed;
+    return true;
+}
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_PREFETCHTUNER_H_
+#define _ACTIVEMQ_CORE_PREFETCHTUNER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Picks the prefetch of a consumer from the time it takes to process each message,
+     * so that the last of its prefetched messages waits about a target latency before it
+     * is consumed.  A fast consumer is given a large prefetch so it isn't starved waiting
+     * on the broker, a slow one a small prefetch so the messages it would sit on are left
+     * to its competing consumers and few are redelivered when it fails.
+     *
+     * The processing time is a moving average of the samples given to it, a new prefetch
+     * is only proposed after several samples and when it differs enough from the current
+     * one to be worth telling the broker about.  The prefetch is never more than the
+     * consumer's configured prefetch nor less than one.
+     *
+     * The class is not thread safe, callers serialize access to it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API PrefetchTuner {
+    private:
+
+        int maximumPrefetch;
+        long long targetLatency;
+        int prefetch;
+
+        // Moving average of the processing time in nanoseconds, zero before any sample.
+        long long averageTime;
+        int samples;
+
+    private:
+
+        PrefetchTuner(const PrefetchTuner&);
+        PrefetchTuner& operator= (const PrefetchTuner&);
+
+    public:
+
+        /**
+         * The smallest number of samples taken before the prefetch is reconsidered.
+         */
+        static const int MIN_SAMPLES;
+
+        /**
+         * Creates a tuner that starts at, and never exceeds, the given prefetch.
+         *
+         * @param maximumPrefetch
+         *      The configured prefetch of the consumer.
+         * @param targetLatency
+         *      The time in milliseconds a prefetched message should wait to be consumed.
+         *
+         * @throws IllegalArgumentException if either value is less than one.
+         */
+        PrefetchTuner(int maximumPrefetch, long long targetLatency);
+
+        virtual ~PrefetchTuner();
+
+        /**
+         * @return the prefetch the consumer should currently have.
+         */
+        int getPrefetch() const {
+            return this->prefetch;
+        }
+
+        /**
+         * @return the largest prefetch the tuner proposes.
+         */
+        int getMaximumPrefetch() const {
+            return this->maximumPrefetch;
+        }
+
+        /**
+         * @return the target latency in milliseconds.
+         */
+        long long getTargetLatency() const {
+            return this->targetLatency;
+        }
+
+        /**
+         * @return the average time in nanoseconds taken to process a message.
+         */
+        long long getAverageProcessingTime() const {
+            return this->averageTime;
+        }
+
+        /**
+         * Records the time taken to process one message and reconsiders the prefetch.
+         *
+         * @param nanos
+         *      The processing time in nanoseconds, negative values are ignored.
+         *
+         * @return true if the prefetch changed and should be sent to the broker.
+         */
+        bool recordProcessingTime(long long nanos);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_PREFETCHTUNER_H_ */
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_
+#define _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace core {
+namespace kernels {
+    class ActiveMQProducerKernel;
+}
+
+    /**
+     * A message whose destination, headers and properties were fixed when a producer
+     * prepared it, for producers that send many messages differing only in their body.
+     * The properties are marshaled once when the message is prepared and every send
+     * copies the prepared message, sharing those bytes, and gives the copy its body,
+     * message id and timestamp.
+     *
+     * A PreparedMessage can only be sent by the producer that prepared it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API PreparedMessage {
+    private:
+
+        const kernels::ActiveMQProducerKernel* producer;
+        decaf::lang::Pointer<commands::Message> prototype;
+        decaf::lang::Pointer<commands::ActiveMQDestination> destination;
+        int deliveryMode;
+        int priority;
+        long long timeToLive;
+
+    private:
+
+        PreparedMessage(const PreparedMessage&);
+        PreparedMessage& operator= (const PreparedMessage&);
+
+    public:
+
+        PreparedMessage(const kernels::ActiveMQProducerKernel* producer,
+                        const decaf::lang::Pointer<commands::Message>& prototype,
+                        const decaf::lang::Pointer<commands::ActiveMQDestination>& destination,
+                        int deliveryMode, int priority, long long timeToLive);
+
+        virtual ~PreparedMessage();
+
+        /**
+         * @return the producer kernel that prepared this message.
+         */
+        const kernels::ActiveMQProducerKernel* getProducer() const {
+            return this->producer;
+        }
+
+        /**
+         * @return the message each send copies, it has no body.
+         */
+        const decaf::lang::Pointer<commands::Message>& getPrototype() const {
+            return this->prototype;
+        }
+
+        const decaf::lang::Pointer<commands::ActiveMQDestination>& getDestination() const {
+            return this->destination;
+        }
+
+        int getDeliveryMode() const {
+            return this->deliveryMode;
+        }
+
+        int getPriority() const {
+            return this->priority;
+        }
+
+        long long getTimeToLive() const {
+            return this->timeToLive;
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_PREPAREDMESSAGE_H_ */
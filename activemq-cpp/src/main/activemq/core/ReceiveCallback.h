@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_RECEIVECALLBACK_H_
+#define _ACTIVEMQ_CORE_RECEIVECALLBACK_H_
+
+#include <activemq/util/Config.h>
+
+#include <cms/ExceptionListener.h>
+#include <cms/Message.h>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * Continuation for an asynchronous receive, the receive side counterpart of the
+     * cms::AsyncCallback a producer takes for its sends.
+     *
+     * The consumer calls onReceive exactly once for each receive it was given the
+     * callback for, from whichever thread completes it, either with the message that
+     * arrived or with NULL if the time ran out or the consumer was closed first.  If
+     * the receive fails the onException method of cms::ExceptionListener is called
+     * instead.  The callback must not block as it may be called from the thread that
+     * dispatches the session's messages.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ReceiveCallback : public cms::ExceptionListener {
+    public:
+
+        virtual ~ReceiveCallback();
+
+        /**
+         * Called when the asynchronous receive has completed.
+         *
+         * @param message
+         *      The message received, the callee owns it and must delete it, or NULL if
+         *      no message arrived in time or the consumer was closed.
+         */
+        virtual void onReceive(cms::Message* message) = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_RECEIVECALLBACK_H_ */
@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RedeliveryScheduler.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::threads;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+
+    class RedeliverySchedulerState {
+    private:
+
+        RedeliverySchedulerState(const RedeliverySchedulerState&);
+        RedeliverySchedulerState& operator= (const RedeliverySchedulerState&);
+
+    public:
+
+        // Held while a due batch is handed over so that close waits for it.
+        Mutex mutex;
+
+        RedeliveryScheduler::Target* target;
+        TimingWheel* wheel;
+        int maxPendingMessages;
+        int pendingMessages;
+        bool closed;
+
+        // The pending batches by number, each removes itself once it runs.
+        long long nextBatch;
+        std::map<long long, Pointer<TimingWheel::Timeout> > batches;
+
+        RedeliverySchedulerState(RedeliveryScheduler::Target* target, TimingWheel* wheel, int maxPendingMessages) :
+            mutex(), target(target), wheel(wheel), maxPendingMessages(maxPendingMessages),
+            pendingMessages(0), closed(false), nextBatch(0), batches() {}
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RedeliveryBatch : public Runnable {
+    private:
+
+        Pointer<RedeliverySchedulerState> state;
+        std::vector< Pointer<MessageDispatch> > messages;
+        long long id;
+
+    private:
+
+        RedeliveryBatch(const RedeliveryBatch&);
+        RedeliveryBatch& operator= (const RedeliveryBatch&);
+
+    public:
+
+        RedeliveryBatch(Pointer<RedeliverySchedulerState> state,
+                        const std::vector< Pointer<MessageDispatch> >& messages, long long id) :
+            Runnable(), state(state), messages(messages), id(id) {}
+
+        virtual ~RedeliveryBatch() {}
+
+        virtual void run() {
+            synchronized(&state->mutex) {
+                if (state->closed || state->batches.erase(id) == 0) {
+                    return;
+                }
+
+                state->pendingMessages -= (int) messages.size();
+
+                try {
+                    state->target->redeliver(messages);
+                } catch (...) {
+                }
+            }
+
+            messages.clear();
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const int RedeliveryScheduler::DEFAULT_MAX_PENDING_MESSAGES = 10000;
+
+////////////////////////////////////////////////////////////////////////////////
+RedeliveryScheduler::Target::~Target() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RedeliveryScheduler::RedeliveryScheduler(Target* target, TimingWheel* wheel, int maxPendingMessages) : state() {
+
+    if (target == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Redelivery Target must not be NULL.");
+    }
+
+    if (wheel == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "TimingWheel must not be NULL.");
+    }
+
+    if (maxPendingMessages < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "Max pending messages must be at least one: %d", maxPendingMessages);
+    }
+
+    this->state.reset(new RedeliverySchedulerState(target, wheel, maxPendingMessages));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RedeliveryScheduler::~RedeliveryScheduler() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RedeliveryScheduler::schedule(const std::vector< Pointer<MessageDispatch> >& messages, long long delay) {
+
+    if (messages.empty()) {
+        return false;
+    }
+
+    synchronized(&state->mutex) {
+
+        if (state->closed) {
+            return false;
+        }
+
+        int count = (int) messages.size();
+
+        if (delay > 0 && state->pendingMessages + count <= state->maxPendingMessages) {
+
+            // The batch can't run before it is recorded, it takes the lock first.
+            long long id = state->nextBatch++;
+            Pointer<Runnable> batch(new RedeliveryBatch(state, messages, id));
+            state->batches[id] = state->wheel->schedule(batch, delay);
+            state->pendingMessages += count;
+            return true;
+        }
+
+        state->target->redeliver(messages);
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliveryScheduler::close() {
+
+    std::map<long long, Pointer<TimingWheel::Timeout> > cancelled;
+
+    synchronized(&state->mutex) {
+        if (state->closed) {
+            return;
+        }
+
+        state->closed = true;
+        state->pendingMessages = 0;
+        cancelled.swap(state->batches);
+    }
+
+    // Cancelling drops the wheel's reference to each batch and the messages it holds.
+    std::map<long long, Pointer<TimingWheel::Timeout> >::iterator iter = cancelled.begin();
+    for (; iter != cancelled.end(); ++iter) {
+        iter->second->cancel();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RedeliveryScheduler::isClosed() const {
+
+    bool result = false;
+    synchronized(&state->mutex) {
+        result = state->closed;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int RedeliveryScheduler::getPendingCount() const {
+
+    int result = 0;
+    synchronized(&state->mutex) {
+        result = state->pendingMessages;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int RedeliveryScheduler::getMaxPendingMessages() const {
+    return this->state->maxPendingMessages;
+}
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_REDELIVERYSCHEDULER_H_
+#define _ACTIVEMQ_CORE_REDELIVERYSCHEDULER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/threads/TimingWheel.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <vector>
+
+namespace activemq {
+namespace core {
+
+    class RedeliverySchedulerState;
+
+    /**
+     * Holds the messages a consumer rolled back until their redelivery delay has passed
+     * and then hands them back to be dispatched ahead of anything still queued.  Every
+     * rollback becomes one batch held in a TimingWheel, so a long backoff ties up neither
+     * the consumer's locks nor a thread, and other messages and sessions keep flowing
+     * while it runs.  Batches are handed back in the order they come due.
+     *
+     * The number of messages held at once is bounded, a batch that would exceed the bound
+     * is handed back straight away rather than held.  Closing the scheduler cancels all
+     * pending batches and drops their messages, once close returns no batch is handed back.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API RedeliveryScheduler {
+    public:
+
+        /**
+         * Receives the batches once they are due, from the wheel's thread.
+         */
+        class AMQCPP_API Target {
+        public:
+
+            virtual ~Target();
+
+            /**
+             * Dispatches the messages again, ahead of any already waiting, keeping their
+             * order.
+             *
+             * @param messages
+             *      The rolled back messages in the order they were first delivered.
+             */
+            virtual void redeliver(const std::vector< decaf::lang::Pointer<commands::MessageDispatch> >& messages) = 0;
+
+        };
+
+    public:
+
+        /**
+         * Default bound on the number of messages held at once.
+         */
+        static const int DEFAULT_MAX_PENDING_MESSAGES;
+
+    private:
+
+        decaf::lang::Pointer<RedeliverySchedulerState> state;
+
+    private:
+
+        RedeliveryScheduler(const RedeliveryScheduler&);
+        RedeliveryScheduler& operator= (const RedeliveryScheduler&);
+
+    public:
+
+        /**
+         * Creates a scheduler that holds batches in the given wheel.
+         *
+         * @param target
+         *      Receives the batches once they are due, it must outlive the scheduler.
+         * @param wheel
+         *      The wheel the batches are held in, it must outlive the scheduler.
+         * @param maxPendingMessages
+         *      The most messages held at once.
+         *
+         * @throws NullPointerException if the target or wheel is NULL.
+         * @throws IllegalArgumentException if maxPendingMessages is less than one.
+         */
+        RedeliveryScheduler(Target* target, threads::TimingWheel* wheel,
+                            int maxPendingMessages = DEFAULT_MAX_PENDING_MESSAGES);
+
+        virtual ~RedeliveryScheduler();
+
+        /**
+         * Holds the messages for the given delay before handing them to the target, the
+         * messages are handed over right away if the delay is not positive or holding
+         * them would exceed the bound.
+         *
+         * @param messages
+         *      The rolled back messages in the order they were first delivered.
+         * @param delay
+         *      The redelivery delay in milliseconds.
+         *
+         * @return true if the messages are being held, false if they were handed over
+         *         or the scheduler is closed.
+         */
+        bool schedule(const std::vector< decaf::lang::Pointer<commands::MessageDispatch> >& messages, long long delay);
+
+        /**
+         * Cancels all pending batches, waiting for one being handed over to finish.
+         */
+        void close();
+
+        /**
+         * @return true if close has been called.
+         */
+        bool isClosed() const;
+
+        /**
+         * @return the number of messages currently held.
+         */
+        int getPendingCount() const;
+
+        /**
+         * @return the most messages held at once.
+         */
+        int getMaxPendingMessages() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_REDELIVERYSCHEDULER_H_ */
@@ -0,0 +1,296 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RingMessageDispatchChannel.h"
+
+#include <decaf/lang/Thread.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int RingMessageDispatchChannel::MIN_CAPACITY = 16;
+const int RingMessageDispatchChannel::SPIN_LIMIT = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+RingMessageDispatchChannel::RingMessageDispatchChannel(int capacity) :
+    closed(false), running(false), mutex(), ring(), head(0), count(0), available(0), waiting(0), memoryUsage(0) {
+
+    this->mutex.setProfilingSite(DEFAULT_PROFILING_SITE);
+
+    int size = MIN_CAPACITY;
+    while (size < capacity && size < (1 << 30)) {
+        size <<= 1;
+    }
+
+    this->ring.resize(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+RingMessageDispatchChannel::~RingMessageDispatchChannel() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
+    synchronized(&mutex) {
+        ensureCapacity();
+        this->ring[(this->head + this->count) & ((int) this->ring.size() - 1)] = message;
+        this->count++;
+        this->memoryUsage += getMemorySize(message);
+        this->available.set(this->count);
+        signalWaiter();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
+    synchronized(&mutex) {
+        ensureCapacity();
+        this->head = (this->head - 1) & ((int) this->ring.size() - 1);
+        this->ring[this->head] = message;
+        this->count++;
+        this->memoryUsage += getMemorySize(message);
+        this->available.set(this->count);
+        signalWaiter();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool RingMessageDispatchChannel::isEmpty() const {
+    return this->available.get() == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> RingMessageDispatchChannel::dequeue(long long timeout) {
+
+    // Before parking give the producer a short window to hand over a message, done
+    // before locking so that the producer can get in.
+    if (timeout != 0 && this->available.get() == 0) {
+        spinForMessage();
+    }
+
+    synchronized(&mutex) {
+
+        // Wait until the channel is ready to deliver messages.
+        while (timeout != 0 && !closed && (this->count == 0 || !running)) {
+            this->waiting++;
+            try {
+                if (timeout == -1) {
+                    mutex.wait();
+                } else {
+                    mutex.wait((unsigned long) timeout);
+                }
+            } catch (...) {
+                this->waiting--;
+                throw;
+            }
+            this->waiting--;
+
+            if (timeout != -1) {
+                break;
+            }
+        }
+
+        if (closed || !running || this->count == 0) {
+            return Pointer<MessageDispatch>();
+        }
+
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> RingMessageDispatchChannel::dequeueNoWait() {
+    synchronized(&mutex) {
+        if (closed || !running || this->count == 0) {
+            return Pointer<MessageDispatch>();
+        }
+        return removeFirst();
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int RingMessageDispatchChannel::dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max) {
+    int count = 0;
+
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+
+        while (count < max && this->count > 0) {
+            buffer.push_back(removeFirst());
+            count++;
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> RingMessageDispatchChannel::peek() const {
+    synchronized(&mutex) {
+        if (closed || !running || this->count == 0) {
+            return Pointer<MessageDispatch>();
+        }
+        return this->ring[this->head];
+    }
+
+    return Pointer<MessageDispatch>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::start() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = true;
+            mutex.notifyAll();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::stop() {
+    synchronized(&mutex) {
+        running = false;
+        mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::close() {
+    synchronized(&mutex) {
+        if (!closed) {
+            running = false;
+            closed = true;
+        }
+        mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::clear() {
+    synchronized(&mutex) {
+        int mask = (int) this->ring.size() - 1;
+        for (int i = 0; i < this->count; ++i) {
+            this->ring[(this->head + i) & mask].reset(NULL);
+        }
+        this->head = 0;
+        this->count = 0;
+        this->memoryUsage = 0;
+        this->available.set(0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int RingMessageDispatchChannel::size() const {
+    return this->available.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long RingMessageDispatchChannel::getMemoryUsage() const {
+    synchronized(&mutex) {
+        return this->memoryUsage;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<Pointer<MessageDispatch> > RingMessageDispatchChannel::removeAll() {
+    std::vector<Pointer<MessageDispatch> > result;
+
+    synchronized(&mutex) {
+        result.reserve(this->count);
+        int mask = (int) this->ring.size() - 1;
+        for (int i = 0; i < this->count; ++i) {
+            result.push_back(this->ring[(this->head + i) & mask]);
+        }
+        clear();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int RingMessageDispatchChannel::capacity() const {
+    synchronized(&mutex) {
+        return (int) this->ring.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::ensureCapacity() {
+
+    int size = (int) this->ring.size();
+    if (this->count < size) {
+        return;
+    }
+
+    // Unwrap into a ring twice the size, this only happens when the broker sends
+    // more than the ring was sized for, e.g. after a rollback puts messages back.
+    std::vector< Pointer<MessageDispatch> > grown(size * 2);
+    for (int i = 0; i < this->count; ++i) {
+        grown[i] = this->ring[(this->head + i) & (size - 1)];
+    }
+
+    this->ring.swap(grown);
+    this->head = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::signalWaiter() {
+    if (this->waiting > 0) {
+        mutex.notify();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::spinForMessage() {
+    for (int i = 0; i < SPIN_LIMIT && this->available.get() == 0; ++i) {
+        Thread::yield();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> RingMessageDispatchChannel::removeFirst() {
+    Pointer<MessageDispatch> result;
+    result.swap(this->ring[this->head]);
+    this->head = (this->head + 1) & ((int) this->ring.size() - 1);
+    this->count--;
+    this->memoryUsage -= getMemorySize(result);
+    this->available.set(this->count);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannel::setProfilingSite(const std::string& site) {
+    this->mutex.setProfilingSite(site);
+}
@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_RINGMESSAGEDISPATCHCHANNEL_H_
+#define _ACTIVEMQ_CORE_RINGMESSAGEDISPATCHCHANNEL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/core/MessageDispatchChannel.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <vector>
+
+namespace activemq {
+namespace core {
+
+    /**
+     * A FIFO MessageDispatchChannel that stores its pending messages in an array used
+     * as a ring buffer, the ring is sized up front from the consumer's prefetch so that
+     * enqueue and dequeue don't allocate, it grows only if more messages than that are
+     * pending.  A consumer waiting on an empty channel spins briefly before it parks
+     * and the producer only signals the channel when a consumer is actually parked.
+     *
+     * The channel is intended for one thread enqueuing and one dequeuing, it remains
+     * safe for other uses since all state changes are made under the channel lock.
+     */
+    class AMQCPP_API RingMessageDispatchChannel : public MessageDispatchChannel {
+    private:
+
+        static const int MIN_CAPACITY;
+        static const int SPIN_LIMIT;
+
+        bool closed;
+        bool running;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+
+        std::vector< Pointer<MessageDispatch> > ring;
+        int head;
+        int count;
+
+        // Readable without the lock, lets a spinning consumer see new messages.
+        decaf::util::concurrent::atomic::AtomicInteger available;
+
+        // Number of consumers parked on the channel waiting for a message.
+        int waiting;
+
+        // Total size of the queued messages.
+        long long memoryUsage;
+
+    private:
+
+        RingMessageDispatchChannel(const RingMessageDispatchChannel&);
+        RingMessageDispatchChannel& operator=(const RingMessageDispatchChannel&);
+
+    public:
+
+        /**
+         * Creates a new channel whose ring can hold the given number of messages
+         * before it has to grow.
+         *
+         * @param capacity
+         *      The expected number of pending messages, normally the consumer prefetch.
+         */
+        RingMessageDispatchChannel(int capacity);
+
+        virtual ~RingMessageDispatchChannel();
+
+        virtual void enqueue(const Pointer<MessageDispatch>& message);
+
+        virtual void enqueueFirst(const Pointer<MessageDispatch>& message);
+
+        virtual bool isEmpty() const;
+
+        virtual bool isClosed() const {
+            return this->closed;
+        }
+
+        virtual bool isRunning() const {
+            return this->running;
+        }
+
+        virtual Pointer<MessageDispatch> dequeue(long long timeout);
+
+        virtual Pointer<MessageDispatch> dequeueNoWait();
+
+        virtual int dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max);
+
+        virtual Pointer<MessageDispatch> peek() const;
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void clear();
+
+        virtual int size() const;
+
+        virtual long long getMemoryUsage() const;
+
+        virtual std::vector<Pointer<MessageDispatch> > removeAll();
+
+        virtual void setProfilingSite(const std::string& site);
+
+        /**
+         * @return the number of messages the ring can currently hold without growing.
+         */
+        int capacity() const;
+
+    public:
+
+        virtual void lock() {
+            mutex.lock();
+        }
+
+        virtual bool tryLock() {
+            return mutex.tryLock();
+        }
+
+        virtual void unlock() {
+            mutex.unlock();
+        }
+
+        virtual void wait() {
+            mutex.wait();
+        }
+
+        virtual void wait(long long millisecs) {
+            mutex.wait(millisecs);
+        }
+
+        virtual void wait(long long millisecs, int nanos) {
+            mutex.wait(millisecs, nanos);
+        }
+
+        virtual void notify() {
+            mutex.notify();
+        }
+
+        virtual void notifyAll() {
+            mutex.notifyAll();
+        }
+
+    private:
+
+        void ensureCapacity();
+
+        void signalWaiter();
+
+        void spinForMessage();
+
+        Pointer<MessageDispatch> removeFirst();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_RINGMESSAGEDISPATCHCHANNEL_H_ */
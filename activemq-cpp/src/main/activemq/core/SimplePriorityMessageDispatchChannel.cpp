@@ -19,6 +19,7 @@
 
 #include <cms/Message.h>
 
+#include <decaf/lang/Integer.h>
 #include <decaf/lang/Math.h>
 
 using namespace std;
@@ -33,10 +34,12 @@ using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 const int SimplePriorityMessageDispatchChannel::MAX_PRIORITIES = 10;
+const int SimplePriorityMessageDispatchChannel::MIN_CAPACITY = 16;
 
 ////////////////////////////////////////////////////////////////////////////////
 SimplePriorityMessageDispatchChannel::SimplePriorityMessageDispatchChannel() :
-    closed(false), running(false), mutex(), channels(MAX_PRIORITIES), enqueued(0) {
+    closed(false), running(false), mutex(), channels(MAX_PRIORITIES), pending(0), enqueued(0), memoryUsage(0) {
+    this->mutex.setProfilingSite(DEFAULT_PROFILING_SITE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,8 +49,14 @@ SimplePriorityMessageDispatchChannel::~SimplePriorityMessageDispatchChannel() {
 ////////////////////////////////////////////////////////////////////////////////
 void SimplePriorityMessageDispatchChannel::enqueue(const Pointer<MessageDispatch>& message) {
     synchronized(&mutex) {
-        this->getChannel(message).addLast(message);
+        int priority = this->getPriority(message);
+        PriorityRing& channel = this->channels[priority];
+        ensureCapacity(channel);
+        channel.ring[(channel.head + channel.count) & ((int) channel.ring.size() - 1)] = message;
+        channel.count++;
+        this->pending |= 1u << priority;
         this->enqueued++;
+        this->memoryUsage += getMemorySize(message);
         mutex.notify();
     }
 }
@@ -55,8 +64,15 @@ void SimplePriorityMessageDispatchChannel::enqueue(const Pointer<MessageDispatch
 ////////////////////////////////////////////////////////////////////////////////
 void SimplePriorityMessageDispatchChannel::enqueueFirst(const Pointer<MessageDispatch>& message) {
     synchronized(&mutex) {
-        this->getChannel(message).addFirst(message);
+        int priority = this->getPriority(message);
+        PriorityRing& channel = this->channels[priority];
+        ensureCapacity(channel);
+        channel.head = (channel.head - 1) & ((int) channel.ring.size() - 1);
+        channel.ring[channel.head] = message;
+        channel.count++;
+        this->pending |= 1u << priority;
         this->enqueued++;
+        this->memoryUsage += getMemorySize(message);
         mutex.notify();
     }
 }
@@ -102,13 +118,51 @@ Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::dequeueNoWait() {
     return Pointer<MessageDispatch>();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int SimplePriorityMessageDispatchChannel::dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max) {
+    int count = 0;
+
+    synchronized(&mutex) {
+        if (closed || !running) {
+            return 0;
+        }
+
+        // Drains whole runs of each priority, visiting only the ones holding messages.
+        while (count < max && this->pending != 0) {
+            int priority = getHighestPriority();
+            PriorityRing& channel = this->channels[priority];
+            int mask = (int) channel.ring.size() - 1;
+
+            int drain = Math::min(channel.count, max - count);
+            for (int i = 0; i < drain; ++i) {
+                buffer.push_back(Pointer<MessageDispatch>());
+                buffer.back().swap(channel.ring[channel.head]);
+                this->memoryUsage -= getMemorySize(buffer.back());
+                channel.head = (channel.head + 1) & mask;
+            }
+
+            channel.count -= drain;
+            this->enqueued -= drain;
+            count += drain;
+
+            if (channel.count == 0) {
+                this->pending &= ~(1u << priority);
+            }
+        }
+    }
+
+    return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::peek() const {
     synchronized(&mutex) {
         if (closed || !running || isEmpty()) {
             return Pointer<MessageDispatch>();
         }
-        return getFirst();
+
+        const PriorityRing& channel = this->channels[getHighestPriority()];
+        return channel.ring[channel.head];
     }
 
     return Pointer<MessageDispatch>();
@@ -147,8 +201,18 @@ void SimplePriorityMessageDispatchChannel::close() {
 void SimplePriorityMessageDispatchChannel::clear() {
     synchronized(&mutex) {
         for (int i = 0; i < MAX_PRIORITIES; i++) {
-            this->channels[i].clear();
+            PriorityRing& channel = this->channels[i];
+            int mask = (int) channel.ring.size() - 1;
+            for (int j = 0; j < channel.count; ++j) {
+                channel.ring[(channel.head + j) & mask].reset(NULL);
+            }
+            channel.head = 0;
+            channel.count = 0;
         }
+
+        this->pending = 0;
+        this->enqueued = 0;
+        this->memoryUsage = 0;
     }
 }
 
@@ -161,16 +225,23 @@ int SimplePriorityMessageDispatchChannel::size() const {
     return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long SimplePriorityMessageDispatchChannel::getMemoryUsage() const {
+    synchronized(&mutex) {
+        return this->memoryUsage;
+    }
+
+    return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<Pointer<MessageDispatch> > SimplePriorityMessageDispatchChannel::removeAll() {
     std::vector<Pointer<MessageDispatch> > result;
 
     synchronized(&mutex) {
-        for (int i = MAX_PRIORITIES - 1; i >= 0; --i) {
-            std::vector<Pointer<MessageDispatch> > temp(channels[i].toArray());
-            result.insert(result.end(), temp.begin(), temp.end());
-            this->enqueued -= (int) temp.size();
-            channels[i].clear();
+        result.reserve(this->enqueued);
+        while (this->pending != 0) {
+            result.push_back(removeFirst());
         }
     }
 
@@ -178,45 +249,69 @@ std::vector<Pointer<MessageDispatch> > SimplePriorityMessageDispatchChannel::rem
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-LinkedList<Pointer<MessageDispatch> >& SimplePriorityMessageDispatchChannel::getChannel(const Pointer<MessageDispatch>& dispatch) {
+int SimplePriorityMessageDispatchChannel::getPriority(const Pointer<MessageDispatch>& dispatch) const {
 
     int priority = cms::Message::DEFAULT_MSG_PRIORITY;
 
     if (dispatch->getMessage() != NULL) {
-        priority = Math::max(dispatch->getMessage()->getPriority(), 0);
-        priority = Math::min(dispatch->getMessage()->getPriority(), 9);
+        priority = Math::max((int) dispatch->getMessage()->getPriority(), 0);
+        priority = Math::min(priority, MAX_PRIORITIES - 1);
     }
 
-    return this->channels[priority];
+    return priority;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::removeFirst() {
+int SimplePriorityMessageDispatchChannel::getHighestPriority() const {
+    return 31 - Integer::numberOfLeadingZeros((int) this->pending);
+}
 
-    if (this->enqueued > 0) {
-        for (int i = MAX_PRIORITIES - 1; i >= 0; i--) {
-            LinkedList<Pointer<MessageDispatch> >& channel = channels[i];
-            if (!channel.isEmpty()) {
-                this->enqueued--;
-                return channel.pop();
-            }
-        }
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannel::ensureCapacity(PriorityRing& channel) {
+
+    int size = (int) channel.ring.size();
+    if (size == 0) {
+        channel.ring.resize(MIN_CAPACITY);
+        return;
+    } else if (channel.count < size) {
+        return;
     }
 
-    return Pointer<MessageDispatch>();
+    // Unwrap into a ring twice the size, it then stays large enough for the
+    // number of messages that are typically pending at this priority.
+    std::vector< Pointer<MessageDispatch> > grown(size * 2);
+    for (int i = 0; i < channel.count; ++i) {
+        grown[i].swap(channel.ring[(channel.head + i) & (size - 1)]);
+    }
+
+    channel.ring.swap(grown);
+    channel.head = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::getFirst() const {
+Pointer<MessageDispatch> SimplePriorityMessageDispatchChannel::removeFirst() {
 
-    if (this->enqueued > 0) {
-        for (int i = MAX_PRIORITIES - 1; i >= 0; i--) {
-            LinkedList<Pointer<MessageDispatch> >& channel = channels[i];
-            if (!channel.isEmpty()) {
-                return channel.getFirst();
-            }
+    Pointer<MessageDispatch> result;
+
+    if (this->pending != 0) {
+        int priority = getHighestPriority();
+        PriorityRing& channel = this->channels[priority];
+
+        result.swap(channel.ring[channel.head]);
+        channel.head = (channel.head + 1) & ((int) channel.ring.size() - 1);
+        channel.count--;
+        this->enqueued--;
+        this->memoryUsage -= getMemorySize(result);
+
+        if (channel.count == 0) {
+            this->pending &= ~(1u << priority);
         }
     }
 
-    return Pointer<MessageDispatch>();
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannel::setProfilingSite(const std::string& site) {
+    this->mutex.setProfilingSite(site);
 }
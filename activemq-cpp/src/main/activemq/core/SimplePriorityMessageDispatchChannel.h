@@ -21,29 +21,57 @@
 #include <activemq/util/Config.h>
 #include <activemq/core/MessageDispatchChannel.h>
 
-#include <decaf/util/LinkedList.h>
-#include <decaf/lang/ArrayPointer.h>
+#include <decaf/lang/Pointer.h>
 #include <decaf/util/concurrent/Mutex.h>
 
+#include <vector>
+
 namespace activemq {
 namespace core {
 
-    using decaf::lang::ArrayPointer;
-
+    /**
+     * A MessageDispatchChannel that hands out messages highest priority first and in
+     * FIFO order within a priority.
+     *
+     * Each of the ten priorities keeps its pending messages in an array used as a ring
+     * buffer, so enqueue and dequeue don't allocate once a ring has grown to the number
+     * of messages that are pending at that priority.  A bitmap records which rings hold
+     * messages, the highest priority with pending messages is found from its leading
+     * zero count rather than by scanning every priority.
+     */
     class AMQCPP_API SimplePriorityMessageDispatchChannel : public MessageDispatchChannel {
     private:
 
         static const int MAX_PRIORITIES;
+        static const int MIN_CAPACITY;
+
+        /**
+         * The pending messages of one priority, the ring is allocated on first use and
+         * its size is always a power of two.
+         */
+        struct PriorityRing {
+            std::vector< Pointer<MessageDispatch> > ring;
+            int head;
+            int count;
+
+            PriorityRing() : ring(), head(0), count(0) {}
+        };
 
         bool closed;
         bool running;
 
         mutable decaf::util::concurrent::Mutex mutex;
 
-        mutable ArrayPointer< decaf::util::LinkedList< Pointer<MessageDispatch> > > channels;
+        std::vector<PriorityRing> channels;
+
+        // Bit N is set while priority N has pending messages.
+        unsigned int pending;
 
         int enqueued;
 
+        // Total size of the queued messages.
+        long long memoryUsage;
+
     private:
 
         SimplePriorityMessageDispatchChannel(const SimplePriorityMessageDispatchChannel&);
@@ -72,6 +100,8 @@ namespace core {
 
         virtual Pointer<MessageDispatch> dequeueNoWait();
 
+        virtual int dequeueAll(std::vector<Pointer<MessageDispatch> >& buffer, int max);
+
         virtual Pointer<MessageDispatch> peek() const;
 
         virtual void start();
@@ -84,8 +114,12 @@ namespace core {
 
         virtual int size() const;
 
+        virtual long long getMemoryUsage() const;
+
         virtual std::vector<Pointer<MessageDispatch> > removeAll();
 
+        virtual void setProfilingSite(const std::string& site);
+
     public:
 
         virtual void lock() {
@@ -122,11 +156,13 @@ namespace core {
 
     private:
 
-        decaf::util::LinkedList<Pointer<MessageDispatch> >& getChannel(const Pointer<MessageDispatch>& dispatch);
+        int getPriority(const Pointer<MessageDispatch>& dispatch) const;
 
-        Pointer<MessageDispatch> removeFirst();
+        int getHighestPriority() const;
+
+        void ensureCapacity(PriorityRing& channel);
 
-        Pointer<MessageDispatch> getFirst() const;
+        Pointer<MessageDispatch> removeFirst();
 
     };
 
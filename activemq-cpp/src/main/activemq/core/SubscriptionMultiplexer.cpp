@@ -0,0 +1,466 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SubscriptionMultiplexer.h"
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/core/Dispatcher.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/util/LongSequenceGenerator.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::util;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+
+    class SharedSubscription;
+
+    class SubscriptionMultiplexerImpl {
+    private:
+
+        SubscriptionMultiplexerImpl(const SubscriptionMultiplexerImpl&);
+        SubscriptionMultiplexerImpl& operator= (const SubscriptionMultiplexerImpl&);
+
+    public:
+
+        ActiveMQConnection* connection;
+        LongSequenceGenerator* consumerIds;
+
+        // Guards everything below and every subscription, dispatches to the members
+        // are made holding it so a member that is removed gets nothing afterwards.
+        Mutex mutex;
+
+        std::map<std::string, Pointer<SharedSubscription> > subscriptions;
+        std::map<ConsumerId, Pointer<SharedSubscription> > members;
+
+        // Lets the acks of consumers that aren't members skip the lock.
+        AtomicInteger memberCount;
+
+        SubscriptionMultiplexerImpl(ActiveMQConnection* connection, LongSequenceGenerator* consumerIds) :
+            connection(connection), consumerIds(consumerIds), mutex(), subscriptions(), members(), memberCount() {
+        }
+
+        void ackConsumed(SharedSubscription& subscription);
+
+        void dispose(const Pointer<SharedSubscription>& subscription);
+    };
+
+    class SharedSubscription : public Dispatcher {
+    private:
+
+        SharedSubscription(const SharedSubscription&);
+        SharedSubscription& operator= (const SharedSubscription&);
+
+    public:
+
+        struct Member {
+
+            Pointer<ConsumerId> consumerId;
+            Dispatcher* dispatcher;
+
+            // How many of the pending messages the member has consumed.
+            std::size_t consumed;
+
+            Member(const Pointer<ConsumerId>& consumerId, Dispatcher* dispatcher, std::size_t consumed) :
+                consumerId(consumerId), dispatcher(dispatcher), consumed(consumed) {
+            }
+        };
+
+        SubscriptionMultiplexerImpl* parent;
+        std::string key;
+        Pointer<ConsumerInfo> info;
+        std::vector<Member> members;
+
+        // Ids of the messages dispatched to the members and not yet acked, in the
+        // order the broker sent them.
+        std::deque< Pointer<MessageId> > pending;
+
+        // Released once the broker has answered the ConsumerInfo, failed is set if it
+        // refused it.
+        CountDownLatch created;
+        bool failed;
+
+        SharedSubscription(SubscriptionMultiplexerImpl* parent, const std::string& key, const Pointer<ConsumerInfo>& info) :
+            Dispatcher(), parent(parent), key(key), info(info), members(), pending(), created(1), failed(false) {
+        }
+
+        virtual ~SharedSubscription() {}
+
+        std::vector<Member>::iterator findMember(const ConsumerId& consumerId) {
+            std::vector<Member>::iterator iter = this->members.begin();
+            for (; iter != this->members.end(); ++iter) {
+                if (*iter->consumerId == consumerId) {
+                    break;
+                }
+            }
+            return iter;
+        }
+
+        virtual void dispatch(const Pointer<MessageDispatch>& dispatch) {
+
+            synchronized(&this->parent->mutex) {
+
+                Pointer<Message> message = dispatch->getMessage();
+                if (message == NULL || this->members.empty()) {
+                    return;
+                }
+
+                this->pending.push_back(message->getMessageId());
+
+                // Each member gets its own MessageDispatch, the message in them is the
+                // one that was decoded and is read only from here on.
+                std::vector<Member>::iterator iter = this->members.begin();
+                for (; iter != this->members.end(); ++iter) {
+                    Pointer<MessageDispatch> copy(new MessageDispatch());
+                    copy->copyDataStructure(dispatch.get());
+                    copy->setConsumerId(iter->consumerId);
+                    iter->dispatcher->dispatch(copy);
+                }
+            }
+        }
+
+        virtual int getHashCode() const {
+            return this->info->getConsumerId()->getHashCode();
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string keyOf(const ConsumerInfo& info) {
+        std::string key = info.getDestination()->getPhysicalName();
+        key += info.isNoLocal() ? "\n1\n" : "\n0\n";
+        key += info.getSelector();
+        return key;
+    }
+
+    bool isCountedAck(int ackType) {
+        return ackType != ActiveMQConstants::ACK_TYPE_DELIVERED &&
+               ackType != ActiveMQConstants::ACK_TYPE_REDELIVERED;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SubscriptionMultiplexerImpl::ackConsumed(SharedSubscription& subscription) {
+
+    if (subscription.members.empty() || subscription.pending.empty()) {
+        return;
+    }
+
+    std::size_t consumed = subscription.pending.size();
+    std::vector<SharedSubscription::Member>::const_iterator iter = subscription.members.begin();
+    for (; iter != subscription.members.end(); ++iter) {
+        consumed = std::min(consumed, iter->consumed);
+    }
+
+    // Acked in batches of half the prefetch as the Java client's optimized acks are,
+    // the broker still has half its window to send while the slowest member catches up.
+    std::size_t threshold = (std::size_t) std::max(1, subscription.info->getPrefetchSize() / 2);
+    if (consumed < threshold) {
+        return;
+    }
+
+    Pointer<MessageAck> ack(new MessageAck());
+    ack->setAckType(ActiveMQConstants::ACK_TYPE_CONSUMED);
+    ack->setConsumerId(subscription.info->getConsumerId());
+    ack->setDestination(subscription.info->getDestination());
+    ack->setFirstMessageId(subscription.pending.front());
+    ack->setLastMessageId(subscription.pending[consumed - 1]);
+    ack->setMessageCount((int) consumed);
+
+    subscription.pending.erase(subscription.pending.begin(), subscription.pending.begin() + consumed);
+    std::vector<SharedSubscription::Member>::iterator member = subscription.members.begin();
+    for (; member != subscription.members.end(); ++member) {
+        member->consumed -= consumed;
+    }
+
+    try {
+        this->connection->oneway(ack);
+        this->connection->getMetrics().getAcksSent().increment();
+    } catch (Exception& e) {
+        this->connection->onClientInternalException(e);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SubscriptionMultiplexerImpl::dispose(const Pointer<SharedSubscription>& subscription) {
+
+    // Waits for a dispatch in progress to the subscription before it goes away.
+    this->connection->removeDispatcher(subscription->info->getConsumerId());
+
+    try {
+        this->connection->oneway(subscription->info->createRemoveCommand());
+    } catch (Exception& e) {
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SubscriptionMultiplexer::SubscriptionMultiplexer(ActiveMQConnection* connection, LongSequenceGenerator* consumerIds) :
+    impl(new SubscriptionMultiplexerImpl(connection, consumerIds)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SubscriptionMultiplexer::~SubscriptionMultiplexer() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SubscriptionMultiplexer::isMultiplexable(const ConsumerInfo& info) {
+
+    const Pointer<ActiveMQDestination>& destination = info.getDestination();
+    if (destination == NULL || !destination->isTopic() || destination->isComposite()) {
+        return false;
+    }
+
+    // Options like consumer.retroactive or consumer.prefetchSize make the subscription
+    // differ from the other consumers' on the same topic.
+    return destination->getOptions().isEmpty() && info.getSubscriptionName().empty() &&
+           !info.isBrowser() && info.getPrefetchSize() > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SubscriptionMultiplexer::subscribe(const Pointer<ConsumerInfo>& info, Dispatcher* dispatcher) {
+
+    Pointer<SharedSubscription> subscription;
+    bool creating = false;
+
+    synchronized(&this->impl->mutex) {
+
+        std::string key = keyOf(*info);
+        std::map<std::string, Pointer<SharedSubscription> >::const_iterator found = this->impl->subscriptions.find(key);
+
+        if (found == this->impl->subscriptions.end()) {
+            Pointer<ConsumerInfo> shared(info->cloneDataStructure());
+            SessionId sessionId(&this->impl->connection->getConnectionId(), -1);
+            shared->setConsumerId(Pointer<ConsumerId>(
+                new ConsumerId(sessionId, this->impl->consumerIds->getNextSequenceId())));
+
+            subscription.reset(new SharedSubscription(this->impl, key, shared));
+            this->impl->subscriptions.insert(std::make_pair(key, subscription));
+            creating = true;
+        } else {
+            subscription = found->second;
+        }
+
+        // A member gets only the messages dispatched after it joined, it counts as
+        // having consumed those that came before.
+        subscription->members.push_back(SharedSubscription::Member(
+            info->getConsumerId(), dispatcher, subscription->pending.size()));
+        this->impl->members.insert(std::make_pair(*info->getConsumerId(), subscription));
+        this->impl->memberCount.incrementAndGet();
+    }
+
+    if (!creating) {
+        subscription->created.await();
+        return !subscription->failed;
+    }
+
+    // The broker's answer is read by the thread that dispatches, so the lock can't be
+    // held while waiting for it.
+    try {
+        this->impl->connection->addDispatcher(subscription->info->getConsumerId(), subscription.get());
+        this->impl->connection->syncRequest(subscription->info);
+    } catch (...) {
+
+        synchronized(&this->impl->mutex) {
+            subscription->failed = true;
+            this->impl->subscriptions.erase(subscription->key);
+
+            std::vector<SharedSubscription::Member>::const_iterator iter = subscription->members.begin();
+            for (; iter != subscription->members.end(); ++iter) {
+                this->impl->members.erase(*iter->consumerId);
+                this->impl->memberCount.decrementAndGet();
+            }
+            subscription->members.clear();
+        }
+
+        this->impl->connection->removeDispatcher(subscription->info->getConsumerId());
+        subscription->created.countDown();
+        throw;
+    }
+
+    subscription->created.countDown();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SubscriptionMultiplexer::unsubscribe(const ConsumerId& consumerId) {
+
+    Pointer<SharedSubscription> emptied;
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<ConsumerId, Pointer<SharedSubscription> >::iterator found = this->impl->members.find(consumerId);
+        if (found == this->impl->members.end()) {
+            return false;
+        }
+
+        Pointer<SharedSubscription> subscription = found->second;
+        this->impl->members.erase(found);
+        this->impl->memberCount.decrementAndGet();
+
+        std::vector<SharedSubscription::Member>::iterator member = subscription->findMember(consumerId);
+        if (member != subscription->members.end()) {
+            subscription->members.erase(member);
+        }
+
+        if (subscription->members.empty()) {
+            this->impl->subscriptions.erase(subscription->key);
+            emptied = subscription;
+        } else {
+            // The member that left may have been the slowest one.
+            this->impl->ackConsumed(*subscription);
+        }
+    }
+
+    if (emptied != NULL) {
+        this->impl->dispose(emptied);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SubscriptionMultiplexer::acknowledge(const MessageAck& ack) {
+
+    if (this->impl->memberCount.get() == 0 || ack.getConsumerId() == NULL) {
+        return false;
+    }
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<ConsumerId, Pointer<SharedSubscription> >::const_iterator found =
+            this->impl->members.find(*ack.getConsumerId());
+        if (found == this->impl->members.end()) {
+            return false;
+        }
+
+        SharedSubscription& subscription = *found->second;
+        if (!isCountedAck(ack.getAckType())) {
+            return true;
+        }
+
+        std::vector<SharedSubscription::Member>::iterator member = subscription.findMember(*ack.getConsumerId());
+        if (member != subscription.members.end()) {
+            // Acks for messages dispatched before a transport interruption aren't
+            // pending any more.
+            member->consumed = std::min(subscription.pending.size(),
+                                        member->consumed + (std::size_t) std::max(0, ack.getMessageCount()));
+            this->impl->ackConsumed(subscription);
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SubscriptionMultiplexer::transportInterrupted() {
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<std::string, Pointer<SharedSubscription> >::const_iterator iter = this->impl->subscriptions.begin();
+        for (; iter != this->impl->subscriptions.end(); ++iter) {
+            SharedSubscription& subscription = *iter->second;
+            subscription.pending.clear();
+
+            std::vector<SharedSubscription::Member>::iterator member = subscription.members.begin();
+            for (; member != subscription.members.end(); ++member) {
+                member->consumed = 0;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SubscriptionMultiplexer::close() {
+
+    std::vector< Pointer<SharedSubscription> > closing;
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<std::string, Pointer<SharedSubscription> >::const_iterator iter = this->impl->subscriptions.begin();
+        for (; iter != this->impl->subscriptions.end(); ++iter) {
+            iter->second->members.clear();
+            closing.push_back(iter->second);
+        }
+
+        this->impl->subscriptions.clear();
+        this->impl->members.clear();
+        this->impl->memberCount.set(0);
+    }
+
+    std::vector< Pointer<SharedSubscription> >::const_iterator iter = closing.begin();
+    for (; iter != closing.end(); ++iter) {
+        this->impl->dispose(*iter);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ConsumerId> SubscriptionMultiplexer::getSubscriptionId(const ConsumerId& consumerId) const {
+
+    synchronized(&this->impl->mutex) {
+
+        std::map<ConsumerId, Pointer<SharedSubscription> >::const_iterator found = this->impl->members.find(consumerId);
+        if (found != this->impl->members.end()) {
+            return found->second->info->getConsumerId();
+        }
+    }
+
+    return Pointer<ConsumerId>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SubscriptionMultiplexer::getSubscriptionCount() const {
+
+    synchronized(&this->impl->mutex) {
+        return (int) this->impl->subscriptions.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SubscriptionMultiplexer::getMemberCount() const {
+    return this->impl->memberCount.get();
+}
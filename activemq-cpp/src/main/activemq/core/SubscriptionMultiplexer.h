@@ -0,0 +1,165 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_SUBSCRIPTIONMULTIPLEXER_H_
+#define _ACTIVEMQ_CORE_SUBSCRIPTIONMULTIPLEXER_H_
+
+#include <activemq/util/Config.h>
+
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/MessageAck.h>
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace util {
+    class LongSequenceGenerator;
+}
+namespace core {
+
+    class ActiveMQConnection;
+    class Dispatcher;
+    class SubscriptionMultiplexerImpl;
+
+    /**
+     * Lets the consumers of a Connection that subscribe to the same topic with the same
+     * selector share one subscription on the broker.  The broker sends each message once
+     * and it is dispatched to every consumer sharing the subscription, all of them given
+     * the same read only message, instead of the broker sending one copy per consumer.
+     *
+     * The consumers sharing a subscription are its members, they keep their own ids but
+     * only the subscription is known to the broker.  Acks from the members never reach
+     * the broker, the subscription acks the messages every member has consumed so the
+     * broker's prefetch window is held open by the slowest member.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API SubscriptionMultiplexer {
+    private:
+
+        SubscriptionMultiplexer(const SubscriptionMultiplexer&);
+        SubscriptionMultiplexer& operator= (const SubscriptionMultiplexer&);
+
+    private:
+
+        SubscriptionMultiplexerImpl* impl;
+
+    public:
+
+        /**
+         * Creates a multiplexer whose subscriptions are made on the default session of
+         * the given connection.
+         *
+         * @param connection
+         *      The Connection whose consumers are multiplexed.
+         * @param consumerIds
+         *      The generator of the ids of the Connection's default session consumers.
+         */
+        SubscriptionMultiplexer(ActiveMQConnection* connection, util::LongSequenceGenerator* consumerIds);
+
+        ~SubscriptionMultiplexer();
+
+    public:
+
+        /**
+         * Checks whether a consumer could share a subscription, it must be a plain
+         * subscription to a topic that isn't durable, browses nothing, has no destination
+         * options and prefetches messages.  The acknowledgement mode of its session is
+         * left for the caller to check, only AUTO_ACKNOWLEDGE and DUPS_OK_ACKNOWLEDGE
+         * consumers ack in a way the subscription can count.
+         *
+         * @param info
+         *      The ConsumerInfo of the consumer.
+         *
+         * @return true if the consumer could share a subscription.
+         */
+        static bool isMultiplexable(const commands::ConsumerInfo& info);
+
+        /**
+         * Adds the consumer to the subscription for its topic, selector and noLocal
+         * setting, creating the subscription on the broker if it is the first one.
+         *
+         * @param info
+         *      The ConsumerInfo of the consumer, it is not sent to the broker.
+         * @param dispatcher
+         *      The Dispatcher that the consumer's messages are given to.
+         *
+         * @return true if the consumer was added, false if it must subscribe on its own
+         *         because the subscription it would have shared could not be created.
+         *
+         * @throws ActiveMQException if the broker refuses the new subscription.
+         */
+        bool subscribe(const decaf::lang::Pointer<commands::ConsumerInfo>& info, Dispatcher* dispatcher);
+
+        /**
+         * Removes the consumer from its subscription, the subscription is removed from
+         * the broker once it has no members.  Once this returns nothing more is given to
+         * the consumer's Dispatcher.
+         *
+         * @param consumerId
+         *      The id of the consumer to remove.
+         *
+         * @return true if the consumer was a member of a subscription.
+         */
+        bool unsubscribe(const commands::ConsumerId& consumerId);
+
+        /**
+         * Takes an ack sent by a consumer, the ack of a member is counted against its
+         * subscription instead of being sent to the broker.
+         *
+         * @param ack
+         *      The MessageAck the consumer is sending.
+         *
+         * @return true if the ack was taken and must not be sent to the broker.
+         */
+        bool acknowledge(const commands::MessageAck& ack);
+
+        /**
+         * Forgets the messages not yet acked, the broker starts the subscriptions afresh
+         * when the connection is restored.
+         */
+        void transportInterrupted();
+
+        /**
+         * Removes every subscription from the broker and drops their members.
+         */
+        void close();
+
+        /**
+         * @param consumerId
+         *      The id of a consumer.
+         *
+         * @return the id of the subscription the consumer shares, or NULL if it isn't
+         *         a member of one.
+         */
+        decaf::lang::Pointer<commands::ConsumerId> getSubscriptionId(const commands::ConsumerId& consumerId) const;
+
+        /**
+         * @return the number of subscriptions held on the broker.
+         */
+        int getSubscriptionCount() const;
+
+        /**
+         * @return the number of consumers sharing the subscriptions.
+         */
+        int getMemberCount() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_CORE_SUBSCRIPTIONMULTIPLEXER_H_ */
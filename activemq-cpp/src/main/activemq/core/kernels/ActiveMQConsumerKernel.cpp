@@ -25,8 +25,8 @@
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
+#include <decaf/util/HashCode.h>
 #include <decaf/util/HashMap.h>
-#include <decaf/util/Collections.h>
 #include <decaf/util/concurrent/ExecutorService.h>
 #include <decaf/util/concurrent/Executors.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
@@ -35,6 +35,7 @@
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/Message.h>
 #include <activemq/commands/MessageAck.h>
 #include <activemq/commands/MessagePull.h>
@@ -45,14 +46,29 @@
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQTransactionContext.h>
 #include <activemq/core/ActiveMQAckHandler.h>
+#include <activemq/core/ConflatingMessageDispatchChannel.h>
+#include <activemq/core/DeliveredMessageList.h>
 #include <activemq/core/FifoMessageDispatchChannel.h>
+#include <activemq/core/OrderedCompletionTracker.h>
+#include <activemq/core/RingMessageDispatchChannel.h>
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
+#include <activemq/core/PrefetchPolicy.h>
+#include <activemq/core/PrefetchTuner.h>
 #include <activemq/core/RedeliveryPolicy.h>
+#include <activemq/core/RedeliveryScheduler.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
+#include <activemq/threads/KeyedSerialExecutor.h>
 #include <activemq/threads/Scheduler.h>
+#include <activemq/threads/TimingWheel.h>
+#include <cms/BytesMessage.h>
 #include <cms/ExceptionListener.h>
 #include <cms/MessageTransformer.h>
+#include <cms/StreamMessage.h>
+#include <algorithm>
+#include <deque>
+#include <map>
 #include <memory>
+#include <vector>
 
 using namespace std;
 using namespace activemq;
@@ -85,6 +101,90 @@ namespace kernels {
         virtual ~PreviouslyDeliveredMap() {}
     };
 
+    /**
+     * The receives made with receiveAsync that are waiting for a message, in the order
+     * they were made.  The timeouts of the receives refer to this rather than to the
+     * consumer so they don't keep it alive.
+     */
+    class AsyncReceives {
+    private:
+
+        AsyncReceives(const AsyncReceives&);
+        AsyncReceives& operator=(const AsyncReceives&);
+
+    public:
+
+        struct Pending {
+
+            ReceiveCallback* callback;
+            Pointer<TimingWheel::Timeout> timeout;
+
+            Pending(ReceiveCallback* callback) : callback(callback), timeout() {}
+        };
+
+        struct Completion {
+
+            ReceiveCallback* callback;
+            cms::Message* message;
+            Pointer<cms::CMSException> error;
+
+            Completion(ReceiveCallback* callback, cms::Message* message, cms::CMSException* error) :
+                callback(callback), message(message), error(error) {}
+        };
+
+        Mutex mutex;
+        std::deque< Pointer<Pending> > pending;
+        // Whether pending holds anything, read without the lock on each dispatch.
+        volatile bool waiting;
+
+        AsyncReceives() : mutex(), pending(), waiting(false) {}
+
+        /**
+         * Takes the given receive off the list, its timeout is cancelled.
+         * @return false if it had already been completed.
+         */
+        bool remove(const Pointer<Pending>& receive) {
+            synchronized(&mutex) {
+                std::deque< Pointer<Pending> >::iterator iter =
+                    std::find(pending.begin(), pending.end(), receive);
+                if (iter == pending.end()) {
+                    return false;
+                }
+                pending.erase(iter);
+                waiting = !pending.empty();
+                release(receive);
+            }
+            return true;
+        }
+
+        /**
+         * Drops the timeout of a receive taken off the list, the lock must be held.
+         */
+        static void release(const Pointer<Pending>& receive) {
+            if (receive->timeout != NULL) {
+                receive->timeout->cancel();
+                receive->timeout.reset(NULL);
+            }
+        }
+
+        /**
+         * Calls the callbacks, what they throw is of no concern to the consumer.
+         */
+        static void complete(const std::vector<Completion>& completed) {
+            std::vector<Completion>::const_iterator iter = completed.begin();
+            for (; iter != completed.end(); ++iter) {
+                try {
+                    if (iter->error != NULL) {
+                        iter->callback->onException(*iter->error);
+                    } else {
+                        iter->callback->onReceive(iter->message);
+                    }
+                } catch (...) {
+                }
+            }
+        }
+    };
+
     class ActiveMQConsumerKernelConfig {
     private:
 
@@ -101,9 +201,10 @@ namespace kernels {
         AtomicBoolean started;
         AtomicBoolean closeSyncRegistered;
         Pointer<MessageDispatchChannel> unconsumedMessages;
-        decaf::util::LinkedList< decaf::lang::Pointer<commands::MessageDispatch> > deliveredMessages;
+        DeliveredMessageList deliveredMessages;
         long long lastDeliveredSequenceId;
         Pointer<commands::MessageAck> pendingAck;
+        Pointer<commands::MessageAck> reusableAck;
         int deliveredCounter;
         int additionalWindowSize;
         volatile bool synchronizationRegistered;
@@ -113,6 +214,10 @@ namespace kernels {
         Pointer<RedeliveryPolicy> redeliveryPolicy;
         Pointer<Exception> failureError;
         Pointer<Scheduler> scheduler;
+        // With non blocking redelivery, holds the rolled back messages while their
+        // redelivery delay passes, created with the first such rollback.
+        Pointer<RedeliveryScheduler::Target> redeliveryTarget;
+        Pointer<RedeliveryScheduler> redeliveryScheduler;
         int hashCode;
         Pointer<PreviouslyDeliveredMap> previouslyDeliveredMessages;
         long long failoverRedeliveryWaitPeriod;
@@ -124,8 +229,53 @@ namespace kernels {
         long long optimizeAcknowledgeTimeOut;
         long long optimizedAckScheduledAckInterval;
         Runnable* optimizedAckTask;
+        int ackCoalesceCount;
+        long long ackCoalesceDelay;
+        long long ackCoalesceStart;
         int ackCounter;
         int dispatchedCount;
+        long long prefetchMemoryLimit;
+        bool prefetchMemoryLimited;
+        // Suspended by the Connection, and the bytes last added to its consumer memory usage.
+        bool suspended;
+        long long reportedMemoryUsage;
+        decaf::util::concurrent::Mutex prefetchMutex;
+        Pointer<PrefetchTuner> prefetchTuner;
+        long long lastReceiveTime;
+        // With a prefetch of zero, the messages pulled at once and the answers the
+        // broker still owes for the pulls sent, guarded by the unconsumedMessages lock.
+        int pullBatchSize;
+        int pullsOutstanding;
+        // With a conflation key the channel keeps the latest message of each key, the
+        // messages it replaced are acked together once enough of them have built up.
+        // Guarded by the unconsumedMessages lock.
+        Pointer<ConflatingMessageDispatchChannel> conflatingChannel;
+        Pointer<MessageDispatch> supersededLast;
+        Pointer<MessageId> supersededFirst;
+        int supersededCount;
+        bool useBorrowedMessages;
+        // Set once the consumer shares a subscription of the connection's multiplexer,
+        // the broker doesn't know the consumer so nothing about it is sent there.
+        bool multiplexed;
+        // With group dispatch or a parallel listener the listener is called from a pool
+        // of lanes, with group dispatch the messages of one group always on the same one.
+        // The tracker holds the messages handed to the lanes in dispatch order so the acks
+        // only cover messages consumed along with all those dispatched before them.  With
+        // a parallel listener the individual acks are coalesced, the sequence numbers of
+        // the messages not yet acked are kept by message and the acks that can't be sent
+        // as part of a range yet are held back by sequence number.  All of it is guarded
+        // by laneMutex as are the executor, the reference the lanes keep to this consumer
+        // and the closing flag.
+        int groupDispatchLanes;
+        int parallelListenerThreads;
+        Pointer<KeyedSerialExecutor> laneExecutor;
+        Pointer<ActiveMQConsumerKernel> laneSelf;
+        decaf::util::concurrent::Mutex laneMutex;
+        OrderedCompletionTracker laneTracker;
+        std::map<const MessageDispatch*, long long> laneSequences;
+        std::map<long long, Pointer<MessageDispatch> > heldAcks;
+        volatile bool lanesClosing;
+        Pointer<AsyncReceives> asyncReceives;
         Pointer<ExecutorService> executor;
         ActiveMQSessionKernel* session;
         ActiveMQConsumerKernel* parent;
@@ -142,6 +292,7 @@ namespace kernels {
                                          deliveredMessages(),
                                          lastDeliveredSequenceId(-1),
                                          pendingAck(),
+                                         reusableAck(),
                                          deliveredCounter(0),
                                          additionalWindowSize(0),
                                          synchronizationRegistered(false),
@@ -151,6 +302,8 @@ namespace kernels {
                                          redeliveryPolicy(),
                                          failureError(),
                                          scheduler(),
+                                         redeliveryTarget(),
+                                         redeliveryScheduler(),
                                          hashCode(),
                                          previouslyDeliveredMessages(),
                                          failoverRedeliveryWaitPeriod(0),
@@ -162,14 +315,75 @@ namespace kernels {
                                          optimizeAcknowledgeTimeOut(),
                                          optimizedAckScheduledAckInterval(),
                                          optimizedAckTask(),
+                                         ackCoalesceCount(0),
+                                         ackCoalesceDelay(0),
+                                         ackCoalesceStart(0),
                                          ackCounter(),
                                          dispatchedCount(),
+                                         prefetchMemoryLimit(0),
+                                         prefetchMemoryLimited(false),
+                                         suspended(false),
+                                         reportedMemoryUsage(0),
+                                         prefetchMutex(),
+                                         prefetchTuner(),
+                                         lastReceiveTime(0),
+                                         pullBatchSize(1),
+                                         pullsOutstanding(0),
+                                         conflatingChannel(),
+                                         supersededLast(),
+                                         supersededFirst(),
+                                         supersededCount(0),
+                                         useBorrowedMessages(false),
+                                         multiplexed(false),
+                                         groupDispatchLanes(0),
+                                         parallelListenerThreads(0),
+                                         laneExecutor(),
+                                         laneSelf(),
+                                         laneMutex(),
+                                         laneTracker(),
+                                         laneSequences(),
+                                         heldAcks(),
+                                         lanesClosing(false),
+                                         asyncReceives(new AsyncReceives()),
                                          executor(),
                                          session(),
                                          parent(),
                                          info() {
         }
 
+        void ackSuperseded(bool flush) {
+
+            std::vector< Pointer<MessageDispatch> > replaced;
+            conflatingChannel->takeSuperseded(replaced);
+
+            std::vector< Pointer<MessageDispatch> >::const_iterator iter = replaced.begin();
+            for (; iter != replaced.end(); ++iter) {
+                const Pointer<MessageId>& id = (*iter)->getMessage()->getMessageId();
+                if (supersededCount == 0) {
+                    supersededFirst = id;
+                }
+                // The range ends at the latest of them, they are replaced out of order.
+                if (supersededLast == NULL ||
+                    supersededLast->getMessage()->getMessageId()->getBrokerSequenceId() < id->getBrokerSequenceId()) {
+                    supersededLast = *iter;
+                }
+                supersededCount++;
+            }
+
+            if (supersededCount > 0 && (flush || supersededCount >= Math::max(1, info->getPrefetchSize() / 2))) {
+                Pointer<MessageAck> ack(new MessageAck(supersededLast, ActiveMQConstants::ACK_TYPE_CONSUMED, supersededCount));
+                ack->setFirstMessageId(supersededFirst);
+                supersededLast.reset(NULL);
+                supersededFirst.reset(NULL);
+                supersededCount = 0;
+                session->sendAck(ack);
+            }
+        }
+
+        int laneCount() const {
+            return groupDispatchLanes > 0 ? groupDispatchLanes : parallelListenerThreads;
+        }
+
         bool isTimeForOptimizedAck(int prefetchSize) const {
             if (ackCounter + deliveredCounter >= (prefetchSize * 0.65)) {
                 return true;
@@ -177,13 +391,62 @@ namespace kernels {
 
             long long nextAckTime = optimizeAckTimestamp + optimizeAcknowledgeTimeOut;
 
-            if (optimizeAcknowledgeTimeOut > 0 && System::currentTimeMillis() >= nextAckTime) {
+            if (optimizeAcknowledgeTimeOut > 0 && System::coarseTimeMillis() >= nextAckTime) {
                 return true;
             }
 
             return false;
         }
 
+        // Builds the ack for a range ending with the given dispatch.  The last ack made is
+        // kept and refilled once the transport and every caller have let go of it, so a
+        // consumer that acks steadily doesn't allocate a new MessageAck for each range.
+        // Called with the delivered messages locked.
+        Pointer<MessageAck> nextAck(const Pointer<MessageDispatch>& dispatch, int type, int count) {
+
+            if (reusableAck == NULL || reusableAck->getReferenceCount() > 1) {
+                reusableAck.reset(new MessageAck(dispatch, type, count));
+                return reusableAck;
+            }
+
+            reusableAck->setCommandId(0);
+            reusableAck->setResponseRequired(false);
+            reusableAck->setAckType((unsigned char) type);
+            reusableAck->setConsumerId(dispatch->getConsumerId());
+            reusableAck->setDestination(dispatch->getDestination());
+            reusableAck->setTransactionId(Pointer<TransactionId>());
+            reusableAck->setFirstMessageId(Pointer<MessageId>());
+            reusableAck->setLastMessageId(dispatch->getMessage()->getMessageId());
+            reusableAck->setMessageCount(count);
+            reusableAck->setPoisonCause(Pointer<BrokerError>());
+
+            return reusableAck;
+        }
+
+        bool isAckCoalescing() const {
+            return ackCoalesceCount > 1 && !optimizeAcknowledge;
+        }
+
+        // Called with the delivered messages locked, they are the consumed messages that
+        // haven't been acked yet.
+        bool isTimeForCoalescedAck(int prefetchSize) {
+            int pending = deliveredMessages.size();
+            if (pending == 1) {
+                ackCoalesceStart = System::nanoTime();
+            }
+
+            // Nothing more to deliver so don't keep the broker waiting.
+            if (unconsumedMessages->isEmpty()) {
+                return true;
+            }
+
+            if (pending >= Math::min(ackCoalesceCount, prefetchSize / 2)) {
+                return true;
+            }
+
+            return ackCoalesceDelay > 0 && (System::nanoTime() - ackCoalesceStart) / 1000 >= ackCoalesceDelay;
+        }
+
         void clearDeliveredList() {
             if (isClearDeliveredList) {
                 synchronized (&this->deliveredMessages) {
@@ -195,21 +458,17 @@ namespace kernels {
                                         session->getTransactionContext()->getTransactionId()));
                                 }
 
-                                Pointer<Iterator<Pointer<MessageDispatch> > > iter(deliveredMessages.iterator());
-
-                                while (iter->hasNext()) {
-                                    Pointer<MessageDispatch> dispatch = iter->next();
-                                    previouslyDeliveredMessages->put(dispatch->getMessage()->getMessageId(), false);
+                                DeliveredMessageList::const_iterator iter = deliveredMessages.begin();
+                                for (; iter != deliveredMessages.end(); ++iter) {
+                                    previouslyDeliveredMessages->put((*iter)->getMessage()->getMessageId(), false);
                                 }
                             } else {
                                 if (session->isClientAcknowledge() || session->isIndividualAcknowledge()) {
                                     if (!info->isBrowser()) {
-                                        Pointer<Iterator<Pointer<MessageDispatch> > > iter(deliveredMessages.iterator());
-
                                         // allow redelivery
-                                        while (iter->hasNext()) {
-                                            Pointer<MessageDispatch> dispatch = iter->next();
-                                            session->getConnection()->rollbackDuplicate(parent, dispatch->getMessage());
+                                        DeliveredMessageList::const_iterator iter = deliveredMessages.begin();
+                                        for (; iter != deliveredMessages.end(); ++iter) {
+                                            session->getConnection()->rollbackDuplicate(parent, (*iter)->getMessage());
                                         }
                                     }
                                 }
@@ -232,14 +491,9 @@ namespace kernels {
 
         // called with deliveredMessages locked
         void removeFromDeliveredMessages(Pointer<MessageId> key) {
-            Pointer< Iterator< Pointer<MessageDispatch> > > iter(this->deliveredMessages.iterator());
-            while (iter->hasNext()) {
-                Pointer<MessageDispatch> candidate = iter->next();
-                if (key->equals(candidate->getMessage()->getMessageId().get())) {
-                    session->getConnection()->rollbackDuplicate(this->parent, candidate->getMessage());
-                    iter->remove();
-                    break;
-                }
+            Pointer<MessageDispatch> candidate = this->deliveredMessages.remove(*key);
+            if (candidate != NULL) {
+                session->getConnection()->rollbackDuplicate(this->parent, candidate->getMessage());
             }
         }
 
@@ -348,21 +602,31 @@ namespace kernels {
             return false;
         }
 
-        bool consumeExpiredMessage(const Pointer<MessageDispatch> dispatch) {
-            if (dispatch->getMessage()->isExpired()) {
+        bool consumeExpiredMessage(const Pointer<MessageDispatch> dispatch, long long now) {
+            if (dispatch->getMessage()->isExpired(now)) {
                 return !info->isBrowser() && consumerExpiryCheckEnabled;
             }
 
             return false;
         }
 
+        // Whether an expired message can join a run acknowledged by one ranged ack, it
+        // must still be in the broker's dispatch order which a priority channel or a
+        // local redelivery after a rollback changes.
+        bool canJoinExpiredRun(const Pointer<MessageDispatch> dispatch) const {
+            return !session->getConnection()->isMessagePrioritySupported() &&
+                   dispatch->getMessage()->getRedeliveryCounter() == 0;
+        }
+
         bool redeliveryExceeded(Pointer<MessageDispatch> dispatch) {
             try {
+                // Read only access so a forwarded message keeps its marshaled properties.
+                const Message* message = dispatch->getMessage().get();
                 return session->isTransacted() && redeliveryPolicy != NULL &&
                        redeliveryPolicy->getMaximumRedeliveries() != RedeliveryPolicy::NO_MAXIMUM_REDELIVERIES &&
                        dispatch->getRedeliveryCounter() > redeliveryPolicy->getMaximumRedeliveries() &&
                         // redeliveryCounter > x expected after resend via brokerRedeliveryPlugin
-                       !dispatch->getMessage()->getMessageProperties().containsKey("redeliveryDelay");
+                       !message->getMessageProperties().containsKey("redeliveryDelay");
             } catch (Exception& ignored) {
                 return false;
             }
@@ -388,6 +652,38 @@ namespace kernels {
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
 
+    /**
+     * Completes an asynchronous receive with NULL once its time is up, unless a
+     * message completed it first.
+     */
+    class AsyncReceiveTimeoutTask : public Runnable {
+    private:
+
+        Pointer<AsyncReceives> receives;
+        Pointer<AsyncReceives::Pending> receive;
+
+    private:
+
+        AsyncReceiveTimeoutTask(const AsyncReceiveTimeoutTask&);
+        AsyncReceiveTimeoutTask& operator=(const AsyncReceiveTimeoutTask&);
+
+    public:
+
+        AsyncReceiveTimeoutTask(Pointer<AsyncReceives> receives, Pointer<AsyncReceives::Pending> receive) :
+            Runnable(), receives(receives), receive(receive) {
+        }
+
+        virtual ~AsyncReceiveTimeoutTask() {}
+
+        virtual void run() {
+            if (this->receives->remove(this->receive)) {
+                std::vector<AsyncReceives::Completion> completed;
+                completed.push_back(AsyncReceives::Completion(this->receive->callback, NULL, NULL));
+                AsyncReceives::complete(completed);
+            }
+        }
+    };
+
     /**
      * Class used to deal with consumers in an active transaction.  This
      * class calls back into the consumer when the transaction is Committed or
@@ -607,6 +903,42 @@ namespace {
         }
     };
 
+    /**
+     * Delivers one message on the dispatch lane it was handed to.
+     */
+    class LaneTask : public Runnable {
+    private:
+
+        Pointer<ActiveMQConsumerKernel> consumer;
+        ActiveMQSessionKernel* session;
+        Pointer<MessageDispatch> dispatch;
+        cms::MessageListener* listener;
+        long long sequence;
+
+    private:
+
+        LaneTask(const LaneTask&);
+        LaneTask& operator=(const LaneTask&);
+
+    public:
+
+        LaneTask(Pointer<ActiveMQConsumerKernel> consumer, ActiveMQSessionKernel* session,
+                 Pointer<MessageDispatch> dispatch, cms::MessageListener* listener, long long sequence) :
+            Runnable(), consumer(consumer), session(session), dispatch(dispatch), listener(listener), sequence(sequence) {}
+        virtual ~LaneTask() {}
+
+        virtual void run() {
+            try {
+                this->consumer->consumeOnLane(this->dispatch, this->listener, this->sequence);
+            } catch (Exception& ex) {
+                this->session->getConnection()->onAsyncException(ex);
+            }
+
+            this->dispatch.reset(NULL);
+            this->consumer.reset(NULL);
+        }
+    };
+
     class AsyncMessageAckTask : public Runnable {
     private:
 
@@ -667,43 +999,35 @@ namespace {
         }
     };
 
-    class NonBlockingRedeliveryTask : public Runnable {
+    /**
+     * Hands the batches held by the RedeliveryScheduler back to the session, unless the
+     * consumer has since been closed.
+     */
+    class ConsumerRedeliveryTarget : public RedeliveryScheduler::Target {
     private:
 
         ActiveMQSessionKernel* session;
-        Pointer<ActiveMQConsumerKernel> consumer;
         ActiveMQConsumerKernelConfig* impl;
-        ArrayList<Pointer<MessageDispatch> > redeliveries;
 
     private:
 
-        NonBlockingRedeliveryTask(const NonBlockingRedeliveryTask&);
-        NonBlockingRedeliveryTask& operator=(const NonBlockingRedeliveryTask&);
+        ConsumerRedeliveryTarget(const ConsumerRedeliveryTarget&);
+        ConsumerRedeliveryTarget& operator=(const ConsumerRedeliveryTarget&);
 
     public:
 
-        NonBlockingRedeliveryTask(ActiveMQSessionKernel* session, Pointer<ActiveMQConsumerKernel> consumer, ActiveMQConsumerKernelConfig* impl) :
-            Runnable(), session(session), consumer(consumer), impl(impl), redeliveries() {
-
-            this->redeliveries.copy(impl->deliveredMessages);
-            Collections::reverse(this->redeliveries);
-        }
-        virtual ~NonBlockingRedeliveryTask() {}
+        ConsumerRedeliveryTarget(ActiveMQSessionKernel* session, ActiveMQConsumerKernelConfig* impl) :
+            RedeliveryScheduler::Target(), session(session), impl(impl) {}
+        virtual ~ConsumerRedeliveryTarget() {}
 
-        virtual void run() {
+        virtual void redeliver(const std::vector< Pointer<MessageDispatch> >& messages) {
             try {
                 if (!impl->unconsumedMessages->isClosed()) {
-                    Pointer<Iterator<Pointer<MessageDispatch> > > iter(redeliveries.iterator());
-                    while (iter->hasNext() && !impl->unconsumedMessages->isClosed()) {
-                        Pointer<MessageDispatch> dispatch = iter->next();
-                        session->dispatch(dispatch);
-                    }
+                    session->redispatch(messages);
                 }
             } catch (Exception& e) {
                 session->getConnection()->onAsyncException(e);
             }
-
-            this->consumer.reset(NULL);
         }
     };
 }
@@ -780,12 +1104,29 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
     this->internal->redeliveryPolicy.reset(this->session->getConnection()->getRedeliveryPolicy()->clone());
     this->internal->scheduler = this->session->getScheduler();
 
+    bool useRingDispatchChannel = Boolean::parseBoolean(destination->getOptions().getProperty(
+        "consumer.useRingDispatchChannel", Boolean::toString(session->getConnection()->isUseRingDispatchChannel())));
+
+    // Only the latest value of each key matters to a conflating consumer, which is only
+    // meaningful for a plain topic subscription since nothing else may skip messages.
+    std::string conflationKey = destination->getOptions().getProperty("consumer.conflationKey", "");
+    bool conflate = !conflationKey.empty() && destination->isTopic() && name.empty() && !browser;
+
     if (this->session->getConnection()->isMessagePrioritySupported()) {
         this->internal->unconsumedMessages.reset(new SimplePriorityMessageDispatchChannel());
+    } else if (conflate) {
+        this->internal->conflatingChannel.reset(new ConflatingMessageDispatchChannel(conflationKey));
+        this->internal->unconsumedMessages = this->internal->conflatingChannel;
+    } else if (useRingDispatchChannel) {
+        this->internal->unconsumedMessages.reset(new RingMessageDispatchChannel(prefetch));
     } else {
         this->internal->unconsumedMessages.reset(new FifoMessageDispatchChannel());
     }
 
+    // An individual ack handler holds the dispatch and can't be stored in its own message.
+    this->internal->useBorrowedMessages =
+        session->getConnection()->isUseBorrowedMessages() && !session->isIndividualAcknowledge();
+
     if (listener != NULL) {
         this->setMessageListener(listener);
     }
@@ -796,6 +1137,9 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
         this->internal->optimizeAcknowledge = true;
     }
 
+    this->internal->ackCoalesceCount = session->getConnection()->getAckCoalesceCount();
+    this->internal->ackCoalesceDelay = session->getConnection()->getAckCoalesceDelay();
+
     if (this->internal->optimizeAcknowledge) {
         this->internal->optimizeAcknowledgeTimeOut = session->getConnection()->getOptimizeAcknowledgeTimeOut();
         this->setOptimizedAckScheduledAckInterval(
@@ -812,6 +1156,37 @@ ActiveMQConsumerKernel::ActiveMQConsumerKernel(ActiveMQSessionKernel* session,
         this->session->getConnection()->isMessagePrioritySupported();
     this->internal->consumerExpiryCheckEnabled =
         this->session->getConnection()->isConsumerExpiryCheckEnabled();
+    this->internal->prefetchMemoryLimit = Long::parseLong(destination->getOptions().getProperty(
+        "consumer.prefetchMemoryLimit",
+        Long::toString(session->getConnection()->getPrefetchPolicy()->getPrefetchMemoryLimit())));
+    this->internal->pullBatchSize = Integer::parseInt(destination->getOptions().getProperty(
+        "consumer.pullBatchSize",
+        Integer::toString(session->getConnection()->getPrefetchPolicy()->getPullBatchSize())));
+
+    long long targetLatency = Long::parseLong(destination->getOptions().getProperty(
+        "consumer.prefetchTargetLatency",
+        Long::toString(session->getConnection()->getPrefetchPolicy()->getPrefetchTargetLatency())));
+
+    if (targetLatency > 0 && this->consumerInfo->getPrefetchSize() > 0 && !this->consumerInfo->isBrowser()) {
+        this->internal->prefetchTuner.reset(new PrefetchTuner(this->consumerInfo->getPrefetchSize(), targetLatency));
+    }
+
+    // Messages can only be delivered on several threads where the acks don't take part
+    // in a transaction or wait for the application.
+    int groupDispatchLanes = Integer::parseInt(destination->getOptions().getProperty(
+        "consumer.groupDispatchLanes", Integer::toString(session->getConnection()->getGroupDispatchLanes())));
+
+    if (groupDispatchLanes > 0 && !this->consumerInfo->isBrowser() &&
+        (session->isAutoAcknowledge() || session->isDupsOkAcknowledge())) {
+        this->internal->groupDispatchLanes = groupDispatchLanes;
+    }
+
+    int parallelListenerThreads = Integer::parseInt(destination->getOptions().getProperty(
+        "consumer.parallelListenerThreads", Integer::toString(session->getConnection()->getParallelListenerThreads())));
+
+    if (parallelListenerThreads > 0 && !this->consumerInfo->isBrowser() && session->isIndividualAcknowledge()) {
+        this->internal->parallelListenerThreads = parallelListenerThreads;
+    }
 
     if (this->consumerInfo->getPrefetchSize() < 0) {
         delete this->internal;
@@ -843,6 +1218,10 @@ void ActiveMQConsumerKernel::start() {
     this->internal->started.set(true);
     this->internal->unconsumedMessages->start();
     this->session->wakeup();
+
+    if (this->internal->asyncReceives->waiting) {
+        completeAsyncReceives();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -862,16 +1241,11 @@ void ActiveMQConsumerKernel::close() {
     try {
         if (!this->isClosed()) {
 
-            if (!this->internal->deliveredMessages.isEmpty() &&
-                this->session->getTransactionContext() != NULL &&
-                this->session->getTransactionContext()->isInTransaction() &&
-                this->internal->closeSyncRegistered.compareAndSet(false, true)) {
+            if (this->session->isTransacted()) {
+                this->session->getTransactionContext()->completePendingCommit();
+            }
 
-                Pointer<ActiveMQConsumerKernel> self =
-                    this->session->lookupConsumerKernel(this->consumerInfo->getConsumerId());
-                Pointer<Synchronization> sync(new CloseSynhcronization(self));
-                this->session->getTransactionContext()->addSynchronization(sync);
-            } else {
+            if (!deferCloseToTransaction()) {
                 doClose();
             }
         }
@@ -879,6 +1253,71 @@ void ActiveMQConsumerKernel::close() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::closeAsync(Pointer<transport::ResponseCallback> onRemoved) {
+
+    try {
+
+        if (this->isClosed()) {
+            return false;
+        }
+
+        if (this->session->isTransacted()) {
+            this->session->getTransactionContext()->completePendingCommit();
+        }
+
+        if (deferCloseToTransaction()) {
+            return false;
+        }
+
+        bool interrupted = Thread::interrupted();
+
+        dispose();
+        bool removing = !this->internal->multiplexed;
+        if (removing) {
+            ActiveMQConnection* connection = this->session->getConnection();
+            connection->checkClosedOrFailed();
+            connection->getTransport().asyncRequest(createRemoveInfo(), onRemoved);
+        }
+        if (interrupted) {
+            Thread::currentThread()->interrupt();
+        }
+
+        return removing;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::deferCloseToTransaction() {
+
+    // Messages delivered in the open transaction are acked when it ends, the consumer
+    // is closed by a Synchronization once it does.
+    if (!this->internal->deliveredMessages.isEmpty() &&
+        this->session->getTransactionContext() != NULL &&
+        this->session->getTransactionContext()->isInTransaction() &&
+        this->internal->closeSyncRegistered.compareAndSet(false, true)) {
+
+        Pointer<ActiveMQConsumerKernel> self =
+            this->session->lookupConsumerKernel(this->consumerInfo->getConsumerId());
+        Pointer<Synchronization> sync(new CloseSynhcronization(self));
+        this->session->getTransactionContext()->addSynchronization(sync);
+        return true;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<RemoveInfo> ActiveMQConsumerKernel::createRemoveInfo() const {
+    Pointer<RemoveInfo> info(new RemoveInfo);
+    info->setObjectId(this->consumerInfo->getConsumerId());
+    info->setLastDeliveredSequenceId(this->internal->lastDeliveredSequenceId);
+    return info;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::doClose() {
 
@@ -890,11 +1329,11 @@ void ActiveMQConsumerKernel::doClose() {
         dispose();
         // Remove at the Broker Side, consumer has been removed from the local
         // Session and Connection objects so if the remote call to remove throws
-        // it is okay to propagate to the client.
-        Pointer<RemoveInfo> info(new RemoveInfo);
-        info->setObjectId(this->consumerInfo->getConsumerId());
-        info->setLastDeliveredSequenceId(this->internal->lastDeliveredSequenceId);
-        this->session->oneway(info);
+        // it is okay to propagate to the client.  A consumer that shared a subscription
+        // has left it and the subscription is removed once it is empty.
+        if (!this->internal->multiplexed) {
+            this->session->oneway(createRemoveInfo());
+        }
         if (interrupted) {
             Thread::currentThread()->interrupt();
         }
@@ -920,6 +1359,19 @@ void ActiveMQConsumerKernel::dispose() {
 
             this->internal->started.set(false);
 
+            // Messages being delivered on the lanes are acked, those still queued are left
+            // to the broker to redeliver.
+            Pointer<KeyedSerialExecutor> laneExecutor;
+            synchronized(&this->internal->laneMutex) {
+                this->internal->lanesClosing = true;
+                laneExecutor.swap(this->internal->laneExecutor);
+                this->internal->laneSelf.reset(NULL);
+            }
+            if (laneExecutor != NULL) {
+                laneExecutor->shutdown();
+            }
+            flushHeldAcks();
+
             if (this->internal->executor != NULL) {
                 this->internal->executor->shutdown();
                 this->internal->executor->awaitTermination(60, TimeUnit::SECONDS);
@@ -931,6 +1383,10 @@ void ActiveMQConsumerKernel::dispose() {
                 this->internal->optimizedAckTask = NULL;
             }
 
+            if (this->internal->redeliveryScheduler != NULL) {
+                this->internal->redeliveryScheduler->close();
+            }
+
             if (session->isClientAcknowledge() || session->isIndividualAcknowledge()) {
                 if (!this->consumerInfo->isBrowser()) {
                     // roll back duplicates that aren't acknowledged
@@ -965,8 +1421,18 @@ void ActiveMQConsumerKernel::dispose() {
                 }
             }
 
+            if (this->internal->conflatingChannel != NULL) {
+                synchronized(this->internal->unconsumedMessages.get()) {
+                    this->internal->ackSuperseded(true);
+                }
+            }
+
+            // Acks the Session held back go out before the consumer's RemoveInfo.
+            this->session->sendPendingAcks();
+
             // Stop and Wakeup all sync consumers.
             this->internal->unconsumedMessages->close();
+            cancelAsyncReceives();
 
             // Remove this Consumer from the Connections set of Dispatchers
             Pointer<ActiveMQConsumerKernel> consumer(this);
@@ -989,6 +1455,9 @@ void ActiveMQConsumerKernel::dispose() {
                 }
             }
 
+            // The bytes this consumer reported no longer count against the budget.
+            reportConsumerMemory();
+
             // If we encountered an error, propagate it.
             if (haveException) {
                 error.setMark(__FILE__, __LINE__);
@@ -1015,15 +1484,46 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
 
     try {
 
+        // The time since the last receive returned is what the application took to
+        // process that message.
+        if (this->internal->lastReceiveTime != 0) {
+            tunePrefetch(System::nanoTime() - this->internal->lastReceiveTime);
+            this->internal->lastReceiveTime = 0;
+        }
+
         // Calculate the deadline
         long long deadline = 0;
         if (timeout > 0) {
             deadline = System::currentTimeMillis() + timeout;
         }
 
+        // Expired messages found one after the other are acknowledged together, and the
+        // clock is read once per wait for messages rather than once per message.
+        std::vector< Pointer<MessageDispatch> > expired;
+        long long now = 0;
+
         // Loop until the time is up or we get a non-expired message
         while (true) {
-            Pointer<MessageDispatch> dispatch = this->internal->unconsumedMessages->dequeue(timeout);
+
+            Pointer<MessageDispatch> dispatch;
+            if (expired.empty()) {
+                dispatch = this->internal->unconsumedMessages->dequeue(timeout);
+                now = System::coarseTimeMillis();
+            } else {
+                dispatch = this->internal->unconsumedMessages->dequeueNoWait();
+                if (dispatch == NULL) {
+                    // The run ends with the queued messages, ack it before waiting for more.
+                    acknowledgeExpired(expired);
+                    if (timeout > 0) {
+                        timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
+                    }
+
+                    sendPullRequest(timeout);
+                    continue;
+                }
+            }
+
+            checkPrefetchMemoryLimit();
             if (dispatch == NULL) {
                 if (timeout > 0 && !this->internal->unconsumedMessages->isClosed()) {
                     timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
@@ -1035,27 +1535,32 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
                     }
                 }
             } else if (dispatch->getMessage() == NULL) {
+                acknowledgeExpired(expired);
                 return Pointer<MessageDispatch> ();
-            } else if (internal->consumeExpiredMessage(dispatch)) {
+            } else if (internal->consumeExpiredMessage(dispatch, now)) {
                 beforeMessageIsConsumed(dispatch);
-                afterMessageIsConsumed(dispatch, true);
-                if (timeout > 0) {
-                    timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
+                if (!internal->canJoinExpiredRun(dispatch)) {
+                    acknowledgeExpired(expired);
                 }
+                expired.push_back(dispatch);
+            } else {
+                acknowledgeExpired(expired);
+                if (internal->redeliveryExceeded(dispatch)) {
+                    internal->posionAck(dispatch,
+                                        "dispatch to " + getConsumerId()->toString() +
+                                        " exceeds RedeliveryPolicy limit: " +
+                                        Integer::toString(internal->redeliveryPolicy->getMaximumRedeliveries()));
+                    if (timeout > 0) {
+                        timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
+                    }
 
-                sendPullRequest(timeout);
-            } else if (internal->redeliveryExceeded(dispatch)) {
-                internal->posionAck(dispatch,
-                                    "dispatch to " + getConsumerId()->toString() +
-                                    " exceeds RedeliveryPolicy limit: " +
-                                    Integer::toString(internal->redeliveryPolicy->getMaximumRedeliveries()));
-                if (timeout > 0) {
-                    timeout = Math::max(deadline - System::currentTimeMillis(), 0LL);
+                    sendPullRequest(timeout);
+                } else {
+                    if (this->internal->prefetchTuner != NULL) {
+                        this->internal->lastReceiveTime = System::nanoTime();
+                    }
+                    return dispatch;
                 }
-
-                sendPullRequest(timeout);
-            } else {
-                return dispatch;
             }
         }
 
@@ -1067,6 +1572,55 @@ decaf::lang::Pointer<MessageDispatch> ActiveMQConsumerKernel::dequeue(long long
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::dequeueAll(std::vector< Pointer<MessageDispatch> >& batch, int max) {
+
+    std::vector< Pointer<MessageDispatch> > taken;
+    taken.reserve(max);
+
+    this->internal->unconsumedMessages->dequeueAll(taken, max);
+    checkPrefetchMemoryLimit();
+
+    // One clock reading serves the whole batch, and each run of expired messages in it
+    // is acknowledged with one ack.
+    std::vector< Pointer<MessageDispatch> > expired;
+    long long now = System::coarseTimeMillis();
+
+    int count = 0;
+    std::vector< Pointer<MessageDispatch> >::const_iterator iter = taken.begin();
+    for (; iter != taken.end(); ++iter) {
+
+        const Pointer<MessageDispatch>& dispatch = *iter;
+
+        if (dispatch->getMessage() == NULL) {
+            continue;
+        } else if (internal->consumeExpiredMessage(dispatch, now)) {
+            beforeMessageIsConsumed(dispatch);
+            if (!internal->canJoinExpiredRun(dispatch)) {
+                acknowledgeExpired(expired);
+            }
+            expired.push_back(dispatch);
+            continue;
+        }
+
+        acknowledgeExpired(expired);
+
+        if (internal->redeliveryExceeded(dispatch)) {
+            internal->posionAck(dispatch,
+                                "dispatch to " + getConsumerId()->toString() +
+                                " exceeds RedeliveryPolicy limit: " +
+                                Integer::toString(internal->redeliveryPolicy->getMaximumRedeliveries()));
+        } else {
+            batch.push_back(dispatch);
+            count++;
+        }
+    }
+
+    acknowledgeExpired(expired);
+
+    return count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 cms::Message* ActiveMQConsumerKernel::receive() {
 
@@ -1084,8 +1638,10 @@ cms::Message* ActiveMQConsumerKernel::receive() {
             return NULL;
         }
 
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *message);
         beforeMessageIsConsumed(message);
         afterMessageIsConsumed(message, false);
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *message);
 
         // Need to clone the message because the user is responsible for freeing
         // its copy of the message, createCMSMessage will do this for us.
@@ -1120,8 +1676,10 @@ cms::Message* ActiveMQConsumerKernel::receive(int timeout) {
             return NULL;
         }
 
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *message);
         beforeMessageIsConsumed(message);
         afterMessageIsConsumed(message, false);
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *message);
 
         // Need to clone the message because the user is responsible for freeing
         // its copy of the message, createCMSMessage will do this for us.
@@ -1131,56 +1689,274 @@ cms::Message* ActiveMQConsumerKernel::receive(int timeout) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-cms::Message* ActiveMQConsumerKernel::receiveNoWait() {
+int ActiveMQConsumerKernel::receive(std::vector<cms::Message*>& messages, int max, int millisecs) {
 
     try {
 
-        this->checkClosed();
-        this->checkMessageListener();
-
-        // Send a request for a new message if needed
-        this->sendPullRequest(-1);
-
-        // Get the next available message, if there is one.
-        Pointer<MessageDispatch> message;
-        if (internal->info->getPrefetchSize() == 0) {
-            message = dequeue(-1);  // Broker will signal if no message.
-        } else {
-            message = dequeue(0);
-        }
+        std::vector< Pointer<MessageDispatch> > batch;
+        consumeBatch(batch, max, millisecs);
 
-        if (message == NULL) {
-            return NULL;
+        std::size_t start = messages.size();
+        try {
+            std::vector< Pointer<MessageDispatch> >::const_iterator iter = batch.begin();
+            for (; iter != batch.end(); ++iter) {
+                this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, **iter);
+
+                // Need to clone the messages because the user is responsible for freeing
+                // its copies of the messages, createCMSMessage will do this for us.
+                messages.push_back(NULL);
+                messages.back() = createCMSMessage(*iter).release();
+            }
+        } catch (...) {
+            for (std::size_t i = start; i < messages.size(); ++i) {
+                delete messages[i];
+            }
+            messages.resize(start);
+            throw;
         }
 
-        beforeMessageIsConsumed(message);
-        afterMessageIsConsumed(message, false);
-
-        // Need to clone the message because the user is responsible for freeing
-        // its copy of the message, createCMSMessage will do this for us.
-        return createCMSMessage(message).release();
+        return (int) batch.size();
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ActiveMQConsumerKernel::setMessageListener(cms::MessageListener* listener) {
+void ActiveMQConsumerKernel::receiveAsync(ReceiveCallback* callback, int millisecs) {
 
     try {
 
-        this->checkClosed();
-
-        if (this->consumerInfo->getPrefetchSize() == 0 && listener != NULL) {
-            throw ActiveMQException(__FILE__, __LINE__,
-                "Cannot deliver async when Prefetch is Zero, set Prefecth to at least One.");
+        if (callback == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "ReceiveCallback cannot be NULL.");
         }
 
-        if (listener != NULL) {
+        this->checkClosed();
+        this->checkMessageListener();
 
-            // Now that we have a valid message listener, redispatch all the messages that it missed.
-            bool wasStarted = session->isStarted();
-            if (wasStarted) {
-                session->stop();
+        Pointer<AsyncReceives> receives = this->internal->asyncReceives;
+        Pointer<AsyncReceives::Pending> receive(new AsyncReceives::Pending(callback));
+
+        synchronized(&receives->mutex) {
+            receives->pending.push_back(receive);
+            receives->waiting = true;
+            if (millisecs > 0) {
+                Pointer<Runnable> task(new AsyncReceiveTimeoutTask(receives, receive));
+                receive->timeout = TimingWheel::getSharedInstance().schedule(task, millisecs);
+            }
+        }
+
+        // Send a request for a new message if needed, the broker's answer is
+        // dispatched as any other message and completes the receive from there.
+        this->sendPullRequest(millisecs < 0 ? -1 : millisecs);
+        completeAsyncReceives();
+
+        if (this->isClosed()) {
+            cancelAsyncReceives();
+        } else if (millisecs < 0 && receives->remove(receive)) {
+            std::vector<AsyncReceives::Completion> completed;
+            completed.push_back(AsyncReceives::Completion(callback, NULL, NULL));
+            AsyncReceives::complete(completed);
+        }
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::completeAsyncReceives() {
+
+    Pointer<AsyncReceives> receives = this->internal->asyncReceives;
+    std::vector<AsyncReceives::Completion> completed;
+
+    // Messages are taken under the lock so the receives are completed in the order
+    // they were made, the callbacks are called once it is released.
+    synchronized(&receives->mutex) {
+
+        while (!receives->pending.empty()) {
+
+            Pointer<AsyncReceives::Pending> receive = receives->pending.front();
+
+            try {
+
+                Pointer<MessageDispatch> message = dequeue(0);
+                if (message == NULL) {
+                    break;
+                }
+
+                this->session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *message);
+                beforeMessageIsConsumed(message);
+                afterMessageIsConsumed(message, false);
+                this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *message);
+
+                completed.push_back(AsyncReceives::Completion(
+                    receive->callback, createCMSMessage(message).release(), NULL));
+
+            } catch (cms::CMSException& ex) {
+                completed.push_back(AsyncReceives::Completion(receive->callback, NULL, ex.clone()));
+            } catch (Exception& ex) {
+                completed.push_back(AsyncReceives::Completion(
+                    receive->callback, NULL, CMSExceptionSupport::create(ex).clone()));
+            }
+
+            receives->pending.pop_front();
+            AsyncReceives::release(receive);
+        }
+
+        receives->waiting = !receives->pending.empty();
+    }
+
+    AsyncReceives::complete(completed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::cancelAsyncReceives() {
+
+    Pointer<AsyncReceives> receives = this->internal->asyncReceives;
+    std::vector<AsyncReceives::Completion> completed;
+
+    synchronized(&receives->mutex) {
+        while (!receives->pending.empty()) {
+            Pointer<AsyncReceives::Pending> receive = receives->pending.front();
+            receives->pending.pop_front();
+            AsyncReceives::release(receive);
+            completed.push_back(AsyncReceives::Completion(receive->callback, NULL, NULL));
+        }
+        receives->waiting = false;
+    }
+
+    AsyncReceives::complete(completed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::receiveBorrowed(std::vector< Pointer<cms::Message> >& messages, int max, int millisecs) {
+
+    try {
+
+        std::vector< Pointer<MessageDispatch> > batch;
+        consumeBatch(batch, max, millisecs);
+
+        // A transformer may replace the message, it works on a copy as in dispatch.
+        bool borrowed = this->internal->transformer == NULL;
+
+        std::vector< Pointer<MessageDispatch> >::const_iterator iter = batch.begin();
+        for (; iter != batch.end(); ++iter) {
+            this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, **iter);
+            messages.push_back(borrowed ? borrowCMSMessage(*iter) : createCMSMessage(*iter));
+        }
+
+        return (int) batch.size();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::consumeBatch(std::vector< Pointer<MessageDispatch> >& batch, int max, int millisecs) {
+
+    this->checkClosed();
+    this->checkMessageListener();
+
+    if (max < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Can't receive a batch of less than one message: %d", max);
+    }
+
+    bool pull = internal->info->getPrefetchSize() == 0;
+
+    // Send a request for a new message if needed
+    this->sendPullRequest(millisecs < 0 ? -1 : millisecs);
+
+    // Wait for the first message as the single message receive calls would.
+    Pointer<MessageDispatch> first;
+    if (millisecs == 0 || pull) {
+        first = dequeue(-1);
+    } else {
+        first = dequeue(millisecs < 0 ? 0 : millisecs);
+    }
+
+    if (first == NULL) {
+        return;
+    }
+
+    batch.reserve(max);
+    batch.push_back(first);
+
+    // A pull consumer only ever has the message it asked for.
+    if (max > 1 && !pull) {
+        dequeueAll(batch, max - 1);
+    }
+
+    std::vector< Pointer<MessageDispatch> >::const_iterator iter = batch.begin();
+    for (; iter != batch.end(); ++iter) {
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, **iter);
+        beforeMessageIsConsumed(*iter);
+    }
+
+    // Every message consumed in auto ack mode is covered by the one ack sent for the
+    // last of them, the other modes account for each message on its own.
+    if (isAutoAcknowledgeEach() && !this->session->isTransacted()) {
+        if (this->internal->optimizeAcknowledge) {
+            synchronized(&this->internal->deliveredMessages) {
+                this->internal->ackCounter += (int) batch.size() - 1;
+            }
+        }
+        afterMessageIsConsumed(batch.back(), false);
+    } else {
+        for (iter = batch.begin(); iter != batch.end(); ++iter) {
+            afterMessageIsConsumed(*iter, false);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+cms::Message* ActiveMQConsumerKernel::receiveNoWait() {
+
+    try {
+
+        this->checkClosed();
+        this->checkMessageListener();
+
+        // Send a request for a new message if needed
+        this->sendPullRequest(-1);
+
+        // Get the next available message, if there is one.
+        Pointer<MessageDispatch> message;
+        if (internal->info->getPrefetchSize() == 0) {
+            message = dequeue(-1);  // Broker will signal if no message.
+        } else {
+            message = dequeue(0);
+        }
+
+        if (message == NULL) {
+            return NULL;
+        }
+
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *message);
+        beforeMessageIsConsumed(message);
+        afterMessageIsConsumed(message, false);
+        this->session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *message);
+
+        // Need to clone the message because the user is responsible for freeing
+        // its copy of the message, createCMSMessage will do this for us.
+        return createCMSMessage(message).release();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setMessageListener(cms::MessageListener* listener) {
+
+    try {
+
+        this->checkClosed();
+
+        if (this->consumerInfo->getPrefetchSize() == 0 && listener != NULL) {
+            throw ActiveMQException(__FILE__, __LINE__,
+                "Cannot deliver async when Prefetch is Zero, set Prefecth to at least One.");
+        }
+
+        if (listener != NULL) {
+
+            // Now that we have a valid message listener, redispatch all the messages that it missed.
+            bool wasStarted = session->isStarted();
+            if (wasStarted) {
+                session->stop();
             }
 
             synchronized(&(this->internal->listenerMutex)) {
@@ -1203,6 +1979,12 @@ void ActiveMQConsumerKernel::setMessageListener(cms::MessageListener* listener)
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::beforeMessageIsConsumed(Pointer<MessageDispatch> dispatch) {
+
+    if (this->session->isTransacted()) {
+        // A commit still in flight clears the delivered messages of its transaction.
+        this->session->getTransactionContext()->completePendingCommit();
+    }
+
     this->internal->lastDeliveredSequenceId = dispatch->getMessage()->getMessageId()->getBrokerSequenceId();
 
     if (!isAutoAcknowledgeBatch()) {
@@ -1244,6 +2026,36 @@ void ActiveMQConsumerKernel::registerSync() {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::acknowledgeExpired(std::vector< Pointer<MessageDispatch> >& expired) {
+
+    try {
+
+        if (expired.empty()) {
+            return;
+        }
+
+        if (!this->internal->unconsumedMessages->isClosed()) {
+
+            Pointer<MessageAck> ack(new MessageAck(expired.back(), ActiveMQConstants::ACK_TYPE_EXPIRED, (int) expired.size()));
+            ack->setFirstMessageId(expired.front()->getMessage()->getMessageId());
+            session->sendAck(ack);
+
+            synchronized(&this->internal->deliveredMessages) {
+                std::vector< Pointer<MessageDispatch> >::const_iterator iter = expired.begin();
+                for (; iter != expired.end(); ++iter) {
+                    this->internal->deliveredMessages.remove(*iter);
+                }
+            }
+        }
+
+        expired.clear();
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> message, bool messageExpired ) {
 
@@ -1272,7 +2084,7 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
                                     this->internal->deliveredMessages.clear();
                                     this->internal->ackCounter = 0;
                                     this->session->sendAck(ack);
-                                    this->internal->optimizeAckTimestamp = System::currentTimeMillis();
+                                    this->internal->optimizeAckTimestamp = System::coarseTimeMillis();
                                 }
 
                                 // As further optimization send ack for expired messages when there
@@ -1285,7 +2097,8 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
                                     this->internal->deliveredCounter = 0;
                                 }
                             }
-                        } else {
+                        } else if (!this->internal->isAckCoalescing() ||
+                                   this->internal->isTimeForCoalescedAck(this->consumerInfo->getPrefetchSize())) {
                             Pointer<MessageAck> ack =
                                 makeAckForAllDeliveredMessages(ActiveMQConstants::ACK_TYPE_CONSUMED);
                             if (ack != NULL) {
@@ -1318,6 +2131,28 @@ void ActiveMQConsumerKernel::afterMessageIsConsumed(Pointer<MessageDispatch> mes
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::deliverCoalescedAcks(Pointer<MessageDispatch> failed) {
+
+    if (!isAutoAcknowledgeEach() || !this->internal->isAckCoalescing()) {
+        return;
+    }
+
+    synchronized(&this->internal->deliveredMessages) {
+
+        if (this->internal->deliveredMessages.size() > 1 && this->internal->deliveredMessages.getFirst() == failed) {
+            this->internal->deliveredMessages.removeFirst();
+            Pointer<MessageAck> ack = makeAckForAllDeliveredMessages(ActiveMQConstants::ACK_TYPE_CONSUMED);
+            this->internal->deliveredMessages.clear();
+            this->internal->deliveredMessages.addFirst(failed);
+
+            if (ack != NULL) {
+                session->sendAck(ack);
+            }
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::deliverAcks() {
 
@@ -1407,7 +2242,7 @@ Pointer<MessageAck> ActiveMQConsumerKernel::makeAckForAllDeliveredMessages(int t
         if (!this->internal->deliveredMessages.isEmpty()) {
 
             Pointer<MessageDispatch> dispatched = this->internal->deliveredMessages.getFirst();
-            Pointer<MessageAck> ack(new MessageAck(dispatched, type, this->internal->deliveredMessages.size()));
+            Pointer<MessageAck> ack = this->internal->nextAck(dispatched, type, this->internal->deliveredMessages.size());
             ack->setFirstMessageId(this->internal->deliveredMessages.getLast()->getMessage()->getMessageId());
 
             return ack;
@@ -1426,6 +2261,10 @@ void ActiveMQConsumerKernel::acknowledge(Pointer<commands::MessageDispatch> disp
 void ActiveMQConsumerKernel::acknowledge(Pointer<commands::MessageDispatch> dispatch, int ackType) {
 
     try {
+        if (this->internal->parallelListenerThreads > 0 && coalesceAck(dispatch, ackType)) {
+            return;
+        }
+
         Pointer<MessageAck> ack(new MessageAck(dispatch, ackType, 1));
         if (ack->isExpiredAck()) {
             ack->setFirstMessageId(ack->getLastMessageId());
@@ -1522,9 +2361,9 @@ void ActiveMQConsumerKernel::rollback() {
 
             Pointer<MessageId> firstMsgId = this->internal->deliveredMessages.getLast()->getMessage()->getMessageId();
 
-            Pointer<Iterator<Pointer<MessageDispatch> > > iter(internal->deliveredMessages.iterator());
-            while (iter->hasNext()) {
-                Pointer<Message> message = iter->next()->getMessage();
+            DeliveredMessageList::const_iterator iter = internal->deliveredMessages.begin();
+            for (; iter != internal->deliveredMessages.end(); ++iter) {
+                Pointer<Message> message = (*iter)->getMessage();
                 message->setRedeliveryCounter(message->getRedeliveryCounter() + 1);
                 // ensure we don't filter this as a duplicate
                 session->getConnection()->rollbackDuplicate(this, message);
@@ -1569,26 +2408,33 @@ void ActiveMQConsumerKernel::rollback() {
                 if (this->internal->nonBlockingRedelivery) {
 
                     if (!this->internal->unconsumedMessages->isClosed()) {
-                        Pointer<ActiveMQConsumerKernel> self =
-                            this->session->lookupConsumerKernel(this->consumerInfo->getConsumerId());
 
-                        NonBlockingRedeliveryTask* redeliveryTask =
-                            new NonBlockingRedeliveryTask(session, self, this->internal);
+                        if (this->internal->redeliveryScheduler == NULL) {
+                            this->internal->redeliveryTarget.reset(
+                                new ConsumerRedeliveryTarget(session, this->internal));
+                            this->internal->redeliveryScheduler.reset(new RedeliveryScheduler(
+                                this->internal->redeliveryTarget.get(), &TimingWheel::getSharedInstance()));
+                        }
+
+                        // The delivered list holds the newest message first.
+                        std::vector< Pointer<MessageDispatch> > redeliveries;
+                        redeliveries.reserve(internal->deliveredMessages.size());
+                        redeliveries.assign(internal->deliveredMessages.begin(), internal->deliveredMessages.end());
+                        std::reverse(redeliveries.begin(), redeliveries.end());
 
                         this->internal->deliveredCounter -= (int) internal->deliveredMessages.size();
                         this->internal->deliveredMessages.clear();
 
-                        this->session->getScheduler()->executeAfterDelay(
-                            redeliveryTask, this->internal->redeliveryDelay);
+                        this->internal->redeliveryScheduler->schedule(
+                            redeliveries, this->internal->redeliveryDelay);
                     }
                 } else {
                     // stop the delivery of messages.
                     this->internal->unconsumedMessages->stop();
 
-                    std::auto_ptr<Iterator<Pointer<MessageDispatch> > > iter(
-                        this->internal->deliveredMessages.iterator());
-                    while (iter->hasNext()) {
-                        this->internal->unconsumedMessages->enqueueFirst(iter->next());
+                    DeliveredMessageList::const_iterator iter = internal->deliveredMessages.begin();
+                    for (; iter != internal->deliveredMessages.end(); ++iter) {
+                        this->internal->unconsumedMessages->enqueueFirst(*iter);
                     }
 
                     this->internal->deliveredCounter -= (int) internal->deliveredMessages.size();
@@ -1624,6 +2470,10 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
 
             if (!this->internal->unconsumedMessages->isClosed()) {
 
+                if (!acceptPullAnswer(dispatch)) {
+                    return;
+                }
+
                 if (this->consumerInfo->isBrowser() || !session->getConnection()->isDuplicate(this, dispatch->getMessage())) {
 
                     synchronized(&this->internal->listenerMutex) {
@@ -1636,18 +2486,41 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                                                     Integer::toString(internal->redeliveryPolicy->getMaximumRedeliveries()));
                                 return;
                             }
-                            Pointer<cms::Message> message = createCMSMessage(dispatch);
+                            if (this->internal->laneCount() > 0) {
+                                dispatchToLane(dispatch);
+                                return;
+                            }
+                            bool borrowed = this->internal->useBorrowedMessages && this->internal->transformer == NULL;
+                            Pointer<cms::Message> message = borrowed ? borrowCMSMessage(dispatch) : createCMSMessage(dispatch);
                             beforeMessageIsConsumed(dispatch);
                             try {
                                 bool expired = isConsumerExpiryCheckEnabled() && dispatch->getMessage()->isExpired();
                                 if (!expired) {
-                                    this->internal->listener->onMessage(message.get());
+                                    long long start = this->internal->prefetchTuner != NULL ? System::nanoTime() : 0;
+                                    session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *dispatch);
+                                    if (borrowed) {
+                                        try {
+                                            this->internal->listener->onMessage(message.get());
+                                        } catch (...) {
+                                            releaseBorrowedMessage(message);
+                                            throw;
+                                        }
+                                        releaseBorrowedMessage(message);
+                                    } else {
+                                        this->internal->listener->onMessage(message.get());
+                                    }
+                                    session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *dispatch);
+                                    if (start != 0) {
+                                        tunePrefetch(System::nanoTime() - start);
+                                    }
                                 }
                                 afterMessageIsConsumed(dispatch, expired);
                             } catch (RuntimeException& e) {
                                 dispatch->setRollbackCause(e);
                                 if (isAutoAcknowledgeBatch() || isAutoAcknowledgeEach() || session->isIndividualAcknowledge()) {
-                                    // Schedule redelivery and possible DLQ processing
+                                    // Schedule redelivery and possible DLQ processing, messages
+                                    // consumed before this one are acked instead of redelivered.
+                                    deliverCoalescedAcks(dispatch);
                                     rollback();
                                 } else {
                                     // Transacted or Client ack: Deliver the next message.
@@ -1660,6 +2533,13 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                                 session->getConnection()->rollbackDuplicate(this, dispatch->getMessage());
                             }
                             this->internal->unconsumedMessages->enqueue(dispatch);
+                            if (this->internal->conflatingChannel != NULL) {
+                                this->internal->ackSuperseded(false);
+                            }
+                            checkPrefetchMemoryLimit();
+                            session->getConnection()->trace(MessageTracer::CONSUMER_ENQUEUE, *dispatch);
+                            session->getConnection()->getMetrics().getPrefetchFill().record(
+                                this->internal->unconsumedMessages->size());
                             if (this->internal->messageAvailableListener != NULL) {
                                 this->internal->messageAvailableListener->onMessageAvailable(this);
                             }
@@ -1689,6 +2569,232 @@ void ActiveMQConsumerKernel::dispatch(const Pointer<MessageDispatch>& dispatch)
                 Thread::yield();
             }
         }
+
+        if (this->internal->asyncReceives->waiting) {
+            completeAsyncReceives();
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::dispatchToLane(const Pointer<MessageDispatch>& dispatch) {
+
+    // A parallel listener acks each message itself, it is delivered as any other then.
+    if (this->internal->parallelListenerThreads > 0) {
+        beforeMessageIsConsumed(dispatch);
+    } else {
+        this->internal->lastDeliveredSequenceId = dispatch->getMessage()->getMessageId()->getBrokerSequenceId();
+    }
+
+    Pointer<KeyedSerialExecutor> executor;
+    Pointer<ActiveMQConsumerKernel> self;
+    long long sequence = 0;
+
+    synchronized(&this->internal->laneMutex) {
+
+        if (this->internal->lanesClosing) {
+            return;
+        }
+
+        if (this->internal->laneExecutor == NULL) {
+            this->internal->laneSelf = this->session->lookupConsumerKernel(this->consumerInfo->getConsumerId());
+            this->internal->laneExecutor.reset(new KeyedSerialExecutor(
+                this->internal->laneCount(),
+                std::string("ActiveMQConsumer[") + this->consumerInfo->getConsumerId()->toString() + "] Dispatch"));
+        }
+
+        executor = this->internal->laneExecutor;
+        self = this->internal->laneSelf;
+        sequence = this->internal->laneTracker.add(dispatch);
+
+        if (this->internal->parallelListenerThreads > 0) {
+            this->internal->laneSequences[dispatch.get()] = sequence;
+        }
+    }
+
+    // Messages without a group share the lane of the empty group and keep their order,
+    // those for a parallel listener take the lanes in turn.
+    int key = (int) sequence;
+    if (this->internal->groupDispatchLanes > 0) {
+        key = decaf::util::HashCode<std::string>()(dispatch->getMessage()->getGroupID());
+    }
+
+    executor->execute(key, new LaneTask(self, this->session, dispatch, this->internal->listener, sequence));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::consumeOnLane(Pointer<MessageDispatch> dispatch,
+                                           cms::MessageListener* listener, long long sequence) {
+
+    try {
+
+        if (this->internal->lanesClosing || this->internal->unconsumedMessages->isClosed()) {
+            return;
+        }
+
+        bool parallel = this->internal->parallelListenerThreads > 0;
+
+        if (isConsumerExpiryCheckEnabled() && dispatch->getMessage()->isExpired()) {
+            acknowledge(dispatch, ActiveMQConstants::ACK_TYPE_EXPIRED);
+            if (parallel) {
+                return;
+            }
+        } else {
+
+            // A failing listener is retried on the lane, holding back the rest of its
+            // group, until the redelivery policy gives up on the message.
+            long long delay = 0;
+            for (int attempt = 1;; ++attempt) {
+                try {
+                    Pointer<cms::Message> message = createCMSMessage(dispatch);
+                    session->getConnection()->trace(MessageTracer::CONSUMER_DELIVER, *dispatch);
+                    listener->onMessage(message.get());
+                    session->getConnection()->trace(MessageTracer::CONSUMER_CONSUMED, *dispatch);
+                    break;
+                } catch (RuntimeException& e) {
+                    dispatch->setRollbackCause(e);
+
+                    int maximum = this->internal->redeliveryPolicy->getMaximumRedeliveries();
+                    if (maximum != RedeliveryPolicy::NO_MAXIMUM_REDELIVERIES && attempt > maximum) {
+                        internal->posionAck(dispatch,
+                            "Exceeded RedeliveryPolicy max redelivery limit: " + Integer::toString(maximum) +
+                            " cause: Exception -> " + e.getMessage());
+                        if (parallel) {
+                            coalesceAck(dispatch, ActiveMQConstants::ACK_TYPE_POISON);
+                            synchronized(&this->internal->deliveredMessages) {
+                                this->internal->deliveredMessages.remove(dispatch);
+                            }
+                            return;
+                        }
+                        break;
+                    }
+
+                    delay = attempt == 1 ? this->internal->redeliveryPolicy->getInitialRedeliveryDelay() :
+                                           this->internal->redeliveryPolicy->getNextRedeliveryDelay(delay);
+                    if (delay > 0) {
+                        Thread::sleep(delay);
+                    }
+
+                    if (this->internal->lanesClosing || this->internal->unconsumedMessages->isClosed()) {
+                        return;
+                    }
+
+                    Pointer<Message> redelivered = dispatch->getMessage();
+                    redelivered->setRedeliveryCounter(redelivered->getRedeliveryCounter() + 1);
+                }
+            }
+        }
+
+        // Acks go out in dispatch order, each for the messages it releases.  A parallel
+        // listener acks the message itself, if it hasn't yet the broker is told of its
+        // delivery as it would be without the lanes.
+        synchronized(&this->internal->laneMutex) {
+            if (parallel) {
+                afterMessageIsConsumed(dispatch, false);
+            } else {
+                Pointer<MessageDispatch> first;
+                Pointer<MessageDispatch> last;
+                int released = this->internal->laneTracker.complete(sequence, first, last);
+                sendRangeAck(first, last, released);
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::sendRangeAck(Pointer<MessageDispatch> first, Pointer<MessageDispatch> last, int count) {
+
+    if (count > 0 && !this->internal->unconsumedMessages->isClosed()) {
+        Pointer<MessageAck> ack(new MessageAck(last, ActiveMQConstants::ACK_TYPE_CONSUMED, count));
+        ack->setFirstMessageId(first->getMessage()->getMessageId());
+        this->session->sendAck(ack);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::coalesceAck(Pointer<MessageDispatch> dispatch, int ackType) {
+
+    synchronized(&this->internal->laneMutex) {
+
+        std::map<const MessageDispatch*, long long>::iterator found =
+            this->internal->laneSequences.find(dispatch.get());
+        if (found == this->internal->laneSequences.end()) {
+            return false;
+        }
+
+        long long sequence = found->second;
+        this->internal->laneSequences.erase(found);
+
+        Pointer<MessageDispatch> first;
+        Pointer<MessageDispatch> last;
+
+        // Any other ack is sent on its own, it only stops holding back the range.
+        if (ackType != ActiveMQConstants::ACK_TYPE_INDIVIDUAL) {
+            int released = this->internal->laneTracker.exclude(sequence, first, last);
+            releaseHeldAcks();
+            sendRangeAck(first, last, released);
+            return false;
+        }
+
+        int released = this->internal->laneTracker.complete(sequence, first, last);
+        if (released > 0) {
+            releaseHeldAcks();
+            sendRangeAck(first, last, released);
+        } else {
+            this->internal->heldAcks[sequence] = dispatch;
+
+            // A message the application never acks would hold back every ack after it,
+            // past half the prefetch the held acks are sent on their own instead.
+            int limit = Math::max(1, this->consumerInfo->getPrefetchSize() / 2);
+            if ((int) this->internal->heldAcks.size() >= limit) {
+                std::map<long long, Pointer<MessageDispatch> >::iterator iter = this->internal->heldAcks.begin();
+                for (; iter != this->internal->heldAcks.end(); ++iter) {
+                    this->internal->laneTracker.exclude(iter->first, first, last);
+                    session->sendAck(Pointer<MessageAck>(
+                        new MessageAck(iter->second, ActiveMQConstants::ACK_TYPE_INDIVIDUAL, 1)));
+                }
+                this->internal->heldAcks.clear();
+            }
+        }
+    }
+
+    synchronized(&this->internal->deliveredMessages) {
+        this->internal->deliveredMessages.remove(dispatch);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::releaseHeldAcks() {
+
+    // The held acks before the head were part of the range just released.
+    std::map<long long, Pointer<MessageDispatch> >& held = this->internal->heldAcks;
+    held.erase(held.begin(), held.lower_bound(this->internal->laneTracker.getHeadSequence()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::flushHeldAcks() {
+
+    try {
+
+        synchronized(&this->internal->laneMutex) {
+            std::map<long long, Pointer<MessageDispatch> >::iterator iter = this->internal->heldAcks.begin();
+            for (; iter != this->internal->heldAcks.end(); ++iter) {
+                session->sendAck(Pointer<MessageAck>(
+                    new MessageAck(iter->second, ActiveMQConstants::ACK_TYPE_INDIVIDUAL, 1)));
+            }
+
+            this->internal->heldAcks.clear();
+            this->internal->laneSequences.clear();
+            this->internal->laneTracker.clear();
+        }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -1747,6 +2853,50 @@ Pointer<cms::Message> ActiveMQConsumerKernel::createCMSMessage(Pointer<MessageDi
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<cms::Message> ActiveMQConsumerKernel::borrowCMSMessage(Pointer<MessageDispatch> dispatch) {
+
+    try {
+
+        // The dispatched message is already read only, it is handed out as is.
+        Pointer<Message> message = dispatch->getMessage();
+
+        if (session->isClientAcknowledge()) {
+            Pointer<ActiveMQAckHandler> ackHandler(new ClientAckHandler(this->session));
+            message->setAckHandler(ackHandler);
+        } else {
+            Pointer<ActiveMQAckHandler> ackHandler(new NoOpAckHandler());
+            message->setAckHandler(ackHandler);
+        }
+
+        return message.dynamicCast<cms::Message>();
+    }
+    AMQ_CATCH_RETHROW(cms::CMSException)
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::releaseBorrowedMessage(Pointer<cms::Message> message) {
+
+    // Rewind what the listener read so a redelivery of the message starts at the
+    // beginning of its body, as a fresh copy would.
+    try {
+        cms::BytesMessage* bytesMessage = dynamic_cast<cms::BytesMessage*>(message.get());
+        if (bytesMessage != NULL) {
+            bytesMessage->reset();
+            return;
+        }
+
+        cms::StreamMessage* streamMessage = dynamic_cast<cms::StreamMessage*>(message.get());
+        if (streamMessage != NULL) {
+            streamMessage->reset();
+        }
+    } catch (cms::CMSException&) {
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::sendPullRequest(long long timeout) {
 
@@ -1754,18 +2904,30 @@ void ActiveMQConsumerKernel::sendPullRequest(long long timeout) {
         this->internal->clearDeliveredList();
 
         // There are still local message, consume them first.
-        if (!this->internal->unconsumedMessages->isEmpty()) {
+        if (!this->internal->unconsumedMessages->isEmpty() && !discardExpiredPullWindow()) {
             return;
         }
 
         if (this->consumerInfo->getPrefetchSize() == 0) {
 
-            Pointer<MessagePull> messagePull(new MessagePull());
-            messagePull->setConsumerId(this->consumerInfo->getConsumerId());
-            messagePull->setDestination(this->consumerInfo->getDestination());
-            messagePull->setTimeout(timeout);
+            int pulls = 1;
+            if (this->internal->pullBatchSize > 1) {
+                synchronized(this->internal->unconsumedMessages.get()) {
+                    // Top the window up, every receive has at least one pull it can be
+                    // answered by as long as the window isn't full.
+                    pulls = this->internal->pullBatchSize - this->internal->pullsOutstanding;
+                    this->internal->pullsOutstanding += pulls;
+                }
+            }
+
+            for (int i = 0; i < pulls; ++i) {
+                Pointer<MessagePull> messagePull(new MessagePull());
+                messagePull->setConsumerId(this->consumerInfo->getConsumerId());
+                messagePull->setDestination(this->consumerInfo->getDestination());
+                messagePull->setTimeout(timeout);
 
-            this->session->oneway(messagePull);
+                this->session->oneway(messagePull);
+            }
         }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1773,6 +2935,144 @@ void ActiveMQConsumerKernel::sendPullRequest(long long timeout) {
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::acceptPullAnswer(const Pointer<MessageDispatch>& dispatch) {
+
+    if (this->consumerInfo->getPrefetchSize() != 0 || this->internal->pullBatchSize <= 1) {
+        return true;
+    }
+
+    if (this->internal->pullsOutstanding > 0) {
+        this->internal->pullsOutstanding--;
+    }
+
+    // An empty dispatch tells a receiver the broker had nothing for its pull, with a
+    // window of pulls it is only passed on once none of them is left to bring a message
+    // and nothing else is waiting to be consumed.
+    return dispatch->getMessage() != NULL ||
+           (this->internal->pullsOutstanding == 0 && this->internal->unconsumedMessages->isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::discardExpiredPullWindow() {
+
+    if (this->consumerInfo->getPrefetchSize() != 0 || this->internal->pullBatchSize <= 1) {
+        return false;
+    }
+
+    synchronized(this->internal->unconsumedMessages.get()) {
+
+        // The empty dispatch of a window that came back empty while no one was receiving
+        // is all that is queued, the new window the caller is about to pull replaces it.
+        if (this->internal->pullsOutstanding != 0 || this->internal->unconsumedMessages->size() != 1) {
+            return false;
+        }
+
+        Pointer<MessageDispatch> dispatch = this->internal->unconsumedMessages->dequeueNoWait();
+        if (dispatch != NULL && dispatch->getMessage() != NULL) {
+            this->internal->unconsumedMessages->enqueueFirst(dispatch);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::checkPrefetchMemoryLimit() {
+
+    reportConsumerMemory();
+
+    if ((this->internal->prefetchMemoryLimit <= 0 && !this->internal->prefetchMemoryLimited) ||
+        this->consumerInfo->getPrefetchSize() == 0) {
+        return;
+    }
+
+    synchronized(&this->internal->prefetchMutex) {
+
+        long long limit = this->internal->prefetchMemoryLimit;
+        long long usage = this->internal->unconsumedMessages->getMemoryUsage();
+        int prefetch = -1;
+
+        // Resuming at half the limit keeps a steady stream of large messages from
+        // flipping the broker between push and stop on every message.
+        // A suspended consumer was already stopped and stays stopped until resumed.
+        if (!this->internal->prefetchMemoryLimited && limit > 0 && usage > limit) {
+            this->internal->prefetchMemoryLimited = true;
+            prefetch = this->internal->suspended ? -1 : 0;
+        } else if (this->internal->prefetchMemoryLimited && (limit <= 0 || usage <= limit / 2)) {
+            this->internal->prefetchMemoryLimited = false;
+            prefetch = this->internal->suspended ? -1 : this->consumerInfo->getCurrentPrefetchSize();
+        }
+
+        // The prefetch is changed under the lock so the broker sees the stops and
+        // resumes in the order they were decided.
+        if (prefetch >= 0) {
+            sendPrefetch(prefetch);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::reportConsumerMemory() {
+
+    ActiveMQConnection* connection = this->session->getConnection();
+
+    // Once the budget and monitor are removed the bytes reported are still taken back.
+    if (this->internal->reportedMemoryUsage == 0 && connection->getConsumerMemoryLimit() <= 0 &&
+        connection->getConsumerPressureMonitor() == NULL && !connection->isConsumersSuspended()) {
+        return;
+    }
+
+    long long delta = 0;
+    synchronized(this->internal->unconsumedMessages.get()) {
+        long long usage = this->internal->unconsumedMessages->getMemoryUsage();
+        delta = usage - this->internal->reportedMemoryUsage;
+        this->internal->reportedMemoryUsage = usage;
+    }
+
+    connection->updateConsumerMemoryUsage(this, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::tunePrefetch(long long processingTime) {
+
+    if (this->internal->prefetchTuner == NULL) {
+        return;
+    }
+
+    synchronized(&this->internal->prefetchMutex) {
+
+        if (!this->internal->prefetchTuner->recordProcessingTime(processingTime)) {
+            return;
+        }
+
+        this->consumerInfo->setCurrentPrefetchSize(this->internal->prefetchTuner->getPrefetch());
+
+        // A consumer over its memory limit or suspended is resumed with the tuned prefetch later.
+        if (!this->internal->prefetchMemoryLimited && !this->internal->suspended) {
+            sendPrefetch(this->internal->prefetchTuner->getPrefetch());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::sendPrefetch(int prefetch) {
+
+    // The subscription a multiplexed consumer shares holds back the broker by acking
+    // no faster than its slowest member consumes.
+    if (this->internal->unconsumedMessages->isClosed() || this->internal->multiplexed) {
+        return;
+    }
+
+    Pointer<ConsumerControl> control(new ConsumerControl());
+    control->setConsumerId(this->consumerInfo->getConsumerId());
+    control->setDestination(this->consumerInfo->getDestination());
+    control->setPrefetch(prefetch);
+
+    this->session->oneway(control);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::checkClosed() const {
     if (this->isClosed()) {
@@ -1797,6 +3097,7 @@ bool ActiveMQConsumerKernel::iterate() {
         if (this->internal->listener != NULL) {
             Pointer<MessageDispatch> dispatch = internal->unconsumedMessages->dequeueNoWait();
             if (dispatch != NULL) {
+                checkPrefetchMemoryLimit();
                 this->dispatch(dispatch);
                 return true;
             }
@@ -1836,6 +3137,18 @@ void ActiveMQConsumerKernel::clearMessagesInProgress() {
                     }
                 }
 
+                checkPrefetchMemoryLimit();
+
+                // Pulls sent before the interruption are not answered.
+                this->internal->pullsOutstanding = 0;
+
+                // The broker redelivers what the lanes hold, their acks can't be sent.
+                synchronized(&this->internal->laneMutex) {
+                    this->internal->laneTracker.clear();
+                    this->internal->laneSequences.clear();
+                    this->internal->heldAcks.clear();
+                }
+
                 // allow dispatch on this connection to resume
                 this->session->getConnection()->setTransportInterruptionProcessingComplete();
                 this->internal->inProgressClearRequiredFlag.decrementAndGet();
@@ -1863,6 +3176,26 @@ int ActiveMQConsumerKernel::getMessageAvailableCount() const {
     return this->internal->unconsumedMessages->size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getPrefetchMemoryUsage() const {
+    return this->internal->unconsumedMessages->getMemoryUsage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getDeliveredMemoryUsage() const {
+
+    long long usage = 0;
+
+    synchronized(&this->internal->deliveredMessages) {
+        DeliveredMessageList::const_iterator iter = internal->deliveredMessages.begin();
+        for (; iter != internal->deliveredMessages.end(); ++iter) {
+            usage += MessageDispatchChannel::getMemorySize(*iter);
+        }
+    }
+
+    return usage;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQConsumerKernel::applyDestinationOptions(Pointer<ConsumerInfo> info) {
 
@@ -2018,6 +3351,91 @@ void ActiveMQConsumerKernel::setPrefetchSize(int prefetchSize) {
     this->consumerInfo->setCurrentPrefetchSize(prefetchSize);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setPrefetchMemoryLimit(long long value) {
+    synchronized(&this->internal->prefetchMutex) {
+        this->internal->prefetchMemoryLimit = value;
+    }
+
+    // A raised or removed limit may let a stopped consumer resume right away.
+    checkPrefetchMemoryLimit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getPrefetchMemoryLimit() const {
+    return this->internal->prefetchMemoryLimit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setPullBatchSize(int value) {
+    synchronized(this->internal->unconsumedMessages.get()) {
+        this->internal->pullBatchSize = value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::getPullBatchSize() const {
+    return this->internal->pullBatchSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::isPrefetchMemoryLimited() const {
+    return this->internal->prefetchMemoryLimited;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::suspend() {
+
+    if (this->consumerInfo->getPrefetchSize() == 0) {
+        return;
+    }
+
+    synchronized(&this->internal->prefetchMutex) {
+        if (this->internal->suspended) {
+            return;
+        }
+
+        this->internal->suspended = true;
+
+        // A consumer over its memory limit was already told to stop.
+        if (!this->internal->prefetchMemoryLimited) {
+            sendPrefetch(0);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::resume() {
+
+    synchronized(&this->internal->prefetchMutex) {
+        if (!this->internal->suspended) {
+            return;
+        }
+
+        this->internal->suspended = false;
+
+        if (!this->internal->prefetchMemoryLimited) {
+            sendPrefetch(this->consumerInfo->getCurrentPrefetchSize());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::isSuspended() const {
+    return this->internal->suspended;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::getTunedPrefetchSize() const {
+    synchronized(&this->internal->prefetchMutex) {
+        if (this->internal->prefetchTuner != NULL) {
+            return this->internal->prefetchTuner->getPrefetch();
+        }
+    }
+
+    return this->consumerInfo->getPrefetchSize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConsumerKernel::isInUse(Pointer<ActiveMQDestination> destination) const {
     return this->consumerInfo->getDestination()->equals(destination.get());
@@ -2086,6 +3504,40 @@ void ActiveMQConsumerKernel::setOptimizeAcknowledge(bool value) {
     this->internal->optimizeAcknowledge = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQConsumerKernel::getAckCoalesceCount() const {
+    return this->internal->ackCoalesceCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setAckCoalesceCount(int value) {
+    if (this->internal->isAckCoalescing() && value <= 1) {
+        deliverAcks();
+    }
+
+    this->internal->ackCoalesceCount = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQConsumerKernel::isMultiplexed() const {
+    return this->internal->multiplexed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setMultiplexed(bool value) {
+    this->internal->multiplexed = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQConsumerKernel::getAckCoalesceDelay() const {
+    return this->internal->ackCoalesceDelay;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerKernel::setAckCoalesceDelay(long long value) {
+    this->internal->ackCoalesceDelay = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQConsumerKernel::isConsumerExpiryCheckEnabled() {
     return this->internal->consumerExpiryCheckEnabled;
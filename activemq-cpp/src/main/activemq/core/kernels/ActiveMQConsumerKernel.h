@@ -28,14 +28,20 @@
 #include <activemq/commands/ConsumerInfo.h>
 #include <activemq/commands/MessageAck.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/RemoveInfo.h>
 #include <activemq/core/Dispatcher.h>
+#include <activemq/core/ReceiveCallback.h>
 #include <activemq/core/RedeliveryPolicy.h>
 #include <activemq/core/MessageDispatchChannel.h>
+#include <activemq/transport/ResponseCallback.h>
+#include <activemq/util/Suspendable.h>
 
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/concurrent/Mutex.h>
 
+#include <vector>
+
 namespace activemq {
 namespace core {
 namespace kernels {
@@ -46,7 +52,9 @@ namespace kernels {
     class ActiveMQSessionKernel;
     class ActiveMQConsumerKernelConfig;
 
-    class AMQCPP_API ActiveMQConsumerKernel : public cms::MessageConsumer, public Dispatcher {
+    class AMQCPP_API ActiveMQConsumerKernel : public cms::MessageConsumer,
+                                              public Dispatcher,
+                                              public util::Suspendable {
     private:
 
         /**
@@ -99,6 +107,66 @@ namespace kernels {
 
         virtual cms::Message* receiveNoWait();
 
+        /**
+         * Synchronously receives up to max messages at once.  The call waits for the first
+         * message as receive(int) would, then takes whatever else is already prefetched
+         * without waiting, locking the prefetch buffer once and updating the ack window
+         * once for the whole batch.
+         *
+         * @param messages
+         *      The vector the received messages are appended to, the caller owns them and
+         *      must delete them.
+         * @param max
+         *      The maximum number of messages to receive, must be at least one.
+         * @param millisecs
+         *      The time to wait for the first message, zero waits indefinitely and a
+         *      negative value doesn't wait at all.
+         *
+         * @return the number of messages appended to the vector, zero if none arrived in time.
+         *
+         * @throws CMSException if max is less than one or an internal error occurs.
+         */
+        int receive(std::vector<cms::Message*>& messages, int max, int millisecs);
+
+        /**
+         * Receives a batch of messages as receive(std::vector<cms::Message*>&, int, int)
+         * does, except that the messages are not copied.  Each is the read only message
+         * that was dispatched, shared with the caller until it drops its Pointer.  Meant
+         * for consumers that only read what they receive, such as queue browsers.
+         *
+         * @param messages
+         *      The vector the received messages are appended to.
+         * @param max
+         *      The maximum number of messages to receive, must be at least one.
+         * @param millisecs
+         *      The time to wait for the first message, zero waits indefinitely and a
+         *      negative value doesn't wait at all.
+         *
+         * @return the number of messages appended to the vector, zero if none arrived in time.
+         *
+         * @throws CMSException if max is less than one or an internal error occurs.
+         */
+        int receiveBorrowed(std::vector< Pointer<cms::Message> >& messages, int max, int millisecs);
+
+        /**
+         * Receives the next message without waiting for it.  The callback is called with
+         * the message once one is available, or with NULL if none arrives within the given
+         * time or the consumer is closed first, so a thread is not tied up for each receive
+         * that is outstanding.  Outstanding receives are completed in the order they were
+         * made, and a message is only handed to them while the consumer is started.
+         *
+         * @param callback
+         *      The callback to complete the receive with, it must stay valid until it has
+         *      been called.
+         * @param millisecs
+         *      The time to wait for a message, zero waits indefinitely and a negative
+         *      value completes the receive at once if no message is prefetched.
+         *
+         * @throws CMSException if the consumer is closed, has a MessageListener or the
+         *         callback is NULL.
+         */
+        void receiveAsync(ReceiveCallback* callback, int millisecs);
+
         virtual void setMessageListener(cms::MessageListener* listener);
 
         virtual cms::MessageListener* getMessageListener() const;
@@ -163,6 +231,21 @@ namespace kernels {
          */
         void doClose();
 
+        /**
+         * Closes this consumer as close does, except that the RemoveInfo is sent as an
+         * asynchronous request whose answer goes to the given callback.
+         *
+         * @param onRemoved
+         *      The callback given the broker's answer to the RemoveInfo.
+         *
+         * @return true if the RemoveInfo was sent, false if the consumer was already
+         *         closed, its close waits for the end of the transaction, or it shared
+         *         a subscription and has no RemoveInfo of its own to send.
+         *
+         * @throw ActiveMQException if an error occurs while performing the operation.
+         */
+        bool closeAsync(Pointer<transport::ResponseCallback> onRemoved);
+
         /**
          * Cleans up this objects internal resources.
          *
@@ -218,6 +301,23 @@ namespace kernels {
          */
         void clearMessagesInProgress();
 
+        /**
+         * Delivers a message to the listener from the dispatch lane it was handed to, with
+         * group dispatch also acks the messages dispatched up to it once they are all
+         * consumed.
+         *
+         * @param dispatch
+         *      The message to deliver.
+         * @param listener
+         *      The MessageListener that was set when the message was dispatched.
+         * @param sequence
+         *      The number the message was given when it was handed to its lane.
+         *
+         * @throw ActiveMQException if an error occurs while acknowledging the message.
+         */
+        void consumeOnLane(Pointer<commands::MessageDispatch> dispatch,
+                                cms::MessageListener* listener, long long sequence);
+
         /**
          * Signals that a Failure occurred and that anything in-progress in the
          * consumer should be cleared.
@@ -275,6 +375,17 @@ namespace kernels {
          */
         int getMessageAvailableCount() const;
 
+        /**
+         * @return the bytes of the messages waiting in this consumer's prefetch buffer.
+         */
+        long long getPrefetchMemoryUsage() const;
+
+        /**
+         * @return the bytes of the messages delivered by this consumer and not yet
+         *         acknowledged.
+         */
+        long long getDeliveredMemoryUsage() const;
+
         /**
          * Sets the RedeliveryPolicy this Consumer should use when a rollback is
          * performed on a transacted Consumer.  The Consumer takes ownership of the
@@ -316,6 +427,68 @@ namespace kernels {
          */
         void setPrefetchSize(int prefetchSize);
 
+        /**
+         * Sets the maximum number of bytes of prefetched messages this consumer holds.  Once
+         * the messages waiting to be consumed exceed the limit the broker is told to stop
+         * dispatching, it is told to resume when they have drained to half the limit.
+         *
+         * @param value
+         *      The prefetch memory limit in bytes, zero or less disables it.
+         */
+        void setPrefetchMemoryLimit(long long value);
+
+        /**
+         * @return the prefetch memory limit in bytes, zero or less if there is no limit.
+         */
+        long long getPrefetchMemoryLimit() const;
+
+        /**
+         * Sets the number of messages this consumer pulls at once when its prefetch is
+         * zero, a receive that finds nothing waiting tops the pulls outstanding up to it.
+         *
+         * @param value
+         *      The number of messages pulled at once, one or less pulls one at a time.
+         */
+        void setPullBatchSize(int value);
+
+        /**
+         * @return the number of messages this consumer pulls at once with a zero prefetch.
+         */
+        int getPullBatchSize() const;
+
+        /**
+         * @return true if the broker was told to stop dispatching because the prefetched
+         *         messages exceed the prefetch memory limit.
+         */
+        bool isPrefetchMemoryLimited() const;
+
+        /**
+         * Tells the broker to stop dispatching to this consumer by sending it a prefetch
+         * of zero, the messages already prefetched are still delivered.  The Connection
+         * suspends its consumers while their memory budget is exceeded or its pressure
+         * monitor reports pressure.  Consumers that pull their messages, and consumers
+         * sharing a multiplexed subscription, are not suspended.
+         */
+        virtual void suspend();
+
+        /**
+         * Tells the broker to dispatch to this consumer again with its current prefetch,
+         * unless the consumer is still over its own prefetch memory limit.
+         */
+        virtual void resume();
+
+        /**
+         * @return true if the consumer was suspended and not yet resumed.
+         */
+        bool isSuspended() const;
+
+        /**
+         * @return the prefetch this consumer asked the broker for after tuning it to the
+         *         rate messages are processed at, or the configured prefetch when the
+         *         prefetch isn't tuned.
+         */
+        int getTunedPrefetchSize() const;
+
         /**
          * Checks if the given destination is the Destination that this Consumer is subscribed to.
          *
@@ -354,6 +527,54 @@ namespace kernels {
          */
         void setOptimizeAcknowledge(bool value);
 
+        /**
+         * @return the most consumed messages this consumer acknowledges with a single
+         *         MessageAck, zero or one if every message is acked on its own.
+         */
+        int getAckCoalesceCount() const;
+
+        /**
+         * Sets the most consumed messages this consumer acknowledges with a single range
+         * MessageAck when it auto acknowledges, the ack is sent early when there are no
+         * more messages waiting to be consumed or the coalesce delay has passed.
+         *
+         * @see ActiveMQConnection::setAckCoalesceCount
+         *
+         * @param value
+         *      The number of messages to coalesce, zero or one to ack every message.
+         */
+        void setAckCoalesceCount(int value);
+
+        /**
+         * @return true if this consumer shares a subscription of its connection's
+         *         SubscriptionMultiplexer instead of having its own on the broker.
+         */
+        bool isMultiplexed() const;
+
+        /**
+         * Marks this consumer as a member of a shared subscription, its ConsumerInfo
+         * never went to the broker so neither its RemoveInfo nor its prefetch changes go
+         * there.  Set by the session once the multiplexer has taken the consumer.
+         *
+         * @param value
+         *      True if the consumer shares a subscription.
+         */
+        void setMultiplexed(bool value);
+
+        /**
+         * @return the longest time in microseconds a coalesced ack is held back.
+         */
+        long long getAckCoalesceDelay() const;
+
+        /**
+         * Sets the longest time in microseconds this consumer holds back a coalesced ack,
+         * zero limits the acks only by the coalesce count.
+         *
+         * @param value
+         *      The time in microseconds to hold back a coalesced ack.
+         */
+        void setAckCoalesceDelay(long long value);
+
         /**
          * @return true if the consumer will skip checking messages for expiration.
          */
@@ -397,6 +618,32 @@ namespace kernels {
          */
         Pointer<MessageDispatch> dequeue(long long timeout);
 
+        /**
+         * Used by the batch receive to take the messages that are already prefetched, the
+         * expired and poisoned ones are consumed as dequeue does and not returned.
+         *
+         * @param batch
+         *      The vector the removed messages are appended to.
+         * @param max
+         *      The maximum number of messages to append.
+         *
+         * @return the number of messages appended.
+         */
+        int dequeueAll(std::vector< Pointer<MessageDispatch> >& batch, int max);
+
+        /**
+         * Waits for and consumes a batch of messages for the batch receive calls, leaving
+         * only their conversion to CMS messages to the caller.
+         *
+         * @param batch
+         *      The vector the consumed messages are appended to.
+         * @param max
+         *      The maximum number of messages to consume, must be at least one.
+         * @param millisecs
+         *      The time to wait for the first message as in the batch receive calls.
+         */
+        void consumeBatch(std::vector< Pointer<MessageDispatch> >& batch, int max, int millisecs);
+
         /**
          * Pre-consume processing
          * @param dispatch - the message being consumed.
@@ -410,16 +657,66 @@ namespace kernels {
          */
         void afterMessageIsConsumed(Pointer<commands::MessageDispatch> dispatch, bool messageExpired);
 
+        /**
+         * Acknowledges a run of expired messages with a single ranged expired ack and
+         * clears the run.  The run must hold messages dequeued one after the other in
+         * the order the broker dispatched them, as the broker expires every message it
+         * dispatched from the first to the last of the range.
+         * @param expired - the expired messages in the order they were dequeued.
+         */
+        void acknowledgeExpired(std::vector< Pointer<commands::MessageDispatch> >& expired);
+
+        /**
+         * Acks the coalesced messages that were consumed before the given one, which
+         * failed delivery and is about to be rolled back.
+         * @param failed - the message whose delivery failed.
+         */
+        void deliverCoalescedAcks(Pointer<commands::MessageDispatch> failed);
+
     private:
 
         Pointer<cms::Message> createCMSMessage(Pointer<commands::MessageDispatch> dispatch);
 
+        void dispatchToLane(const Pointer<commands::MessageDispatch>& dispatch);
+
+        void sendRangeAck(Pointer<commands::MessageDispatch> first, Pointer<commands::MessageDispatch> last, int count);
+
+        bool coalesceAck(Pointer<commands::MessageDispatch> dispatch, int ackType);
+
+        void releaseHeldAcks();
+
+        void flushHeldAcks();
+
+        Pointer<cms::Message> borrowCMSMessage(Pointer<commands::MessageDispatch> dispatch);
+
+        void releaseBorrowedMessage(Pointer<cms::Message> message);
+
         void applyDestinationOptions(Pointer<commands::ConsumerInfo> info);
 
         void sendPullRequest(long long timeout);
 
+        void completeAsyncReceives();
+
+        void cancelAsyncReceives();
+
+        void checkPrefetchMemoryLimit();
+
+        void reportConsumerMemory();
+
+        bool acceptPullAnswer(const Pointer<commands::MessageDispatch>& dispatch);
+
+        bool discardExpiredPullWindow();
+
+        void tunePrefetch(long long processingTime);
+
+        void sendPrefetch(int prefetch);
+
         void checkClosed() const;
 
+        bool deferCloseToTransaction();
+
+        Pointer<commands::RemoveInfo> createRemoveInfo() const;
+
         void checkMessageListener() const;
 
         void ackLater(Pointer<commands::MessageDispatch> message, int ackType);
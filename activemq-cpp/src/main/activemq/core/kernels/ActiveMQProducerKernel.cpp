@@ -18,12 +18,21 @@
 #include "ActiveMQProducerKernel.h"
 
 #include <cms/Message.h>
+#include <cms/IllegalStateException.h>
+#include <cms/MessageFormatException.h>
 #include <activemq/core/kernels/ActiveMQSessionKernel.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
 #include <activemq/util/CMSExceptionSupport.h>
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
+#include <activemq/transport/IOTransport.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/InvalidStateException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
@@ -38,9 +47,293 @@ using namespace activemq::core::kernels;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
 using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace core {
+namespace kernels {
+
+    /**
+     * Bounds the number of pipelined sends a producer has waiting for their response from
+     * the broker, and keeps the first failure until the producer reports it.  The producer
+     * and each outstanding send share ownership since responses can arrive after the
+     * producer is gone.
+     */
+    class PendingSendWindow : public cms::AsyncCallback {
+    private:
+
+        PendingSendWindow(const PendingSendWindow&);
+        PendingSendWindow& operator= (const PendingSendWindow&);
+
+    private:
+
+        Mutex mutex;
+        int limit;
+        int pending;
+        std::auto_ptr<cms::CMSException> error;
+
+    public:
+
+        PendingSendWindow(int limit) : mutex(), limit(limit), pending(0), error() {}
+
+        virtual ~PendingSendWindow() {}
+
+        virtual void onSuccess() {
+            synchronized(&this->mutex) {
+                this->pending--;
+                this->mutex.notifyAll();
+            }
+        }
+
+        virtual void onException(const cms::CMSException& ex) {
+            synchronized(&this->mutex) {
+                if (this->error.get() == NULL) {
+                    this->error.reset(new cms::CMSException(ex));
+                }
+                this->pending--;
+                this->mutex.notifyAll();
+            }
+        }
+
+        int getLimit() const {
+            return this->limit;
+        }
+
+        void setLimit(int limit) {
+            synchronized(&this->mutex) {
+                this->limit = limit;
+                this->mutex.notifyAll();
+            }
+        }
+
+        int getPending() {
+            synchronized(&this->mutex) {
+                return this->pending;
+            }
+
+            return 0;
+        }
+
+        // Waits for a free slot in the window, a limit of zero or less means no window.
+        void acquire() {
+            synchronized(&this->mutex) {
+                while (this->limit > 0 && this->pending >= this->limit) {
+                    this->mutex.wait();
+                }
+                this->pending++;
+            }
+        }
+
+        // Waits for every pending send to complete, returns false if the timeout expired first.
+        bool awaitEmpty(long long timeout) {
+            long long deadline = timeout > 0 ? System::currentTimeMillis() + timeout : 0;
+            synchronized(&this->mutex) {
+                while (this->pending > 0) {
+                    if (timeout <= 0) {
+                        this->mutex.wait();
+                    } else {
+                        long long remaining = deadline - System::currentTimeMillis();
+                        if (remaining <= 0) {
+                            return false;
+                        }
+                        this->mutex.wait(remaining);
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        // Throws the first failure since the last call, if there was one.
+        void throwIfFailed() {
+            std::auto_ptr<cms::CMSException> failure;
+            synchronized(&this->mutex) {
+                failure = this->error;
+            }
+
+            if (failure.get() != NULL) {
+                throw cms::CMSException(*failure);
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Forwards the completion of a single send to a shared callback exactly once.  A
+     * request the transport can't accept is sometimes completed with an error before
+     * the exception reaches the sender, so the transport and the sender each hold a
+     * reference and the sender only completes the send itself when the transport never
+     * did.  Once the sender has returned or thrown the transport is the only one left
+     * that can complete it.
+     */
+    class SendCompletion : public cms::AsyncCallback {
+    private:
+
+        SendCompletion(const SendCompletion&);
+        SendCompletion& operator= (const SendCompletion&);
+
+    private:
+
+        Pointer<cms::AsyncCallback> target;
+        AtomicBoolean completed;
+        AtomicInteger references;
+
+    public:
+
+        SendCompletion(const Pointer<cms::AsyncCallback>& target) : target(target), completed(false), references(2) {}
+
+        virtual ~SendCompletion() {}
+
+        virtual void onSuccess() {
+            if (this->completed.compareAndSet(false, true)) {
+                this->target->onSuccess();
+            }
+            release();
+        }
+
+        virtual void onException(const cms::CMSException& ex) {
+            if (this->completed.compareAndSet(false, true)) {
+                this->target->onException(ex);
+            }
+            release();
+        }
+
+        // The send returned normally, the transport now owns the completion.
+        void sent() {
+            release();
+        }
+
+        // The send threw, returns true if the target was never told about it.
+        bool failed() {
+            if (this->completed.compareAndSet(false, true)) {
+                // The transport dropped the request, so its reference goes too.
+                release();
+                release();
+                return true;
+            }
+
+            release();
+            return false;
+        }
+
+    private:
+
+        void release() {
+            if (this->references.decrementAndGet() == 0) {
+                delete this;
+            }
+        }
+    };
+
+    /**
+     * Counts down the acknowledgements of a batch send and keeps the first error.
+     */
+    class BatchSendCallback : public cms::AsyncCallback {
+    private:
+
+        BatchSendCallback(const BatchSendCallback&);
+        BatchSendCallback& operator= (const BatchSendCallback&);
+
+    private:
+
+        CountDownLatch pending;
+        Mutex mutex;
+        std::auto_ptr<cms::CMSException> error;
+
+    public:
+
+        BatchSendCallback(int count) : pending(count), mutex(), error() {}
+
+        virtual ~BatchSendCallback() {}
+
+        virtual void onSuccess() {
+            this->pending.countDown();
+        }
+
+        virtual void onException(const cms::CMSException& ex) {
+            synchronized(&this->mutex) {
+                if (this->error.get() == NULL) {
+                    this->error.reset(new cms::CMSException(ex));
+                }
+            }
+            this->pending.countDown();
+        }
+
+        // Accounts for sends that were never made because an earlier one failed.
+        void abandon(int count) {
+            for (int i = 0; i < count; ++i) {
+                this->pending.countDown();
+            }
+        }
+
+        bool await(long long timeout) {
+            if (timeout > 0) {
+                return this->pending.await(timeout);
+            }
+
+            this->pending.await();
+            return true;
+        }
+
+        void throwIfFailed() {
+            synchronized(&this->mutex) {
+                if (this->error.get() != NULL) {
+                    throw cms::CMSException(*this->error);
+                }
+            }
+        }
+    };
+
+    /**
+     * Defers the flush of the connection's IOTransport for as long as it is in scope.
+     */
+    class FlushDeferral {
+    private:
+
+        FlushDeferral(const FlushDeferral&);
+        FlushDeferral& operator= (const FlushDeferral&);
+
+    private:
+
+        activemq::transport::IOTransport* transport;
+
+    public:
+
+        FlushDeferral(ActiveMQConnection* connection) : transport(NULL) {
+            this->transport = dynamic_cast<activemq::transport::IOTransport*>(
+                connection->getTransport().narrow(typeid(activemq::transport::IOTransport)));
+            if (this->transport != NULL && !this->transport->isFlushDeferred()) {
+                this->transport->setFlushDeferred(true);
+            } else {
+                this->transport = NULL;
+            }
+        }
+
+        ~FlushDeferral() {
+            try {
+                end();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        void end() {
+            if (this->transport != NULL) {
+                activemq::transport::IOTransport* deferred = this->transport;
+                this->transport = NULL;
+                deferred->setFlushDeferred(false);
+            }
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQProducerKernel::ActiveMQProducerKernel(ActiveMQSessionKernel* session,
                                                const Pointer<commands::ProducerId>& producerId,
@@ -57,7 +350,8 @@ ActiveMQProducerKernel::ActiveMQProducerKernel(ActiveMQSessionKernel* session,
                                                                         memoryUsage(),
                                                                         destination(),
                                                                         messageSequence(),
-                                                                        transformer() {
+                                                                        transformer(),
+                                                                        pendingSends() {
 
     if (session == NULL || producerId == NULL) {
         throw ActiveMQException(
@@ -86,6 +380,8 @@ ActiveMQProducerKernel::ActiveMQProducerKernel(ActiveMQSessionKernel* session,
     if (session->getConnection()->getProtocolVersion() >= 3 && session->getConnection()->getProducerWindowSize() > 0) {
         this->memoryUsage.reset(new MemoryUsage(session->getConnection()->getProducerWindowSize()));
     }
+
+    this->pendingSends.reset(new PendingSendWindow(session->getConnection()->getMaxPendingSends()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,6 +399,9 @@ void ActiveMQProducerKernel::close() {
 
         if (!this->isClosed()) {
 
+            // Pipelined sends still owe the caller their broker confirmation.
+            bool drained = this->pendingSends->awaitEmpty(this->session->getConnection()->getCloseTimeout());
+
             dispose();
 
             // Remove at the Broker Side, if this fails the producer has already
@@ -113,6 +412,12 @@ void ActiveMQProducerKernel::close() {
             this->session->oneway(info);
 
             this->closed = true;
+
+            if (!drained) {
+                throw cms::CMSException("Timed out waiting for the broker to acknowledge the pending sends.");
+            }
+
+            this->pendingSends->throwIfFailed();
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -211,48 +516,283 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
 
     try {
 
+        long long sendTime = this->session->getConnection()->getMessageTracer() != NULL ? System::nanoTime() : 0;
+
         this->checkClosed();
 
-        if (destination == NULL) {
+        Pointer<ActiveMQDestination> dest = resolveDestination(destination);
 
-            if (this->producerInfo->getDestination() == NULL) {
-                throw cms::UnsupportedOperationException("A destination must be specified.", NULL);
+        cms::Message* outbound = message;
+        Pointer<cms::Message> scopedMessage;
+        if (this->transformer != NULL) {
+            if (this->transformer->producerTransform(this->session, this, message, &outbound)) {
+                // scopedMessage ensures that when we are responsible for the lifetime of the
+                // transformed message, the message remains valid until the send operation either
+                // succeeds or throws an exception.
+                scopedMessage.reset(outbound);
             }
+            if (outbound == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "MessageTransformer set transformed message to NULL");
+            }
+        }
+
+        this->dispatch(dest, outbound, Pointer<commands::Message>(), deliveryMode, priority, timeToLive, onComplete, sendTime);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::dispatch(const Pointer<ActiveMQDestination>& destination, cms::Message* outbound,
+                                      const Pointer<commands::Message>& owned, int deliveryMode, int priority,
+                                      long long timeToLive, cms::AsyncCallback* onComplete, long long sendTime) {
+
+    waitForWindowSpace();
 
-            throw cms::InvalidDestinationException("Don't understand null destinations", NULL);
+    bool pipelined = isPipelinedSend(deliveryMode, onComplete);
+    SendCompletion* completion = NULL;
+
+    if (pipelined) {
+
+        // Report a failure of an earlier send before taking on another one.
+        this->pendingSends->throwIfFailed();
+
+        try {
+            this->pendingSends->acquire();
+        } catch (InterruptedException& e) {
+            throw cms::CMSException("Send aborted due to thread interrupt.");
         }
 
-        Pointer<ActiveMQDestination> dest;
-        const ActiveMQDestination* transformed;
+        completion = new SendCompletion(this->pendingSends);
+        onComplete = completion;
+    }
 
-        if (destination == this->destination.get()) {
-            dest = this->producerInfo->getDestination();
-        } else if (this->producerInfo->getDestination() == NULL) {
-            // We always need to use a copy of the users destination since we want to control
-            // its lifetime.  If the transform results in a new destination we can use that, but
-            // if its already an ActiveMQDestination then we need to clone it.
-            if (ActiveMQMessageTransformation::transformDestination(destination, &transformed)) {
-                dest.reset(const_cast<ActiveMQDestination*>(transformed));
-            } else {
-                dest.reset(transformed->cloneDataStructure());
-            }
+    try {
+        if (owned != NULL) {
+            this->session->sendOwned(this, destination, owned, deliveryMode, priority, timeToLive,
+                                     this->memoryUsage.get(), this->sendTimeout, onComplete, sendTime);
+        } else {
+            this->session->send(this, destination, outbound, deliveryMode, priority, timeToLive,
+                                this->memoryUsage.get(), this->sendTimeout, onComplete, sendTime);
+        }
+    } catch (...) {
+        // The error is thrown to the caller here so it shouldn't be reported again.
+        if (completion != NULL && completion->failed()) {
+            this->pendingSends->onSuccess();
+        }
+        throw;
+    }
+
+    if (completion != NULL) {
+        completion->sent();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQDestination> ActiveMQProducerKernel::resolveDestination(const cms::Destination* destination) {
+
+    if (destination == NULL) {
+
+        if (this->producerInfo->getDestination() == NULL) {
+            throw cms::UnsupportedOperationException("A destination must be specified.", NULL);
+        }
+
+        throw cms::InvalidDestinationException("Don't understand null destinations", NULL);
+    }
+
+    Pointer<ActiveMQDestination> dest;
+    const ActiveMQDestination* transformed;
+
+    if (destination == this->destination.get()) {
+        dest = this->producerInfo->getDestination();
+    } else if (this->producerInfo->getDestination() == NULL) {
+        // We always need to use a copy of the users destination since we want to control
+        // its lifetime.  If the transform results in a new destination we can use that, but
+        // if its already an ActiveMQDestination then we need to clone it.
+        if (ActiveMQMessageTransformation::transformDestination(destination, &transformed)) {
+            dest.reset(const_cast<ActiveMQDestination*>(transformed));
         } else {
+            dest.reset(transformed->cloneDataStructure());
+        }
+    } else {
+        throw cms::UnsupportedOperationException(
+            string("This producer can only send messages to: ") +
+            this->producerInfo->getDestination()->getPhysicalName(), NULL);
+    }
+
+    if (dest == NULL) {
+        throw cms::CMSException("No destination specified", NULL);
+    }
+
+    return dest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::waitForWindowSpace() {
+
+    if (this->memoryUsage.get() != NULL && this->memoryUsage->isFull()) {
+        long long start = System::nanoTime();
+        try {
+            this->memoryUsage->waitForSpace();
+        } catch (InterruptedException& e) {
+            throw cms::CMSException("Send aborted due to thread interrupt.");
+        }
+        this->session->getConnection()->getMetrics().getFlowControlBlockTime().record(
+            (System::nanoTime() - start) / 1000);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQProducerKernel::isPipelinedSend(int deliveryMode, cms::AsyncCallback* onComplete) const {
+
+    if (onComplete != NULL || this->sendTimeout > 0 || this->pendingSends->getLimit() <= 0) {
+        return false;
+    }
+
+    // The same sends that the session would otherwise make as a blocking request.
+    ActiveMQConnection* connection = this->session->getConnection();
+    return connection->isAlwaysSyncSend() ||
+           (deliveryMode == cms::DeliveryMode::PERSISTENT && !connection->isUseAsyncSend() && !this->session->isTransacted());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::setMaxPendingSends(int value) {
+    this->pendingSends->setLimit(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQProducerKernel::getMaxPendingSends() const {
+    return this->pendingSends->getLimit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQProducerKernel::getPendingSendCount() const {
+    return this->pendingSends->getPending();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::awaitPendingSends() {
+
+    try {
+        if (!this->pendingSends->awaitEmpty(this->sendTimeout)) {
+            throw cms::CMSException("Timed out waiting for the broker to acknowledge the pending sends.");
+        }
+
+        this->pendingSends->throwIfFailed();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const std::vector<cms::Message*>& messages) {
+
+    try {
+        this->checkClosed();
+        this->send(this->destination.get(), messages, defaultDeliveryMode, defaultPriority, defaultTimeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const cms::Destination* destination, const std::vector<cms::Message*>& messages,
+                                  int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+
+        this->checkClosed();
+
+        if (messages.empty()) {
+            return;
+        }
+
+        Pointer<BatchSendCallback> callback(new BatchSendCallback((int) messages.size()));
+
+        std::size_t sent = 0;
+        try {
+
+            // A full window waits on ProducerAcks for messages that must already be on the wire.
+            std::auto_ptr<FlushDeferral> deferral;
+            if (this->memoryUsage.get() == NULL) {
+                deferral.reset(new FlushDeferral(this->session->getConnection()));
+            }
+
+            for (; sent < messages.size(); ++sent) {
+                SendCompletion* completion = new SendCompletion(callback);
+                try {
+                    this->send(destination, messages[sent], deliveryMode, priority, timeToLive, completion);
+                } catch (...) {
+                    if (!completion->failed()) {
+                        ++sent;
+                    }
+                    throw;
+                }
+                completion->sent();
+            }
+
+            if (deferral.get() != NULL) {
+                deferral->end();
+            }
+
+        } catch (...) {
+            callback->abandon((int) (messages.size() - sent));
+            throw;
+        }
+
+        if (!callback->await(this->sendTimeout)) {
+            throw cms::CMSException("Timed out waiting for the broker to acknowledge the batch.");
+        }
+
+        callback->throwIfFailed();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const std::vector<const cms::Destination*>& destinations, cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        this->send(destinations, message, defaultDeliveryMode, defaultPriority, defaultTimeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const std::vector<const cms::Destination*>& destinations, cms::Message* message,
+                                  int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+
+        ActiveMQConnection* connection = this->session->getConnection();
+        long long sendTime = connection->getMessageTracer() != NULL ? System::nanoTime() : 0;
+
+        this->checkClosed();
+
+        if (message == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Message passed was NULL");
+        }
+
+        if (destinations.empty()) {
+            return;
+        }
+
+        if (this->producerInfo->getDestination() != NULL) {
             throw cms::UnsupportedOperationException(
                 string("This producer can only send messages to: ") +
                 this->producerInfo->getDestination()->getPhysicalName(), NULL);
         }
 
-        if (dest == NULL) {
-            throw cms::CMSException("No destination specified", NULL);
+        // A destination that can't be used fails the send before any copy is sent.
+        std::vector< Pointer<ActiveMQDestination> > targets;
+        targets.reserve(destinations.size());
+        std::vector<const cms::Destination*>::const_iterator iter = destinations.begin();
+        for (; iter != destinations.end(); ++iter) {
+            targets.push_back(resolveDestination(*iter));
         }
 
         cms::Message* outbound = message;
         Pointer<cms::Message> scopedMessage;
         if (this->transformer != NULL) {
             if (this->transformer->producerTransform(this->session, this, message, &outbound)) {
-                // scopedMessage ensures that when we are responsible for the lifetime of the
-                // transformed message, the message remains valid until the send operation either
-                // succeeds or throws an exception.
                 scopedMessage.reset(outbound);
             }
             if (outbound == NULL) {
@@ -260,20 +800,195 @@ void ActiveMQProducerKernel::send(const cms::Destination* destination, cms::Mess
             }
         }
 
-        if (this->memoryUsage.get() != NULL) {
-            try {
-                this->memoryUsage->waitForSpace();
-            } catch (InterruptedException& e) {
-                throw cms::CMSException("Send aborted due to thread interrupt.");
+        // The copies are made from one message whose body and properties are marshaled
+        // here, the session clones it for each destination and the clones share its bytes.
+        commands::Message* transformed = NULL;
+        Pointer<commands::Message> shared;
+        if (ActiveMQMessageTransformation::transformMessage(outbound, connection, &transformed)) {
+            shared.reset(transformed);
+        } else {
+            shared.reset(transformed->cloneDataStructure());
+        }
+        shared->setConnection(connection);
+        shared->onSend();
+        shared->storeMarshaledForm();
+
+        cms::Message* sharedMessage = dynamic_cast<cms::Message*>(shared.get());
+
+        Pointer<BatchSendCallback> callback(new BatchSendCallback((int) targets.size()));
+
+        std::size_t sent = 0;
+        try {
+
+            // A full window waits on ProducerAcks for messages that must already be on the wire.
+            std::auto_ptr<FlushDeferral> deferral;
+            if (this->memoryUsage.get() == NULL) {
+                deferral.reset(new FlushDeferral(connection));
+            }
+
+            for (; sent < targets.size(); ++sent) {
+                waitForWindowSpace();
+
+                SendCompletion* completion = new SendCompletion(callback);
+                try {
+                    this->session->send(this, targets[sent], sharedMessage, deliveryMode, priority, timeToLive,
+                                        this->memoryUsage.get(), this->sendTimeout, completion, sendTime);
+                } catch (...) {
+                    if (!completion->failed()) {
+                        ++sent;
+                    }
+                    throw;
+                }
+                completion->sent();
+            }
+
+            if (deferral.get() != NULL) {
+                deferral->end();
             }
+
+        } catch (...) {
+            callback->abandon((int) (targets.size() - sent));
+            throw;
+        }
+
+        // The headers the session set on the shared message are those of the last copy.
+        message->setCMSDeliveryMode(deliveryMode);
+        message->setCMSTimestamp(sharedMessage->getCMSTimestamp());
+        message->setCMSExpiration(sharedMessage->getCMSExpiration());
+        message->setCMSPriority(priority);
+        message->setCMSRedelivered(false);
+        message->setCMSDestination(targets.back().dynamicCast<cms::Destination>().get());
+
+        commands::Message* original = dynamic_cast<commands::Message*>(message);
+        if (original != NULL) {
+            original->setMessageId(Pointer<MessageId>(new MessageId(*shared->getMessageId())));
+        } else {
+            message->setCMSMessageID(shared->getMessageId()->toString());
         }
 
-        this->session->send(this, dest, outbound, deliveryMode, priority, timeToLive,
-                            this->memoryUsage.get(), this->sendTimeout, onComplete);
+        if (!callback->await(this->sendTimeout)) {
+            throw cms::CMSException("Timed out waiting for the broker to acknowledge the copies.");
+        }
+
+        callback->throwIfFailed();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage* ActiveMQProducerKernel::prepare(cms::Message* message) {
+
+    try {
+        this->checkClosed();
+        return this->prepare(this->destination.get(), message, defaultDeliveryMode, defaultPriority, defaultTimeToLive);
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+PreparedMessage* ActiveMQProducerKernel::prepare(const cms::Destination* destination, cms::Message* message,
+                                                 int deliveryMode, int priority, long long timeToLive) {
+
+    try {
+
+        this->checkClosed();
+
+        if (message == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Message passed was NULL");
+        }
+
+        Pointer<ActiveMQDestination> dest = resolveDestination(destination);
+
+        cms::Message* outbound = message;
+        Pointer<cms::Message> scopedMessage;
+        if (this->transformer != NULL) {
+            if (this->transformer->producerTransform(this->session, this, message, &outbound)) {
+                scopedMessage.reset(outbound);
+            }
+            if (outbound == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "MessageTransformer set transformed message to NULL");
+            }
+        }
+
+        ActiveMQConnection* connection = this->session->getConnection();
+
+        commands::Message* transformed = NULL;
+        Pointer<commands::Message> prototype;
+        if (ActiveMQMessageTransformation::transformMessage(outbound, connection, &transformed)) {
+            prototype.reset(transformed);
+        } else {
+            prototype.reset(transformed->cloneDataStructure());
+        }
+
+        if (dynamic_cast<ActiveMQTextMessage*>(prototype.get()) == NULL &&
+            dynamic_cast<ActiveMQBytesMessage*>(prototype.get()) == NULL) {
+            throw cms::UnsupportedOperationException("Only a TextMessage or BytesMessage can be prepared.");
+        }
+
+        // The copies made by each send share the properties marshaled here.
+        dynamic_cast<cms::Message*>(prototype.get())->clearBody();
+        prototype->setConnection(connection);
+        prototype->storeMarshaledForm();
+
+        return new PreparedMessage(this, prototype, dest, deliveryMode, priority, timeToLive);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const PreparedMessage& prepared, const std::string& text) {
+
+    try {
+
+        long long sendTime = this->session->getConnection()->getMessageTracer() != NULL ? System::nanoTime() : 0;
+
+        Pointer<commands::Message> copy = copyPrepared(prepared);
+
+        ActiveMQTextMessage* textMessage = dynamic_cast<ActiveMQTextMessage*>(copy.get());
+        if (textMessage == NULL) {
+            throw cms::MessageFormatException("The prepared message is not a TextMessage.");
+        }
+        textMessage->setText(text);
+
+        this->dispatch(prepared.getDestination(), NULL, copy, prepared.getDeliveryMode(),
+                       prepared.getPriority(), prepared.getTimeToLive(), NULL, sendTime);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerKernel::send(const PreparedMessage& prepared, const unsigned char* body, int size) {
+
+    try {
+
+        long long sendTime = this->session->getConnection()->getMessageTracer() != NULL ? System::nanoTime() : 0;
+
+        Pointer<commands::Message> copy = copyPrepared(prepared);
+
+        ActiveMQBytesMessage* bytesMessage = dynamic_cast<ActiveMQBytesMessage*>(copy.get());
+        if (bytesMessage == NULL) {
+            throw cms::MessageFormatException("The prepared message is not a BytesMessage.");
+        }
+        bytesMessage->setBodyBytes(body, size);
+
+        this->dispatch(prepared.getDestination(), NULL, copy, prepared.getDeliveryMode(),
+                       prepared.getPriority(), prepared.getTimeToLive(), NULL, sendTime);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<commands::Message> ActiveMQProducerKernel::copyPrepared(const PreparedMessage& prepared) {
+
+    this->checkClosed();
+
+    if (prepared.getProducer() != this) {
+        throw cms::IllegalStateException("The message was prepared by another producer.");
+    }
+
+    return Pointer<commands::Message>(prepared.getPrototype()->cloneDataStructure());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQProducerKernel::onProducerAck(const commands::ProducerAck& ack) {
 
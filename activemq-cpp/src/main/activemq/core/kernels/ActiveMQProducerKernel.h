@@ -30,8 +30,10 @@
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/commands/ProducerAck.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/core/PreparedMessage.h>
 
 #include <memory>
+#include <vector>
 
 namespace activemq {
 namespace core {
@@ -40,6 +42,7 @@ namespace kernels {
     using decaf::lang::Pointer;
 
     class ActiveMQSessionKernel;
+    class PendingSendWindow;
 
     class AMQCPP_API ActiveMQProducerKernel : public cms::MessageProducer {
     private:
@@ -83,6 +86,9 @@ namespace kernels {
         // Used to tranform Message before sending them to the CMS bus.
         cms::MessageTransformer* transformer;
 
+        // Tracks the pipelined sends that are still waiting for the broker's response.
+        Pointer<PendingSendWindow> pendingSends;
+
     private:
 
         ActiveMQProducerKernel(const ActiveMQProducerKernel&);
@@ -134,6 +140,149 @@ namespace kernels {
         virtual void send(const cms::Destination* destination, cms::Message* message,
                           int deliveryMode, int priority, long long timeToLive, cms::AsyncCallback* callback);
 
+        /**
+         * Sends a batch of messages to this producer's destination using the producer's
+         * default delivery mode, priority and time to live.
+         *
+         * @see send(const cms::Destination*, const std::vector<cms::Message*>&, int, int, long long)
+         */
+        void send(const std::vector<cms::Message*>& messages);
+
+        /**
+         * Sends a batch of messages and waits once for the broker to acknowledge all of
+         * them.  Every message is sent as a request without waiting for its response, so
+         * the messages follow each other onto the wire and the whole batch costs about one
+         * round trip to the broker instead of one per message.  When nothing else is
+         * limiting the sends, such as a full producer window, the transport defers its
+         * flush until the last message is written so the batch leaves in as few socket
+         * writes as possible.
+         *
+         * If the producer has a send timeout it bounds the wait for the acknowledgements.
+         * When the broker rejects any of the messages the first error is thrown once all
+         * of the acknowledgements have arrived, the messages it accepted stay sent.
+         *
+         * @param destination
+         *      The destination to send the messages to.
+         * @param messages
+         *      The messages to send, in order.
+         * @param deliveryMode
+         *      The delivery mode to send the messages with.
+         * @param priority
+         *      The priority to send the messages with.
+         * @param timeToLive
+         *      The time to live to send the messages with.
+         *
+         * @throws CMSException if a message can't be sent, the broker rejects one of them,
+         *         or the send timeout expires before every message is acknowledged.
+         */
+        void send(const cms::Destination* destination, const std::vector<cms::Message*>& messages,
+                  int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends one message to each of several destinations using the producer's default
+         * delivery mode, priority and time to live.
+         *
+         * @see send(const std::vector<const cms::Destination*>&, cms::Message*, int, int, long long)
+         */
+        void send(const std::vector<const cms::Destination*>& destinations, cms::Message* message);
+
+        /**
+         * Sends the message to each of the given destinations and waits once for the broker
+         * to acknowledge all of the copies.  The body and properties are marshaled a single
+         * time and every copy shares those bytes, only the destination, message id and the
+         * other fields that differ from one send to the next are set for each of them.  The
+         * copies follow each other onto the wire as a batch send's messages do.
+         *
+         * Each copy has its own message id, the message given is left with the id and the
+         * destination of the last copy.  When the broker rejects any of the copies the first
+         * error is thrown once all of the acknowledgements have arrived, the copies it
+         * accepted stay sent.
+         *
+         * @param destinations
+         *      The destinations to send the message to, in order.
+         * @param message
+         *      The message to send.
+         * @param deliveryMode
+         *      The delivery mode to send the message with.
+         * @param priority
+         *      The priority to send the message with.
+         * @param timeToLive
+         *      The time to live to send the message with.
+         *
+         * @throws CMSException if a copy can't be sent, the broker rejects one of them,
+         *         or the send timeout expires before every copy is acknowledged.
+         * @throws UnsupportedOperationException if this producer has a destination.
+         */
+        void send(const std::vector<const cms::Destination*>& destinations, cms::Message* message,
+                  int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Prepares a message to be sent to this producer's destination with the producer's
+         * default delivery mode, priority and time to live.
+         *
+         * @see prepare(const cms::Destination*, cms::Message*, int, int, long long)
+         */
+        PreparedMessage* prepare(cms::Message* message);
+
+        /**
+         * Fixes the headers and properties of the given message, and the destination and
+         * send options, into a PreparedMessage whose sends only give each copy a body.
+         * The message is transformed if this producer has a MessageTransformer, its body
+         * is dropped and its properties are marshaled here instead of on every send.  The
+         * message given is not changed and can be reused.
+         *
+         * @param destination
+         *      The destination the prepared message is sent to.
+         * @param message
+         *      The TextMessage or BytesMessage whose headers and properties are used.
+         * @param deliveryMode
+         *      The delivery mode to send the message with.
+         * @param priority
+         *      The priority to send the message with.
+         * @param timeToLive
+         *      The time to live to send the message with.
+         *
+         * @return a new PreparedMessage that the caller owns.
+         *
+         * @throws CMSException if the producer is closed or the properties can't be marshaled.
+         * @throws UnsupportedOperationException if the message is neither a TextMessage nor
+         *         a BytesMessage, or the destination isn't one this producer can send to.
+         */
+        PreparedMessage* prepare(const cms::Destination* destination, cms::Message* message,
+                                 int deliveryMode, int priority, long long timeToLive);
+
+        /**
+         * Sends a copy of a prepared TextMessage with the given text as its body, the
+         * same way a send of the message itself would be made.
+         *
+         * @param prepared
+         *      A message this producer prepared from a TextMessage.
+         * @param text
+         *      The body of the message to send.
+         *
+         * @throws CMSException if the message can't be sent.
+         * @throws IllegalStateException if another producer prepared the message.
+         * @throws MessageFormatException if the message wasn't prepared from a TextMessage.
+         */
+        void send(const PreparedMessage& prepared, const std::string& text);
+
+        /**
+         * Sends a copy of a prepared BytesMessage with the given bytes as its body, the
+         * same way a send of the message itself would be made.
+         *
+         * @param prepared
+         *      A message this producer prepared from a BytesMessage.
+         * @param body
+         *      The bytes to copy into the body of the message to send.
+         * @param size
+         *      The number of bytes in the body.
+         *
+         * @throws CMSException if the message can't be sent.
+         * @throws IllegalStateException if another producer prepared the message.
+         * @throws MessageFormatException if the message wasn't prepared from a BytesMessage.
+         */
+        void send(const PreparedMessage& prepared, const unsigned char* body, int size);
+
         /**
          * Set an MessageTransformer instance that is applied to all cms::Message objects before they
          * are sent on to the CMS bus.
@@ -250,6 +399,40 @@ namespace kernels {
             return this->sendTimeout;
         }
 
+        /**
+         * Sets the number of persistent sends that this Producer can have waiting for
+         * their response from the broker.  When greater than zero a send that would
+         * otherwise block until the broker has stored the message is made as an
+         * asynchronous request instead, and the caller only blocks once this many are
+         * outstanding.  A failure the broker reports for one of these sends is thrown
+         * from the next send, from awaitPendingSends or from close.  Sends that have a
+         * callback or a send timeout are never pipelined.
+         *
+         * @param value
+         *      The maximum number of pipelined sends, zero or less to disable pipelining.
+         */
+        void setMaxPendingSends(int value);
+
+        /**
+         * @return the maximum number of pipelined sends awaiting a broker response,
+         *         zero or less if sends are not pipelined.
+         */
+        int getMaxPendingSends() const;
+
+        /**
+         * @return the number of pipelined sends currently waiting for their response.
+         */
+        int getPendingSendCount() const;
+
+        /**
+         * Waits for every pipelined send to be acknowledged by the broker, the wait is
+         * bounded by the send timeout when one is set.
+         *
+         * @throws CMSException if the broker rejected one of the sends since the last
+         *         failure was reported, or if the send timeout expires.
+         */
+        void awaitPendingSends();
+
         /**
          * @return true if this Producer has been closed.
          */
@@ -301,6 +484,24 @@ namespace kernels {
        // Checks for the closed state and throws if so.
        void checkClosed() const;
 
+       // Checks if a send is one that is pipelined through the pending send window.
+       bool isPipelinedSend(int deliveryMode, cms::AsyncCallback* onComplete) const;
+
+       // Returns the producer's own copy of the destination a message is sent to.
+       Pointer<commands::ActiveMQDestination> resolveDestination(const cms::Destination* destination);
+
+       // Waits while the producer window is full.
+       void waitForWindowSpace();
+
+       // Sends through the session, through the pending send window when the send can be
+       // pipelined.  An owned message is sent as is, otherwise the outbound one is copied.
+       void dispatch(const Pointer<commands::ActiveMQDestination>& destination, cms::Message* outbound,
+                     const Pointer<commands::Message>& owned, int deliveryMode, int priority,
+                     long long timeToLive, cms::AsyncCallback* onComplete, long long sendTime);
+
+       // Checks the producer is open and prepared the message, and returns a copy to send.
+       Pointer<commands::Message> copyPrepared(const PreparedMessage& prepared);
+
     };
 
 }}}
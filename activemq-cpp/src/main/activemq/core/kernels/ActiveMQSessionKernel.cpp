@@ -26,6 +26,7 @@
 #include <activemq/core/ActiveMQQueueBrowser.h>
 #include <activemq/core/ActiveMQSessionExecutor.h>
 #include <activemq/core/PrefetchPolicy.h>
+#include <activemq/core/SubscriptionMultiplexer.h>
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
 #include <activemq/util/CMSExceptionSupport.h>
@@ -47,6 +48,8 @@
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/commands/RemoveSubscriptionInfo.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/transport/ResponseCallback.h>
 
 #include <decaf/lang/Boolean.h>
 #include <decaf/lang/Integer.h>
@@ -54,13 +57,16 @@
 #include <decaf/lang/Long.h>
 #include <decaf/lang/Math.h>
 #include <decaf/util/Queue.h>
-#include <decaf/util/LinkedList.h>
+#include <decaf/util/concurrent/CopyOnWriteArrayList.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
-#include <decaf/util/concurrent/locks/ReentrantReadWriteLock.h>
 #include <decaf/lang/exceptions/InvalidStateException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 
+#include <typeinfo>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
@@ -69,6 +75,7 @@ using namespace activemq::core::kernels;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
 using namespace activemq::threads;
+using namespace activemq::transport;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
@@ -82,19 +89,84 @@ namespace kernels{
 
     class CloseSynhcronization;
 
+    /**
+     * Hands a consumer of a Session that dispatches on the transport thread its messages
+     * without going through the Session, errors are dropped as the Session's executor
+     * drops them.
+     */
+    class DirectDispatcher : public Dispatcher {
+    private:
+
+        Pointer<ActiveMQConsumerKernel> consumer;
+
+    private:
+
+        DirectDispatcher(const DirectDispatcher&);
+        DirectDispatcher& operator=(const DirectDispatcher&);
+
+    public:
+
+        DirectDispatcher(Pointer<ActiveMQConsumerKernel> consumer) : Dispatcher(), consumer(consumer) {}
+
+        virtual ~DirectDispatcher() {}
+
+        virtual void dispatch(const Pointer<MessageDispatch>& dispatch) {
+            // A listener closing its consumer releases this dispatcher, the consumer is
+            // kept until its dispatch returns and nothing of this is used after it.
+            Pointer<ActiveMQConsumerKernel> consumer = this->consumer;
+            try {
+                consumer->dispatch(dispatch);
+            } catch (decaf::lang::Exception& ex) {
+                ex.setMark(__FILE__, __LINE__);
+            } catch (std::exception& ex) {
+                ActiveMQException amqex(__FILE__, __LINE__, ex.what());
+            } catch (...) {
+                ActiveMQException amqex(__FILE__, __LINE__, "caught unknown exception");
+            }
+        }
+
+        virtual int getHashCode() const {
+            return this->consumer->getHashCode();
+        }
+    };
+
     class SessionConfig {
     private:
 
         SessionConfig(const SessionConfig&);
         SessionConfig& operator=(const SessionConfig&);
 
+    public:
+
+        typedef ConcurrentHashMap< Pointer<ConsumerId>,
+                                   Pointer<ActiveMQConsumerKernel>,
+                                   HashCode< Pointer<ConsumerId> >,
+                                   PointerEquals<ConsumerId> > ConsumerMap;
+
+        typedef ConcurrentHashMap< Pointer<ProducerId>,
+                                   Pointer<ActiveMQProducerKernel>,
+                                   HashCode< Pointer<ProducerId> >,
+                                   PointerEquals<ProducerId> > ProducerMap;
+
+        typedef ConcurrentHashMap< Pointer<ConsumerId>,
+                                   Pointer<Dispatcher>,
+                                   HashCode< Pointer<ConsumerId> >,
+                                   PointerEquals<ConsumerId> > DispatcherMap;
+
     public:
 
         AtomicBoolean synchronizationRegistered;
-        decaf::util::concurrent::locks::ReentrantReadWriteLock producerLock;
-        decaf::util::LinkedList< Pointer<ActiveMQProducerKernel> > producers;
-        decaf::util::concurrent::locks::ReentrantReadWriteLock consumerLock;
-        decaf::util::LinkedList< Pointer<ActiveMQConsumerKernel> > consumers;
+        // The registries are read far more often than changed, the lists are iterated
+        // over snapshots and the indexes read without locking.  The locks only keep a
+        // list and its index in step while they are changed.
+        Mutex producerLock;
+        CopyOnWriteArrayList< Pointer<ActiveMQProducerKernel> > producers;
+        ProducerMap producersById;
+        Mutex consumerLock;
+        CopyOnWriteArrayList< Pointer<ActiveMQConsumerKernel> > consumers;
+        ConsumerMap consumersById;
+        // The dispatchers of consumers that are dispatched to directly.
+        DispatcherMap directDispatchers;
         Pointer<Scheduler> scheduler;
         Pointer<CloseSynhcronization> closeSync;
         Mutex sendMutex;
@@ -102,12 +174,19 @@ namespace kernels{
         int hashCode;
         bool sessionAsyncDispatch;
 
+        // The thread dispatching a round whose acks are held, and the acks it held.
+        Thread* volatile ackBatchThread;
+        Mutex heldAcksLock;
+        std::vector< Pointer<MessageAck> > heldAcks;
+
     public:
 
         SessionConfig() : synchronizationRegistered(false),
-                          producerLock(), producers(), consumerLock(), consumers(),
-                          scheduler(), closeSync(), sendMutex(), transformer(NULL),
-                          hashCode(), sessionAsyncDispatch(true) {}
+                          producerLock(), producers(), producersById(),
+                          consumerLock(), consumers(), consumersById(),
+                          directDispatchers(), scheduler(), closeSync(), sendMutex(), transformer(NULL),
+                          hashCode(), sessionAsyncDispatch(true),
+                          ackBatchThread(NULL), heldAcksLock(), heldAcks() {}
         ~SessionConfig() {}
     };
 
@@ -187,8 +266,198 @@ namespace kernels{
         }
     };
 
+    /**
+     * Collects the broker's answer to a ConsumerInfo or RemoveInfo sent by the async
+     * consumer create and close calls.
+     */
+    class ConsumerResponse : public ResponseCallback {
+    private:
+
+        ConsumerResponse(const ConsumerResponse&);
+        ConsumerResponse& operator=(const ConsumerResponse&);
+
+    public:
+
+        CountDownLatch answered;
+        Pointer<Response> response;
+
+    public:
+
+        ConsumerResponse() : ResponseCallback(), answered(1), response() {}
+
+        virtual ~ConsumerResponse() {}
+
+        virtual void onComplete(Pointer<commands::Response> response) {
+            this->response = response;
+            this->answered.countDown();
+        }
+
+        // The broker's error if it refused the command, NULL once it accepted it.
+        Pointer<ActiveMQException> getError(const char* request) const {
+
+            ExceptionResponse* exceptionResponse = dynamic_cast<ExceptionResponse*>(this->response.get());
+            if (exceptionResponse != NULL) {
+                return Pointer<ActiveMQException>(new ActiveMQException(
+                    exceptionResponse->getException()->createExceptionObject()));
+            } else if (this->response == NULL) {
+                return Pointer<ActiveMQException>(new ActiveMQException(__FILE__, __LINE__,
+                    "No valid response received for the %s, check broker.", request));
+            }
+
+            return Pointer<ActiveMQException>();
+        }
+    };
+
+    /**
+     * A consumer whose ConsumerInfo was sent to the broker, held until the caller takes it.
+     */
+    class PendingConsumer : public ActiveMQSessionKernel::ConsumerFuture {
+    private:
+
+        PendingConsumer(const PendingConsumer&);
+        PendingConsumer& operator=(const PendingConsumer&);
+
+    private:
+
+        Pointer<ConsumerResponse> answer;
+        Pointer<ActiveMQConsumerKernel> kernel;
+        ActiveMQConsumer* consumer;
+        Mutex mutex;
+        Pointer<ActiveMQException> error;
+
+    public:
+
+        PendingConsumer(Pointer<ConsumerResponse> answer, Pointer<ActiveMQConsumerKernel> kernel) :
+            answer(answer), kernel(kernel), consumer(new ActiveMQConsumer(kernel)), mutex(), error() {
+        }
+
+        virtual ~PendingConsumer() {
+            try {
+                delete this->consumer;
+            } catch (...) {
+            }
+        }
+
+        virtual bool isDone() const {
+            return this->answer->answered.getCount() == 0;
+        }
+
+        virtual bool await(long long millisecs) {
+            try {
+                return this->answer->answered.await(millisecs);
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+        }
+
+        virtual cms::MessageConsumer* get() {
+
+            try {
+
+                synchronized(&this->mutex) {
+
+                    if (this->error != NULL) {
+                        throw ActiveMQException(*this->error);
+                    }
+
+                    if (this->consumer == NULL) {
+                        throw ActiveMQException(__FILE__, __LINE__,
+                            "PendingConsumer::get - The consumer was already taken.");
+                    }
+
+                    this->answer->answered.await();
+
+                    this->error = this->answer->getError("consumer");
+                    if (this->error != NULL) {
+                        // The broker never knew the consumer, it is only closed locally.
+                        this->kernel->setFailureError(this->error.get());
+                        this->kernel->dispose();
+                        delete this->consumer;
+                        this->consumer = NULL;
+                        throw ActiveMQException(*this->error);
+                    }
+
+                    cms::MessageConsumer* result = this->consumer;
+                    this->consumer = NULL;
+                    return result;
+                }
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+
+            return NULL;
+        }
+    };
+
+    /**
+     * A consumer close whose RemoveInfo was sent to the broker.
+     */
+    class PendingClose : public ActiveMQSessionKernel::CloseFuture {
+    private:
+
+        PendingClose(const PendingClose&);
+        PendingClose& operator=(const PendingClose&);
+
+    private:
+
+        Pointer<ConsumerResponse> answer;
+        bool sent;
+
+    public:
+
+        // A close with nothing sent, complete from the start.
+        PendingClose() : answer(new ConsumerResponse()), sent(false) {
+            this->answer->answered.countDown();
+        }
+
+        PendingClose(Pointer<ConsumerResponse> answer) : answer(answer), sent(true) {
+        }
+
+        virtual ~PendingClose() {}
+
+        virtual bool isDone() const {
+            return this->answer->answered.getCount() == 0;
+        }
+
+        virtual void await() {
+            try {
+                this->answer->answered.await();
+                checkAnswer();
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+        }
+
+        virtual bool await(long long millisecs) {
+            try {
+                if (!this->answer->answered.await(millisecs)) {
+                    return false;
+                }
+                checkAnswer();
+                return true;
+            }
+            AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+        }
+
+    private:
+
+        void checkAnswer() const {
+            if (this->sent) {
+                Pointer<ActiveMQException> error = this->answer->getError("consumer removal");
+                if (error != NULL) {
+                    throw ActiveMQException(*error);
+                }
+            }
+        }
+    };
+
 }}}
 
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQSessionKernel::ConsumerFuture::~ConsumerFuture() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQSessionKernel::CloseFuture::~CloseFuture() {
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQSessionKernel::ActiveMQSessionKernel(ActiveMQConnection* connection,
                                              const Pointer<SessionId>& id,
@@ -356,16 +625,22 @@ void ActiveMQSessionKernel::dispose() {
 
         Finalizer final(this, this->connection);
 
+        // Let a commit still in flight settle the consumers before they are disposed.
+        this->transaction->completePendingCommit();
+
         // Stop the dispatch executor.
         stop();
 
-        // Dispose of all Consumers, the dispose method skips the RemoveInfo command.
-        this->config->consumerLock.writeLock().lock();
+        // Acks held by a round that closed the Session go out before its consumers do.
         try {
-            // We have to copy all the consumers to another list since we aren't using a
-            // CopyOnWriteArrayList right now.
-            ArrayList<Pointer<ActiveMQConsumerKernel> > consumers(this->config->consumers);
-            Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > consumerIter(consumers.iterator());
+            sendPendingAcks();
+        } catch (ActiveMQException& ex) {
+            /* Absorb */
+        }
+
+        // Dispose of all Consumers, the dispose method skips the RemoveInfo command.
+        synchronized(&this->config->consumerLock) {
+            Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > consumerIter(this->config->consumers.iterator());
             while (consumerIter->hasNext()) {
                 try{
                     Pointer<ActiveMQConsumerKernel> consumer = consumerIter->next();
@@ -378,19 +653,12 @@ void ActiveMQSessionKernel::dispose() {
                 }
             }
             this->config->consumers.clear();
-            this->config->consumerLock.writeLock().unlock();
-        } catch (Exception& ex) {
-            this->config->consumerLock.writeLock().unlock();
-            throw;
+            this->config->consumersById.clear();
         }
 
         // Dispose of all Producers, the dispose method skips the RemoveInfo command.
-        this->config->producerLock.writeLock().lock();
-        try {
-            // We have to copy all the producers to another list since we aren't using a
-            // CopyOnWriteArrayList right now.
-            ArrayList<Pointer<ActiveMQProducerKernel> > producers(this->config->producers);
-            std::auto_ptr<Iterator<Pointer<ActiveMQProducerKernel> > > producerIter(producers.iterator());
+        synchronized(&this->config->producerLock) {
+            std::auto_ptr<Iterator<Pointer<ActiveMQProducerKernel> > > producerIter(this->config->producers.iterator());
 
             while (producerIter->hasNext()) {
                 try{
@@ -400,10 +668,7 @@ void ActiveMQSessionKernel::dispose() {
                 }
             }
             this->config->producers.clear();
-            this->config->producerLock.writeLock().unlock();
-        } catch (Exception& ex) {
-            this->config->producerLock.writeLock().unlock();
-            throw;
+            this->config->producersById.clear();
         }
 
         // Roll Back the transaction since we were closed without an explicit call
@@ -435,6 +700,23 @@ void ActiveMQSessionKernel::commit() {
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQTransactionContext::CommitFuture> ActiveMQSessionKernel::commitAsync() {
+
+    try {
+
+        this->checkClosed();
+
+        if (!this->isTransacted()) {
+            throw ActiveMQException(
+                __FILE__, __LINE__, "ActiveMQSessionKernel::commitAsync - This Session is not Transacted");
+        }
+
+        return this->transaction->commitAsync();
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::rollback() {
 
@@ -464,17 +746,10 @@ void ActiveMQSessionKernel::recover() {
             throw cms::IllegalStateException("This session is transacted");
         }
 
-        this->config->consumerLock.readLock().lock();
-        try {
-            Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-            while (iter->hasNext()) {
-                Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-                consumer->rollback();
-            }
-            this->config->consumerLock.readLock().unlock();
-        } catch (Exception& ex) {
-            this->config->consumerLock.readLock().unlock();
-            throw;
+        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+        while (iter->hasNext()) {
+            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+            consumer->rollback();
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -487,54 +762,33 @@ void ActiveMQSessionKernel::clearMessagesInProgress(Pointer<AtomicInteger> trans
         this->executor->clearMessagesInProgress();
     }
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            consumer->inProgressClearRequired();
-            transportsInterrupted->incrementAndGet();
-            this->connection->getScheduler()->executeAfterDelay(
-                new ClearConsumerTask(consumer), 0LL);
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        consumer->inProgressClearRequired();
+        transportsInterrupted->incrementAndGet();
+        this->connection->getScheduler()->executeAfterDelay(
+            new ClearConsumerTask(consumer), 0LL);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::acknowledge() {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            consumer->acknowledge();
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        consumer->acknowledge();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::deliverAcks() {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            consumer->deliverAcks();
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        consumer->deliverAcks();
     }
 }
 
@@ -566,33 +820,45 @@ cms::MessageConsumer* ActiveMQSessionKernel::createConsumer(const cms::Destinati
 
         this->checkClosed();
 
-        // Cast the destination to an OpenWire destination, so we can
-        // get all the goodies.
-        const ActiveMQDestination* amqDestination =
-            dynamic_cast<const ActiveMQDestination*>( destination );
+        Pointer<ActiveMQConsumerKernel> consumer = this->createConsumerKernel(destination, selector, noLocal);
 
-        if (amqDestination == NULL) {
-            throw ActiveMQException(__FILE__, __LINE__, "Destination was either NULL or not created by this CMS Client");
+        try{
+            this->addConsumer(consumer);
+            if (!this->subscribeMultiplexed(consumer)) {
+                this->connection->startupRequest(consumer->getConsumerInfo());
+            }
+        } catch (Exception& ex) {
+            this->removeConsumer(consumer);
+            throw;
         }
 
-        Pointer<ActiveMQDestination> dest( amqDestination->cloneDataStructure() );
+        consumer->setMessageTransformer(this->config->transformer);
 
-        int prefetch = 0;
-        if (dest->isTopic()) {
-            prefetch = this->connection->getPrefetchPolicy()->getTopicPrefetch();
-        } else {
-            prefetch = this->connection->getPrefetchPolicy()->getQueuePrefetch();
+        if (this->connection->isStarted()) {
+            consumer->start();
         }
 
-        // Create the consumer instance.
-        Pointer<ActiveMQConsumerKernel> consumer(
-            new ActiveMQConsumerKernel(this, this->getNextConsumerId(),
-                                       dest, "", selector, prefetch, 0, noLocal,
-                                       false, this->connection->isDispatchAsync(), NULL));
+        return new ActiveMQConsumer(consumer);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQSessionKernel::ConsumerFuture> ActiveMQSessionKernel::createConsumerAsync(
+    const cms::Destination* destination, const std::string& selector, bool noLocal) {
+
+    try {
+
+        this->checkClosed();
+
+        Pointer<ActiveMQConsumerKernel> consumer = this->createConsumerKernel(destination, selector, noLocal);
+        Pointer<ConsumerResponse> answer(new ConsumerResponse());
 
         try{
             this->addConsumer(consumer);
-            this->connection->syncRequest(consumer->getConsumerInfo());
+            this->connection->checkClosedOrFailed();
+            this->connection->ensureConnectionInfoSent();
+            this->connection->getTransport().asyncRequest(consumer->getConsumerInfo(), answer);
         } catch (Exception& ex) {
             this->removeConsumer(consumer);
             throw;
@@ -600,15 +866,68 @@ cms::MessageConsumer* ActiveMQSessionKernel::createConsumer(const cms::Destinati
 
         consumer->setMessageTransformer(this->config->transformer);
 
+        // Nothing is dispatched to the consumer before the broker has accepted it.
         if (this->connection->isStarted()) {
             consumer->start();
         }
 
-        return new ActiveMQConsumer(consumer);
+        return Pointer<ConsumerFuture>(new PendingConsumer(answer, consumer));
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQSessionKernel::CloseFuture> ActiveMQSessionKernel::closeConsumerAsync(cms::MessageConsumer* consumer) {
+
+    try {
+
+        ActiveMQConsumer* amqConsumer = dynamic_cast<ActiveMQConsumer*>(consumer);
+
+        if (amqConsumer == NULL) {
+            throw ActiveMQException(__FILE__, __LINE__, "Consumer was either NULL or not created by this CMS Client");
+        }
+
+        Pointer<ActiveMQConsumerKernel> kernel = this->lookupConsumerKernel(amqConsumer->getConsumerId());
+        Pointer<ConsumerResponse> answer(new ConsumerResponse());
+
+        if (kernel == NULL || !kernel->closeAsync(answer)) {
+            return Pointer<CloseFuture>(new PendingClose());
+        }
+
+        return Pointer<CloseFuture>(new PendingClose(answer));
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<ActiveMQConsumerKernel> ActiveMQSessionKernel::createConsumerKernel(const cms::Destination* destination,
+                                                                            const std::string& selector, bool noLocal) {
+
+    // Cast the destination to an OpenWire destination, so we can
+    // get all the goodies.
+    const ActiveMQDestination* amqDestination =
+        dynamic_cast<const ActiveMQDestination*>( destination );
+
+    if (amqDestination == NULL) {
+        throw ActiveMQException(__FILE__, __LINE__, "Destination was either NULL or not created by this CMS Client");
+    }
+
+    Pointer<ActiveMQDestination> dest( amqDestination->cloneDataStructure() );
+
+    int prefetch = 0;
+    if (dest->isTopic()) {
+        prefetch = this->connection->getPrefetchPolicy()->getTopicPrefetch();
+    } else {
+        prefetch = this->connection->getPrefetchPolicy()->getQueuePrefetch();
+    }
+
+    // Create the consumer instance.
+    return Pointer<ActiveMQConsumerKernel>(
+        new ActiveMQConsumerKernel(this, this->getNextConsumerId(),
+                                   dest, "", selector, prefetch, 0, noLocal,
+                                   false, this->connection->isDispatchAsync(), NULL));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 cms::MessageConsumer* ActiveMQSessionKernel::createDurableConsumer(const cms::Topic* destination, const std::string& name,
                                                                    const std::string& selector, bool noLocal) {
@@ -636,7 +955,7 @@ cms::MessageConsumer* ActiveMQSessionKernel::createDurableConsumer(const cms::To
 
         try {
             this->addConsumer(consumer);
-            this->connection->syncRequest(consumer->getConsumerInfo());
+            this->connection->startupRequest(consumer->getConsumerInfo());
         } catch (Exception& ex) {
             this->removeConsumer(consumer);
             throw;
@@ -686,7 +1005,7 @@ cms::MessageProducer* ActiveMQSessionKernel::createProducer(const cms::Destinati
 
         try {
             this->addProducer(producer);
-            this->connection->syncRequest(producer->getProducerInfo());
+            this->connection->startupRequest(producer->getProducerInfo());
         } catch (Exception& ex) {
             this->removeProducer(producer);
             throw;
@@ -785,13 +1104,11 @@ cms::TemporaryQueue* ActiveMQSessionKernel::createTemporaryQueue() {
 
         this->checkClosed();
 
-        std::auto_ptr<commands::ActiveMQTempQueue> queue(new
-            commands::ActiveMQTempQueue(this->createTemporaryDestinationName()));
+        // Registered with the Broker, or taken from those registered ahead of time.
+        std::auto_ptr<commands::ActiveMQTempDestination> queue(
+            this->connection->createTempDestination(cms::Destination::TEMPORARY_QUEUE));
 
-        // Register it with the Broker
-        this->createTemporaryDestination(queue.get());
-
-        return queue.release();
+        return dynamic_cast<commands::ActiveMQTempQueue*>(queue.release());
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -803,13 +1120,11 @@ cms::TemporaryTopic* ActiveMQSessionKernel::createTemporaryTopic() {
 
         this->checkClosed();
 
-        std::auto_ptr<commands::ActiveMQTempTopic> topic(new
-            commands::ActiveMQTempTopic(createTemporaryDestinationName()));
-
-        // Register it with the Broker
-        this->createTemporaryDestination(topic.get());
+        // Registered with the Broker, or taken from those registered ahead of time.
+        std::auto_ptr<commands::ActiveMQTempDestination> topic(
+            this->connection->createTempDestination(cms::Destination::TEMPORARY_TOPIC));
 
-        return topic.release();
+        return dynamic_cast<commands::ActiveMQTempTopic*>(topic.release());
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
 }
@@ -911,7 +1226,40 @@ bool ActiveMQSessionKernel::isTransacted() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
                                  cms::Message* message, int deliveryMode, int priority, long long timeToLive,
-                                 util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete) {
+                                 util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                                 long long sendTime) {
+
+    try {
+        this->doSend(producer, destination, message, Pointer<commands::Message>(), deliveryMode, priority,
+                     timeToLive, producerWindow, sendTimeout, onComplete, sendTime);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::sendOwned(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
+                                      Pointer<commands::Message> message, int deliveryMode, int priority, long long timeToLive,
+                                      util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                                      long long sendTime) {
+
+    try {
+
+        cms::Message* headers = dynamic_cast<cms::Message*>(message.get());
+        if (headers == NULL) {
+            throw cms::CMSException("Message to send is not a CMS Message");
+        }
+
+        this->doSend(producer, destination, headers, message, deliveryMode, priority,
+                     timeToLive, producerWindow, sendTimeout, onComplete, sendTime);
+    }
+    AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::doSend(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
+                                   cms::Message* message, Pointer<commands::Message> owned, int deliveryMode, int priority,
+                                   long long timeToLive, util::MemoryUsage* producerWindow, long long sendTimeout,
+                                   cms::AsyncCallback* onComplete, long long sendTime) {
 
     try {
 
@@ -969,19 +1317,29 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
             // around beyond the point that send returns.  When the transform step results in
             // a new Message object being created we can just use that new instance, but when
             // the original cms::Message pointer was already a commands::Message then we need
-            // to clone it.
-            if (ActiveMQMessageTransformation::transformMessage(message, connection, &transformed)) {
-                amqMessage.reset(transformed);
+            // to clone it.  An owned message was made for this send alone and is sent as is.
+            if (owned != NULL) {
+                amqMessage = owned;
             } else {
-                amqMessage.reset(transformed->cloneDataStructure());
-            }
+                if (ActiveMQMessageTransformation::transformMessage(message, connection, &transformed)) {
+                    amqMessage.reset(transformed);
+                } else {
+                    amqMessage.reset(transformed->cloneDataStructure());
+                }
 
-            // Sets the Message ID on the original message per spec.
-            message->setCMSMessageID(id->toString());
-            message->setCMSDestination(destination.dynamicCast<cms::Destination>().get());
+                // Sets the Message ID on the original message per spec, our own message types
+                // are given the id directly so its string form is only built if it's asked for.
+                commands::Message* original = dynamic_cast<commands::Message*>(message);
+                if (original != NULL) {
+                    original->setMessageId(Pointer<MessageId>(new MessageId(*id)));
+                } else {
+                    message->setCMSMessageID(id->toString());
+                }
+                message->setCMSDestination(destination.dynamicCast<cms::Destination>().get());
+            }
 
             amqMessage->setMessageId(id);
-            amqMessage->getBrokerPath().clear();
+            amqMessage->setBrokerPath(std::vector< Pointer<BrokerId> >());
             amqMessage->setTransactionId(txId);
             amqMessage->setConnection(this->connection);
 
@@ -991,6 +1349,12 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
             amqMessage->onSend();
             amqMessage->setProducerId(producerId);
 
+            MessageTracer* tracer = this->connection->getMessageTracer();
+            if (tracer != NULL) {
+                tracer->onTrace(MessageTracer::PRODUCER_SEND, *amqMessage, sendTime);
+                tracer->onTrace(MessageTracer::SESSION_SEND, *amqMessage, System::nanoTime());
+            }
+
             if (onComplete == NULL && sendTimeout <= 0 && !amqMessage->isResponseRequired() && !this->connection->isAlwaysSyncSend() &&
                 (!amqMessage->isPersistent() || this->connection->isUseAsyncSend() || amqMessage->getTransactionId() != NULL)) {
 
@@ -1008,6 +1372,8 @@ void ActiveMQSessionKernel::send(kernels::ActiveMQProducerKernel* producer, Poin
                     this->connection->asyncRequest(amqMessage, onComplete);
                 }
             }
+
+            this->connection->getMetrics().getMessagesSent().increment();
         }
     }
     AMQ_CATCH_ALL_THROW_CMSEXCEPTION()
@@ -1062,14 +1428,22 @@ void ActiveMQSessionKernel::dispatch(const Pointer<MessageDispatch>& dispatch) {
 
     if (this->executor.get() != NULL) {
         this->executor->execute(dispatch);
+        if (this->config->sessionAsyncDispatch) {
+            this->connection->getMetrics().getDispatchQueueDepth().record(this->executor->size());
+        }
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::redispatch(MessageDispatchChannel& unconsumedMessages) {
 
-    std::vector< Pointer<MessageDispatch> > messages = unconsumedMessages.removeAll();
-    std::vector< Pointer<MessageDispatch> >::reverse_iterator iter = messages.rbegin();
+    redispatch(unconsumedMessages.removeAll());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::redispatch(const std::vector< Pointer<MessageDispatch> >& messages) {
+
+    std::vector< Pointer<MessageDispatch> >::const_reverse_iterator iter = messages.rbegin();
 
     for (; iter != messages.rend(); ++iter) {
         executor->executeFirst(*iter);
@@ -1079,18 +1453,11 @@ void ActiveMQSessionKernel::redispatch(MessageDispatchChannel& unconsumedMessage
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::start() {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
 
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            consumer->start();
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        consumer->start();
     }
 
     if (this->executor.get() != NULL) {
@@ -1101,18 +1468,11 @@ void ActiveMQSessionKernel::start() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::stop() {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
 
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            consumer->stop();
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        consumer->stop();
     }
 
     if (this->executor.get() != NULL) {
@@ -1130,46 +1490,16 @@ bool ActiveMQSessionKernel::isStarted() const {
     return this->executor->isRunning();
 }
 
-////////////////////////////////////////////////////////////////////////////////
-void ActiveMQSessionKernel::createTemporaryDestination(commands::ActiveMQTempDestination* tempDestination) {
-
-    try {
-
-        Pointer<DestinationInfo> command(new DestinationInfo());
-        command->setConnectionId(this->connection->getConnectionInfo().getConnectionId());
-        command->setOperationType(ActiveMQConstants::DESTINATION_ADD_OPERATION);
-        command->setDestination(Pointer<ActiveMQTempDestination> (tempDestination->cloneDataStructure()));
-
-        // Send the message to the broker.
-        this->syncRequest(command);
-
-        // Now that its setup, link it to this Connection so it can be closed.
-        tempDestination->setConnection(this->connection);
-        this->connection->addTempDestination(Pointer<ActiveMQTempDestination>(tempDestination->cloneDataStructure()));
-    }
-    AMQ_CATCH_RETHROW( ActiveMQException )
-    AMQ_CATCH_EXCEPTION_CONVERT( Exception, ActiveMQException )
-    AMQ_CATCHALL_THROW( ActiveMQException )
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 bool ActiveMQSessionKernel::isInUse(Pointer<ActiveMQDestination> destination) {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
 
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->isInUse(destination)) {
-                this->config->consumerLock.readLock().unlock();
-                return true;
-            }
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        if (consumer->isInUse(destination)) {
+            return true;
         }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
     }
 
     return false;
@@ -1195,18 +1525,6 @@ void ActiveMQSessionKernel::destroyTemporaryDestination(
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
-////////////////////////////////////////////////////////////////////////////////
-std::string ActiveMQSessionKernel::createTemporaryDestinationName() {
-
-    try {
-        return this->connection->getConnectionId().getValue() + ":" +
-               Long::toString(this->connection->getNextTempDestinationId());
-    }
-    AMQ_CATCH_RETHROW(ActiveMQException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
-    AMQ_CATCHALL_THROW(ActiveMQException)
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::oneway(Pointer<Command> command) {
 
@@ -1244,36 +1562,58 @@ void ActiveMQSessionKernel::addConsumer(Pointer<ActiveMQConsumerKernel> consumer
 
         this->checkClosed();
 
-        this->config->consumerLock.writeLock().lock();
-        try {
+        synchronized(&this->config->consumerLock) {
             this->config->consumers.add(consumer);
-            this->config->consumerLock.writeLock().unlock();
-        } catch (Exception& ex) {
-            this->config->consumerLock.writeLock().unlock();
-            throw;
+            this->config->consumersById.put(consumer->getConsumerId(), consumer);
         }
 
-        // Register this as a message dispatcher for the consumer.
-        this->connection->addDispatcher(consumer->getConsumerInfo()->getConsumerId(), this);
+        // Register this as a message dispatcher for the consumer, unless the consumer can be
+        // dispatched to from the transport thread itself.
+        if (this->connection->isDirectDispatch() && !this->config->sessionAsyncDispatch) {
+            Pointer<Dispatcher> dispatcher(new DirectDispatcher(consumer));
+            this->config->directDispatchers.put(consumer->getConsumerId(), dispatcher);
+            this->connection->addDispatcher(consumer->getConsumerInfo()->getConsumerId(), dispatcher.get());
+        } else {
+            this->connection->addDispatcher(consumer->getConsumerInfo()->getConsumerId(), this);
+        }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool ActiveMQSessionKernel::subscribeMultiplexed(Pointer<ActiveMQConsumerKernel> consumer) {
+
+    // The subscription can only count the acks of sessions that ack every message
+    // as it is consumed.
+    if (!this->connection->isMultiplexTopicSubscriptions() ||
+        !(this->isAutoAcknowledge() || this->isDupsOkAcknowledge()) ||
+        !SubscriptionMultiplexer::isMultiplexable(*consumer->getConsumerInfo())) {
+        return false;
+    }
+
+    if (!this->connection->getSubscriptionMultiplexer().subscribe(consumer->getConsumerInfo(), this)) {
+        return false;
+    }
+
+    consumer->setMultiplexed(true);
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::removeConsumer(Pointer<ActiveMQConsumerKernel> consumer) {
 
     try {
+        if (consumer->isMultiplexed()) {
+            this->connection->getSubscriptionMultiplexer().unsubscribe(*consumer->getConsumerId());
+        }
         this->connection->removeDispatcher(consumer->getConsumerId());
-        this->config->consumerLock.writeLock().lock();
-        try {
+        this->config->directDispatchers.remove(consumer->getConsumerId());
+        synchronized(&this->config->consumerLock) {
             this->config->consumers.remove(consumer);
+            this->config->consumersById.remove(consumer->getConsumerId(), consumer);
             this->connection->removeAuditedDispatcher(consumer.get());
-            this->config->consumerLock.writeLock().unlock();
-        } catch (Exception& ex) {
-            this->config->consumerLock.writeLock().unlock();
-            throw;
         }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1287,13 +1627,9 @@ void ActiveMQSessionKernel::addProducer(Pointer<ActiveMQProducerKernel> producer
     try {
         this->checkClosed();
 
-        this->config->producerLock.writeLock().lock();
-        try {
+        synchronized(&this->config->producerLock) {
             this->config->producers.add(producer);
-            this->config->producerLock.writeLock().unlock();
-        } catch(Exception& ex) {
-            this->config->producerLock.writeLock().unlock();
-            throw;
+            this->config->producersById.put(producer->getProducerId(), producer);
         }
 
         this->connection->addProducer(producer);
@@ -1308,13 +1644,9 @@ void ActiveMQSessionKernel::removeProducer(Pointer<ActiveMQProducerKernel> produ
 
     try {
         this->connection->removeProducer(producer->getProducerId());
-        this->config->producerLock.writeLock().lock();
-        try {
+        synchronized(&this->config->producerLock) {
             this->config->producers.remove(producer);
-            this->config->producerLock.writeLock().unlock();
-        } catch(Exception& ex) {
-            this->config->producerLock.writeLock().unlock();
-            throw;
+            this->config->producersById.remove(producer->getProducerId(), producer);
         }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
@@ -1325,49 +1657,17 @@ void ActiveMQSessionKernel::removeProducer(Pointer<ActiveMQProducerKernel> produ
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<ActiveMQProducerKernel> ActiveMQSessionKernel::lookupProducerKernel(Pointer<ProducerId> id) {
 
-    this->config->producerLock.readLock().lock();
-    try {
-
-        std::auto_ptr<Iterator<Pointer<ActiveMQProducerKernel> > > producerIter(this->config->producers.iterator());
-
-        while (producerIter->hasNext()) {
-            Pointer<ActiveMQProducerKernel> producer = producerIter->next();
-            if (producer->getProducerId()->equals(*id)) {
-                this->config->producerLock.readLock().unlock();
-                return producer;
-            }
-        }
-
-        this->config->producerLock.readLock().unlock();
-    } catch(Exception& ex) {
-        this->config->producerLock.readLock().unlock();
-        throw;
-    }
-
-    return Pointer<ActiveMQProducerKernel>();
+    Pointer<ActiveMQProducerKernel> producer;
+    this->config->producersById.tryGet(id, producer);
+    return producer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<ActiveMQConsumerKernel> ActiveMQSessionKernel::lookupConsumerKernel(Pointer<ConsumerId> id) {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getConsumerId()->equals(*id)) {
-                this->config->consumerLock.readLock().unlock();
-                return consumer;
-            }
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
-    }
-
-    return Pointer<ActiveMQConsumerKernel>();
+    Pointer<ActiveMQConsumerKernel> consumer;
+    this->config->consumersById.tryGet(id, consumer);
+    return consumer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1377,21 +1677,13 @@ bool ActiveMQSessionKernel::iterateConsumers() {
         return false;
     }
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
 
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->iterate()) {
-                this->config->consumerLock.readLock().unlock();
-                return true;
-            }
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        if (consumer->iterate()) {
+            return true;
         }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
     }
 
     return false;
@@ -1400,43 +1692,21 @@ bool ActiveMQSessionKernel::iterateConsumers() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::setPrefetchSize(Pointer<ConsumerId> id, int prefetch) {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getConsumerId()->equals(*id)) {
-                consumer->setPrefetchSize(prefetch);
-            }
-        }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
+    Pointer<ActiveMQConsumerKernel> consumer = lookupConsumerKernel(id);
+    if (consumer != NULL) {
+        consumer->setPrefetchSize(prefetch);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::close(Pointer<ConsumerId> id) {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getConsumerId()->equals(*id)) {
-                try {
-                    consumer->close();
-                } catch (cms::CMSException& e) {
-                }
-            }
+    Pointer<ActiveMQConsumerKernel> consumer = lookupConsumerKernel(id);
+    if (consumer != NULL) {
+        try {
+            consumer->close();
+        } catch (cms::CMSException& e) {
         }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
     }
 }
 
@@ -1486,30 +1756,115 @@ int ActiveMQSessionKernel::getHashCode() const {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::checkMessageListener() const {
 
-    this->config->consumerLock.readLock().lock();
-    try {
-        Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
-        while (iter->hasNext()) {
-            Pointer<ActiveMQConsumerKernel> consumer = iter->next();
-            if (consumer->getMessageListener() != NULL) {
-                throw cms::IllegalStateException(
-                    "Cannot synchronously receive a message when a MessageListener is set");
-            }
+    Pointer<Iterator< Pointer<ActiveMQConsumerKernel> > > iter(this->config->consumers.iterator());
+    while (iter->hasNext()) {
+        Pointer<ActiveMQConsumerKernel> consumer = iter->next();
+        if (consumer->getMessageListener() != NULL) {
+            throw cms::IllegalStateException(
+                "Cannot synchronously receive a message when a MessageListener is set");
         }
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionKernel::sendAck(Pointer<MessageAck> ack, bool async) {
+
+    // The acks of a consumer sharing a subscription are counted by the subscription.
+    if (this->connection->getSubscriptionMultiplexer().acknowledge(*ack)) {
+        return;
+    }
+
+    long long start = System::nanoTime();
+
     if (async || this->connection->isSendAcksAsync() || this->isTransacted()) {
+
+        // Counted in the metrics once sendPendingAcks writes it.
+        if (this->config->ackBatchThread != NULL && this->config->ackBatchThread == Thread::currentThread()) {
+            synchronized(&this->config->heldAcksLock) {
+                this->config->heldAcks.push_back(ack);
+            }
+            return;
+        }
+
         this->connection->oneway(ack);
     } else {
         this->connection->syncRequest(ack);
     }
+
+    ConnectionMetrics& metrics = this->connection->getMetrics();
+    metrics.getAcksSent().increment();
+    metrics.getAckSendTime().record((System::nanoTime() - start) / 1000);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::beginAckBatch() {
+
+    // The acks of the other modes carry transaction or recovery state that must not
+    // fall behind the commands that follow them.
+    if (this->connection->isAggregateSessionAcks() && (this->isAutoAcknowledge() || this->isDupsOkAcknowledge())) {
+        this->config->ackBatchThread = Thread::currentThread();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::endAckBatch() {
+    this->config->ackBatchThread = NULL;
+    sendPendingAcks();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionKernel::sendPendingAcks() {
+
+    try {
+
+        std::vector< Pointer<MessageAck> > acks;
+        synchronized(&this->config->heldAcksLock) {
+            acks.swap(this->config->heldAcks);
+        }
+
+        if (acks.empty()) {
+            return;
+        }
+
+        // The acks are written back to back and flushed together, unless some other
+        // writer already has the flush deferred and will do it.
+        IOTransport* io = NULL;
+        if (acks.size() > 1) {
+            io = dynamic_cast<IOTransport*>(this->connection->getTransport().narrow(typeid(IOTransport)));
+            if (io != NULL && !io->isFlushDeferred()) {
+                io->setFlushDeferred(true);
+            } else {
+                io = NULL;
+            }
+        }
+
+        ConnectionMetrics& metrics = this->connection->getMetrics();
+
+        try {
+            std::vector< Pointer<MessageAck> >::const_iterator iter = acks.begin();
+            for (; iter != acks.end(); ++iter) {
+                long long start = System::nanoTime();
+                this->connection->oneway(*iter);
+                metrics.getAcksSent().increment();
+                metrics.getAckSendTime().record((System::nanoTime() - start) / 1000);
+            }
+        } catch (...) {
+            if (io != NULL) {
+                try {
+                    io->setFlushDeferred(false);
+                } catch (...) {
+                }
+            }
+            throw;
+        }
+
+        if (io != NULL) {
+            io->setFlushDeferred(false);
+        }
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1525,14 +1880,17 @@ void ActiveMQSessionKernel::setSessionAsyncDispatch(bool sessionAsyncDispatch) {
 ////////////////////////////////////////////////////////////////////////////////
 decaf::util::ArrayList< Pointer<ActiveMQConsumerKernel> > ActiveMQSessionKernel::getConsumers() const {
     ArrayList< Pointer<ActiveMQConsumerKernel> > result;
-    this->config->consumerLock.readLock().lock();
-    try {
-        result.addAll(this->config->consumers);
-        this->config->consumerLock.readLock().unlock();
-    } catch (Exception& ex) {
-        this->config->consumerLock.readLock().unlock();
-        throw;
-    }
+    result.addAll(this->config->consumers);
 
     return result;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQSessionKernel::getDispatchQueueMemoryUsage() const {
+    return this->executor.get() != NULL ? this->executor->getMemoryUsage() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ActiveMQSessionKernel::getDispatchQueueSize() const {
+    return this->executor.get() != NULL ? this->executor->size() : 0;
+}
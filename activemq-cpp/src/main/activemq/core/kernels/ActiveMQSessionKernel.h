@@ -65,6 +65,86 @@ namespace kernels {
     class SessionConfig;
 
     class AMQCPP_API ActiveMQSessionKernel : public virtual cms::Session, public Dispatcher {
+    public:
+
+        /**
+         * The outcome of a consumer created with createConsumerAsync.
+         *
+         * The consumer is registered with the session as soon as its ConsumerInfo is
+         * sent, get hands it to the caller once the broker has accepted it.  A consumer
+         * the broker refused is closed by get, which then throws the broker's error.
+         * A future dropped before get was called closes its consumer.
+         */
+        class AMQCPP_API ConsumerFuture {
+        public:
+
+            virtual ~ConsumerFuture();
+
+            /**
+             * @return true once the broker has answered the consumer's ConsumerInfo.
+             */
+            virtual bool isDone() const = 0;
+
+            /**
+             * Waits at most the given time for the broker to answer.
+             *
+             * @param millisecs
+             *      The time to wait in milliseconds.
+             *
+             * @return true if the broker answered, false if the time ran out first.
+             *
+             * @throws CMSException if the wait is interrupted.
+             */
+            virtual bool await(long long millisecs) = 0;
+
+            /**
+             * Waits for the broker to answer and returns the consumer, which the caller
+             * then owns.  The consumer is handed out only once.
+             *
+             * @return the new consumer.
+             *
+             * @throws CMSException if the broker refused the consumer, or if it was
+             *         already taken by an earlier call.
+             */
+            virtual cms::MessageConsumer* get() = 0;
+
+        };
+
+        /**
+         * The outcome of a consumer close started with closeConsumerAsync, done once the
+         * broker has confirmed the removal of the consumer.
+         */
+        class AMQCPP_API CloseFuture {
+        public:
+
+            virtual ~CloseFuture();
+
+            /**
+             * @return true once the broker has confirmed the removal.
+             */
+            virtual bool isDone() const = 0;
+
+            /**
+             * Waits for the broker to confirm the removal.
+             *
+             * @throws CMSException if the broker answered with an error.
+             */
+            virtual void await() = 0;
+
+            /**
+             * Waits at most the given time for the broker to confirm the removal.
+             *
+             * @param millisecs
+             *      The time to wait in milliseconds.
+             *
+             * @return true if the removal was confirmed, false if the time ran out first.
+             *
+             * @throws CMSException if the broker answered with an error.
+             */
+            virtual bool await(long long millisecs) = 0;
+
+        };
+
     private:
 
         friend class activemq::core::ActiveMQSessionExecutor;
@@ -144,6 +224,15 @@ namespace kernels {
          */
         virtual void redispatch(MessageDispatchChannel& unconsumedMessages);
 
+        /**
+         * Redispatches the given messages to the consumers ahead of any messages already
+         * waiting to be dispatched, keeping their order.
+         *
+         * @param messages
+         *      The messages to be redelivered in the order they were first delivered.
+         */
+        virtual void redispatch(const std::vector< Pointer<commands::MessageDispatch> >& messages);
+
         /**
          * Stops asynchronous message delivery.
          */
@@ -273,12 +362,32 @@ namespace kernels {
          *      of the given message.
          * @param sendTimeout
          *      The amount of time to block during send before failing, or 0 to wait forever.
+         * @param onComplete
+         *      Callback notified when an asynchronous send completes, or NULL.
+         * @param sendTime
+         *      The System::nanoTime at which the producer's send was called, reported to
+         *      the connection's MessageTracer if one is set.
          *
          * @throws CMSException if an error occurs while sending the message.
          */
         void send(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
                   cms::Message* message, int deliveryMode, int priority, long long timeToLive,
-                  util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete);
+                  util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                  long long sendTime = 0);
+
+        /**
+         * Sends a message the producer has made for this send alone, the same way the
+         * send of a cms::Message does but without first copying it.  The message is
+         * given its headers and id directly and must not be used by the caller again.
+         *
+         * @see send(kernels::ActiveMQProducerKernel*, Pointer<commands::ActiveMQDestination>,
+         *           cms::Message*, int, int, long long, util::MemoryUsage*, long long,
+         *           cms::AsyncCallback*, long long)
+         */
+        void sendOwned(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
+                       Pointer<commands::Message> message, int deliveryMode, int priority, long long timeToLive,
+                       util::MemoryUsage* producerWindow, long long sendTimeout, cms::AsyncCallback* onComplete,
+                       long long sendTime = 0);
 
         /**
          * This method gets any registered exception listener of this sessions
@@ -430,6 +539,54 @@ namespace kernels {
          */
         void removeProducer(Pointer<ActiveMQProducerKernel> producer);
 
+        /**
+         * Commits the current transaction without waiting for the broker to answer, see
+         * ActiveMQTransactionContext::commitAsync.
+         *
+         * @return the future that reports the outcome of the commit.
+         *
+         * @throws CMSException if the session is closed or not transacted.
+         */
+        Pointer<ActiveMQTransactionContext::CommitFuture> commitAsync();
+
+        /**
+         * Creates a consumer without waiting for the broker to accept it.  The
+         * ConsumerInfo is sent as an asynchronous request and the caller collects the
+         * consumer from the returned future, so many consumers can be set up within a
+         * single round trip to the broker.
+         *
+         * @param destination
+         *      The destination to consume from.
+         * @param selector
+         *      The message selector, empty for none.
+         * @param noLocal
+         *      Whether messages sent on this session's connection are filtered out.
+         *
+         * @return the future that hands out the consumer.
+         *
+         * @throws CMSException if the session is closed or the ConsumerInfo can't be sent.
+         */
+        Pointer<ConsumerFuture> createConsumerAsync(const cms::Destination* destination,
+                                                    const std::string& selector = "",
+                                                    bool noLocal = false);
+
+        /**
+         * Closes a consumer of this session without waiting for the broker to confirm
+         * its removal.  The consumer is closed locally before this returns, the future
+         * reports the broker's answer to the RemoveInfo.  A close that the session's
+         * transaction defers until it completes, or of a consumer already closed, gives
+         * a future that is done at once.  The caller still deletes the consumer.
+         *
+         * @param consumer
+         *      A consumer created by this session.
+         *
+         * @return the future that reports the broker's answer.
+         *
+         * @throws CMSException if the consumer is not from this client or the
+         *         RemoveInfo can't be sent.
+         */
+        Pointer<CloseFuture> closeConsumerAsync(cms::MessageConsumer* consumer);
+
         /**
          * Starts if not already start a Transaction for this Session.  If the session
          * is not a Transacted Session then an exception is thrown.  If a transaction is
@@ -571,6 +728,26 @@ namespace kernels {
          */
         void sendAck(decaf::lang::Pointer<commands::MessageAck> ack, bool async = false);
 
+        /**
+         * Starts a round of dispatch on the calling thread.  Until endAckBatch is called
+         * the acks that the thread would send asynchronously are held by the Session
+         * instead, this only happens for an AUTO_ACKNOWLEDGE or DUPS_OK_ACKNOWLEDGE
+         * Session whose Connection aggregates Session acks.
+         */
+        void beginAckBatch();
+
+        /**
+         * Ends the round started by beginAckBatch and sends the acks held during it.
+         */
+        void endAckBatch();
+
+        /**
+         * Sends the held acks now, one after another with a single flush of the transport.
+         * Called before anything that must reach the Broker after them, like the removal
+         * of a consumer whose messages they ack.
+         */
+        void sendPendingAcks();
+
         /**
          * Returns true if this session is dispatching messages to its consumers asynchronously.
          *
@@ -594,6 +771,16 @@ namespace kernels {
          */
         decaf::util::ArrayList< Pointer<ActiveMQConsumerKernel> > getConsumers() const;
 
+        /**
+         * @return the bytes of the messages queued for dispatch to this session's consumers.
+         */
+        long long getDispatchQueueMemoryUsage() const;
+
+        /**
+         * @return the number of messages queued for dispatch to this session's consumers.
+         */
+        int getDispatchQueueSize() const;
+
    private:
 
        /**
@@ -607,20 +794,25 @@ namespace kernels {
        // Checks for the closed state and throws if so.
        void checkClosed() const;
 
-       // Send the Destination Creation Request to the Broker, alerting it
-       // that we've created a new Temporary Destination.
-       // @param tempDestination - The new Temporary Destination
-       void createTemporaryDestination(commands::ActiveMQTempDestination* tempDestination);
-
        // Send the Destination Destruction Request to the Broker, alerting
        // it that we've removed an existing Temporary Destination.
        // @param tempDestination - The Temporary Destination to remove
        void destroyTemporaryDestination(commands::ActiveMQTempDestination* tempDestination);
 
-       // Creates a new Temporary Destination name using the connection id
-       // and a rolling count.
-       // @return a unique Temporary Destination name
-       std::string createTemporaryDestinationName();
+       // Creates the kernel of a new consumer of the given destination, not yet added
+       // to the session or sent to the broker.
+       Pointer<ActiveMQConsumerKernel> createConsumerKernel(const cms::Destination* destination,
+                                                            const std::string& selector, bool noLocal);
+
+       // Adds an added consumer to the connection's shared subscription for its topic
+       // when it can share one, returns false if its ConsumerInfo must be sent instead.
+       bool subscribeMultiplexed(Pointer<ActiveMQConsumerKernel> consumer);
+
+       // Sends either the cms::Message, which is copied, or the owned message as is.
+       void doSend(kernels::ActiveMQProducerKernel* producer, Pointer<commands::ActiveMQDestination> destination,
+                   cms::Message* message, Pointer<commands::Message> owned, int deliveryMode, int priority,
+                   long long timeToLive, util::MemoryUsage* producerWindow, long long sendTimeout,
+                   cms::AsyncCallback* onComplete, long long sendTime);
 
     };
 
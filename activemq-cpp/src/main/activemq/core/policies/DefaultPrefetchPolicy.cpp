@@ -31,13 +31,19 @@ int DefaultPrefetchPolicy::DEFAULT_DURABLE_TOPIC_PREFETCH = 100;
 int DefaultPrefetchPolicy::DEFAULT_QUEUE_PREFETCH = 1000;
 int DefaultPrefetchPolicy::DEFAULT_QUEUE_BROWSER_PREFETCH = 500;
 int DefaultPrefetchPolicy::DEFAULT_TOPIC_PREFETCH = MAX_PREFETCH_SIZE;
+long long DefaultPrefetchPolicy::DEFAULT_PREFETCH_MEMORY_LIMIT = 0;
+long long DefaultPrefetchPolicy::DEFAULT_PREFETCH_TARGET_LATENCY = 0;
+int DefaultPrefetchPolicy::DEFAULT_PULL_BATCH_SIZE = 1;
 
 ////////////////////////////////////////////////////////////////////////////////
 DefaultPrefetchPolicy::DefaultPrefetchPolicy() :
     durableTopicPrefetch( DEFAULT_DURABLE_TOPIC_PREFETCH ),
     queuePrefetch( DEFAULT_QUEUE_PREFETCH ),
     queueBrowserPrefetch( DEFAULT_QUEUE_BROWSER_PREFETCH ),
-    topicPrefetch( DEFAULT_TOPIC_PREFETCH ) {
+    topicPrefetch( DEFAULT_TOPIC_PREFETCH ),
+    prefetchMemoryLimit( DEFAULT_PREFETCH_MEMORY_LIMIT ),
+    prefetchTargetLatency( DEFAULT_PREFETCH_TARGET_LATENCY ),
+    pullBatchSize( DEFAULT_PULL_BATCH_SIZE ) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +59,9 @@ PrefetchPolicy* DefaultPrefetchPolicy::clone() const {
     copy->setTopicPrefetch(this->getTopicPrefetch());
     copy->setQueueBrowserPrefetch(this->getQueueBrowserPrefetch());
     copy->setQueuePrefetch(this->getQueuePrefetch());
+    copy->setPrefetchMemoryLimit(this->getPrefetchMemoryLimit());
+    copy->setPrefetchTargetLatency(this->getPrefetchTargetLatency());
+    copy->setPullBatchSize(this->getPullBatchSize());
 
     return copy;
 }
@@ -33,6 +33,9 @@ namespace policies {
         int queuePrefetch;
         int queueBrowserPrefetch;
         int topicPrefetch;
+        long long prefetchMemoryLimit;
+        long long prefetchTargetLatency;
+        int pullBatchSize;
 
     public:
 
@@ -41,6 +44,9 @@ namespace policies {
         static int DEFAULT_QUEUE_PREFETCH;
         static int DEFAULT_QUEUE_BROWSER_PREFETCH;
         static int DEFAULT_TOPIC_PREFETCH;
+        static long long DEFAULT_PREFETCH_MEMORY_LIMIT;
+        static long long DEFAULT_PREFETCH_TARGET_LATENCY;
+        static int DEFAULT_PULL_BATCH_SIZE;
 
     private:
 
@@ -85,6 +91,30 @@ namespace policies {
             return this->topicPrefetch;
         }
 
+        virtual void setPrefetchMemoryLimit(long long value) {
+            this->prefetchMemoryLimit = value;
+        }
+
+        virtual long long getPrefetchMemoryLimit() const {
+            return this->prefetchMemoryLimit;
+        }
+
+        virtual void setPrefetchTargetLatency(long long value) {
+            this->prefetchTargetLatency = value;
+        }
+
+        virtual long long getPrefetchTargetLatency() const {
+            return this->prefetchTargetLatency;
+        }
+
+        virtual void setPullBatchSize(int value) {
+            this->pullBatchSize = getMaxPrefetchLimit(value);
+        }
+
+        virtual int getPullBatchSize() const {
+            return this->pullBatchSize;
+        }
+
         virtual int getMaxPrefetchLimit(int value) const {
             return value < MAX_PREFETCH_SIZE ? value : MAX_PREFETCH_SIZE;
         }
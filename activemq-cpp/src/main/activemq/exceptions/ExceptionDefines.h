@@ -17,6 +17,23 @@
 #ifndef _ACTIVEMQ_EXCEPTIONS_EXCEPTIONDEFINES_H_
 #define _ACTIVEMQ_EXCEPTIONS_EXCEPTIONDEFINES_H_
 
+#include <decaf/lang/Exception.h>
+#include <cms/CMSException.h>
+
+namespace activemq {
+namespace exceptions {
+
+    using decaf::lang::markWithLiteral;
+
+    /**
+     * Marks a CMSException for the exception macros, it copies the file name.
+     */
+    inline void markWithLiteral(cms::CMSException& ex, const char* file, const int lineNumber) {
+        ex.setMark(file, lineNumber);
+    }
+
+}}
+
 /**
  * Macro for catching and re-throwing an exception of
  * a given type.
@@ -25,7 +42,7 @@
  */
 #define AMQ_CATCH_RETHROW( type ) \
     catch( type& ex ){ \
-        ex.setMark( __FILE__, __LINE__ ); \
+        ::activemq::exceptions::markWithLiteral( ex, __FILE__, __LINE__ ); \
         throw; \
     }
 
@@ -38,7 +55,7 @@
 #define AMQ_CATCH_EXCEPTION_CONVERT( sourceType, targetType ) \
     catch( sourceType& ex ){ \
         targetType target( ex ); \
-        target.setMark( __FILE__, __LINE__ ); \
+        ::activemq::exceptions::markWithLiteral( target, __FILE__, __LINE__ ); \
         throw target; \
     }
 
@@ -72,7 +89,7 @@
  */
 #define AMQ_CATCH_NOTHROW( type ) \
     catch( type& ex ){ \
-        ex.setMark( __FILE__, __LINE__ ); \
+        ::activemq::exceptions::markWithLiteral( ex, __FILE__, __LINE__ ); \
     }
 
 
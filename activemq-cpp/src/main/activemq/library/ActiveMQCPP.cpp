@@ -18,18 +18,37 @@
 #include "ActiveMQCPP.h"
 
 #include <decaf/lang/Runtime.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Boolean.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/internal/util/concurrent/Threading.h>
+#include <decaf/internal/util/concurrent/LockProfiler.h>
+#include <decaf/internal/io/BufferPool.h>
 #include <activemq/wireformat/WireFormatRegistry.h>
 #include <activemq/transport/TransportRegistry.h>
 
 #include <activemq/util/IdGenerator.h>
+#include <activemq/commands/DataStructurePool.h>
+#include <activemq/commands/DestinationInterner.h>
+#include <activemq/commands/IdSupport.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/threads/TimingWheel.h>
 
 #include <activemq/wireformat/stomp/StompWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
+#include <activemq/wireformat/openwire/marshal/MarshallerTable.h>
 
+#include <activemq/transport/inactivity/KeepAliveService.h>
 #include <activemq/transport/mock/MockTransportFactory.h>
+#include <activemq/transport/loopback/LoopbackTransportFactory.h>
+#include <activemq/transport/tcp/TcpEventLoop.h>
+#include <activemq/transport/tcp/SslHandshakeLimiter.h>
 #include <activemq/transport/tcp/TcpTransportFactory.h>
 #include <activemq/transport/tcp/SslTransportFactory.h>
+#include <activemq/transport/tcp/UnixTransportFactory.h>
 #include <activemq/transport/failover/FailoverTransportFactory.h>
+#include <activemq/transport/striped/StripedTransportFactory.h>
 
 using namespace activemq;
 using namespace activemq::library;
@@ -37,8 +56,20 @@ using namespace activemq::util;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
 using namespace activemq::transport::mock;
+using namespace activemq::transport::loopback;
 using namespace activemq::transport::failover;
+using namespace activemq::transport::striped;
 using namespace activemq::wireformat;
+using namespace decaf::lang;
+using namespace decaf::internal::io;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int DEFAULT_MONITOR_SPIN_COUNT = 100;
+
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ActiveMQCPP::ActiveMQCPP() {
@@ -52,18 +83,54 @@ ActiveMQCPP::~ActiveMQCPP() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::initializeLibrary(int argc, char** argv) {
+    ActiveMQCPP::initializeLibrary(argc, argv, std::map<std::string, std::string>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQCPP::initializeLibrary(int argc, char** argv, const std::map<std::string, std::string>& properties) {
 
     // Initialize the Decaf Library by requesting its runtime.
     decaf::lang::Runtime::initializeRuntime(argc, argv);
 
+    // Apply the caller's settings before any library threads are started.
+    ActiveMQCPP::configureLibrary(properties);
+
     // Register all WireFormats
     ActiveMQCPP::registerWireFormats();
 
     // Register all Transports
     ActiveMQCPP::registerTransports();
 
-    // Start the IdGenerator Kernel
+    // Start the IdGenerator Kernel, the host name and unique stub are only worked
+    // out when the first id is generated.
     IdGenerator::initialize();
+
+    // Allows connections to recycle the commands they unmarshal.
+    commands::DataStructurePool::initialize();
+
+    // Shares one instance of each queue and topic the wire formats decode.
+    commands::DestinationInterner::initialize();
+
+    // Keeps the producer each thread last parsed a message id string of.
+    commands::IdSupport::initialize();
+
+    // Holds the OpenWire marshallers that all the wire formats share.
+    wireformat::openwire::marshal::MarshallerTable::initialize();
+
+    // Keeps the parsed options of the broker URIs the connection factories are given.
+    core::ActiveMQConnectionFactory::initialize();
+
+    // Timer shared by the connections that opt into the TimingWheel.
+    threads::TimingWheel::initialize();
+
+    // Drives the inactivity checks of all connections.
+    transport::inactivity::KeepAliveService::initialize();
+
+    // Reads the sockets of the connections that use the event loop.
+    transport::tcp::TcpEventLoop::initialize();
+
+    // Paces the SSL handshakes of transports that connect at the same time.
+    transport::tcp::SslHandshakeLimiter::initialize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,6 +141,24 @@ void ActiveMQCPP::initializeLibrary() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::shutdownLibrary() {
 
+    transport::tcp::SslHandshakeLimiter::shutdownInstance();
+
+    transport::tcp::TcpEventLoop::shutdownInstance();
+
+    transport::inactivity::KeepAliveService::shutdownInstance();
+
+    threads::TimingWheel::shutdownSharedInstance();
+
+    core::ActiveMQConnectionFactory::shutdown();
+
+    wireformat::openwire::marshal::MarshallerTable::shutdown();
+
+    commands::IdSupport::shutdown();
+
+    commands::DestinationInterner::shutdown();
+
+    commands::DataStructurePool::shutdown();
+
     // Shutdown the IdGenerator Kernel
     IdGenerator::shutdown();
 
@@ -87,24 +172,58 @@ void ActiveMQCPP::shutdownLibrary() {
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::registerWireFormats() {
 
-    // Each of the internally implemented WireFormat's is registered here
-    // with the WireFormat Registry
-    WireFormatRegistry::initialize();
+    // The internally implemented WireFormat's are registered with the WireFormat
+    // Registry when it is first used.
+    WireFormatRegistry::initialize(&ActiveMQCPP::registerDefaultWireFormats);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQCPP::registerDefaultWireFormats(WireFormatRegistry& registry) {
 
-    WireFormatRegistry::getInstance().registerFactory("openwire", new wireformat::openwire::OpenWireFormatFactory());
-    WireFormatRegistry::getInstance().registerFactory("stomp", new wireformat::stomp::StompWireFormatFactory());
+    registry.registerFactory("openwire", new wireformat::openwire::OpenWireFormatFactory());
+    registry.registerFactory("stomp", new wireformat::stomp::StompWireFormatFactory());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQCPP::registerTransports() {
 
-    // Each of the internally implemented Transports is registered here
-    TransportRegistry::initialize();
+    // The internally implemented Transports are registered when the Transport
+    // Registry is first used.
+    TransportRegistry::initialize(&ActiveMQCPP::registerDefaultTransports);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQCPP::registerDefaultTransports(TransportRegistry& registry) {
+
+    registry.registerFactory("tcp", new TcpTransportFactory());
+    registry.registerFactory("ssl", new SslTransportFactory());
+    registry.registerFactory("nio", new TcpTransportFactory());
+    registry.registerFactory("nio+ssl", new SslTransportFactory());
+    registry.registerFactory("unix", new UnixTransportFactory());
+    registry.registerFactory("mock", new MockTransportFactory());
+    registry.registerFactory("loopback", new LoopbackTransportFactory());
+    registry.registerFactory("failover", new FailoverTransportFactory());
+    registry.registerFactory("striped", new StripedTransportFactory());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQCPP::configureLibrary(const std::map<std::string, std::string>& properties) {
+
+    std::map<std::string, std::string>::const_iterator iter = properties.begin();
+    for (; iter != properties.end(); ++iter) {
+        System::setProperty(iter->first, iter->second);
+    }
+
+    if (Boolean::parseBoolean(System::getProperty("decaf.concurrent.adaptiveMonitors", "false"))) {
+        Threading::setMonitorSpinCount(Integer::parseInt(System::getProperty(
+            "decaf.concurrent.monitorSpinCount", Integer::toString(DEFAULT_MONITOR_SPIN_COUNT))));
+    } else {
+        Threading::setMonitorSpinCount(0);
+    }
+
+    LockProfiler::setEnabled(Boolean::parseBoolean(System::getProperty("decaf.concurrent.lockProfiling", "false")));
 
-    TransportRegistry::getInstance().registerFactory("tcp", new TcpTransportFactory());
-    TransportRegistry::getInstance().registerFactory("ssl", new SslTransportFactory());
-    TransportRegistry::getInstance().registerFactory("nio", new TcpTransportFactory());
-    TransportRegistry::getInstance().registerFactory("nio+ssl", new SslTransportFactory());
-    TransportRegistry::getInstance().registerFactory("mock", new MockTransportFactory());
-    TransportRegistry::getInstance().registerFactory("failover", new FailoverTransportFactory());
+    BufferPool::setMaxReserved(Long::parseLong(System::getProperty(
+        "decaf.io.bufferPool.maxReserved", Long::toString(BufferPool::DEFAULT_MAX_RESERVED))));
+    BufferPool::setEnabled(Boolean::parseBoolean(System::getProperty("decaf.io.bufferPool", "false")));
 }
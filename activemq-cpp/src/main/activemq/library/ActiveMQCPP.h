@@ -20,7 +20,16 @@
 
 #include <activemq/util/Config.h>
 
+#include <map>
+#include <string>
+
 namespace activemq {
+namespace transport {
+    class TransportRegistry;
+}
+namespace wireformat {
+    class WireFormatRegistry;
+}
 namespace library {
 
     class AMQCPP_API ActiveMQCPP {
@@ -57,6 +66,42 @@ namespace library {
          */
         static void initializeLibrary(int argc, char** argv);
 
+        /**
+         * Initialize the ActiveMQ-CPP Library constructs using the given properties to
+         * configure the library.  The properties are added to the System properties once
+         * the Decaf library is running, they are passed in a standard map as the Decaf
+         * collections cannot be used before then.  The following settings are recognized:
+         *
+         *  - decaf.concurrent.adaptiveMonitors : when true a thread that finds a Mutex
+         *    locked spins briefly before it parks, default is false.
+         *  - decaf.concurrent.monitorSpinCount : the upper bound on the spins made when
+         *    adaptive monitors are enabled, default is 100.
+         *  - decaf.concurrent.lockProfiling : when true the waits for and holds of the
+         *    library's busiest locks are recorded, LockProfiler::report returns them,
+         *    default is false.
+         *  - decaf.io.bufferPool : when true the staging buffers of the buffered streams,
+         *    the transports' socket buffers among them, are drawn from a pool of slabs
+         *    backed by huge pages where the platform allows, BufferPool::getStatistics
+         *    reports its hits and misses, default is false.
+         *  - decaf.io.bufferPool.maxReserved : the most bytes of slabs the buffer pool
+         *    reserves, larger demand is served from the heap, default is 64MB.
+         *  - activemq.idgenerator.hostname : the host name used in the generated ids,
+         *    default is the name the machine is configured with, it is never resolved.
+         *  - activemq.idgenerator.localport : a number used in place of the port that is
+         *    otherwise bound briefly to make the generated ids unique between processes.
+         *  - activemq.ssl.handshake.maxConcurrent : the most SSL handshakes that the
+         *    transports run at once, default is the number of processors.
+         *  - activemq.ssl.handshake.startInterval : the least time in milliseconds between
+         *    the start of two SSL handshakes, default is 0.
+         *
+         * @param argc - the count of arguments passed to this Process.
+         * @param argv - the array of string arguments passed to this process.
+         * @param properties - the properties used to configure the library.
+         *
+         * @throws runtime_error if an error occurs while initializing this library.
+         */
+        static void initializeLibrary(int argc, char** argv, const std::map<std::string, std::string>& properties);
+
         /**
          * Shutdown the ActiveMQ-CPP Library, freeing any resources
          * that could not be freed up to this point.  All the user created
@@ -69,6 +114,9 @@ namespace library {
 
         static void registerWireFormats();
         static void registerTransports();
+        static void registerDefaultWireFormats(wireformat::WireFormatRegistry& registry);
+        static void registerDefaultTransports(transport::TransportRegistry& registry);
+        static void configureLibrary(const std::map<std::string, std::string>& properties);
 
     };
 
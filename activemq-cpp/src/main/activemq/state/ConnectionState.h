@@ -33,7 +33,8 @@
 
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
-#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/lang/Pointer.h>
 
@@ -43,6 +44,8 @@ namespace activemq {
 namespace state {
 
     using decaf::lang::Pointer;
+    using decaf::lang::PointerEquals;
+    using decaf::util::concurrent::ConcurrentHashMap;
     using namespace decaf::util;
     using namespace activemq::commands;
 
@@ -50,12 +53,14 @@ namespace state {
     private:
 
         Pointer< ConnectionInfo > info;
-        ConcurrentStlMap< Pointer<LocalTransactionId>,
-                          Pointer<TransactionState>,
-                          LocalTransactionId::COMPARATOR > transactions;
-        ConcurrentStlMap< Pointer<SessionId>,
-                          Pointer<SessionState>,
-                          SessionId::COMPARATOR > sessions;
+        ConcurrentHashMap< Pointer<LocalTransactionId>,
+                           Pointer<TransactionState>,
+                           HashCode< Pointer<LocalTransactionId> >,
+                           PointerEquals<LocalTransactionId> > transactions;
+        ConcurrentHashMap< Pointer<SessionId>,
+                           Pointer<SessionState>,
+                           HashCode< Pointer<SessionId> >,
+                           PointerEquals<SessionId> > sessions;
         LinkedList< Pointer<DestinationInfo> > tempDestinations;
         decaf::util::concurrent::atomic::AtomicBoolean disposed;
 
@@ -19,10 +19,15 @@
 
 #include <decaf/lang/Runnable.h>
 #include <decaf/util/HashCode.h>
-#include <decaf/util/LinkedHashMap.h>
-#include <decaf/util/MapEntry.h>
 #include <decaf/util/NoSuchElementException.h>
-#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/concurrent/ConcurrentLRUCache.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/Properties.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
 
 #include <activemq/commands/ConsumerControl.h>
 #include <activemq/commands/ExceptionResponse.h>
@@ -30,64 +35,210 @@
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/transport/TransportListener.h>
 #include <activemq/wireformat/WireFormat.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+
+#include <deque>
+#include <vector>
+#include <cstring>
 
 using namespace activemq;
 using namespace activemq::core;
 using namespace activemq::state;
 using namespace activemq::commands;
 using namespace activemq::exceptions;
+using namespace activemq::wireformat::openwire;
 using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::io;
 using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
 namespace state {
 
 
-    class MessageCache : public LinkedHashMap<Pointer<MessageId>, Pointer<Command> > {
-    protected:
+    /**
+     * Holds the most recently sent messages for replay as marshaled frames packed into
+     * a single ring of getMaxMessageCacheSize() bytes.  When a new frame doesn't fit the
+     * oldest frames are dropped until it does, so memory use never exceeds the limit and
+     * adding a message allocates nothing once the ring exists.  The frames are written
+     * with a private wire format that has caching disabled so that they stand alone and
+     * can be decoded again regardless of what the connection negotiates.
+     */
+    class MessageCache {
+    private:
+
+        MessageCache(const MessageCache&);
+        MessageCache& operator= (const MessageCache&);
+
+    private:
+
+        struct Frame {
+            std::size_t start;
+            std::size_t length;
+
+            Frame(std::size_t start, std::size_t length) : start(start), length(length) {}
+        };
+
+        // Copies a marshaled frame into its place in the ring.
+        class FrameWriter : public decaf::io::OutputStream {
+        private:
+
+            FrameWriter(const FrameWriter&);
+            FrameWriter& operator= (const FrameWriter&);
+
+        private:
+
+            unsigned char* position;
+
+        public:
+
+            FrameWriter(unsigned char* position) : OutputStream(), position(position) {}
+
+            virtual ~FrameWriter() {}
+
+        protected:
+
+            virtual void doWriteByte(unsigned char value) {
+                *position++ = value;
+            }
+
+            virtual void doWriteArrayBounded(const unsigned char* buffer, int size AMQCPP_UNUSED, int offset, int length) {
+                std::memcpy(position, buffer + offset, (std::size_t) length);
+                position += length;
+            }
+        };
 
         ConnectionStateTracker* parent;
 
-    public:
+        mutable Mutex mutex;
+        std::vector<unsigned char> ring;
+        std::deque<Frame> frames;
 
-        int currentCacheSize;
+        OpenWireFormat wireFormat;
+        ByteArrayOutputStream buffer;
+        DataOutputStream bufferOut;
 
     public:
 
         MessageCache(ConnectionStateTracker* parent) :
-            LinkedHashMap<Pointer<MessageId>, Pointer<Command> >(), parent(parent), currentCacheSize(0) {
+            parent(parent), mutex(), ring(), frames(), wireFormat(decaf::util::Properties()),
+            buffer(), bufferOut(&buffer) {
+
+            wireFormat.setCacheEnabled(false);
+            wireFormat.setTightEncodingEnabled(false);
+            wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
         }
 
         virtual ~MessageCache() {}
 
-        virtual bool removeEldestEntry(const MapEntry<Pointer<MessageId>, Pointer<Command> >& eldest) {
-            bool result = currentCacheSize > parent->getMaxMessageCacheSize();
-            if (result) {
-                Pointer<Message> message = eldest.getValue().dynamicCast<Message>();
-                currentCacheSize -= message->getSize();
+        void add(Message* message) {
+
+            synchronized(&mutex) {
+
+                int limit = parent->getMaxMessageCacheSize();
+                std::size_t capacity = limit > 0 ? (std::size_t) limit : 0;
+                if (this->ring.size() != capacity) {
+                    // The limit was changed, start over with a ring of the new size.
+                    this->frames.clear();
+                    std::vector<unsigned char>(capacity).swap(this->ring);
+                }
+
+                this->buffer.reset();
+                this->wireFormat.looseMarshalNestedObject(message, &this->bufferOut);
+                this->bufferOut.flush();
+
+                std::size_t length = (std::size_t) this->buffer.size();
+                if (length > capacity) {
+                    return;
+                }
+
+                std::size_t start = allocate(length);
+                FrameWriter writer(&this->ring[start]);
+                this->buffer.writeTo(&writer);
+                this->frames.push_back(Frame(start, length));
             }
-            return result;
         }
-    };
 
-    class MessagePullCache : public LinkedHashMap<std::string, Pointer<Command> > {
-    protected:
+        /**
+         * Sends each cached frame, oldest first, on the given Transport.  When the
+         * connection's wire format encodes the way the cache does the frames are sent as
+         * they are, otherwise each is decoded so that the connection can encode it again.
+         */
+        void replay(Pointer<transport::Transport> transport) {
+
+            const OpenWireFormat* target = dynamic_cast<const OpenWireFormat*>(transport->getWireFormat().get());
+            bool preMarshaled = target != NULL && !target->isCacheEnabled() &&
+                                !target->isTightEncodingEnabled() && target->getVersion() == this->wireFormat.getVersion();
+
+            std::vector< Pointer<Command> > messages;
+
+            synchronized(&mutex) {
+                messages.reserve(this->frames.size());
+
+                std::deque<Frame>::const_iterator frame = this->frames.begin();
+                for (; frame != this->frames.end(); ++frame) {
+                    if (preMarshaled) {
+                        // Past the leading not null marker the nested form is the frame.
+                        messages.push_back(Pointer<Command>(new MarshaledCommand(
+                            &this->ring[frame->start + 1], (int) frame->length - 1, this->wireFormat.getVersion())));
+                    } else {
+                        ByteArrayInputStream bytes(&this->ring[frame->start], (int) frame->length);
+                        DataInputStream bytesIn(&bytes);
+                        messages.push_back(Pointer<Command>(
+                            dynamic_cast<Command*>(this->wireFormat.looseUnmarshalNestedObject(&bytesIn))));
+                    }
+                }
+            }
 
-        ConnectionStateTracker* parent;
+            std::vector< Pointer<Command> >::const_iterator message = messages.begin();
+            for (; message != messages.end(); ++message) {
+                transport->oneway(*message);
+            }
+        }
 
-    public:
+        void clear() {
+            synchronized(&mutex) {
+                this->frames.clear();
+            }
+        }
 
-        MessagePullCache(ConnectionStateTracker* parent) :
-            LinkedHashMap<std::string, Pointer<Command> >(), parent(parent) {
+        long long getMemoryUsage() const {
+            long long usage = 0;
+            synchronized(&mutex) {
+                usage = (long long) (this->ring.capacity() + this->frames.size() * sizeof(Frame));
+            }
+            return usage;
         }
 
-        virtual ~MessagePullCache() {}
+    private:
+
+        // Finds room for a frame of the given length, dropping the oldest frames as needed,
+        // the frames always occupy one or two runs of the ring so the check is O(1).
+        std::size_t allocate(std::size_t length) {
+
+            while (!this->frames.empty()) {
+
+                std::size_t head = this->frames.front().start;
+                const Frame& last = this->frames.back();
+                std::size_t tail = last.start + last.length;
+
+                if (last.start >= head) {
+                    if (this->ring.size() - tail >= length) {
+                        return tail;
+                    } else if (head >= length) {
+                        return 0;
+                    }
+                } else if (head - tail >= length) {
+                    return tail;
+                }
 
-        virtual bool removeEldestEntry(const MapEntry<std::string, Pointer<Command> >& eldest AMQCPP_UNUSED) {
-            return size() > parent->getMaxMessagePullCacheSize();
+                this->frames.pop_front();
+            }
+
+            return 0;
         }
     };
 
@@ -106,19 +257,20 @@ namespace state {
         const Pointer<Tracked> TRACKED_RESPONSE_MARKER;
 
         /** Map holding the ConnectionStates, indexed by the ConnectionId */
-        ConcurrentStlMap<Pointer<ConnectionId>, Pointer<ConnectionState>, ConnectionId::COMPARATOR> connectionStates;
+        ConcurrentHashMap<Pointer<ConnectionId>, Pointer<ConnectionState>,
+                          decaf::util::HashCode< Pointer<ConnectionId> >, PointerEquals<ConnectionId> > connectionStates;
 
         /** Store Messages if trackMessages == true */
         MessageCache messageCache;
 
-        /** Store MessagePull commands for replay */
-        MessagePullCache messagePullCache;
+        /** Store MessagePull commands for replay, pulls are rare so one segment is enough */
+        ConcurrentLRUCache<std::string, Pointer<Command> > messagePullCache;
 
         StateTrackerImpl(ConnectionStateTracker * parent) : parent(parent),
                                                             TRACKED_RESPONSE_MARKER(new Tracked()),
                                                             connectionStates(),
                                                             messageCache(parent),
-                                                            messagePullCache(parent) {
+                                                            messagePullCache(1, 1) {
         }
 
         ~StateTrackerImpl() {
@@ -172,7 +324,12 @@ ConnectionStateTracker::ConnectionStateTracker() : impl(new StateTrackerImpl(thi
                                                    trackMessages(true),
                                                    trackTransactionProducers(true),
                                                    maxMessageCacheSize(128 * 1024),
-                                                   maxMessagePullCacheSize(10) {
+                                                   maxMessagePullCacheSize(10),
+                                                   transactionSpoolSize(0),
+                                                   transactionSpoolDirectory(),
+                                                   transactionSpoolFileSize(TransactionJournal::DEFAULT_FILE_SIZE) {
+
+    this->impl->messagePullCache.setMaxCacheSize(this->maxMessagePullCacheSize);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,6 +345,20 @@ Pointer<Tracked> ConnectionStateTracker::track(Pointer<Command> command) {
 
     try{
 
+        // Sends inside a transaction are by far the most frequent command, they are
+        // recorded here without the visitor and, since the session never touches a
+        // message again once it's been sent, without copying it either.
+        if (command->isMessage() && this->trackTransactions) {
+            const Message* message = dynamic_cast<const Message*>(command.get());
+            if (message != NULL && message->getTransactionId() != NULL) {
+                Pointer<TransactionState> transactionState = transactionStateOf(message);
+                if (transactionState != NULL) {
+                    addTransactedMessage(transactionState, command, message);
+                }
+                return this->impl->TRACKED_RESPONSE_MARKER;
+            }
+        }
+
         Pointer<Command> result = command->visit(this);
         if (result == NULL) {
             return Pointer<Tracked>();
@@ -201,21 +372,9 @@ Pointer<Tracked> ConnectionStateTracker::track(Pointer<Command> command) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void ConnectionStateTracker::trackBack(Pointer<Command> command) {
-
-    try {
-        if (command != NULL) {
-            if (trackMessages && command->isMessage()) {
-                Pointer<Message> message = command.dynamicCast<Message>();
-                if (message->getTransactionId() == NULL) {
-                    this->impl->messageCache.currentCacheSize += message->getSize();
-                }
-            }
-        }
-    }
-    AMQ_CATCH_RETHROW(ActiveMQException)
-    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
-    AMQ_CATCHALL_THROW(ActiveMQException)
+void ConnectionStateTracker::trackBack(Pointer<Command> command AMQCPP_UNUSED) {
+    // Cached messages are charged against the cache limit as they're added, there's
+    // nothing left to account for once the send has completed.
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -245,14 +404,12 @@ void ConnectionStateTracker::restore(Pointer<transport::Transport> transport) {
         }
 
         // Now we flush messages
-        Pointer<Iterator<Pointer<Command> > > messages(this->impl->messageCache.values().iterator());
-        while (messages->hasNext()) {
-            transport->oneway(messages->next());
-        }
+        this->impl->messageCache.replay(transport);
 
-        Pointer<Iterator<Pointer<Command> > > messagePullIter(this->impl->messagePullCache.values().iterator());
-        while (messagePullIter->hasNext()) {
-            transport->oneway(messagePullIter->next());
+        std::vector<Pointer<Command> > messagePulls = this->impl->messagePullCache.values();
+        std::vector<Pointer<Command> >::const_iterator messagePull = messagePulls.begin();
+        for (; messagePull != messagePulls.end(); ++messagePull) {
+            transport->oneway(*messagePull);
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -288,11 +445,7 @@ void ConnectionStateTracker::doRestoreTransactions(Pointer<transport::Transport>
                 transport->oneway(state->next()->getInfo());
             }
 
-            std::auto_ptr<Iterator<Pointer<Command> > > commands(txState->getCommands().iterator());
-
-            while (commands->hasNext()) {
-                transport->oneway(commands->next());
-            }
+            txState->replay(transport);
 
             state.reset(txState->getProducerStates().iterator());
             while (state->hasNext()) {
@@ -394,10 +547,10 @@ void ConnectionStateTracker::doRestoreProducers(Pointer<transport::Transport> tr
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionStateTracker::doRestoreTempDestinations(Pointer<transport::Transport> transport, Pointer<ConnectionState> connectionState) {
     try {
-        std::auto_ptr<Iterator<Pointer<DestinationInfo> > > iter(connectionState->getTempDesinations().iterator());
-
-        while (iter->hasNext()) {
-            transport->oneway(iter->next());
+        const LinkedList<Pointer<DestinationInfo> >& destinations = connectionState->getTempDesinations();
+        LinkedList<Pointer<DestinationInfo> >::const_iterator destination = destinations.begin();
+        for (; destination != destinations.end(); ++destination) {
+            transport->oneway(*destination);
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -628,29 +781,13 @@ Pointer<Command> ConnectionStateTracker::processMessage(Message* message) {
 
         if (message != NULL) {
             if (trackTransactions && message->getTransactionId() != NULL) {
-                Pointer<ProducerId> producerId = message->getProducerId();
-                Pointer<ConnectionId> connectionId = producerId->getParentId()->getParentId();
-
-                if (connectionId != NULL) {
-                    Pointer<ConnectionState> cs = this->impl->connectionStates.get(connectionId);
-                    if (cs != NULL) {
-                        Pointer<TransactionState> transactionState = cs->getTransactionState(message->getTransactionId());
-                        if (transactionState != NULL) {
-                            transactionState->addCommand(Pointer<Command>(message->cloneDataStructure()));
-
-                            if (trackTransactionProducers) {
-                                // Track the producer in case it is closed before a commit
-                                Pointer<SessionState> sessionState = cs->getSessionState(producerId->getParentId());
-                                Pointer<ProducerState> producerState = sessionState->getProducerState(producerId);
-                                producerState->setTransactionState(transactionState);
-                            }
-                        }
-                    }
+                Pointer<TransactionState> transactionState = transactionStateOf(message);
+                if (transactionState != NULL) {
+                    addTransactedMessage(transactionState, Pointer<Command>(message->cloneDataStructure()), message);
                 }
                 return this->impl->TRACKED_RESPONSE_MARKER;
             } else if (trackMessages) {
-                this->impl->messageCache.put(
-                    message->getMessageId(), Pointer<Message>(message->cloneDataStructure()));
+                this->impl->messageCache.add(message);
             }
         }
 
@@ -661,6 +798,45 @@ Pointer<Command> ConnectionStateTracker::processMessage(Message* message) {
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TransactionState> ConnectionStateTracker::transactionStateOf(const Message* message) {
+
+    Pointer<ProducerId> producerId = message->getProducerId();
+    Pointer<ConnectionId> connectionId = producerId->getParentId()->getParentId();
+
+    Pointer<ConnectionState> cs;
+    if (connectionId == NULL || !this->impl->connectionStates.tryGet(connectionId, cs)) {
+        return Pointer<TransactionState>();
+    }
+
+    Pointer<TransactionState> transactionState = cs->getTransactionState(message->getTransactionId());
+    if (transactionState != NULL && trackTransactionProducers) {
+        // Track the producer in case it is closed before a commit, it only needs
+        // doing for the first message the producer sends in the transaction.
+        Pointer<SessionState> sessionState = cs->getSessionState(producerId->getParentId());
+        Pointer<ProducerState> producerState = sessionState->getProducerState(producerId);
+        if (producerState->getTransactionState() != transactionState) {
+            producerState->setTransactionState(transactionState);
+        }
+    }
+
+    return transactionState;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::addTransactedMessage(Pointer<TransactionState> transactionState,
+                                                  Pointer<Command> command, const Message* message) {
+
+    if (this->transactionSpoolSize > 0 && transactionState->getJournal() == NULL &&
+        transactionState->getMemoryUsage() + message->getSize() > this->transactionSpoolSize) {
+
+        transactionState->startJournal(Pointer<TransactionJournal>(
+            new TransactionJournal(this->transactionSpoolDirectory, this->transactionSpoolFileSize)));
+    }
+
+    transactionState->addCommand(command);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Command> ConnectionStateTracker::processBeginTransaction(TransactionInfo* info) {
 
@@ -827,7 +1003,8 @@ Pointer<Command> ConnectionStateTracker::processMessagePull(MessagePull* pull) {
 
     try {
 
-        if (pull != NULL && pull->getDestination() != NULL && pull->getConsumerId() != NULL) {
+        if (pull != NULL && pull->getDestination() != NULL && pull->getConsumerId() != NULL &&
+            this->maxMessagePullCacheSize > 0) {
             std::string id = pull->getDestination()->toString() + "::" + pull->getConsumerId()->toString();
             this->impl->messagePullCache.put(id, Pointer<Command>(pull->cloneDataStructure()));
         }
@@ -850,15 +1027,13 @@ void ConnectionStateTracker::connectionInterruptProcessingComplete(transport::Tr
 
         StlMap<Pointer<ConsumerId>, Pointer<ConsumerInfo>, ConsumerId::COMPARATOR> stalledConsumers = connectionState->getRecoveringPullConsumers();
 
-        Pointer<Iterator<Pointer<ConsumerId> > > key(stalledConsumers.keySet().iterator());
-        while (key->hasNext()) {
+        StlMap<Pointer<ConsumerId>, Pointer<ConsumerInfo>, ConsumerId::COMPARATOR>::const_iterator stalled = stalledConsumers.begin();
+        for (; stalled != stalledConsumers.end(); ++stalled) {
             Pointer<ConsumerControl> control(new ConsumerControl());
 
-            Pointer<ConsumerId> theKey = key->next();
-
-            control->setConsumerId(theKey);
-            control->setPrefetch(stalledConsumers.get(theKey)->getPrefetchSize());
-            control->setDestination(stalledConsumers.get(theKey)->getDestination());
+            control->setConsumerId(stalled.getKey());
+            control->setPrefetch(stalled.getValue()->getPrefetchSize());
+            control->setDestination(stalled.getValue()->getDestination());
 
             try {
                 transport->oneway(control);
@@ -870,6 +1045,36 @@ void ConnectionStateTracker::connectionInterruptProcessingComplete(transport::Tr
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTracker::setMaxMessagePullCacheSize(int maxMessagePullCacheSize) {
+
+    this->maxMessagePullCacheSize = maxMessagePullCacheSize;
+
+    if (maxMessagePullCacheSize > 0) {
+        this->impl->messagePullCache.setMaxCacheSize(maxMessagePullCacheSize);
+    } else {
+        this->impl->messagePullCache.clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ConnectionStateTracker::getMemoryUsage() const {
+
+    long long transactions = 0;
+    Pointer<Iterator<Pointer<ConnectionState> > > connection(this->impl->connectionStates.values().iterator());
+    while (connection->hasNext()) {
+        Pointer<Iterator<Pointer<TransactionState> > > transaction(
+            connection->next()->getTransactionStates().iterator());
+        while (transaction->hasNext()) {
+            transactions += transaction->next()->getMemoryUsage();
+        }
+    }
+
+    // The pull cache holds at most getMaxMessagePullCacheSize() small commands.
+    return this->impl->messageCache.getMemoryUsage() + transactions +
+           (long long) this->impl->messagePullCache.size() * (long long) sizeof(MessagePull);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ConnectionStateTracker::transportInterrupted() {
 
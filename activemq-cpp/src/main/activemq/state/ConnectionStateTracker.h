@@ -32,6 +32,8 @@
 
 #include <decaf/lang/Pointer.h>
 
+#include <string>
+
 namespace activemq {
 namespace state {
 
@@ -52,6 +54,9 @@ namespace state {
         bool trackTransactionProducers;
         int maxMessageCacheSize;
         int maxMessagePullCacheSize;
+        long long transactionSpoolSize;
+        std::string transactionSpoolDirectory;
+        long long transactionSpoolFileSize;
 
         friend class RemoveTransactionAction;
 
@@ -72,6 +77,12 @@ namespace state {
 
         void transportInterrupted();
 
+        /**
+         * @return the bytes held by the caches of sent messages and message pulls, and
+         *         the messages of open transactions held in memory, kept for replay.
+         */
+        long long getMemoryUsage() const;
+
         virtual decaf::lang::Pointer<Command> processDestinationInfo(DestinationInfo* info);
 
         virtual decaf::lang::Pointer<Command> processRemoveDestination(DestinationInfo* info);
@@ -168,9 +179,7 @@ namespace state {
             return this->maxMessagePullCacheSize;
         }
 
-        void setMaxMessagePullCacheSize(int maxMessagePullCacheSize) {
-            this->maxMessagePullCacheSize = maxMessagePullCacheSize;
-        }
+        void setMaxMessagePullCacheSize(int maxMessagePullCacheSize);
 
         bool isTrackTransactionProducers() const {
             return this->trackTransactionProducers;
@@ -180,8 +189,67 @@ namespace state {
             this->trackTransactionProducers = trackTransactionProducers;
         }
 
+        long long getTransactionSpoolSize() const {
+            return this->transactionSpoolSize;
+        }
+
+        /**
+         * Sets the bytes of messages a tracked transaction holds in memory for replay.
+         * The messages sent in the transaction after it passes the limit are written to a
+         * TransactionJournal of memory mapped temporary files instead, so a transaction
+         * that sends many messages no longer keeps them all on the heap until it ends.
+         * A send fails if the journal's file can't be created.  Zero or less, the
+         * default, holds every message in memory.
+         *
+         * @param transactionSpoolSize
+         *      The bytes held in memory for each transaction.
+         */
+        void setTransactionSpoolSize(long long transactionSpoolSize) {
+            this->transactionSpoolSize = transactionSpoolSize;
+        }
+
+        const std::string& getTransactionSpoolDirectory() const {
+            return this->transactionSpoolDirectory;
+        }
+
+        /**
+         * @param transactionSpoolDirectory
+         *      The directory the transaction journals are created in, empty for the
+         *      system's temporary directory.
+         */
+        void setTransactionSpoolDirectory(const std::string& transactionSpoolDirectory) {
+            this->transactionSpoolDirectory = transactionSpoolDirectory;
+        }
+
+        long long getTransactionSpoolFileSize() const {
+            return this->transactionSpoolFileSize;
+        }
+
+        /**
+         * @param transactionSpoolFileSize
+         *      The size in bytes of each file of a transaction journal.
+         */
+        void setTransactionSpoolFileSize(long long transactionSpoolFileSize) {
+            this->transactionSpoolFileSize = transactionSpoolFileSize;
+        }
+
     private:
 
+        /**
+         * Finds the state of the transaction a message is sent in and, when transaction
+         * producers are tracked, links the sending producer to it.
+         *
+         * @return the TransactionState or NULL if the transaction isn't being tracked.
+         */
+        decaf::lang::Pointer<TransactionState> transactionStateOf(const Message* message);
+
+        /**
+         * Adds a message sent in a transaction to its state, starting the transaction's
+         * journal first if the message takes it past the spool size.
+         */
+        void addTransactedMessage(decaf::lang::Pointer<TransactionState> transactionState,
+                                  decaf::lang::Pointer<Command> command, const Message* message);
+
         void doRestoreTransactions(decaf::lang::Pointer<transport::Transport> transport,
                                    decaf::lang::Pointer<ConnectionState> connectionState);
 
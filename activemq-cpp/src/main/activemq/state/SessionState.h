@@ -26,7 +26,9 @@
 #include <activemq/state/ProducerState.h>
 
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
-#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
 
 #include <string>
 
@@ -34,7 +36,9 @@ namespace activemq {
 namespace state {
 
     using decaf::lang::Pointer;
-    using decaf::util::concurrent::ConcurrentStlMap;
+    using decaf::lang::PointerEquals;
+    using decaf::util::HashCode;
+    using decaf::util::concurrent::ConcurrentHashMap;
     using decaf::util::concurrent::atomic::AtomicBoolean;
     using namespace activemq::commands;
 
@@ -43,13 +47,15 @@ namespace state {
 
         Pointer<SessionInfo> info;
 
-        ConcurrentStlMap<Pointer<ProducerId>,
-                         Pointer<ProducerState>,
-                         ProducerId::COMPARATOR> producers;
+        ConcurrentHashMap<Pointer<ProducerId>,
+                          Pointer<ProducerState>,
+                          HashCode< Pointer<ProducerId> >,
+                          PointerEquals<ProducerId> > producers;
 
-        ConcurrentStlMap<Pointer<ConsumerId>,
-                         Pointer<ConsumerState>,
-                         ConsumerId::COMPARATOR> consumers;
+        ConcurrentHashMap<Pointer<ConsumerId>,
+                          Pointer<ConsumerState>,
+                          HashCode< Pointer<ConsumerId> >,
+                          PointerEquals<ConsumerId> > consumers;
 
         AtomicBoolean disposed;
 
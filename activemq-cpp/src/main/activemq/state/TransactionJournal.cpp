@@ -0,0 +1,315 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TransactionJournal.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/Properties.h>
+#include <decaf/util/UUID.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::state;
+using namespace activemq::wireformat::openwire;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+const long long TransactionJournal::DEFAULT_FILE_SIZE = 64 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int LENGTH_SIZE = 4;
+
+    void putInt(unsigned char* buffer, int value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            *buffer++ = (unsigned char) (value >> shift);
+        }
+    }
+
+    int getInt(const unsigned char* buffer) {
+        int value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value = (value << 8) | buffer[i];
+        }
+        return value;
+    }
+
+    std::string temporaryDirectory() {
+
+        const char* names[] = { "TMPDIR", "TEMP", "TMP" };
+        for (std::size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+            try {
+                std::string value = System::getenv(names[i]);
+                if (!value.empty()) {
+                    return value;
+                }
+            } catch (Exception& ex) {
+            }
+        }
+
+#ifdef _WIN32
+        return ".";
+#else
+        return "/tmp";
+#endif
+    }
+
+    // Copies a marshaled frame into its place in a file.
+    class FrameWriter : public decaf::io::OutputStream {
+    private:
+
+        FrameWriter(const FrameWriter&);
+        FrameWriter& operator= (const FrameWriter&);
+
+    private:
+
+        unsigned char* position;
+
+    public:
+
+        FrameWriter(unsigned char* position) : OutputStream(), position(position) {}
+
+        virtual ~FrameWriter() {}
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value) {
+            *position++ = value;
+        }
+
+        virtual void doWriteArrayBounded(const unsigned char* buffer, int size AMQCPP_UNUSED, int offset, int length) {
+            std::memcpy(position, buffer + offset, (std::size_t) length);
+            position += length;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace state {
+
+    class TransactionJournalImpl {
+    private:
+
+        TransactionJournalImpl(const TransactionJournalImpl&);
+        TransactionJournalImpl& operator= (const TransactionJournalImpl&);
+
+    public:
+
+        std::string directory;
+        long long fileSize;
+        std::string prefix;
+
+        // The files in the order they were created, frames are only written to the last.
+        std::vector<MappedFile*> files;
+        std::vector<std::string> fileNames;
+        long long position;
+        int count;
+        long long journalSize;
+
+        OpenWireFormat wireFormat;
+        ByteArrayOutputStream buffer;
+        DataOutputStream bufferOut;
+
+        TransactionJournalImpl(const std::string& directory, long long fileSize) :
+            directory(directory.empty() ? temporaryDirectory() : directory), fileSize(fileSize),
+            prefix("amq-tx-" + UUID::randomUUID().toString()), files(), fileNames(), position(0),
+            count(0), journalSize(0), wireFormat(decaf::util::Properties()), buffer(), bufferOut(&buffer) {
+
+            wireFormat.setCacheEnabled(false);
+            wireFormat.setTightEncodingEnabled(false);
+            wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+        }
+
+        ~TransactionJournalImpl() {
+            try {
+                clear();
+            }
+            AMQ_CATCHALL_NOTHROW()
+        }
+
+        // Creates the next file, large enough for at least the given number of bytes.
+        void createFile(long long needed) {
+
+            std::string name = this->directory + "/" + this->prefix + "-" +
+                               Long::toString((long long) this->files.size()) + ".journal";
+
+            // The name is kept before the file is created so that clear removes it even
+            // if mapping it fails part way.
+            this->fileNames.push_back(name);
+            this->files.push_back(new MappedFile(name, needed > this->fileSize ? needed : this->fileSize));
+            this->position = 0;
+        }
+
+        void clear() {
+
+            std::vector<MappedFile*>::iterator file = this->files.begin();
+            for (; file != this->files.end(); ++file) {
+                delete *file;
+            }
+
+            std::vector<std::string>::const_iterator name = this->fileNames.begin();
+            for (; name != this->fileNames.end(); ++name) {
+                std::remove(name->c_str());
+            }
+
+            this->files.clear();
+            this->fileNames.clear();
+            this->position = 0;
+            this->count = 0;
+            this->journalSize = 0;
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+TransactionJournal::TransactionJournal(const std::string& directory, long long fileSize) : impl(NULL) {
+
+    if (fileSize <= LENGTH_SIZE) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Transaction journal file size is too small: %lld", fileSize);
+    }
+
+    this->impl = new TransactionJournalImpl(directory, fileSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransactionJournal::~TransactionJournal() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TransactionJournal::append(Command* command) {
+
+    try {
+
+        this->impl->buffer.reset();
+        this->impl->wireFormat.looseMarshalNestedObject(command, &this->impl->bufferOut);
+        this->impl->bufferOut.flush();
+
+        long long length = this->impl->buffer.size();
+        long long needed = LENGTH_SIZE + length;
+
+        // A file is zero filled, a length of zero where the next frame would start marks
+        // the end of the frames it holds.
+        if (this->impl->files.empty() || this->impl->files.back()->getSize() - this->impl->position < needed) {
+            this->impl->createFile(needed);
+        }
+
+        unsigned char* start = this->impl->files.back()->getAddress() + this->impl->position;
+        putInt(start, (int) length);
+        FrameWriter writer(start + LENGTH_SIZE);
+        this->impl->buffer.writeTo(&writer);
+
+        this->impl->position += needed;
+        this->impl->journalSize += needed;
+        this->impl->count++;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TransactionJournal::replay(Pointer<transport::Transport> transport) const {
+
+    try {
+
+        const OpenWireFormat* target = dynamic_cast<const OpenWireFormat*>(transport->getWireFormat().get());
+        bool preMarshaled = target != NULL && !target->isCacheEnabled() &&
+                            !target->isTightEncodingEnabled() && target->getVersion() == this->impl->wireFormat.getVersion();
+
+        // Only one command is decoded at a time, however many the journal holds.
+        std::vector<MappedFile*>::const_iterator file = this->impl->files.begin();
+        for (; file != this->impl->files.end(); ++file) {
+
+            const unsigned char* address = (*file)->getAddress();
+            long long size = (*file)->getSize();
+            long long position = 0;
+
+            while (size - position >= LENGTH_SIZE) {
+
+                int length = getInt(address + position);
+                if (length <= 0) {
+                    break;
+                }
+
+                const unsigned char* frame = address + position + LENGTH_SIZE;
+                position += LENGTH_SIZE + length;
+
+                if (preMarshaled) {
+                    // Past the leading not null marker the nested form is the frame.
+                    transport->oneway(Pointer<Command>(new MarshaledCommand(
+                        frame + 1, length - 1, this->impl->wireFormat.getVersion())));
+                } else {
+                    ByteArrayInputStream bytes(frame, length);
+                    DataInputStream bytesIn(&bytes);
+                    transport->oneway(Pointer<Command>(
+                        dynamic_cast<Command*>(this->impl->wireFormat.looseUnmarshalNestedObject(&bytesIn))));
+                }
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TransactionJournal::size() const {
+    return this->impl->count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TransactionJournal::getJournalSize() const {
+    return this->impl->journalSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> TransactionJournal::getFileNames() const {
+    return this->impl->fileNames;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TransactionJournal::clear() {
+    this->impl->clear();
+}
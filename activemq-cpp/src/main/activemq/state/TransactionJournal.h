@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_STATE_TRANSACTIONJOURNAL_H_
+#define _ACTIVEMQ_STATE_TRANSACTIONJOURNAL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+#include <activemq/transport/Transport.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace state {
+
+    class TransactionJournalImpl;
+
+    /**
+     * Holds the commands of a transaction that are kept for replay after a failover in
+     * memory mapped temporary files rather than on the heap.  Each command is encoded
+     * with a private wire format that has caching disabled, as the state tracker's
+     * message cache does, and copied into the current file as a four byte big endian
+     * length followed by the frame.  A file that has no room for the next frame is left
+     * behind and a new one of the same size is created, or a larger one if the frame
+     * alone would not fit, so the journal grows with the transaction while only the
+     * pages being written need to stay resident.  The files are removed when the
+     * journal is destroyed.
+     *
+     * The journal is not thread safe, the ConnectionStateTracker uses it from the
+     * thread that tracks the commands of the transaction.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API TransactionJournal {
+    public:
+
+        /**
+         * Default size in bytes of each of the journal's files.
+         */
+        static const long long DEFAULT_FILE_SIZE;
+
+    private:
+
+        TransactionJournalImpl* impl;
+
+    private:
+
+        TransactionJournal(const TransactionJournal&);
+        TransactionJournal& operator= (const TransactionJournal&);
+
+    public:
+
+        /**
+         * Creates a journal whose files are created in the given directory as they are
+         * needed, nothing is created until the first command is appended.
+         *
+         * @param directory
+         *      The directory to hold the files, empty for the system's temporary directory.
+         * @param fileSize
+         *      The size in bytes of each file.
+         *
+         * @throws IllegalArgumentException if the file size is not positive.
+         */
+        TransactionJournal(const std::string& directory, long long fileSize = DEFAULT_FILE_SIZE);
+
+        virtual ~TransactionJournal();
+
+        /**
+         * Encodes the command and appends it after the ones already held.
+         *
+         * @param command
+         *      The command to append.
+         *
+         * @throws IOException if a file can't be created or mapped.
+         */
+        void append(commands::Command* command);
+
+        /**
+         * Sends the commands held, in the order they were appended, on the given
+         * Transport.  When the transport's wire format encodes the way the journal does
+         * the frames are sent as they are, otherwise each is decoded so that the
+         * transport can encode it again.
+         *
+         * @param transport
+         *      The transport to send the commands on.
+         *
+         * @throws IOException if a command can't be sent.
+         */
+        void replay(decaf::lang::Pointer<transport::Transport> transport) const;
+
+        /**
+         * @return the number of commands held.
+         */
+        int size() const;
+
+        /**
+         * @return the bytes the frames of the commands held take up in the files.
+         */
+        long long getJournalSize() const;
+
+        /**
+         * @return the names of the files created so far, in the order they were created.
+         */
+        std::vector<std::string> getFileNames() const;
+
+        /**
+         * Unmaps and removes the files, after this the journal is empty.
+         */
+        void clear();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_STATE_TRANSACTIONJOURNAL_H_ */
@@ -18,6 +18,7 @@
 #include "TransactionState.h"
 
 #include <activemq/state/ProducerState.h>
+#include <activemq/commands/Message.h>
 
 #include <decaf/lang/exceptions/IllegalStateException.h>
 
@@ -30,7 +31,8 @@ using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
 TransactionState::TransactionState(Pointer<TransactionId> id) :
-    commands(), id(id), disposed(false), prepared(false), preparedResult(0), producers() {
+    commands(), memoryUsage(0), journal(), journalIndex(0), id(id), disposed(false), prepared(false),
+    preparedResult(0), producers() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -61,14 +63,54 @@ void TransactionState::shutdown() {
 void TransactionState::clear() {
     this->commands.clear();
     this->producers.clear();
+    this->memoryUsage = 0;
+    this->journal.reset(NULL);
+    this->journalIndex = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void TransactionState::addCommand(Pointer<Command> operation) {
     checkShutdown();
+
+    if (operation->isMessage()) {
+        if (this->journal != NULL) {
+            this->journal->append(operation.get());
+            return;
+        }
+
+        const Message* message = dynamic_cast<const Message*>(operation.get());
+        if (message != NULL) {
+            this->memoryUsage += message->getSize();
+        }
+    }
+
     commands.add(operation);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TransactionState::startJournal(Pointer<TransactionJournal> journal) {
+    checkShutdown();
+    this->journal = journal;
+    this->journalIndex = this->commands.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TransactionState::replay(Pointer<transport::Transport> transport) const {
+
+    int index = 0;
+    LinkedList<Pointer<Command> >::const_iterator command = this->commands.begin();
+    for (; command != this->commands.end(); ++command, ++index) {
+        if (index == this->journalIndex && this->journal != NULL) {
+            this->journal->replay(transport);
+        }
+        transport->oneway(*command);
+    }
+
+    if (index == this->journalIndex && this->journal != NULL) {
+        this->journal->replay(transport);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TransactionState::checkShutdown() const {
     if (this->disposed.get()) {
@@ -22,11 +22,14 @@
 #include <activemq/commands/Command.h>
 #include <activemq/commands/ProducerId.h>
 #include <activemq/commands/TransactionId.h>
+#include <activemq/state/TransactionJournal.h>
+#include <activemq/transport/Transport.h>
 
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
-#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
 
 #include <string>
 #include <memory>
@@ -37,7 +40,9 @@ namespace state {
     using decaf::lang::Pointer;
     using decaf::util::LinkedList;
     using decaf::util::concurrent::atomic::AtomicBoolean;
-    using decaf::util::concurrent::ConcurrentStlMap;
+    using decaf::lang::PointerEquals;
+    using decaf::util::HashCode;
+    using decaf::util::concurrent::ConcurrentHashMap;
     using namespace activemq::commands;
 
     class ProducerState;
@@ -46,12 +51,18 @@ namespace state {
     private:
 
         LinkedList< Pointer<Command> > commands;
+        long long memoryUsage;
+        // Once the journal is started the messages go to it.  The commands that end a
+        // transaction come after all of its messages so the journal replays as one run
+        // ahead of the command at journalIndex.
+        Pointer<TransactionJournal> journal;
+        int journalIndex;
         Pointer<TransactionId> id;
         AtomicBoolean disposed;
         bool prepared;
         int preparedResult;
-        ConcurrentStlMap<Pointer<ProducerId>, Pointer<ProducerState>,
-                         ProducerId::COMPARATOR> producers;
+        ConcurrentHashMap<Pointer<ProducerId>, Pointer<ProducerState>,
+                          HashCode< Pointer<ProducerId> >, PointerEquals<ProducerId> > producers;
 
     private:
 
@@ -78,6 +89,38 @@ namespace state {
             return commands;
         }
 
+        /**
+         * @return the bytes of the messages of this transaction held in memory for replay.
+         */
+        long long getMemoryUsage() const {
+            return this->memoryUsage;
+        }
+
+        /**
+         * Sends the messages added from now on to the given journal instead of holding
+         * them in memory, the transaction commands are still held in memory.
+         *
+         * @param journal
+         *      The journal to hold the messages.
+         */
+        void startJournal(Pointer<TransactionJournal> journal);
+
+        /**
+         * @return the journal holding the messages added since it was started, or NULL.
+         */
+        Pointer<TransactionJournal> getJournal() const {
+            return this->journal;
+        }
+
+        /**
+         * Sends the commands of this transaction, in the order they were added, on the
+         * given Transport.
+         *
+         * @param transport
+         *      The transport to send the commands on.
+         */
+        void replay(Pointer<transport::Transport> transport) const;
+
         const Pointer<TransactionId> getId() const {
             return id;
         }
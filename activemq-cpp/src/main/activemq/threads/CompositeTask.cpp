@@ -20,6 +20,9 @@
 using namespace activemq;
 using namespace activemq::threads;
 
+////////////////////////////////////////////////////////////////////////////////
+CompositeTask::CompositeTask() : Task(), ready(0), nextReady(NULL) {}
+
 ////////////////////////////////////////////////////////////////////////////////
 CompositeTask::~CompositeTask() {}
 
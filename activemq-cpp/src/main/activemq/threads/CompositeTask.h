@@ -24,15 +24,34 @@
 namespace activemq {
 namespace threads {
 
+    class CompositeTaskRunner;
+    class CompositeTaskRunnerImpl;
+
     /**
      * Represents a single task that can be part of a set of Tasks that are contained
      * in a <code>CompositeTaskRunner</code>.
      *
+     * A task that has work is handed to its runner with CompositeTaskRunner::wakeup(task),
+     * the runner only checks the tasks that were woken that way so a task that has nothing
+     * to do costs it nothing.
+     *
      * @since 3.0
      */
     class AMQCPP_API CompositeTask : public activemq::threads::Task {
+    private:
+
+        // Set while the task is queued to run, only the wakeup that sets it queues the
+        // task.  The link chains the task on its runner's list of woken tasks.
+        volatile int ready;
+        CompositeTask* volatile nextReady;
+
+        friend class CompositeTaskRunner;
+        friend class CompositeTaskRunnerImpl;
+
     public:
 
+        CompositeTask();
+
         virtual ~CompositeTask();
 
         /**
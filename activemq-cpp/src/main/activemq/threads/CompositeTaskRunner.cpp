@@ -18,8 +18,11 @@
 #include "CompositeTaskRunner.h"
 
 #include <memory>
+#include <deque>
+#include <set>
 
 #include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace std;
 using namespace activemq;
@@ -29,6 +32,7 @@ using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
@@ -42,7 +46,20 @@ namespace threads {
 
     public:
 
-        decaf::util::LinkedList<CompositeTask*> tasks;
+        // Guards the registered tasks and the run queue, held by the runner thread
+        // while it iterates a task so that a removed task is never run afterwards.
+        decaf::util::concurrent::Mutex tasksLock;
+        std::set<CompositeTask*> tasks;
+        std::deque<CompositeTask*> runQueue;
+
+        // Tasks woken since the runner last looked, pushed without a lock and taken
+        // all at once by the runner so the stack never sees a concurrent pop.
+        volatile void* wokenTasks;
+
+        // Set by the untargeted wakeup, the runner then queues every task itself
+        // rather than the waking thread taking the tasks lock.
+        volatile int wakeAll;
+
         mutable decaf::util::concurrent::Mutex mutex;
 
         decaf::lang::Pointer<decaf::lang::Thread> thread;
@@ -53,7 +70,11 @@ namespace threads {
 
     public:
 
-        CompositeTaskRunnerImpl() : tasks(),
+        CompositeTaskRunnerImpl() : tasksLock(),
+                                    tasks(),
+                                    runQueue(),
+                                    wokenTasks(NULL),
+                                    wakeAll(0),
                                     mutex(),
                                     thread(),
                                     threadTerminated(false),
@@ -61,6 +82,77 @@ namespace threads {
                                     shutdown(false) {
         }
 
+        /**
+         * Pushes the task on the woken stack unless it is already queued.
+         *
+         * @return true if the task was pushed.
+         */
+        bool pushWoken(CompositeTask* task) {
+
+            if (!Atomics::compareAndSet32(&task->ready, 0, 1)) {
+                return false;
+            }
+
+            void* head = NULL;
+            do {
+                head = Atomics::getAcquire(&wokenTasks);
+                task->nextReady = static_cast<CompositeTask*>(head);
+            } while (!Atomics::compareAndSet(&wokenTasks, head, task));
+
+            return true;
+        }
+
+        /**
+         * Moves the woken tasks onto the run queue in the order they were woken, must
+         * be called with the tasks lock held.
+         */
+        void collectWoken() {
+
+            if (Atomics::getAndSet(&wakeAll, 0) != 0) {
+                std::set<CompositeTask*>::const_iterator iter = tasks.begin();
+                for (; iter != tasks.end(); ++iter) {
+                    if (Atomics::compareAndSet32(&(*iter)->ready, 0, 1)) {
+                        runQueue.push_back(*iter);
+                    }
+                }
+            }
+
+            CompositeTask* woken = static_cast<CompositeTask*>(Atomics::getAndSet(&wokenTasks, NULL));
+            if (woken == NULL) {
+                return;
+            }
+
+            // The stack holds the last woken first.
+            std::deque<CompositeTask*>::size_type end = runQueue.size();
+            while (woken != NULL) {
+                CompositeTask* next = woken->nextReady;
+                woken->nextReady = NULL;
+                if (tasks.find(woken) != tasks.end()) {
+                    runQueue.insert(runQueue.begin() + end, woken);
+                }
+                woken = next;
+            }
+        }
+
+        /**
+         * Takes the next task off the run queue and clears its ready flag so that a
+         * wakeup from here on queues it again, must be called with the tasks lock held.
+         *
+         * @return the next task or NULL if none are queued.
+         */
+        CompositeTask* nextTask() {
+
+            if (runQueue.empty()) {
+                return NULL;
+            }
+
+            CompositeTask* task = runQueue.front();
+            runQueue.pop_front();
+            Atomics::getAndSet(&task->ready, 0);
+
+            return task;
+        }
+
     };
 
 }}
@@ -145,6 +237,26 @@ void CompositeTaskRunner::shutdown() {
 ////////////////////////////////////////////////////////////////////////////////
 void CompositeTaskRunner::wakeup() {
 
+    Atomics::getAndSet(&impl->wakeAll, 1);
+
+    synchronized(&impl->mutex) {
+        if (impl->shutdown) {
+            return;
+        }
+        impl->pending = true;
+        impl->mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompositeTaskRunner::wakeup(CompositeTask* task) {
+
+    // Only the wakeup that queues the task needs to signal the runner, the others
+    // find it queued already.
+    if (task == NULL || !impl->pushWoken(task)) {
+        return;
+    }
+
     synchronized(&impl->mutex) {
         if (impl->shutdown) {
             return;
@@ -194,9 +306,18 @@ void CompositeTaskRunner::run() {
 void CompositeTaskRunner::addTask(CompositeTask* task) {
 
     if (task != NULL) {
-        synchronized(&impl->tasks) {
-            impl->tasks.add(task);
-            wakeup();
+        synchronized(&impl->tasksLock) {
+            if (impl->tasks.insert(task).second) {
+                // Checked once so that work it had before being added isn't missed.
+                Atomics::getAndSet(&task->ready, 1);
+                task->nextReady = NULL;
+                impl->runQueue.push_back(task);
+            }
+        }
+
+        synchronized(&impl->mutex) {
+            impl->pending = true;
+            impl->mutex.notifyAll();
         }
     }
 }
@@ -205,9 +326,21 @@ void CompositeTaskRunner::addTask(CompositeTask* task) {
 void CompositeTaskRunner::removeTask(CompositeTask* task) {
 
     if (task != NULL) {
-        synchronized(&impl->tasks) {
-            impl->tasks.remove(task);
-            wakeup();
+        synchronized(&impl->tasksLock) {
+            impl->collectWoken();
+            if (impl->tasks.erase(task) > 0) {
+                std::deque<CompositeTask*>::iterator iter = impl->runQueue.begin();
+                while (iter != impl->runQueue.end()) {
+                    if (*iter == task) {
+                        iter = impl->runQueue.erase(iter);
+                    } else {
+                        ++iter;
+                    }
+                }
+
+                // Left set so that a stray wakeup doesn't queue a task that is gone.
+                Atomics::getAndSet(&task->ready, 1);
+            }
         }
     }
 }
@@ -215,20 +348,25 @@ void CompositeTaskRunner::removeTask(CompositeTask* task) {
 ////////////////////////////////////////////////////////////////////////////////
 bool CompositeTaskRunner::iterate() {
 
-    synchronized(&impl->tasks) {
+    synchronized(&impl->tasksLock) {
 
-        for (int i = 0; i < impl->tasks.size(); ++i) {
-            CompositeTask* task = impl->tasks.pop();
+        impl->collectWoken();
+
+        CompositeTask* task = NULL;
+        while ((task = impl->nextTask()) != NULL) {
 
             if (task->isPending()) {
                 task->iterate();
-                impl->tasks.addLast(task);
+
+                // A task with more to do goes behind the others, unless it was woken
+                // while it ran in which case it is queued already.
+                if (task->isPending() && Atomics::compareAndSet32(&task->ready, 0, 1)) {
+                    impl->runQueue.push_back(task);
+                }
 
                 // Always return true, so that we check again for any of
                 // the other tasks that might now be pending.
                 return true;
-            } else {
-                impl->tasks.addLast(task);
             }
         }
     }
@@ -34,8 +34,10 @@ namespace threads {
     class CompositeTaskRunnerImpl;
 
     /**
-     * A Task Runner that can contain one or more CompositeTasks that are each checked
-     * for pending work and run if any is present in the order that the tasks were added.
+     * A Task Runner that can contain one or more CompositeTasks and runs those that have
+     * pending work.  Tasks are queued to run by waking them, a woken task is checked for
+     * pending work and iterated once, then queued behind the other woken tasks for as long
+     * as it still has work, so the runner never looks at a task that wasn't woken.
      *
      * @since 3.0
      */
@@ -87,12 +89,23 @@ namespace threads {
         virtual void shutdown();
 
         /**
-         * Signal the TaskRunner to wakeup and execute another iteration cycle on
-         * the task, the Task instance will be run until its iterate method has
-         * returned false indicating it is done.
+         * Signal the TaskRunner to wakeup and check every one of its tasks for pending
+         * work, this costs the runner a look at each task.  A caller that knows which
+         * task has work should wake that task instead.
          */
         virtual void wakeup();
 
+        /**
+         * Queues the given task to be checked for pending work and run, waking the
+         * runner if needed.  Waking a task that is already queued does nothing more.
+         * The task must have been added to this runner and not be woken while it is
+         * being removed.
+         *
+         * @param task
+         *      The task that has work.
+         */
+        void wakeup(CompositeTask* task);
+
     protected:
 
         virtual void run();
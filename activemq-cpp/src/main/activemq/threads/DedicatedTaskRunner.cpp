@@ -27,14 +27,12 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-DedicatedTaskRunner::DedicatedTaskRunner(Task* task) :
-    mutex(), thread(), threadTerminated(false), pending(false), shutDown(false), task(task) {
+DedicatedTaskRunner::DedicatedTaskRunner(Task* task, const std::vector<int>& affinity) :
+    mutex(), thread(), threadTerminated(false), pending(false), shutDown(false), task(task), affinity(affinity) {
 
     if (this->task == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "Task passed was null");
     }
-
-    this->thread.reset(new Thread(this, "ActiveMQ Dedicated Task Runner"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,7 +47,12 @@ DedicatedTaskRunner::~DedicatedTaskRunner() {
 void DedicatedTaskRunner::start() {
 
     synchronized(&mutex) {
-        if (!shutDown && !this->thread->isAlive()) {
+        // The thread is created here so that runners that are never started don't hold one.
+        if (!shutDown && this->thread == NULL) {
+            this->thread.reset(new Thread(this, "ActiveMQ Dedicated Task Runner"));
+            if (!affinity.empty()) {
+                this->thread->setAffinity(affinity);
+            }
             this->thread->start();
             this->wakeup();
         }
@@ -76,6 +79,7 @@ void DedicatedTaskRunner::shutdown(long long timeout) {
     synchronized(&mutex) {
 
         if (this->thread == NULL) {
+            shutDown = true;
             return;
         }
 
@@ -97,6 +101,7 @@ void DedicatedTaskRunner::shutdown() {
     synchronized(&mutex) {
 
         if (this->thread == NULL) {
+            shutDown = true;
             return;
         }
 
@@ -27,6 +27,8 @@
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/lang/Pointer.h>
 
+#include <vector>
+
 namespace activemq {
 namespace threads {
 
@@ -41,6 +43,7 @@ namespace threads {
         bool pending;
         bool shutDown;
         Task* task;
+        std::vector<int> affinity;
 
     private:
 
@@ -49,7 +52,19 @@ namespace threads {
 
     public:
 
-        DedicatedTaskRunner(Task* task);
+        /**
+         * Creates a runner with a thread of its own for the given Task, the thread is
+         * only created once the runner is started.
+         *
+         * @param task
+         *      The Task to run, it must outlive this runner.
+         * @param affinity
+         *      The processors the runner's thread is restricted to, empty for any.
+         *
+         * @throws NullPointerException if the Task is NULL.
+         */
+        DedicatedTaskRunner(Task* task, const std::vector<int>& affinity = std::vector<int>());
+
         virtual ~DedicatedTaskRunner();
 
         virtual void start();
@@ -0,0 +1,245 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeyedSerialExecutor.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/threads/Task.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/TaskRunnerPool.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace threads {
+
+    /**
+     * A queue of Runnables that the pool runs as a Task, never on two workers at once.
+     */
+    class SerialLane : public Task {
+    private:
+
+        SerialLane(const SerialLane&);
+        SerialLane& operator= (const SerialLane&);
+
+    private:
+
+        decaf::util::concurrent::Mutex mutex;
+        std::deque<Runnable*> queue;
+
+        // Once set nothing more is queued, the Runnables given are run by the caller.
+        bool closed;
+
+    public:
+
+        Pointer<TaskRunner> runner;
+
+    public:
+
+        SerialLane() : Task(), mutex(), queue(), closed(false), runner() {}
+
+        virtual ~SerialLane() {}
+
+        /**
+         * Queues the Runnable, returns false without queueing it once the lane is closed.
+         */
+        bool offer(Runnable* task) {
+            synchronized(&mutex) {
+                if (closed) {
+                    return false;
+                }
+                queue.push_back(task);
+            }
+            return true;
+        }
+
+        virtual bool iterate() {
+
+            std::vector<Runnable*> batch;
+
+            synchronized(&mutex) {
+                while (!queue.empty() && (int) batch.size() < KeyedSerialExecutor::MAX_BATCH_SIZE) {
+                    batch.push_back(queue.front());
+                    queue.pop_front();
+                }
+            }
+
+            runAll(batch);
+
+            bool more = false;
+            synchronized(&mutex) {
+                more = !queue.empty();
+            }
+            return more;
+        }
+
+        /**
+         * Closes the lane and runs what is left in it on the calling thread.
+         */
+        void drain() {
+
+            std::vector<Runnable*> remaining;
+
+            synchronized(&mutex) {
+                closed = true;
+                remaining.assign(queue.begin(), queue.end());
+                queue.clear();
+            }
+
+            runAll(remaining);
+        }
+
+        static void runAll(const std::vector<Runnable*>& tasks) {
+            std::vector<Runnable*>::const_iterator iter = tasks.begin();
+            for (; iter != tasks.end(); ++iter) {
+                runAndDelete(*iter);
+            }
+        }
+
+        static void runAndDelete(Runnable* task) {
+            try {
+                task->run();
+            }
+            AMQ_CATCHALL_NOTHROW()
+            delete task;
+        }
+
+    };
+
+    class KeyedSerialExecutorImpl {
+    private:
+
+        KeyedSerialExecutorImpl(const KeyedSerialExecutorImpl&);
+        KeyedSerialExecutorImpl& operator= (const KeyedSerialExecutorImpl&);
+
+    public:
+
+        TaskRunnerPool pool;
+        std::vector<SerialLane*> lanes;
+
+    public:
+
+        KeyedSerialExecutorImpl(int poolSize, const std::string& name, const std::vector<int>& affinity) :
+            pool(poolSize, name, affinity), lanes() {
+
+            int count = poolSize * KeyedSerialExecutor::LANES_PER_THREAD;
+            for (int i = 0; i < count; ++i) {
+                SerialLane* lane = new SerialLane();
+                lanes.push_back(lane);
+                lane->runner = pool.createTaskRunner(lane);
+            }
+        }
+
+        ~KeyedSerialExecutorImpl() {
+            std::vector<SerialLane*>::iterator iter = lanes.begin();
+            for (; iter != lanes.end(); ++iter) {
+                (*iter)->runner.reset(NULL);
+                delete *iter;
+            }
+        }
+
+        SerialLane* laneFor(int key) const {
+            return lanes[(unsigned int) key % (unsigned int) lanes.size()];
+        }
+
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+const int KeyedSerialExecutor::LANES_PER_THREAD = 4;
+const int KeyedSerialExecutor::MAX_BATCH_SIZE = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+KeyedSerialExecutor::KeyedSerialExecutor(int poolSize, const std::string& name, const std::vector<int>& affinity) : impl(NULL) {
+
+    if (poolSize < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Pool size must be at least one");
+    }
+
+    this->impl = new KeyedSerialExecutorImpl(poolSize, name, affinity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+KeyedSerialExecutor::~KeyedSerialExecutor() {
+    try {
+        shutdown();
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int KeyedSerialExecutor::getPoolSize() const {
+    return this->impl->pool.getPoolSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int KeyedSerialExecutor::getLaneCount() const {
+    return (int) this->impl->lanes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutor::execute(int key, decaf::lang::Runnable* task) {
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Runnable cannot be NULL");
+    }
+
+    SerialLane* lane = this->impl->laneFor(key);
+    if (!lane->offer(task)) {
+        SerialLane::runAndDelete(task);
+        return;
+    }
+
+    // Starting a runner wakes it, a started runner is only woken.
+    if (lane->runner->isStarted()) {
+        lane->runner->wakeup();
+    } else {
+        lane->runner->start();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutor::shutdown() {
+
+    std::vector<SerialLane*>::iterator iter = this->impl->lanes.begin();
+    for (; iter != this->impl->lanes.end(); ++iter) {
+        (*iter)->runner->shutdown();
+    }
+
+    this->impl->pool.shutdown();
+
+    for (iter = this->impl->lanes.begin(); iter != this->impl->lanes.end(); ++iter) {
+        (*iter)->drain();
+    }
+}
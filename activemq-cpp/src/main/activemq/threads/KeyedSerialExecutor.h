@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_KEYEDSERIALEXECUTOR_H_
+#define _ACTIVEMQ_THREADS_KEYEDSERIALEXECUTOR_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/lang/Runnable.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace threads {
+
+    class KeyedSerialExecutorImpl;
+
+    /**
+     * Runs Runnables on a fixed set of worker threads while keeping the order of those
+     * given with the same key.  Keys are spread over a number of serial lanes, each a
+     * Task on a TaskRunnerPool, a lane runs its Runnables one after the other in the
+     * order they were given and the lanes run in parallel on the pool's workers.  Each
+     * time a lane runs it takes every Runnable queued on it up to a batch at once, so a
+     * burst of work for one key costs one wakeup rather than one per Runnable.
+     *
+     * A slow Runnable only holds up the keys that share its lane.  Every Runnable given
+     * to the executor is run exactly once, those given after shutdown or still queued
+     * when it shuts down are run by the calling thread.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API KeyedSerialExecutor {
+    public:
+
+        /**
+         * The number of lanes the keys are spread over for each worker thread.
+         */
+        static const int LANES_PER_THREAD;
+
+        /**
+         * The most Runnables a lane takes from its queue each time it runs.
+         */
+        static const int MAX_BATCH_SIZE;
+
+    private:
+
+        KeyedSerialExecutorImpl* impl;
+
+    private:
+
+        KeyedSerialExecutor(const KeyedSerialExecutor&);
+        KeyedSerialExecutor& operator=(const KeyedSerialExecutor&);
+
+    public:
+
+        /**
+         * Creates a new executor, the worker threads are started by the first Runnable
+         * it is given.
+         *
+         * @param poolSize
+         *      The number of worker threads.
+         * @param name
+         *      The name the worker threads are given, each gets its index appended.
+         * @param affinity
+         *      The processors the worker threads are restricted to, empty for any.
+         *
+         * @throws IllegalArgumentException if the pool size is less than one.
+         */
+        KeyedSerialExecutor(int poolSize, const std::string& name,
+                            const std::vector<int>& affinity = std::vector<int>());
+
+        virtual ~KeyedSerialExecutor();
+
+        /**
+         * @return the number of worker threads.
+         */
+        int getPoolSize() const;
+
+        /**
+         * @return the number of serial lanes the keys are spread over.
+         */
+        int getLaneCount() const;
+
+        /**
+         * Queues the Runnable to run after every Runnable given earlier with the same
+         * key.  The executor takes ownership of the Runnable and deletes it once run.
+         *
+         * @param key
+         *      The key whose order the Runnable keeps.
+         * @param task
+         *      The Runnable to run.
+         *
+         * @throws NullPointerException if the Runnable is NULL.
+         */
+        void execute(int key, decaf::lang::Runnable* task);
+
+        /**
+         * Stops the worker threads and runs whatever is still queued on the calling
+         * thread, Runnables given after this are run by the thread that gives them.
+         */
+        void shutdown();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_KEYEDSERIALEXECUTOR_H_ */
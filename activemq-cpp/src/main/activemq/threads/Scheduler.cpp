@@ -26,6 +26,7 @@
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
 
 using namespace activemq;
 using namespace activemq::threads;
@@ -34,15 +35,65 @@ using namespace activemq::exceptions;
 using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-Scheduler::Scheduler(const std::string& name) : mutex(), name(name), timer(NULL), tasks() {
+namespace {
+
+    /**
+     * Wraps the tasks placed in a TimingWheel, one shot tasks are not tracked by
+     * the Scheduler so they check that it is still active before running and the
+     * wheel frees them once they expire.
+     */
+    class WheelTask : public Runnable {
+    private:
+
+        Pointer<AtomicBoolean> active;
+        SchedulerTimerTask task;
+
+    private:
+
+        WheelTask(const WheelTask&);
+        WheelTask& operator= (const WheelTask&);
+
+    public:
+
+        WheelTask(const Pointer<AtomicBoolean>& active, Runnable* task, bool ownsTask) :
+            Runnable(), active(active), task(task, ownsTask) {
+        }
+
+        virtual ~WheelTask() {}
+
+        virtual void run() {
+            if (this->active->get()) {
+                this->task.run();
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Scheduler::Scheduler(const std::string& name) :
+    mutex(), name(name), timer(NULL), tasks(), wheel(NULL), timeouts(), active(new AtomicBoolean(true)) {
+
+    if (name.empty()) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Scheduler name must not be empty.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Scheduler::Scheduler(const std::string& name, TimingWheel* wheel) :
+    mutex(), name(name), timer(NULL), tasks(), wheel(wheel), timeouts(), active(new AtomicBoolean(true)) {
 
     if (name.empty()) {
         throw IllegalArgumentException(__FILE__, __LINE__, "Scheduler name must not be empty.");
     }
+
+    if (wheel == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "TimingWheel must not be NULL.");
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +107,8 @@ Scheduler::~Scheduler() {
         this->tasks.clear();
 
         delete this->timer;
+
+        this->cancelTimeouts();
     }
     AMQ_CATCHALL_NOTHROW()
 }
@@ -68,6 +121,12 @@ void Scheduler::executePeriodically(Runnable* task, long long period, bool ownsT
     }
 
     synchronized(&mutex) {
+        if (this->wheel != NULL) {
+            Pointer<Runnable> wheelTask(new WheelTask(this->active, task, ownsTask));
+            this->timeouts.put(task, this->wheel->scheduleAtFixedRate(wheelTask, period, period));
+            return;
+        }
+
         TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
         this->timer->scheduleAtFixedRate(timerTask, period, period);
         this->tasks.put(task, timerTask);
@@ -82,6 +141,12 @@ void Scheduler::schedualPeriodically(Runnable* task, long long period, bool owns
     }
 
     synchronized(&mutex) {
+        if (this->wheel != NULL) {
+            Pointer<Runnable> wheelTask(new WheelTask(this->active, task, ownsTask));
+            this->timeouts.put(task, this->wheel->schedule(wheelTask, period, period));
+            return;
+        }
+
         TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
         this->timer->schedule(timerTask, period, period);
         this->tasks.put(task, timerTask);
@@ -96,6 +161,11 @@ void Scheduler::cancel(Runnable* task) {
     }
 
     synchronized(&mutex) {
+        if (this->wheel != NULL) {
+            this->timeouts.remove(task)->cancel();
+            return;
+        }
+
         TimerTask* ticket = this->tasks.remove(task);
         if (ticket != NULL) {
             ticket->cancel();
@@ -112,6 +182,12 @@ void Scheduler::executeAfterDelay(Runnable* task, long long delay, bool ownsTask
     }
 
     synchronized(&mutex) {
+        if (this->wheel != NULL) {
+            Pointer<Runnable> wheelTask(new WheelTask(this->active, task, ownsTask));
+            this->wheel->schedule(wheelTask, delay);
+            return;
+        }
+
         TimerTask* timerTask = new SchedulerTimerTask(task, ownsTask);
         this->timer->schedule(timerTask, delay);
     }
@@ -122,12 +198,42 @@ void Scheduler::shutdown() {
     if (this->timer != NULL) {
         this->timer->cancel();
     }
+
+    this->cancelTimeouts();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Scheduler::isUsingTimingWheel() const {
+    return this->wheel != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Scheduler::cancelTimeouts() {
+
+    if (this->wheel == NULL) {
+        return;
+    }
+
+    this->active->set(false);
+
+    synchronized(&mutex) {
+        Pointer< Iterator< Pointer<TimingWheel::Timeout> > > iter(this->timeouts.values().iterator());
+        while (iter->hasNext()) {
+            iter->next()->cancel();
+        }
+
+        this->timeouts.clear();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Scheduler::doStart() {
     synchronized(&mutex) {
-        this->timer = new Timer(name);
+        if (this->wheel != NULL) {
+            this->active->set(true);
+        } else {
+            this->timer = new Timer(name);
+        }
     }
 }
 
@@ -138,4 +244,6 @@ void Scheduler::doStop(ServiceStopper* stopper AMQCPP_UNUSED) {
             this->timer->cancel();
         }
     }
+
+    this->cancelTimeouts();
 }
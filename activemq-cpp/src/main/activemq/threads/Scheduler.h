@@ -20,11 +20,13 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/util/ServiceSupport.h>
+#include <activemq/threads/TimingWheel.h>
 
 #include <decaf/lang/Runnable.h>
 #include <decaf/util/Timer.h>
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 
 #include <string>
 
@@ -35,6 +37,11 @@ namespace threads {
      * Scheduler class for use in executing Runnable Tasks either periodically or
      * one time only with optional delay.
      *
+     * By default each Scheduler runs its tasks from its own decaf::util::Timer, it can
+     * instead be given a TimingWheel, in which case the tasks are placed in the wheel
+     * and the Scheduler creates no thread of its own.  This allows many Schedulers to
+     * share one wheel at the cost of the wheel's tick resolution.
+     *
      * @since 3.3.0
      */
     class AMQCPP_API Scheduler : public activemq::util::ServiceSupport {
@@ -44,6 +51,9 @@ namespace threads {
         std::string name;
         decaf::util::Timer* timer;
         decaf::util::StlMap<decaf::lang::Runnable*, decaf::util::TimerTask*> tasks;
+        TimingWheel* wheel;
+        decaf::util::StlMap<decaf::lang::Runnable*, decaf::lang::Pointer<TimingWheel::Timeout> > timeouts;
+        decaf::lang::Pointer<decaf::util::concurrent::atomic::AtomicBoolean> active;
 
     private:
 
@@ -54,6 +64,19 @@ namespace threads {
 
         Scheduler(const std::string& name);
 
+        /**
+         * Creates a Scheduler whose tasks are run by the given TimingWheel.
+         *
+         * @param name
+         *      The name of this Scheduler.
+         * @param wheel
+         *      The TimingWheel to schedule onto, which must outlive this Scheduler.
+         *
+         * @throws IllegalArgumentException if the name is empty.
+         * @throws NullPointerException if the wheel is NULL.
+         */
+        Scheduler(const std::string& name, TimingWheel* wheel);
+
         virtual ~Scheduler();
 
     public:
@@ -68,6 +91,15 @@ namespace threads {
 
         void shutdown();
 
+        /**
+         * @return true if this Scheduler runs its tasks on a TimingWheel.
+         */
+        bool isUsingTimingWheel() const;
+
+    private:
+
+        void cancelTimeouts();
+
     protected:
 
         virtual void doStart();
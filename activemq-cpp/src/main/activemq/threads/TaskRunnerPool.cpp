@@ -0,0 +1,416 @@
+#include "TaskRunnerPool.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/RejectedExecutionException.h>
+#include <decaf/util/concurrent/ThreadFactory.h>
+#include <decaf/util/concurrent/WorkStealingExecutor.h>
+
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace threads {
+
+    class PooledTaskRunner;
+
+    /**
+     * Names and places the pool's worker threads and remembers them so the pool can
+     * tell when it is being shut down from one of its own workers.
+     */
+    class PoolThreadFactory : public decaf::util::concurrent::ThreadFactory {
+    private:
+
+        PoolThreadFactory(const PoolThreadFactory&);
+        PoolThreadFactory& operator= (const PoolThreadFactory&);
+
+    private:
+
+        std::string name;
+        std::vector<int> affinity;
+        mutable decaf::util::concurrent::Mutex mutex;
+        std::vector<Thread*> threads;
+
+    public:
+
+        PoolThreadFactory(const std::string& name, const std::vector<int>& affinity) :
+            ThreadFactory(), name(name), affinity(affinity), mutex(), threads() {
+        }
+
+        virtual ~PoolThreadFactory() {}
+
+        virtual Thread* newThread(Runnable* runnable) {
+            Thread* thread = NULL;
+            synchronized(&mutex) {
+                thread = new Thread(runnable, name + "-" + Integer::toString((int) threads.size()));
+                threads.push_back(thread);
+            }
+            if (!affinity.empty()) {
+                thread->setAffinity(affinity);
+            }
+            return thread;
+        }
+
+        bool isPoolThread(Thread* thread) const {
+            bool result = false;
+            synchronized(&mutex) {
+                std::vector<Thread*>::const_iterator iter = threads.begin();
+                for (; iter != threads.end(); ++iter) {
+                    if (*iter == thread) {
+                        result = true;
+                    }
+                }
+            }
+            return result;
+        }
+
+    };
+
+    class TaskRunnerPoolImpl {
+    private:
+
+        TaskRunnerPoolImpl(const TaskRunnerPoolImpl&);
+        TaskRunnerPoolImpl& operator= (const TaskRunnerPoolImpl&);
+
+    public:
+
+        int poolSize;
+
+        // Owned by the executor, which deletes it.
+        PoolThreadFactory* threadFactory;
+
+        // Async mode so that each worker runs the runners woken on it in order.
+        decaf::util::concurrent::WorkStealingExecutor executor;
+
+        // Once set a runner taken from the executor is released instead of run.
+        volatile bool closed;
+
+    public:
+
+        TaskRunnerPoolImpl(int poolSize, const std::string& name, const std::vector<int>& affinity) :
+            poolSize(poolSize), threadFactory(new PoolThreadFactory(name, affinity)),
+            executor(poolSize, threadFactory, true), closed(false) {
+        }
+
+        ~TaskRunnerPoolImpl() {}
+
+        bool schedule(PooledTaskRunner* runner);
+
+        void shutdown();
+
+    };
+
+    class PooledTaskRunner : public TaskRunner, public decaf::lang::Runnable {
+    private:
+
+        PooledTaskRunner(const PooledTaskRunner&);
+        PooledTaskRunner& operator= (const PooledTaskRunner&);
+
+    public:
+
+        // The number of iterations a runner gets before it goes to the back of
+        // the queue so that one busy Task can't hold a worker to itself.
+        static const int MAX_ITERATIONS = 16;
+
+    private:
+
+        TaskRunnerPoolImpl* pool;
+        Task* task;
+        mutable decaf::util::concurrent::Mutex mutex;
+        Thread* runningThread;
+        bool started;
+        bool queued;
+        bool running;
+        bool pending;
+        bool shutDown;
+
+        // Set by the pool to itself so the runner can queue itself again.
+        Pointer<PooledTaskRunner> self;
+
+    public:
+
+        PooledTaskRunner(TaskRunnerPoolImpl* pool, Task* task) :
+            TaskRunner(), Runnable(), pool(pool), task(task), mutex(), runningThread(NULL),
+            started(false), queued(false), running(false), pending(false),
+            shutDown(false), self() {
+        }
+
+        virtual ~PooledTaskRunner() {}
+
+        void setSelf(const Pointer<PooledTaskRunner>& self) {
+            this->self = self;
+        }
+
+        virtual void start() {
+            synchronized(&mutex) {
+                if (started || shutDown) {
+                    return;
+                }
+                started = true;
+            }
+
+            wakeup();
+        }
+
+        virtual bool isStarted() const {
+            bool result = false;
+            synchronized(&mutex) {
+                result = started;
+            }
+            return result;
+        }
+
+        virtual void shutdown(long long timeout) {
+            doShutdown(timeout);
+        }
+
+        virtual void shutdown() {
+            doShutdown(0);
+        }
+
+        virtual void wakeup() {
+
+            Pointer<PooledTaskRunner> runner;
+
+            synchronized(&mutex) {
+                if (shutDown || !started) {
+                    return;
+                }
+
+                if (running) {
+                    pending = true;
+                    return;
+                }
+
+                if (queued) {
+                    return;
+                }
+
+                queued = true;
+                runner = self;
+            }
+
+            if (runner != NULL) {
+                schedule(runner);
+            }
+        }
+
+        /**
+         * Called from a pool worker each time the runner is taken from the pool's
+         * queues, the runner holds on to itself for as long as it is queued.
+         */
+        virtual void run() {
+
+            Pointer<PooledTaskRunner> keepAlive;
+            synchronized(&mutex) {
+                keepAlive = self;
+            }
+
+            if (keepAlive == NULL) {
+                return;
+            }
+
+            if (pool->closed) {
+                abandon();
+            } else {
+                runOnce();
+            }
+        }
+
+        /**
+         * Called for a runner that was still queued when the pool was shut down, the
+         * runner won't be run again.
+         */
+        void abandon() {
+            synchronized(&mutex) {
+                queued = false;
+                self.reset(NULL);
+                mutex.notifyAll();
+            }
+        }
+
+        /**
+         * Called from a pool worker to give the Task its iterations.
+         */
+        void runOnce() {
+
+            synchronized(&mutex) {
+                queued = false;
+                if (shutDown) {
+                    self.reset(NULL);
+                    mutex.notifyAll();
+                    return;
+                }
+
+                running = true;
+                pending = false;
+                runningThread = Thread::currentThread();
+            }
+
+            bool more = false;
+
+            try {
+                for (int i = 0; i < MAX_ITERATIONS; ++i) {
+                    more = this->task->iterate();
+                    if (!more) {
+                        break;
+                    }
+                }
+            }
+            AMQ_CATCHALL_NOTHROW()
+
+            Pointer<PooledTaskRunner> runner;
+
+            synchronized(&mutex) {
+                running = false;
+                runningThread = NULL;
+
+                if (shutDown) {
+                    self.reset(NULL);
+                } else if (more || pending) {
+                    pending = false;
+                    queued = true;
+                    runner = self;
+                }
+
+                mutex.notifyAll();
+            }
+
+            if (runner != NULL) {
+                schedule(runner);
+            }
+        }
+
+    private:
+
+        void schedule(const Pointer<PooledTaskRunner>& runner) {
+            if (!pool->schedule(runner.get())) {
+                synchronized(&mutex) {
+                    queued = false;
+                    if (shutDown) {
+                        self.reset(NULL);
+                    }
+                }
+            }
+        }
+
+        void doShutdown(long long timeout) {
+
+            synchronized(&mutex) {
+
+                shutDown = true;
+                pending = false;
+
+                // A Task may shut down its own runner from within iterate.
+                if (runningThread == Thread::currentThread()) {
+                    return;
+                }
+
+                if (timeout > 0) {
+                    if (running) {
+                        mutex.wait(timeout);
+                    }
+                } else {
+                    while (running) {
+                        mutex.wait();
+                    }
+                }
+
+                // Nothing can queue the runner now, if it is still queued the
+                // worker that takes it will release it.
+                if (!queued && !running) {
+                    self.reset(NULL);
+                }
+            }
+        }
+
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TaskRunnerPoolImpl::schedule(PooledTaskRunner* runner) {
+
+    if (closed) {
+        return false;
+    }
+
+    try {
+        // The runner keeps itself alive while queued so the executor doesn't own it.
+        executor.execute(runner, false);
+    } catch (RejectedExecutionException& ex) {
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPoolImpl::shutdown() {
+
+    closed = true;
+
+    // Runners still queued are taken by the workers and released, not run.
+    executor.shutdown();
+
+    if (!threadFactory->isPoolThread(Thread::currentThread())) {
+        while (!executor.awaitTermination(1, TimeUnit::MINUTES)) {
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunnerPool::TaskRunnerPool(int poolSize, const std::string& name, const std::vector<int>& affinity) : impl(NULL) {
+
+    if (poolSize < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Pool size must be at least one");
+    }
+
+    this->impl = new TaskRunnerPoolImpl(poolSize, name, affinity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TaskRunnerPool::~TaskRunnerPool() {
+    try {
+        shutdown();
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TaskRunnerPool::getPoolSize() const {
+    return this->impl->poolSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TaskRunner> TaskRunnerPool::createTaskRunner(Task* task) {
+
+    if (task == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Task passed was null");
+    }
+
+    Pointer<PooledTaskRunner> runner(new PooledTaskRunner(this->impl, task));
+    runner->setSelf(runner);
+
+    return runner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPool::shutdown() {
+    this->impl->shutdown();
+}
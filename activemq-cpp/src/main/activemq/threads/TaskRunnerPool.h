@@ -0,0 +1,106 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TASKRUNNERPOOL_H_
+#define _ACTIVEMQ_THREADS_TASKRUNNERPOOL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/threads/TaskRunner.h>
+#include <activemq/threads/Task.h>
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace threads {
+
+    class TaskRunnerPoolImpl;
+
+    /**
+     * A fixed set of worker threads that is shared by any number of TaskRunners,
+     * unlike the DedicatedTaskRunner which dedicates a thread to every Task the
+     * runners created from this pool hand their Task to the pool's workers each
+     * time they are woken up.
+     *
+     * A runner is never queued more than once or run by two workers at the same
+     * time, so each Task is iterated in order just as it would be on a thread of
+     * its own.  The workers are those of a decaf WorkStealingExecutor running in
+     * async mode, a runner woken from a worker is queued on that worker and an idle
+     * worker steals from the queues of the busy ones.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API TaskRunnerPool {
+    private:
+
+        TaskRunnerPoolImpl* impl;
+
+    private:
+
+        TaskRunnerPool(const TaskRunnerPool&);
+        TaskRunnerPool& operator=(const TaskRunnerPool&);
+
+    public:
+
+        /**
+         * Creates a new pool, the worker threads are started by the first
+         * TaskRunner that is woken up.
+         *
+         * @param poolSize
+         *      The number of worker threads in the pool.
+         * @param name
+         *      The name the worker threads are given, each gets its index appended.
+         * @param affinity
+         *      The processors the worker threads are restricted to, empty for any.
+         *
+         * @throws IllegalArgumentException if the pool size is less than one.
+         */
+        TaskRunnerPool(int poolSize, const std::string& name,
+                       const std::vector<int>& affinity = std::vector<int>());
+
+        virtual ~TaskRunnerPool();
+
+        /**
+         * @return the number of worker threads in this pool.
+         */
+        int getPoolSize() const;
+
+        /**
+         * Creates a TaskRunner that runs the given Task on this pool's workers, the
+         * pool must outlive the returned runner.
+         *
+         * @param task
+         *      The Task the new runner iterates, it must outlive the runner.
+         *
+         * @return a new TaskRunner that runs the Task on this pool.
+         *
+         * @throws NullPointerException if the Task is NULL.
+         */
+        decaf::lang::Pointer<TaskRunner> createTaskRunner(Task* task);
+
+        /**
+         * Stops the worker threads and waits for them to exit, a runner of this
+         * pool that is woken after this won't run its Task again.
+         */
+        void shutdown();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TASKRUNNERPOOL_H_ */
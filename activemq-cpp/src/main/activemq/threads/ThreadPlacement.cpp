@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ThreadPlacement.h"
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <algorithm>
+#include <cctype>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    AtomicInteger nextCore;
+    AtomicInteger nextNode;
+
+    // Rotates through the values without going negative once the counter wraps.
+    int nextIndex(AtomicInteger& counter, int size) {
+        unsigned int value = (unsigned int) counter.getAndIncrement();
+        return (int) (value % (unsigned int) size);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ThreadPlacement::Policy ThreadPlacement::parse(const std::string& value) {
+
+    std::string name(value);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    if (name == "none") {
+        return NONE;
+    } else if (name == "core") {
+        return CORE;
+    } else if (name == "node") {
+        return NODE;
+    }
+
+    throw IllegalArgumentException(
+        __FILE__, __LINE__, "Unknown thread placement policy: %s", value.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ThreadPlacement::toString(Policy policy) {
+
+    switch (policy) {
+        case CORE:
+            return "core";
+        case NODE:
+            return "node";
+        default:
+            return "none";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<int> ThreadPlacement::nextPlacement(Policy policy) {
+
+    std::vector<int> result;
+
+    if (policy == NONE) {
+        return result;
+    }
+
+    int nodes = System::availableNumaNodes();
+
+    if (policy == NODE) {
+        // A single node holds every processor, pinning to it would change nothing.
+        if (nodes > 1) {
+            result = System::getNumaNodeProcessors(nextIndex(nextNode, nodes));
+        }
+        return result;
+    }
+
+    // Cores are handed out node by node so neighbouring connections share a node.
+    std::vector<int> cores;
+    for (int node = 0; node < nodes; ++node) {
+        std::vector<int> processors = System::getNumaNodeProcessors(node);
+        cores.insert(cores.end(), processors.begin(), processors.end());
+    }
+
+    if (cores.empty()) {
+        for (int cpu = 0; cpu < System::availableProcessors(); ++cpu) {
+            cores.push_back(cpu);
+        }
+    }
+
+    result.push_back(cores[nextIndex(nextCore, (int) cores.size())]);
+    return result;
+}
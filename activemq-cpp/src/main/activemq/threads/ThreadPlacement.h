@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _ACTIVEMQ_THREADS_THREADPLACEMENT_H_
+#define _ACTIVEMQ_THREADS_THREADPLACEMENT_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace threads {
+
+    /**
+     * Chooses the processors that the threads of a connection are restricted to.  With
+     * a placement policy in effect the reader and dispatch threads of a connection all
+     * run on the same core or NUMA node, which keeps the messages they hand each other in
+     * that core's or node's caches.  Successive connections are spread round robin over
+     * the cores or nodes of the machine.
+     *
+     * @since 3.9
+     */
+    class AMQCPP_API ThreadPlacement {
+    public:
+
+        enum Policy {
+            /** Threads may run on any processor, the default. */
+            NONE,
+            /** All of a connection's threads run on one processor. */
+            CORE,
+            /** All of a connection's threads run on the processors of one NUMA node. */
+            NODE
+        };
+
+    private:
+
+        ThreadPlacement();
+        ThreadPlacement(const ThreadPlacement&);
+        ThreadPlacement& operator= (const ThreadPlacement&);
+
+    public:
+
+        /**
+         * Converts the name used in configuration, "none", "core" or "node", into a Policy,
+         * the match ignores case.
+         *
+         * @param value
+         *      The name of the policy.
+         *
+         * @return the named Policy.
+         *
+         * @throws IllegalArgumentException if the name is not one of the policies.
+         */
+        static Policy parse(const std::string& value);
+
+        /**
+         * @return the configuration name of the given Policy.
+         */
+        static std::string toString(Policy policy);
+
+        /**
+         * Picks the processors for the next connection under the given Policy, each call
+         * moves on to the next core or node.
+         *
+         * @param policy
+         *      The placement policy in effect.
+         *
+         * @return the processors the connection's threads should use, empty for any.
+         */
+        static std::vector<int> nextPlacement(Policy policy);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_THREADPLACEMENT_H_ */
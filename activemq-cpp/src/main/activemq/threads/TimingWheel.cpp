@@ -0,0 +1,474 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TimingWheel.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const long long TimingWheel::DEFAULT_TICK_DURATION = 10;
+const int TimingWheel::DEFAULT_TICKS_PER_WHEEL = 512;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    TimingWheel* sharedInstance = NULL;
+
+    long long currentTime() {
+        return System::nanoTime() / 1000000;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace threads {
+
+    class TimingWheelImpl : public Runnable {
+    private:
+
+        TimingWheelImpl(const TimingWheelImpl&);
+        TimingWheelImpl& operator= (const TimingWheelImpl&);
+
+    public:
+
+        std::string name;
+        long long tickDuration;
+        int mask;
+
+        // Head of the intrusive list of timeouts in each bucket.
+        std::vector<TimingWheel::Timeout*> buckets;
+
+        mutable Mutex mutex;
+        Pointer<Thread> thread;
+
+        long long startTime;
+
+        // The last tick whose bucket has been processed.
+        long long tick;
+
+        int pending;
+        bool shutdown;
+
+    public:
+
+        TimingWheelImpl(const std::string& name, long long tickDuration, int ticksPerWheel) :
+            name(name), tickDuration(tickDuration), mask(0), buckets(), mutex(), thread(),
+            startTime(currentTime()), tick(0), pending(0), shutdown(false) {
+
+            int size = 1;
+            while (size < ticksPerWheel) {
+                size <<= 1;
+            }
+
+            this->mask = size - 1;
+            this->buckets.resize(size, NULL);
+        }
+
+        virtual ~TimingWheelImpl() {}
+
+        Pointer<TimingWheel::Timeout> schedule(const Pointer<Runnable>& task, long long delay,
+                                               long long period, bool fixedRate) {
+
+            if (task == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "Task to schedule cannot be NULL.");
+            }
+
+            if (delay < 0) {
+                throw IllegalArgumentException(__FILE__, __LINE__, "Delay cannot be negative.");
+            }
+
+            Pointer<TimingWheel::Timeout> timeout(
+                new TimingWheel::Timeout(this, task, currentTime() + delay, period, fixedRate));
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    throw IllegalStateException(__FILE__, __LINE__, "TimingWheel has been shutdown.");
+                }
+
+                if (pending == 0) {
+                    // Nothing is waiting so the worker may have stopped ticking, bring
+                    // the wheel up to date rather than making it walk the idle ticks.
+                    long long current = (currentTime() - startTime) / tickDuration;
+                    if (current > tick) {
+                        tick = current;
+                    }
+                }
+
+                timeout->self = timeout;
+                insert(timeout.get());
+
+                if (thread == NULL) {
+                    thread.reset(new Thread(this, name));
+                    thread->start();
+                }
+
+                mutex.notifyAll();
+            }
+
+            return timeout;
+        }
+
+        bool remove(TimingWheel::Timeout* timeout) {
+
+            Pointer<TimingWheel::Timeout> released;
+
+            synchronized(&mutex) {
+                if (timeout->bucket < 0) {
+                    return false;
+                }
+
+                unlink(timeout);
+                released.swap(timeout->self);
+            }
+
+            return true;
+        }
+
+        void stop() {
+
+            std::vector< Pointer<TimingWheel::Timeout> > released;
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    return;
+                }
+
+                shutdown = true;
+
+                for (std::size_t i = 0; i < buckets.size(); ++i) {
+                    while (buckets[i] != NULL) {
+                        TimingWheel::Timeout* timeout = buckets[i];
+                        unlink(timeout);
+                        timeout->wheel = NULL;
+                        released.push_back(timeout->self);
+                        timeout->self.reset();
+                    }
+                }
+
+                mutex.notifyAll();
+            }
+
+            if (thread != NULL && Thread::currentThread() != thread.get()) {
+                thread->join();
+            }
+        }
+
+        virtual void run() {
+
+            std::vector< Pointer<TimingWheel::Timeout> > expired;
+            bool fixedDelay = false;
+
+            while (true) {
+
+                synchronized(&mutex) {
+
+                    while (!shutdown) {
+
+                        if (pending == 0) {
+                            mutex.wait();
+                            continue;
+                        }
+
+                        long long now = currentTime();
+                        long long deadline = startTime + (tick + 1) * tickDuration;
+                        if (now >= deadline) {
+                            break;
+                        }
+
+                        mutex.wait(deadline - now);
+                    }
+
+                    if (shutdown) {
+                        return;
+                    }
+
+                    // Process every tick that has elapsed since the last pass in one batch.
+                    long long current = (currentTime() - startTime) / tickDuration;
+                    while (tick < current && pending > 0) {
+                        tick++;
+                        expire(buckets[(int) (tick & mask)], expired, fixedDelay);
+                    }
+
+                    if (tick < current) {
+                        tick = current;
+                    }
+                }
+
+                std::vector< Pointer<TimingWheel::Timeout> >::iterator iter = expired.begin();
+                for (; iter != expired.end(); ++iter) {
+                    if (!(*iter)->cancelled) {
+                        try {
+                            (*iter)->task->run();
+                        } catch (...) {
+                        }
+                    }
+                }
+
+                if (fixedDelay) {
+                    synchronized(&mutex) {
+                        for (iter = expired.begin(); iter != expired.end(); ++iter) {
+                            TimingWheel::Timeout* timeout = iter->get();
+                            if (timeout->period <= 0 || timeout->fixedRate) {
+                                continue;
+                            }
+
+                            if (shutdown) {
+                                timeout->wheel = NULL;
+                            } else if (!timeout->cancelled) {
+                                timeout->deadline = currentTime() + timeout->period;
+                                timeout->self = *iter;
+                                insert(timeout);
+                            }
+                        }
+                    }
+                }
+
+                expired.clear();
+                fixedDelay = false;
+            }
+        }
+
+    private:
+
+        void expire(TimingWheel::Timeout* timeout,
+                    std::vector< Pointer<TimingWheel::Timeout> >& expired,
+                    bool& fixedDelay) {
+
+            while (timeout != NULL) {
+                TimingWheel::Timeout* next = timeout->next;
+
+                if (timeout->rounds > 0) {
+                    timeout->rounds--;
+                } else {
+                    unlink(timeout);
+                    expired.push_back(timeout->self);
+                    timeout->self.reset();
+
+                    if (timeout->period <= 0) {
+                        timeout->wheel = NULL;
+                    } else if (timeout->fixedRate) {
+                        timeout->deadline += timeout->period;
+                        timeout->self = expired.back();
+                        insert(timeout);
+                    } else {
+                        fixedDelay = true;
+                    }
+                }
+
+                timeout = next;
+            }
+        }
+
+        void insert(TimingWheel::Timeout* timeout) {
+
+            long long target = (timeout->deadline - startTime + tickDuration - 1) / tickDuration;
+            if (target <= tick) {
+                target = tick + 1;
+            }
+
+            timeout->rounds = (target - tick - 1) / (mask + 1);
+            timeout->bucket = (int) (target & mask);
+            timeout->prev = NULL;
+            timeout->next = buckets[timeout->bucket];
+
+            if (timeout->next != NULL) {
+                timeout->next->prev = timeout;
+            }
+
+            buckets[timeout->bucket] = timeout;
+            pending++;
+        }
+
+        void unlink(TimingWheel::Timeout* timeout) {
+
+            if (timeout->prev != NULL) {
+                timeout->prev->next = timeout->next;
+            } else {
+                buckets[timeout->bucket] = timeout->next;
+            }
+
+            if (timeout->next != NULL) {
+                timeout->next->prev = timeout->prev;
+            }
+
+            timeout->prev = NULL;
+            timeout->next = NULL;
+            timeout->bucket = -1;
+            pending--;
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheel::Timeout::Timeout(TimingWheelImpl* wheel, const Pointer<Runnable>& task,
+                              long long deadline, long long period, bool fixedRate) :
+    wheel(wheel), task(task), self(), prev(NULL), next(NULL), deadline(deadline),
+    period(period), rounds(0), bucket(-1), fixedRate(fixedRate), cancelled(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheel::Timeout::~Timeout() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimingWheel::Timeout::cancel() {
+
+    if (this->cancelled) {
+        return false;
+    }
+
+    this->cancelled = true;
+
+    TimingWheelImpl* owner = this->wheel;
+    if (owner == NULL) {
+        return false;
+    }
+
+    return owner->remove(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimingWheel::Timeout::isCancelled() const {
+    return this->cancelled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TimingWheel::Timeout::isPeriodic() const {
+    return this->period > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheel::TimingWheel(const std::string& name, long long tickDuration, int ticksPerWheel) : impl(NULL) {
+
+    if (name.empty()) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "TimingWheel name must not be empty.");
+    }
+
+    if (tickDuration <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Tick duration must be positive.");
+    }
+
+    if (ticksPerWheel <= 0 || ticksPerWheel > (1 << 30)) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Ticks per wheel must be positive and no more than 2^30.");
+    }
+
+    this->impl = new TimingWheelImpl(name, tickDuration, ticksPerWheel);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheel::~TimingWheel() {
+    try {
+        this->impl->stop();
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimingWheel::Timeout> TimingWheel::schedule(const Pointer<Runnable>& task, long long delay) {
+    return this->impl->schedule(task, delay, 0, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimingWheel::Timeout> TimingWheel::schedule(const Pointer<Runnable>& task, long long delay, long long period) {
+
+    if (period <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Period must be positive.");
+    }
+
+    return this->impl->schedule(task, delay, period, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<TimingWheel::Timeout> TimingWheel::scheduleAtFixedRate(const Pointer<Runnable>& task, long long delay, long long period) {
+
+    if (period <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Period must be positive.");
+    }
+
+    return this->impl->schedule(task, delay, period, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheel::shutdown() {
+    this->impl->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TimingWheel::getPendingCount() const {
+
+    int result = 0;
+
+    synchronized(&this->impl->mutex) {
+        result = this->impl->pending;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long TimingWheel::getTickDuration() const {
+    return this->impl->tickDuration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TimingWheel::getTicksPerWheel() const {
+    return this->impl->mask + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheel& TimingWheel::getSharedInstance() {
+
+    if (sharedInstance == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    return *sharedInstance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheel::initialize() {
+    sharedInstance = new TimingWheel("ActiveMQ Shared TimingWheel");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheel::shutdownSharedInstance() {
+    TimingWheel* old = sharedInstance;
+    sharedInstance = NULL;
+    delete old;
+}
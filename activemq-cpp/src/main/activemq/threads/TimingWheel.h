@@ -0,0 +1,251 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TIMINGWHEEL_H_
+#define _ACTIVEMQ_THREADS_TIMINGWHEEL_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace threads {
+
+    class TimingWheelImpl;
+
+    /**
+     * A hashed timing wheel that runs delayed and periodic Runnable tasks from a
+     * single thread.  Each task is hashed into one of a fixed ring of buckets by
+     * the tick on which it expires, so scheduling and cancelling are constant time
+     * regardless of how many tasks are pending, and a cancelled task is unlinked
+     * immediately instead of lingering until its expiration.  On every tick the
+     * wheel visits only the bucket for that tick and runs everything in it that is
+     * due as one batch, catching up on any ticks it missed while busy.
+     *
+     * The trade off against decaf::util::Timer is resolution: a task fires on the
+     * first tick at or after its deadline, so it may run up to one tick duration
+     * late.  This makes the wheel a good fit for the large number of coarse
+     * timeouts a process with many connections needs, such as the inactivity
+     * monitor checks, and a shared instance is provided for that purpose.
+     *
+     * The worker thread is only created once the first task is scheduled.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API TimingWheel {
+    public:
+
+        /**
+         * Handle returned for each scheduled task which can be used to cancel it.
+         */
+        class AMQCPP_API Timeout {
+        private:
+
+            Timeout(const Timeout&);
+            Timeout& operator= (const Timeout&);
+
+        private:
+
+            TimingWheelImpl* wheel;
+            decaf::lang::Pointer<decaf::lang::Runnable> task;
+            decaf::lang::Pointer<Timeout> self;
+
+            Timeout* prev;
+            Timeout* next;
+
+            long long deadline;
+            long long period;
+            long long rounds;
+            int bucket;
+            bool fixedRate;
+            volatile bool cancelled;
+
+            friend class TimingWheelImpl;
+
+        public:
+
+            Timeout(TimingWheelImpl* wheel, const decaf::lang::Pointer<decaf::lang::Runnable>& task,
+                    long long deadline, long long period, bool fixedRate);
+
+            virtual ~Timeout();
+
+            /**
+             * Cancels the task, if it is currently running it is allowed to complete but
+             * it will not be run again.
+             *
+             * @return true if the task was pending and has now been prevented from running.
+             */
+            bool cancel();
+
+            /**
+             * @return true if cancel has been called on this task.
+             */
+            bool isCancelled() const;
+
+            /**
+             * @return true if this is a periodic task.
+             */
+            bool isPeriodic() const;
+
+        };
+
+    public:
+
+        /**
+         * Default length of a tick in milliseconds.
+         */
+        static const long long DEFAULT_TICK_DURATION;
+
+        /**
+         * Default number of buckets in the wheel.
+         */
+        static const int DEFAULT_TICKS_PER_WHEEL;
+
+    private:
+
+        TimingWheelImpl* impl;
+
+    private:
+
+        TimingWheel(const TimingWheel&);
+        TimingWheel& operator= (const TimingWheel&);
+
+    public:
+
+        /**
+         * Creates a new TimingWheel.
+         *
+         * @param name
+         *      The name given to the wheel's worker thread.
+         * @param tickDuration
+         *      The length of a tick in milliseconds, which is the resolution of the wheel.
+         * @param ticksPerWheel
+         *      The number of buckets, rounded up to the next power of two.
+         *
+         * @throws IllegalArgumentException if the name is empty or either value is not positive.
+         */
+        TimingWheel(const std::string& name,
+                    long long tickDuration = DEFAULT_TICK_DURATION,
+                    int ticksPerWheel = DEFAULT_TICKS_PER_WHEEL);
+
+        virtual ~TimingWheel();
+
+        /**
+         * Schedules the task to run once after the given delay.
+         *
+         * @param task
+         *      The task to run, the wheel keeps a reference until it has run or is cancelled.
+         * @param delay
+         *      Time in milliseconds before the task is run.
+         *
+         * @return a handle that can be used to cancel the task.
+         *
+         * @throws NullPointerException if the task is NULL.
+         * @throws IllegalArgumentException if the delay is negative.
+         * @throws IllegalStateException if the wheel has been shutdown.
+         */
+        decaf::lang::Pointer<Timeout> schedule(const decaf::lang::Pointer<decaf::lang::Runnable>& task, long long delay);
+
+        /**
+         * Schedules the task to run repeatedly with a fixed delay between the end of one
+         * execution and the start of the next.
+         *
+         * @param task
+         *      The task to run, the wheel keeps a reference until it is cancelled.
+         * @param delay
+         *      Time in milliseconds before the task is first run.
+         * @param period
+         *      Time in milliseconds between executions.
+         *
+         * @return a handle that can be used to cancel the task.
+         *
+         * @throws NullPointerException if the task is NULL.
+         * @throws IllegalArgumentException if the delay is negative or the period is not positive.
+         * @throws IllegalStateException if the wheel has been shutdown.
+         */
+        decaf::lang::Pointer<Timeout> schedule(const decaf::lang::Pointer<decaf::lang::Runnable>& task, long long delay, long long period);
+
+        /**
+         * Schedules the task to run repeatedly at a fixed rate measured from its first
+         * scheduled execution.
+         *
+         * @param task
+         *      The task to run, the wheel keeps a reference until it is cancelled.
+         * @param delay
+         *      Time in milliseconds before the task is first run.
+         * @param period
+         *      Time in milliseconds between executions.
+         *
+         * @return a handle that can be used to cancel the task.
+         *
+         * @throws NullPointerException if the task is NULL.
+         * @throws IllegalArgumentException if the delay is negative or the period is not positive.
+         * @throws IllegalStateException if the wheel has been shutdown.
+         */
+        decaf::lang::Pointer<Timeout> scheduleAtFixedRate(const decaf::lang::Pointer<decaf::lang::Runnable>& task, long long delay, long long period);
+
+        /**
+         * Cancels all pending tasks and stops the worker thread, a task that is currently
+         * running is allowed to complete.  No new tasks can be scheduled afterwards.
+         */
+        void shutdown();
+
+        /**
+         * @return the number of tasks that are currently waiting in the wheel.
+         */
+        int getPendingCount() const;
+
+        /**
+         * @return the length of a tick in milliseconds.
+         */
+        long long getTickDuration() const;
+
+        /**
+         * @return the number of buckets in the wheel.
+         */
+        int getTicksPerWheel() const;
+
+    public:
+
+        /**
+         * Returns the wheel that is shared by all connections in the process, it is
+         * created by the library initialization and destroyed at library shutdown.
+         *
+         * @return the shared TimingWheel instance.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static TimingWheel& getSharedInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdownSharedInstance();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TIMINGWHEEL_H_ */
@@ -18,6 +18,7 @@
 #include "FutureResponse.h"
 
 #include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/util/Config.h>
@@ -34,20 +35,43 @@ using namespace decaf::lang::exceptions;
 using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-FutureResponse::FutureResponse() : responseLatch(1), response(), responseCallback() {}
+FutureResponse::FutureResponse() : mutex(), response(), complete(false), responseCallback() {}
 
 ////////////////////////////////////////////////////////////////////////////////
 FutureResponse::FutureResponse(const Pointer<ResponseCallback> responseCallback) :
-    responseLatch(1), response(), responseCallback(responseCallback) {}
+    mutex(), response(), complete(false), responseCallback(responseCallback) {}
 
 ////////////////////////////////////////////////////////////////////////////////
 FutureResponse::~FutureResponse() {}
 
+////////////////////////////////////////////////////////////////////////////////
+void FutureResponse::awaitResponse(unsigned int timeout, bool timed) const {
+
+    synchronized(&mutex) {
+        if (!timed) {
+            while (!complete) {
+                mutex.wait();
+            }
+        } else {
+            long long remaining = timeout;
+            long long deadline = System::currentTimeMillis() + remaining;
+            while (!complete && remaining > 0) {
+                mutex.wait(remaining);
+                remaining = deadline - System::currentTimeMillis();
+            }
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Response> FutureResponse::getResponse() const {
     try {
-        this->responseLatch.await();
-        return response;
+        awaitResponse(0, false);
+        synchronized(&mutex) {
+            return response;
+        }
+
+        return Pointer<Response>();
     } catch (decaf::lang::exceptions::InterruptedException& ex) {
         decaf::lang::Thread::currentThread()->interrupt();
         throw decaf::io::InterruptedIOException(__FILE__, __LINE__, "Interrupted while awaiting a response");
@@ -56,20 +80,18 @@ Pointer<Response> FutureResponse::getResponse() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Response> FutureResponse::getResponse() {
-    try {
-        this->responseLatch.await();
-        return response;
-    } catch (decaf::lang::exceptions::InterruptedException& ex) {
-        decaf::lang::Thread::currentThread()->interrupt();
-        throw decaf::io::InterruptedIOException(__FILE__, __LINE__, "Interrupted while awaiting a response");
-    }
+    return static_cast<const FutureResponse*>(this)->getResponse();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Response> FutureResponse::getResponse(unsigned int timeout) const {
     try {
-        this->responseLatch.await(timeout);
-        return response;
+        awaitResponse(timeout, true);
+        synchronized(&mutex) {
+            return response;
+        }
+
+        return Pointer<Response>();
     } catch (decaf::lang::exceptions::InterruptedException& ex) {
         throw decaf::io::InterruptedIOException(__FILE__, __LINE__, "Interrupted while awaiting a response");
     }
@@ -77,19 +99,34 @@ Pointer<Response> FutureResponse::getResponse(unsigned int timeout) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Response> FutureResponse::getResponse(unsigned int timeout) {
-    try {
-        this->responseLatch.await(timeout);
-        return response;
-    } catch (decaf::lang::exceptions::InterruptedException& ex) {
-        throw decaf::io::InterruptedIOException(__FILE__, __LINE__, "Interrupted while awaiting a response");
-    }
+    return static_cast<const FutureResponse*>(this)->getResponse(timeout);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void FutureResponse::setResponse(Pointer<Response> response) {
-    this->response = response;
-    this->responseLatch.countDown();
+    synchronized(&mutex) {
+        this->response = response;
+        this->complete = true;
+        mutex.notifyAll();
+    }
     if (responseCallback != NULL) {
-        responseCallback->onComplete(this->response);
+        responseCallback->onComplete(response);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FutureResponse::isComplete() const {
+    synchronized(&mutex) {
+        return complete;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FutureResponse::reset() {
+    synchronized(&mutex) {
+        this->response.reset(NULL);
+        this->complete = false;
     }
 }
@@ -27,7 +27,6 @@
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/concurrent/Mutex.h>
-#include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/lang/exceptions/InterruptedException.h>
 #include <decaf/io/InterruptedIOException.h>
 
@@ -45,10 +44,19 @@ namespace transport {
     class AMQCPP_API FutureResponse {
     private:
 
-        mutable decaf::util::concurrent::CountDownLatch responseLatch;
+        // Guards response and complete, waiters block on it until the response is set.
+        mutable decaf::util::concurrent::Mutex mutex;
         Pointer<Response> response;
+        bool complete;
         Pointer<ResponseCallback> responseCallback;
 
+    private:
+
+        FutureResponse(const FutureResponse&);
+        FutureResponse& operator=(const FutureResponse&);
+
+        void awaitResponse(unsigned int timeout, bool timed) const;
+
     public:
 
         FutureResponse();
@@ -86,6 +94,19 @@ namespace transport {
          */
         void setResponse(Pointer<Response> response);
 
+        /**
+         * @return true once a response was set, waiters have been or will be released.
+         */
+        bool isComplete() const;
+
+        /**
+         * Returns this future to the state it had when created so that it can carry
+         * the response of another request.  Only valid for a future without a callback
+         * that is complete or that no other thread can still complete, a future whose
+         * setResponse may yet be called must not be reset.
+         */
+        void reset();
+
     };
 
 }}
@@ -17,16 +17,27 @@
 
 #include "IOTransport.h"
 
+#include <decaf/io/ByteArrayInputStream.h>
 #include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/transport/WriteQueueFullException.h>
+#include <activemq/transport/logging/FrameCaptureFile.h>
 #include <activemq/util/Config.h>
+#include <activemq/util/StripedCounter.h>
 #include <typeinfo>
+#include <vector>
 
 using namespace activemq;
 using namespace activemq::transport;
+using namespace activemq::transport::logging;
 using namespace activemq::exceptions;
 using namespace activemq::commands;
 using namespace activemq::wireformat;
@@ -34,6 +45,7 @@ using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
 
@@ -43,6 +55,34 @@ LOGDECAF_INITIALIZE( logger, IOTransport, "activemq.transport.IOTransport")
 namespace activemq {
 namespace transport {
 
+    // Collects the bytes of a frame being marshaled so it can be captured before it is sent.
+    class FrameBufferStream : public decaf::io::OutputStream {
+    private:
+
+        FrameBufferStream(const FrameBufferStream&);
+        FrameBufferStream& operator= (const FrameBufferStream&);
+
+    private:
+
+        std::vector<unsigned char>& buffer;
+
+    public:
+
+        FrameBufferStream(std::vector<unsigned char>& buffer) : OutputStream(), buffer(buffer) {}
+
+        virtual ~FrameBufferStream() {}
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value) {
+            buffer.push_back(value);
+        }
+
+        virtual void doWriteArrayBounded(const unsigned char* data, int size AMQCPP_UNUSED, int offset, int length) {
+            buffer.insert(buffer.end(), data + offset, data + offset + length);
+        }
+    };
+
     class IOTransportImpl {
     private:
 
@@ -55,15 +95,182 @@ namespace transport {
         TransportListener* listener;
         decaf::io::DataInputStream* inputStream;
         decaf::io::DataOutputStream* outputStream;
+
+        // Serializes the writes to the output stream, kept here rather than taken from the
+        // stream so that it can be profiled.
+        decaf::util::concurrent::Mutex outputLock;
         Pointer<decaf::lang::Thread> thread;
         AtomicBoolean closed;
         AtomicBoolean started;
 
-        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+        bool writeBatching;
+        int maxBatchBytes;
+        long long maxBatchLinger;
+        int maxWriteQueueSize;
+        IOTransport::WriteQueuePolicy writeQueuePolicy;
+        Pointer< LinkedBlockingQueue< Pointer<Command> > > writeQueue;
+        Pointer<decaf::lang::Runnable> writerTask;
+        Pointer<decaf::lang::Thread> writer;
+        AtomicBoolean writerFailed;
+
+        typedef Pointer< std::vector<unsigned char> > Frame;
+
+        bool pipelinedReads;
+        int maxPendingFrames;
+        Pointer< LinkedBlockingQueue<Frame> > frameQueue;
+        Pointer< LinkedBlockingQueue<Frame> > framePool;
+        Pointer<decaf::lang::Runnable> decoderTask;
+        Pointer<decaf::lang::Thread> decoder;
+        ActiveMQException readerError;
+        bool readerFailed;
+
+        // Guarded by the output lock, while set oneway leaves the flush to the caller.
+        bool flushDeferred;
+
+        bool eventDriven;
+        bool startCalled;
+        Pointer<ByteArrayInputStream> frameIn;
+        Pointer<DataInputStream> frameDataIn;
+
+        // Set while capturing, the send buffer is guarded by the output lock.
+        Pointer<FrameCaptureFile> capture;
+        std::vector<unsigned char> captureFrame;
+        Pointer<FrameBufferStream> captureSink;
+        Pointer<DataOutputStream> captureOut;
+
+        util::StripedCounter commandsSent;
+        util::StripedCounter commandsReceived;
+        util::StripedCounter bytesSent;
+        util::StripedCounter bytesReceived;
+        util::StripedCounter writesDropped;
+
+        activemq::util::MessageTracer* volatile tracer;
+
+        // Processors the reader, writer and decoder threads are restricted to, empty for any.
+        std::vector<int> threadAffinity;
+
+        // How long close waits for the writer to flush commands queued before the close.
+        static const long long WRITER_DRAIN_TIMEOUT = 5000;
+
+        // How often a sender waiting for room in the write queue checks the writer is alive.
+        static const long long WRITE_QUEUE_RECHECK = 100;
+
+        // Frame buffers that grew beyond this are freed rather than reused.
+        static const std::size_t MAX_POOLED_FRAME_SIZE = 1024 * 1024;
+
+        IOTransportImpl() : wireFormat(), listener(NULL), inputStream(NULL), outputStream(NULL), outputLock(), thread(), closed(false),
+                            writeBatching(false), maxBatchBytes(65536), maxBatchLinger(0), maxWriteQueueSize(0),
+                            writeQueuePolicy(IOTransport::BLOCK), writeQueue(), writerTask(), writer(),
+                            writerFailed(false), pipelinedReads(false), maxPendingFrames(64), frameQueue(), framePool(),
+                            decoderTask(), decoder(), readerError(), readerFailed(false), flushDeferred(false),
+                            eventDriven(false), startCalled(false), frameIn(), frameDataIn(), capture(), captureFrame(),
+                            captureSink(), captureOut(), commandsSent(), commandsReceived(), bytesSent(), bytesReceived(),
+                            writesDropped(), tracer(NULL), threadAffinity() {
+            this->outputLock.setProfilingSite("activemq.transport.IOTransport.output");
         }
 
         IOTransportImpl(const Pointer<WireFormat> wireFormat) :
-            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), thread(), closed(false) {
+            wireFormat(wireFormat), listener(NULL), inputStream(NULL), outputStream(NULL), outputLock(), thread(), closed(false),
+            writeBatching(false), maxBatchBytes(65536), maxBatchLinger(0), maxWriteQueueSize(0),
+            writeQueuePolicy(IOTransport::BLOCK), writeQueue(), writerTask(), writer(), writerFailed(false),
+            pipelinedReads(false), maxPendingFrames(64), frameQueue(), framePool(), decoderTask(), decoder(), readerError(),
+            readerFailed(false), flushDeferred(false), eventDriven(false), startCalled(false), frameIn(),
+            frameDataIn(), capture(), captureFrame(), captureSink(), captureOut(), commandsSent(), commandsReceived(),
+            bytesSent(), bytesReceived(), writesDropped(), tracer(NULL), threadAffinity() {
+            this->outputLock.setProfilingSite("activemq.transport.IOTransport.output");
+        }
+
+        void createWriteQueue() {
+            this->writeQueue.reset(new LinkedBlockingQueue< Pointer<Command> >(
+                this->maxWriteQueueSize > 0 ? this->maxWriteQueueSize : Integer::MAX_VALUE));
+        }
+
+        static bool isDroppable(const Pointer<Command>& command) {
+            return command != NULL && command->isMessage() && !command->isResponseRequired();
+        }
+
+        // Takes the oldest message that can be dropped out of the write queue.
+        bool dropOldestMessage() {
+            Pointer<Command> oldest;
+            Pointer< Iterator< Pointer<Command> > > iter(this->writeQueue->iterator());
+            while (iter->hasNext()) {
+                Pointer<Command> queued = iter->next();
+                if (isDroppable(queued)) {
+                    oldest = queued;
+                    break;
+                }
+            }
+
+            // The writer may have taken it in the meantime.
+            if (oldest != NULL && this->writeQueue->remove(oldest)) {
+                this->writesDropped.increment();
+                return true;
+            }
+
+            return false;
+        }
+
+        void trace(activemq::util::MessageTracer::TracePoint point, const Command& command) {
+            activemq::util::MessageTracer* tracer = this->tracer;
+            if (tracer != NULL) {
+                tracer->onTrace(point, command, System::nanoTime());
+            }
+        }
+
+        void place(const Pointer<decaf::lang::Thread>& thread) {
+            if (thread != NULL && !this->threadAffinity.empty()) {
+                thread->setAffinity(this->threadAffinity);
+            }
+        }
+
+        // Counts each frame that was read whole, and records it when capturing.
+        void onFrameRead(const unsigned char* frame, int size) {
+            this->bytesReceived.add(size);
+            if (this->capture != NULL && size > 0) {
+                this->capture->capture(FrameCaptureFile::INBOUND, frame, size);
+            }
+        }
+    };
+
+    class IOTransportWriter : public Runnable {
+    private:
+
+        IOTransport* parent;
+
+    private:
+
+        IOTransportWriter(const IOTransportWriter&);
+        IOTransportWriter& operator= (const IOTransportWriter&);
+
+    public:
+
+        IOTransportWriter(IOTransport* parent) : Runnable(), parent(parent) {}
+
+        virtual ~IOTransportWriter() {}
+
+        virtual void run() {
+            parent->runWriter();
+        }
+    };
+
+    class IOTransportDecoder : public Runnable {
+    private:
+
+        IOTransport* parent;
+
+    private:
+
+        IOTransportDecoder(const IOTransportDecoder&);
+        IOTransportDecoder& operator= (const IOTransportDecoder&);
+
+    public:
+
+        IOTransportDecoder(IOTransport* parent) : Runnable(), parent(parent) {}
+
+        virtual ~IOTransportDecoder() {}
+
+        virtual void run() {
+            parent->runDecoder();
         }
     };
 
@@ -106,6 +313,9 @@ void IOTransport::fire(const Pointer<Command> command) {
 
     try {
 
+        this->impl->commandsReceived.increment();
+        this->impl->trace(activemq::util::MessageTracer::TRANSPORT_RECEIVE, *command);
+
         // If we have been closed then we don't deliver any messages that
         // might have sneaked in while we where closing.
         if (this->impl->listener == NULL || this->impl->closed.get()) {
@@ -127,7 +337,7 @@ void IOTransport::oneway(const Pointer<Command> command) {
         }
 
         // Make sure the thread has been started.
-        if (impl->thread == NULL) {
+        if (!impl->startCalled) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - transport is not started");
         }
 
@@ -141,10 +351,26 @@ void IOTransport::oneway(const Pointer<Command> command) {
             throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - invalid output stream");
         }
 
-        synchronized(impl->outputStream) {
+        if (impl->writer != NULL) {
+
+            if (impl->writerFailed.get()) {
+                throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - writer thread has failed");
+            }
+
+            // The writer thread marshals and flushes it along with any other pending commands.
+            if (!impl->writeQueue->offer(command)) {
+                enqueueWhenFull(command);
+            }
+            return;
+        }
+
+        synchronized(&impl->outputLock) {
             // Write the command to the output stream.
-            this->impl->wireFormat->marshal(command, this, this->impl->outputStream);
-            this->impl->outputStream->flush();
+            marshal(command);
+            if (!this->impl->flushDeferred) {
+                this->impl->outputStream->flush();
+                this->impl->trace(activemq::util::MessageTracer::TRANSPORT_FLUSH, *command);
+            }
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -152,6 +378,34 @@ void IOTransport::oneway(const Pointer<Command> command) {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::enqueueWhenFull(const Pointer<Command>& command) {
+
+    bool droppable = IOTransportImpl::isDroppable(command);
+
+    if (droppable && impl->writeQueuePolicy == FAIL) {
+        throw WriteQueueFullException(__FILE__, __LINE__, "IOTransport::oneway() - write queue is full");
+    }
+
+    while (true) {
+
+        if (droppable && impl->writeQueuePolicy == DROP_OLDEST && impl->dropOldestMessage()) {
+            if (impl->writeQueue->offer(command)) {
+                return;
+            }
+            continue;
+        }
+
+        if (impl->writeQueue->offer(command, IOTransportImpl::WRITE_QUEUE_RECHECK, TimeUnit::MILLISECONDS)) {
+            return;
+        }
+
+        if (impl->writerFailed.get() || impl->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "IOTransport::oneway() - writer stopped while the write queue was full");
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransport::start() {
 
@@ -169,9 +423,63 @@ void IOTransport::start() {
                         "IO streams and wireFormat instances must be set before calling start");
             }
 
+            if (impl->capture != NULL) {
+
+                if (!impl->wireFormat->isFramed()) {
+                    throw IOException(__FILE__, __LINE__, "IOTransport::start() - "
+                            "frame capture requires a framed wireFormat");
+                }
+
+                impl->captureSink.reset(new FrameBufferStream(impl->captureFrame));
+                impl->captureOut.reset(new DataOutputStream(impl->captureSink.get()));
+            }
+
+            if (impl->eventDriven) {
+
+                if (!impl->wireFormat->isFramed()) {
+                    throw IOException(__FILE__, __LINE__, "IOTransport::start() - "
+                            "event driven reads require a framed wireFormat");
+                }
+
+                // Frames are handed to us, nothing here reads from the input stream.
+                impl->frameIn.reset(new ByteArrayInputStream());
+                impl->frameDataIn.reset(new DataInputStream(impl->frameIn.get()));
+                impl->startCalled = true;
+
+                if (impl->writeBatching) {
+                    impl->createWriteQueue();
+                    impl->writerTask.reset(new IOTransportWriter(this));
+                    impl->writer.reset(new Thread(impl->writerTask.get(), "IOTransport writer Thread"));
+                    impl->place(impl->writer);
+                    impl->writer->start();
+                }
+
+                return;
+            }
+
+            // The decoder has to be running before the polling thread can queue frames for it.
+            if (impl->pipelinedReads && impl->wireFormat->isFramed()) {
+                impl->frameQueue.reset(new LinkedBlockingQueue<IOTransportImpl::Frame>(impl->maxPendingFrames));
+                impl->framePool.reset(new LinkedBlockingQueue<IOTransportImpl::Frame>(impl->maxPendingFrames));
+                impl->decoderTask.reset(new IOTransportDecoder(this));
+                impl->decoder.reset(new Thread(impl->decoderTask.get(), "IOTransport decoder Thread"));
+                impl->place(impl->decoder);
+                impl->decoder->start();
+            }
+
             // Start the polling thread.
             impl->thread.reset(new Thread(this, "IOTransport reader Thread"));
+            impl->place(impl->thread);
             impl->thread->start();
+            impl->startCalled = true;
+
+            if (impl->writeBatching) {
+                impl->createWriteQueue();
+                impl->writerTask.reset(new IOTransportWriter(this));
+                impl->writer.reset(new Thread(impl->writerTask.get(), "IOTransport writer Thread"));
+                impl->place(impl->writer);
+                impl->writer->start();
+            }
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -217,10 +525,21 @@ void IOTransport::close() {
         if (impl->closed.compareAndSet(false, true)) {
 
             Finalizer finalize(impl->thread);
+            Finalizer finalizeWriter(impl->writer);
+            Finalizer finalizeDecoder(impl->decoder);
 
             // No need to fire anymore async events now.
             this->impl->listener = NULL;
 
+            // Give the writer a chance to flush what was queued before we were closed, the
+            // NULL command tells it to stop.  If it is stuck writing to a dead peer it will
+            // be released when the output stream is closed below.
+            if (impl->writer != NULL) {
+                if (impl->writeQueue->offer(Pointer<Command>(), IOTransportImpl::WRITER_DRAIN_TIMEOUT, TimeUnit::MILLISECONDS)) {
+                    impl->writer->join(IOTransportImpl::WRITER_DRAIN_TIMEOUT);
+                }
+            }
+
             IOException error;
             bool hasException = false;
 
@@ -263,12 +582,31 @@ void IOTransport::close() {
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransport::run() {
 
+    if (this->impl->decoder != NULL) {
+        runFrameReader();
+        return;
+    }
+
+    // While capturing each frame is read whole so it can be recorded before it's unmarshaled.
+    ByteArrayInputStream frameIn;
+    DataInputStream frameDataIn(&frameIn);
+    std::vector<unsigned char> frame;
+
     try {
 
         while (this->impl->started.get() && !this->impl->closed.get()) {
 
+            Pointer<Command> command;
+
             // Read the next command from the input stream.
-            Pointer<Command> command(impl->wireFormat->unmarshal(this, this->impl->inputStream));
+            if (this->impl->capture != NULL) {
+                impl->wireFormat->readFrame(this->impl->inputStream, frame);
+                impl->onFrameRead(&frame[0], (int) frame.size());
+                frameIn.setByteArray(&frame[0], (int) frame.size());
+                command = impl->wireFormat->unmarshal(this, &frameDataIn);
+            } else {
+                command = impl->wireFormat->unmarshal(this, this->impl->inputStream);
+            }
 
             // Notify the listener.
             fire(command);
@@ -287,6 +625,173 @@ void IOTransport::run() {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::runFrameReader() {
+
+    try {
+
+        while (this->impl->started.get() && !this->impl->closed.get()) {
+
+            IOTransportImpl::Frame frame;
+            if (!impl->framePool->poll(frame)) {
+                frame.reset(new std::vector<unsigned char>());
+            }
+
+            impl->wireFormat->readFrame(this->impl->inputStream, *frame);
+            impl->onFrameRead(&(*frame)[0], (int) frame->size());
+
+            // Blocks once the decoder falls maxPendingFrames behind.
+            impl->frameQueue->put(frame);
+        }
+    } catch (exceptions::ActiveMQException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        this->impl->readerError = ex;
+        this->impl->readerFailed = true;
+    } catch (decaf::lang::Exception& ex) {
+        exceptions::ActiveMQException exl(ex);
+        exl.setMark(__FILE__, __LINE__);
+        this->impl->readerError = exl;
+        this->impl->readerFailed = true;
+    } catch (...) {
+        exceptions::ActiveMQException ex(__FILE__, __LINE__, "IOTransport::runFrameReader - caught unknown exception");
+        LOGDECAF_WARN(logger, ex.getStackTraceString());
+        this->impl->readerError = ex;
+        this->impl->readerFailed = true;
+    }
+
+    // The NULL frame tells the decoder to stop, it reports any error stored above once
+    // the frames read before it have been dispatched.
+    try {
+        impl->frameQueue->put(IOTransportImpl::Frame());
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::runDecoder() {
+
+    ByteArrayInputStream frameIn;
+    DataInputStream frameDataIn(&frameIn);
+    bool failed = false;
+
+    while (true) {
+
+        IOTransportImpl::Frame frame;
+
+        try {
+            frame = impl->frameQueue->take();
+        }
+        AMQ_CATCHALL_NOTHROW()
+
+        if (frame == NULL) {
+            break;
+        }
+
+        // After a failure, or once closed, the frames are only drained so that the polling
+        // thread never blocks on a full queue.
+        if (!failed && !this->impl->closed.get()) {
+
+            try {
+
+                frameIn.setByteArray(&(*frame)[0], (int) frame->size());
+                Pointer<Command> command(impl->wireFormat->unmarshal(this, &frameDataIn));
+
+                fire(command);
+
+            } catch (exceptions::ActiveMQException& ex) {
+                failed = true;
+                ex.setMark(__FILE__, __LINE__);
+                fire(ex);
+            } catch (decaf::lang::Exception& ex) {
+                failed = true;
+                exceptions::ActiveMQException exl(ex);
+                exl.setMark(__FILE__, __LINE__);
+                fire(exl);
+            } catch (...) {
+                failed = true;
+                exceptions::ActiveMQException ex(__FILE__, __LINE__, "IOTransport::runDecoder - caught unknown exception");
+                LOGDECAF_WARN(logger, ex.getStackTraceString());
+                fire(ex);
+            }
+        }
+
+        if (frame->capacity() <= IOTransportImpl::MAX_POOLED_FRAME_SIZE) {
+            impl->framePool->offer(frame);
+        }
+    }
+
+    // The polling thread wrote the error before queuing the NULL frame.
+    if (!failed && this->impl->readerFailed) {
+        fire(this->impl->readerError);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::runWriter() {
+
+    try {
+
+        while (!this->impl->writerFailed.get()) {
+
+            Pointer<Command> command = impl->writeQueue->take();
+            bool stopping = command == NULL;
+
+            synchronized(&impl->outputLock) {
+
+                // Only kept while tracing, so each command can be reported once the batch is flushed.
+                std::vector< Pointer<Command> > traced;
+
+                long long start = impl->outputStream->size();
+                long long deadline = System::currentTimeMillis() + impl->maxBatchLinger;
+
+                while (command != NULL) {
+
+                    marshal(command);
+                    if (impl->tracer != NULL) {
+                        traced.push_back(command);
+                    }
+                    command.reset(NULL);
+
+                    if (impl->outputStream->size() - start >= impl->maxBatchBytes) {
+                        break;
+                    }
+
+                    // Take whatever else is already waiting, and if nothing is then linger
+                    // for a bit to give other senders a chance to join this batch.
+                    if (!impl->writeQueue->poll(command)) {
+                        long long remaining = deadline - System::currentTimeMillis();
+                        if (remaining <= 0 || !impl->writeQueue->poll(command, remaining, TimeUnit::MILLISECONDS)) {
+                            break;
+                        }
+                    }
+
+                    stopping = command == NULL;
+                }
+
+                this->impl->outputStream->flush();
+
+                for (std::size_t i = 0; i < traced.size(); ++i) {
+                    impl->trace(activemq::util::MessageTracer::TRANSPORT_FLUSH, *traced[i]);
+                }
+            }
+
+            if (stopping) {
+                break;
+            }
+        }
+    } catch (decaf::lang::Exception& ex) {
+        this->impl->writerFailed.set(true);
+        exceptions::ActiveMQException exl(ex);
+        exl.setMark(__FILE__, __LINE__);
+        fire(exl);
+    } catch (...) {
+        this->impl->writerFailed.set(true);
+        exceptions::ActiveMQException ex(__FILE__, __LINE__, "IOTransport::runWriter - caught unknown exception");
+        LOGDECAF_WARN(logger, ex.getStackTraceString());
+        fire(ex);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<FutureResponse> IOTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
                                                   const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
@@ -316,6 +821,254 @@ void IOTransport::setOutputStream(decaf::io::DataOutputStream* os) {
     this->impl->outputStream = os;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isWriteBatching() const {
+    return this->impl->writeBatching;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setWriteBatching(bool value) {
+    this->impl->writeBatching = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int IOTransport::getMaxBatchBytes() const {
+    return this->impl->maxBatchBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setMaxBatchBytes(int value) {
+    this->impl->maxBatchBytes = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getMaxBatchLinger() const {
+    return this->impl->maxBatchLinger;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setMaxBatchLinger(long long value) {
+    this->impl->maxBatchLinger = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int IOTransport::getMaxWriteQueueSize() const {
+    return this->impl->maxWriteQueueSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setMaxWriteQueueSize(int value) {
+    this->impl->maxWriteQueueSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IOTransport::WriteQueuePolicy IOTransport::getWriteQueuePolicy() const {
+    return this->impl->writeQueuePolicy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setWriteQueuePolicy(WriteQueuePolicy value) {
+    this->impl->writeQueuePolicy = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getWritesDropped() const {
+    return this->impl->writesDropped.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isFlushDeferred() const {
+    if (this->impl->outputStream == NULL) {
+        return false;
+    }
+
+    synchronized(&this->impl->outputLock) {
+        return this->impl->flushDeferred;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setFlushDeferred(bool value) {
+
+    try {
+
+        if (this->impl->outputStream == NULL) {
+            throw IOException(__FILE__, __LINE__, "IOTransport::setFlushDeferred() - invalid output stream");
+        }
+
+        synchronized(&this->impl->outputLock) {
+            bool wasDeferred = this->impl->flushDeferred;
+            this->impl->flushDeferred = value;
+
+            if (wasDeferred && !value && !this->impl->closed.get()) {
+                this->impl->outputStream->flush();
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isPipelinedReads() const {
+    return this->impl->pipelinedReads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setPipelinedReads(bool value) {
+    this->impl->pipelinedReads = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int IOTransport::getMaxPendingFrames() const {
+    return this->impl->maxPendingFrames;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setMaxPendingFrames(int value) {
+    this->impl->maxPendingFrames = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::isEventDriven() const {
+    return this->impl->eventDriven;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setEventDriven(bool value) {
+    this->impl->eventDriven = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<int> IOTransport::getThreadAffinity() const {
+    return this->impl->threadAffinity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setThreadAffinity(const std::vector<int>& cpus) {
+
+    this->impl->threadAffinity = cpus;
+
+    // Threads that are already running are moved as well, an empty set frees them.
+    Pointer<Thread> threads[] = { this->impl->thread, this->impl->writer, this->impl->decoder };
+    for (std::size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i) {
+        if (threads[i] != NULL) {
+            threads[i]->setAffinity(cpus);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FrameCaptureFile> IOTransport::getFrameCapture() const {
+    return this->impl->capture;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setFrameCapture(const Pointer<FrameCaptureFile>& capture) {
+    this->impl->capture = capture;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getCommandsSent() const {
+    return this->impl->commandsSent.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getCommandsReceived() const {
+    return this->impl->commandsReceived.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getBytesSent() const {
+    return this->impl->bytesSent.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long IOTransport::getBytesReceived() const {
+    return this->impl->bytesReceived.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+activemq::util::MessageTracer* IOTransport::getMessageTracer() const {
+    return this->impl->tracer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::setMessageTracer(activemq::util::MessageTracer* tracer) {
+    this->impl->tracer = tracer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::marshal(const Pointer<Command>& command) {
+
+    this->impl->commandsSent.increment();
+    this->impl->trace(activemq::util::MessageTracer::TRANSPORT_MARSHAL, *command);
+
+    if (this->impl->capture == NULL) {
+        long long start = this->impl->outputStream->size();
+        this->impl->wireFormat->marshal(command, this, this->impl->outputStream);
+        this->impl->bytesSent.add(this->impl->outputStream->size() - start);
+        this->impl->trace(activemq::util::MessageTracer::TRANSPORT_WRITE, *command);
+        return;
+    }
+
+    this->impl->captureFrame.clear();
+    this->impl->wireFormat->marshal(command, this, this->impl->captureOut.get());
+
+    int size = (int) this->impl->captureFrame.size();
+    if (size > 0) {
+        const unsigned char* frame = &this->impl->captureFrame[0];
+        this->impl->capture->capture(FrameCaptureFile::OUTBOUND, frame, size);
+        this->impl->outputStream->write(frame, size, 0, size);
+        this->impl->bytesSent.add(size);
+    }
+
+    this->impl->trace(activemq::util::MessageTracer::TRANSPORT_WRITE, *command);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool IOTransport::dispatchFrame(const unsigned char* frame, int size) {
+
+    if (this->impl->closed.get() || this->impl->frameDataIn == NULL) {
+        return false;
+    }
+
+    try {
+
+        impl->onFrameRead(frame, size);
+        impl->frameIn->setByteArray(frame, size);
+        Pointer<Command> command(impl->wireFormat->unmarshal(this, impl->frameDataIn.get()));
+
+        fire(command);
+        return true;
+
+    } catch (exceptions::ActiveMQException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        fire(ex);
+    } catch (decaf::lang::Exception& ex) {
+        exceptions::ActiveMQException exl(ex);
+        exl.setMark(__FILE__, __LINE__);
+        fire(exl);
+    } catch (...) {
+        exceptions::ActiveMQException ex(__FILE__, __LINE__, "IOTransport::dispatchFrame - caught unknown exception");
+        LOGDECAF_WARN(logger, ex.getStackTraceString());
+        fire(ex);
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransport::dispatchReadFailure(const decaf::lang::Exception& error) {
+
+    exceptions::ActiveMQException ex(error);
+    ex.setMark(__FILE__, __LINE__);
+    fire(ex);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<wireformat::WireFormat> IOTransport::getWireFormat() const {
     return this->impl->wireFormat;
@@ -30,15 +30,23 @@
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/util/logging/LoggerDefines.h>
+#include <activemq/util/MessageTracer.h>
+
+#include <vector>
 
 namespace activemq {
 namespace transport {
+namespace logging {
+    class FrameCaptureFile;
+}
 
     using decaf::lang::Pointer;
     using activemq::commands::Command;
     using activemq::commands::Response;
 
     class IOTransportImpl;
+    class IOTransportWriter;
+    class IOTransportDecoder;
 
     /**
      * Implementation of the Transport interface that performs marshaling of commands
@@ -54,14 +62,56 @@ namespace transport {
      * The close method will close the associated
      * streams.  Close can be called explicitly by the user, but is also called in the
      * destructor.  Once this object has been closed, it cannot be restarted.
+     *
+     * When write batching is enabled the oneway method does not write to the output
+     * stream itself, instead the command is queued and a dedicated writer thread marshals
+     * whatever commands have accumulated and flushes them to the stream as one batch.
+     * This trades a small amount of latency for far fewer flush calls, and frees the
+     * sending threads from contending on the output stream.  The queue can be bounded so
+     * a stalled socket holds back only so much, what a sender finds when it is full is
+     * decided by the WriteQueuePolicy.
+     *
+     * When pipelined reads are enabled and the WireFormat is framed the polling thread
+     * only takes whole frames off the input stream and queues them, a decoder thread
+     * unmarshals them in the order they arrived and notifies the listener.  The socket is
+     * then read again while the previous command is still being decoded and dispatched.
+     * A single decoder is used since stateful wire formats, and the ordering of the
+     * commands themselves, require that frames are decoded one after the other.
+     *
+     * When event driven no polling thread is started at all, whoever owns the connection
+     * watches it for data instead, for example on a shared event loop, and passes each
+     * complete frame it receives to dispatchFrame.  The input stream is then never read,
+     * but it is still closed along with the transport.
      */
     class AMQCPP_API IOTransport : public Transport,
                                    public decaf::lang::Runnable {
 
         LOGDECAF_DECLARE(logger)
 
+    public:
+
+        /**
+         * What oneway does with a message sent without waiting for a response when
+         * the bounded write queue is full.  Any other command always waits for room,
+         * they are part of the protocol and can't be refused or lost.
+         */
+        enum WriteQueuePolicy {
+
+            // Wait until the writer has made room.
+            BLOCK,
+
+            // Throw a WriteQueueFullException.
+            FAIL,
+
+            // Drop the oldest queued message that was sent without waiting for a response.
+            DROP_OLDEST
+        };
+
     private:
 
+        friend class IOTransportWriter;
+        friend class IOTransportDecoder;
+
         IOTransportImpl* impl;
 
     private:
@@ -87,6 +137,39 @@ namespace transport {
          */
         void fire(const Pointer<Command> command);
 
+        /**
+         * Run loop of the writer thread when write batching is enabled, drains the
+         * queue of pending commands and writes them to the output stream in batches.
+         */
+        void runWriter();
+
+        /**
+         * Queues a command for the writer thread when the write queue is full, as the
+         * WriteQueuePolicy decides.
+         */
+        void enqueueWhenFull(const Pointer<Command>& command);
+
+        /**
+         * Run loop of the polling thread when pipelined reads are enabled, reads whole frames
+         * from the input stream and queues them for the decoder thread.
+         */
+        void runFrameReader();
+
+        /**
+         * Run loop of the decoder thread when pipelined reads are enabled, unmarshals the
+         * frames queued by the polling thread and notifies the listener of each command.
+         */
+        void runDecoder();
+
+        /**
+         * Writes the command to the output stream, recording its frame first when a frame
+         * capture is set.  The caller must hold the output lock.
+         *
+         * @param command
+         *      The command to marshal.
+         */
+        void marshal(const Pointer<Command>& command);
+
     public:
 
         /**
@@ -121,6 +204,246 @@ namespace transport {
          */
         virtual void setOutputStream(decaf::io::DataOutputStream* os);
 
+        /**
+         * @return true if commands sent via oneway are handed to a writer thread and
+         *         written to the output stream in batches.
+         */
+        bool isWriteBatching() const;
+
+        /**
+         * Sets if commands sent via oneway are handed to a writer thread and written to
+         * the output stream in batches, must be set before the transport is started.
+         *
+         * @param value
+         *      True to enable batched writes.
+         */
+        void setWriteBatching(bool value);
+
+        /**
+         * @return the number of marshaled bytes after which a batch is flushed.
+         */
+        int getMaxBatchBytes() const;
+
+        /**
+         * Sets the number of marshaled bytes after which the writer thread flushes the
+         * current batch even if more commands are waiting to be written.
+         *
+         * @param value
+         *      The maximum size of a batch in bytes.
+         */
+        void setMaxBatchBytes(int value);
+
+        /**
+         * @return the time in milliseconds the writer waits for more commands before
+         *         flushing a batch.
+         */
+        long long getMaxBatchLinger() const;
+
+        /**
+         * Sets the time in milliseconds the writer thread waits for more commands to
+         * arrive before flushing a batch, zero flushes as soon as the queue is empty.
+         *
+         * @param value
+         *      The maximum linger time in milliseconds.
+         */
+        void setMaxBatchLinger(long long value);
+
+        /**
+         * @return the number of commands the write queue holds, zero if it is unbounded.
+         */
+        int getMaxWriteQueueSize() const;
+
+        /**
+         * Sets the number of commands that can wait for the writer thread when write
+         * batching is enabled, must be set before the transport is started.
+         *
+         * @param value
+         *      The capacity of the write queue, zero for no limit.
+         */
+        void setMaxWriteQueueSize(int value);
+
+        /**
+         * @return what is done with a message sent to a full write queue.
+         */
+        WriteQueuePolicy getWriteQueuePolicy() const;
+
+        /**
+         * Sets what is done with a message sent without waiting for a response when the
+         * bounded write queue is full.
+         *
+         * @param value
+         *      The policy to apply, BLOCK by default.
+         */
+        void setWriteQueuePolicy(WriteQueuePolicy value);
+
+        /**
+         * @return the number of messages the DROP_OLDEST policy dropped from the write queue.
+         */
+        long long getWritesDropped() const;
+
+        /**
+         * @return true if oneway is currently leaving the output stream unflushed.
+         */
+        bool isFlushDeferred() const;
+
+        /**
+         * Sets if oneway should skip the flush that normally follows each command it
+         * writes, while deferred a burst of commands leaves in as few socket writes as
+         * the stream's buffer allows.  Clearing the flag flushes anything written while
+         * it was set.  This has no effect when write batching is enabled since the
+         * writer thread already flushes once per batch.
+         *
+         * @param value
+         *      True to defer flushing until the flag is cleared.
+         *
+         * @throws IOException if the output stream isn't set or the flush fails.
+         */
+        void setFlushDeferred(bool value);
+
+        /**
+         * @return true if reading frames from the input stream and unmarshaling them are
+         *         done on separate threads.
+         */
+        bool isPipelinedReads() const;
+
+        /**
+         * Sets if frames are read from the input stream by the polling thread and unmarshaled
+         * by a decoder thread, must be set before the transport is started.  This has no
+         * effect unless the WireFormat is framed.
+         *
+         * @param value
+         *      True to enable pipelined reads.
+         */
+        void setPipelinedReads(bool value);
+
+        /**
+         * @return the number of frames read ahead of the decoder before reading blocks.
+         */
+        int getMaxPendingFrames() const;
+
+        /**
+         * Sets the number of frames the polling thread may read ahead of the decoder thread
+         * before it stops reading from the input stream, must be set before the transport is
+         * started.
+         *
+         * @param value
+         *      The maximum number of frames waiting to be decoded.
+         */
+        void setMaxPendingFrames(int value);
+
+        /**
+         * @return true if incoming frames are delivered by calls to dispatchFrame rather
+         *         than read from the input stream by a polling thread.
+         */
+        bool isEventDriven() const;
+
+        /**
+         * Sets if incoming frames are delivered by calls to dispatchFrame instead of being
+         * read from the input stream by a polling thread, must be set before the transport
+         * is started and requires a framed WireFormat.
+         *
+         * @param value
+         *      True to leave reading to the caller.
+         */
+        void setEventDriven(bool value);
+
+        /**
+         * @return the processors the transport's threads are restricted to, empty if they
+         *         may run on any processor.
+         */
+        std::vector<int> getThreadAffinity() const;
+
+        /**
+         * Restricts the reader, writer and decoder threads of this transport to the given
+         * processors, see decaf::lang::Thread::setAffinity.  This is meant to be set before
+         * the transport is started, threads that are already running are moved as well.
+         * An event driven transport has no reader thread of its own.
+         *
+         * @param cpus
+         *      The zero based indices of the processors to use, empty for any processor.
+         */
+        void setThreadAffinity(const std::vector<int>& cpus);
+
+        /**
+         * @return the capture that records the frames sent and received, or NULL.
+         */
+        Pointer<logging::FrameCaptureFile> getFrameCapture() const;
+
+        /**
+         * Sets a capture that every frame sent and received is recorded into, must be set
+         * before the transport is started and requires a framed WireFormat.  Outgoing
+         * commands are marshaled into a buffer that is recorded and then written to the
+         * output stream, incoming frames are read whole before being unmarshaled.
+         *
+         * @param capture
+         *      The capture to record frames into, or NULL to stop capturing.
+         */
+        void setFrameCapture(const Pointer<logging::FrameCaptureFile>& capture);
+
+        /**
+         * @return the number of commands written to the output stream.
+         */
+        long long getCommandsSent() const;
+
+        /**
+         * @return the number of commands read and passed to the listener.
+         */
+        long long getCommandsReceived() const;
+
+        /**
+         * @return the number of bytes written to the output stream.
+         */
+        long long getBytesSent() const;
+
+        /**
+         * Returns the number of bytes received, which is only known when frames are read
+         * whole, that is when reads are pipelined, event driven or being captured.  When
+         * commands are unmarshaled directly from the input stream this stays at zero.
+         *
+         * @return the number of bytes of the frames received.
+         */
+        long long getBytesReceived() const;
+
+        /**
+         * @return the tracer notified as commands are written and read, or NULL.
+         */
+        util::MessageTracer* getMessageTracer() const;
+
+        /**
+         * Sets a tracer that is notified before and after each command is marshaled, when
+         * the command is flushed to the output stream, and when each command read is passed
+         * to the listener.  The transport does not take ownership of the tracer.
+         *
+         * @param tracer
+         *      The tracer to notify, or NULL to stop tracing.
+         */
+        void setMessageTracer(util::MessageTracer* tracer);
+
+        /**
+         * Unmarshals a frame received while event driven and notifies the listener of the
+         * command.  Frames must be dispatched one at a time in the order they arrived.
+         * If the frame can't be unmarshaled the listener is notified of the error instead
+         * and no further frames should be dispatched.
+         *
+         * @param frame
+         *      The bytes of exactly one frame as delimited by WireFormat::getFrameLength.
+         * @param size
+         *      The length of the frame.
+         *
+         * @return true if the command was dispatched, false if the listener was notified
+         *         of an error.
+         */
+        bool dispatchFrame(const unsigned char* frame, int size);
+
+        /**
+         * Notifies the listener that reading failed while event driven, for instance
+         * because the peer closed its end of the connection.
+         *
+         * @param error
+         *      The exception to report.
+         */
+        void dispatchReadFailure(const decaf::lang::Exception& error);
+
     public:  // Transport methods
 
         virtual void oneway(const Pointer<Command> command);
@@ -17,6 +17,9 @@
 
 #include "TransportRegistry.h"
 
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/util/concurrent/Mutex.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::transport;
@@ -24,10 +27,15 @@ using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
     TransportRegistry* theOnlyInstance;
+    TransportRegistry::DefaultFactories defaultFactories;
+    volatile int defaultsRegistered;
+    Mutex* defaultsLock;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -93,12 +101,27 @@ std::vector<std::string> TransportRegistry::getTransportNames() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 TransportRegistry& TransportRegistry::getInstance() {
+
+    if (theOnlyInstance != NULL && Atomics::getAcquire(&defaultsRegistered) == 0) {
+        synchronized(defaultsLock) {
+            if (defaultsRegistered == 0) {
+                if (defaultFactories != NULL) {
+                    defaultFactories(*theOnlyInstance);
+                }
+                Atomics::lazySet(&defaultsRegistered, 1);
+            }
+        }
+    }
+
     return *theOnlyInstance;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void TransportRegistry::initialize() {
+void TransportRegistry::initialize(DefaultFactories defaults) {
     theOnlyInstance = new TransportRegistry();
+    defaultFactories = defaults;
+    defaultsRegistered = 0;
+    defaultsLock = new Mutex();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -106,4 +129,6 @@ void TransportRegistry::shutdown() {
     theOnlyInstance->unregisterAllFactories();
     delete theOnlyInstance;
     theOnlyInstance = NULL;
+    delete defaultsLock;
+    defaultsLock = NULL;
 }
@@ -43,6 +43,14 @@ namespace transport {
      * @since 3.0
      */
     class AMQCPP_API TransportRegistry {
+    public:
+
+        /**
+         * Registers the built in factories with the registry, run by getInstance the
+         * first time it is called so a process that never connects doesn't create them.
+         */
+        typedef void (*DefaultFactories)(TransportRegistry& registry);
+
     private:
 
         decaf::util::StlMap<std::string, TransportFactory*> registry;
@@ -112,14 +120,16 @@ namespace transport {
     public:
 
         /**
-         * Gets the single instance of the TransportRegistry
+         * Gets the single instance of the TransportRegistry, the built in factories are
+         * registered the first time this is called.
+         *
          * @return reference to the single instance of this Registry
          */
         static TransportRegistry& getInstance();
 
     private:
 
-        static void initialize();
+        static void initialize(DefaultFactories defaults);
         static void shutdown();
 
         friend class activemq::library::ActiveMQCPP;
@@ -0,0 +1,55 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_WRITEQUEUEFULLEXCEPTION_H_
+#define _ACTIVEMQ_TRANSPORT_WRITEQUEUEFULLEXCEPTION_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/io/IOException.h>
+
+namespace activemq {
+namespace transport {
+
+    /**
+     * Signals that a message was refused because the queue of commands waiting to be
+     * written was full.  The transport itself is still usable, so unlike other IO errors
+     * this does not call for the connection to be failed over.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API WriteQueueFullException : public decaf::io::IOException {
+    public:
+
+        WriteQueueFullException();
+
+        WriteQueueFullException(const decaf::lang::Exception& ex);
+
+        WriteQueueFullException(const WriteQueueFullException& ex);
+
+        WriteQueueFullException(const char* file, const int lineNumber, const char* msg, ...);
+
+        virtual WriteQueueFullException* clone() const {
+            return new WriteQueueFullException(*this);
+        }
+
+        virtual ~WriteQueueFullException() throw ();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_WRITEQUEUEFULLEXCEPTION_H_ */
@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkingTransport.h"
+
+#include <activemq/commands/LastPartialCommand.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/PartialCommand.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/OutputStream.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+
+#include <algorithm>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::chunking;
+using namespace activemq::wireformat::openwire;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Cuts what is marshaled into it into partial commands and sends each one as soon
+    // as it is full and more data follows, what is left when done goes in the last one.
+    class ChunkOutputStream : public decaf::io::OutputStream {
+    private:
+
+        ChunkOutputStream(const ChunkOutputStream&);
+        ChunkOutputStream& operator= (const ChunkOutputStream&);
+
+    private:
+
+        Transport* next;
+        int commandId;
+        std::size_t chunkSize;
+        std::vector<unsigned char> chunk;
+
+    public:
+
+        ChunkOutputStream(Transport* next, int commandId, int chunkSize) :
+            OutputStream(), next(next), commandId(commandId), chunkSize((std::size_t) chunkSize), chunk() {
+
+            this->chunk.reserve(this->chunkSize);
+        }
+
+        virtual ~ChunkOutputStream() {}
+
+        void finish() {
+            Pointer<PartialCommand> last(new LastPartialCommand());
+            last->setCommandId(this->commandId);
+            last->getData().swap(this->chunk);
+            this->next->oneway(last);
+        }
+
+    protected:
+
+        virtual void doWriteByte(unsigned char value) {
+            doWriteArrayBounded(&value, 1, 0, 1);
+        }
+
+        virtual void doWriteArrayBounded(const unsigned char* data, int size AMQCPP_UNUSED, int offset, int length) {
+
+            const unsigned char* position = data + offset;
+            std::size_t remaining = (std::size_t) length;
+
+            while (remaining > 0) {
+
+                if (this->chunk.size() == this->chunkSize) {
+                    Pointer<PartialCommand> partial(new PartialCommand());
+                    partial->setCommandId(this->commandId);
+                    partial->getData().swap(this->chunk);
+                    this->chunk.reserve(this->chunkSize);
+                    this->next->oneway(partial);
+                }
+
+                std::size_t count = std::min(remaining, this->chunkSize - this->chunk.size());
+                this->chunk.insert(this->chunk.end(), position, position + count);
+                position += count;
+                remaining -= count;
+            }
+        }
+    };
+
+    bool isPartial(const Command& command) {
+        unsigned char type = command.getDataStructureType();
+        return type == PartialCommand::ID_PARTIALCOMMAND || type == LastPartialCommand::ID_LASTPARTIALCOMMAND;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChunkingTransport::ChunkingTransport(const Pointer<Transport> next, const Pointer<OpenWireFormat> wireFormat, int chunkSize) :
+    TransportFilter(next), wireFormat(wireFormat), chunkSize(chunkSize), sendMutex(), joined() {
+
+    if (chunkSize <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "The chunk size must be positive.");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChunkingTransport::~ChunkingTransport() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChunkingTransport::isChunked(const Command& command) const {
+
+    if (this->wireFormat->isCacheEnabled()) {
+        return false;
+    }
+
+    if (!command.isMessage()) {
+        // A message the state tracker replays already encoded.
+        const MarshaledCommand* marshaled = dynamic_cast<const MarshaledCommand*>(&command);
+        return marshaled != NULL && marshaled->getFrame().size() > (std::size_t) this->chunkSize;
+    }
+
+    const Message& message = dynamic_cast<const Message&>(command);
+    return message.getSize() > (unsigned int) this->chunkSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransport::oneway(const Pointer<Command> command) {
+
+    try {
+
+        checkClosed();
+
+        if (command == NULL || !isChunked(*command)) {
+            next->oneway(command);
+            return;
+        }
+
+        synchronized(&this->sendMutex) {
+            ChunkOutputStream chunks(next.get(), command->getCommandId(), this->chunkSize);
+            DataOutputStream out(&chunks);
+            this->wireFormat->marshal(command, this, &out);
+            out.flush();
+            chunks.finish();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransport::onCommand(const Pointer<Command> command) {
+
+    if (!isPartial(*command)) {
+        TransportFilter::onCommand(command);
+        return;
+    }
+
+    try {
+
+        Pointer<PartialCommand> partial = command.dynamicCast<PartialCommand>();
+
+        const std::vector<unsigned char>& data = partial->getData();
+        if (this->joined.empty()) {
+            this->joined.swap(partial->getData());
+        } else {
+            this->joined.insert(this->joined.end(), data.begin(), data.end());
+        }
+
+        if (command->getDataStructureType() != LastPartialCommand::ID_LASTPARTIALCOMMAND) {
+            return;
+        }
+
+        // The joined frame is read in place, then the buffer is let go as it holds a
+        // whole large message.
+        std::vector<unsigned char> frame;
+        frame.swap(this->joined);
+
+        if (frame.empty()) {
+            throw IOException(__FILE__, __LINE__, "ChunkingTransport - received an empty chunked command");
+        }
+
+        ByteArrayInputStream bytesIn(&frame[0], (int) frame.size());
+        DataInputStream dataIn(&bytesIn);
+
+        Pointer<Command> complete = this->wireFormat->unmarshal(this, &dataIn);
+        TransportFilter::onCommand(complete);
+
+    } catch (decaf::lang::Exception& ex) {
+        this->joined.clear();
+        ActiveMQException error(ex);
+        error.setMark(__FILE__, __LINE__);
+        TransportFilter::onException(error);
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_CHUNKING_CHUNKINGTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_CHUNKING_CHUNKINGTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/TransportFilter.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+namespace activemq {
+namespace transport {
+namespace chunking {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * A transport filter that sends large messages as a run of PartialCommand frames
+     * ending in a LastPartialCommand, and joins the runs it receives back into the
+     * command they carry.  The message is marshaled straight into the chunks so the
+     * sender never holds the encoded message in one piece, and each chunk is its own
+     * frame so commands sent by other threads, acks through a PriorityLaneTransport
+     * in particular, can go out between the chunks of a large message.
+     *
+     * The peer has to join the chunks as well, a broker only does so when it has been
+     * configured to.  Chunks are sent only while the OpenWire marshal cache is off since
+     * the cache has to change in the order commands are read at the other end.  The
+     * filter is enabled with this URI option:
+     *
+     *  transport.chunkSize - the size of the chunks in bytes, messages whose estimated
+     *                        size is larger are chunked.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ChunkingTransport : public TransportFilter {
+    private:
+
+        Pointer<wireformat::openwire::OpenWireFormat> wireFormat;
+
+        int chunkSize;
+
+        // Keeps the chunks of two large messages from interleaving.
+        decaf::util::concurrent::Mutex sendMutex;
+
+        // The data of the partial commands received so far, only the reader thread uses it.
+        std::vector<unsigned char> joined;
+
+    private:
+
+        ChunkingTransport(const ChunkingTransport&);
+        ChunkingTransport& operator=(const ChunkingTransport&);
+
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param next
+         *      The next Transport in the chain.
+         * @param wireFormat
+         *      The OpenWire format the chunked messages are marshaled with.
+         * @param chunkSize
+         *      The size of the chunks in bytes, messages that are estimated to be
+         *      larger are chunked.
+         *
+         * @throws IllegalArgumentException if the chunk size is not positive.
+         */
+        ChunkingTransport(const Pointer<Transport> next,
+                          const Pointer<wireformat::openwire::OpenWireFormat> wireFormat,
+                          int chunkSize);
+
+        virtual ~ChunkingTransport();
+
+        /**
+         * @return the size of the chunks in bytes.
+         */
+        int getChunkSize() const {
+            return this->chunkSize;
+        }
+
+        /**
+         * @return true if the command would currently be sent in chunks.
+         */
+        bool isChunked(const Command& command) const;
+
+    public: // TransportFilter Methods
+
+        virtual void oneway(const Pointer<Command> command);
+
+        virtual void onCommand(const Pointer<Command> command);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_CHUNKING_CHUNKINGTRANSPORT_H_ */
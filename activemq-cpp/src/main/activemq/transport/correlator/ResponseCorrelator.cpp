@@ -17,11 +17,13 @@
 
 #include "ResponseCorrelator.h"
 #include <algorithm>
+#include <vector>
 
 #include <decaf/util/ArrayList.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
-#include <decaf/util/HashMap.h>
+#include <decaf/util/OpenHashMap.h>
 
 #include <activemq/commands/Response.h>
 #include <activemq/commands/ExceptionResponse.h>
@@ -40,64 +42,182 @@ using namespace decaf::util;
 using namespace decaf::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-namespace {
+namespace activemq{
+namespace transport{
+namespace correlator{
 
-    class ResponseFinalizer {
+    /**
+     * One slice of the outstanding request map, command ids are spread over the
+     * stripes so that concurrent senders and the reader thread rarely share a lock.
+     */
+    class RequestStripe {
     private:
 
-        ResponseFinalizer(const ResponseFinalizer&);
-        ResponseFinalizer operator=(const ResponseFinalizer&);
+        RequestStripe(const RequestStripe&);
+        RequestStripe& operator= (const RequestStripe&);
 
-    private:
+    public:
 
-        Mutex* mutex;
-        int commandId;
-        HashMap<unsigned int, Pointer<FutureResponse> >* map;
+        // Futures of finished synchronous requests kept for the next ones on the stripe.
+        static const std::size_t MAX_SPARES = 2;
 
-    public:
+        decaf::util::concurrent::Mutex mutex;
+        OpenHashMap<unsigned int, Pointer<FutureResponse> > requests;
+        std::vector<Pointer<FutureResponse> > spares;
 
-        ResponseFinalizer(Mutex* mutex, int commandId, HashMap<unsigned int, Pointer<FutureResponse> >* map) :
-            mutex(mutex), commandId(commandId), map(map) {
+        RequestStripe() : mutex(), requests(), spares() {
+            this->mutex.setProfilingSite("activemq.transport.ResponseCorrelator.requests");
         }
 
-        ~ResponseFinalizer() {
-            synchronized(mutex){
-                try {
-                    map->remove(commandId);
-                } catch (...) {}
-            }
-        }
     };
-}
-
-////////////////////////////////////////////////////////////////////////////////
-namespace activemq{
-namespace transport{
-namespace correlator{
 
     class CorrelatorData {
+    private:
+
+        CorrelatorData(const CorrelatorData&);
+        CorrelatorData& operator= (const CorrelatorData&);
+
     public:
 
+        // Must be a power of two, ids are mapped to a stripe by masking.
+        static const unsigned int STRIPE_COUNT = 32;
+
         // The next command id for sent commands.
         decaf::util::concurrent::atomic::AtomicInteger nextCommandId;
 
-        // Map of request ids to future response objects.
-        HashMap<unsigned int, Pointer<FutureResponse> > requestMap;
+        // Outstanding requests striped by command id, since ids increase monotonically
+        // requests in flight at the same time land on different stripes.
+        RequestStripe stripes[STRIPE_COUNT];
 
-        // Sync object for accessing the request map.
-        decaf::util::concurrent::Mutex mapMutex;
+        // Set once the filter is unusable, priorError is assigned before this is set
+        // and is never changed afterwards.
+        decaf::util::concurrent::atomic::AtomicBoolean disposed;
 
         // Indicates that an the filter is now unusable from some error.
         Pointer<Exception> priorError;
 
+        // Sync object for the transition into the disposed state.
+        decaf::util::concurrent::Mutex disposeMutex;
+
     public:
 
-        CorrelatorData() : nextCommandId(1), requestMap(), mapMutex(), priorError(NULL) {}
+        CorrelatorData() : nextCommandId(1), stripes(), disposed(false), priorError(NULL), disposeMutex() {}
+
+        RequestStripe& stripeFor(unsigned int commandId) {
+            return stripes[commandId & (STRIPE_COUNT - 1)];
+        }
+
+        /**
+         * Adds the future response for the given command id unless the filter has
+         * already been disposed, the check is made under the stripe lock so a request
+         * can never be added after dispose has drained its stripe.
+         *
+         * @return the error the filter was disposed with or NULL if the request was added.
+         */
+        Pointer<Exception> add(unsigned int commandId, Pointer<FutureResponse> futureResponse) {
+            RequestStripe& stripe = stripeFor(commandId);
+            synchronized(&stripe.mutex) {
+                if (disposed.get()) {
+                    return priorError;
+                }
+                stripe.requests.put(commandId, futureResponse);
+            }
+            return Pointer<Exception>();
+        }
+
+        /**
+         * Adds a future response for a synchronous request, one left by an earlier
+         * request on the same stripe is reused when there is one so a request allocates
+         * nothing for its wait.
+         *
+         * @return the error the filter was disposed with or NULL if the request was added.
+         */
+        Pointer<Exception> addRequest(unsigned int commandId, Pointer<FutureResponse>& futureResponse) {
+            RequestStripe& stripe = stripeFor(commandId);
+            synchronized(&stripe.mutex) {
+                if (disposed.get()) {
+                    return priorError;
+                }
+                if (!stripe.spares.empty()) {
+                    futureResponse = stripe.spares.back();
+                    stripe.spares.pop_back();
+                } else {
+                    futureResponse.reset(new FutureResponse());
+                }
+                stripe.requests.put(commandId, futureResponse);
+            }
+            return Pointer<Exception>();
+        }
+
+        /**
+         * Ends a synchronous request, its future is removed if still mapped and kept for
+         * reuse unless the reader thread took it out of the map and has yet to set its
+         * response.
+         */
+        void finishRequest(unsigned int commandId, const Pointer<FutureResponse>& futureResponse) {
+            RequestStripe& stripe = stripeFor(commandId);
+            synchronized(&stripe.mutex) {
+                bool removed = false;
+                if (stripe.requests.containsKey(commandId)) {
+                    stripe.requests.remove(commandId);
+                    removed = true;
+                }
+                if ((removed || futureResponse->isComplete()) && stripe.spares.size() < RequestStripe::MAX_SPARES) {
+                    futureResponse->reset();
+                    stripe.spares.push_back(futureResponse);
+                }
+            }
+        }
+
+        /**
+         * Removes the future response for the given command id.
+         *
+         * @return the removed future response or NULL if there was none.
+         */
+        Pointer<FutureResponse> remove(unsigned int commandId) {
+            RequestStripe& stripe = stripeFor(commandId);
+            synchronized(&stripe.mutex) {
+                try {
+                    return stripe.requests.remove(commandId);
+                } catch (NoSuchElementException& ex) {
+                }
+            }
+            return Pointer<FutureResponse>();
+        }
 
     };
 
 }}}
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ResponseFinalizer {
+    private:
+
+        ResponseFinalizer(const ResponseFinalizer&);
+        ResponseFinalizer operator=(const ResponseFinalizer&);
+
+    private:
+
+        CorrelatorData* data;
+        int commandId;
+        const Pointer<FutureResponse>& futureResponse;
+
+    public:
+
+        ResponseFinalizer(CorrelatorData* data, int commandId, const Pointer<FutureResponse>& futureResponse) :
+            data(data), commandId(commandId), futureResponse(futureResponse) {
+        }
+
+        ~ResponseFinalizer() {
+            try {
+                data->finishRequest(commandId, futureResponse);
+            } catch (...) {}
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ResponseCorrelator::ResponseCorrelator(Pointer<Transport> next) : TransportFilter(next), impl(new CorrelatorData) {
 }
@@ -145,14 +265,7 @@ Pointer<FutureResponse> ResponseCorrelator::asyncRequest(const Pointer<Command>
 
         // Add a future response object to the map indexed by this command id.
         Pointer<FutureResponse> futureResponse(new FutureResponse(responseCallback));
-        Pointer<Exception> priorError;
-
-        synchronized(&this->impl->mapMutex) {
-            priorError = this->impl->priorError;
-            if (priorError == NULL) {
-                this->impl->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
-            }
-        }
+        Pointer<Exception> priorError = this->impl->add((unsigned int) command->getCommandId(), futureResponse);
 
         if (priorError != NULL) {
 
@@ -162,7 +275,7 @@ Pointer<FutureResponse> ResponseCorrelator::asyncRequest(const Pointer<Command>
 
             futureResponse->setResponse(response);
 
-            throw IOException(__FILE__, __LINE__, this->impl->priorError->getMessage().c_str());
+            throw IOException(__FILE__, __LINE__, priorError->getMessage().c_str());
         }
 
         // Send the request.
@@ -170,7 +283,7 @@ Pointer<FutureResponse> ResponseCorrelator::asyncRequest(const Pointer<Command>
             next->oneway(command);
         } catch (Exception &ex) {
             // We have to ensure this gets cleaned out otherwise we can consume memory over time.
-            this->impl->requestMap.remove(command->getCommandId());
+            this->impl->remove(command->getCommandId());
             throw;
         }
 
@@ -194,22 +307,15 @@ Pointer<Response> ResponseCorrelator::request(const Pointer<Command> command) {
         command->setResponseRequired(true);
 
         // Add a future response object to the map indexed by this command id.
-        Pointer<FutureResponse> futureResponse(new FutureResponse());
-        Pointer<Exception> priorError;
-
-        synchronized(&this->impl->mapMutex) {
-            priorError = this->impl->priorError;
-            if (priorError == NULL) {
-                this->impl->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
-            }
-        }
+        Pointer<FutureResponse> futureResponse;
+        Pointer<Exception> priorError = this->impl->addRequest((unsigned int) command->getCommandId(), futureResponse);
 
         if (priorError != NULL) {
-            throw IOException(__FILE__, __LINE__, this->impl->priorError->getMessage().c_str());
+            throw IOException(__FILE__, __LINE__, priorError->getMessage().c_str());
         }
 
         // The finalizer will cleanup the map even if an exception is thrown.
-        ResponseFinalizer finalizer(&this->impl->mapMutex, command->getCommandId(), &this->impl->requestMap);
+        ResponseFinalizer finalizer(this->impl, command->getCommandId(), futureResponse);
 
         // Wait to be notified of the response via the futureResponse object.
         Pointer<commands::Response> response;
@@ -245,22 +351,15 @@ Pointer<Response> ResponseCorrelator::request(const Pointer<Command> command, un
         command->setResponseRequired(true);
 
         // Add a future response object to the map indexed by this command id.
-        Pointer<FutureResponse> futureResponse(new FutureResponse());
-        Pointer<Exception> priorError;
-
-        synchronized(&this->impl->mapMutex) {
-            priorError = this->impl->priorError;
-            if (priorError == NULL) {
-                this->impl->requestMap.put((unsigned int) command->getCommandId(), futureResponse);
-            }
-        }
+        Pointer<FutureResponse> futureResponse;
+        Pointer<Exception> priorError = this->impl->addRequest((unsigned int) command->getCommandId(), futureResponse);
 
         if (priorError != NULL) {
-            throw IOException(__FILE__, __LINE__, this->impl->priorError->getMessage().c_str());
+            throw IOException(__FILE__, __LINE__, priorError->getMessage().c_str());
         }
 
         // The finalizer will cleanup the map even if an exception is thrown.
-        ResponseFinalizer finalizer(&this->impl->mapMutex, command->getCommandId(), &this->impl->requestMap);
+        ResponseFinalizer finalizer(this->impl, command->getCommandId(), futureResponse);
 
         // Wait to be notified of the response via the futureResponse object.
         Pointer<commands::Response> response;
@@ -298,16 +397,10 @@ void ResponseCorrelator::onCommand(const Pointer<Command> command) {
     Pointer<Response> response = command.dynamicCast<Response>();
 
     // It is a response - let's correlate ...
-    synchronized(&this->impl->mapMutex) {
+    Pointer<FutureResponse> futureResponse = this->impl->remove(response->getCorrelationId());
 
-        Pointer<FutureResponse> futureResponse;
-        try {
-            futureResponse = this->impl->requestMap.remove(response->getCorrelationId());
-        } catch (NoSuchElementException& ex) {
-            return;
-        }
-
-        // Set the response property in the future response.
+    // Set the response property in the future response.
+    if (futureResponse != NULL) {
         futureResponse->setResponse(response);
     }
 }
@@ -331,13 +424,23 @@ void ResponseCorrelator::onException(const decaf::lang::Exception& ex) {
 ////////////////////////////////////////////////////////////////////////////////
 void ResponseCorrelator::dispose(Pointer<Exception> error) {
 
+    synchronized(&this->impl->disposeMutex) {
+        if (this->impl->disposed.get()) {
+            return;
+        }
+        this->impl->priorError = error;
+        this->impl->disposed.set(true);
+    }
+
+    // New requests now fail fast, so once each stripe is drained it stays empty.
     ArrayList<Pointer<FutureResponse> > requests;
-    synchronized(&this->impl->mapMutex) {
-        if (this->impl->priorError == NULL) {
-            this->impl->priorError = error;
-            requests.ensureCapacity((int)this->impl->requestMap.size());
-            requests.copy(this->impl->requestMap.values());
-            this->impl->requestMap.clear();
+    for (unsigned int i = 0; i < CorrelatorData::STRIPE_COUNT; ++i) {
+        RequestStripe& stripe = this->impl->stripes[i];
+        synchronized(&stripe.mutex) {
+            if (!stripe.requests.isEmpty()) {
+                requests.addAll(stripe.requests.values());
+                stripe.requests.clear();
+            }
         }
     }
 
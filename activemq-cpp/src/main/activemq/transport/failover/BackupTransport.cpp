@@ -25,13 +25,21 @@ using namespace activemq::transport::failover;
 
 ////////////////////////////////////////////////////////////////////////////////
 BackupTransport::BackupTransport(BackupTransportPool* parent) :
-    parent(parent), transport(), uri(), closed(true), priority(false) {
+    parent(parent), transport(), uri(), closed(true), priority(false), negotiated(false) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 BackupTransport::~BackupTransport() {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BackupTransport::onCommand(const Pointer<commands::Command> command) {
+
+    if (command->isWireFormatInfo()) {
+        this->negotiated = true;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void BackupTransport::onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
 
@@ -22,6 +22,7 @@
 
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <decaf/net/URI.h>
 #include <decaf/lang/Pointer.h>
 #include <memory>
@@ -52,6 +53,9 @@ namespace failover {
         // Is this Transport one of the priority backups.
         bool priority;
 
+        // Has the broker's WireFormatInfo been received, true if the Transport doesn't negotiate.
+        volatile bool negotiated;
+
     private:
 
         BackupTransport(const BackupTransport&);
@@ -98,9 +102,22 @@ namespace failover {
 
             if (this->transport != NULL) {
                 this->transport->setTransportListener(this);
+
+                if (this->transport->narrow(typeid(wireformat::openwire::OpenWireFormatNegotiator)) == NULL) {
+                    this->negotiated = true;
+                }
             }
         }
 
+        /**
+         * Watches for the broker's WireFormatInfo so the pool knows when this backup has
+         * finished negotiating, all other commands are dropped.
+         *
+         * @param command
+         *      The command received from the broker.
+         */
+        virtual void onCommand(const Pointer<commands::Command> command);
+
         /**
          * Event handler for an exception from a command transport.
          * <p>
@@ -132,6 +149,14 @@ namespace failover {
         /**
          * @return true if this transport was in the priority backup list.
          */
+        /**
+         * @return true once the Transport has completed its WireFormatInfo exchange
+         *         and can be used without waiting on the broker.
+         */
+        bool isNegotiated() const {
+            return this->negotiated;
+        }
+
         bool isPriority() const {
             return this->priority;
         }
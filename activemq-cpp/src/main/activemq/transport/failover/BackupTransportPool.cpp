@@ -228,7 +228,22 @@ Pointer<BackupTransport> BackupTransportPool::getBackup() {
 
     synchronized(&this->impl->backups) {
         if (!this->impl->backups.isEmpty()) {
-            result = this->impl->backups.removeAt(0);
+
+            // Prefer a backup that has finished negotiating so the restore can be sent
+            // right away, but never pass over a priority backup for a non-priority one.
+            bool priority = this->impl->backups.getFirst()->isPriority();
+            int index = 0;
+
+            std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
+            for (int next = 0; iter->hasNext(); ++next) {
+                Pointer<BackupTransport> backup = iter->next();
+                if (backup->isPriority() == priority && backup->isNegotiated()) {
+                    index = next;
+                    break;
+                }
+            }
+
+            result = this->impl->backups.removeAt(index);
         }
     }
 
@@ -362,6 +377,41 @@ bool BackupTransportPool::isPriorityBackupAvailable() const {
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BackupTransportPool::retainBackups(URIPool& current) {
+
+    if (!isEnabled()) {
+        return;
+    }
+
+    synchronized(&this->impl->backups) {
+
+        std::auto_ptr<Iterator<Pointer<BackupTransport> > > iter(this->impl->backups.iterator());
+
+        while (iter->hasNext()) {
+            Pointer<BackupTransport> backup = iter->next();
+
+            if (current.contains(backup->getUri())) {
+                current.removeURI(backup->getUri());
+                continue;
+            }
+
+            iter->remove();
+
+            if (backup->isPriority() && this->impl->priorityBackups > 0) {
+                this->impl->priorityBackups--;
+            }
+
+            // The backup goes away with this list entry, nothing may call back into it.
+            backup->getTransport()->setTransportListener(NULL);
+            this->closeTask->add(backup->getTransport());
+        }
+    }
+
+    this->impl->pending = true;
+    this->taskRunner->wakeup();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Transport> BackupTransportPool::createTransport(const URI& location) const {
 
@@ -142,6 +142,17 @@ namespace failover {
          */
         bool isPriorityBackupAvailable() const;
 
+        /**
+         * Brings the backups in line with a new list of broker URIs without tearing
+         * down the ones that are still wanted.  Backups to URIs no longer in the given
+         * pool are closed, the URIs of the others are taken out of it so they aren't
+         * connected to twice, and the pool is flagged to build any backups now missing.
+         *
+         * @param current
+         *      The pool holding the URIs backups may be kept to.
+         */
+        void retainBackups(URIPool& current);
+
     private:
 
         // The backups report their failure to the pool, the pool removes them
@@ -18,15 +18,25 @@
 #include "FailoverTransport.h"
 
 #include <activemq/commands/ConnectionControl.h>
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/ProducerId.h>
 #include <activemq/commands/ShutdownInfo.h>
 #include <activemq/commands/RemoveInfo.h>
 #include <activemq/transport/TransportRegistry.h>
+#include <activemq/transport/WriteQueueFullException.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <activemq/threads/DedicatedTaskRunner.h>
 #include <activemq/threads/CompositeTaskRunner.h>
+#include <activemq/threads/TimingWheel.h>
 #include <activemq/transport/failover/BackupTransportPool.h>
 #include <activemq/transport/failover/URIPool.h>
 #include <activemq/transport/failover/FailoverTransportListener.h>
 #include <activemq/transport/failover/CloseTransportsTask.h>
+#include <activemq/transport/failover/Outbox.h>
 #include <activemq/transport/failover/URIPool.h>
 #include <decaf/util/Random.h>
 #include <decaf/util/StringTokenizer.h>
@@ -34,8 +44,19 @@
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/ArrayPointer.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/net/InetAddress.h>
+
+#include <vector>
 
 using namespace std;
 using namespace activemq;
@@ -45,6 +66,7 @@ using namespace activemq::exceptions;
 using namespace activemq::threads;
 using namespace activemq::transport;
 using namespace activemq::transport::failover;
+using namespace activemq::wireformat::openwire;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::net;
@@ -58,6 +80,385 @@ namespace activemq {
 namespace transport {
 namespace failover {
 
+    /**
+     * Tracks the outcome of a set of ConnectAttempts, the first attempt to report
+     * success wins and any that complete after the race has been decided must
+     * dispose of their own Transport.
+     */
+    class ConnectRace {
+    private:
+
+        ConnectRace(const ConnectRace&);
+        ConnectRace& operator= (const ConnectRace&);
+
+    private:
+
+        Mutex mutex;
+        int remaining;
+        int winner;
+        bool decided;
+
+    public:
+
+        ConnectRace(int attempts) : mutex(), remaining(attempts), winner(-1), decided(false) {}
+
+        bool offer(int index) {
+            synchronized(&mutex) {
+                remaining--;
+                mutex.notifyAll();
+                if (!decided && winner < 0) {
+                    winner = index;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void failed() {
+            synchronized(&mutex) {
+                remaining--;
+                mutex.notifyAll();
+            }
+        }
+
+        /**
+         * Waits for either a winner or for every attempt to fail, once this method
+         * returns no other attempt can become the winner.
+         *
+         * @return the index of the winning attempt or -1 if they all failed.
+         */
+        int await() {
+            synchronized(&mutex) {
+                while (winner < 0 && remaining > 0) {
+                    mutex.wait();
+                }
+                decided = true;
+                return winner;
+            }
+            return -1;
+        }
+    };
+
+    /**
+     * One connect attempt of a parallel connect, the attempt starts its Transport
+     * and waits for the WireFormatInfo to arrive before reporting success.  Commands
+     * that arrive before the attempt is handed over to the FailoverTransport are held
+     * and replayed so that none are lost when the Transport's listener is swapped.
+     */
+    class ConnectAttempt : public DefaultTransportListener {
+    private:
+
+        ConnectAttempt(const ConnectAttempt&);
+        ConnectAttempt& operator= (const ConnectAttempt&);
+
+    private:
+
+        int index;
+        URI uri;
+        Pointer<Transport> transport;
+        Pointer<URIPool> pool;
+        Pointer<ConnectRace> race;
+        long long timeout;
+
+        Mutex mutex;
+        CountDownLatch negotiated;
+        LinkedList< Pointer<Command> > pending;
+        Pointer<Exception> failure;
+        TransportListener* target;
+        bool cancelled;
+
+    public:
+
+        ConnectAttempt(int index, const URI& uri, Pointer<Transport> transport,
+                       Pointer<URIPool> pool, Pointer<ConnectRace> race, long long timeout) :
+            index(index), uri(uri), transport(transport), pool(pool), race(race), timeout(timeout),
+            mutex(), negotiated(1), pending(), failure(), target(NULL), cancelled(false) {
+        }
+
+        virtual ~ConnectAttempt() {}
+
+        const URI& getURI() const {
+            return this->uri;
+        }
+
+        Pointer<Transport> getTransport() const {
+            return this->transport;
+        }
+
+        Pointer<Exception> getFailure() {
+            synchronized(&mutex) {
+                return this->failure;
+            }
+            return Pointer<Exception>();
+        }
+
+        void connect() {
+
+            long long startTime = System::currentTimeMillis();
+
+            try {
+                this->transport->setTransportListener(this);
+                this->transport->start();
+
+                // Only a Transport that negotiates will ever deliver a WireFormatInfo.
+                bool negotiates = this->transport->narrow(typeid(OpenWireFormatNegotiator)) != NULL;
+                if (negotiates && this->timeout > 0) {
+                    this->negotiated.await(this->timeout);
+                } else if (negotiates) {
+                    this->negotiated.await();
+                }
+
+                bool stopped = false;
+                synchronized(&mutex) {
+                    stopped = this->cancelled;
+                    if (!stopped && this->failure != NULL) {
+                        throw IOException(*this->failure);
+                    } else if (!stopped && negotiates && this->negotiated.getCount() > 0) {
+                        throw IOException(__FILE__, __LINE__, "Timed out waiting for WireFormatInfo from: %s",
+                                          this->uri.toString().c_str());
+                    }
+                }
+
+                if (stopped) {
+                    this->race->failed();
+                    dispose();
+                    return;
+                }
+
+                this->pool->recordConnectTime(this->uri, System::currentTimeMillis() - startTime);
+
+                if (this->race->offer(this->index)) {
+                    return;
+                }
+
+            } catch (Exception& ex) {
+
+                bool wasCancelled = false;
+                synchronized(&mutex) {
+                    wasCancelled = this->cancelled;
+                    if (this->failure == NULL) {
+                        this->failure.reset(ex.clone());
+                    }
+                }
+
+                if (!wasCancelled) {
+                    this->pool->recordConnectTime(this->uri, -1);
+                }
+
+                this->race->failed();
+            }
+
+            dispose();
+        }
+
+        /**
+         * Stops an attempt that lost the race from waiting any longer for its
+         * Transport to negotiate.
+         */
+        void cancel() {
+            synchronized(&mutex) {
+                this->cancelled = true;
+            }
+            this->negotiated.countDown();
+        }
+
+        /**
+         * Passes the Transport to its new listener, any held commands are delivered
+         * first.  The held commands are delivered without holding this attempt's lock
+         * so the new listener is free to take its own locks.
+         *
+         * @return false if the Transport failed before it could be handed over.
+         */
+        bool handOver(TransportListener* listener) {
+
+            while (true) {
+                Pointer<Command> next;
+
+                synchronized(&mutex) {
+                    if (this->failure != NULL) {
+                        return false;
+                    }
+
+                    if (this->pending.isEmpty()) {
+                        this->target = listener;
+                        this->transport->setTransportListener(listener);
+                        return true;
+                    }
+
+                    next = this->pending.pop();
+                }
+
+                listener->onCommand(next);
+            }
+
+            return false;
+        }
+
+        void dispose() {
+            try {
+                this->transport->close();
+            } catch (...) {
+            }
+        }
+
+        virtual void onCommand(const Pointer<Command> command) {
+            TransportListener* listener = NULL;
+
+            synchronized(&mutex) {
+                listener = this->target;
+                if (listener == NULL) {
+                    this->pending.add(command);
+                }
+            }
+
+            if (listener != NULL) {
+                listener->onCommand(command);
+            } else if (command->isWireFormatInfo()) {
+                this->negotiated.countDown();
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex) {
+            TransportListener* listener = NULL;
+
+            synchronized(&mutex) {
+                listener = this->target;
+                if (listener == NULL && this->failure == NULL) {
+                    this->failure.reset(ex.clone());
+                }
+            }
+
+            if (listener != NULL) {
+                listener->onException(ex);
+            } else {
+                this->negotiated.countDown();
+            }
+        }
+
+        virtual void transportInterrupted() {
+            TransportListener* listener = NULL;
+            synchronized(&mutex) {
+                listener = this->target;
+            }
+
+            if (listener != NULL) {
+                listener->transportInterrupted();
+            }
+        }
+
+        virtual void transportResumed() {
+            TransportListener* listener = NULL;
+            synchronized(&mutex) {
+                listener = this->target;
+            }
+
+            if (listener != NULL) {
+                listener->transportResumed();
+            }
+        }
+    };
+
+    class ConnectAttemptTask : public Runnable {
+    private:
+
+        ConnectAttemptTask(const ConnectAttemptTask&);
+        ConnectAttemptTask& operator= (const ConnectAttemptTask&);
+
+    private:
+
+        Pointer<ConnectAttempt> attempt;
+
+    public:
+
+        ConnectAttemptTask(Pointer<ConnectAttempt> attempt) : Runnable(), attempt(attempt) {}
+
+        virtual ~ConnectAttemptTask() {}
+
+        virtual void run() {
+            this->attempt->connect();
+        }
+    };
+
+    class FailoverTransportImpl;
+
+    /**
+     * Rebalances the transport once its staggered rebalance delay has passed.
+     */
+    class RebalanceTask : public Runnable {
+    private:
+
+        FailoverTransportImpl* parent;
+
+    private:
+
+        RebalanceTask(const RebalanceTask&);
+        RebalanceTask& operator= (const RebalanceTask&);
+
+    public:
+
+        RebalanceTask(FailoverTransportImpl* parent) : Runnable(), parent(parent) {}
+
+        virtual ~RebalanceTask() {}
+
+        virtual void run();
+    };
+
+    /**
+     * Writes what was appended to the outbox to the disk, run at the sync interval so
+     * the sends of that interval share one flush.
+     */
+    class OutboxSyncTask : public Runnable {
+    private:
+
+        Pointer<Outbox> outbox;
+
+    private:
+
+        OutboxSyncTask(const OutboxSyncTask&);
+        OutboxSyncTask& operator= (const OutboxSyncTask&);
+
+    public:
+
+        OutboxSyncTask(Pointer<Outbox> outbox) : Runnable(), outbox(outbox) {}
+
+        virtual ~OutboxSyncTask() {}
+
+        virtual void run() {
+            try {
+                this->outbox->sync();
+            } catch (Exception&) {
+            }
+        }
+    };
+
+    /**
+     * Sends the messages held in the outbox once a broker is connected.
+     */
+    class OutboxDrainTask : public CompositeTask {
+    private:
+
+        FailoverTransport* parent;
+        FailoverTransportImpl* impl;
+
+    private:
+
+        OutboxDrainTask(const OutboxDrainTask&);
+        OutboxDrainTask& operator= (const OutboxDrainTask&);
+
+    public:
+
+        OutboxDrainTask(FailoverTransport* parent, FailoverTransportImpl* impl) :
+            CompositeTask(), parent(parent), impl(impl) {}
+
+        virtual ~OutboxDrainTask() {}
+
+        virtual bool isPending() const;
+
+        virtual bool iterate() {
+            return this->parent->drainOutbox();
+        }
+    };
+
     class FailoverTransportImpl {
     private:
 
@@ -67,6 +468,10 @@ namespace failover {
     public:
 
         static const int DEFAULT_INITIAL_RECONNECT_DELAY;
+        static const int DEFAULT_PARALLEL_CONNECT_TIMEOUT;
+        static const int DEFAULT_REBALANCE_WINDOW;
+        static const int DEFAULT_OUTBOX_SYNC_INTERVAL;
+        static const int OUTBOX_DRAIN_BATCH;
         static const int INFINITE_WAIT;
 
     public:
@@ -96,6 +501,13 @@ namespace failover {
         bool rebalanceUpdateURIs;
         bool priorityBackup;
         bool backupsEnabled;
+        int parallelConnects;
+        long long parallelConnectTimeout;
+        bool consistentHashing;
+        long long rebalanceWindow;
+        std::string outboxFile;
+        long long outboxFileSize;
+        long long outboxSyncInterval;
         volatile bool shutdown;
 
         bool doRebalance;
@@ -118,6 +530,16 @@ namespace failover {
         Pointer<CompositeTaskRunner> taskRunner;
         Pointer<TransportListener> disposedListener;
         Pointer<TransportListener> myTransportListener;
+        Pointer<ThreadPoolExecutor> connectExecutor;
+        Pointer<ConnectAttempt> connectedAttempt;
+        Pointer<TimingWheel::Timeout> rebalanceTimeout;
+        Pointer<Outbox> outbox;
+        Pointer<OpenWireFormat> outboxFormat;
+        Pointer<OutboxDrainTask> outboxDrainTask;
+        Pointer<TimingWheel::Timeout> outboxSyncTimeout;
+        Pointer<ConnectionId> connectionId;
+
+        Random random;
 
         TransportListener* transportListener;
 
@@ -146,6 +568,13 @@ namespace failover {
             rebalanceUpdateURIs(true),
             priorityBackup(false),
             backupsEnabled(false),
+            parallelConnects(1),
+            parallelConnectTimeout(DEFAULT_PARALLEL_CONNECT_TIMEOUT),
+            consistentHashing(true),
+            rebalanceWindow(DEFAULT_REBALANCE_WINDOW),
+            outboxFile(),
+            outboxFileSize(Outbox::DEFAULT_FILE_SIZE),
+            outboxSyncInterval(DEFAULT_OUTBOX_SYNC_INTERVAL),
             shutdown(false),
             doRebalance(false),
             connectedToPrioirty(false),
@@ -164,19 +593,39 @@ namespace failover {
             taskRunner(new CompositeTaskRunner()),
             disposedListener(),
             myTransportListener(new FailoverTransportListener(parent)),
+            connectExecutor(),
+            connectedAttempt(),
+            rebalanceTimeout(),
+            outbox(),
+            outboxFormat(),
+            outboxDrainTask(),
+            outboxSyncTimeout(),
+            connectionId(),
+            random(),
             transportListener(NULL) {
 
             this->backups.reset(
                 new BackupTransportPool(parent, taskRunner, closeTask, uris, updated, priorityUris));
+            this->outboxDrainTask.reset(new OutboxDrainTask(parent, this));
 
             this->taskRunner->addTask(parent);
             this->taskRunner->addTask(this->closeTask.get());
+            this->taskRunner->addTask(this->outboxDrainTask.get());
         }
 
         bool isPriority(const decaf::net::URI& uri) {
             return priorityUris->contains(uri) || uris->isPriority(uri);
         }
 
+        Pointer<ThreadPoolExecutor> getConnectExecutor() {
+            if (this->connectExecutor == NULL) {
+                this->connectExecutor.reset(
+                    new ThreadPoolExecutor(parallelConnects, parallelConnects, 5, TimeUnit::SECONDS,
+                                           new LinkedBlockingQueue<Runnable*>()));
+            }
+            return this->connectExecutor;
+        }
+
         Pointer<URIPool> getConnectList() {
             // Pick an appropriate URI pool, updated is always preferred if updates are
             // enabled and we have any, otherwise we fallback to our original list so that
@@ -188,6 +637,22 @@ namespace failover {
             return uris;
         }
 
+        // Starts resolving the hosts of the socket based URIs in the list so the lookups
+        // overlap the reconnect delay and the attempts on the URIs tried before them.
+        void resolveHostsAhead(Pointer<URIPool> connectList) {
+
+            URIPool candidates(*connectList);
+
+            Pointer< Iterator<URI> > iter(candidates.getURIList().iterator());
+            while (iter->hasNext()) {
+                URI uri = iter->next();
+                std::string scheme = uri.getScheme();
+                if (scheme == "tcp" || scheme == "ssl") {
+                    InetAddress::resolveAsync(uri.getHost());
+                }
+            }
+        }
+
         void doDelay() {
             if (reconnectDelay > 0) {
                 synchronized (&sleepMutex) {
@@ -283,9 +748,191 @@ namespace failover {
         bool willReconnect() {
             return firstConnection || 0 != calculateReconnectAttemptLimit();
         }
+
+        /**
+         * Delays a rebalance by a random part of the rebalance window so that the clients
+         * of a broker told about the same update don't all reconnect at once.  A rebalance
+         * already waiting its turn covers this one.  This must be called with the reconnect
+         * mutex locked.
+         */
+        void scheduleRebalance() {
+            if (this->rebalanceTimeout == NULL) {
+                long long delay = random.nextInt((int) rebalanceWindow) + 1;
+                this->rebalanceTimeout = TimingWheel::getSharedInstance().schedule(
+                    Pointer<Runnable>(new RebalanceTask(this)), delay);
+            }
+        }
+
+        void cancelRebalance() {
+            if (this->rebalanceTimeout != NULL) {
+                this->rebalanceTimeout->cancel();
+                this->rebalanceTimeout.reset(NULL);
+            }
+        }
+
+        void openOutbox() {
+            if (this->outboxFile.empty() || this->outbox != NULL) {
+                return;
+            }
+
+            // Frames that wait on disk can't refer to the marshal cache of a connection,
+            // so the outbox has a wire format of its own with the cache turned off.
+            Properties properties;
+            this->outboxFormat.reset(new OpenWireFormat(properties));
+            this->outboxFormat->setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+            this->outboxFormat->setCacheEnabled(false);
+
+            this->outbox.reset(new Outbox(this->outboxFile, this->outboxFileSize));
+
+            if (this->outboxSyncInterval > 0) {
+                this->outboxSyncTimeout = TimingWheel::getSharedInstance().schedule(
+                    Pointer<Runnable>(new OutboxSyncTask(this->outbox)), outboxSyncInterval, outboxSyncInterval);
+            }
+        }
+
+        void closeOutbox() {
+            if (this->outboxSyncTimeout != NULL) {
+                this->outboxSyncTimeout->cancel();
+                this->outboxSyncTimeout.reset(NULL);
+            }
+
+            if (this->outbox != NULL) {
+                this->outbox->close();
+            }
+        }
+
+        /**
+         * Only one way messages outside of a transaction go through the outbox, anything
+         * that waits on a response has to reach a broker before the send completes.
+         */
+        bool isOutboxCandidate(const Command& command) const {
+            if (!command.isMessage() || command.isResponseRequired()) {
+                return false;
+            }
+
+            const Message* message = dynamic_cast<const Message*>(&command);
+            return message != NULL && message->getTransactionId() == NULL;
+        }
+
+        /**
+         * This must be called with the reconnect mutex locked.
+         */
+        bool isOutboxDrainPending() const {
+            return this->outbox != NULL && this->connectedTransport != NULL &&
+                   this->connectionId != NULL && !this->closed && !this->outbox->isEmpty();
+        }
+
+        /**
+         * Appends the message to the outbox if there is no broker to send it to, or if
+         * messages sent earlier are still waiting there so that it doesn't overtake them.
+         * A full outbox holds up the send until the drain makes room.
+         *
+         * @return true if the message was appended, false if it is to be sent directly.
+         */
+        bool appendToOutbox(const Pointer<Command> command, const Transport* parent) {
+
+            if (!isOutboxCandidate(*command)) {
+                return false;
+            }
+
+            synchronized(&reconnectMutex) {
+
+                if (this->connectedTransport != NULL && this->outbox->isEmpty()) {
+                    return false;
+                }
+
+                ByteArrayOutputStream bytes;
+                DataOutputStream out(&bytes);
+                this->outboxFormat->marshal(command, parent, &out);
+                out.flush();
+
+                std::pair<unsigned char*, int> frame = bytes.toByteArray();
+                ArrayPointer<unsigned char> buffer(frame.first, frame.second);
+
+                long long start = System::currentTimeMillis();
+
+                while (!this->outbox->append(buffer.get(), buffer.length())) {
+
+                    if (this->closed) {
+                        throw IOException(__FILE__, __LINE__, "Transport disposed.");
+                    }
+
+                    if (this->timeout > 0 && System::currentTimeMillis() - start > this->timeout) {
+                        throw IOException(__FILE__, __LINE__,
+                            "Failover timeout of %d ms reached while the outbox was full.", (int) this->timeout);
+                    }
+
+                    reconnectMutex.wait(100);
+                }
+
+                if (this->connectedTransport != NULL) {
+                    this->taskRunner->wakeup();
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Reads a message back from the outbox.  One appended by an earlier connection is
+         * moved over to the current one, it keeps its message id so the broker can still
+         * tell it apart from a copy that was delivered before a crash.
+         */
+        Pointer<Command> readFromOutbox(std::vector<unsigned char>& frame, const Pointer<ConnectionId> current) {
+
+            ByteArrayInputStream bytesIn(&frame[0], (int) frame.size());
+            DataInputStream dataIn(&bytesIn);
+
+            Pointer<Command> command = this->outboxFormat->unmarshal(NULL, &dataIn);
+
+            Pointer<Message> message = command.dynamicCast<Message>();
+            const Pointer<ProducerId>& producerId = message->getProducerId();
+            if (producerId != NULL && producerId->getConnectionId() != current->getValue()) {
+                Pointer<ProducerId> moved(producerId->cloneDataStructure());
+                moved->setConnectionId(current->getValue());
+                message->setProducerId(moved);
+            }
+
+            return command;
+        }
+
+        void rebalanceNow() {
+            synchronized(&reconnectMutex) {
+                if (this->rebalanceTimeout == NULL || this->rebalanceTimeout->isCancelled()) {
+                    return;
+                }
+
+                this->rebalanceTimeout.reset(NULL);
+
+                if (started) {
+                    this->doRebalance = true;
+                    try {
+                        this->taskRunner->wakeup();
+                    } catch (InterruptedException& ex) {
+                        Thread::currentThread()->interrupt();
+                    }
+                }
+            }
+        }
     };
 
+    void RebalanceTask::run() {
+        this->parent->rebalanceNow();
+    }
+
+    bool OutboxDrainTask::isPending() const {
+        synchronized(&this->impl->reconnectMutex) {
+            return this->impl->isOutboxDrainPending();
+        }
+
+        return false;
+    }
+
     const int FailoverTransportImpl::DEFAULT_INITIAL_RECONNECT_DELAY = 10;
+    const int FailoverTransportImpl::DEFAULT_PARALLEL_CONNECT_TIMEOUT = 30000;
+    const int FailoverTransportImpl::DEFAULT_REBALANCE_WINDOW = 5000;
+    const int FailoverTransportImpl::DEFAULT_OUTBOX_SYNC_INTERVAL = 100;
+    const int FailoverTransportImpl::OUTBOX_DRAIN_BATCH = 64;
     const int FailoverTransportImpl::INFINITE_WAIT = -1;
 
 }}}
@@ -399,12 +1046,34 @@ std::string FailoverTransport::getRemoteAddress() const {
 ////////////////////////////////////////////////////////////////////////////////
 void FailoverTransport::oneway(const Pointer<Command> command) {
 
+    if (command != NULL && this->impl->outbox != NULL) {
+        try {
+            if (this->impl->appendToOutbox(command, this)) {
+                return;
+            }
+        }
+        AMQ_CATCH_RETHROW(IOException)
+        AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+        AMQ_CATCHALL_THROW(IOException)
+    }
+
     Pointer<Exception> error;
 
     try {
 
         synchronized(&this->impl->reconnectMutex) {
 
+            if (command != NULL && command->isConnectionInfo()) {
+                Pointer<ConnectionInfo> info = command.dynamicCast<ConnectionInfo>();
+                this->impl->connectionId = info->getConnectionId();
+
+                if (this->impl->consistentHashing) {
+                    // Hash the brokers the cluster hands out by client id so every client
+                    // settles on its own broker of the list rather than all on the first.
+                    this->impl->updated->setHashKey(info->getClientId());
+                }
+            }
+
             if (command != NULL && this->impl->connectedTransport == NULL) {
 
                 if (command->isShutdownInfo()) {
@@ -504,6 +1173,16 @@ void FailoverTransport::oneway(const Pointer<Command> command) {
                         if (command->isShutdownInfo()) {
                             this->impl->shutdown = true;
                         }
+                    } catch (WriteQueueFullException& e) {
+
+                        // The message was refused but the transport is fine, the sender
+                        // is told and nothing is failed over.
+                        if (command->isResponseRequired()) {
+                            this->impl->requestMap.remove(command->getCommandId());
+                        }
+                        e.setMark(__FILE__, __LINE__);
+                        error.reset(e.clone());
+                        break;
                     } catch (IOException& e) {
 
                         e.setMark(__FILE__, __LINE__);
@@ -517,8 +1196,10 @@ void FailoverTransport::oneway(const Pointer<Command> command) {
                                 this->impl->requestMap.remove(command->getCommandId());
                             }
 
-                            // re-throw the exception so it will handled by the outer catch
-                            throw;
+                            // Fail over and go round again, handled here rather than by
+                            // rethrowing to the outer catch as the failure is expected.
+                            handleTransportFailure(e);
+                            continue;
                         } else {
                             // Trigger the reconnect since we can't count on inactivity or
                             // other socket events to trip the failover condition.
@@ -578,6 +1259,7 @@ void FailoverTransport::start() {
             if (this->impl->backupsEnabled || this->impl->priorityBackup) {
                 this->impl->backups->setEnabled(true);
             }
+            this->impl->openOutbox();
             this->impl->taskRunner->start();
 
             stateTracker.setMaxMessageCacheSize(this->getMaxCacheSize());
@@ -630,6 +1312,7 @@ void FailoverTransport::close() {
 
             this->impl->backups->setEnabled(false);
             this->impl->requestMap.clear();
+            this->impl->cancelRebalance();
 
             if (this->impl->connectedTransport != NULL) {
                 transportToStop.swap(this->impl->connectedTransport);
@@ -645,6 +1328,12 @@ void FailoverTransport::close() {
         }
 
         this->impl->taskRunner->shutdown(TimeUnit::MINUTES.toMillis(5));
+        this->impl->closeOutbox();
+
+        if (this->impl->connectExecutor != NULL) {
+            this->impl->connectExecutor->shutdown();
+            this->impl->connectExecutor->awaitTermination(5, TimeUnit::MINUTES);
+        }
 
         if (transportToStop != NULL) {
             transportToStop->close();
@@ -664,6 +1353,12 @@ void FailoverTransport::reconnect(bool rebalance) {
         if (this->impl->started) {
 
             if (rebalance) {
+                if (this->impl->connectedTransport != NULL && this->impl->rebalanceWindow > 0) {
+                    this->impl->scheduleRebalance();
+                    return;
+                }
+
+                this->impl->cancelRebalance();
                 this->impl->doRebalance = true;
             }
 
@@ -683,21 +1378,47 @@ void FailoverTransport::restoreTransport(const Pointer<Transport> transport) {
 
         transport->start();
 
-        //send information to the broker - informing it we are an ft client
-        Pointer<ConnectionControl> cc(new ConnectionControl());
-        cc->setFaultTolerant(true);
-        transport->oneway(cc);
+        // None of the restore commands wait on a response, so rather than flushing the
+        // socket once per command they are written back to back and go out in buffer
+        // sized batches, the responses are then handled as they arrive.
+        IOTransport* ioTransport = dynamic_cast<IOTransport*>(transport->narrow(typeid(IOTransport)));
+        if (ioTransport != NULL && !ioTransport->isWriteBatching()) {
+            ioTransport->setFlushDeferred(true);
+        } else {
+            ioTransport = NULL;
+        }
+
+        try {
+
+            //send information to the broker - informing it we are an ft client
+            Pointer<ConnectionControl> cc(new ConnectionControl());
+            cc->setFaultTolerant(true);
+            transport->oneway(cc);
 
-        stateTracker.restore(transport);
+            stateTracker.restore(transport);
 
-        decaf::util::StlMap<int, Pointer<Command> > commands;
-        synchronized(&this->impl->requestMap) {
-            commands.copy(this->impl->requestMap);
+            decaf::util::StlMap<int, Pointer<Command> > commands;
+            synchronized(&this->impl->requestMap) {
+                commands.copy(this->impl->requestMap);
+            }
+
+            Pointer<Iterator<Pointer<Command> > > iter(commands.values().iterator());
+            while (iter->hasNext()) {
+                transport->oneway(iter->next());
+            }
+
+        } catch (Exception& ex) {
+            if (ioTransport != NULL) {
+                try {
+                    ioTransport->setFlushDeferred(false);
+                } catch (...) {
+                }
+            }
+            throw;
         }
 
-        Pointer<Iterator<Pointer<Command> > > iter(commands.values().iterator());
-        while (iter->hasNext()) {
-            transport->oneway(iter->next());
+        if (ioTransport != NULL) {
+            ioTransport->setFlushDeferred(false);
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -845,6 +1566,10 @@ void FailoverTransport::updateURIs(bool rebalance, const decaf::util::List<decaf
             if (!(copy->isEmpty() && this->impl->updated->isEmpty()) &&
                 !(copy->equals(*this->impl->updated))) {
 
+                // Backups to brokers that are still listed are kept rather than
+                // reopened, those to brokers that went away are closed.
+                this->impl->backups->retainBackups(*this->impl->updated);
+
                 synchronized(&this->impl->reconnectMutex) {
                     reconnect(rebalance);
                 }
@@ -875,6 +1600,54 @@ bool FailoverTransport::isPending() const {
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::drainOutbox() {
+
+    Pointer<Transport> transport;
+    Pointer<ConnectionId> connectionId;
+
+    synchronized(&this->impl->reconnectMutex) {
+        if (!this->impl->isOutboxDrainPending()) {
+            return false;
+        }
+
+        transport = this->impl->connectedTransport;
+        connectionId = this->impl->connectionId;
+    }
+
+    std::vector<unsigned char> frame;
+
+    for (int i = 0; i < FailoverTransportImpl::OUTBOX_DRAIN_BATCH && this->impl->outbox->peek(frame); ++i) {
+
+        Pointer<Command> command;
+        try {
+            command = this->impl->readFromOutbox(frame, connectionId);
+        } catch (Exception&) {
+            // A frame that can't be read would hold up every message behind it.
+            this->impl->outbox->consume();
+            continue;
+        }
+
+        try {
+            transport->oneway(command);
+        } catch (IOException& ex) {
+            // The message stays in the outbox and is sent again after the reconnect.
+            ex.setMark(__FILE__, __LINE__);
+            handleTransportFailure(ex);
+            return false;
+        }
+
+        this->impl->outbox->consume();
+    }
+
+    // Senders waiting on a full outbox can carry on.
+    synchronized(&this->impl->reconnectMutex) {
+        this->impl->reconnectMutex.notifyAll();
+    }
+
+    return !this->impl->outbox->isEmpty();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool FailoverTransport::iterate() {
 
@@ -897,7 +1670,8 @@ bool FailoverTransport::iterate() {
             } else {
 
                 if (this->impl->doRebalance) {
-                    if (this->impl->connectedToPrioirty || connectList->getPriorityURI().equals(*this->impl->connectedTransportURI)) {
+                    if (this->impl->connectedToPrioirty ||
+                        (this->impl->connectedTransportURI != NULL && connectList->isPreferred(*this->impl->connectedTransportURI))) {
                         // already connected to first in the list, no need to rebalance
                         this->impl->doRebalance = false;
                         return false;
@@ -928,6 +1702,10 @@ bool FailoverTransport::iterate() {
                     }
                 }
 
+                if (transport == NULL) {
+                    this->impl->resolveHostsAhead(connectList);
+                }
+
                 // Sleep for the reconnectDelay if there's no backup and we aren't trying
                 // for the first time, or we were disposed for some reason.
                 if (transport == NULL && !this->impl->firstConnection &&
@@ -943,8 +1721,16 @@ bool FailoverTransport::iterate() {
 
                 while ((transport != NULL || !connectList->isEmpty()) && this->impl->connectedTransport == NULL && !this->impl->closed) {
                     try {
+                        bool transportStarted = false;
+
                         // We could be starting the loop with a backup already.
-                        if (transport == NULL) {
+                        if (transport == NULL && this->impl->parallelConnects > 1) {
+                            transport = connectInParallel(connectList, failures, uri, failure);
+                            if (transport == NULL) {
+                                continue;
+                            }
+                            transportStarted = true;
+                        } else if (transport == NULL) {
                             try {
                                 uri = connectList->getURI();
                             } catch (NoSuchElementException& ex) {
@@ -954,8 +1740,10 @@ bool FailoverTransport::iterate() {
                             transport = createTransport(uri);
                         }
 
-                        transport->setTransportListener(this->impl->myTransportListener.get());
-                        transport->start();
+                        if (!transportStarted) {
+                            transport->setTransportListener(this->impl->myTransportListener.get());
+                            transport->start();
+                        }
 
                         if (this->impl->started && !this->impl->firstConnection) {
                             restoreTransport(transport);
@@ -1056,6 +1844,76 @@ bool FailoverTransport::iterate() {
     return !this->impl->closed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> FailoverTransport::connectInParallel(Pointer<URIPool> connectList, List<URI>& failures,
+                                                        URI& uri, Pointer<Exception>& failure) {
+
+    LinkedList<URI> candidates;
+    connectList->getURIs(this->impl->parallelConnects, candidates, this->impl->priorityBackup);
+
+    LinkedList<URI> created;
+    std::vector< Pointer<Transport> > transports;
+    std::auto_ptr<Iterator<URI> > iter(candidates.iterator());
+    while (iter->hasNext()) {
+        URI candidate = iter->next();
+        try {
+            transports.push_back(createTransport(candidate));
+            created.add(candidate);
+        } catch (Exception& ex) {
+            failures.add(candidate);
+            failure.reset(ex.clone());
+        }
+    }
+
+    if (transports.empty()) {
+        return Pointer<Transport>();
+    }
+
+    Pointer<ConnectRace> race(new ConnectRace((int) transports.size()));
+    std::vector< Pointer<ConnectAttempt> > attempts;
+    for (int index = 0; index < (int) transports.size(); ++index) {
+        attempts.push_back(Pointer<ConnectAttempt>(new ConnectAttempt(
+            index, created.get(index), transports[index], connectList, race,
+            this->impl->parallelConnectTimeout)));
+    }
+
+    Pointer<ThreadPoolExecutor> executor = this->impl->getConnectExecutor();
+    std::vector< Pointer<ConnectAttempt> >::const_iterator attempt = attempts.begin();
+    for (; attempt != attempts.end(); ++attempt) {
+        executor->execute(new ConnectAttemptTask(*attempt));
+    }
+
+    int winner = race->await();
+
+    for (int index = 0; index < (int) attempts.size(); ++index) {
+        if (index != winner) {
+            attempts[index]->cancel();
+            failures.add(attempts[index]->getURI());
+            if (attempts[index]->getFailure() != NULL) {
+                failure = attempts[index]->getFailure();
+            }
+        }
+    }
+
+    if (winner < 0) {
+        return Pointer<Transport>();
+    }
+
+    Pointer<ConnectAttempt> connected = attempts[winner];
+    if (!connected->handOver(this->impl->myTransportListener.get())) {
+        failures.add(connected->getURI());
+        failure = connected->getFailure();
+        connected->dispose();
+        return Pointer<Transport>();
+    }
+
+    // The attempt must outlive any call the Transport is still making into it.
+    this->impl->connectedAttempt = connected;
+    uri = connected->getURI();
+
+    return connected->getTransport();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<Transport> FailoverTransport::createTransport(const URI& location) const {
 
@@ -1263,6 +2121,33 @@ void FailoverTransport::setBackupPoolSize(int value) {
     this->impl->backups->setBackupPoolSize(value);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int FailoverTransport::getParallelConnects() const {
+    return this->impl->parallelConnects;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setParallelConnects(int value) {
+    synchronized(&this->impl->reconnectMutex) {
+        // The executor is sized for the old value so it is replaced on the next connect.
+        if (this->impl->connectExecutor != NULL && value != this->impl->parallelConnects) {
+            this->impl->connectExecutor->shutdown();
+            this->impl->connectExecutor.reset(NULL);
+        }
+        this->impl->parallelConnects = value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getParallelConnectTimeout() const {
+    return this->impl->parallelConnectTimeout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setParallelConnectTimeout(long long value) {
+    this->impl->parallelConnectTimeout = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool FailoverTransport::isTrackMessages() const {
     return this->impl->trackMessages;
@@ -1333,6 +2218,95 @@ void FailoverTransport::setRebalanceUpdateURIs(bool rebalanceUpdateURIs) {
     this->impl->rebalanceUpdateURIs = rebalanceUpdateURIs;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool FailoverTransport::isConsistentHashing() const {
+    return this->impl->consistentHashing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setConsistentHashing(bool value) {
+    this->impl->consistentHashing = value;
+    if (!value) {
+        this->impl->updated->setHashKey("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getRebalanceWindow() const {
+    return this->impl->rebalanceWindow;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setRebalanceWindow(long long value) {
+    this->impl->rebalanceWindow = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FailoverTransport::getOutboxFile() const {
+    return this->impl->outboxFile;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setOutboxFile(const std::string& value) {
+    this->impl->outboxFile = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getOutboxFileSize() const {
+    return this->impl->outboxFileSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setOutboxFileSize(long long value) {
+    this->impl->outboxFileSize = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getOutboxSyncInterval() const {
+    return this->impl->outboxSyncInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setOutboxSyncInterval(long long value) {
+    this->impl->outboxSyncInterval = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getOutboxPendingCount() const {
+    Pointer<Outbox> outbox = this->impl->outbox;
+    return outbox != NULL ? outbox->getPendingCount() : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getTransactionSpoolSize() const {
+    return this->stateTracker.getTransactionSpoolSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setTransactionSpoolSize(long long value) {
+    this->stateTracker.setTransactionSpoolSize(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FailoverTransport::getTransactionSpoolDirectory() const {
+    return this->stateTracker.getTransactionSpoolDirectory();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setTransactionSpoolDirectory(const std::string& value) {
+    this->stateTracker.setTransactionSpoolDirectory(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FailoverTransport::getTransactionSpoolFileSize() const {
+    return this->stateTracker.getTransactionSpoolFileSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransport::setTransactionSpoolFileSize(long long value) {
+    this->stateTracker.setTransactionSpoolFileSize(value);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool FailoverTransport::isPriorityBackup() const {
     return this->impl->priorityBackup;
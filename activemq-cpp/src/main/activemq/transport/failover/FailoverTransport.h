@@ -43,7 +43,9 @@ namespace failover {
 
     class FailoverTransportListener;
     class BackupTransportPool;
+    class URIPool;
     class FailoverTransportImpl;
+    class OutboxDrainTask;
 
     class AMQCPP_API FailoverTransport : public CompositeTransport,
                                          public activemq::threads::CompositeTask {
@@ -51,6 +53,7 @@ namespace failover {
 
         friend class FailoverTransportListener;
         friend class BackupTransportPool;
+        friend class OutboxDrainTask;
 
         state::ConnectionStateTracker stateTracker;
 
@@ -129,6 +132,13 @@ namespace failover {
 
         void setInitialized(bool value);
 
+        /**
+         * @return the tracker holding the state this transport restores when it reconnects.
+         */
+        const state::ConnectionStateTracker& getStateTracker() const {
+            return this->stateTracker;
+        }
+
         virtual Transport* narrow(const std::type_info& typeId);
 
         virtual std::string getRemoteAddress() const;
@@ -200,6 +210,39 @@ namespace failover {
 
         void setBackupPoolSize(int value);
 
+        /**
+         * Gets the number of URIs that are connected to at the same time when this
+         * transport needs to connect, a value of one or less connects serially.
+         *
+         * @return the number of URIs raced against each other on a connect.
+         */
+        int getParallelConnects() const;
+
+        /**
+         * Sets the number of URIs that are connected to at the same time when this
+         * transport needs to connect.  The URIs with the lowest average connect time
+         * are tried and the first to complete its WireFormatInfo exchange is used,
+         * the others are closed and returned to the pool.
+         *
+         * @param value
+         *      The number of URIs to race, one or less connects serially.
+         */
+        void setParallelConnects(int value);
+
+        /**
+         * @return the time in milliseconds a parallel connect waits for a WireFormatInfo.
+         */
+        long long getParallelConnectTimeout() const;
+
+        /**
+         * Sets how long, in milliseconds, each parallel connect attempt waits for the
+         * broker's WireFormatInfo before it is considered failed, zero waits forever.
+         *
+         * @param value
+         *      The time to wait in milliseconds.
+         */
+        void setParallelConnectTimeout(long long value);
+
         bool isTrackMessages() const;
 
         void setTrackMessages(bool value);
@@ -228,6 +271,107 @@ namespace failover {
 
         void setRebalanceUpdateURIs(bool rebalanceUpdateURIs);
 
+        bool isConsistentHashing() const;
+
+        /**
+         * When enabled the broker URIs handed out by the cluster are ordered for this
+         * client by hashing them with its client id, so the clients of a cluster spread
+         * over its brokers and a change to the list only moves the clients whose broker
+         * was added or removed.  The configured URIs are not affected.
+         *
+         * @param value
+         *      True to hash the updated URIs by client id, enabled by default.
+         */
+        void setConsistentHashing(bool value);
+
+        long long getRebalanceWindow() const;
+
+        /**
+         * Sets the window in milliseconds over which a rebalance requested by the broker
+         * is spread.  Each client waits a random part of the window before it reconnects
+         * so a cluster update doesn't reconnect all clients at the same moment.
+         *
+         * @param value
+         *      The window in milliseconds, zero rebalances at once, default is 5000.
+         */
+        void setRebalanceWindow(long long value);
+
+        std::string getOutboxFile() const;
+
+        /**
+         * Sets the file of the outbox that holds the messages sent while no broker is
+         * connected.  With an outbox a one way message that is not part of a transaction
+         * is appended to the file instead of holding up the producer until a broker is
+         * found, and the held messages are sent in order once one is.  The file keeps
+         * them across a restart of the client.  The outbox is opened when the transport
+         * is started.
+         *
+         * @param value
+         *      The name of the outbox file, empty for no outbox which is the default.
+         */
+        void setOutboxFile(const std::string& value);
+
+        long long getOutboxFileSize() const;
+
+        /**
+         * Sets the size of the outbox file, which bounds the messages it can hold.  A send
+         * that finds the outbox full waits for room, for at most the failover timeout.
+         *
+         * @param value
+         *      The size of the outbox file in bytes, default is 64MB.
+         */
+        void setOutboxFileSize(long long value);
+
+        long long getOutboxSyncInterval() const;
+
+        /**
+         * Sets how often the messages appended to the outbox are written to the disk, the
+         * sends of one interval share a single flush.  Messages appended since the last
+         * flush survive the failure of the process but not of the machine.
+         *
+         * @param value
+         *      The interval in milliseconds, zero leaves the writes to the operating
+         *      system, default is 100.
+         */
+        void setOutboxSyncInterval(long long value);
+
+        /**
+         * @return the number of messages waiting in the outbox to be sent.
+         */
+        long long getOutboxPendingCount() const;
+
+        long long getTransactionSpoolSize() const;
+
+        /**
+         * Sets the bytes of messages each tracked transaction holds in memory for replay
+         * after a failover.  The messages a transaction sends after passing the limit are
+         * written to memory mapped temporary files instead, which are removed when the
+         * transaction ends.  A send fails if the file can't be created.
+         *
+         * @param value
+         *      The bytes held in memory for each transaction, zero or less holds every
+         *      message in memory which is the default.
+         */
+        void setTransactionSpoolSize(long long value);
+
+        std::string getTransactionSpoolDirectory() const;
+
+        /**
+         * @param value
+         *      The directory the files of the spooled transactions are created in, empty
+         *      for the system's temporary directory which is the default.
+         */
+        void setTransactionSpoolDirectory(const std::string& value);
+
+        long long getTransactionSpoolFileSize() const;
+
+        /**
+         * @param value
+         *      The size in bytes of each file a spooled transaction writes its messages
+         *      to, a transaction creates more files as it needs them, default is 64MB.
+         */
+        void setTransactionSpoolFileSize(long long value);
+
         bool isPriorityBackup() const;
 
         void setPriorityBackup(bool priorityBackup);
@@ -272,6 +416,14 @@ namespace failover {
 
     private:
 
+        /**
+         * Sends the next batch of the messages held in the outbox on the connected
+         * Transport.
+         *
+         * @return true if more messages are waiting to be sent.
+         */
+        bool drainOutbox();
+
         /**
          * Looks up the correct Factory and create a new Composite version of the
          * Transport requested.
@@ -282,6 +434,23 @@ namespace failover {
          */
         Pointer<Transport> createTransport(const decaf::net::URI& location) const;
 
+        /**
+         * Connects to the fastest of the free URIs in the given pool at the same time
+         * and returns the Transport of the first connect attempt to complete, the
+         * URIs that weren't used are added to the failures list.
+         *
+         * @param connectList - The pool that URIs are taken from.
+         * @param failures - The list that the unused URIs are added to.
+         * @param uri - Updated with the URI of the Transport returned.
+         * @param failure - Updated with the error of a failed attempt.
+         *
+         * @return the started Transport or NULL if none of the attempts connected.
+         */
+        Pointer<Transport> connectInParallel(Pointer<URIPool> connectList,
+                                             decaf::util::List<decaf::net::URI>& failures,
+                                             decaf::net::URI& uri,
+                                             Pointer<decaf::lang::Exception>& failure);
+
         void processNewTransports(bool rebalance, std::string newTransports);
 
         void processResponse(const Pointer<Response> response);
@@ -95,6 +95,10 @@ Pointer<Transport> FailoverTransportFactory::doCreateComposite(const decaf::net:
             Boolean::parseBoolean(topLvlProperties.getProperty("backup", "false")));
         transport->setBackupPoolSize(
             Integer::parseInt(topLvlProperties.getProperty("backupPoolSize", "1")));
+        transport->setParallelConnects(
+            Integer::parseInt(topLvlProperties.getProperty("parallelConnects", "1")));
+        transport->setParallelConnectTimeout(
+            Long::parseLong(topLvlProperties.getProperty("parallelConnectTimeout", "30000")));
         transport->setTimeout(
             Long::parseLong(topLvlProperties.getProperty("timeout", "-1")));
         transport->setTrackMessages(
@@ -107,7 +111,21 @@ Pointer<Transport> FailoverTransportFactory::doCreateComposite(const decaf::net:
             Boolean::parseBoolean(topLvlProperties.getProperty("updateURIsSupported", "true")));
         transport->setPriorityBackup(
             Boolean::parseBoolean(topLvlProperties.getProperty("priorityBackup", "false")));
+        transport->setConsistentHashing(
+            Boolean::parseBoolean(topLvlProperties.getProperty("consistentHashing", "true")));
+        transport->setRebalanceWindow(
+            Long::parseLong(topLvlProperties.getProperty("rebalanceWindow", "5000")));
+        transport->setOutboxFile(topLvlProperties.getProperty("outboxFile", ""));
+        transport->setOutboxFileSize(
+            Long::parseLong(topLvlProperties.getProperty("outboxFileSize", "67108864")));
+        transport->setOutboxSyncInterval(
+            Long::parseLong(topLvlProperties.getProperty("outboxSyncInterval", "100")));
         transport->setPriorityURIs(topLvlProperties.getProperty("priorityURIs", ""));
+        transport->setTransactionSpoolSize(
+            Long::parseLong(topLvlProperties.getProperty("transactionSpoolSize", "0")));
+        transport->setTransactionSpoolDirectory(topLvlProperties.getProperty("transactionSpoolDirectory", ""));
+        transport->setTransactionSpoolFileSize(
+            Long::parseLong(topLvlProperties.getProperty("transactionSpoolFileSize", "67108864")));
 
         transport->addURI(false, data.getComponents());
 
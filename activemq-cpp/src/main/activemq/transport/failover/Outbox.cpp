@@ -0,0 +1,380 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Outbox.h"
+
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+const char Outbox::MAGIC[8] = { 'A', 'M', 'Q', 'O', 'U', 'T', 'B', '1' };
+const int Outbox::HEADER_SIZE = 24;
+const int Outbox::RECORD_HEADER_SIZE = 16;
+const int Outbox::WRAP = -1;
+const long long Outbox::DEFAULT_FILE_SIZE = 64 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void putInt(unsigned char* buffer, int value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            *buffer++ = (unsigned char) (value >> shift);
+        }
+    }
+
+    void putLong(unsigned char* buffer, long long value) {
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            *buffer++ = (unsigned char) (value >> shift);
+        }
+    }
+
+    int getInt(const unsigned char* buffer) {
+        unsigned int value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value = (value << 8) | buffer[i];
+        }
+        return (int) value;
+    }
+
+    long long getLong(const unsigned char* buffer) {
+        unsigned long long value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value = (value << 8) | buffer[i];
+        }
+        return (long long) value;
+    }
+
+    long long align(long long position) {
+        return (position + 7) & ~7LL;
+    }
+
+    // FNV-1a over the sequence number, the length and the frame, so a record left
+    // behind by an earlier trip around the ring doesn't check out in a new one's place.
+    int checksum(long long sequence, const unsigned char* frame, int size) {
+
+        unsigned int hash = 2166136261U;
+
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            hash = (hash ^ (unsigned char) (sequence >> shift)) * 16777619U;
+        }
+
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            hash = (hash ^ (unsigned char) (size >> shift)) * 16777619U;
+        }
+
+        for (int i = 0; i < size; ++i) {
+            hash = (hash ^ frame[i]) * 16777619U;
+        }
+
+        return (int) hash;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Outbox::Outbox(const std::string& path, long long fileSize) :
+    path(path), mutex(), file(), capacity(0), readPosition(HEADER_SIZE), readSequence(1),
+    writePosition(HEADER_SIZE), writeSequence(1), pendingCount(0), pendingBytes(0), dirty(false) {
+
+    if (path.empty()) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Outbox file path cannot be empty.");
+    }
+
+    if (fileSize < HEADER_SIZE + 3 * RECORD_HEADER_SIZE) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Outbox file size is too small: %lld", fileSize);
+    }
+
+    this->file.reset(new MappedFile(path, fileSize, false));
+    this->capacity = this->file->getSize() & ~7LL;
+
+    recover();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Outbox::~Outbox() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Outbox::append(const unsigned char* frame, int size) {
+
+    synchronized(&this->mutex) {
+
+        if (this->file.get() == NULL) {
+            throw IllegalStateException(__FILE__, __LINE__, "Outbox is closed.");
+        }
+
+        long long needed = align(RECORD_HEADER_SIZE + (long long) size);
+
+        if (frame == NULL || size <= 0 || needed + RECORD_HEADER_SIZE > this->capacity - HEADER_SIZE) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "Frame of %d bytes can't be held in the outbox.", size);
+        }
+
+        // Records always leave room for a wrap record before the end of the file, and the
+        // writer never catches up with the reader so equal positions mean an empty ring.
+        long long position = this->writePosition;
+        bool wrap = false;
+
+        if (this->writePosition >= this->readPosition) {
+            if (position + needed + RECORD_HEADER_SIZE > this->capacity) {
+                if (HEADER_SIZE + needed >= this->readPosition) {
+                    return false;
+                }
+                position = HEADER_SIZE;
+                wrap = true;
+            }
+        } else if (position + needed >= this->readPosition) {
+            return false;
+        }
+
+        unsigned char* base = this->file->getAddress();
+        unsigned char* record = base + position;
+
+        putInt(record + 4, checksum(this->writeSequence, frame, size));
+        putLong(record + 8, this->writeSequence);
+        std::memcpy(record + RECORD_HEADER_SIZE, frame, size);
+        putInt(record, size);
+
+        if (wrap) {
+            unsigned char* marker = base + this->writePosition;
+            putInt(marker + 4, 0);
+            putLong(marker + 8, this->writeSequence);
+            putInt(marker, WRAP);
+        }
+
+        this->writePosition = position + needed;
+        this->writeSequence++;
+        this->pendingCount++;
+        this->pendingBytes += size;
+        this->dirty = true;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Outbox::peek(std::vector<unsigned char>& frame) const {
+
+    synchronized(&this->mutex) {
+
+        if (this->file.get() == NULL || this->pendingCount == 0) {
+            return false;
+        }
+
+        const unsigned char* record = this->file->getAddress() + nextRecord(this->readPosition);
+        int size = getInt(record);
+        frame.assign(record + RECORD_HEADER_SIZE, record + RECORD_HEADER_SIZE + size);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Outbox::consume() {
+
+    synchronized(&this->mutex) {
+
+        if (this->file.get() == NULL || this->pendingCount == 0) {
+            return;
+        }
+
+        long long position = nextRecord(this->readPosition);
+        int size = getInt(this->file->getAddress() + position);
+
+        this->readSequence++;
+        this->pendingCount--;
+        this->pendingBytes -= size;
+
+        if (this->pendingCount == 0) {
+            this->readPosition = HEADER_SIZE;
+            this->writePosition = HEADER_SIZE;
+        } else {
+            this->readPosition = align(position + RECORD_HEADER_SIZE + size);
+        }
+
+        writeHeader();
+        this->dirty = true;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Outbox::sync() {
+
+    synchronized(&this->mutex) {
+
+        if (this->file.get() == NULL || !this->dirty) {
+            return false;
+        }
+
+        this->file->sync();
+        this->dirty = false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Outbox::close() {
+
+    synchronized(&this->mutex) {
+
+        if (this->file.get() == NULL) {
+            return;
+        }
+
+        try {
+            if (this->dirty) {
+                this->file->sync();
+            }
+        } catch (IOException&) {
+        }
+
+        this->file->close();
+        this->file.reset(NULL);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Outbox::isEmpty() const {
+    synchronized(&this->mutex) {
+        return this->pendingCount == 0;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Outbox::getPendingCount() const {
+    synchronized(&this->mutex) {
+        return this->pendingCount;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Outbox::getPendingBytes() const {
+    synchronized(&this->mutex) {
+        return this->pendingBytes;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Outbox::recover() {
+
+    const unsigned char* base = this->file->getAddress();
+
+    if (std::memcmp(base, MAGIC, sizeof(MAGIC)) == 0) {
+        this->readPosition = getLong(base + 8);
+        this->readSequence = getLong(base + 16);
+    }
+
+    // A new file, or a header that makes no sense, starts an empty ring.
+    if (std::memcmp(base, MAGIC, sizeof(MAGIC)) != 0 || this->readSequence < 1 ||
+        this->readPosition < HEADER_SIZE || this->readPosition % 8 != 0 ||
+        this->readPosition + RECORD_HEADER_SIZE > this->capacity) {
+
+        this->readPosition = HEADER_SIZE;
+        this->readSequence = 1;
+    }
+
+    long long position = this->readPosition;
+    long long sequence = this->readSequence;
+    bool wrapped = false;
+
+    while (position + RECORD_HEADER_SIZE <= this->capacity) {
+
+        const unsigned char* record = base + position;
+        int size = getInt(record);
+
+        if (getLong(record + 8) != sequence) {
+            break;
+        }
+
+        if (size == WRAP) {
+            if (wrapped) {
+                break;
+            }
+            wrapped = true;
+            position = HEADER_SIZE;
+            continue;
+        }
+
+        long long end = position + RECORD_HEADER_SIZE + (long long) size;
+        if (size <= 0 || end > this->capacity || (wrapped && end >= this->readPosition) ||
+            getInt(record + 4) != checksum(sequence, record + RECORD_HEADER_SIZE, size)) {
+            break;
+        }
+
+        this->pendingCount++;
+        this->pendingBytes += size;
+        sequence++;
+        position = align(end);
+    }
+
+    this->writeSequence = sequence;
+
+    if (this->pendingCount == 0) {
+        this->readPosition = HEADER_SIZE;
+        this->readSequence = sequence;
+        this->writePosition = HEADER_SIZE;
+    } else {
+        this->writePosition = position;
+    }
+
+    writeHeader();
+    this->dirty = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Outbox::writeHeader() {
+
+    unsigned char* base = this->file->getAddress();
+
+    std::memcpy(base, MAGIC, sizeof(MAGIC));
+    putLong(base + 8, this->readPosition);
+    putLong(base + 16, this->readSequence);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Outbox::nextRecord(long long position) const {
+
+    if (getInt(this->file->getAddress() + position) == WRAP) {
+        return HEADER_SIZE;
+    }
+
+    return position;
+}
@@ -0,0 +1,218 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_FAILOVER_OUTBOX_H_
+#define _ACTIVEMQ_TRANSPORT_FAILOVER_OUTBOX_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace decaf {
+namespace internal {
+namespace io {
+    class MappedFile;
+}}}
+
+namespace activemq {
+namespace transport {
+namespace failover {
+
+    /**
+     * A journal of encoded frames kept in a memory mapped file, which the FailoverTransport
+     * uses to hold the messages a producer sends while no broker is connected and to
+     * replay them in order once one is.  Appending a frame costs a copy into the mapped
+     * region, sync writes the frames appended since the last sync to the disk so that
+     * many appends share a single flush.  Frames that were appended but not yet synced
+     * can be lost if the machine fails, a failure of the process loses nothing.
+     *
+     * The file is used as a ring.  It begins with a header of HEADER_SIZE bytes: the
+     * eight byte MAGIC followed by the eight byte position and sequence number of the
+     * oldest frame not yet consumed.  It is followed by records of a four byte frame
+     * length, a four byte checksum of the frame, the eight byte sequence number of the
+     * record and the frame itself, each record starting on an eight byte boundary.  A
+     * record that doesn't fit before the end of the file is preceded by a wrap record,
+     * whose length is WRAP, and written at the start of the ring.  All values are big
+     * endian.  The length of a record is written last so a record cut short by a crash
+     * is never seen as complete, opening the file again finds the frames from the
+     * header's position onwards for as long as the sequence numbers follow on and the
+     * checksums match.
+     *
+     * The methods are thread safe.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API Outbox {
+    public:
+
+        /**
+         * The bytes the outbox file starts with.
+         */
+        static const char MAGIC[8];
+
+        /**
+         * Size in bytes of the header at the start of the file.
+         */
+        static const int HEADER_SIZE;
+
+        /**
+         * Size in bytes of the fields that precede each frame.
+         */
+        static const int RECORD_HEADER_SIZE;
+
+        /**
+         * The length of the record that sends the reader back to the start of the ring.
+         */
+        static const int WRAP;
+
+        /**
+         * Default size of the outbox file in bytes.
+         */
+        static const long long DEFAULT_FILE_SIZE;
+
+    private:
+
+        std::string path;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+        std::auto_ptr<decaf::internal::io::MappedFile> file;
+        long long capacity;
+        long long readPosition;
+        long long readSequence;
+        long long writePosition;
+        long long writeSequence;
+        long long pendingCount;
+        long long pendingBytes;
+        bool dirty;
+
+    private:
+
+        Outbox(const Outbox&);
+        Outbox& operator= (const Outbox&);
+
+    public:
+
+        /**
+         * Opens the outbox file, creating it if it doesn't exist, and recovers the frames
+         * that were appended and not consumed before it was last closed.  An existing file
+         * larger than the requested size keeps its size.
+         *
+         * @param path
+         *      The name of the outbox file.
+         * @param fileSize
+         *      The size of the file in bytes.
+         *
+         * @throws IOException if the file can't be opened.
+         * @throws IllegalArgumentException if the path is empty or the file size can't
+         *         hold the header and a record.
+         */
+        Outbox(const std::string& path, long long fileSize = DEFAULT_FILE_SIZE);
+
+        virtual ~Outbox();
+
+        /**
+         * Appends a frame after the ones already held.
+         *
+         * @param frame
+         *      The encoded frame.
+         * @param size
+         *      The number of bytes in the frame.
+         *
+         * @return true if the frame was appended, false if there is no room for it
+         *         until more frames are consumed.
+         *
+         * @throws IllegalStateException if the outbox is closed.
+         * @throws IllegalArgumentException if the frame could never fit in the file.
+         */
+        bool append(const unsigned char* frame, int size);
+
+        /**
+         * Copies out the oldest frame that has not been consumed.
+         *
+         * @param frame
+         *      The vector the frame is copied into.
+         *
+         * @return true if there was a frame, false if the outbox is empty.
+         */
+        bool peek(std::vector<unsigned char>& frame) const;
+
+        /**
+         * Removes the oldest frame, once it has been sent on.  Does nothing if the outbox
+         * is empty.
+         */
+        void consume();
+
+        /**
+         * Writes the frames appended and consumed since the last sync to the disk.
+         *
+         * @return true if there was anything to write.
+         *
+         * @throws IOException if the file can't be written.
+         */
+        bool sync();
+
+        /**
+         * Syncs and unmaps the file, the frames it holds are recovered the next time it
+         * is opened.
+         */
+        void close();
+
+        /**
+         * @return true if there are no frames waiting to be consumed.
+         */
+        bool isEmpty() const;
+
+        /**
+         * @return the number of frames waiting to be consumed.
+         */
+        long long getPendingCount() const;
+
+        /**
+         * @return the number of frame bytes waiting to be consumed.
+         */
+        long long getPendingBytes() const;
+
+        /**
+         * @return the name of the outbox file.
+         */
+        const std::string& getPath() const {
+            return this->path;
+        }
+
+        /**
+         * @return the size in bytes of the outbox file.
+         */
+        long long getFileSize() const {
+            return this->capacity;
+        }
+
+    private:
+
+        void recover();
+
+        void writeHeader();
+
+        long long nextRecord(long long position) const;
+
+    };
+
+}}}
+
+#endif /*_ACTIVEMQ_TRANSPORT_FAILOVER_OUTBOX_H_*/
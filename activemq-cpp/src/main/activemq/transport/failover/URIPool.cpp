@@ -18,6 +18,8 @@
 #include "URIPool.h"
 
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include <decaf/util/Random.h>
 #include <decaf/lang/System.h>
 
@@ -31,11 +33,72 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool() : uriPool(), priorityURI(), randomize(false) {
+const int URIPool::DECAY_FACTOR = 4;
+const long long URIPool::FAILED_CONNECT_TIME = 30000;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    struct RankedURI {
+        long long connectTime;
+        int index;
+        URI uri;
+
+        RankedURI(long long connectTime, int index, const URI& uri) :
+            connectTime(connectTime), index(index), uri(uri) {}
+
+        bool operator< (const RankedURI& other) const {
+            if (connectTime != other.connectTime) {
+                return connectTime < other.connectTime;
+            }
+            return index < other.index;
+        }
+    };
+
+    // The rendezvous hashing weight of a URI for a key, FNV-1a over the key and the
+    // URI with a final mix so that weights for similar URIs are unrelated.
+    unsigned long long hashWeight(const std::string& key, const std::string& uri) {
+
+        unsigned long long hash = 14695981039346656037ULL;
+
+        for (std::size_t i = 0; i < key.length(); ++i) {
+            hash = (hash ^ (unsigned char) key[i]) * 1099511628211ULL;
+        }
+
+        hash = (hash ^ 0xFF) * 1099511628211ULL;
+
+        for (std::size_t i = 0; i < uri.length(); ++i) {
+            hash = (hash ^ (unsigned char) uri[i]) * 1099511628211ULL;
+        }
+
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 33;
+
+        return hash;
+    }
+
+    struct WeightedURI {
+        unsigned long long weight;
+        URI uri;
+
+        WeightedURI(unsigned long long weight, const URI& uri) : weight(weight), uri(uri) {}
+
+        // Heaviest first.
+        bool operator< (const WeightedURI& other) const {
+            return weight > other.weight;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIPool::URIPool() : uriPool(), priorityURI(), randomize(false), connectTimes(), hashKey() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(), randomize(false) {
+URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(), randomize(false), connectTimes(), hashKey() {
     this->uriPool.copy(uris);
 
     if (!this->uriPool.isEmpty()) {
@@ -44,9 +107,11 @@ URIPool::URIPool(const decaf::util::List<URI>& uris) : uriPool(), priorityURI(),
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-URIPool::URIPool(const URIPool& uris) : uriPool(), priorityURI(), randomize(false) {
+URIPool::URIPool(const URIPool& uris) : uriPool(), priorityURI(), randomize(false), connectTimes(), hashKey() {
     synchronized(&uris.uriPool) {
         this->uriPool.copy(uris.uriPool);
+        this->connectTimes.copy(uris.connectTimes);
+        this->hashKey = uris.hashKey;
     }
 
     if (!this->uriPool.isEmpty()) {
@@ -58,6 +123,8 @@ URIPool::URIPool(const URIPool& uris) : uriPool(), priorityURI(), randomize(fals
 URIPool& URIPool::operator= (const URIPool& uris) {
     synchronized(&uris.uriPool) {
         this->uriPool.copy(uris.uriPool);
+        this->connectTimes.copy(uris.connectTimes);
+        this->hashKey = uris.hashKey;
     }
 
     if (!this->uriPool.isEmpty()) {
@@ -79,7 +146,17 @@ URI URIPool::getURI() {
 
             int index = 0; // Take the first one in the list unless random is on.
 
-            if (isRandomize()) {
+            if (!hashKey.empty()) {
+                unsigned long long heaviest = 0;
+                std::auto_ptr<Iterator<URI> > iter(uriPool.iterator());
+                for (int next = 0; iter->hasNext(); ++next) {
+                    unsigned long long weight = hashWeight(hashKey, iter->next().toString());
+                    if (next == 0 || weight > heaviest) {
+                        heaviest = weight;
+                        index = next;
+                    }
+                }
+            } else if (isRandomize()) {
                 Random rand;
                 rand.setSeed(decaf::lang::System::currentTimeMillis());
                 index = rand.nextInt((int) uriPool.size());
@@ -92,6 +169,112 @@ URI URIPool::getURI() {
     throw NoSuchElementException(__FILE__, __LINE__, "URI Pool is currently empty.");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int URIPool::getURIs(int count, List<URI>& uris, bool priorityFirst) {
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    int taken = 0;
+
+    synchronized(&uriPool) {
+
+        if (priorityFirst && uriPool.contains(priorityURI)) {
+            uriPool.remove(priorityURI);
+            uris.add(priorityURI);
+            taken++;
+        }
+
+        if (taken == count || uriPool.isEmpty()) {
+            return taken;
+        }
+
+        if (!hashKey.empty()) {
+
+            std::vector<WeightedURI> weighted;
+            weighted.reserve(uriPool.size());
+
+            std::auto_ptr<Iterator<URI> > iter(uriPool.iterator());
+            while (iter->hasNext()) {
+                URI uri = iter->next();
+                weighted.push_back(WeightedURI(hashWeight(hashKey, uri.toString()), uri));
+            }
+
+            std::sort(weighted.begin(), weighted.end());
+
+            std::vector<WeightedURI>::const_iterator next = weighted.begin();
+            for (; next != weighted.end() && taken < count; ++next, ++taken) {
+                uriPool.remove(next->uri);
+                uris.add(next->uri);
+            }
+
+            return taken;
+        }
+
+        std::vector<RankedURI> ranked;
+        ranked.reserve(uriPool.size());
+
+        std::auto_ptr<Iterator<URI> > iter(uriPool.iterator());
+        for (int index = 0; iter->hasNext(); ++index) {
+            URI uri = iter->next();
+            long long connectTime = 0;
+            if (connectTimes.containsKey(uri.toString())) {
+                connectTime = connectTimes.get(uri.toString());
+            }
+            ranked.push_back(RankedURI(connectTime, index, uri));
+        }
+
+        if (isRandomize()) {
+            Random rand;
+            rand.setSeed(decaf::lang::System::currentTimeMillis());
+            for (int i = (int) ranked.size() - 1; i > 0; --i) {
+                std::swap(ranked[i].index, ranked[rand.nextInt(i + 1)].index);
+            }
+        }
+
+        std::sort(ranked.begin(), ranked.end());
+
+        std::vector<RankedURI>::const_iterator next = ranked.begin();
+        for (; next != ranked.end() && taken < count; ++next, ++taken) {
+            uriPool.remove(next->uri);
+            uris.add(next->uri);
+        }
+    }
+
+    return taken;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPool::recordConnectTime(const URI& uri, long long millis) {
+
+    if (millis < 0) {
+        millis = FAILED_CONNECT_TIME;
+    }
+
+    synchronized(&uriPool) {
+        std::string key = uri.toString();
+        if (connectTimes.containsKey(key)) {
+            long long average = connectTimes.get(key);
+            millis = average + (millis - average) / DECAY_FACTOR;
+        }
+        connectTimes.put(key, millis);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long URIPool::getConnectTime(const URI& uri) const {
+
+    synchronized(&uriPool) {
+        std::string key = uri.toString();
+        if (connectTimes.containsKey(key)) {
+            return connectTimes.get(key);
+        }
+    }
+
+    return -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool URIPool::addURI(const URI& uri) {
 
@@ -166,6 +349,44 @@ bool URIPool::isPriority(const decaf::net::URI& uri) const {
     return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string URIPool::getHashKey() const {
+    synchronized(&uriPool) {
+        return this->hashKey;
+    }
+    return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPool::setHashKey(const std::string& key) {
+    synchronized(&uriPool) {
+        this->hashKey = key;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIPool::isPreferred(const decaf::net::URI& uri) const {
+
+    synchronized(&uriPool) {
+
+        if (hashKey.empty()) {
+            return priorityURI.equals(uri);
+        }
+
+        unsigned long long weight = hashWeight(hashKey, uri.toString());
+
+        std::auto_ptr<Iterator<URI> > iter(uriPool.iterator());
+        while (iter->hasNext()) {
+            URI next = iter->next();
+            if (hashWeight(hashKey, next.toString()) > weight && !next.equals(uri)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void URIPool::clear() {
     synchronized(&uriPool) {
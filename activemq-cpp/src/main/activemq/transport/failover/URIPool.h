@@ -22,6 +22,7 @@
 
 #include <decaf/net/URI.h>
 #include <decaf/util/LinkedList.h>
+#include <decaf/util/StlMap.h>
 #include <decaf/util/NoSuchElementException.h>
 
 namespace activemq {
@@ -34,9 +35,23 @@ namespace failover {
         mutable decaf::util::LinkedList<decaf::net::URI> uriPool;
         decaf::net::URI priorityURI;
         bool randomize;
+        decaf::util::StlMap<std::string, long long> connectTimes;
+        std::string hashKey;
 
     public:
 
+        /**
+         * The weight, as 1/DECAY_FACTOR, that a new connect time sample is given
+         * when it is folded into the running average kept for a URI.
+         */
+        static const int DECAY_FACTOR;
+
+        /**
+         * The connect time, in milliseconds, that is recorded for a URI when an
+         * attempt to connect to it fails.
+         */
+        static const long long FAILED_CONNECT_TIME;
+
         /**
          * Create an Empty URI Pool.
          */
@@ -103,7 +118,8 @@ namespace failover {
          * Fetches the next available URI from the pool, if there are no more
          * URIs free when this method is called it throws a NoSuchElementException.
          * Receiving the exception is not an indication that a URI won't be available
-         * in the future, the caller should react accordingly.
+         * in the future, the caller should react accordingly.  A hashed pool gives
+         * out its heaviest URI.
          *
          * @return the next free URI in the Pool.
          *
@@ -111,6 +127,48 @@ namespace failover {
          */
         decaf::net::URI getURI();
 
+        /**
+         * Takes up to count URIs from the pool ordered by the time it has taken to
+         * connect to them in the past, fastest first, URIs that have never been
+         * tried sort ahead of all the others.  When priority is requested the Pool's
+         * priority URI is always taken first if it's free.  URIs with equal connect
+         * times are returned in random order if this pool is randomized, otherwise
+         * they keep their order in the pool.  A hashed pool returns its URIs by
+         * weight instead, see setHashKey.
+         *
+         * @param count
+         *      The maximum number of URIs to take from the pool.
+         * @param uris
+         *      The list that the URIs taken from the pool are appended to.
+         * @param priorityFirst
+         *      Should the priority URI be taken before any other.
+         *
+         * @return the number of URIs that were taken from the pool.
+         */
+        int getURIs(int count, decaf::util::List<decaf::net::URI>& uris, bool priorityFirst);
+
+        /**
+         * Records how long it took to connect to the given URI, the value is folded
+         * into an exponentially weighted average which getURIs uses to order its
+         * results.  A negative value records a failed connect attempt.
+         *
+         * @param uri
+         *      The URI that a connect attempt was made to.
+         * @param millis
+         *      The time the attempt took in milliseconds, or -1 if it failed.
+         */
+        void recordConnectTime(const decaf::net::URI& uri, long long millis);
+
+        /**
+         * Gets the average time it has taken to connect to the given URI.
+         *
+         * @param uri
+         *      The URI whose connect time is requested.
+         *
+         * @return the average connect time in milliseconds or -1 if not known.
+         */
+        long long getConnectTime(const decaf::net::URI& uri) const;
+
         /**
          * Adds a URI to the free list, callers that have previously taken one using
          * the <code>getURI</code> method should always return the URI when they close
@@ -162,6 +220,37 @@ namespace failover {
             this->randomize = value;
         }
 
+        /**
+         * @return the key URIs are hashed with, empty if the pool isn't hashed.
+         */
+        std::string getHashKey() const;
+
+        /**
+         * Sets the key that orders the URIs of this pool by rendezvous hashing.  Each
+         * URI is given a weight hashed from the key and the URI, getURI and getURIs
+         * then take the URIs heaviest first instead of by position, randomness or
+         * connect time.  A client that hashes with the same key always prefers the same
+         * URI of a list, and adding or removing a URI only moves the clients whose
+         * preferred URI it is or becomes.
+         *
+         * @param key
+         *      The key of the client, an empty key turns hashing off.
+         */
+        void setHashKey(const std::string& key);
+
+        /**
+         * Checks if the given URI is the one a connection from this pool should be
+         * made to.  For a hashed pool that is a URI that no URI in the pool outweighs,
+         * which is true for a URI taken from the pool as long as no heavier URI has
+         * been added since, otherwise it is the priority URI.
+         *
+         * @param uri
+         *      The URI to check.
+         *
+         * @return true if the URI is the preferred one.
+         */
+        bool isPreferred(const decaf::net::URI& uri) const;
+
         /**
          * Returns true if the given URI is contained in this set of URIs.
          *
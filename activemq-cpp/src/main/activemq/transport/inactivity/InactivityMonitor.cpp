@@ -19,16 +19,20 @@
 
 #include "ReadChecker.h"
 #include "WriteChecker.h"
+#include "KeepAliveService.h"
 
 #include <activemq/threads/CompositeTask.h>
 #include <activemq/threads/CompositeTaskRunner.h>
+#include <activemq/threads/TimingWheel.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/KeepAliveInfo.h>
 
 #include <decaf/util/Timer.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 #include <decaf/lang/Math.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/Boolean.h>
@@ -43,12 +47,22 @@ using namespace activemq::exceptions;
 using namespace activemq::wireformat;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::internal::util::concurrent;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The same clock the KeepAliveService schedules the checks by.
+    long long currentTime() {
+        return System::nanoTime() / 1000000;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 namespace activemq {
 namespace transport {
@@ -72,8 +86,12 @@ namespace inactivity {
         Pointer<ReadChecker> readCheckerTask;
         Pointer<WriteChecker> writeCheckerTask;
 
-        Timer readCheckTimer;
-        Timer writeCheckTimer;
+        // Created on start unless the checks are placed in the shared TimingWheel.
+        Pointer<Timer> readCheckTimer;
+        Pointer<Timer> writeCheckTimer;
+
+        Pointer<TimingWheel::Timeout> readCheckTimeout;
+        Pointer<TimingWheel::Timeout> writeCheckTimeout;
 
         Pointer<CompositeTaskRunner> asyncTasks;
 
@@ -82,8 +100,10 @@ namespace inactivity {
 
         AtomicBoolean monitorStarted;
 
-        AtomicBoolean commandSent;
-        AtomicBoolean commandReceived;
+        // Times the last command was received and sent, stored with relaxed atomics so
+        // that traffic costs no more than a clock read and a plain store.
+        volatile long long lastReadTime;
+        volatile long long lastWriteTime;
 
         AtomicBoolean failed;
         AtomicBoolean inRead;
@@ -97,6 +117,8 @@ namespace inactivity {
         long long initialDelayTime;
 
         bool keepAliveResponseRequired;
+        bool useTimingWheel;
+        bool useKeepAliveService;
 
         InactivityMonitorData(const Pointer<WireFormat> wireFormat) :
             wireFormat(wireFormat),
@@ -104,14 +126,16 @@ namespace inactivity {
             remoteWireFormatInfo(),
             readCheckerTask(),
             writeCheckerTask(),
-            readCheckTimer("InactivityMonitor Read Check Timer"),
-            writeCheckTimer("InactivityMonitor Write Check Timer"),
+            readCheckTimer(),
+            writeCheckTimer(),
+            readCheckTimeout(),
+            writeCheckTimeout(),
             asyncTasks(),
             asyncReadTask(),
             asyncWriteTask(),
             monitorStarted(),
-            commandSent(),
-            commandReceived(true),
+            lastReadTime(currentTime()),
+            lastWriteTime(lastReadTime),
             failed(),
             inRead(),
             inWrite(),
@@ -120,7 +144,9 @@ namespace inactivity {
             readCheckTime(0),
             writeCheckTime(0),
             initialDelayTime(0),
-            keepAliveResponseRequired(false) {
+            keepAliveResponseRequired(false),
+            useTimingWheel(false),
+            useKeepAliveService(true) {
         }
     };
 
@@ -215,6 +241,8 @@ InactivityMonitor::InactivityMonitor(const Pointer<Transport> next, const decaf:
     TransportFilter(next), members(new InactivityMonitorData(wireFormat)) {
 
     this->members->keepAliveResponseRequired = Boolean::parseBoolean(properties.getProperty("keepAliveResponseRequired", "false"));
+    this->members->useTimingWheel = Boolean::parseBoolean(properties.getProperty("transport.useTimingWheel", "false"));
+    this->members->useKeepAliveService = Boolean::parseBoolean(properties.getProperty("transport.useKeepAliveService", "true"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,6 +298,26 @@ void InactivityMonitor::setKeepAliveResponseRequired(bool value) {
     this->members->keepAliveResponseRequired = value;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool InactivityMonitor::isUseTimingWheel() const {
+    return this->members->useTimingWheel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::setUseTimingWheel(bool value) {
+    this->members->useTimingWheel = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool InactivityMonitor::isUseKeepAliveService() const {
+    return this->members->useKeepAliveService;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::setUseKeepAliveService(bool value) {
+    this->members->useKeepAliveService = value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitor::afterNextIsStarted() {
     try {
@@ -312,7 +360,7 @@ void InactivityMonitor::onException(const decaf::lang::Exception& ex) {
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitor::onCommand(const Pointer<Command> command) {
 
-    this->members->commandReceived.set(true);
+    Atomics::setRelaxed64(&this->members->lastReadTime, currentTime());
     this->members->inRead.set(true);
 
     try {
@@ -365,11 +413,11 @@ void InactivityMonitor::oneway(const Pointer<Command> command) {
 
                 this->next->oneway(command);
 
-                this->members->commandSent.set(true);
+                Atomics::setRelaxed64(&this->members->lastWriteTime, currentTime());
                 this->members->inWrite.set(false);
 
             } catch (Exception& ex) {
-                this->members->commandSent.set(true);
+                Atomics::setRelaxed64(&this->members->lastWriteTime, currentTime());
                 this->members->inWrite.set(false);
                 ex.setMark(__FILE__, __LINE__);
                 throw;
@@ -387,20 +435,36 @@ bool InactivityMonitor::allowReadCheck(long long elapsed) {
     return elapsed > (this->members->readCheckTime * 9 / 10);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long InactivityMonitor::readCheckDelay(long long now) const {
+    return Atomics::getRelaxed64(&this->members->lastReadTime) + this->members->readCheckTime - now;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long InactivityMonitor::writeCheckDelay(long long now) const {
+    // Allow for a check that runs a little early, or a keep alive sent a little late,
+    // as the read check throttle does.
+    return Atomics::getRelaxed64(&this->members->lastWriteTime) + (this->members->writeCheckTime * 9 / 10) - now;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitor::readCheck() {
 
+    long long now = currentTime();
+
+    // A command still being read counts as traffic.
     if (this->members->inRead.get() || this->members->wireFormat->inReceive()) {
+        Atomics::setRelaxed64(&this->members->lastReadTime, now);
         return;
     }
 
-    if (!this->members->commandReceived.get()) {
+    if (readCheckDelay(now) <= 0) {
         // Set the failed state on our async Read Failure Task and wakeup its runner.
         this->members->asyncReadTask->setFailed(true);
-        this->members->asyncTasks->wakeup();
+        if (this->members->asyncTasks != NULL) {
+            this->members->asyncTasks->wakeup(this->members->asyncReadTask.get());
+        }
     }
-
-    this->members->commandReceived.set(false);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -410,13 +474,27 @@ void InactivityMonitor::writeCheck() {
         return;
     }
 
-    if (!this->members->commandSent.get()) {
+    if (writeCheckDelay(currentTime()) <= 0) {
 
         this->members->asyncWriteTask->setWrite(true);
-        this->members->asyncTasks->wakeup();
+        if (this->members->asyncTasks != NULL) {
+            this->members->asyncTasks->wakeup(this->members->asyncWriteTask.get());
+        }
     }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool InactivityMonitor::hasPendingAsyncTasks() const {
+    return this->members->asyncReadTask->isPending() || this->members->asyncWriteTask->isPending();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitor::runAsyncTasks() {
 
-    this->members->commandSent.set(false);
+    while (hasPendingAsyncTasks()) {
+        this->members->asyncWriteTask->iterate();
+        this->members->asyncReadTask->iterate();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -436,13 +514,16 @@ void InactivityMonitor::startMonitorThreads() {
 
     synchronized( &this->members->monitor ) {
 
-        this->members->asyncTasks.reset(new CompositeTaskRunner());
         this->members->asyncReadTask.reset(new AsyncSignalReadErrorkTask(this, this->getRemoteAddress()));
         this->members->asyncWriteTask.reset(new AsyncWriteTask(this));
 
-        this->members->asyncTasks->addTask(this->members->asyncReadTask.get());
-        this->members->asyncTasks->addTask(this->members->asyncWriteTask.get());
-        this->members->asyncTasks->start();
+        // With the KeepAliveService the async work runs on its shared threads.
+        if (!this->members->useKeepAliveService) {
+            this->members->asyncTasks.reset(new CompositeTaskRunner());
+            this->members->asyncTasks->addTask(this->members->asyncReadTask.get());
+            this->members->asyncTasks->addTask(this->members->asyncWriteTask.get());
+            this->members->asyncTasks->start();
+        }
 
         this->members->readCheckTime = Math::min(this->members->localWireFormatInfo->getMaxInactivityDuration(),
                 this->members->remoteWireFormatInfo->getMaxInactivityDuration());
@@ -457,8 +538,23 @@ void InactivityMonitor::startMonitorThreads() {
             this->members->readCheckerTask.reset(new ReadChecker(this));
             this->members->writeCheckTime = this->members->readCheckTime > 3 ? this->members->readCheckTime / 3 : this->members->readCheckTime;
 
-            this->members->writeCheckTimer.scheduleAtFixedRate(this->members->writeCheckerTask, this->members->initialDelayTime, this->members->writeCheckTime);
-            this->members->readCheckTimer.scheduleAtFixedRate(this->members->readCheckerTask, this->members->initialDelayTime, this->members->readCheckTime);
+            if (this->members->useKeepAliveService) {
+                KeepAliveService::getInstance().registerMonitor(this,
+                    this->members->initialDelayTime, this->members->readCheckTime, this->members->writeCheckTime);
+            } else if (this->members->useTimingWheel) {
+                TimingWheel& wheel = TimingWheel::getSharedInstance();
+                this->members->writeCheckTimeout = wheel.scheduleAtFixedRate(
+                    this->members->writeCheckerTask, this->members->initialDelayTime, this->members->writeCheckTime);
+                this->members->readCheckTimeout = wheel.scheduleAtFixedRate(
+                    this->members->readCheckerTask, this->members->initialDelayTime, this->members->readCheckTime);
+            } else {
+                this->members->writeCheckTimer.reset(new Timer("InactivityMonitor Write Check Timer"));
+                this->members->readCheckTimer.reset(new Timer("InactivityMonitor Read Check Timer"));
+                this->members->writeCheckTimer->scheduleAtFixedRate(
+                    this->members->writeCheckerTask, this->members->initialDelayTime, this->members->writeCheckTime);
+                this->members->readCheckTimer->scheduleAtFixedRate(
+                    this->members->readCheckerTask, this->members->initialDelayTime, this->members->readCheckTime);
+            }
         }
     }
 }
@@ -473,12 +569,23 @@ void InactivityMonitor::stopMonitorThreads() {
             this->members->readCheckerTask->cancel();
             this->members->writeCheckerTask->cancel();
 
-            this->members->readCheckTimer.purge();
-            this->members->readCheckTimer.cancel();
-            this->members->writeCheckTimer.purge();
-            this->members->writeCheckTimer.cancel();
+            if (this->members->readCheckTimeout != NULL) {
+                this->members->readCheckTimeout->cancel();
+                this->members->writeCheckTimeout->cancel();
+            }
 
-            this->members->asyncTasks->shutdown();
+            if (this->members->readCheckTimer != NULL) {
+                this->members->readCheckTimer->purge();
+                this->members->readCheckTimer->cancel();
+                this->members->writeCheckTimer->purge();
+                this->members->writeCheckTimer->cancel();
+            }
+
+            if (this->members->useKeepAliveService) {
+                KeepAliveService::getInstance().unregisterMonitor(this);
+            } else {
+                this->members->asyncTasks->shutdown();
+            }
         }
     }
 }
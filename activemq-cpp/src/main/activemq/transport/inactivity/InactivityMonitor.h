@@ -38,6 +38,7 @@ namespace inactivity {
     class AsyncSignalReadErrorkTask;
     class AsyncWriteTask;
     class InactivityMonitorData;
+    class KeepAliveServiceImpl;
 
     class AMQCPP_API InactivityMonitor : public TransportFilter {
     private:
@@ -49,6 +50,7 @@ namespace inactivity {
         friend class AsyncSignalReadErrorkTask;
         friend class WriteChecker;
         friend class AsyncWriteTask;
+        friend class KeepAliveServiceImpl;
 
     private:
 
@@ -80,6 +82,38 @@ namespace inactivity {
 
         void setKeepAliveResponseRequired(bool value);
 
+        /**
+         * @return true if the read and write checks run on the shared TimingWheel
+         *         instead of a pair of Timers owned by this monitor.
+         */
+        bool isUseTimingWheel() const;
+
+        /**
+         * Sets whether the read and write checks run on the shared TimingWheel, which
+         * must be set before the monitor is started to take effect.
+         *
+         * @param value
+         *      true to use the shared TimingWheel.
+         */
+        void setUseTimingWheel(bool value);
+
+        /**
+         * @return true if the read and write checks are driven by the process wide
+         *         KeepAliveService, which is the default.
+         */
+        bool isUseKeepAliveService() const;
+
+        /**
+         * Sets whether the read and write checks are driven by the process wide
+         * KeepAliveService.  When disabled the monitor runs its checks from its own
+         * Timers, or the shared TimingWheel if that is enabled, and has its own
+         * thread for sending keep alives.  Must be set before the monitor is started.
+         *
+         * @param value
+         *      true to use the KeepAliveService.
+         */
+        void setUseKeepAliveService(bool value);
+
         long long getReadCheckTime() const;
 
         void setReadCheckTime(long long value);
@@ -105,12 +139,26 @@ namespace inactivity {
         // Throttles read checking
         bool allowReadCheck(long long elapsed);
 
+        // Milliseconds until the read check can find the connection inactive, zero or
+        // less once it can.  The time is the KeepAliveService's clock.
+        long long readCheckDelay(long long now) const;
+
+        // Milliseconds until the write check has to send a keep alive, zero or less once
+        // it has to.
+        long long writeCheckDelay(long long now) const;
+
         // Performs a Read Check on the current connection, called from a separate Thread.
         void readCheck();
 
         // Perform a Write Check on the current connection, called from a separate Thread.
         void writeCheck();
 
+        // True when a keep alive send or read failure is waiting to be processed.
+        bool hasPendingAsyncTasks() const;
+
+        // Processes the pending keep alive send and read failure, called from the KeepAliveService.
+        void runAsyncTasks();
+
         // Stops all the monitoring Threads, cannot restart once called.
         void stopMonitorThreads();
 
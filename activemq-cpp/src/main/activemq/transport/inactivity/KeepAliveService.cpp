@@ -0,0 +1,504 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeepAliveService.h"
+
+#include <activemq/transport/inactivity/InactivityMonitor.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Math.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::inactivity;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const long long KeepAliveService::DEFAULT_RESOLUTION = 100;
+const int KeepAliveService::DEFAULT_DISPATCH_THREADS = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    KeepAliveService* instance = NULL;
+
+    long long currentTime() {
+        return System::nanoTime() / 1000000;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace inactivity {
+
+    class MonitorEntry {
+    private:
+
+        MonitorEntry(const MonitorEntry&);
+        MonitorEntry& operator= (const MonitorEntry&);
+
+    public:
+
+        InactivityMonitor* monitor;
+
+        long long readCheckTime;
+        long long writeCheckTime;
+        long long nextRead;
+        long long nextWrite;
+
+        // Number of checks or dispatches currently running for this monitor.
+        int active;
+
+        // Thread running the dispatched work, it may unregister the monitor itself.
+        Thread* dispatchThread;
+
+        bool readDue;
+        bool writeDue;
+        bool queued;
+        bool removed;
+
+        MonitorEntry(InactivityMonitor* monitor, long long readCheckTime, long long writeCheckTime) :
+            monitor(monitor), readCheckTime(readCheckTime), writeCheckTime(writeCheckTime),
+            nextRead(0), nextWrite(0), active(0), dispatchThread(NULL),
+            readDue(false), writeDue(false), queued(false), removed(false) {
+        }
+    };
+
+    class KeepAliveServiceImpl : public Runnable {
+    private:
+
+        KeepAliveServiceImpl(const KeepAliveServiceImpl&);
+        KeepAliveServiceImpl& operator= (const KeepAliveServiceImpl&);
+
+    public:
+
+        long long resolution;
+        int dispatchThreads;
+
+        mutable Mutex mutex;
+        LinkedList< Pointer<MonitorEntry> > entries;
+
+        Pointer<Thread> thread;
+        Pointer<ThreadPoolExecutor> executor;
+
+        long long sweeps;
+        bool shutdown;
+
+    public:
+
+        KeepAliveServiceImpl(long long resolution, int dispatchThreads) :
+            resolution(resolution), dispatchThreads(dispatchThreads), mutex(), entries(),
+            thread(), executor(), sweeps(0), shutdown(false) {
+        }
+
+        virtual ~KeepAliveServiceImpl() {}
+
+        long long align(long long deadline) const {
+            return ((deadline + resolution - 1) / resolution) * resolution;
+        }
+
+        long long advance(long long deadline, long long period, long long now) const {
+            long long next = deadline + period;
+            if (next <= now) {
+                // Skip the checks that were missed instead of running them back to back.
+                next = now + period;
+            }
+
+            return align(next);
+        }
+
+        Pointer<MonitorEntry> find(InactivityMonitor* monitor) const {
+
+            Pointer< Iterator< Pointer<MonitorEntry> > > iter(entries.iterator());
+            while (iter->hasNext()) {
+                Pointer<MonitorEntry> entry = iter->next();
+                if (entry->monitor == monitor) {
+                    return entry;
+                }
+            }
+
+            return Pointer<MonitorEntry>();
+        }
+
+        void add(InactivityMonitor* monitor, long long initialDelay,
+                 long long readCheckTime, long long writeCheckTime) {
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    throw IllegalStateException(__FILE__, __LINE__, "KeepAliveService has been shutdown.");
+                }
+
+                if (find(monitor) != NULL) {
+                    throw IllegalStateException(__FILE__, __LINE__, "InactivityMonitor is already registered.");
+                }
+
+                long long now = currentTime();
+
+                Pointer<MonitorEntry> entry(new MonitorEntry(monitor, readCheckTime, writeCheckTime));
+                entry->nextRead = align(now + initialDelay);
+                entry->nextWrite = entry->nextRead;
+                entries.add(entry);
+
+                if (thread == NULL) {
+                    executor.reset(new ThreadPoolExecutor(dispatchThreads, dispatchThreads, 5, TimeUnit::SECONDS,
+                                                          new LinkedBlockingQueue<Runnable*>()));
+                    thread.reset(new Thread(this, "ActiveMQ KeepAliveService"));
+                    thread->start();
+                }
+
+                mutex.notifyAll();
+            }
+        }
+
+        bool remove(InactivityMonitor* monitor) {
+
+            synchronized(&mutex) {
+
+                Pointer<MonitorEntry> entry = find(monitor);
+                if (entry == NULL) {
+                    return false;
+                }
+
+                entries.remove(entry);
+                entry->removed = true;
+
+                // Wait out any check or dispatch in flight, other than our own.
+                int own = entry->dispatchThread == Thread::currentThread() ? 1 : 0;
+                while (entry->active > own && thread.get() != Thread::currentThread()) {
+                    mutex.wait();
+                }
+            }
+
+            return true;
+        }
+
+        void stop() {
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    return;
+                }
+
+                shutdown = true;
+
+                Pointer< Iterator< Pointer<MonitorEntry> > > iter(entries.iterator());
+                while (iter->hasNext()) {
+                    iter->next()->removed = true;
+                }
+
+                entries.clear();
+                mutex.notifyAll();
+            }
+
+            if (thread != NULL && Thread::currentThread() != thread.get()) {
+                thread->join();
+            }
+
+            if (executor != NULL) {
+                executor->shutdown();
+                executor->awaitTermination(5, TimeUnit::MINUTES);
+            }
+        }
+
+        virtual void run() {
+
+            std::vector< Pointer<MonitorEntry> > due;
+
+            while (true) {
+
+                synchronized(&mutex) {
+
+                    while (!shutdown) {
+
+                        long long now = currentTime();
+                        long long next = Long::MAX_VALUE;
+
+                        Pointer< Iterator< Pointer<MonitorEntry> > > iter(entries.iterator());
+                        while (iter->hasNext()) {
+                            Pointer<MonitorEntry> entry = iter->next();
+
+                            if (entry->nextRead <= now) {
+                                long long delay = entry->monitor->readCheckDelay(now);
+                                if (delay > 0) {
+                                    // Traffic was seen since, the check follows it instead of running.
+                                    entry->nextRead = align(now + delay);
+                                } else {
+                                    entry->readDue = true;
+                                    entry->nextRead = advance(entry->nextRead, entry->readCheckTime, now);
+                                }
+                            }
+
+                            if (entry->nextWrite <= now) {
+                                long long delay = entry->monitor->writeCheckDelay(now);
+                                if (delay > 0) {
+                                    entry->nextWrite = align(now + delay);
+                                } else {
+                                    entry->writeDue = true;
+                                    entry->nextWrite = advance(entry->nextWrite, entry->writeCheckTime, now);
+                                }
+                            }
+
+                            if (entry->readDue || entry->writeDue) {
+                                entry->active++;
+                                due.push_back(entry);
+                            }
+
+                            next = Math::min(next, Math::min(entry->nextRead, entry->nextWrite));
+                        }
+
+                        if (!due.empty()) {
+                            sweeps++;
+                            break;
+                        }
+
+                        if (next == Long::MAX_VALUE) {
+                            mutex.wait();
+                        } else {
+                            mutex.wait(next - now);
+                        }
+                    }
+
+                    if (shutdown) {
+                        return;
+                    }
+                }
+
+                std::vector< Pointer<MonitorEntry> >::iterator iter = due.begin();
+                for (; iter != due.end(); ++iter) {
+                    check(*iter);
+                }
+
+                synchronized(&mutex) {
+                    for (iter = due.begin(); iter != due.end(); ++iter) {
+                        Pointer<MonitorEntry>& entry = *iter;
+                        entry->active--;
+
+                        if (!entry->removed && !entry->queued && !shutdown &&
+                            entry->monitor->hasPendingAsyncTasks()) {
+
+                            entry->queued = true;
+                            entry->active++;
+                            executor->execute(new DispatchTask(this, entry));
+                        }
+                    }
+
+                    mutex.notifyAll();
+                }
+
+                due.clear();
+            }
+        }
+
+        void dispatch(const Pointer<MonitorEntry>& entry) {
+
+            synchronized(&mutex) {
+                entry->queued = false;
+                if (entry->removed) {
+                    entry->active--;
+                    mutex.notifyAll();
+                    return;
+                }
+
+                entry->dispatchThread = Thread::currentThread();
+            }
+
+            try {
+                entry->monitor->runAsyncTasks();
+            } catch (...) {
+            }
+
+            synchronized(&mutex) {
+                entry->dispatchThread = NULL;
+                entry->active--;
+                mutex.notifyAll();
+            }
+        }
+
+    private:
+
+        void check(const Pointer<MonitorEntry>& entry) {
+
+            // Flags are only touched by this thread once the entry is marked active.
+            bool read = entry->readDue;
+            bool write = entry->writeDue;
+            entry->readDue = false;
+            entry->writeDue = false;
+
+            if (entry->removed) {
+                return;
+            }
+
+            try {
+                if (write) {
+                    entry->monitor->writeCheck();
+                }
+
+                if (read) {
+                    entry->monitor->readCheck();
+                }
+            } catch (...) {
+            }
+        }
+
+        class DispatchTask : public Runnable {
+        private:
+
+            KeepAliveServiceImpl* parent;
+            Pointer<MonitorEntry> entry;
+
+        private:
+
+            DispatchTask(const DispatchTask&);
+            DispatchTask& operator= (const DispatchTask&);
+
+        public:
+
+            DispatchTask(KeepAliveServiceImpl* parent, const Pointer<MonitorEntry>& entry) :
+                Runnable(), parent(parent), entry(entry) {
+            }
+
+            virtual ~DispatchTask() {}
+
+            virtual void run() {
+                this->parent->dispatch(this->entry);
+            }
+        };
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+KeepAliveService::KeepAliveService(long long resolution, int dispatchThreads) : impl(NULL) {
+
+    if (resolution <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Resolution must be positive.");
+    }
+
+    if (dispatchThreads <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Dispatch thread count must be positive.");
+    }
+
+    this->impl = new KeepAliveServiceImpl(resolution, dispatchThreads);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+KeepAliveService::~KeepAliveService() {
+    try {
+        this->impl->stop();
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveService::registerMonitor(InactivityMonitor* monitor, long long initialDelay,
+                                       long long readCheckTime, long long writeCheckTime) {
+
+    if (monitor == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "InactivityMonitor cannot be NULL.");
+    }
+
+    if (readCheckTime <= 0 || writeCheckTime <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Check times must be positive.");
+    }
+
+    this->impl->add(monitor, initialDelay < 0 ? 0 : initialDelay, readCheckTime, writeCheckTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool KeepAliveService::unregisterMonitor(InactivityMonitor* monitor) {
+    return this->impl->remove(monitor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveService::shutdown() {
+    this->impl->stop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int KeepAliveService::getMonitorCount() const {
+
+    int result = 0;
+
+    synchronized(&this->impl->mutex) {
+        result = this->impl->entries.size();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long KeepAliveService::getSweepCount() const {
+
+    long long result = 0;
+
+    synchronized(&this->impl->mutex) {
+        result = this->impl->sweeps;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long KeepAliveService::getResolution() const {
+    return this->impl->resolution;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+KeepAliveService& KeepAliveService::getInstance() {
+
+    if (instance == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    return *instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveService::initialize() {
+    instance = new KeepAliveService();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveService::shutdownInstance() {
+    KeepAliveService* old = instance;
+    instance = NULL;
+    delete old;
+}
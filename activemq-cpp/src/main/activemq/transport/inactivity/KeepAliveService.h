@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_INACTIVITY_KEEPALIVESERVICE_H_
+#define _ACTIVEMQ_TRANSPORT_INACTIVITY_KEEPALIVESERVICE_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace inactivity {
+
+    class InactivityMonitor;
+    class KeepAliveServiceImpl;
+
+    /**
+     * Process wide service that drives the read and write checks of every registered
+     * InactivityMonitor from a single thread.  Each wakeup sweeps all the monitors and
+     * runs every check that has come due, the deadlines are rounded up to the service's
+     * resolution so that monitors with similar schedules are handled by the same sweep.
+     * Sending a KeepAliveInfo or reporting a read failure can block, so that work is
+     * handed to a small pool of threads shared by all the monitors.  Neither the thread
+     * count nor the number of wakeups grows with the number of connections.
+     *
+     * A check that comes due on a connection that has carried traffic since is not run,
+     * it is pushed back to the period after that traffic instead.  Busy connections only
+     * cost a timestamp compare per period and never have keep alives sent on them.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API KeepAliveService {
+    public:
+
+        /**
+         * Default granularity in milliseconds that check deadlines are rounded to.
+         */
+        static const long long DEFAULT_RESOLUTION;
+
+        /**
+         * Default number of threads used to send keep alives and report failures.
+         */
+        static const int DEFAULT_DISPATCH_THREADS;
+
+    private:
+
+        KeepAliveServiceImpl* impl;
+
+    private:
+
+        KeepAliveService(const KeepAliveService&);
+        KeepAliveService& operator= (const KeepAliveService&);
+
+    public:
+
+        /**
+         * Creates a new KeepAliveService, its threads are started when the first monitor
+         * is registered.
+         *
+         * @param resolution
+         *      The granularity in milliseconds that check deadlines are rounded up to.
+         * @param dispatchThreads
+         *      The number of threads used to run the monitors' asynchronous work.
+         *
+         * @throws IllegalArgumentException if either value is not positive.
+         */
+        KeepAliveService(long long resolution = DEFAULT_RESOLUTION,
+                         int dispatchThreads = DEFAULT_DISPATCH_THREADS);
+
+        virtual ~KeepAliveService();
+
+        /**
+         * Adds the monitor to the set that is checked on each sweep.
+         *
+         * @param monitor
+         *      The monitor to check, it must be unregistered before it is destroyed.
+         * @param initialDelay
+         *      Time in milliseconds before the first checks are made.
+         * @param readCheckTime
+         *      Time in milliseconds between read checks.
+         * @param writeCheckTime
+         *      Time in milliseconds between write checks.
+         *
+         * @throws NullPointerException if the monitor is NULL.
+         * @throws IllegalArgumentException if either check time is not positive.
+         * @throws IllegalStateException if the service has been shutdown.
+         */
+        void registerMonitor(InactivityMonitor* monitor, long long initialDelay,
+                             long long readCheckTime, long long writeCheckTime);
+
+        /**
+         * Removes the monitor, once this method returns no check or asynchronous work
+         * for it is in progress unless the caller is that work itself.
+         *
+         * @param monitor
+         *      The monitor to remove.
+         *
+         * @return true if the monitor was registered.
+         */
+        bool unregisterMonitor(InactivityMonitor* monitor);
+
+        /**
+         * Stops the service's threads and drops all registered monitors.
+         */
+        void shutdown();
+
+        /**
+         * @return the number of monitors currently registered.
+         */
+        int getMonitorCount() const;
+
+        /**
+         * @return the number of sweeps that have run checks since the service started.
+         */
+        long long getSweepCount() const;
+
+        /**
+         * @return the deadline granularity in milliseconds.
+         */
+        long long getResolution() const;
+
+    public:
+
+        /**
+         * Returns the service used by the InactivityMonitors of all connections in the
+         * process, it is created by the library initialization and destroyed at library
+         * shutdown.
+         *
+         * @return the shared KeepAliveService instance.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static KeepAliveService& getInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdownInstance();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_INACTIVITY_KEEPALIVESERVICE_H_ */
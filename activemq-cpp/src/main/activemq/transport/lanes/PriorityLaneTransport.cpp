@@ -0,0 +1,346 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PriorityLaneTransport.h"
+
+#include <activemq/commands/MessageAck.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::lanes;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace lanes {
+
+    class PriorityLaneTransportImpl {
+    private:
+
+        PriorityLaneTransportImpl(const PriorityLaneTransportImpl&);
+        PriorityLaneTransportImpl& operator=(const PriorityLaneTransportImpl&);
+
+    public:
+
+        // Guards both lanes and the writer state below.
+        Mutex mutex;
+
+        std::deque< Pointer<Command> > priority;
+        std::deque< Pointer<Command> > bulk;
+
+        int maxPendingSends;
+
+        // Set while the writer is sending a command it took from a lane.
+        bool writing;
+        bool stopping;
+        bool failed;
+
+        Pointer<Runnable> writerTask;
+        Pointer<Thread> writer;
+
+        // How long close waits for the writer to send commands queued before the close.
+        static const long long DRAIN_TIMEOUT = 5000;
+
+        PriorityLaneTransportImpl() : mutex(), priority(), bulk(), maxPendingSends(64), writing(false),
+                                      stopping(false), failed(false), writerTask(), writer() {
+        }
+
+        bool isEmpty() const {
+            return priority.empty() && bulk.empty() && !writing;
+        }
+    };
+
+    class PriorityLaneWriter : public Runnable {
+    private:
+
+        PriorityLaneTransport* parent;
+
+    private:
+
+        PriorityLaneWriter(const PriorityLaneWriter&);
+        PriorityLaneWriter& operator=(const PriorityLaneWriter&);
+
+    public:
+
+        PriorityLaneWriter(PriorityLaneTransport* parent) : Runnable(), parent(parent) {}
+
+        virtual ~PriorityLaneWriter() {}
+
+        virtual void run() {
+            parent->runWriter();
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityLaneTransport::PriorityLaneTransport(const Pointer<Transport> next) :
+    TransportFilter(next), impl(new PriorityLaneTransportImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityLaneTransport::~PriorityLaneTransport() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool PriorityLaneTransport::isPriorityCommand(const Command& command) {
+
+    if (command.isMessageAck()) {
+        // An ack inside a transaction has to follow the begin sent ahead of it.
+        const MessageAck& ack = dynamic_cast<const MessageAck&>(command);
+        return ack.getTransactionId() == NULL;
+    }
+
+    return command.isKeepAliveInfo() || command.isWireFormatInfo() ||
+           command.isConsumerControl() || command.isProducerAck();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::oneway(const Pointer<Command> command) {
+
+    try {
+
+        checkClosed();
+
+        if (command == NULL) {
+            throw IOException(__FILE__, __LINE__, "PriorityLaneTransport::oneway() - attempting to send NULL command");
+        }
+
+        if (this->impl->writer == NULL) {
+            next->oneway(command);
+            return;
+        }
+
+        bool priority = isPriorityCommand(*command);
+
+        synchronized(&this->impl->mutex) {
+
+            while (!priority && (int) this->impl->bulk.size() >= this->impl->maxPendingSends &&
+                   !this->impl->failed && !this->impl->stopping) {
+                this->impl->mutex.wait();
+            }
+
+            if (this->impl->failed) {
+                throw IOException(__FILE__, __LINE__, "PriorityLaneTransport::oneway() - writer thread has failed");
+            }
+
+            if (this->impl->stopping) {
+                throw IOException(__FILE__, __LINE__, "PriorityLaneTransport::oneway() - transport is closed");
+            }
+
+            if (priority) {
+                this->impl->priority.push_back(command);
+            } else {
+                this->impl->bulk.push_back(command);
+            }
+
+            this->impl->mutex.notifyAll();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::close() {
+
+    try {
+
+        // Give the writer a chance to send what was queued before the close, if it
+        // is stuck writing to a dead peer closing the chain below releases it.
+        if (!isClosed() && this->impl->writer != NULL) {
+            synchronized(&this->impl->mutex) {
+                long long deadline = System::currentTimeMillis() + PriorityLaneTransportImpl::DRAIN_TIMEOUT;
+                while (!this->impl->isEmpty() && !this->impl->failed) {
+                    long long remaining = deadline - System::currentTimeMillis();
+                    if (remaining <= 0) {
+                        break;
+                    }
+                    this->impl->mutex.wait(remaining);
+                }
+            }
+        }
+
+        TransportFilter::close();
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::afterNextIsStarted() {
+
+    try {
+
+        if (this->impl->writer == NULL) {
+            this->impl->writerTask.reset(new PriorityLaneWriter(this));
+            this->impl->writer.reset(new Thread(this->impl->writerTask.get(), "PriorityLaneTransport writer Thread"));
+            this->impl->writer->start();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::doClose() {
+
+    try {
+
+        synchronized(&this->impl->mutex) {
+            this->impl->stopping = true;
+            this->impl->priority.clear();
+            this->impl->bulk.clear();
+            this->impl->mutex.notifyAll();
+        }
+
+        if (this->impl->writer != NULL) {
+            this->impl->writer->join();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::runWriter() {
+
+    try {
+
+        bool stopped = false;
+
+        while (!stopped) {
+
+            Pointer<Command> command;
+
+            synchronized(&this->impl->mutex) {
+
+                this->impl->writing = false;
+                this->impl->mutex.notifyAll();
+
+                while (this->impl->priority.empty() && this->impl->bulk.empty() && !this->impl->stopping) {
+                    this->impl->mutex.wait();
+                }
+
+                // The priority lane is emptied first, one command at a time, so anything
+                // queued in it while a bulk frame is written goes out right after it.
+                if (!this->impl->priority.empty()) {
+                    command = this->impl->priority.front();
+                    this->impl->priority.pop_front();
+                    this->impl->writing = true;
+                } else if (!this->impl->bulk.empty()) {
+                    command = this->impl->bulk.front();
+                    this->impl->bulk.pop_front();
+                    this->impl->writing = true;
+                } else {
+                    stopped = true;
+                }
+            }
+
+            if (command != NULL) {
+                next->oneway(command);
+            }
+        }
+
+    } catch (decaf::lang::Exception& ex) {
+        ActiveMQException error(ex);
+        error.setMark(__FILE__, __LINE__);
+        writerFailed(error);
+    } catch (std::exception& ex) {
+        writerFailed(ActiveMQException(__FILE__, __LINE__, "PriorityLaneTransport writer failed: %s", ex.what()));
+    } catch (...) {
+        writerFailed(ActiveMQException(__FILE__, __LINE__, "PriorityLaneTransport writer failed with an unknown error"));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::writerFailed(const decaf::lang::Exception& error) {
+
+    bool report = false;
+
+    // Senders blocked on a full bulk lane are woken to see the failure.
+    synchronized(&this->impl->mutex) {
+        report = !this->impl->stopping;
+        this->impl->failed = true;
+        this->impl->writing = false;
+        this->impl->priority.clear();
+        this->impl->bulk.clear();
+        this->impl->mutex.notifyAll();
+    }
+
+    if (report) {
+        TransportFilter::onException(error);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityLaneTransport::getMaxPendingSends() const {
+    return this->impl->maxPendingSends;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransport::setMaxPendingSends(int value) {
+
+    if (value < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "The pending send limit must be at least one.");
+    }
+
+    synchronized(&this->impl->mutex) {
+        this->impl->maxPendingSends = value;
+        this->impl->mutex.notifyAll();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PriorityLaneTransport::getPendingCount() const {
+
+    int count = 0;
+
+    synchronized(&this->impl->mutex) {
+        count = (int) (this->impl->priority.size() + this->impl->bulk.size());
+    }
+
+    return count;
+}
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LANES_PRIORITYLANETRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_LANES_PRIORITYLANETRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/TransportFilter.h>
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace transport {
+namespace lanes {
+
+    using decaf::lang::Pointer;
+
+    class PriorityLaneTransportImpl;
+    class PriorityLaneWriter;
+
+    /**
+     * A transport filter that sends commands from a writer thread through two lanes.
+     * Small control commands, such as acks outside of a transaction and keep alives,
+     * go into a priority lane that the writer always empties before it takes the next
+     * command of the bulk lane, so they overtake messages queued behind a large send
+     * instead of waiting for all of them to be written.  Commands within a lane keep
+     * the order they were sent in.
+     *
+     * Frames are never split so a control command still waits for the frame being
+     * written when it arrives, the overtaking happens at frame boundaries.  The bulk
+     * lane holds a bounded number of commands, a sender that finds it full blocks until
+     * the writer catches up.  The filter is enabled with these URI options:
+     *
+     *  transport.priorityLanes   - true to add the filter to the transport chain.
+     *  transport.maxPendingSends - the number of commands the bulk lane holds.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API PriorityLaneTransport : public TransportFilter {
+    private:
+
+        PriorityLaneTransportImpl* impl;
+
+        friend class PriorityLaneWriter;
+
+    private:
+
+        PriorityLaneTransport(const PriorityLaneTransport&);
+        PriorityLaneTransport& operator=(const PriorityLaneTransport&);
+
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param next
+         *      The next Transport in the chain.
+         */
+        PriorityLaneTransport(const Pointer<Transport> next);
+
+        virtual ~PriorityLaneTransport();
+
+        /**
+         * Waits for the writer to send the commands queued before the close and
+         * then closes the transport chain.
+         */
+        virtual void close();
+
+        /**
+         * Queues the command in the lane it belongs to.  Until the transport is
+         * started commands are sent from the calling thread.
+         *
+         * @throws IOException if the transport is closed or the writer has failed.
+         */
+        virtual void oneway(const Pointer<Command> command);
+
+    public:
+
+        /**
+         * @return the number of commands the bulk lane holds before senders block.
+         */
+        int getMaxPendingSends() const;
+
+        /**
+         * Sets the number of commands the bulk lane holds before senders block.
+         *
+         * @param value
+         *      The maximum number of queued bulk commands, at least one.
+         */
+        void setMaxPendingSends(int value);
+
+        /**
+         * @return the number of commands waiting in either lane.
+         */
+        int getPendingCount() const;
+
+        /**
+         * Checks if a command goes into the priority lane.  Those are the commands that
+         * nothing sent before them depends on: keep alives, wire format info, consumer
+         * control, producer acks and message acks that are not part of a transaction.
+         *
+         * @param command
+         *      The command to check.
+         *
+         * @return true if the command may overtake queued bulk commands.
+         */
+        static bool isPriorityCommand(const Command& command);
+
+    protected:
+
+        virtual void afterNextIsStarted();
+
+        virtual void doClose();
+
+    private:
+
+        void runWriter();
+
+        void writerFailed(const decaf::lang::Exception& error);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_LANES_PRIORITYLANETRANSPORT_H_ */
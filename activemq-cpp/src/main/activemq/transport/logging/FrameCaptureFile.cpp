@@ -0,0 +1,183 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameCaptureFile.h"
+
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::logging;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+const char FrameCaptureFile::MAGIC[8] = { 'A', 'M', 'Q', 'F', 'C', 'A', 'P', '1' };
+const int FrameCaptureFile::HEADER_SIZE = 24;
+const int FrameCaptureFile::RECORD_HEADER_SIZE = 13;
+const long long FrameCaptureFile::DEFAULT_FILE_SIZE = 64 * 1024 * 1024;
+const int FrameCaptureFile::DEFAULT_FILE_COUNT = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    unsigned char* putInt(unsigned char* buffer, int value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            *buffer++ = (unsigned char) (value >> shift);
+        }
+        return buffer;
+    }
+
+    unsigned char* putLong(unsigned char* buffer, long long value) {
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            *buffer++ = (unsigned char) (value >> shift);
+        }
+        return buffer;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureFile::FrameCaptureFile(const std::string& path, long long fileSize, int fileCount) :
+    path(path), fileSize(fileSize), fileCount(fileCount), mutex(), current(), position(0), sequence(-1),
+    frames(0), dropped(0), startMillis(System::currentTimeMillis()), startNanos(System::nanoTime()),
+    closed(false) {
+
+    if (path.empty()) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Capture file path cannot be empty.");
+    }
+
+    if (fileSize <= HEADER_SIZE + RECORD_HEADER_SIZE) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Capture file size is too small: %lld", fileSize);
+    }
+
+    if (fileCount <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Capture file count must be positive.");
+    }
+
+    openNextFile();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureFile::~FrameCaptureFile() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFile::capture(Direction direction, const unsigned char* frame, int size) {
+
+    synchronized(&this->mutex) {
+
+        long long needed = RECORD_HEADER_SIZE + (long long) size;
+
+        if (this->closed || frame == NULL || size <= 0 || needed > this->fileSize - HEADER_SIZE) {
+            this->dropped++;
+        } else {
+
+            // A file that can't be created ends the capture rather than failing the transport.
+            if (this->position + needed > this->fileSize) {
+                try {
+                    openNextFile();
+                } catch (decaf::lang::Exception&) {
+                    this->current.reset(NULL);
+                    this->closed = true;
+                }
+            }
+
+            if (this->closed) {
+                this->dropped++;
+            } else {
+
+                long long micros = this->startMillis * 1000 + (System::nanoTime() - this->startNanos) / 1000;
+
+                unsigned char* record = this->current->getAddress() + this->position;
+                unsigned char* data = putLong(record + 4, micros);
+                *data++ = (unsigned char) direction;
+                std::memcpy(data, frame, (std::size_t) size);
+
+                // The length goes in last, a copy cut short leaves the records before it readable.
+                putInt(record, size);
+
+                this->position += needed;
+                this->frames++;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFile::close() {
+
+    synchronized(&this->mutex) {
+        this->closed = true;
+        this->current.reset(NULL);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameCaptureFile::getFrameCount() const {
+
+    synchronized(&this->mutex) {
+        return this->frames;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long FrameCaptureFile::getDroppedCount() const {
+
+    synchronized(&this->mutex) {
+        return this->dropped;
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string FrameCaptureFile::getFileName(const std::string& path, int index) {
+    return path + "." + Integer::toString(index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFile::openNextFile() {
+
+    // Unmap the full file before the next one, which may be the same file reused, is created.
+    this->current.reset(NULL);
+
+    this->sequence++;
+    this->current.reset(new MappedFile(getFileName(this->path, (int) (this->sequence % this->fileCount)), this->fileSize));
+
+    unsigned char* header = this->current->getAddress();
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    putLong(putLong(header + sizeof(MAGIC), this->sequence), this->startMillis);
+
+    this->position = HEADER_SIZE;
+}
@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREFILE_H_
+#define _ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREFILE_H_
+
+#include <activemq/util/Config.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace io {
+    class MappedFile;
+}}}
+
+namespace activemq {
+namespace transport {
+namespace logging {
+
+    /**
+     * Records the encoded frames a transport sends and receives into a set of memory
+     * mapped files, so that the traffic of a connection can be examined after the fact
+     * without paying for a toString of every command while it runs.  Capturing a frame
+     * costs a copy into the mapped region, the file contents are written out by the
+     * operating system.
+     *
+     * The frames are written to fileCount files named path.0, path.1 and so on, each of
+     * fileSize bytes.  When one file is full the next is started and once all of them
+     * have been used the oldest is overwritten.  Each file begins with a header of
+     * HEADER_SIZE bytes: the eight byte MAGIC, an eight byte sequence number that orders
+     * the files and the eight byte creation time of the capture in milliseconds.  It is
+     * followed by records of a four byte frame length, an eight byte timestamp in
+     * microseconds since the epoch, a one byte direction and the frame itself.  All
+     * values are big endian and a zero length marks the end of the records.  The files
+     * are read back with a FrameCaptureReader.
+     *
+     * Frames that don't fit in an empty file are not recorded, nor is anything once the
+     * capture has been closed or a file could not be created, these are counted in
+     * getDroppedCount instead.  The methods are thread safe.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API FrameCaptureFile {
+    public:
+
+        /**
+         * The direction a captured frame travelled in.
+         */
+        enum Direction {
+            INBOUND = 1,
+            OUTBOUND = 2
+        };
+
+        /**
+         * The bytes every capture file starts with.
+         */
+        static const char MAGIC[8];
+
+        /**
+         * Size in bytes of the header at the start of each file.
+         */
+        static const int HEADER_SIZE;
+
+        /**
+         * Size in bytes of the fields that precede each frame.
+         */
+        static const int RECORD_HEADER_SIZE;
+
+        /**
+         * Default size of each capture file in bytes.
+         */
+        static const long long DEFAULT_FILE_SIZE;
+
+        /**
+         * Default number of capture files that are rotated through.
+         */
+        static const int DEFAULT_FILE_COUNT;
+
+    private:
+
+        std::string path;
+        long long fileSize;
+        int fileCount;
+
+        mutable decaf::util::concurrent::Mutex mutex;
+        std::auto_ptr<decaf::internal::io::MappedFile> current;
+        long long position;
+        long long sequence;
+        long long frames;
+        long long dropped;
+        long long startMillis;
+        long long startNanos;
+        bool closed;
+
+    private:
+
+        FrameCaptureFile(const FrameCaptureFile&);
+        FrameCaptureFile& operator= (const FrameCaptureFile&);
+
+    public:
+
+        /**
+         * Creates the first capture file.
+         *
+         * @param path
+         *      The name the capture files are created with, the index of each is appended.
+         * @param fileSize
+         *      The size of each capture file in bytes.
+         * @param fileCount
+         *      The number of files to rotate through.
+         *
+         * @throws IOException if the first file can't be created.
+         * @throws IllegalArgumentException if the path is empty, the file size can't hold
+         *         the header or the file count is not positive.
+         */
+        FrameCaptureFile(const std::string& path, long long fileSize = DEFAULT_FILE_SIZE,
+                         int fileCount = DEFAULT_FILE_COUNT);
+
+        virtual ~FrameCaptureFile();
+
+        /**
+         * Appends a frame to the current file, moving on to the next file if this one
+         * doesn't have room for it.
+         *
+         * @param direction
+         *      Whether the frame was received or sent.
+         * @param frame
+         *      The encoded frame.
+         * @param size
+         *      The number of bytes in the frame.
+         */
+        void capture(Direction direction, const unsigned char* frame, int size);
+
+        /**
+         * Unmaps the current file, frames captured afterwards are dropped.
+         */
+        void close();
+
+        /**
+         * @return the number of frames that have been recorded.
+         */
+        long long getFrameCount() const;
+
+        /**
+         * @return the number of frames that could not be recorded.
+         */
+        long long getDroppedCount() const;
+
+        /**
+         * @return the name the capture files are created with.
+         */
+        const std::string& getPath() const {
+            return this->path;
+        }
+
+        /**
+         * @return the size in bytes of each capture file.
+         */
+        long long getFileSize() const {
+            return this->fileSize;
+        }
+
+        /**
+         * @return the number of capture files rotated through.
+         */
+        int getFileCount() const {
+            return this->fileCount;
+        }
+
+        /**
+         * Returns the name of one of the capture files.
+         *
+         * @param path
+         *      The name the capture files are created with.
+         * @param index
+         *      The index of the file.
+         *
+         * @return the name of the file.
+         */
+        static std::string getFileName(const std::string& path, int index);
+
+    private:
+
+        void openNextFile();
+
+    };
+
+}}}
+
+#endif /*_ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREFILE_H_*/
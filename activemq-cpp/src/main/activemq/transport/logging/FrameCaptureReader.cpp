@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameCaptureReader.h"
+
+#include <activemq/transport/logging/FrameCaptureFile.h>
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/IOException.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::logging;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    int getInt(const unsigned char* buffer) {
+        unsigned int value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value = (value << 8) | buffer[i];
+        }
+        return (int) value;
+    }
+
+    long long getLong(const unsigned char* buffer) {
+        unsigned long long value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value = (value << 8) | buffer[i];
+        }
+        return (long long) value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureReader::FrameCaptureReader(const std::string& fileName) :
+    file(new MappedFile(fileName)), sequence(0), creationTime(0), position(FrameCaptureFile::HEADER_SIZE),
+    direction(0), timestamp(0), frame(NULL), frameSize(0) {
+
+    const unsigned char* header = this->file->getAddress();
+
+    if (this->file->getSize() < FrameCaptureFile::HEADER_SIZE ||
+        std::memcmp(header, FrameCaptureFile::MAGIC, sizeof(FrameCaptureFile::MAGIC)) != 0) {
+
+        throw IOException(__FILE__, __LINE__, "Not a frame capture file: %s", fileName.c_str());
+    }
+
+    this->sequence = getLong(header + sizeof(FrameCaptureFile::MAGIC));
+    this->creationTime = getLong(header + sizeof(FrameCaptureFile::MAGIC) + 8);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureReader::~FrameCaptureReader() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FrameCaptureReader::next() {
+
+    long long size = this->file->getSize();
+
+    this->frame = NULL;
+    this->frameSize = 0;
+
+    if (this->position + FrameCaptureFile::RECORD_HEADER_SIZE > size) {
+        return false;
+    }
+
+    const unsigned char* record = this->file->getAddress() + this->position;
+    int length = getInt(record);
+
+    if (length <= 0 || this->position + FrameCaptureFile::RECORD_HEADER_SIZE + length > size) {
+        return false;
+    }
+
+    this->timestamp = getLong(record + 4);
+    this->direction = record[12];
+    this->frame = record + FrameCaptureFile::RECORD_HEADER_SIZE;
+    this->frameSize = length;
+    this->position += FrameCaptureFile::RECORD_HEADER_SIZE + length;
+
+    return true;
+}
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREREADER_H_
+#define _ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREREADER_H_
+
+#include <activemq/util/Config.h>
+
+#include <memory>
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace io {
+    class MappedFile;
+}}}
+
+namespace activemq {
+namespace transport {
+namespace logging {
+
+    /**
+     * Iterates over the frames recorded in one file written by a FrameCaptureFile.  The
+     * frame returned by getFrame can be passed to the unmarshal method of the WireFormat
+     * the connection was using to decode it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API FrameCaptureReader {
+    private:
+
+        std::auto_ptr<decaf::internal::io::MappedFile> file;
+        long long sequence;
+        long long creationTime;
+        long long position;
+
+        int direction;
+        long long timestamp;
+        const unsigned char* frame;
+        int frameSize;
+
+    private:
+
+        FrameCaptureReader(const FrameCaptureReader&);
+        FrameCaptureReader& operator= (const FrameCaptureReader&);
+
+    public:
+
+        /**
+         * Opens a capture file, the reader is positioned before its first frame.
+         *
+         * @param fileName
+         *      The name of the capture file.
+         *
+         * @throws IOException if the file can't be opened or isn't a capture file.
+         */
+        FrameCaptureReader(const std::string& fileName);
+
+        virtual ~FrameCaptureReader();
+
+        /**
+         * Moves to the next frame in the file.
+         *
+         * @return true if there was another frame, false at the end of the file.
+         */
+        bool next();
+
+        /**
+         * @return the sequence number of the file within its capture.
+         */
+        long long getSequence() const {
+            return this->sequence;
+        }
+
+        /**
+         * @return the time in milliseconds that the capture was started.
+         */
+        long long getCreationTime() const {
+            return this->creationTime;
+        }
+
+        /**
+         * @return the FrameCaptureFile::Direction of the current frame.
+         */
+        int getDirection() const {
+            return this->direction;
+        }
+
+        /**
+         * @return the time in microseconds since the epoch that the current frame was captured.
+         */
+        long long getTimestamp() const {
+            return this->timestamp;
+        }
+
+        /**
+         * @return the bytes of the current frame, valid until the reader is destroyed.
+         */
+        const unsigned char* getFrame() const {
+            return this->frame;
+        }
+
+        /**
+         * @return the number of bytes in the current frame.
+         */
+        int getFrameSize() const {
+            return this->frameSize;
+        }
+
+    };
+
+}}}
+
+#endif /*_ACTIVEMQ_TRANSPORT_LOGGING_FRAMECAPTUREREADER_H_*/
@@ -17,6 +17,11 @@
 
 #include "LoggingTransport.h"
 
+#include <activemq/transport/IOTransport.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::exceptions;
@@ -27,13 +32,62 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
-LoggingTransport::LoggingTransport(const Pointer<Transport> next) : TransportFilter(next) {
+LoggingTransport::LoggingTransport(const Pointer<Transport> next) : TransportFilter(next), capture() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoggingTransport::LoggingTransport(const Pointer<Transport> next, const Pointer<FrameCaptureFile> capture) :
+    TransportFilter(next), capture(capture) {
+
+    if (capture != NULL) {
+
+        IOTransport* io = dynamic_cast<IOTransport*>(next->narrow(typeid(IOTransport)));
+        if (io == NULL) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "LoggingTransport - frame capture requires an IOTransport");
+        }
+
+        io->setFrameCapture(capture);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FrameCaptureFile> LoggingTransport::createFrameCapture(const decaf::util::Properties& properties) {
+
+    try {
+
+        std::string path = properties.getProperty("transport.captureFile", "");
+        if (path.empty()) {
+            return Pointer<FrameCaptureFile>();
+        }
+
+        long long fileSize = Long::parseLong(properties.getProperty(
+            "transport.captureFileSize", Long::toString(FrameCaptureFile::DEFAULT_FILE_SIZE)));
+        int fileCount = Integer::parseInt(properties.getProperty(
+            "transport.captureFileCount", Integer::toString(FrameCaptureFile::DEFAULT_FILE_COUNT)));
+
+        return Pointer<FrameCaptureFile>(new FrameCaptureFile(path, fileSize, fileCount));
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(IllegalArgumentException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoggingTransport::doClose() {
+
+    if (this->capture != NULL) {
+        this->capture->close();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void LoggingTransport::onCommand(const Pointer<Command> command) {
 
-    std::cout << "RECV: " << command->toString() << std::endl;
+    if (this->capture == NULL) {
+        std::cout << "RECV: " << command->toString() << std::endl;
+    }
 
     // Delegate to the base class.
     TransportFilter::onCommand(command);
@@ -44,7 +98,9 @@ void LoggingTransport::oneway(const Pointer<Command> command) {
 
     try {
 
-        std::cout << "SEND: " << command->toString() << std::endl;
+        if (this->capture == NULL) {
+            std::cout << "SEND: " << command->toString() << std::endl;
+        }
 
         // Delegate to the base class.
         TransportFilter::oneway(command);
@@ -60,7 +116,9 @@ Pointer<Response> LoggingTransport::request(const Pointer<Command> command) {
 
     try {
 
-        std::cout << "SEND: " << command->toString() << std::endl;
+        if (this->capture == NULL) {
+            std::cout << "SEND: " << command->toString() << std::endl;
+        }
 
         // Delegate to the base class.
         Pointer<Response> response = TransportFilter::request(command);
@@ -78,7 +136,9 @@ Pointer<Response> LoggingTransport::request(const Pointer<Command> command, unsi
 
     try {
 
-        std::cout << "SEND: " << command->toString() << std::endl;
+        if (this->capture == NULL) {
+            std::cout << "SEND: " << command->toString() << std::endl;
+        }
 
         // Delegate to the base class.
         Pointer<Response> response = TransportFilter::request(command, timeout);
@@ -20,7 +20,9 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/transport/TransportFilter.h>
+#include <activemq/transport/logging/FrameCaptureFile.h>
 #include <decaf/lang/Pointer.h>
+#include <decaf/util/Properties.h>
 
 namespace activemq{
 namespace transport{
@@ -30,8 +32,20 @@ namespace logging{
 
     /**
      * A transport filter that logs commands as they are sent/received.
+     *
+     * In capture mode the commands aren't logged, instead the IOTransport at the bottom
+     * of the chain records the encoded frames into a FrameCaptureFile which is closed
+     * along with this transport.  Capture mode is configured with these URI options:
+     *
+     *  transport.captureFile      - the name the capture files are created with.
+     *  transport.captureFileSize  - the size of each capture file in bytes.
+     *  transport.captureFileCount - the number of capture files rotated through.
      */
     class AMQCPP_API LoggingTransport: public TransportFilter {
+    private:
+
+        Pointer<FrameCaptureFile> capture;
+
     public:
 
         /**
@@ -40,8 +54,39 @@ namespace logging{
          */
         LoggingTransport(const Pointer<Transport> next);
 
+        /**
+         * Creates a LoggingTransport in capture mode.
+         *
+         * @param next
+         *      The next Transport in the chain, it must be built on an IOTransport.
+         * @param capture
+         *      The capture that frames are recorded into.
+         *
+         * @throws IllegalArgumentException if there is no IOTransport in the chain.
+         */
+        LoggingTransport(const Pointer<Transport> next, const Pointer<FrameCaptureFile> capture);
+
         virtual ~LoggingTransport() {}
 
+        /**
+         * @return the capture frames are recorded into, or NULL if commands are logged.
+         */
+        Pointer<FrameCaptureFile> getFrameCapture() const {
+            return this->capture;
+        }
+
+        /**
+         * Creates the FrameCaptureFile described by the transport.captureFile options.
+         *
+         * @param properties
+         *      The transport's URI options.
+         *
+         * @return the new capture, or NULL if transport.captureFile isn't set.
+         *
+         * @throws IOException if the capture file can't be created.
+         */
+        static Pointer<FrameCaptureFile> createFrameCapture(const decaf::util::Properties& properties);
+
     public: // TransportFilter methods.
 
         virtual void onCommand(const Pointer<Command> command);
@@ -64,6 +109,10 @@ namespace logging{
          */
         virtual Pointer<Response> request(const Pointer<Command> command, unsigned int timeout);
 
+    protected:
+
+        virtual void doClose();
+
     };
 
 }}}
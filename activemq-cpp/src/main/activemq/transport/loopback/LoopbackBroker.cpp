@@ -0,0 +1,484 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackBroker.h"
+
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/commands/BrokerError.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/BrokerInfo.h>
+#include <activemq/commands/ConnectionId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/DestinationInfo.h>
+#include <activemq/commands/ExceptionResponse.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessagePull.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/Response.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/TransactionInfo.h>
+#include <activemq/transport/loopback/LoopbackTransport.h>
+
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::loopback;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    class LoopbackBrokerImpl {
+    private:
+
+        LoopbackBrokerImpl(const LoopbackBrokerImpl&);
+        LoopbackBrokerImpl& operator=(const LoopbackBrokerImpl&);
+
+    public:
+
+        struct Subscription {
+
+            Pointer<ConsumerInfo> info;
+            LoopbackTransport* transport;
+
+            // Messages a zero prefetch consumer has pulled and not yet been given.
+            int pulls;
+
+            Subscription(const Pointer<ConsumerInfo>& info, LoopbackTransport* transport) :
+                info(info), transport(transport), pulls(0) {}
+
+            bool canTake() const {
+                return this->info->getPrefetchSize() > 0 || this->pulls > 0;
+            }
+        };
+
+        struct DestinationState {
+
+            std::vector<Subscription> subscriptions;
+            std::deque< Pointer<Message> > pending;
+
+            // The queue subscription the next message is offered to first.
+            std::size_t next;
+
+            DestinationState() : subscriptions(), pending(), next(0) {}
+        };
+
+        typedef std::map<std::string, DestinationState> DestinationMap;
+        typedef std::map<std::string, std::vector< Pointer<Message> > > TransactionMap;
+
+        std::string name;
+
+        mutable Mutex mutex;
+
+        DestinationMap queues;
+        DestinationMap topics;
+        TransactionMap transactions;
+
+        // Names of the temporary destinations the connections have created.
+        std::set<std::string> temporaryDestinations;
+
+        LoopbackBrokerImpl(const std::string& name) :
+            name(name), mutex(), queues(), topics(), transactions(), temporaryDestinations() {}
+
+    public:
+
+        DestinationState& stateOf(const ActiveMQDestination& destination) {
+            DestinationMap& map = destination.isTopic() ? this->topics : this->queues;
+            return map[destination.getPhysicalName()];
+        }
+
+        static void dispatch(const Subscription& subscription, const Pointer<Message>& message) {
+
+            Pointer<MessageDispatch> dispatch(new MessageDispatch());
+            dispatch->setConsumerId(subscription.info->getConsumerId());
+            dispatch->setDestination(message->getDestination());
+
+            // Each consumer gets a message of its own, as if it had been unmarshalled,
+            // without the sending connection a message off the wire never has.
+            Pointer<Message> copy = message->copy();
+            copy->setConnection(NULL);
+            dispatch->setMessage(copy);
+            subscription.transport->deliver(dispatch);
+        }
+
+        void route(const Pointer<Message>& message) {
+
+            DestinationState& state = stateOf(*message->getDestination());
+
+            if (message->getDestination()->isTopic()) {
+                for (std::size_t i = 0; i < state.subscriptions.size(); ++i) {
+                    dispatch(state.subscriptions[i], message);
+                }
+                return;
+            }
+
+            state.pending.push_back(message);
+            drain(state);
+        }
+
+        // Hands out the held messages of a queue in turn to the consumers that can take them.
+        void drain(DestinationState& state) {
+
+            while (!state.pending.empty()) {
+
+                std::size_t count = state.subscriptions.size();
+                Subscription* target = NULL;
+                for (std::size_t i = 0; i < count && target == NULL; ++i) {
+                    Subscription& candidate = state.subscriptions[(state.next + i) % count];
+                    if (candidate.canTake()) {
+                        target = &candidate;
+                        state.next = (state.next + i + 1) % count;
+                    }
+                }
+
+                if (target == NULL) {
+                    return;
+                }
+
+                if (target->info->getPrefetchSize() == 0) {
+                    target->pulls--;
+                }
+
+                dispatch(*target, state.pending.front());
+                state.pending.pop_front();
+            }
+        }
+
+        // Sends a browser the messages the queue holds, leaving them for its consumers,
+        // followed by the empty dispatch that ends the browse.
+        static void browse(const Subscription& browser, const DestinationState& state) {
+
+            std::deque< Pointer<Message> >::const_iterator iter = state.pending.begin();
+            for (; iter != state.pending.end(); ++iter) {
+                dispatch(browser, *iter);
+            }
+
+            Pointer<MessageDispatch> done(new MessageDispatch());
+            done->setConsumerId(browser.info->getConsumerId());
+            done->setDestination(browser.info->getDestination());
+            browser.transport->deliver(done);
+        }
+
+        // Returns why the consumer is refused, empty when it was added.
+        std::string addConsumer(LoopbackTransport* source, const Pointer<ConsumerInfo>& info) {
+
+            // As a broker does, consumers of a temporary destination no connection
+            // created are refused.
+            if (info->getDestination()->isTemporary() &&
+                temporaryDestinations.count(info->getDestination()->getPhysicalName()) == 0) {
+                return "Cannot subscribe to the unknown temporary destination: " +
+                       info->getDestination()->getPhysicalName();
+            }
+
+            DestinationState& state = stateOf(*info->getDestination());
+
+            if (info->isBrowser()) {
+                browse(Subscription(info, source), state);
+                return "";
+            }
+
+            state.subscriptions.push_back(Subscription(info, source));
+
+            if (!info->getDestination()->isTopic()) {
+                drain(state);
+            }
+
+            return "";
+        }
+
+        void destination(const Pointer<DestinationInfo>& info) {
+
+            if (info->getDestination() == NULL || !info->getDestination()->isTemporary()) {
+                return;
+            }
+
+            if (info->getOperationType() == ActiveMQConstants::DESTINATION_ADD_OPERATION) {
+                temporaryDestinations.insert(info->getDestination()->getPhysicalName());
+            } else if (info->getOperationType() == ActiveMQConstants::DESTINATION_REMOVE_OPERATION) {
+                temporaryDestinations.erase(info->getDestination()->getPhysicalName());
+            }
+        }
+
+        void pull(const Pointer<MessagePull>& pull) {
+
+            if (pull->getDestination() == NULL || pull->getDestination()->isTopic()) {
+                return;
+            }
+
+            DestinationState& state = stateOf(*pull->getDestination());
+            for (std::size_t i = 0; i < state.subscriptions.size(); ++i) {
+                Subscription& subscription = state.subscriptions[i];
+                if (!subscription.info->getConsumerId()->equals(pull->getConsumerId().get())) {
+                    continue;
+                }
+
+                if (!state.pending.empty()) {
+                    dispatch(subscription, state.pending.front());
+                    state.pending.pop_front();
+                } else if (pull->getTimeout() < 0) {
+                    // Nothing to give a no wait receive, tell the consumer so.
+                    Pointer<MessageDispatch> none(new MessageDispatch());
+                    none->setConsumerId(pull->getConsumerId());
+                    none->setDestination(pull->getDestination());
+                    subscription.transport->deliver(none);
+                } else {
+                    subscription.pulls++;
+                }
+                return;
+            }
+        }
+
+        // Removes the subscriptions the predicate matches from every destination.
+        template<typename Predicate>
+        void removeConsumers(Predicate matches) {
+            removeConsumers(this->queues, matches);
+            removeConsumers(this->topics, matches);
+        }
+
+        template<typename Predicate>
+        static void removeConsumers(DestinationMap& map, Predicate matches) {
+
+            DestinationMap::iterator iter = map.begin();
+            for (; iter != map.end(); ++iter) {
+                std::vector<Subscription>& subscriptions = iter->second.subscriptions;
+                for (std::size_t i = 0; i < subscriptions.size();) {
+                    if (matches(subscriptions[i])) {
+                        subscriptions.erase(subscriptions.begin() + i);
+                    } else {
+                        ++i;
+                    }
+                }
+                iter->second.next = 0;
+            }
+        }
+
+        void transaction(const Pointer<TransactionInfo>& info) {
+
+            std::string key = info->getTransactionId()->toString();
+
+            switch (info->getType()) {
+                case ActiveMQConstants::TRANSACTION_STATE_COMMITONEPHASE:
+                case ActiveMQConstants::TRANSACTION_STATE_COMMITTWOPHASE: {
+                    TransactionMap::iterator found = this->transactions.find(key);
+                    if (found != this->transactions.end()) {
+                        std::vector< Pointer<Message> > messages;
+                        messages.swap(found->second);
+                        this->transactions.erase(found);
+                        for (std::size_t i = 0; i < messages.size(); ++i) {
+                            route(messages[i]);
+                        }
+                    }
+                    break;
+                }
+                case ActiveMQConstants::TRANSACTION_STATE_ROLLBACK:
+                case ActiveMQConstants::TRANSACTION_STATE_FORGET:
+                    this->transactions.erase(key);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        Pointer<BrokerInfo> createBrokerInfo() const {
+
+            Pointer<BrokerId> brokerId(new BrokerId());
+            brokerId->setValue("loopback:" + this->name);
+
+            Pointer<BrokerInfo> info(new BrokerInfo());
+            info->setBrokerId(brokerId);
+            info->setBrokerName(this->name);
+            info->setBrokerURL("loopback://" + this->name);
+            return info;
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    typedef LoopbackBrokerImpl::Subscription Subscription;
+
+    class OfTransport {
+    private:
+
+        LoopbackTransport* transport;
+
+    public:
+
+        OfTransport(LoopbackTransport* transport) : transport(transport) {}
+
+        bool operator()(const Subscription& subscription) const {
+            return subscription.transport == this->transport;
+        }
+    };
+
+    class OfRemovedId {
+    private:
+
+        const DataStructure* objectId;
+
+    public:
+
+        OfRemovedId(const DataStructure* objectId) : objectId(objectId) {}
+
+        bool operator()(const Subscription& subscription) const {
+
+            const ConsumerId* consumerId = subscription.info->getConsumerId().get();
+
+            switch (this->objectId->getDataStructureType()) {
+                case ConsumerId::ID_CONSUMERID:
+                    return consumerId->equals(this->objectId);
+                case SessionId::ID_SESSIONID: {
+                    const SessionId* sessionId = static_cast<const SessionId*>(this->objectId);
+                    return consumerId->getConnectionId() == sessionId->getConnectionId() &&
+                           consumerId->getSessionId() == sessionId->getValue();
+                }
+                case ConnectionId::ID_CONNECTIONID:
+                    return consumerId->getConnectionId() ==
+                           static_cast<const ConnectionId*>(this->objectId)->getValue();
+                default:
+                    return false;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackBroker::LoopbackBroker(const std::string& name) : impl(new LoopbackBrokerImpl(name)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackBroker::~LoopbackBroker() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LoopbackBroker::getName() const {
+    return this->impl->name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackBroker::process(LoopbackTransport* source, const Pointer<Command> command) {
+
+    std::string refusal;
+
+    synchronized(&this->impl->mutex) {
+
+        if (command->isMessage()) {
+            Pointer<Message> message = command.dynamicCast<Message>();
+            if (message->getTransactionId() != NULL) {
+                this->impl->transactions[message->getTransactionId()->toString()].push_back(message);
+            } else {
+                this->impl->route(message);
+            }
+        } else if (command->isConsumerInfo()) {
+            refusal = this->impl->addConsumer(source, command.dynamicCast<ConsumerInfo>());
+        } else if (command->isDestinationInfo()) {
+            this->impl->destination(command.dynamicCast<DestinationInfo>());
+        } else if (command->isMessagePull()) {
+            this->impl->pull(command.dynamicCast<MessagePull>());
+        } else if (command->isRemoveInfo()) {
+            Pointer<RemoveInfo> info = command.dynamicCast<RemoveInfo>();
+            if (info->getObjectId() != NULL) {
+                this->impl->removeConsumers(OfRemovedId(info->getObjectId().get()));
+            }
+        } else if (command->isTransactionInfo()) {
+            this->impl->transaction(command.dynamicCast<TransactionInfo>());
+        } else if (command->isConnectionInfo()) {
+            // A broker introduces itself once the connection is established.
+            source->deliver(this->impl->createBrokerInfo());
+        }
+    }
+
+    if (command->isResponseRequired()) {
+
+        Pointer<Response> response;
+        if (!refusal.empty()) {
+            Pointer<BrokerError> error(new BrokerError());
+            error->setExceptionClass("javax.jms.InvalidDestinationException");
+            error->setMessage(refusal);
+
+            Pointer<ExceptionResponse> exceptionResponse(new ExceptionResponse());
+            exceptionResponse->setException(error);
+            response = exceptionResponse;
+        } else {
+            response.reset(new Response());
+        }
+
+        response->setCorrelationId(command->getCommandId());
+        source->deliver(response);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackBroker::removeTransport(LoopbackTransport* source) {
+
+    synchronized(&this->impl->mutex) {
+        this->impl->removeConsumers(OfTransport(source));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LoopbackBroker::getPendingCount(const std::string& queueName) const {
+
+    int count = 0;
+    synchronized(&this->impl->mutex) {
+        LoopbackBrokerImpl::DestinationMap::const_iterator found = this->impl->queues.find(queueName);
+        if (found != this->impl->queues.end()) {
+            count = (int) found->second.pending.size();
+        }
+    }
+
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LoopbackBroker::getConsumerCount() const {
+
+    int count = 0;
+    synchronized(&this->impl->mutex) {
+        LoopbackBrokerImpl::DestinationMap::const_iterator iter = this->impl->queues.begin();
+        for (; iter != this->impl->queues.end(); ++iter) {
+            count += (int) iter->second.subscriptions.size();
+        }
+        for (iter = this->impl->topics.begin(); iter != this->impl->topics.end(); ++iter) {
+            count += (int) iter->second.subscriptions.size();
+        }
+    }
+
+    return count;
+}
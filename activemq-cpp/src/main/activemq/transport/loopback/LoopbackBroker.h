@@ -0,0 +1,108 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKBROKER_H_
+#define _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKBROKER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <string>
+
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    using decaf::lang::Pointer;
+
+    class LoopbackTransport;
+    class LoopbackBrokerImpl;
+
+    /**
+     * A minimal in-process broker shared by the LoopbackTransports created for the same
+     * name.  It answers the commands a client sends and routes the messages sent to a
+     * queue to one of its consumers in turn and the messages sent to a topic to all of
+     * its consumers, delivering them through each consumer's own transport.
+     *
+     * Queue messages with no consumer to take them are held until one subscribes, the
+     * messages of a transaction are routed when it commits and dropped when it rolls back.
+     * Acknowledgements are accepted and dropped, nothing is redelivered, and there are no
+     * wildcards, selectors, durable subscriptions or advisories.  Consumers with a prefetch
+     * of zero are handed queue messages only when they pull.  Consumers of a temporary
+     * destination that no connection created are refused with an error response.  A
+     * queue browser is sent a copy of each message the queue holds, then the end of the
+     * browse.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API LoopbackBroker {
+    private:
+
+        LoopbackBrokerImpl* impl;
+
+    private:
+
+        LoopbackBroker(const LoopbackBroker&);
+        LoopbackBroker& operator=(const LoopbackBroker&);
+
+    public:
+
+        LoopbackBroker(const std::string& name);
+
+        virtual ~LoopbackBroker();
+
+        /**
+         * @return the name the broker's transports are created with.
+         */
+        std::string getName() const;
+
+        /**
+         * Handles a command sent through the given transport, any response or message
+         * that results is delivered through the transport it is meant for.
+         *
+         * @param source
+         *      The transport the command was sent on.
+         * @param command
+         *      The command that was sent.
+         */
+        void process(LoopbackTransport* source, const Pointer<commands::Command> command);
+
+        /**
+         * Removes the consumers of a transport that is closing.
+         *
+         * @param source
+         *      The transport that is closing.
+         */
+        void removeTransport(LoopbackTransport* source);
+
+        /**
+         * @return the number of messages held on the named queue for want of a consumer.
+         */
+        int getPendingCount(const std::string& queueName) const;
+
+        /**
+         * @return the number of consumers subscribed to any destination.
+         */
+        int getConsumerCount() const;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKBROKER_H_ */
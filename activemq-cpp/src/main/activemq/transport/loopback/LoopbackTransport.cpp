@@ -0,0 +1,256 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackTransport.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/transport/TransportListener.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::loopback;
+using namespace activemq::wireformat;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    class LoopbackTransportImpl : public Runnable {
+    private:
+
+        LoopbackTransportImpl(const LoopbackTransportImpl&);
+        LoopbackTransportImpl& operator=(const LoopbackTransportImpl&);
+
+    public:
+
+        Pointer<LoopbackBroker> broker;
+        Pointer<WireFormat> wireFormat;
+        TransportListener* listener;
+
+        // Commands from the broker waiting for the delivery thread, a NULL command
+        // stops it.
+        LinkedBlockingQueue< Pointer<Command> > inbound;
+        Thread* deliveryThread;
+
+        AtomicBoolean started;
+        AtomicBoolean closed;
+
+        LoopbackTransportImpl(const Pointer<LoopbackBroker>& broker, const Pointer<WireFormat>& wireFormat) :
+            Runnable(), broker(broker), wireFormat(wireFormat), listener(NULL), inbound(),
+            deliveryThread(NULL), started(false), closed(false) {}
+
+        virtual ~LoopbackTransportImpl() {}
+
+        virtual void run() {
+
+            while (true) {
+
+                Pointer<Command> command = this->inbound.take();
+                if (command == NULL) {
+                    return;
+                }
+
+                TransportListener* listener = this->listener;
+                if (listener == NULL) {
+                    continue;
+                }
+
+                try {
+                    listener->onCommand(command);
+                } catch (Exception& ex) {
+                    listener->onException(ex);
+                } catch (...) {
+                    listener->onException(Exception(__FILE__, __LINE__,
+                        "LoopbackTransport - listener threw an unknown exception"));
+                }
+            }
+        }
+
+        void stopDelivery() {
+
+            if (this->deliveryThread == NULL) {
+                return;
+            }
+
+            this->inbound.offer(Pointer<Command>());
+
+            // The listener may close its own transport, the thread then ends by itself.
+            if (Thread::currentThread() != this->deliveryThread) {
+                this->deliveryThread->join();
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackTransport::LoopbackTransport(const Pointer<LoopbackBroker> broker, const Pointer<WireFormat> wireFormat) :
+    Transport(), impl(new LoopbackTransportImpl(broker, wireFormat)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackTransport::~LoopbackTransport() {
+    try {
+        close();
+        if (this->impl->deliveryThread != NULL && Thread::currentThread() != this->impl->deliveryThread) {
+            delete this->impl->deliveryThread;
+        }
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::deliver(const Pointer<Command> command) {
+
+    if (this->impl->closed.get()) {
+        return;
+    }
+
+    this->impl->inbound.offer(command);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<LoopbackBroker> LoopbackTransport::getBroker() const {
+    return this->impl->broker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::oneway(const Pointer<Command> command) {
+
+    try {
+
+        if (this->impl->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "LoopbackTransport::oneway - transport is closed");
+        }
+
+        this->impl->broker->process(this, command);
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FutureResponse> LoopbackTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
+                                                        const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "LoopbackTransport::asyncRequest() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> LoopbackTransport::request(const Pointer<Command> command AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "LoopbackTransport::request() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> LoopbackTransport::request(const Pointer<Command> command AMQCPP_UNUSED, unsigned int timeout AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "LoopbackTransport::request() - unsupported operation");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<WireFormat> LoopbackTransport::getWireFormat() const {
+    return this->impl->wireFormat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::setWireFormat(const Pointer<WireFormat> wireFormat) {
+    this->impl->wireFormat = wireFormat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::setTransportListener(TransportListener* listener) {
+    this->impl->listener = listener;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransportListener* LoopbackTransport::getTransportListener() const {
+    return this->impl->listener;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::start() {
+
+    try {
+
+        if (this->impl->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "LoopbackTransport::start - transport is closed");
+        }
+
+        if (this->impl->started.compareAndSet(false, true)) {
+            this->impl->deliveryThread = new Thread(this->impl,
+                "ActiveMQ Loopback Transport: " + this->impl->broker->getName());
+            this->impl->deliveryThread->start();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::stop() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransport::close() {
+
+    try {
+
+        if (this->impl->closed.compareAndSet(false, true)) {
+            this->impl->broker->removeTransport(this);
+            this->impl->stopDelivery();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool LoopbackTransport::isConnected() const {
+    return this->impl->started.get() && !this->impl->closed.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool LoopbackTransport::isClosed() const {
+    return this->impl->closed.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LoopbackTransport::getRemoteAddress() const {
+    return "loopback://" + this->impl->broker->getName();
+}
@@ -0,0 +1,164 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/Transport.h>
+#include <activemq/transport/loopback/LoopbackBroker.h>
+#include <activemq/wireformat/WireFormat.h>
+
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+    using activemq::commands::Response;
+
+    class LoopbackTransportImpl;
+
+    /**
+     * A Transport to a LoopbackBroker in the same process.  Commands sent are handed to
+     * the broker on the sending thread, without being marshalled, and whatever the broker
+     * sends back is queued to the transport and passed to its listener from a thread of
+     * its own, as a socket transport passes on what its reader thread reads.  The client
+     * runs its whole connection, session and consumer pipeline as it would against a
+     * remote broker, only without the network and the wire format.
+     *
+     * Like the IOTransport it only sends oneway commands, requests are correlated by a
+     * ResponseCorrelator above it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API LoopbackTransport : public Transport {
+    private:
+
+        LoopbackTransportImpl* impl;
+
+    private:
+
+        LoopbackTransport(const LoopbackTransport&);
+        LoopbackTransport& operator=(const LoopbackTransport&);
+
+    public:
+
+        /**
+         * @param broker
+         *      The broker commands are sent to.
+         * @param wireFormat
+         *      The WireFormat the client configured, reported by getWireFormat but not
+         *      used to marshal anything.
+         */
+        LoopbackTransport(const Pointer<LoopbackBroker> broker, const Pointer<wireformat::WireFormat> wireFormat);
+
+        virtual ~LoopbackTransport();
+
+        /**
+         * Queues a command from the broker for delivery to this transport's listener,
+         * commands that arrive once the transport is closed are dropped.
+         *
+         * @param command
+         *      The command to deliver.
+         */
+        void deliver(const Pointer<Command> command);
+
+        /**
+         * @return the broker this transport sends to.
+         */
+        Pointer<LoopbackBroker> getBroker() const;
+
+    public: // Transport Methods
+
+        virtual void oneway(const Pointer<Command> command);
+
+        /**
+         * {@inheritDoc}
+         *
+         * Not supported, requests are handled by a ResponseCorrelator.
+         */
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command,
+                                                     const Pointer<ResponseCallback> responseCallback);
+
+        /**
+         * {@inheritDoc}
+         *
+         * Not supported, requests are handled by a ResponseCorrelator.
+         */
+        virtual Pointer<Response> request(const Pointer<Command> command);
+
+        /**
+         * {@inheritDoc}
+         *
+         * Not supported, requests are handled by a ResponseCorrelator.
+         */
+        virtual Pointer<Response> request(const Pointer<Command> command, unsigned int timeout);
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const;
+
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat);
+
+        virtual void setTransportListener(TransportListener* listener);
+
+        virtual TransportListener* getTransportListener() const;
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual Transport* narrow(const std::type_info& typeId) {
+            if (typeid(*this) == typeId) {
+                return this;
+            }
+
+            return NULL;
+        }
+
+        virtual bool isFaultTolerant() const {
+            return false;
+        }
+
+        virtual bool isConnected() const;
+
+        virtual bool isClosed() const;
+
+        virtual std::string getRemoteAddress() const;
+
+        virtual void reconnect(const decaf::net::URI& uri AMQCPP_UNUSED) {}
+
+        virtual bool isReconnectSupported() const {
+            return false;
+        }
+
+        virtual bool isUpdateURIsSupported() const {
+            return false;
+        }
+
+        virtual void updateURIs(bool rebalance AMQCPP_UNUSED, const decaf::util::List<decaf::net::URI>& uris AMQCPP_UNUSED) {
+            throw decaf::io::IOException();
+        }
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORT_H_ */
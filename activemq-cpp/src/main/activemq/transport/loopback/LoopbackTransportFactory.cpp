@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackTransportFactory.h"
+
+#include <activemq/transport/correlator/ResponseCorrelator.h>
+#include <activemq/transport/logging/LoggingTransport.h>
+#include <activemq/transport/loopback/LoopbackTransport.h>
+#include <activemq/util/URISupport.h>
+
+#include <decaf/util/concurrent/Concurrent.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::wireformat;
+using namespace activemq::transport;
+using namespace activemq::transport::loopback;
+using namespace activemq::transport::correlator;
+using namespace activemq::transport::logging;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackTransportFactory::LoopbackTransportFactory() : AbstractTransportFactory(), mutex(), brokers() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoopbackTransportFactory::~LoopbackTransportFactory() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> LoopbackTransportFactory::create(const decaf::net::URI& location) {
+
+    try {
+
+        Properties properties = activemq::util::URISupport::parseQuery(location.getQuery());
+
+        Pointer<WireFormat> wireFormat = this->createWireFormat(properties);
+
+        Pointer<Transport> transport(doCreateComposite(location, wireFormat, properties));
+
+        transport.reset(new ResponseCorrelator(transport));
+
+        if (properties.getProperty("transport.commandTracingEnabled", "false") == "true") {
+            transport.reset(new LoggingTransport(transport));
+        }
+
+        return transport;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> LoopbackTransportFactory::createComposite(const decaf::net::URI& location) {
+
+    try {
+
+        Properties properties = activemq::util::URISupport::parseQuery(location.getQuery());
+
+        Pointer<WireFormat> wireFormat = this->createWireFormat(properties);
+
+        return doCreateComposite(location, wireFormat, properties);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> LoopbackTransportFactory::doCreateComposite(const decaf::net::URI& location,
+                                                               const Pointer<wireformat::WireFormat> wireFormat,
+                                                               const decaf::util::Properties& properties AMQCPP_UNUSED) {
+
+    try {
+
+        std::string name = location.getAuthority();
+        if (name.empty()) {
+            name = "localhost";
+        }
+
+        return Pointer<Transport>(new LoopbackTransport(getBroker(name), wireFormat));
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<LoopbackBroker> LoopbackTransportFactory::getBroker(const std::string& name) {
+
+    Pointer<LoopbackBroker> broker;
+
+    synchronized(&this->mutex) {
+        std::map< std::string, Pointer<LoopbackBroker> >::iterator found = this->brokers.find(name);
+        if (found != this->brokers.end()) {
+            broker = found->second;
+        } else {
+            broker.reset(new LoopbackBroker(name));
+            this->brokers.insert(std::make_pair(name, broker));
+        }
+    }
+
+    return broker;
+}
@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTFACTORY_H_
+#define _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTFACTORY_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/transport/AbstractTransportFactory.h>
+#include <activemq/transport/loopback/LoopbackBroker.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Manufactures LoopbackTransports for URIs of the form loopback://name, all the
+     * transports created for one name share the same in-process LoopbackBroker.  A
+     * broker is created with the first transport for its name and kept for the life
+     * of the factory, so messages held on its queues outlive the connections that
+     * sent them as they would on a real broker.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API LoopbackTransportFactory : public AbstractTransportFactory {
+    private:
+
+        decaf::util::concurrent::Mutex mutex;
+        std::map< std::string, Pointer<LoopbackBroker> > brokers;
+
+    private:
+
+        LoopbackTransportFactory(const LoopbackTransportFactory&);
+        LoopbackTransportFactory& operator=(const LoopbackTransportFactory&);
+
+    public:
+
+        LoopbackTransportFactory();
+
+        virtual ~LoopbackTransportFactory();
+
+        virtual Pointer<Transport> create(const decaf::net::URI& location);
+
+        virtual Pointer<Transport> createComposite(const decaf::net::URI& location);
+
+    protected:
+
+        virtual Pointer<Transport> doCreateComposite(const decaf::net::URI& location,
+                                                     const Pointer<wireformat::WireFormat> wireFormat,
+                                                     const decaf::util::Properties& properties);
+
+    private:
+
+        Pointer<LoopbackBroker> getBroker(const std::string& name);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTFACTORY_H_ */
@@ -0,0 +1,586 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripedTransport.h"
+
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ConsumerInfo.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessagePull.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/ProducerInfo.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/SessionInfo.h>
+#include <activemq/transport/TransportListener.h>
+#include <activemq/transport/TransportRegistry.h>
+#include <cms/Session.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/ArrayList.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::striped;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::net;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace striped {
+
+    class StripeListener : public TransportListener {
+    private:
+
+        StripedTransport* parent;
+
+    private:
+
+        StripeListener(const StripeListener&);
+        StripeListener& operator=(const StripeListener&);
+
+    public:
+
+        StripeListener(StripedTransport* parent) : parent(parent) {}
+
+        virtual ~StripeListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            TransportListener* listener = parent->getTransportListener();
+            if (listener != NULL) {
+                listener->onCommand(command);
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex) {
+            parent->handleTransportFailure(ex);
+        }
+
+        virtual void transportInterrupted() {
+            TransportListener* listener = parent->getTransportListener();
+            if (listener != NULL) {
+                listener->transportInterrupted();
+            }
+        }
+
+        virtual void transportResumed() {
+            TransportListener* listener = parent->getTransportListener();
+            if (listener != NULL) {
+                listener->transportResumed();
+            }
+        }
+    };
+
+    class StripedTransportImpl {
+    private:
+
+        StripedTransportImpl(const StripedTransportImpl&);
+        StripedTransportImpl& operator=(const StripedTransportImpl&);
+
+    public:
+
+        // Consumers are known by their session and own value, the connection is the same
+        // for all of them.
+        typedef std::pair<long long, long long> ConsumerKey;
+
+        int stripes;
+        ArrayList<URI> uris;
+        TransportListener* listener;
+        StripeListener stripeListener;
+
+        std::vector< Pointer<Transport> > transports;
+        AtomicBoolean started;
+        AtomicBoolean closed;
+        AtomicBoolean failed;
+
+        // Guards the assignments, the stripe list only changes while stopped.
+        mutable Mutex mutex;
+        std::map<long long, int> sessions;
+        std::map<ConsumerKey, int> consumers;
+        int nextStripe;
+
+        StripedTransportImpl(StripedTransport* parent) : stripes(2),
+                                                         uris(),
+                                                         listener(NULL),
+                                                         stripeListener(parent),
+                                                         transports(),
+                                                         started(false),
+                                                         closed(false),
+                                                         failed(false),
+                                                         mutex(),
+                                                         sessions(),
+                                                         consumers(),
+                                                         nextStripe(0) {
+        }
+
+        int sessionStripe(long long sessionId) const {
+            synchronized(&mutex) {
+                std::map<long long, int>::const_iterator found = sessions.find(sessionId);
+                if (found != sessions.end()) {
+                    return found->second;
+                }
+            }
+
+            return 0;
+        }
+
+        int consumerStripe(const Pointer<ConsumerId>& consumerId) const {
+
+            if (consumerId == NULL) {
+                return 0;
+            }
+
+            synchronized(&mutex) {
+                std::map<ConsumerKey, int>::const_iterator found =
+                    consumers.find(std::make_pair(consumerId->getSessionId(), consumerId->getValue()));
+                if (found != consumers.end()) {
+                    return found->second;
+                }
+            }
+
+            return sessionStripe(consumerId->getSessionId());
+        }
+
+        int producerStripe(const Pointer<ProducerId>& producerId) const {
+            return producerId == NULL ? 0 : sessionStripe(producerId->getSessionId());
+        }
+
+        // Transacted sessions are kept with the transactions on the first stripe, the
+        // others take the stripes in turn.
+        int assignSession(const SessionInfo& info) {
+
+            int stripe = 0;
+            long long sessionId = info.getSessionId()->getValue();
+
+            synchronized(&mutex) {
+                if (info.getAckMode() != (unsigned int) cms::Session::SESSION_TRANSACTED) {
+                    stripe = nextStripe;
+                    nextStripe = (nextStripe + 1) % (int) transports.size();
+                }
+                sessions[sessionId] = stripe;
+            }
+
+            return stripe;
+        }
+
+        // Durable subscribers are kept on the first stripe, where the connection's own
+        // client ID is used.
+        int assignConsumer(const ConsumerInfo& info) {
+
+            const Pointer<ConsumerId>& consumerId = info.getConsumerId();
+            int stripe = info.getSubscriptionName().empty() ? sessionStripe(consumerId->getSessionId()) : 0;
+
+            synchronized(&mutex) {
+                consumers[std::make_pair(consumerId->getSessionId(), consumerId->getValue())] = stripe;
+            }
+
+            return stripe;
+        }
+
+        // Returns the stripe the command goes to, or -1 if it goes to all of them.  The
+        // broadcast ones are answered by the stripe given in primary.
+        int route(const Pointer<Command>& command, int& primary) {
+
+            primary = 0;
+
+            if (command->isMessage()) {
+                Message* message = dynamic_cast<Message*>(command.get());
+                return message->getTransactionId() != NULL ? 0 : producerStripe(message->getProducerId());
+            } else if (command->isMessageAck()) {
+                MessageAck* ack = dynamic_cast<MessageAck*>(command.get());
+                return ack->getTransactionId() != NULL ? 0 : consumerStripe(ack->getConsumerId());
+            } else if (command->isMessagePull()) {
+                return consumerStripe(dynamic_cast<MessagePull*>(command.get())->getConsumerId());
+            } else if (command->isConsumerInfo()) {
+                return assignConsumer(*dynamic_cast<ConsumerInfo*>(command.get()));
+            } else if (command->isProducerInfo()) {
+                return producerStripe(dynamic_cast<ProducerInfo*>(command.get())->getProducerId());
+            } else if (command->isSessionInfo()) {
+                primary = assignSession(*dynamic_cast<SessionInfo*>(command.get()));
+                return -1;
+            } else if (command->isConnectionInfo() || command->isShutdownInfo()) {
+                return -1;
+            } else if (command->isRemoveInfo()) {
+                return routeRemove(*dynamic_cast<RemoveInfo*>(command.get()), primary);
+            }
+
+            // Transactions, temporary destinations and the rest stay on the first stripe.
+            return 0;
+        }
+
+        int routeRemove(const RemoveInfo& info, int& primary) {
+
+            const Pointer<DataStructure>& objectId = info.getObjectId();
+            if (objectId == NULL) {
+                return 0;
+            }
+
+            unsigned char type = objectId->getDataStructureType();
+
+            if (type == ConsumerId::ID_CONSUMERID) {
+                Pointer<ConsumerId> consumerId = objectId.dynamicCast<ConsumerId>();
+                int stripe = consumerStripe(consumerId);
+                synchronized(&mutex) {
+                    consumers.erase(std::make_pair(consumerId->getSessionId(), consumerId->getValue()));
+                }
+                return stripe;
+            } else if (type == ProducerId::ID_PRODUCERID) {
+                return producerStripe(objectId.dynamicCast<ProducerId>());
+            } else if (type == SessionId::ID_SESSIONID) {
+                long long sessionId = objectId.dynamicCast<SessionId>()->getValue();
+                primary = sessionStripe(sessionId);
+                synchronized(&mutex) {
+                    sessions.erase(sessionId);
+                }
+                return -1;
+            } else if (type == ConnectionId::ID_CONNECTIONID) {
+                return -1;
+            }
+
+            return 0;
+        }
+
+        // The copy of a broadcast command sent to a stripe that doesn't answer for it,
+        // the stripe's connection is registered under a client ID of its own.
+        Pointer<Command> copyFor(const Pointer<Command>& command, int stripe) {
+
+            if (!command->isResponseRequired() && !command->isConnectionInfo()) {
+                return command;
+            }
+
+            Pointer<Command> copy(dynamic_cast<Command*>(command->cloneDataStructure()));
+            copy->setResponseRequired(false);
+
+            if (copy->isConnectionInfo()) {
+                ConnectionInfo* info = dynamic_cast<ConnectionInfo*>(copy.get());
+                info->setClientId(info->getClientId() + "-stripe-" + Integer::toString(stripe));
+            }
+
+            return copy;
+        }
+
+        void closeTransports() {
+            for (std::size_t i = 0; i < transports.size(); ++i) {
+                try {
+                    transports[i]->close();
+                } catch (...) {
+                }
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+StripedTransport::StripedTransport() : CompositeTransport(), impl(new StripedTransportImpl(this)) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StripedTransport::~StripedTransport() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::setStripes(int stripes) {
+
+    if (stripes < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "The number of stripes must be at least one: %d", stripes);
+    }
+
+    this->impl->stripes = stripes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int StripedTransport::getStripes() const {
+    return this->impl->stripes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int StripedTransport::getSessionStripe(long long sessionId) const {
+
+    synchronized(&this->impl->mutex) {
+        std::map<long long, int>::const_iterator found = this->impl->sessions.find(sessionId);
+        if (found != this->impl->sessions.end()) {
+            return found->second;
+        }
+    }
+
+    return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::addURI(bool rebalance AMQCPP_UNUSED, const List<URI>& uris) {
+
+    synchronized(&this->impl->mutex) {
+        this->impl->uris.addAll(uris);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::removeURI(bool rebalance AMQCPP_UNUSED, const List<URI>& uris) {
+
+    synchronized(&this->impl->mutex) {
+        this->impl->uris.removeAll(uris);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::start() {
+
+    try {
+
+        if (this->impl->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "The transport is closed.");
+        }
+
+        if (!this->impl->started.compareAndSet(false, true)) {
+            return;
+        }
+
+        if (this->impl->transports.empty()) {
+
+            if (this->impl->uris.isEmpty()) {
+                throw IOException(__FILE__, __LINE__, "No URIs were given to connect the stripes to.");
+            }
+
+            for (int i = 0; i < this->impl->stripes; ++i) {
+
+                URI location = this->impl->uris.get(i % this->impl->uris.size());
+
+                TransportFactory* factory = TransportRegistry::getInstance().findFactory(location.getScheme());
+                if (factory == NULL) {
+                    throw IOException(__FILE__, __LINE__, "Invalid URI specified, no valid Factory Found.");
+                }
+
+                Pointer<Transport> transport(factory->createComposite(location));
+                transport->setTransportListener(&this->impl->stripeListener);
+                this->impl->transports.push_back(transport);
+            }
+        }
+
+        try {
+            for (std::size_t i = 0; i < this->impl->transports.size(); ++i) {
+                this->impl->transports[i]->start();
+            }
+        } catch (...) {
+            this->impl->closeTransports();
+            this->impl->transports.clear();
+            this->impl->started.set(false);
+            throw;
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::stop() {
+
+    try {
+
+        if (!this->impl->started.compareAndSet(true, false)) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < this->impl->transports.size(); ++i) {
+            this->impl->transports[i]->stop();
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::close() {
+
+    if (!this->impl->closed.compareAndSet(false, true)) {
+        return;
+    }
+
+    this->impl->started.set(false);
+    this->impl->closeTransports();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::oneway(const Pointer<Command> command) {
+
+    try {
+
+        if (this->impl->closed.get()) {
+            throw IOException(__FILE__, __LINE__, "The transport is closed.");
+        }
+
+        if (this->impl->transports.empty()) {
+            throw IOException(__FILE__, __LINE__, "The transport has not been started.");
+        }
+
+        int primary = 0;
+        int stripe = this->impl->route(command, primary);
+
+        if (stripe >= 0) {
+            this->impl->transports[stripe]->oneway(command);
+            return;
+        }
+
+        // The stripe answering for the command gets it first, the broker then knows of
+        // a new session on it before any of the session's commands arrive elsewhere.
+        this->impl->transports[primary]->oneway(command);
+
+        for (int i = 0; i < (int) this->impl->transports.size(); ++i) {
+            if (i != primary) {
+                this->impl->transports[i]->oneway(this->impl->copyFor(command, i));
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<FutureResponse> StripedTransport::asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
+                                                       const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__, "StripedTransport::asyncRequest - Not Supported");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> StripedTransport::request(const Pointer<Command> command AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__, "StripedTransport::request - Not Supported");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Response> StripedTransport::request(const Pointer<Command> command AMQCPP_UNUSED, unsigned int timeout AMQCPP_UNUSED) {
+    throw UnsupportedOperationException(__FILE__, __LINE__, "StripedTransport::request - Not Supported");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<wireformat::WireFormat> StripedTransport::getWireFormat() const {
+
+    if (this->impl->transports.empty()) {
+        return Pointer<wireformat::WireFormat>();
+    }
+
+    return this->impl->transports[0]->getWireFormat();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::setTransportListener(TransportListener* listener) {
+    this->impl->listener = listener;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransportListener* StripedTransport::getTransportListener() const {
+    return this->impl->listener;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Transport* StripedTransport::narrow(const std::type_info& typeId) {
+
+    if (typeid(*this) == typeId) {
+        return this;
+    }
+
+    if (!this->impl->transports.empty()) {
+        return this->impl->transports[0]->narrow(typeId);
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool StripedTransport::isConnected() const {
+
+    if (this->impl->transports.empty() || this->impl->failed.get()) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < this->impl->transports.size(); ++i) {
+        if (!this->impl->transports[i]->isConnected()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool StripedTransport::isClosed() const {
+    return this->impl->closed.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string StripedTransport::getRemoteAddress() const {
+
+    if (this->impl->transports.empty()) {
+        return "";
+    }
+
+    return this->impl->transports[0]->getRemoteAddress();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::reconnect(const decaf::net::URI& uri AMQCPP_UNUSED) {
+    throw IOException(__FILE__, __LINE__, "StripedTransport::reconnect - Not Supported");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::updateURIs(bool rebalance AMQCPP_UNUSED, const decaf::util::List<decaf::net::URI>& uris AMQCPP_UNUSED) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransport::handleTransportFailure(const decaf::lang::Exception& error) {
+
+    // The first failure is reported, the connection is gone along with its sessions.
+    if (this->impl->closed.get() || !this->impl->failed.compareAndSet(false, true)) {
+        return;
+    }
+
+    if (this->impl->listener != NULL) {
+        this->impl->listener->onException(error);
+    }
+}
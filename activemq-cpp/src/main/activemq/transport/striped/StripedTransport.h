@@ -0,0 +1,162 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+
+#include <activemq/commands/Command.h>
+#include <activemq/transport/CompositeTransport.h>
+#include <activemq/wireformat/WireFormat.h>
+
+#include <decaf/util/List.h>
+#include <decaf/net/URI.h>
+
+namespace activemq {
+namespace transport {
+namespace striped {
+
+    using decaf::lang::Pointer;
+    using activemq::commands::Command;
+    using activemq::commands::Response;
+
+    class StripedTransportImpl;
+    class StripeListener;
+
+    /**
+     * A Transport that spreads the sessions of one connection over several connections
+     * to the same broker, so that a connection isn't limited to what one TCP stream and
+     * one reader thread can carry.
+     *
+     * Each stripe is a full connection of its own, created from the URIs of the composite
+     * in turn, that the broker knows by the connection's ID and a client ID with the stripe
+     * number appended.  Every session is assigned to one stripe when it is created and
+     * all its producers, consumers, messages and acks go through that stripe, keeping
+     * their order.  Connection level commands go to all stripes, the first one answering
+     * for the connection.  Sessions are registered with every stripe so that a consumer
+     * can be moved to the first stripe, which durable subscribers are as the broker knows
+     * their subscriptions by the connection's own client ID.  Transacted sessions and
+     * temporary destinations stay on the first stripe along with the transactions.
+     *
+     * XA transactions span sessions that aren't transacted, they can only be used with a
+     * single stripe.  A stripe that fails fails the whole transport.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API StripedTransport : public CompositeTransport {
+    private:
+
+        StripedTransportImpl* impl;
+
+    private:
+
+        StripedTransport(const StripedTransport&);
+        StripedTransport& operator=(const StripedTransport&);
+
+    public:
+
+        StripedTransport();
+
+        virtual ~StripedTransport();
+
+        /**
+         * Sets the number of connections the sessions are spread over, takes effect
+         * when the transport is started.
+         *
+         * @param stripes
+         *      The number of stripes, at least one.
+         */
+        void setStripes(int stripes);
+
+        /**
+         * @return the number of connections the sessions are spread over.
+         */
+        int getStripes() const;
+
+        /**
+         * @return the stripe the session with the given ID was assigned to, or -1 if
+         *         the transport knows no such session.
+         */
+        int getSessionStripe(long long sessionId) const;
+
+    public: // CompositeTransport methods
+
+        virtual void addURI(bool rebalance, const decaf::util::List<decaf::net::URI>& uris);
+
+        virtual void removeURI(bool rebalance, const decaf::util::List<decaf::net::URI>& uris);
+
+    public: // Transport methods
+
+        virtual void start();
+
+        virtual void stop();
+
+        virtual void close();
+
+        virtual void oneway(const Pointer<Command> command);
+
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command,
+                                                     const Pointer<ResponseCallback> responseCallback);
+
+        virtual Pointer<Response> request(const Pointer<Command> command);
+
+        virtual Pointer<Response> request(const Pointer<Command> command, unsigned int timeout);
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const;
+
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat AMQCPP_UNUSED) {}
+
+        virtual void setTransportListener(TransportListener* listener);
+
+        virtual TransportListener* getTransportListener() const;
+
+        virtual Transport* narrow(const std::type_info& typeId);
+
+        virtual bool isFaultTolerant() const {
+            return false;
+        }
+
+        virtual bool isConnected() const;
+
+        virtual bool isClosed() const;
+
+        virtual bool isReconnectSupported() const {
+            return false;
+        }
+
+        virtual bool isUpdateURIsSupported() const {
+            return false;
+        }
+
+        virtual std::string getRemoteAddress() const;
+
+        virtual void reconnect(const decaf::net::URI& uri);
+
+        virtual void updateURIs(bool rebalance, const decaf::util::List<decaf::net::URI>& uris);
+
+    private:
+
+        friend class StripeListener;
+
+        void handleTransportFailure(const decaf::lang::Exception& error);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORT_H_ */
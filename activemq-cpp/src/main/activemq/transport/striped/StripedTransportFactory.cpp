@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripedTransportFactory.h"
+
+#include <activemq/transport/striped/StripedTransport.h>
+#include <activemq/transport/correlator/ResponseCorrelator.h>
+#include <activemq/util/CompositeData.h>
+#include <activemq/util/URISupport.h>
+
+#include <decaf/lang/Integer.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::transport;
+using namespace activemq::transport::striped;
+using namespace activemq::transport::correlator;
+using namespace activemq::exceptions;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> StripedTransportFactory::create(const decaf::net::URI& location) {
+
+    try {
+
+        // Create the initial Transport, then wrap it in the normal Filters
+        Pointer<Transport> transport(doCreateComposite(location));
+
+        // Create the Transport for response correlator
+        transport.reset(new ResponseCorrelator(transport));
+
+        return transport;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> StripedTransportFactory::createComposite(const decaf::net::URI& location) {
+
+    try {
+        return doCreateComposite(location);
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> StripedTransportFactory::doCreateComposite(const decaf::net::URI& location) {
+
+    try {
+
+        CompositeData data = URISupport::parseComposite(location);
+        Pointer<StripedTransport> transport(new StripedTransport());
+
+        Properties topLvlProperties = data.getParameters();
+
+        transport->setStripes(Integer::parseInt(topLvlProperties.getProperty("stripes", "2")));
+
+        transport->addURI(false, data.getComponents());
+
+        return transport;
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORTFACTORY_H_
+#define _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORTFACTORY_H_
+
+#include <activemq/util/Config.h>
+
+#include <activemq/transport/AbstractTransportFactory.h>
+#include <activemq/transport/Transport.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/Properties.h>
+
+namespace activemq {
+namespace transport {
+namespace striped {
+
+    using decaf::lang::Pointer;
+
+    /**
+     * Creates an instance of a StripedTransport from a composite URI such as
+     * striped:(tcp://host:61616)?stripes=4.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API StripedTransportFactory : public AbstractTransportFactory {
+    public:
+
+        virtual ~StripedTransportFactory() {}
+
+        virtual Pointer<Transport> create(const decaf::net::URI& location);
+
+        virtual Pointer<Transport> createComposite(const decaf::net::URI& location);
+
+    protected:
+
+        virtual Pointer<Transport> doCreateComposite(const decaf::net::URI& location);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_STRIPED_STRIPEDTRANSPORTFACTORY_H_ */
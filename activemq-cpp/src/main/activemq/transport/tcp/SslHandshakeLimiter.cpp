@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SslHandshakeLimiter.h"
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::net::ssl;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    SslHandshakeLimiter* instance = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SslHandshakeLimiter::SslHandshakeLimiter(int maxConcurrent, int startInterval) :
+    maxConcurrent(maxConcurrent), startInterval(startInterval),
+    permits(maxConcurrent > 0 ? maxConcurrent : 1, true), pacingLock(), nextStart(0) {
+
+    if (maxConcurrent <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "Concurrent handshake limit must be positive: %d", maxConcurrent);
+    }
+
+    if (startInterval < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "Handshake start interval cannot be negative: %d", startInterval);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SslHandshakeLimiter::~SslHandshakeLimiter() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiter::handshake(SSLSocket* socket, long long timeout) {
+
+    try {
+
+        if (socket == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Socket passed was NULL");
+        }
+
+        if (!this->acquire(timeout)) {
+            throw IOException(__FILE__, __LINE__,
+                "Timed out waiting %lld ms to start the SSL handshake", timeout);
+        }
+
+        try {
+            socket->startHandshake();
+        } catch (...) {
+            this->release();
+            throw;
+        }
+
+        this->release();
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(InterruptedException, IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SslHandshakeLimiter::acquire(long long timeout) {
+
+    if (timeout > 0) {
+        if (!permits.tryAcquire(timeout, TimeUnit::MILLISECONDS)) {
+            return false;
+        }
+    } else {
+        permits.acquire();
+    }
+
+    if (this->startInterval == 0) {
+        return true;
+    }
+
+    // Each turn claims the next start slot, so the waits of handshakes that were let
+    // through together are spread out rather than all ending at once.
+    long long start = 0;
+    long long now = System::nanoTime();
+
+    synchronized(&pacingLock) {
+        start = nextStart > now ? nextStart : now;
+        nextStart = start + TimeUnit::MILLISECONDS.toNanos(this->startInterval);
+    }
+
+    try {
+        if (start > now) {
+            TimeUnit::NANOSECONDS.sleep(start - now);
+        }
+    } catch (...) {
+        permits.release();
+        throw;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiter::release() {
+    permits.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int SslHandshakeLimiter::getActiveCount() const {
+    return this->maxConcurrent - permits.availablePermits();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SslHandshakeLimiter& SslHandshakeLimiter::getInstance() {
+
+    if (instance == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    return *instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiter::initialize() {
+
+    int maxConcurrent = System::availableProcessors();
+    int startInterval = 0;
+
+    try {
+        maxConcurrent = Integer::parseInt(System::getProperty(
+            "activemq.ssl.handshake.maxConcurrent", Integer::toString(maxConcurrent)));
+        startInterval = Integer::parseInt(System::getProperty(
+            "activemq.ssl.handshake.startInterval", "0"));
+    } catch (Exception&) {
+    }
+
+    instance = new SslHandshakeLimiter(maxConcurrent > 0 ? maxConcurrent : 1, startInterval > 0 ? startInterval : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiter::shutdownInstance() {
+    SslHandshakeLimiter* old = instance;
+    instance = NULL;
+    delete old;
+}
@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_SSLHANDSHAKELIMITER_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_SSLHANDSHAKELIMITER_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/net/ssl/SSLSocket.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/Semaphore.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace tcp {
+
+    /**
+     * Process wide limit on the SSL handshakes that SslTransports run at once.  After a
+     * broker restarts every failover transport reconnects at about the same moment and
+     * each full handshake costs a burst of CPU for the key exchange, run all together
+     * they starve the threads carrying live traffic and each takes longer than it would
+     * alone.  Transports take a turn here before their handshake, so no more than the
+     * configured number run at once and successive handshakes start at least the start
+     * interval apart, turning the storm into a steady ramp.  Handshakes that resume a
+     * cached session finish quickly and hand their turn on sooner.
+     *
+     * Turns are granted in the order they are asked for.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API SslHandshakeLimiter {
+    private:
+
+        int maxConcurrent;
+        int startInterval;
+
+        decaf::util::concurrent::Semaphore permits;
+
+        decaf::util::concurrent::Mutex pacingLock;
+
+        // Earliest time in nanoseconds the next handshake may start.
+        long long nextStart;
+
+    private:
+
+        SslHandshakeLimiter(const SslHandshakeLimiter&);
+        SslHandshakeLimiter& operator= (const SslHandshakeLimiter&);
+
+    public:
+
+        /**
+         * Creates a new SslHandshakeLimiter.
+         *
+         * @param maxConcurrent
+         *      The most handshakes that can run at once.
+         * @param startInterval
+         *      The least time in milliseconds between the start of two handshakes.
+         *
+         * @throws IllegalArgumentException if maxConcurrent is not positive or the
+         *         interval is negative.
+         */
+        SslHandshakeLimiter(int maxConcurrent, int startInterval);
+
+        virtual ~SslHandshakeLimiter();
+
+        /**
+         * Waits for a turn, runs the handshake of the socket on the calling thread and
+         * ends the turn whether it succeeded or not.
+         *
+         * @param socket
+         *      The connected socket whose handshake is to run.
+         * @param timeout
+         *      The longest time in milliseconds to wait for a turn, zero or less waits
+         *      as long as it takes.
+         *
+         * @throws NullPointerException if the socket is NULL.
+         * @throws IOException if no turn came before the timeout or the handshake fails.
+         */
+        void handshake(decaf::net::ssl::SSLSocket* socket, long long timeout);
+
+        /**
+         * Waits until another handshake may start, each successful call must be matched
+         * by a call to release once the handshake is over.
+         *
+         * @param timeout
+         *      The longest time in milliseconds to wait, zero or less waits as long as
+         *      it takes.
+         *
+         * @return true if a turn was taken, false if the timeout passed first.
+         *
+         * @throws InterruptedException if the thread is interrupted while waiting.
+         */
+        bool acquire(long long timeout);
+
+        /**
+         * Ends a turn taken by acquire.
+         */
+        void release();
+
+        /**
+         * @return the number of handshakes currently running.
+         */
+        int getActiveCount() const;
+
+        /**
+         * @return the most handshakes that can run at once.
+         */
+        int getMaxConcurrent() const {
+            return this->maxConcurrent;
+        }
+
+        /**
+         * @return the least time in milliseconds between the start of two handshakes.
+         */
+        int getStartInterval() const {
+            return this->startInterval;
+        }
+
+    public:
+
+        /**
+         * Returns the limiter shared by all SslTransports in the process.  It is created
+         * by the library initialization from the activemq.ssl.handshake.maxConcurrent
+         * property, which defaults to the number of processors, and the property
+         * activemq.ssl.handshake.startInterval, which defaults to zero.
+         *
+         * @return the shared SslHandshakeLimiter instance.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static SslHandshakeLimiter& getInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdownInstance();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_SSLHANDSHAKELIMITER_H_ */
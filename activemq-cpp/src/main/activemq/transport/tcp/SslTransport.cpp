@@ -17,6 +17,7 @@
 
 #include "SslTransport.h"
 
+#include <activemq/transport/tcp/SslHandshakeLimiter.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Boolean.h>
 #include <decaf/net/ssl/SSLSocket.h>
@@ -39,13 +40,23 @@ using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 SslTransport::SslTransport(const Pointer<Transport> next, const decaf::net::URI& location) :
-    TcpTransport(next, location) {
+    TcpTransport(next, location), kernelTLS(false) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 SslTransport::~SslTransport() {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SslTransport::setKernelTLS(bool kernelTLS) {
+    this->kernelTLS = kernelTLS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SslTransport::isKernelTLS() const {
+    return this->kernelTLS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Socket* SslTransport::createSocket() {
 
@@ -59,6 +70,25 @@ Socket* SslTransport::createSocket() {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SslTransport::connectSocket(Socket* socket) {
+
+    try {
+
+        TcpTransport::connectSocket(socket);
+
+        // Without this the handshake would run on whichever thread first reads or
+        // writes, outside of any limit.
+        SSLSocket* sslSocket = dynamic_cast<SSLSocket*>(socket);
+        if (sslSocket != NULL) {
+            SslHandshakeLimiter::getInstance().handshake(sslSocket, this->getConnectTimeout());
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void SslTransport::configureSocket(Socket* socket) {
 
@@ -81,6 +111,7 @@ void SslTransport::configureSocket(Socket* socket) {
         params.setServerNames(serverNames);
 
         sslSocket->setSSLParameters(params);
+        sslSocket->setUseKernelTLS(this->kernelTLS);
 
         TcpTransport::configureSocket(socket);
     }
@@ -34,6 +34,10 @@ namespace tcp {
      * @since 3.2.0
      */
     class AMQCPP_API SslTransport : public TcpTransport {
+    private:
+
+        bool kernelTLS;
+
     private:
 
         SslTransport(const SslTransport&);
@@ -54,6 +58,21 @@ namespace tcp {
 
         virtual ~SslTransport();
 
+        /**
+         * Sets whether the socket should hand encryption of outgoing data to the kernel's
+         * TLS support once the handshake completes.  When the kernel or the SSL library
+         * lacks support for it the socket keeps encrypting in user space.
+         *
+         * @param kernelTLS
+         *      True to request kernel TLS, false (the default) otherwise.
+         */
+        void setKernelTLS(bool kernelTLS);
+
+        /**
+         * @return true if kernel TLS is requested for the sockets this transport creates.
+         */
+        bool isKernelTLS() const;
+
     protected:
 
         /**
@@ -61,11 +80,28 @@ namespace tcp {
          */
         virtual decaf::net::Socket* createSocket();
 
+        /**
+         * Connects the socket and runs the SSL handshake once it is connected, taking
+         * a turn from the SslHandshakeLimiter so that transports reconnecting together
+         * don't all handshake at once.  The connect timeout also bounds the wait for
+         * the turn.
+         */
+        virtual void connectSocket(decaf::net::Socket* socket);
+
         /**
          * {@inheritDoc}
          */
         virtual void configureSocket(decaf::net::Socket* socket);
 
+        /**
+         * The SSL records can only be decoded by reading through the SSLSocket's streams.
+         *
+         * @return false always.
+         */
+        virtual bool isEventLoopSupported() const {
+            return false;
+        }
+
     };
 
 }}}
@@ -22,6 +22,7 @@
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/inactivity/InactivityMonitor.h>
 #include <activemq/transport/logging/LoggingTransport.h>
+#include <decaf/lang/Boolean.h>
 
 #include <memory>
 
@@ -50,7 +51,7 @@ Pointer<Transport> SslTransportFactory::doCreateComposite(const decaf::net::URI&
 
     try {
 
-        Pointer<Transport> transport(new IOTransport(wireFormat));
+        Pointer<Transport> transport(createIOTransport(wireFormat, properties));
 
         transport.reset(new SslTransport(transport, location));
 
@@ -62,8 +63,11 @@ Pointer<Transport> SslTransportFactory::doCreateComposite(const decaf::net::URI&
             transport.reset(new InactivityMonitor(transport, properties, wireFormat));
         }
 
-        // If command tracing was enabled, wrap the transport with a logging transport.
-        if (properties.getProperty("transport.commandTracingEnabled", "false") == "true") {
+        // If frame capture or command tracing was enabled, wrap the transport with a logging transport.
+        Pointer<FrameCaptureFile> capture = LoggingTransport::createFrameCapture(properties);
+        if (capture != NULL) {
+            transport.reset(new LoggingTransport(transport, capture));
+        } else if (properties.getProperty("transport.commandTracingEnabled", "false") == "true") {
             // Create the Transport for response correlator
             transport.reset(new LoggingTransport(transport));
         }
@@ -79,3 +83,20 @@ Pointer<Transport> SslTransportFactory::doCreateComposite(const decaf::net::URI&
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
     AMQ_CATCHALL_THROW(ActiveMQException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SslTransportFactory::doConfigureTransport(Pointer<Transport> transport,
+                                               const decaf::util::Properties& properties) {
+
+    try {
+
+        TcpTransportFactory::doConfigureTransport(transport, properties);
+
+        Pointer<SslTransport> ssl = transport.dynamicCast<SslTransport>();
+
+        ssl->setKernelTLS(Boolean::parseBoolean(properties.getProperty("transport.kernelTLS", "false")));
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
@@ -39,6 +39,9 @@ namespace tcp {
                                                      const Pointer<wireformat::WireFormat> wireFormat,
                                                      const decaf::util::Properties& properties );
 
+        virtual void doConfigureTransport(Pointer<Transport> transport,
+                                          const decaf::util::Properties& properties);
+
     };
 
 }}}
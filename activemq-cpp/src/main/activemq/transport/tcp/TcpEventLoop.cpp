@@ -0,0 +1,578 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TcpEventLoop.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/internal/net/tcp/TcpSocketPoller.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/StlMap.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::exceptions;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int TcpEventLoop::DEFAULT_LOOP_THREADS = 2;
+const int TcpEventLoop::DEFAULT_SOCKETS_PER_LOOP = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    TcpEventLoop* instance = NULL;
+
+    // How long a poll waits when the platform can't interrupt it to pick up changes.
+    const long long POLL_INTERVAL = 100;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    class SocketRegistration {
+    private:
+
+        SocketRegistration(const SocketRegistration&);
+        SocketRegistration& operator= (const SocketRegistration&);
+
+    public:
+
+        TcpSocket* socket;
+        TcpEventLoop::Handler* handler;
+
+        // Set once the loop thread has added the socket to its poller.
+        bool added;
+
+        // Set when the socket should no longer be watched, detached once the loop
+        // thread has taken it out of the poller.
+        bool removed;
+        bool detached;
+
+        IOException error;
+        bool failed;
+
+        SocketRegistration(TcpSocket* socket, TcpEventLoop::Handler* handler) :
+            socket(socket), handler(handler), added(false), removed(false), detached(false),
+            error(), failed(false) {
+        }
+    };
+
+    class EventLoopThread : public Runnable {
+    private:
+
+        EventLoopThread(const EventLoopThread&);
+        EventLoopThread& operator= (const EventLoopThread&);
+
+    public:
+
+        std::string name;
+        int capacity;
+
+        mutable Mutex mutex;
+        StlMap< TcpSocket*, Pointer<SocketRegistration> > registrations;
+        LinkedList< Pointer<SocketRegistration> > pending;
+
+        // Detached registrations are kept until the current batch of ready sockets
+        // has been handled since a later entry in it may still refer to one of them.
+        std::vector< Pointer<SocketRegistration> > retired;
+
+        Pointer<TcpSocketPoller> poller;
+        Pointer<Thread> thread;
+        SocketRegistration* current;
+        bool shutdown;
+
+    public:
+
+        EventLoopThread(const std::string& name, int capacity) :
+            Runnable(), name(name), capacity(capacity), mutex(), registrations(), pending(), retired(),
+            poller(), thread(), current(NULL), shutdown(false) {
+        }
+
+        virtual ~EventLoopThread() {}
+
+        bool isStarted() const {
+            return thread != NULL;
+        }
+
+        int size() const {
+            int result = 0;
+            synchronized(&mutex) {
+                result = registrations.size();
+            }
+            return result;
+        }
+
+        bool isLoopThread() const {
+            return thread.get() == Thread::currentThread();
+        }
+
+        void add(TcpSocket* socket, TcpEventLoop::Handler* handler) {
+
+            Pointer<SocketRegistration> registration(new SocketRegistration(socket, handler));
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    throw IllegalStateException(__FILE__, __LINE__, "TcpEventLoop has been shutdown.");
+                }
+
+                if (thread == NULL) {
+                    poller.reset(new TcpSocketPoller(capacity));
+                    thread.reset(new Thread(this, name));
+                    thread->start();
+                }
+
+                registrations.put(socket, registration);
+                pending.add(registration);
+
+                if (isLoopThread()) {
+                    applyPending();
+                } else {
+                    poller->wakeup();
+                    while (!registration->added && !registration->failed && !shutdown) {
+                        mutex.wait();
+                    }
+                }
+
+                if (registration->failed) {
+                    throw registration->error;
+                }
+
+                if (!registration->added) {
+                    throw IllegalStateException(__FILE__, __LINE__, "TcpEventLoop has been shutdown.");
+                }
+            }
+        }
+
+        bool remove(TcpSocket* socket) {
+
+            synchronized(&mutex) {
+
+                if (!registrations.containsKey(socket)) {
+                    return false;
+                }
+
+                Pointer<SocketRegistration> registration = registrations.get(socket);
+                if (registration->removed) {
+                    return false;
+                }
+
+                registration->removed = true;
+
+                if (isLoopThread()) {
+                    detach(registration);
+                } else {
+                    pending.add(registration);
+                    poller->wakeup();
+                    while (!registration->detached && !shutdown) {
+                        mutex.wait();
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void stop() {
+
+            synchronized(&mutex) {
+
+                if (shutdown) {
+                    return;
+                }
+
+                shutdown = true;
+
+                if (poller != NULL) {
+                    poller->wakeup();
+                }
+
+                mutex.notifyAll();
+            }
+
+            if (thread != NULL && !isLoopThread()) {
+                thread->join();
+            }
+
+            synchronized(&mutex) {
+                Pointer< Iterator< Pointer<SocketRegistration> > > iter(registrations.values().iterator());
+                while (iter->hasNext()) {
+                    Pointer<SocketRegistration> registration = iter->next();
+                    registration->removed = true;
+                    registration->detached = true;
+                }
+
+                registrations.clear();
+                pending.clear();
+                retired.clear();
+                mutex.notifyAll();
+            }
+        }
+
+        virtual void run() {
+
+            std::vector<void*> ready;
+
+            while (true) {
+
+                bool stopping = false;
+
+                synchronized(&mutex) {
+                    retired.clear();
+                    applyPending();
+                    stopping = shutdown;
+                }
+
+                if (stopping) {
+                    break;
+                }
+
+                try {
+                    poller->poll(poller->isWakeable() ? -1 : POLL_INTERVAL, ready);
+                } catch (Exception&) {
+                    // Nothing useful can be done, back off so a persistent failure
+                    // doesn't spin.
+                    ready.clear();
+                    try {
+                        Thread::sleep(POLL_INTERVAL);
+                    } catch (Exception&) {
+                    }
+                }
+
+                std::vector<void*>::const_iterator iter = ready.begin();
+                for (; iter != ready.end(); ++iter) {
+                    handle((SocketRegistration*) *iter);
+                }
+            }
+        }
+
+    private:
+
+        void handle(SocketRegistration* registration) {
+
+            bool skip = false;
+
+            synchronized(&mutex) {
+                skip = registration->removed || shutdown;
+                if (!skip) {
+                    current = registration;
+                }
+            }
+
+            if (skip) {
+                return;
+            }
+
+            bool keep = false;
+
+            try {
+                keep = registration->handler->onReadable();
+            } catch (...) {
+            }
+
+            synchronized(&mutex) {
+                current = NULL;
+
+                if (!keep && !registration->removed) {
+                    registration->removed = true;
+                    detach(registrations.get(registration->socket));
+                }
+
+                mutex.notifyAll();
+            }
+        }
+
+        // Called on the loop thread with the mutex held.
+        void applyPending() {
+
+            Pointer< Iterator< Pointer<SocketRegistration> > > iter(pending.iterator());
+            while (iter->hasNext()) {
+                Pointer<SocketRegistration> registration = iter->next();
+
+                if (registration->removed) {
+                    detach(registration);
+                } else if (!registration->added) {
+                    try {
+                        poller->add(registration->socket, registration.get());
+                        registration->added = true;
+                    } catch (Exception& ex) {
+                        registration->error = IOException(ex);
+                        registration->error.setMark(__FILE__, __LINE__);
+                        registration->failed = true;
+                        registration->removed = true;
+                        detach(registration);
+                    }
+                }
+            }
+
+            pending.clear();
+            mutex.notifyAll();
+        }
+
+        // Called on the loop thread with the mutex held.
+        void detach(const Pointer<SocketRegistration>& registration) {
+
+            if (registration->detached) {
+                return;
+            }
+
+            if (registration->added) {
+                poller->remove(registration->socket);
+            }
+
+            registrations.remove(registration->socket);
+            retired.push_back(registration);
+            registration->detached = true;
+            mutex.notifyAll();
+        }
+    };
+
+    class TcpEventLoopImpl {
+    private:
+
+        TcpEventLoopImpl(const TcpEventLoopImpl&);
+        TcpEventLoopImpl& operator= (const TcpEventLoopImpl&);
+
+    public:
+
+        std::vector< Pointer<EventLoopThread> > loops;
+        int socketsPerLoop;
+
+        mutable Mutex mutex;
+        bool shutdown;
+
+    public:
+
+        TcpEventLoopImpl(int loopThreads, int socketsPerLoop) :
+            loops(), socketsPerLoop(socketsPerLoop), mutex(), shutdown(false) {
+
+            for (int i = 0; i < loopThreads; ++i) {
+                std::string name = "ActiveMQ TcpEventLoop #" + Integer::toString(i + 1);
+                loops.push_back(Pointer<EventLoopThread>(new EventLoopThread(name, socketsPerLoop)));
+            }
+        }
+
+        // Picks the loop watching the fewest sockets, starting unused loops before sharing.
+        Pointer<EventLoopThread> select() const {
+
+            Pointer<EventLoopThread> result;
+            int fewest = socketsPerLoop;
+
+            std::vector< Pointer<EventLoopThread> >::const_iterator iter = loops.begin();
+            for (; iter != loops.end(); ++iter) {
+                int size = (*iter)->size();
+                if (size < fewest) {
+                    fewest = size;
+                    result = *iter;
+                }
+            }
+
+            return result;
+        }
+
+        Pointer<EventLoopThread> find(TcpSocket* socket) const {
+
+            std::vector< Pointer<EventLoopThread> >::const_iterator iter = loops.begin();
+            for (; iter != loops.end(); ++iter) {
+                bool found = false;
+                synchronized(&(*iter)->mutex) {
+                    found = (*iter)->registrations.containsKey(socket);
+                }
+
+                if (found) {
+                    return *iter;
+                }
+            }
+
+            return Pointer<EventLoopThread>();
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoop::Handler::~Handler() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoop::TcpEventLoop(int loopThreads, int socketsPerLoop) : impl(NULL) {
+
+    if (loopThreads <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Loop thread count must be positive.");
+    }
+
+    if (socketsPerLoop <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Sockets per loop must be positive.");
+    }
+
+    this->impl = new TcpEventLoopImpl(loopThreads, socketsPerLoop);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoop::~TcpEventLoop() {
+    try {
+        shutdown();
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoop::registerSocket(TcpSocket* socket, Handler* handler) {
+
+    if (socket == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "TcpSocket cannot be NULL.");
+    }
+
+    if (handler == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Handler cannot be NULL.");
+    }
+
+    Pointer<EventLoopThread> loop;
+
+    synchronized(&this->impl->mutex) {
+
+        if (this->impl->shutdown) {
+            throw IllegalStateException(__FILE__, __LINE__, "TcpEventLoop has been shutdown.");
+        }
+
+        if (this->impl->find(socket) != NULL) {
+            throw IllegalStateException(__FILE__, __LINE__, "TcpSocket is already registered.");
+        }
+
+        loop = this->impl->select();
+        if (loop == NULL) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpEventLoop is full, each of its %d threads already watches %d sockets.",
+                (int) this->impl->loops.size(), this->impl->socketsPerLoop);
+        }
+    }
+
+    // Not done under the lock since a handler may register a socket from the loop
+    // thread that this waits on.
+    loop->add(socket, handler);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpEventLoop::unregisterSocket(TcpSocket* socket) {
+
+    if (socket == NULL) {
+        return false;
+    }
+
+    Pointer<EventLoopThread> loop = this->impl->find(socket);
+    if (loop == NULL) {
+        return false;
+    }
+
+    return loop->remove(socket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoop::shutdown() {
+
+    synchronized(&this->impl->mutex) {
+        if (this->impl->shutdown) {
+            return;
+        }
+
+        this->impl->shutdown = true;
+    }
+
+    std::vector< Pointer<EventLoopThread> >::const_iterator iter = this->impl->loops.begin();
+    for (; iter != this->impl->loops.end(); ++iter) {
+        (*iter)->stop();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpEventLoop::getSocketCount() const {
+
+    int result = 0;
+
+    std::vector< Pointer<EventLoopThread> >::const_iterator iter = this->impl->loops.begin();
+    for (; iter != this->impl->loops.end(); ++iter) {
+        result += (*iter)->size();
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpEventLoop::getActiveLoopCount() const {
+
+    int result = 0;
+
+    synchronized(&this->impl->mutex) {
+        std::vector< Pointer<EventLoopThread> >::const_iterator iter = this->impl->loops.begin();
+        for (; iter != this->impl->loops.end(); ++iter) {
+            if ((*iter)->isStarted()) {
+                result++;
+            }
+        }
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpEventLoop::getLoopThreads() const {
+    return (int) this->impl->loops.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoop& TcpEventLoop::getInstance() {
+
+    if (instance == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    return *instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoop::initialize() {
+    instance = new TcpEventLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoop::shutdownInstance() {
+    TcpEventLoop* old = instance;
+    instance = NULL;
+    delete old;
+}
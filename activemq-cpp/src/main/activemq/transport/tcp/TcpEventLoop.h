@@ -0,0 +1,179 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_TCPEVENTLOOP_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_TCPEVENTLOOP_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/internal/net/tcp/TcpSocket.h>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace transport {
+namespace tcp {
+
+    class TcpEventLoopImpl;
+
+    /**
+     * Process wide set of threads that watch many non-blocking TcpSockets at once and
+     * call a handler whenever one of them has data to read, so that connections don't
+     * each need a thread blocked in a read.  Every socket is assigned to the loop thread
+     * watching the fewest sockets and stays with it until it is unregistered, its handler
+     * is therefore never called from two threads at once.
+     *
+     * Handlers run on the loop thread and hold up every other socket on it while they
+     * run, so they should only read what is available and pass it on.
+     *
+     * The loop threads are only created once a socket is registered.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API TcpEventLoop {
+    public:
+
+        /**
+         * Callback for a registered socket.
+         */
+        class AMQCPP_API Handler {
+        public:
+
+            virtual ~Handler();
+
+            /**
+             * Called from the loop thread when the socket has data to read, the peer has
+             * closed it or an error occurred.  The handler reads until the socket has
+             * nothing more to return.
+             *
+             * @return true to keep watching the socket, false to have it unregistered.
+             */
+            virtual bool onReadable() = 0;
+
+        };
+
+    public:
+
+        /**
+         * Default number of threads that sockets are spread over.
+         */
+        static const int DEFAULT_LOOP_THREADS;
+
+        /**
+         * Default maximum number of sockets each loop thread watches.
+         */
+        static const int DEFAULT_SOCKETS_PER_LOOP;
+
+    private:
+
+        TcpEventLoopImpl* impl;
+
+    private:
+
+        TcpEventLoop(const TcpEventLoop&);
+        TcpEventLoop& operator= (const TcpEventLoop&);
+
+    public:
+
+        /**
+         * Creates a new TcpEventLoop, its threads are started as sockets are registered.
+         *
+         * @param loopThreads
+         *      The number of threads that sockets are spread over.
+         * @param socketsPerLoop
+         *      The maximum number of sockets each thread watches.
+         *
+         * @throws IllegalArgumentException if either value is not positive.
+         */
+        TcpEventLoop(int loopThreads = DEFAULT_LOOP_THREADS,
+                     int socketsPerLoop = DEFAULT_SOCKETS_PER_LOOP);
+
+        virtual ~TcpEventLoop();
+
+        /**
+         * Starts watching the socket, once this method returns the handler will be called
+         * whenever the socket becomes readable.
+         *
+         * @param socket
+         *      The connected, non-blocking socket to watch.  It must be unregistered before
+         *      it is destroyed.
+         * @param handler
+         *      The handler to call, it must remain valid until the socket is unregistered.
+         *
+         * @throws NullPointerException if either argument is NULL.
+         * @throws IllegalStateException if the socket is already registered or the event
+         *         loop has been shutdown.
+         * @throws IOException if every loop thread is full or the socket can't be watched.
+         */
+        void registerSocket(decaf::internal::net::tcp::TcpSocket* socket, Handler* handler);
+
+        /**
+         * Stops watching the socket, once this method returns its handler is not running
+         * and will not be called again, unless the caller is that handler itself.
+         *
+         * @param socket
+         *      The socket to remove.
+         *
+         * @return true if the socket was registered.
+         */
+        bool unregisterSocket(decaf::internal::net::tcp::TcpSocket* socket);
+
+        /**
+         * Stops the loop threads and drops all registered sockets.
+         */
+        void shutdown();
+
+        /**
+         * @return the number of sockets currently registered.
+         */
+        int getSocketCount() const;
+
+        /**
+         * @return the number of loop threads that have been started.
+         */
+        int getActiveLoopCount() const;
+
+        /**
+         * @return the maximum number of threads that sockets are spread over.
+         */
+        int getLoopThreads() const;
+
+    public:
+
+        /**
+         * Returns the event loop shared by all event driven TCP transports in the process,
+         * it is created by the library initialization and destroyed at library shutdown.
+         *
+         * @return the shared TcpEventLoop instance.
+         *
+         * @throws IllegalStateException if the library has not been initialized.
+         */
+        static TcpEventLoop& getInstance();
+
+    private:
+
+        static void initialize();
+        static void shutdownInstance();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_TCPEVENTLOOP_H_ */
@@ -19,13 +19,22 @@
 
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/TransportFactory.h>
+#include <activemq/transport/tcp/TcpEventLoop.h>
+#include <activemq/wireformat/WireFormat.h>
 
+#include <decaf/internal/net/tcp/TcpSocket.h>
+#include <decaf/io/EOFException.h>
+#include <decaf/lang/Math.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/net/SocketFactory.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/zip/DeflaterOutputStream.h>
+#include <decaf/util/zip/InflaterInputStream.h>
 
 #include <memory>
+#include <vector>
+#include <string.h>
 
 using namespace std;
 using namespace activemq;
@@ -33,11 +42,14 @@ using namespace activemq::io;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
 using namespace activemq::exceptions;
+using namespace activemq::wireformat;
 using namespace decaf;
+using namespace decaf::internal::net::tcp;
 using namespace decaf::net;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::util::concurrent::atomic;
+using namespace decaf::util::zip;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
@@ -46,6 +58,134 @@ namespace activemq {
 namespace transport {
 namespace tcp {
 
+    /**
+     * Reads whatever the non-blocking socket holds each time the event loop reports it
+     * readable and passes every complete frame to the IOTransport.
+     */
+    class TcpTransportReader : public TcpEventLoop::Handler {
+    private:
+
+        TcpTransportReader(const TcpTransportReader&);
+        TcpTransportReader& operator= (const TcpTransportReader&);
+
+    private:
+
+        // Bytes taken from the socket per event before the other sockets get a turn.
+        static const int MAX_READ_PER_EVENT = 256 * 1024;
+
+        // A buffer that grew beyond this for a large frame is released once drained.
+        static const std::size_t MAX_RETAINED_SIZE = 1024 * 1024;
+
+        TcpSocket* socket;
+        IOTransport* transport;
+        Pointer<WireFormat> wireFormat;
+
+        std::vector<unsigned char> buffer;
+        std::size_t initialSize;
+
+        // The received bytes that haven't been dispatched are buffer[start, end).
+        int start;
+        int end;
+
+        // Length of the incomplete frame at start, if known.
+        int needed;
+
+    public:
+
+        TcpTransportReader(TcpSocket* socket, IOTransport* transport, int bufferSize) :
+            TcpEventLoop::Handler(), socket(socket), transport(transport), wireFormat(transport->getWireFormat()),
+            buffer(bufferSize > 0 ? bufferSize : 8192), initialSize(buffer.size()), start(0), end(0), needed(-1) {
+        }
+
+        virtual ~TcpTransportReader() {}
+
+        virtual bool onReadable() {
+
+            try {
+
+                int total = 0;
+                while (total < MAX_READ_PER_EVENT) {
+
+                    makeRoom();
+
+                    int count = socket->read(&buffer[0], (int) buffer.size(), end, (int) buffer.size() - end);
+                    if (count == 0) {
+                        break;
+                    } else if (count < 0) {
+                        throw EOFException(__FILE__, __LINE__, "TcpTransport - connection closed by the peer");
+                    }
+
+                    end += count;
+                    total += count;
+
+                    if (!dispatchFrames()) {
+                        return false;
+                    }
+                }
+
+                return true;
+
+            } catch (decaf::lang::Exception& ex) {
+                ex.setMark(__FILE__, __LINE__);
+                transport->dispatchReadFailure(ex);
+            } catch (...) {
+                transport->dispatchReadFailure(
+                    ActiveMQException(__FILE__, __LINE__, "TcpTransportReader - caught unknown exception"));
+            }
+
+            return false;
+        }
+
+    private:
+
+        bool dispatchFrames() {
+
+            while (start < end) {
+
+                int length = wireFormat->getFrameLength(&buffer[start], end - start);
+                if (length < 0 || length > end - start) {
+                    needed = length;
+                    break;
+                }
+
+                if (!transport->dispatchFrame(&buffer[start], length)) {
+                    return false;
+                }
+
+                start += length;
+                needed = -1;
+            }
+
+            if (start == end) {
+                start = 0;
+                end = 0;
+
+                if (buffer.size() > MAX_RETAINED_SIZE) {
+                    std::vector<unsigned char>(initialSize).swap(buffer);
+                }
+            }
+
+            return true;
+        }
+
+        void makeRoom() {
+
+            if (end < (int) buffer.size()) {
+                return;
+            }
+
+            if (start > 0) {
+                ::memmove(&buffer[0], &buffer[start], end - start);
+                end -= start;
+                start = 0;
+            }
+
+            if (end == (int) buffer.size()) {
+                buffer.resize(Math::max((int) buffer.size() * 2, needed));
+            }
+        }
+    };
+
     class TcpTransportImpl {
     private:
 
@@ -60,7 +200,7 @@ namespace tcp {
         std::auto_ptr<decaf::io::DataInputStream> dataInputStream;
         std::auto_ptr<decaf::io::DataOutputStream> dataOutputStream;
 
-        const decaf::net::URI& location;
+        decaf::net::URI location;
 
         int outputBufferSize;
         int inputBufferSize;
@@ -72,6 +212,17 @@ namespace tcp {
         int soReceiveBufferSize;
         int soSendBufferSize;
         bool tcpNoDelay;
+        int soBusyPoll;
+        bool tcpQuickAck;
+        int tcpNotSentLowWater;
+        int soMaxPacingRate;
+        int tcpUserTimeout;
+
+        bool eventLoop;
+        TcpSocket* tcpSocket;
+        bool streamCompression;
+        int streamCompressionLevel;
+        std::auto_ptr<TcpTransportReader> reader;
 
         TcpTransportImpl(const decaf::net::URI& location) :
             connectTimeout(0),
@@ -86,7 +237,17 @@ namespace tcp {
             soKeepAlive(false),
             soReceiveBufferSize(-1),
             soSendBufferSize(-1),
-            tcpNoDelay(true) {
+            tcpNoDelay(true),
+            soBusyPoll(-1),
+            tcpQuickAck(false),
+            tcpNotSentLowWater(-1),
+            soMaxPacingRate(-1),
+            tcpUserTimeout(-1),
+            eventLoop(false),
+            tcpSocket(NULL),
+            streamCompression(false),
+            streamCompressionLevel(Deflater::DEFAULT_COMPRESSION),
+            reader() {
         }
     };
 }}}
@@ -119,9 +280,25 @@ void TcpTransport::beforeNextIsStarted() {
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::afterNextIsStarted() {
+    try {
+        if (impl->reader.get() != NULL) {
+            TcpEventLoop::getInstance().registerSocket(impl->tcpSocket, impl->reader.get());
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::afterNextIsStopped() {
     try {
+        if (impl->reader.get() != NULL) {
+            TcpEventLoop::getInstance().unregisterSocket(impl->tcpSocket);
+        }
+
         // The IOTransport is now stopped, so we can safely closed the socket
         // and no asynchronous exceptions should be triggered.
         if (impl->socket.get() != NULL) {
@@ -136,6 +313,10 @@ void TcpTransport::afterNextIsStopped() {
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::doClose() {
     try {
+        if (impl->reader.get() != NULL) {
+            TcpEventLoop::getInstance().unregisterSocket(impl->tcpSocket);
+        }
+
         if (impl->socket.get() != NULL) {
             impl->socket->close();
         }
@@ -150,24 +331,20 @@ void TcpTransport::connect() {
 
     try {
 
-        impl->socket.reset(this->createSocket());
+        // The event loop needs the plain socket so it is created here rather than
+        // by a SocketFactory.
+        if (impl->eventLoop && isEventLoopSupported()) {
+            impl->tcpSocket = this->createEventLoopSocket();
+            impl->socket.reset(new Socket(impl->tcpSocket));
+        } else {
+            impl->socket.reset(this->createSocket());
+        }
 
         // Set all Socket Options from the URI options.
         this->configureSocket(impl->socket.get());
 
-        URI uri = this->impl->location;
-
-        // Ensure something is actually passed in for the URI
-        if (uri.getAuthority() == "") {
-            throw SocketException(__FILE__, __LINE__,
-                "Connection URI was not provided or is invalid: %s", uri.toString().c_str());
-        }
-
         // Connect the socket.
-        string host = uri.getHost();
-        int port = uri.getPort();
-
-        impl->socket->connect(host, port, impl->connectTimeout);
+        this->connectSocket(impl->socket.get());
 
         // Cast it to an IO transport so we can wire up the socket
         // input and output streams.
@@ -186,23 +363,34 @@ void TcpTransport::connect() {
         // We don't own these ever, socket object owns.
         InputStream* socketIStream = impl->socket->getInputStream();
         OutputStream* sokcetOStream = impl->socket->getOutputStream();
+        bool ownSocketStreams = false;
+
+        // Compression goes right over the socket so that tracing still shows the frames.
+        // The deflate stream sync flushes each time the buffered stream above it is
+        // flushed, the peer can then inflate everything written so far.
+        if (this->impl->streamCompression) {
+            Deflater* deflater = new Deflater(this->impl->streamCompressionLevel);
+            sokcetOStream = new DeflaterOutputStream(sokcetOStream, deflater, outputBufferSize, false, true, true);
+            socketIStream = new InflaterInputStream(socketIStream, new Inflater(), inputBufferSize, false, true);
+            ownSocketStreams = true;
+        }
 
         Pointer<InputStream> inputStream;
         Pointer<OutputStream> outputStream;
 
         // If tcp tracing was enabled, wrap the input / output streams with logging streams
         if (this->impl->trace) {
-            // Wrap with logging stream, we don't own the wrapped streams
-            inputStream.reset(new LoggingInputStream(socketIStream));
-            outputStream.reset(new LoggingOutputStream(sokcetOStream));
+            // Wrap with logging stream, we only own the wrapped streams if they compress
+            inputStream.reset(new LoggingInputStream(socketIStream, ownSocketStreams));
+            outputStream.reset(new LoggingOutputStream(sokcetOStream, ownSocketStreams));
 
             // Now wrap with the Buffered streams, we own the source streams
             inputStream.reset(new BufferedInputStream(inputStream.release(), inputBufferSize, true));
             outputStream.reset(new BufferedOutputStream(outputStream.release(), outputBufferSize, true));
         } else {
-            // Wrap with the Buffered streams, we don't own the source streams
-            inputStream.reset(new BufferedInputStream(socketIStream, inputBufferSize));
-            outputStream.reset(new BufferedOutputStream(sokcetOStream, outputBufferSize));
+            // Wrap with the Buffered streams, we only own the source streams if they compress
+            inputStream.reset(new BufferedInputStream(socketIStream, inputBufferSize, ownSocketStreams));
+            outputStream.reset(new BufferedOutputStream(sokcetOStream, outputBufferSize, ownSocketStreams));
         }
 
         // Now wrap the Buffered Streams with DataInput based streams.  We own
@@ -214,6 +402,16 @@ void TcpTransport::connect() {
         // Give the IOTransport the streams.
         ioTransport->setInputStream(impl->dataInputStream.get());
         ioTransport->setOutputStream(impl->dataOutputStream.get());
+
+        // Reads are left to the event loop once started, the streams are still used
+        // for writes.  Commands that aren't framed or are compressed can only be read
+        // from the stream.
+        Pointer<WireFormat> wireFormat = ioTransport->getWireFormat();
+        if (impl->tcpSocket != NULL && wireFormat != NULL && wireFormat->isFramed() && !impl->streamCompression) {
+            impl->tcpSocket->setNonBlocking(true);
+            ioTransport->setEventDriven(true);
+            impl->reader.reset(new TcpTransportReader(impl->tcpSocket, ioTransport, inputBufferSize));
+        }
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -232,6 +430,31 @@ Socket* TcpTransport::createSocket() {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+TcpSocket* TcpTransport::createEventLoopSocket() {
+    return new TcpSocket();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::connectSocket(Socket* socket) {
+
+    try {
+
+        URI uri = this->impl->location;
+
+        // Ensure something is actually passed in for the URI
+        if (uri.getAuthority() == "") {
+            throw SocketException(__FILE__, __LINE__,
+                "Connection URI was not provided or is invalid: %s", uri.toString().c_str());
+        }
+
+        socket->connect(uri.getHost(), uri.getPort(), impl->connectTimeout);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpTransport::configureSocket(Socket* socket) {
 
@@ -256,6 +479,27 @@ void TcpTransport::configureSocket(Socket* socket) {
         if (soSendBufferSize > 0) {
             socket->setSendBufferSize(soSendBufferSize);
         }
+
+        // The latency options are only set when asked for, not every platform has them.
+        if (this->impl->soBusyPoll > 0) {
+            socket->setBusyPoll(this->impl->soBusyPoll);
+        }
+
+        if (this->impl->tcpQuickAck) {
+            socket->setTcpQuickAck(true);
+        }
+
+        if (this->impl->tcpNotSentLowWater > 0) {
+            socket->setTcpNotSentLowWater(this->impl->tcpNotSentLowWater);
+        }
+
+        if (this->impl->soMaxPacingRate > 0) {
+            socket->setMaxPacingRate(this->impl->soMaxPacingRate);
+        }
+
+        if (this->impl->tcpUserTimeout > 0) {
+            socket->setTcpUserTimeout(this->impl->tcpUserTimeout);
+        }
     }
     DECAF_CATCH_RETHROW(NullPointerException)
     DECAF_CATCH_RETHROW(IllegalArgumentException)
@@ -363,6 +607,86 @@ bool TcpTransport::isTcpNoDelay() const {
     return this->impl->tcpNoDelay;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setBusyPoll(int soBusyPoll) {
+    this->impl->soBusyPoll = soBusyPoll;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getBusyPoll() const {
+    return this->impl->soBusyPoll;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setTcpQuickAck(bool tcpQuickAck) {
+    this->impl->tcpQuickAck = tcpQuickAck;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isTcpQuickAck() const {
+    return this->impl->tcpQuickAck;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setTcpNotSentLowWater(int tcpNotSentLowWater) {
+    this->impl->tcpNotSentLowWater = tcpNotSentLowWater;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getTcpNotSentLowWater() const {
+    return this->impl->tcpNotSentLowWater;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setMaxPacingRate(int soMaxPacingRate) {
+    this->impl->soMaxPacingRate = soMaxPacingRate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getMaxPacingRate() const {
+    return this->impl->soMaxPacingRate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setTcpUserTimeout(int tcpUserTimeout) {
+    this->impl->tcpUserTimeout = tcpUserTimeout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getTcpUserTimeout() const {
+    return this->impl->tcpUserTimeout;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setEventLoop(bool eventLoop) {
+    this->impl->eventLoop = eventLoop;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isEventLoop() const {
+    return this->impl->eventLoop;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setStreamCompression(bool streamCompression) {
+    this->impl->streamCompression = streamCompression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpTransport::isStreamCompression() const {
+    return this->impl->streamCompression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransport::setStreamCompressionLevel(int streamCompressionLevel) {
+    this->impl->streamCompressionLevel = streamCompressionLevel;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpTransport::getStreamCompressionLevel() const {
+    return this->impl->streamCompressionLevel;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 decaf::net::URI TcpTransport::getLocation() const {
     return this->impl->location;
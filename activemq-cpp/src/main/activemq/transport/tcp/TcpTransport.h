@@ -32,6 +32,13 @@
 #include <decaf/io/DataOutputStream.h>
 #include <memory>
 
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+    class TcpSocket;
+}}}}
+
 namespace activemq {
 namespace transport {
 namespace tcp {
@@ -44,6 +51,20 @@ namespace tcp {
      * Implements a TCP/IP based transport filter, this transport is meant to
      * wrap an instance of an IOTransport.  The lower level transport should take
      * care of managing stream reads and writes.
+     *
+     * With the eventLoop option set the socket is made non-blocking and registered with
+     * the shared TcpEventLoop instead of being read by a thread of the IOTransport, the
+     * bytes that arrive are gathered into frames and handed to the IOTransport to be
+     * unmarshaled.  This only happens when the WireFormat is framed, otherwise the
+     * option is ignored.
+     *
+     * With the streamCompression option set everything written to the socket, frame
+     * headers and control commands included, goes through one deflate stream that lasts
+     * as long as the connection, so each frame is compressed against all those before it.
+     * The stream is flushed once per flush of the transport's output, which with write
+     * batching is once per batch of frames.  The peer has to be configured the same way
+     * since nothing on the wire announces it, and the socket is always read by a thread
+     * of the IOTransport as the eventLoop reads raw frames.
      */
     class AMQCPP_API TcpTransport: public TransportFilter {
     private:
@@ -97,6 +118,30 @@ namespace tcp {
         void setTcpNoDelay(bool tcpNoDelay);
         bool isTcpNoDelay() const;
 
+        void setBusyPoll(int soBusyPoll);
+        int getBusyPoll() const;
+
+        void setTcpQuickAck(bool tcpQuickAck);
+        bool isTcpQuickAck() const;
+
+        void setTcpNotSentLowWater(int tcpNotSentLowWater);
+        int getTcpNotSentLowWater() const;
+
+        void setMaxPacingRate(int soMaxPacingRate);
+        int getMaxPacingRate() const;
+
+        void setTcpUserTimeout(int tcpUserTimeout);
+        int getTcpUserTimeout() const;
+
+        void setEventLoop(bool eventLoop);
+        bool isEventLoop() const;
+
+        void setStreamCompression(bool streamCompression);
+        bool isStreamCompression() const;
+
+        void setStreamCompressionLevel(int streamCompressionLevel);
+        int getStreamCompressionLevel() const;
+
     public: // Transport Methods
 
         virtual bool isFaultTolerant() const {
@@ -111,6 +156,8 @@ namespace tcp {
 
         virtual void beforeNextIsStarted();
 
+        virtual void afterNextIsStarted();
+
         virtual void afterNextIsStopped();
 
         virtual void doClose();
@@ -131,6 +178,26 @@ namespace tcp {
          */
         virtual decaf::net::Socket* createSocket();
 
+        /**
+         * Create the unconnected plain socket that the shared TcpEventLoop reads when the
+         * eventLoop option is set, the transport wraps it in the Socket it connects.
+         *
+         * @return a newly created unconnected TcpSocket instance.
+         */
+        virtual decaf::internal::net::tcp::TcpSocket* createEventLoopSocket();
+
+        /**
+         * Connects the configured Socket to the location this transport was created for,
+         * the host and port of the URI.  Subclasses whose locations name their peer some
+         * other way override this.
+         *
+         * @param socket
+         *      The configured but unconnected Socket.
+         *
+         * @throw IOException if the location is invalid or the Socket fails to connect.
+         */
+        virtual void connectSocket(decaf::net::Socket* socket);
+
         /**
          * Using options from configuration URI, configure the socket options before the
          * Socket instance is connected to the Server.  Subclasses can override this option
@@ -146,6 +213,17 @@ namespace tcp {
          */
         virtual void configureSocket(decaf::net::Socket* socket);
 
+        /**
+         * Indicates if the connection can be read by the shared TcpEventLoop, which needs
+         * the plain TCP socket.  Subclasses that layer a protocol over the socket's own
+         * streams return false so that the eventLoop option is ignored for them.
+         *
+         * @return true if the eventLoop option is supported.
+         */
+        virtual bool isEventLoopSupported() const {
+            return true;
+        }
+
     };
 
 }}}
@@ -19,26 +19,35 @@
 
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/tcp/TcpTransport.h>
+#include <activemq/transport/chunking/ChunkingTransport.h>
 #include <activemq/transport/correlator/ResponseCorrelator.h>
 #include <activemq/transport/logging/LoggingTransport.h>
 #include <activemq/transport/inactivity/InactivityMonitor.h>
+#include <activemq/transport/lanes/PriorityLaneTransport.h>
 #include <activemq/util/URISupport.h>
 #include <activemq/wireformat/WireFormat.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
 #include <decaf/util/Properties.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Boolean.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
 
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
+using namespace activemq::transport::chunking;
 using namespace activemq::transport::correlator;
 using namespace activemq::transport::logging;
 using namespace activemq::transport::inactivity;
+using namespace activemq::transport::lanes;
 using namespace activemq::exceptions;
 using namespace decaf;
 using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
 using namespace decaf::util;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,7 +96,7 @@ Pointer<Transport> TcpTransportFactory::doCreateComposite(const decaf::net::URI&
 
     try {
 
-        Pointer<Transport> transport(new IOTransport(wireFormat));
+        Pointer<Transport> transport(createIOTransport(wireFormat, properties));
 
         transport.reset(new TcpTransport(transport, location));
 
@@ -95,16 +104,38 @@ Pointer<Transport> TcpTransportFactory::doCreateComposite(const decaf::net::URI&
         // are set in the properties object.
         doConfigureTransport(transport, properties);
 
+        // The nio scheme reads through the event loop unless the URI asks otherwise.
+        if (location.getScheme() == "nio" && !properties.hasProperty("transport.eventLoop")) {
+            transport.dynamicCast<TcpTransport>()->setEventLoop(true);
+        }
+
+        // Below the inactivity monitor so its keep alives also get to skip the bulk lane.
+        if (properties.getProperty("transport.priorityLanes", "false") == "true") {
+            Pointer<PriorityLaneTransport> lanes(new PriorityLaneTransport(transport));
+            lanes->setMaxPendingSends(
+                Integer::parseInt(properties.getProperty("transport.maxPendingSends", "64")));
+            transport = lanes;
+        }
+
         if (properties.getProperty("transport.useInactivityMonitor", "true") == "true") {
             transport.reset(new InactivityMonitor(transport, properties, wireFormat));
         }
 
-        // If command tracing was enabled, wrap the transport with a logging transport.
-        // We support the old CMS value, the ActiveMQ trace value and the NMS useLogging
-        // value in order to be more friendly.
-        if (properties.getProperty("transport.commandTracingEnabled", "false") == "true" ||
-            properties.getProperty("transport.useLogging", "false") == "true" ||
-            properties.getProperty("transport.trace", "false") == "true") {
+        // Above the inactivity monitor so each chunk read counts as activity.
+        int chunkSize = Integer::parseInt(properties.getProperty("transport.chunkSize", "0"));
+        if (chunkSize > 0 && dynamic_cast<OpenWireFormat*>(wireFormat.get()) != NULL) {
+            transport.reset(new ChunkingTransport(transport, wireFormat.dynamicCast<OpenWireFormat>(), chunkSize));
+        }
+
+        // If frame capture or command tracing was enabled, wrap the transport with a logging
+        // transport.  We support the old CMS value, the ActiveMQ trace value and the NMS
+        // useLogging value in order to be more friendly.
+        Pointer<FrameCaptureFile> capture = LoggingTransport::createFrameCapture(properties);
+        if (capture != NULL) {
+            transport.reset(new LoggingTransport(transport, capture));
+        } else if (properties.getProperty("transport.commandTracingEnabled", "false") == "true" ||
+                   properties.getProperty("transport.useLogging", "false") == "true" ||
+                   properties.getProperty("transport.trace", "false") == "true") {
 
             transport.reset(new LoggingTransport(transport));
         }
@@ -137,6 +168,48 @@ void TcpTransportFactory::doConfigureTransport(Pointer<Transport> transport,
         tcp->setSendBufferSize(Integer::parseInt(properties.getProperty("soSendBufferSize", "-1")));
         tcp->setTcpNoDelay(Boolean::parseBoolean(properties.getProperty("tcpNoDelay", "true")));
         tcp->setConnectTimeout(Integer::parseInt(properties.getProperty("soConnectTimeout", "0")));
+        tcp->setBusyPoll(Integer::parseInt(properties.getProperty("soBusyPoll", "-1")));
+        tcp->setTcpQuickAck(Boolean::parseBoolean(properties.getProperty("tcpQuickAck", "false")));
+        tcp->setTcpNotSentLowWater(Integer::parseInt(properties.getProperty("tcpNotSentLowWater", "-1")));
+        tcp->setMaxPacingRate(Integer::parseInt(properties.getProperty("soMaxPacingRate", "-1")));
+        tcp->setTcpUserTimeout(Integer::parseInt(properties.getProperty("tcpUserTimeout", "-1")));
+        tcp->setEventLoop(Boolean::parseBoolean(properties.getProperty("transport.eventLoop", "false")));
+        tcp->setStreamCompression(Boolean::parseBoolean(properties.getProperty("transport.streamCompression", "false")));
+        tcp->setStreamCompressionLevel(Integer::parseInt(properties.getProperty("transport.streamCompressionLevel", "-1")));
+    }
+    AMQ_CATCH_RETHROW(ActiveMQException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
+    AMQ_CATCHALL_THROW(ActiveMQException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Transport> TcpTransportFactory::createIOTransport(const Pointer<wireformat::WireFormat> wireFormat,
+                                                          const decaf::util::Properties& properties) {
+
+    try {
+
+        Pointer<IOTransport> transport(new IOTransport(wireFormat));
+
+        transport->setWriteBatching(Boolean::parseBoolean(properties.getProperty("transport.writeBatching", "false")));
+        transport->setMaxBatchBytes(Integer::parseInt(properties.getProperty("transport.maxBatchBytes", "65536")));
+        transport->setMaxBatchLinger(Long::parseLong(properties.getProperty("transport.maxBatchLinger", "0")));
+        transport->setMaxWriteQueueSize(Integer::parseInt(properties.getProperty("transport.maxWriteQueueSize", "0")));
+
+        std::string policy = properties.getProperty("transport.writeQueuePolicy", "block");
+        if (policy == "block") {
+            transport->setWriteQueuePolicy(IOTransport::BLOCK);
+        } else if (policy == "fail") {
+            transport->setWriteQueuePolicy(IOTransport::FAIL);
+        } else if (policy == "dropOldest") {
+            transport->setWriteQueuePolicy(IOTransport::DROP_OLDEST);
+        } else {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "Unknown transport.writeQueuePolicy: %s", policy.c_str());
+        }
+        transport->setPipelinedReads(Boolean::parseBoolean(properties.getProperty("transport.pipelinedReads", "false")));
+        transport->setMaxPendingFrames(Integer::parseInt(properties.getProperty("transport.maxPendingFrames", "64")));
+
+        return transport;
     }
     AMQ_CATCH_RETHROW(ActiveMQException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, ActiveMQException)
@@ -47,6 +47,20 @@ namespace tcp {
 
         virtual void doConfigureTransport(Pointer<Transport>, const decaf::util::Properties& properties);
 
+        /**
+         * Creates the IOTransport that sits at the bottom of the Transport chain and
+         * applies the IO related options found in the properties object.
+         *
+         * @param wireFormat
+         *      The WireFormat the IOTransport uses to marshal and unmarshal commands.
+         * @param properties
+         *      The properties that were parsed from the URI query string.
+         *
+         * @return a new IOTransport instance.
+         */
+        virtual Pointer<Transport> createIOTransport(const Pointer<wireformat::WireFormat> wireFormat,
+                                                     const decaf::util::Properties& properties);
+
     };
 
 }}}
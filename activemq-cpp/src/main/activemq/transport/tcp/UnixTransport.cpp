@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UnixTransport.h"
+
+#include <decaf/internal/net/local/UnixSocket.h>
+#include <decaf/net/SocketException.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::internal::net::local;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+UnixTransport::UnixTransport(const Pointer<Transport> next, const decaf::net::URI& location) :
+    TcpTransport(next, location) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+UnixTransport::~UnixTransport() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Socket* UnixTransport::createSocket() {
+
+    try {
+        return new Socket(new UnixSocket());
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocket* UnixTransport::createEventLoopSocket() {
+    return new UnixSocket();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixTransport::connectSocket(Socket* socket) {
+
+    try {
+
+        URI uri = this->getLocation();
+
+        if (uri.getPath() == "") {
+            throw SocketException(__FILE__, __LINE__,
+                "Connection URI does not name a socket path: %s", uri.toString().c_str());
+        }
+
+        socket->connect(uri.getPath(), 0, this->getConnectTimeout());
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_TCP_UNIXTRANSPORT_H_
+#define _ACTIVEMQ_TRANSPORT_TCP_UNIXTRANSPORT_H_
+
+#include <activemq/util/Config.h>
+
+#include <activemq/transport/tcp/TcpTransport.h>
+
+namespace activemq {
+namespace transport {
+namespace tcp {
+
+    /**
+     * Transport for connecting to a Broker on the same host through a Unix domain socket,
+     * the path of the location URI names the socket, as in unix:///var/run/activemq.sock.
+     * The data skips the TCP stack while the core TcpTransport logic, including the
+     * eventLoop option, is reused.  Options of the TCP protocol, such as tcpNoDelay, have
+     * no effect on these sockets.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API UnixTransport : public TcpTransport {
+    private:
+
+        UnixTransport(const UnixTransport&);
+        UnixTransport& operator=(const UnixTransport&);
+
+    public:
+
+        /**
+         * Creates a new instance of the UnixTransport, the transport will not attempt to
+         * connect to the socket until the connect method is called.
+         *
+         * @param next
+         *      The next transport in the chain
+         * @param location
+         *      The URI whose path names the socket this transport is to connect to.
+         */
+        UnixTransport(const Pointer<Transport> next, const decaf::net::URI& location);
+
+        virtual ~UnixTransport();
+
+    protected:
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::net::Socket* createSocket();
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual decaf::internal::net::tcp::TcpSocket* createEventLoopSocket();
+
+        /**
+         * Connects the Socket to the path of the location URI.
+         *
+         * {@inheritDoc}
+         */
+        virtual void connectSocket(decaf::net::Socket* socket);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_TCP_UNIXTRANSPORT_H_ */
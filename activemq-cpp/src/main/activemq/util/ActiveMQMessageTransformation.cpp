@@ -40,6 +40,8 @@
 #include <activemq/commands/ActiveMQBytesMessage.h>
 #include <activemq/commands/ActiveMQObjectMessage.h>
 #include <activemq/commands/Message.h>
+#include <activemq/util/NativeMessageProvider.h>
+#include <activemq/util/NativeDestinationProvider.h>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
 
@@ -71,6 +73,14 @@ bool ActiveMQMessageTransformation::transformDestination(const cms::Destination*
 
     *amqDestination = dynamic_cast<const ActiveMQDestination*>(destination);
 
+    // A wrapper around one of our own destinations hands it over as is.
+    if (*amqDestination == NULL) {
+        const NativeDestinationProvider* provider = dynamic_cast<const NativeDestinationProvider*>(destination);
+        if (provider != NULL) {
+            *amqDestination = provider->getNativeDestination();
+        }
+    }
+
     if (*amqDestination == NULL) {
 
         if (dynamic_cast<const cms::TemporaryQueue*>(destination) != NULL) {
@@ -106,6 +116,15 @@ bool ActiveMQMessageTransformation::transformMessage(cms::Message* message, Acti
 
     *amqMessage = dynamic_cast<Message*>(message);
 
+    // A wrapper around one of our own messages hands it over, it is treated as if it
+    // had been given to us directly and isn't rebuilt through the CMS API.
+    if (*amqMessage == NULL) {
+        NativeMessageProvider* provider = dynamic_cast<NativeMessageProvider*>(message);
+        if (provider != NULL) {
+            *amqMessage = provider->getNativeMessage();
+        }
+    }
+
     if (*amqMessage != NULL) {
         return false;
     } else {
@@ -51,7 +51,8 @@ namespace util {
          * This method will return true if the passed CMS Destination was cloned and a new Destination
          * object created or false if the input Destination was already an ActiveMQ destination.  The
          * should use the return value as a hint to determine if it needs to delete the amqDestinatio
-         * object or not.
+         * object or not.  A destination implementing NativeDestinationProvider is treated as the
+         * ActiveMQ destination it provides.
          *
          * @param destination
          *      Destination to be converted into ActiveMQ's implementation.
@@ -71,7 +72,8 @@ namespace util {
          * This method will return true if the passed CMS Message was cloned and a new ActiveMQMessage
          * object created or false if the input Message was already an ActiveMQMessage instance.  The
          * caller should use the return value as a hint to determine if it needs to delete the resulting
-         * ActiveMQMessage object or not.
+         * ActiveMQMessage object or not.  A message implementing NativeMessageProvider is treated
+         * as the ActiveMQ message it provides, which saves rebuilding it field by field.
          *
          * @param message
          *      CMS Message to be converted into ActiveMQ's implementation.
@@ -0,0 +1,642 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BlockCompressionCodec.h"
+
+#include <decaf/io/IOException.h>
+#include <decaf/io/InputStream.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Math.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string BlockCompressionCodec::SUFFIX = "+blocks";
+const int BlockCompressionCodec::DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void writeInt(std::vector<unsigned char>& out, std::size_t index, int value) {
+        out[index] = (unsigned char) ((value >> 24) & 0xFF);
+        out[index + 1] = (unsigned char) ((value >> 16) & 0xFF);
+        out[index + 2] = (unsigned char) ((value >> 8) & 0xFF);
+        out[index + 3] = (unsigned char) (value & 0xFF);
+    }
+
+    int readInt(const unsigned char* buffer) {
+        return ((buffer[0] & 0xFF) << 24) | ((buffer[1] & 0xFF) << 16) |
+               ((buffer[2] & 0xFF) << 8) | (buffer[3] & 0xFF);
+    }
+
+    /**
+     * Blocks shared out between the calling thread and the helpers from the pool, each
+     * thread claims the next unprocessed block until there are none left.  The first
+     * failure stops the others from claiming more.
+     */
+    class BlockWork {
+    private:
+
+        BlockWork(const BlockWork&);
+        BlockWork& operator= (const BlockWork&);
+
+    private:
+
+        AtomicInteger next;
+        AtomicBoolean failed;
+
+        Mutex mutex;
+        int helpers;
+        std::string error;
+
+    protected:
+
+        int blocks;
+
+    public:
+
+        BlockWork(int blocks) : next(0), failed(false), mutex(), helpers(0), error(), blocks(blocks) {}
+
+        virtual ~BlockWork() {}
+
+        virtual void process(int block) = 0;
+
+        void work() {
+
+            while (!failed.get()) {
+
+                int block = next.getAndIncrement();
+                if (block >= blocks) {
+                    return;
+                }
+
+                try {
+                    process(block);
+                } catch (decaf::lang::Exception& ex) {
+                    fail(ex.getMessage());
+                } catch (std::exception& ex) {
+                    fail(ex.what());
+                } catch (...) {
+                    fail("Unknown error");
+                }
+            }
+        }
+
+        void helperStarted() {
+            synchronized(&mutex) {
+                helpers++;
+            }
+        }
+
+        void helperDone() {
+            synchronized(&mutex) {
+                helpers--;
+                mutex.notifyAll();
+            }
+        }
+
+        // The helpers refer to this object, so it can't go out of scope until they've all
+        // finished, even if the waiting thread is interrupted.
+        void awaitHelpers() {
+
+            bool interrupted = false;
+
+            synchronized(&mutex) {
+                while (helpers > 0) {
+                    try {
+                        mutex.wait();
+                    } catch (InterruptedException&) {
+                        interrupted = true;
+                    }
+                }
+            }
+
+            if (interrupted) {
+                Thread::currentThread()->interrupt();
+            }
+        }
+
+        bool hasFailed() const {
+            return failed.get();
+        }
+
+        std::string getError() {
+            synchronized(&mutex) {
+                return error;
+            }
+
+            return std::string();
+        }
+
+    private:
+
+        void fail(const std::string& message) {
+            synchronized(&mutex) {
+                if (!failed.get()) {
+                    error = message;
+                    failed.set(true);
+                }
+            }
+        }
+    };
+
+    class BlockHelper : public Runnable {
+    private:
+
+        BlockHelper(const BlockHelper&);
+        BlockHelper& operator= (const BlockHelper&);
+
+    private:
+
+        BlockWork* work;
+
+    public:
+
+        BlockHelper(BlockWork* work) : Runnable(), work(work) {}
+
+        virtual ~BlockHelper() {}
+
+        virtual void run() {
+            work->work();
+            work->helperDone();
+        }
+    };
+
+    void runBlocks(ThreadPoolExecutor* executor, BlockWork& work, int blocks) {
+
+        int helpers = executor == NULL ? 0 : Math::min(blocks - 1, executor->getMaximumPoolSize());
+
+        for (int i = 0; i < helpers; ++i) {
+            work.helperStarted();
+            try {
+                executor->execute(new BlockHelper(&work));
+            } catch (decaf::lang::Exception&) {
+                // The pool has been shut down, the calling thread does the rest.
+                work.helperDone();
+                break;
+            }
+        }
+
+        work.work();
+        work.awaitHelpers();
+    }
+
+    class CompressBlocks : public BlockWork {
+    private:
+
+        CompressBlocks(const CompressBlocks&);
+        CompressBlocks& operator= (const CompressBlocks&);
+
+    public:
+
+        CompressionCodec* codec;
+        int level;
+        int blockSize;
+        long long total;
+
+        const unsigned char* const* buffers;
+        const int* lengths;
+
+        // Offset of each buffer within the data as a whole.
+        std::vector<long long> starts;
+
+        std::vector< std::vector<unsigned char> > compressed;
+
+        CompressBlocks(CompressionCodec* codec, int level, int blockSize, int blocks,
+                       const unsigned char* const* buffers, const int* lengths, int count) :
+            BlockWork(blocks), codec(codec), level(level), blockSize(blockSize), total(0),
+            buffers(buffers), lengths(lengths), starts(), compressed(blocks) {
+
+            starts.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                starts.push_back(total);
+                total += lengths[i] > 0 ? lengths[i] : 0;
+            }
+        }
+
+        virtual void process(int block) {
+
+            long long begin = (long long) block * blockSize;
+            long long end = Math::min(begin + blockSize, total);
+
+            // A block may span several of the buffers, it is passed as the parts of each.
+            std::vector<const unsigned char*> parts;
+            std::vector<int> partLengths;
+
+            int index = (int) (std::upper_bound(starts.begin(), starts.end(), begin) - starts.begin()) - 1;
+            for (; index < (int) starts.size() && starts[index] < end; ++index) {
+
+                long long from = Math::max(begin, starts[index]);
+                long long to = Math::min(end, starts[index] + (lengths[index] > 0 ? lengths[index] : 0));
+                if (to > from) {
+                    parts.push_back(buffers[index] + (from - starts[index]));
+                    partLengths.push_back((int) (to - from));
+                }
+            }
+
+            codec->compress(level, parts.empty() ? NULL : &parts[0],
+                            partLengths.empty() ? NULL : &partLengths[0], (int) parts.size(), compressed[block]);
+        }
+    };
+
+    class DecompressBlocks : public BlockWork {
+    private:
+
+        DecompressBlocks(const DecompressBlocks&);
+        DecompressBlocks& operator= (const DecompressBlocks&);
+
+    public:
+
+        CompressionCodec* codec;
+
+        std::vector<const unsigned char*> sources;
+        std::vector<int> sourceLengths;
+        std::vector<int> sizes;
+        std::vector<std::size_t> targets;
+
+        unsigned char* out;
+
+        DecompressBlocks(CompressionCodec* codec, int blocks) :
+            BlockWork(blocks), codec(codec), sources(), sourceLengths(), sizes(), targets(), out(NULL) {
+        }
+
+        virtual void process(int block) {
+
+            std::vector<unsigned char> decompressed;
+            decompressed.reserve((std::size_t) sizes[block]);
+
+            codec->decompress(sources[block], sourceLengths[block], decompressed, sizes[block]);
+
+            if ((int) decompressed.size() != sizes[block]) {
+                throw DataFormatException(__FILE__, __LINE__,
+                    "Block %d decompressed to %d bytes instead of %d", block, (int) decompressed.size(), sizes[block]);
+            }
+
+            if (!decompressed.empty()) {
+                std::memcpy(out + targets[block], &decompressed[0], decompressed.size());
+            }
+        }
+    };
+
+    /**
+     * Reads block compressed data decompressing a block when the reads reach it, the
+     * buffer of the decompressed block is reused for the next so its size stays that of
+     * the largest block.
+     */
+    class BlockInputStream : public InputStream {
+    private:
+
+        CompressionCodec* codec;
+        const unsigned char* data;
+        int blocks;
+        int nextBlock;
+        long long nextOffset;
+
+        std::vector<unsigned char> window;
+        std::size_t position;
+
+    private:
+
+        BlockInputStream(const BlockInputStream&);
+        BlockInputStream& operator= (const BlockInputStream&);
+
+    public:
+
+        BlockInputStream(CompressionCodec* codec, const unsigned char* data, int blocks) :
+            InputStream(), codec(codec), data(data), blocks(blocks), nextBlock(0),
+            nextOffset(4 + (long long) blocks * 8), window(), position(0) {
+        }
+
+        virtual ~BlockInputStream() {}
+
+        virtual int available() const {
+            return (int) (this->window.size() - this->position);
+        }
+
+    protected:
+
+        virtual int doReadByte() {
+            if (!fill()) {
+                return -1;
+            }
+
+            return this->window[this->position++];
+        }
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+
+            if (length == 0) {
+                return 0;
+            }
+
+            if (buffer == NULL) {
+                throw NullPointerException(__FILE__, __LINE__, "Buffer passed is Null");
+            }
+
+            if (size < 0 || offset < 0 || offset > size || length < 0 || length > size - offset) {
+                throw IndexOutOfBoundsException(__FILE__, __LINE__,
+                    "Invalid bounds, size: %d, offset: %d, length: %d", size, offset, length);
+            }
+
+            if (!fill()) {
+                return -1;
+            }
+
+            int count = Math::min(length, (int) (this->window.size() - this->position));
+            std::memcpy(buffer + offset, &this->window[this->position], (std::size_t) count);
+            this->position += (std::size_t) count;
+
+            return count;
+        }
+
+    private:
+
+        bool fill() {
+
+            while (this->position == this->window.size()) {
+
+                if (this->nextBlock == this->blocks) {
+                    return false;
+                }
+
+                int size = readInt(this->data + 4 + this->nextBlock * 8);
+                int compressed = readInt(this->data + 8 + this->nextBlock * 8);
+
+                this->window.clear();
+                this->position = 0;
+
+                try {
+                    this->codec->decompress(this->data + this->nextOffset, compressed, this->window, size);
+                } catch (Exception& ex) {
+                    throw IOException(__FILE__, __LINE__,
+                        "Failed to decompress block %d: %s", this->nextBlock, ex.getMessage().c_str());
+                }
+
+                if ((int) this->window.size() != size) {
+                    throw IOException(__FILE__, __LINE__, "Block %d decompressed to %d bytes instead of %d",
+                        this->nextBlock, (int) this->window.size(), size);
+                }
+
+                this->nextOffset += compressed;
+                this->nextBlock++;
+            }
+
+            return true;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BlockCompressionCodec::BlockCompressionCodec(CompressionCodec* codec, int blockSize) :
+    CompressionCodec(), codec(codec), blockSize(blockSize), executorLock(), executor() {
+
+    if (codec == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "Codec passed was NULL");
+    }
+
+    if (blockSize <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Block size must be positive: %d", blockSize);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BlockCompressionCodec::~BlockCompressionCodec() {
+    try {
+        if (this->executor != NULL) {
+            this->executor->shutdown();
+        }
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string BlockCompressionCodec::getName() const {
+    return toBlockCodecName(this->codec->getName());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long BlockCompressionCodec::getMemoryUsage() const {
+    return this->codec->getMemoryUsage();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BlockCompressionCodec::compress(int level, const unsigned char* const* buffers, const int* lengths,
+                                     int count, std::vector<unsigned char>& out) {
+
+    if (level < -1 || level > 9) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression level passed was Invalid: %d", level);
+    }
+
+    long long total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += lengths[i] > 0 ? lengths[i] : 0;
+    }
+
+    if (total > Integer::MAX_VALUE) {
+        throw IOException(__FILE__, __LINE__, "Data is too large to compress: %lld bytes", total);
+    }
+
+    int blocks = (int) ((total + this->blockSize - 1) / this->blockSize);
+
+    CompressBlocks work(this->codec.get(), level, this->blockSize, blocks, buffers, lengths, count);
+    runBlocks(blocks > 1 ? getExecutor() : NULL, work, blocks);
+
+    if (work.hasFailed()) {
+        throw IOException(__FILE__, __LINE__, "Failed to compress a block: %s", work.getError().c_str());
+    }
+
+    std::size_t size = 4 + (std::size_t) blocks * 8;
+    for (int block = 0; block < blocks; ++block) {
+        size += work.compressed[block].size();
+    }
+
+    std::size_t start = out.size();
+    out.reserve(start + size);
+    out.resize(start + 4 + (std::size_t) blocks * 8);
+
+    writeInt(out, start, blocks);
+
+    for (int block = 0; block < blocks; ++block) {
+        long long begin = (long long) block * this->blockSize;
+        int uncompressed = (int) (Math::min(begin + this->blockSize, total) - begin);
+
+        writeInt(out, start + 4 + (std::size_t) block * 8, uncompressed);
+        writeInt(out, start + 8 + (std::size_t) block * 8, (int) work.compressed[block].size());
+    }
+
+    for (int block = 0; block < blocks; ++block) {
+        out.insert(out.end(), work.compressed[block].begin(), work.compressed[block].end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BlockCompressionCodec::decompress(const unsigned char* buffer, int length,
+                                       std::vector<unsigned char>& out, int expected) {
+
+    if (buffer == NULL || length < 4) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data is missing its header.");
+    }
+
+    int blocks = readInt(buffer);
+    if (blocks < 0 || blocks > (length - 4) / 8) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid block count: %d", blocks);
+    }
+
+    DecompressBlocks work(this->codec.get(), blocks);
+    work.sources.reserve(blocks);
+    work.sourceLengths.reserve(blocks);
+    work.sizes.reserve(blocks);
+    work.targets.reserve(blocks);
+
+    long long total = 0;
+    long long offset = 4 + (long long) blocks * 8;
+
+    for (int block = 0; block < blocks; ++block) {
+
+        int size = readInt(buffer + 4 + block * 8);
+        int compressed = readInt(buffer + 8 + block * 8);
+
+        if (size < 0 || compressed < 0 || offset + compressed > length) {
+            throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid entry for block %d", block);
+        }
+
+        work.sources.push_back(buffer + offset);
+        work.sourceLengths.push_back(compressed);
+        work.sizes.push_back(size);
+        work.targets.push_back((std::size_t) total);
+
+        offset += compressed;
+        total += size;
+    }
+
+    if (total > Integer::MAX_VALUE || (expected > 0 && total != expected)) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid size: %lld", total);
+    }
+
+    if (total == 0) {
+        return;
+    }
+
+    // Every block decompresses straight into its place in the output.
+    std::size_t start = out.size();
+    out.resize(start + (std::size_t) total);
+    work.out = &out[start];
+
+    runBlocks(blocks > 1 ? getExecutor() : NULL, work, blocks);
+
+    if (work.hasFailed()) {
+        out.resize(start);
+        throw DataFormatException(__FILE__, __LINE__, "Failed to decompress a block: %s", work.getError().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+InputStream* BlockCompressionCodec::createInputStream(const unsigned char* buffer, int length, int expected) {
+
+    if (buffer == NULL || length < 4) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data is missing its header.");
+    }
+
+    int blocks = readInt(buffer);
+    if (blocks < 0 || blocks > (length - 4) / 8) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid block count: %d", blocks);
+    }
+
+    // The entries are checked now so the stream can trust them.
+    long long total = 0;
+    long long offset = 4 + (long long) blocks * 8;
+
+    for (int block = 0; block < blocks; ++block) {
+
+        int size = readInt(buffer + 4 + block * 8);
+        int compressed = readInt(buffer + 8 + block * 8);
+
+        if (size < 0 || compressed < 0 || offset + compressed > length) {
+            throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid entry for block %d", block);
+        }
+
+        offset += compressed;
+        total += size;
+    }
+
+    if (total > Integer::MAX_VALUE || (expected > 0 && total != expected)) {
+        throw DataFormatException(__FILE__, __LINE__, "Block compressed data has an invalid size: %lld", total);
+    }
+
+    return new BlockInputStream(this->codec.get(), buffer, blocks);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ThreadPoolExecutor* BlockCompressionCodec::getExecutor() {
+
+    int helpers = System::availableProcessors() - 1;
+    if (helpers <= 0) {
+        return NULL;
+    }
+
+    synchronized(&this->executorLock) {
+        if (this->executor == NULL) {
+            this->executor.reset(new ThreadPoolExecutor(helpers, helpers, 5, TimeUnit::SECONDS,
+                                                        new LinkedBlockingQueue<Runnable*>()));
+            this->executor->allowCoreThreadTimeout(true);
+        }
+
+        return this->executor.get();
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool BlockCompressionCodec::isBlockCodecName(const std::string& name) {
+    return name.size() > SUFFIX.size() &&
+           name.compare(name.size() - SUFFIX.size(), SUFFIX.size(), SUFFIX) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string BlockCompressionCodec::toBlockCodecName(const std::string& name) {
+    return name + SUFFIX;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string BlockCompressionCodec::toWrappedCodecName(const std::string& name) {
+    return isBlockCodecName(name) ? name.substr(0, name.size() - SUFFIX.size()) : name;
+}
@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_BLOCKCOMPRESSIONCODEC_H_
+#define _ACTIVEMQ_UTIL_BLOCKCOMPRESSIONCODEC_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/CompressionCodec.h>
+
+#include <decaf/io/InputStream.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+    class ThreadPoolExecutor;
+}}}
+
+namespace activemq {
+namespace util {
+
+    /**
+     * CompressionCodec that splits the data into blocks of a fixed size and compresses each
+     * one on its own with another codec, so that large bodies are compressed and
+     * decompressed by several threads at once.  The calling thread works on the blocks
+     * along with helper threads from a pool the codec starts when first needed, one fewer
+     * than the number of processors.  The helpers stop after a few seconds without work.
+     *
+     * The compressed form is the four byte big endian number of blocks, then for each
+     * block its uncompressed and compressed sizes as four byte big endian values, then the
+     * compressed blocks in order.  Every block is the complete output of the wrapped codec.
+     *
+     * The name of the codec is the wrapped codec's name followed by SUFFIX, "zlib+blocks"
+     * for instance, and is carried in the CODEC_PROPERTY of the messages it compresses.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API BlockCompressionCodec : public CompressionCodec {
+    public:
+
+        /**
+         * Appended to the name of the wrapped codec to name this one.
+         */
+        static const std::string SUFFIX;
+
+        /**
+         * Block size used when none is given, 1MB.
+         */
+        static const int DEFAULT_BLOCK_SIZE;
+
+    private:
+
+        std::auto_ptr<CompressionCodec> codec;
+        int blockSize;
+
+        decaf::util::concurrent::Mutex executorLock;
+        decaf::lang::Pointer<decaf::util::concurrent::ThreadPoolExecutor> executor;
+
+    private:
+
+        BlockCompressionCodec(const BlockCompressionCodec&);
+        BlockCompressionCodec& operator= (const BlockCompressionCodec&);
+
+    public:
+
+        /**
+         * Creates a codec that compresses each block with the given codec.
+         *
+         * @param codec
+         *      The codec that compresses the blocks, this codec takes ownership of it.
+         * @param blockSize
+         *      The number of uncompressed bytes in every block but the last.
+         *
+         * @throws NullPointerException if the codec is NULL.
+         * @throws IllegalArgumentException if the block size is not positive.
+         */
+        BlockCompressionCodec(CompressionCodec* codec, int blockSize = DEFAULT_BLOCK_SIZE);
+
+        virtual ~BlockCompressionCodec();
+
+        virtual std::string getName() const;
+
+        virtual void compress(int level, const unsigned char* const* buffers, const int* lengths,
+                              int count, std::vector<unsigned char>& out);
+
+        virtual void decompress(const unsigned char* buffer, int length,
+                                std::vector<unsigned char>& out, int expected = 0);
+
+        virtual long long getMemoryUsage() const;
+
+        /**
+         * Creates a stream that reads the decompressed form of the given block compressed
+         * data.  Each block is decompressed on the reading thread when the reads reach it
+         * so only one block is held decompressed at a time.
+         *
+         * @param buffer
+         *      The block compressed data, it must outlive the stream and not change.
+         * @param length
+         *      The number of bytes of compressed data.
+         * @param expected
+         *      The decompressed size recorded with the data, or zero if it isn't known.
+         *
+         * @return a new stream that the caller owns.
+         *
+         * @throws DataFormatException if the header of the data is not valid.
+         */
+        decaf::io::InputStream* createInputStream(const unsigned char* buffer, int length, int expected = 0);
+
+        /**
+         * @return the number of uncompressed bytes in every block but the last.
+         */
+        int getBlockSize() const {
+            return this->blockSize;
+        }
+
+    public:
+
+        /**
+         * @return true if the name is that of a BlockCompressionCodec.
+         */
+        static bool isBlockCodecName(const std::string& name);
+
+        /**
+         * @return the name of the BlockCompressionCodec wrapping the named codec.
+         */
+        static std::string toBlockCodecName(const std::string& name);
+
+        /**
+         * @return the name of the codec wrapped by the named BlockCompressionCodec.
+         */
+        static std::string toWrappedCodecName(const std::string& name);
+
+    private:
+
+        decaf::util::concurrent::ThreadPoolExecutor* getExecutor();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_BLOCKCOMPRESSIONCODEC_H_ */
@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionCodec.h"
+
+#include <activemq/util/BlockCompressionCodec.h>
+#include <activemq/util/CompressionPool.h>
+#include <activemq/util/Lz4Codec.h>
+#include <activemq/util/ZstdCodec.h>
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string CompressionCodec::ZLIB = "zlib";
+const std::string CompressionCodec::LZ4 = "lz4";
+const std::string CompressionCodec::ZSTD = "zstd";
+const std::string CompressionCodec::CODEC_PROPERTY = "JMS_AMQCPP_CompressionCodec";
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodec::~CompressionCodec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long CompressionCodec::getMemoryUsage() const {
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CompressionCodec::isKnown(const std::string& name) {
+
+    if (BlockCompressionCodec::isBlockCodecName(name)) {
+        return isKnown(BlockCompressionCodec::toWrappedCodecName(name));
+    }
+
+    return name == ZLIB || name == LZ4 || name == ZSTD;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CompressionCodec::isSupported(const std::string& name) {
+
+    if (BlockCompressionCodec::isBlockCodecName(name)) {
+        return isSupported(BlockCompressionCodec::toWrappedCodecName(name));
+    } else if (name == ZLIB) {
+        return true;
+    } else if (name == LZ4) {
+        return Lz4Codec::isAvailable();
+    } else if (name == ZSTD) {
+        return ZstdCodec::isAvailable();
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionCodec* CompressionCodec::create(const std::string& name, const std::vector<unsigned char>& dictionary) {
+
+    if (!isKnown(name)) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Unknown compression codec: %s", name.c_str());
+    }
+
+    if (!isSupported(name)) {
+        throw UnsupportedOperationException(__FILE__, __LINE__,
+            "The %s compression codec is not supported by this build of the library", name.c_str());
+    }
+
+    if (BlockCompressionCodec::isBlockCodecName(name)) {
+        return new BlockCompressionCodec(create(BlockCompressionCodec::toWrappedCodecName(name), dictionary));
+    } else if (name == LZ4) {
+        return new Lz4Codec(dictionary);
+    } else if (name == ZSTD) {
+        return new ZstdCodec(dictionary);
+    }
+
+    return new CompressionPool();
+}
@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_COMPRESSIONCODEC_H_
+#define _ACTIVEMQ_UTIL_COMPRESSIONCODEC_H_
+
+#include <activemq/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * Compresses and decompresses message bodies in one of the formats the client knows.
+     *
+     * The zlib codec is the one every ActiveMQ client understands, a message compressed
+     * with it only carries the compressed flag.  A message compressed with any other codec
+     * also carries the codec's name in the CODEC_PROPERTY message property so the receiver
+     * knows how to decompress it.  The LZ4 and Zstandard codecs are only available when the
+     * library was built against those libraries, see isSupported.  Any of the codecs can be
+     * wrapped by a BlockCompressionCodec, named by appending its SUFFIX, which compresses
+     * large bodies in blocks on several threads.
+     *
+     * Implementations must be safe to use from several threads at once.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API CompressionCodec {
+    public:
+
+        /**
+         * Name of the zlib codec, the default.
+         */
+        static const std::string ZLIB;
+
+        /**
+         * Name of the LZ4 codec, trades compression ratio for speed.
+         */
+        static const std::string LZ4;
+
+        /**
+         * Name of the Zstandard codec, compresses better than zlib at a similar speed.
+         */
+        static const std::string ZSTD;
+
+        /**
+         * Message property that names the codec a message body was compressed with, it is
+         * absent when the body was compressed with zlib.
+         */
+        static const std::string CODEC_PROPERTY;
+
+    public:
+
+        virtual ~CompressionCodec();
+
+        /**
+         * @return the name of this codec.
+         */
+        virtual std::string getName() const = 0;
+
+        /**
+         * Compresses the given arrays, in order, as one unit and appends the result to the
+         * given vector.
+         *
+         * @param level
+         *      The compression level to use, -1 for the codec's default or [0..9] from
+         *      fastest to best compression.
+         * @param buffers
+         *      The arrays to compress.
+         * @param lengths
+         *      The number of bytes to compress from each of the arrays.
+         * @param count
+         *      The number of arrays passed.
+         * @param out
+         *      The vector that the compressed bytes are appended to.
+         *
+         * @throws IllegalArgumentException if the level is not valid.
+         * @throws IOException if the codec fails to compress the data.
+         */
+        virtual void compress(int level, const unsigned char* const* buffers, const int* lengths,
+                              int count, std::vector<unsigned char>& out) = 0;
+
+        /**
+         * Decompresses data produced by this codec's compress method and appends the result
+         * to the given vector.
+         *
+         * @param buffer
+         *      The compressed data.
+         * @param length
+         *      The number of compressed bytes.
+         * @param out
+         *      The vector that the decompressed bytes are appended to.
+         * @param expected
+         *      The size of the decompressed data if known, or zero if not known.
+         *
+         * @throws DataFormatException if the data is corrupt or incomplete.
+         */
+        virtual void decompress(const unsigned char* buffer, int length,
+                                std::vector<unsigned char>& out, int expected = 0) = 0;
+
+        /**
+         * @return the bytes held by the compression state this codec keeps between calls,
+         *         zero for codecs that keep none.
+         */
+        virtual long long getMemoryUsage() const;
+
+    public:
+
+        /**
+         * @return true if the name is one of the codecs the client knows of, whether or not
+         *         it was built with support for it.
+         */
+        static bool isKnown(const std::string& name);
+
+        /**
+         * @return true if this build of the library can use the named codec.
+         */
+        static bool isSupported(const std::string& name);
+
+        /**
+         * Creates a new instance of the named codec, a BlockCompressionCodec is created
+         * with the default block size.
+         *
+         * @param name
+         *      The name of the codec.
+         * @param dictionary
+         *      Data that the codec primes itself with so that small messages resembling it
+         *      compress better, both ends must use the same dictionary.  Ignored by zlib.
+         *
+         * @return a new codec owned by the caller.
+         *
+         * @throws IllegalArgumentException if the codec is not known.
+         * @throws UnsupportedOperationException if this build does not support the codec.
+         */
+        static CompressionCodec* create(const std::string& name,
+                                        const std::vector<unsigned char>& dictionary = std::vector<unsigned char>());
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_COMPRESSIONCODEC_H_ */
@@ -0,0 +1,306 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionPool.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/Exception.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+const int CompressionPool::DEFAULT_MAX_IDLE;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Smallest amount of free space handed to zlib on each call.
+    const std::size_t MIN_CHUNK_SIZE = 1024;
+
+    // Makes sure there are at least MIN_CHUNK_SIZE bytes free past used, growing
+    // geometrically so that large outputs don't resize on every call.
+    void ensureSpace(std::vector<unsigned char>& out, std::size_t used) {
+        if (out.size() - used < MIN_CHUNK_SIZE) {
+            std::size_t grown = out.size() * 2;
+            out.resize(grown < used + MIN_CHUNK_SIZE ? used + MIN_CHUNK_SIZE : grown);
+        }
+    }
+
+    // Returns a Deflater to the pool when the compress call is done with it.
+    class DeflaterHolder {
+    private:
+
+        DeflaterHolder(const DeflaterHolder&);
+        DeflaterHolder& operator= (const DeflaterHolder&);
+
+    public:
+
+        CompressionPool* pool;
+        Deflater* deflater;
+
+        DeflaterHolder(CompressionPool* pool, Deflater* deflater) : pool(pool), deflater(deflater) {}
+
+        ~DeflaterHolder() {
+            try {
+                pool->returnDeflater(deflater);
+            } catch (...) {
+            }
+        }
+    };
+
+    // Returns an Inflater to the pool when the decompress call is done with it.
+    class InflaterHolder {
+    private:
+
+        InflaterHolder(const InflaterHolder&);
+        InflaterHolder& operator= (const InflaterHolder&);
+
+    public:
+
+        CompressionPool* pool;
+        Inflater* inflater;
+
+        InflaterHolder(CompressionPool* pool, Inflater* inflater) : pool(pool), inflater(inflater) {}
+
+        ~InflaterHolder() {
+            try {
+                pool->returnInflater(inflater);
+            } catch (...) {
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionPool::CompressionPool(int maxIdle) : CompressionCodec(), deflaters(), inflaters(), maxIdle(maxIdle < 0 ? 0 : maxIdle), lock() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CompressionPool::~CompressionPool() {
+    try {
+
+        std::vector<Deflater*>::iterator deflater = this->deflaters.begin();
+        for (; deflater != this->deflaters.end(); ++deflater) {
+            delete *deflater;
+        }
+
+        std::vector<Inflater*>::iterator inflater = this->inflaters.begin();
+        for (; inflater != this->inflaters.end(); ++inflater) {
+            delete *inflater;
+        }
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Deflater* CompressionPool::takeDeflater(int level) {
+
+    if (level < Deflater::DEFAULT_COMPRESSION || level > Deflater::BEST_COMPRESSION) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression level passed was Invalid: %d", level);
+    }
+
+    Deflater* deflater = NULL;
+
+    synchronized(&this->lock) {
+        if (!this->deflaters.empty()) {
+            deflater = this->deflaters.back();
+            this->deflaters.pop_back();
+        }
+    }
+
+    if (deflater == NULL) {
+        return new Deflater(level);
+    }
+
+    // Applied by the Deflater when the first input of the new stream is set.
+    deflater->setLevel(level);
+
+    return deflater;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPool::returnDeflater(Deflater* deflater) {
+
+    if (deflater == NULL) {
+        return;
+    }
+
+    try {
+        deflater->reset();
+    } catch (Exception&) {
+        // Ended by its user, it can't be used again.
+        delete deflater;
+        return;
+    }
+
+    synchronized(&this->lock) {
+        if ((int) this->deflaters.size() < this->maxIdle) {
+            this->deflaters.push_back(deflater);
+            return;
+        }
+    }
+
+    delete deflater;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Inflater* CompressionPool::takeInflater() {
+
+    synchronized(&this->lock) {
+        if (!this->inflaters.empty()) {
+            Inflater* inflater = this->inflaters.back();
+            this->inflaters.pop_back();
+            return inflater;
+        }
+    }
+
+    return new Inflater();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPool::returnInflater(Inflater* inflater) {
+
+    if (inflater == NULL) {
+        return;
+    }
+
+    try {
+        inflater->reset();
+    } catch (Exception&) {
+        // Ended by its user, it can't be used again.
+        delete inflater;
+        return;
+    }
+
+    synchronized(&this->lock) {
+        if ((int) this->inflaters.size() < this->maxIdle) {
+            this->inflaters.push_back(inflater);
+            return;
+        }
+    }
+
+    delete inflater;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string CompressionPool::getName() const {
+    return CompressionCodec::ZLIB;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPool::compress(int level, const unsigned char* const* buffers, const int* lengths,
+                               int count, std::vector<unsigned char>& out) {
+
+    DeflaterHolder holder(this, this->takeDeflater(level));
+    Deflater* deflater = holder.deflater;
+
+    std::size_t used = out.size();
+
+    for (int i = 0; i < count; ++i) {
+
+        if (lengths[i] <= 0) {
+            continue;
+        }
+
+        deflater->setInput(buffers[i], lengths[i], 0, lengths[i]);
+
+        while (!deflater->needsInput()) {
+            ensureSpace(out, used);
+            used += deflater->deflate(&out[0], (int) out.size(), (int) used, (int) (out.size() - used));
+        }
+    }
+
+    deflater->finish();
+
+    while (!deflater->finished()) {
+        ensureSpace(out, used);
+        used += deflater->deflate(&out[0], (int) out.size(), (int) used, (int) (out.size() - used));
+    }
+
+    out.resize(used);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPool::decompress(const unsigned char* buffer, int length,
+                                 std::vector<unsigned char>& out, int expected) {
+
+    InflaterHolder holder(this, this->takeInflater());
+    Inflater* inflater = holder.inflater;
+
+    std::size_t used = out.size();
+
+    if (expected > 0) {
+        out.resize(used + (std::size_t) expected);
+    }
+
+    if (length > 0) {
+        inflater->setInput(buffer, length, 0, length);
+    }
+
+    while (!inflater->finished()) {
+
+        ensureSpace(out, used);
+        int result = inflater->inflate(&out[0], (int) out.size(), (int) used, (int) (out.size() - used));
+
+        if (result == 0 && !inflater->finished() && (inflater->needsInput() || inflater->needsDictionary())) {
+            throw DataFormatException(__FILE__, __LINE__, "Compressed data ended before the end of the stream.");
+        }
+
+        used += result;
+    }
+
+    out.resize(used);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CompressionPool::getIdleDeflaters() const {
+
+    synchronized(&this->lock) {
+        return (int) this->deflaters.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CompressionPool::getIdleInflaters() const {
+
+    synchronized(&this->lock) {
+        return (int) this->inflaters.size();
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long CompressionPool::getMemoryUsage() const {
+
+    // (1 << (windowBits + 2)) + (1 << (memLevel + 9)) for deflate plus its state, the
+    // window and state for inflate.
+    static const long long DEFLATER_BYTES = (1LL << 17) + (1LL << 17) + 6 * 1024;
+    static const long long INFLATER_BYTES = (1LL << 15) + 7 * 1024;
+
+    return getIdleDeflaters() * DEFLATER_BYTES + getIdleInflaters() * INFLATER_BYTES;
+}
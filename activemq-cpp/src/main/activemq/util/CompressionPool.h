@@ -0,0 +1,193 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_COMPRESSIONPOOL_H_
+#define _ACTIVEMQ_UTIL_COMPRESSIONPOOL_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/CompressionCodec.h>
+
+#include <decaf/util/zip/Deflater.h>
+#include <decaf/util/zip/Inflater.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * Keeps idle zlib compression and decompression contexts so that message bodies can be
+     * compressed and decompressed without initializing and tearing down a new zlib stream,
+     * and its several hundred kilobytes of state, for every message.  A context taken from
+     * the pool is reset before it is handed out again.
+     *
+     * Every method may be called from any thread, the pool is only locked for as long as it
+     * takes to push or pop a context.  Up to getMaxIdle() contexts of each kind are kept,
+     * any that are returned beyond that are deleted.
+     *
+     * The compress and decompress methods work directly against a std::vector so that a
+     * message's content can be produced or consumed without intermediate stream copies.
+     * The pool is the zlib CompressionCodec.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API CompressionPool : public CompressionCodec {
+    public:
+
+        /**
+         * Default number of idle contexts of each kind kept by the pool.
+         */
+        static const int DEFAULT_MAX_IDLE = 4;
+
+    private:
+
+        std::vector<decaf::util::zip::Deflater*> deflaters;
+        std::vector<decaf::util::zip::Inflater*> inflaters;
+        int maxIdle;
+
+        mutable decaf::util::concurrent::Mutex lock;
+
+    private:
+
+        CompressionPool(const CompressionPool&);
+        CompressionPool& operator= (const CompressionPool&);
+
+    public:
+
+        /**
+         * Creates a pool that holds on to at most maxIdle contexts of each kind.
+         *
+         * @param maxIdle
+         *      The number of idle Deflaters and Inflaters to keep, zero disables pooling.
+         */
+        CompressionPool(int maxIdle = DEFAULT_MAX_IDLE);
+
+        virtual ~CompressionPool();
+
+        /**
+         * Hands out an idle Deflater set to the given level, or a new one if none is idle.
+         * The caller must pass it back to returnDeflater, or delete it, when done.
+         *
+         * @param level
+         *      The compression level to use, -1 for the zlib default or [0..9].
+         *
+         * @return a Deflater that is ready to compress a new stream.
+         *
+         * @throws IllegalArgumentException if the level is not valid.
+         */
+        decaf::util::zip::Deflater* takeDeflater(int level);
+
+        /**
+         * Resets the given Deflater and keeps it for reuse, or deletes it if the pool is
+         * full or the Deflater has been ended.
+         *
+         * @param deflater
+         *      The Deflater to return, NULL is ignored.
+         */
+        void returnDeflater(decaf::util::zip::Deflater* deflater);
+
+        /**
+         * Hands out an idle Inflater, or a new one if none is idle.  The caller must pass
+         * it back to returnInflater, or delete it, when done.
+         *
+         * @return an Inflater that is ready to decompress a new stream.
+         */
+        decaf::util::zip::Inflater* takeInflater();
+
+        /**
+         * Resets the given Inflater and keeps it for reuse, or deletes it if the pool is
+         * full or the Inflater has been ended.
+         *
+         * @param inflater
+         *      The Inflater to return, NULL is ignored.
+         */
+        void returnInflater(decaf::util::zip::Inflater* inflater);
+
+        /**
+         * @return CompressionCodec::ZLIB.
+         */
+        virtual std::string getName() const;
+
+        /**
+         * Compresses the given arrays, in order, as one zlib stream and appends the result
+         * to the given vector.
+         *
+         * @param level
+         *      The compression level to use, -1 for the zlib default or [0..9].
+         * @param buffers
+         *      The arrays to compress.
+         * @param lengths
+         *      The number of bytes to compress from each of the arrays.
+         * @param count
+         *      The number of arrays passed.
+         * @param out
+         *      The vector that the compressed bytes are appended to.
+         *
+         * @throws IllegalArgumentException if the level is not valid.
+         */
+        virtual void compress(int level, const unsigned char* const* buffers, const int* lengths,
+                              int count, std::vector<unsigned char>& out);
+
+        /**
+         * Decompresses a complete zlib stream and appends the result to the given vector.
+         *
+         * @param buffer
+         *      The compressed data.
+         * @param length
+         *      The number of compressed bytes.
+         * @param out
+         *      The vector that the decompressed bytes are appended to.
+         * @param expected
+         *      The size of the decompressed data if known, used to size the vector up
+         *      front, or zero if not known.
+         *
+         * @throws DataFormatException if the data is not a complete zlib stream.
+         */
+        virtual void decompress(const unsigned char* buffer, int length,
+                                std::vector<unsigned char>& out, int expected = 0);
+
+        /**
+         * @return the number of idle contexts of each kind the pool keeps.
+         */
+        int getMaxIdle() const {
+            return this->maxIdle;
+        }
+
+        /**
+         * @return the number of Deflaters currently idle in the pool.
+         */
+        int getIdleDeflaters() const;
+
+        /**
+         * @return the number of Inflaters currently idle in the pool.
+         */
+        int getIdleInflaters() const;
+
+        /**
+         * {@inheritDoc}
+         *
+         * Estimated from the idle Deflaters and Inflaters using zlib's documented state
+         * sizes for its default window and memory level.
+         */
+        virtual long long getMemoryUsage() const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_COMPRESSIONPOOL_H_ */
@@ -0,0 +1,157 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CopyOnWriteBytes.h"
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::vector<unsigned char> EMPTY_BYTES;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::Releaser::~Releaser() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::Buffer::~Buffer() {
+
+    if (this->releaser != NULL) {
+        try {
+            this->releaser->release(this->external, this->externalLength);
+        } catch (...) {
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::CopyOnWriteBytes() : buffer() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::CopyOnWriteBytes(const std::vector<unsigned char>& bytes) : buffer() {
+    if (!bytes.empty()) {
+        this->buffer.reset(new Buffer(bytes));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::CopyOnWriteBytes(const CopyOnWriteBytes& source) : buffer(source.buffer) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes::~CopyOnWriteBytes() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes& CopyOnWriteBytes::operator= (const CopyOnWriteBytes& source) {
+    this->buffer = source.buffer;
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CopyOnWriteBytes& CopyOnWriteBytes::operator= (const std::vector<unsigned char>& bytes) {
+
+    if (this->buffer != NULL && &bytes == &this->buffer->bytes) {
+        return *this;
+    }
+
+    if (bytes.empty()) {
+        clear();
+    } else if (this->buffer != NULL && !isShared() && !isAttached()) {
+        this->buffer->bytes = bytes;
+    } else {
+        this->buffer.reset(new Buffer(bytes));
+    }
+
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector<unsigned char>& CopyOnWriteBytes::get() const {
+
+    if (this->buffer == NULL) {
+        return EMPTY_BYTES;
+    }
+
+    if (isAttached()) {
+        const unsigned char* bytes = this->buffer->external;
+        this->buffer.reset(new Buffer(std::vector<unsigned char>(bytes, bytes + this->buffer->externalLength)));
+    }
+
+    return this->buffer->bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char>& CopyOnWriteBytes::edit() {
+
+    if (this->buffer == NULL) {
+        this->buffer.reset(new Buffer());
+    } else if (isAttached()) {
+        get();
+    } else if (isShared()) {
+        this->buffer.reset(new Buffer(this->buffer->bytes));
+    }
+
+    return this->buffer->bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* CopyOnWriteBytes::data() const {
+
+    if (isAttached()) {
+        return this->buffer->external;
+    }
+
+    const std::vector<unsigned char>& bytes = get();
+    return bytes.empty() ? NULL : &bytes[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytes::attach(const unsigned char* bytes, std::size_t length, Releaser* releaser) {
+
+    if (bytes == NULL) {
+        if (releaser != NULL) {
+            releaser->release(bytes, length);
+        }
+        clear();
+        return;
+    }
+
+    this->buffer.reset(new Buffer(bytes, length, releaser));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytes::clear() {
+
+    if (this->buffer != NULL && !isShared() && !isAttached()) {
+        this->buffer->bytes.clear();
+    } else {
+        this->buffer.reset(NULL);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CopyOnWriteBytes::isShared() const {
+    return this->buffer != NULL && this->buffer->getReferenceCount() > 1;
+}
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_COPYONWRITEBYTES_H_
+#define _ACTIVEMQ_UTIL_COPYONWRITEBYTES_H_
+
+#include <activemq/util/Config.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/util/concurrent/atomic/AtomicRefCounted.h>
+
+#include <vector>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * A byte buffer that copies share until one of them is modified.  Copying or
+     * assigning a CopyOnWriteBytes only takes a reference to its bytes, the bytes are
+     * copied the first time a holder asks to modify them while another holder still
+     * shares them.
+     *
+     * The bytes are immutable while shared, a reference returned by get() stays valid
+     * until this holder modifies or drops them.  Holders of the same bytes may be used
+     * from different threads, one holder may not be used from two threads at once.
+     *
+     * The bytes can also be memory the application owns, attached without a copy and
+     * handed back to the application's Releaser once no holder uses them anymore.
+     * Attached bytes are read in place through data(), get() and edit() copy them
+     * into a vector of this holder's own first.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API CopyOnWriteBytes {
+    public:
+
+        /**
+         * Told when attached bytes are no longer used, which may happen on any thread
+         * that dropped the last holder of them.
+         */
+        class AMQCPP_API Releaser {
+        public:
+
+            virtual ~Releaser();
+
+            /**
+             * Called once with the bytes that were attached.
+             *
+             * @param bytes
+             *      The bytes given to attach.
+             * @param length
+             *      The number of bytes given to attach.
+             */
+            virtual void release(const unsigned char* bytes, std::size_t length) = 0;
+
+        };
+
+    private:
+
+        class Buffer : public decaf::util::concurrent::atomic::AtomicRefCounted {
+        private:
+
+            Buffer(const Buffer&);
+            Buffer& operator= (const Buffer&);
+
+        public:
+
+            std::vector<unsigned char> bytes;
+
+            const unsigned char* external;
+            std::size_t externalLength;
+            Releaser* releaser;
+
+            Buffer() : AtomicRefCounted(), bytes(), external(NULL), externalLength(0), releaser(NULL) {}
+
+            Buffer(const std::vector<unsigned char>& bytes) :
+                AtomicRefCounted(), bytes(bytes), external(NULL), externalLength(0), releaser(NULL) {}
+
+            Buffer(const unsigned char* external, std::size_t length, Releaser* releaser) :
+                AtomicRefCounted(), bytes(), external(external), externalLength(length), releaser(releaser) {}
+
+            ~Buffer();
+
+        };
+
+        // Mutable so that get() can replace attached bytes with a copy.
+        mutable decaf::lang::Pointer<Buffer> buffer;
+
+    public:
+
+        CopyOnWriteBytes();
+
+        /**
+         * Creates a buffer holding a copy of the given bytes.
+         *
+         * @param bytes
+         *      The bytes to copy.
+         */
+        CopyOnWriteBytes(const std::vector<unsigned char>& bytes);
+
+        /**
+         * Creates a buffer that shares the bytes of the source.
+         *
+         * @param source
+         *      The buffer to share the bytes of.
+         */
+        CopyOnWriteBytes(const CopyOnWriteBytes& source);
+
+        virtual ~CopyOnWriteBytes();
+
+        /**
+         * Drops the bytes held and shares those of the source.
+         */
+        CopyOnWriteBytes& operator= (const CopyOnWriteBytes& source);
+
+        /**
+         * Replaces the bytes held with a copy of the given ones, reusing the storage
+         * of the bytes held when they are not shared.
+         */
+        CopyOnWriteBytes& operator= (const std::vector<unsigned char>& bytes);
+
+        /**
+         * @return the bytes, which must not be modified through a cast.  Attached bytes
+         *         are first copied into a vector held by this buffer only.
+         */
+        const std::vector<unsigned char>& get() const;
+
+        /**
+         * Gets the bytes to modify them, copying them first if they are shared.  The
+         * reference is valid until this buffer is next copied from or assigned to.
+         *
+         * @return the bytes held only by this buffer.
+         */
+        std::vector<unsigned char>& edit();
+
+        /**
+         * Empties the buffer, the bytes it shared are left to their other holders.
+         */
+        void clear();
+
+        /**
+         * Holds the given bytes in place of the current ones without copying them.  The
+         * bytes must stay valid and unchanged until the releaser is called, which is
+         * done once the last holder drops them.
+         *
+         * @param bytes
+         *      The bytes to hold.
+         * @param length
+         *      The number of bytes to hold.
+         * @param releaser
+         *      Told when the bytes are no longer used, or NULL when the caller keeps the
+         *      bytes valid for as long as any holder may use them.
+         */
+        void attach(const unsigned char* bytes, std::size_t length, Releaser* releaser);
+
+        /**
+         * @return true if the bytes held were attached and are read in place.
+         */
+        bool isAttached() const {
+            return this->buffer != NULL && this->buffer->external != NULL;
+        }
+
+        /**
+         * @return the first of the bytes held, or NULL when there are none, valid for as
+         *         long as get() would be.
+         */
+        const unsigned char* data() const;
+
+        /**
+         * @return true if another buffer currently holds the same bytes.
+         */
+        bool isShared() const;
+
+        std::size_t size() const {
+            if (this->buffer == NULL) {
+                return 0;
+            }
+
+            return this->buffer->external != NULL ? this->buffer->externalLength : this->buffer->bytes.size();
+        }
+
+        bool isEmpty() const {
+            return size() == 0;
+        }
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_COPYONWRITEBYTES_H_ */
@@ -25,6 +25,7 @@
 #include <decaf/util/concurrent/Mutex.h>
 
 #include <decaf/internal/util/StringUtils.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 #include <decaf/lang/exceptions/RuntimeException.h>
 
 using namespace activemq;
@@ -36,6 +37,7 @@ using namespace decaf::net;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 IdGeneratorKernel* IdGenerator::kernel = NULL;
@@ -50,35 +52,67 @@ namespace util {
         std::string UNIQUE_STUB;
         int instanceCount;
         std::string hostname;
+        bool resolved;
         mutable decaf::util::concurrent::Mutex mutex;
 
-        IdGeneratorKernel() : UNIQUE_STUB(), instanceCount(0), hostname(), mutex() {
+        IdGeneratorKernel() : UNIQUE_STUB(), instanceCount(0), hostname(), resolved(false), mutex() {
+        }
+
+        /**
+         * Works out the host name and the unique stub the first time an id is needed
+         * rather than when the library starts, the caller holds the mutex.
+         */
+        void resolve() {
+
+            if (resolved) {
+                return;
+            }
+
+            // The host name is only part of the id, it is not resolved to an address
+            // as that can wait for seconds on a host without working reverse DNS.
+            hostname = System::getProperty("activemq.idgenerator.hostname", "");
+            if (hostname.empty()) {
+                hostname = InetAddress::getLocalHostName();
+            }
 
             std::string stub = "";
 
             try {
-                hostname = InetAddress::getLocalHost().getHostName();
-                ServerSocket ss(0);
-                stub = "-" + Long::toString(ss.getLocalPort()) +
-                       "-" + Long::toString(System::currentTimeMillis()) + "-";
-                Thread::sleep(100);
-                ss.close();
+
+                std::string localPort = System::getProperty("activemq.idgenerator.localport", "");
+
+                if (!localPort.empty()) {
+                    stub = "-" + Long::toString(Long::parseLong(localPort)) +
+                           "-" + Long::toString(System::currentTimeMillis()) + "-";
+                } else {
+
+                    // Holding the port until the clock has moved on means no other
+                    // process can pair the same port with the same time.
+                    ServerSocket ss(0);
+                    long long now = System::currentTimeMillis();
+                    stub = "-" + Long::toString(ss.getLocalPort()) + "-" + Long::toString(now) + "-";
+                    while (System::currentTimeMillis() <= now) {
+                        Thread::sleep(1);
+                    }
+                    ss.close();
+                }
+
             } catch (Exception& ioe) {
-                hostname = "localhost";
                 stub = "-1-" + Long::toString(System::currentTimeMillis()) + "-";
             }
 
             UNIQUE_STUB = stub;
+            resolved = true;
         }
     };
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
-IdGenerator::IdGenerator() : prefix(), seed(), sequence(0) {
+IdGenerator::IdGenerator() : prefix(), seed(), seeded(0), sequence(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-IdGenerator::IdGenerator(const std::string& prefix) : prefix(prefix), seed(), sequence(0) {
+IdGenerator::IdGenerator(const std::string& prefix) : prefix(prefix), seed(), seeded(0), sequence(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,30 +122,56 @@ IdGenerator::~IdGenerator() {
 ////////////////////////////////////////////////////////////////////////////////
 std::string IdGenerator::generateId() const {
 
-    std::string result;
-
     if (IdGenerator::kernel == NULL) {
         throw RuntimeException(__FILE__, __LINE__, "Library is not initialized.");
     }
 
-    synchronized( &( IdGenerator::kernel->mutex ) ) {
+    // The seed is only assigned once, after that only the sequence changes and that
+    // is a single atomic increment.
+    if (Atomics::getAndAdd(&this->seeded, 0) == 0) {
+
+        synchronized( &( IdGenerator::kernel->mutex ) ) {
+
+            if (seed.empty()) {
+
+                IdGenerator::kernel->resolve();
 
-        if (seed.empty()) {
+                if (prefix.empty()) {
+                    this->seed = std::string("ID:") + IdGenerator::kernel->hostname + IdGenerator::kernel->UNIQUE_STUB
+                            + Long::toString(IdGenerator::kernel->instanceCount++) + ":";
+                } else {
+                    this->seed = prefix + IdGenerator::kernel->UNIQUE_STUB + Long::toString(IdGenerator::kernel->instanceCount++) + ":";
+                }
 
-            if (prefix.empty()) {
-                this->seed = std::string("ID:") + IdGenerator::kernel->hostname + IdGenerator::kernel->UNIQUE_STUB
-                        + Long::toString(IdGenerator::kernel->instanceCount++) + ":";
-            } else {
-                this->seed = prefix + IdGenerator::kernel->UNIQUE_STUB + Long::toString(IdGenerator::kernel->instanceCount++) + ":";
+                Atomics::getAndSet(&this->seeded, 1);
             }
         }
-
-        result = this->seed + Long::toString(this->sequence++);
     }
 
+    long long next = Atomics::getAndAdd64(&this->sequence, 1);
+
+    std::string result;
+    result.reserve(this->seed.length() + 20);
+    result.append(this->seed);
+    result.append(Long::toString(next));
+
     return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string IdGenerator::getHostname() {
+
+    if (IdGenerator::kernel == NULL) {
+        throw RuntimeException(__FILE__, __LINE__, "Library is not initialized.");
+    }
+
+    synchronized( &( IdGenerator::kernel->mutex ) ) {
+        IdGenerator::kernel->resolve();
+    }
+
+    return IdGenerator::kernel->hostname;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string IdGenerator::getSeedFromId(const std::string& id) {
 
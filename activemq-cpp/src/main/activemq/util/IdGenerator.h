@@ -35,7 +35,8 @@ namespace util {
 
         std::string prefix;
         mutable std::string seed;
-        mutable long long sequence;
+        mutable volatile int seeded;
+        mutable volatile long long sequence;
 
         static IdGeneratorKernel* kernel;
 
@@ -62,10 +63,11 @@ namespace util {
     public:
 
         /**
-         * Since the initialization of this object results in the retrieval of the
-         * machine's host name we can quickly return it here.
+         * Gets the host name used in the generated ids, the name given by the
+         * activemq.idgenerator.hostname system property or else the name the machine
+         * is configured with.  The name is not resolved so this never waits on DNS.
          *
-         * @return the previously retrieved host name.
+         * @return the host name used in the generated ids.
          */
         static std::string getHostname();
 
@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <decaf/lang/Long.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+#include <cmath>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::lang;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int LatencyHistogram::SUB_BUCKET_COUNT;
+const int LatencyHistogram::BUCKET_COUNT;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Number of bits needed to index the sub buckets of a power of two.
+    const int SUB_BUCKET_BITS = 4;
+
+    // Index of the highest set bit of a positive value.
+    int highestBit(long long value) {
+        int bit = 0;
+        for (int shift = 32; shift > 0; shift >>= 1) {
+            if ((value >> shift) != 0) {
+                value >>= shift;
+                bit += shift;
+            }
+        }
+        return bit;
+    }
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram() : totalCount(0), totalSum(0), minValue(Long::MAX_VALUE), maxValue(0) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        this->counts[i] = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::~LatencyHistogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int LatencyHistogram::getBucketIndex(long long value) {
+
+    if (value < SUB_BUCKET_COUNT) {
+        return value < 0 ? 0 : (int) value;
+    }
+
+    // The top SUB_BUCKET_BITS + 1 bits of the value select its bucket.
+    int shift = highestBit(value) - SUB_BUCKET_BITS;
+    int subBucket = (int) (value >> shift) - SUB_BUCKET_COUNT;
+
+    return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getBucketUpperBound(int index) {
+
+    if (index < SUB_BUCKET_COUNT) {
+        return index < 0 ? 0 : index;
+    }
+
+    int shift = index / SUB_BUCKET_COUNT - 1;
+    unsigned long long subBucket = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+
+    return (long long) (((subBucket + 1) << shift) - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::record(long long value) {
+
+    if (value < 0) {
+        value = 0;
+    }
+
+    Atomics::getAndAdd64(&this->counts[getBucketIndex(value)], 1);
+    Atomics::getAndAdd64(&this->totalSum, value);
+
+    long long current = this->minValue;
+    while (value < current && !Atomics::compareAndSet64(&this->minValue, current, value)) {
+        current = this->minValue;
+    }
+
+    current = this->maxValue;
+    while (value > current && !Atomics::compareAndSet64(&this->maxValue, current, value)) {
+        current = this->maxValue;
+    }
+
+    // Counted last so that a reader seeing the count also sees the bucket.
+    Atomics::getAndAdd64(&this->totalCount, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getCount() const {
+    return this->totalCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getSum() const {
+    return this->totalSum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getMin() const {
+    return this->totalCount == 0 ? 0 : this->minValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getMax() const {
+    return this->totalCount == 0 ? 0 : this->maxValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double LatencyHistogram::getMean() const {
+    long long count = this->totalCount;
+    return count == 0 ? 0.0 : (double) this->totalSum / (double) count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getValueAtPercentile(double percentile) const {
+
+    long long count = this->totalCount;
+    if (count == 0) {
+        return 0;
+    }
+
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    long long target = (long long) std::ceil(percentile / 100.0 * (double) count);
+    if (target < 1) {
+        target = 1;
+    }
+
+    long long max = this->maxValue;
+    long long seen = 0;
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += this->counts[i];
+        if (seen >= target) {
+            long long bound = getBucketUpperBound(i);
+            return bound < max ? bound : max;
+        }
+    }
+
+    return max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::reset() {
+
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        this->counts[i] = 0;
+    }
+
+    this->totalCount = 0;
+    this->totalSum = 0;
+    this->minValue = Long::MAX_VALUE;
+    this->maxValue = 0;
+}
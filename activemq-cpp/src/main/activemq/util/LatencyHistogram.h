@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_LATENCYHISTOGRAM_H_
+#define _ACTIVEMQ_UTIL_LATENCYHISTOGRAM_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * A fixed size histogram of non-negative values, typically latencies in microseconds,
+     * that can be recorded into from many threads without locking.  In the manner of an
+     * HDR histogram the range is divided into powers of two that are each split into
+     * sixteen linear sub buckets, values below sixteen are kept exactly and any larger
+     * value is stored with a relative error of at most one part in sixteen.  The whole
+     * range of a long long is covered so no value is ever clamped into an overflow bucket.
+     *
+     * Recording a value is a handful of atomic additions, reads are not synchronized with
+     * concurrent recording so a percentile taken while values are being recorded reflects
+     * some but not necessarily all of them.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API LatencyHistogram {
+    public:
+
+        /**
+         * Number of linear sub buckets in each power of two.
+         */
+        static const int SUB_BUCKET_COUNT = 16;
+
+        /**
+         * Total number of buckets needed to cover every non-negative long long value.
+         */
+        static const int BUCKET_COUNT = 60 * SUB_BUCKET_COUNT;
+
+    private:
+
+        volatile long long counts[BUCKET_COUNT];
+        volatile long long totalCount;
+        volatile long long totalSum;
+        volatile long long minValue;
+        volatile long long maxValue;
+
+    private:
+
+        LatencyHistogram(const LatencyHistogram&);
+        LatencyHistogram& operator= (const LatencyHistogram&);
+
+    public:
+
+        LatencyHistogram();
+
+        virtual ~LatencyHistogram();
+
+        /**
+         * Records a single value, negative values are recorded as zero.
+         *
+         * @param value
+         *      The value to record.
+         */
+        void record(long long value);
+
+        /**
+         * @return the number of values recorded.
+         */
+        long long getCount() const;
+
+        /**
+         * @return the sum of all the values recorded.
+         */
+        long long getSum() const;
+
+        /**
+         * @return the smallest value recorded, or zero if nothing has been recorded.
+         */
+        long long getMin() const;
+
+        /**
+         * @return the largest value recorded, or zero if nothing has been recorded.
+         */
+        long long getMax() const;
+
+        /**
+         * @return the mean of the values recorded, or zero if nothing has been recorded.
+         */
+        double getMean() const;
+
+        /**
+         * Returns the value that the given percentage of the recorded values are less than
+         * or equal to, to within the precision of the bucket the value falls in.  The result
+         * is the upper bound of that bucket limited to the largest value recorded.
+         *
+         * @param percentile
+         *      The percentage in the range [0, 100], values outside it are clamped.
+         *
+         * @return the value at the percentile, or zero if nothing has been recorded.
+         */
+        long long getValueAtPercentile(double percentile) const;
+
+        /**
+         * Clears all recorded values, values recorded while the reset runs may be lost.
+         */
+        void reset();
+
+        /**
+         * Returns the index of the bucket that the given value is counted in.
+         *
+         * @param value
+         *      A non-negative value.
+         *
+         * @return the bucket index in the range [0, BUCKET_COUNT).
+         */
+        static int getBucketIndex(long long value);
+
+        /**
+         * Returns the largest value that is counted in the given bucket.
+         *
+         * @param index
+         *      The bucket index in the range [0, BUCKET_COUNT).
+         *
+         * @return the upper bound of the bucket's values.
+         */
+        static long long getBucketUpperBound(int index);
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_LATENCYHISTOGRAM_H_ */
@@ -16,14 +16,14 @@
  */
 
 #include "LongSequenceGenerator.h"
-#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace activemq;
 using namespace activemq::util;
-using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-LongSequenceGenerator::LongSequenceGenerator() : lastSequenceId(0), mutex() {
+LongSequenceGenerator::LongSequenceGenerator() : lastSequenceId(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,20 +32,10 @@ LongSequenceGenerator::~LongSequenceGenerator() {
 
 ////////////////////////////////////////////////////////////////////////////////
 long long LongSequenceGenerator::getNextSequenceId() {
-
-    synchronized(&mutex) {
-        return ++this->lastSequenceId;
-    }
-
-    return 0;
+    return Atomics::addAndGet64(&this->lastSequenceId, 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 long long LongSequenceGenerator::getLastSequenceId() {
-
-    synchronized(&mutex) {
-        return this->lastSequenceId;
-    }
-
-    return 0;
+    return Atomics::getAndAdd64(&this->lastSequenceId, 0);
 }
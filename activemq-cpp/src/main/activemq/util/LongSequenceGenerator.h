@@ -19,7 +19,6 @@
 #define _ACTIVEMQ_UTIL_LONGSEQUENCEGENERATOR_H_
 
 #include <activemq/util/Config.h>
-#include <decaf/util/concurrent/Mutex.h>
 
 namespace activemq {
 namespace util {
@@ -27,13 +26,18 @@ namespace util {
     /**
      * This class is used to generate a sequence of long long values that
      * are incremented each time a new value is requested.  This class is
-     * thread safe so the ids can be requested in different threads safely.
+     * thread safe so the ids can be requested in different threads safely,
+     * each request is a single atomic increment so no lock is taken.
      */
     class AMQCPP_API LongSequenceGenerator {
     private:
 
-        long long lastSequenceId;
-        decaf::util::concurrent::Mutex mutex;
+        volatile long long lastSequenceId;
+
+    private:
+
+        LongSequenceGenerator(const LongSequenceGenerator&);
+        LongSequenceGenerator& operator= (const LongSequenceGenerator&);
 
     public:
 
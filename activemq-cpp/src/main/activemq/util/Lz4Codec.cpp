@@ -0,0 +1,189 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Lz4Codec.h"
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+Lz4Codec::Lz4Codec(const std::vector<unsigned char>& dictionary) : CompressionCodec(), dictionary(dictionary) {
+
+    if (!isAvailable()) {
+        throw UnsupportedOperationException(__FILE__, __LINE__,
+            "The lz4 compression codec is not supported by this build of the library");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Lz4Codec::~Lz4Codec() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Lz4Codec::isAvailable() {
+#ifdef HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string Lz4Codec::getName() const {
+    return CompressionCodec::LZ4;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Lz4Codec::compress(int level, const unsigned char* const* buffers AMQCPP_UNUSED,
+                        const int* lengths AMQCPP_UNUSED, int count AMQCPP_UNUSED,
+                        std::vector<unsigned char>& out AMQCPP_UNUSED) {
+
+    if (level < -1 || level > 9) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression level passed was Invalid: %d", level);
+    }
+
+#ifdef HAVE_LZ4
+
+    long long total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += lengths[i] > 0 ? lengths[i] : 0;
+    }
+
+    if (total > LZ4_MAX_INPUT_SIZE) {
+        throw IOException(__FILE__, __LINE__, "Data is too large to compress with lz4: %lld bytes", total);
+    }
+
+    // An LZ4 block is compressed from one contiguous run of bytes.
+    std::vector<unsigned char> gathered;
+    const char* source = NULL;
+
+    if (count == 1 && total > 0) {
+        source = (const char*) buffers[0];
+    } else if (total > 0) {
+        gathered.reserve((std::size_t) total);
+        for (int i = 0; i < count; ++i) {
+            if (lengths[i] > 0) {
+                gathered.insert(gathered.end(), buffers[i], buffers[i] + lengths[i]);
+            }
+        }
+        source = (const char*) &gathered[0];
+    }
+
+    int size = (int) total;
+    std::size_t start = out.size();
+    int bound = LZ4_compressBound(size);
+
+    out.resize(start + 4 + (std::size_t) bound);
+    out[start] = (unsigned char) ((size >> 24) & 0xFF);
+    out[start + 1] = (unsigned char) ((size >> 16) & 0xFF);
+    out[start + 2] = (unsigned char) ((size >> 8) & 0xFF);
+    out[start + 3] = (unsigned char) (size & 0xFF);
+
+    if (size == 0) {
+        out.resize(start + 4);
+        return;
+    }
+
+    int acceleration = level < 0 ? 1 : 10 - level;
+    char* target = (char*) &out[start + 4];
+    int written = 0;
+
+    if (this->dictionary.empty()) {
+        written = LZ4_compress_fast(source, target, size, bound, acceleration);
+    } else {
+        LZ4_stream_t* stream = LZ4_createStream();
+        if (stream == NULL) {
+            throw IOException(__FILE__, __LINE__, "Failed to allocate an lz4 stream");
+        }
+
+        LZ4_loadDict(stream, (const char*) &this->dictionary[0], (int) this->dictionary.size());
+        written = LZ4_compress_fast_continue(stream, source, target, size, bound, acceleration);
+        LZ4_freeStream(stream);
+    }
+
+    if (written <= 0) {
+        out.resize(start);
+        throw IOException(__FILE__, __LINE__, "lz4 failed to compress the data");
+    }
+
+    out.resize(start + 4 + (std::size_t) written);
+
+#else
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "The lz4 compression codec is not supported by this build of the library");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Lz4Codec::decompress(const unsigned char* buffer AMQCPP_UNUSED, int length AMQCPP_UNUSED,
+                          std::vector<unsigned char>& out AMQCPP_UNUSED, int expected AMQCPP_UNUSED) {
+
+#ifdef HAVE_LZ4
+
+    if (buffer == NULL || length < 4) {
+        throw DataFormatException(__FILE__, __LINE__, "lz4 data is missing its size header.");
+    }
+
+    int size = ((buffer[0] & 0xFF) << 24) | ((buffer[1] & 0xFF) << 16) |
+               ((buffer[2] & 0xFF) << 8) | (buffer[3] & 0xFF);
+
+    if (size < 0 || (expected > 0 && size != expected)) {
+        throw DataFormatException(__FILE__, __LINE__, "lz4 data has an invalid size header: %d", size);
+    }
+
+    if (size == 0) {
+        return;
+    }
+
+    std::size_t start = out.size();
+    out.resize(start + (std::size_t) size);
+
+    const char* source = (const char*) buffer + 4;
+    char* target = (char*) &out[start];
+    int result = 0;
+
+    if (this->dictionary.empty()) {
+        result = LZ4_decompress_safe(source, target, length - 4, size);
+    } else {
+        result = LZ4_decompress_safe_usingDict(source, target, length - 4, size,
+                                               (const char*) &this->dictionary[0], (int) this->dictionary.size());
+    }
+
+    if (result != size) {
+        out.resize(start);
+        throw DataFormatException(__FILE__, __LINE__, "lz4 data is corrupt or was compressed with another dictionary.");
+    }
+
+#else
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "The lz4 compression codec is not supported by this build of the library");
+#endif
+}
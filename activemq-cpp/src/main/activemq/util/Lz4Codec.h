@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_LZ4CODEC_H_
+#define _ACTIVEMQ_UTIL_LZ4CODEC_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/CompressionCodec.h>
+
+#include <vector>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * CompressionCodec that uses LZ4 block compression, which compresses and decompresses
+     * several times faster than zlib at the cost of a lower compression ratio.
+     *
+     * The compressed form is the four byte big endian size of the uncompressed data followed
+     * by a single LZ4 block.  The compression level selects LZ4's acceleration, level 9 and
+     * the default level give the best ratio and lower levels trade ratio for speed.
+     *
+     * When a dictionary is given the block is compressed against it, the receiver must
+     * decompress with the same dictionary.  LZ4 only makes use of the last 64KB of it.
+     *
+     * Only usable when the library is built against liblz4, see isAvailable.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API Lz4Codec : public CompressionCodec {
+    private:
+
+        std::vector<unsigned char> dictionary;
+
+    private:
+
+        Lz4Codec(const Lz4Codec&);
+        Lz4Codec& operator= (const Lz4Codec&);
+
+    public:
+
+        /**
+         * Creates a codec that compresses against the given dictionary, which may be empty.
+         *
+         * @param dictionary
+         *      The dictionary shared with the receivers of the compressed data.
+         *
+         * @throws UnsupportedOperationException if the library was built without LZ4.
+         */
+        Lz4Codec(const std::vector<unsigned char>& dictionary = std::vector<unsigned char>());
+
+        virtual ~Lz4Codec();
+
+        virtual std::string getName() const;
+
+        virtual void compress(int level, const unsigned char* const* buffers, const int* lengths,
+                              int count, std::vector<unsigned char>& out);
+
+        virtual void decompress(const unsigned char* buffer, int length,
+                                std::vector<unsigned char>& out, int expected = 0);
+
+        /**
+         * @return true if the library was built with LZ4 support.
+         */
+        static bool isAvailable();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_LZ4CODEC_H_ */
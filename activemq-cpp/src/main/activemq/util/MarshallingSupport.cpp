@@ -21,12 +21,15 @@
 #include <activemq/exceptions/ExceptionDefines.h>
 #include <decaf/lang/Short.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/internal/util/StringUtils.h>
 
 using namespace activemq;
 using namespace activemq::util;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::lang;
+using namespace decaf::internal::util;
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -138,60 +141,28 @@ std::string MarshallingSupport::asciiToModifiedUtf8(const std::string& asciiStri
 
     try {
 
-        if (asciiString.length() > 0) {
-
-            int utfLength = 0;
-            std::size_t length = asciiString.length();
-
-            for (std::size_t i = 0; i < length; ++i) {
-
-                unsigned int charValue = (unsigned char) asciiString.at(i);
-
-                // Written to allow for expansion to wide character strings at some
-                // point, as it stands now the value can never be > 255 since the
-                // string class returns a single byte char.
-                if (charValue > 0 && charValue <= 127) {
-                    utfLength++;
-                } else if (charValue <= 2047) {
-                    utfLength += 2;
-                } else {
-                    utfLength += 3;
-                }
-            }
-
-            if (utfLength > Integer::MAX_VALUE) {
-                throw UTFDataFormatException(__FILE__, __LINE__,
-                        (std::string("MarshallingSupport::asciiToModifiedUtf8 - Cannot marshall ")
-                                + "string utf8 encoding longer than: 2^31 bytes, supplied string utf8 encoding was: " + Integer::toString((int) utfLength)
-                                + " bytes long.").c_str());
-            }
-
-            std::string utfBytes((std::size_t) utfLength, '\0');
-            unsigned int utfIndex = 0;
-
-            for (std::size_t i = 0; i < length; i++) {
-
-                unsigned int charValue = (unsigned char) asciiString.at(i);
-
-                // Written to allow for expansion to wide character strings at some
-                // point, as it stands now the value can never be > 255 since the
-                // string class returns a single byte char.
-                if (charValue > 0 && charValue <= 127) {
-                    utfBytes[utfIndex++] = (char) charValue;
-                } else if (charValue <= 2047) {
-                    utfBytes[utfIndex++] = (char) (0xc0 | (0x1f & (charValue >> 6)));
-                    utfBytes[utfIndex++] = (char) (0x80 | (0x3f & charValue));
-                } else {
-                    utfBytes[utfIndex++] = (char) (0xe0 | (0x0f & (charValue >> 12)));
-                    utfBytes[utfIndex++] = (char) (0x80 | (0x3f & (charValue >> 6)));
-                    utfBytes[utfIndex++] = (char) (0x80 | (0x3f & charValue));
-                }
-            }
-
-            return utfBytes;
-        } else {
-            return "";
+        const unsigned char* data = (const unsigned char*) asciiString.c_str();
+        std::size_t length = asciiString.length();
+
+        // A string without zero or values above 127 is its own encoding.
+        std::size_t span = StringUtils::unencodedSpan(data, length);
+        if (span == length) {
+            return asciiString;
+        }
+
+        std::size_t utfLength = span + StringUtils::modifiedUtf8Length(data + span, length - span);
+
+        if (utfLength > (std::size_t) Integer::MAX_VALUE) {
+            throw UTFDataFormatException(__FILE__, __LINE__,
+                    (std::string("MarshallingSupport::asciiToModifiedUtf8 - Cannot marshall ")
+                            + "string utf8 encoding longer than: 2^31 bytes, supplied string utf8 encoding was: " + Long::toString((long long) utfLength)
+                            + " bytes long.").c_str());
         }
+
+        std::string utfBytes(utfLength, '\0');
+        StringUtils::encodeModifiedUtf8(data, length, (unsigned char*) &utfBytes[0]);
+
+        return utfBytes;
     }
     AMQ_CATCH_RETHROW(decaf::io::UTFDataFormatException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::UTFDataFormatException)
@@ -210,63 +181,10 @@ std::string MarshallingSupport::modifiedUtf8ToAscii(const std::string modifiedUt
         }
 
         std::vector<unsigned char> result(utfLength);
+        std::size_t length = StringUtils::decodeModifiedUtf8(
+            (const unsigned char*) modifiedUtf8String.c_str(), utfLength, &result[0]);
 
-        std::size_t count = 0;
-        std::size_t index = 0;
-        unsigned char a = 0;
-
-        while (count < utfLength) {
-            if ((result[index] = modifiedUtf8String[count++]) < 0x80) {
-                index++;
-            } else if (((a = result[index]) & 0xE0) == 0xC0) {
-                if (count >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of two byte char found at end.");
-                }
-
-                unsigned char b = modifiedUtf8String[count++];
-                if ((b & 0xC0) != 0x80) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, byte two does not start with 0x80.");
-                }
-
-                // 2-byte UTF8 encoding: 110X XXxx 10xx xxxx
-                // Bits set at 'X' means we have encountered a UTF8 encoded value
-                // greater than 255, which is not supported.
-                if (a & 0x1C) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 2 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
-
-                result[index++] = (unsigned char) (((a & 0x1F) << 6) | (b & 0x3F));
-
-            } else if ((a & 0xF0) == 0xE0) {
-
-                if (count + 1 >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of three byte char found at end.");
-                } else {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 3 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
-
-                // If we were to support multibyte strings in the future this would be
-                // the remainder of this method decoding logic.
-                //
-                //int b = modifiedUtf8String[count++];
-                //int c = modifiedUtf8String[count++];
-                //if( ( ( b & 0xC0 ) != 0x80 ) || ( ( c & 0xC0 ) != 0x80 ) ) {
-                //    throw UTFDataFormatException(
-                //        __FILE__, __LINE__,
-                //        "Invalid UTF-8 encoding found, byte two does not start with 0x80." );
-                //}
-                //
-                //result[inde++] = ( ( a & 0x0F ) << 12 ) |
-                //                 ( ( b & 0x3F ) << 6 ) | ( c & 0x3F );
-
-            } else {
-                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, aborting.");
-            }
-        }
-
-        return std::string((char*) (&result[0]), index);
+        return std::string((char*) (&result[0]), length);
     }
     AMQ_CATCH_RETHROW(decaf::io::UTFDataFormatException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::UTFDataFormatException)
@@ -17,19 +17,23 @@
 
 #include "MemoryUsage.h"
 #include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace activemq;
 using namespace activemq::util;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
 using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////
-MemoryUsage::MemoryUsage() : limit(0), usage(0), mutex() {
+MemoryUsage::MemoryUsage() : limit(0), usage(0), waiters(0), mutex() {
+    this->mutex.setProfilingSite("activemq.util.MemoryUsage");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-MemoryUsage::MemoryUsage(unsigned long long limit) : limit(limit), usage(), mutex() {
+MemoryUsage::MemoryUsage(unsigned long long limit) : limit(limit), usage(0), waiters(0), mutex() {
+    this->mutex.setProfilingSite("activemq.util.MemoryUsage");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,20 +43,50 @@ MemoryUsage::~MemoryUsage() {
 ////////////////////////////////////////////////////////////////////////////////
 void MemoryUsage::waitForSpace() {
 
+    if (!this->isFull()) {
+        return;
+    }
+
     synchronized(&mutex) {
-        while (this->isFull()) {
-            mutex.wait();
+
+        // Count this thread before checking again, a thread that frees space either
+        // sees the count and notifies or its update is seen here.
+        Atomics::incrementAndGet(&waiters);
+
+        try {
+            while (this->isFull()) {
+                mutex.wait();
+            }
+        } catch (...) {
+            Atomics::decrementAndGet(&waiters);
+            throw;
         }
+
+        Atomics::decrementAndGet(&waiters);
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void MemoryUsage::waitForSpace(unsigned int timeout) {
 
-    if (this->isFull()) {
-        synchronized(&mutex) {
-            mutex.wait(timeout);
+    if (!this->isFull()) {
+        return;
+    }
+
+    synchronized(&mutex) {
+
+        Atomics::incrementAndGet(&waiters);
+
+        try {
+            if (this->isFull()) {
+                mutex.wait(timeout);
+            }
+        } catch (...) {
+            Atomics::decrementAndGet(&waiters);
+            throw;
         }
+
+        Atomics::decrementAndGet(&waiters);
     }
 }
 
@@ -63,9 +97,7 @@ void MemoryUsage::increaseUsage(unsigned long long value) {
         return;
     }
 
-    synchronized(&mutex) {
-        this->usage += value;
-    }
+    Atomics::getAndAdd64(&usage, (long long) value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -75,19 +107,52 @@ void MemoryUsage::decreaseUsage(unsigned long long value) {
         return;
     }
 
-    synchronized(&mutex) {
-        value > this->usage ? this->usage = 0 : this->usage -= value;
-        mutex.notifyAll();
-    }
+    long long current = 0;
+    long long update = 0;
+
+    do {
+        current = Atomics::getAndAdd64(&usage, 0);
+        update = value > (unsigned long long) current ? 0 : current - (long long) value;
+    } while (!Atomics::compareAndSet64(&usage, current, update));
+
+    notifyWaiters();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool MemoryUsage::isFull() const {
-    bool result = false;
+    return (unsigned long long) Atomics::getAndAdd64(const_cast<volatile long long*>(&usage), 0) >= this->limit;
+}
 
-    synchronized(&mutex) {
-        result = this->usage >= this->limit;
-    }
+////////////////////////////////////////////////////////////////////////////////
+unsigned long long MemoryUsage::getUsage() const {
+    return (unsigned long long) Atomics::getAndAdd64(const_cast<volatile long long*>(&usage), 0);
+}
 
-    return result;
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setUsage(unsigned long long usage) {
+
+    long long current = 0;
+
+    do {
+        current = Atomics::getAndAdd64(&this->usage, 0);
+    } while (!Atomics::compareAndSet64(&this->usage, current, (long long) usage));
+
+    notifyWaiters();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::setLimit(unsigned long long limit) {
+    this->limit = limit;
+    notifyWaiters();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsage::notifyWaiters() {
+
+    // The atomic read orders this check after the preceding update of the usage.
+    if (Atomics::getAndAdd(&waiters, 0) > 0) {
+        synchronized(&mutex) {
+            mutex.notifyAll();
+        }
+    }
 }
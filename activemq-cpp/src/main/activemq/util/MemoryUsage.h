@@ -25,18 +25,34 @@
 namespace activemq {
 namespace util {
 
+    /**
+     * Tracks the amount of memory used against a fixed limit.  The usage is kept in an
+     * atomic counter so increasing, decreasing and checking it never takes a lock, only
+     * a thread that finds the usage at or above the limit parks on the internal Mutex,
+     * and the Mutex is only notified when such a thread is present.
+     */
     class AMQCPP_API MemoryUsage : public Usage {
     private:
 
         // The physical limit of memory usage this object allows.
-        unsigned long long limit;
+        volatile unsigned long long limit;
 
         // Amount of memory currently used in.
-        unsigned long long usage;
+        volatile long long usage;
 
-        // Mutex to lock usage and wait on.
+        // Number of threads that are parked, or about to park, waiting for space.
+        volatile int waiters;
+
+        // Mutex that threads waiting for space park on.
         mutable decaf::util::concurrent::Mutex mutex;
 
+    private:
+
+        MemoryUsage(const MemoryUsage&);
+        MemoryUsage& operator= (const MemoryUsage&);
+
+        void notifyWaiters();
+
     public:
 
         /**
@@ -95,17 +111,13 @@ namespace util {
          * Gets the current usage amount.
          * @return the amount of bytes currently used.
          */
-        unsigned long long getUsage() const {
-            return usage;
-        }
+        unsigned long long getUsage() const;
 
         /**
          * Sets the current usage amount
          * @param usage - The amount to tag as used.
          */
-        void setUsage(unsigned long long usage) {
-            this->usage = usage;
-        }
+        void setUsage(unsigned long long usage);
 
         /**
          * Gets the current limit amount.
@@ -119,9 +131,7 @@ namespace util {
          * Sets the current limit amount
          * @param limit - The amount that can be used before full.
          */
-        void setLimit(unsigned long long limit) {
-            this->limit = limit;
-        }
+        void setLimit(unsigned long long limit);
 
     };
 
@@ -0,0 +1,1269 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageSelector.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <cms/DeliveryMode.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/exceptions/NumberFormatException.h>
+
+#include <locale>
+#include <set>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * A value on the evaluation stack, NULL stands for SQL's unknown.
+     */
+    struct SelectorValue {
+
+        enum Type {
+            NULL_VALUE,
+            BOOLEAN_VALUE,
+            LONG_VALUE,
+            DOUBLE_VALUE,
+            STRING_VALUE
+        };
+
+        Type type;
+        bool boolValue;
+        long long longValue;
+        double doubleValue;
+        std::string stringValue;
+
+        SelectorValue() : type(NULL_VALUE), boolValue(false), longValue(0), doubleValue(0), stringValue() {}
+
+        static SelectorValue ofBool(bool value) {
+            SelectorValue result;
+            result.type = BOOLEAN_VALUE;
+            result.boolValue = value;
+            return result;
+        }
+
+        static SelectorValue ofLong(long long value) {
+            SelectorValue result;
+            result.type = LONG_VALUE;
+            result.longValue = value;
+            return result;
+        }
+
+        static SelectorValue ofDouble(double value) {
+            SelectorValue result;
+            result.type = DOUBLE_VALUE;
+            result.doubleValue = value;
+            return result;
+        }
+
+        static SelectorValue ofString(const std::string& value) {
+            SelectorValue result;
+            result.type = STRING_VALUE;
+            result.stringValue = value;
+            return result;
+        }
+
+        bool isNull() const {
+            return type == NULL_VALUE;
+        }
+
+        bool isNumber() const {
+            return type == LONG_VALUE || type == DOUBLE_VALUE;
+        }
+
+        bool isTrue() const {
+            return type == BOOLEAN_VALUE && boolValue;
+        }
+
+        bool isFalse() const {
+            return type == BOOLEAN_VALUE && !boolValue;
+        }
+
+        double asDouble() const {
+            return type == LONG_VALUE ? (double) longValue : doubleValue;
+        }
+    };
+
+    enum HeaderField {
+        NOT_A_HEADER = -1,
+        JMS_DELIVERY_MODE,
+        JMS_PRIORITY,
+        JMS_MESSAGE_ID,
+        JMS_TIMESTAMP,
+        JMS_CORRELATION_ID,
+        JMS_TYPE,
+        JMS_EXPIRATION,
+        JMS_REDELIVERED
+    };
+
+    HeaderField getHeaderField(const std::string& name) {
+
+        if (name.compare(0, 3, "JMS") != 0) {
+            return NOT_A_HEADER;
+        } else if (name == "JMSDeliveryMode") {
+            return JMS_DELIVERY_MODE;
+        } else if (name == "JMSPriority") {
+            return JMS_PRIORITY;
+        } else if (name == "JMSMessageID") {
+            return JMS_MESSAGE_ID;
+        } else if (name == "JMSTimestamp") {
+            return JMS_TIMESTAMP;
+        } else if (name == "JMSCorrelationID") {
+            return JMS_CORRELATION_ID;
+        } else if (name == "JMSType") {
+            return JMS_TYPE;
+        } else if (name == "JMSExpiration") {
+            return JMS_EXPIRATION;
+        } else if (name == "JMSRedelivered") {
+            return JMS_REDELIVERED;
+        }
+
+        return NOT_A_HEADER;
+    }
+
+    /**
+     * Where the identifiers of a selector are looked up.
+     */
+    class ValueSource {
+    public:
+
+        virtual ~ValueSource() {}
+
+        virtual SelectorValue getProperty(const std::string& name) const = 0;
+
+        virtual SelectorValue getHeader(int field) const = 0;
+
+    };
+
+    SelectorValue nonEmpty(const std::string& value) {
+        return value.empty() ? SelectorValue() : SelectorValue::ofString(value);
+    }
+
+    class MessageValueSource : public ValueSource {
+    private:
+
+        const cms::Message* message;
+
+    public:
+
+        MessageValueSource(const cms::Message* message) : message(message) {}
+
+        virtual SelectorValue getProperty(const std::string& name) const {
+
+            if (!message->propertyExists(name)) {
+                return SelectorValue();
+            }
+
+            switch (message->getPropertyValueType(name)) {
+                case cms::Message::BOOLEAN_TYPE:
+                    return SelectorValue::ofBool(message->getBooleanProperty(name));
+                case cms::Message::BYTE_TYPE:
+                case cms::Message::SHORT_TYPE:
+                case cms::Message::INTEGER_TYPE:
+                case cms::Message::LONG_TYPE:
+                    return SelectorValue::ofLong(message->getLongProperty(name));
+                case cms::Message::FLOAT_TYPE:
+                case cms::Message::DOUBLE_TYPE:
+                    return SelectorValue::ofDouble(message->getDoubleProperty(name));
+                case cms::Message::STRING_TYPE:
+                    return SelectorValue::ofString(message->getStringProperty(name));
+                default:
+                    return SelectorValue();
+            }
+        }
+
+        virtual SelectorValue getHeader(int field) const {
+
+            switch (field) {
+                case JMS_DELIVERY_MODE:
+                    return SelectorValue::ofString(message->getCMSDeliveryMode() == cms::DeliveryMode::PERSISTENT ?
+                                                   "PERSISTENT" : "NON_PERSISTENT");
+                case JMS_PRIORITY:
+                    return SelectorValue::ofLong(message->getCMSPriority());
+                case JMS_MESSAGE_ID:
+                    return nonEmpty(message->getCMSMessageID());
+                case JMS_TIMESTAMP:
+                    return SelectorValue::ofLong(message->getCMSTimestamp());
+                case JMS_CORRELATION_ID:
+                    return nonEmpty(message->getCMSCorrelationID());
+                case JMS_TYPE:
+                    return nonEmpty(message->getCMSType());
+                case JMS_EXPIRATION:
+                    return SelectorValue::ofLong(message->getCMSExpiration());
+                case JMS_REDELIVERED:
+                    return SelectorValue::ofBool(message->getCMSRedelivered());
+                default:
+                    return SelectorValue();
+            }
+        }
+    };
+
+    class MapValueSource : public ValueSource {
+    private:
+
+        const PrimitiveMap& properties;
+
+    public:
+
+        MapValueSource(const PrimitiveMap& properties) : properties(properties) {}
+
+        virtual SelectorValue getProperty(const std::string& name) const {
+
+            if (!properties.containsKey(name)) {
+                return SelectorValue();
+            }
+
+            switch (properties.getValueType(name)) {
+                case PrimitiveValueNode::BOOLEAN_TYPE:
+                    return SelectorValue::ofBool(properties.getBool(name));
+                case PrimitiveValueNode::BYTE_TYPE:
+                case PrimitiveValueNode::SHORT_TYPE:
+                case PrimitiveValueNode::INTEGER_TYPE:
+                case PrimitiveValueNode::LONG_TYPE:
+                    return SelectorValue::ofLong(properties.getLong(name));
+                case PrimitiveValueNode::FLOAT_TYPE:
+                case PrimitiveValueNode::DOUBLE_TYPE:
+                    return SelectorValue::ofDouble(properties.getDouble(name));
+                case PrimitiveValueNode::STRING_TYPE:
+                case PrimitiveValueNode::BIG_STRING_TYPE:
+                    return SelectorValue::ofString(properties.getString(name));
+                default:
+                    return SelectorValue();
+            }
+        }
+
+        virtual SelectorValue getHeader(int field AMQCPP_UNUSED) const {
+            return SelectorValue();
+        }
+    };
+
+    enum OpCode {
+        PUSH_CONSTANT,
+        PUSH_PROPERTY,
+        PUSH_HEADER,
+        JUMP_IF_FALSE,
+        JUMP_IF_TRUE,
+        AND,
+        OR,
+        NOT,
+        EQUAL,
+        NOT_EQUAL,
+        LESS,
+        GREATER,
+        LESS_EQUAL,
+        GREATER_EQUAL,
+        BETWEEN,
+        IN,
+        LIKE,
+        IS_NULL,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        NEGATE
+    };
+
+    struct Instruction {
+        OpCode opcode;
+        int operand;
+
+        Instruction(OpCode opcode, int operand) : opcode(opcode), operand(operand) {}
+    };
+
+    // A LIKE pattern is a run of byte values, with the wildcards below in it.
+    const int ANY_CHARACTER = -1;
+    const int ANY_CHARACTERS = -2;
+
+    typedef std::vector<int> LikePattern;
+
+    /**
+     * Skips over one UTF-8 encoded character so that '_' matches a whole character.
+     */
+    std::size_t nextCharacter(const std::string& value, std::size_t index) {
+        index++;
+        while (index < value.size() && (((unsigned char) value[index]) & 0xC0) == 0x80) {
+            index++;
+        }
+        return index;
+    }
+
+    bool likeMatches(const LikePattern& pattern, const std::string& value) {
+
+        std::size_t p = 0;
+        std::size_t v = 0;
+        std::size_t starPattern = std::string::npos;
+        std::size_t starValue = 0;
+
+        while (v < value.size()) {
+            if (p < pattern.size() && pattern[p] == ANY_CHARACTER) {
+                p++;
+                v = nextCharacter(value, v);
+            } else if (p < pattern.size() && pattern[p] == (unsigned char) value[v]) {
+                p++;
+                v++;
+            } else if (p < pattern.size() && pattern[p] == ANY_CHARACTERS) {
+                starPattern = p++;
+                starValue = v;
+            } else if (starPattern != std::string::npos) {
+                // Let the last '%' swallow one more character and retry from there.
+                p = starPattern + 1;
+                starValue = nextCharacter(value, starValue);
+                v = starValue;
+            } else {
+                return false;
+            }
+        }
+
+        while (p < pattern.size() && pattern[p] == ANY_CHARACTERS) {
+            p++;
+        }
+
+        return p == pattern.size();
+    }
+
+    // Three valued logic, NULL is unknown.
+    SelectorValue logicalAnd(const SelectorValue& left, const SelectorValue& right) {
+        if (left.isFalse() || right.isFalse()) {
+            return SelectorValue::ofBool(false);
+        } else if (left.isTrue() && right.isTrue()) {
+            return SelectorValue::ofBool(true);
+        }
+        return SelectorValue();
+    }
+
+    SelectorValue logicalOr(const SelectorValue& left, const SelectorValue& right) {
+        if (left.isTrue() || right.isTrue()) {
+            return SelectorValue::ofBool(true);
+        } else if (left.isFalse() && right.isFalse()) {
+            return SelectorValue::ofBool(false);
+        }
+        return SelectorValue();
+    }
+
+    SelectorValue compare(OpCode opcode, const SelectorValue& left, const SelectorValue& right) {
+
+        if (left.isNull() || right.isNull()) {
+            return SelectorValue();
+        }
+
+        int order = 0;
+
+        if (left.type == SelectorValue::LONG_VALUE && right.type == SelectorValue::LONG_VALUE) {
+            order = left.longValue < right.longValue ? -1 : (left.longValue > right.longValue ? 1 : 0);
+        } else if (left.isNumber() && right.isNumber()) {
+            double l = left.asDouble();
+            double r = right.asDouble();
+            if (l != l || r != r) {
+                // NaN compares false to everything, itself included.
+                return SelectorValue::ofBool(opcode == NOT_EQUAL);
+            }
+            order = l < r ? -1 : (l > r ? 1 : 0);
+        } else if (left.type == SelectorValue::STRING_VALUE && right.type == SelectorValue::STRING_VALUE) {
+            order = left.stringValue.compare(right.stringValue);
+        } else if (left.type == SelectorValue::BOOLEAN_VALUE && right.type == SelectorValue::BOOLEAN_VALUE) {
+            if (opcode != EQUAL && opcode != NOT_EQUAL) {
+                return SelectorValue::ofBool(false);
+            }
+            order = left.boolValue == right.boolValue ? 0 : 1;
+        } else {
+            // Values of different types are never equal, nor unequal.
+            return SelectorValue::ofBool(false);
+        }
+
+        switch (opcode) {
+            case EQUAL:
+                return SelectorValue::ofBool(order == 0);
+            case NOT_EQUAL:
+                return SelectorValue::ofBool(order != 0);
+            case LESS:
+                return SelectorValue::ofBool(order < 0);
+            case GREATER:
+                return SelectorValue::ofBool(order > 0);
+            case LESS_EQUAL:
+                return SelectorValue::ofBool(order <= 0);
+            default:
+                return SelectorValue::ofBool(order >= 0);
+        }
+    }
+
+    SelectorValue arithmetic(OpCode opcode, const SelectorValue& left, const SelectorValue& right) {
+
+        if (!left.isNumber() || !right.isNumber()) {
+            return SelectorValue();
+        }
+
+        if (left.type == SelectorValue::LONG_VALUE && right.type == SelectorValue::LONG_VALUE) {
+            switch (opcode) {
+                case ADD:
+                    return SelectorValue::ofLong(left.longValue + right.longValue);
+                case SUBTRACT:
+                    return SelectorValue::ofLong(left.longValue - right.longValue);
+                case MULTIPLY:
+                    return SelectorValue::ofLong(left.longValue * right.longValue);
+                default:
+                    if (right.longValue == 0) {
+                        return SelectorValue();
+                    }
+                    return SelectorValue::ofLong(left.longValue / right.longValue);
+            }
+        }
+
+        double l = left.asDouble();
+        double r = right.asDouble();
+
+        switch (opcode) {
+            case ADD:
+                return SelectorValue::ofDouble(l + r);
+            case SUBTRACT:
+                return SelectorValue::ofDouble(l - r);
+            case MULTIPLY:
+                return SelectorValue::ofDouble(l * r);
+            default:
+                return SelectorValue::ofDouble(l / r);
+        }
+    }
+
+    enum TokenType {
+        END_OF_INPUT,
+        IDENTIFIER,
+        STRING_LITERAL,
+        LONG_LITERAL,
+        DOUBLE_LITERAL,
+        KEYWORD,
+        OPERATOR
+    };
+
+    struct Token {
+        TokenType type;
+        std::string text;
+        std::size_t position;
+        long long longValue;
+        double doubleValue;
+
+        Token() : type(END_OF_INPUT), text(), position(0), longValue(0), doubleValue(0) {}
+    };
+
+    /**
+     * The static type of an expression, used to reject selectors such as "a + 1" or
+     * "NOT 'x'" when they are compiled.  Identifiers may hold a value of any type.
+     */
+    enum ExpressionKind {
+        ANY_EXPRESSION,
+        BOOLEAN_EXPRESSION,
+        NUMERIC_EXPRESSION,
+        STRING_EXPRESSION
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace util {
+
+    class MessageSelectorImpl {
+    private:
+
+        MessageSelectorImpl(const MessageSelectorImpl&);
+        MessageSelectorImpl& operator= (const MessageSelectorImpl&);
+
+    public:
+
+        std::vector<Instruction> program;
+        std::vector<SelectorValue> constants;
+        std::vector<std::string> properties;
+        std::vector<LikePattern> patterns;
+        std::vector< std::set<std::string> > sets;
+
+        MessageSelectorImpl() : program(), constants(), properties(), patterns(), sets() {}
+
+        bool evaluate(const ValueSource& source) const {
+
+            if (this->program.empty()) {
+                return true;
+            }
+
+            std::vector<SelectorValue> stack;
+            stack.reserve(8);
+
+            std::size_t count = this->program.size();
+            for (std::size_t pc = 0; pc < count; ++pc) {
+
+                const Instruction& instruction = this->program[pc];
+
+                switch (instruction.opcode) {
+                    case PUSH_CONSTANT:
+                        stack.push_back(this->constants[instruction.operand]);
+                        break;
+                    case PUSH_PROPERTY:
+                        stack.push_back(source.getProperty(this->properties[instruction.operand]));
+                        break;
+                    case PUSH_HEADER:
+                        stack.push_back(source.getHeader(instruction.operand));
+                        break;
+                    case JUMP_IF_FALSE:
+                        // The operand is decided, leave it as the result and skip the other side.
+                        if (stack.back().isFalse()) {
+                            pc = (std::size_t) instruction.operand - 1;
+                        }
+                        break;
+                    case JUMP_IF_TRUE:
+                        if (stack.back().isTrue()) {
+                            pc = (std::size_t) instruction.operand - 1;
+                        }
+                        break;
+                    case NOT: {
+                        SelectorValue& top = stack.back();
+                        top = top.type == SelectorValue::BOOLEAN_VALUE ? SelectorValue::ofBool(!top.boolValue) : SelectorValue();
+                        break;
+                    }
+                    case IS_NULL:
+                        stack.back() = SelectorValue::ofBool(stack.back().isNull());
+                        break;
+                    case NEGATE: {
+                        SelectorValue& top = stack.back();
+                        if (top.type == SelectorValue::LONG_VALUE) {
+                            top.longValue = -top.longValue;
+                        } else if (top.type == SelectorValue::DOUBLE_VALUE) {
+                            top.doubleValue = -top.doubleValue;
+                        } else {
+                            top = SelectorValue();
+                        }
+                        break;
+                    }
+                    case LIKE: {
+                        SelectorValue& top = stack.back();
+                        if (top.type == SelectorValue::STRING_VALUE) {
+                            top = SelectorValue::ofBool(likeMatches(this->patterns[instruction.operand], top.stringValue));
+                        } else if (!top.isNull()) {
+                            top = SelectorValue::ofBool(false);
+                        }
+                        break;
+                    }
+                    case IN: {
+                        SelectorValue& top = stack.back();
+                        if (top.type == SelectorValue::STRING_VALUE) {
+                            const std::set<std::string>& set = this->sets[instruction.operand];
+                            top = SelectorValue::ofBool(set.find(top.stringValue) != set.end());
+                        } else if (!top.isNull()) {
+                            top = SelectorValue::ofBool(false);
+                        }
+                        break;
+                    }
+                    case BETWEEN: {
+                        SelectorValue upper = stack.back();
+                        stack.pop_back();
+                        SelectorValue lower = stack.back();
+                        stack.pop_back();
+                        SelectorValue& value = stack.back();
+                        value = logicalAnd(compare(GREATER_EQUAL, value, lower), compare(LESS_EQUAL, value, upper));
+                        break;
+                    }
+                    default: {
+                        SelectorValue right = stack.back();
+                        stack.pop_back();
+                        SelectorValue& left = stack.back();
+
+                        switch (instruction.opcode) {
+                            case AND:
+                                left = logicalAnd(left, right);
+                                break;
+                            case OR:
+                                left = logicalOr(left, right);
+                                break;
+                            case ADD:
+                            case SUBTRACT:
+                            case MULTIPLY:
+                            case DIVIDE:
+                                left = arithmetic(instruction.opcode, left, right);
+                                break;
+                            default:
+                                left = compare(instruction.opcode, left, right);
+                                break;
+                        }
+                        break;
+                    }
+                }
+            }
+
+            return stack.back().isTrue();
+        }
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Recursive descent parser that emits the program of a MessageSelectorImpl in
+     * postfix order, operator precedence follows the JMS specification.
+     */
+    class SelectorParser {
+    private:
+
+        const std::string& selector;
+        MessageSelectorImpl& impl;
+
+        std::vector<Token> tokens;
+        std::size_t current;
+
+    private:
+
+        SelectorParser(const SelectorParser&);
+        SelectorParser& operator= (const SelectorParser&);
+
+    public:
+
+        SelectorParser(const std::string& selector, MessageSelectorImpl& impl) :
+            selector(selector), impl(impl), tokens(), current(0) {
+        }
+
+        void parse() {
+
+            tokenize();
+
+            if (tokens.size() == 1) {
+                return;
+            }
+
+            ExpressionKind kind = parseOr();
+            expectBoolean(kind, tokens[0]);
+
+            if (peek().type != END_OF_INPUT) {
+                fail("unexpected '" + peek().text + "'", peek());
+            }
+        }
+
+    private:
+
+        void fail(const std::string& message, const Token& token) const {
+            std::ostringstream stream;
+            stream << "Invalid selector \"" << selector << "\": " << message
+                   << " at position " << (token.position + 1);
+            throw cms::InvalidSelectorException(stream.str());
+        }
+
+        void fail(const std::string& message, std::size_t position) const {
+            Token token;
+            token.position = position;
+            fail(message, token);
+        }
+
+        static bool isIdentifierStart(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$';
+        }
+
+        static bool isIdentifierPart(char c) {
+            return isIdentifierStart(c) || (c >= '0' && c <= '9') || c == '.';
+        }
+
+        static bool isDigit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        static std::string toUpper(const std::string& value) {
+            std::string result(value);
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                if (result[i] >= 'a' && result[i] <= 'z') {
+                    result[i] = (char) (result[i] - 'a' + 'A');
+                }
+            }
+            return result;
+        }
+
+        static bool isKeyword(const std::string& upper) {
+            return upper == "NOT" || upper == "AND" || upper == "OR" || upper == "BETWEEN" ||
+                   upper == "LIKE" || upper == "ESCAPE" || upper == "IN" || upper == "IS" ||
+                   upper == "NULL" || upper == "TRUE" || upper == "FALSE";
+        }
+
+        void tokenize() {
+
+            std::size_t length = selector.size();
+            std::size_t i = 0;
+
+            while (true) {
+
+                while (i < length && (selector[i] == ' ' || selector[i] == '\t' ||
+                                      selector[i] == '\r' || selector[i] == '\n' || selector[i] == '\f')) {
+                    i++;
+                }
+
+                Token token;
+                token.position = i;
+
+                if (i >= length) {
+                    tokens.push_back(token);
+                    return;
+                }
+
+                char c = selector[i];
+
+                if (isIdentifierStart(c)) {
+                    std::size_t start = i;
+                    while (i < length && isIdentifierPart(selector[i])) {
+                        i++;
+                    }
+                    token.text = selector.substr(start, i - start);
+                    std::string upper = toUpper(token.text);
+                    if (isKeyword(upper)) {
+                        token.type = KEYWORD;
+                        token.text = upper;
+                    } else {
+                        token.type = IDENTIFIER;
+                    }
+                } else if (c == '\'') {
+                    token.type = STRING_LITERAL;
+                    i++;
+                    while (true) {
+                        if (i >= length) {
+                            fail("unterminated string literal", token);
+                        } else if (selector[i] == '\'') {
+                            // A doubled quote stands for a quote inside the literal.
+                            if (i + 1 < length && selector[i + 1] == '\'') {
+                                token.text += '\'';
+                                i += 2;
+                            } else {
+                                i++;
+                                break;
+                            }
+                        } else {
+                            token.text += selector[i++];
+                        }
+                    }
+                } else if (isDigit(c) || (c == '.' && i + 1 < length && isDigit(selector[i + 1]))) {
+                    i = readNumber(i, token);
+                } else {
+                    token.type = OPERATOR;
+                    if ((c == '<' && i + 1 < length && (selector[i + 1] == '>' || selector[i + 1] == '=')) ||
+                        (c == '>' && i + 1 < length && selector[i + 1] == '=')) {
+                        token.text = selector.substr(i, 2);
+                        i += 2;
+                    } else if (c == '=' || c == '<' || c == '>' || c == '+' || c == '-' ||
+                               c == '*' || c == '/' || c == '(' || c == ')' || c == ',') {
+                        token.text = std::string(1, c);
+                        i++;
+                    } else {
+                        fail(std::string("unexpected character '") + c + "'", token);
+                    }
+                }
+
+                tokens.push_back(token);
+            }
+        }
+
+        std::size_t readNumber(std::size_t i, Token& token) {
+
+            std::size_t length = selector.size();
+            std::size_t start = i;
+
+            // Hexadecimal integer.
+            if (selector[i] == '0' && i + 1 < length && (selector[i + 1] == 'x' || selector[i + 1] == 'X')) {
+                i += 2;
+                std::size_t digits = i;
+                while (i < length && (isDigit(selector[i]) || (selector[i] >= 'a' && selector[i] <= 'f') ||
+                                      (selector[i] >= 'A' && selector[i] <= 'F'))) {
+                    i++;
+                }
+                token.text = selector.substr(start, i - start);
+                token.type = LONG_LITERAL;
+                token.longValue = parseLong(selector.substr(digits, i - digits), 16, token);
+                return skipLongSuffix(i);
+            }
+
+            bool approximate = false;
+            while (i < length && isDigit(selector[i])) {
+                i++;
+            }
+            if (i < length && selector[i] == '.') {
+                approximate = true;
+                i++;
+                while (i < length && isDigit(selector[i])) {
+                    i++;
+                }
+            }
+            if (i < length && (selector[i] == 'e' || selector[i] == 'E')) {
+                std::size_t exponent = i + 1;
+                if (exponent < length && (selector[exponent] == '+' || selector[exponent] == '-')) {
+                    exponent++;
+                }
+                if (exponent < length && isDigit(selector[exponent])) {
+                    approximate = true;
+                    i = exponent;
+                    while (i < length && isDigit(selector[i])) {
+                        i++;
+                    }
+                }
+            }
+
+            token.text = selector.substr(start, i - start);
+
+            if (approximate || (i < length && (selector[i] == 'd' || selector[i] == 'D' ||
+                                               selector[i] == 'f' || selector[i] == 'F'))) {
+                // Parsed in the classic locale so a ',' decimal point never applies.
+                std::istringstream stream(token.text);
+                stream.imbue(std::locale::classic());
+                stream >> token.doubleValue;
+                if (stream.fail()) {
+                    fail("invalid number '" + token.text + "'", token);
+                }
+                token.type = DOUBLE_LITERAL;
+                if (i < length && (selector[i] == 'd' || selector[i] == 'D' ||
+                                   selector[i] == 'f' || selector[i] == 'F')) {
+                    i++;
+                }
+                return i;
+            }
+
+            token.type = LONG_LITERAL;
+            if (token.text.size() > 1 && token.text[0] == '0') {
+                token.longValue = parseLong(token.text.substr(1), 8, token);
+            } else {
+                token.longValue = parseLong(token.text, 10, token);
+            }
+
+            return skipLongSuffix(i);
+        }
+
+        std::size_t skipLongSuffix(std::size_t i) const {
+            if (i < selector.size() && (selector[i] == 'l' || selector[i] == 'L')) {
+                i++;
+            }
+            return i;
+        }
+
+        long long parseLong(const std::string& digits, int radix, const Token& token) const {
+            try {
+                return Long::parseLong(digits, radix);
+            } catch (NumberFormatException& ex) {
+                fail("invalid number '" + token.text + "'", token);
+            }
+            return 0;
+        }
+
+        const Token& peek() const {
+            return tokens[current];
+        }
+
+        const Token& next() {
+            const Token& token = tokens[current];
+            if (token.type != END_OF_INPUT) {
+                current++;
+            }
+            return token;
+        }
+
+        bool acceptKeyword(const char* keyword) {
+            if (peek().type == KEYWORD && peek().text == keyword) {
+                current++;
+                return true;
+            }
+            return false;
+        }
+
+        bool acceptOperator(const char* op) {
+            if (peek().type == OPERATOR && peek().text == op) {
+                current++;
+                return true;
+            }
+            return false;
+        }
+
+        void expectKeyword(const char* keyword) {
+            if (!acceptKeyword(keyword)) {
+                fail(std::string("expected ") + keyword, peek());
+            }
+        }
+
+        void expectOperator(const char* op) {
+            if (!acceptOperator(op)) {
+                fail(std::string("expected '") + op + "'", peek());
+            }
+        }
+
+        void expectBoolean(ExpressionKind kind, const Token& token) const {
+            if (kind != BOOLEAN_EXPRESSION && kind != ANY_EXPRESSION) {
+                fail("expected a boolean expression", token);
+            }
+        }
+
+        void expectNumeric(ExpressionKind kind, const Token& token) const {
+            if (kind != NUMERIC_EXPRESSION && kind != ANY_EXPRESSION) {
+                fail("expected a numeric expression", token);
+            }
+        }
+
+        void expectString(ExpressionKind kind, const Token& token) const {
+            if (kind != STRING_EXPRESSION && kind != ANY_EXPRESSION) {
+                fail("expected a string expression", token);
+            }
+        }
+
+        std::string expectStringLiteral() {
+            if (peek().type != STRING_LITERAL) {
+                fail("expected a string literal", peek());
+            }
+            return next().text;
+        }
+
+        int emit(OpCode opcode, int operand = 0) {
+            impl.program.push_back(Instruction(opcode, operand));
+            return (int) impl.program.size() - 1;
+        }
+
+        void emitConstant(const SelectorValue& value) {
+            impl.constants.push_back(value);
+            emit(PUSH_CONSTANT, (int) impl.constants.size() - 1);
+        }
+
+        void patchJump(int jump) {
+            impl.program[jump].operand = (int) impl.program.size();
+        }
+
+        // orExpression := andExpression ( OR andExpression )*
+        ExpressionKind parseOr() {
+            const Token& start = peek();
+            ExpressionKind kind = parseAnd();
+
+            while (peek().type == KEYWORD && peek().text == "OR") {
+                expectBoolean(kind, start);
+                const Token& op = next();
+                int jump = emit(JUMP_IF_TRUE);
+                expectBoolean(parseAnd(), op);
+                emit(OR);
+                patchJump(jump);
+                kind = BOOLEAN_EXPRESSION;
+            }
+
+            return kind;
+        }
+
+        // andExpression := notExpression ( AND notExpression )*
+        ExpressionKind parseAnd() {
+            const Token& start = peek();
+            ExpressionKind kind = parseNot();
+
+            while (peek().type == KEYWORD && peek().text == "AND") {
+                expectBoolean(kind, start);
+                const Token& op = next();
+                int jump = emit(JUMP_IF_FALSE);
+                expectBoolean(parseNot(), op);
+                emit(AND);
+                patchJump(jump);
+                kind = BOOLEAN_EXPRESSION;
+            }
+
+            return kind;
+        }
+
+        // notExpression := NOT notExpression | equalityExpression
+        ExpressionKind parseNot() {
+            const Token& op = peek();
+
+            if (acceptKeyword("NOT")) {
+                expectBoolean(parseNot(), op);
+                emit(NOT);
+                return BOOLEAN_EXPRESSION;
+            }
+
+            return parseEquality();
+        }
+
+        // equalityExpression := comparison ( ( '=' | '<>' ) comparison | IS [NOT] NULL )*
+        ExpressionKind parseEquality() {
+            ExpressionKind kind = parseComparison();
+
+            while (true) {
+                if (acceptOperator("=")) {
+                    parseComparison();
+                    emit(EQUAL);
+                } else if (acceptOperator("<>")) {
+                    parseComparison();
+                    emit(NOT_EQUAL);
+                } else if (acceptKeyword("IS")) {
+                    bool negated = acceptKeyword("NOT");
+                    expectKeyword("NULL");
+                    emit(IS_NULL);
+                    if (negated) {
+                        emit(NOT);
+                    }
+                } else {
+                    return kind;
+                }
+                kind = BOOLEAN_EXPRESSION;
+            }
+        }
+
+        // comparison := additive ( ( '<' | '>' | '<=' | '>=' ) additive
+        //                        | [NOT] LIKE string [ESCAPE string]
+        //                        | [NOT] BETWEEN additive AND additive
+        //                        | [NOT] IN '(' string ( ',' string )* ')' )*
+        ExpressionKind parseComparison() {
+            const Token& start = peek();
+            ExpressionKind kind = parseAdditive();
+
+            while (true) {
+                const Token& op = peek();
+
+                if (acceptOperator("<")) {
+                    parseAdditive();
+                    emit(LESS);
+                } else if (acceptOperator(">")) {
+                    parseAdditive();
+                    emit(GREATER);
+                } else if (acceptOperator("<=")) {
+                    parseAdditive();
+                    emit(LESS_EQUAL);
+                } else if (acceptOperator(">=")) {
+                    parseAdditive();
+                    emit(GREATER_EQUAL);
+                } else {
+                    bool negated = false;
+                    if (peek().type == KEYWORD && peek().text == "NOT" && current + 1 < tokens.size() &&
+                        tokens[current + 1].type == KEYWORD &&
+                        (tokens[current + 1].text == "LIKE" || tokens[current + 1].text == "BETWEEN" ||
+                         tokens[current + 1].text == "IN")) {
+
+                        negated = true;
+                        current++;
+                    }
+
+                    if (acceptKeyword("LIKE")) {
+                        expectString(kind, start);
+                        parseLike();
+                    } else if (acceptKeyword("BETWEEN")) {
+                        expectNumeric(kind, start);
+                        expectNumeric(parseAdditive(), op);
+                        expectKeyword("AND");
+                        expectNumeric(parseAdditive(), op);
+                        emit(BETWEEN);
+                    } else if (acceptKeyword("IN")) {
+                        expectString(kind, start);
+                        parseIn();
+                    } else {
+                        return kind;
+                    }
+
+                    if (negated) {
+                        emit(NOT);
+                    }
+                }
+
+                kind = BOOLEAN_EXPRESSION;
+            }
+        }
+
+        void parseLike() {
+
+            const Token& patternToken = peek();
+            std::string pattern = expectStringLiteral();
+
+            int escape = -1;
+            if (acceptKeyword("ESCAPE")) {
+                const Token& escapeToken = peek();
+                std::string text = expectStringLiteral();
+                if (text.size() != 1) {
+                    fail("the ESCAPE string must be a single character", escapeToken);
+                }
+                escape = (unsigned char) text[0];
+            }
+
+            LikePattern compiled;
+            for (std::size_t i = 0; i < pattern.size(); ++i) {
+                int c = (unsigned char) pattern[i];
+                if (c == escape) {
+                    if (++i == pattern.size()) {
+                        fail("the LIKE pattern ends with its escape character", patternToken);
+                    }
+                    compiled.push_back((unsigned char) pattern[i]);
+                } else if (c == '%') {
+                    // Consecutive '%' match no more than a single one.
+                    if (compiled.empty() || compiled.back() != ANY_CHARACTERS) {
+                        compiled.push_back(ANY_CHARACTERS);
+                    }
+                } else if (c == '_') {
+                    compiled.push_back(ANY_CHARACTER);
+                } else {
+                    compiled.push_back(c);
+                }
+            }
+
+            impl.patterns.push_back(compiled);
+            emit(LIKE, (int) impl.patterns.size() - 1);
+        }
+
+        void parseIn() {
+
+            expectOperator("(");
+
+            std::set<std::string> values;
+            values.insert(expectStringLiteral());
+            while (acceptOperator(",")) {
+                values.insert(expectStringLiteral());
+            }
+
+            expectOperator(")");
+
+            impl.sets.push_back(values);
+            emit(IN, (int) impl.sets.size() - 1);
+        }
+
+        // additive := multiplicative ( ( '+' | '-' ) multiplicative )*
+        ExpressionKind parseAdditive() {
+            const Token& start = peek();
+            ExpressionKind kind = parseMultiplicative();
+
+            while (peek().type == OPERATOR && (peek().text == "+" || peek().text == "-")) {
+                expectNumeric(kind, start);
+                const Token& op = next();
+                expectNumeric(parseMultiplicative(), op);
+                emit(op.text == "+" ? ADD : SUBTRACT);
+                kind = NUMERIC_EXPRESSION;
+            }
+
+            return kind;
+        }
+
+        // multiplicative := unary ( ( '*' | '/' ) unary )*
+        ExpressionKind parseMultiplicative() {
+            const Token& start = peek();
+            ExpressionKind kind = parseUnary();
+
+            while (peek().type == OPERATOR && (peek().text == "*" || peek().text == "/")) {
+                expectNumeric(kind, start);
+                const Token& op = next();
+                expectNumeric(parseUnary(), op);
+                emit(op.text == "*" ? MULTIPLY : DIVIDE);
+                kind = NUMERIC_EXPRESSION;
+            }
+
+            return kind;
+        }
+
+        // unary := '+' unary | '-' unary | primary
+        ExpressionKind parseUnary() {
+            const Token& op = peek();
+
+            if (acceptOperator("+")) {
+                ExpressionKind kind = parseUnary();
+                expectNumeric(kind, op);
+                return NUMERIC_EXPRESSION;
+            } else if (acceptOperator("-")) {
+                expectNumeric(parseUnary(), op);
+                emit(NEGATE);
+                return NUMERIC_EXPRESSION;
+            }
+
+            return parsePrimary();
+        }
+
+        // primary := literal | identifier | '(' orExpression ')'
+        ExpressionKind parsePrimary() {
+            const Token& token = next();
+
+            switch (token.type) {
+                case STRING_LITERAL:
+                    emitConstant(SelectorValue::ofString(token.text));
+                    return STRING_EXPRESSION;
+                case LONG_LITERAL:
+                    emitConstant(SelectorValue::ofLong(token.longValue));
+                    return NUMERIC_EXPRESSION;
+                case DOUBLE_LITERAL:
+                    emitConstant(SelectorValue::ofDouble(token.doubleValue));
+                    return NUMERIC_EXPRESSION;
+                case IDENTIFIER: {
+                    HeaderField field = getHeaderField(token.text);
+                    if (field != NOT_A_HEADER) {
+                        emit(PUSH_HEADER, field);
+                    } else {
+                        impl.properties.push_back(token.text);
+                        emit(PUSH_PROPERTY, (int) impl.properties.size() - 1);
+                    }
+                    return ANY_EXPRESSION;
+                }
+                case KEYWORD:
+                    if (token.text == "TRUE" || token.text == "FALSE") {
+                        emitConstant(SelectorValue::ofBool(token.text == "TRUE"));
+                        return BOOLEAN_EXPRESSION;
+                    } else if (token.text == "NULL") {
+                        emitConstant(SelectorValue());
+                        return ANY_EXPRESSION;
+                    }
+                    break;
+                case OPERATOR:
+                    if (token.text == "(") {
+                        ExpressionKind kind = parseOr();
+                        expectOperator(")");
+                        return kind;
+                    }
+                    break;
+                default:
+                    fail("unexpected end of selector", token);
+            }
+
+            fail("unexpected '" + token.text + "'", token);
+            return ANY_EXPRESSION;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelector::MessageSelector(const std::string& selector) : selector(selector), impl(new MessageSelectorImpl()) {
+
+    try {
+        SelectorParser parser(this->selector, *this->impl);
+        parser.parse();
+    } catch (...) {
+        delete this->impl;
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageSelector::~MessageSelector() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MessageSelector::matches(const cms::Message* message) const {
+
+    if (message == NULL) {
+        return false;
+    }
+
+    return this->impl->evaluate(MessageValueSource(message));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MessageSelector::matches(const PrimitiveMap& properties) const {
+    return this->impl->evaluate(MapValueSource(properties));
+}
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_MESSAGESELECTOR_H_
+#define _ACTIVEMQ_UTIL_MESSAGESELECTOR_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/PrimitiveMap.h>
+
+#include <cms/Message.h>
+#include <cms/InvalidSelectorException.h>
+
+#include <string>
+
+namespace activemq {
+namespace util {
+
+    class MessageSelectorImpl;
+
+    /**
+     * A JMS message selector compiled on the client so messages can be filtered locally
+     * instead of by the broker.
+     *
+     * The selector uses the SQL-92 conditional expression syntax of the JMS specification:
+     * comparisons, arithmetic, AND / OR / NOT, BETWEEN, IN, LIKE with an optional ESCAPE
+     * character and IS [NOT] NULL, over message properties and the JMSDeliveryMode,
+     * JMSPriority, JMSMessageID, JMSTimestamp, JMSCorrelationID, JMSType, JMSExpiration
+     * and JMSRedelivered header fields.  Keywords are case insensitive and identifiers
+     * are not.  Missing properties are NULL and make comparisons unknown, a message
+     * matches only when the whole selector is true.  Values of different types never
+     * compare equal, strings may also be ordered as the broker allows.
+     *
+     * The selector is parsed once into a flat program that is evaluated on a small
+     * stack, a compiled selector is immutable and may be shared by any number of
+     * threads.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MessageSelector {
+    private:
+
+        std::string selector;
+
+        MessageSelectorImpl* impl;
+
+    private:
+
+        MessageSelector(const MessageSelector&);
+        MessageSelector& operator= (const MessageSelector&);
+
+    public:
+
+        /**
+         * Compiles the given selector, an empty selector matches every message.
+         *
+         * @param selector
+         *      The selector expression.
+         *
+         * @throws InvalidSelectorException if the selector is not valid.
+         */
+        MessageSelector(const std::string& selector);
+
+        virtual ~MessageSelector();
+
+        /**
+         * @return the selector this instance was compiled from.
+         */
+        const std::string& getSelector() const {
+            return this->selector;
+        }
+
+        /**
+         * Evaluates the selector against the given message's headers and properties.
+         *
+         * @param message
+         *      The message to evaluate, a NULL message never matches.
+         *
+         * @return true if the selector is true for the message.
+         *
+         * @throws CMSException if the message's properties can't be read.
+         */
+        bool matches(const cms::Message* message) const;
+
+        /**
+         * Evaluates the selector against a set of properties, the header fields all
+         * evaluate as NULL.
+         *
+         * @param properties
+         *      The properties to evaluate.
+         *
+         * @return true if the selector is true for the properties.
+         */
+        bool matches(const PrimitiveMap& properties) const;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_MESSAGESELECTOR_H_ */
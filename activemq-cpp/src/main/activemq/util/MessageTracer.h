@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_MESSAGETRACER_H_
+#define _ACTIVEMQ_UTIL_MESSAGETRACER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Command.h>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * Callback that is notified as commands pass the points on their way between the
+     * application and the broker, so the end to end latency of a message can be broken
+     * down into the time spent in each stage.  Consecutive sent points for a message
+     * measure, in order, the wait for producer window space and the session, the wait
+     * for the transport, marshaling and the socket write.  On the receive side they
+     * measure the connection's dispatch, the time spent queued in the consumer's
+     * prefetch channel and the time taken by the application to consume the message.
+     *
+     * A tracer is optional, when none is set each point costs a single NULL check.  When
+     * one is set it is called on the thread that passes the point, often while holding
+     * locks on the send or dispatch path, so implementations must be thread safe and
+     * should do little more than record the timestamp.
+     *
+     * The timestamps are taken from System::nanoTime, so they are only comparable with
+     * each other and with other values from the same clock within this process.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MessageTracer {
+    public:
+
+        /**
+         * The points at which a tracer is notified.  The command passed for the producer
+         * and outbound transport points is the Message being sent, for the inbound
+         * transport point it is whatever command was read, and for the connection and
+         * consumer points it is the MessageDispatch carrying the message.
+         */
+        enum TracePoint {
+
+            /**
+             * A producer's send was called, before it waits for space in the producer
+             * window.  Notified once the message to be sent has been built.
+             */
+            PRODUCER_SEND = 1,
+
+            /**
+             * The session is handing the message to the connection to be sent.
+             */
+            SESSION_SEND,
+
+            /**
+             * The transport is about to marshal the command.
+             */
+            TRANSPORT_MARSHAL,
+
+            /**
+             * The command has been marshaled to the output stream.
+             */
+            TRANSPORT_WRITE,
+
+            /**
+             * The output stream holding the command has been flushed to the socket.
+             */
+            TRANSPORT_FLUSH,
+
+            /**
+             * A command has been read and unmarshaled and is being passed to the listener.
+             */
+            TRANSPORT_RECEIVE,
+
+            /**
+             * The connection is dispatching the message to its consumer.
+             */
+            CONNECTION_DISPATCH,
+
+            /**
+             * The message has been queued in the consumer's prefetch channel.
+             */
+            CONSUMER_ENQUEUE,
+
+            /**
+             * The message is being delivered to the application, either to its
+             * MessageListener or as the result of a receive call.
+             */
+            CONSUMER_DELIVER,
+
+            /**
+             * The application has finished with the message, either its MessageListener
+             * returned or, for a receive call, the message's acknowledgement has been
+             * handled and it is about to be returned.
+             */
+            CONSUMER_CONSUMED
+        };
+
+    public:
+
+        virtual ~MessageTracer();
+
+        /**
+         * Called each time a command passes one of the trace points.
+         *
+         * @param point
+         *      The trace point that was passed.
+         * @param command
+         *      The command that passed it.
+         * @param timestamp
+         *      The System::nanoTime value at which the point was passed.
+         */
+        virtual void onTrace(TracePoint point, const commands::Command& command, long long timestamp) = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_MESSAGETRACER_H_ */
@@ -0,0 +1,53 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_NATIVEDESTINATIONPROVIDER_H_
+#define _ACTIVEMQ_UTIL_NATIVEDESTINATIONPROVIDER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace commands {
+    class ActiveMQDestination;
+}
+namespace util {
+
+    /**
+     * Implemented by cms::Destination types of other code that wrap one of this library's
+     * destinations, the wrapped destination is used as is where the library needs one of
+     * its own rather than being rebuilt from the destination's name.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API NativeDestinationProvider {
+    public:
+
+        virtual ~NativeDestinationProvider();
+
+        /**
+         * Returns the library destination this destination stands for, the caller doesn't
+         * take ownership of it.
+         *
+         * @return the wrapped destination, or NULL to have it rebuilt from its name.
+         */
+        virtual const commands::ActiveMQDestination* getNativeDestination() const = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_NATIVEDESTINATIONPROVIDER_H_ */
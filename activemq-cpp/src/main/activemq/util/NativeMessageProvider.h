@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_NATIVEMESSAGEPROVIDER_H_
+#define _ACTIVEMQ_UTIL_NATIVEMESSAGEPROVIDER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace commands {
+    class Message;
+}
+namespace util {
+
+    /**
+     * Implemented by cms::Message types of other code that wrap one of this library's
+     * messages, such as proxies or decorators adding behavior to a message.  When such a
+     * message is sent the wrapped message is sent as if it had been given to the producer
+     * directly, it is copied once as any of the library's messages are rather than having
+     * its properties and body read through the CMS API into a new message first.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API NativeMessageProvider {
+    public:
+
+        virtual ~NativeMessageProvider();
+
+        /**
+         * Returns the library message this message stands for.  The message must hold all
+         * the headers, properties and body of this one, the caller doesn't take ownership
+         * of it.
+         *
+         * @return the wrapped message, or NULL to have this message copied through the
+         *         CMS API instead.
+         */
+        virtual commands::Message* getNativeMessage() = 0;
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_NATIVEMESSAGEPROVIDER_H_ */
@@ -32,17 +32,16 @@ PrimitiveList::PrimitiveList() : converter() {
 
 ////////////////////////////////////////////////////////////////////////////////
 PrimitiveList::PrimitiveList( const decaf::util::List<PrimitiveValueNode>& src )
-  : LinkedList<PrimitiveValueNode>( src ), converter(){
+  : ArrayList<PrimitiveValueNode>( src ), converter(){
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 PrimitiveList::PrimitiveList( const PrimitiveList& src )
-  : LinkedList<PrimitiveValueNode>( src ), converter() {
+  : ArrayList<PrimitiveValueNode>( src ), converter() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 PrimitiveList::~PrimitiveList() {
-    clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -20,7 +20,7 @@
 
 #include <string>
 #include <vector>
-#include <decaf/util/LinkedList.h>
+#include <decaf/util/ArrayList.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 #include <stdio.h>
@@ -31,9 +31,10 @@ namespace activemq{
 namespace util{
 
     /**
-     * List of primitives.
+     * List of primitives.  The values are held in one contiguous array so a list of
+     * numbers costs a single allocation rather than one per element.
      */
-    class PrimitiveList : public decaf::util::LinkedList<PrimitiveValueNode> {
+    class PrimitiveList : public decaf::util::ArrayList<PrimitiveValueNode> {
     private:
 
         PrimitiveValueConverter converter;
@@ -18,8 +18,6 @@
 #include "PrimitiveValueConverter.h"
 
 #include <decaf/lang/Boolean.h>
-#include <decaf/lang/Byte.h>
-#include <decaf/lang/Character.h>
 #include <decaf/lang/Short.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
@@ -29,6 +27,95 @@
 using namespace activemq;
 using namespace activemq::util;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    /**
+     * Parses a decimal number the way Integer::parseInt and Long::parseLong do, an
+     * optional minus sign followed only by digits, but straight from the node's
+     * string without building a decaf String or throwing for text that isn't a
+     * number in range.
+     */
+    bool parseDecimal(const std::string& text, long long min, long long max, long long& result) {
+
+        std::size_t length = text.length();
+        std::size_t i = 0;
+
+        if (length == 0) {
+            return false;
+        }
+
+        bool negative = text[0] == '-';
+        if (negative && ++i == length) {
+            return false;
+        }
+
+        // Accumulated as a negative value so that the minimum of long long fits.
+        long long limit = negative ? min : -max;
+        long long multiplyLimit = limit / 10;
+        long long value = 0;
+
+        for (; i < length; ++i) {
+
+            char ch = text[i];
+            if (ch < '0' || ch > '9') {
+                return false;
+            }
+
+            int digit = ch - '0';
+            if (value < multiplyLimit) {
+                return false;
+            }
+
+            value *= 10;
+            if (value < limit + digit) {
+                return false;
+            }
+
+            value -= digit;
+        }
+
+        result = negative ? value : -value;
+        return true;
+    }
+
+    long long parseDecimal(const PrimitiveValueNode& value, long long min, long long max) {
+
+        long long result = 0;
+        if (!parseDecimal(value.getStringView(), min, max, result)) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(
+                __FILE__, __LINE__, "Unsupported Type Conversion");
+        }
+
+        return result;
+    }
+
+    /**
+     * Formats a number as Integer::toString and Long::toString do, the digits are
+     * written into a local buffer so the returned string is the only allocation.
+     */
+    std::string formatDecimal(long long value) {
+
+        char buffer[24];
+        char* end = buffer + sizeof(buffer);
+        char* position = end;
+
+        unsigned long long magnitude = value < 0 ?
+            0ULL - (unsigned long long) value : (unsigned long long) value;
+
+        do {
+            *--position = (char) ('0' + (int) (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (value < 0) {
+            *--position = '-';
+        }
+
+        return std::string(position, (std::size_t) (end - position));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 template<>
 bool PrimitiveValueConverter::convert<bool>(const PrimitiveValueNode& value) const {
@@ -58,11 +145,7 @@ unsigned char PrimitiveValueConverter::convert<unsigned char>(const PrimitiveVal
             return value.getByte();
         case PrimitiveValueNode::STRING_TYPE:
         case PrimitiveValueNode::BIG_STRING_TYPE:
-        {
-            try{
-                return decaf::lang::Byte::parseByte( value.getString() );
-            } catch( decaf::lang::Exception& ex ) {}
-        }
+            return (unsigned char) parseDecimal( value, 0, 255 );
         default:
             throw decaf::lang::exceptions::UnsupportedOperationException(
                  __FILE__, __LINE__, "Unsupported Type Conversion" );
@@ -78,11 +161,7 @@ char PrimitiveValueConverter::convert<char>(const PrimitiveValueNode& value) con
             return value.getChar();
         case PrimitiveValueNode::STRING_TYPE:
         case PrimitiveValueNode::BIG_STRING_TYPE:
-        {
-            try{
-                return (char)decaf::lang::Byte::parseByte( value.getString() );
-            } catch( decaf::lang::Exception& ex ) {}
-        }
+            return (char) parseDecimal( value, 0, 255 );
         default:
             throw decaf::lang::exceptions::UnsupportedOperationException(
                  __FILE__, __LINE__, "Unsupported Type Conversion" );
@@ -100,11 +179,7 @@ short PrimitiveValueConverter::convert<short>(const PrimitiveValueNode& value) c
             return value.getShort();
         case PrimitiveValueNode::STRING_TYPE:
         case PrimitiveValueNode::BIG_STRING_TYPE:
-        {
-            try{
-                return decaf::lang::Short::parseShort( value.getString() );
-            } catch( decaf::lang::Exception& ex ) {}
-        }
+            return (short) parseDecimal( value, decaf::lang::Short::MIN_VALUE, decaf::lang::Short::MAX_VALUE );
         default:
             throw decaf::lang::exceptions::UnsupportedOperationException(
                  __FILE__, __LINE__, "Unsupported Type Conversion" );
@@ -124,11 +199,7 @@ int PrimitiveValueConverter::convert<int>(const PrimitiveValueNode& value) const
             return value.getInt();
         case PrimitiveValueNode::STRING_TYPE:
         case PrimitiveValueNode::BIG_STRING_TYPE:
-        {
-            try{
-                return decaf::lang::Integer::parseInt( value.getString() );
-            } catch( decaf::lang::Exception& ex ) {}
-        }
+            return (int) parseDecimal( value, decaf::lang::Integer::MIN_VALUE, decaf::lang::Integer::MAX_VALUE );
         default:
             throw decaf::lang::exceptions::UnsupportedOperationException(
                 __FILE__, __LINE__, "Unsupported Type Conversion" );
@@ -150,11 +221,7 @@ long long PrimitiveValueConverter::convert<long long>(const PrimitiveValueNode&
             return (long long)value.getLong();
         case PrimitiveValueNode::STRING_TYPE:
         case PrimitiveValueNode::BIG_STRING_TYPE:
-        {
-            try{
-                return decaf::lang::Long::parseLong( value.getString() );
-            } catch( decaf::lang::Exception& ex ) {}
-        }
+            return (long long) parseDecimal( value, decaf::lang::Long::MIN_VALUE, decaf::lang::Long::MAX_VALUE );
         default:
             throw decaf::lang::exceptions::UnsupportedOperationException(
                 __FILE__, __LINE__, "Unsupported Type Conversion" );
@@ -213,15 +280,15 @@ std::string PrimitiveValueConverter::convert<std::string>(const PrimitiveValueNo
         case PrimitiveValueNode::BOOLEAN_TYPE:
             return decaf::lang::Boolean::toString( value.getBool() );
         case PrimitiveValueNode::BYTE_TYPE:
-            return decaf::lang::Byte::toString( value.getByte() );
+            return formatDecimal( value.getByte() );
         case PrimitiveValueNode::CHAR_TYPE:
-            return decaf::lang::Character::valueOf( value.getChar() ).toString();
+            return std::string( 1, value.getChar() );
         case PrimitiveValueNode::SHORT_TYPE:
-            return decaf::lang::Short::toString( value.getShort() );
+            return formatDecimal( value.getShort() );
         case PrimitiveValueNode::INTEGER_TYPE:
-            return decaf::lang::Integer::toString( value.getInt() );
+            return formatDecimal( value.getInt() );
         case PrimitiveValueNode::LONG_TYPE:
-            return decaf::lang::Long::toString( value.getLong() );
+            return formatDecimal( value.getLong() );
         case PrimitiveValueNode::FLOAT_TYPE:
             return decaf::lang::Float::toString( value.getFloat() );
         case PrimitiveValueNode::DOUBLE_TYPE:
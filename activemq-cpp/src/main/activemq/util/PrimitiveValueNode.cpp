@@ -21,7 +21,7 @@
 #include <activemq/util/PrimitiveMap.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/util/StlMap.h>
-#include <decaf/util/LinkedList.h>
+#include <decaf/util/ArrayList.h>
 
 #ifdef HAVE_STRING_H
 #include <string.h>
@@ -34,6 +34,14 @@ using namespace std;
 using namespace activemq;
 using namespace activemq::util;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Viewed in place of a string value that was never allocated.
+    const std::string EMPTY_STRING;
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 PrimitiveValueNode::PrimitiveValueNode() : valueType(NULL_TYPE), value() {
     memset(&value, 0, sizeof(value));
@@ -360,6 +368,20 @@ std::string PrimitiveValueNode::getString() const {
     return *value.stringValue;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const std::string& PrimitiveValueNode::getStringView() const {
+
+    if (valueType != STRING_TYPE) {
+        throw decaf::util::NoSuchElementException(__FILE__, __LINE__, "PrimitiveValue is not STRING_TYPE");
+    }
+
+    if (value.stringValue == NULL) {
+        return EMPTY_STRING;
+    }
+
+    return *value.stringValue;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PrimitiveValueNode::setByteArray(const std::vector<unsigned char>& lvalue) {
     clear();
@@ -385,8 +407,7 @@ std::vector<unsigned char> PrimitiveValueNode::getByteArray() const {
 void PrimitiveValueNode::setList(const decaf::util::List<PrimitiveValueNode>& lvalue) {
     clear();
     valueType = LIST_TYPE;
-    value.listValue = new decaf::util::LinkedList<PrimitiveValueNode>();
-    value.listValue->copy(lvalue);
+    value.listValue = new decaf::util::ArrayList<PrimitiveValueNode>(lvalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -370,6 +370,15 @@ namespace util {
          */
         std::string getString() const;
 
+        /**
+         * Gets the String value of this Node without copying it, the reference is only
+         * valid until the node is changed or destroyed.
+         * @return reference to the string held by this node
+         * @throw NoSuchElementException this node cannot be returned as the
+         * requested type.
+         */
+        const std::string& getStringView() const;
+
         /**
          * Sets the value of this value node to the new value specified,
          * this method overwrites any data that was previously at the index
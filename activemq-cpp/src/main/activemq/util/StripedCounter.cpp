@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripedCounter.h"
+
+#include <decaf/lang/Thread.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::lang;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int StripedCounter::STRIPE_COUNT;
+
+////////////////////////////////////////////////////////////////////////////////
+StripedCounter::StripedCounter() {
+    for (int i = 0; i < STRIPE_COUNT; ++i) {
+        this->cells[i].value = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StripedCounter::~StripedCounter() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedCounter::add(long long delta) {
+    int index = (int) (Thread::currentThread()->getId() & (STRIPE_COUNT - 1));
+    Atomics::getAndAdd64(&this->cells[index].value, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StripedCounter::get() const {
+    long long sum = 0;
+    for (int i = 0; i < STRIPE_COUNT; ++i) {
+        sum += this->cells[i].value;
+    }
+    return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedCounter::reset() {
+    for (int i = 0; i < STRIPE_COUNT; ++i) {
+        long long value = this->cells[i].value;
+        Atomics::getAndAdd64(&this->cells[i].value, -value);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_STRIPEDCOUNTER_H_
+#define _ACTIVEMQ_UTIL_STRIPEDCOUNTER_H_
+
+#include <activemq/util/Config.h>
+
+namespace activemq {
+namespace util {
+
+    /**
+     * A counter meant to be updated from many threads at once on a hot path.  The count
+     * is split over a fixed number of cells that each sit on their own cache line and a
+     * thread always adds into the cell picked by its thread id, so threads updating the
+     * counter concurrently rarely contend on the same memory.  Reading the counter sums
+     * the cells, the result is exact once updates have stopped but is only a close
+     * estimate while they are in progress.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API StripedCounter {
+    public:
+
+        /**
+         * Number of cells the count is spread over, a power of two.
+         */
+        static const int STRIPE_COUNT = 16;
+
+    private:
+
+        struct Cell {
+            volatile long long value;
+            char padding[64 - sizeof(long long)];
+        };
+
+        Cell cells[STRIPE_COUNT];
+
+    private:
+
+        StripedCounter(const StripedCounter&);
+        StripedCounter& operator= (const StripedCounter&);
+
+    public:
+
+        StripedCounter();
+
+        virtual ~StripedCounter();
+
+        /**
+         * Adds the given amount to the count.
+         *
+         * @param delta
+         *      The amount to add, which may be negative.
+         */
+        void add(long long delta);
+
+        /**
+         * Adds one to the count.
+         */
+        void increment() {
+            add(1);
+        }
+
+        /**
+         * @return the sum of all the updates made since creation or the last reset.
+         */
+        long long get() const;
+
+        /**
+         * Sets the count back to zero, updates made while the reset runs may be lost.
+         */
+        void reset();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_STRIPEDCOUNTER_H_ */
@@ -0,0 +1,380 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ZstdCodec.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/util/CompressionPool.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+#include <map>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace activemq {
+namespace util {
+
+    class ZstdCodecImpl {
+    private:
+
+        ZstdCodecImpl(const ZstdCodecImpl&);
+        ZstdCodecImpl& operator= (const ZstdCodecImpl&);
+
+    public:
+
+        std::vector<unsigned char> dictionary;
+
+        Mutex lock;
+
+#ifdef HAVE_ZSTD
+        std::vector<ZSTD_CCtx*> compressors;
+        std::vector<ZSTD_DCtx*> decompressors;
+
+        // The dictionary digested for compression, one per level used.
+        std::map<int, ZSTD_CDict*> compressionDictionaries;
+        ZSTD_DDict* decompressionDictionary;
+#endif
+
+        ZstdCodecImpl(const std::vector<unsigned char>& dictionary) : dictionary(dictionary), lock()
+#ifdef HAVE_ZSTD
+            , compressors(), decompressors(), compressionDictionaries(), decompressionDictionary(NULL)
+#endif
+        {
+        }
+
+        ~ZstdCodecImpl() {
+#ifdef HAVE_ZSTD
+            std::vector<ZSTD_CCtx*>::iterator compressor = this->compressors.begin();
+            for (; compressor != this->compressors.end(); ++compressor) {
+                ZSTD_freeCCtx(*compressor);
+            }
+
+            std::vector<ZSTD_DCtx*>::iterator decompressor = this->decompressors.begin();
+            for (; decompressor != this->decompressors.end(); ++decompressor) {
+                ZSTD_freeDCtx(*decompressor);
+            }
+
+            std::map<int, ZSTD_CDict*>::iterator cdict = this->compressionDictionaries.begin();
+            for (; cdict != this->compressionDictionaries.end(); ++cdict) {
+                ZSTD_freeCDict(cdict->second);
+            }
+
+            ZSTD_freeDDict(this->decompressionDictionary);
+#endif
+        }
+
+#ifdef HAVE_ZSTD
+
+        ZSTD_CCtx* takeCompressor() {
+            synchronized(&this->lock) {
+                if (!this->compressors.empty()) {
+                    ZSTD_CCtx* context = this->compressors.back();
+                    this->compressors.pop_back();
+                    return context;
+                }
+            }
+
+            ZSTD_CCtx* context = ZSTD_createCCtx();
+            if (context == NULL) {
+                throw IOException(__FILE__, __LINE__, "Failed to allocate a zstd compression context");
+            }
+
+            return context;
+        }
+
+        void returnCompressor(ZSTD_CCtx* context) {
+            synchronized(&this->lock) {
+                if ((int) this->compressors.size() < CompressionPool::DEFAULT_MAX_IDLE) {
+                    this->compressors.push_back(context);
+                    return;
+                }
+            }
+
+            ZSTD_freeCCtx(context);
+        }
+
+        ZSTD_DCtx* takeDecompressor() {
+            synchronized(&this->lock) {
+                if (!this->decompressors.empty()) {
+                    ZSTD_DCtx* context = this->decompressors.back();
+                    this->decompressors.pop_back();
+                    return context;
+                }
+            }
+
+            ZSTD_DCtx* context = ZSTD_createDCtx();
+            if (context == NULL) {
+                throw IOException(__FILE__, __LINE__, "Failed to allocate a zstd decompression context");
+            }
+
+            return context;
+        }
+
+        void returnDecompressor(ZSTD_DCtx* context) {
+            synchronized(&this->lock) {
+                if ((int) this->decompressors.size() < CompressionPool::DEFAULT_MAX_IDLE) {
+                    this->decompressors.push_back(context);
+                    return;
+                }
+            }
+
+            ZSTD_freeDCtx(context);
+        }
+
+        ZSTD_CDict* getCompressionDictionary(int level) {
+            synchronized(&this->lock) {
+
+                std::map<int, ZSTD_CDict*>::iterator iter = this->compressionDictionaries.find(level);
+                if (iter != this->compressionDictionaries.end()) {
+                    return iter->second;
+                }
+
+                ZSTD_CDict* cdict = ZSTD_createCDict(&this->dictionary[0], this->dictionary.size(), level);
+                if (cdict == NULL) {
+                    throw IllegalArgumentException(__FILE__, __LINE__, "The zstd dictionary could not be loaded");
+                }
+
+                this->compressionDictionaries.insert(std::make_pair(level, cdict));
+                return cdict;
+            }
+
+            return NULL;
+        }
+
+        static void checkResult(size_t result) {
+            if (ZSTD_isError(result)) {
+                throw IOException(__FILE__, __LINE__, "zstd failed to compress the data: %s", ZSTD_getErrorName(result));
+            }
+        }
+
+#endif
+
+    };
+
+}}
+
+////////////////////////////////////////////////////////////////////////////////
+ZstdCodec::ZstdCodec(const std::vector<unsigned char>& dictionary) : CompressionCodec(), impl(NULL) {
+
+    if (!isAvailable()) {
+        throw UnsupportedOperationException(__FILE__, __LINE__,
+            "The zstd compression codec is not supported by this build of the library");
+    }
+
+    this->impl = new ZstdCodecImpl(dictionary);
+
+#ifdef HAVE_ZSTD
+    if (!dictionary.empty()) {
+        this->impl->decompressionDictionary = ZSTD_createDDict(&dictionary[0], dictionary.size());
+        if (this->impl->decompressionDictionary == NULL) {
+            delete this->impl;
+            throw IllegalArgumentException(__FILE__, __LINE__, "The zstd dictionary could not be loaded");
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ZstdCodec::~ZstdCodec() {
+    try {
+        delete this->impl;
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ZstdCodec::isAvailable() {
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string ZstdCodec::getName() const {
+    return CompressionCodec::ZSTD;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ZstdCodec::getMemoryUsage() const {
+
+    long long usage = (long long) this->impl->dictionary.capacity();
+
+#ifdef HAVE_ZSTD
+    synchronized(&this->impl->lock) {
+
+        std::vector<ZSTD_CCtx*>::const_iterator compressor = this->impl->compressors.begin();
+        for (; compressor != this->impl->compressors.end(); ++compressor) {
+            usage += (long long) ZSTD_sizeof_CCtx(*compressor);
+        }
+
+        std::vector<ZSTD_DCtx*>::const_iterator decompressor = this->impl->decompressors.begin();
+        for (; decompressor != this->impl->decompressors.end(); ++decompressor) {
+            usage += (long long) ZSTD_sizeof_DCtx(*decompressor);
+        }
+
+        std::map<int, ZSTD_CDict*>::const_iterator cdict = this->impl->compressionDictionaries.begin();
+        for (; cdict != this->impl->compressionDictionaries.end(); ++cdict) {
+            usage += (long long) ZSTD_sizeof_CDict(cdict->second);
+        }
+
+        if (this->impl->decompressionDictionary != NULL) {
+            usage += (long long) ZSTD_sizeof_DDict(this->impl->decompressionDictionary);
+        }
+    }
+#endif
+
+    return usage;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ZstdCodec::compress(int level, const unsigned char* const* buffers AMQCPP_UNUSED,
+                         const int* lengths AMQCPP_UNUSED, int count AMQCPP_UNUSED,
+                         std::vector<unsigned char>& out AMQCPP_UNUSED) {
+
+    if (level < -1 || level > 9) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Compression level passed was Invalid: %d", level);
+    }
+
+#ifdef HAVE_ZSTD
+
+    int zstdLevel = level < 0 ? ZSTD_CLEVEL_DEFAULT : (level == 0 ? 1 : level);
+
+    std::size_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += lengths[i] > 0 ? (std::size_t) lengths[i] : 0;
+    }
+
+    ZSTD_CCtx* context = this->impl->takeCompressor();
+    std::size_t start = out.size();
+
+    try {
+
+        ZstdCodecImpl::checkResult(ZSTD_CCtx_reset(context, ZSTD_reset_session_and_parameters));
+
+        if (this->impl->dictionary.empty()) {
+            ZstdCodecImpl::checkResult(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, zstdLevel));
+        } else {
+            ZstdCodecImpl::checkResult(ZSTD_CCtx_refCDict(context, this->impl->getCompressionDictionary(zstdLevel)));
+        }
+
+        // Records the size in the frame header so the receiver can size its output.
+        ZstdCodecImpl::checkResult(ZSTD_CCtx_setPledgedSrcSize(context, total));
+
+        // The bound covers the whole frame so the output never has to grow.
+        out.resize(start + ZSTD_compressBound(total));
+        ZSTD_outBuffer output = { &out[start], out.size() - start, 0 };
+
+        for (int i = 0; i < count; ++i) {
+
+            if (lengths[i] <= 0) {
+                continue;
+            }
+
+            ZSTD_inBuffer input = { buffers[i], (std::size_t) lengths[i], 0 };
+            while (input.pos < input.size) {
+                ZstdCodecImpl::checkResult(ZSTD_compressStream2(context, &output, &input, ZSTD_e_continue));
+            }
+        }
+
+        ZSTD_inBuffer empty = { NULL, 0, 0 };
+        std::size_t remaining = 0;
+        do {
+            remaining = ZSTD_compressStream2(context, &output, &empty, ZSTD_e_end);
+            ZstdCodecImpl::checkResult(remaining);
+        } while (remaining != 0);
+
+        out.resize(start + output.pos);
+
+    } catch (...) {
+        out.resize(start);
+        this->impl->returnCompressor(context);
+        throw;
+    }
+
+    this->impl->returnCompressor(context);
+
+#else
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "The zstd compression codec is not supported by this build of the library");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ZstdCodec::decompress(const unsigned char* buffer AMQCPP_UNUSED, int length AMQCPP_UNUSED,
+                           std::vector<unsigned char>& out AMQCPP_UNUSED, int expected AMQCPP_UNUSED) {
+
+#ifdef HAVE_ZSTD
+
+    if (buffer == NULL || length <= 0) {
+        throw DataFormatException(__FILE__, __LINE__, "zstd data is empty.");
+    }
+
+    unsigned long long size = ZSTD_getFrameContentSize(buffer, (std::size_t) length);
+
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        size > (unsigned long long) Integer::MAX_VALUE || (expected > 0 && size != (unsigned long long) expected)) {
+
+        throw DataFormatException(__FILE__, __LINE__, "zstd data is not a frame of known size.");
+    }
+
+    std::size_t start = out.size();
+    out.resize(start + (std::size_t) size);
+    void* target = size > 0 ? &out[start] : NULL;
+
+    ZSTD_DCtx* context = this->impl->takeDecompressor();
+    std::size_t result = 0;
+
+    if (this->impl->decompressionDictionary != NULL) {
+        result = ZSTD_decompress_usingDDict(context, target, (std::size_t) size, buffer,
+                                            (std::size_t) length, this->impl->decompressionDictionary);
+    } else {
+        result = ZSTD_decompressDCtx(context, target, (std::size_t) size, buffer, (std::size_t) length);
+    }
+
+    this->impl->returnDecompressor(context);
+
+    if (ZSTD_isError(result) || result != size) {
+        out.resize(start);
+        throw DataFormatException(__FILE__, __LINE__, "zstd data is corrupt: %s",
+            ZSTD_isError(result) ? ZSTD_getErrorName(result) : "size mismatch");
+    }
+
+#else
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "The zstd compression codec is not supported by this build of the library");
+#endif
+}
@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_ZSTDCODEC_H_
+#define _ACTIVEMQ_UTIL_ZSTDCODEC_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/util/CompressionCodec.h>
+
+#include <vector>
+
+namespace activemq {
+namespace util {
+
+    class ZstdCodecImpl;
+
+    /**
+     * CompressionCodec that writes Zstandard frames, which compress better than zlib at a
+     * similar or higher speed.
+     *
+     * Each compressed body is a single frame that records its decompressed size.  The
+     * compression level maps onto the Zstandard levels of the same number, the default
+     * level is Zstandard's own default and level 0 is its fastest regular level.
+     *
+     * A dictionary, typically trained with "zstd --train" on sample message bodies, makes
+     * small messages compress far better.  The dictionary is digested once per compression
+     * level and shared by all compressions, the receiver must decompress with the same
+     * dictionary.  Compression and decompression contexts are kept for reuse like the
+     * contexts of the CompressionPool.
+     *
+     * Only usable when the library is built against libzstd, see isAvailable.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API ZstdCodec : public CompressionCodec {
+    private:
+
+        ZstdCodecImpl* impl;
+
+    private:
+
+        ZstdCodec(const ZstdCodec&);
+        ZstdCodec& operator= (const ZstdCodec&);
+
+    public:
+
+        /**
+         * Creates a codec that compresses against the given dictionary, which may be empty.
+         *
+         * @param dictionary
+         *      The dictionary shared with the receivers of the compressed data.
+         *
+         * @throws UnsupportedOperationException if the library was built without Zstandard.
+         * @throws IllegalArgumentException if the dictionary can't be loaded.
+         */
+        ZstdCodec(const std::vector<unsigned char>& dictionary = std::vector<unsigned char>());
+
+        virtual ~ZstdCodec();
+
+        virtual std::string getName() const;
+
+        virtual void compress(int level, const unsigned char* const* buffers, const int* lengths,
+                              int count, std::vector<unsigned char>& out);
+
+        virtual void decompress(const unsigned char* buffer, int length,
+                                std::vector<unsigned char>& out, int expected = 0);
+
+        virtual long long getMemoryUsage() const;
+
+        /**
+         * @return true if the library was built with Zstandard support.
+         */
+        static bool isAvailable();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_ZSTDCODEC_H_ */
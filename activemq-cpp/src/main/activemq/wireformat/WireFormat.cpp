@@ -19,6 +19,27 @@
 
 using namespace activemq;
 using namespace activemq::wireformat;
+using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 WireFormat::~WireFormat() {}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WireFormat::isFramed() const {
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WireFormat::readFrame(decaf::io::DataInputStream* in AMQCPP_UNUSED,
+                           std::vector<unsigned char>& frame AMQCPP_UNUSED) {
+
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "WireFormat::readFrame - this wire format doesn't read framed commands");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int WireFormat::getFrameLength(const unsigned char* buffer AMQCPP_UNUSED, int size AMQCPP_UNUSED) {
+
+    throw UnsupportedOperationException(__FILE__, __LINE__,
+        "WireFormat::getFrameLength - this wire format doesn't read framed commands");
+}
@@ -31,6 +31,8 @@
 
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 
+#include <vector>
+
 namespace activemq {
 namespace wireformat {
 
@@ -112,6 +114,55 @@ namespace wireformat {
          */
         virtual bool inReceive() const = 0;
 
+        /**
+         * Indicates if the commands this WireFormat reads are framed so that readFrame can
+         * take the bytes of each one off a stream without unmarshaling them.
+         *
+         * The default implementation returns false.
+         *
+         * @return true if readFrame is supported.
+         */
+        virtual bool isFramed() const;
+
+        /**
+         * Reads the complete encoded form of the next command from the input stream without
+         * unmarshaling it.  Passing the bytes to unmarshal in a stream of their own later
+         * yields the command, so reading and unmarshaling can happen on different threads
+         * as long as the frames are unmarshaled in the order they were read.
+         *
+         * The default implementation throws an UnsupportedOperationException.
+         *
+         * @param in
+         *      The input stream to read the frame from.
+         * @param frame
+         *      The vector that is resized to hold the frame and receives its bytes.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws UnsupportedOperationException if this WireFormat isn't framed.
+         */
+        virtual void readFrame(decaf::io::DataInputStream* in, std::vector<unsigned char>& frame);
+
+        /**
+         * Examines bytes that were received without being taken off a stream and works
+         * out how long the first frame in them is, so that a caller doing non-blocking
+         * reads knows when it holds a complete frame to pass to unmarshal.  While the
+         * frame is incomplete the WireFormat reports that it is receiving.
+         *
+         * The default implementation throws an UnsupportedOperationException.
+         *
+         * @param buffer
+         *      The received bytes, starting at the beginning of a frame.
+         * @param size
+         *      The number of bytes in the buffer.
+         *
+         * @return the total length in bytes of the frame, which may be more than size, or
+         *         -1 if there aren't yet enough bytes to tell.
+         *
+         * @throws IOException if the bytes can't be the start of a valid frame.
+         * @throws UnsupportedOperationException if this WireFormat isn't framed.
+         */
+        virtual int getFrameLength(const unsigned char* buffer, int size);
+
         /**
          * If the Transport Provides a Negotiator this method will create and return
          * a new instance of the Negotiator.
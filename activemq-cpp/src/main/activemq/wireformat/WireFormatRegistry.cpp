@@ -17,6 +17,9 @@
 
 #include "WireFormatRegistry.h"
 
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/util/concurrent/Mutex.h>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::wireformat;
@@ -24,10 +27,15 @@ using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
     WireFormatRegistry* theOnlyInstance;
+    WireFormatRegistry::DefaultFactories defaultFactories;
+    volatile int defaultsRegistered;
+    Mutex* defaultsLock;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,12 +103,27 @@ std::vector<std::string> WireFormatRegistry::getWireFormatNames() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 WireFormatRegistry& WireFormatRegistry::getInstance() {
+
+    if (theOnlyInstance != NULL && Atomics::getAcquire(&defaultsRegistered) == 0) {
+        synchronized(defaultsLock) {
+            if (defaultsRegistered == 0) {
+                if (defaultFactories != NULL) {
+                    defaultFactories(*theOnlyInstance);
+                }
+                Atomics::lazySet(&defaultsRegistered, 1);
+            }
+        }
+    }
+
     return *theOnlyInstance;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void WireFormatRegistry::initialize() {
+void WireFormatRegistry::initialize(DefaultFactories defaults) {
     theOnlyInstance = new WireFormatRegistry();
+    defaultFactories = defaults;
+    defaultsRegistered = 0;
+    defaultsLock = new Mutex();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,4 +131,6 @@ void WireFormatRegistry::shutdown() {
     theOnlyInstance->unregisterAllFactories();
     delete theOnlyInstance;
     theOnlyInstance = NULL;
+    delete defaultsLock;
+    defaultsLock = NULL;
 }
@@ -43,6 +43,14 @@ namespace wireformat {
      * @since 3.0
      */
     class AMQCPP_API WireFormatRegistry {
+    public:
+
+        /**
+         * Registers the built in factories with the registry, run by getInstance the
+         * first time it is called so a process that never connects doesn't create them.
+         */
+        typedef void (*DefaultFactories)(WireFormatRegistry& registry);
+
     private:
 
         decaf::util::StlMap<std::string, WireFormatFactory*> registry;
@@ -115,14 +123,16 @@ namespace wireformat {
         std::vector<std::string> getWireFormatNames() const;
 
         /**
-         * Gets the single instance of the WireFormatRegistry
+         * Gets the single instance of the WireFormatRegistry, the built in factories are
+         * registered the first time this is called.
+         *
          * @return reference to the single instance of this Registry
          */
         static WireFormatRegistry& getInstance();
 
     private:
 
-        static void initialize();
+        static void initialize(DefaultFactories defaults);
         static void shutdown();
 
         friend class activemq::library::ActiveMQCPP;
@@ -0,0 +1,117 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MarshaledCommand.h"
+
+#include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::exceptions;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+MarshaledCommand::MarshaledCommand(const unsigned char* frame, int size, int version) :
+    BaseCommand(), frame(), version(version) {
+
+    if (frame == NULL || size <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "A marshaled command can't be empty.");
+    }
+
+    this->frame.assign(frame, frame + size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshaledCommand::~MarshaledCommand() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char MarshaledCommand::getDataStructureType() const {
+    return this->frame[0];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshaledCommand* MarshaledCommand::cloneDataStructure() const {
+    MarshaledCommand* clone = new MarshaledCommand(&this->frame[0], (int) this->frame.size(), this->version);
+    clone->copyDataStructure(this);
+    return clone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshaledCommand::copyDataStructure(const DataStructure* src) {
+
+    if (this == src) {
+        return;
+    }
+
+    const MarshaledCommand* srcPtr = dynamic_cast<const MarshaledCommand*>(src);
+
+    if (srcPtr == NULL || src == NULL) {
+        throw IllegalArgumentException(__FILE__, __LINE__,
+            "MarshaledCommand::copyDataStructure - src is NULL or invalid");
+    }
+
+    BaseCommand::copyDataStructure(src);
+
+    this->frame = srcPtr->frame;
+    this->version = srcPtr->version;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string MarshaledCommand::toString() const {
+
+    ostringstream stream;
+
+    stream << "MarshaledCommand { ";
+    stream << "CommandId = " << this->getCommandId();
+    stream << ", Type = " << (int) this->getDataStructureType();
+    stream << ", Version = " << this->version;
+    stream << ", Size = " << this->frame.size();
+    stream << " }";
+
+    return stream.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MarshaledCommand::equals(const DataStructure* value) const {
+
+    if (this == value) {
+        return true;
+    }
+
+    const MarshaledCommand* valuePtr = dynamic_cast<const MarshaledCommand*>(value);
+
+    if (valuePtr == NULL || value == NULL) {
+        return false;
+    }
+
+    return this->version == valuePtr->version && this->frame == valuePtr->frame &&
+           BaseCommand::equals(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<Command> MarshaledCommand::visit(activemq::state::CommandVisitor* visitor AMQCPP_UNUSED) {
+    throw ActiveMQException(__FILE__, __LINE__,
+        "MarshaledCommand::visit - marshaled commands are only written to the wire");
+}
@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHALEDCOMMAND_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHALEDCOMMAND_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/BaseCommand.h>
+
+#include <string>
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+
+    /**
+     * A command that was encoded ahead of time, in the loose encoding of the given
+     * OpenWire version with the marshal cache turned off.  The frame holds the type byte
+     * and the body of the command without the size prefix.  OpenWireFormat writes the
+     * frame as it is when its own encoding is the same, which lets a command be sent
+     * again without decoding it into an object only to encode it once more.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MarshaledCommand : public commands::BaseCommand {
+    private:
+
+        std::vector<unsigned char> frame;
+        int version;
+
+    private:
+
+        MarshaledCommand(const MarshaledCommand&);
+        MarshaledCommand& operator= (const MarshaledCommand&);
+
+    public:
+
+        /**
+         * Creates the command from an encoded frame.
+         *
+         * @param frame
+         *      The type byte and the body of the encoded command.
+         * @param size
+         *      The number of bytes in the frame.
+         * @param version
+         *      The OpenWire version the command was encoded with.
+         *
+         * @throws IllegalArgumentException if the frame is empty.
+         */
+        MarshaledCommand(const unsigned char* frame, int size, int version);
+
+        virtual ~MarshaledCommand();
+
+        /**
+         * @return the type byte and the body of the encoded command.
+         */
+        const std::vector<unsigned char>& getFrame() const {
+            return this->frame;
+        }
+
+        /**
+         * @return the OpenWire version the command was encoded with.
+         */
+        int getVersion() const {
+            return this->version;
+        }
+
+        /**
+         * @return the type of the encoded command.
+         */
+        virtual unsigned char getDataStructureType() const;
+
+        virtual MarshaledCommand* cloneDataStructure() const;
+
+        virtual void copyDataStructure(const commands::DataStructure* src);
+
+        virtual std::string toString() const;
+
+        virtual bool equals(const commands::DataStructure* value) const;
+
+        /**
+         * A marshaled command is only ever written out, there is nothing to visit.
+         *
+         * @throws ActiveMQException always.
+         */
+        virtual decaf::lang::Pointer<commands::Command> visit(activemq::state::CommandVisitor* visitor);
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHALEDCOMMAND_H_ */
@@ -21,15 +21,27 @@
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Long.h>
 #include <decaf/util/UUID.h>
+#include <decaf/util/concurrent/Lock.h>
 #include <decaf/lang/Math.h>
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <activemq/wireformat/openwire/OpenWireFormatNegotiator.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
 #include <activemq/wireformat/MarshalAware.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/DestinationInterner.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTempTopic.h>
+#include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/ConnectionId.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/SessionId.h>
 #include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
-#include <activemq/wireformat/openwire/marshal/generated/MarshallerFactory.h>
+#include <activemq/wireformat/openwire/marshal/MarshallerTable.h>
 #include <activemq/exceptions/ActiveMQException.h>
 
 using namespace std;
@@ -44,24 +56,72 @@ using namespace activemq::wireformat::openwire::marshal;
 using namespace activemq::wireformat::openwire::utils;
 using namespace decaf::io;
 using namespace decaf::util;
+using namespace decaf::util::concurrent;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Most commands repeat the same few identifiers and destinations, held encoded.
+    const std::size_t TIGHT_FORM_CACHE_SIZE = 32;
+
+    // Types whose encoding holds no nested objects and doesn't vary by version.
+    bool isTightFormType(unsigned char type) {
+        switch (type) {
+            case ProducerId::ID_PRODUCERID:
+            case ConsumerId::ID_CONSUMERID:
+            case SessionId::ID_SESSIONID:
+            case ConnectionId::ID_CONNECTIONID:
+            case BrokerId::ID_BROKERID:
+            case ActiveMQQueue::ID_ACTIVEMQQUEUE:
+            case ActiveMQTopic::ID_ACTIVEMQTOPIC:
+            case ActiveMQTempQueue::ID_ACTIVEMQTEMPQUEUE:
+            case ActiveMQTempTopic::ID_ACTIVEMQTEMPTOPIC:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char OpenWireFormat::NULL_TYPE = 0;
 const int OpenWireFormat::DEFAULT_VERSION = 1;
 const int OpenWireFormat::MAX_SUPPORTED_VERSION = 11;
+const int OpenWireFormat::MAX_CACHE_SIZE = 16383;
+const int OpenWireFormat::DEFAULT_MAX_FRAME_READ_AHEAD = 65536;
 
 ////////////////////////////////////////////////////////////////////////////////
 OpenWireFormat::OpenWireFormat(const decaf::util::Properties& properties) :
-    properties(properties), preferedWireFormatInfo(), dataMarshallers(256),
-    id(UUID::randomUUID().toString()), receiving(), version(0), stackTraceEnabled(true),
+    properties(properties), preferedWireFormatInfo(), marshallers(MarshallerTable::getShared()), ownMarshallers(NULL),
+    id(UUID::randomUUID().toString()), receiving(), marshalling(), marshalBooleans(), looseBuffer(256),
+    looseOut(&looseBuffer), unmarshalBooleans(), unmarshalArena(), maxFrameReadAhead(DEFAULT_MAX_FRAME_READ_AHEAD),
+    frameBuffer(), frameIn(), frameDataIn(&frameIn), commandPool(NULL), marshalCacheLock(),
+    marshalCache(), marshalCacheIndex(), nextMarshalCacheIndex(0), tightCacheIndexes(), tightCacheCursor(0),
+    tightForms(), nextTightForm(0), tightFormBooleans(), tightFormBuffer(), tightFormOut(&tightFormBuffer),
+    unmarshalCache(), internDestinations(true), destinationScratch(2), version(0), stackTraceEnabled(true),
     tcpNoDelayEnabled(true), cacheEnabled(true), cacheSize(1024), tightEncodingEnabled(false),
     sizePrefixDisabled(false), maxInactivityDuration(30000), maxInactivityDurationInitialDelay(10000) {
 
-    // initialize the universal marshalers, don't need to reset them again
-    // after this so its safe to do this here.
-    generated::MarshallerFactory().configure(this);
+    // The marshallers are shared by every format in the process, only a format created
+    // before the library is initialized has to build a table of its own.
+    if (this->marshallers == NULL) {
+        this->ownMarshallers = MarshallerTable::createStandard();
+        this->marshallers = this->ownMarshallers;
+    }
+
+    this->maxFrameReadAhead = Integer::parseInt(
+        properties.getProperty("wireFormat.maxFrameReadAhead", Integer::toString(DEFAULT_MAX_FRAME_READ_AHEAD)));
+
+    this->internDestinations = Boolean::parseBoolean(
+        properties.getProperty("wireFormat.internDestinations", "true"));
+
+    if (Boolean::parseBoolean(properties.getProperty("wireFormat.recycleCommands", "false"))) {
+        this->commandPool = new DataStructurePool(Integer::parseInt(
+            properties.getProperty("wireFormat.recycleCommandsLimit",
+                                   Integer::toString(DataStructurePool::DEFAULT_MAX_CACHED_BLOCKS))));
+    }
 
     // Set to Default as lowest common denominator, then we will try
     // and move up to the preferred when the wireformat is negotiated.
@@ -72,6 +132,11 @@ OpenWireFormat::OpenWireFormat(const decaf::util::Properties& properties) :
 OpenWireFormat::~OpenWireFormat() {
     try {
         this->destroyMarshalers();
+
+        if (this->commandPool != NULL) {
+            this->commandPool->close();
+            this->commandPool = NULL;
+        }
     }
     AMQ_CATCHALL_NOTHROW()
 }
@@ -90,10 +155,9 @@ Pointer<Transport> OpenWireFormat::createNegotiator(const Pointer<Transport> tra
 void OpenWireFormat::destroyMarshalers() {
 
     try {
-        for (size_t i = 0; i < dataMarshallers.size(); ++i) {
-            delete dataMarshallers[i];
-            dataMarshallers[i] = NULL;
-        }
+        delete this->ownMarshallers;
+        this->ownMarshallers = NULL;
+        this->marshallers = NULL;
     }
     AMQ_CATCH_NOTHROW(ActiveMQException)
     AMQ_CATCHALL_NOTHROW()
@@ -122,8 +186,15 @@ void OpenWireFormat::setVersion(int version) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormat::addMarshaller(DataStreamMarshaller* marshaller) {
-    unsigned char type = marshaller->getDataStructureType();
-    dataMarshallers[type & 0xFF] = marshaller;
+
+    // The shared table is never modified, the first marshaller added gives this
+    // format a table of its own that starts out with the shared marshallers.
+    if (this->ownMarshallers == NULL) {
+        this->ownMarshallers = new MarshallerTable(this->marshallers);
+        this->marshallers = this->ownMarshallers;
+    }
+
+    this->ownMarshallers->add(marshaller);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -144,67 +215,128 @@ void OpenWireFormat::marshal(const Pointer<commands::Command> command, const act
 
     try {
 
-        int size = 1;
+        if (command == NULL) {
+            dataOut->writeInt(1);
+            dataOut->writeByte(NULL_TYPE);
+            return;
+        }
+
+        const MarshaledCommand* marshaled = dynamic_cast<const MarshaledCommand*>(command.get());
+        if (marshaled != NULL) {
+
+            if (!canWriteMarshaled(*marshaled)) {
+                throw IOException(__FILE__, __LINE__,
+                    "OpenWireFormat::marshal - command was encoded for a different wire format");
+            }
+
+            // Without the cache nothing in the frame depends on earlier frames.
+            const std::vector<unsigned char>& frame = marshaled->getFrame();
+            if (!sizePrefixDisabled) {
+                dataOut->writeInt((int) frame.size());
+            }
+            dataOut->write(&frame[0], (int) frame.size());
+            return;
+        }
 
-        if (command != NULL) {
+        DataStructure* dataStructure = dynamic_cast<DataStructure*>(command.get());
 
-            DataStructure* dataStructure = dynamic_cast<DataStructure*>(command.get());
+        // The cache must change in the order the frames reach the stream.
+        Lock cacheLock(&this->marshalCacheLock, this->cacheEnabled);
 
-            unsigned char type = dataStructure->getDataStructureType();
+        if (this->marshalling.compareAndSet(false, true)) {
 
-            DataStreamMarshaller* dsm = dataMarshallers[type & 0xFF];
+            class Finally {
+            private:
 
-            if (dsm == NULL) {
-                throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(type)).c_str());
-            }
+                decaf::util::concurrent::atomic::AtomicBoolean* state;
 
-            if (tightEncodingEnabled) {
-                BooleanStream bs;
-                size += dsm->tightMarshal1(this, dataStructure, &bs);
-                size += bs.marshalledSize();
+            private:
 
-                if (!sizePrefixDisabled) {
-                    dataOut->writeInt(size);
+                Finally(const Finally&);
+                Finally& operator=(const Finally&);
+
+            public:
+
+                Finally(decaf::util::concurrent::atomic::AtomicBoolean* state) : state(state) {
                 }
 
-                dataOut->writeByte(type);
-                bs.marshal(dataOut);
-                dsm->tightMarshal2(this, dataStructure, dataOut, &bs);
+                ~Finally() {
+                    state->set(false);
+                }
+            }
 
-            } else {
+            finalizer(&(this->marshalling));
 
-                if (sizePrefixDisabled) {
-                    dataOut->writeByte(type);
-                    dsm->looseMarshal(this, dataStructure, dataOut);
-                } else {
+            this->marshalBooleans.reset();
+            this->looseBuffer.reset();
+            doMarshal(dataStructure, dataOut, &this->marshalBooleans, &this->looseBuffer, &this->looseOut);
 
-                    ByteArrayOutputStream* baos = new ByteArrayOutputStream();
-                    std::auto_ptr<DataOutputStream> looseOut(new DataOutputStream(baos, true));
+        } else {
 
-                    looseOut->writeByte(type);
-                    dsm->looseMarshal(this, dataStructure, looseOut.get());
-                    looseOut->close();
+            // Someone else is using the shared state, can't wait around for them.
+            BooleanStream bs;
+            ByteArrayOutputStream buffer;
+            DataOutputStream bufferOut(&buffer);
+            doMarshal(dataStructure, dataOut, &bs, &buffer, &bufferOut);
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
 
-                    // Now the data goes to the transport from out byte buffer.
-                    dataOut->writeInt((int) baos->size());
+////////////////////////////////////////////////////////////////////////////////
+bool OpenWireFormat::canWriteMarshaled(const MarshaledCommand& command) const {
+    return !this->cacheEnabled && !this->tightEncodingEnabled && this->version == command.getVersion();
+}
 
-                    if (baos->size() > 0) {
-                        std::pair<unsigned char*, int> array = baos->toByteArray();
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::doMarshal(DataStructure* dataStructure, DataOutputStream* dataOut, BooleanStream* bs,
+                               ByteArrayOutputStream* buffer, DataOutputStream* bufferOut) {
 
-                        try {
-                            dataOut->write(array.first, array.second);
-                        } catch (Exception& ex) {
-                            delete[] array.first;
-                            throw;
-                        }
+    try {
 
-                        delete[] array.first;
-                    }
-                }
+        unsigned char type = dataStructure->getDataStructureType();
+
+        DataStreamMarshaller* dsm = this->marshallers->get(type);
+
+        if (dsm == NULL) {
+            throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(type)).c_str());
+        }
+
+        if (tightEncodingEnabled) {
+
+            // The tight encoding places the boolean bits ahead of the data they describe
+            // so the size pass must run first, the second pass streams straight out.
+            if (cacheEnabled) {
+                this->tightCacheIndexes.clear();
+                this->tightCacheCursor = 0;
+            }
+
+            int size = 1;
+            size += dsm->tightMarshal1(this, dataStructure, bs);
+            size += bs->marshalledSize();
+
+            if (!sizePrefixDisabled) {
+                dataOut->writeInt(size);
             }
+
+            dataOut->writeByte(type);
+            bs->marshal(dataOut);
+            dsm->tightMarshal2(this, dataStructure, dataOut, bs);
+
+        } else if (sizePrefixDisabled) {
+            dataOut->writeByte(type);
+            dsm->looseMarshal(this, dataStructure, dataOut);
         } else {
-            dataOut->writeInt(size);
-            dataOut->writeByte(NULL_TYPE);
+
+            bufferOut->writeByte(type);
+            dsm->looseMarshal(this, dataStructure, bufferOut);
+
+            // Now the data goes to the transport directly from the reusable buffer.
+            dataOut->writeInt((int) buffer->size());
+            buffer->writeTo(dataOut);
         }
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -222,31 +354,139 @@ Pointer<commands::Command> OpenWireFormat::unmarshal(const activemq::transport::
             throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
         }
 
+        DataInputStream* input = dis;
+
         if (!sizePrefixDisabled) {
-            dis->readInt();
+            int size = dis->readInt();
+
+            // Take the whole frame now, so it comes off the stream in one read and
+            // doesn't leave the decode waiting on the socket part way through.
+            if (size > 0 && size <= maxFrameReadAhead) {
+
+                if ((int) frameBuffer.size() < size) {
+                    frameBuffer.resize(size);
+                }
+
+                dis->readFully(&frameBuffer[0], size);
+                frameIn.setByteArray(&frameBuffer[0], size);
+                input = &frameDataIn;
+            }
         }
 
         // Get the unmarshalled DataStructure
-        Pointer<DataStructure> data(doUnmarshal(dis));
+        std::auto_ptr<DataStructure> data(doUnmarshal(input));
 
-        if (data == NULL) {
+        if (data.get() == NULL) {
             throw IOException(__FILE__, __LINE__, "OpenWireFormat::doUnmarshal - "
                     "Failed to unmarshal an Object");
         }
 
         // Now all unmarshals from this level should result in an object
-        // that is a commands::Command type, if its not then the cast will
-        // throw an ClassCastException.
-        Pointer<Command> command = data.dynamicCast<Command>();
+        // that is a commands::Command type, the type tells us if it is.
+        if (!this->marshallers->isCommand(data->getDataStructureType())) {
+            throw IOException(__FILE__, __LINE__, "OpenWireFormat::unmarshal - "
+                    "Unmarshaled data of type %d is not a Command", (int) data->getDataStructureType());
+        }
+
+        return Pointer<Command>(static_cast<Command*>(data.release()));
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenWireFormat::isFramed() const {
+    return !this->sizePrefixDisabled &&
+           (this->preferedWireFormatInfo == NULL || !this->preferedWireFormatInfo->isSizePrefixDisabled());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::readFrame(decaf::io::DataInputStream* in, std::vector<unsigned char>& frame) {
+
+    try {
+
+        if (in == NULL) {
+            throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
+        }
 
-        return command;
+        if (!isFramed()) {
+            throw UnsupportedOperationException(__FILE__, __LINE__,
+                "OpenWireFormat::readFrame - the size prefix is disabled");
+        }
+
+        // The inactivity monitor counts a frame being read as activity the same way
+        // it does a command being unmarshaled.
+        this->receiving.set(true);
+
+        try {
+
+            int size = in->readInt();
+            if (size < 0) {
+                throw IOException(__FILE__, __LINE__,
+                    "OpenWireFormat::readFrame - Invalid frame size: %d", size);
+            }
+
+            frame.resize(size + 4);
+            frame[0] = (unsigned char) ((size >> 24) & 0xFF);
+            frame[1] = (unsigned char) ((size >> 16) & 0xFF);
+            frame[2] = (unsigned char) ((size >> 8) & 0xFF);
+            frame[3] = (unsigned char) (size & 0xFF);
+
+            if (size > 0) {
+                in->readFully(&frame[4], size);
+            }
+
+        } catch (...) {
+            this->receiving.set(false);
+            throw;
+        }
+
+        this->receiving.set(false);
     }
     AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
     AMQ_CATCH_EXCEPTION_CONVERT(ActiveMQException, IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int OpenWireFormat::getFrameLength(const unsigned char* buffer, int size) {
+
+    try {
+
+        if (!isFramed()) {
+            throw UnsupportedOperationException(__FILE__, __LINE__,
+                "OpenWireFormat::getFrameLength - the size prefix is disabled");
+        }
+
+        if (buffer == NULL || size < 4) {
+            this->receiving.set(size > 0);
+            return -1;
+        }
+
+        int frameSize = (int) (((unsigned int) buffer[0] << 24) | ((unsigned int) buffer[1] << 16) |
+                               ((unsigned int) buffer[2] << 8) | (unsigned int) buffer[3]);
+
+        if (frameSize < 0 || frameSize > Integer::MAX_VALUE - 4) {
+            this->receiving.set(false);
+            throw IOException(__FILE__, __LINE__,
+                "OpenWireFormat::getFrameLength - Invalid frame size: %d", frameSize);
+        }
+
+        // Same as readFrame, a partly received frame counts as activity.
+        this->receiving.set(size < frameSize + 4);
+
+        return frameSize + 4;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* OpenWireFormat::doUnmarshal(DataInputStream* dis) {
 
@@ -275,11 +515,17 @@ commands::DataStructure* OpenWireFormat::doUnmarshal(DataInputStream* dis) {
 
         finalizer(&(this->receiving));
 
+        // Everything created while unmarshaling this command comes from our pool.
+        DataStructurePool::Scope poolScope(this->commandPool);
+
+        // The temporaries of the previous command are all gone by now.
+        this->unmarshalArena.reset();
+
         unsigned char dataType = dis->readByte();
 
         if (dataType != NULL_TYPE) {
 
-            DataStreamMarshaller* dsm = dynamic_cast<DataStreamMarshaller*>(dataMarshallers[dataType & 0xFF]);
+            DataStreamMarshaller* dsm = this->marshallers->get(dataType);
 
             if (dsm == NULL) {
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(dataType)).c_str());
@@ -290,9 +536,8 @@ commands::DataStructure* OpenWireFormat::doUnmarshal(DataInputStream* dis) {
             std::auto_ptr<DataStructure> data(dsm->createObject());
 
             if (this->tightEncodingEnabled) {
-                BooleanStream bs;
-                bs.unmarshal(dis);
-                dsm->tightUnmarshal(this, data.get(), dis, &bs);
+                this->unmarshalBooleans.unmarshal(dis);
+                dsm->tightUnmarshal(this, data.get(), dis, &this->unmarshalBooleans);
             } else {
                 dsm->looseUnmarshal(this, data.get(), dis);
             }
@@ -332,12 +577,21 @@ int OpenWireFormat::tightMarshalNestedObject1(commands::DataStructure* object, u
             throw IOException(__FILE__, __LINE__, "No valid data structure type for object of this type");
         }
 
-        DataStreamMarshaller* dsm = dataMarshallers[type & 0xFF];
+        DataStreamMarshaller* dsm = this->marshallers->get(type);
 
         if (dsm == NULL) {
             throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(type)).c_str());
         }
 
+        // Only the marshal holding the shared state may use the held encodings.
+        if (bs == &this->marshalBooleans && isTightFormType(type)) {
+            const TightFormEntry* form = getTightForm(object, dsm);
+            if (form != NULL) {
+                bs->writeBits(form->bits, form->bitCount);
+                return 1 + (int) form->bytes.size();
+            }
+        }
+
         return 1 + dsm->tightMarshal1(this, object, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -367,12 +621,23 @@ void OpenWireFormat::tightMarshalNestedObject2(DataStructure* o, DataOutputStrea
 
         } else {
 
-            DataStreamMarshaller* dsm = dataMarshallers[type & 0xFF];
+            DataStreamMarshaller* dsm = this->marshallers->get(type);
 
             if (dsm == NULL) {
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(type)).c_str());
             }
 
+            if (bs == &this->marshalBooleans && isTightFormType(type)) {
+                const TightFormEntry* form = findTightForm(o);
+                if (form != NULL) {
+                    if (!form->bytes.empty()) {
+                        ds->write(&form->bytes[0], (int) form->bytes.size());
+                    }
+                    bs->skip(form->bitCount);
+                    return;
+                }
+            }
+
             dsm->tightMarshal2(this, o, ds, bs);
         }
     }
@@ -391,12 +656,18 @@ DataStructure* OpenWireFormat::tightUnmarshalNestedObject(DataInputStream* dis,
 
             const unsigned char dataType = dis->readByte();
 
-            DataStreamMarshaller* dsm = dataMarshallers[dataType & 0xFF];
+            DataStreamMarshaller* dsm = this->marshallers->get(dataType);
 
             if (dsm == NULL) {
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(dataType)).c_str());
             }
 
+            DataStructure* scratch = getDestinationScratch(dataType, dsm);
+            if (scratch != NULL) {
+                dsm->tightUnmarshal(this, scratch, dis, bs);
+                return internDestination(scratch);
+            }
+
             std::auto_ptr<DataStructure> data(dsm->createObject());
 
             if (data->isMarshalAware() && bs->readBoolean()) {
@@ -431,12 +702,18 @@ DataStructure* OpenWireFormat::looseUnmarshalNestedObject(decaf::io::DataInputSt
 
             unsigned char dataType = dis->readByte();
 
-            DataStreamMarshaller* dsm = dataMarshallers[dataType & 0xFF];
+            DataStreamMarshaller* dsm = this->marshallers->get(dataType);
 
             if (dsm == NULL) {
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(dataType)).c_str());
             }
 
+            DataStructure* scratch = getDestinationScratch(dataType, dsm);
+            if (scratch != NULL) {
+                dsm->looseUnmarshal(this, scratch, dis);
+                return internDestination(scratch);
+            }
+
             std::auto_ptr<DataStructure> data(dsm->createObject());
             dsm->looseUnmarshal(this, data.get(), dis);
             return data.release();
@@ -462,7 +739,7 @@ void OpenWireFormat::looseMarshalNestedObject(commands::DataStructure* o, decaf:
 
             dataOut->writeByte(dataType);
 
-            DataStreamMarshaller* dsm = dataMarshallers[dataType & 0xFF];
+            DataStreamMarshaller* dsm = this->marshallers->get(dataType);
 
             if (dsm == NULL) {
                 throw IOException(__FILE__, __LINE__, (string("OpenWireFormat::marshal - Unknown data type: ") + Integer::toString(dataType)).c_str());
@@ -477,6 +754,220 @@ void OpenWireFormat::looseMarshalNestedObject(commands::DataStructure* o, decaf:
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int OpenWireFormat::IdentityHash::operator()(const DataStructure* value) const {
+    unsigned long long address = (unsigned long long) reinterpret_cast<std::size_t>(value);
+    return (int) (address ^ (address >> 32));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short OpenWireFormat::getMarshalCacheIndex(const DataStructure* object) const {
+
+    if (object == NULL || !this->marshalCacheIndex.containsKey(object)) {
+        return -1;
+    }
+
+    short index = this->marshalCacheIndex.get(object);
+
+    // The object may have changed since it was sent or been deleted and another one
+    // created in its place, only a hit if the peer holds the same value.
+    const Pointer<DataStructure>& value = this->marshalCache[index].value;
+    if (value->getDataStructureType() != object->getDataStructureType() || !value->equals(object)) {
+        return -1;
+    }
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short OpenWireFormat::addToMarshalCache(const DataStructure* object) {
+
+    int limit = Math::min(this->cacheSize, MAX_CACHE_SIZE);
+    if (object == NULL || limit <= 0) {
+        return -1;
+    }
+
+    short index = this->nextMarshalCacheIndex;
+    if (index >= limit) {
+        index = 0;
+    }
+    this->nextMarshalCacheIndex = (short) ((index + 1) % limit);
+
+    if ((std::size_t) index < this->marshalCache.size()) {
+        const DataStructure* evicted = this->marshalCache[index].source;
+        if (this->marshalCacheIndex.containsKey(evicted) && this->marshalCacheIndex.get(evicted) == index) {
+            this->marshalCacheIndex.remove(evicted);
+        }
+    } else {
+        this->marshalCache.resize(index + 1);
+    }
+
+    MarshalCacheEntry& entry = this->marshalCache[index];
+    entry.source = object;
+    entry.value.reset(object->cloneDataStructure());
+    this->marshalCacheIndex.put(object, index);
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+short OpenWireFormat::popTightMarshalCacheIndex() {
+
+    if (this->tightCacheCursor >= this->tightCacheIndexes.size()) {
+        throw IOException(__FILE__, __LINE__, "OpenWireFormat::popTightMarshalCacheIndex - "
+                "No cache index was recorded for the object being written");
+    }
+
+    return this->tightCacheIndexes[this->tightCacheCursor++];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::setInUnmarshalCache(short index, DataStructure* object) {
+
+    // The peer ran out of room in its cache and sent the value on its own.
+    if (index == -1) {
+        return;
+    }
+
+    if (index < 0 || index >= MAX_CACHE_SIZE) {
+        throw IOException(__FILE__, __LINE__, "OpenWireFormat::setInUnmarshalCache - "
+                "Invalid cache index: %d", (int) index);
+    }
+
+    if ((std::size_t) index >= this->unmarshalCache.size()) {
+        this->unmarshalCache.resize(index + 1);
+    }
+
+    this->unmarshalCache[index].reset(object);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructure* OpenWireFormat::getFromUnmarshalCache(short index) {
+
+    if (index < 0 || (std::size_t) index >= this->unmarshalCache.size()) {
+        throw IOException(__FILE__, __LINE__, "OpenWireFormat::getFromUnmarshalCache - "
+                "No value cached under index: %d", (int) index);
+    }
+
+    return this->unmarshalCache[index].get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructure* OpenWireFormat::getDestinationScratch(unsigned char type, DataStreamMarshaller* dsm) {
+
+    if (!this->internDestinations ||
+        (type != ActiveMQQueue::ID_ACTIVEMQQUEUE && type != ActiveMQTopic::ID_ACTIVEMQTOPIC)) {
+        return NULL;
+    }
+
+    Pointer<DataStructure>& scratch = this->destinationScratch[type - ActiveMQQueue::ID_ACTIVEMQQUEUE];
+    if (scratch.get() == NULL) {
+        scratch.reset(dsm->createObject());
+    }
+
+    return scratch.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DataStructure* OpenWireFormat::internDestination(DataStructure* scratch) {
+
+    ActiveMQDestination* destination = static_cast<ActiveMQDestination*>(scratch);
+
+    ActiveMQDestination* interned = DestinationInterner::intern(*destination);
+    if (interned != NULL) {
+        return interned;
+    }
+
+    return destination->cloneDataStructure();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const OpenWireFormat::TightFormEntry* OpenWireFormat::getTightForm(DataStructure* object, DataStreamMarshaller* dsm) {
+
+    TightFormEntry* entry = NULL;
+
+    std::vector<TightFormEntry>::iterator iter = this->tightForms.begin();
+    for (; iter != this->tightForms.end(); ++iter) {
+        if (iter->source == object) {
+            entry = &(*iter);
+            break;
+        }
+    }
+
+    if (entry != NULL && entry->value->getDataStructureType() == object->getDataStructureType() &&
+        entry->value->equals(object)) {
+        return entry;
+    }
+
+    // Encode the value on its own, the bits are read back in the order written.
+    this->tightFormBooleans.reset();
+    this->tightFormBuffer.reset();
+
+    dsm->tightMarshal1(this, object, &this->tightFormBooleans);
+    int bitCount = this->tightFormBooleans.getPosition();
+    if (bitCount > 32) {
+        return NULL;
+    }
+
+    unsigned int bits = 0;
+    this->tightFormBooleans.clear();
+    for (int i = 0; i < bitCount; ++i) {
+        if (this->tightFormBooleans.readBoolean()) {
+            bits |= 0x01U << i;
+        }
+    }
+
+    this->tightFormBooleans.clear();
+    dsm->tightMarshal2(this, object, &this->tightFormOut, &this->tightFormBooleans);
+
+    if (entry == NULL) {
+        if (this->tightForms.size() < TIGHT_FORM_CACHE_SIZE) {
+            this->tightForms.push_back(TightFormEntry());
+            entry = &this->tightForms.back();
+        } else {
+            entry = &this->tightForms[this->nextTightForm];
+            this->nextTightForm = (this->nextTightForm + 1) % TIGHT_FORM_CACHE_SIZE;
+        }
+    }
+
+    std::pair<unsigned char*, int> encoded = this->tightFormBuffer.toByteArray();
+
+    entry->source = object;
+    entry->value.reset(object->cloneDataStructure());
+    entry->bits = bits;
+    entry->bitCount = bitCount;
+    entry->bytes.assign(encoded.first, encoded.first + encoded.second);
+
+    delete [] encoded.first;
+
+    return entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const OpenWireFormat::TightFormEntry* OpenWireFormat::findTightForm(const DataStructure* object) const {
+
+    std::vector<TightFormEntry>::const_iterator iter = this->tightForms.begin();
+    for (; iter != this->tightForms.end(); ++iter) {
+        if (iter->source == object) {
+            return &(*iter);
+        }
+    }
+
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormat::clearCaches() {
+
+    synchronized(&marshalCacheLock) {
+        this->marshalCache.clear();
+        this->marshalCacheIndex.clear();
+        this->nextMarshalCacheIndex = 0;
+    }
+
+    this->unmarshalCache.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormat::renegotiateWireFormat(const WireFormatInfo& info) {
 
@@ -494,4 +985,7 @@ void OpenWireFormat::renegotiateWireFormat(const WireFormatInfo& info) {
     this->cacheSize = min(info.getCacheSize(), preferedWireFormatInfo->getCacheSize());
     this->maxInactivityDuration = min(info.getMaxInactivityDuration(), preferedWireFormatInfo->getMaxInactivityDuration());
     this->maxInactivityDurationInitialDelay = min(info.getMaxInactivityDurationInitalDelay(), preferedWireFormatInfo->getMaxInactivityDurationInitalDelay());
+
+    // Anything cached so far was encoded for settings the peer may not share.
+    this->clearCaches();
 }
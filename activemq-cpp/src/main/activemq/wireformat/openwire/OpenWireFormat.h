@@ -21,11 +21,20 @@
 #include <activemq/util/Config.h>
 #include <activemq/commands/WireFormatInfo.h>
 #include <activemq/commands/DataStructure.h>
+#include <activemq/commands/DataStructurePool.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <activemq/wireformat/openwire/utils/UnmarshalArena.h>
 #include <decaf/lang/Pointer.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/HashMap.h>
 #include <decaf/util/Properties.h>
+#include <decaf/util/concurrent/Mutex.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <memory>
@@ -36,8 +45,11 @@ namespace openwire {
 
 namespace marshal {
     class DataStreamMarshaller;
+    class MarshallerTable;
 }
 
+    class MarshaledCommand;
+
     using decaf::lang::Pointer;
 
     class AMQCPP_API OpenWireFormat : public wireformat::WireFormat {
@@ -52,16 +64,57 @@ namespace marshal {
         // Defines the maximum supported openwire version
         static const int MAX_SUPPORTED_VERSION;
 
+        // Upper bound on the number of entries in the value caches, the same limit the
+        // OpenWire peers use so any index a peer sends fits in the unmarshal cache.
+        static const int MAX_CACHE_SIZE;
+
+        // Default for the largest frame that is read from the stream whole before decoding.
+        static const int DEFAULT_MAX_FRAME_READ_AHEAD;
+
     private:
 
+        struct MarshalCacheEntry {
+            // The object that was marshaled, only used as the identity of the entry.
+            const commands::DataStructure* source;
+
+            // Copy of the value that was sent, guards against a stale source address.
+            Pointer<commands::DataStructure> value;
+
+            MarshalCacheEntry() : source(NULL), value() {}
+        };
+
+        struct TightFormEntry {
+            // The object that was encoded, only used as the identity of the entry.
+            const commands::DataStructure* source;
+
+            // Copy of the value that was encoded, the source may have changed since.
+            Pointer<commands::DataStructure> value;
+
+            // The boolean bits of the encoding, first written in bit 0, and their number.
+            unsigned int bits;
+            int bitCount;
+
+            // The encoded bytes that follow the type byte.
+            std::vector<unsigned char> bytes;
+
+            TightFormEntry() : source(NULL), value(), bits(0), bitCount(0), bytes() {}
+        };
+
+        struct IdentityHash : public decaf::util::HashCodeUnaryBase<const commands::DataStructure*> {
+            int operator()(const commands::DataStructure* value) const;
+        };
+
         // Configuration parameters
         decaf::util::Properties properties;
 
         // Preferred WireFormatInfo
         Pointer<commands::WireFormatInfo> preferedWireFormatInfo;
 
-        // Marshalers
-        std::vector< marshal::DataStreamMarshaller* > dataMarshallers;
+        // Marshalers, the shared table or ownMarshallers once this format has been given
+        // marshallers of its own.  The table also flags the types that are Commands, which
+        // lets unmarshal hand out a Command without having to dynamic cast what it read.
+        const marshal::MarshallerTable* marshallers;
+        marshal::MarshallerTable* ownMarshallers;
 
         // Uniquely Generated ID, initialize in the Ctor
         std::string id;
@@ -69,6 +122,64 @@ namespace marshal {
         // Indicates when we are in the doUnmarshal call
         decaf::util::concurrent::atomic::AtomicBoolean receiving;
 
+        // Marshal state that is reused from one command to the next so that the send path
+        // doesn't allocate per command, the marshalling flag guards it against concurrent
+        // callers, a caller that loses the race falls back to a temporary set of buffers.
+        decaf::util::concurrent::atomic::AtomicBoolean marshalling;
+        utils::BooleanStream marshalBooleans;
+        decaf::io::ByteArrayOutputStream looseBuffer;
+        decaf::io::DataOutputStream looseOut;
+
+        // Boolean stream reused by the reader thread in doUnmarshal.
+        utils::BooleanStream unmarshalBooleans;
+
+        // Temporaries of the command being unmarshaled, reset by doUnmarshal for each
+        // frame.  Only touched by the reader thread.
+        utils::UnmarshalArena unmarshalArena;
+
+        // Frames whose size prefix is no larger than maxFrameReadAhead are read off the
+        // stream in one go and unmarshaled from frameBuffer by the reader thread.
+        int maxFrameReadAhead;
+        std::vector<unsigned char> frameBuffer;
+        decaf::io::ByteArrayInputStream frameIn;
+        decaf::io::DataInputStream frameDataIn;
+
+        // Pool the unmarshaled commands are drawn from, NULL unless the
+        // wireFormat.recycleCommands option is enabled.
+        commands::DataStructurePool* commandPool;
+
+        // Values marshaled with the cache enabled, once full the oldest entry is
+        // replaced.  The lock is held for the whole of each marshal so the entries
+        // change in the same order the peer reads them.
+        decaf::util::concurrent::Mutex marshalCacheLock;
+        std::vector<MarshalCacheEntry> marshalCache;
+        decaf::util::HashMap<const commands::DataStructure*, short, IdentityHash> marshalCacheIndex;
+        short nextMarshalCacheIndex;
+
+        // Indexes chosen by the size pass of a tight marshal, the write pass replays
+        // them since entries can be replaced while the size pass runs.
+        std::vector<short> tightCacheIndexes;
+        std::size_t tightCacheCursor;
+
+        // Tight encodings of the identifiers and destinations nested in most commands
+        // sent, spliced into later commands while the value doesn't change.  Only used
+        // by the marshal holding the shared marshal state, once full the oldest entry
+        // is replaced.
+        std::vector<TightFormEntry> tightForms;
+        std::size_t nextTightForm;
+        utils::BooleanStream tightFormBooleans;
+        decaf::io::ByteArrayOutputStream tightFormBuffer;
+        decaf::io::DataOutputStream tightFormOut;
+
+        // Values the peer has sent, only touched by the reader thread.
+        std::vector< Pointer<commands::DataStructure> > unmarshalCache;
+
+        // Queues and topics are decoded into these, one per type, and swapped for their
+        // interned instance unless the wireFormat.internDestinations option is false.
+        // Only touched by the reader thread.
+        bool internDestinations;
+        std::vector< Pointer<commands::DataStructure> > destinationScratch;
+
         // WireFormat Data
         int version;
         bool stackTraceEnabled;
@@ -104,7 +215,9 @@ namespace marshal {
 
         /**
          * Allows an external source to add marshalers to this object for
-         * types that may be marshaled or unmarshaled.
+         * types that may be marshaled or unmarshaled.  The format owns the marshaler,
+         * one already added for the same type is replaced and deleted.  Marshalers
+         * added to one format are never seen by the others.
          * @param marshaler - the Marshaler to add to the collection.
          */
         void addMarshaller(marshal::DataStreamMarshaller* marshaler);
@@ -114,6 +227,18 @@ namespace marshal {
          */
         virtual void marshal(const Pointer<commands::Command> command, const activemq::transport::Transport* transport, decaf::io::DataOutputStream* out);
 
+        /**
+         * Checks whether a command encoded ahead of time can be written as it is, which
+         * needs this format to use the loose encoding of the same version without the
+         * marshal cache.  Marshaling one that can't be written fails.
+         *
+         * @param command
+         *      The encoded command.
+         *
+         * @return true if the command's frame can be written by this format.
+         */
+        bool canWriteMarshaled(const MarshaledCommand& command) const;
+
         /**
          * {@inheritDoc}
          */
@@ -261,6 +386,45 @@ namespace marshal {
             return this->receiving.get();
         }
 
+        /**
+         * Commands are framed while the size prefix is on, since the negotiated setting
+         * can only turn it off when the preferred WireFormatInfo allows that too, the
+         * answer holds for the life of the connection.
+         *
+         * @return true if every command read is prefixed with its size.
+         */
+        virtual bool isFramed() const;
+
+        /**
+         * Reads the size prefix of the next command followed by the bytes it counts, the
+         * frame holds both so that it can be handed to unmarshal unchanged.
+         *
+         * @param in
+         *      The input stream to read the frame from.
+         * @param frame
+         *      The vector that is resized to hold the frame and receives its bytes.
+         *
+         * @throws IOException if an I/O error occurs or the size prefix is negative.
+         * @throws UnsupportedOperationException if the size prefix is disabled.
+         */
+        virtual void readFrame(decaf::io::DataInputStream* in, std::vector<unsigned char>& frame);
+
+        /**
+         * Decodes the size prefix at the start of the buffer, the frame length includes
+         * the four bytes of the prefix itself.
+         *
+         * @param buffer
+         *      The received bytes, starting at the beginning of a frame.
+         * @param size
+         *      The number of bytes in the buffer.
+         *
+         * @return the length of the frame or -1 if the size prefix is incomplete.
+         *
+         * @throws IOException if the size prefix is negative.
+         * @throws UnsupportedOperationException if the size prefix is disabled.
+         */
+        virtual int getFrameLength(const unsigned char* buffer, int size);
+
         /**
          * Checks if the cacheEnabled flag is on
          * @return true if the flag is on.
@@ -293,6 +457,72 @@ namespace marshal {
             this->cacheSize = value;
         }
 
+        /**
+         * Looks up the index under which an object was last sent while caching is on.
+         *
+         * @param object
+         *      The DataStructure that is to be marshaled.
+         *
+         * @return the index of the cached value or -1 if it isn't in the cache.
+         */
+        short getMarshalCacheIndex(const commands::DataStructure* object) const;
+
+        /**
+         * Adds the value of an object to the marshal cache, replacing the oldest entry
+         * once the cache is full.
+         *
+         * @param object
+         *      The DataStructure that is about to be marshaled in full.
+         *
+         * @return the index the peer should store the value under or -1 when the
+         *         negotiated cache size leaves no room for it.
+         */
+        short addToMarshalCache(const commands::DataStructure* object);
+
+        /**
+         * Stores the index picked by the size pass of a tight marshal so the write
+         * pass can write the same one.
+         *
+         * @param index
+         *      The index to be written for the current cached object.
+         */
+        void pushTightMarshalCacheIndex(short index) {
+            this->tightCacheIndexes.push_back(index);
+        }
+
+        /**
+         * @return the next index stored by pushTightMarshalCacheIndex.
+         *
+         * @throws IOException if the size pass didn't store an index for this object.
+         */
+        short popTightMarshalCacheIndex();
+
+        /**
+         * Records a value sent by the peer under the index it gave.
+         *
+         * @param index
+         *      The index the peer assigned, -1 if the peer didn't cache the value.
+         * @param object
+         *      The unmarshaled value, the cache shares ownership of it with the caller.
+         *
+         * @throws IOException if the index is out of range.
+         */
+        void setInUnmarshalCache(short index, commands::DataStructure* object);
+
+        /**
+         * Returns the value the peer stored under the given index, the instance is shared
+         * with the cache and any earlier commands that referenced it so the caller takes
+         * a reference to it and must treat it as immutable.
+         *
+         * @param index
+         *      The index sent by the peer.
+         *
+         * @return the cached DataStructure, NULL if the value the peer cached was NULL.
+         *
+         * @throws IOException if the peer never stored a value under the index.
+         */
+        commands::DataStructure* getFromUnmarshalCache(short index);
+
         /**
          * Checks if the tightEncodingEnabled flag is on
          * @return true if the flag is on.
@@ -357,8 +587,103 @@ namespace marshal {
             this->maxInactivityDurationInitialDelay = value;
         }
 
+        /**
+         * Gets the largest frame that unmarshal reads from the stream as a whole before
+         * decoding it, set with the wireFormat.maxFrameReadAhead option.
+         *
+         * @return the largest frame size in bytes that is read ahead, zero when disabled.
+         */
+        int getMaxFrameReadAhead() const {
+            return this->maxFrameReadAhead;
+        }
+
+        /**
+         * Sets the largest frame that unmarshal reads from the stream as a whole using its
+         * size prefix, the command is then decoded from memory instead of with many small
+         * reads from the stream.  Frames that are larger are decoded from the stream as
+         * they arrive, zero disables the read ahead.
+         *
+         * @param value
+         *      The largest frame size in bytes to read ahead.
+         */
+        void setMaxFrameReadAhead(int value) {
+            this->maxFrameReadAhead = value;
+        }
+
+        /**
+         * Checks if the commands unmarshaled by this wire format are recycled, when
+         * enabled the wireFormat.recycleCommands option gave this instance a pool that
+         * the memory of its unmarshaled commands is drawn from and returned to.
+         *
+         * @return true if unmarshaled commands are recycled.
+         */
+        bool isRecycleCommands() const {
+            return this->commandPool != NULL;
+        }
+
+        /**
+         * @return the pool that unmarshaled commands are drawn from, or NULL when
+         *         command recycling is disabled.
+         */
+        const commands::DataStructurePool* getCommandPool() const {
+            return this->commandPool;
+        }
+
+        /**
+         * Returns the arena the marshallers take the temporaries of the command being
+         * unmarshaled from, memory taken from it is only valid until the next command
+         * is unmarshaled.  Only for use by the reader thread during an unmarshal.
+         *
+         * @return the unmarshal arena of this wire format.
+         */
+        utils::UnmarshalArena& getUnmarshalArena() {
+            return this->unmarshalArena;
+        }
+
+        /**
+         * Checks if the queues and topics this wire format decodes are replaced by the
+         * process wide instance interned for their name, see DestinationInterner.
+         *
+         * @return true if decoded destinations are interned.
+         */
+        bool isInternDestinations() const {
+            return this->internDestinations;
+        }
+
+        /**
+         * Sets if the queues and topics this wire format decodes are interned.
+         *
+         * @param value
+         *      True to hand out the interned instance of each decoded queue and topic.
+         */
+        void setInternDestinations(bool value) {
+            this->internDestinations = value;
+        }
+
     protected:
 
+        /**
+         * Performs the marshal of a non-null command using the given scratch state, the
+         * size prefix (when enabled) is computed from the encoded length so the frame is
+         * handed to the output stream without any intermediate copies.
+         *
+         * @param dataStructure
+         *      The command to marshal.
+         * @param dataOut
+         *      The stream that receives the marshaled frame.
+         * @param bs
+         *      A cleared BooleanStream used for tight encoding.
+         * @param buffer
+         *      An empty ByteArrayOutputStream used to size loose encoded frames.
+         * @param bufferOut
+         *      The DataOutputStream that wraps buffer.
+         *
+         * @throws IOException if an error occurs during the marshal.
+         */
+        void doMarshal(commands::DataStructure* dataStructure, decaf::io::DataOutputStream* dataOut,
+                       utils::BooleanStream* bs, decaf::io::ByteArrayOutputStream* buffer,
+                       decaf::io::DataOutputStream* bufferOut);
+
         /**
          * Perform the actual unmarshal of data from the given DataInputStream
          * return the unmarshalled DataStrucutre object once done, caller takes
@@ -375,8 +700,46 @@ namespace marshal {
         commands::DataStructure* doUnmarshal(decaf::io::DataInputStream* dis);
 
         /**
-         * Cleans up all registered Marshallers and empties the dataMarshallers
-         * vector.  This should be called before a reconfiguration of the version
+         * Returns the tight encoding of a value that is always encoded the same way,
+         * encoding it when the held one is missing or out of date.
+         *
+         * @param object
+         *      The value about to be tight marshaled.
+         * @param dsm
+         *      The marshaller for the value's type.
+         *
+         * @return the encoding or NULL if the value isn't one that is held.
+         *
+         * @throws IOException if an error occurs while encoding the value.
+         */
+        const TightFormEntry* getTightForm(commands::DataStructure* object, marshal::DataStreamMarshaller* dsm);
+
+        /**
+         * @return the encoding getTightForm returned for the object in the size pass of
+         *         the current marshal, NULL if there was none or it has been replaced.
+         */
+        const TightFormEntry* findTightForm(const commands::DataStructure* object) const;
+
+        /**
+         * @return the scratch instance a queue or topic of the given type is decoded
+         *         into, NULL if destinations of the type aren't interned.
+         */
+        commands::DataStructure* getDestinationScratch(unsigned char type, marshal::DataStreamMarshaller* dsm);
+
+        /**
+         * @return the interned instance of the destination decoded into the scratch
+         *         instance, or a copy of it when it can't be interned.
+         */
+        commands::DataStructure* internDestination(commands::DataStructure* scratch);
+
+        /**
+         * Drops the values held in the marshal and unmarshal caches.
+         */
+        void clearCaches();
+
+        /**
+         * Cleans up the Marshallers this format owns and lets go of the shared
+         * ones.  This should be called before a reconfiguration of the version
          * marshallers, or on destruction of this object
          */
         void destroyMarshalers();
@@ -53,7 +53,7 @@ Pointer<WireFormat> OpenWireFormatFactory::createWireFormat(const decaf::util::P
         info->setStackTraceEnabled(
             Boolean::parseBoolean(properties.getProperty("wireFormat.stackTraceEnabled", "true")));
         info->setCacheEnabled(
-            Boolean::parseBoolean(properties.getProperty("wireFormat.cacheEnabled", "false")));
+            Boolean::parseBoolean(properties.getProperty("wireFormat.cacheEnabled", "true")));
         info->setCacheSize(
             Integer::parseInt(properties.getProperty("wireFormat.cacheSize", "1024")));
         info->setTcpNoDelayEnabled(
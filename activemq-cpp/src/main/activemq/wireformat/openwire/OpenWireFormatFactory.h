@@ -43,11 +43,16 @@ namespace openwire{
          * --------------------
          * wireFormat.stackTraceEnabled
          * wireFormat.cacheEnabled
+         * wireFormat.cacheSize
          * wireFormat.tcpNoDelayEnabled
          * wireFormat.tightEncodingEnabled
          * wireFormat.sizePrefixDisabled
          * wireFormat.maxInactivityDuration
          * wireFormat.maxInactivityDurationInitialDelay
+         * wireFormat.recycleCommands
+         * wireFormat.recycleCommandsLimit
+         * wireFormat.internDestinations
+         * wireFormat.maxFrameReadAhead
          */
         OpenWireFormatFactory() {}
 
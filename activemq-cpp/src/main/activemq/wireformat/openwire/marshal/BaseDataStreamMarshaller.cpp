@@ -27,6 +27,7 @@
 #include <decaf/lang/Long.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Pointer.h>
+#include <decaf/internal/util/StringUtils.h>
 #include <activemq/util/Config.h>
 
 using namespace std;
@@ -41,6 +42,7 @@ using namespace activemq::wireformat::openwire::utils;
 using namespace decaf::io;
 using namespace decaf::util;
 using namespace decaf::lang;
+using decaf::internal::util::StringUtils;
 
 ////////////////////////////////////////////////////////////////////////////////
 utils::HexTable BaseDataStreamMarshaller::hexTable;
@@ -48,6 +50,27 @@ utils::HexTable BaseDataStreamMarshaller::hexTable;
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn,utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            bool fullValue = bs->readBoolean();
+            short index = dataIn->readShort();
+
+            if (fullValue) {
+                DataStructure* object = wireFormat->tightUnmarshalNestedObject(dataIn, bs);
+                try {
+                    wireFormat->setInUnmarshalCache(index, object);
+                } catch (...) {
+                    // Dropped through a Pointer, an interned destination is shared.
+                    Pointer<DataStructure> dropped(object);
+                    throw;
+                }
+                return object;
+            }
+
+            return wireFormat->getFromUnmarshalCache(index);
+        }
+
         return wireFormat->tightUnmarshalNestedObject(dataIn, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -58,6 +81,23 @@ commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalCachedObject(Op
 ////////////////////////////////////////////////////////////////////////////////
 int BaseDataStreamMarshaller::tightMarshalCachedObject1(OpenWireFormat* wireFormat, commands::DataStructure* data, utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            short index = wireFormat->getMarshalCacheIndex(data);
+            bool fullValue = index == -1;
+            bs->writeBoolean(fullValue);
+
+            if (fullValue) {
+                index = wireFormat->addToMarshalCache(data);
+                wireFormat->pushTightMarshalCacheIndex(index);
+                return 2 + wireFormat->tightMarshalNestedObject1(data, bs);
+            }
+
+            wireFormat->pushTightMarshalCacheIndex(index);
+            return 2;
+        }
+
         return wireFormat->tightMarshalNestedObject1(data, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -68,6 +108,19 @@ int BaseDataStreamMarshaller::tightMarshalCachedObject1(OpenWireFormat* wireForm
 ////////////////////////////////////////////////////////////////////////////////
 void BaseDataStreamMarshaller::tightMarshalCachedObject2(OpenWireFormat* wireFormat, commands::DataStructure* data, decaf::io::DataOutputStream* dataOut,utils::BooleanStream* bs) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            // The size pass already chose the index, the cache may have changed since.
+            dataOut->writeShort(wireFormat->popTightMarshalCacheIndex());
+
+            if (bs->readBoolean()) {
+                wireFormat->tightMarshalNestedObject2(data, dataOut, bs);
+            }
+
+            return;
+        }
+
         wireFormat->tightMarshalNestedObject2(data, dataOut, bs);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -78,6 +131,23 @@ void BaseDataStreamMarshaller::tightMarshalCachedObject2(OpenWireFormat* wireFor
 ////////////////////////////////////////////////////////////////////////////////
 void BaseDataStreamMarshaller::looseMarshalCachedObject(OpenWireFormat* wireFormat, commands::DataStructure* data, decaf::io::DataOutputStream* dataOut) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            short index = wireFormat->getMarshalCacheIndex(data);
+            bool fullValue = index == -1;
+            dataOut->writeBoolean(fullValue);
+
+            if (fullValue) {
+                dataOut->writeShort(wireFormat->addToMarshalCache(data));
+                wireFormat->looseMarshalNestedObject(data, dataOut);
+            } else {
+                dataOut->writeShort(index);
+            }
+
+            return;
+        }
+
         wireFormat->looseMarshalNestedObject(data, dataOut);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -88,6 +158,27 @@ void BaseDataStreamMarshaller::looseMarshalCachedObject(OpenWireFormat* wireForm
 ////////////////////////////////////////////////////////////////////////////////
 commands::DataStructure* BaseDataStreamMarshaller::looseUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn) {
     try {
+
+        if (wireFormat->isCacheEnabled()) {
+
+            bool fullValue = dataIn->readBoolean();
+            short index = dataIn->readShort();
+
+            if (fullValue) {
+                DataStructure* object = wireFormat->looseUnmarshalNestedObject(dataIn);
+                try {
+                    wireFormat->setInUnmarshalCache(index, object);
+                } catch (...) {
+                    // Dropped through a Pointer, an interned destination is shared.
+                    Pointer<DataStructure> dropped(object);
+                    throw;
+                }
+                return object;
+            }
+
+            return wireFormat->getFromUnmarshalCache(index);
+        }
+
         return wireFormat->looseUnmarshalNestedObject(dataIn);
     }
     AMQ_CATCH_RETHROW(IOException)
@@ -167,6 +258,27 @@ std::string BaseDataStreamMarshaller::tightUnmarshalString(decaf::io::DataInputS
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string BaseDataStreamMarshaller::tightUnmarshalString(OpenWireFormat* wireFormat,
+                                                           decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs) {
+
+    try {
+
+        if (bs->readBoolean()) {
+            if (bs->readBoolean()) {
+                return this->readAsciiString(dataIn);
+            } else {
+                return this->readUTFString(wireFormat, dataIn);
+            }
+        } else {
+            return "";
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int BaseDataStreamMarshaller::tightMarshalString1(const std::string& value, utils::BooleanStream* bs) {
     try {
@@ -259,6 +371,21 @@ std::string BaseDataStreamMarshaller::looseUnmarshalString(decaf::io::DataInputS
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string BaseDataStreamMarshaller::looseUnmarshalString(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn) {
+
+    try {
+        if (dataIn->readBoolean()) {
+            return this->readUTFString(wireFormat, dataIn);
+        } else {
+            return "";
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int BaseDataStreamMarshaller::tightMarshalLong1(OpenWireFormat* wireFormat AMQCPP_UNUSED, long long value, utils::BooleanStream* bs) {
 
@@ -375,8 +502,8 @@ commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalBrokerError(Ope
 
             std::auto_ptr<BrokerError> answer(new BrokerError());
 
-            answer->setExceptionClass(tightUnmarshalString(dataIn, bs));
-            answer->setMessage(tightUnmarshalString(dataIn, bs));
+            answer->setExceptionClass(tightUnmarshalString(wireFormat, dataIn, bs));
+            answer->setMessage(tightUnmarshalString(wireFormat, dataIn, bs));
 
             if (wireFormat->isStackTraceEnabled()) {
                 short length = dataIn->readShort();
@@ -386,9 +513,9 @@ commands::DataStructure* BaseDataStreamMarshaller::tightUnmarshalBrokerError(Ope
 
                     Pointer<BrokerError::StackTraceElement> element(new BrokerError::StackTraceElement);
 
-                    element->ClassName = tightUnmarshalString(dataIn, bs);
-                    element->MethodName = tightUnmarshalString(dataIn, bs);
-                    element->FileName = tightUnmarshalString(dataIn, bs);
+                    element->ClassName = tightUnmarshalString(wireFormat, dataIn, bs);
+                    element->MethodName = tightUnmarshalString(wireFormat, dataIn, bs);
+                    element->FileName = tightUnmarshalString(wireFormat, dataIn, bs);
                     element->LineNumber = dataIn->readInt();
                     stackTrace.push_back(element);
                 }
@@ -496,8 +623,8 @@ commands::DataStructure* BaseDataStreamMarshaller::looseUnmarshalBrokerError(Ope
 
             std::auto_ptr<BrokerError> answer(new BrokerError());
 
-            answer->setExceptionClass(looseUnmarshalString(dataIn));
-            answer->setMessage(looseUnmarshalString(dataIn));
+            answer->setExceptionClass(looseUnmarshalString(wireFormat, dataIn));
+            answer->setMessage(looseUnmarshalString(wireFormat, dataIn));
 
             if (wireFormat->isStackTraceEnabled()) {
 
@@ -508,9 +635,9 @@ commands::DataStructure* BaseDataStreamMarshaller::looseUnmarshalBrokerError(Ope
 
                     Pointer<BrokerError::StackTraceElement> element(new BrokerError::StackTraceElement);
 
-                    element->ClassName = looseUnmarshalString(dataIn);
-                    element->MethodName = looseUnmarshalString(dataIn);
-                    element->FileName = looseUnmarshalString(dataIn);
+                    element->ClassName = looseUnmarshalString(wireFormat, dataIn);
+                    element->MethodName = looseUnmarshalString(wireFormat, dataIn);
+                    element->FileName = looseUnmarshalString(wireFormat, dataIn);
                     element->LineNumber = dataIn->readInt();
 
                     stackTrace.push_back(element);
@@ -612,6 +739,45 @@ std::vector<unsigned char> BaseDataStreamMarshaller::looseUnmarshalByteArray(dec
     AMQ_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshaller::tightUnmarshalByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs,
+                                                       std::vector<unsigned char>& target) {
+
+    try {
+
+        target.clear();
+        if (bs->readBoolean()) {
+            int size = dataIn->readInt();
+            if (size > 0) {
+                target.resize(size);
+                dataIn->readFully(&target[0], size);
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BaseDataStreamMarshaller::looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn, std::vector<unsigned char>& target) {
+
+    try {
+
+        target.clear();
+        if (dataIn->readBoolean()) {
+            int size = dataIn->readInt();
+            if (size > 0) {
+                target.resize(size);
+                dataIn->readFully(&target[0], size);
+            }
+        }
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<unsigned char> BaseDataStreamMarshaller::tightUnmarshalConstByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs AMQCPP_UNUSED,int size) {
 
@@ -695,16 +861,52 @@ std::string BaseDataStreamMarshaller::readAsciiString(decaf::io::DataInputStream
         std::string text;
         int size = dataIn->readShort();
 
+        // The bytes go straight into the string, ASCII needs no decoding.
         if (size > 0) {
+            const unsigned char* window = dataIn->readContiguous(size);
+            if (window != NULL) {
+                text.assign((const char*) window, size);
+            } else {
+                text.resize(size);
+                dataIn->readFully((unsigned char*) &text[0], size);
+            }
+        }
+
+        return text;
+    }
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string BaseDataStreamMarshaller::readUTFString(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn) {
 
-            std::vector<char> data(size);
-            dataIn->readFully((unsigned char*) &data[0], size);
+    try {
 
-            // Now build a string and copy data into it.
-            text.insert(text.begin(), data.begin(), data.end());
+        int length = dataIn->readUnsignedShort();
+        if (length == 0) {
+            return "";
         }
 
-        return text;
+        // Strings are nearly always ASCII, read from a frame or buffer that holds them
+        // they are copied once into the result and need no decoding.
+        const unsigned char* window = dataIn->readContiguous(length);
+        if (window != NULL && StringUtils::unencodedSpan(window, length) == (std::size_t) length) {
+            return std::string((const char*) window, length);
+        }
+
+        // Decoded characters are never longer than their encoding, decoding in the
+        // arena gives a result string of exactly the decoded size.
+        unsigned char* decoded = wireFormat->getUnmarshalArena().allocate(length);
+        if (window == NULL) {
+            dataIn->readFully(decoded, length);
+            window = decoded;
+        }
+
+        std::size_t size = StringUtils::decodeModifiedUtf8(window, length, decoded);
+
+        return std::string((const char*) decoded, size);
     }
     AMQ_CATCH_RETHROW(IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, IOException)
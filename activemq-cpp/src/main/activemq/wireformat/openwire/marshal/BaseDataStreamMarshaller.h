@@ -144,7 +144,8 @@ namespace marshal{
          * @param wireFormat - The OpenwireFormat properties
          * @param dataIn - stream to read marshaled form from
          * @param bs - boolean stream to marshal to.
-         * @return pointer to a new DataStructure Object
+         * @return pointer to a DataStructure Object, when the cache is enabled
+         *         this can be an instance shared with earlier commands.
          * @throws IOException if an error occurs.
          */
         virtual commands::DataStructure* tightUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs);
@@ -185,7 +186,8 @@ namespace marshal{
          * Loose Unmarshal the cached object
          * @param wireFormat - The OpenwireFormat properties
          * @param dataIn - stream to read marshaled form from
-         * @return pointer to a new DataStructure Object
+         * @return pointer to a DataStructure Object, when the cache is enabled
+         *         this can be an instance shared with earlier commands.
          * @throws IOException if an error occurs.
          */
         virtual commands::DataStructure* looseUnmarshalCachedObject(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn);
@@ -250,6 +252,17 @@ namespace marshal{
          */
         virtual std::string tightUnmarshalString(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs);
 
+        /**
+         * Performs Tight Unmarshaling of String Objects, decoding the encoded string in
+         * the unmarshal arena of the wire format instead of a buffer of its own.
+         * @param wireFormat - The OpenwireFormat properties
+         * @param dataIn - the DataInputStream to Un-Marshal from
+         * @param bs - boolean stream to unmarshal from.
+         * @return the unmarshaled string.
+         * @throws IOException if an error occurs.
+         */
+        virtual std::string tightUnmarshalString(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs);
+
         /**
          * Tight Marshals the String to a Booleans Stream Object, returns
          * the marshaled size.
@@ -285,6 +298,16 @@ namespace marshal{
          */
         virtual std::string looseUnmarshalString(decaf::io::DataInputStream* dataIn);
 
+        /**
+         * Loose Un-Marshal the String to the DataOuputStream passed, decoding the encoded
+         * string in the unmarshal arena of the wire format instead of a buffer of its own.
+         * @param wireFormat - The OpenwireFormat properties
+         * @param dataIn - stream to read marshaled form from
+         * @return the unmarshaled string
+         * @throws IOException if an error occurs.
+         */
+        virtual std::string looseUnmarshalString(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn);
+
         /**
          * Tightly marshal the long long to the BooleanStream passed.
          * @param wireFormat - The OpenwireFormat properties
@@ -350,6 +373,27 @@ namespace marshal{
          */
         virtual std::vector<unsigned char> looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn);
 
+        /**
+         * Tight Unmarshal an array of char directly into the given vector, the bytes are
+         * read from the stream straight into the vector's storage which avoids the copy
+         * that results from unmarshaling to a temporary and then assigning it.
+         * @param dataIn - the DataInputStream to Un-Marshal from
+         * @param bs - boolean stream to unmarshal from.
+         * @param target - the vector that receives the unmarshaled bytes.
+         * @throws IOException if an error occurs.
+         */
+        virtual void tightUnmarshalByteArray(decaf::io::DataInputStream* dataIn, utils::BooleanStream* bs,
+                                             std::vector<unsigned char>& target);
+
+        /**
+         * Loose Unmarshal an array of char directly into the given vector, the bytes are
+         * read from the stream straight into the vector's storage.
+         * @param dataIn - the DataInputStream to Un-Marshal from
+         * @param target - the vector that receives the unmarshaled bytes.
+         * @throws IOException if an error occurs.
+         */
+        virtual void looseUnmarshalByteArray(decaf::io::DataInputStream* dataIn, std::vector<unsigned char>& target);
+
         /**
          * Tight Unmarshal a fixed size array from that data input stream
          * and return an stl vector of char as the resultant.
@@ -518,6 +562,17 @@ namespace marshal{
          */
         virtual std::string readAsciiString(decaf::io::DataInputStream* dataIn);
 
+        /**
+         * Reads a modified UTF-8 string as DataInputStream::readUTF does.  An ASCII
+         * string the stream holds contiguously is copied straight into the result,
+         * otherwise the string is decoded in the unmarshal arena of the wire format, so
+         * either way the only allocation is the returned string.
+         * @param wireFormat - The OpenwireFormat whose arena is used
+         * @param dataIn - DataInputStream to read from
+         * @return string value read from stream
+         */
+        std::string readUTFString(OpenWireFormat* wireFormat, decaf::io::DataInputStream* dataIn);
+
     };
 
 }}}}
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MarshallerTable.h"
+
+#include <activemq/commands/Command.h>
+#include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/MessageFastPathMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQTextMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/MarshallerFactory.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <memory>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SharedTable {
+    private:
+
+        SharedTable(const SharedTable&);
+        SharedTable& operator=(const SharedTable&);
+
+    public:
+
+        Mutex mutex;
+        MarshallerTable* table;
+
+        SharedTable() : mutex(), table(NULL) {}
+
+        ~SharedTable() {
+            delete table;
+        }
+    };
+
+    SharedTable* shared = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshallerTable::MarshallerTable() : marshallers(256), commandTypes(256, false), owned(256, false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshallerTable::MarshallerTable(const MarshallerTable* base) :
+    marshallers(base->marshallers), commandTypes(base->commandTypes), owned(256, false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshallerTable::~MarshallerTable() {
+    for (std::size_t i = 0; i < this->marshallers.size(); ++i) {
+        if (this->owned[i]) {
+            delete this->marshallers[i];
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTable::add(DataStreamMarshaller* marshaller) {
+
+    unsigned char type = marshaller->getDataStructureType();
+
+    DataStreamMarshaller* replaced = this->marshallers[type];
+    if (replaced != marshaller) {
+        if (this->owned[type]) {
+            delete replaced;
+        }
+        this->marshallers[type] = marshaller;
+        this->owned[type] = true;
+    }
+
+    std::auto_ptr<DataStructure> sample(marshaller->createObject());
+    this->commandTypes[type] = dynamic_cast<Command*>(sample.get()) != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MarshallerTable* MarshallerTable::createStandard() {
+
+    std::auto_ptr<MarshallerTable> table(new MarshallerTable());
+    generated::MarshallerFactory().configure(table.get());
+
+    // The message types producers send most get marshallers that skip the unset fields.
+    table->add(new MessageFastPathMarshaller<generated::ActiveMQTextMessageMarshaller>());
+    table->add(new MessageFastPathMarshaller<generated::ActiveMQBytesMessageMarshaller>());
+
+    return table.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const MarshallerTable* MarshallerTable::getShared() {
+
+    if (shared == NULL) {
+        return NULL;
+    }
+
+    synchronized(&shared->mutex) {
+        if (shared->table == NULL) {
+            shared->table = createStandard();
+        }
+    }
+
+    return shared->table;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTable::initialize() {
+    shared = new SharedTable();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTable::shutdown() {
+    SharedTable* old = shared;
+    shared = NULL;
+    delete old;
+}
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MARSHALLERTABLE_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MARSHALLERTABLE_H_
+
+#include <activemq/util/Config.h>
+
+#include <vector>
+
+namespace activemq {
+namespace library {
+    class ActiveMQCPP;
+}
+namespace wireformat {
+namespace openwire {
+namespace marshal {
+
+    class DataStreamMarshaller;
+
+    /**
+     * Maps each data structure type to the marshaller of that type and records which of
+     * the types are Commands.
+     *
+     * The marshallers hold no state of their own, so one standard table serves every
+     * OpenWireFormat in the process.  It is built the first time a wire format asks for
+     * it and is never modified afterwards.  A wire format that is given marshallers of
+     * its own derives a private table from the standard one, which refers to the shared
+     * marshallers and owns only the ones added to it.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API MarshallerTable {
+    private:
+
+        std::vector<DataStreamMarshaller*> marshallers;
+        std::vector<bool> commandTypes;
+        std::vector<bool> owned;
+
+    private:
+
+        MarshallerTable(const MarshallerTable&);
+        MarshallerTable& operator=(const MarshallerTable&);
+
+    public:
+
+        /**
+         * Creates a table with no marshallers.
+         */
+        MarshallerTable();
+
+        /**
+         * Creates a table that starts out with the marshallers of another.  The table
+         * refers to those marshallers without owning them, the base table must outlive it.
+         *
+         * @param base
+         *      The table whose entries are copied.
+         */
+        explicit MarshallerTable(const MarshallerTable* base);
+
+        virtual ~MarshallerTable();
+
+        /**
+         * Adds a marshaller for the type it marshals, the table takes ownership of it.  A
+         * marshaller the table owns for the same type is replaced and deleted.
+         *
+         * @param marshaller
+         *      The marshaller to add.
+         */
+        void add(DataStreamMarshaller* marshaller);
+
+        /**
+         * @return the marshaller of the given type or NULL if there is none.
+         */
+        DataStreamMarshaller* get(unsigned char type) const {
+            return this->marshallers[type];
+        }
+
+        /**
+         * @return true if the given type has a marshaller and is a Command.
+         */
+        bool isCommand(unsigned char type) const {
+            return this->commandTypes[type];
+        }
+
+        /**
+         * Creates a table holding the generated marshallers of every type, with the fast
+         * path marshallers for the message types producers send most.
+         *
+         * @return a new table the caller owns.
+         */
+        static MarshallerTable* createStandard();
+
+        /**
+         * Returns the process wide standard table, it is built on the first call.
+         *
+         * @return the shared table, or NULL if the library isn't initialized.
+         */
+        static const MarshallerTable* getShared();
+
+    private:
+
+        static void initialize();
+
+        static void shutdown();
+
+        friend class activemq::library::ActiveMQCPP;
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MARSHALLERTABLE_H_ */
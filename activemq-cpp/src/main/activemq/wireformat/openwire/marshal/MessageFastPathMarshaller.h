@@ -0,0 +1,250 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MESSAGEFASTPATHMARSHALLER_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MESSAGEFASTPATHMARSHALLER_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/commands/Message.h>
+#include <activemq/exceptions/ActiveMQException.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/marshal/generated/BaseCommandMarshaller.h>
+#include <activemq/wireformat/openwire/utils/BooleanStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/IOException.h>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace marshal {
+
+    /**
+     * Tight marshals the messages of the generated marshaller it extends without walking
+     * the message fields that producers never set.
+     *
+     * A message that has no original destination or transaction, no nested data structure,
+     * target consumer, broker path or cluster, no arrival or broker times and no user ID
+     * encodes those fields as a fixed run of boolean bits, with a -1 cache index for the
+     * cached ones when the cache is enabled.  Those runs are written and skipped as a
+     * whole, the rest of the message is encoded as the generated marshaller does and the
+     * output is byte for byte the same.  Messages with any of the rare fields set, as
+     * the ones a broker forwards, are passed to the generated marshaller.
+     *
+     * @since 3.9.0
+     */
+    template<typename Generated>
+    class MessageFastPathMarshaller : public Generated {
+    public:
+
+        MessageFastPathMarshaller() : Generated() {}
+
+        virtual ~MessageFastPathMarshaller() {}
+
+        virtual int tightMarshal1(OpenWireFormat* wireFormat, commands::DataStructure* dataStructure, utils::BooleanStream* bs) {
+
+            try {
+
+                // Only registered for this marshaller's own type, always a Message.  The
+                // fields are read through a const pointer so the rare ones aren't allocated.
+                commands::Message* message = static_cast<commands::Message*>(dataStructure);
+                const commands::Message* info = message;
+
+                if (!isCommonShape(info)) {
+                    return Generated::tightMarshal1(wireFormat, dataStructure, bs);
+                }
+
+                message->beforeMarshal(wireFormat);
+                int rc = this->generated::BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
+
+                int wireVersion = wireFormat->getVersion();
+
+                rc += this->tightMarshalCachedObject1(wireFormat, info->getProducerId().get(), bs);
+                rc += this->tightMarshalCachedObject1(wireFormat, info->getDestination().get(), bs);
+                rc += this->tightMarshalCachedObject1(wireFormat, info->getTransactionId().get(), bs);
+                rc += nullCachedObject1(wireFormat, bs);
+                rc += this->tightMarshalNestedObject1(wireFormat, info->getMessageId().get(), bs);
+                rc += nullCachedObject1(wireFormat, bs);
+                rc += this->tightMarshalString1(info->getGroupID(), bs);
+                rc += this->tightMarshalString1(info->getCorrelationId(), bs);
+                bs->writeBoolean(info->isPersistent());
+                rc += this->tightMarshalLong1(wireFormat, info->getExpiration(), bs);
+                rc += this->tightMarshalNestedObject1(wireFormat, info->getReplyTo().get(), bs);
+                rc += this->tightMarshalLong1(wireFormat, info->getTimestamp(), bs);
+                rc += this->tightMarshalString1(info->getType(), bs);
+
+                int contentSize = (int) info->getContentBytes().size();
+                bs->writeBoolean(contentSize != 0);
+                rc += contentSize == 0 ? 0 : contentSize + 4;
+
+                int propertiesSize = (int) info->getMarshalledProperties().size();
+                bs->writeBoolean(propertiesSize != 0);
+                rc += propertiesSize == 0 ? 0 : propertiesSize + 4;
+
+                // No nested data structure.
+                bs->writeBoolean(false);
+                rc += nullCachedObject1(wireFormat, bs);
+
+                bs->writeBits(tailBits(info, wireVersion), tailLength(wireVersion));
+
+                return rc + 9;
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        virtual void tightMarshal2(OpenWireFormat* wireFormat, commands::DataStructure* dataStructure,
+                                   decaf::io::DataOutputStream* dataOut, utils::BooleanStream* bs) {
+
+            try {
+
+                commands::Message* message = static_cast<commands::Message*>(dataStructure);
+                const commands::Message* info = message;
+
+                // Nothing changes the rare fields between the passes, both take the same path.
+                if (!isCommonShape(info)) {
+                    Generated::tightMarshal2(wireFormat, dataStructure, dataOut, bs);
+                    return;
+                }
+
+                this->generated::BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs);
+
+                this->tightMarshalCachedObject2(wireFormat, info->getProducerId().get(), dataOut, bs);
+                this->tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
+                this->tightMarshalCachedObject2(wireFormat, info->getTransactionId().get(), dataOut, bs);
+                nullCachedObject2(wireFormat, dataOut, bs);
+                this->tightMarshalNestedObject2(wireFormat, info->getMessageId().get(), dataOut, bs);
+                nullCachedObject2(wireFormat, dataOut, bs);
+                this->tightMarshalString2(info->getGroupID(), dataOut, bs);
+                dataOut->writeInt(info->getGroupSequence());
+                this->tightMarshalString2(info->getCorrelationId(), dataOut, bs);
+                bs->skip(1);
+                this->tightMarshalLong2(wireFormat, info->getExpiration(), dataOut, bs);
+                dataOut->write(info->getPriority());
+                this->tightMarshalNestedObject2(wireFormat, info->getReplyTo().get(), dataOut, bs);
+                this->tightMarshalLong2(wireFormat, info->getTimestamp(), dataOut, bs);
+                this->tightMarshalString2(info->getType(), dataOut, bs);
+
+                if (bs->readBoolean()) {
+                    const util::CopyOnWriteBytes& content = info->getContentBytes();
+                    dataOut->writeInt((int) content.size());
+                    dataOut->write(content.data(), (int) content.size(), 0, (int) content.size());
+                }
+
+                if (bs->readBoolean()) {
+                    const std::vector<unsigned char>& properties = info->getMarshalledProperties();
+                    dataOut->writeInt((int) properties.size());
+                    dataOut->write(&properties[0], (int) properties.size(), 0, (int) properties.size());
+                }
+
+                bs->skip(1);
+                nullCachedObject2(wireFormat, dataOut, bs);
+
+                // The redelivery counter follows the compressed bit, the first of the tail.
+                bs->skip(1);
+                dataOut->writeInt(info->getRedeliveryCounter());
+                bs->skip(tailLength(wireFormat->getVersion()) - 1);
+
+                message->afterMarshal(wireFormat);
+            }
+            AMQ_CATCH_RETHROW(decaf::io::IOException)
+            AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
+            AMQ_CATCHALL_THROW(decaf::io::IOException)
+        }
+
+        /**
+         * @return true if none of the fields producers leave unset are set on the message.
+         */
+        static bool isCommonShape(const commands::Message* info) {
+            return info->getOriginalDestination().get() == NULL &&
+                   info->getOriginalTransactionId().get() == NULL &&
+                   info->getDataStructure().get() == NULL &&
+                   info->getTargetConsumerId().get() == NULL &&
+                   info->getBrokerPath().empty() &&
+                   info->getCluster().empty() &&
+                   info->getArrival() == 0 &&
+                   info->getBrokerInTime() == 0 &&
+                   info->getBrokerOutTime() == 0 &&
+                   info->getUserID().empty();
+        }
+
+    private:
+
+        // A NULL cached object, flagged as a full value holding nothing when the cache
+        // is on so it takes the -1 index, a single false bit otherwise.
+        static int nullCachedObject1(OpenWireFormat* wireFormat, utils::BooleanStream* bs) {
+
+            if (wireFormat->isCacheEnabled()) {
+                bs->writeBits(0x01, 2);
+                return 2;
+            }
+
+            bs->writeBoolean(false);
+            return 0;
+        }
+
+        static void nullCachedObject2(OpenWireFormat* wireFormat, decaf::io::DataOutputStream* dataOut, utils::BooleanStream* bs) {
+
+            if (wireFormat->isCacheEnabled()) {
+                dataOut->writeShort(-1);
+                bs->skip(2);
+                return;
+            }
+
+            bs->skip(1);
+        }
+
+        // The bits from the compressed flag to the end of the message: compressed, the
+        // empty broker path, zero arrival, empty user ID, the DF bridge flag, then by
+        // version droppable, the empty cluster, zero broker in and out times and the
+        // group first flag.
+        static int tailLength(int wireVersion) {
+            return 6 + (wireVersion >= 2 ? 1 : 0) + (wireVersion >= 3 ? 5 : 0) + (wireVersion >= 10 ? 1 : 0);
+        }
+
+        static unsigned int tailBits(const commands::Message* info, int wireVersion) {
+
+            unsigned int bits = 0;
+            int position = 6;
+
+            if (info->isCompressed()) {
+                bits |= 0x01;
+            }
+            if (info->isRecievedByDFBridge()) {
+                bits |= 0x01 << 5;
+            }
+            if (wireVersion >= 2) {
+                if (info->isDroppable()) {
+                    bits |= 0x01 << position;
+                }
+                position++;
+            }
+            if (wireVersion >= 3) {
+                position += 5;
+            }
+            if (wireVersion >= 10 && info->isJMSXGroupFirstForConsumer()) {
+                bits |= 0x01 << position;
+            }
+
+            return bits;
+        }
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_MARSHAL_MESSAGEFASTPATHMARSHALLER_H_ */
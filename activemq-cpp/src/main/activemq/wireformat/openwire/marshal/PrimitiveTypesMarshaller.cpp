@@ -21,6 +21,7 @@
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
+#include <decaf/io/EOFException.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <decaf/lang/Short.h>
 
@@ -38,6 +39,13 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MAX_RESERVED_ELEMENTS = 4096;
+
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PrimitiveTypesMarshaller::marshal(const PrimitiveMap* map, std::vector<unsigned char>& buffer) {
 
@@ -182,6 +190,46 @@ PrimitiveList* PrimitiveTypesMarshaller::unmarshalList(DataInputStream& dataIn)
     AMQ_CATCHALL_THROW(decaf::lang::Exception)
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void PrimitiveTypesMarshaller::indexMap(const unsigned char* buffer, int length, std::map<std::string, int>& offsets) {
+
+    try {
+
+        ByteArrayInputStream bytesIn(buffer, length);
+        DataInputStream dataIn(&bytesIn);
+
+        int size = dataIn.readInt();
+        for (int i = 0; i < size; i++) {
+            std::string key = dataIn.readUTF();
+            offsets[key] = length - bytesIn.available();
+            skipPrimitive(dataIn);
+        }
+    }
+    AMQ_CATCH_RETHROW(io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
+    AMQ_CATCHALL_THROW(io::IOException)
+}
+
+///////////////////////////////////////////////////////////////////////////////
+PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(const unsigned char* buffer, int length, int offset) {
+
+    try {
+
+        if (offset < 0 || offset >= length) {
+            throw IOException(__FILE__, __LINE__, "PrimitiveTypesMarshaller::unmarshalPrimitive - "
+                    "Offset %d is outside of the buffer", offset);
+        }
+
+        ByteArrayInputStream bytesIn(buffer, length, offset, length - offset);
+        DataInputStream dataIn(&bytesIn);
+
+        return unmarshalPrimitive(dataIn);
+    }
+    AMQ_CATCH_RETHROW(io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
+    AMQ_CATCHALL_THROW(io::IOException)
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void PrimitiveTypesMarshaller::marshalPrimitiveMap(decaf::io::DataOutputStream& dataOut, const decaf::util::Map<std::string, PrimitiveValueNode>& map) {
 
@@ -336,11 +384,18 @@ void PrimitiveTypesMarshaller::unmarshalPrimitiveMap(decaf::io::DataInputStream&
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void PrimitiveTypesMarshaller::unmarshalPrimitiveList(decaf::io::DataInputStream& dataIn, decaf::util::LinkedList<PrimitiveValueNode>& list) {
+void PrimitiveTypesMarshaller::unmarshalPrimitiveList(decaf::io::DataInputStream& dataIn, PrimitiveList& list) {
 
     try {
 
         int size = dataIn.readInt();
+
+        // The size comes off the wire so only a bounded amount is reserved up front,
+        // a larger list still grows as its elements are actually read.
+        if (size > 0) {
+            list.ensureCapacity(list.size() + (size < MAX_RESERVED_ELEMENTS ? size : MAX_RESERVED_ELEMENTS));
+        }
+
         while (size-- > 0) {
             list.add(unmarshalPrimitive(dataIn));
         }
@@ -444,3 +499,72 @@ PrimitiveValueNode PrimitiveTypesMarshaller::unmarshalPrimitive(io::DataInputStr
     AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
     AMQ_CATCHALL_THROW(io::IOException)
 }
+
+///////////////////////////////////////////////////////////////////////////////
+void PrimitiveTypesMarshaller::skipPrimitive(io::DataInputStream& dataIn) {
+
+    try {
+
+        unsigned char type = dataIn.readByte();
+        long long length = 0;
+
+        switch (type) {
+
+            case PrimitiveValueNode::NULL_TYPE:
+                break;
+            case PrimitiveValueNode::BYTE_TYPE:
+            case PrimitiveValueNode::BOOLEAN_TYPE:
+                length = 1;
+                break;
+            case PrimitiveValueNode::CHAR_TYPE:
+                length = 3;
+                break;
+            case PrimitiveValueNode::SHORT_TYPE:
+                length = 2;
+                break;
+            case PrimitiveValueNode::INTEGER_TYPE:
+            case PrimitiveValueNode::FLOAT_TYPE:
+                length = 4;
+                break;
+            case PrimitiveValueNode::LONG_TYPE:
+            case PrimitiveValueNode::DOUBLE_TYPE:
+                length = 8;
+                break;
+            case PrimitiveValueNode::STRING_TYPE:
+                length = dataIn.readShort();
+                break;
+            case PrimitiveValueNode::BYTE_ARRAY_TYPE:
+            case PrimitiveValueNode::BIG_STRING_TYPE:
+                length = dataIn.readInt();
+                break;
+            case PrimitiveValueNode::LIST_TYPE: {
+                int size = dataIn.readInt();
+                while (size-- > 0) {
+                    skipPrimitive(dataIn);
+                }
+                break;
+            }
+            case PrimitiveValueNode::MAP_TYPE: {
+                int size = dataIn.readInt();
+                while (size-- > 0) {
+                    dataIn.readUTF();
+                    skipPrimitive(dataIn);
+                }
+                break;
+            }
+            default:
+                throw IOException(
+                __FILE__,
+                __LINE__, "PrimitiveTypesMarshaller::skipPrimitive - "
+                        "Unsupported data type: %d", (int) type);
+        }
+
+        if (length > 0 && dataIn.skip(length) != length) {
+            throw EOFException(__FILE__, __LINE__, "PrimitiveTypesMarshaller::skipPrimitive - "
+                    "Value extends past the end of the data");
+        }
+    }
+    AMQ_CATCH_RETHROW(io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(Exception, io::IOException)
+    AMQ_CATCHALL_THROW(io::IOException)
+}
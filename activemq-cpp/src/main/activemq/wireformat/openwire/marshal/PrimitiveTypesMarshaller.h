@@ -26,6 +26,7 @@
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/IOException.h>
+#include <map>
 #include <string>
 
 namespace activemq{
@@ -142,6 +143,39 @@ namespace marshal{
          */
         static util::PrimitiveList* unmarshalList( decaf::io::DataInputStream& dataIn );
 
+        /**
+         * Finds where the value of each entry of a marshaled map starts without
+         * decoding any of the values.
+         *
+         * @param buffer
+         *      The marshaled Map.
+         * @param length
+         *      The number of bytes in the buffer.
+         * @param offsets
+         *      Receives the offset of each entry's value by key, a key that appears
+         *      twice maps to its last value as it does when the map is unmarshaled.
+         *
+         * @throws IOException if the buffer doesn't hold a valid marshaled map.
+         */
+        static void indexMap( const unsigned char* buffer, int length, std::map<std::string, int>& offsets );
+
+        /**
+         * Unmarshals the single value that starts at the given offset of a buffer, as
+         * found by indexMap.
+         *
+         * @param buffer
+         *      The marshaled data.
+         * @param length
+         *      The number of bytes in the buffer.
+         * @param offset
+         *      The offset of the value's type byte.
+         *
+         * @return a PrimitiveValueNode containing the value.
+         *
+         * @throws IOException if the buffer doesn't hold a valid value at the offset.
+         */
+        static util::PrimitiveValueNode unmarshalPrimitive( const unsigned char* buffer, int length, int offset );
+
     protected:
 
         /**
@@ -200,7 +234,7 @@ namespace marshal{
          */
         static void unmarshalPrimitiveList(
             decaf::io::DataInputStream& dataIn,
-            decaf::util::LinkedList<util::PrimitiveValueNode>& list );
+            util::PrimitiveList& list );
 
         /**
          * Unmarshals a Primitive Type from the stream, and returns it as a
@@ -212,6 +246,14 @@ namespace marshal{
          */
         static util::PrimitiveValueNode unmarshalPrimitive( decaf::io::DataInputStream& dataIn );
 
+        /**
+         * Reads past a marshaled Primitive Type without decoding it.
+         * @param dataIn - DataInputStream to read from.
+         *
+         * @throws IOException if an I/O error occurs during this operation.
+         */
+        static void skipPrimitive( decaf::io::DataInputStream& dataIn );
+
     };
 
 }}}}
@@ -58,15 +58,15 @@ void ActiveMQBlobMessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, D
         MessageMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ActiveMQBlobMessage* info =
-            dynamic_cast<ActiveMQBlobMessage*>(dataStructure);
+            static_cast<ActiveMQBlobMessage*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         if (wireVersion >= 3) {
-            info->setRemoteBlobUrl(tightUnmarshalString(dataIn, bs));
+            info->setRemoteBlobUrl(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 3) {
-            info->setMimeType(tightUnmarshalString(dataIn, bs));
+            info->setMimeType(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 3) {
             info->setDeletedByBroker(bs->readBoolean());
@@ -83,7 +83,7 @@ int ActiveMQBlobMessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, Dat
     try {
 
         ActiveMQBlobMessage* info =
-            dynamic_cast<ActiveMQBlobMessage*>(dataStructure);
+            static_cast<ActiveMQBlobMessage*>(dataStructure);
 
         int rc = MessageMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -114,7 +114,7 @@ void ActiveMQBlobMessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Da
         MessageMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ActiveMQBlobMessage* info =
-            dynamic_cast<ActiveMQBlobMessage*>(dataStructure);
+            static_cast<ActiveMQBlobMessage*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -140,15 +140,15 @@ void ActiveMQBlobMessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, D
 
         MessageMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ActiveMQBlobMessage* info =
-            dynamic_cast<ActiveMQBlobMessage*>(dataStructure);
+            static_cast<ActiveMQBlobMessage*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         if (wireVersion >= 3) {
-            info->setRemoteBlobUrl(looseUnmarshalString(dataIn));
+            info->setRemoteBlobUrl(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 3) {
-            info->setMimeType(looseUnmarshalString(dataIn));
+            info->setMimeType(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 3) {
             info->setDeletedByBroker(dataIn->readBoolean());
@@ -165,7 +165,7 @@ void ActiveMQBlobMessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, Dat
     try {
 
         ActiveMQBlobMessage* info =
-            dynamic_cast<ActiveMQBlobMessage*>(dataStructure);
+            static_cast<ActiveMQBlobMessage*>(dataStructure);
         MessageMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,7 +58,7 @@ void ActiveMQObjectMessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat,
         MessageMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ActiveMQObjectMessage* info =
-            dynamic_cast<ActiveMQObjectMessage*>(dataStructure);
+            static_cast<ActiveMQObjectMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
 
 
@@ -75,7 +75,7 @@ int ActiveMQObjectMessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, D
     try {
 
         ActiveMQObjectMessage* info =
-            dynamic_cast<ActiveMQObjectMessage*>(dataStructure);
+            static_cast<ActiveMQObjectMessage*>(dataStructure);
 
         info->beforeMarshal(wireFormat);
         int rc = MessageMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
@@ -95,7 +95,7 @@ void ActiveMQObjectMessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat,
         MessageMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ActiveMQObjectMessage* info =
-            dynamic_cast<ActiveMQObjectMessage*>(dataStructure);
+            static_cast<ActiveMQObjectMessage*>(dataStructure);
         info->afterMarshal(wireFormat);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -110,7 +110,7 @@ void ActiveMQObjectMessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat,
 
         MessageMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ActiveMQObjectMessage* info =
-            dynamic_cast<ActiveMQObjectMessage*>(dataStructure);
+            static_cast<ActiveMQObjectMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
         info->afterUnmarshal(wireFormat);
     }
@@ -125,7 +125,7 @@ void ActiveMQObjectMessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, D
     try {
 
         ActiveMQObjectMessage* info =
-            dynamic_cast<ActiveMQObjectMessage*>(dataStructure);
+            static_cast<ActiveMQObjectMessage*>(dataStructure);
         info->beforeMarshal(wireFormat);
         MessageMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         info->afterMarshal(wireFormat);
@@ -58,7 +58,7 @@ void ActiveMQStreamMessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat,
         MessageMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ActiveMQStreamMessage* info =
-            dynamic_cast<ActiveMQStreamMessage*>(dataStructure);
+            static_cast<ActiveMQStreamMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
 
 
@@ -75,7 +75,7 @@ int ActiveMQStreamMessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, D
     try {
 
         ActiveMQStreamMessage* info =
-            dynamic_cast<ActiveMQStreamMessage*>(dataStructure);
+            static_cast<ActiveMQStreamMessage*>(dataStructure);
 
         info->beforeMarshal(wireFormat);
         int rc = MessageMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
@@ -95,7 +95,7 @@ void ActiveMQStreamMessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat,
         MessageMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ActiveMQStreamMessage* info =
-            dynamic_cast<ActiveMQStreamMessage*>(dataStructure);
+            static_cast<ActiveMQStreamMessage*>(dataStructure);
         info->afterMarshal(wireFormat);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -110,7 +110,7 @@ void ActiveMQStreamMessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat,
 
         MessageMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ActiveMQStreamMessage* info =
-            dynamic_cast<ActiveMQStreamMessage*>(dataStructure);
+            static_cast<ActiveMQStreamMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
         info->afterUnmarshal(wireFormat);
     }
@@ -125,7 +125,7 @@ void ActiveMQStreamMessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, D
     try {
 
         ActiveMQStreamMessage* info =
-            dynamic_cast<ActiveMQStreamMessage*>(dataStructure);
+            static_cast<ActiveMQStreamMessage*>(dataStructure);
         info->beforeMarshal(wireFormat);
         MessageMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         info->afterMarshal(wireFormat);
@@ -58,7 +58,7 @@ void ActiveMQTextMessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, D
         MessageMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ActiveMQTextMessage* info =
-            dynamic_cast<ActiveMQTextMessage*>(dataStructure);
+            static_cast<ActiveMQTextMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
 
 
@@ -75,7 +75,7 @@ int ActiveMQTextMessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, Dat
     try {
 
         ActiveMQTextMessage* info =
-            dynamic_cast<ActiveMQTextMessage*>(dataStructure);
+            static_cast<ActiveMQTextMessage*>(dataStructure);
 
         info->beforeMarshal(wireFormat);
         int rc = MessageMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
@@ -95,7 +95,7 @@ void ActiveMQTextMessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Da
         MessageMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ActiveMQTextMessage* info =
-            dynamic_cast<ActiveMQTextMessage*>(dataStructure);
+            static_cast<ActiveMQTextMessage*>(dataStructure);
         info->afterMarshal(wireFormat);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -110,7 +110,7 @@ void ActiveMQTextMessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, D
 
         MessageMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ActiveMQTextMessage* info =
-            dynamic_cast<ActiveMQTextMessage*>(dataStructure);
+            static_cast<ActiveMQTextMessage*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
         info->afterUnmarshal(wireFormat);
     }
@@ -125,7 +125,7 @@ void ActiveMQTextMessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, Dat
     try {
 
         ActiveMQTextMessage* info =
-            dynamic_cast<ActiveMQTextMessage*>(dataStructure);
+            static_cast<ActiveMQTextMessage*>(dataStructure);
         info->beforeMarshal(wireFormat);
         MessageMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         info->afterMarshal(wireFormat);
@@ -58,8 +58,8 @@ void BrokerIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructur
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         BrokerId* info =
-            dynamic_cast<BrokerId*>(dataStructure);
-        info->setValue(tightUnmarshalString(dataIn, bs));
+            static_cast<BrokerId*>(dataStructure);
+        info->setValue(tightUnmarshalString(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -72,7 +72,7 @@ int BrokerIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure*
     try {
 
         BrokerId* info =
-            dynamic_cast<BrokerId*>(dataStructure);
+            static_cast<BrokerId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getValue(), bs);
@@ -92,7 +92,7 @@ void BrokerIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         BrokerId* info =
-            dynamic_cast<BrokerId*>(dataStructure);
+            static_cast<BrokerId*>(dataStructure);
         tightMarshalString2(info->getValue(), dataOut, bs);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -107,8 +107,8 @@ void BrokerIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructur
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         BrokerId* info =
-            dynamic_cast<BrokerId*>(dataStructure);
-        info->setValue(looseUnmarshalString(dataIn));
+            static_cast<BrokerId*>(dataStructure);
+        info->setValue(looseUnmarshalString(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -121,7 +121,7 @@ void BrokerIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure*
     try {
 
         BrokerId* info =
-            dynamic_cast<BrokerId*>(dataStructure);
+            static_cast<BrokerId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getValue(), dataOut);
     }
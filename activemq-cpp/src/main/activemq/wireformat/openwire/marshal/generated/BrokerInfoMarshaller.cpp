@@ -58,13 +58,13 @@ void BrokerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         BrokerInfo* info =
-            dynamic_cast<BrokerInfo*>(dataStructure);
+            static_cast<BrokerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         info->setBrokerId(Pointer<BrokerId>(dynamic_cast<BrokerId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
-        info->setBrokerURL(tightUnmarshalString(dataIn, bs));
+        info->setBrokerURL(tightUnmarshalString(wireFormat, dataIn, bs));
 
         if (bs->readBoolean()) {
             short size = dataIn->readShort();
@@ -76,7 +76,7 @@ void BrokerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
         } else {
             info->getPeerBrokerInfos().clear();
         }
-        info->setBrokerName(tightUnmarshalString(dataIn, bs));
+        info->setBrokerName(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setSlaveBroker(bs->readBoolean());
         info->setMasterBroker(bs->readBoolean());
         info->setFaultTolerantConfiguration(bs->readBoolean());
@@ -90,10 +90,10 @@ void BrokerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
             info->setConnectionId(tightUnmarshalLong(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 3) {
-            info->setBrokerUploadUrl(tightUnmarshalString(dataIn, bs));
+            info->setBrokerUploadUrl(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 3) {
-            info->setNetworkProperties(tightUnmarshalString(dataIn, bs));
+            info->setNetworkProperties(tightUnmarshalString(wireFormat, dataIn, bs));
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -107,7 +107,7 @@ int BrokerInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructur
     try {
 
         BrokerInfo* info =
-            dynamic_cast<BrokerInfo*>(dataStructure);
+            static_cast<BrokerInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -151,7 +151,7 @@ void BrokerInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructu
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         BrokerInfo* info =
-            dynamic_cast<BrokerInfo*>(dataStructure);
+            static_cast<BrokerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -190,13 +190,13 @@ void BrokerInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         BrokerInfo* info =
-            dynamic_cast<BrokerInfo*>(dataStructure);
+            static_cast<BrokerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         info->setBrokerId(Pointer<BrokerId>(dynamic_cast<BrokerId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
-        info->setBrokerURL(looseUnmarshalString(dataIn));
+        info->setBrokerURL(looseUnmarshalString(wireFormat, dataIn));
 
         if (dataIn->readBoolean()) {
             short size = dataIn->readShort();
@@ -208,7 +208,7 @@ void BrokerInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
         } else {
             info->getPeerBrokerInfos().clear();
         }
-        info->setBrokerName(looseUnmarshalString(dataIn));
+        info->setBrokerName(looseUnmarshalString(wireFormat, dataIn));
         info->setSlaveBroker(dataIn->readBoolean());
         info->setMasterBroker(dataIn->readBoolean());
         info->setFaultTolerantConfiguration(dataIn->readBoolean());
@@ -222,10 +222,10 @@ void BrokerInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
             info->setConnectionId(looseUnmarshalLong(wireFormat, dataIn));
         }
         if (wireVersion >= 3) {
-            info->setBrokerUploadUrl(looseUnmarshalString(dataIn));
+            info->setBrokerUploadUrl(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 3) {
-            info->setNetworkProperties(looseUnmarshalString(dataIn));
+            info->setNetworkProperties(looseUnmarshalString(wireFormat, dataIn));
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -239,7 +239,7 @@ void BrokerInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructur
     try {
 
         BrokerInfo* info =
-            dynamic_cast<BrokerInfo*>(dataStructure);
+            static_cast<BrokerInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
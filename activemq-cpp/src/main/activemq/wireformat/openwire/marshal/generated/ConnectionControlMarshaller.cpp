@@ -58,7 +58,7 @@ void ConnectionControlMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Dat
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConnectionControl* info =
-            dynamic_cast<ConnectionControl*>(dataStructure);
+            static_cast<ConnectionControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -68,16 +68,16 @@ void ConnectionControlMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Dat
         info->setResume(bs->readBoolean());
         info->setSuspend(bs->readBoolean());
         if (wireVersion >= 6) {
-            info->setConnectedBrokers(tightUnmarshalString(dataIn, bs));
+            info->setConnectedBrokers(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 6) {
-            info->setReconnectTo(tightUnmarshalString(dataIn, bs));
+            info->setReconnectTo(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 6) {
             info->setRebalanceConnection(bs->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setToken(tightUnmarshalByteArray(dataIn, bs));
+            tightUnmarshalByteArray(dataIn, bs, info->getToken());
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -91,7 +91,7 @@ int ConnectionControlMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataS
     try {
 
         ConnectionControl* info =
-            dynamic_cast<ConnectionControl*>(dataStructure);
+            static_cast<ConnectionControl*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -131,7 +131,7 @@ void ConnectionControlMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Data
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConnectionControl* info =
-            dynamic_cast<ConnectionControl*>(dataStructure);
+            static_cast<ConnectionControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -168,7 +168,7 @@ void ConnectionControlMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Dat
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConnectionControl* info =
-            dynamic_cast<ConnectionControl*>(dataStructure);
+            static_cast<ConnectionControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -178,16 +178,16 @@ void ConnectionControlMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Dat
         info->setResume(dataIn->readBoolean());
         info->setSuspend(dataIn->readBoolean());
         if (wireVersion >= 6) {
-            info->setConnectedBrokers(looseUnmarshalString(dataIn));
+            info->setConnectedBrokers(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 6) {
-            info->setReconnectTo(looseUnmarshalString(dataIn));
+            info->setReconnectTo(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 6) {
             info->setRebalanceConnection(dataIn->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setToken(looseUnmarshalByteArray(dataIn));
+            looseUnmarshalByteArray(dataIn, info->getToken());
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -201,7 +201,7 @@ void ConnectionControlMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataS
     try {
 
         ConnectionControl* info =
-            dynamic_cast<ConnectionControl*>(dataStructure);
+            static_cast<ConnectionControl*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,7 +58,7 @@ void ConnectionErrorMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConnectionError* info =
-            dynamic_cast<ConnectionError*>(dataStructure);
+            static_cast<ConnectionError*>(dataStructure);
         info->setException(Pointer<BrokerError>(dynamic_cast<BrokerError* >(
             tightUnmarshalBrokerError(wireFormat, dataIn, bs))));
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId* >(
@@ -75,7 +75,7 @@ int ConnectionErrorMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStr
     try {
 
         ConnectionError* info =
-            dynamic_cast<ConnectionError*>(dataStructure);
+            static_cast<ConnectionError*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalBrokerError1(wireFormat, info->getException().get(), bs);
@@ -96,7 +96,7 @@ void ConnectionErrorMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConnectionError* info =
-            dynamic_cast<ConnectionError*>(dataStructure);
+            static_cast<ConnectionError*>(dataStructure);
         tightMarshalBrokerError2(wireFormat, info->getException().get(), dataOut, bs);
         tightMarshalNestedObject2(wireFormat, info->getConnectionId().get(), dataOut, bs);
     }
@@ -112,7 +112,7 @@ void ConnectionErrorMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConnectionError* info =
-            dynamic_cast<ConnectionError*>(dataStructure);
+            static_cast<ConnectionError*>(dataStructure);
         info->setException(Pointer<BrokerError>(dynamic_cast< BrokerError*>(
             looseUnmarshalBrokerError(wireFormat, dataIn))));
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId*>(
@@ -129,7 +129,7 @@ void ConnectionErrorMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStr
     try {
 
         ConnectionError* info =
-            dynamic_cast<ConnectionError*>(dataStructure);
+            static_cast<ConnectionError*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalBrokerError(wireFormat, info->getException().get(), dataOut);
         looseMarshalNestedObject(wireFormat, info->getConnectionId().get(), dataOut);
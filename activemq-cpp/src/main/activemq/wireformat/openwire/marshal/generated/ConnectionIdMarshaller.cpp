@@ -58,8 +58,8 @@ void ConnectionIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStru
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConnectionId* info =
-            dynamic_cast<ConnectionId*>(dataStructure);
-        info->setValue(tightUnmarshalString(dataIn, bs));
+            static_cast<ConnectionId*>(dataStructure);
+        info->setValue(tightUnmarshalString(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -72,7 +72,7 @@ int ConnectionIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStruct
     try {
 
         ConnectionId* info =
-            dynamic_cast<ConnectionId*>(dataStructure);
+            static_cast<ConnectionId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getValue(), bs);
@@ -92,7 +92,7 @@ void ConnectionIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruc
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConnectionId* info =
-            dynamic_cast<ConnectionId*>(dataStructure);
+            static_cast<ConnectionId*>(dataStructure);
         tightMarshalString2(info->getValue(), dataOut, bs);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -107,8 +107,8 @@ void ConnectionIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStru
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConnectionId* info =
-            dynamic_cast<ConnectionId*>(dataStructure);
-        info->setValue(looseUnmarshalString(dataIn));
+            static_cast<ConnectionId*>(dataStructure);
+        info->setValue(looseUnmarshalString(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -121,7 +121,7 @@ void ConnectionIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStruct
     try {
 
         ConnectionId* info =
-            dynamic_cast<ConnectionId*>(dataStructure);
+            static_cast<ConnectionId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getValue(), dataOut);
     }
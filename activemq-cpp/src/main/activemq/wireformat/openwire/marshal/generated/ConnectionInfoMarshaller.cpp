@@ -58,15 +58,15 @@ void ConnectionInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConnectionInfo* info =
-            dynamic_cast<ConnectionInfo*>(dataStructure);
+            static_cast<ConnectionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
-        info->setClientId(tightUnmarshalString(dataIn, bs));
-        info->setPassword(tightUnmarshalString(dataIn, bs));
-        info->setUserName(tightUnmarshalString(dataIn, bs));
+        info->setClientId(tightUnmarshalString(wireFormat, dataIn, bs));
+        info->setPassword(tightUnmarshalString(wireFormat, dataIn, bs));
+        info->setUserName(tightUnmarshalString(wireFormat, dataIn, bs));
 
         if (bs->readBoolean()) {
             short size = dataIn->readShort();
@@ -90,7 +90,7 @@ void ConnectionInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
             info->setFailoverReconnect(bs->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setClientIp(tightUnmarshalString(dataIn, bs));
+            info->setClientIp(tightUnmarshalString(wireFormat, dataIn, bs));
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -104,7 +104,7 @@ int ConnectionInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStru
     try {
 
         ConnectionInfo* info =
-            dynamic_cast<ConnectionInfo*>(dataStructure);
+            static_cast<ConnectionInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -145,7 +145,7 @@ void ConnectionInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStr
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConnectionInfo* info =
-            dynamic_cast<ConnectionInfo*>(dataStructure);
+            static_cast<ConnectionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -181,15 +181,15 @@ void ConnectionInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConnectionInfo* info =
-            dynamic_cast<ConnectionInfo*>(dataStructure);
+            static_cast<ConnectionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
-        info->setClientId(looseUnmarshalString(dataIn));
-        info->setPassword(looseUnmarshalString(dataIn));
-        info->setUserName(looseUnmarshalString(dataIn));
+        info->setClientId(looseUnmarshalString(wireFormat, dataIn));
+        info->setPassword(looseUnmarshalString(wireFormat, dataIn));
+        info->setUserName(looseUnmarshalString(wireFormat, dataIn));
 
         if (dataIn->readBoolean()) {
             short size = dataIn->readShort();
@@ -213,7 +213,7 @@ void ConnectionInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
             info->setFailoverReconnect(dataIn->readBoolean());
         }
         if (wireVersion >= 8) {
-            info->setClientIp(looseUnmarshalString(dataIn));
+            info->setClientIp(looseUnmarshalString(wireFormat, dataIn));
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -227,7 +227,7 @@ void ConnectionInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStru
     try {
 
         ConnectionInfo* info =
-            dynamic_cast<ConnectionInfo*>(dataStructure);
+            static_cast<ConnectionInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,7 +58,7 @@ void ConsumerControlMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConsumerControl* info =
-            dynamic_cast<ConsumerControl*>(dataStructure);
+            static_cast<ConsumerControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -91,7 +91,7 @@ int ConsumerControlMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStr
     try {
 
         ConsumerControl* info =
-            dynamic_cast<ConsumerControl*>(dataStructure);
+            static_cast<ConsumerControl*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -127,7 +127,7 @@ void ConsumerControlMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConsumerControl* info =
-            dynamic_cast<ConsumerControl*>(dataStructure);
+            static_cast<ConsumerControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -159,7 +159,7 @@ void ConsumerControlMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConsumerControl* info =
-            dynamic_cast<ConsumerControl*>(dataStructure);
+            static_cast<ConsumerControl*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -192,7 +192,7 @@ void ConsumerControlMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStr
     try {
 
         ConsumerControl* info =
-            dynamic_cast<ConsumerControl*>(dataStructure);
+            static_cast<ConsumerControl*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
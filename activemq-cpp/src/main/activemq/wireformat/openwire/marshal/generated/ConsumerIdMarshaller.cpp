@@ -58,8 +58,8 @@ void ConsumerIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConsumerId* info =
-            dynamic_cast<ConsumerId*>(dataStructure);
-        info->setConnectionId(tightUnmarshalString(dataIn, bs));
+            static_cast<ConsumerId*>(dataStructure);
+        info->setConnectionId(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setSessionId(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setValue(tightUnmarshalLong(wireFormat, dataIn, bs));
     }
@@ -74,7 +74,7 @@ int ConsumerIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructur
     try {
 
         ConsumerId* info =
-            dynamic_cast<ConsumerId*>(dataStructure);
+            static_cast<ConsumerId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getConnectionId(), bs);
@@ -96,7 +96,7 @@ void ConsumerIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructu
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConsumerId* info =
-            dynamic_cast<ConsumerId*>(dataStructure);
+            static_cast<ConsumerId*>(dataStructure);
         tightMarshalString2(info->getConnectionId(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getSessionId(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getValue(), dataOut, bs);
@@ -113,8 +113,8 @@ void ConsumerIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConsumerId* info =
-            dynamic_cast<ConsumerId*>(dataStructure);
-        info->setConnectionId(looseUnmarshalString(dataIn));
+            static_cast<ConsumerId*>(dataStructure);
+        info->setConnectionId(looseUnmarshalString(wireFormat, dataIn));
         info->setSessionId(looseUnmarshalLong(wireFormat, dataIn));
         info->setValue(looseUnmarshalLong(wireFormat, dataIn));
     }
@@ -129,7 +129,7 @@ void ConsumerIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructur
     try {
 
         ConsumerId* info =
-            dynamic_cast<ConsumerId*>(dataStructure);
+            static_cast<ConsumerId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getConnectionId(), dataOut);
         looseMarshalLong(wireFormat, info->getSessionId(), dataOut);
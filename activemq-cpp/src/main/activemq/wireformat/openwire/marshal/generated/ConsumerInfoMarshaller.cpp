@@ -58,7 +58,7 @@ void ConsumerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStru
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ConsumerInfo* info =
-            dynamic_cast<ConsumerInfo*>(dataStructure);
+            static_cast<ConsumerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -70,11 +70,11 @@ void ConsumerInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStru
         info->setPrefetchSize(dataIn->readInt());
         info->setMaximumPendingMessageLimit(dataIn->readInt());
         info->setDispatchAsync(bs->readBoolean());
-        info->setSelector(tightUnmarshalString(dataIn, bs));
+        info->setSelector(tightUnmarshalString(wireFormat, dataIn, bs));
         if (wireVersion >= 10) {
-            info->setClientId(tightUnmarshalString(dataIn, bs));
+            info->setClientId(tightUnmarshalString(wireFormat, dataIn, bs));
         }
-        info->setSubscriptionName(tightUnmarshalString(dataIn, bs));
+        info->setSubscriptionName(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setNoLocal(bs->readBoolean());
         info->setExclusive(bs->readBoolean());
         info->setRetroactive(bs->readBoolean());
@@ -120,7 +120,7 @@ int ConsumerInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStruct
     try {
 
         ConsumerInfo* info =
-            dynamic_cast<ConsumerInfo*>(dataStructure);
+            static_cast<ConsumerInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -162,7 +162,7 @@ void ConsumerInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruc
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ConsumerInfo* info =
-            dynamic_cast<ConsumerInfo*>(dataStructure);
+            static_cast<ConsumerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -202,7 +202,7 @@ void ConsumerInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStru
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ConsumerInfo* info =
-            dynamic_cast<ConsumerInfo*>(dataStructure);
+            static_cast<ConsumerInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -214,11 +214,11 @@ void ConsumerInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStru
         info->setPrefetchSize(dataIn->readInt());
         info->setMaximumPendingMessageLimit(dataIn->readInt());
         info->setDispatchAsync(dataIn->readBoolean());
-        info->setSelector(looseUnmarshalString(dataIn));
+        info->setSelector(looseUnmarshalString(wireFormat, dataIn));
         if (wireVersion >= 10) {
-            info->setClientId(looseUnmarshalString(dataIn));
+            info->setClientId(looseUnmarshalString(wireFormat, dataIn));
         }
-        info->setSubscriptionName(looseUnmarshalString(dataIn));
+        info->setSubscriptionName(looseUnmarshalString(wireFormat, dataIn));
         info->setNoLocal(dataIn->readBoolean());
         info->setExclusive(dataIn->readBoolean());
         info->setRetroactive(dataIn->readBoolean());
@@ -264,7 +264,7 @@ void ConsumerInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStruct
     try {
 
         ConsumerInfo* info =
-            dynamic_cast<ConsumerInfo*>(dataStructure);
+            static_cast<ConsumerInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
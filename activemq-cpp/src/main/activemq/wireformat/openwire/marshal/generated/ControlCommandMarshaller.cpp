@@ -58,8 +58,8 @@ void ControlCommandMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ControlCommand* info =
-            dynamic_cast<ControlCommand*>(dataStructure);
-        info->setCommand(tightUnmarshalString(dataIn, bs));
+            static_cast<ControlCommand*>(dataStructure);
+        info->setCommand(tightUnmarshalString(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -72,7 +72,7 @@ int ControlCommandMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStru
     try {
 
         ControlCommand* info =
-            dynamic_cast<ControlCommand*>(dataStructure);
+            static_cast<ControlCommand*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getCommand(), bs);
@@ -92,7 +92,7 @@ void ControlCommandMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStr
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ControlCommand* info =
-            dynamic_cast<ControlCommand*>(dataStructure);
+            static_cast<ControlCommand*>(dataStructure);
         tightMarshalString2(info->getCommand(), dataOut, bs);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -107,8 +107,8 @@ void ControlCommandMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ControlCommand* info =
-            dynamic_cast<ControlCommand*>(dataStructure);
-        info->setCommand(looseUnmarshalString(dataIn));
+            static_cast<ControlCommand*>(dataStructure);
+        info->setCommand(looseUnmarshalString(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -121,7 +121,7 @@ void ControlCommandMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStru
     try {
 
         ControlCommand* info =
-            dynamic_cast<ControlCommand*>(dataStructure);
+            static_cast<ControlCommand*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getCommand(), dataOut);
     }
@@ -58,7 +58,7 @@ void DestinationInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         DestinationInfo* info =
-            dynamic_cast<DestinationInfo*>(dataStructure);
+            static_cast<DestinationInfo*>(dataStructure);
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
@@ -88,7 +88,7 @@ int DestinationInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStr
     try {
 
         DestinationInfo* info =
-            dynamic_cast<DestinationInfo*>(dataStructure);
+            static_cast<DestinationInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalCachedObject1(wireFormat, info->getConnectionId().get(), bs);
@@ -111,7 +111,7 @@ void DestinationInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         DestinationInfo* info =
-            dynamic_cast<DestinationInfo*>(dataStructure);
+            static_cast<DestinationInfo*>(dataStructure);
         tightMarshalCachedObject2(wireFormat, info->getConnectionId().get(), dataOut, bs);
         tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         dataOut->write(info->getOperationType());
@@ -130,7 +130,7 @@ void DestinationInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         DestinationInfo* info =
-            dynamic_cast<DestinationInfo*>(dataStructure);
+            static_cast<DestinationInfo*>(dataStructure);
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
@@ -160,7 +160,7 @@ void DestinationInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStr
     try {
 
         DestinationInfo* info =
-            dynamic_cast<DestinationInfo*>(dataStructure);
+            static_cast<DestinationInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalCachedObject(wireFormat, info->getConnectionId().get(), dataOut);
         looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
@@ -58,9 +58,9 @@ void DiscoveryEventMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         DiscoveryEvent* info =
-            dynamic_cast<DiscoveryEvent*>(dataStructure);
-        info->setServiceName(tightUnmarshalString(dataIn, bs));
-        info->setBrokerName(tightUnmarshalString(dataIn, bs));
+            static_cast<DiscoveryEvent*>(dataStructure);
+        info->setServiceName(tightUnmarshalString(wireFormat, dataIn, bs));
+        info->setBrokerName(tightUnmarshalString(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -73,7 +73,7 @@ int DiscoveryEventMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStru
     try {
 
         DiscoveryEvent* info =
-            dynamic_cast<DiscoveryEvent*>(dataStructure);
+            static_cast<DiscoveryEvent*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getServiceName(), bs);
@@ -94,7 +94,7 @@ void DiscoveryEventMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStr
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         DiscoveryEvent* info =
-            dynamic_cast<DiscoveryEvent*>(dataStructure);
+            static_cast<DiscoveryEvent*>(dataStructure);
         tightMarshalString2(info->getServiceName(), dataOut, bs);
         tightMarshalString2(info->getBrokerName(), dataOut, bs);
     }
@@ -110,9 +110,9 @@ void DiscoveryEventMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         DiscoveryEvent* info =
-            dynamic_cast<DiscoveryEvent*>(dataStructure);
-        info->setServiceName(looseUnmarshalString(dataIn));
-        info->setBrokerName(looseUnmarshalString(dataIn));
+            static_cast<DiscoveryEvent*>(dataStructure);
+        info->setServiceName(looseUnmarshalString(wireFormat, dataIn));
+        info->setBrokerName(looseUnmarshalString(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -125,7 +125,7 @@ void DiscoveryEventMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStru
     try {
 
         DiscoveryEvent* info =
-            dynamic_cast<DiscoveryEvent*>(dataStructure);
+            static_cast<DiscoveryEvent*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getServiceName(), dataOut);
         looseMarshalString(info->getBrokerName(), dataOut);
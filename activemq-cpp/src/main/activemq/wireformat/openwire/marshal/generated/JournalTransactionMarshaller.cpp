@@ -58,7 +58,7 @@ void JournalTransactionMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Da
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         JournalTransaction* info =
-            dynamic_cast<JournalTransaction*>(dataStructure);
+            static_cast<JournalTransaction*>(dataStructure);
         info->setTransactionId(Pointer<TransactionId>(dynamic_cast<TransactionId* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setType(dataIn->readByte());
@@ -75,7 +75,7 @@ int JournalTransactionMarshaller::tightMarshal1(OpenWireFormat* wireFormat, Data
     try {
 
         JournalTransaction* info =
-            dynamic_cast<JournalTransaction*>(dataStructure);
+            static_cast<JournalTransaction*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalNestedObject1(wireFormat, info->getTransactionId().get(), bs);
@@ -96,7 +96,7 @@ void JournalTransactionMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Dat
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         JournalTransaction* info =
-            dynamic_cast<JournalTransaction*>(dataStructure);
+            static_cast<JournalTransaction*>(dataStructure);
         tightMarshalNestedObject2(wireFormat, info->getTransactionId().get(), dataOut, bs);
         dataOut->write(info->getType());
         bs->readBoolean();
@@ -113,7 +113,7 @@ void JournalTransactionMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Da
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         JournalTransaction* info =
-            dynamic_cast<JournalTransaction*>(dataStructure);
+            static_cast<JournalTransaction*>(dataStructure);
         info->setTransactionId(Pointer<TransactionId>(dynamic_cast<TransactionId*>(
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setType(dataIn->readByte());
@@ -130,7 +130,7 @@ void JournalTransactionMarshaller::looseMarshal(OpenWireFormat* wireFormat, Data
     try {
 
         JournalTransaction* info =
-            dynamic_cast<JournalTransaction*>(dataStructure);
+            static_cast<JournalTransaction*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalNestedObject(wireFormat, info->getTransactionId().get(), dataOut);
         dataOut->write(info->getType());
@@ -58,7 +58,7 @@ void LocalTransactionIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Da
         TransactionIdMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         LocalTransactionId* info =
-            dynamic_cast<LocalTransactionId*>(dataStructure);
+            static_cast<LocalTransactionId*>(dataStructure);
         info->setValue(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
@@ -74,7 +74,7 @@ int LocalTransactionIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, Data
     try {
 
         LocalTransactionId* info =
-            dynamic_cast<LocalTransactionId*>(dataStructure);
+            static_cast<LocalTransactionId*>(dataStructure);
 
         int rc = TransactionIdMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalLong1(wireFormat, info->getValue(), bs);
@@ -95,7 +95,7 @@ void LocalTransactionIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Dat
         TransactionIdMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         LocalTransactionId* info =
-            dynamic_cast<LocalTransactionId*>(dataStructure);
+            static_cast<LocalTransactionId*>(dataStructure);
         tightMarshalLong2(wireFormat, info->getValue(), dataOut, bs);
         tightMarshalCachedObject2(wireFormat, info->getConnectionId().get(), dataOut, bs);
     }
@@ -111,7 +111,7 @@ void LocalTransactionIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Da
 
         TransactionIdMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         LocalTransactionId* info =
-            dynamic_cast<LocalTransactionId*>(dataStructure);
+            static_cast<LocalTransactionId*>(dataStructure);
         info->setValue(looseUnmarshalLong(wireFormat, dataIn));
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
@@ -127,7 +127,7 @@ void LocalTransactionIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, Data
     try {
 
         LocalTransactionId* info =
-            dynamic_cast<LocalTransactionId*>(dataStructure);
+            static_cast<LocalTransactionId*>(dataStructure);
         TransactionIdMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalLong(wireFormat, info->getValue(), dataOut);
         looseMarshalCachedObject(wireFormat, info->getConnectionId().get(), dataOut);
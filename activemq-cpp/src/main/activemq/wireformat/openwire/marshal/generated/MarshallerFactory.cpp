@@ -90,63 +90,63 @@ using namespace activemq::wireformat::openwire::marshal;
 using namespace activemq::wireformat::openwire::marshal::generated;
 
 ///////////////////////////////////////////////////////////////////////////////
-void MarshallerFactory::configure(OpenWireFormat* format) {
+void MarshallerFactory::configure(MarshallerTable* table) {
 
-    format->addMarshaller(new ActiveMQBlobMessageMarshaller());
-    format->addMarshaller(new ActiveMQBytesMessageMarshaller());
-    format->addMarshaller(new ActiveMQMapMessageMarshaller());
-    format->addMarshaller(new ActiveMQMessageMarshaller());
-    format->addMarshaller(new ActiveMQObjectMessageMarshaller());
-    format->addMarshaller(new ActiveMQQueueMarshaller());
-    format->addMarshaller(new ActiveMQStreamMessageMarshaller());
-    format->addMarshaller(new ActiveMQTempQueueMarshaller());
-    format->addMarshaller(new ActiveMQTempTopicMarshaller());
-    format->addMarshaller(new ActiveMQTextMessageMarshaller());
-    format->addMarshaller(new ActiveMQTopicMarshaller());
-    format->addMarshaller(new BrokerIdMarshaller());
-    format->addMarshaller(new BrokerInfoMarshaller());
-    format->addMarshaller(new ConnectionControlMarshaller());
-    format->addMarshaller(new ConnectionErrorMarshaller());
-    format->addMarshaller(new ConnectionIdMarshaller());
-    format->addMarshaller(new ConnectionInfoMarshaller());
-    format->addMarshaller(new ConsumerControlMarshaller());
-    format->addMarshaller(new ConsumerIdMarshaller());
-    format->addMarshaller(new ConsumerInfoMarshaller());
-    format->addMarshaller(new ControlCommandMarshaller());
-    format->addMarshaller(new DataArrayResponseMarshaller());
-    format->addMarshaller(new DataResponseMarshaller());
-    format->addMarshaller(new DestinationInfoMarshaller());
-    format->addMarshaller(new DiscoveryEventMarshaller());
-    format->addMarshaller(new ExceptionResponseMarshaller());
-    format->addMarshaller(new FlushCommandMarshaller());
-    format->addMarshaller(new IntegerResponseMarshaller());
-    format->addMarshaller(new JournalQueueAckMarshaller());
-    format->addMarshaller(new JournalTopicAckMarshaller());
-    format->addMarshaller(new JournalTraceMarshaller());
-    format->addMarshaller(new JournalTransactionMarshaller());
-    format->addMarshaller(new KeepAliveInfoMarshaller());
-    format->addMarshaller(new LastPartialCommandMarshaller());
-    format->addMarshaller(new LocalTransactionIdMarshaller());
-    format->addMarshaller(new MessageAckMarshaller());
-    format->addMarshaller(new MessageDispatchMarshaller());
-    format->addMarshaller(new MessageDispatchNotificationMarshaller());
-    format->addMarshaller(new MessageIdMarshaller());
-    format->addMarshaller(new MessagePullMarshaller());
-    format->addMarshaller(new NetworkBridgeFilterMarshaller());
-    format->addMarshaller(new PartialCommandMarshaller());
-    format->addMarshaller(new ProducerAckMarshaller());
-    format->addMarshaller(new ProducerIdMarshaller());
-    format->addMarshaller(new ProducerInfoMarshaller());
-    format->addMarshaller(new RemoveInfoMarshaller());
-    format->addMarshaller(new RemoveSubscriptionInfoMarshaller());
-    format->addMarshaller(new ReplayCommandMarshaller());
-    format->addMarshaller(new ResponseMarshaller());
-    format->addMarshaller(new SessionIdMarshaller());
-    format->addMarshaller(new SessionInfoMarshaller());
-    format->addMarshaller(new ShutdownInfoMarshaller());
-    format->addMarshaller(new SubscriptionInfoMarshaller());
-    format->addMarshaller(new TransactionInfoMarshaller());
-    format->addMarshaller(new WireFormatInfoMarshaller());
-    format->addMarshaller(new XATransactionIdMarshaller());
+    table->add(new ActiveMQBlobMessageMarshaller());
+    table->add(new ActiveMQBytesMessageMarshaller());
+    table->add(new ActiveMQMapMessageMarshaller());
+    table->add(new ActiveMQMessageMarshaller());
+    table->add(new ActiveMQObjectMessageMarshaller());
+    table->add(new ActiveMQQueueMarshaller());
+    table->add(new ActiveMQStreamMessageMarshaller());
+    table->add(new ActiveMQTempQueueMarshaller());
+    table->add(new ActiveMQTempTopicMarshaller());
+    table->add(new ActiveMQTextMessageMarshaller());
+    table->add(new ActiveMQTopicMarshaller());
+    table->add(new BrokerIdMarshaller());
+    table->add(new BrokerInfoMarshaller());
+    table->add(new ConnectionControlMarshaller());
+    table->add(new ConnectionErrorMarshaller());
+    table->add(new ConnectionIdMarshaller());
+    table->add(new ConnectionInfoMarshaller());
+    table->add(new ConsumerControlMarshaller());
+    table->add(new ConsumerIdMarshaller());
+    table->add(new ConsumerInfoMarshaller());
+    table->add(new ControlCommandMarshaller());
+    table->add(new DataArrayResponseMarshaller());
+    table->add(new DataResponseMarshaller());
+    table->add(new DestinationInfoMarshaller());
+    table->add(new DiscoveryEventMarshaller());
+    table->add(new ExceptionResponseMarshaller());
+    table->add(new FlushCommandMarshaller());
+    table->add(new IntegerResponseMarshaller());
+    table->add(new JournalQueueAckMarshaller());
+    table->add(new JournalTopicAckMarshaller());
+    table->add(new JournalTraceMarshaller());
+    table->add(new JournalTransactionMarshaller());
+    table->add(new KeepAliveInfoMarshaller());
+    table->add(new LastPartialCommandMarshaller());
+    table->add(new LocalTransactionIdMarshaller());
+    table->add(new MessageAckMarshaller());
+    table->add(new MessageDispatchMarshaller());
+    table->add(new MessageDispatchNotificationMarshaller());
+    table->add(new MessageIdMarshaller());
+    table->add(new MessagePullMarshaller());
+    table->add(new NetworkBridgeFilterMarshaller());
+    table->add(new PartialCommandMarshaller());
+    table->add(new ProducerAckMarshaller());
+    table->add(new ProducerIdMarshaller());
+    table->add(new ProducerInfoMarshaller());
+    table->add(new RemoveInfoMarshaller());
+    table->add(new RemoveSubscriptionInfoMarshaller());
+    table->add(new ReplayCommandMarshaller());
+    table->add(new ResponseMarshaller());
+    table->add(new SessionIdMarshaller());
+    table->add(new SessionInfoMarshaller());
+    table->add(new ShutdownInfoMarshaller());
+    table->add(new SubscriptionInfoMarshaller());
+    table->add(new TransactionInfoMarshaller());
+    table->add(new WireFormatInfoMarshaller());
+    table->add(new XATransactionIdMarshaller());
 }
 
@@ -22,7 +22,7 @@
 #pragma warning( disable : 4290 )
 #endif
 
-#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/marshal/MarshallerTable.h>
 
 namespace activemq {
 namespace wireformat {
@@ -43,7 +43,7 @@ namespace generated {
 
         virtual ~MarshallerFactory() {};
 
-        virtual void configure(OpenWireFormat* format);
+        virtual void configure(MarshallerTable* table);
 
     };
 
@@ -58,7 +58,7 @@ void MessageDispatchMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         MessageDispatch* info =
-            dynamic_cast<MessageDispatch*>(dataStructure);
+            static_cast<MessageDispatch*>(dataStructure);
         info->setConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
@@ -78,7 +78,7 @@ int MessageDispatchMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStr
     try {
 
         MessageDispatch* info =
-            dynamic_cast<MessageDispatch*>(dataStructure);
+            static_cast<MessageDispatch*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalCachedObject1(wireFormat, info->getConsumerId().get(), bs);
@@ -100,7 +100,7 @@ void MessageDispatchMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         MessageDispatch* info =
-            dynamic_cast<MessageDispatch*>(dataStructure);
+            static_cast<MessageDispatch*>(dataStructure);
         tightMarshalCachedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
         tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         tightMarshalNestedObject2(wireFormat, info->getMessage().get(), dataOut, bs);
@@ -118,7 +118,7 @@ void MessageDispatchMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         MessageDispatch* info =
-            dynamic_cast<MessageDispatch*>(dataStructure);
+            static_cast<MessageDispatch*>(dataStructure);
         info->setConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
@@ -138,7 +138,7 @@ void MessageDispatchMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStr
     try {
 
         MessageDispatch* info =
-            dynamic_cast<MessageDispatch*>(dataStructure);
+            static_cast<MessageDispatch*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalCachedObject(wireFormat, info->getConsumerId().get(), dataOut);
         looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
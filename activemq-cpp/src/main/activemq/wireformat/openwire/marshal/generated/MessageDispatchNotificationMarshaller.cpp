@@ -58,7 +58,7 @@ void MessageDispatchNotificationMarshaller::tightUnmarshal(OpenWireFormat* wireF
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         MessageDispatchNotification* info =
-            dynamic_cast<MessageDispatchNotification*>(dataStructure);
+            static_cast<MessageDispatchNotification*>(dataStructure);
         info->setConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
@@ -78,7 +78,7 @@ int MessageDispatchNotificationMarshaller::tightMarshal1(OpenWireFormat* wireFor
     try {
 
         MessageDispatchNotification* info =
-            dynamic_cast<MessageDispatchNotification*>(dataStructure);
+            static_cast<MessageDispatchNotification*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalCachedObject1(wireFormat, info->getConsumerId().get(), bs);
@@ -101,7 +101,7 @@ void MessageDispatchNotificationMarshaller::tightMarshal2(OpenWireFormat* wireFo
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         MessageDispatchNotification* info =
-            dynamic_cast<MessageDispatchNotification*>(dataStructure);
+            static_cast<MessageDispatchNotification*>(dataStructure);
         tightMarshalCachedObject2(wireFormat, info->getConsumerId().get(), dataOut, bs);
         tightMarshalCachedObject2(wireFormat, info->getDestination().get(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getDeliverySequenceId(), dataOut, bs);
@@ -119,7 +119,7 @@ void MessageDispatchNotificationMarshaller::looseUnmarshal(OpenWireFormat* wireF
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         MessageDispatchNotification* info =
-            dynamic_cast<MessageDispatchNotification*>(dataStructure);
+            static_cast<MessageDispatchNotification*>(dataStructure);
         info->setConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
@@ -139,7 +139,7 @@ void MessageDispatchNotificationMarshaller::looseMarshal(OpenWireFormat* wireFor
     try {
 
         MessageDispatchNotification* info =
-            dynamic_cast<MessageDispatchNotification*>(dataStructure);
+            static_cast<MessageDispatchNotification*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalCachedObject(wireFormat, info->getConsumerId().get(), dataOut);
         looseMarshalCachedObject(wireFormat, info->getDestination().get(), dataOut);
@@ -58,12 +58,12 @@ void MessageIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructu
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         MessageId* info =
-            dynamic_cast<MessageId*>(dataStructure);
+            static_cast<MessageId*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         if (wireVersion >= 10) {
-            info->setTextView(tightUnmarshalString(dataIn, bs));
+            info->setTextView(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         info->setProducerId(Pointer<ProducerId>(dynamic_cast<ProducerId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
@@ -81,7 +81,7 @@ int MessageIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure
     try {
 
         MessageId* info =
-            dynamic_cast<MessageId*>(dataStructure);
+            static_cast<MessageId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -109,7 +109,7 @@ void MessageIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructur
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         MessageId* info =
-            dynamic_cast<MessageId*>(dataStructure);
+            static_cast<MessageId*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -132,12 +132,12 @@ void MessageIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructu
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         MessageId* info =
-            dynamic_cast<MessageId*>(dataStructure);
+            static_cast<MessageId*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
         if (wireVersion >= 10) {
-            info->setTextView(looseUnmarshalString(dataIn));
+            info->setTextView(looseUnmarshalString(wireFormat, dataIn));
         }
         info->setProducerId(Pointer<ProducerId>(dynamic_cast<ProducerId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
@@ -155,7 +155,7 @@ void MessageIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure
     try {
 
         MessageId* info =
-            dynamic_cast<MessageId*>(dataStructure);
+            static_cast<MessageId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -48,7 +48,7 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         Message* info =
-            dynamic_cast<Message*>(dataStructure);
+            static_cast<Message*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -64,18 +64,18 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setOriginalTransactionId(Pointer<TransactionId>(dynamic_cast<TransactionId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
-        info->setGroupID(tightUnmarshalString(dataIn, bs));
+        info->setGroupID(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setGroupSequence(dataIn->readInt());
-        info->setCorrelationId(tightUnmarshalString(dataIn, bs));
+        info->setCorrelationId(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setPersistent(bs->readBoolean());
         info->setExpiration(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setPriority(dataIn->readByte());
         info->setReplyTo(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setTimestamp(tightUnmarshalLong(wireFormat, dataIn, bs));
-        info->setType(tightUnmarshalString(dataIn, bs));
-        info->setContent(tightUnmarshalByteArray(dataIn, bs));
-        info->setMarshalledProperties(tightUnmarshalByteArray(dataIn, bs));
+        info->setType(tightUnmarshalString(wireFormat, dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getContent());
+        tightUnmarshalByteArray(dataIn, bs, info->getMarshalledProperties());
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure* >(
             tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
         info->setTargetConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId* >(
@@ -91,10 +91,10 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
                     tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
             }
         } else {
-            info->getBrokerPath().clear();
+            info->setBrokerPath(std::vector< Pointer<BrokerId> >());
         }
         info->setArrival(tightUnmarshalLong(wireFormat, dataIn, bs));
-        info->setUserID(tightUnmarshalString(dataIn, bs));
+        info->setUserID(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setRecievedByDFBridge(bs->readBoolean());
         if (wireVersion >= 2) {
             info->setDroppable(bs->readBoolean());
@@ -109,7 +109,7 @@ void MessageMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructure
                         tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
                 }
             } else {
-                info->getCluster().clear();
+                info->setCluster(std::vector< Pointer<BrokerId> >());
             }
         }
         if (wireVersion >= 3) {
@@ -132,8 +132,8 @@ int MessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure*
 
     try {
 
-        Message* info =
-            dynamic_cast<Message*>(dataStructure);
+        const Message* info =
+            static_cast<const Message*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -152,8 +152,8 @@ int MessageMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure*
         rc += tightMarshalNestedObject1(wireFormat, info->getReplyTo().get(), bs);
         rc += tightMarshalLong1(wireFormat, info->getTimestamp(), bs);
         rc += tightMarshalString1(info->getType(), bs);
-        bs->writeBoolean(info->getContent().size() != 0);
-        rc += info->getContent().size() == 0 ? 0 : (int)info->getContent().size() + 4;
+        bs->writeBoolean(info->getContentBytes().size() != 0);
+        rc += info->getContentBytes().size() == 0 ? 0 : (int)info->getContentBytes().size() + 4;
         bs->writeBoolean(info->getMarshalledProperties().size() != 0);
         rc += info->getMarshalledProperties().size() == 0 ? 0 : (int)info->getMarshalledProperties().size() + 4;
         rc += tightMarshalNestedObject1(wireFormat, info->getDataStructure().get(), bs);
@@ -193,8 +193,8 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
 
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
-        Message* info =
-            dynamic_cast<Message*>(dataStructure);
+        const Message* info =
+            static_cast<const Message*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -214,8 +214,8 @@ void MessageMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure*
         tightMarshalLong2(wireFormat, info->getTimestamp(), dataOut, bs);
         tightMarshalString2(info->getType(), dataOut, bs);
         if (bs->readBoolean()) {
-            dataOut->writeInt((int)info->getContent().size() );
-            dataOut->write((const unsigned char*)(&info->getContent()[0]), (int)info->getContent().size(), 0, (int)info->getContent().size());
+            dataOut->writeInt((int)info->getContentBytes().size() );
+            dataOut->write(info->getContentBytes().data(), (int)info->getContentBytes().size(), 0, (int)info->getContentBytes().size());
         }
         if (bs->readBoolean()) {
             dataOut->writeInt((int)info->getMarshalledProperties().size() );
@@ -257,7 +257,7 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         Message* info =
-            dynamic_cast<Message*>(dataStructure);
+            static_cast<Message*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -273,18 +273,18 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setOriginalTransactionId(Pointer<TransactionId>(dynamic_cast<TransactionId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
-        info->setGroupID(looseUnmarshalString(dataIn));
+        info->setGroupID(looseUnmarshalString(wireFormat, dataIn));
         info->setGroupSequence(dataIn->readInt());
-        info->setCorrelationId(looseUnmarshalString(dataIn));
+        info->setCorrelationId(looseUnmarshalString(wireFormat, dataIn));
         info->setPersistent(dataIn->readBoolean());
         info->setExpiration(looseUnmarshalLong(wireFormat, dataIn));
         info->setPriority(dataIn->readByte());
         info->setReplyTo(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setTimestamp(looseUnmarshalLong(wireFormat, dataIn));
-        info->setType(looseUnmarshalString(dataIn));
-        info->setContent(looseUnmarshalByteArray(dataIn));
-        info->setMarshalledProperties(looseUnmarshalByteArray(dataIn));
+        info->setType(looseUnmarshalString(wireFormat, dataIn));
+        looseUnmarshalByteArray(dataIn, info->getContent());
+        looseUnmarshalByteArray(dataIn, info->getMarshalledProperties());
         info->setDataStructure(Pointer<DataStructure>(dynamic_cast<DataStructure*>(
             looseUnmarshalNestedObject(wireFormat, dataIn))));
         info->setTargetConsumerId(Pointer<ConsumerId>(dynamic_cast<ConsumerId*>(
@@ -300,10 +300,10 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
                     looseUnmarshalNestedObject(wireFormat, dataIn))));
             }
         } else {
-            info->getBrokerPath().clear();
+            info->setBrokerPath(std::vector< Pointer<BrokerId> >());
         }
         info->setArrival(looseUnmarshalLong(wireFormat, dataIn));
-        info->setUserID(looseUnmarshalString(dataIn));
+        info->setUserID(looseUnmarshalString(wireFormat, dataIn));
         info->setRecievedByDFBridge(dataIn->readBoolean());
         if (wireVersion >= 2) {
             info->setDroppable(dataIn->readBoolean());
@@ -318,7 +318,7 @@ void MessageMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructure
                         looseUnmarshalNestedObject(wireFormat, dataIn))));
                 }
             } else {
-                info->getCluster().clear();
+                info->setCluster(std::vector< Pointer<BrokerId> >());
             }
         }
         if (wireVersion >= 3) {
@@ -341,8 +341,8 @@ void MessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure*
 
     try {
 
-        Message* info =
-            dynamic_cast<Message*>(dataStructure);
+        const Message* info =
+            static_cast<const Message*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -362,10 +362,10 @@ void MessageMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure*
         looseMarshalNestedObject(wireFormat, info->getReplyTo().get(), dataOut);
         looseMarshalLong(wireFormat, info->getTimestamp(), dataOut);
         looseMarshalString(info->getType(), dataOut);
-        dataOut->write( info->getContent().size() != 0 );
-        if( info->getContent().size() != 0 ) {
-            dataOut->writeInt( (int)info->getContent().size() );
-            dataOut->write((const unsigned char*)(&info->getContent()[0]), (int)info->getContent().size(), 0, (int)info->getContent().size());
+        dataOut->write( info->getContentBytes().size() != 0 );
+        if( info->getContentBytes().size() != 0 ) {
+            dataOut->writeInt( (int)info->getContentBytes().size() );
+            dataOut->write(info->getContentBytes().data(), (int)info->getContentBytes().size(), 0, (int)info->getContentBytes().size());
         }
         dataOut->write( info->getMarshalledProperties().size() != 0 );
         if( info->getMarshalledProperties().size() != 0 ) {
@@ -58,7 +58,7 @@ void MessagePullMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruc
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         MessagePull* info =
-            dynamic_cast<MessagePull*>(dataStructure);
+            static_cast<MessagePull*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -68,7 +68,7 @@ void MessagePullMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruc
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
         info->setTimeout(tightUnmarshalLong(wireFormat, dataIn, bs));
         if (wireVersion >= 3) {
-            info->setCorrelationId(tightUnmarshalString(dataIn, bs));
+            info->setCorrelationId(tightUnmarshalString(wireFormat, dataIn, bs));
         }
         if (wireVersion >= 3) {
             info->setMessageId(Pointer<MessageId>(dynamic_cast<MessageId* >(
@@ -86,7 +86,7 @@ int MessagePullMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructu
     try {
 
         MessagePull* info =
-            dynamic_cast<MessagePull*>(dataStructure);
+            static_cast<MessagePull*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -117,7 +117,7 @@ void MessagePullMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruct
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         MessagePull* info =
-            dynamic_cast<MessagePull*>(dataStructure);
+            static_cast<MessagePull*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -143,7 +143,7 @@ void MessagePullMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruc
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         MessagePull* info =
-            dynamic_cast<MessagePull*>(dataStructure);
+            static_cast<MessagePull*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -153,7 +153,7 @@ void MessagePullMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruc
             looseUnmarshalCachedObject(wireFormat, dataIn))));
         info->setTimeout(looseUnmarshalLong(wireFormat, dataIn));
         if (wireVersion >= 3) {
-            info->setCorrelationId(looseUnmarshalString(dataIn));
+            info->setCorrelationId(looseUnmarshalString(wireFormat, dataIn));
         }
         if (wireVersion >= 3) {
             info->setMessageId(Pointer<MessageId>(dynamic_cast<MessageId*>(
@@ -171,7 +171,7 @@ void MessagePullMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructu
     try {
 
         MessagePull* info =
-            dynamic_cast<MessagePull*>(dataStructure);
+            static_cast<MessagePull*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,7 +58,7 @@ void NetworkBridgeFilterMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, D
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         NetworkBridgeFilter* info =
-            dynamic_cast<NetworkBridgeFilter*>(dataStructure);
+            static_cast<NetworkBridgeFilter*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -82,7 +82,7 @@ int NetworkBridgeFilterMarshaller::tightMarshal1(OpenWireFormat* wireFormat, Dat
     try {
 
         NetworkBridgeFilter* info =
-            dynamic_cast<NetworkBridgeFilter*>(dataStructure);
+            static_cast<NetworkBridgeFilter*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -109,7 +109,7 @@ void NetworkBridgeFilterMarshaller::tightMarshal2(OpenWireFormat* wireFormat, Da
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         NetworkBridgeFilter* info =
-            dynamic_cast<NetworkBridgeFilter*>(dataStructure);
+            static_cast<NetworkBridgeFilter*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -133,7 +133,7 @@ void NetworkBridgeFilterMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, D
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         NetworkBridgeFilter* info =
-            dynamic_cast<NetworkBridgeFilter*>(dataStructure);
+            static_cast<NetworkBridgeFilter*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -157,7 +157,7 @@ void NetworkBridgeFilterMarshaller::looseMarshal(OpenWireFormat* wireFormat, Dat
     try {
 
         NetworkBridgeFilter* info =
-            dynamic_cast<NetworkBridgeFilter*>(dataStructure);
+            static_cast<NetworkBridgeFilter*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,7 +58,7 @@ void ProducerAckMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruc
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ProducerAck* info =
-            dynamic_cast<ProducerAck*>(dataStructure);
+            static_cast<ProducerAck*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -81,7 +81,7 @@ int ProducerAckMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructu
     try {
 
         ProducerAck* info =
-            dynamic_cast<ProducerAck*>(dataStructure);
+            static_cast<ProducerAck*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -108,7 +108,7 @@ void ProducerAckMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStruct
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ProducerAck* info =
-            dynamic_cast<ProducerAck*>(dataStructure);
+            static_cast<ProducerAck*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -131,7 +131,7 @@ void ProducerAckMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruc
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ProducerAck* info =
-            dynamic_cast<ProducerAck*>(dataStructure);
+            static_cast<ProducerAck*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -154,7 +154,7 @@ void ProducerAckMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructu
     try {
 
         ProducerAck* info =
-            dynamic_cast<ProducerAck*>(dataStructure);
+            static_cast<ProducerAck*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
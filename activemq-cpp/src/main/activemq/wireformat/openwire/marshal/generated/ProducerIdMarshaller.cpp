@@ -58,8 +58,8 @@ void ProducerIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         ProducerId* info =
-            dynamic_cast<ProducerId*>(dataStructure);
-        info->setConnectionId(tightUnmarshalString(dataIn, bs));
+            static_cast<ProducerId*>(dataStructure);
+        info->setConnectionId(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setValue(tightUnmarshalLong(wireFormat, dataIn, bs));
         info->setSessionId(tightUnmarshalLong(wireFormat, dataIn, bs));
     }
@@ -74,7 +74,7 @@ int ProducerIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructur
     try {
 
         ProducerId* info =
-            dynamic_cast<ProducerId*>(dataStructure);
+            static_cast<ProducerId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getConnectionId(), bs);
@@ -96,7 +96,7 @@ void ProducerIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructu
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         ProducerId* info =
-            dynamic_cast<ProducerId*>(dataStructure);
+            static_cast<ProducerId*>(dataStructure);
         tightMarshalString2(info->getConnectionId(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getValue(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getSessionId(), dataOut, bs);
@@ -113,8 +113,8 @@ void ProducerIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         ProducerId* info =
-            dynamic_cast<ProducerId*>(dataStructure);
-        info->setConnectionId(looseUnmarshalString(dataIn));
+            static_cast<ProducerId*>(dataStructure);
+        info->setConnectionId(looseUnmarshalString(wireFormat, dataIn));
         info->setValue(looseUnmarshalLong(wireFormat, dataIn));
         info->setSessionId(looseUnmarshalLong(wireFormat, dataIn));
     }
@@ -129,7 +129,7 @@ void ProducerIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructur
     try {
 
         ProducerId* info =
-            dynamic_cast<ProducerId*>(dataStructure);
+            static_cast<ProducerId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getConnectionId(), dataOut);
         looseMarshalLong(wireFormat, info->getValue(), dataOut);
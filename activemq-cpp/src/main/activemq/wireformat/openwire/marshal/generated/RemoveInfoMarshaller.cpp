@@ -58,7 +58,7 @@ void RemoveInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStruct
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         RemoveInfo* info =
-            dynamic_cast<RemoveInfo*>(dataStructure);
+            static_cast<RemoveInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -79,7 +79,7 @@ int RemoveInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructur
     try {
 
         RemoveInfo* info =
-            dynamic_cast<RemoveInfo*>(dataStructure);
+            static_cast<RemoveInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -105,7 +105,7 @@ void RemoveInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructu
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         RemoveInfo* info =
-            dynamic_cast<RemoveInfo*>(dataStructure);
+            static_cast<RemoveInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -126,7 +126,7 @@ void RemoveInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStruct
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         RemoveInfo* info =
-            dynamic_cast<RemoveInfo*>(dataStructure);
+            static_cast<RemoveInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -147,7 +147,7 @@ void RemoveInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructur
     try {
 
         RemoveInfo* info =
-            dynamic_cast<RemoveInfo*>(dataStructure);
+            static_cast<RemoveInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,11 +58,11 @@ void RemoveSubscriptionInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         RemoveSubscriptionInfo* info =
-            dynamic_cast<RemoveSubscriptionInfo*>(dataStructure);
+            static_cast<RemoveSubscriptionInfo*>(dataStructure);
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
-        info->setSubcriptionName(tightUnmarshalString(dataIn, bs));
-        info->setClientId(tightUnmarshalString(dataIn, bs));
+        info->setSubcriptionName(tightUnmarshalString(wireFormat, dataIn, bs));
+        info->setClientId(tightUnmarshalString(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -75,7 +75,7 @@ int RemoveSubscriptionInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat,
     try {
 
         RemoveSubscriptionInfo* info =
-            dynamic_cast<RemoveSubscriptionInfo*>(dataStructure);
+            static_cast<RemoveSubscriptionInfo*>(dataStructure);
 
         int rc = BaseCommandMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalCachedObject1(wireFormat, info->getConnectionId().get(), bs);
@@ -97,7 +97,7 @@ void RemoveSubscriptionInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat,
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         RemoveSubscriptionInfo* info =
-            dynamic_cast<RemoveSubscriptionInfo*>(dataStructure);
+            static_cast<RemoveSubscriptionInfo*>(dataStructure);
         tightMarshalCachedObject2(wireFormat, info->getConnectionId().get(), dataOut, bs);
         tightMarshalString2(info->getSubcriptionName(), dataOut, bs);
         tightMarshalString2(info->getClientId(), dataOut, bs);
@@ -114,11 +114,11 @@ void RemoveSubscriptionInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         RemoveSubscriptionInfo* info =
-            dynamic_cast<RemoveSubscriptionInfo*>(dataStructure);
+            static_cast<RemoveSubscriptionInfo*>(dataStructure);
         info->setConnectionId(Pointer<ConnectionId>(dynamic_cast<ConnectionId*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
-        info->setSubcriptionName(looseUnmarshalString(dataIn));
-        info->setClientId(looseUnmarshalString(dataIn));
+        info->setSubcriptionName(looseUnmarshalString(wireFormat, dataIn));
+        info->setClientId(looseUnmarshalString(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -131,7 +131,7 @@ void RemoveSubscriptionInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat,
     try {
 
         RemoveSubscriptionInfo* info =
-            dynamic_cast<RemoveSubscriptionInfo*>(dataStructure);
+            static_cast<RemoveSubscriptionInfo*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalCachedObject(wireFormat, info->getConnectionId().get(), dataOut);
         looseMarshalString(info->getSubcriptionName(), dataOut);
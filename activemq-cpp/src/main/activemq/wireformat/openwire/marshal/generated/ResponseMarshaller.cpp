@@ -58,7 +58,7 @@ void ResponseMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructur
         BaseCommandMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         Response* info =
-            dynamic_cast<Response*>(dataStructure);
+            static_cast<Response*>(dataStructure);
         info->setCorrelationId(dataIn->readInt());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -88,7 +88,7 @@ void ResponseMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructure
         BaseCommandMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         Response* info =
-            dynamic_cast<Response*>(dataStructure);
+            static_cast<Response*>(dataStructure);
         dataOut->writeInt(info->getCorrelationId());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -103,7 +103,7 @@ void ResponseMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructur
 
         BaseCommandMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         Response* info =
-            dynamic_cast<Response*>(dataStructure);
+            static_cast<Response*>(dataStructure);
         info->setCorrelationId(dataIn->readInt());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -117,7 +117,7 @@ void ResponseMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure*
     try {
 
         Response* info =
-            dynamic_cast<Response*>(dataStructure);
+            static_cast<Response*>(dataStructure);
         BaseCommandMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         dataOut->writeInt(info->getCorrelationId());
     }
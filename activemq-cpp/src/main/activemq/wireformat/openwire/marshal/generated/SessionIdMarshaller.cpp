@@ -58,8 +58,8 @@ void SessionIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataStructu
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         SessionId* info =
-            dynamic_cast<SessionId*>(dataStructure);
-        info->setConnectionId(tightUnmarshalString(dataIn, bs));
+            static_cast<SessionId*>(dataStructure);
+        info->setConnectionId(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setValue(tightUnmarshalLong(wireFormat, dataIn, bs));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -73,7 +73,7 @@ int SessionIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStructure
     try {
 
         SessionId* info =
-            dynamic_cast<SessionId*>(dataStructure);
+            static_cast<SessionId*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         rc += tightMarshalString1(info->getConnectionId(), bs);
@@ -94,7 +94,7 @@ void SessionIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStructur
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         SessionId* info =
-            dynamic_cast<SessionId*>(dataStructure);
+            static_cast<SessionId*>(dataStructure);
         tightMarshalString2(info->getConnectionId(), dataOut, bs);
         tightMarshalLong2(wireFormat, info->getValue(), dataOut, bs);
     }
@@ -110,8 +110,8 @@ void SessionIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataStructu
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         SessionId* info =
-            dynamic_cast<SessionId*>(dataStructure);
-        info->setConnectionId(looseUnmarshalString(dataIn));
+            static_cast<SessionId*>(dataStructure);
+        info->setConnectionId(looseUnmarshalString(wireFormat, dataIn));
         info->setValue(looseUnmarshalLong(wireFormat, dataIn));
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -125,7 +125,7 @@ void SessionIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStructure
     try {
 
         SessionId* info =
-            dynamic_cast<SessionId*>(dataStructure);
+            static_cast<SessionId*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         looseMarshalString(info->getConnectionId(), dataOut);
         looseMarshalLong(wireFormat, info->getValue(), dataOut);
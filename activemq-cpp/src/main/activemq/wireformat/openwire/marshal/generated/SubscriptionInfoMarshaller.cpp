@@ -58,15 +58,15 @@ void SubscriptionInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, Data
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         SubscriptionInfo* info =
-            dynamic_cast<SubscriptionInfo*>(dataStructure);
+            static_cast<SubscriptionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
-        info->setClientId(tightUnmarshalString(dataIn, bs));
+        info->setClientId(tightUnmarshalString(wireFormat, dataIn, bs));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
             tightUnmarshalCachedObject(wireFormat, dataIn, bs))));
-        info->setSelector(tightUnmarshalString(dataIn, bs));
-        info->setSubcriptionName(tightUnmarshalString(dataIn, bs));
+        info->setSelector(tightUnmarshalString(wireFormat, dataIn, bs));
+        info->setSubcriptionName(tightUnmarshalString(wireFormat, dataIn, bs));
         if (wireVersion >= 3) {
             info->setSubscribedDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination* >(
                 tightUnmarshalNestedObject(wireFormat, dataIn, bs))));
@@ -86,7 +86,7 @@ int SubscriptionInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataSt
     try {
 
         SubscriptionInfo* info =
-            dynamic_cast<SubscriptionInfo*>(dataStructure);
+            static_cast<SubscriptionInfo*>(dataStructure);
 
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
 
@@ -118,7 +118,7 @@ void SubscriptionInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataS
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         SubscriptionInfo* info =
-            dynamic_cast<SubscriptionInfo*>(dataStructure);
+            static_cast<SubscriptionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
@@ -145,15 +145,15 @@ void SubscriptionInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, Data
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         SubscriptionInfo* info =
-            dynamic_cast<SubscriptionInfo*>(dataStructure);
+            static_cast<SubscriptionInfo*>(dataStructure);
 
         int wireVersion = wireFormat->getVersion();
 
-        info->setClientId(looseUnmarshalString(dataIn));
+        info->setClientId(looseUnmarshalString(wireFormat, dataIn));
         info->setDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
             looseUnmarshalCachedObject(wireFormat, dataIn))));
-        info->setSelector(looseUnmarshalString(dataIn));
-        info->setSubcriptionName(looseUnmarshalString(dataIn));
+        info->setSelector(looseUnmarshalString(wireFormat, dataIn));
+        info->setSubcriptionName(looseUnmarshalString(wireFormat, dataIn));
         if (wireVersion >= 3) {
             info->setSubscribedDestination(Pointer<ActiveMQDestination>(dynamic_cast<ActiveMQDestination*>(
                 looseUnmarshalNestedObject(wireFormat, dataIn))));
@@ -173,7 +173,7 @@ void SubscriptionInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataSt
     try {
 
         SubscriptionInfo* info =
-            dynamic_cast<SubscriptionInfo*>(dataStructure);
+            static_cast<SubscriptionInfo*>(dataStructure);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
 
         int wireVersion = wireFormat->getVersion();
@@ -58,12 +58,12 @@ void WireFormatInfoMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataSt
         BaseDataStreamMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         WireFormatInfo* info =
-            dynamic_cast<WireFormatInfo*>(dataStructure);
+            static_cast<WireFormatInfo*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
 
         info->setMagic(tightUnmarshalConstByteArray(dataIn, bs, 8));
         info->setVersion(dataIn->readInt());
-        info->setMarshalledProperties(tightUnmarshalByteArray(dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getMarshalledProperties());
 
         info->afterUnmarshal( wireFormat );
     }
@@ -78,7 +78,7 @@ int WireFormatInfoMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStru
     try {
 
         WireFormatInfo* info =
-            dynamic_cast<WireFormatInfo*>(dataStructure);
+            static_cast<WireFormatInfo*>(dataStructure);
 
         info->beforeMarshal(wireFormat);
         int rc = BaseDataStreamMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
@@ -100,7 +100,7 @@ void WireFormatInfoMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataStr
         BaseDataStreamMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         WireFormatInfo* info =
-            dynamic_cast<WireFormatInfo*>(dataStructure);
+            static_cast<WireFormatInfo*>(dataStructure);
         dataOut->write((const unsigned char*)(&info->getMagic()[0]), 8, 0, 8);
         dataOut->writeInt(info->getVersion());
         if (bs->readBoolean()) {
@@ -121,11 +121,11 @@ void WireFormatInfoMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataSt
 
         BaseDataStreamMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         WireFormatInfo* info =
-            dynamic_cast<WireFormatInfo*>(dataStructure);
+            static_cast<WireFormatInfo*>(dataStructure);
         info->beforeUnmarshal(wireFormat);
         info->setMagic(looseUnmarshalConstByteArray(dataIn, 8));
         info->setVersion(dataIn->readInt());
-        info->setMarshalledProperties(looseUnmarshalByteArray(dataIn));
+        looseUnmarshalByteArray(dataIn, info->getMarshalledProperties());
         info->afterUnmarshal(wireFormat);
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
@@ -139,7 +139,7 @@ void WireFormatInfoMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStru
     try {
 
         WireFormatInfo* info =
-            dynamic_cast<WireFormatInfo*>(dataStructure);
+            static_cast<WireFormatInfo*>(dataStructure);
         info->beforeMarshal(wireFormat);
         BaseDataStreamMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         dataOut->write((const unsigned char*)(&info->getMagic()[0]), 8, 0, 8);
@@ -58,10 +58,10 @@ void XATransactionIdMarshaller::tightUnmarshal(OpenWireFormat* wireFormat, DataS
         TransactionIdMarshaller::tightUnmarshal(wireFormat, dataStructure, dataIn, bs);
 
         XATransactionId* info =
-            dynamic_cast<XATransactionId*>(dataStructure);
+            static_cast<XATransactionId*>(dataStructure);
         info->setFormatId(dataIn->readInt());
-        info->setGlobalTransactionId(tightUnmarshalByteArray(dataIn, bs));
-        info->setBranchQualifier(tightUnmarshalByteArray(dataIn, bs));
+        tightUnmarshalByteArray(dataIn, bs, info->getGlobalTransactionId());
+        tightUnmarshalByteArray(dataIn, bs, info->getBranchQualifier());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -74,7 +74,7 @@ int XATransactionIdMarshaller::tightMarshal1(OpenWireFormat* wireFormat, DataStr
     try {
 
         XATransactionId* info =
-            dynamic_cast<XATransactionId*>(dataStructure);
+            static_cast<XATransactionId*>(dataStructure);
 
         int rc = TransactionIdMarshaller::tightMarshal1(wireFormat, dataStructure, bs);
         bs->writeBoolean(info->getGlobalTransactionId().size() != 0);
@@ -97,7 +97,7 @@ void XATransactionIdMarshaller::tightMarshal2(OpenWireFormat* wireFormat, DataSt
         TransactionIdMarshaller::tightMarshal2(wireFormat, dataStructure, dataOut, bs );
 
         XATransactionId* info =
-            dynamic_cast<XATransactionId*>(dataStructure);
+            static_cast<XATransactionId*>(dataStructure);
         dataOut->writeInt(info->getFormatId());
         if (bs->readBoolean()) {
             dataOut->writeInt((int)info->getGlobalTransactionId().size() );
@@ -120,10 +120,10 @@ void XATransactionIdMarshaller::looseUnmarshal(OpenWireFormat* wireFormat, DataS
 
         TransactionIdMarshaller::looseUnmarshal(wireFormat, dataStructure, dataIn);
         XATransactionId* info =
-            dynamic_cast<XATransactionId*>(dataStructure);
+            static_cast<XATransactionId*>(dataStructure);
         info->setFormatId(dataIn->readInt());
-        info->setGlobalTransactionId(looseUnmarshalByteArray(dataIn));
-        info->setBranchQualifier(looseUnmarshalByteArray(dataIn));
+        looseUnmarshalByteArray(dataIn, info->getGlobalTransactionId());
+        looseUnmarshalByteArray(dataIn, info->getBranchQualifier());
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, decaf::io::IOException)
@@ -136,7 +136,7 @@ void XATransactionIdMarshaller::looseMarshal(OpenWireFormat* wireFormat, DataStr
     try {
 
         XATransactionId* info =
-            dynamic_cast<XATransactionId*>(dataStructure);
+            static_cast<XATransactionId*>(dataStructure);
         TransactionIdMarshaller::looseMarshal(wireFormat, dataStructure, dataOut);
         dataOut->writeInt(info->getFormatId());
         dataOut->write( info->getGlobalTransactionId().size() != 0 );
@@ -19,6 +19,8 @@
 
 #include <activemq/exceptions/ActiveMQException.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::exceptions;
@@ -30,10 +32,10 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ///////////////////////////////////////////////////////////////////////////////
-BooleanStream::BooleanStream() : data(), arrayLimit(0), arrayPos(0), bytePos(0) {
+BooleanStream::BooleanStream() : data(NULL), capacity(INLINE_CAPACITY), inlineData(), overflow(),
+                                 arrayLimit(0), arrayPos(0), bytePos(0) {
 
-    // Reserve 1K
-    this->data.resize( 1000, 0 );
+    this->data = this->inlineData;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,9 +69,9 @@ void BooleanStream::writeBoolean( bool value ) {
         if( bytePos == 0 ) {
             arrayLimit++;
 
-            if( (size_t)arrayLimit >= data.size() ) {
+            if( arrayLimit >= capacity ) {
                 // re-grow the array if necessary
-                data.resize( data.size() * 2 );
+                ensureCapacity( capacity * 2 );
             }
         }
 
@@ -90,6 +92,28 @@ void BooleanStream::writeBoolean( bool value ) {
     AMQ_CATCHALL_THROW( IOException )
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::writeBits( unsigned int bits, int count ) {
+
+    try{
+
+        for( int i = 0; i < count; ++i ) {
+            writeBoolean( ( ( bits >> i ) & 0x01 ) != 0 );
+        }
+    }
+    AMQ_CATCH_RETHROW( IOException )
+    AMQ_CATCH_EXCEPTION_CONVERT( Exception, IOException )
+    AMQ_CATCHALL_THROW( IOException )
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::skip( int count ) {
+
+    int position = bytePos + count;
+    arrayPos = (short)( arrayPos + position / 8 );
+    bytePos = (unsigned char)( position % 8 );
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 void BooleanStream::marshal( DataOutputStream* dataOut ) {
 
@@ -106,7 +130,7 @@ void BooleanStream::marshal( DataOutputStream* dataOut ) {
         }
 
         // Dump the payload
-        dataOut->write( &data[0], (int)data.size(), 0, arrayLimit );
+        dataOut->write( data, capacity, 0, arrayLimit );
         clear();
     }
     AMQ_CATCH_RETHROW( IOException )
@@ -131,7 +155,7 @@ void BooleanStream::marshal( std::vector< unsigned char >& dataOut ) {
         }
 
         // Insert all data from data into the passed buffer
-        dataOut.insert( dataOut.end(), &data[0], &data[arrayLimit-1] );
+        dataOut.insert( dataOut.end(), data, data + arrayLimit - 1 );
     }
     AMQ_CATCH_RETHROW( IOException )
     AMQ_CATCH_EXCEPTION_CONVERT( Exception, IOException )
@@ -152,10 +176,10 @@ void BooleanStream::unmarshal( DataInputStream* dataIn ) {
         }
 
         // Make sure we can accomodate all the data.
-        data.resize( arrayLimit );
+        ensureCapacity( arrayLimit );
 
         // Make sure we get all the data we are expecting
-        dataIn->readFully( &data[0], (int)data.size(), 0, arrayLimit );
+        dataIn->readFully( data, capacity, 0, arrayLimit );
 
         clear();
     }
@@ -171,6 +195,19 @@ void BooleanStream::clear() {
     bytePos = 0;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::reset() {
+
+    // Only the bytes that were in use can hold set bits, the rest are still zero.
+    int used = std::min( (int)arrayLimit, capacity );
+    if( used > 0 ) {
+        std::fill( data, data + used, (unsigned char)0 );
+    }
+
+    arrayLimit = 0;
+    clear();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 int BooleanStream::marshalledSize() {
 
@@ -182,3 +219,19 @@ int BooleanStream::marshalledSize() {
         return 3 + arrayLimit;
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////
+void BooleanStream::ensureCapacity( int size ) {
+
+    if( size <= capacity ) {
+        return;
+    }
+
+    if( data == inlineData ) {
+        overflow.assign( inlineData, inlineData + capacity );
+    }
+
+    overflow.resize( size, 0 );
+    data = &overflow[0];
+    capacity = size;
+}
@@ -22,6 +22,8 @@
 #include <decaf/io/DataOutputStream.h>
 #include <activemq/util/Config.h>
 
+#include <vector>
+
 namespace activemq{
 namespace wireformat{
 namespace openwire{
@@ -49,8 +51,22 @@ namespace utils{
     class AMQCPP_API BooleanStream {
     private:
 
-        // Internal Buffer of data
-        std::vector<unsigned char> data;
+        // Number of bytes held inline before the stream spills to the heap, nearly
+        // every command marshals well under this many booleans.
+        static const int INLINE_CAPACITY = 64;
+
+        // Points at the inline buffer or at the overflow vector's storage.
+        unsigned char* data;
+
+        // Number of bytes that data can hold.
+        int capacity;
+
+        // Inline storage used until the stream grows larger than it.
+        unsigned char inlineData[INLINE_CAPACITY];
+
+        // Heap storage for streams that outgrow the inline buffer, kept once
+        // allocated so a reused stream doesn't allocate again.
+        std::vector<unsigned char> overflow;
 
         // Limit on buffer size
         short arrayLimit;
@@ -61,6 +77,11 @@ namespace utils{
         // Bit we are on in the byte we are on from the buffer
         unsigned char bytePos;
 
+    private:
+
+        BooleanStream(const BooleanStream&);
+        BooleanStream& operator=(const BooleanStream&);
+
     public:
 
         BooleanStream();
@@ -84,6 +105,32 @@ namespace utils{
          */
         void writeBoolean( bool value );
 
+        /**
+         * Writes a run of boolean values, lowest bit first, the same as calling
+         * writeBoolean once for each of the given bits.
+         *
+         * @param bits - the values to write, bit 0 is written first.
+         * @param count - the number of bits to write, at most 32.
+         *
+         * @throws IOException if an I/O error occurs during this operation.
+         */
+        void writeBits( unsigned int bits, int count );
+
+        /**
+         * Moves past the given number of booleans without reading them.
+         *
+         * @param count - the number of booleans to skip.
+         */
+        void skip( int count );
+
+        /**
+         * @return the number of booleans read or written since the stream was last
+         *         cleared.
+         */
+        int getPosition() const {
+            return arrayPos * 8 + bytePos;
+        }
+
         /**
          * Marshal the data to a DataOutputStream
          * @param dataOut - Stream to write the data to.
@@ -113,12 +160,24 @@ namespace utils{
          */
         void clear();
 
+        /**
+         * Discards all boolean data that has been written or unmarshaled so that the
+         * stream can be reused for another marshal operation without reallocating its
+         * internal buffer.
+         */
+        void reset();
+
         /**
          * Calc the size that data is marshalled to
          * @return int size of marshalled data.
          */
         int marshalledSize();
 
+    private:
+
+        // Makes room for at least the given number of bytes, new bytes are zeroed.
+        void ensureCapacity(int size);
+
     };
 
 }}}}
@@ -69,7 +69,7 @@ bool MessagePropertyInterceptor::getBooleanProperty(const std::string& name) con
         return message->isJMSXGroupFirstForConsumer();
     }
 
-    return this->properties->getBool(name);
+    return this->getProperties()->getBool(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,7 +80,7 @@ unsigned char MessagePropertyInterceptor::getByteProperty(const std::string& nam
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    return this->properties->getByte(name);
+    return this->getProperties()->getByte(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -91,7 +91,7 @@ double MessagePropertyInterceptor::getDoubleProperty(const std::string& name) co
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    return this->properties->getDouble(name);
+    return this->getProperties()->getDouble(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,7 +103,7 @@ float MessagePropertyInterceptor::getFloatProperty(const std::string& name) cons
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    return this->properties->getFloat(name);
+    return this->getProperties()->getFloat(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,7 +117,7 @@ int MessagePropertyInterceptor::getIntProperty(const std::string& name) const {
         return this->message->getGroupSequence();
     }
 
-    return this->properties->getInt(name);
+    return this->getProperties()->getInt(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,7 +131,7 @@ long long MessagePropertyInterceptor::getLongProperty(const std::string& name) c
         return (long long) this->message->getGroupSequence();
     }
 
-    return this->properties->getLong(name);
+    return this->getProperties()->getLong(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,7 +143,7 @@ short MessagePropertyInterceptor::getShortProperty(const std::string& name) cons
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    return this->properties->getShort(name);
+    return this->getProperties()->getShort(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -159,7 +159,7 @@ std::string MessagePropertyInterceptor::getStringProperty(const std::string& nam
         return Boolean::toString(message->isJMSXGroupFirstForConsumer());
     }
 
-    return this->properties->getString(name);
+    return this->getProperties()->getString(name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,7 +171,7 @@ void MessagePropertyInterceptor::setBooleanProperty(const std::string& name, boo
         return message->setJMSXGroupFirstForConsumer(value);
     }
 
-    this->properties->setBool(name, value);
+    this->getPropertiesForUpdate()->setBool(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -181,7 +181,7 @@ void MessagePropertyInterceptor::setByteProperty(const std::string& name, unsign
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    this->properties->setByte(name, value);
+    this->getPropertiesForUpdate()->setByte(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -191,7 +191,7 @@ void MessagePropertyInterceptor::setDoubleProperty(const std::string& name, doub
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    this->properties->setDouble(name, value);
+    this->getPropertiesForUpdate()->setDouble(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -203,7 +203,7 @@ void MessagePropertyInterceptor::setFloatProperty(const std::string& name, float
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    this->properties->setFloat(name, value);
+    this->getPropertiesForUpdate()->setFloat(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -217,7 +217,7 @@ void MessagePropertyInterceptor::setIntProperty(const std::string& name, int val
         this->message->setGroupSequence(value);
     }
 
-    this->properties->setInt(name, value);
+    this->getPropertiesForUpdate()->setInt(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -226,7 +226,7 @@ void MessagePropertyInterceptor::setLongProperty(const std::string& name, long l
         throw ActiveMQException(__FILE__, __LINE__, "Cannot Convert Reserved Property to this Type.");
     }
 
-    this->properties->setLong(name, value);
+    this->getPropertiesForUpdate()->setLong(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -240,7 +240,7 @@ void MessagePropertyInterceptor::setShortProperty(const std::string& name, short
         this->message->setGroupSequence((int) value);
     }
 
-    this->properties->setShort(name, value);
+    this->getPropertiesForUpdate()->setShort(name, value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -256,5 +256,18 @@ void MessagePropertyInterceptor::setStringProperty(const std::string& name, cons
         this->message->setJMSXGroupFirstForConsumer(Boolean::parseBoolean(value));
     }
 
-    this->properties->setString(name, value);
+    this->getPropertiesForUpdate()->setString(name, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const PrimitiveMap* MessagePropertyInterceptor::getProperties() const {
+    this->message->unmarshalProperties();
+    return this->properties;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PrimitiveMap* MessagePropertyInterceptor::getPropertiesForUpdate() {
+    // The non-const accessor is what tells the Message its properties changed.
+    this->message->getMessageProperties();
+    return this->properties;
 }
@@ -182,6 +182,14 @@ namespace utils {
          */
         virtual void setStringProperty( const std::string& name, const std::string& value );
 
+    private:
+
+        // Returns the properties once the Message has unmarshaled any it received.
+        const util::PrimitiveMap* getProperties() const;
+
+        // Returns the properties for a change, the Message then marshals them again.
+        util::PrimitiveMap* getPropertiesForUpdate();
+
     };
 
 }}}}
@@ -0,0 +1,102 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UnmarshalArena.h"
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+const int UnmarshalArena::DEFAULT_CHUNK_SIZE = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+UnmarshalArena::UnmarshalArena(int chunkSize) : chunks(), current(0), offset(0), chunkSize(chunkSize) {
+
+    if (chunkSize <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Chunk size must be positive: %d", chunkSize);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+UnmarshalArena::~UnmarshalArena() {
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        delete [] chunks[i].data;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char* UnmarshalArena::allocate(int size) {
+
+    if (size < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Allocation size is negative: %d", size);
+    }
+
+    if (current < chunks.size() && chunks[current].capacity - offset >= size) {
+        unsigned char* block = chunks[current].data + offset;
+        offset += size;
+        return block;
+    }
+
+    return allocateChunk(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char* UnmarshalArena::allocateChunk(int size) {
+
+    Chunk chunk;
+    chunk.capacity = size > chunkSize ? size : chunkSize;
+    chunk.data = new unsigned char[chunk.capacity];
+
+    try {
+        chunks.push_back(chunk);
+    } catch (...) {
+        delete [] chunk.data;
+        throw;
+    }
+
+    current = chunks.size() - 1;
+    offset = size;
+    return chunk.data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnmarshalArena::reset() {
+
+    while (chunks.size() > 1) {
+        delete [] chunks.back().data;
+        chunks.pop_back();
+    }
+
+    current = 0;
+    offset = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long UnmarshalArena::getCapacity() const {
+
+    long long capacity = 0;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        capacity += chunks[i].capacity;
+    }
+
+    return capacity;
+}
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_UNMARSHALARENA_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_UNMARSHALARENA_H_
+
+#include <activemq/util/Config.h>
+
+#include <vector>
+
+namespace activemq {
+namespace wireformat {
+namespace openwire {
+namespace utils {
+
+    /**
+     * Monotonic allocator for the temporaries of one unmarshal, such as the encoded bytes
+     * of a string before it is decoded into the command.  Allocations bump a pointer
+     * through a chunk and are never freed one by one, reset() makes the whole arena
+     * available again for the next frame.
+     *
+     * The first chunk is kept across resets so that the usual frame allocates nothing
+     * from the heap, chunks added for a frame larger than it are released by reset().
+     * Memory handed out is only valid until the next reset and must not escape the
+     * unmarshal.  The arena is not thread safe, it belongs to the one thread reading
+     * a transport.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API UnmarshalArena {
+    public:
+
+        /**
+         * Size of the chunk the arena starts with.
+         */
+        static const int DEFAULT_CHUNK_SIZE;
+
+    private:
+
+        struct Chunk {
+            unsigned char* data;
+            int capacity;
+        };
+
+        std::vector<Chunk> chunks;
+
+        // The chunk being allocated from and the offset of its first free byte.
+        std::size_t current;
+        int offset;
+
+        int chunkSize;
+
+    private:
+
+        UnmarshalArena(const UnmarshalArena&);
+        UnmarshalArena& operator=(const UnmarshalArena&);
+
+    public:
+
+        /**
+         * Creates an arena whose chunks are at least the given number of bytes.
+         *
+         * @param chunkSize
+         *      The size of the first chunk and the least size of those added later.
+         */
+        explicit UnmarshalArena(int chunkSize = DEFAULT_CHUNK_SIZE);
+
+        ~UnmarshalArena();
+
+        /**
+         * Returns a block of the given number of bytes that stays valid until the next
+         * reset.  The block is not initialized.
+         *
+         * @param size
+         *      The number of bytes needed, zero or more.
+         *
+         * @return the start of the block.
+         */
+        unsigned char* allocate(int size);
+
+        /**
+         * Makes all the memory handed out since the last reset available again, keeping
+         * only the first chunk.
+         */
+        void reset();
+
+        /**
+         * @return the number of bytes the arena currently holds from the heap.
+         */
+        long long getCapacity() const;
+
+    private:
+
+        unsigned char* allocateChunk(int size);
+
+    };
+
+}}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_OPENWIRE_UTILS_UNMARSHALARENA_H_ */
@@ -79,6 +79,9 @@ const std::string StompCommandConstants::HEADER_ID = "id";
 const std::string StompCommandConstants::HEADER_SUBSCRIPTION = "subscription";
 const std::string StompCommandConstants::HEADER_TRANSFORMATION = "transformation";
 const std::string StompCommandConstants::HEADER_TRANSFORMATION_ERROR = "transformation-error";
+const std::string StompCommandConstants::HEADER_ACCEPT_VERSION = "accept-version";
+const std::string StompCommandConstants::HEADER_VERSION = "version";
+const std::string StompCommandConstants::HEADER_HEARTBEAT = "heart-beat";
 
 ////////////////////////////////////////////////////////////////////////////////
 // Stomp Ack Modes
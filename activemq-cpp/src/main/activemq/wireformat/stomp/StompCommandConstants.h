@@ -84,6 +84,9 @@ namespace stomp{
         static const std::string HEADER_SUBSCRIPTION;
         static const std::string HEADER_TRANSFORMATION;
         static const std::string HEADER_TRANSFORMATION_ERROR;
+        static const std::string HEADER_ACCEPT_VERSION;
+        static const std::string HEADER_VERSION;
+        static const std::string HEADER_HEARTBEAT;
 
         // Stomp Ack Modes
         static const std::string ACK_CLIENT;
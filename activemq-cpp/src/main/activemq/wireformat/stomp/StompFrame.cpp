@@ -18,8 +18,10 @@
 #include "StompFrame.h"
 
 #include <string>
+#include <string.h>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/io/EOFException.h>
 #include <decaf/lang/Character.h>
 #include <decaf/lang/Integer.h>
 
@@ -36,6 +38,63 @@ using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Largest number of bytes read ahead of the parse position when looking for
+    // a delimiter, kept well below the default transport buffer size so that a
+    // mark never forces the buffered stream to grow.
+    const int MAX_READ_WINDOW = 512;
+
+    // Characters escaped in the headers of STOMP 1.1 and later frames.
+    const char* const ESCAPED_CHARACTERS = "\\:\n\r";
+
+    // Decodes the escapes in the NUL terminated text in place, returns the decoded length.
+    std::size_t unescape(unsigned char* text, std::size_t length) {
+
+        unsigned char* out = (unsigned char*) memchr(text, '\\', length);
+        if (out == NULL) {
+            return length;
+        }
+
+        const unsigned char* in = out;
+        const unsigned char* end = text + length;
+
+        while (in < end) {
+
+            if (*in != '\\') {
+                *out++ = *in++;
+                continue;
+            }
+
+            if (++in == end) {
+                throw decaf::io::IOException(__FILE__, __LINE__, "StompFrame::readHeaders: header ends in an escape");
+            }
+
+            switch (*in++) {
+                case 'n':
+                    *out++ = '\n';
+                    break;
+                case 'r':
+                    *out++ = '\r';
+                    break;
+                case 'c':
+                    *out++ = ':';
+                    break;
+                case '\\':
+                    *out++ = '\\';
+                    break;
+                default:
+                    throw decaf::io::IOException(__FILE__, __LINE__, "StompFrame::readHeaders: undefined escape in header");
+            }
+        }
+
+        *out = '\0';
+        return (std::size_t) (out - text);
+    }
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 StompFrame::StompFrame() : command(), properties(), body() {
 }
@@ -72,6 +131,11 @@ void StompFrame::setBody(const unsigned char* bytes, std::size_t numBytes) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
+    this->toStream(stream, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrame::toStream(decaf::io::DataOutputStream* stream, bool escapeHeaders) const {
 
     if (stream == NULL) {
         throw NullPointerException(__FILE__, __LINE__, "Stream Passed is Null");
@@ -88,6 +152,19 @@ void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
         string& name = headers[ix].first;
         string& value = headers[ix].second;
 
+        if (escapeHeaders) {
+            if (name.find_first_of(ESCAPED_CHARACTERS) != string::npos) {
+                string escaped;
+                appendEscaped(escaped, name);
+                name.swap(escaped);
+            }
+            if (value.find_first_of(ESCAPED_CHARACTERS) != string::npos) {
+                string escaped;
+                appendEscaped(escaped, value);
+                value.swap(escaped);
+            }
+        }
+
         stream->write((unsigned char*) name.c_str(), (int) name.length(), 0, (int) name.length());
         stream->write(':');
         stream->write((unsigned char*) value.c_str(), (int) value.length(), 0, (int) value.length());
@@ -113,8 +190,43 @@ void StompFrame::toStream(decaf::io::DataOutputStream* stream) const {
     stream->flush();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void StompFrame::appendEscaped(std::string& buffer, const std::string& value) {
+
+    std::size_t start = 0;
+    std::size_t next = value.find_first_of(ESCAPED_CHARACTERS);
+
+    while (next != string::npos) {
+        buffer.append(value, start, next - start);
+        buffer.push_back('\\');
+        switch (value[next]) {
+            case '\n':
+                buffer.push_back('n');
+                break;
+            case '\r':
+                buffer.push_back('r');
+                break;
+            case ':':
+                buffer.push_back('c');
+                break;
+            default:
+                buffer.push_back('\\');
+                break;
+        }
+        start = next + 1;
+        next = value.find_first_of(ESCAPED_CHARACTERS, start);
+    }
+
+    buffer.append(value, start, string::npos);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void StompFrame::fromStream(decaf::io::DataInputStream* in) {
+    this->fromStream(in, false, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrame::fromStream(decaf::io::DataInputStream* in, bool unescapeHeaders, bool heartBeats) {
 
     if (in == NULL) {
         throw decaf::io::IOException(__FILE__, __LINE__, "DataInputStream passed is NULL");
@@ -122,11 +234,13 @@ void StompFrame::fromStream(decaf::io::DataInputStream* in) {
 
     try {
 
-        // Read the command header.
-        readCommandHeader(in);
+        // Read the command header, a heart-beat is all there is to read.
+        if (!readCommandHeader(in, heartBeats)) {
+            return;
+        }
 
         // Read the headers.
-        readHeaders(in);
+        readHeaders(in, unescapeHeaders);
 
         // Read the body.
         readBody(in);
@@ -137,10 +251,12 @@ void StompFrame::fromStream(decaf::io::DataInputStream* in) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void StompFrame::readCommandHeader(decaf::io::DataInputStream* in) {
+bool StompFrame::readCommandHeader(decaf::io::DataInputStream* in, bool heartBeats) {
 
     try {
 
+        this->command.clear();
+
         std::vector<unsigned char> buffer;
 
         while (true) {
@@ -162,7 +278,12 @@ void StompFrame::readCommandHeader(decaf::io::DataInputStream* in) {
             if (offset >= 0) {
                 // Set the command in the frame - copy the memory.
                 this->setCommand(reinterpret_cast<char*>(&buffer[(size_t) offset]));
-                break;
+                return true;
+            }
+
+            // An empty line between frames is the peer's heart-beat.
+            if (heartBeats) {
+                return false;
             }
         }
     }
@@ -172,7 +293,7 @@ void StompFrame::readCommandHeader(decaf::io::DataInputStream* in) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void StompFrame::readHeaders(decaf::io::DataInputStream* in) {
+void StompFrame::readHeaders(decaf::io::DataInputStream* in, bool unescape) {
 
     try {
 
@@ -198,24 +319,24 @@ void StompFrame::readHeaders(decaf::io::DataInputStream* in) {
             } else {
 
                 // Search through this line to separate the key/value pair.
-                for (size_t ix = 0; ix < buffer.size(); ++ix) {
+                unsigned char* separator = (unsigned char*) memchr(&buffer[0], ':', numChars);
 
-                    // If found the key/value separator...
-                    if (buffer[ix] == ':') {
+                if (separator != NULL) {
 
-                        // Null-terminate the key.
-                        buffer[ix] = '\0';
+                    // Null-terminate the key.
+                    *separator = '\0';
 
-                        const char* key = reinterpret_cast<char*>(&buffer[0]);
-                        const char* value = reinterpret_cast<char*>(&buffer[ix + 1]);
+                    if (unescape) {
+                        ::unescape(&buffer[0], (std::size_t) (separator - &buffer[0]));
+                        ::unescape(separator + 1, (std::size_t) (&buffer[numChars - 1] - (separator + 1)));
+                    }
 
-                        // Assign the header key/value pair.
-                        if (!this->getProperties().hasProperty(key)) {
-                            this->getProperties().setProperty(key, value);
-                        }
+                    const char* key = reinterpret_cast<char*>(&buffer[0]);
+                    const char* value = reinterpret_cast<char*>(separator + 1);
 
-                        // Break out of the for loop.
-                        break;
+                    // Assign the header key/value pair.
+                    if (!this->getProperties().hasProperty(key)) {
+                        this->getProperties().setProperty(key, value);
                     }
                 }
             }
@@ -234,28 +355,12 @@ std::size_t StompFrame::readHeaderLine(std::vector<unsigned char>& buffer, decaf
         // Clear any data from the buffer.
         buffer.clear();
 
-        std::size_t count = 0;
-
-        while (true) {
+        std::size_t count = readUntil(buffer, in, '\n');
 
-            // Read the next char from the stream.
-            buffer.push_back(in->readByte());
+        // Overwrite the line feed with a null character.
+        buffer[count - 1] = '\0';
 
-            // Increment the position pointer.
-            count++;
-
-            // If we reached the line terminator, return the total number
-            // of characters read.
-            if (buffer[count - 1] == '\n') {
-                // Overwrite the line feed with a null character.
-                buffer[count - 1] = '\0';
-                return count;
-            }
-        }
-
-        // If we get here something bad must have happened.
-        throw decaf::io::IOException(__FILE__, __LINE__, "StompWireFormat::readStompHeaderLine: "
-                "Unrecoverable, error condition");
+        return count;
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
@@ -307,17 +412,72 @@ void StompFrame::readBody(decaf::io::DataInputStream* in) {
 
             // Content length was either zero, or not set, so we read until the
             // first null is encountered.
+            readUntil(this->body, in, '\0');
+        }
+    }
+    AMQ_CATCH_RETHROW(decaf::io::IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(decaf::lang::Exception, decaf::io::IOException)
+    AMQ_CATCHALL_THROW(decaf::io::IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StompFrame::readUntil(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in, unsigned char delimiter) {
+
+    try {
+
+        std::size_t start = buffer.size();
+
+        if (!in->markSupported()) {
+
             while (true) {
 
-                char byte = in->readByte();
-                this->body.push_back(byte);
+                unsigned char byte = (unsigned char) in->readByte();
+                buffer.push_back(byte);
 
-                if (byte != '\0') {
-                    continue;
+                if (byte == delimiter) {
+                    return buffer.size() - start;
                 }
+            }
+        }
+
+        while (true) {
 
-                break; // Read null and newline we are done.
+            // Read whatever is already available, up to the window size, and at
+            // least one byte so that we block until the peer sends something.
+            int window = in->available();
+            if (window < 1) {
+                window = 1;
+            } else if (window > MAX_READ_WINDOW) {
+                window = MAX_READ_WINDOW;
             }
+
+            std::size_t offset = buffer.size();
+            buffer.resize(offset + (std::size_t) window);
+
+            in->mark(window);
+            int read = in->read(&buffer[0], (int) buffer.size(), (int) offset, window);
+
+            if (read == -1) {
+                buffer.resize(offset);
+                throw decaf::io::EOFException(__FILE__, __LINE__, "StompFrame::readUntil - Reached EOF");
+            }
+
+            unsigned char* found = (unsigned char*) memchr(&buffer[offset], delimiter, (std::size_t) read);
+
+            if (found == NULL) {
+                buffer.resize(offset + (std::size_t) read);
+                continue;
+            }
+
+            // Give back whatever was read past the delimiter.
+            int used = (int) (found - &buffer[offset]) + 1;
+            if (used < read) {
+                in->reset();
+                in->skip(used);
+            }
+
+            buffer.resize(offset + (std::size_t) used);
+            return buffer.size() - start;
         }
     }
     AMQ_CATCH_RETHROW(decaf::io::IOException)
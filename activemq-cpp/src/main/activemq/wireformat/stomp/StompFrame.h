@@ -177,6 +177,17 @@ namespace stomp {
          */
         void toStream(decaf::io::DataOutputStream* stream) const;
 
+        /**
+         * Writes this Frame to an OuputStream in the Stomp Wire Format, escaping the
+         * header names and values as STOMP 1.1 and later require when asked to.
+         *
+         * @param stream - The stream to write the Frame to.
+         * @param escapeHeaders - true if the headers are to be escaped.
+         *
+         * @throw IOException if an error occurs while reading the Frame.
+         */
+        void toStream(decaf::io::DataOutputStream* stream, bool escapeHeaders) const;
+
         /**
          * Reads a Stop Frame from a DataInputStream in the Stomp Wire format.
          *
@@ -186,21 +197,54 @@ namespace stomp {
          */
         void fromStream(decaf::io::DataInputStream* stream);
 
+        /**
+         * Reads a Stomp Frame from a DataInputStream in the Stomp Wire format.  Escaped
+         * headers are decoded as they are read, only a header containing a backslash
+         * costs more than a plain one.
+         *
+         * @param stream - The stream to read the Frame from.
+         * @param unescapeHeaders - true if the headers are escaped as in STOMP 1.1 and later.
+         * @param heartBeats - true if an empty line ahead of the command is a heart-beat,
+         *                     the read then ends and the frame is left without a command.
+         *
+         * @throw IOException if an error occurs while writing the Frame.
+         */
+        void fromStream(decaf::io::DataInputStream* stream, bool unescapeHeaders, bool heartBeats);
+
+        /**
+         * @return true if the last fromStream call read a heart-beat instead of a frame.
+         */
+        bool isHeartBeat() const {
+            return this->command.empty();
+        }
+
+        /**
+         * Appends the value to the buffer with the characters STOMP 1.1 and later escape
+         * in headers escaped.
+         *
+         * @param buffer - The buffer to append to.
+         * @param value - The header name or value to append.
+         */
+        static void appendEscaped(std::string& buffer, const std::string& value);
+
     private:
 
         /**
          * Read the Stomp Command from the Frame
          * @param in - The stream to read the Frame from.
+         * @param heartBeats - true if an empty line ends the read as a heart-beat.
+         * @return false if a heart-beat was read instead of a command.
          * @throws IOException
          */
-        void readCommandHeader(decaf::io::DataInputStream* in);
+        bool readCommandHeader(decaf::io::DataInputStream* in, bool heartBeats);
 
         /**
          * Read all the Stomp Headers for the incoming Frame
          * @param in - The stream to read the Frame from.
+         * @param unescape - true if the headers are escaped.
          * @throws IOException
          */
-        void readHeaders(decaf::io::DataInputStream* in);
+        void readHeaders(decaf::io::DataInputStream* in, bool unescape);
 
         /**
          * Reads a Stomp Header line and stores it in the buffer object
@@ -211,6 +255,20 @@ namespace stomp {
          */
         std::size_t readHeaderLine(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in);
 
+        /**
+         * Reads from the stream up to and including the first occurrence of the given
+         * delimiter, appending the bytes to the buffer.  When the stream supports mark
+         * the bytes are read in blocks and searched for the delimiter so that nothing
+         * past it is consumed, otherwise they are read one at a time.
+         *
+         * @param buffer - reference to a memory buffer that the bytes are appended to.
+         * @param in - The stream to read the Frame from.
+         * @param delimiter - The byte value that ends the read.
+         * @return number of bytes appended to the buffer including the delimiter.
+         * @throws IOException
+         */
+        std::size_t readUntil(std::vector<unsigned char>& buffer, decaf::io::DataInputStream* in, unsigned char delimiter);
+
         /**
          * Reads the Stomp Body from the Wire and store it in the frame.
          * @param in - The stream to read the Frame from.
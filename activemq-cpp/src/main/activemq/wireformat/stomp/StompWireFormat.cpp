@@ -20,6 +20,7 @@
 #include <activemq/wireformat/stomp/StompFrame.h>
 #include <activemq/wireformat/stomp/StompHelper.h>
 #include <activemq/wireformat/stomp/StompCommandConstants.h>
+#include <activemq/wireformat/stomp/StompWireFormatNegotiator.h>
 #include <activemq/core/ActiveMQConstants.h>
 #include <activemq/commands/Response.h>
 #include <activemq/commands/ActiveMQMessage.h>
@@ -39,6 +40,7 @@
 #include <activemq/commands/ProducerInfo.h>
 #include <activemq/commands/ConsumerInfo.h>
 #include <activemq/commands/RemoveSubscriptionInfo.h>
+#include <activemq/commands/KeepAliveInfo.h>
 
 #include <decaf/lang/Character.h>
 #include <decaf/lang/Integer.h>
@@ -83,13 +85,47 @@ namespace stomp {
         // Prefix used to address Temporary Queues (default is /temp-queue/
         std::string tempQueuePrefix;
 
+        // Messages and acks are encoded here and written in one piece, the storage is
+        // kept between frames.
+        std::string frameBuffer;
+
+        // The last destination and transaction written with their header values, a
+        // producer sends to the same destination and in the same transaction many times
+        // in a row.  The Pointers keep the objects alive so the identity test is sound.
+        Pointer<ActiveMQDestination> lastDestination;
+        std::string lastDestinationHeader;
+        Pointer<TransactionId> lastTransaction;
+        std::string lastTransactionHeader;
+
+        // Heart-beat intervals offered in the CONNECT frame, zero for none.
+        long long outgoingHeartBeat;
+        long long incomingHeartBeat;
+
+        // Heart-beat intervals agreed on with the broker when it connected.
+        long long sendInterval;
+        long long receiveInterval;
+
+        // True once the broker has accepted STOMP 1.1, headers are then escaped and
+        // acks name their subscription.
+        bool stomp11;
+
     public:
 
         StompWireformatProperties() : connectResponseId(-1),
                                       topicPrefix("/topic/"),
                                       queuePrefix("/queue/"),
                                       tempTopicPrefix("/temp-topic/"),
-                                      tempQueuePrefix("/temp-queue/") {
+                                      tempQueuePrefix("/temp-queue/"),
+                                      frameBuffer(),
+                                      lastDestination(),
+                                      lastDestinationHeader(),
+                                      lastTransaction(),
+                                      lastTransactionHeader(),
+                                      outgoingHeartBeat(0),
+                                      incomingHeartBeat(0),
+                                      sendInterval(0),
+                                      receiveInterval(0),
+                                      stomp11(false) {
 
         }
 
@@ -97,6 +133,63 @@ namespace stomp {
 
 }}}
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void appendNumber(std::string& buffer, long long value) {
+        char digits[24];
+        int pos = (int) sizeof(digits);
+        unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long) value : (unsigned long long) value;
+        do {
+            digits[--pos] = (char) ('0' + (magnitude % 10));
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (value < 0) {
+            digits[--pos] = '-';
+        }
+        buffer.append(digits + pos, sizeof(digits) - pos);
+    }
+
+    void appendHeader(std::string& buffer, const std::string& name, const std::string& value, bool escape = false) {
+        if (escape) {
+            StompFrame::appendEscaped(buffer, name);
+            buffer.push_back(':');
+            StompFrame::appendEscaped(buffer, value);
+        } else {
+            buffer.append(name);
+            buffer.push_back(':');
+            buffer.append(value);
+        }
+        buffer.push_back('\n');
+    }
+
+    void appendHeader(std::string& buffer, const std::string& name, long long value) {
+        buffer.append(name);
+        buffer.push_back(':');
+        appendNumber(buffer, value);
+        buffer.push_back('\n');
+    }
+
+    // A message property of the same name replaces a standard header, as it did when
+    // the headers were collected in the frame's Properties.
+    bool overridden(const activemq::util::PrimitiveMap& properties, const std::string& name) {
+        return !properties.isEmpty() && properties.containsKey(name);
+    }
+
+    const std::string JMSX_DELIVERY_COUNT = "JMSXDeliveryCount";
+    const std::string JMSX_GROUP_SEQ = "JMSXGroupSeq";
+    const std::string JMSX_GROUP_ID = "JMSXGroupID";
+
+    // The interval heart-beats go at in one direction, the longer of the two asked for
+    // or none when either side doesn't want them.
+    long long negotiateInterval(long long sender, long long receiver) {
+        if (sender == 0 || receiver == 0) {
+            return 0;
+        }
+        return sender > receiver ? sender : receiver;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 StompWireFormat::StompWireFormat() : helper(NULL), clientId(), receiving(), properties(NULL) {
     this->helper = new StompHelper(this);
@@ -125,6 +218,22 @@ void StompWireFormat::marshal(const Pointer<Command> command,
                     "output stream is NULL");
         }
 
+        // Messages and acks are the bulk of what is sent, they are encoded straight into
+        // the stream instead of going through a StompFrame.
+        if (command->isMessage()) {
+            if (writeMessage(command, out)) {
+                return;
+            }
+        } else if (command->isMessageAck()) {
+            writeAck(command, out);
+            return;
+        } else if (command->isKeepAliveInfo() && hasNegotiator()) {
+            // A heart-beat is a lone end of line between frames.
+            out->write('\n');
+            out->flush();
+            return;
+        }
+
         Pointer<StompFrame> frame;
 
         if (command->isMessage()) {
@@ -163,7 +272,7 @@ void StompWireFormat::marshal(const Pointer<Command> command,
         }
 
         // Let the Frame write itself to the output stream
-        frame->toStream(out);
+        frame->toStream(out, this->properties->stomp11);
     }
     AMQ_CATCH_RETHROW( decaf::io::IOException)
     AMQ_CATCH_EXCEPTION_CONVERT( decaf::lang::Exception, decaf::io::IOException)
@@ -189,7 +298,11 @@ Pointer<Command> StompWireFormat::unmarshal(const activemq::transport::Transport
         frame.reset(new StompFrame());
 
         // Read the command header.
-        frame->fromStream(in);
+        frame->fromStream(in, this->properties->stomp11, hasNegotiator());
+
+        if (frame->isHeartBeat()) {
+            return Pointer<Command>(new KeepAliveInfo());
+        }
 
         // Return the Command.
         const std::string commandId = frame->getCommand();
@@ -235,7 +348,16 @@ Pointer<Command> StompWireFormat::unmarshal(const activemq::transport::Transport
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<transport::Transport> StompWireFormat::createNegotiator(const Pointer<transport::Transport> transport AMQCPP_UNUSED) {
+bool StompWireFormat::hasNegotiator() const {
+    return this->properties->outgoingHeartBeat > 0 || this->properties->incomingHeartBeat > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<transport::Transport> StompWireFormat::createNegotiator(const Pointer<transport::Transport> transport) {
+
+    if (hasNegotiator()) {
+        return Pointer<transport::Transport>(new StompWireFormatNegotiator(this, transport));
+    }
 
     throw UnsupportedOperationException(__FILE__, __LINE__, "No Negotiator is required to use this WireFormat.");
 
@@ -296,7 +418,20 @@ Pointer<Command> StompWireFormat::unmarshalReceipt(const Pointer<StompFrame> fra
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-Pointer<Command> StompWireFormat::unmarshalConnected(const Pointer<StompFrame> frame AMQCPP_UNUSED) {
+Pointer<Command> StompWireFormat::unmarshalConnected(const Pointer<StompFrame> frame) {
+
+    // A broker that only speaks STOMP 1.0 sends neither header.
+    std::string version = frame->getProperty(StompCommandConstants::HEADER_VERSION, "1.0");
+    this->properties->stomp11 = version != "1.0";
+
+    std::string heartBeat = frame->getProperty(StompCommandConstants::HEADER_HEARTBEAT, "0,0");
+    std::size_t comma = heartBeat.find(',');
+    if (comma != std::string::npos) {
+        long long brokerSends = Long::parseLong(heartBeat.substr(0, comma));
+        long long brokerReceives = Long::parseLong(heartBeat.substr(comma + 1));
+        this->properties->sendInterval = negotiateInterval(this->properties->outgoingHeartBeat, brokerReceives);
+        this->properties->receiveInterval = negotiateInterval(brokerSends, this->properties->incomingHeartBeat);
+    }
 
     Pointer<Response> response(new Response());
 
@@ -414,6 +549,15 @@ Pointer<StompFrame> StompWireFormat::marshalConnectionInfo(const Pointer<Command
     frame->setProperty(StompCommandConstants::HEADER_LOGIN, info->getUserName());
     frame->setProperty(StompCommandConstants::HEADER_PASSWORD, info->getPassword());
 
+    // Heart-beats came with STOMP 1.1, which is only asked for when they are wanted.
+    if (hasNegotiator()) {
+        std::string heartBeat = Long::toString(this->properties->outgoingHeartBeat);
+        heartBeat.push_back(',');
+        heartBeat.append(Long::toString(this->properties->incomingHeartBeat));
+        frame->setProperty(StompCommandConstants::HEADER_ACCEPT_VERSION, "1.0,1.1");
+        frame->setProperty(StompCommandConstants::HEADER_HEARTBEAT, heartBeat);
+    }
+
     this->properties->connectResponseId = info->getCommandId();
 
     // Store this for later.
@@ -562,6 +706,190 @@ Pointer<StompFrame> StompWireFormat::marshalRemoveSubscriptionInfo(const Pointer
     return frame;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool StompWireFormat::writeMessage(const Pointer<Command>& command, decaf::io::DataOutputStream* out) {
+
+    Message* message = dynamic_cast<Message*>(command.get());
+    ActiveMQTextMessage* textMessage = dynamic_cast<ActiveMQTextMessage*>(message);
+    ActiveMQBytesMessage* bytesMessage = textMessage == NULL ? dynamic_cast<ActiveMQBytesMessage*>(message) : NULL;
+
+    // Anything else is refused by marshalMessage.
+    if (textMessage == NULL && bytesMessage == NULL) {
+        return false;
+    }
+
+    const activemq::util::PrimitiveMap& props = message->getMessageProperties();
+    bool escape = this->properties->stomp11;
+    std::string& buffer = this->properties->frameBuffer;
+    buffer.clear();
+
+    buffer.append(StompCommandConstants::SEND);
+    buffer.push_back('\n');
+
+    if (command->isResponseRequired() && !overridden(props, StompCommandConstants::HEADER_RECEIPT_REQUIRED)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_RECEIPT_REQUIRED, command->getCommandId());
+    }
+
+    if (!overridden(props, StompCommandConstants::HEADER_DESTINATION)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_DESTINATION, destinationHeader(message->getDestination()), escape);
+    }
+    if (!message->getCorrelationId().empty() && !overridden(props, StompCommandConstants::HEADER_CORRELATIONID)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_CORRELATIONID, message->getCorrelationId(), escape);
+    }
+    if (!overridden(props, StompCommandConstants::HEADER_EXPIRES)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_EXPIRES, message->getExpiration());
+    }
+    if (!overridden(props, StompCommandConstants::HEADER_PERSISTENT)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_PERSISTENT, Boolean::toString(message->isPersistent()));
+    }
+    if (message->getRedeliveryCounter() != 0 && !overridden(props, StompCommandConstants::HEADER_REDELIVERED)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_REDELIVERED, "true");
+    }
+    if (!overridden(props, StompCommandConstants::HEADER_JMSPRIORITY)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_JMSPRIORITY, message->getPriority());
+    }
+    if (message->getReplyTo() != NULL && !overridden(props, StompCommandConstants::HEADER_REPLYTO)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_REPLYTO, helper->convertDestination(message->getReplyTo()), escape);
+    }
+    if (!overridden(props, StompCommandConstants::HEADER_TIMESTAMP)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_TIMESTAMP, message->getTimestamp());
+    }
+    if (!message->getType().empty() && !overridden(props, StompCommandConstants::HEADER_TYPE)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_TYPE, message->getType(), escape);
+    }
+    if (message->getTransactionId() != NULL && !overridden(props, StompCommandConstants::HEADER_TRANSACTIONID)) {
+        appendHeader(buffer, StompCommandConstants::HEADER_TRANSACTIONID, transactionHeader(message->getTransactionId()), escape);
+    }
+    if (!overridden(props, JMSX_DELIVERY_COUNT)) {
+        appendHeader(buffer, JMSX_DELIVERY_COUNT, message->getRedeliveryCounter());
+    }
+    if (!overridden(props, JMSX_GROUP_SEQ)) {
+        appendHeader(buffer, JMSX_GROUP_SEQ, message->getGroupSequence());
+    }
+    if (!message->getGroupID().empty() && !overridden(props, JMSX_GROUP_ID)) {
+        appendHeader(buffer, JMSX_GROUP_ID, message->getGroupID(), escape);
+    }
+
+    // A bytes message's content-length is always its own, it replaces a property of
+    // that name.
+    bool hasContentLength = bytesMessage != NULL;
+
+    if (!props.isEmpty()) {
+        Pointer<decaf::util::Iterator<std::string> > keys(props.keySet().iterator());
+        while (keys->hasNext()) {
+            std::string key = keys->next();
+            if (bytesMessage != NULL && key == StompCommandConstants::HEADER_CONTENTLENGTH) {
+                continue;
+            }
+            hasContentLength = hasContentLength || key == StompCommandConstants::HEADER_CONTENTLENGTH;
+            appendHeader(buffer, key, props.getString(key), escape);
+        }
+    }
+
+    if (textMessage != NULL) {
+
+        // The text goes out with its terminating NUL as part of the body.
+        std::string text = textMessage->getText();
+        buffer.push_back('\n');
+        buffer.append(text);
+        buffer.push_back('\0');
+        if (hasContentLength) {
+            buffer.push_back('\0');
+        }
+        buffer.push_back('\n');
+        out->write((const unsigned char*) buffer.data(), (int) buffer.size(), 0, (int) buffer.size());
+
+    } else if (bytesMessage->isReadOnlyBody() && !bytesMessage->isCompressed()) {
+
+        // Once sent the stored content is the body, it is written from where it is.
+        const std::vector<unsigned char>& content = bytesMessage->getContent();
+        appendHeader(buffer, StompCommandConstants::HEADER_CONTENTLENGTH, (long long) content.size());
+        buffer.push_back('\n');
+        out->write((const unsigned char*) buffer.data(), (int) buffer.size(), 0, (int) buffer.size());
+        if (!content.empty()) {
+            out->write(&content[0], (int) content.size(), 0, (int) content.size());
+        }
+        out->write((const unsigned char*) "\0\n", 2, 0, 2);
+
+    } else {
+
+        unsigned char* bodyBytes = bytesMessage->getBodyBytes();
+        int length = bytesMessage->getBodyLength();
+        appendHeader(buffer, StompCommandConstants::HEADER_CONTENTLENGTH, (long long) length);
+        buffer.push_back('\n');
+        if (bodyBytes != NULL) {
+            buffer.append((const char*) bodyBytes, length);
+            delete [] bodyBytes;
+        }
+        buffer.append("\0\n", 2);
+        out->write((const unsigned char*) buffer.data(), (int) buffer.size(), 0, (int) buffer.size());
+    }
+
+    out->flush();
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::writeAck(const Pointer<Command>& command, decaf::io::DataOutputStream* out) {
+
+    MessageAck* ack = dynamic_cast<MessageAck*>(command.get());
+
+    std::string& buffer = this->properties->frameBuffer;
+    buffer.clear();
+
+    buffer.append(StompCommandConstants::ACK);
+    buffer.push_back('\n');
+
+    if (command->isResponseRequired()) {
+        buffer.append(StompCommandConstants::HEADER_RECEIPT_REQUIRED);
+        buffer.append(":ignore:");
+        appendNumber(buffer, command->getCommandId());
+        buffer.push_back('\n');
+    }
+
+    appendHeader(buffer, StompCommandConstants::HEADER_MESSAGEID,
+                 ack->getLastMessageId()->getProducerId()->getConnectionId(), this->properties->stomp11);
+
+    // STOMP 1.1 wants to know which subscription the message came through.
+    if (this->properties->stomp11) {
+        appendHeader(buffer, StompCommandConstants::HEADER_SUBSCRIPTION,
+                     helper->convertConsumerId(ack->getConsumerId()), true);
+    }
+
+    if (ack->getTransactionId() != NULL) {
+        appendHeader(buffer, StompCommandConstants::HEADER_TRANSACTIONID,
+                     transactionHeader(ack->getTransactionId()), this->properties->stomp11);
+    }
+
+    // No body, the frame ends with its NUL.
+    buffer.append("\n\0\n", 3);
+
+    out->write((const unsigned char*) buffer.data(), (int) buffer.size(), 0, (int) buffer.size());
+    out->flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& StompWireFormat::destinationHeader(const Pointer<ActiveMQDestination>& destination) {
+
+    if (destination == NULL || this->properties->lastDestination.get() != destination.get()) {
+        this->properties->lastDestinationHeader = helper->convertDestination(destination);
+        this->properties->lastDestination = destination;
+    }
+
+    return this->properties->lastDestinationHeader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& StompWireFormat::transactionHeader(const Pointer<TransactionId>& transactionId) {
+
+    if (this->properties->lastTransaction.get() != transactionId.get()) {
+        this->properties->lastTransactionHeader = helper->convertTransactionId(transactionId);
+        this->properties->lastTransaction = transactionId;
+    }
+
+    return this->properties->lastTransactionHeader;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string StompWireFormat::getTopicPrefix() const {
     return this->properties->topicPrefix;
@@ -570,6 +898,7 @@ std::string StompWireFormat::getTopicPrefix() const {
 ////////////////////////////////////////////////////////////////////////////////
 void StompWireFormat::setTopicPrefix(const std::string& prefix) {
     this->properties->topicPrefix = prefix;
+    this->properties->lastDestination.reset(NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -580,6 +909,7 @@ std::string StompWireFormat::getQueuePrefix() const {
 ////////////////////////////////////////////////////////////////////////////////
 void StompWireFormat::setQueuePrefix(const std::string& prefix) {
     this->properties->queuePrefix = prefix;
+    this->properties->lastDestination.reset(NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -590,6 +920,7 @@ std::string StompWireFormat::getTempTopicPrefix() const {
 ////////////////////////////////////////////////////////////////////////////////
 void StompWireFormat::setTempTopicPrefix(const std::string& prefix) {
     this->properties->tempTopicPrefix = prefix;
+    this->properties->lastDestination.reset(NULL);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -600,4 +931,35 @@ std::string StompWireFormat::getTempQueuePrefix() const {
 ////////////////////////////////////////////////////////////////////////////////
 void StompWireFormat::setTempQueuePrefix(const std::string& prefix) {
     this->properties->tempQueuePrefix = prefix;
+    this->properties->lastDestination.reset(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getOutgoingHeartBeat() const {
+    return this->properties->outgoingHeartBeat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::setOutgoingHeartBeat(long long interval) {
+    this->properties->outgoingHeartBeat = interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getIncomingHeartBeat() const {
+    return this->properties->incomingHeartBeat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormat::setIncomingHeartBeat(long long interval) {
+    this->properties->incomingHeartBeat = interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getSendHeartBeatInterval() const {
+    return this->properties->sendInterval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long StompWireFormat::getReceiveHeartBeatInterval() const {
+    return this->properties->receiveInterval;
 }
@@ -21,6 +21,8 @@
 #include <activemq/util/Config.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/wireformat/stomp/StompFrame.h>
+#include <activemq/commands/ActiveMQDestination.h>
+#include <activemq/commands/TransactionId.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
 #include <decaf/io/IOException.h>
 #include <decaf/lang/Pointer.h>
@@ -171,6 +173,54 @@ namespace stomp {
          */
         void setTempQueuePrefix(const std::string& prefix);
 
+        /**
+         * Gets the interval in milliseconds at which this client offers to send
+         * heart-beats, zero if it doesn't send them.
+         *
+         * @return the outgoing heart-beat interval offered in the CONNECT frame.
+         */
+        long long getOutgoingHeartBeat() const;
+
+        /**
+         * Sets the interval in milliseconds at which this client offers to send
+         * heart-beats.  When either heart-beat interval is set the CONNECT frame asks
+         * for STOMP 1.1 and the heart-beats are negotiated with the broker.
+         *
+         * @param interval
+         *      The interval offered, zero to not send heart-beats.
+         */
+        void setOutgoingHeartBeat(long long interval);
+
+        /**
+         * Gets the interval in milliseconds at which this client asks the broker to
+         * send heart-beats, zero if it doesn't want them.
+         *
+         * @return the incoming heart-beat interval asked for in the CONNECT frame.
+         */
+        long long getIncomingHeartBeat() const;
+
+        /**
+         * Sets the interval in milliseconds at which this client asks the broker to
+         * send heart-beats, the connection fails when the broker is silent for twice
+         * the negotiated interval.
+         *
+         * @param interval
+         *      The interval asked for, zero to not check that the broker is alive.
+         */
+        void setIncomingHeartBeat(long long interval);
+
+        /**
+         * @return the negotiated interval in milliseconds at which heart-beats have to
+         *         be sent, zero until the broker has connected or if none are sent.
+         */
+        long long getSendHeartBeatInterval() const;
+
+        /**
+         * @return the negotiated interval in milliseconds at which the broker sends
+         *         heart-beats, zero until the broker has connected or if it sends none.
+         */
+        long long getReceiveHeartBeatInterval() const;
+
         /**
          * Is there a Message being unmarshaled?
          *
@@ -185,13 +235,12 @@ namespace stomp {
          * Transport that uses it.
          * @return true if the WireFormat provides a Negotiator.
          */
-        virtual bool hasNegotiator() const {
-            return false;
-        }
+        virtual bool hasNegotiator() const;
 
         /**
          * If the Transport Provides a Negotiator this method will create and return
-         * a news instance of the Negotiator.
+         * a news instance of the Negotiator.  A STOMP transport is wrapped only when
+         * heart-beats are configured, the negotiator then keeps them going.
          * @return new instance of a WireFormatNegotiator.
          * @throws UnsupportedOperationException if the WireFormat doesn't have a Negotiator.
          */
@@ -214,6 +263,11 @@ namespace stomp {
         Pointer<StompFrame> marshalConsumerInfo(const Pointer<Command> command);
         Pointer<StompFrame> marshalRemoveSubscriptionInfo(const Pointer<Command> command);
 
+        bool writeMessage(const Pointer<Command>& command, decaf::io::DataOutputStream* out);
+        void writeAck(const Pointer<Command>& command, decaf::io::DataOutputStream* out);
+        const std::string& destinationHeader(const Pointer<commands::ActiveMQDestination>& destination);
+        const std::string& transactionHeader(const Pointer<commands::TransactionId>& transactionId);
+
     };
 
 }}}
@@ -18,12 +18,14 @@
 #include "StompWireFormatFactory.h"
 
 #include <activemq/exceptions/ActiveMQException.h>
+#include <decaf/lang/Long.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::stomp;
 using namespace activemq::exceptions;
+using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
 Pointer<WireFormat> StompWireFormatFactory::createWireFormat(const decaf::util::Properties& properties AMQCPP_UNUSED) {
@@ -40,6 +42,10 @@ Pointer<WireFormat> StompWireFormatFactory::createWireFormat(const decaf::util::
             properties.getProperty("wireFormat.tempTopicPrefix", "/temp-topic/"));
         wireFormat->setTempQueuePrefix(
             properties.getProperty("wireFormat.tempQueuePrefix", "/temp-queue/"));
+        wireFormat->setOutgoingHeartBeat(
+            Long::parseLong(properties.getProperty("wireFormat.outgoingHeartBeat", "0")));
+        wireFormat->setIncomingHeartBeat(
+            Long::parseLong(properties.getProperty("wireFormat.incomingHeartBeat", "0")));
 
         return wireFormat;
     }
@@ -0,0 +1,238 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompWireFormatNegotiator.h"
+
+#include <activemq/wireformat/stomp/StompWireFormat.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/exceptions/ActiveMQException.h>
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::threads;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf::internal::util::concurrent;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    long long currentTime() {
+        return System::nanoTime() / 1000000;
+    }
+
+    class HeartBeatSender : public Runnable {
+    private:
+
+        StompWireFormatNegotiator* parent;
+
+    private:
+
+        HeartBeatSender(const HeartBeatSender&);
+        HeartBeatSender& operator=(const HeartBeatSender&);
+
+    public:
+
+        HeartBeatSender(StompWireFormatNegotiator* parent) : Runnable(), parent(parent) {}
+
+        virtual void run() {
+            parent->sendCheck();
+        }
+    };
+
+    class HeartBeatChecker : public Runnable {
+    private:
+
+        StompWireFormatNegotiator* parent;
+
+    private:
+
+        HeartBeatChecker(const HeartBeatChecker&);
+        HeartBeatChecker& operator=(const HeartBeatChecker&);
+
+    public:
+
+        HeartBeatChecker(StompWireFormatNegotiator* parent) : Runnable(), parent(parent) {}
+
+        virtual void run() {
+            parent->receiveCheck();
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompWireFormatNegotiator::StompWireFormatNegotiator(StompWireFormat* wireFormat, const Pointer<Transport> next) :
+    WireFormatNegotiator(next),
+    stompWireFormat(wireFormat),
+    lastReadTime(currentTime()),
+    lastWriteTime(lastReadTime),
+    started(),
+    failed(),
+    mutex(),
+    sendTimeout(),
+    receiveTimeout() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompWireFormatNegotiator::~StompWireFormatNegotiator() {
+    try {
+        close();
+    }
+    AMQ_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::oneway(const Pointer<Command> command) {
+
+    try {
+
+        checkClosed();
+
+        next->oneway(command);
+
+        Atomics::setRelaxed64(&this->lastWriteTime, currentTime());
+    }
+    AMQ_CATCH_RETHROW(UnsupportedOperationException)
+    AMQ_CATCH_RETHROW(IOException)
+    AMQ_CATCH_EXCEPTION_CONVERT(exceptions::ActiveMQException, IOException)
+    AMQ_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::onCommand(const Pointer<Command> command) {
+
+    Atomics::setRelaxed64(&this->lastReadTime, currentTime());
+
+    // The broker's heart-beats only ever serve to show that it is alive.
+    if (command->isKeepAliveInfo()) {
+        return;
+    }
+
+    // The first response answers the CONNECT, the heart-beats are agreed on by then.
+    if (command->isResponse() && this->started.compareAndSet(false, true)) {
+        try {
+            startHeartBeats();
+        } catch (decaf::lang::Exception& ex) {
+            TransportFilter::onException(ex);
+        }
+    }
+
+    TransportFilter::onCommand(command);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::sendCheck() {
+
+    long long interval = this->stompWireFormat->getSendHeartBeatInterval();
+
+    if (currentTime() - Atomics::getRelaxed64(&this->lastWriteTime) < interval / 2 || isClosed()) {
+        return;
+    }
+
+    try {
+        this->oneway(Pointer<Command>(new KeepAliveInfo()));
+    } catch (IOException& ex) {
+        stopHeartBeats();
+        TransportFilter::onException(ex);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::receiveCheck() {
+
+    long long now = currentTime();
+
+    // A frame still being read counts as traffic.
+    if (this->stompWireFormat->inReceive()) {
+        Atomics::setRelaxed64(&this->lastReadTime, now);
+        return;
+    }
+
+    long long interval = this->stompWireFormat->getReceiveHeartBeatInterval();
+
+    if (now - Atomics::getRelaxed64(&this->lastReadTime) > interval * 2 && this->failed.compareAndSet(false, true)) {
+        stopHeartBeats();
+        IOException ex(__FILE__, __LINE__,
+            (std::string("No heart-beat received from the broker in time: ") + next->getRemoteAddress()).c_str());
+        TransportFilter::onException(ex);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::beforeNextIsStopped() {
+    stopHeartBeats();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::doClose() {
+    stopHeartBeats();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::startHeartBeats() {
+
+    long long sendInterval = this->stompWireFormat->getSendHeartBeatInterval();
+    long long receiveInterval = this->stompWireFormat->getReceiveHeartBeatInterval();
+
+    synchronized(&this->mutex) {
+
+        if (isClosed()) {
+            return;
+        }
+
+        TimingWheel& wheel = TimingWheel::getSharedInstance();
+
+        // Checking at half the interval keeps the gap between writes below it.
+        if (sendInterval > 0) {
+            long long period = sendInterval > 1 ? sendInterval / 2 : 1;
+            this->sendTimeout = wheel.schedule(Pointer<Runnable>(new HeartBeatSender(this)), period, period);
+        }
+
+        if (receiveInterval > 0) {
+            this->receiveTimeout = wheel.schedule(
+                Pointer<Runnable>(new HeartBeatChecker(this)), receiveInterval, receiveInterval);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatNegotiator::stopHeartBeats() {
+
+    synchronized(&this->mutex) {
+
+        if (this->sendTimeout != NULL) {
+            this->sendTimeout->cancel();
+            this->sendTimeout.reset(NULL);
+        }
+
+        if (this->receiveTimeout != NULL) {
+            this->receiveTimeout->cancel();
+            this->receiveTimeout.reset(NULL);
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_
+#define _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_
+
+#include <activemq/util/Config.h>
+#include <activemq/wireformat/WireFormatNegotiator.h>
+#include <activemq/threads/TimingWheel.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/lang/Pointer.h>
+
+namespace activemq {
+namespace wireformat {
+namespace stomp {
+
+    using decaf::lang::Pointer;
+
+    class StompWireFormat;
+
+    /**
+     * Keeps the STOMP heart-beats going once they have been negotiated in the CONNECT
+     * and CONNECTED frames, which makes the InactivityMonitor unnecessary for a STOMP
+     * connection.  A heart-beat is sent when nothing else was written for half the
+     * negotiated send interval, and the transport fails when nothing at all was read
+     * for twice the negotiated receive interval.  Heart-beats read from the broker end
+     * here, they are never passed up to the connection.
+     *
+     * The checks run on the shared TimingWheel so an idle connection costs no thread.
+     *
+     * @since 3.9.0
+     */
+    class AMQCPP_API StompWireFormatNegotiator : public wireformat::WireFormatNegotiator {
+    private:
+
+        // The StompWireFormat that negotiates the heart-beat intervals.
+        StompWireFormat* stompWireFormat;
+
+        // Time of the last read and write, in milliseconds.
+        volatile long long lastReadTime;
+        volatile long long lastWriteTime;
+
+        // Set once the broker has connected and the checks were scheduled.
+        decaf::util::concurrent::atomic::AtomicBoolean started;
+
+        // Set once the transport was failed for want of heart-beats.
+        decaf::util::concurrent::atomic::AtomicBoolean failed;
+
+        decaf::util::concurrent::Mutex mutex;
+
+        Pointer<threads::TimingWheel::Timeout> sendTimeout;
+        Pointer<threads::TimingWheel::Timeout> receiveTimeout;
+
+    private:
+
+        StompWireFormatNegotiator(const StompWireFormatNegotiator&);
+        StompWireFormatNegotiator& operator=(const StompWireFormatNegotiator&);
+
+    public:
+
+        /**
+         * Constructor - Initializes this object around another Transport
+         * @param wireFormat - The StompWireFormat object that negotiates the heart-beats
+         * @param next - The next transport in the chain
+         */
+        StompWireFormatNegotiator(StompWireFormat* wireFormat, const Pointer<transport::Transport> next);
+
+        virtual ~StompWireFormatNegotiator();
+
+        virtual void oneway(const Pointer<commands::Command> command);
+
+    public:
+
+        virtual void onCommand(const Pointer<commands::Command> command);
+
+    public:
+
+        /**
+         * Sends a heart-beat if nothing was written for half the send interval, called
+         * from the timer.
+         */
+        void sendCheck();
+
+        /**
+         * Fails the transport if the broker was silent for too long, called from the
+         * timer.
+         */
+        void receiveCheck();
+
+    protected:
+
+        virtual void beforeNextIsStopped();
+
+        virtual void doClose();
+
+    private:
+
+        void startHeartBeats();
+
+        void stopHeartBeats();
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_WIREFORMAT_STOMP_STOMPWIREFORMATNEGOTIATOR_H_ */
@@ -22,6 +22,14 @@ using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::internal;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    DecafRuntime* runtime() {
+        return dynamic_cast<DecafRuntime*>(Runtime::getRuntime());
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 AprPool::AprPool() : aprPool(NULL) {
 }
@@ -39,7 +47,7 @@ AprPool::~AprPool() {
 void AprPool::allocatePool() const {
 
     if (aprPool == NULL) {
-        apr_pool_create_unmanaged_ex(&aprPool, NULL, NULL);
+        aprPool = runtime()->takePool();
     }
 }
 
@@ -47,7 +55,7 @@ void AprPool::allocatePool() const {
 void AprPool::destroyPool() {
 
     if (aprPool != NULL) {
-        apr_pool_destroy(aprPool);
+        runtime()->recyclePool(aprPool);
     }
 
     aprPool = NULL;
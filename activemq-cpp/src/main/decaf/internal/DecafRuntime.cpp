@@ -18,6 +18,7 @@
 #include "DecafRuntime.h"
 
 #include <apr.h>
+#include <apr_allocator.h>
 #include <apr_general.h>
 #include <apr_pools.h>
 
@@ -26,11 +27,16 @@
 #include <decaf/internal/net/Network.h>
 #include <decaf/internal/security/SecurityRuntime.h>
 #include <decaf/internal/util/concurrent/Threading.h>
+#include <decaf/internal/util/concurrent/LockProfiler.h>
+#include <decaf/internal/io/BufferPool.h>
+
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::internal;
 using namespace decaf::internal::net;
 using namespace decaf::internal::security;
+using namespace decaf::internal::io;
 using namespace decaf::internal::util::concurrent;
 using namespace decaf::lang;
 using namespace decaf::util::concurrent;
@@ -39,6 +45,23 @@ using namespace decaf::util::concurrent;
 namespace {
     apr_pool_t* aprPool;
     Mutex* globalLock;
+
+    // Pools given back by the sockets and other objects that need one of their own,
+    // reused so that connection churn doesn't create and destroy a pool each time.
+    std::vector<apr_pool_t*>* freePools;
+    Mutex* freePoolsLock;
+
+    // The most free pools kept, and the most memory each keeps once cleared.
+    const std::size_t MAX_FREE_POOLS = 64;
+    const apr_size_t MAX_RETAINED_BYTES = 32 * 1024;
+
+    void destroyFreePools() {
+        std::vector<apr_pool_t*>::iterator iter = freePools->begin();
+        for (; iter != freePools->end(); ++iter) {
+            apr_pool_destroy(*iter);
+        }
+        freePools->clear();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +77,54 @@ apr_pool_t* DecafRuntime::getGlobalPool() const {
     return aprPool;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+apr_pool_t* DecafRuntime::takePool() {
+
+    apr_pool_t* pool = NULL;
+
+    if (freePoolsLock != NULL) {
+        synchronized(freePoolsLock) {
+            if (!freePools->empty()) {
+                pool = freePools->back();
+                freePools->pop_back();
+            }
+        }
+    }
+
+    if (pool == NULL) {
+        apr_pool_create_unmanaged_ex(&pool, NULL, NULL);
+        apr_allocator_max_free_set(apr_pool_allocator_get(pool), MAX_RETAINED_BYTES);
+    }
+
+    return pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DecafRuntime::recyclePool(apr_pool_t* pool) {
+
+    if (pool == NULL) {
+        return;
+    }
+
+    if (freePoolsLock != NULL) {
+
+        // Runs the cleanups, closing any sockets or files the pool still holds, and
+        // hands all but the retained memory back to the system.
+        apr_pool_clear(pool);
+
+        synchronized(freePoolsLock) {
+            if (freePools->size() < MAX_FREE_POOLS) {
+                freePools->push_back(pool);
+                pool = NULL;
+            }
+        }
+    }
+
+    if (pool != NULL) {
+        apr_pool_destroy(pool);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Mutex* DecafRuntime::getGlobalLock() {
     return globalLock;
@@ -74,8 +145,12 @@ void Runtime::initializeRuntime(int argc, char **argv) {
 
     Runtime::getRuntime();
     Threading::initialize();
+    LockProfiler::initialize();
+    BufferPool::initialize();
 
     globalLock = new Mutex;
+    freePools = new std::vector<apr_pool_t*>();
+    freePoolsLock = new Mutex;
 
     System::initSystem(argc, argv);
     Network::initializeNetworking();
@@ -101,6 +176,19 @@ void Runtime::shutdownRuntime() {
     // This must go away before Threading is shutdown.
     delete globalLock;
 
+    // Pools given back after this are destroyed rather than kept.
+    Mutex* poolsLock = freePoolsLock;
+    synchronized(poolsLock) {
+        freePoolsLock = NULL;
+        destroyFreePools();
+    }
+    delete poolsLock;
+    delete freePools;
+    freePools = NULL;
+
+    BufferPool::shutdown();
+    LockProfiler::shutdown();
+
     // Threading is the last to by shutdown since most other parts of the Runtime
     // need to make use of Thread primitives.
     Threading::shutdown();
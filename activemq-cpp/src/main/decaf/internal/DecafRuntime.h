@@ -54,6 +54,24 @@ namespace internal {
          */
         apr_pool_t* getGlobalPool() const;
 
+        /**
+         * Hands out an unmanaged APR pool for an object that needs a pool of its own,
+         * one that was given back with recyclePool if there is one, a new one otherwise.
+         *
+         * @return an empty APR pool that the caller gives back with recyclePool.
+         */
+        apr_pool_t* takePool();
+
+        /**
+         * Gives back a pool handed out by takePool.  The pool is cleared, running its
+         * cleanups just as destroying it would, and kept for reuse while the runtime
+         * holds fewer than a bounded number of free pools, otherwise it is destroyed.
+         *
+         * @param pool
+         *      The pool to give back, it must not be used again by the caller.
+         */
+        void recyclePool(apr_pool_t* pool);
+
         /**
          * Gets a pointer to the Decaf Runtime's Global Lock object, this can be used by
          * Decaf APIs to synchronize around certain actions such as adding or acquiring
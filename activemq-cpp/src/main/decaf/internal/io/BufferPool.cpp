@@ -0,0 +1,373 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPool.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/internal/util/concurrent/PlatformThread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <functional>
+#include <map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::io;
+using namespace decaf::internal::util::concurrent;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+const int BufferPool::MIN_BUFFER_SIZE = 4096;
+const int BufferPool::SLAB_SIZE = 2 * 1024 * 1024;
+const long long BufferPool::DEFAULT_MAX_RESERVED = 64LL * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // One list for each power of two from MIN_BUFFER_SIZE to SLAB_SIZE.
+    const int SIZE_CLASSES = 10;
+
+    struct FreeBuffer {
+        FreeBuffer* next;
+    };
+
+    struct Slab {
+        int sizeClass;
+        bool hugePage;
+
+        Slab(int sizeClass, bool hugePage) : sizeClass(sizeClass), hugePage(hugePage) {}
+    };
+
+    class PoolKernel {
+    private:
+
+        PoolKernel(const PoolKernel&);
+        PoolKernel& operator=(const PoolKernel&);
+
+    public:
+
+        decaf_mutex_t lock;
+
+        FreeBuffer* freeBuffers[SIZE_CLASSES];
+
+        // Keyed by the start of the slab so the slab holding a buffer is found with
+        // one search.
+        std::map<unsigned char*, Slab> slabs;
+
+        long long hits;
+        long long misses;
+        int hugePageSlabs;
+        int buffersInUse;
+
+        // Set once the library has shut down, the kernel goes away with the last of
+        // the buffers still in use.
+        bool closed;
+
+        PoolKernel() : lock(), freeBuffers(), slabs(), hits(0), misses(0), hugePageSlabs(0),
+                       buffersInUse(0), closed(false) {
+            PlatformThread::createMutex(&lock);
+        }
+
+        ~PoolKernel();
+    };
+
+    volatile int enabled = 0;
+    volatile long long maxReserved = BufferPool::DEFAULT_MAX_RESERVED;
+
+    PoolKernel* kernel = NULL;
+
+    int sizeOfClass(int sizeClass) {
+        return BufferPool::MIN_BUFFER_SIZE << sizeClass;
+    }
+
+    int classOf(int size) {
+        int sizeClass = 0;
+        while (sizeOfClass(sizeClass) < size) {
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+
+    bool contains(unsigned char* slab, unsigned char* buffer) {
+        std::less<unsigned char*> less;
+        return !less(buffer, slab) && less(buffer, slab + BufferPool::SLAB_SIZE);
+    }
+
+    /**
+     * Maps a slab, huge page backed where the platform can, falling back to ordinary
+     * pages aligned to the slab size and advised as huge pages.  The pages are touched
+     * so none of the slab's buffers fault when first used.
+     */
+    unsigned char* reserveSlab(bool& hugePage) {
+
+        unsigned char* slab = NULL;
+        hugePage = false;
+
+#ifdef _WIN32
+        slab = (unsigned char*) VirtualAlloc(NULL, BufferPool::SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#ifdef MAP_HUGETLB
+        void* memory = mmap(NULL, BufferPool::SLAB_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            slab = (unsigned char*) memory;
+            hugePage = true;
+        }
+#endif
+        if (slab == NULL) {
+            // Twice the size is mapped so an aligned slab can be cut from it.
+            std::size_t span = 2 * (std::size_t) BufferPool::SLAB_SIZE;
+            void* memory = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                return NULL;
+            }
+
+            unsigned char* start = (unsigned char*) memory;
+            std::size_t lead = (std::size_t) BufferPool::SLAB_SIZE -
+                ((std::size_t) start % (std::size_t) BufferPool::SLAB_SIZE);
+            if (lead == (std::size_t) BufferPool::SLAB_SIZE) {
+                lead = 0;
+            }
+
+            slab = start + lead;
+            if (lead > 0) {
+                munmap(start, lead);
+            }
+            munmap(slab + BufferPool::SLAB_SIZE, span - lead - BufferPool::SLAB_SIZE);
+#ifdef MADV_HUGEPAGE
+            madvise(slab, BufferPool::SLAB_SIZE, MADV_HUGEPAGE);
+#endif
+        }
+#endif
+
+        if (slab != NULL) {
+            for (int offset = 0; offset < BufferPool::SLAB_SIZE; offset += BufferPool::MIN_BUFFER_SIZE) {
+                ((volatile unsigned char*) slab)[offset] = 0;
+            }
+        }
+
+        return slab;
+    }
+
+    void releaseSlab(unsigned char* slab) {
+#ifdef _WIN32
+        VirtualFree(slab, 0, MEM_RELEASE);
+#else
+        munmap(slab, BufferPool::SLAB_SIZE);
+#endif
+    }
+
+    PoolKernel::~PoolKernel() {
+        std::map<unsigned char*, Slab>::iterator slab = slabs.begin();
+        for (; slab != slabs.end(); ++slab) {
+            releaseSlab(slab->first);
+        }
+        PlatformThread::destroyMutex(lock);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BufferPool::Statistics::Statistics() : hits(0), misses(0), slabs(0), hugePageSlabs(0), reservedBytes(0), buffersInUse(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::initialize() {
+    if (kernel != NULL) {
+        // Left behind by an earlier shutdown with buffers still in use.
+        PlatformThread::lockMutex(kernel->lock);
+        kernel->closed = false;
+        PlatformThread::unlockMutex(kernel->lock);
+    } else {
+        kernel = new PoolKernel();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::shutdown() {
+
+    Atomics::getAndSet(&enabled, 0);
+
+    PoolKernel* old = kernel;
+    if (old == NULL) {
+        return;
+    }
+
+    PlatformThread::lockMutex(old->lock);
+    old->closed = true;
+    bool dispose = old->buffersInUse == 0;
+    PlatformThread::unlockMutex(old->lock);
+
+    if (dispose) {
+        kernel = NULL;
+        delete old;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::setEnabled(bool value) {
+    Atomics::getAndSet(&enabled, value ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool BufferPool::isEnabled() {
+    return Atomics::getAcquire(&enabled) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::setMaxReserved(long long bytes) {
+    Atomics::setRelaxed64(&maxReserved, bytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long BufferPool::getMaxReserved() {
+    return Atomics::getRelaxed64(&maxReserved);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char* BufferPool::allocate(int size) {
+
+    if (size < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Buffer size cannot be negative: %d", size);
+    }
+
+    PoolKernel* pool = kernel;
+    if (pool == NULL || size > SLAB_SIZE || Atomics::getAcquire(&enabled) == 0) {
+        return new unsigned char[size];
+    }
+
+    int sizeClass = classOf(size);
+
+    PlatformThread::lockMutex(pool->lock);
+
+    if (pool->closed) {
+        PlatformThread::unlockMutex(pool->lock);
+        return new unsigned char[size];
+    }
+
+    FreeBuffer* buffer = pool->freeBuffers[sizeClass];
+    if (buffer != NULL) {
+        pool->freeBuffers[sizeClass] = buffer->next;
+        pool->hits++;
+        pool->buffersInUse++;
+        PlatformThread::unlockMutex(pool->lock);
+        return (unsigned char*) buffer;
+    }
+
+    pool->misses++;
+    bool reserve = (long long) (pool->slabs.size() + 1) * SLAB_SIZE <= Atomics::getRelaxed64(&maxReserved);
+
+    PlatformThread::unlockMutex(pool->lock);
+
+    bool hugePage = false;
+    unsigned char* slab = reserve ? reserveSlab(hugePage) : NULL;
+    if (slab == NULL) {
+        return new unsigned char[size];
+    }
+
+    // The first buffer of the slab is the one asked for, the rest are freed.
+    PlatformThread::lockMutex(pool->lock);
+
+    pool->slabs.insert(std::make_pair(slab, Slab(sizeClass, hugePage)));
+    if (hugePage) {
+        pool->hugePageSlabs++;
+    }
+
+    int bufferSize = sizeOfClass(sizeClass);
+    for (int offset = SLAB_SIZE - bufferSize; offset > 0; offset -= bufferSize) {
+        FreeBuffer* freed = (FreeBuffer*) (slab + offset);
+        freed->next = pool->freeBuffers[sizeClass];
+        pool->freeBuffers[sizeClass] = freed;
+    }
+    pool->buffersInUse++;
+
+    PlatformThread::unlockMutex(pool->lock);
+
+    return slab;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::release(unsigned char* buffer) {
+
+    if (buffer == NULL) {
+        return;
+    }
+
+    PoolKernel* pool = kernel;
+    if (pool != NULL) {
+
+        PlatformThread::lockMutex(pool->lock);
+
+        std::map<unsigned char*, Slab>::iterator slab = pool->slabs.upper_bound(buffer);
+        if (slab != pool->slabs.begin() && contains((--slab)->first, buffer)) {
+
+            FreeBuffer* freed = (FreeBuffer*) buffer;
+            freed->next = pool->freeBuffers[slab->second.sizeClass];
+            pool->freeBuffers[slab->second.sizeClass] = freed;
+
+            bool dispose = --pool->buffersInUse == 0 && pool->closed;
+            PlatformThread::unlockMutex(pool->lock);
+
+            if (dispose) {
+                kernel = NULL;
+                delete pool;
+            }
+            return;
+        }
+
+        PlatformThread::unlockMutex(pool->lock);
+    }
+
+    delete [] buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BufferPool::Statistics BufferPool::getStatistics() {
+
+    Statistics statistics;
+
+    PoolKernel* pool = kernel;
+    if (pool != NULL) {
+        PlatformThread::lockMutex(pool->lock);
+        statistics.hits = pool->hits;
+        statistics.misses = pool->misses;
+        statistics.slabs = (int) pool->slabs.size();
+        statistics.hugePageSlabs = pool->hugePageSlabs;
+        statistics.reservedBytes = (long long) pool->slabs.size() * SLAB_SIZE;
+        statistics.buffersInUse = pool->buffersInUse;
+        PlatformThread::unlockMutex(pool->lock);
+    }
+
+    return statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPool::resetStatistics() {
+
+    PoolKernel* pool = kernel;
+    if (pool != NULL) {
+        PlatformThread::lockMutex(pool->lock);
+        pool->hits = 0;
+        pool->misses = 0;
+        PlatformThread::unlockMutex(pool->lock);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_BUFFERPOOL_H_
+#define _DECAF_INTERNAL_IO_BUFFERPOOL_H_
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    /**
+     * Size classed pool of the staging buffers of the buffered streams, the socket read
+     * and write buffers of the transports among them.  Buffers come in powers of two
+     * from MIN_BUFFER_SIZE up to SLAB_SIZE and are carved from slabs of SLAB_SIZE bytes,
+     * each slab serving a single size.  Where the platform has them a slab is backed by a
+     * huge page, otherwise its pages are touched when it is reserved so that the buffers
+     * taken from it never fault.  Freed buffers go back to the list of their size and
+     * slabs are only given back to the system when the library shuts down.
+     *
+     * The pool is off until enabled, while it is off, and for requests larger than a
+     * slab or beyond the reservation limit, buffers come from the heap.  Release takes
+     * any buffer that allocate returned, whether the pool was on or not at the time.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API BufferPool {
+    public:
+
+        /**
+         * The smallest buffer the pool hands out, smaller requests are rounded up.
+         */
+        static const int MIN_BUFFER_SIZE;
+
+        /**
+         * The size of the slabs buffers are carved from and of the largest pooled buffer.
+         */
+        static const int SLAB_SIZE;
+
+        /**
+         * The most bytes of slabs reserved when no limit is set, 64MB.
+         */
+        static const long long DEFAULT_MAX_RESERVED;
+
+        /**
+         * A copy of the counters of the pool.
+         */
+        class DECAF_API Statistics {
+        public:
+
+            // Allocations served from a freed buffer.
+            long long hits;
+
+            // Allocations made while the pool was on that found no freed buffer, whether a
+            // new slab was carved for them or they went to the heap.
+            long long misses;
+
+            int slabs;
+            int hugePageSlabs;
+            long long reservedBytes;
+            int buffersInUse;
+
+            Statistics();
+        };
+
+    private:
+
+        BufferPool();
+        BufferPool(const BufferPool&);
+        BufferPool& operator=(const BufferPool&);
+
+    public:
+
+        /**
+         * Turns the pool on or off, buffers already handed out are unaffected.
+         */
+        static void setEnabled(bool value);
+
+        static bool isEnabled();
+
+        /**
+         * Sets the most bytes of slabs the pool reserves, allocations that would need
+         * more come from the heap.  Slabs already reserved are kept.
+         */
+        static void setMaxReserved(long long bytes);
+
+        static long long getMaxReserved();
+
+        /**
+         * @param size
+         *      The number of bytes needed, not negative.
+         *
+         * @return a buffer of at least the given size that must be passed to release.
+         */
+        static unsigned char* allocate(int size);
+
+        /**
+         * Gives back a buffer returned from allocate, NULL is ignored.
+         */
+        static void release(unsigned char* buffer);
+
+        static Statistics getStatistics();
+
+        /**
+         * Clears the hit and miss counts.
+         */
+        static void resetStatistics();
+
+    public:
+
+        /**
+         * Called by the Decaf Runtime once Threading is up.
+         */
+        static void initialize();
+
+        /**
+         * Called by the Decaf Runtime before Threading shuts down, slabs with buffers
+         * still in use are kept until the last of them is released.
+         */
+        static void shutdown();
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_BUFFERPOOL_H_ */
@@ -0,0 +1,249 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MappedFile.h"
+
+#include <decaf/internal/AprPool.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <apr_errno.h>
+#include <apr_file_io.h>
+#include <apr_mmap.h>
+#include <apr_portable.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::io;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace io {
+
+    class MappedFileImpl {
+    private:
+
+        MappedFileImpl(const MappedFileImpl&);
+        MappedFileImpl& operator= (const MappedFileImpl&);
+
+    public:
+
+        AprPool pool;
+        apr_file_t* file;
+        apr_mmap_t* mapping;
+        long long size;
+        bool writable;
+
+        MappedFileImpl() : pool(), file(NULL), mapping(NULL), size(0), writable(false) {
+        }
+
+        void open(const std::string& path, apr_int32_t flags) {
+
+            apr_status_t result = apr_file_open(&this->file, path.c_str(), flags | APR_FOPEN_BINARY,
+                                                APR_OS_DEFAULT, pool.getAprPool());
+            if (result != APR_SUCCESS) {
+                this->file = NULL;
+                fail(result, "Could not open file: " + path);
+            }
+        }
+
+        void map(const std::string& path) {
+
+            apr_int32_t flags = this->writable ? (APR_MMAP_READ | APR_MMAP_WRITE) : APR_MMAP_READ;
+            apr_status_t result = apr_mmap_create(&this->mapping, this->file, 0, (apr_size_t) this->size,
+                                                  flags, pool.getAprPool());
+            if (result != APR_SUCCESS) {
+                this->mapping = NULL;
+                close();
+                fail(result, "Could not map file: " + path);
+            }
+        }
+
+        void close() {
+
+            if (this->mapping != NULL) {
+                apr_mmap_delete(this->mapping);
+                this->mapping = NULL;
+            }
+
+            if (this->file != NULL) {
+                apr_file_close(this->file);
+                this->file = NULL;
+            }
+        }
+
+        static void fail(apr_status_t result, const std::string& message) {
+            char buffer[256] = { 0 };
+            throw IOException(__FILE__, __LINE__, "%s - %s", message.c_str(),
+                              apr_strerror(result, buffer, 255));
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const std::string& path, long long size) : impl(NULL) {
+    this->openWritable(path, size, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const std::string& path, long long size, bool truncate) : impl(NULL) {
+    this->openWritable(path, size, truncate);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const std::string& path) : impl(new MappedFileImpl()) {
+
+    try {
+
+        this->impl->open(path, APR_FOPEN_READ);
+
+        apr_off_t end = 0;
+        apr_status_t result = apr_file_seek(this->impl->file, APR_END, &end);
+        if (result != APR_SUCCESS) {
+            this->impl->close();
+            MappedFileImpl::fail(result, "Could not read the size of file: " + path);
+        }
+
+        if (end == 0) {
+            this->impl->close();
+            throw IOException(__FILE__, __LINE__, "Could not map empty file: %s", path.c_str());
+        }
+
+        this->impl->size = (long long) end;
+        this->impl->map(path);
+
+    } catch (...) {
+        delete this->impl;
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MappedFile::~MappedFile() {
+    try {
+        close();
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MappedFile::close() {
+    this->impl->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MappedFile::sync() {
+
+    if (this->impl->mapping == NULL) {
+        throw IllegalStateException(__FILE__, __LINE__, "Mapped file is closed.");
+    }
+
+    if (!this->impl->writable) {
+        throw IllegalStateException(__FILE__, __LINE__, "Mapped file is read only.");
+    }
+
+#ifdef _WIN32
+    apr_os_file_t handle;
+    apr_os_file_get(&handle, this->impl->file);
+    if (!::FlushViewOfFile(this->impl->mapping->mm, 0) || !::FlushFileBuffers(handle)) {
+        throw IOException(__FILE__, __LINE__, "Could not sync mapped file, error %d",
+                          (int) ::GetLastError());
+    }
+#else
+    if (::msync(this->impl->mapping->mm, (size_t) this->impl->size, MS_SYNC) != 0) {
+        throw IOException(__FILE__, __LINE__, "Could not sync mapped file - %s", ::strerror(errno));
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned char* MappedFile::getAddress() const {
+    if (this->impl->mapping == NULL) {
+        return NULL;
+    }
+
+    return (unsigned char*) this->impl->mapping->mm;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long MappedFile::getSize() const {
+    return this->impl->size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool MappedFile::isWritable() const {
+    return this->impl->writable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MappedFile::openWritable(const std::string& path, long long size, bool truncate) {
+
+    if (size <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Mapped file size must be positive.");
+    }
+
+    this->impl = new MappedFileImpl();
+
+    try {
+
+        apr_int32_t flags = APR_FOPEN_READ | APR_FOPEN_WRITE | APR_FOPEN_CREATE;
+        if (truncate) {
+            flags |= APR_FOPEN_TRUNCATE;
+        }
+
+        this->impl->writable = true;
+        this->impl->open(path, flags);
+
+        apr_off_t end = 0;
+        apr_status_t result = apr_file_seek(this->impl->file, APR_END, &end);
+        if (result != APR_SUCCESS) {
+            this->impl->close();
+            MappedFileImpl::fail(result, "Could not read the size of file: " + path);
+        }
+
+        if ((long long) end < size) {
+            result = apr_file_trunc(this->impl->file, (apr_off_t) size);
+            if (result != APR_SUCCESS) {
+                this->impl->close();
+                MappedFileImpl::fail(result, "Could not size file: " + path);
+            }
+            end = (apr_off_t) size;
+        }
+
+        this->impl->size = (long long) end;
+        this->impl->map(path);
+
+    } catch (...) {
+        delete this->impl;
+        this->impl = NULL;
+        throw;
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_MAPPEDFILE_H_
+#define _DECAF_INTERNAL_IO_MAPPEDFILE_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/io/IOException.h>
+
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    class MappedFileImpl;
+
+    /**
+     * A file whose contents are mapped into the address space of the process.  A file
+     * opened for writing is created, or truncated, and extended to the requested size so
+     * that its whole length can be written through the address returned by getAddress,
+     * the operating system writes the changes back to the file.  A writable file can
+     * also be reopened with its contents kept, and sync forces the changes to the disk
+     * when they must survive a crash of the machine rather than only of the process.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API MappedFile {
+    private:
+
+        MappedFileImpl* impl;
+
+    private:
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator= (const MappedFile&);
+
+    public:
+
+        /**
+         * Creates the named file, or truncates it if it exists, sizes it and maps it for
+         * reading and writing.  The file starts out filled with zeros.
+         *
+         * @param path
+         *      The name of the file to create.
+         * @param size
+         *      The size of the file in bytes.
+         *
+         * @throws IOException if the file can't be created or mapped.
+         * @throws IllegalArgumentException if the size is not positive.
+         */
+        MappedFile(const std::string& path, long long size);
+
+        /**
+         * Opens the named file for reading and writing, creating it if it doesn't exist,
+         * and maps it.  Unless truncated the contents of an existing file are kept, a
+         * file shorter than the requested size is extended with zeros and a longer one
+         * is mapped whole.
+         *
+         * @param path
+         *      The name of the file to open.
+         * @param size
+         *      The minimum size of the file in bytes.
+         * @param truncate
+         *      True to discard the contents of an existing file.
+         *
+         * @throws IOException if the file can't be opened, sized or mapped.
+         * @throws IllegalArgumentException if the size is not positive.
+         */
+        MappedFile(const std::string& path, long long size, bool truncate);
+
+        /**
+         * Maps the whole of an existing file for reading only.
+         *
+         * @param path
+         *      The name of the file to open.
+         *
+         * @throws IOException if the file can't be opened or mapped.
+         */
+        MappedFile(const std::string& path);
+
+        virtual ~MappedFile();
+
+        /**
+         * Unmaps and closes the file, after this the address is no longer valid.
+         */
+        void close();
+
+        /**
+         * Writes the changes made through the mapping to the disk and waits until they
+         * are stored.  Only the pages that were changed are written.
+         *
+         * @throws IOException if the changes can't be written.
+         * @throws IllegalStateException if the file is closed or read only.
+         */
+        void sync();
+
+        /**
+         * @return the start of the mapped region, or NULL once closed.
+         */
+        unsigned char* getAddress() const;
+
+        /**
+         * @return the size of the mapped region in bytes.
+         */
+        long long getSize() const;
+
+        /**
+         * @return true if the file was mapped for writing.
+         */
+        bool isWritable() const;
+
+    private:
+
+        void openWritable(const std::string& path, long long size, bool truncate);
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_MAPPEDFILE_H_ */
@@ -23,6 +23,7 @@
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/internal/util/ResourceLifecycleManager.h>
+#include <decaf/internal/net/ResolverCache.h>
 
 #include <apr_signal.h>
 
@@ -54,10 +55,16 @@ namespace net {
         ResourceLifecycleManager resources;
         Mutex lock;
         LinkedList<Runnable*> shutdownTasks;
+        ResolverCache resolver;
 
-        NetworkData() : resources(), lock(), shutdownTasks() {}
+        NetworkData() : resources(), lock(), shutdownTasks(), resolver() {}
 
         ~NetworkData() {
+            try {
+                resolver.shutdown();
+            } catch (...) {
+            }
+
             try {
                 std::auto_ptr<Iterator<Runnable*> > iter(shutdownTasks.iterator());
                 while (iter->hasNext()) {
@@ -124,6 +131,11 @@ void Network::shutdownNetworking() {
     delete Network::networkRuntime;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ResolverCache* Network::getResolverCache() {
+    return &(this->data->resolver);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Network::addShutdownTask(decaf::lang::Runnable* task) {
     if (task != NULL) {
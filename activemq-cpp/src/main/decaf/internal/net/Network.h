@@ -29,6 +29,7 @@ namespace internal {
 namespace net {
 
     class NetworkData;
+    class ResolverCache;
 
     /**
      * Internal class used to manage Networking related resources and hide platform
@@ -104,6 +105,13 @@ namespace net {
          */
         void addShutdownTask(decaf::lang::Runnable* task);
 
+        /**
+         * Gets the cache of host name lookups shared by all sockets of the runtime.
+         *
+         * @return pointer to the Network runtime's ResolverCache.
+         */
+        ResolverCache* getResolverCache();
+
     public:   // Static methods
 
         /**
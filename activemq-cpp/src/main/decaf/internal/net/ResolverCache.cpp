@@ -0,0 +1,399 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResolverCache.h"
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/net/UnknownHostException.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/RejectedExecutionException.h>
+#include <decaf/internal/AprPool.h>
+
+#include <apr_network_io.h>
+
+#include <map>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const long long ResolverCache::DEFAULT_TIME_TO_LIVE = 30 * 1000;
+const long long ResolverCache::DEFAULT_STALE_TIME = 5 * 60 * 1000;
+const long long ResolverCache::DEFAULT_NEGATIVE_TIME_TO_LIVE = 1000;
+const int ResolverCache::MAX_ENTRIES = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+
+    class ResolverCacheImpl {
+    private:
+
+        ResolverCacheImpl(const ResolverCacheImpl&);
+        ResolverCacheImpl& operator=(const ResolverCacheImpl&);
+
+    public:
+
+        // Background lookups run in a few threads that go away when idle.
+        static const int RESOLVER_THREADS = 4;
+
+        struct Entry {
+
+            std::vector<unsigned char> address;
+
+            // When the last lookup completed, 0 until one has, and whether it failed.
+            long long resolvedAt;
+            bool failed;
+
+            // True while a lookup of the name is in progress.
+            bool resolving;
+
+            Entry() : address(), resolvedAt(0), failed(false), resolving(false) {}
+        };
+
+        typedef std::map<std::string, Entry> EntryMap;
+
+        mutable Mutex lock;
+        EntryMap entries;
+
+        long long timeToLive;
+        long long staleTime;
+        long long negativeTimeToLive;
+
+        Pointer<ThreadPoolExecutor> executor;
+        bool shutdown;
+
+    public:
+
+        ResolverCacheImpl() : lock(), entries(),
+                              timeToLive(ResolverCache::DEFAULT_TIME_TO_LIVE),
+                              staleTime(ResolverCache::DEFAULT_STALE_TIME),
+                              negativeTimeToLive(ResolverCache::DEFAULT_NEGATIVE_TIME_TO_LIVE),
+                              executor(), shutdown(false) {
+        }
+
+        // Asks the system resolver, never called with the lock held.
+        static bool lookup(const std::string& host, std::vector<unsigned char>& address) {
+
+            AprPool pool;
+            apr_sockaddr_t* info = NULL;
+
+            apr_status_t result = apr_sockaddr_info_get(
+                &info, host.c_str(), APR_UNSPEC, 0, APR_IPV4_ADDR_OK, pool.getAprPool());
+
+            if (result != APR_SUCCESS || info == NULL) {
+                return false;
+            }
+
+            const unsigned char* bytes = (const unsigned char*) info->ipaddr_ptr;
+            address.assign(bytes, bytes + info->ipaddr_len);
+            return true;
+        }
+
+        // Finds the entry for the host, making room for it if it is new.  Returns NULL
+        // when the cache is full of live entries.  Called with the lock held.
+        Entry* entryFor(const std::string& host, long long now) {
+
+            EntryMap::iterator found = entries.find(host);
+            if (found != entries.end()) {
+                return &found->second;
+            }
+
+            if ((int) entries.size() >= ResolverCache::MAX_ENTRIES) {
+                EntryMap::iterator iter = entries.begin();
+                while (iter != entries.end()) {
+                    if (!iter->second.resolving && isExpired(iter->second, now)) {
+                        entries.erase(iter++);
+                    } else {
+                        ++iter;
+                    }
+                }
+
+                if ((int) entries.size() >= ResolverCache::MAX_ENTRIES) {
+                    return NULL;
+                }
+            }
+
+            return &entries[host];
+        }
+
+        bool isExpired(const Entry& entry, long long now) const {
+            if (entry.failed) {
+                return now - entry.resolvedAt >= negativeTimeToLive;
+            }
+            return now - entry.resolvedAt >= timeToLive + staleTime;
+        }
+
+        // Records the outcome of a lookup and wakes the callers waiting for it.
+        void complete(const std::string& host, bool resolved, const std::vector<unsigned char>& address) {
+
+            synchronized(&lock) {
+                EntryMap::iterator found = entries.find(host);
+                if (found != entries.end()) {
+                    Entry& entry = found->second;
+                    entry.resolving = false;
+
+                    // A failed refresh keeps the stale address for as long as it lasts.
+                    if (resolved) {
+                        entry.address = address;
+                        entry.resolvedAt = System::currentTimeMillis();
+                        entry.failed = false;
+                    } else if (entry.resolvedAt == 0 || entry.failed) {
+                        entry.address.clear();
+                        entry.resolvedAt = System::currentTimeMillis();
+                        entry.failed = true;
+                    }
+                }
+
+                lock.notifyAll();
+            }
+        }
+
+        // Hands a lookup of the host to the background threads, the entry is already
+        // marked as resolving.  Called with the lock held.
+        bool submit(const std::string& host);
+
+    };
+
+    class ResolveTask : public Runnable {
+    private:
+
+        ResolveTask(const ResolveTask&);
+        ResolveTask& operator=(const ResolveTask&);
+
+    private:
+
+        ResolverCacheImpl* impl;
+        std::string host;
+
+    public:
+
+        ResolveTask(ResolverCacheImpl* impl, const std::string& host) : Runnable(), impl(impl), host(host) {}
+
+        virtual ~ResolveTask() {}
+
+        virtual void run() {
+            std::vector<unsigned char> address;
+            bool resolved = ResolverCacheImpl::lookup(host, address);
+            impl->complete(host, resolved, address);
+        }
+    };
+
+    ////////////////////////////////////////////////////////////////////////////
+    bool ResolverCacheImpl::submit(const std::string& host) {
+
+        if (shutdown) {
+            return false;
+        }
+
+        if (executor == NULL) {
+            executor.reset(new ThreadPoolExecutor(RESOLVER_THREADS, RESOLVER_THREADS, 5, TimeUnit::SECONDS,
+                                                  new LinkedBlockingQueue<Runnable*>()));
+            executor->allowCoreThreadTimeout(true);
+        }
+
+        try {
+            executor->execute(new ResolveTask(this, host));
+            return true;
+        } catch (RejectedExecutionException& ex) {
+            return false;
+        }
+    }
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+ResolverCache::ResolverCache() : impl(new ResolverCacheImpl()) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ResolverCache::~ResolverCache() {
+    try {
+        shutdown();
+        delete this->impl;
+    }
+    DECAF_CATCH_NOTHROW(Exception)
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char> ResolverCache::resolve(const std::string& host) {
+
+    synchronized(&this->impl->lock) {
+
+        while (true) {
+
+            long long now = System::currentTimeMillis();
+            ResolverCacheImpl::Entry* entry = this->impl->entryFor(host, now);
+
+            if (entry == NULL) {
+                break;
+            }
+
+            if (entry->resolvedAt != 0) {
+                long long age = now - entry->resolvedAt;
+
+                if (entry->failed && age < this->impl->negativeTimeToLive) {
+                    throw UnknownHostException(__FILE__, __LINE__, "Could not resolve host: %s", host.c_str());
+                } else if (!entry->failed && age < this->impl->timeToLive) {
+                    return entry->address;
+                } else if (!entry->failed && age < this->impl->timeToLive + this->impl->staleTime) {
+                    if (!entry->resolving) {
+                        entry->resolving = this->impl->submit(host);
+                    }
+
+                    if (entry->resolving) {
+                        return entry->address;
+                    }
+                }
+            }
+
+            // Wait for a lookup in progress rather than starting another one.
+            if (entry->resolving) {
+                this->impl->lock.wait();
+                continue;
+            }
+
+            entry->resolving = true;
+            break;
+        }
+    }
+
+    std::vector<unsigned char> address;
+    bool resolved = ResolverCacheImpl::lookup(host, address);
+    this->impl->complete(host, resolved, address);
+
+    if (!resolved) {
+        throw UnknownHostException(__FILE__, __LINE__, "Could not resolve host: %s", host.c_str());
+    }
+
+    return address;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::resolveAsync(const std::string& host) {
+
+    synchronized(&this->impl->lock) {
+
+        long long now = System::currentTimeMillis();
+        ResolverCacheImpl::Entry* entry = this->impl->entryFor(host, now);
+
+        if (entry == NULL || entry->resolving) {
+            return;
+        }
+
+        if (entry->resolvedAt != 0) {
+            long long age = now - entry->resolvedAt;
+            if (age < (entry->failed ? this->impl->negativeTimeToLive : this->impl->timeToLive)) {
+                return;
+            }
+        }
+
+        entry->resolving = this->impl->submit(host);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::clear() {
+
+    synchronized(&this->impl->lock) {
+
+        // Entries being resolved stay, their lookups report back to them.
+        ResolverCacheImpl::EntryMap::iterator iter = this->impl->entries.begin();
+        while (iter != this->impl->entries.end()) {
+            if (!iter->second.resolving) {
+                this->impl->entries.erase(iter++);
+            } else {
+                ++iter;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::shutdown() {
+
+    Pointer<ThreadPoolExecutor> executor;
+
+    synchronized(&this->impl->lock) {
+        this->impl->shutdown = true;
+        executor.swap(this->impl->executor);
+    }
+
+    if (executor != NULL) {
+        executor->shutdown();
+        executor->awaitTermination(30, TimeUnit::SECONDS);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ResolverCache::size() const {
+
+    int size = 0;
+
+    synchronized(&this->impl->lock) {
+        size = (int) this->impl->entries.size();
+    }
+
+    return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ResolverCache::getTimeToLive() const {
+    return this->impl->timeToLive;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::setTimeToLive(long long value) {
+    synchronized(&this->impl->lock) {
+        this->impl->timeToLive = value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ResolverCache::getStaleTime() const {
+    return this->impl->staleTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::setStaleTime(long long value) {
+    synchronized(&this->impl->lock) {
+        this->impl->staleTime = value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ResolverCache::getNegativeTimeToLive() const {
+    return this->impl->negativeTimeToLive;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCache::setNegativeTimeToLive(long long value) {
+    synchronized(&this->impl->lock) {
+        this->impl->negativeTimeToLive = value;
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_RESOLVERCACHE_H_
+#define _DECAF_INTERNAL_NET_RESOLVERCACHE_H_
+
+#include <decaf/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace decaf {
+namespace internal {
+namespace net {
+
+    class ResolverCacheImpl;
+
+    /**
+     * Caches the addresses host names resolve to so that connecting to a host doesn't
+     * block on the system resolver every time.
+     *
+     * A resolved address is used for the time to live, after that it is still handed out
+     * for the stale time while a background thread resolves the name again, callers only
+     * wait on the resolver once an entry is older than both.  A name that fails to
+     * resolve is remembered as failed for the negative time to live.  Callers asking for
+     * a name that is already being resolved wait for that lookup instead of starting their
+     * own, so a burst of connects to one host makes a single lookup.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API ResolverCache {
+    public:
+
+        /**
+         * Default time in milliseconds a resolved address is used without resolving again.
+         */
+        static const long long DEFAULT_TIME_TO_LIVE;
+
+        /**
+         * Default time in milliseconds past the time to live that an address is still used
+         * while it is resolved again in the background.
+         */
+        static const long long DEFAULT_STALE_TIME;
+
+        /**
+         * Default time in milliseconds a failed lookup is remembered.
+         */
+        static const long long DEFAULT_NEGATIVE_TIME_TO_LIVE;
+
+        /**
+         * Number of host names the cache holds at most, expired entries are dropped to
+         * make room and names beyond it are resolved without being cached.
+         */
+        static const int MAX_ENTRIES;
+
+    private:
+
+        ResolverCacheImpl* impl;
+
+    private:
+
+        ResolverCache(const ResolverCache&);
+        ResolverCache& operator=(const ResolverCache&);
+
+    public:
+
+        ResolverCache();
+
+        virtual ~ResolverCache();
+
+        /**
+         * Returns the address bytes the host name resolves to, four for an IPv4 address
+         * and sixteen for an IPv6 one, an IPv4 address is preferred if the host has both.
+         *
+         * @param host
+         *      The host name or address literal to resolve.
+         *
+         * @return the address bytes of the host.
+         *
+         * @throws UnknownHostException if the name doesn't resolve.
+         */
+        std::vector<unsigned char> resolve(const std::string& host);
+
+        /**
+         * Starts resolving the host name in the background unless the cache holds a fresh
+         * address for it or it is already being resolved, a later resolve finds the
+         * result in the cache.
+         *
+         * @param host
+         *      The host name or address literal to resolve.
+         */
+        void resolveAsync(const std::string& host);
+
+        /**
+         * Drops every cached address, lookups in progress complete as usual.
+         */
+        void clear();
+
+        /**
+         * Stops the background resolver, waiting for lookups in progress.  Asynchronous
+         * resolves are ignored afterwards and stale entries are resolved by the caller.
+         */
+        void shutdown();
+
+        /**
+         * @return the number of host names in the cache.
+         */
+        int size() const;
+
+        long long getTimeToLive() const;
+
+        void setTimeToLive(long long value);
+
+        long long getStaleTime() const;
+
+        void setStaleTime(long long value);
+
+        long long getNegativeTimeToLive() const;
+
+        void setNegativeTimeToLive(long long value);
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_NET_RESOLVERCACHE_H_ */
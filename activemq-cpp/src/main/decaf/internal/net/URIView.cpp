@@ -0,0 +1,620 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIView.h"
+
+#include <decaf/lang/Character.h>
+
+#include <cstring>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::net;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The components a character may appear in unescaped, following the legal sets
+    // of the URI class: the scheme takes letters, digits and "+-.", the authority
+    // "@[]" plus the someLegal set, the path "/@" plus someLegal and the query,
+    // fragment and opaque part the allLegal set.  A domain name takes letters,
+    // digits and "-.".  ESCAPED marks the components that take "%hh" escapes.
+    enum {
+        SCHEME = 1,
+        AUTHORITY = 2,
+        PATH = 4,
+        QUERY = 8,
+        DOMAIN = 16,
+        ESCAPED = 32
+    };
+
+    int classOf(char ch) {
+
+        if (Character::isLetterOrDigit(ch)) {
+            return SCHEME | AUTHORITY | PATH | QUERY | DOMAIN;
+        }
+
+        // Anything outside of US-ASCII is taken as is, like URIEncoderDecoder does.
+        if ((unsigned char) ch > 127) {
+            return AUTHORITY | PATH | QUERY;
+        }
+
+        switch (ch) {
+            case '-':
+            case '.':
+                return SCHEME | AUTHORITY | PATH | QUERY | DOMAIN;
+            case '+':
+                return SCHEME | AUTHORITY | PATH | QUERY;
+            case '_':
+            case '!':
+            case '~':
+            case '\'':
+            case '(':
+            case ')':
+            case '*':
+            case ',':
+            case ';':
+            case ':':
+            case '$':
+            case '&':
+            case '=':
+            case '@':
+                return AUTHORITY | PATH | QUERY;
+            case '[':
+            case ']':
+                return AUTHORITY | QUERY;
+            case '/':
+                return PATH | QUERY;
+            case '?':
+                return QUERY;
+            default:
+                return 0;
+        }
+    }
+
+    bool isHexDigit(char ch) {
+        return (ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F') || (ch >= 'a' && ch <= 'f');
+    }
+
+    std::size_t find(const char* begin, std::size_t length, char ch) {
+        const void* found = ::memchr(begin, ch, length);
+        return found == NULL ? std::string::npos : (std::size_t) ((const char*) found - begin);
+    }
+
+    std::size_t findLast(const char* begin, std::size_t length, char ch) {
+        for (std::size_t i = length; i > 0; --i) {
+            if (begin[i - 1] == ch) {
+                return i - 1;
+            }
+        }
+        return std::string::npos;
+    }
+
+    // A decimal number of one to three digits no greater than 255.
+    bool isIPv4Word(const char* word, std::size_t length) {
+
+        if (length < 1 || length > 3) {
+            return false;
+        }
+
+        int value = 0;
+        for (std::size_t i = 0; i < length; ++i) {
+            if (!Character::isDigit(word[i])) {
+                return false;
+            }
+            value = value * 10 + (word[i] - '0');
+        }
+
+        return value <= 255;
+    }
+
+    // The port as parseInt reads it: 0 or more when it is a number, -1 when it is a
+    // negative number and -2 when it isn't a number.
+    int parsePort(const char* text, std::size_t length) {
+
+        std::size_t i = 0;
+        bool negative = length > 0 && text[0] == '-';
+        if (negative) {
+            ++i;
+        }
+
+        if (i == length) {
+            return -2;
+        }
+
+        long long value = 0;
+        for (; i < length; ++i) {
+            if (!Character::isDigit(text[i])) {
+                return -2;
+            }
+            value = value * 10 + (text[i] - '0');
+            if (value > 2147483648LL) {
+                return -2;
+            }
+        }
+
+        if (negative) {
+            return value == 0 ? 0 : -1;
+        }
+
+        return value > 2147483647LL ? -2 : (int) value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIView::URIView() : source(NULL),
+                     scheme(),
+                     schemeSpecificPart(),
+                     authority(),
+                     userInfo(),
+                     host(),
+                     portText(),
+                     path(),
+                     query(),
+                     fragment(),
+                     port(-1),
+                     absolute(false),
+                     opaque(false),
+                     serverAuthority(false),
+                     authorityMissing(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIView::scan(const std::string& uri) {
+
+    *this = URIView();
+    this->source = &uri;
+
+    const char* chars = uri.data();
+    std::size_t length = uri.length();
+
+    // One pass up to the fragment finds the first ':', '/' and '?', which is all
+    // it takes to split off the scheme, the query and the fragment.
+    std::size_t colon = std::string::npos;
+    std::size_t slash = std::string::npos;
+    std::size_t question = std::string::npos;
+    std::size_t end = length;
+
+    for (std::size_t i = 0; i < length; ++i) {
+        char ch = chars[i];
+        if (ch == '#') {
+            end = i;
+            break;
+        } else if (ch == ':') {
+            if (colon == std::string::npos) {
+                colon = i;
+            }
+        } else if (ch == '/') {
+            if (slash == std::string::npos) {
+                slash = i;
+            }
+        } else if (ch == '?') {
+            if (question == std::string::npos) {
+                question = i;
+            }
+        }
+    }
+
+    if (end < length) {
+        this->fragment.offset = end + 1;
+        this->fragment.length = length - end - 1;
+    }
+
+    // If a '/' or '?' occurs before the first ':' the uri has no scheme and is
+    // therefore not absolute.
+    this->absolute = colon != std::string::npos && slash > colon && question > colon;
+
+    if (this->absolute) {
+        this->scheme.length = colon;
+        this->schemeSpecificPart.offset = colon + 1;
+    }
+    this->schemeSpecificPart.length = end - this->schemeSpecificPart.offset;
+
+    std::size_t ssp = this->schemeSpecificPart.offset;
+
+    if (!this->scheme.isEmpty() && (this->schemeSpecificPart.isEmpty() || chars[ssp] != '/')) {
+        this->opaque = true;
+        return;
+    }
+
+    std::size_t pathEnd = end;
+    if (question != std::string::npos) {
+        this->query.offset = question + 1;
+        this->query.length = end - question - 1;
+        pathEnd = question;
+    }
+
+    if (pathEnd - ssp < 2 || chars[ssp] != '/' || chars[ssp + 1] != '/') {
+        this->path.offset = ssp;
+        this->path.length = pathEnd - ssp;
+        return;
+    }
+
+    this->authority.offset = ssp + 2;
+    std::size_t index = find(chars + ssp + 2, pathEnd - ssp - 2, '/');
+    if (index != std::string::npos) {
+        this->authority.length = index;
+        this->path.offset = ssp + 2 + index;
+        this->path.length = pathEnd - this->path.offset;
+    } else {
+        this->authority.length = pathEnd - ssp - 2;
+        this->path.offset = pathEnd;
+        this->authorityMissing = this->authority.isEmpty() &&
+                                 this->query.isEmpty() && this->fragment.isEmpty();
+    }
+
+    if (this->authority.isEmpty()) {
+        return;
+    }
+
+    // Split the authority as if it were server based, user info up to the '@' and
+    // then host and port around the last ':' that isn't inside an IPv6 address.
+    const char* begin = at(this->authority);
+    std::size_t authorityEnd = this->authority.length;
+    std::size_t hostStart = 0;
+
+    index = find(begin, authorityEnd, '@');
+    if (index != std::string::npos) {
+        this->userInfo.offset = this->authority.offset;
+        this->userInfo.length = index;
+        hostStart = index + 1;
+    }
+
+    this->host.offset = this->authority.offset + hostStart;
+    this->host.length = authorityEnd - hostStart;
+
+    index = findLast(begin + hostStart, authorityEnd - hostStart, ':');
+    std::size_t bracket = find(begin + hostStart, authorityEnd - hostStart, ']');
+
+    if (index != std::string::npos && (bracket == std::string::npos || bracket < index)) {
+        this->host.length = index;
+        this->portText.offset = this->host.offset + index + 1;
+        this->portText.length = authorityEnd - hostStart - index - 1;
+
+        int value = parsePort(at(this->portText), this->portText.length);
+        this->port = value < 0 ? -1 : value;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIView::validate(bool forceServer) {
+
+    checkCharacters(this->fragment, QUERY | ESCAPED, "Invalid URI Fragment");
+
+    if (this->absolute) {
+
+        if (this->scheme.isEmpty()) {
+            throwError("Scheme not specified.", 0);
+        }
+
+        if (!Character::isLetter(*at(this->scheme))) {
+            throwError("Schema must start with a Letter.", 0);
+        }
+
+        checkCharacters(this->scheme, SCHEME, "Invalid Schema");
+
+        if (this->schemeSpecificPart.isEmpty()) {
+            throwError("Scheme specific part is invalid..", this->schemeSpecificPart.offset);
+        }
+    }
+
+    if (this->opaque) {
+        checkCharacters(this->schemeSpecificPart, QUERY | ESCAPED, "Invalid URI Ssp");
+    } else {
+
+        checkCharacters(this->query, QUERY | ESCAPED, "Invalid URI Query");
+
+        if (this->authorityMissing) {
+            throwError("Scheme specific part is invalid..", this->source->length());
+        }
+
+        checkCharacters(this->authority, AUTHORITY | ESCAPED, "Invalid URI Authority");
+        checkCharacters(this->path, PATH | ESCAPED, "Invalid URI Path");
+    }
+
+    validateServerAuthority(forceServer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIView::checkCharacters(const Component& component, int legal, const char* reason) const {
+
+    const char* chars = at(component);
+
+    for (std::size_t i = 0; i < component.length; ++i) {
+
+        char ch = chars[i];
+
+        if (ch == '%' && (legal & ESCAPED) != 0) {
+            if (i + 2 >= component.length || !isHexDigit(chars[i + 1]) || !isHexDigit(chars[i + 2])) {
+                throwError(reason, component.offset + i);
+            }
+            i += 2;
+            continue;
+        }
+
+        if ((classOf(ch) & legal) == 0) {
+            throwError(reason, component.offset + i);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIView::validateServerAuthority(bool forceServer) {
+
+    this->serverAuthority = false;
+
+    if (this->authority.isEmpty()) {
+        return false;
+    }
+
+    const char* chars = at(this->userInfo);
+    for (std::size_t i = 0; i < this->userInfo.length; ++i) {
+        if (chars[i] == '[' || chars[i] == ']') {
+            throwError("User Info cannot contain '[' or ']'", this->userInfo.offset + i);
+        }
+    }
+
+    if (!this->portText.isEmpty()) {
+
+        int value = parsePort(at(this->portText), this->portText.length);
+        if (value < 0) {
+            if (forceServer) {
+                throwError(value == -1 ? "Port number is missing" : "Port number is malformed.",
+                           this->portText.offset);
+            }
+            return false;
+        }
+    }
+
+    if (this->host.isEmpty()) {
+        if (forceServer) {
+            throwError("Host name is empty", this->host.offset);
+        }
+        return false;
+    }
+
+    this->serverAuthority = checkHost(forceServer);
+    return this->serverAuthority;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIView::checkHost(bool forceServer) {
+
+    const char* chars = at(this->host);
+    std::size_t length = this->host.length;
+
+    if (chars[0] == '[') {
+
+        if (chars[length - 1] != ']') {
+            throwError("Host address does not end in ']'", this->host.offset);
+        }
+
+        if (!isValidIPv6Address(chars, length)) {
+            throwError("Host IPv6 address is not valid", this->host.offset);
+        }
+
+        return true;
+    }
+
+    // '[' and ']' can only be the first and last char of the host name.
+    if (find(chars, length, '[') != std::string::npos || find(chars, length, ']') != std::string::npos) {
+        throwError("Unexpected '[' or ']' found in address", this->host.offset);
+    }
+
+    std::size_t index = findLast(chars, length, '.');
+
+    if (index == std::string::npos || index == length - 1 || !Character::isDigit(chars[index + 1])) {
+
+        if (isValidDomainName(chars, length)) {
+            return true;
+        }
+
+        if (forceServer) {
+            throwError("Host address is not valid", this->host.offset);
+        }
+
+        return false;
+    }
+
+    if (isValidIPv4Address(chars, length)) {
+        return true;
+    }
+
+    if (forceServer) {
+        throwError("Host IPv4 address is not valid", this->host.offset);
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIView::throwError(const char* reason, std::size_t index) const {
+    throw URISyntaxException(__FILE__, __LINE__, *this->source, reason, (int) index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIView::isValidIPv4Address(const char* host, std::size_t length) {
+
+    // Four decimal numbers no greater than 255, leading zeros are allowed.
+    int words = 0;
+    int value = -1;
+
+    for (std::size_t i = 0; i <= length; ++i) {
+        if (i == length || host[i] == '.') {
+            if (value < 0 || ++words > 4) {
+                return false;
+            }
+            value = -1;
+        } else if (Character::isDigit(host[i])) {
+            value = (value < 0 ? 0 : value * 10) + (host[i] - '0');
+            if (value > 255) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return words == 4;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIView::isValidIPv6Address(const char* host, std::size_t length) {
+
+    bool doubleColon = false;
+    int numberOfColons = 0;
+    int numberOfPeriods = 0;
+    std::size_t wordStart = 0;
+    std::size_t wordLength = 0;
+    char ch = 0;
+    char prevChar = 0;
+    std::size_t offset = 0; // offset for [] ip addresses
+
+    if (length < 2) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < length; i++) {
+
+        prevChar = ch;
+        ch = host[i];
+
+        switch (ch) {
+
+            // case for an open bracket [x:x:x:...x]
+            case '[':
+                if (i != 0 || host[length - 1] != ']' || length < 4) {
+                    return false;
+                }
+                if (host[1] == ':' && host[2] != ':') {
+                    return false;
+                }
+                offset = 1;
+                break;
+
+            // case for a closed bracket at end of IP [x:x:x:...x]
+            case ']':
+                if (i != length - 1 || host[0] != '[') {
+                    return false;
+                }
+                break;
+
+            // case for the last 32-bits represented as IPv4 x:x:x:x:x:x:d.d.d.d
+            case '.':
+                numberOfPeriods++;
+                if (numberOfPeriods > 3) {
+                    return false;
+                }
+                if (!isIPv4Word(host + wordStart, wordLength)) {
+                    return false;
+                }
+                if (numberOfColons != 6 && !doubleColon) {
+                    return false;
+                }
+                // a special case ::1:2:3:4:5:d.d.d.d allows 7 colons with an IPv4
+                // ending, otherwise 7 :'s is bad
+                if (numberOfColons == 7 && host[offset] != ':' && host[offset + 1] != ':') {
+                    return false;
+                }
+                wordLength = 0;
+                break;
+
+            case ':':
+                numberOfColons++;
+                if (numberOfColons > 7) {
+                    return false;
+                }
+                if (numberOfPeriods > 0) {
+                    return false;
+                }
+                if (prevChar == ':') {
+                    if (doubleColon) {
+                        return false;
+                    }
+                    doubleColon = true;
+                }
+                wordLength = 0;
+                break;
+
+            default:
+                if (wordLength > 3 || !isHexDigit(ch)) {
+                    return false;
+                }
+                if (wordLength == 0) {
+                    wordStart = i;
+                }
+                wordLength++;
+        }
+    }
+
+    // Check if we have an IPv4 ending
+    if (numberOfPeriods > 0) {
+        return numberOfPeriods == 3 && isIPv4Word(host + wordStart, wordLength);
+    }
+
+    // If we're at the end and we haven't had 7 colons then there is a problem
+    // unless we encountered a doubleColon
+    if (numberOfColons != 7 && !doubleColon) {
+        return false;
+    }
+
+    // An empty word at the end means we ended in a ':', which is only valid as
+    // the end of a '::'.
+    if (wordLength == 0 && length >= offset + 2 &&
+        host[length - 1 - offset] != ':' && host[length - 2 - offset] != ':') {
+        return false;
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool URIView::isValidDomainName(const char* host, std::size_t length) {
+
+    for (std::size_t i = 0; i < length; ++i) {
+        if ((classOf(host[i]) & DOMAIN) == 0) {
+            return false;
+        }
+    }
+
+    // Each label between the dots can't start or end with '-' and the last one
+    // can't start with a digit unless it is the whole name.
+    std::size_t labelStart = 0;
+    std::size_t lastStart = 0;
+    std::size_t lastLength = 0;
+
+    for (std::size_t i = 0; i <= length; ++i) {
+        if (i == length || host[i] == '.') {
+            if (i > labelStart) {
+                if (host[labelStart] == '-' || host[i - 1] == '-') {
+                    return false;
+                }
+                lastStart = labelStart;
+                lastLength = i - labelStart;
+            }
+            labelStart = i + 1;
+        }
+    }
+
+    if (lastLength == 0) {
+        return false;
+    }
+
+    return lastLength == length || !Character::isDigit(host[lastStart]);
+}
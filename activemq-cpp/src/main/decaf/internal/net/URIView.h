@@ -0,0 +1,231 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_URIVIEW_H_
+#define _DECAF_INTERNAL_NET_URIVIEW_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/net/URISyntaxException.h>
+
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace net {
+
+    /**
+     * A view of the components of a URI string.  Scanning splits the string into its
+     * scheme, scheme specific part, authority, user info, host, port, path, query and
+     * fragment in a single pass, recording each as an offset and length into the string
+     * without copying or checking anything.  The characters of the components, the host
+     * address and the port are checked only when validate is called, which is what makes
+     * the view a URI as the decaf::net::URI class defines it.
+     *
+     * The view refers to the string it scanned, which must outlive it and not change.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API URIView {
+    public:
+
+        /**
+         * A component of the scanned string.  A component that is not present has
+         * a length of zero.
+         */
+        struct Component {
+
+            std::size_t offset;
+            std::size_t length;
+
+            Component() : offset(0), length(0) {}
+
+            bool isEmpty() const {
+                return length == 0;
+            }
+        };
+
+    private:
+
+        const std::string* source;
+
+        Component scheme;
+        Component schemeSpecificPart;
+        Component authority;
+        Component userInfo;
+        Component host;
+        Component portText;
+        Component path;
+        Component query;
+        Component fragment;
+
+        int port;
+
+        bool absolute;
+        bool opaque;
+        bool serverAuthority;
+
+        // Set by scan when the string is a "//" with nothing after it.
+        bool authorityMissing;
+
+    public:
+
+        URIView();
+
+        /**
+         * Splits the given string into its components, replacing anything scanned
+         * before.  The authority is split into user info, host and port as if it were
+         * server based, validate decides whether it really is.
+         *
+         * @param uri
+         *      The URI string to scan, it must outlive the view.
+         */
+        void scan(const std::string& uri);
+
+        /**
+         * Checks the scanned components the way the URI class does on construction
+         * and decides whether the authority is server based.
+         *
+         * @param forceServer
+         *      If true an authority that is not a valid server authority is an error
+         *      instead of being taken as registry based.
+         *
+         * @throws URISyntaxException if the string is not a valid URI, its index is the
+         *         offset of the offending character in the scanned string.
+         */
+        void validate(bool forceServer);
+
+        /**
+         * Checks whether the scanned authority is server based, the other components
+         * are not checked.
+         *
+         * @param forceServer
+         *      If true an authority that is not a valid server authority is an error.
+         *
+         * @return true if the authority is server based.
+         *
+         * @throws URISyntaxException if forceServer is set and the authority is not
+         *         server based, or the user info holds a '[' or ']'.
+         */
+        bool validateServerAuthority(bool forceServer);
+
+        /**
+         * @return the string the view was scanned from.
+         */
+        const std::string& getSource() const {
+            return *this->source;
+        }
+
+        /**
+         * @return the text of the given component as a new string.
+         */
+        std::string toString(const Component& component) const {
+            return component.isEmpty() ? std::string() :
+                this->source->substr(component.offset, component.length);
+        }
+
+        const Component& getScheme() const {
+            return this->scheme;
+        }
+
+        const Component& getSchemeSpecificPart() const {
+            return this->schemeSpecificPart;
+        }
+
+        const Component& getAuthority() const {
+            return this->authority;
+        }
+
+        const Component& getUserInfo() const {
+            return this->userInfo;
+        }
+
+        const Component& getHost() const {
+            return this->host;
+        }
+
+        const Component& getPath() const {
+            return this->path;
+        }
+
+        const Component& getQuery() const {
+            return this->query;
+        }
+
+        const Component& getFragment() const {
+            return this->fragment;
+        }
+
+        /**
+         * The user info, host and port are those of the authority split as if it were
+         * server based, whether it really is is known once validated.
+         *
+         * @return the port, or -1 if there is none or it is not a number.
+         */
+        int getPort() const {
+            return this->port;
+        }
+
+        bool isAbsolute() const {
+            return this->absolute;
+        }
+
+        bool isOpaque() const {
+            return this->opaque;
+        }
+
+        /**
+         * @return true if validate found the authority to be server based.
+         */
+        bool isServerAuthority() const {
+            return this->serverAuthority;
+        }
+
+    public:
+
+        /**
+         * @return true if the characters are an IPv4 address in dotted decimal form.
+         */
+        static bool isValidIPv4Address(const char* host, std::size_t length);
+
+        /**
+         * @return true if the characters are an IPv6 address, with or without the
+         *         enclosing brackets.
+         */
+        static bool isValidIPv6Address(const char* host, std::size_t length);
+
+        /**
+         * @return true if the characters are a domain name.
+         */
+        static bool isValidDomainName(const char* host, std::size_t length);
+
+    private:
+
+        void checkCharacters(const Component& component, int legal, const char* reason) const;
+
+        bool checkHost(bool forceServer);
+
+        void throwError(const char* reason, std::size_t index) const;
+
+        const char* at(const Component& component) const {
+            return this->source->data() + component.offset;
+        }
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_NET_URIVIEW_H_ */
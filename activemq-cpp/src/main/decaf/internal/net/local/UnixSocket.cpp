@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UnixSocket.h"
+
+#include <decaf/net/SocketOptions.h>
+
+#include <apr_network_io.h>
+
+#include <stdio.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::local;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    apr_status_t createAddress(apr_sockaddr_t** address DECAF_UNUSED, const std::string& path DECAF_UNUSED,
+                               apr_pool_t* pool DECAF_UNUSED) {
+#ifdef APR_UNIX
+        return apr_sockaddr_info_get(address, path.c_str(), APR_UNIX, 0, 0, pool);
+#else
+        throw IOException(__FILE__, __LINE__, "Unix domain sockets are not supported on this platform.");
+#endif
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+UnixSocket::UnixSocket() : TcpSocket(), path() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+UnixSocket::~UnixSocket() {
+    try {
+        close();
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool UnixSocket::isSupported() {
+#ifdef APR_UNIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string UnixSocket::getLocalAddress() const {
+    return this->path;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocket::create() {
+
+    try {
+#ifdef APR_UNIX
+        createSocket(APR_UNIX, 0);
+#else
+        throw IOException(__FILE__, __LINE__, "Unix domain sockets are not supported on this platform.");
+#endif
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocket::bind(const std::string& path, int port DECAF_UNUSED) {
+
+    try {
+
+        // A client socket is bound with no path before it connects, it stays unnamed.
+        if (path.empty()) {
+            return;
+        }
+
+        apr_sockaddr_t* address = NULL;
+        checkResult(createAddress(&address, path, getAprPool()));
+
+        bindAddress(address);
+        this->path = path;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocket::connect(const std::string& path, int port DECAF_UNUSED, int timeout) {
+
+    try {
+
+        if (path.empty()) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "The socket path cannot be empty.");
+        }
+
+        apr_sockaddr_t* address = NULL;
+        checkResult(createAddress(&address, path, getAprPool()));
+
+        connectAddress(address, timeout);
+
+    } catch (IOException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw;
+    } catch (IllegalArgumentException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw;
+    } catch (Exception& ex) {
+        try {
+            close();
+        } catch (lang::Exception& cx) { /* Absorb */
+        }
+        throw SocketException(ex.clone());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocket::close() {
+
+    try {
+
+        TcpSocket::close();
+
+        if (!this->path.empty()) {
+            ::remove(this->path.c_str());
+            this->path.clear();
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int UnixSocket::getOption(int option) const {
+
+    if (isTcpOption(option) && !isClosed()) {
+        return 0;
+    }
+
+    return TcpSocket::getOption(option);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocket::setOption(int option, int value) {
+
+    if (isTcpOption(option) && !isClosed()) {
+        return;
+    }
+
+    TcpSocket::setOption(option, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool UnixSocket::isTcpOption(int option) {
+    return option == SocketOptions::SOCKET_OPTION_TCP_NODELAY ||
+           option == SocketOptions::SOCKET_OPTION_KEEPALIVE ||
+           option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK ||
+           option == SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT ||
+           option == SocketOptions::SOCKET_OPTION_TCP_USER_TIMEOUT;
+}
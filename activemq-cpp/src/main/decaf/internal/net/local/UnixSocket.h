@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_LOCAL_UNIXSOCKET_H_
+#define _DECAF_INTERNAL_NET_LOCAL_UNIXSOCKET_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/internal/net/tcp/TcpSocket.h>
+
+#include <string>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace local {
+
+    /**
+     * A stream socket in the Unix domain, connecting to a peer on the same host through
+     * a path in the file system without going through the TCP stack.
+     *
+     * The host names given to bind and connect are paths and ports are ignored, binding
+     * to an empty path leaves the socket unbound.  Reads, writes, polling and the socket
+     * level options are those of the TcpSocket, options of the TCP protocol are ignored
+     * when set and read back as zero.  A socket that was bound removes its path when it
+     * is closed.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API UnixSocket : public decaf::internal::net::tcp::TcpSocket {
+    private:
+
+        std::string path;
+
+    private:
+
+        UnixSocket(const UnixSocket&);
+        UnixSocket& operator=(const UnixSocket&);
+
+    public:
+
+        UnixSocket();
+
+        virtual ~UnixSocket();
+
+        /**
+         * @return true if the platform supports sockets in the Unix domain.
+         */
+        static bool isSupported();
+
+    public:
+
+        virtual std::string getLocalAddress() const;
+
+        virtual void create();
+
+        virtual void bind(const std::string& path, int port);
+
+        virtual void connect(const std::string& path, int port, int timeout);
+
+        virtual void close();
+
+        virtual int getOption(int option) const;
+
+        virtual void setOption(int option, int value);
+
+    private:
+
+        static bool isTcpOption(int option);
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_LOCAL_UNIXSOCKET_H_ */
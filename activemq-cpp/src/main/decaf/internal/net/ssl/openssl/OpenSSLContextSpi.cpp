@@ -26,6 +26,7 @@
 #include <decaf/lang/ArrayPointer.h>
 #include <decaf/lang/exceptions/IllegalStateException.h>
 #include <decaf/util/concurrent/Mutex.h>
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCache.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketException.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketFactory.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLServerSocketFactory.h>
@@ -76,6 +77,7 @@ namespace openssl {
         Pointer<ServerSocketFactory> serverSocketFactory;
         Pointer<SecureRandom> random;
         std::string password;
+        OpenSSLSessionCache sessionCache;
 
         static Mutex* locks;
         static std::string defaultCipherList;
@@ -98,6 +100,7 @@ namespace openssl {
                                   serverSocketFactory(),
                                   random(),
                                   password(),
+                                  sessionCache(),
                                   openSSLContext(NULL) {
 
             ContextData::locks = new Mutex[size];
@@ -203,6 +206,12 @@ void OpenSSLContextSpi::providerInit( SecureRandom* random ) {
         SSL_CTX_set_options( this->data->openSSLContext, SSL_OP_ALL | SSL_OP_NO_SSLv2 );
         SSL_CTX_set_mode( this->data->openSSLContext, SSL_MODE_AUTO_RETRY );
 
+        // Server side sessions are cached by OpenSSL so that clients can resume them, client
+        // side sessions are kept in our own cache keyed by the peer, see OpenSSLSessionCache.
+        static const unsigned char sessionIdContext[] = "decaf";
+        SSL_CTX_set_session_cache_mode( this->data->openSSLContext, SSL_SESS_CACHE_SERVER );
+        SSL_CTX_set_session_id_context( this->data->openSSLContext, sessionIdContext, sizeof( sessionIdContext ) - 1 );
+
         // The Password Callback for cases where we need to open a Cert.
         SSL_CTX_set_default_passwd_cb( this->data->openSSLContext, &ContextData::passwordCallback );
         SSL_CTX_set_default_passwd_cb_userdata( this->data->openSSLContext, (void*)this->data );
@@ -313,3 +322,9 @@ void* OpenSSLContextSpi::getOpenSSLCtx() {
 
     return (void*)this->data->openSSLContext;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache* OpenSSLContextSpi::getSessionCache() {
+
+    return &this->data->sessionCache;
+}
@@ -29,6 +29,7 @@ namespace ssl {
 namespace openssl {
 
     class ContextData;
+    class OpenSSLSessionCache;
 
     /**
      * Provides an SSLContext that wraps the OpenSSL API.
@@ -74,6 +75,7 @@ namespace openssl {
         std::vector<std::string> getDefaultCipherSuites();
         std::vector<std::string> getSupportedCipherSuites();
         void* getOpenSSLCtx();
+        OpenSSLSessionCache* getSessionCache();
 
     };
 
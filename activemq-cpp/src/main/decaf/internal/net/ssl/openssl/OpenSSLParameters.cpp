@@ -36,11 +36,14 @@ using namespace decaf::internal::net::ssl::openssl;
 #ifdef HAVE_OPENSSL
 
 ////////////////////////////////////////////////////////////////////////////////
-OpenSSLParameters::OpenSSLParameters(SSL_CTX* context) : needClientAuth(false),
+OpenSSLParameters::OpenSSLParameters(SSL_CTX* context, OpenSSLSessionCache* sessionCache) :
+                                                         needClientAuth(false),
                                                          wantClientAuth(false),
                                                          useClientMode(true),
+                                                         useKernelTLS(false),
                                                          context(context),
                                                          ssl(NULL),
+                                                         sessionCache(sessionCache),
                                                          enabledCipherSuites(),
                                                          enabledProtocols(),
                                                          serverNames() {
@@ -115,7 +118,7 @@ OpenSSLParameters* OpenSSLParameters::clone() const {
 
 #ifdef HAVE_OPENSSL
 
-    std::auto_ptr<OpenSSLParameters> cloned( new OpenSSLParameters( this->context ) );
+    std::auto_ptr<OpenSSLParameters> cloned( new OpenSSLParameters( this->context, this->sessionCache ) );
 
     cloned->enabledProtocols = this->enabledProtocols;
     cloned->enabledCipherSuites = this->enabledCipherSuites;
@@ -123,6 +126,7 @@ OpenSSLParameters* OpenSSLParameters::clone() const {
     cloned->needClientAuth = this->needClientAuth;
     cloned->wantClientAuth = this->wantClientAuth;
     cloned->useClientMode = this->useClientMode;
+    cloned->useKernelTLS = this->useKernelTLS;
 
     return cloned.release();
 
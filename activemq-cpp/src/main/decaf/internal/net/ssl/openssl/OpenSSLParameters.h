@@ -33,6 +33,8 @@ namespace net {
 namespace ssl {
 namespace openssl {
 
+    class OpenSSLSessionCache;
+
     /**
      * Container class for parameters that are Common to OpenSSL socket classes.
      *
@@ -44,12 +46,15 @@ namespace openssl {
         bool needClientAuth;
         bool wantClientAuth;
         bool useClientMode;
+        bool useKernelTLS;
 
 #ifdef HAVE_OPENSSL
         SSL_CTX* context;
         SSL* ssl;
 #endif
 
+        OpenSSLSessionCache* sessionCache;
+
         std::vector<std::string> enabledCipherSuites;
         std::vector<std::string> enabledProtocols;
         std::vector<std::string> serverNames;
@@ -62,7 +67,7 @@ namespace openssl {
     public:
 
 #ifdef HAVE_OPENSSL
-        OpenSSLParameters(SSL_CTX* context);
+        OpenSSLParameters(SSL_CTX* context, OpenSSLSessionCache* sessionCache = NULL);
 #endif
 
         virtual ~OpenSSLParameters();
@@ -93,6 +98,14 @@ namespace openssl {
             this->useClientMode = value;
         }
 
+        bool getUseKernelTLS() const {
+            return this->useKernelTLS;
+        }
+
+        void setUseKernelTLS( bool value ) {
+            this->useKernelTLS = value;
+        }
+
         std::vector<std::string> getSupportedCipherSuites() const;
 
         std::vector<std::string> getSupportedProtocols() const;
@@ -107,6 +120,14 @@ namespace openssl {
 
         std::vector<std::string> getServerNames() const;
 
+        /**
+         * @return the cache that client sockets store their sessions in for resumption
+         *         on later connects to the same peer, or NULL if sessions aren't cached.
+         */
+        OpenSSLSessionCache* getSessionCache() const {
+            return this->sessionCache;
+        }
+
         void setServerNames(const std::vector<std::string>& serverNames);
 
 #ifdef HAVE_OPENSSL
@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenSSLSessionCache.h"
+
+#include <decaf/lang/Exception.h>
+
+#include <time.h>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::ssl;
+using namespace decaf::internal::net::ssl::openssl;
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache::OpenSSLSessionCache() :
+#ifdef HAVE_OPENSSL
+    sessions(),
+#endif
+    lock() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLSessionCache::~OpenSSLSessionCache() {
+    try {
+        this->clear();
+    }
+    DECAF_CATCH_NOTHROW(Exception)
+    DECAF_CATCHALL_NOTHROW()
+}
+
+#ifdef HAVE_OPENSSL
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenSSLSessionCache::resume(const std::string& key, SSL* ssl) {
+
+    if (ssl == NULL) {
+        return false;
+    }
+
+    synchronized(&this->lock) {
+
+        std::map<std::string, SSL_SESSION*>::iterator iter = this->sessions.find(key);
+        if (iter == this->sessions.end()) {
+            return false;
+        }
+
+        SSL_SESSION* session = iter->second;
+
+        // The server would refuse an expired session anyway, don't bother offering it.
+        long expires = SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+        if (expires < (long) ::time(NULL)) {
+            SSL_SESSION_free(session);
+            this->sessions.erase(iter);
+            return false;
+        }
+
+        // The SSL object takes its own reference to the session.
+        return SSL_set_session(ssl, session) == 1;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::store(const std::string& key, SSL* ssl) {
+
+    if (ssl == NULL) {
+        return;
+    }
+
+    SSL_SESSION* session = SSL_get1_session(ssl);
+    if (session == NULL) {
+        return;
+    }
+
+    synchronized(&this->lock) {
+
+        std::map<std::string, SSL_SESSION*>::iterator iter = this->sessions.find(key);
+        if (iter != this->sessions.end()) {
+
+            if (iter->second == session) {
+                // Already stored, drop the extra reference we just took.
+                SSL_SESSION_free(session);
+                return;
+            }
+
+            SSL_SESSION_free(iter->second);
+            iter->second = session;
+        } else {
+            this->sessions.insert(std::make_pair(key, session));
+        }
+    }
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::remove(const std::string& key DECAF_UNUSED) {
+
+#ifdef HAVE_OPENSSL
+    synchronized(&this->lock) {
+
+        std::map<std::string, SSL_SESSION*>::iterator iter = this->sessions.find(key);
+        if (iter != this->sessions.end()) {
+            SSL_SESSION_free(iter->second);
+            this->sessions.erase(iter);
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSessionCache::clear() {
+
+#ifdef HAVE_OPENSSL
+    synchronized(&this->lock) {
+
+        std::map<std::string, SSL_SESSION*>::iterator iter = this->sessions.begin();
+        for (; iter != this->sessions.end(); ++iter) {
+            SSL_SESSION_free(iter->second);
+        }
+
+        this->sessions.clear();
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenSSLSessionCache::size() const {
+
+#ifdef HAVE_OPENSSL
+    synchronized(&this->lock) {
+        return (int) this->sessions.size();
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_
+#define _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <map>
+#include <string>
+
+#ifdef HAVE_OPENSSL
+#include <openssl/ssl.h>
+#endif
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace ssl {
+namespace openssl {
+
+    /**
+     * Client side cache of the SSL sessions negotiated with remote peers.  A session is
+     * stored under a key naming the peer, typically its "host:port", once a handshake with
+     * that peer completes.  The next socket that connects to the same peer offers the
+     * stored session, either by its session ID or as a session ticket, so the server can
+     * resume it with an abbreviated handshake instead of a full key exchange.
+     *
+     * The cache holds one reference to each stored session, expired sessions are dropped
+     * when they are looked up.  All methods are thread safe.
+     *
+     * @since 3.9
+     */
+    class DECAF_API OpenSSLSessionCache {
+    private:
+
+#ifdef HAVE_OPENSSL
+        std::map<std::string, SSL_SESSION*> sessions;
+#endif
+
+        mutable decaf::util::concurrent::Mutex lock;
+
+    private:
+
+        OpenSSLSessionCache(const OpenSSLSessionCache&);
+        OpenSSLSessionCache& operator=(const OpenSSLSessionCache&);
+
+    public:
+
+        OpenSSLSessionCache();
+
+        virtual ~OpenSSLSessionCache();
+
+#ifdef HAVE_OPENSSL
+
+        /**
+         * Sets the session stored for the given key on the SSL object so that its next
+         * handshake attempts to resume it, does nothing when no usable session is stored.
+         *
+         * @param key
+         *      The key naming the peer the SSL object is about to connect to.
+         * @param ssl
+         *      The SSL object whose handshake has not yet started.
+         *
+         * @return true if a session was set on the SSL object.
+         */
+        bool resume(const std::string& key, SSL* ssl);
+
+        /**
+         * Stores the current session of the SSL object under the given key, replacing any
+         * session already stored for it.  Does nothing if the SSL object has no session.
+         *
+         * @param key
+         *      The key naming the peer the SSL object is connected to.
+         * @param ssl
+         *      The SSL object whose handshake has completed.
+         */
+        void store(const std::string& key, SSL* ssl);
+
+#endif
+
+        /**
+         * Drops the session stored for the given key, if any.
+         *
+         * @param key
+         *      The key naming the peer whose session is to be removed.
+         */
+        void remove(const std::string& key);
+
+        /**
+         * Drops all the stored sessions.
+         */
+        void clear();
+
+        /**
+         * @return the number of sessions currently stored.
+         */
+        int size() const;
+
+    };
+
+}}}}}
+
+#endif /* _DECAF_INTERNAL_NET_SSL_OPENSSL_OPENSSLSESSIONCACHE_H_ */
@@ -23,17 +23,25 @@
     #include <openssl/x509.h>
     #include <openssl/x509v3.h>
     #include <openssl/bio.h>
+
+    // Kernel TLS is available from OpenSSL 3.0 when the library was built with it.
+    #if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+        #define DECAF_OPENSSL_HAVE_KTLS
+    #endif
 #endif
 
 #include <decaf/net/SocketImpl.h>
 #include <decaf/io/IOException.h>
 #include <decaf/net/SocketException.h>
 #include <decaf/lang/Boolean.h>
+#include <decaf/lang/Integer.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 #include <decaf/internal/util/StringUtils.h>
 #include <decaf/internal/net/SocketFileDescriptor.h>
+#include <decaf/internal/net/tcp/TcpSocket.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLParameters.h>
+#include <decaf/internal/net/ssl/openssl/OpenSSLSessionCache.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketException.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketInputStream.h>
 #include <decaf/internal/net/ssl/openssl/OpenSSLSocketOutputStream.h>
@@ -49,6 +57,7 @@ using namespace decaf::util::concurrent;
 using namespace decaf::internal;
 using namespace decaf::internal::util;
 using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
 using namespace decaf::internal::net::ssl;
 using namespace decaf::internal::net::ssl::openssl;
 
@@ -62,17 +71,32 @@ namespace openssl {
     class SocketData {
     public:
 
+        // Largest amount of data OpenSSL places in a single TLS record.
+        static const int MAX_RECORD_SIZE = 16384;
+
         bool handshakeStarted;
         bool handshakeCompleted;
+        bool sessionCached;
+        bool kernelTLSSend;
         std::string commonName;
 
+        // Names the peer in the session cache, "host:port" of the connect.
+        std::string sessionKey;
+
+        // Staging buffer used to pack small writes into full TLS records.
+        std::vector<unsigned char> recordBuffer;
+
         Mutex handshakeLock;
 
     public:
 
         SocketData() : handshakeStarted(false),
                        handshakeCompleted(false),
+                       sessionCached(false),
+                       kernelTLSSend(false),
                        commonName(),
+                       sessionKey(),
+                       recordBuffer(),
                        handshakeLock() {
         }
 
@@ -190,6 +214,10 @@ void OpenSSLSocket::connect(const std::string& host, int port, int timeout) {
             // Later when startHandshake is called we will check for this common name
             // in the provided certificate
             this->data->commonName = host;
+
+            // Sessions negotiated with this peer are cached under this key so that
+            // reconnects to it can resume them.
+            this->data->sessionKey = host + ":" + Integer::toString(port);
         }
 #else
         throw SocketException( __FILE__, __LINE__, "Not Supported" );
@@ -210,6 +238,14 @@ void OpenSSLSocket::close() {
             return;
         }
 
+#ifdef HAVE_OPENSSL
+        // Servers may send session tickets after the handshake, so store the session
+        // again now to pick up the latest one for the next connect.
+        if (this->data->sessionCached) {
+            this->parameters->getSessionCache()->store(this->data->sessionKey, this->parameters->getSSL());
+        }
+#endif
+
         SSLSocket::close();
 
         if (this->input != NULL) {
@@ -351,6 +387,15 @@ void OpenSSLSocket::startHandshake() {
 
             bool peerVerifyDisabled = Boolean::parseBoolean(System::getProperty("decaf.net.ssl.disablePeerVerification", "false"));
 
+#ifdef DECAF_OPENSSL_HAVE_KTLS
+            // OpenSSL hands the negotiated keys to the kernel once the handshake is done if
+            // the kernel supports kernel TLS for the chosen cipher, otherwise it carries on
+            // encrypting in user space.
+            if (this->parameters->getUseKernelTLS()) {
+                SSL_set_options(this->parameters->getSSL(), SSL_OP_ENABLE_KTLS);
+            }
+#endif
+
             if (this->parameters->getUseClientMode()) {
 
                 // Since we are a client we want to enforce peer verification, we set a
@@ -367,6 +412,19 @@ void OpenSSLSocket::startHandshake() {
                     SSL_set_tlsext_host_name(this->parameters->getSSL(), serverName.c_str());
                 }
 
+                // Offer the last session negotiated with this peer so that the server can
+                // resume it rather than going through a full handshake.
+                OpenSSLSessionCache* cache = NULL;
+                if (!this->data->sessionKey.empty() &&
+                    !Boolean::parseBoolean(System::getProperty("decaf.net.ssl.disableSessionResumption", "false"))) {
+
+                    cache = this->parameters->getSessionCache();
+                }
+
+                if (cache != NULL) {
+                    cache->resume(this->data->sessionKey, this->parameters->getSSL());
+                }
+
                 int result = SSL_connect(this->parameters->getSSL());
 
                 // Checks the error status, when things go right we still perform a deeper
@@ -378,10 +436,18 @@ void OpenSSLSocket::startHandshake() {
                     if (!peerVerifyDisabled) {
                         verifyServerCert(this->data->commonName);
                     }
+                    if (cache != NULL) {
+                        cache->store(this->data->sessionKey, this->parameters->getSSL());
+                        this->data->sessionCached = true;
+                    }
                     break;
                 case SSL_ERROR_SSL:
                 case SSL_ERROR_ZERO_RETURN:
                 case SSL_ERROR_SYSCALL:
+                    // Don't offer the same session again if it was what the server choked on.
+                    if (cache != NULL) {
+                        cache->remove(this->data->sessionKey);
+                    }
                     SSLSocket::close();
                     throw OpenSSLSocketException(__FILE__, __LINE__);
                 }
@@ -413,6 +479,12 @@ void OpenSSLSocket::startHandshake() {
                 }
             }
 
+#ifdef DECAF_OPENSSL_HAVE_KTLS
+            if (this->parameters->getUseKernelTLS()) {
+                this->data->kernelTLSSend = BIO_get_ktls_send(SSL_get_wbio(this->parameters->getSSL())) != 0;
+            }
+#endif
+
             this->data->handshakeCompleted = true;
         }
 #else
@@ -461,6 +533,44 @@ bool OpenSSLSocket::getWantClientAuth() const {
     return this->parameters->getWantClientAuth();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSocket::setUseKernelTLS(bool value) {
+
+    synchronized( &( this->data->handshakeLock ) ) {
+        if (this->data->handshakeStarted) {
+            throw IllegalArgumentException(__FILE__, __LINE__,
+                "Handshake has already been started cannot change kernel TLS mode.");
+        }
+
+        this->parameters->setUseKernelTLS(value);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenSSLSocket::getUseKernelTLS() const {
+
+#ifdef DECAF_OPENSSL_HAVE_KTLS
+    return this->parameters->getUseKernelTLS();
+#else
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool OpenSSLSocket::isKernelTLSActive() const {
+    return this->data->handshakeCompleted && this->data->kernelTLSSend;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocket* OpenSSLSocket::getKernelTLSSocket() const {
+
+    if (!this->isKernelTLSActive()) {
+        return NULL;
+    }
+
+    return dynamic_cast<TcpSocket*>(this->impl);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int OpenSSLSocket::read(unsigned char* buffer, int size, int offset, int length) {
 
@@ -566,33 +676,122 @@ void OpenSSLSocket::write(const unsigned char* buffer, int size, int offset, int
             this->startHandshake();
         }
 
-        int remaining = length;
+        // With kernel TLS the socket takes plain data and the kernel builds the records.
+        TcpSocket* kernelTLSSocket = this->getKernelTLSSocket();
+        if (kernelTLSSocket != NULL) {
+            kernelTLSSocket->write(buffer, size, offset, length);
+            return;
+        }
 
-        while (remaining > 0 && !isClosed()) {
+        this->writeRecords(buffer + offset, length);
+#else
+        throw SocketException( __FILE__, __LINE__, "Not Supported" );
+#endif
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
 
-            int written = SSL_write(this->parameters->getSSL(), buffer + offset, remaining);
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSocket::writeArrays(const unsigned char* const* buffers DECAF_UNUSED, const int* lengths DECAF_UNUSED, int count DECAF_UNUSED) {
 
-            switch (SSL_get_error(this->parameters->getSSL(), written)) {
-            case SSL_ERROR_NONE:
-                offset += written;
-                remaining -= written;
-                break;
-            case SSL_ERROR_ZERO_RETURN:
-                throw SocketException(__FILE__, __LINE__, "The connection was broken unexpectedly.");
-            default:
-                throw OpenSSLSocketException(__FILE__, __LINE__);
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__,
+                "OpenSSLSocket::write - This Stream has been closed.");
+        }
+
+#ifdef HAVE_OPENSSL
+
+        if (!this->data->handshakeCompleted) {
+            this->startHandshake();
+        }
+
+        // The kernel builds the records itself, so the arrays can go down in vectored sends.
+        TcpSocket* kernelTLSSocket = this->getKernelTLSSocket();
+        if (kernelTLSSocket != NULL) {
+            kernelTLSSocket->writeArrays(buffers, lengths, count);
+            return;
+        }
+
+        std::vector<unsigned char>& record = this->data->recordBuffer;
+        if (record.capacity() < (std::size_t) SocketData::MAX_RECORD_SIZE) {
+            record.reserve(SocketData::MAX_RECORD_SIZE);
+        }
+
+        record.clear();
+
+        for (int i = 0; i < count && !isClosed(); ++i) {
+
+            const unsigned char* buffer = buffers[i];
+            int remaining = lengths[i];
+
+            while (remaining > 0) {
+
+                // Nothing pending and at least a full record's worth left in this buffer,
+                // SSL_write splits it into full records itself so skip the copy.
+                if (record.empty() && remaining >= SocketData::MAX_RECORD_SIZE) {
+                    int direct = remaining - (remaining % SocketData::MAX_RECORD_SIZE);
+                    this->writeRecords(buffer, direct);
+                    buffer += direct;
+                    remaining -= direct;
+                    continue;
+                }
+
+                int space = SocketData::MAX_RECORD_SIZE - (int) record.size();
+                int chunk = remaining < space ? remaining : space;
+
+                record.insert(record.end(), buffer, buffer + chunk);
+                buffer += chunk;
+                remaining -= chunk;
+
+                if ((int) record.size() == SocketData::MAX_RECORD_SIZE) {
+                    this->writeRecords(&record[0], (int) record.size());
+                    record.clear();
+                }
             }
         }
+
+        if (!record.empty()) {
+            this->writeRecords(&record[0], (int) record.size());
+            record.clear();
+        }
 #else
         throw SocketException( __FILE__, __LINE__, "Not Supported" );
 #endif
     }
     DECAF_CATCH_RETHROW(IOException)
-    DECAF_CATCH_RETHROW(NullPointerException)
-    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSocket::writeRecords(const unsigned char* buffer DECAF_UNUSED, int length DECAF_UNUSED) {
+
+#ifdef HAVE_OPENSSL
+    int offset = 0;
+    int remaining = length;
+
+    while (remaining > 0 && !isClosed()) {
+
+        int written = SSL_write(this->parameters->getSSL(), buffer + offset, remaining);
+
+        switch (SSL_get_error(this->parameters->getSSL(), written)) {
+        case SSL_ERROR_NONE:
+            offset += written;
+            remaining -= written;
+            break;
+        case SSL_ERROR_ZERO_RETURN:
+            throw SocketException(__FILE__, __LINE__, "The connection was broken unexpectedly.");
+        default:
+            throw OpenSSLSocketException(__FILE__, __LINE__);
+        }
+    }
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int OpenSSLSocket::available() {
 
@@ -28,6 +28,9 @@
 namespace decaf {
 namespace internal {
 namespace net {
+namespace tcp {
+    class TcpSocket;
+}
 namespace ssl {
 namespace openssl {
 
@@ -193,6 +196,22 @@ namespace openssl {
          */
         virtual bool getWantClientAuth() const;
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual void setUseKernelTLS(bool value);
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool getUseKernelTLS() const;
+
+        /**
+         * @return true if the handshake has completed and outgoing data is being encrypted
+         *         by the kernel rather than by OpenSSL.
+         */
+        bool isKernelTLSActive() const;
+
     public:
 
         /**
@@ -233,6 +252,23 @@ namespace openssl {
          */
         void write(const unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Writes the contents of several buffers to the Socket in order.  Small buffers are
+         * packed together so that they share TLS records instead of each one being sent in
+         * a record of its own, buffers too large to be packed are written directly.  The
+         * arguments are expected to have been validated by the caller.
+         *
+         * @param buffers
+         *      The buffers to write to the socket.
+         * @param lengths
+         *      The number of bytes to write from each of the buffers.
+         * @param count
+         *      The number of buffers passed.
+         *
+         * @throw IOException if an I/O error occurs during the write.
+         */
+        void writeArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
         /**
          * Gets the number of bytes in the Socket buffer that can be read without blocking.
          *
@@ -248,6 +284,13 @@ namespace openssl {
         // its really valid.
         void verifyServerCert(const std::string& serverName);
 
+        // Hands the given bytes to SSL_write until all of them have been written.
+        void writeRecords(const unsigned char* buffer, int length);
+
+        // Returns the plain TCP socket beneath this one once kernel TLS has taken over
+        // encryption of outgoing data, NULL while OpenSSL still does it.
+        decaf::internal::net::tcp::TcpSocket* getKernelTLSSocket() const;
+
     public:
 
         using decaf::net::Socket::connect;
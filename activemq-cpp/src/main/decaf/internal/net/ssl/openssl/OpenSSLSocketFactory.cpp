@@ -74,7 +74,7 @@ Socket* OpenSSLSocketFactory::createSocket() {
 #ifdef HAVE_OPENSSL
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
-        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx, this->parent->getSessionCache() ) );
         return new OpenSSLSocket( parameters.release() );
 #else
         return NULL;
@@ -93,7 +93,7 @@ Socket* OpenSSLSocketFactory::createSocket( const decaf::net::InetAddress* host,
 #ifdef HAVE_OPENSSL
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
-        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx, this->parent->getSessionCache() ) );
         std::auto_ptr<SSLSocket> socket( new OpenSSLSocket( parameters.release(), host, port ) );
         return socket.release();
 #else
@@ -114,7 +114,7 @@ Socket* OpenSSLSocketFactory::createSocket( const decaf::net::InetAddress* host,
 #ifdef HAVE_OPENSSL
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
-        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx, this->parent->getSessionCache() ) );
         std::auto_ptr<SSLSocket> socket(
             new OpenSSLSocket( parameters.release(), host, port, ifAddress, localPort ) );
         return socket.release();
@@ -135,7 +135,7 @@ Socket* OpenSSLSocketFactory::createSocket( const std::string& hostname, int por
 #ifdef HAVE_OPENSSL
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
-        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx, this->parent->getSessionCache() ) );
         std::auto_ptr<SSLSocket> socket( new OpenSSLSocket( parameters.release(), hostname, port ) );
         return socket.release();
 #else
@@ -156,7 +156,7 @@ Socket* OpenSSLSocketFactory::createSocket( const std::string& hostname, int por
 #ifdef HAVE_OPENSSL
         // Create a new SSL object for the Socket then create a new unconnected Socket.
         SSL_CTX* ctx = static_cast<SSL_CTX*>( this->parent->getOpenSSLCtx() );
-        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx ) );
+        std::auto_ptr<OpenSSLParameters> parameters( new OpenSSLParameters( ctx, this->parent->getSessionCache() ) );
         std::auto_ptr<SSLSocket> socket(
             new OpenSSLSocket( parameters.release(), hostname, port, ifAddress, localPort ) );
         return socket.release();
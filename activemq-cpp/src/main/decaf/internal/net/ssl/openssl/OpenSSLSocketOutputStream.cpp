@@ -95,3 +95,25 @@ void OpenSSLSocketOutputStream::doWriteArrayBounded( const unsigned char* buffer
     DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
     DECAF_CATCHALL_THROW( IOException )
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLSocketOutputStream::doWriteArrays( const unsigned char* const* buffers, const int* lengths, int count ) {
+
+    try{
+
+        if( checkArrays( buffers, lengths, count ) == 0 ) {
+            return;
+        }
+
+        if( closed ) {
+            throw IOException(
+                __FILE__, __LINE__, "This Stream has been closed." );
+        }
+
+        this->socket->writeArrays( buffers, lengths, count );
+    }
+    DECAF_CATCH_RETHROW( IOException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCHALL_THROW( IOException )
+}
@@ -60,6 +60,8 @@ namespace openssl {
 
         virtual void doWriteArrayBounded( const unsigned char* buffer, int size, int offset, int length );
 
+        virtual void doWriteArrays( const unsigned char* const* buffers, const int* lengths, int count );
+
     };
 
 }}}}}
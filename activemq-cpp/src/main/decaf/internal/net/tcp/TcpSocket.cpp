@@ -23,6 +23,7 @@
 
 #include <decaf/net/SocketError.h>
 #include <decaf/net/SocketOptions.h>
+#include <decaf/net/InetAddress.h>
 #include <decaf/lang/Character.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/util/concurrent/atomic/AtomicBoolean.h>
@@ -33,10 +34,16 @@
 
 #include <apr_portable.h>
 #include <apr_network_io.h>
+#include <apr_poll.h>
+
+#define APR_WANT_IOVEC
+#include <apr_want.h>
 
 #if !defined(HAVE_WINSOCK2_H)
     #include <sys/select.h>
     #include <sys/socket.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
 #else
     #include <Winsock2.h>
 #endif
@@ -85,6 +92,11 @@ namespace tcp {
         int trafficClass;
         int soTimeout;
         int soLinger;
+        bool nonBlocking;
+        bool quickAck;
+
+        // How long in microseconds a blocked write waits before checking for a close.
+        static const apr_interval_time_t WRITE_WAIT_INTERVAL = 100 * 1000;
 
         TcpSocketImpl() : apr_pool(),
                           socketHandle(NULL),
@@ -99,12 +111,76 @@ namespace tcp {
                           connected(false),
                           trafficClass(0),
                           soTimeout(-1),
-                          soLinger(-1) {
+                          soLinger(-1),
+                          nonBlocking(false),
+                          quickAck(false) {
         }
     };
 
 }}}}
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Finds the native level and name of the options APR has no equivalent for, returns
+    // false for any other option and throws if the platform doesn't support the option.
+    bool findNativeOption(int option, int& level, int& name) {
+
+        if (option == SocketOptions::SOCKET_OPTION_BUSY_POLL) {
+#ifdef SO_BUSY_POLL
+            level = SOL_SOCKET;
+            name = SO_BUSY_POLL;
+            return true;
+#endif
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK) {
+#ifdef TCP_QUICKACK
+            level = IPPROTO_TCP;
+            name = TCP_QUICKACK;
+            return true;
+#endif
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT) {
+#ifdef TCP_NOTSENT_LOWAT
+            level = IPPROTO_TCP;
+            name = TCP_NOTSENT_LOWAT;
+            return true;
+#endif
+        } else if (option == SocketOptions::SOCKET_OPTION_MAX_PACING_RATE) {
+#ifdef SO_MAX_PACING_RATE
+            level = SOL_SOCKET;
+            name = SO_MAX_PACING_RATE;
+            return true;
+#endif
+        } else if (option == SocketOptions::SOCKET_OPTION_TCP_USER_TIMEOUT) {
+#ifdef TCP_USER_TIMEOUT
+            level = IPPROTO_TCP;
+            name = TCP_USER_TIMEOUT;
+            return true;
+#endif
+        } else {
+            return false;
+        }
+
+        throw SocketException(__FILE__, __LINE__, "Socket Option is not supported on this platform.");
+    }
+
+    bool setNativeOption(apr_socket_t* socket, int level, int name, int value) {
+        apr_os_sock_t oss;
+        apr_os_sock_get(&oss, socket);
+        return ::setsockopt(oss, level, name, (const char*) &value, sizeof(value)) == 0;
+    }
+
+    bool getNativeOption(apr_socket_t* socket, int level, int name, int& value) {
+        apr_os_sock_t oss;
+        apr_os_sock_get(&oss, socket);
+#if defined(HAVE_WINSOCK2_H)
+        int length = sizeof(value);
+#else
+        socklen_t length = sizeof(value);
+#endif
+        return ::getsockopt(oss, level, name, (char*) &value, &length) == 0;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 TcpSocket::TcpSocket() : impl(new TcpSocketImpl) {
 }
@@ -148,24 +224,30 @@ void TcpSocket::create() {
 
     try {
 
-        if (this->impl->socketHandle != NULL) {
-            throw IOException(__FILE__, __LINE__, "The System level socket has already been created.");
-        }
-
-        // Create the actual socket.
-        checkResult(apr_socket_create(&this->impl->socketHandle,
-            AF_INET, SOCK_STREAM, APR_PROTO_TCP, this->impl->apr_pool.getAprPool()));
-
-        // Initialize the Socket's FileDescriptor
-        apr_os_sock_t osSocket = -1;
-        apr_os_sock_get(&osSocket, this->impl->socketHandle);
-        this->fd = new SocketFileDescriptor(osSocket);
+        createSocket(AF_INET, APR_PROTO_TCP);
     }
     DECAF_CATCH_RETHROW(decaf::io::IOException)
     DECAF_CATCH_EXCEPTION_CONVERT(Exception, decaf::io::IOException)
     DECAF_CATCHALL_THROW(decaf::io::IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::createSocket(int family, int protocol) {
+
+    if (this->impl->socketHandle != NULL) {
+        throw IOException(__FILE__, __LINE__, "The System level socket has already been created.");
+    }
+
+    // Create the actual socket.
+    checkResult(apr_socket_create(&this->impl->socketHandle,
+        family, SOCK_STREAM, protocol, this->impl->apr_pool.getAprPool()));
+
+    // Initialize the Socket's FileDescriptor
+    apr_os_sock_t osSocket = -1;
+    apr_os_sock_get(&osSocket, this->impl->socketHandle);
+    this->fd = new SocketFileDescriptor(osSocket);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpSocket::accept(SocketImpl* socket) {
 
@@ -268,18 +350,7 @@ void TcpSocket::bind(const std::string& ipaddress, int port) {
             throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
         }
 
-        // Set the socket to reuse the address and default as blocking with no timeout.
-        apr_socket_opt_set(impl->socketHandle, APR_SO_REUSEADDR, 1);
-        apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 0);
-        apr_socket_timeout_set(impl->socketHandle, -1);
-
-        // Bind to the Socket, this may be where we find out if the port is in use.
-        result = apr_socket_bind(impl->socketHandle, impl->localAddress);
-
-        if (result != APR_SUCCESS) {
-            close();
-            throw SocketException(__FILE__, __LINE__, "ServerSocket::bind - %s", SocketError::getErrorString().c_str());
-        }
+        bindAddress(impl->localAddress);
 
         // Only incur the overhead of a lookup if we don't already know the local port.
         if (port != 0) {
@@ -295,6 +366,25 @@ void TcpSocket::bind(const std::string& ipaddress, int port) {
     DECAF_CATCHALL_THROW(decaf::io::IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::bindAddress(apr_sockaddr_t* address) {
+
+    impl->localAddress = address;
+
+    // Set the socket to reuse the address and default as blocking with no timeout.
+    apr_socket_opt_set(impl->socketHandle, APR_SO_REUSEADDR, 1);
+    apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 0);
+    apr_socket_timeout_set(impl->socketHandle, -1);
+
+    // Bind to the Socket, this may be where we find out if the port is in use.
+    apr_status_t result = apr_socket_bind(impl->socketHandle, address);
+
+    if (result != APR_SUCCESS) {
+        close();
+        throw SocketException(__FILE__, __LINE__, "ServerSocket::bind - %s", SocketError::getErrorString().c_str());
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TcpSocket::connect(const std::string& hostname, int port, int timeout) {
 
@@ -308,36 +398,21 @@ void TcpSocket::connect(const std::string& hostname, int port, int timeout) {
             throw IOException(__FILE__, __LINE__, "The socket was not yet created.");
         }
 
-        // Create the Address data
-        checkResult(apr_sockaddr_info_get(&impl->remoteAddress, hostname.c_str(), APR_INET, (apr_port_t) port, 0, impl->apr_pool.getAprPool()));
-
-        int oldNonblockSetting = 0;
-        apr_interval_time_t oldTimeoutSetting = 0;
-
-        // Record the old settings.
-        apr_socket_opt_get(impl->socketHandle, APR_SO_NONBLOCK, &oldNonblockSetting);
-        apr_socket_timeout_get(impl->socketHandle, &oldTimeoutSetting);
-
-        // Temporarily make it what we want, blocking.
-        apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 0);
-
-        // Timeout and non-timeout case require very different logic.
-        if (timeout <= 0) {
-            apr_socket_timeout_set(impl->socketHandle, -1);
-        } else {
-            apr_socket_timeout_set(impl->socketHandle, timeout * 1000);
+        // Create the Address data from the cached lookup of the host, only an IPv6 address
+        // leaves the resolving to APR as this socket is IPv4.
+        std::string address = hostname;
+        ArrayPointer<unsigned char> bytes = InetAddress::getByName(hostname).getAddress();
+        if (bytes.length() == 4) {
+            address = InetAddress::getByAddress(bytes.get(), 4).getHostAddress();
         }
 
-        // try to Connect to the provided address.
-        checkResult (apr_socket_connect(impl->socketHandle, impl->remoteAddress) );
+        apr_sockaddr_t* remoteAddress = NULL;
+        checkResult(apr_sockaddr_info_get(&remoteAddress, address.c_str(), APR_INET, (apr_port_t) port, 0, impl->apr_pool.getAprPool()));
 
-        // Now that we are connected, we want to go back to old settings.
-        apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, oldNonblockSetting);
-        apr_socket_timeout_set(impl->socketHandle, oldTimeoutSetting);
+        connectAddress(remoteAddress, timeout);
 
         // Now that we connected, cache the port value for later lookups.
         this->port = port;
-        this->impl->connected = true;
 
     } catch (IOException& ex) {
         ex.setMark(__FILE__, __LINE__);
@@ -368,6 +443,42 @@ void TcpSocket::connect(const std::string& hostname, int port, int timeout) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::connectAddress(apr_sockaddr_t* address, int timeout) {
+
+    if (this->impl->socketHandle == NULL) {
+        throw IOException(__FILE__, __LINE__, "The socket was not yet created.");
+    }
+
+    impl->remoteAddress = address;
+
+    int oldNonblockSetting = 0;
+    apr_interval_time_t oldTimeoutSetting = 0;
+
+    // Record the old settings.
+    apr_socket_opt_get(impl->socketHandle, APR_SO_NONBLOCK, &oldNonblockSetting);
+    apr_socket_timeout_get(impl->socketHandle, &oldTimeoutSetting);
+
+    // Temporarily make it what we want, blocking.
+    apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 0);
+
+    // Timeout and non-timeout case require very different logic.
+    if (timeout <= 0) {
+        apr_socket_timeout_set(impl->socketHandle, -1);
+    } else {
+        apr_socket_timeout_set(impl->socketHandle, timeout * 1000);
+    }
+
+    // try to Connect to the provided address.
+    checkResult(apr_socket_connect(impl->socketHandle, address));
+
+    // Now that we are connected, we want to go back to old settings.
+    apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, oldNonblockSetting);
+    apr_socket_timeout_set(impl->socketHandle, oldTimeoutSetting);
+
+    this->impl->connected = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string TcpSocket::getLocalAddress() const {
 
@@ -554,6 +665,19 @@ int TcpSocket::getOption(int option) const {
             return this->impl->soLinger;
         }
 
+        int level = 0;
+        int name = 0;
+
+        if (findNativeOption(option, level, name)) {
+
+            int nativeValue = 0;
+            if (!getNativeOption(impl->socketHandle, level, name, nativeValue)) {
+                throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+            }
+
+            return nativeValue;
+        }
+
         if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
             aprId = APR_SO_REUSEADDR;
         } else if (option == SocketOptions::SOCKET_OPTION_SNDBUF) {
@@ -592,6 +716,7 @@ void TcpSocket::setOption(int option, int value) {
             // Time in APR for sockets is in microseconds so multiply by 1000.
             checkResult(apr_socket_timeout_set(impl->socketHandle, value * 1000));
             this->impl->soTimeout = value;
+            this->impl->nonBlocking = false;
             return;
         } else if (option == SocketOptions::SOCKET_OPTION_LINGER) {
 
@@ -604,6 +729,22 @@ void TcpSocket::setOption(int option, int value) {
             return;
         }
 
+        int level = 0;
+        int name = 0;
+
+        if (findNativeOption(option, level, name)) {
+
+            if (!setNativeOption(impl->socketHandle, level, name, value)) {
+                throw SocketException(__FILE__, __LINE__, SocketError::getErrorString().c_str());
+            }
+
+            if (option == SocketOptions::SOCKET_OPTION_TCP_QUICKACK) {
+                this->impl->quickAck = value != 0;
+            }
+
+            return;
+        }
+
         if (option == SocketOptions::SOCKET_OPTION_REUSEADDR) {
             aprId = APR_SO_REUSEADDR;
         } else if (option == SocketOptions::SOCKET_OPTION_SNDBUF) {
@@ -674,6 +815,11 @@ int TcpSocket::read(unsigned char* buffer, int size, int offset, int length) {
         // size is the number of bytes actually read, can be <= bufferSize.
         result = apr_socket_recv(impl->socketHandle, (char*) buffer + offset, &aprSize);
 
+        // Nothing has arrived yet, which only happens when the socket is non-blocking.
+        if (APR_STATUS_IS_EAGAIN(result) && this->impl->nonBlocking && !isClosed()) {
+            return 0;
+        }
+
         // Check for EOF, on windows we only get size==0 so check that to, if we
         // were closed though then we throw an IOException so the caller knows we
         // aren't usable anymore.
@@ -691,6 +837,14 @@ int TcpSocket::read(unsigned char* buffer, int size, int offset, int length) {
                 "Socket Read Error - %s", SocketError::getErrorString().c_str());
         }
 
+        // The platform falls back to delayed ACKs on its own, turn quick ACKs back on.
+        if (this->impl->quickAck) {
+            int level = 0;
+            int name = 0;
+            findNativeOption(SocketOptions::SOCKET_OPTION_TCP_QUICKACK, level, name);
+            setNativeOption(impl->socketHandle, level, name, 1);
+        }
+
         return (int) aprSize;
     }
     DECAF_CATCH_RETHROW(IOException)
@@ -740,18 +894,21 @@ void TcpSocket::write(const unsigned char* buffer, int size, int offset, int len
 
         while (remaining > 0 && !isClosed()) {
 
-            // On input remaining is the bytes to send, after return remaining
-            // is the amount actually sent.
-            result = apr_socket_send(this->impl->socketHandle, (const char*) lbuffer, &remaining);
+            // On input sent is the bytes to send, after return sent is the
+            // amount actually sent.
+            apr_size_t sent = remaining;
+            result = apr_socket_send(this->impl->socketHandle, (const char*) lbuffer, &sent);
 
-            if (result != APR_SUCCESS || isClosed()) {
+            if (APR_STATUS_IS_EAGAIN(result) && this->impl->nonBlocking && !isClosed()) {
+                waitForWrite();
+            } else if (result != APR_SUCCESS || isClosed()) {
                 throw IOException(__FILE__, __LINE__,
                     "TcpSocketOutputStream::write - %s", SocketError::getErrorString().c_str());
             }
 
             // move us to next position to write, or maybe end.
-            lbuffer += remaining;
-            remaining = length - remaining;
+            lbuffer += sent;
+            remaining -= sent;
         }
     }
     DECAF_CATCH_RETHROW(IOException)
@@ -760,6 +917,74 @@ void TcpSocket::write(const unsigned char* buffer, int size, int offset, int len
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::writeArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    // Most platforms allow at least this many vectors in a single send.
+    static const int MAX_VECTORS = 64;
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpSocket::write - This Stream has been closed.");
+        }
+
+        // The buffer that is to be sent next and how much of it has gone already.
+        int index = 0;
+        apr_size_t offset = 0;
+
+        struct iovec vectors[MAX_VECTORS];
+
+        while (index < count && !isClosed()) {
+
+            apr_int32_t used = 0;
+            for (int i = index; i < count && used < MAX_VECTORS; ++i) {
+
+                apr_size_t skip = i == index ? offset : 0;
+                if ((apr_size_t) lengths[i] == skip) {
+                    continue;
+                }
+
+                vectors[used].iov_base = (char*) (buffers[i] + skip);
+                vectors[used].iov_len = (apr_size_t) lengths[i] - skip;
+                used++;
+            }
+
+            if (used == 0) {
+                break;
+            }
+
+            apr_size_t sent = 0;
+            apr_status_t result = apr_socket_sendv(this->impl->socketHandle, vectors, used, &sent);
+
+            if (APR_STATUS_IS_EAGAIN(result) && this->impl->nonBlocking && !isClosed()) {
+                waitForWrite();
+            } else if (result != APR_SUCCESS || isClosed()) {
+                throw IOException(__FILE__, __LINE__,
+                    "TcpSocketOutputStream::write - %s", SocketError::getErrorString().c_str());
+            }
+
+            // Skip over the buffers that were sent in full, the send may have stopped
+            // part way through one of them.
+            while (index < count) {
+
+                apr_size_t remaining = (apr_size_t) lengths[index] - offset;
+                if (sent < remaining) {
+                    offset += sent;
+                    break;
+                }
+
+                sent -= remaining;
+                offset = 0;
+                index++;
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool TcpSocket::isConnected() const {
     return this->impl->connected;
@@ -769,3 +994,76 @@ bool TcpSocket::isConnected() const {
 bool TcpSocket::isClosed() const {
     return this->impl->closed.get();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::setNonBlocking(bool value) {
+
+    try {
+
+        if (this->impl->socketHandle == NULL) {
+            throw IOException(__FILE__, __LINE__, "The socket was not yet created.");
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "The Socket is closed.");
+        }
+
+        if (value) {
+            // A zero timeout makes APR return EAGAIN rather than wait for the socket.
+            checkResult(apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 1));
+            checkResult(apr_socket_timeout_set(impl->socketHandle, 0));
+        } else {
+            checkResult(apr_socket_opt_set(impl->socketHandle, APR_SO_NONBLOCK, 0));
+            checkResult(apr_socket_timeout_set(impl->socketHandle,
+                impl->soTimeout > 0 ? (apr_interval_time_t) impl->soTimeout * 1000 : -1));
+        }
+
+        this->impl->nonBlocking = value;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocket::isNonBlocking() const {
+    return this->impl->nonBlocking;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+apr_pool_t* TcpSocket::getAprPool() const {
+    return this->impl->apr_pool.getAprPool();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+apr_socket_t* TcpSocket::getSocketHandle() const {
+    return this->impl->socketHandle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocket::waitForWrite() {
+
+    apr_pollfd_t descriptor;
+    descriptor.p = impl->apr_pool.getAprPool();
+    descriptor.desc_type = APR_POLL_SOCKET;
+    descriptor.reqevents = APR_POLLOUT;
+    descriptor.rtnevents = 0;
+    descriptor.desc.s = impl->socketHandle;
+    descriptor.client_data = NULL;
+
+    // Wake up now and then so that a close from another thread isn't missed, once
+    // closed the caller sees that and gives up on the write.
+    while (!isClosed()) {
+
+        apr_int32_t signalled = 0;
+        apr_status_t result = apr_poll(&descriptor, 1, &signalled, TcpSocketImpl::WRITE_WAIT_INTERVAL);
+
+        if (result == APR_SUCCESS && signalled > 0) {
+            return;
+        }
+
+        if (!APR_STATUS_IS_TIMEUP(result) && !APR_STATUS_IS_EINTR(result)) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpSocketOutputStream::write - %s", SocketError::getErrorString().c_str());
+        }
+    }
+}
@@ -28,6 +28,8 @@
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 
+#include <apr_network_io.h>
+
 namespace decaf {
 namespace internal {
 namespace net {
@@ -36,6 +38,7 @@ namespace tcp {
     class TcpSocketInputStream;
     class TcpSocketOutputStream;
     class TcpSocketImpl;
+    class TcpSocketPoller;
 
     /**
      * Platform-independent implementation of the socket interface.
@@ -45,6 +48,8 @@ namespace tcp {
 
         TcpSocketImpl* impl;
 
+        friend class TcpSocketPoller;
+
     private:
 
         TcpSocket(const TcpSocket&);
@@ -158,7 +163,8 @@ namespace tcp {
          * @param length
          *      The number of bytes past offset to fill with data.
          *
-         * @return the actual number of bytes read or -1 if at EOF.
+         * @return the actual number of bytes read or -1 if at EOF, in non-blocking mode
+         *         zero is returned when no data is available.
          *
          * @throw IOException if an I/O error occurs during the read.
          * @throw NullPointerException if buffer is Null.
@@ -184,10 +190,80 @@ namespace tcp {
          */
         void write(const unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Writes the contents of several buffers to the Socket in order using vectored
+         * sends, so that they go out together without first being copied into one
+         * buffer.  The arguments are expected to have been validated by the caller.
+         *
+         * @param buffers
+         *      The buffers to write to the socket.
+         * @param lengths
+         *      The number of bytes to write from each of the buffers.
+         * @param count
+         *      The number of buffers passed.
+         *
+         * @throw IOException if an I/O error occurs during the write.
+         */
+        void writeArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
+        /**
+         * Sets if reads return immediately when no data has arrived instead of waiting
+         * for some, this allows a socket to be read only when a TcpSocketPoller reports
+         * it as readable.  Writes still wait for room in the send buffer so the output
+         * stream behaves the same in either mode.  Must be called once connected.
+         *
+         * @param value
+         *      True to make reads non-blocking.
+         *
+         * @throw IOException if the socket is closed or the mode can't be changed.
+         */
+        void setNonBlocking(bool value);
+
+        /**
+         * @return true if reads on this socket are non-blocking.
+         */
+        bool isNonBlocking() const;
+
     protected:
 
         void checkResult(apr_status_t value) const;
 
+        /**
+         * Creates the system level stream socket in the given address family, the TCP
+         * socket creates it with AF_INET.
+         *
+         * @throw IOException if the socket was already created or can't be created.
+         */
+        void createSocket(int family, int protocol);
+
+        /**
+         * Binds the socket to an address created in this socket's pool.
+         *
+         * @throw SocketException if the socket can't be bound, the socket is closed.
+         */
+        void bindAddress(apr_sockaddr_t* address);
+
+        /**
+         * Connects the socket to an address created in this socket's pool, waiting at most
+         * timeout milliseconds when it is greater than zero.
+         *
+         * @throw IOException if the socket isn't created or the connect fails.
+         */
+        void connectAddress(apr_sockaddr_t* address, int timeout);
+
+        /**
+         * @return the pool the socket's addresses are created in.
+         */
+        apr_pool_t* getAprPool() const;
+
+    private:
+
+        // Returns the APR socket so that it can be added to a poll set.
+        apr_socket_t* getSocketHandle() const;
+
+        // Waits for the send buffer to drain after a non-blocking send couldn't complete.
+        void waitForWrite();
+
     };
 
 }}}}
@@ -100,3 +100,25 @@ void TcpSocketOutputStream::doWriteArrayBounded(const unsigned char* buffer, int
     DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketOutputStream::doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        if (checkArrays(buffers, lengths, count) == 0) {
+            return;
+        }
+
+        if (closed) {
+            throw IOException(__FILE__, __LINE__,
+                "TcpSocketOutputStream::write - This Stream has been closed.");
+        }
+
+        this->socket->writeArrays(buffers, lengths, count);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
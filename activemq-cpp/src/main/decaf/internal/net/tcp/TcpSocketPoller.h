@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_TCP_TCPSOCKETPOLLER_H_
+#define _DECAF_INTERNAL_NET_TCP_TCPSOCKETPOLLER_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <vector>
+
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class TcpSocket;
+    class TcpSocketPollerImpl;
+
+    /**
+     * Waits on a set of TcpSockets at once and reports which of them can be read from,
+     * using the best mechanism the platform offers.  On unix that is whatever APR's
+     * pollset uses (epoll, kqueue, /dev/poll or poll), on Windows it is an I/O completion
+     * port with a zero byte overlapped read posted on each socket.  Each socket is added
+     * with an attachment that is handed back when it is ready, the socket should be in
+     * non-blocking mode so that whoever is notified can read until no data is left and
+     * then return to polling.  On Windows a socket that was reported is watched again
+     * when poll is next called, so it must be read before then.
+     *
+     * The add and remove methods must only be called from the thread that polls, or
+     * while no thread is polling, since not every platform allows the set to change
+     * during a poll.  Only wakeup is safe to call from any thread.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API TcpSocketPoller {
+    private:
+
+        TcpSocketPollerImpl* impl;
+
+    private:
+
+        TcpSocketPoller(const TcpSocketPoller&);
+        TcpSocketPoller& operator= (const TcpSocketPoller&);
+
+    public:
+
+        /**
+         * Creates a new poller.
+         *
+         * @param capacity
+         *      The maximum number of sockets that can be added at once.
+         *
+         * @throws IllegalArgumentException if the capacity is not positive.
+         * @throws IOException if the platform poll set can't be created.
+         */
+        TcpSocketPoller(int capacity);
+
+        virtual ~TcpSocketPoller();
+
+        /**
+         * Starts watching the socket for data to read, a peer close or an error.
+         *
+         * @param socket
+         *      The connected socket to watch, it must stay open until it is removed.
+         * @param attachment
+         *      The value returned by poll when this socket is ready.
+         *
+         * @throws NullPointerException if the socket is NULL.
+         * @throws IOException if the socket isn't connected or the poller is full.
+         */
+        void add(TcpSocket* socket, void* attachment);
+
+        /**
+         * Stops watching the socket.
+         *
+         * @param socket
+         *      The socket to remove.
+         *
+         * @return true if the socket was being watched.
+         */
+        bool remove(TcpSocket* socket);
+
+        /**
+         * Waits for at least one of the sockets to be ready.
+         *
+         * @param timeout
+         *      The longest time to wait in milliseconds, a negative value waits until
+         *      a socket is ready or wakeup is called.
+         * @param ready
+         *      Receives the attachments of the sockets that are ready, it is cleared first.
+         *
+         * @return the number of ready sockets, zero if the wait timed out or was woken.
+         *
+         * @throws IOException if the poll fails.
+         */
+        int poll(long long timeout, std::vector<void*>& ready);
+
+        /**
+         * Causes a poll that is in progress, or the next one, to return immediately.
+         * Does nothing if isWakeable returns false.
+         */
+        void wakeup();
+
+        /**
+         * @return true if this platform supports waking up a poll from another thread, if
+         *         not callers should poll with a timeout to notice changes.
+         */
+        bool isWakeable() const;
+
+        /**
+         * @return the number of sockets being watched.
+         */
+        int size() const;
+
+        /**
+         * @return the maximum number of sockets that can be watched at once.
+         */
+        int getCapacity() const;
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_NET_TCP_TCPSOCKETPOLLER_H_ */
@@ -0,0 +1,221 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <decaf/internal/net/tcp/TcpSocketPoller.h>
+
+#include <decaf/internal/AprPool.h>
+#include <decaf/internal/net/tcp/TcpSocket.h>
+#include <decaf/net/SocketError.h>
+
+#include <apr_poll.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    class TcpSocketPollerImpl {
+    private:
+
+        TcpSocketPollerImpl(const TcpSocketPollerImpl&);
+        TcpSocketPollerImpl& operator= (const TcpSocketPollerImpl&);
+
+    public:
+
+        AprPool pool;
+        apr_pollset_t* pollset;
+        int capacity;
+        int count;
+        bool wakeable;
+
+        TcpSocketPollerImpl(int capacity) :
+            pool(), pollset(NULL), capacity(capacity), count(0), wakeable(false) {
+        }
+
+        void initDescriptor(apr_pollfd_t& descriptor, apr_socket_t* handle, void* attachment) {
+            descriptor.p = pool.getAprPool();
+            descriptor.desc_type = APR_POLL_SOCKET;
+            descriptor.reqevents = APR_POLLIN;
+            descriptor.rtnevents = 0;
+            descriptor.desc.s = handle;
+            descriptor.client_data = attachment;
+        }
+    };
+
+}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocketPoller::TcpSocketPoller(int capacity) : impl(NULL) {
+
+    if (capacity <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Capacity must be positive: %d", capacity);
+    }
+
+    this->impl = new TcpSocketPollerImpl(capacity);
+
+    apr_status_t result = APR_SUCCESS;
+
+#ifdef APR_POLLSET_WAKEABLE
+    // Wakeups are only supported from APR 1.4 on, older versions fall back to polling
+    // with a timeout.
+    result = apr_pollset_create(&impl->pollset, (apr_uint32_t) capacity,
+                                impl->pool.getAprPool(), APR_POLLSET_WAKEABLE);
+    impl->wakeable = result == APR_SUCCESS;
+#endif
+
+    if (!impl->wakeable) {
+        result = apr_pollset_create(&impl->pollset, (apr_uint32_t) capacity, impl->pool.getAprPool(), 0);
+    }
+
+    if (result != APR_SUCCESS) {
+        delete this->impl;
+        throw IOException(__FILE__, __LINE__,
+            "Could not create the poll set: %s", SocketError::getErrorString().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocketPoller::~TcpSocketPoller() {
+
+    try {
+        apr_pollset_destroy(impl->pollset);
+    }
+    DECAF_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketPoller::add(TcpSocket* socket, void* attachment) {
+
+    try {
+
+        if (socket == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Socket passed was NULL");
+        }
+
+        if (!socket->isConnected() || socket->isClosed() || socket->getSocketHandle() == NULL) {
+            throw IOException(__FILE__, __LINE__, "Socket is not connected.");
+        }
+
+        if (impl->count >= impl->capacity) {
+            throw IOException(__FILE__, __LINE__, "Poller is full, capacity is: %d", impl->capacity);
+        }
+
+        apr_pollfd_t descriptor;
+        impl->initDescriptor(descriptor, socket->getSocketHandle(), attachment);
+
+        if (apr_pollset_add(impl->pollset, &descriptor) != APR_SUCCESS) {
+            throw IOException(__FILE__, __LINE__,
+                "Could not add the socket to the poll set: %s", SocketError::getErrorString().c_str());
+        }
+
+        impl->count++;
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocketPoller::remove(TcpSocket* socket) {
+
+    if (socket == NULL || socket->getSocketHandle() == NULL) {
+        return false;
+    }
+
+    apr_pollfd_t descriptor;
+    impl->initDescriptor(descriptor, socket->getSocketHandle(), NULL);
+
+    if (apr_pollset_remove(impl->pollset, &descriptor) != APR_SUCCESS) {
+        return false;
+    }
+
+    impl->count--;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::poll(long long timeout, std::vector<void*>& ready) {
+
+    try {
+
+        ready.clear();
+
+        apr_int32_t signalled = 0;
+        const apr_pollfd_t* descriptors = NULL;
+
+        // Time in APR is in microseconds.
+        apr_interval_time_t aprTimeout = timeout < 0 ? -1 : (apr_interval_time_t) timeout * 1000;
+
+        apr_status_t result = apr_pollset_poll(impl->pollset, aprTimeout, &signalled, &descriptors);
+
+        if (APR_STATUS_IS_TIMEUP(result) || APR_STATUS_IS_EINTR(result)) {
+            return 0;
+        }
+
+        if (result != APR_SUCCESS) {
+            throw IOException(__FILE__, __LINE__,
+                "Poll on the socket set failed: %s", SocketError::getErrorString().c_str());
+        }
+
+        for (apr_int32_t i = 0; i < signalled; ++i) {
+            ready.push_back(descriptors[i].client_data);
+        }
+
+        return (int) ready.size();
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketPoller::wakeup() {
+#ifdef APR_POLLSET_WAKEABLE
+    if (impl->wakeable) {
+        apr_pollset_wakeup(impl->pollset);
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocketPoller::isWakeable() const {
+    return impl->wakeable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::size() const {
+    return impl->count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::getCapacity() const {
+    return impl->capacity;
+}
@@ -0,0 +1,359 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// GetQueuedCompletionStatusEx and CancelIoEx need Vista, this must come before
+// anything that includes windows.h.
+#undef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+
+#include <decaf/internal/net/tcp/TcpSocketPoller.h>
+
+#include <decaf/internal/net/tcp/TcpSocket.h>
+#include <decaf/net/SocketError.h>
+
+#include <apr_portable.h>
+
+#include <winsock2.h>
+#include <windows.h>
+
+#include <cstring>
+#include <map>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::net;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace net {
+namespace tcp {
+
+    /**
+     * A socket being watched.  Readiness is signalled by a zero byte overlapped read
+     * completing on the port, which happens once data, a close or an error arrives
+     * and consumes nothing, so the socket is then read as it would be after any other
+     * poll.  The kernel owns the entry while a read is pending, so a removed entry is
+     * only freed once that read has completed or been cancelled.
+     */
+    struct PollEntry {
+
+        // First so that the OVERLAPPED the port hands back is the entry.
+        OVERLAPPED overlapped;
+
+        SOCKET handle;
+        void* attachment;
+        bool pending;
+        bool removed;
+
+        PollEntry(SOCKET handle, void* attachment) :
+            overlapped(), handle(handle), attachment(attachment), pending(false), removed(false) {
+        }
+    };
+
+    class TcpSocketPollerImpl {
+    private:
+
+        TcpSocketPollerImpl(const TcpSocketPollerImpl&);
+        TcpSocketPollerImpl& operator= (const TcpSocketPollerImpl&);
+
+    public:
+
+        // How long the destructor waits for cancelled reads to complete.
+        static const DWORD DRAIN_TIMEOUT = 1000;
+
+        HANDLE port;
+        int capacity;
+        int count;
+
+        std::map<TcpSocket*, PollEntry*> entries;
+
+        // Entries without a read pending, they are armed at the start of the next poll
+        // or freed there if removed meanwhile.
+        std::vector<PollEntry*> idle;
+
+        std::vector<OVERLAPPED_ENTRY> completions;
+
+        // Reads posted that haven't completed, including those of removed entries.
+        int outstanding;
+
+        TcpSocketPollerImpl(int capacity) :
+            port(NULL), capacity(capacity), count(0), entries(), idle(),
+            completions(capacity + 1), outstanding(0) {
+        }
+
+        /**
+         * Posts the read that reports the entry when the socket is readable.
+         *
+         * @return false if the read failed straight away, the socket is then ready
+         *         since reading it will report the error.
+         */
+        bool arm(PollEntry* entry) {
+
+            std::memset(&entry->overlapped, 0, sizeof(OVERLAPPED));
+
+            WSABUF buffer;
+            buffer.len = 0;
+            buffer.buf = NULL;
+            DWORD flags = 0;
+
+            if (WSARecv(entry->handle, &buffer, 1, NULL, &flags, &entry->overlapped, NULL) == SOCKET_ERROR &&
+                WSAGetLastError() != WSA_IO_PENDING) {
+
+                return false;
+            }
+
+            entry->pending = true;
+            outstanding++;
+            return true;
+        }
+
+        /**
+         * Takes the entry back from the kernel once its read has completed.
+         *
+         * @return the entry, or NULL if it was removed and has been freed.
+         */
+        PollEntry* complete(OVERLAPPED* overlapped) {
+
+            PollEntry* entry = reinterpret_cast<PollEntry*>(overlapped);
+            entry->pending = false;
+            outstanding--;
+
+            if (entry->removed) {
+                delete entry;
+                return NULL;
+            }
+
+            return entry;
+        }
+    };
+
+}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocketPoller::TcpSocketPoller(int capacity) : impl(NULL) {
+
+    if (capacity <= 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Capacity must be positive: %d", capacity);
+    }
+
+    this->impl = new TcpSocketPollerImpl(capacity);
+
+    impl->port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+    if (impl->port == NULL) {
+        delete this->impl;
+        throw IOException(__FILE__, __LINE__,
+            "Could not create the completion port: %s", SocketError::getErrorString().c_str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpSocketPoller::~TcpSocketPoller() {
+
+    try {
+
+        std::map<TcpSocket*, PollEntry*>::iterator iter = impl->entries.begin();
+        for (; iter != impl->entries.end(); ++iter) {
+            iter->second->removed = true;
+            if (iter->second->pending) {
+                CancelIoEx((HANDLE) iter->second->handle, &iter->second->overlapped);
+            }
+        }
+
+        // A pending read writes to its entry when it completes, so wait for them all.
+        // If one never does its entry is leaked rather than freed under the kernel.
+        while (impl->outstanding > 0) {
+
+            ULONG signalled = 0;
+            if (!GetQueuedCompletionStatusEx(impl->port, &impl->completions[0],
+                    (ULONG) impl->completions.size(), &signalled, TcpSocketPollerImpl::DRAIN_TIMEOUT, FALSE)) {
+                break;
+            }
+
+            for (ULONG i = 0; i < signalled; ++i) {
+                if (impl->completions[i].lpOverlapped != NULL) {
+                    impl->complete(impl->completions[i].lpOverlapped);
+                }
+            }
+        }
+
+        std::vector<PollEntry*>::iterator idle = impl->idle.begin();
+        for (; idle != impl->idle.end(); ++idle) {
+            delete *idle;
+        }
+
+        CloseHandle(impl->port);
+    }
+    DECAF_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketPoller::add(TcpSocket* socket, void* attachment) {
+
+    try {
+
+        if (socket == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Socket passed was NULL");
+        }
+
+        if (!socket->isConnected() || socket->isClosed() || socket->getSocketHandle() == NULL) {
+            throw IOException(__FILE__, __LINE__, "Socket is not connected.");
+        }
+
+        if (impl->count >= impl->capacity) {
+            throw IOException(__FILE__, __LINE__, "Poller is full, capacity is: %d", impl->capacity);
+        }
+
+        if (impl->entries.find(socket) != impl->entries.end()) {
+            throw IOException(__FILE__, __LINE__, "Socket is already being polled.");
+        }
+
+        apr_os_sock_t handle;
+        apr_os_sock_get(&handle, socket->getSocketHandle());
+
+        // A socket can't leave the port it was first associated with, so one that is
+        // added again after being removed is already there.
+        if (CreateIoCompletionPort((HANDLE) handle, impl->port, 0, 0) == NULL &&
+            GetLastError() != ERROR_INVALID_PARAMETER) {
+
+            throw IOException(__FILE__, __LINE__,
+                "Could not add the socket to the completion port: %s", SocketError::getErrorString().c_str());
+        }
+
+        PollEntry* entry = new PollEntry((SOCKET) handle, attachment);
+        impl->entries.insert(std::make_pair(socket, entry));
+        impl->idle.push_back(entry);
+        impl->count++;
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocketPoller::remove(TcpSocket* socket) {
+
+    std::map<TcpSocket*, PollEntry*>::iterator iter = impl->entries.find(socket);
+    if (iter == impl->entries.end()) {
+        return false;
+    }
+
+    PollEntry* entry = iter->second;
+    impl->entries.erase(iter);
+    impl->count--;
+
+    // An idle entry is freed by the next poll, a pending one when its cancelled read
+    // completes.  Closing the socket completes the read as well.
+    entry->removed = true;
+    if (entry->pending) {
+        CancelIoEx((HANDLE) entry->handle, &entry->overlapped);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::poll(long long timeout, std::vector<void*>& ready) {
+
+    try {
+
+        ready.clear();
+
+        std::vector<PollEntry*> rearm;
+        rearm.swap(impl->idle);
+
+        std::vector<PollEntry*>::iterator iter = rearm.begin();
+        for (; iter != rearm.end(); ++iter) {
+            PollEntry* entry = *iter;
+
+            if (entry->removed) {
+                delete entry;
+            } else if (!impl->arm(entry)) {
+                ready.push_back(entry->attachment);
+                impl->idle.push_back(entry);
+            }
+        }
+
+        DWORD wait = INFINITE;
+        if (!ready.empty()) {
+            wait = 0;
+        } else if (timeout >= 0) {
+            wait = timeout < (long long) INFINITE ? (DWORD) timeout : INFINITE - 1;
+        }
+
+        ULONG signalled = 0;
+        if (!GetQueuedCompletionStatusEx(impl->port, &impl->completions[0],
+                (ULONG) impl->completions.size(), &signalled, wait, FALSE)) {
+
+            if (GetLastError() == WAIT_TIMEOUT) {
+                return (int) ready.size();
+            }
+
+            throw IOException(__FILE__, __LINE__,
+                "Wait on the completion port failed: %s", SocketError::getErrorString().c_str());
+        }
+
+        for (ULONG i = 0; i < signalled; ++i) {
+
+            // Wakeups are posted without an OVERLAPPED.
+            if (impl->completions[i].lpOverlapped == NULL) {
+                continue;
+            }
+
+            PollEntry* entry = impl->complete(impl->completions[i].lpOverlapped);
+            if (entry != NULL) {
+                ready.push_back(entry->attachment);
+                impl->idle.push_back(entry);
+            }
+        }
+
+        return (int) ready.size();
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpSocketPoller::wakeup() {
+    PostQueuedCompletionStatus(impl->port, 0, 0, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TcpSocketPoller::isWakeable() const {
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::size() const {
+    return impl->count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TcpSocketPoller::getCapacity() const {
+    return impl->capacity;
+}
@@ -31,6 +31,14 @@ using namespace decaf::internal::nio;
 using namespace decaf::nio;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::internal::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Direct buffers start on a page boundary, as the memory the OS pages in and out.
+    const int DIRECT_BUFFER_ALIGNMENT = 4096;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteBuffer* BufferFactory::createByteBuffer( int capacity ) {
@@ -64,6 +72,18 @@ ByteBuffer* BufferFactory::createByteBuffer( std::vector<unsigned char>& buffer
     DECAF_CATCHALL_THROW( Exception )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer* BufferFactory::createDirectByteBuffer( int capacity ) {
+
+    try{
+        Pointer<ByteArrayAdapter> array( new ByteArrayAdapter( capacity, DIRECT_BUFFER_ALIGNMENT ) );
+        return new ByteArrayBuffer( array, 0, capacity, false );
+    }
+    DECAF_CATCH_RETHROW( IllegalArgumentException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, IllegalArgumentException )
+    DECAF_CATCHALL_THROW( IllegalArgumentException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CharBuffer* BufferFactory::createCharBuffer( int capacity ) {
 
@@ -99,6 +99,20 @@ namespace nio{
          */
         static decaf::nio::ByteBuffer* createByteBuffer( std::vector<unsigned char>& buffer );
 
+        /**
+         * Allocates a new direct byte buffer, its storage starts on a page boundary.
+         * Its position will be zero its limit will be its capacity and its mark is
+         * not set.
+         *
+         * @param capacity
+         *      The internal buffer's capacity.
+         *
+         * @return a newly allocated ByteBuffer which the caller owns.
+         *
+         * @throws IllegalArgumentException if the capacity specified is negative.
+         */
+        static decaf::nio::ByteBuffer* createDirectByteBuffer( int capacity );
+
         /**
          * Allocates a new char buffer whose position will be zero its limit will
          * be its capacity and its mark is not set.
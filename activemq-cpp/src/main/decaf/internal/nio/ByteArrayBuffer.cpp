@@ -29,6 +29,39 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::internal::nio;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Checks the arguments of a bulk transfer of count values of the given size
+    // against the bytes remaining in the buffer.
+    void checkTransfer( const decaf::nio::ByteBuffer& buffer, const void* values, int count, int size, bool writing ) {
+
+        if( writing && buffer.isReadOnly() ) {
+            throw decaf::nio::ReadOnlyBufferException(
+                __FILE__, __LINE__, "This buffer is Read Only." );
+        }
+
+        if( count < 0 ) {
+            throw IndexOutOfBoundsException(
+                __FILE__, __LINE__, "Negative count: %d", count );
+        }
+
+        if( values == NULL && count > 0 ) {
+            throw NullPointerException(
+                __FILE__, __LINE__, "Passed Buffer is Null." );
+        }
+
+        if( count > buffer.remaining() / size ) {
+            if( writing ) {
+                throw decaf::nio::BufferOverflowException(
+                    __FILE__, __LINE__, "Not Enough space to store requested Data." );
+            }
+            throw decaf::nio::BufferUnderflowException(
+                __FILE__, __LINE__, "Not Enough Data to Fill Request." );
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayBuffer::ByteArrayBuffer( int size, bool readOnly ) :
     decaf::nio::ByteBuffer( size ), _array(new ByteArrayAdapter(size)), offset(0), length(size), readOnly(readOnly) {
@@ -607,6 +640,117 @@ ByteArrayBuffer& ByteArrayBuffer::putShort( int index, short value ) {
     DECAF_CATCHALL_THROW( IndexOutOfBoundsException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::getShorts( short* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( short ), false );
+
+        this->_array->getShortsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( short );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferUnderflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::getInts( int* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( int ), false );
+
+        this->_array->getIntsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( int );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferUnderflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::getLongs( long long* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( long long ), false );
+
+        this->_array->getLongsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( long long );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferUnderflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::putShorts( const short* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( short ), true );
+
+        this->_array->putShortsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( short );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferOverflowException )
+    DECAF_CATCH_RETHROW( decaf::nio::ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferOverflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferOverflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::putInts( const int* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( int ), true );
+
+        this->_array->putIntsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( int );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferOverflowException )
+    DECAF_CATCH_RETHROW( decaf::nio::ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferOverflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferOverflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayBuffer& ByteArrayBuffer::putLongs( const long long* values, int count ) {
+
+    try{
+
+        checkTransfer( *this, values, count, (int)sizeof( long long ), true );
+
+        this->_array->putLongsAt( this->offset + this->_position, values, count );
+        this->_position += count * (int)sizeof( long long );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferOverflowException )
+    DECAF_CATCH_RETHROW( decaf::nio::ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferOverflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferOverflowException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayBuffer* ByteArrayBuffer::slice() const {
 
@@ -209,6 +209,13 @@ namespace nio{
          */
         virtual bool hasArray() const { return true; }
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool isDirect() const {
+            return this->_array->getAlignment() > 0;
+        }
+
     public:   // Abstract Methods
 
         /**
@@ -401,6 +408,36 @@ namespace nio{
          */
         virtual ByteArrayBuffer& putShort( int index, short value );
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& getShorts( short* values, int count );
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& getInts( int* values, int count );
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& getLongs( long long* values, int count );
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& putShorts( const short* values, int count );
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& putInts( const int* values, int count );
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual ByteArrayBuffer& putLongs( const long long* values, int count );
+
         /**
          * {@inheritDoc}
          */
@@ -154,6 +154,13 @@ namespace nio {
          */
         virtual double get(int index) const;
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied from the backing array with a single range check.
+         */
+        virtual DoubleBuffer& get(double* buffer, int size, int offset, int length);
+
         /**
          * {@inheritDoc}
          */
@@ -178,6 +185,13 @@ namespace nio {
          */
         virtual DoubleBuffer& put(int index, double value);
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied into the backing array with a single range check.
+         */
+        virtual DoubleBuffer& put(const double* buffer, int size, int offset, int length);
+
         /**
          * {@inheritDoc}
          */
@@ -154,6 +154,13 @@ namespace nio {
          */
         virtual float get(int index) const;
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied from the backing array with a single range check.
+         */
+        virtual FloatBuffer& get(float* buffer, int size, int offset, int length);
+
         /**
          * {@inheritDoc}
          */
@@ -178,6 +185,13 @@ namespace nio {
          */
         virtual FloatBuffer& put(int index, float value);
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied into the backing array with a single range check.
+         */
+        virtual FloatBuffer& put(const float* buffer, int size, int offset, int length);
+
         /**
          * {@inheritDoc}
          */
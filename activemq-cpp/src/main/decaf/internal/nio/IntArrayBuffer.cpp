@@ -221,6 +221,45 @@ int IntArrayBuffer::get( int index ) const {
     DECAF_CATCHALL_THROW( IndexOutOfBoundsException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+IntBuffer& IntArrayBuffer::get( int* buffer, int size, int bufferOffset, int length ) {
+
+    try{
+
+        if( length == 0 ) {
+            return *this;
+        }
+
+        if( buffer == NULL ) {
+            throw NullPointerException(
+                __FILE__, __LINE__,
+                "IntArrayBuffer::get - Passed Buffer is Null" );
+        }
+
+        if( size < 0 || bufferOffset < 0 || length < 0 ||
+            (long long)bufferOffset + (long long)length > (long long)size ) {
+            throw IndexOutOfBoundsException(
+                 __FILE__, __LINE__, "Arguments violate array bounds." );
+        }
+
+        if( length > this->remaining() ) {
+            throw BufferUnderflowException(
+                __FILE__, __LINE__,
+                "IntArrayBuffer::get - Not enough data to fill length = %d", length );
+        }
+
+        this->_array->getInts( this->offset + this->position(), buffer + bufferOffset, length );
+        this->position( this->position() + length );
+
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferUnderflowException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferUnderflowException )
+    DECAF_CATCHALL_THROW( BufferUnderflowException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 IntBuffer& IntArrayBuffer::put( int value ) {
 
@@ -262,6 +301,52 @@ IntBuffer& IntArrayBuffer::put( int index, int value ) {
     DECAF_CATCHALL_THROW( IndexOutOfBoundsException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+IntBuffer& IntArrayBuffer::put( const int* buffer, int size, int bufferOffset, int length ) {
+
+    try{
+
+        if( length == 0 ) {
+            return *this;
+        }
+
+        if( this->isReadOnly() ) {
+            throw decaf::nio::ReadOnlyBufferException(
+                __FILE__, __LINE__,
+                "IntArrayBuffer::put - Buffer is Read Only." );
+        }
+
+        if( buffer == NULL ) {
+            throw NullPointerException(
+                __FILE__, __LINE__,
+                "IntArrayBuffer::put - Passed Buffer is Null." );
+        }
+
+        if( size < 0 || bufferOffset < 0 || length < 0 ||
+            (long long)bufferOffset + (long long)length > (long long)size ) {
+            throw IndexOutOfBoundsException(
+                 __FILE__, __LINE__, "Arguments violate array bounds." );
+        }
+
+        if( length > this->remaining() ) {
+            throw decaf::nio::BufferOverflowException(
+                __FILE__, __LINE__,
+                "IntArrayBuffer::put - Not Enough space to store requested Data." );
+        }
+
+        this->_array->putInts( this->offset + this->position(), buffer + bufferOffset, length );
+        this->position( this->position() + length );
+
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( decaf::nio::BufferOverflowException )
+    DECAF_CATCH_RETHROW( decaf::nio::ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, decaf::nio::BufferOverflowException )
+    DECAF_CATCHALL_THROW( decaf::nio::BufferOverflowException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 IntBuffer* IntArrayBuffer::slice() const {
 
@@ -154,6 +154,13 @@ namespace nio{
          */
         virtual int get( int index ) const;
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied from the backing array with a single range check.
+         */
+        virtual IntBuffer& get( int* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
@@ -176,6 +183,13 @@ namespace nio{
          */
         virtual IntBuffer& put( int index, int value );
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied into the backing array with a single range check.
+         */
+        virtual IntBuffer& put( const int* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
@@ -154,6 +154,13 @@ namespace nio{
          */
         virtual long long get( int index ) const;
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied from the backing array with a single range check.
+         */
+        virtual LongBuffer& get( long long* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
@@ -176,6 +183,13 @@ namespace nio{
          */
         virtual LongBuffer& put( int index, long long value );
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied into the backing array with a single range check.
+         */
+        virtual LongBuffer& put( const long long* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
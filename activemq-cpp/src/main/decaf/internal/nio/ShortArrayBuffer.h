@@ -154,6 +154,13 @@ namespace nio{
          */
         virtual short get( int index ) const;
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied from the backing array with a single range check.
+         */
+        virtual ShortBuffer& get( short* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
@@ -176,6 +183,13 @@ namespace nio{
          */
         virtual ShortBuffer& put( int index, short value );
 
+        /**
+         * {@inheritDoc}
+         *
+         * The values are copied into the backing array with a single range check.
+         */
+        virtual ShortBuffer& put( const short* buffer, int size, int offset, int length );
+
         /**
          * {@inheritDoc}
          */
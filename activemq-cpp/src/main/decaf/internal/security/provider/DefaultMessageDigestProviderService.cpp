@@ -20,6 +20,7 @@
 #include <decaf/internal/security/provider/crypto/MD4MessageDigestSpi.h>
 #include <decaf/internal/security/provider/crypto/MD5MessageDigestSpi.h>
 #include <decaf/internal/security/provider/crypto/SHA1MessageDigestSpi.h>
+#include <decaf/internal/security/provider/crypto/OpenSSLMessageDigestSpi.h>
 
 using namespace decaf;
 using namespace decaf::security;
@@ -45,8 +46,15 @@ SecuritySpi* DefaultMessageDigestProviderService::newInstance() {
         return new MD4MessageDigestSpi();
     } else if (getAlgorithm() == "MD5") {
         return new MD5MessageDigestSpi();
+    } else if (getAlgorithm() == "SHA-256") {
+        return new OpenSSLMessageDigestSpi("SHA256");
     } else {
+#ifdef HAVE_OPENSSL
+        // OpenSSL uses the SHA instructions of the CPU where they exist.
+        return new OpenSSLMessageDigestSpi("SHA1");
+#else
         return new SHA1MessageDigestSpi();
+#endif
     }
 
     return NULL;
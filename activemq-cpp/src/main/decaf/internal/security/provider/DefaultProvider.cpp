@@ -43,6 +43,9 @@ void DefaultProvider::initialize() {
         this->addService(new DefaultMessageDigestProviderService(this, "MD4"));
         this->addService(new DefaultMessageDigestProviderService(this, "MD5"));
         this->addService(new DefaultMessageDigestProviderService(this, "SHA1"));
+#ifdef HAVE_OPENSSL
+        this->addService(new DefaultMessageDigestProviderService(this, "SHA-256"));
+#endif
         this->addService(new DefaultSecureRandomProviderService(this, "Default"));
     }
     DECAF_CATCHALL_THROW(Exception)
@@ -0,0 +1,274 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenSSLMessageDigestSpi.h"
+
+#ifdef HAVE_OPENSSL
+    #include <openssl/evp.h>
+#endif
+
+#include <decaf/security/DigestException.h>
+#include <decaf/security/NoSuchAlgorithmException.h>
+
+using namespace decaf;
+using namespace decaf::security;
+using namespace decaf::internal;
+using namespace decaf::internal::security;
+using namespace decaf::internal::security::provider;
+using namespace decaf::internal::security::provider::crypto;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace security {
+namespace provider {
+namespace crypto {
+
+    class OpenSSLMessageDigestSpiImpl {
+    private:
+
+        OpenSSLMessageDigestSpiImpl(const OpenSSLMessageDigestSpiImpl&);
+        OpenSSLMessageDigestSpiImpl& operator= (const OpenSSLMessageDigestSpiImpl&);
+
+    public:
+
+#ifdef HAVE_OPENSSL
+        const EVP_MD* digest;
+        EVP_MD_CTX* context;
+
+        OpenSSLMessageDigestSpiImpl(const EVP_MD* digest) : digest(digest), context(NULL) {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+            context = EVP_MD_CTX_create();
+#else
+            context = EVP_MD_CTX_new();
+#endif
+            if (context == NULL) {
+                throw DigestException(__FILE__, __LINE__, "Could not allocate an OpenSSL digest context.");
+            }
+        }
+
+        ~OpenSSLMessageDigestSpiImpl() {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+            EVP_MD_CTX_destroy(context);
+#else
+            EVP_MD_CTX_free(context);
+#endif
+        }
+
+        void reset() {
+            if (EVP_DigestInit_ex(context, digest, NULL) != 1) {
+                throw DigestException(__FILE__, __LINE__, "Could not initialize the OpenSSL digest.");
+            }
+        }
+
+        void update(const unsigned char* input, int length) {
+            if (EVP_DigestUpdate(context, input, (size_t) length) != 1) {
+                throw DigestException(__FILE__, __LINE__, "OpenSSL failed to update the digest.");
+            }
+        }
+
+        // Writes the digest and starts the next one, as a MessageDigest does.
+        void finalize(unsigned char* result) {
+            if (EVP_DigestFinal_ex(context, result, NULL) != 1) {
+                throw DigestException(__FILE__, __LINE__, "OpenSSL failed to complete the digest.");
+            }
+            reset();
+        }
+
+        int length() const {
+            return EVP_MD_size(digest);
+        }
+#else
+        int length() const {
+            return 0;
+        }
+#endif
+    };
+
+}}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLMessageDigestSpi::OpenSSLMessageDigestSpi(const std::string& algorithm) : MessageDigestSpi(), impl(NULL) {
+
+#ifdef HAVE_OPENSSL
+    const EVP_MD* digest = EVP_get_digestbyname(algorithm.c_str());
+    if (digest == NULL) {
+        throw NoSuchAlgorithmException(__FILE__, __LINE__,
+            "OpenSSL doesn't provide the %s digest.", algorithm.c_str());
+    }
+
+    this->impl = new OpenSSLMessageDigestSpiImpl(digest);
+    try {
+        this->impl->reset();
+    } catch (...) {
+        delete this->impl;
+        throw;
+    }
+#else
+    throw NoSuchAlgorithmException(__FILE__, __LINE__,
+        "The %s digest needs OpenSSL, the library was built without it.", algorithm.c_str());
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLMessageDigestSpi::OpenSSLMessageDigestSpi(OpenSSLMessageDigestSpiImpl* impl) : MessageDigestSpi(), impl(impl) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenSSLMessageDigestSpi::~OpenSSLMessageDigestSpi() {
+    delete this->impl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessageDigestSpi* OpenSSLMessageDigestSpi::clone() {
+
+#ifdef HAVE_OPENSSL
+    OpenSSLMessageDigestSpiImpl* copy = new OpenSSLMessageDigestSpiImpl(this->impl->digest);
+    if (EVP_MD_CTX_copy_ex(copy->context, this->impl->context) != 1) {
+        delete copy;
+        throw DigestException(__FILE__, __LINE__, "OpenSSL failed to copy the digest.");
+    }
+
+    return new OpenSSLMessageDigestSpi(copy);
+#else
+    return NULL;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenSSLMessageDigestSpi::engineGetDigestLength() {
+    return this->impl->length();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLMessageDigestSpi::engineUpdate(unsigned char input DECAF_UNUSED) {
+#ifdef HAVE_OPENSSL
+    this->impl->update(&input, 1);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLMessageDigestSpi::engineUpdate(const unsigned char* input, int size, int offset, int length) {
+
+    if (input == NULL && size > 0) {
+        throw DigestException(__FILE__, __LINE__, "Null buffer parameter.");
+    }
+
+    if (size <= 0) {
+        return;
+    }
+
+    if (offset < 0 || length < 0) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__, "Incorrect offset or length value.");
+    }
+
+    if (offset + length > size) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__, "Incorrect offset or length value.");
+    }
+
+#ifdef HAVE_OPENSSL
+    this->impl->update(&input[offset], length);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLMessageDigestSpi::engineUpdate(const std::vector<unsigned char>& input) {
+
+    if (input.empty()) {
+        return;
+    }
+
+    this->engineUpdate(&input[0], (int) input.size(), 0, (int) input.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLMessageDigestSpi::engineUpdate(decaf::nio::ByteBuffer& input) {
+
+    if (!input.hasRemaining()) {
+        return;
+    }
+
+    int length = input.limit() - input.position();
+
+    if (input.hasArray()) {
+        engineUpdate(input.array(), input.arrayOffset() + input.limit(), input.arrayOffset() + input.position(), length);
+        input.position(input.limit());
+    } else {
+        std::vector<unsigned char> temp(length);
+        input.get(&temp[0], length, 0, length);
+        engineUpdate(&temp[0], length, 0, length);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenSSLMessageDigestSpi::engineReset() {
+#ifdef HAVE_OPENSSL
+    this->impl->reset();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char> OpenSSLMessageDigestSpi::engineDigest() {
+
+    std::vector<unsigned char> buffer(engineGetDigestLength());
+#ifdef HAVE_OPENSSL
+    this->impl->finalize(&buffer[0]);
+#endif
+
+    return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int OpenSSLMessageDigestSpi::engineDigest(unsigned char* buffer, int size, int offset, int length) {
+
+    if (buffer == NULL) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__, "Null buffer parameter.");
+    }
+
+    int digestLength = engineGetDigestLength();
+
+    if (size < digestLength) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__,
+            "The value of size parameter is less than the actual digest length.");
+    }
+
+    if (length < digestLength) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__,
+            "The value of length parameter is less than the actual digest length.");
+    }
+
+    if (offset < 0) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__, "Invalid negative offset.");
+    }
+
+    if (offset + length > size) {
+        engineReset();
+        throw DigestException(__FILE__, __LINE__, "Incorrect offset or length value.");
+    }
+
+#ifdef HAVE_OPENSSL
+    this->impl->finalize(buffer + offset);
+#endif
+
+    return digestLength;
+}
@@ -22,6 +22,7 @@
 #include <decaf/lang/Math.h>
 #include <decaf/lang/Float.h>
 #include <decaf/lang/Double.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
 
 using namespace decaf;
 using namespace decaf::nio;
@@ -30,9 +31,127 @@ using namespace decaf::internal::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The first address in the allocation that is a multiple of the alignment, the
+    // allocation is alignment - 1 bytes larger than the array to leave room for it.
+    unsigned char* alignedStart(unsigned char* allocation, int alignment) {
+        std::size_t misalignment = (std::size_t) allocation & (std::size_t) (alignment - 1);
+        return misalignment == 0 ? allocation : allocation + (alignment - misalignment);
+    }
+
+    bool isLittleEndian() {
+        union {
+            unsigned int value;
+            unsigned char bytes[sizeof(unsigned int)];
+        } probe;
+        probe.value = 1;
+        return probe.bytes[0] == 1;
+    }
+
+    const bool nativeLittleEndian = isLittleEndian();
+
+    // Written as shifts, which compilers recognize as byte swaps and, in the loop of
+    // reverseEach, as vector shuffles swapping several values per instruction.
+    inline unsigned short reverse(unsigned short value) {
+        return (unsigned short) ((value >> 8) | (value << 8));
+    }
+
+    inline unsigned int reverse(unsigned int value) {
+        return (value >> 24) | ((value >> 8) & 0x0000FF00U) | ((value << 8) & 0x00FF0000U) | (value << 24);
+    }
+
+    inline unsigned long long reverse(unsigned long long value) {
+        return ((unsigned long long) reverse((unsigned int) value) << 32) | reverse((unsigned int) (value >> 32));
+    }
+
+    template<typename U>
+    void reverseEach(U* values, int count) {
+        for (int i = 0; i < count; ++i) {
+            values[i] = reverse(values[i]);
+        }
+    }
+
+    // Checks a bulk access of count values of the given size from the byte offset start
+    // once, the copy that follows has no checks of its own.
+    void checkRange(long long start, int count, int size, const void* values, int capacity) {
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "ByteArrayAdapter - Negative count: %d", count);
+        }
+
+        if (values == NULL && count > 0) {
+            throw NullPointerException(__FILE__, __LINE__, "ByteArrayAdapter - Passed Buffer is Null.");
+        }
+
+        if (start < 0 || start + (long long) count * size > (long long) capacity) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "ByteArrayAdapter - Not enough data to fill request.");
+        }
+    }
+
+    template<typename T>
+    void copyOut(const unsigned char* bytes, int capacity, long long start, T* values, int count) {
+
+        checkRange(start, count, (int) sizeof(T), values, capacity);
+
+        if (count > 0) {
+            memcpy(values, bytes + start, count * sizeof(T));
+        }
+    }
+
+    template<typename T>
+    void copyIn(unsigned char* bytes, int capacity, long long start, const T* values, int count) {
+
+        checkRange(start, count, (int) sizeof(T), values, capacity);
+
+        if (count > 0) {
+            memcpy(bytes + start, values, count * sizeof(T));
+        }
+    }
+
+    // The caller's array is aligned for U, the values are swapped in it once copied.
+    template<typename T, typename U>
+    void copyOutBigEndian(const unsigned char* bytes, int capacity, long long start, T* values, int count) {
+
+        copyOut(bytes, capacity, start, values, count);
+
+        if (nativeLittleEndian) {
+            reverseEach((U*) values, count);
+        }
+    }
+
+    // The array may be unaligned at a byte index and the caller's values can't be
+    // changed, so the values are swapped a block at a time in an aligned scratch block.
+    template<typename T, typename U>
+    void copyInBigEndian(unsigned char* bytes, int capacity, long long start, const T* values, int count) {
+
+        if (!nativeLittleEndian) {
+            copyIn(bytes, capacity, start, values, count);
+            return;
+        }
+
+        checkRange(start, count, (int) sizeof(T), values, capacity);
+
+        U block[256 / sizeof(U)];
+        const int blockCount = (int) (sizeof(block) / sizeof(U));
+
+        unsigned char* target = bytes + start;
+        while (count > 0) {
+            int chunk = count < blockCount ? count : blockCount;
+            memcpy(block, values, chunk * sizeof(U));
+            reverseEach(block, chunk);
+            memcpy(target, block, chunk * sizeof(U));
+            values += chunk;
+            target += chunk * sizeof(U);
+            count -= chunk;
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(int size) :
-        array(), size(size), own(true) {
+        array(), size(size), own(true), allocation(NULL), alignment(0) {
 
     try {
 
@@ -48,9 +167,31 @@ ByteArrayAdapter::ByteArrayAdapter(int size) :
     DECAF_CATCHALL_THROW(Exception)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ByteArrayAdapter::ByteArrayAdapter(int size, int alignment) :
+        array(), size(size), own(true), allocation(NULL), alignment(alignment) {
+
+    try {
+
+        if (size < 0) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "Array size given must be greater than zero.");
+        }
+
+        if (alignment <= 0 || (alignment & (alignment - 1)) != 0) {
+            throw IllegalArgumentException(__FILE__, __LINE__, "Alignment %d is not a power of two.", alignment);
+        }
+
+        this->allocation = new unsigned char[size + alignment - 1];
+        this->array.bytes = alignedStart(this->allocation, alignment);
+        memset(this->array.bytes, 0, size);
+    }
+    DECAF_CATCH_RETHROW(IllegalArgumentException)
+    DECAF_CATCHALL_THROW(IllegalArgumentException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(unsigned char* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(array, size, own);
@@ -62,7 +203,7 @@ ByteArrayAdapter::ByteArrayAdapter(unsigned char* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(char* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size, own);
@@ -74,7 +215,7 @@ ByteArrayAdapter::ByteArrayAdapter(char* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(double* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size * (int) sizeof(double), own);
@@ -86,7 +227,7 @@ ByteArrayAdapter::ByteArrayAdapter(double* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(float* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size * (int) sizeof(float), own);
@@ -98,7 +239,7 @@ ByteArrayAdapter::ByteArrayAdapter(float* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(long long* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size * (int) sizeof(long long), own);
@@ -110,7 +251,7 @@ ByteArrayAdapter::ByteArrayAdapter(long long* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(int* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size * (int) sizeof(int), own);
@@ -122,7 +263,7 @@ ByteArrayAdapter::ByteArrayAdapter(int* array, int size, bool own) :
 
 ////////////////////////////////////////////////////////////////////////////////
 ByteArrayAdapter::ByteArrayAdapter(short* array, int size, bool own) :
-        array(), size(size), own(own) {
+        array(), size(size), own(own), allocation(NULL), alignment(0) {
 
     try {
         this->initialize(reinterpret_cast<unsigned char*>(array), size * (int) sizeof(short), own);
@@ -158,7 +299,7 @@ ByteArrayAdapter::~ByteArrayAdapter() {
 
     try {
         if (own) {
-            delete[] array.bytes;
+            delete[] (allocation != NULL ? allocation : array.bytes);
         }
     }
     DECAF_CATCHALL_NOTHROW()
@@ -258,12 +399,18 @@ void ByteArrayAdapter::resize(int size) {
         // Save old state
         int oldCapacity = this->size;
         unsigned char* oldArray = this->array.bytes;
+        unsigned char* oldAllocation = this->allocation != NULL ? this->allocation : oldArray;
 
         // Resize and copy as much of the old as we can back and delete old array
-        this->array.bytes = new unsigned char[size];
+        if (this->alignment > 0) {
+            this->allocation = new unsigned char[size + this->alignment - 1];
+            this->array.bytes = alignedStart(this->allocation, this->alignment);
+        } else {
+            this->array.bytes = new unsigned char[size];
+        }
         this->size = size;
         memcpy(this->array.bytes, oldArray, Math::min((int) oldCapacity, (int) size));
-        delete[] oldArray;
+        delete[] oldAllocation;
     }
     DECAF_CATCH_RETHROW(InvalidStateException)
     DECAF_CATCHALL_THROW(InvalidStateException)
@@ -718,3 +865,195 @@ ByteArrayAdapter& ByteArrayAdapter::putShortAt(int index, short value) {
     DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getShorts(int index, short* values, int count) const {
+
+    try {
+        copyOut(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(short), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putShorts(int index, const short* values, int count) {
+
+    try {
+        copyIn(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(short), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getInts(int index, int* values, int count) const {
+
+    try {
+        copyOut(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(int), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putInts(int index, const int* values, int count) {
+
+    try {
+        copyIn(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(int), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getLongs(int index, long long* values, int count) const {
+
+    try {
+        copyOut(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(long long), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putLongs(int index, const long long* values, int count) {
+
+    try {
+        copyIn(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(long long), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getFloats(int index, float* values, int count) const {
+
+    try {
+        copyOut(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(float), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putFloats(int index, const float* values, int count) {
+
+    try {
+        copyIn(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(float), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getDoubles(int index, double* values, int count) const {
+
+    try {
+        copyOut(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(double), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putDoubles(int index, const double* values, int count) {
+
+    try {
+        copyIn(this->array.bytes, this->getCapacity(), (long long) index * (long long) sizeof(double), values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getShortsAt(int index, short* values, int count) const {
+
+    try {
+        copyOutBigEndian<short, unsigned short>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putShortsAt(int index, const short* values, int count) {
+
+    try {
+        copyInBigEndian<short, unsigned short>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getIntsAt(int index, int* values, int count) const {
+
+    try {
+        copyOutBigEndian<int, unsigned int>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putIntsAt(int index, const int* values, int count) {
+
+    try {
+        copyInBigEndian<int, unsigned int>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::getLongsAt(int index, long long* values, int count) const {
+
+    try {
+        copyOutBigEndian<long long, unsigned long long>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapter::putLongsAt(int index, const long long* values, int count) {
+
+    try {
+        copyInBigEndian<long long, unsigned long long>(this->array.bytes, this->getCapacity(), index, values, count);
+    }
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_EXCEPTION_CONVERT(Exception, IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IndexOutOfBoundsException)
+}
@@ -64,6 +64,11 @@ namespace util {
         // Whether this object owns the buffer
         bool own;
 
+        // The allocation an aligned array was placed in and the alignment it was placed
+        // at, NULL and zero when the array wasn't allocated aligned.
+        unsigned char* allocation;
+        int alignment;
+
     public:
 
         /**
@@ -78,6 +83,23 @@ namespace util {
          */
         ByteArrayAdapter(int size);
 
+        /**
+         * Creates a byte array object that is allocated internally with its first element
+         * at an address that is a multiple of the given alignment, such as the page size.
+         * The array is owned and deleted when this object is deleted, it is initially
+         * created with all elements initialized to zero and keeps its alignment when it
+         * is resized.
+         *
+         * @param size
+         *      The size of the array, this is the limit we read and write to.
+         * @param alignment
+         *      The alignment of the array, a power of two.
+         *
+         * @throws IllegalArgumentException if size is negative or the alignment isn't a
+         *         power of two.
+         */
+        ByteArrayAdapter(int size, int alignment);
+
         /**
          * Creates a byte array object that wraps the given array.  If the own flag
          * is set then it will delete this array when this object is deleted.
@@ -192,6 +214,14 @@ namespace util {
 
         virtual ~ByteArrayAdapter();
 
+        /**
+         * @return the alignment the array was allocated at, zero if it wasn't allocated
+         *         aligned.
+         */
+        virtual int getAlignment() const {
+            return this->alignment;
+        }
+
         /**
          * Gets the size of the underlying array.
          * @return the size the array.
@@ -767,6 +797,293 @@ namespace util {
          */
         virtual ByteArrayAdapter& putShortAt(int index, short value);
 
+        /**
+         * Copies count shorts starting at the given index into the values array.  The
+         * index is relative to the size of the type as for getShort, the values keep
+         * the native byte order and the range is checked once for the whole copy.
+         *
+         * @param index
+         *      The index of the first value to copy.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getShorts(int index, short* values, int count) const;
+
+        /**
+         * Copies count shorts from the values array into this array starting at the
+         * given index.  The index is relative to the size of the type as for putShort,
+         * the values keep the native byte order and the range is checked once for the
+         * whole copy.
+         *
+         * @param index
+         *      The index of the first value to write.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putShorts(int index, const short* values, int count);
+
+        /**
+         * Copies count ints starting at the given index into the values array.  The
+         * index is relative to the size of the type as for getInt, the values keep
+         * the native byte order and the range is checked once for the whole copy.
+         *
+         * @param index
+         *      The index of the first value to copy.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getInts(int index, int* values, int count) const;
+
+        /**
+         * Copies count ints from the values array into this array starting at the
+         * given index.  The index is relative to the size of the type as for putInt,
+         * the values keep the native byte order and the range is checked once for the
+         * whole copy.
+         *
+         * @param index
+         *      The index of the first value to write.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putInts(int index, const int* values, int count);
+
+        /**
+         * Copies count longs starting at the given index into the values array.  The
+         * index is relative to the size of the type as for getLong, the values keep
+         * the native byte order and the range is checked once for the whole copy.
+         *
+         * @param index
+         *      The index of the first value to copy.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getLongs(int index, long long* values, int count) const;
+
+        /**
+         * Copies count longs from the values array into this array starting at the
+         * given index.  The index is relative to the size of the type as for putLong,
+         * the values keep the native byte order and the range is checked once for the
+         * whole copy.
+         *
+         * @param index
+         *      The index of the first value to write.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putLongs(int index, const long long* values, int count);
+
+        /**
+         * Copies count floats starting at the given index into the values array.  The
+         * index is relative to the size of the type as for getFloat, the values keep
+         * the native byte order and the range is checked once for the whole copy.
+         *
+         * @param index
+         *      The index of the first value to copy.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getFloats(int index, float* values, int count) const;
+
+        /**
+         * Copies count floats from the values array into this array starting at the
+         * given index.  The index is relative to the size of the type as for putFloat,
+         * the values keep the native byte order and the range is checked once for the
+         * whole copy.
+         *
+         * @param index
+         *      The index of the first value to write.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putFloats(int index, const float* values, int count);
+
+        /**
+         * Copies count doubles starting at the given index into the values array.  The
+         * index is relative to the size of the type as for getDouble, the values keep
+         * the native byte order and the range is checked once for the whole copy.
+         *
+         * @param index
+         *      The index of the first value to copy.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getDoubles(int index, double* values, int count) const;
+
+        /**
+         * Copies count doubles from the values array into this array starting at the
+         * given index.  The index is relative to the size of the type as for putDouble,
+         * the values keep the native byte order and the range is checked once for the
+         * whole copy.
+         *
+         * @param index
+         *      The index of the first value to write.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to copy.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putDoubles(int index, const double* values, int count);
+
+        /**
+         * Reads count big endian shorts starting at the given byte index into the
+         * values array, the bulk form of getShortAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getShortsAt(int index, short* values, int count) const;
+
+        /**
+         * Writes count shorts from the values array big endian into this array starting
+         * at the given byte index, the bulk form of putShortAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to write.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putShortsAt(int index, const short* values, int count);
+
+        /**
+         * Reads count big endian ints starting at the given byte index into the
+         * values array, the bulk form of getIntAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getIntsAt(int index, int* values, int count) const;
+
+        /**
+         * Writes count ints from the values array big endian into this array starting
+         * at the given byte index, the bulk form of putIntAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to write.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putIntsAt(int index, const int* values, int count);
+
+        /**
+         * Reads count big endian longs starting at the given byte index into the
+         * values array, the bulk form of getLongAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array that receives the values, at least count elements long.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void getLongsAt(int index, long long* values, int count) const;
+
+        /**
+         * Writes count longs from the values array big endian into this array starting
+         * at the given byte index, the bulk form of putLongAt.
+         *
+         * @param index
+         *      The byte index of the first value.
+         * @param values
+         *      The array holding the values, at least count elements long.
+         * @param count
+         *      The number of values to write.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if index or count is negative or the range
+         *         extends past the end of the array.
+         */
+        virtual void putLongsAt(int index, const long long* values, int count);
+
     private:
 
         void initialize(unsigned char* buffer, int size, bool own);
@@ -22,16 +22,46 @@
 
 #include <decaf/lang/exceptions/RuntimeException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/io/UTFDataFormatException.h>
+
+#include <string.h>
 
 using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
+using namespace decaf::io;
 using namespace decaf::internal;
 using namespace decaf::internal::util;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
 
+    const unsigned long long HIGH_BITS = 0x8080808080808080ULL;
+    const unsigned long long LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+    inline unsigned long long loadWord(const unsigned char* data) {
+        unsigned long long word;
+        memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    // The length of the leading run of bytes below 0x80, which decode as themselves.
+    std::size_t asciiSpan(const unsigned char* data, std::size_t length) {
+
+        std::size_t index = 0;
+        for (; index + sizeof(unsigned long long) <= length; index += sizeof(unsigned long long)) {
+            if ((loadWord(data + index) & HIGH_BITS) != 0) {
+                break;
+            }
+        }
+
+        while (index < length && data[index] < 0x80) {
+            index++;
+        }
+
+        return index;
+    }
+
     int compareRight(char const* left, char const* right) {
 
         int bias = 0;
@@ -168,3 +198,128 @@ int StringUtils::compareIgnoreCase(const char* left, const char* right) {
 int StringUtils::compare(const char* left, const char* right) {
     return doCompare(left, right, false);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StringUtils::unencodedSpan(const unsigned char* data, std::size_t length) {
+
+    std::size_t index = 0;
+    for (; index + sizeof(unsigned long long) <= length; index += sizeof(unsigned long long)) {
+
+        unsigned long long word = loadWord(data + index);
+
+        // Adding 0x7F to the low bits of a byte sets its high bit unless the byte is
+        // zero, masking with the inverted word clears it again for bytes above 0x7F.
+        if ((((word & LOW_BITS) + LOW_BITS) & ~word & HIGH_BITS) != HIGH_BITS) {
+            break;
+        }
+    }
+
+    while (index < length && data[index] != 0 && data[index] < 0x80) {
+        index++;
+    }
+
+    return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StringUtils::modifiedUtf8Length(const unsigned char* data, std::size_t length) {
+
+    std::size_t utfLength = 0;
+    std::size_t index = 0;
+
+    while (index < length) {
+
+        std::size_t span = unencodedSpan(data + index, length - index);
+        utfLength += span;
+        index += span;
+
+        // Zero and the values above 127 take two bytes.
+        if (index < length) {
+            utfLength += 2;
+            index++;
+        }
+    }
+
+    return utfLength;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StringUtils::encodeModifiedUtf8(const unsigned char* data, std::size_t length, unsigned char* encoded) {
+
+    std::size_t utfIndex = 0;
+    std::size_t index = 0;
+
+    while (index < length) {
+
+        std::size_t span = unencodedSpan(data + index, length - index);
+        if (span > 0) {
+            memcpy(encoded + utfIndex, data + index, span);
+            utfIndex += span;
+            index += span;
+        }
+
+        if (index < length) {
+            unsigned int charValue = data[index++];
+            encoded[utfIndex++] = (unsigned char) (0xc0 | (0x1f & (charValue >> 6)));
+            encoded[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
+        }
+    }
+
+    return utfIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t StringUtils::decodeModifiedUtf8(const unsigned char* encoded, std::size_t length, unsigned char* decoded) {
+
+    std::size_t count = 0;
+    std::size_t index = 0;
+
+    while (count < length) {
+
+        std::size_t span = asciiSpan(encoded + count, length - count);
+        if (span > 0) {
+            // The buffers are the same one when decoding in place.
+            memmove(decoded + index, encoded + count, span);
+            index += span;
+            count += span;
+            continue;
+        }
+
+        unsigned char a = encoded[count++];
+
+        if ((a & 0xE0) == 0xC0) {
+            if (count >= length) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of two byte char found at end.");
+            }
+
+            unsigned char b = encoded[count++];
+            if ((b & 0xC0) != 0x80) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, byte two does not start with 0x80.");
+            }
+
+            // 2-byte UTF8 encoding: 110X XXxx 10xx xxxx
+            // Bits set at 'X' means we have encountered a UTF8 encoded value
+            // greater than 255, which is not supported.
+            if (a & 0x1C) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 2 byte UTF-8 encoding found, "
+                        "This method only supports encoded ASCII values of (0-255).");
+            }
+
+            decoded[index++] = (unsigned char) (((a & 0x1F) << 6) | (b & 0x3F));
+
+        } else if ((a & 0xF0) == 0xE0) {
+
+            if (count + 1 >= length) {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of three byte char found at end.");
+            } else {
+                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 3 byte UTF-8 encoding found, "
+                        "This method only supports encoded ASCII values of (0-255).");
+            }
+
+        } else {
+            throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, aborting.");
+        }
+    }
+
+    return index;
+}
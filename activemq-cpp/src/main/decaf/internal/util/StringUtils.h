@@ -20,6 +20,8 @@
 
 #include <decaf/util/Config.h>
 
+#include <cstddef>
+
 namespace decaf {
 namespace internal {
 namespace util {
@@ -78,6 +80,68 @@ namespace util {
          */
         static int compare(const char* left, const char* right);
 
+
+        /**
+         * Returns the number of leading bytes of the given data that are in the range
+         * 1 to 127, the characters that Java modified UTF-8 encodes as themselves.  The
+         * data is checked a word at a time so long ASCII runs are passed over quickly.
+         *
+         * @param data
+         *      The bytes to check.
+         * @param length
+         *      The number of bytes to check.
+         *
+         * @return the length of the leading run of bytes that need no encoding.
+         */
+        static std::size_t unencodedSpan(const unsigned char* data, std::size_t length);
+
+        /**
+         * Returns the number of bytes the Java modified UTF-8 encoding of the given
+         * single byte characters takes.
+         *
+         * @param data
+         *      The characters to measure.
+         * @param length
+         *      The number of characters.
+         *
+         * @return the length of the encoded form.
+         */
+        static std::size_t modifiedUtf8Length(const unsigned char* data, std::size_t length);
+
+        /**
+         * Encodes the given single byte characters as Java modified UTF-8, runs of ASCII
+         * characters are copied as a whole.
+         *
+         * @param data
+         *      The characters to encode.
+         * @param length
+         *      The number of characters.
+         * @param encoded
+         *      The buffer receiving the encoding, at least modifiedUtf8Length bytes long.
+         *
+         * @return the number of bytes written to the encoded buffer.
+         */
+        static std::size_t encodeModifiedUtf8(const unsigned char* data, std::size_t length, unsigned char* encoded);
+
+        /**
+         * Decodes Java modified UTF-8 into single byte characters, runs of ASCII bytes
+         * are copied as a whole.  The decoded form is never longer than the encoded one,
+         * so the decoded buffer may be the encoded one to decode in place.
+         *
+         * @param encoded
+         *      The modified UTF-8 bytes to decode.
+         * @param length
+         *      The number of encoded bytes.
+         * @param decoded
+         *      The buffer receiving the characters, at least length bytes long.
+         *
+         * @return the number of characters written to the decoded buffer.
+         *
+         * @throws UTFDataFormatException if the encoding is invalid or holds a character
+         *         that doesn't fit in a single byte.
+         */
+        static std::size_t decodeModifiedUtf8(const unsigned char* encoded, std::size_t length, unsigned char* decoded);
+
     };
 
 }}}
@@ -59,6 +59,51 @@ namespace concurrent {
         static int incrementAndGet(volatile int* target);
         static int decrementAndGet(volatile int* target);
 
+        static bool compareAndSet64(volatile long long* target, long long expect, long long update);
+        static long long getAndAdd64(volatile long long* target, long long delta);
+        static long long addAndGet64(volatile long long* target, long long delta);
+
+    public:
+
+        /*
+         * Ordering aware variants, the operations above are all full barriers while these
+         * only order what the caller needs.  On platforms without a memory model aware
+         * backend they fall back to the fully ordered operations.
+         */
+
+        /**
+         * Stores the value with release semantics, writes made before the store are
+         * visible to a thread that reads the new value with getAcquire.
+         */
+        static void lazySet(volatile int* target, int value);
+        static void lazySet(volatile void** target, void* value);
+
+        /**
+         * Loads the value with acquire semantics.
+         */
+        static int getAcquire(volatile int* target);
+        static void* getAcquire(volatile void** target);
+
+        /**
+         * Increments the value without ordering any other memory access, suitable for
+         * taking another reference to an object the caller already holds one to.
+         */
+        static int incrementAndGetRelaxed(volatile int* target);
+
+        /**
+         * Decrements the value with release semantics, when the result is zero an acquire
+         * fence follows so that the caller can safely destroy what the count protected.
+         */
+        static int decrementAndGetRelease(volatile int* target);
+
+        /**
+         * Loads and stores a 64 bit value atomically without ordering any other memory
+         * access, suitable for values such as timestamps that are only read on their
+         * own.  The store is not torn on 32 bit platforms.
+         */
+        static long long getRelaxed64(volatile long long* target);
+        static void setRelaxed64(volatile long long* target, long long value);
+
     private:
 
         static void initialize();
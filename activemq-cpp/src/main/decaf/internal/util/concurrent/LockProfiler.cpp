@@ -0,0 +1,321 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LockProfiler.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/internal/util/concurrent/PlatformThread.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace internal {
+namespace util {
+namespace concurrent {
+
+    class LockProfiler::Site {
+    private:
+
+        Site(const Site&);
+        Site& operator=(const Site&);
+
+    public:
+
+        std::string name;
+
+        volatile long long acquisitions;
+        volatile long long contended;
+        volatile long long waitNanos;
+
+        volatile long long holds;
+        volatile long long holdNanos;
+
+        volatile long long waitHistogram[HISTOGRAM_BUCKETS];
+        volatile long long holdHistogram[HISTOGRAM_BUCKETS];
+
+        Site(const std::string& name) : name(name), acquisitions(0), contended(0), waitNanos(0),
+                                        holds(0), holdNanos(0), waitHistogram(), holdHistogram() {
+        }
+
+        void clear() {
+            Atomics::setRelaxed64(&acquisitions, 0);
+            Atomics::setRelaxed64(&contended, 0);
+            Atomics::setRelaxed64(&waitNanos, 0);
+            Atomics::setRelaxed64(&holds, 0);
+            Atomics::setRelaxed64(&holdNanos, 0);
+            for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+                Atomics::setRelaxed64(&waitHistogram[i], 0);
+                Atomics::setRelaxed64(&holdHistogram[i], 0);
+            }
+        }
+
+        void copyTo(Statistics& statistics) {
+            statistics.site = name;
+            statistics.acquisitions = Atomics::getRelaxed64(&acquisitions);
+            statistics.contended = Atomics::getRelaxed64(&contended);
+            statistics.waitNanos = Atomics::getRelaxed64(&waitNanos);
+            statistics.holds = Atomics::getRelaxed64(&holds);
+            statistics.holdNanos = Atomics::getRelaxed64(&holdNanos);
+            for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+                statistics.waitHistogram[i] = Atomics::getRelaxed64(&waitHistogram[i]);
+                statistics.holdHistogram[i] = Atomics::getRelaxed64(&holdHistogram[i]);
+            }
+        }
+    };
+
+}}}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    volatile int enabled = 0;
+
+    // Sites are only ever added, the lock guards the list and not their counters.
+    decaf_mutex_t registryLock;
+    std::vector<LockProfiler::Site*>* sites = NULL;
+
+    int bucketOf(long long nanos) {
+        int bucket = 0;
+        while (nanos > 1 && bucket < LockProfiler::HISTOGRAM_BUCKETS - 1) {
+            nanos >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    bool mostWaitedFirst(const LockProfiler::Statistics& left, const LockProfiler::Statistics& right) {
+        return left.waitNanos > right.waitNanos;
+    }
+
+    std::string micros(long long nanos) {
+        std::ostringstream stream;
+        stream << std::fixed << std::setprecision(1) << (double) nanos / 1000.0;
+        return stream.str();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const int LockProfiler::HISTOGRAM_BUCKETS;
+
+////////////////////////////////////////////////////////////////////////////////
+LockProfiler::Statistics::Statistics() : site(), acquisitions(0), contended(0), waitNanos(0), holds(0), holdNanos(0),
+                                         waitHistogram(HISTOGRAM_BUCKETS, 0), holdHistogram(HISTOGRAM_BUCKETS, 0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LockProfiler::Statistics::percentile(const std::vector<long long>& histogram, double fraction) {
+
+    long long total = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        total += histogram[i];
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    long long wanted = (long long) (fraction * (double) total);
+    if (wanted < 1) {
+        wanted = 1;
+    }
+
+    long long seen = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+        if (seen >= wanted) {
+            return 2LL << i;
+        }
+    }
+
+    return 2LL << (histogram.size() - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::initialize() {
+    PlatformThread::createMutex(&registryLock);
+    sites = new std::vector<Site*>();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::shutdown() {
+
+    Atomics::getAndSet(&enabled, 0);
+
+    std::vector<Site*>* old = sites;
+    sites = NULL;
+
+    if (old != NULL) {
+        for (std::size_t i = 0; i < old->size(); ++i) {
+            delete (*old)[i];
+        }
+        delete old;
+        PlatformThread::destroyMutex(registryLock);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::setEnabled(bool value) {
+    Atomics::getAndSet(&enabled, value ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool LockProfiler::isEnabled() {
+    return Atomics::getAcquire(&enabled) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LockProfiler::Site* LockProfiler::getSite(const std::string& name) {
+
+    if (sites == NULL) {
+        return NULL;
+    }
+
+    Site* site = NULL;
+
+    PlatformThread::lockMutex(registryLock);
+    for (std::size_t i = 0; i < sites->size(); ++i) {
+        if ((*sites)[i]->name == name) {
+            site = (*sites)[i];
+            break;
+        }
+    }
+
+    if (site == NULL) {
+        site = new Site(name);
+        sites->push_back(site);
+    }
+    PlatformThread::unlockMutex(registryLock);
+
+    return site;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::recordAcquire(Site* site, long long waitNanos, bool contended) {
+
+    Atomics::addAndGet64(&site->acquisitions, 1);
+
+    if (contended) {
+        Atomics::addAndGet64(&site->contended, 1);
+        Atomics::addAndGet64(&site->waitNanos, waitNanos);
+    }
+
+    Atomics::addAndGet64(&site->waitHistogram[bucketOf(waitNanos)], 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::recordHold(Site* site, long long holdNanos) {
+    Atomics::addAndGet64(&site->holds, 1);
+    Atomics::addAndGet64(&site->holdNanos, holdNanos);
+    Atomics::addAndGet64(&site->holdHistogram[bucketOf(holdNanos)], 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<LockProfiler::Statistics> LockProfiler::getStatistics() {
+
+    std::vector<Statistics> result;
+
+    if (sites == NULL) {
+        return result;
+    }
+
+    PlatformThread::lockMutex(registryLock);
+    result.resize(sites->size());
+    for (std::size_t i = 0; i < sites->size(); ++i) {
+        (*sites)[i]->copyTo(result[i]);
+    }
+    PlatformThread::unlockMutex(registryLock);
+
+    std::stable_sort(result.begin(), result.end(), mostWaitedFirst);
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool LockProfiler::getStatistics(const std::string& name, Statistics& statistics) {
+
+    if (sites == NULL) {
+        return false;
+    }
+
+    bool found = false;
+
+    PlatformThread::lockMutex(registryLock);
+    for (std::size_t i = 0; i < sites->size(); ++i) {
+        if ((*sites)[i]->name == name) {
+            (*sites)[i]->copyTo(statistics);
+            found = true;
+            break;
+        }
+    }
+    PlatformThread::unlockMutex(registryLock);
+
+    return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfiler::reset() {
+
+    if (sites == NULL) {
+        return;
+    }
+
+    PlatformThread::lockMutex(registryLock);
+    for (std::size_t i = 0; i < sites->size(); ++i) {
+        (*sites)[i]->clear();
+    }
+    PlatformThread::unlockMutex(registryLock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string LockProfiler::report() {
+
+    std::vector<Statistics> statistics = getStatistics();
+
+    std::ostringstream stream;
+    stream << "Lock profile, times in microseconds, percentiles are bucket upper bounds"
+           << (isEnabled() ? "" : " (recording is off)") << std::endl;
+
+    for (std::size_t i = 0; i < statistics.size(); ++i) {
+
+        const Statistics& site = statistics[i];
+
+        double contendedPercent = site.acquisitions == 0 ? 0.0 :
+            100.0 * (double) site.contended / (double) site.acquisitions;
+
+        stream << site.site << std::endl
+               << "  acquired " << site.acquisitions << ", contended " << site.contended
+               << " (" << std::fixed << std::setprecision(1) << contendedPercent << "%)"
+               << ", waited " << micros(site.waitNanos)
+               << ", p50 " << micros(Statistics::percentile(site.waitHistogram, 0.50))
+               << ", p99 " << micros(Statistics::percentile(site.waitHistogram, 0.99))
+               << ", max " << micros(Statistics::percentile(site.waitHistogram, 1.0)) << std::endl
+               << "  held " << site.holds << " times for " << micros(site.holdNanos)
+               << ", p50 " << micros(Statistics::percentile(site.holdHistogram, 0.50))
+               << ", p99 " << micros(Statistics::percentile(site.holdHistogram, 0.99))
+               << ", max " << micros(Statistics::percentile(site.holdHistogram, 1.0)) << std::endl;
+    }
+
+    return stream.str();
+}
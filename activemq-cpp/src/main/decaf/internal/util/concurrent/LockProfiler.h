@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILER_H_
+#define _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILER_H_
+
+#include <decaf/util/Config.h>
+
+#include <string>
+#include <vector>
+
+namespace decaf {
+namespace internal {
+namespace util {
+namespace concurrent {
+
+    /**
+     * Records how long threads wait to acquire and how long they hold the Mutex objects
+     * that were given a profiling site, totals and histograms are kept per site so that
+     * all the locks of one kind, the dispatch channels of every consumer say, add up to
+     * one entry.  A Mutex is given its site with Mutex::setProfilingSite.
+     *
+     * Profiling is off until enabled, while it is off a profiled Mutex does no more than
+     * count its lock depth.  While it is on an acquire first tries the lock and takes the
+     * time only when that fails, so an uncontended acquire costs one clock read for the
+     * start of the hold.  The hold runs from the outermost lock to the matching unlock,
+     * the time spent in wait is not counted as held.
+     *
+     * The histograms have a bucket per power of two nanoseconds, bucket i counting the
+     * times from 2^i up to 2^(i+1) nanoseconds and bucket 0 those below 2.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API LockProfiler {
+    public:
+
+        /**
+         * The number of buckets in each histogram.
+         */
+        static const int HISTOGRAM_BUCKETS = 40;
+
+        /**
+         * The counters of one site, kept by the profiler for the life of the library.
+         */
+        class Site;
+
+        /**
+         * A copy of the counters of one site.
+         */
+        class DECAF_API Statistics {
+        public:
+
+            std::string site;
+
+            long long acquisitions;
+            long long contended;
+            long long waitNanos;
+
+            long long holds;
+            long long holdNanos;
+
+            std::vector<long long> waitHistogram;
+            std::vector<long long> holdHistogram;
+
+            Statistics();
+
+            /**
+             * @return the upper bound in nanoseconds of the histogram bucket holding the
+             *         given fraction of the counted times, or 0 if none were counted.
+             */
+            static long long percentile(const std::vector<long long>& histogram, double fraction);
+
+        };
+
+    private:
+
+        LockProfiler();
+        LockProfiler(const LockProfiler&);
+        LockProfiler& operator=(const LockProfiler&);
+
+    public:
+
+        /**
+         * Turns recording on or off, the counters are kept either way.
+         */
+        static void setEnabled(bool enabled);
+
+        /**
+         * @return true if the profiled locks are recording.
+         */
+        static bool isEnabled();
+
+        /**
+         * Returns the site with the given name, creating it the first time the name is
+         * seen.  The site stays valid until the library is shut down.
+         *
+         * @param name
+         *      The name the site is reported under.
+         *
+         * @return the site with the given name.
+         */
+        static Site* getSite(const std::string& name);
+
+        /**
+         * Records one acquire of a lock at the given site.
+         *
+         * @param site
+         *      The site of the lock that was acquired.
+         * @param waitNanos
+         *      The time the thread waited for the lock.
+         * @param contended
+         *      True if the lock was held by another thread when it was asked for.
+         */
+        static void recordAcquire(Site* site, long long waitNanos, bool contended);
+
+        /**
+         * Records the time one lock at the given site was held.
+         */
+        static void recordHold(Site* site, long long holdNanos);
+
+        /**
+         * @return a copy of the counters of every site, the site with the most time spent
+         *         waiting first.
+         */
+        static std::vector<Statistics> getStatistics();
+
+        /**
+         * Copies the counters of the named site.
+         *
+         * @return false if no site has the given name.
+         */
+        static bool getStatistics(const std::string& name, Statistics& statistics);
+
+        /**
+         * Zeroes the counters of every site.
+         */
+        static void reset();
+
+        /**
+         * @return a readable table of the counters of every site, the site with the most
+         *         time spent waiting first.
+         */
+        static std::string report();
+
+    public:
+
+        /**
+         * Creates the site registry, called by the Runtime once Threading is running.
+         */
+        static void initialize();
+
+        /**
+         * Stops recording and frees every site, called by the Runtime before Threading
+         * is shut down.
+         */
+        static void shutdown();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILER_H_ */
@@ -141,12 +141,49 @@ namespace concurrent {
 
         static void setStackSize(decaf_thread_t thread, long long stackSize);
 
+        /**
+         * Restricts the thread to running on the given processors, an empty set lets it
+         * run on any of the processors again.
+         *
+         * @param thread
+         *      The thread whose affinity is changed.
+         * @param cpus
+         *      The zero based indices of the processors the thread may run on.
+         *
+         * @return true if the affinity was applied, false if the platform doesn't
+         *         support it or rejected the processor set.
+         */
+        static bool setAffinity(decaf_thread_t thread, const std::vector<int>& cpus);
+
+        /**
+         * @return the number of NUMA nodes in the system, one when the platform
+         *         doesn't expose its memory topology.
+         */
+        static int getNumaNodeCount();
+
+        /**
+         * Fills the vector with the indices of the processors that belong to the given
+         * NUMA node, it is left empty if the node is unknown.
+         *
+         * @param node
+         *      The zero based index of the NUMA node.
+         * @param cpus
+         *      The vector that receives the processor indices.
+         */
+        static void getNumaNodeProcessors(int node, std::vector<int>& cpus);
+
         /**
          * Pause the current thread allowing another thread to be scheduled for
          * execution, no guarantee that this will happen.
          */
         static void yeild();
 
+        /**
+         * Hints to the processor that the calling thread is busy waiting so that it
+         * can reduce the cost of the spin, this never enters the kernel.
+         */
+        static void spinPause();
+
     public:  // Thread Local Methods
 
         static void createTlsKey(decaf_tls_key* key);
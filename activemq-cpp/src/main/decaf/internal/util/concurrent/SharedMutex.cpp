@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SharedMutex.h"
+
+#include <decaf/internal/util/concurrent/PlatformThread.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+SharedMutex::SharedMutex() : handle() {
+    PlatformThread::createRWMutex(&handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedMutex::~SharedMutex() {
+    PlatformThread::destroyRWMutex(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutex::readLock() {
+    PlatformThread::readerLockMutex(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutex::writeLock() {
+    PlatformThread::writerLockMutex(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedMutex::tryReadLock() {
+    return PlatformThread::tryReaderLockMutex(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SharedMutex::tryWriteLock() {
+    return PlatformThread::tryWriterLockMutex(handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutex::unlock() {
+    PlatformThread::unlockRWMutex(handle);
+}
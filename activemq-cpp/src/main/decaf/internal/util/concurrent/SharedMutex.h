@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_CONCURRENT_SHAREDMUTEX_H_
+#define _DECAF_INTERNAL_UTIL_CONCURRENT_SHAREDMUTEX_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/internal/util/concurrent/ThreadingTypes.h>
+
+namespace decaf {
+namespace internal {
+namespace util {
+namespace concurrent {
+
+    /**
+     * A plain shared / exclusive lock over the platform's read-write mutex.  Unlike
+     * ReentrantReadWriteLock it keeps no owner, hold counts or wait queue of its own,
+     * taking and releasing the read lock is a single call into the platform lock which
+     * readers that don't meet a writer complete without blocking.
+     *
+     * The lock isn't reentrant: a thread must not take the write lock while holding
+     * either lock, nor take the read lock again while a writer may be waiting.  It is
+     * meant for short leaf sections that call out to nothing that could lock again,
+     * registries read on every message and written rarely.
+     *
+     * @since 1.0
+     */
+    class DECAF_API SharedMutex {
+    private:
+
+        decaf_rwmutex_t handle;
+
+    private:
+
+        SharedMutex(const SharedMutex&);
+        SharedMutex& operator=(const SharedMutex&);
+
+    public:
+
+        SharedMutex();
+
+        ~SharedMutex();
+
+        /**
+         * Acquires the lock shared with other readers, waiting while a writer holds it.
+         */
+        void readLock();
+
+        /**
+         * Acquires the lock exclusively, waiting until all readers and writers left it.
+         */
+        void writeLock();
+
+        /**
+         * @return true if the lock was acquired shared without waiting.
+         */
+        bool tryReadLock();
+
+        /**
+         * @return true if the lock was acquired exclusively without waiting.
+         */
+        bool tryWriteLock();
+
+        /**
+         * Releases the lock held by the calling thread, shared or exclusive.
+         */
+        void unlock();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_CONCURRENT_SHAREDMUTEX_H_ */
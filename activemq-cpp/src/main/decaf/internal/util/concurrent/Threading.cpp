@@ -21,6 +21,7 @@
 #include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/util/concurrent/Executors.h>
 
 #include <decaf/internal/util/concurrent/ThreadLocalImpl.h>
@@ -137,7 +138,8 @@ namespace {
                              activeThreads(),
                              priorityMapping(),
                              osThreadId(),
-                             monitors() {
+                             monitors(),
+                             spinCount(0) {
         }
 
         decaf_tls_key threadKey;
@@ -151,12 +153,42 @@ namespace {
         std::vector<int> priorityMapping;
         AtomicInteger osThreadId;
         MonitorPool* monitors;
+        volatile int spinCount;
     };
 
     #define MONITOR_POOL_BLOCK_SIZE 64
 
     ThreadingLibrary* library = NULL;
 
+    // Counts the initializations of the library, a thread's cached handle is only good
+    // for the generation it was cached in.
+    int libraryGeneration = 0;
+
+#ifdef DECAF_THREAD_LOCAL
+    // The current thread's handle is looked up on every ThreadLocal access, monitor
+    // operation and park, the compiler thread local serves it without going through
+    // the platform TLS key.  The key is kept in step for platforms without one.
+    DECAF_THREAD_LOCAL ThreadHandle* cachedHandle = NULL;
+    DECAF_THREAD_LOCAL int cachedGeneration = 0;
+#endif
+
+    void setCurrentThreadHandle(ThreadHandle* thread) {
+        PlatformThread::setTlsValue(library->threadKey, thread != NULL ? thread->parent : NULL);
+        PlatformThread::setTlsValue(library->selfKey, thread);
+#ifdef DECAF_THREAD_LOCAL
+        cachedHandle = thread;
+        cachedGeneration = libraryGeneration;
+#endif
+    }
+
+    ThreadHandle* currentThreadHandle() {
+#ifdef DECAF_THREAD_LOCAL
+        return cachedGeneration == libraryGeneration ? cachedHandle : NULL;
+#else
+        return (ThreadHandle*)PlatformThread::getTlsValue(library->selfKey);
+#endif
+    }
+
     // ------------------------ Forward Declare All Utility Methds ----------------------- //
     void threadExitTlsCleanup(ThreadHandle* thread);
     void unblockThreads(ThreadHandle* monitor);
@@ -200,8 +232,7 @@ namespace {
         PlatformThread::notifyAll(self->condition);
         unblockThreads(self->joiners);
 
-        PlatformThread::setTlsValue(library->threadKey, NULL);
-        PlatformThread::setTlsValue(library->selfKey, NULL);
+        setCurrentThreadHandle(NULL);
 
         // Ensure all of this thread's local values are purged.
         threadExitTlsCleanup(self);
@@ -230,8 +261,7 @@ namespace {
 
         ThreadHandle* thread = (ThreadHandle*)arg;
 
-        PlatformThread::setTlsValue(library->threadKey, thread->parent);
-        PlatformThread::setTlsValue(library->selfKey, thread);
+        setCurrentThreadHandle(thread);
 
         PlatformThread::lockMutex(thread->mutex);
 
@@ -424,6 +454,8 @@ namespace {
         monitor->count = 0;
         monitor->blocking = NULL;
         monitor->waiting = NULL;
+        monitor->blockers = 0;
+        monitor->spins = 0;
         monitor->next = NULL;
         return monitor;
     }
@@ -605,6 +637,12 @@ namespace {
             throw IllegalMonitorStateException(__FILE__, __LINE__, "Current Thread is not the lock holder.");
         }
 
+        // Waiters join the queue before they release the lock, so the owner sees an
+        // empty queue only when there is nobody to notify.
+        if (monitor->waiting == NULL) {
+            return;
+        }
+
         PlatformThread::lockMutex(monitor->mutex);
 
         next = monitor->waiting;
@@ -630,6 +668,38 @@ namespace {
         PlatformThread::unlockMutex(monitor->mutex);
     }
 
+    bool spinOnMonitor(MonitorHandle* monitor) {
+
+        int maxSpins = library->spinCount;
+        if (maxSpins <= 0) {
+            return false;
+        }
+
+        // Adapt to how long the lock has been held recently, the estimate is not
+        // guarded as it is only a hint.
+        int spins = monitor->spins;
+        int limit = spins * 2 + 10;
+        if (limit > maxSpins) {
+            limit = maxSpins;
+        }
+
+        bool acquired = false;
+        int count = 0;
+
+        while (count < limit) {
+            ++count;
+            PlatformThread::spinPause();
+            if (PlatformThread::tryLockMutex(monitor->lock) == true) {
+                acquired = true;
+                break;
+            }
+        }
+
+        monitor->spins = spins + (count - spins) / 8;
+
+        return acquired;
+    }
+
     void doMonitorEnter(MonitorHandle* monitor, ThreadHandle* thread) {
 
         while (true) {
@@ -640,9 +710,20 @@ namespace {
                 break;
             }
 
+            if (spinOnMonitor(monitor)) {
+                monitor->owner = thread;
+                monitor->count = 1;
+                break;
+            }
+
             PlatformThread::lockMutex(monitor->mutex);
 
+            // Announce that this thread is about to block before the final attempt at
+            // the lock, an exiting owner either sees the count or this attempt succeeds.
+            Atomics::incrementAndGet(&monitor->blockers);
+
             if (PlatformThread::tryLockMutex(monitor->lock) == true) {
+                Atomics::decrementAndGet(&monitor->blockers);
                 PlatformThread::unlockMutex(monitor->mutex);
                 monitor->owner = thread;
                 monitor->count = 1;
@@ -663,6 +744,8 @@ namespace {
 
             dequeueThread(&monitor->blocking, thread);
 
+            Atomics::decrementAndGet(&monitor->blockers);
+
             PlatformThread::unlockMutex(monitor->mutex);
         }
 
@@ -684,15 +767,17 @@ namespace {
         if (monitor->count == 0) {
             monitor->owner = NULL;
 
-            // Wake any blocked threads so they can attempt to enter the monitor.
-            PlatformThread::lockMutex(monitor->mutex);
-            unblockThreads(monitor->blocking);
-
-            // since we are signaling waiting threads we unlock this under lock so that they
-            // don't go back to sleep before we are done
             PlatformThread::unlockMutex(monitor->lock);
 
-            PlatformThread::unlockMutex(monitor->mutex);
+            // A thread that decided to block has counted itself before its last attempt
+            // at the lock and holds the mutex until it is waiting, so waking the blocked
+            // threads is only needed if there are any.  The atomic read orders it after
+            // the unlock above.
+            if (Atomics::getAndAdd(&monitor->blockers, 0) > 0) {
+                PlatformThread::lockMutex(monitor->mutex);
+                unblockThreads(monitor->blocking);
+                PlatformThread::unlockMutex(monitor->mutex);
+            }
         }
     }
 
@@ -737,13 +822,14 @@ namespace {
 
         PlatformThread::lockMutex(monitor->mutex);
 
+        // This thread enters the wait queue while it still holds the lock so that a
+        // notifying owner can tell when the queue is empty without the mutex.
+        enqueueThread(&monitor->waiting, thread);
+
         // Release the lock and wake up any blocked threads.
         PlatformThread::unlockMutex(monitor->lock);
         unblockThreads(monitor->blocking);
 
-        // This thread now enters the wait queue.
-        enqueueThread(&monitor->waiting, thread);
-
         MonitorWaitCompletionCondition completion(thread);
 
         if (mills || nanos) {
@@ -809,6 +895,7 @@ Threading::Threading() {
 void Threading::initialize() {
 
     library = new ThreadingLibrary();
+    libraryGeneration++;
 
     // Figure out what the OS level thread priority mappings are for the Thread
     // classes generic priority value range.
@@ -972,8 +1059,7 @@ ThreadHandle* Threading::attachToCurrentThread() {
     thread->parent = osThread.get();
     thread->osThread = true;
 
-    PlatformThread::setTlsValue(library->threadKey, osThread.get());
-    PlatformThread::setTlsValue(library->selfKey, thread.get());
+    setCurrentThreadHandle(thread.get());
 
     // Store the Thread that wraps this OS thread for later deletion since
     // no other owners exist.
@@ -1057,7 +1143,10 @@ bool Threading::isInterrupted(ThreadHandle* handle, bool reset) {
 
     bool currentValue = handle->interrupted;
 
-    if (reset == true) {
+    // Every interruptible acquire checks and clears the flag on entry, with no
+    // interrupt pending that costs a read instead of the handle's mutex.  An
+    // interrupt racing with the read stays set and is seen by the next check.
+    if (reset == true && currentValue == true) {
         PlatformThread::lockMutex(handle->mutex);
         currentValue = handle->interrupted;
         handle->interrupted = false;
@@ -1299,6 +1388,22 @@ void Threading::setThreadPriority(ThreadHandle* handle, int priority) {
     handle->priority = priority;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long Threading::getThreadStackSize(ThreadHandle* handle) {
+    return handle->stackSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Threading::setThreadAffinity(ThreadHandle* handle, const std::vector<int>& cpus) {
+
+    // Once the thread has exited its OS handle may already have been released.
+    if (handle->state == Thread::TERMINATED) {
+        return false;
+    }
+
+    return PlatformThread::setAffinity(handle->handle, cpus);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 const char* Threading::getThreadName(ThreadHandle* handle) {
     return handle->name;
@@ -1326,7 +1431,7 @@ Thread* Threading::getCurrentThread() {
 
 ////////////////////////////////////////////////////////////////////////////////
 ThreadHandle* Threading::getCurrentThreadHandle() {
-    ThreadHandle* self = (ThreadHandle*)PlatformThread::getTlsValue(library->selfKey);
+    ThreadHandle* self = currentThreadHandle();
 
     if (self == NULL) {
         self = attachToCurrentThread();
@@ -1575,6 +1680,26 @@ void Threading::notifyAllWaiters(MonitorHandle* monitor) {
     doNotifyWaiters(monitor, true);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Threading::setMonitorSpinCount(int spinCount) {
+
+    if (spinCount < 0) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Monitor spin count cannot be negative.");
+    }
+
+    // Spinning only pays off when the owner can run at the same time as the spinner.
+    if (System::availableProcessors() <= 1) {
+        spinCount = 0;
+    }
+
+    library->spinCount = spinCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Threading::getMonitorSpinCount() {
+    return library->spinCount;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Threading::monitorExitUsingThreadId(MonitorHandle* monitor, ThreadHandle* thread) {
 
@@ -1688,7 +1813,7 @@ void Threading::destoryThreadLocalSlot(int slot) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Threading::releaseCurrentThreadHandle() {
-    ThreadHandle* self = (ThreadHandle*)PlatformThread::getTlsValue(library->selfKey);
+    ThreadHandle* self = currentThreadHandle();
 
     if (self != NULL) {
         detachFromCurrentThread(self);
@@ -1711,8 +1836,7 @@ void Threading::detachFromCurrentThread(ThreadHandle* self) {
     }
 
     if (isFound) {
-        PlatformThread::setTlsValue(library->threadKey, NULL);
-        PlatformThread::setTlsValue(library->selfKey, NULL);
+        setCurrentThreadHandle(NULL);
 
         // Ensure all of this thread's local values are purged.
         threadExitTlsCleanup(self);
@@ -22,6 +22,8 @@
 
 #include <decaf/lang/Thread.h>
 
+#include <vector>
+
 namespace decaf {
 namespace internal {
 namespace util {
@@ -181,6 +183,26 @@ namespace concurrent {
          */
         static bool isMonitorLocked(MonitorHandle* monitor);
 
+        /**
+         * Sets the upper bound on the number of times a thread that finds a monitor locked
+         * retries the lock, pausing between each attempt, before it parks to wait for the
+         * owner to exit.  Each monitor adapts the number of spins it uses to how quickly the
+         * lock has been released in the past, so monitors held for long periods quickly stop
+         * spinning.  A value of zero, the default, parks immediately.  Spinning is never
+         * enabled on a single processor host.
+         *
+         * @param spinCount
+         *      The maximum number of lock attempts made before parking.
+         *
+         * @throws IllegalArgumentException if the value is negative.
+         */
+        static void setMonitorSpinCount(int spinCount);
+
+        /**
+         * @return the maximum number of lock attempts a thread makes before parking.
+         */
+        static int getMonitorSpinCount();
+
     public:  // Threads
 
         /**
@@ -242,6 +264,10 @@ namespace concurrent {
 
         static void setThreadPriority(ThreadHandle* thread, int priority);
 
+        static bool setThreadAffinity(ThreadHandle* thread, const std::vector<int>& cpus);
+
+        static long long getThreadStackSize(ThreadHandle* thread);
+
         static const char* getThreadName(ThreadHandle* thread);
 
         static void setThreadName(ThreadHandle* thread, const char* name);
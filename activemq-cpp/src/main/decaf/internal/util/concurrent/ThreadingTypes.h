@@ -100,6 +100,8 @@ namespace concurrent{
         ThreadHandle* owner;
         ThreadHandle* waiting;
         ThreadHandle* blocking;
+        volatile int blockers;
+        int spins;
         bool initialized;
         MonitorHandle* next;
     };
@@ -17,7 +17,7 @@
 
 #include <decaf/internal/util/concurrent/Atomics.h>
 
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) && !defined(HAVE_ATOMIC_MEMORY_MODEL)
 #if defined(SOLARIS2) && SOLARIS2 >= 10
 #include <atomic.h>
 #endif
@@ -28,7 +28,7 @@ using namespace decaf::internal::util;
 using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) && !defined(HAVE_ATOMIC_MEMORY_MODEL)
 
 #include <decaf/internal/util/concurrent/PlatformThread.h>
 
@@ -40,14 +40,14 @@ namespace {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Atomics::initialize() {
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) && !defined(HAVE_ATOMIC_MEMORY_MODEL)
     PlatformThread::createMutex(&atomicMutex);
 #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Atomics::shutdown() {
-#ifndef HAVE_ATOMIC_BUILTINS
+#if !defined(HAVE_ATOMIC_BUILTINS) && !defined(HAVE_ATOMIC_MEMORY_MODEL)
     PlatformThread::destroyMutex(atomicMutex);
 #endif
 }
@@ -55,7 +55,9 @@ void Atomics::shutdown() {
 ////////////////////////////////////////////////////////////////////////////////
 bool Atomics::compareAndSet32(volatile int* target, int expect, int update ) {
 
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_compare_exchange_n(target, &expect, update, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_val_compare_and_swap(target, expect, update)  == expect;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_cas_32((volatile unsigned int*)target, expect, update) == expect;
@@ -76,7 +78,9 @@ bool Atomics::compareAndSet32(volatile int* target, int expect, int update ) {
 
 ////////////////////////////////////////////////////////////////////////////////
 bool Atomics::compareAndSet(volatile void** target, void* expect, void* update) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_compare_exchange_n(target, &expect, update, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_val_compare_and_swap(target, (void*)expect, (void*)update) == (void*)expect;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_cas_ptr(target, expect, update) == expect;
@@ -97,7 +101,9 @@ bool Atomics::compareAndSet(volatile void** target, void* expect, void* update)
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::getAndSet(volatile int* target, int newValue) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_exchange_n(target, newValue, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     __sync_synchronize();
     return __sync_lock_test_and_set(target, newValue);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -117,7 +123,9 @@ int Atomics::getAndSet(volatile int* target, int newValue) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void* Atomics::getAndSet(volatile void** target, void* newValue) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return (void*) __atomic_exchange_n(target, newValue, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     __sync_synchronize();
     return (void*) __sync_lock_test_and_set(target, newValue);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
@@ -139,7 +147,9 @@ void* Atomics::getAndSet(volatile void** target, void* newValue) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::getAndIncrement(volatile int* target) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_fetch_add(target, 1, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, 1);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, 1) - 1;
@@ -158,7 +168,9 @@ int Atomics::getAndIncrement(volatile int* target) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::getAndDecrement(volatile int* target) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_fetch_sub(target, 1, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, 0xFFFFFFFF);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, 0xFFFFFFFF) + 1;
@@ -177,7 +189,9 @@ int Atomics::getAndDecrement(volatile int* target) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::getAndAdd(volatile int* target, int delta) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_fetch_add(target, delta, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, delta);
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, delta) - delta;
@@ -196,7 +210,9 @@ int Atomics::getAndAdd(volatile int* target, int delta) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::addAndGet(volatile int* target, int delta) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_add_fetch(target, delta, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, delta) + delta;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, delta);
@@ -215,7 +231,9 @@ int Atomics::addAndGet(volatile int* target, int delta) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::incrementAndGet(volatile int* target) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_add_fetch(target, 1, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, 1) + 1;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, 1);
@@ -234,7 +252,9 @@ int Atomics::incrementAndGet(volatile int* target) {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Atomics::decrementAndGet(volatile int* target) {
-#ifdef HAVE_ATOMIC_BUILTINS
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_sub_fetch(target, 1, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
     return __sync_fetch_and_add(target, 0xFFFFFFFF) - 1;
 #elif defined(SOLARIS2) && SOLARIS2 >= 10
     return atomic_add_32_nv((volatile unsigned int*)target, 0xFFFFFFFF);
@@ -251,3 +271,150 @@ int Atomics::decrementAndGet(volatile int* target) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_compare_exchange_n(target, &expect, update, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    return __sync_val_compare_and_swap(target, expect, update) == expect;
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return (long long) atomic_cas_64((volatile uint64_t*)target, expect, update) == expect;
+#else
+    bool result = false;
+    PlatformThread::lockMutex(atomicMutex);
+
+    if (*target == expect) {
+        *target = update;
+        result = true;
+    }
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return result;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getAndAdd64(volatile long long* target, long long delta) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_fetch_add(target, delta, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    return __sync_fetch_and_add(target, delta);
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return (long long) atomic_add_64_nv((volatile uint64_t*)target, delta) - delta;
+#else
+    long long oldValue;
+    PlatformThread::lockMutex(atomicMutex);
+
+    oldValue = *target;
+    *target += delta;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return oldValue;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::addAndGet64(volatile long long* target, long long delta) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_add_fetch(target, delta, __ATOMIC_SEQ_CST);
+#elif defined(HAVE_ATOMIC_BUILTINS)
+    return __sync_fetch_and_add(target, delta) + delta;
+#elif defined(SOLARIS2) && SOLARIS2 >= 10
+    return (long long) atomic_add_64_nv((volatile uint64_t*)target, delta);
+#else
+    long long newValue;
+    PlatformThread::lockMutex(atomicMutex);
+
+    *target += delta;
+    newValue = *target;
+
+    PlatformThread::unlockMutex(atomicMutex);
+
+    return newValue;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::lazySet(volatile int* target, int value) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#else
+    Atomics::getAndSet(target, value);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::lazySet(volatile void** target, void* value) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#else
+    Atomics::getAndSet(target, value);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::getAcquire(volatile int* target) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#else
+    return Atomics::addAndGet(target, 0);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* Atomics::getAcquire(volatile void** target) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return (void*) __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#else
+    void* value = (void*) *target;
+    while (!Atomics::compareAndSet(target, value, value)) {
+        value = (void*) *target;
+    }
+    return value;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::incrementAndGetRelaxed(volatile int* target) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_add_fetch(target, 1, __ATOMIC_RELAXED);
+#else
+    return Atomics::incrementAndGet(target);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::decrementAndGetRelease(volatile int* target) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    int newValue = __atomic_sub_fetch(target, 1, __ATOMIC_RELEASE);
+    if (newValue == 0) {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    }
+    return newValue;
+#else
+    return Atomics::decrementAndGet(target);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getRelaxed64(volatile long long* target) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+#else
+    return Atomics::addAndGet64(target, 0);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::setRelaxed64(volatile long long* target, long long value) {
+#if defined(HAVE_ATOMIC_MEMORY_MODEL)
+    __atomic_store_n(target, value, __ATOMIC_RELAXED);
+#else
+    long long current = *target;
+    while (!Atomics::compareAndSet64(target, current, value)) {
+        current = *target;
+    }
+#endif
+}
@@ -48,6 +48,10 @@
 #if HAVE_TIME_H
 #include <time.h>
 #endif
+#if defined(__linux__)
+#include <stdio.h>
+#include <stdlib.h>
+#endif
 
 using namespace decaf;
 using namespace decaf::lang;
@@ -462,6 +466,137 @@ void PlatformThread::setStackSize(decaf_thread_t thread DECAF_UNUSED, long long
     pthread_attr_destroy( &attributes );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool PlatformThread::setAffinity(decaf_thread_t thread, const std::vector<int>& cpus) {
+
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP) && defined(CPU_SET)
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    if (cpus.empty()) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &cpuSet);
+        }
+    } else {
+        std::vector<int>::const_iterator iter = cpus.begin();
+        for (; iter != cpus.end(); ++iter) {
+            if (*iter >= 0 && *iter < CPU_SETSIZE) {
+                CPU_SET(*iter, &cpuSet);
+            }
+        }
+    }
+
+    // The kernel drops the processors that aren't online and fails only when
+    // none of the requested ones are.
+    return pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    (void) thread;
+    (void) cpus;
+    return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+#if defined(__linux__)
+
+    // Parses the kernel's cpulist format, ranges separated by commas: "0-3,8,10-11".
+    void parseCpuList(const char* list, std::vector<int>& cpus) {
+
+        const char* current = list;
+
+        while (*current != '\0') {
+
+            char* end = NULL;
+            long first = strtol(current, &end, 10);
+            if (end == current) {
+                break;
+            }
+
+            long last = first;
+            if (*end == '-') {
+                current = end + 1;
+                last = strtol(current, &end, 10);
+                if (end == current) {
+                    break;
+                }
+            }
+
+            for (long cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back((int) cpu);
+            }
+
+            current = end;
+            if (*current != ',') {
+                break;
+            }
+            ++current;
+        }
+    }
+
+    bool readNodeCpuList(int node, std::vector<int>& cpus) {
+
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+        FILE* file = fopen(path, "r");
+        if (file == NULL) {
+            return false;
+        }
+
+        char buffer[1024];
+        bool result = fgets(buffer, sizeof(buffer), file) != NULL;
+        fclose(file);
+
+        if (result) {
+            parseCpuList(buffer, cpus);
+        }
+
+        return result;
+    }
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PlatformThread::getNumaNodeCount() {
+
+#if defined(__linux__)
+    int count = 0;
+    std::vector<int> cpus;
+    while (readNodeCpuList(count, cpus)) {
+        count++;
+    }
+
+    return count > 0 ? count : 1;
+#else
+    return 1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PlatformThread::getNumaNodeProcessors(int node, std::vector<int>& cpus) {
+
+    cpus.clear();
+
+#if defined(__linux__)
+    if (node >= 0 && readNodeCpuList(node, cpus)) {
+        return;
+    }
+#endif
+
+    // Without any topology information every processor is on the one node.
+    if (node == 0) {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back((int) cpu);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PlatformThread::yeild() {
 
@@ -474,6 +609,18 @@ void PlatformThread::yeild() {
     #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void PlatformThread::spinPause() {
+
+    #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+        __asm__ __volatile__ ("pause" ::: "memory");
+    #elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+        __asm__ __volatile__ ("yield" ::: "memory");
+    #elif defined(__GNUC__)
+        __asm__ __volatile__ ("" ::: "memory");
+    #endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PlatformThread::createTlsKey(decaf_tls_key* tlsKey) {
     pthread_key_create(tlsKey, NULL);
@@ -79,3 +79,57 @@ int Atomics::decrementAndGet(volatile int* target) {
     return ::InterlockedExchangeAdd((volatile LONG*)target, 0xFFFFFFFF) - 1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool Atomics::compareAndSet64(volatile long long* target, long long expect, long long update) {
+    return ::InterlockedCompareExchange64((volatile LONGLONG*)target, update, expect) == expect;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getAndAdd64(volatile long long* target, long long delta) {
+    return ::InterlockedExchangeAdd64((volatile LONGLONG*)target, delta);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::addAndGet64(volatile long long* target, long long delta) {
+    return ::InterlockedExchangeAdd64((volatile LONGLONG*)target, delta) + delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::lazySet(volatile int* target, int value) {
+    ::InterlockedExchange((volatile LONG*)target, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::lazySet(volatile void** target, void* value) {
+    InterlockedExchangePointer((volatile PVOID*)target, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::getAcquire(volatile int* target) {
+    return ::InterlockedCompareExchange((volatile LONG*)target, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* Atomics::getAcquire(volatile void** target) {
+    return InterlockedCompareExchangePointer((volatile PVOID*)target, NULL, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::incrementAndGetRelaxed(volatile int* target) {
+    return ::InterlockedIncrement((volatile LONG*)target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Atomics::decrementAndGetRelease(volatile int* target) {
+    return ::InterlockedDecrement((volatile LONG*)target);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Atomics::getRelaxed64(volatile long long* target) {
+    return ::InterlockedCompareExchange64((volatile LONGLONG*)target, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Atomics::setRelaxed64(volatile long long* target, long long value) {
+    ::InterlockedExchange64((volatile LONGLONG*)target, value);
+}
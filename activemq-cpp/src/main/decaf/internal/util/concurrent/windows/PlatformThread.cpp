@@ -422,11 +422,75 @@ long long PlatformThread::getStackSize(decaf_thread_t thread DECAF_UNUSED) {
 void PlatformThread::setStackSize(decaf_thread_t thread DECAF_UNUSED, long long stackSize DECAF_UNUSED) {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool PlatformThread::setAffinity(decaf_thread_t thread, const std::vector<int>& cpus) {
+
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask) == 0) {
+        return false;
+    }
+
+    DWORD_PTR mask = 0;
+
+    if (cpus.empty()) {
+        mask = processMask;
+    } else {
+        std::vector<int>::const_iterator iter = cpus.begin();
+        for (; iter != cpus.end(); ++iter) {
+            if (*iter >= 0 && *iter < (int) (sizeof(DWORD_PTR) * 8)) {
+                mask |= ((DWORD_PTR) 1) << *iter;
+            }
+        }
+        mask &= processMask;
+    }
+
+    if (mask == 0) {
+        return false;
+    }
+
+    return ::SetThreadAffinityMask(thread, mask) != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int PlatformThread::getNumaNodeCount() {
+
+    ULONG highestNode = 0;
+    if (::GetNumaHighestNodeNumber(&highestNode) == 0) {
+        return 1;
+    }
+
+    return (int) highestNode + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PlatformThread::getNumaNodeProcessors(int node, std::vector<int>& cpus) {
+
+    cpus.clear();
+
+    ULONGLONG mask = 0;
+    if (node < 0 || node > 0xFF || ::GetNumaNodeProcessorMask((UCHAR) node, &mask) == 0) {
+        return;
+    }
+
+    for (int cpu = 0; cpu < 64; ++cpu) {
+        if ((mask & (((ULONGLONG) 1) << cpu)) != 0) {
+            cpus.push_back(cpu);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PlatformThread::yeild() {
     SwitchToThread();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void PlatformThread::spinPause() {
+    YieldProcessor();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void PlatformThread::createTlsKey(decaf_tls_key* tlsKey) {
     if (tlsKey == NULL) {
@@ -18,18 +18,20 @@
 #include "BufferedInputStream.h"
 
 #include <decaf/lang/System.h>
+#include <decaf/internal/io/BufferPool.h>
 
 #include <algorithm>
 
 using namespace std;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::internal::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
 BufferedInputStream::BufferedInputStream(InputStream* stream, bool own) :
-    FilterInputStream(stream, own), pos(0), count(0), markLimit(-1), markPos(-1), bufferSize(8192), buff(new unsigned char[bufferSize]), proxyBuffer(buff) {
+    FilterInputStream(stream, own), pos(0), count(0), markLimit(-1), markPos(-1), bufferSize(8192), buff(BufferPool::allocate(bufferSize)), proxyBuffer(buff) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,7 +42,7 @@ BufferedInputStream::BufferedInputStream(InputStream* stream, int bufferSize, bo
         throw new IllegalArgumentException(__FILE__, __LINE__, "Size must be greater than zero");
     }
 
-    this->buff = new unsigned char[bufferSize];
+    this->buff = BufferPool::allocate(bufferSize);
     this->proxyBuffer = this->buff;
 }
 
@@ -51,7 +53,7 @@ BufferedInputStream::~BufferedInputStream() {
     }
     DECAF_CATCHALL_NOTHROW()
 
-    delete[] this->buff;
+    BufferPool::release(this->buff);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -295,6 +297,20 @@ long long BufferedInputStream::skip(long long amount) {
     DECAF_CATCHALL_THROW( IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* BufferedInputStream::readContiguous(int length) {
+
+    unsigned char* lbuffer = this->proxyBuffer;
+
+    if (lbuffer == NULL || length < 0 || (this->count - this->pos) < length) {
+        return NULL;
+    }
+
+    const unsigned char* window = lbuffer + this->pos;
+    this->pos += length;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int BufferedInputStream::bufferData(InputStream* inputStream, unsigned char*& buffer) {
 
@@ -321,10 +337,10 @@ int BufferedInputStream::bufferData(InputStream* inputStream, unsigned char*& bu
                 newLength = markLimit;
             }
 
-            unsigned char* temp = new unsigned char[newLength];
+            unsigned char* temp = BufferPool::allocate(newLength);
             System::arraycopy(temp, 0, buffer, 0, count);
             std::swap(temp, buffer);
-            delete[] temp;
+            BufferPool::release(temp);
             this->bufferSize = newLength;
 
             if (this->proxyBuffer != NULL) {
@@ -93,6 +93,13 @@ namespace io{
          */
         virtual long long skip(long long num);
 
+        /**
+         * {@inheritDoc}
+         *
+         * Only bytes already in the buffer are returned, the wrapped stream is never read.
+         */
+        virtual const unsigned char* readContiguous(int length);
+
         /**
          * {@inheritDoc}
          */
@@ -19,10 +19,14 @@
 
 #include <decaf/lang/System.h>
 #include <decaf/lang/Math.h>
+#include <decaf/internal/io/BufferPool.h>
+
+#include <vector>
 
 using namespace std;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::internal::io;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
@@ -53,7 +57,7 @@ BufferedOutputStream::~BufferedOutputStream() {
     }
     DECAF_CATCHALL_NOTHROW()
 
-    delete [] buffer;
+    BufferPool::release(buffer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,7 +69,7 @@ void BufferedOutputStream::init(int bufSize) {
 
     this->bufferSize = bufSize;
 
-    buffer = new unsigned char[bufSize];
+    buffer = BufferPool::allocate(bufSize);
     head = tail = 0;
 }
 
@@ -86,6 +90,35 @@ void BufferedOutputStream::emptyBuffer() {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void BufferedOutputStream::writeThrough(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    if (this->outputStream == NULL) {
+        throw IOException(__FILE__, __LINE__, "BufferedOutputStream::emptyBuffer - OutputStream is closed");
+    }
+
+    try {
+
+        std::vector<const unsigned char*> allBuffers;
+        std::vector<int> allLengths;
+        allBuffers.reserve(count + 1);
+        allLengths.reserve(count + 1);
+
+        if (this->head != this->tail) {
+            allBuffers.push_back(this->buffer + this->head);
+            allLengths.push_back(this->tail - this->head);
+        }
+
+        allBuffers.insert(allBuffers.end(), buffers, buffers + count);
+        allLengths.insert(allLengths.end(), lengths, lengths + count);
+
+        this->outputStream->writeArrays(&allBuffers[0], &allLengths[0], (int) allBuffers.size());
+        this->head = this->tail = 0;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void BufferedOutputStream::flush() {
 
@@ -196,3 +229,35 @@ void BufferedOutputStream::doWriteArrayBounded(const unsigned char* buffer, int
     DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferedOutputStream::doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        long long total = checkArrays(buffers, lengths, count);
+        if (total == 0) {
+            return;
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "BufferedOutputStream::write - Stream is clsoed");
+        }
+
+        if (total > bufferSize - tail) {
+            writeThrough(buffers, lengths, count);
+            return;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (lengths[i] > 0) {
+                System::arraycopy(buffers[i], 0, this->buffer, this->tail, lengths[i]);
+                tail += lengths[i];
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
@@ -97,6 +97,8 @@ namespace io{
 
         virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
 
+        virtual void doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
     private:
 
         /**
@@ -112,6 +114,13 @@ namespace io{
          */
         void emptyBuffer();
 
+        /**
+         * Writes the contents of the buffer followed by the given arrays to the output
+         * stream in a single call, leaving the buffer empty.  This is used for writes
+         * that don't fit in the buffer so that their data isn't copied through it.
+         */
+        void writeThrough(const unsigned char* const* buffers, const int* lengths, int count);
+
     };
 
 }}
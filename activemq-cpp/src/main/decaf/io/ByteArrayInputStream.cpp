@@ -178,6 +178,18 @@ int ByteArrayInputStream::doReadArrayBounded(unsigned char* buffer, int size, in
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* ByteArrayInputStream::readContiguous(int length) {
+
+    if (this->buffer == NULL || length < 0 || this->count - this->pos < length) {
+        return NULL;
+    }
+
+    const unsigned char* window = this->buffer + this->pos;
+    this->pos += length;
+    return window;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long ByteArrayInputStream::skip(long long num) {
 
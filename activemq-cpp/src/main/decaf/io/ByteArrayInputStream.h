@@ -200,6 +200,11 @@ namespace io{
          */
         virtual long long skip(long long num);
 
+        /**
+         * {@inheritDoc}
+         */
+        virtual const unsigned char* readContiguous(int length);
+
         /**
          * {@inheritDoc}
          */
@@ -18,6 +18,7 @@
 #include <decaf/io/DataInputStream.h>
 
 #include <decaf/io/PushbackInputStream.h>
+#include <decaf/internal/util/StringUtils.h>
 
 #ifdef HAVE_STRING_H
 #include <string.h>
@@ -30,9 +31,74 @@ using namespace std;
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::util;
+using namespace decaf::internal::util;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Number of bytes the bulk reads take from the underlying stream at a time.
+    const int BLOCK_SIZE = 512;
+
+    // The shifts below are the form GCC, Clang and MSVC recognize and turn into a
+    // single load and byte swap on little-endian targets.
+    struct ShortCodec {
+        typedef short Type;
+        static short load(const unsigned char* src) {
+            return (short) (((unsigned short) src[0] << 8) | (unsigned short) src[1]);
+        }
+    };
+
+    struct IntCodec {
+        typedef int Type;
+        static int load(const unsigned char* src) {
+            return (int) (((unsigned int) src[0] << 24) | ((unsigned int) src[1] << 16) |
+                          ((unsigned int) src[2] << 8) | (unsigned int) src[3]);
+        }
+    };
+
+    struct LongCodec {
+        typedef long long Type;
+        static long long load(const unsigned char* src) {
+            return (long long) (((unsigned long long) src[0] << 56) | ((unsigned long long) src[1] << 48) |
+                                ((unsigned long long) src[2] << 40) | ((unsigned long long) src[3] << 32) |
+                                ((unsigned long long) src[4] << 24) | ((unsigned long long) src[5] << 16) |
+                                ((unsigned long long) src[6] << 8) | (unsigned long long) src[7]);
+        }
+    };
+
+    template<typename Codec>
+    void readValues(DataInputStream* dataIn, typename Codec::Type* values, int count) {
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "count parameter out of Bounds: %d.", count);
+        }
+
+        if (values == NULL && count != 0) {
+            throw NullPointerException(__FILE__, __LINE__, "DataInputStream::readValues - passed values array is Null");
+        }
+
+        const int valueSize = (int) sizeof(typename Codec::Type);
+        const int valuesPerBlock = BLOCK_SIZE / valueSize;
+
+        unsigned char block[BLOCK_SIZE];
+
+        for (int index = 0; index < count;) {
+
+            int blockCount = count - index < valuesPerBlock ? count - index : valuesPerBlock;
+
+            dataIn->readFully(block, BLOCK_SIZE, 0, blockCount * valueSize);
+
+            for (int i = 0; i < blockCount; ++i) {
+                values[index + i] = Codec::load(block + i * valueSize);
+            }
+
+            index += blockCount;
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 DataInputStream::DataInputStream(InputStream* inputStream, bool own) :
     FilterInputStream(inputStream, own), buffer() {
@@ -239,67 +305,25 @@ std::string DataInputStream::readUTF() {
             return "";
         }
 
-        std::vector<unsigned char> buffer(utfLength);
-        std::vector<unsigned char> result(utfLength);
-
-        this->readFully(&buffer[0], utfLength);
-
-        std::size_t count = 0;
-        std::size_t index = 0;
-        unsigned char a = 0;
-
-        while (count < utfLength) {
-            if ((result[index] = buffer[count++]) < 0x80) {
-                index++;
-            } else if (((a = result[index]) & 0xE0) == 0xC0) {
-                if (count >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of two byte char found at end.");
-                }
-
-                unsigned char b = buffer[count++];
-                if ((b & 0xC0) != 0x80) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, byte two does not start with 0x80.");
-                }
-
-                // 2-byte UTF8 encoding: 110X XXxx 10xx xxxx
-                // Bits set at 'X' means we have encountered a UTF8 encoded value
-                // greater than 255, which is not supported.
-                if (a & 0x1C) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 2 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
-
-                result[index++] = (unsigned char) (((a & 0x1F) << 6) | (b & 0x3F));
-
-            } else if ((a & 0xF0) == 0xE0) {
-
-                if (count + 1 >= utfLength) {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, start of three byte char found at end.");
-                } else {
-                    throw UTFDataFormatException(__FILE__, __LINE__, "Invalid 3 byte UTF-8 encoding found, "
-                            "This method only supports encoded ASCII values of (0-255).");
-                }
+        // When the stream holds the encoded bytes the string is built from them where
+        // they are, an ASCII string needs no decoding at all.
+        const unsigned char* encoded = inputStream->readContiguous(utfLength);
+        if (encoded != NULL && StringUtils::unencodedSpan(encoded, utfLength) == utfLength) {
+            return std::string((const char*) encoded, utfLength);
+        }
 
-                // If we were to support multibyte strings in the future this would be
-                // the remainder of this method decoding logic.
-                //
-                //int b = buffer[count++];
-                //int c = buffer[count++];
-                //if( ( ( b & 0xC0 ) != 0x80 ) || ( ( c & 0xC0 ) != 0x80 ) ) {
-                //    throw UTFDataFormatException(
-                //        __FILE__, __LINE__,
-                //        "Invalid UTF-8 encoding found, byte two does not start with 0x80." );
-                //}
-                //
-                //result[inde++] = ( ( a & 0x0F ) << 12 ) |
-                //                 ( ( b & 0x3F ) << 6 ) | ( c & 0x3F );
+        std::string text(utfLength, '\0');
+        unsigned char* decoded = (unsigned char*) &text[0];
 
-            } else {
-                throw UTFDataFormatException(__FILE__, __LINE__, "Invalid UTF-8 encoding found, aborting.");
-            }
+        // Decoded characters are never longer than their encoding, so the bytes can be
+        // read into the string and decoded in place.
+        if (encoded == NULL) {
+            this->readFully(decoded, utfLength);
+            encoded = decoded;
         }
 
-        return std::string((char*) (&result[0]), index);
+        text.resize(StringUtils::decodeModifiedUtf8(encoded, utfLength, decoded));
+        return text;
     }
     DECAF_CATCH_RETHROW(UTFDataFormatException)
     DECAF_CATCH_RETHROW(EOFException)
@@ -456,6 +480,16 @@ long long DataInputStream::skipBytes(long long num) {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* DataInputStream::readContiguous(int length) {
+
+    if (inputStream == NULL) {
+        return NULL;
+    }
+
+    return inputStream->readContiguous(length);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void DataInputStream::readAllData(unsigned char* buffer, int length) {
 
@@ -474,3 +508,42 @@ void DataInputStream::readAllData(unsigned char* buffer, int length) {
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStream::readShorts(short* values, int count) {
+
+    try {
+        readValues<ShortCodec>(this, values, count);
+    }
+    DECAF_CATCH_RETHROW(EOFException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStream::readInts(int* values, int count) {
+
+    try {
+        readValues<IntCodec>(this, values, count);
+    }
+    DECAF_CATCH_RETHROW(EOFException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStream::readLongs(long long* values, int count) {
+
+    try {
+        readValues<LongCodec>(this, values, count);
+    }
+    DECAF_CATCH_RETHROW(EOFException)
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
@@ -336,6 +336,63 @@ namespace io{
          */
         virtual long long skipBytes(long long num);
 
+        /**
+         * {@inheritDoc}
+         *
+         * This stream holds no data of its own, the bytes are the ones the wrapped
+         * stream holds contiguously.
+         */
+        virtual const unsigned char* readContiguous(int length);
+
+        /**
+         * Reads count short values written in the form used by readShort into the
+         * given array.  The bytes are read from the underlying stream in blocks
+         * rather than one value at a time.
+         *
+         * @param values
+         *      The array that receives the values, it must hold at least count values.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws IOException if an I/O Error occurs.
+         * @throws EOFException if the end of input is reached before count values are read.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void readShorts(short* values, int count);
+
+        /**
+         * Reads count int values written in the form used by readInt into the given
+         * array, in blocks.
+         *
+         * @param values
+         *      The array that receives the values, it must hold at least count values.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws IOException if an I/O Error occurs.
+         * @throws EOFException if the end of input is reached before count values are read.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void readInts(int* values, int count);
+
+        /**
+         * Reads count long long values written in the form used by readLong into the
+         * given array, in blocks.
+         *
+         * @param values
+         *      The array that receives the values, it must hold at least count values.
+         * @param count
+         *      The number of values to read.
+         *
+         * @throws IOException if an I/O Error occurs.
+         * @throws EOFException if the end of input is reached before count values are read.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void readLongs(long long* values, int count);
+
     private:
 
         // Used internally to reliably get data from the underlying stream
@@ -18,14 +18,96 @@
 #include <decaf/io/DataOutputStream.h>
 #include <decaf/io/UTFDataFormatException.h>
 #include <decaf/util/Config.h>
+#include <decaf/internal/util/StringUtils.h>
 #include <string.h>
 #include <stdio.h>
 
 using namespace decaf;
 using namespace decaf::io;
 using namespace decaf::util;
+using namespace decaf::internal::util;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Number of bytes the bulk writes convert on the stack before each write to the
+    // underlying stream.
+    const int BLOCK_SIZE = 512;
+
+    // The shifts below are the form GCC, Clang and MSVC recognize and turn into a
+    // single byte swap and store on little-endian targets.
+    struct ShortCodec {
+        typedef short Type;
+        static void store(unsigned char* dest, short value) {
+            unsigned short uvalue = (unsigned short) value;
+            dest[0] = (unsigned char) (uvalue >> 8);
+            dest[1] = (unsigned char) (uvalue);
+        }
+    };
+
+    struct IntCodec {
+        typedef int Type;
+        static void store(unsigned char* dest, int value) {
+            unsigned int uvalue = (unsigned int) value;
+            dest[0] = (unsigned char) (uvalue >> 24);
+            dest[1] = (unsigned char) (uvalue >> 16);
+            dest[2] = (unsigned char) (uvalue >> 8);
+            dest[3] = (unsigned char) (uvalue);
+        }
+    };
+
+    struct LongCodec {
+        typedef long long Type;
+        static void store(unsigned char* dest, long long value) {
+            unsigned long long uvalue = (unsigned long long) value;
+            dest[0] = (unsigned char) (uvalue >> 56);
+            dest[1] = (unsigned char) (uvalue >> 48);
+            dest[2] = (unsigned char) (uvalue >> 40);
+            dest[3] = (unsigned char) (uvalue >> 32);
+            dest[4] = (unsigned char) (uvalue >> 24);
+            dest[5] = (unsigned char) (uvalue >> 16);
+            dest[6] = (unsigned char) (uvalue >> 8);
+            dest[7] = (unsigned char) (uvalue);
+        }
+    };
+
+    template<typename Codec>
+    long long writeValues(OutputStream* outputStream, const typename Codec::Type* values, int count) {
+
+        if (outputStream == NULL) {
+            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
+        }
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "count parameter out of Bounds: %d.", count);
+        }
+
+        if (values == NULL && count != 0) {
+            throw NullPointerException(__FILE__, __LINE__, "DataOutputStream::write - passed values array is Null");
+        }
+
+        const int valueSize = (int) sizeof(typename Codec::Type);
+        const int valuesPerBlock = BLOCK_SIZE / valueSize;
+
+        unsigned char block[BLOCK_SIZE];
+
+        for (int index = 0; index < count;) {
+
+            int blockCount = count - index < valuesPerBlock ? count - index : valuesPerBlock;
+
+            for (int i = 0; i < blockCount; ++i) {
+                Codec::store(block + i * valueSize, values[index + i]);
+            }
+
+            outputStream->write(block, BLOCK_SIZE, 0, blockCount * valueSize);
+            index += blockCount;
+        }
+
+        return (long long) count * valueSize;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 DataOutputStream::DataOutputStream(OutputStream* outputStream, bool own) :
     FilterOutputStream(outputStream, own), written(0) {
@@ -78,7 +160,11 @@ void DataOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size
     }
 
     try {
-        outputStream->write(buffer, size, offset, length);
+        // Written as a single array write so that a buffered stream can send an array
+        // that doesn't fit in its buffer along with what it holds rather than copying
+        // the array through the buffer.
+        const unsigned char* start = buffer + offset;
+        outputStream->writeArrays(&start, &length, 1);
         written += length;
     }
     DECAF_CATCH_RETHROW(IOException)
@@ -87,6 +173,29 @@ void DataOutputStream::doWriteArrayBounded(const unsigned char* buffer, int size
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStream::doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        long long total = checkArrays(buffers, lengths, count);
+        if (total == 0) {
+            return;
+        }
+
+        if (isClosed()) {
+            throw IOException(__FILE__, __LINE__, "DataOutputStream::write - Base stream is Null");
+        }
+
+        outputStream->writeArrays(buffers, lengths, count);
+        written += total;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void DataOutputStream::writeBoolean(bool value) {
     try {
@@ -273,40 +382,31 @@ void DataOutputStream::writeUTF(const std::string& value) {
 
     try {
 
-        unsigned int utfLength = this->countUTFLength(value);
+        const unsigned char* data = (const unsigned char*) value.c_str();
+        std::size_t length = value.length();
+
+        // Strings without zero or values above 127 are their own encoding and are
+        // written from the string as they are.
+        std::size_t span = StringUtils::unencodedSpan(data, length);
+        std::size_t utfLength = span == length ? length : span + StringUtils::modifiedUtf8Length(data + span, length - span);
 
         if (utfLength > 65535) {
             throw UTFDataFormatException(__FILE__, __LINE__, "Attempted to write a string as UTF-8 whose length is longer "
                     "than the supported 65535 bytes");
         }
 
-        std::size_t length = value.length();
-        std::vector<unsigned char> utfBytes((std::size_t) utfLength);
-        unsigned int utfIndex = 0;
-
-        for (std::size_t i = 0; i < length; i++) {
-
-            unsigned int charValue = (unsigned char) value.at(i);
-
-            // Written to allow for expansion to wide character strings at some
-            // point, as it stands now the value can never be > 255 since the
-            // string class returns a single byte char.
-            if (charValue > 0 && charValue <= 127) {
-                utfBytes[utfIndex++] = (unsigned char) charValue;
-            } else if (charValue <= 2047) {
-                utfBytes[utfIndex++] = (unsigned char) (0xc0 | (0x1f & (charValue >> 6)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
-            } else {
-                utfBytes[utfIndex++] = (unsigned char) (0xe0 | (0x0f & (charValue >> 12)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & (charValue >> 6)));
-                utfBytes[utfIndex++] = (unsigned char) (0x80 | (0x3f & charValue));
+        this->writeUnsignedShort((unsigned short) utfLength);
+
+        if (span == length) {
+            if (length > 0) {
+                this->write(data, (int) length, 0, (int) length);
             }
+            return;
         }
 
-        this->writeUnsignedShort((unsigned short) utfLength);
-        if (utfLength > 0) {
-            this->write(&utfBytes[0], utfIndex, 0, utfIndex);
-        }
+        std::vector<unsigned char> utfBytes(utfLength);
+        StringUtils::encodeModifiedUtf8(data, length, &utfBytes[0]);
+        this->write(&utfBytes[0], (int) utfLength, 0, (int) utfLength);
     }
     DECAF_CATCH_RETHROW(UTFDataFormatException)
     DECAF_CATCH_RETHROW(IOException)
@@ -315,25 +415,41 @@ void DataOutputStream::writeUTF(const std::string& value) {
 
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int DataOutputStream::countUTFLength(const std::string& value) {
+    return (unsigned int) StringUtils::modifiedUtf8Length((const unsigned char*) value.c_str(), value.length());
+}
 
-    unsigned int utfCount = 0;
-    std::size_t length = value.length();
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStream::writeShorts(const short* values, int count) {
 
-    for (std::size_t i = 0; i < length; ++i) {
+    try {
+        written += writeValues<ShortCodec>(outputStream, values, count);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
 
-        unsigned int charValue = (unsigned char) value.at(i);
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStream::writeInts(const int* values, int count) {
 
-        // Written to allow for expansion to wide character strings at some
-        // point, as it stands now the value can never be > 255 since the
-        // string class returns a single byte char.
-        if (charValue > 0 && charValue <= 127) {
-            utfCount++;
-        } else if (charValue <= 2047) {
-            utfCount += 2;
-        } else {
-            utfCount += 3;
-        }
+    try {
+        written += writeValues<IntCodec>(outputStream, values, count);
     }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStream::writeLongs(const long long* values, int count) {
 
-    return utfCount;
+    try {
+        written += writeValues<LongCodec>(outputStream, values, count);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
 }
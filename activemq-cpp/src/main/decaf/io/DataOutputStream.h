@@ -128,12 +128,61 @@ namespace io{
          */
         virtual void writeUTF(const std::string& value);
 
+        /**
+         * Writes count short values from the given array to the underlying output
+         * stream in the same big-endian form as writeShort.  The values are converted
+         * in blocks so that the underlying stream is written once per block instead
+         * of once per value.
+         *
+         * @param values
+         *      The array of values to write.
+         * @param count
+         *      The number of values to write from the array.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void writeShorts(const short* values, int count);
+
+        /**
+         * Writes count int values from the given array to the underlying output
+         * stream in the same big-endian form as writeInt, in blocks.
+         *
+         * @param values
+         *      The array of values to write.
+         * @param count
+         *      The number of values to write from the array.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void writeInts(const int* values, int count);
+
+        /**
+         * Writes count long long values from the given array to the underlying output
+         * stream in the same big-endian form as writeLong, in blocks.
+         *
+         * @param values
+         *      The array of values to write.
+         * @param count
+         *      The number of values to write from the array.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         */
+        virtual void writeLongs(const long long* values, int count);
+
     protected:
 
         virtual void doWriteByte(unsigned char value);
 
         virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
 
+        virtual void doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
     private:
 
         // Determine the encoded length of a string when written as modified UTF-8
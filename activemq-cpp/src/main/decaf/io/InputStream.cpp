@@ -20,6 +20,9 @@
 #include <typeinfo>
 
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/nio/ByteBuffer.h>
+
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::io;
@@ -86,6 +89,48 @@ int InputStream::read(unsigned char* buffer, int size, int offset, int length) {
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int InputStream::read(decaf::nio::ByteBuffer& buffer) {
+
+    try {
+
+        if (buffer.isReadOnly()) {
+            throw decaf::nio::ReadOnlyBufferException(__FILE__, __LINE__, "Can't read into a read-only buffer.");
+        }
+
+        int length = buffer.remaining();
+        if (length == 0) {
+            return 0;
+        }
+
+        int result = 0;
+
+        if (buffer.hasArray()) {
+            int offset = buffer.arrayOffset() + buffer.position();
+            result = this->doReadArrayBounded(buffer.array(), offset + length, offset, length);
+            if (result > 0) {
+                buffer.position(buffer.position() + result);
+            }
+        } else {
+            std::vector<unsigned char> temp(length);
+            result = this->doReadArrayBounded(&temp[0], length, 0, length);
+            if (result > 0) {
+                buffer.put(&temp[0], length, 0, result);
+            }
+        }
+
+        return result;
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(decaf::nio::ReadOnlyBufferException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const unsigned char* InputStream::readContiguous(int length DECAF_UNUSED) {
+    return NULL;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long InputStream::skip(long long num) {
 
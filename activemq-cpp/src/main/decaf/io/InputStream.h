@@ -28,6 +28,9 @@
 #include <decaf/util/Config.h>
 
 namespace decaf{
+namespace nio{
+    class ByteBuffer;
+}
 namespace io{
 
     /**
@@ -232,6 +235,23 @@ namespace io{
          */
         virtual int read(unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Reads up to remaining() bytes of data from the input stream into the given
+         * buffer at its position, which is then incremented by the number of bytes read.
+         * A buffer with a backing array, as a direct buffer, is read into without an
+         * intermediate copy.  Blocks as read( buffer, size, offset, length ) does.
+         *
+         * @param buffer
+         *      The buffer to read the data into.
+         *
+         * @return The number of bytes read, zero if the buffer has no room left, or -1
+         *         if EOF is detected.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws ReadOnlyBufferException if the buffer is read-only.
+         */
+        virtual int read(decaf::nio::ByteBuffer& buffer);
+
         /**
          * Skips over and discards n bytes of data from this input stream. The skip
          * method may, for a variety of reasons, end up skipping over some smaller
@@ -255,6 +275,25 @@ namespace io{
          */
         virtual long long skip(long long num);
 
+        /**
+         * Moves past the next length bytes of the stream and returns where they are held
+         * when the stream already has all of them in one contiguous block of memory, so
+         * that a caller can decode them where they are instead of copying them out.
+         *
+         * The default implementation returns NULL, streams that don't hold their data in
+         * memory never have such a block.
+         *
+         * @param length
+         *      The number of bytes wanted.
+         *
+         * @return a pointer to the bytes, valid until the stream is next read, reset or
+         *         closed, or NULL if they aren't all held contiguously, in which case
+         *         nothing was consumed.
+         *
+         * @throws IOException if an I/O error occurs.
+         */
+        virtual const unsigned char* readContiguous(int length);
+
         /**
          * Output a String representation of this object.
          *
@@ -21,6 +21,9 @@
 
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/nio/ByteBuffer.h>
+
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::io;
@@ -82,6 +85,42 @@ void OutputStream::write(const unsigned char* buffer, int size, int offset, int
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void OutputStream::write(decaf::nio::ByteBuffer& buffer) {
+
+    try {
+
+        int length = buffer.remaining();
+        if (length == 0) {
+            return;
+        }
+
+        if (buffer.hasArray() && !buffer.isReadOnly()) {
+            int offset = buffer.arrayOffset() + buffer.position();
+            this->doWriteArrayBounded(buffer.array(), offset + length, offset, length);
+            buffer.position(buffer.limit());
+        } else {
+            std::vector<unsigned char> temp(length);
+            buffer.get(&temp[0], length, 0, length);
+            this->doWriteArrayBounded(&temp[0], length, 0, length);
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutputStream::writeArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+        this->doWriteArrays(buffers, lengths, count);
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OutputStream::doWriteArray(const unsigned char* buffer, int size) {
 
@@ -121,3 +160,55 @@ void OutputStream::doWriteArrayBounded(const unsigned char* buffer, int size, in
     DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(IOException)
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OutputStream::doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    try {
+
+        checkArrays(buffers, lengths, count);
+
+        for (int i = 0; i < count; ++i) {
+            if (lengths[i] > 0) {
+                this->doWriteArrayBounded(buffers[i], lengths[i], 0, lengths[i]);
+            }
+        }
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long OutputStream::checkArrays(const unsigned char* const* buffers, const int* lengths, int count) {
+
+    if (count < 0) {
+        throw IndexOutOfBoundsException(__FILE__, __LINE__, "count parameter out of Bounds: %d.", count);
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    if (buffers == NULL || lengths == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "OutputStream::writeArrays - passed arrays are Null.");
+    }
+
+    long long total = 0;
+
+    for (int i = 0; i < count; ++i) {
+
+        if (lengths[i] < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "length parameter out of Bounds: %d.", lengths[i]);
+        }
+
+        if (buffers[i] == NULL && lengths[i] != 0) {
+            throw NullPointerException(__FILE__, __LINE__, "OutputStream::writeArrays - passed buffer is Null.");
+        }
+
+        total += lengths[i];
+    }
+
+    return total;
+}
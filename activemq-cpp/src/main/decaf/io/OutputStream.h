@@ -29,6 +29,9 @@
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
 
 namespace decaf{
+namespace nio{
+    class ByteBuffer;
+}
 namespace io{
 
     /**
@@ -126,6 +129,42 @@ namespace io{
          */
         virtual void write(const unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Writes the bytes remaining in the given buffer, from its position to its limit,
+         * to the output stream and moves its position to its limit.  A writable buffer
+         * with a backing array, as a direct buffer, is written without an intermediate
+         * copy.
+         *
+         * @param buffer
+         *      The buffer holding the data to write.
+         *
+         * @throws IOException if an I/O error occurs.
+         */
+        virtual void write(decaf::nio::ByteBuffer& buffer);
+
+        /**
+         * Writes several arrays of bytes to the output stream as if by calling write once
+         * for each of them in order, this allows a stream that can send the arrays in a
+         * single operation, such as a socket with a vectored write, to do so without the
+         * caller first copying them into one contiguous buffer.
+         *
+         * The default implementation of this method simply calls doWriteArrays which
+         * writes each array in turn using the doWriteArrayBounded method.
+         *
+         * @param buffers
+         *      The arrays of bytes to write.
+         * @param lengths
+         *      The number of bytes to write from each of the arrays.
+         * @param count
+         *      The number of arrays passed.
+         *
+         * @throws IOException if an I/O error occurs.
+         * @throws NullPointerException thrown if buffers, lengths or one of the arrays
+         *         that has a non-zero length is Null.
+         * @throws IndexOutOfBoundsException if count or one of the lengths is negative.
+         */
+        virtual void writeArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
         /**
          * Output a String representation of this object.
          *
@@ -143,6 +182,19 @@ namespace io{
 
         virtual void doWriteArrayBounded(const unsigned char* buffer, int size, int offset, int length);
 
+        virtual void doWriteArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
+        /**
+         * Checks the arguments given to writeArrays, for use by subclasses that provide
+         * their own doWriteArrays implementation.
+         *
+         * @return the total number of bytes in the arrays.
+         *
+         * @throws NullPointerException if buffers, lengths or a non-empty array is Null.
+         * @throws IndexOutOfBoundsException if count or one of the lengths is negative.
+         */
+        static long long checkArrays(const unsigned char* const* buffers, const int* lengths, int count);
+
     public:
 
         virtual void lock() {
@@ -154,10 +154,7 @@ AbstractStringBuilder::AbstractStringBuilder(int capacity) : impl() {
 AbstractStringBuilder::AbstractStringBuilder(const String& source) :
     impl(new AbstractStringBuilderImpl(source.length() + INITIAL_CAPACITY)) {
 
-    for (int i = 0; i < source.length(); ++i) {
-        impl->value[i] = source.charAt(i);
-    }
-
+    source.getChars(0, source.length(), impl->value.get(), 0);
     impl->length = source.length();
 }
 
@@ -165,10 +162,7 @@ AbstractStringBuilder::AbstractStringBuilder(const String& source) :
 AbstractStringBuilder::AbstractStringBuilder(const std::string& source) :
     impl(new AbstractStringBuilderImpl((int)source.length() + INITIAL_CAPACITY)) {
 
-    for (int i = 0; i < (int) source.length(); ++i) {
-        impl->value[i] = source.at(i);
-    }
-
+    System::arraycopy(source.data(), 0, impl->value.get(), 0, source.length());
     impl->length = (int) source.length();
 }
 
@@ -184,10 +178,7 @@ AbstractStringBuilder::AbstractStringBuilder(const CharSequence* source) : impl(
 
     impl = new AbstractStringBuilderImpl(capacity + INITIAL_CAPACITY);
 
-    for (int i = 0; i < (int) src.length(); ++i) {
-        impl->value[i] = src.at(i);
-    }
-
+    System::arraycopy(src.data(), 0, impl->value.get(), 0, src.length());
     impl->length = (int) src.length();
 }
 
@@ -319,10 +310,8 @@ void AbstractStringBuilder::doAppend(const std::string& value) {
     int length = (int) value.length();
     int newLength = impl->length + length;
     impl->ensureCapacity(newLength);
-
-    for (int i = 0; i < length; ++i) {
-        impl->value[impl->length++] = value.at(i);
-    }
+    System::arraycopy(value.data(), 0, impl->value.get(), impl->length, length);
+    impl->length = newLength;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -445,11 +434,7 @@ void AbstractStringBuilder::doInsert(int index, const std::string& value) {
 
     if (stringLength != 0) {
         impl->move(stringLength, index);
-
-        for (int i = 0; i < stringLength; ++i) {
-            impl->value[index++] = value.at(i);
-        }
-
+        System::arraycopy(value.data(), 0, impl->value.get(), index, stringLength);
         impl->length += stringLength;
     }
 }
@@ -817,7 +802,7 @@ String AbstractStringBuilder::substring(int start) const {
         }
 
         // Remove String sharing for more performance
-        return String(impl->value.get(), start, impl->length - start);
+        return String(impl->value.get(), impl->length, start, impl->length - start);
     }
     throw StringIndexOutOfBoundsException(__FILE__, __LINE__, start);
 }
@@ -831,7 +816,7 @@ String AbstractStringBuilder::substring(int start, int end) const {
         }
 
         // Remove String sharing for more performance
-        return String(impl->value.get(), start, end - start);
+        return String(impl->value.get(), impl->length, start, end - start);
     }
 
     throw StringIndexOutOfBoundsException(__FILE__, __LINE__,
@@ -850,18 +835,9 @@ String AbstractStringBuilder::toString() const {
         return "";
     }
 
-    int wasted = impl->value.length() - 1 - impl->length;
-    if (wasted >= 256 || (wasted >= INITIAL_CAPACITY && wasted >= (impl->length >> 1))) {
-        return String(impl->value.get(), 0, impl->length);
-    }
-
-    impl->shared = true;
-
-    // TODO optimize so that internal data can be shared with the returned String
-    //      and discarded only after a new mutating method call is made.
-    //      ensure the shared flag is set once we do this.
-
-    return String(impl->value.get(), 0, impl->length);
+    // The String always takes a copy, short results are held inline and never touch
+    // the heap, so the buffer isn't marked shared and later appends can keep using it.
+    return String(impl->value.get(), impl->length, 0, impl->length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
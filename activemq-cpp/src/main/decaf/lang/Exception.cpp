@@ -15,11 +15,13 @@
  * limitations under the License.
  */
 #include <stdio.h>
+#include <string.h>
 #include "Exception.h"
 #include <decaf/util/logging/LoggerDefines.h>
 #include <decaf/internal/AprPool.h>
 #include <decaf/lang/Pointer.h>
 
+#include <deque>
 #include <sstream>
 #include <apr_strings.h>
 
@@ -46,13 +48,76 @@ namespace lang {
         decaf::lang::Pointer<const std::exception> cause;
 
         /**
-         * The stack trace.
+         * A point where the exception was marked.  A file name known to be a literal
+         * is kept as is, any other is copied into files.
+         */
+        struct Mark {
+            const char* file;
+            int line;
+            bool copied;
+        };
+
+        /**
+         * The most marks kept, an exception marked more often keeps the first ones
+         * and counts the others.
+         */
+        static const int MAX_MARKS = 32;
+
+        Mark marks[MAX_MARKS];
+        int markCount;
+        int droppedMarks;
+
+        /**
+         * The copied file names of marks, a deque so that adding one doesn't move
+         * those the marks point to.
+         */
+        std::deque<std::string> files;
+
+        /**
+         * A trace given to setStackTrace, it comes before the marks set since.
          */
         std::vector< std::pair< std::string, int> > stackTrace;
 
     public:
 
-        ExceptionData() : message(), cause(NULL), stackTrace() {}
+        ExceptionData() : message(), cause(NULL), markCount(0), droppedMarks(0), files(), stackTrace() {}
+
+        void addMark(const char* file, int line, bool literal) {
+
+            if (this->markCount == MAX_MARKS) {
+                this->droppedMarks++;
+                return;
+            }
+
+            Mark& mark = this->marks[this->markCount++];
+            if (literal) {
+                mark.file = file;
+            } else {
+                this->files.push_back(file != NULL ? file : "");
+                mark.file = this->files.back().c_str();
+            }
+            mark.line = line;
+            mark.copied = !literal;
+        }
+
+        void clearMarks() {
+            this->markCount = 0;
+            this->droppedMarks = 0;
+            this->files.clear();
+        }
+
+        void copyMarks(const ExceptionData& other) {
+
+            if (this == &other) {
+                return;
+            }
+
+            clearMarks();
+            for (int i = 0; i < other.markCount; ++i) {
+                addMark(other.marks[i].file, other.marks[i].line, !other.marks[i].copied);
+            }
+            this->droppedMarks = other.droppedMarks;
+        }
 
     };
 
@@ -117,6 +182,12 @@ void Exception::setMessage(const char* msg, ...) {
 ////////////////////////////////////////////////////////////////////////////////
 void Exception::buildMessage(const char* format, va_list& vargs) {
 
+    // Most messages are plain text, they don't need a pool to be formatted.
+    if (strchr(format, '%') == NULL) {
+        this->data->message.assign(format);
+        return;
+    }
+
     // Allocate buffer with a guess of it's size
     AprPool pool;
 
@@ -129,8 +200,13 @@ void Exception::buildMessage(const char* format, va_list& vargs) {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Exception::setMark(const char* file, const int lineNumber) {
-    // Add this mark to the end of the stack trace.
-    this->data->stackTrace.push_back(std::make_pair(std::string(file), (int) lineNumber));
+    this->data->addMark(file, lineNumber, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Exception::setMarkLiteral(const char* file, const int lineNumber) {
+    // The trace strings are only built if someone asks for them.
+    this->data->addMark(file, lineNumber, true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,12 +216,22 @@ Exception* Exception::clone() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 std::vector<std::pair<std::string, int> > Exception::getStackTrace() const {
-    return this->data->stackTrace;
+
+    std::vector<std::pair<std::string, int> > trace(this->data->stackTrace);
+    trace.reserve(trace.size() + this->data->markCount);
+
+    for (int i = 0; i < this->data->markCount; ++i) {
+        const ExceptionData::Mark& mark = this->data->marks[i];
+        trace.push_back(std::make_pair(std::string(mark.file), mark.line));
+    }
+
+    return trace;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Exception::setStackTrace(const std::vector<std::pair<std::string, int> >& trace) {
     this->data->stackTrace = trace;
+    this->data->clearMarks();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +257,14 @@ std::string Exception::getStackTraceString() const {
         stream << ", LINE: " << this->data->stackTrace[ix].second;
         stream << std::endl;
     }
+    for (int ix = 0; ix < this->data->markCount; ++ix) {
+        stream << "\tFILE: " << this->data->marks[ix].file;
+        stream << ", LINE: " << this->data->marks[ix].line;
+        stream << std::endl;
+    }
+    if (this->data->droppedMarks > 0) {
+        stream << "\t... " << this->data->droppedMarks << " more" << std::endl;
+    }
 
     // Return the string from the output stream.
     return stream.str();
@@ -180,6 +274,7 @@ std::string Exception::getStackTraceString() const {
 Exception& Exception::operator =(const Exception& ex) {
     this->data->message = ex.data->message;
     this->data->stackTrace = ex.data->stackTrace;
+    this->data->copyMarks(*ex.data);
     this->data->cause = ex.data->cause;
     return *this;
 }
@@ -149,7 +149,8 @@ namespace lang {
         virtual void setMessage(const char* msg, ...);
 
         /**
-         * Adds a file/line number to the stack trace.
+         * Adds a file/line number to the stack trace.  The first 32 marks are kept,
+         * later ones are counted.
          *
          * @param file
          *      The name of the file calling this method (use __FILE__).
@@ -158,6 +159,19 @@ namespace lang {
          */
         virtual void setMark(const char* file, const int lineNumber);
 
+        /**
+         * Adds a file/line number to the stack trace like setMark but keeps only the
+         * pointer to the file name instead of copying it, so the name has to remain
+         * valid for the life of the exception as a __FILE__ literal does.  Used by
+         * the exception macros.
+         *
+         * @param file
+         *      The name of the file calling this method, a string literal.
+         * @param lineNumber
+         *      The line number in the calling file (use __LINE__).
+         */
+        void setMarkLiteral(const char* file, const int lineNumber);
+
         /**
          * Clones this exception.  This is useful for cases where you need
          * to preserve the type of the original exception as well as the message.
@@ -212,6 +226,18 @@ namespace lang {
 
    };
 
+    /**
+     * Marks the exception with a file name literal, used by the exception macros so
+     * that the file name is only copied for a Throwable that is not an Exception.
+     */
+    inline void markWithLiteral(Exception& ex, const char* file, const int lineNumber) {
+        ex.setMarkLiteral(file, lineNumber);
+    }
+
+    inline void markWithLiteral(Throwable& ex, const char* file, const int lineNumber) {
+        ex.setMark(file, lineNumber);
+    }
+
 }}
 
 #endif /*_DECAF_LANG_EXCEPTION_EXCEPTION_H_*/
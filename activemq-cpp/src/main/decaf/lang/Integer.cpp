@@ -400,17 +400,19 @@ int Integer::lowestOneBit(int value) {
 int Integer::numberOfLeadingZeros(int value) {
 
     if (value == 0) {
-        return 0;
+        return 32;
     }
 
+    // Smear the highest one-bit into every lower position, the zeros left above
+    // it are the leading zeros.
     unsigned int uvalue = (unsigned int) value;
 
-    value |= value >> 1;
-    value |= value >> 2;
-    value |= value >> 4;
-    value |= value >> 8;
-    value |= value >> 16;
-    return Integer::bitCount(~uvalue);
+    uvalue |= uvalue >> 1;
+    uvalue |= uvalue >> 2;
+    uvalue |= uvalue >> 4;
+    uvalue |= uvalue >> 8;
+    uvalue |= uvalue >> 16;
+    return Integer::bitCount((int) ~uvalue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
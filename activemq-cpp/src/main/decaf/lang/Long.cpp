@@ -19,6 +19,12 @@
 #include <decaf/lang/Character.h>
 #include <sstream>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#pragma intrinsic(_BitScanForward64, _BitScanReverse64)
+#define DECAF_HAVE_BITSCAN64
+#endif
+
 using namespace decaf;
 using namespace decaf::lang;
 
@@ -59,6 +65,11 @@ int Long::bitCount(long long value) {
 
     unsigned long long uvalue = (unsigned long long) value;
 
+#if defined(__GNUC__)
+    // A single instruction when the target has one, a table lookup otherwise.
+    return __builtin_popcountll(uvalue);
+#else
+
     uvalue = (uvalue & 0x5555555555555555LL) + ((uvalue >> 1) & 0x5555555555555555LL);
     uvalue = (uvalue & 0x3333333333333333LL) + ((uvalue >> 2) & 0x3333333333333333LL);
     // adjust for 64-bit integer
@@ -67,6 +78,7 @@ int Long::bitCount(long long value) {
     i = (i & 0x00FF00FF) + ((i >> 8) & 0x00FF00FF);
     i = (i & 0x0000FFFF) + ((i >> 16) & 0x0000FFFF);
     return i;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -144,28 +156,47 @@ long long Long::lowestOneBit(long long value) {
 int Long::numberOfLeadingZeros(long long value) {
 
     if (value == 0) {
-        return 0;
+        return 64;
     }
 
     unsigned long long uvalue = (unsigned long long) value;
 
-    value |= value >> 1;
-    value |= value >> 2;
-    value |= value >> 4;
-    value |= value >> 8;
-    value |= value >> 16;
-    value |= value >> 32;
-    return Long::bitCount(~uvalue);
+#if defined(__GNUC__)
+    return __builtin_clzll(uvalue);
+#elif defined(DECAF_HAVE_BITSCAN64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, uvalue);
+    return 63 - (int) index;
+#else
+    // Smear the highest one-bit into every lower position, the zeros left above
+    // it are the leading zeros.
+    uvalue |= uvalue >> 1;
+    uvalue |= uvalue >> 2;
+    uvalue |= uvalue >> 4;
+    uvalue |= uvalue >> 8;
+    uvalue |= uvalue >> 16;
+    uvalue |= uvalue >> 32;
+    return Long::bitCount((long long) ~uvalue);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int Long::numberOfTrailingZeros(long long value) {
     if (value == 0) {
-        return 0;
+        return 64;
     }
 
     unsigned long long uvalue = (unsigned long long) value;
-    return Long::bitCount((uvalue & (-1 * uvalue)) - 1);
+
+#if defined(__GNUC__)
+    return __builtin_ctzll(uvalue);
+#elif defined(DECAF_HAVE_BITSCAN64)
+    unsigned long index = 0;
+    _BitScanForward64(&index, uvalue);
+    return (int) index;
+#else
+    return Long::bitCount((long long) ((uvalue & (0 - uvalue)) - 1));
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,12 +35,21 @@ namespace lang {
     struct STATIC_CAST_TOKEN {};
     struct DYNAMIC_CAST_TOKEN {};
 
+    /**
+     * Called when a Pointer takes ownership of a new value, a Reference Counter type
+     * can provide an overload of this function to attach itself to the value, for
+     * instance to use a count that is stored in the object.  The default does nothing.
+     */
+    template<typename REFCOUNTER>
+    inline void initializeReferenceCounter(REFCOUNTER& refCounter DECAF_UNUSED, const void* value DECAF_UNUSED) {}
+
     /**
      * Decaf's implementation of a Smart Pointer that is a template on a Type
      * and is Thread Safe if the default Reference Counter is used.  This Pointer
      * type allows for the substitution of different Reference Counter implementations
      * which provide a means of using invasive reference counting if desired using
-     * a custom implementation of <code>ReferenceCounter</code>.
+     * a custom implementation of <code>ReferenceCounter</code>.  The default counter
+     * is invasive for types derived from AtomicRefCounted.
      * <p>
      * The Decaf smart pointer provide comparison operators for comparing Pointer
      * instances in the same manner as normal pointer, except that it does not provide
@@ -85,7 +94,9 @@ namespace lang {
          * @param value -
          *      The instance of the type we are containing here.
          */
-        explicit Pointer(const PointerType value) : REFCOUNTER(), value(value), onDelete(onDeleteFunc) {}
+        explicit Pointer(const PointerType value) : REFCOUNTER(), value(value), onDelete(onDeleteFunc) {
+            initializeReferenceCounter(static_cast<REFCOUNTER&>(*this), value);
+        }
 
         /**
          * Copy constructor. Copies the value contained in the pointer to the new
@@ -381,6 +392,30 @@ namespace lang {
 
     };
 
+    /**
+     * Equality function object that compares the values being Pointed to rather than
+     * the contained pointers, it is the counterpart of PointerComparator for hashed
+     * collections such as ConcurrentHashMap whose keys are Pointer instances.  Two NULL
+     * Pointers are equal, otherwise the type must provide a workable operator ==.
+     */
+    template<typename T, typename R = decaf::util::concurrent::atomic::AtomicRefCounter>
+    class PointerEquals {
+    public:
+
+        bool operator()(const Pointer<T, R>& left, const Pointer<T, R>& right) const {
+            if (left.get() == right.get()) {
+                return true;
+            }
+
+            if (left == NULL || right == NULL) {
+                return false;
+            }
+
+            return *left == *right;
+        }
+
+    };
+
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include <decaf/lang/Double.h>
 
 #include <decaf/internal/util/StringUtils.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 
 using namespace std;
 using namespace decaf;
@@ -37,56 +38,124 @@ using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::internal;
 using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace decaf {
 namespace lang {
 
-    class Contents {
-    public:
+    /**
+     * Header of a heap allocated character array, the characters follow it in the
+     * same allocation so that a shared array costs a single allocation.
+     */
+    struct String::SharedChars {
+        volatile int refs;
 
-        ArrayPointer<char> value;
-        int length;
-        int offset;
-        int hashCode;
+        char* chars() {
+            return reinterpret_cast<char*>(this) + sizeof(SharedChars);
+        }
+    };
 
-    public:
+}}
 
-        /**
-         * Contents as empty string.
-         */
-        Contents() : value(), length(0), offset(0), hashCode(0) {}
+////////////////////////////////////////////////////////////////////////////////
+String::Chars::Chars(int size) : data(local), shared(NULL), size(size) {
 
-        /**
-         * Contents created with the given length, the array is length + 1 to add the
-         * null terminating character.
-         */
-        Contents(int length) : value(length + 1), length(length), offset(0), hashCode(0) {
-            value[length] = 0;  // Null terminated
-        }
+    if (size > INLINE_CAPACITY) {
+        char* block = new char[sizeof(SharedChars) + size];
+        this->shared = reinterpret_cast<SharedChars*>(block);
+        this->shared->refs = 1;
+        this->data = this->shared->chars();
+    }
+}
 
-        /**
-         * Contents is a view of some other String which can either be all or a
-         * window allowing for substring methods to not need to copy the contents.
-         */
-        Contents(int offset, int length, ArrayPointer<char> value) :
-            value(value), length(length), offset(offset), hashCode(0) {}
-    };
+////////////////////////////////////////////////////////////////////////////////
+String::Chars::Chars(const Chars& source) : data(local), shared(source.shared), size(source.size) {
 
-}}
+    if (this->shared != NULL) {
+        Atomics::incrementAndGetRelaxed(&this->shared->refs);
+        this->data = source.data;
+    } else {
+        System::arraycopy(source.local, 0, this->local, 0, INLINE_CAPACITY);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+String::Chars::~Chars() {
+    release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+String::Chars& String::Chars::operator= (const Chars& source) {
+
+    if (this == &source) {
+        return *this;
+    }
+
+    if (source.shared != NULL) {
+        Atomics::incrementAndGetRelaxed(&source.shared->refs);
+    }
+
+    release();
+
+    this->shared = source.shared;
+    this->size = source.size;
+
+    if (this->shared != NULL) {
+        this->data = source.data;
+    } else {
+        this->data = this->local;
+        System::arraycopy(source.local, 0, this->local, 0, INLINE_CAPACITY);
+    }
+
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void String::Chars::release() {
+
+    if (this->shared != NULL && Atomics::decrementAndGetRelease(&this->shared->refs) == 0) {
+        delete [] reinterpret_cast<char*>(this->shared);
+    }
+
+    this->shared = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+String::Contents::Contents() : value(), length(0), offset(0), hashCode(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+String::Contents::Contents(int length) : value(length + 1), length(length), offset(0), hashCode(0) {
+    value[length] = 0;  // Null terminated
+}
+
+////////////////////////////////////////////////////////////////////////////////
+String::Contents::Contents(int offset, int length, const Chars& value) :
+    value(value), length(length), offset(offset), hashCode(0) {
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 String::String(Contents* content) :
-    contents(new Contents(0, content->length, content->value)) {
+    contents(0, content->length, content->value) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-String::String(int offset, int length, const ArrayPointer<char> content) :
-    contents(new Contents(offset, length, content)) {
+String::String(int offset, int length, const Contents& content) : contents() {
+
+    // A short view is copied inline rather than keeping the whole array alive.
+    if (length < Chars::INLINE_CAPACITY) {
+        if (length > 0) {
+            contents = Contents(length);
+            System::arraycopy(content.value.get(), offset, contents.value.get(), 0, length);
+        }
+    } else {
+        contents = Contents(offset, length, content.value);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-String::String() : contents(new Contents()) {
+String::String() : contents() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,21 +166,21 @@ String::String(const char value, int count) : contents() {
             __FILE__, __LINE__, "count parameter out of Bounds: %d.", count);
     }
 
-    contents = new Contents(count);
+    contents = Contents(count);
     for (int i = 0; i < count; ++i) {
-        contents->value[i] = value;
+        contents.value[i] = value;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-String::String(const String& source) : contents(new Contents(*source.contents)) {
+String::String(const String& source) : contents(source.contents) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-String::String(const std::string& source) : contents(new Contents((int)source.length())) {
+String::String(const std::string& source) : contents((int)source.length()) {
 
     // load the passed string into the contents value.
-    System::arraycopy(source.c_str(), 0, contents->value.get(), 0, source.length());
+    System::arraycopy(source.c_str(), 0, contents.value.get(), 0, source.length());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -125,10 +194,10 @@ String::String(const char* array) : contents() {
     int size = StringUtils::stringLength(array);
 
     if (size > 0) {
-        this->contents = new Contents(size);
-        System::arraycopy(array, 0, contents->value.get(), 0, size);
+        this->contents = Contents(size);
+        System::arraycopy(array, 0, contents.value.get(), 0, size);
     } else {
-        this->contents = new Contents();
+        this->contents = Contents();
     }
 }
 
@@ -146,10 +215,10 @@ String::String(const char* array, int size) : contents() {
     }
 
     if (size > 0) {
-        this->contents = new Contents(size);
-        System::arraycopy(array, 0, contents->value.get(), 0, size);
+        this->contents = Contents(size);
+        System::arraycopy(array, 0, contents.value.get(), 0, size);
     } else {
-        this->contents = new Contents();
+        this->contents = Contents();
     }
 }
 
@@ -174,10 +243,10 @@ String::String(const char* array, int offset, int length) : contents() {
     }
 
     if (size > 0 && length > 0) {
-        this->contents = new Contents(length);
-        System::arraycopy(array, offset, contents->value.get(), 0, length);
+        this->contents = Contents(length);
+        System::arraycopy(array, offset, contents.value.get(), 0, length);
     } else {
-        this->contents = new Contents();
+        this->contents = Contents();
     }
 }
 
@@ -205,28 +274,20 @@ String::String(const char* array, int size, int offset, int length) : contents()
     }
 
     if (size > 0 && length > 0) {
-        this->contents = new Contents(length);
-        System::arraycopy(array, offset, contents->value.get(), 0, length);
+        this->contents = Contents(length);
+        System::arraycopy(array, offset, contents.value.get(), 0, length);
     } else {
-        this->contents = new Contents();
+        this->contents = Contents();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 String::~String() {
-    try {
-        delete this->contents;
-    }
-    DECAF_CATCH_NOTHROW(Exception)
-    DECAF_CATCHALL_NOTHROW()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 String& String::operator= (const String& other) {
-    contents->value = other.contents->value;
-    contents->length = other.contents->length;
-    contents->offset = other.contents->offset;
-    contents->hashCode = other.contents->hashCode;
+    contents = other.contents;
 
     return *this;
 }
@@ -234,14 +295,12 @@ String& String::operator= (const String& other) {
 ////////////////////////////////////////////////////////////////////////////////
 String& String::operator= (const std::string& other) {
 
-    delete contents;
-
     if (!other.empty()) {
         int length = (int) other.length();
-        contents = new Contents(length);
-        System::arraycopy(other.c_str(), 0, contents->value.get(), 0, length);
+        contents = Contents(length);
+        System::arraycopy(other.c_str(), 0, contents.value.get(), 0, length);
     } else {
-        contents = new Contents();
+        contents = Contents();
     }
 
     return *this;
@@ -255,12 +314,11 @@ String& String::operator= (const char* other) {
     }
 
     int length = StringUtils::stringLength(other);
-    delete contents;
     if (length > 0) {
-        contents = new Contents(length);
-        System::arraycopy(other, 0, contents->value.get(), 0, length);
+        contents = Contents(length);
+        System::arraycopy(other, 0, contents.value.get(), 0, length);
     } else {
-        contents = new Contents();
+        contents = Contents();
     }
 
     return *this;
@@ -374,24 +432,24 @@ String String::operator+ (const char* other) const {
 ////////////////////////////////////////////////////////////////////////////////
 const char* String::c_str() const {
 
-    if (contents->length == 0) {
+    if (contents.length == 0) {
         return "";
     }
 
-    if (contents->length == contents->value.length() - 1) {
-        return (const char*) (contents->value.get() + contents->offset);
+    // Views that run to the end of the array share its NULL terminator.
+    if (contents.offset + contents.length == contents.value.length() - 1) {
+        return (const char*) (contents.value.get() + contents.offset);
     }
 
-    Contents* newContents = new Contents(contents->length);
+    Contents newContents(contents.length);
 
-    System::arraycopy(contents->value.get(), contents->offset,
-                      newContents->value.get(), 0, contents->length);
+    System::arraycopy(contents.value.get(), contents.offset,
+                      newContents.value.get(), 0, contents.length);
 
-    Contents* oldContents = this->contents;
+    newContents.hashCode = contents.hashCode;
     this->contents = newContents;
-    delete oldContents;
 
-    return contents->value.get();
+    return contents.value.get();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -404,7 +462,7 @@ char String::charAt(int index) const {
                 __FILE__, __LINE__, "Index given is out of bounds: %d.", index);
         }
 
-        return this->contents->value[this->contents->offset + index];
+        return this->contents.value[this->contents.offset + index];
     }
     DECAF_CATCH_RETHROW(StringIndexOutOfBoundsException)
     DECAF_CATCHALL_THROW(StringIndexOutOfBoundsException)
@@ -414,13 +472,13 @@ char String::charAt(int index) const {
 String String::compact() const {
 
     // Empty String.
-    if (contents->value.length() == 0) {
+    if (contents.value.length() == 0) {
         return *this;
     }
 
     // Don't do anything if the string is already compact.
-    if (contents->value.length() > this->contents->length + 1) {
-        return String(contents->value.get(), contents->offset, contents->length);
+    if (contents.value.length() > this->contents.length + 1) {
+        return String(contents.value.get(), contents.offset, contents.length);
     }
 
     return *this;
@@ -429,39 +487,39 @@ String String::compact() const {
 ////////////////////////////////////////////////////////////////////////////////
 int String::compareTo(const String& string) const {
 
-    int o1 = contents->offset;
-    int o2 = string.contents->offset;
+    int o1 = contents.offset;
+    int o2 = string.contents.offset;
     int result;
 
-    int end = contents->offset +
-        (contents->length < string.contents->length ? contents->length : string.contents->length);
+    int end = contents.offset +
+        (contents.length < string.contents.length ? contents.length : string.contents.length);
 
     while (o1 < end) {
-        if ((result = contents->value[o1++] - string.contents->value[o2++]) != 0) {
+        if ((result = contents.value[o1++] - string.contents.value[o2++]) != 0) {
             return result;
         }
     }
 
-    return contents->length - string.contents->length;
+    return contents.length - string.contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::compareTo(const std::string& string) const {
 
-    int o1 = contents->offset;
+    int o1 = contents.offset;
     int o2 = 0;
     int result;
 
-    int end = contents->offset +
-        (contents->length < (int) string.length() ? contents->length : (int) string.length());
+    int end = contents.offset +
+        (contents.length < (int) string.length() ? contents.length : (int) string.length());
 
     while (o1 < end) {
-        if ((result = contents->value[o1++] - string.at(o2++)) != 0) {
+        if ((result = contents.value[o1++] - string.at(o2++)) != 0) {
             return result;
         }
     }
 
-    return contents->length - (int)string.length();
+    return contents.length - (int)string.length();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -473,35 +531,35 @@ int String::compareTo(const char* string) const {
 
     int length = StringUtils::stringLength(string);
 
-    int o1 = contents->offset;
+    int o1 = contents.offset;
     int o2 = 0;
     int result;
 
-    int end = contents->offset +
-        (contents->length < length ? contents->length : length);
+    int end = contents.offset +
+        (contents.length < length ? contents.length : length);
 
     while (o1 < end) {
-        if ((result = contents->value[o1++] - string[o2++]) != 0) {
+        if ((result = contents.value[o1++] - string[o2++]) != 0) {
             return result;
         }
     }
 
-    return contents->length - length;
+    return contents.length - length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::compareToIgnoreCase(const String& string) const {
 
-    int o1 = contents->offset;
-    int o2 = string.contents->offset;
+    int o1 = contents.offset;
+    int o2 = string.contents.offset;
     int result;
 
-    int end = contents->offset +
-        (contents->length < string.contents->length ? contents->length : string.contents->length);
+    int end = contents.offset +
+        (contents.length < string.contents.length ? contents.length : string.contents.length);
     char c1, c2;
 
     while (o1 < end) {
-        if ((c1 = contents->value[o1++]) == (c2 = string.contents->value[o2++])) {
+        if ((c1 = contents.value[o1++]) == (c2 = string.contents.value[o2++])) {
             continue;
         }
         c1 = Character::toLowerCase(c1);
@@ -511,22 +569,22 @@ int String::compareToIgnoreCase(const String& string) const {
         }
     }
 
-    return contents->length - string.contents->length;
+    return contents.length - string.contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::compareToIgnoreCase(const std::string& string) const {
 
-    int o1 = contents->offset;
+    int o1 = contents.offset;
     int o2 = 0;
     int result;
 
-    int end = contents->offset +
-        (contents->length < (int) string.length() ? contents->length : (int) string.length());
+    int end = contents.offset +
+        (contents.length < (int) string.length() ? contents.length : (int) string.length());
     char c1, c2;
 
     while (o1 < end) {
-        if ((c1 = contents->value[o1++]) == (c2 = string.at(o2++))) {
+        if ((c1 = contents.value[o1++]) == (c2 = string.at(o2++))) {
             continue;
         }
         c1 = Character::toLowerCase(c1);
@@ -536,7 +594,7 @@ int String::compareToIgnoreCase(const std::string& string) const {
         }
     }
 
-    return contents->length - (int) string.length();
+    return contents.length - (int) string.length();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -548,15 +606,15 @@ int String::compareToIgnoreCase(const char* string) const {
 
     int length = StringUtils::stringLength(string);
 
-    int o1 = contents->offset;
+    int o1 = contents.offset;
     int o2 = 0;
     int result;
 
-    int end = contents->offset + (contents->length < length ? contents->length : length);
+    int end = contents.offset + (contents.length < length ? contents.length : length);
     char c1, c2;
 
     while (o1 < end) {
-        if ((c1 = contents->value[o1++]) == (c2 = string[o2++])) {
+        if ((c1 = contents.value[o1++]) == (c2 = string[o2++])) {
             continue;
         }
         c1 = Character::toLowerCase(c1);
@@ -566,7 +624,7 @@ int String::compareToIgnoreCase(const char* string) const {
         }
     }
 
-    return contents->length - length;
+    return contents.length - length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -590,19 +648,19 @@ String String::copyValueOf(char* data, int start, int length) {
 ////////////////////////////////////////////////////////////////////////////////
 String String::concat(const String& string) const {
 
-    if (string.contents->length == 0) {
+    if (string.contents.length == 0) {
         return *this;
     }
 
-    Contents buffer(contents->length + string.contents->length);
+    Contents buffer(contents.length + string.contents.length);
 
-    if (contents->length > 0) {
-        System::arraycopy(contents->value.get(), contents->offset,
-                          buffer.value.get(), 0, contents->length);
+    if (contents.length > 0) {
+        System::arraycopy(contents.value.get(), contents.offset,
+                          buffer.value.get(), 0, contents.length);
     }
 
-    System::arraycopy(string.contents->value.get(), string.contents->offset,
-                      buffer.value.get(), contents->length, string.contents->length);
+    System::arraycopy(string.contents.value.get(), string.contents.offset,
+                      buffer.value.get(), contents.length, string.contents.length);
 
     return String(&buffer);
 }
@@ -614,14 +672,14 @@ String String::concat(const std::string& string) const {
         return *this;
     }
 
-    Contents buffer(contents->length + (int) string.length());
+    Contents buffer(contents.length + (int) string.length());
 
-    if (contents->length > 0) {
-        System::arraycopy(contents->value.get(), contents->offset,
-                          buffer.value.get(), 0, contents->length);
+    if (contents.length > 0) {
+        System::arraycopy(contents.value.get(), contents.offset,
+                          buffer.value.get(), 0, contents.length);
     }
 
-    System::arraycopy(string.c_str(), 0, buffer.value.get(), contents->length, string.length());
+    System::arraycopy(string.c_str(), 0, buffer.value.get(), contents.length, string.length());
 
     return String(&buffer);
 }
@@ -639,14 +697,14 @@ String String::concat(const char* string) const {
         return *this;
     }
 
-    Contents buffer(contents->length + length);
+    Contents buffer(contents.length + length);
 
-    if (contents->length > 0) {
-        System::arraycopy(contents->value.get(), contents->offset,
-                          buffer.value.get(), 0, contents->length);
+    if (contents.length > 0) {
+        System::arraycopy(contents.value.get(), contents.offset,
+                          buffer.value.get(), 0, contents.length);
     }
 
-    System::arraycopy(string, 0, buffer.value.get(), contents->length, length);
+    System::arraycopy(string, 0, buffer.value.get(), contents.length, length);
 
     return String(&buffer);
 }
@@ -668,7 +726,7 @@ bool String::contains(const char* string) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 bool String::endsWith(const String& suffix) const {
-    return regionMatches(contents->length - suffix.contents->length, suffix, 0, suffix.contents->length);
+    return regionMatches(contents.length - suffix.contents.length, suffix, 0, suffix.contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -688,15 +746,15 @@ bool String::equals(const String& other) const {
 
     // Don't force compute hash code on this instance, if not already done
     // we will just do a straight compare.
-    int hashCode = contents->hashCode;
-    int otherHashCode = other.contents->hashCode;
+    int hashCode = contents.hashCode;
+    int otherHashCode = other.contents.hashCode;
 
     if (hashCode != otherHashCode && hashCode != 0 && otherHashCode != 0) {
         return false;
     }
 
-    for (int i = 0; i < contents->length; ++i) {
-        if (contents->value[contents->offset + i] != other.contents->value[other.contents->offset + i]) {
+    for (int i = 0; i < contents.length; ++i) {
+        if (contents.value[contents.offset + i] != other.contents.value[other.contents.offset + i]) {
             return false;
         }
     }
@@ -715,8 +773,8 @@ bool String::equals(const std::string& other) const {
         return false;
     }
 
-    for (int i = 0; i < contents->length; ++i) {
-        if (contents->value[contents->offset + i] != (unsigned char) other.at(i)) {
+    for (int i = 0; i < contents.length; ++i) {
+        if (contents.value[contents.offset + i] != (unsigned char) other.at(i)) {
             return false;
         }
     }
@@ -735,8 +793,8 @@ bool String::equals(const char* other) const {
         return false;
     }
 
-    for (int i = 0; i < contents->length; ++i) {
-        if (contents->value[contents->offset + i] != (unsigned char) other[i]) {
+    for (int i = 0; i < contents.length; ++i) {
+        if (contents.value[contents.offset + i] != (unsigned char) other[i]) {
             return false;
         }
     }
@@ -750,19 +808,19 @@ bool String::equalsIgnoreCase(const String& string) const {
         return true;
     }
 
-    if (contents->length != string.contents->length) {
+    if (contents.length != string.contents.length) {
         return false;
     }
 
-    int offsetThis = contents->offset;
-    int offsetOther = string.contents->offset;
-    int end = contents->offset + contents->length;
+    int offsetThis = contents.offset;
+    int offsetOther = string.contents.offset;
+    int end = contents.offset + contents.length;
 
     char c1, c2;
-    ArrayPointer<char> target = string.contents->value;
+    const Chars& target = string.contents.value;
 
     while (offsetThis < end) {
-        if ((c1 = contents->value[offsetThis++]) != (c2 = target[offsetOther++])) {
+        if ((c1 = contents.value[offsetThis++]) != (c2 = target[offsetOther++])) {
             // If we add support for multibyte strings we need to check both cases
             // toUpperCase and toLowerCase because of Unicode.
             if (Character::toUpperCase(c1) != Character::toUpperCase(c2)) {
@@ -776,18 +834,18 @@ bool String::equalsIgnoreCase(const String& string) const {
 ////////////////////////////////////////////////////////////////////////////////
 bool String::equalsIgnoreCase(const std::string& string) const {
 
-    if (contents->length != (int) string.length()) {
+    if (contents.length != (int) string.length()) {
         return false;
     }
 
-    int offsetThis = contents->offset;
-    int end = contents->offset + contents->length;
+    int offsetThis = contents.offset;
+    int end = contents.offset + contents.length;
 
     int indexOther = 0;
     char c1, c2;
 
     while (offsetThis < end) {
-        if ((c1 = contents->value[offsetThis++]) != (c2 = string.at(indexOther++))) {
+        if ((c1 = contents.value[offsetThis++]) != (c2 = string.at(indexOther++))) {
             // If we add support for multibyte strings we need to check both cases
             // toUpperCase and toLowerCase because of Unicode.
             if (Character::toUpperCase(c1) != Character::toUpperCase(c2)) {
@@ -807,18 +865,18 @@ bool String::equalsIgnoreCase(const char* string) const {
 
     int stringLen = StringUtils::stringLength(string);
 
-    if (contents->length != stringLen) {
+    if (contents.length != stringLen) {
         return false;
     }
 
     int indexOther = 0;
-    int offsetThis = contents->offset;
-    int end = contents->offset + contents->length;
+    int offsetThis = contents.offset;
+    int end = contents.offset + contents.length;
 
     char c1, c2;
 
     while (offsetThis < end) {
-        if ((c1 = contents->value[offsetThis++]) != (c2 = string[indexOther++])) {
+        if ((c1 = contents.value[offsetThis++]) != (c2 = string[indexOther++])) {
             // If we add support for multibyte strings we need to check both cases
             // toUpperCase and toLowerCase because of Unicode.
             if (Character::toUpperCase(c1) != Character::toUpperCase(c2)) {
@@ -836,13 +894,13 @@ int String::findFirstOf(const String& chars) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::findFirstOf(const String& chars, int start) const {
-    if (start < contents->length) {
+    if (start < contents.length) {
         if (start < 0) {
             start = 0;
         }
 
-        for (int i = contents->offset + start; i < contents->offset + contents->length; i++) {
-            char c = contents->value[i];
+        for (int i = contents.offset + start; i < contents.offset + contents.length; i++) {
+            char c = contents.value[i];
             if (chars.indexOf(c) != -1) {
                 return i;
             }
@@ -858,13 +916,13 @@ int String::findFirstNotOf(const String& chars) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::findFirstNotOf(const String& chars, int start) const {
-    if (start < contents->length) {
+    if (start < contents.length) {
         if (start < 0) {
             start = 0;
         }
 
-        for (int i = contents->offset + start; i < contents->offset + contents->length; i++) {
-            char c = contents->value[i];
+        for (int i = contents.offset + start; i < contents.offset + contents.length; i++) {
+            char c = contents.value[i];
             if (chars.indexOf(c) == -1) {
                 return i;
             }
@@ -876,7 +934,7 @@ int String::findFirstNotOf(const String& chars, int start) const {
 ////////////////////////////////////////////////////////////////////////////////
 void String::getChars(int srcBegin, int srcEnd, char* dest, int destSize, int destBegin) const {
 
-    if (srcBegin < 0 || srcBegin > srcEnd || srcEnd > contents->length) {
+    if (srcBegin < 0 || srcBegin > srcEnd || srcEnd > contents.length) {
         throw StringIndexOutOfBoundsException(__FILE__, __LINE__,
             "Invalid start or end parameters: %d, %d", srcBegin, srcEnd);
     }
@@ -891,37 +949,37 @@ void String::getChars(int srcBegin, int srcEnd, char* dest, int destSize, int de
     }
 
     // Note: last character not copied!
-    System::arraycopy(contents->value.get(), srcBegin + contents->offset,
+    System::arraycopy(contents.value.get(), srcBegin + contents.offset,
                       dest, destBegin, srcEnd - srcBegin);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void String::getChars(int start, int end, char* buffer, int index) const {
     // NOTE last character not copied!
-    System::arraycopy(contents->value.get(), start + contents->offset, buffer, index, end - start);
+    System::arraycopy(contents.value.get(), start + contents.offset, buffer, index, end - start);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::hashCode() const {
 
-    if (contents->hashCode == 0) {
-        if (contents->length == 0) {
+    if (contents.hashCode == 0) {
+        if (contents.length == 0) {
             return 0;
         }
 
         int hash = 0;
 
-        for (int i = contents->offset; i < contents->length + contents->offset; i++) {
-            hash = contents->value[i] + ((hash << 5) - hash);
+        for (int i = contents.offset; i < contents.length + contents.offset; i++) {
+            hash = contents.value[i] + ((hash << 5) - hash);
         }
-        contents->hashCode = hash;
+        contents.hashCode = hash;
     }
-    return contents->hashCode;
+    return contents.hashCode;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool String::isEmpty() const {
-    return this->contents->length == 0;
+    return this->contents.length == 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -936,14 +994,14 @@ int String::indexOf(char value) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::indexOf(char value, int start) const {
-    if (start < contents->length) {
+    if (start < contents.length) {
         if (start < 0) {
             start = 0;
         }
 
-        for (int i = contents->offset + start; i < contents->offset + contents->length; i++) {
-            if (contents->value[i] == value) {
-                return i - contents->offset;
+        for (int i = contents.offset + start; i < contents.offset + contents.length; i++) {
+            if (contents.value[i] == value) {
+                return i - contents.offset;
             }
         }
     }
@@ -962,28 +1020,28 @@ int String::indexOf(const String& subString, int start) const {
         start = 0;
     }
 
-    int subCount = subString.contents->length;
+    int subCount = subString.contents.length;
     if (subCount > 0) {
-        if (subCount + start > contents->length) {
+        if (subCount + start > contents.length) {
             return -1;
         }
 
-        char* target = subString.contents->value.get();
-        int subOffset = subString.contents->offset;
+        char* target = subString.contents.value.get();
+        int subOffset = subString.contents.offset;
 
         char firstChar = target[subOffset];
         int end = subOffset + subCount;
 
         while (true) {
             int i = indexOf(firstChar, start);
-            if (i == -1 || subCount + i > contents->length) {
+            if (i == -1 || subCount + i > contents.length) {
                 return -1; // handles subCount > length() || start >= length()
             }
 
-            int o1 = contents->offset + i;
+            int o1 = contents.offset + i;
             int o2 = subOffset;
 
-            while (++o2 < end && contents->value[++o1] == target[o2]) {
+            while (++o2 < end && contents.value[++o1] == target[o2]) {
                 // Intentionally empty
             }
             if (o2 == end) {
@@ -993,7 +1051,7 @@ int String::indexOf(const String& subString, int start) const {
         }
     }
 
-    return start < contents->length ? start : contents->length;
+    return start < contents.length ? start : contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1010,7 +1068,7 @@ int String::indexOf(const std::string& subString, int start) const {
 
     int subCount = (int) subString.length();
     if (subCount > 0) {
-        if (subCount + start > contents->length) {
+        if (subCount + start > contents.length) {
             return -1;
         }
 
@@ -1020,14 +1078,14 @@ int String::indexOf(const std::string& subString, int start) const {
 
         while (true) {
             int i = indexOf(firstChar, start);
-            if (i == -1 || subCount + i > contents->length) {
+            if (i == -1 || subCount + i > contents.length) {
                 return -1; // handles subCount > length() || start >= length()
             }
 
-            int o1 = contents->offset + i;
+            int o1 = contents.offset + i;
             int o2 = 0;
 
-            while (++o2 < end && contents->value[++o1] == target[o2]) {
+            while (++o2 < end && contents.value[++o1] == target[o2]) {
                 // Intentionally empty
             }
             if (o2 == end) {
@@ -1037,7 +1095,7 @@ int String::indexOf(const std::string& subString, int start) const {
         }
     }
 
-    return start < contents->length ? start : contents->length;
+    return start < contents.length ? start : contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1058,7 +1116,7 @@ int String::indexOf(const char* subString, int start) const {
 
     int subCount = StringUtils::stringLength(subString);
     if (subCount > 0) {
-        if (subCount + start > contents->length) {
+        if (subCount + start > contents.length) {
             return -1;
         }
 
@@ -1067,14 +1125,14 @@ int String::indexOf(const char* subString, int start) const {
 
         while (true) {
             int i = indexOf(firstChar, start);
-            if (i == -1 || subCount + i > contents->length) {
+            if (i == -1 || subCount + i > contents.length) {
                 return -1; // handles subCount > length() || start >= length()
             }
 
-            int o1 = contents->offset + i;
+            int o1 = contents.offset + i;
             int o2 = 0;
 
-            while (++o2 < end && contents->value[++o1] == subString[o2]) {
+            while (++o2 < end && contents.value[++o1] == subString[o2]) {
                 // Intentionally empty
             }
             if (o2 == end) {
@@ -1084,24 +1142,24 @@ int String::indexOf(const char* subString, int start) const {
         }
     }
 
-    return start < contents->length ? start : contents->length;
+    return start < contents.length ? start : contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(char value) const {
-    return lastIndexOf(value, contents->length - 1);
+    return lastIndexOf(value, contents.length - 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(char value, int start) const {
     if (start >= 0) {
-        if (start >= contents->length) {
-            start = contents->length - 1;
+        if (start >= contents.length) {
+            start = contents.length - 1;
         }
 
-        for (int i = contents->offset + start; i >= contents->offset; --i) {
-            if (contents->value[i] == value) {
-                return i - contents->offset;
+        for (int i = contents.offset + start; i >= contents.offset; --i) {
+            if (contents.value[i] == value) {
+                return i - contents.offset;
             }
         }
     }
@@ -1111,22 +1169,22 @@ int String::lastIndexOf(char value, int start) const {
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(const String& string) const {
     // Use length instead of length - 1 so lastIndexOf("") answers length
-    return lastIndexOf(string, contents->length);
+    return lastIndexOf(string, contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(const String& subString, int start) const {
-    int subCount = subString.contents->length;
+    int subCount = subString.contents.length;
 
-    if (subCount <= contents->length && start >= 0) {
+    if (subCount <= contents.length && start >= 0) {
         if (subCount > 0) {
-            if (start > contents->length - subCount) {
-                start = contents->length - subCount;
+            if (start > contents.length - subCount) {
+                start = contents.length - subCount;
             }
 
             // count and subCount are both >= 1
-            char* target = subString.contents->value.get();
-            int subOffset = subString.contents->offset;
+            char* target = subString.contents.value.get();
+            int subOffset = subString.contents.offset;
             char firstChar = target[subOffset];
             int end = subOffset + subCount;
 
@@ -1136,10 +1194,10 @@ int String::lastIndexOf(const String& subString, int start) const {
                     return -1;
                 }
 
-                int o1 = contents->offset + i;
+                int o1 = contents.offset + i;
                 int o2 = subOffset;
 
-                while (++o2 < end && contents->value[++o1] == target[o2]) {
+                while (++o2 < end && contents.value[++o1] == target[o2]) {
                     // Intentionally empty
                 }
 
@@ -1149,7 +1207,7 @@ int String::lastIndexOf(const String& subString, int start) const {
                 start = i - 1;
             }
         }
-        return start < contents->length ? start : contents->length;
+        return start < contents.length ? start : contents.length;
     }
     return -1;
 }
@@ -1157,17 +1215,17 @@ int String::lastIndexOf(const String& subString, int start) const {
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(const std::string& string) const {
     // Use length instead of length - 1 so lastIndexOf("") answers length
-    return lastIndexOf(string, contents->length);
+    return lastIndexOf(string, contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(const std::string& subString, int start) const {
     int subCount = (int) subString.length();
 
-    if (subCount <= contents->length && start >= 0) {
+    if (subCount <= contents.length && start >= 0) {
         if (subCount > 0) {
-            if (start > contents->length - subCount) {
-                start = contents->length - subCount;
+            if (start > contents.length - subCount) {
+                start = contents.length - subCount;
             }
 
             // count and subCount are both >= 1
@@ -1181,10 +1239,10 @@ int String::lastIndexOf(const std::string& subString, int start) const {
                     return -1;
                 }
 
-                int o1 = contents->offset + i;
+                int o1 = contents.offset + i;
                 int o2 = 0;
 
-                while (++o2 < end && contents->value[++o1] == target[o2]) {
+                while (++o2 < end && contents.value[++o1] == target[o2]) {
                     // Intentionally empty
                 }
 
@@ -1194,7 +1252,7 @@ int String::lastIndexOf(const std::string& subString, int start) const {
                 start = i - 1;
             }
         }
-        return start < contents->length ? start : contents->length;
+        return start < contents.length ? start : contents.length;
     }
     return -1;
 }
@@ -1202,7 +1260,7 @@ int String::lastIndexOf(const std::string& subString, int start) const {
 ////////////////////////////////////////////////////////////////////////////////
 int String::lastIndexOf(const char* string) const {
     // Use length instead of length - 1 so lastIndexOf("") answers length
-    return lastIndexOf(string, contents->length);
+    return lastIndexOf(string, contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1214,10 +1272,10 @@ int String::lastIndexOf(const char* subString, int start) const {
 
     int subCount = StringUtils::stringLength(subString);
 
-    if (subCount <= contents->length && start >= 0) {
+    if (subCount <= contents.length && start >= 0) {
         if (subCount > 0) {
-            if (start > contents->length - subCount) {
-                start = contents->length - subCount;
+            if (start > contents.length - subCount) {
+                start = contents.length - subCount;
             }
 
             // count and subCount are both >= 1
@@ -1230,10 +1288,10 @@ int String::lastIndexOf(const char* subString, int start) const {
                     return -1;
                 }
 
-                int o1 = contents->offset + i;
+                int o1 = contents.offset + i;
                 int o2 = 0;
 
-                while (++o2 < end && contents->value[++o1] == subString[o2]) {
+                while (++o2 < end && contents.value[++o1] == subString[o2]) {
                     // Intentionally empty
                 }
 
@@ -1243,24 +1301,24 @@ int String::lastIndexOf(const char* subString, int start) const {
                 start = i - 1;
             }
         }
-        return start < contents->length ? start : contents->length;
+        return start < contents.length ? start : contents.length;
     }
     return -1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int String::length() const {
-    return this->contents->length;
+    return this->contents.length;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool String::regionMatches(int thisStart, const String& string, int start, int length) const {
 
-    if (string.contents->length - start < length || start < 0) {
+    if (string.contents.length - start < length || start < 0) {
         return false;
     }
 
-    if (thisStart < 0 || contents->length - thisStart < length) {
+    if (thisStart < 0 || contents.length - thisStart < length) {
         return false;
     }
 
@@ -1268,11 +1326,11 @@ bool String::regionMatches(int thisStart, const String& string, int start, int l
         return true;
     }
 
-    int o1 = contents->offset + thisStart;
-    int o2 = string.contents->offset + start;
+    int o1 = contents.offset + thisStart;
+    int o2 = string.contents.offset + start;
 
     for (int i = 0; i < length; ++i) {
-        if (contents->value[o1 + i] != string.contents->value[o2 + i]) {
+        if (contents.value[o1 + i] != string.contents.value[o2 + i]) {
             return false;
         }
     }
@@ -1287,20 +1345,20 @@ bool String::regionMatches(bool ignoreCase, int thisStart, const String& string,
         return regionMatches(thisStart, string, start, length);
     }
 
-    if (thisStart < 0 || length > contents->length - thisStart) {
+    if (thisStart < 0 || length > contents.length - thisStart) {
         return false;
     }
-    if (start < 0 || length > string.contents->length - start) {
+    if (start < 0 || length > string.contents.length - start) {
         return false;
     }
 
-    thisStart += contents->offset;
-    start += string.contents->offset;
+    thisStart += contents.offset;
+    start += string.contents.offset;
     int end = thisStart + length;
     char c1, c2;
 
     while (thisStart < end) {
-        if ((c1 = contents->value[thisStart++]) != (c2 = string.contents->value[start++])) {
+        if ((c1 = contents.value[thisStart++]) != (c2 = string.contents.value[start++])) {
             // If we add support for multibyte strings we need to check both cases
             // toUpperCase and toLowerCase because of Unicode.
             if (Character::toUpperCase(c1) != Character::toUpperCase(c2)) {
@@ -1320,9 +1378,9 @@ String String::replace(char oldChar, char newChar) const {
         return *this;
     }
 
-    Contents buffer(contents->length);
+    Contents buffer(contents.length);
 
-    System::arraycopy(contents->value.get(), contents->offset, buffer.value.get(), 0, contents->length);
+    System::arraycopy(contents.value.get(), contents.offset, buffer.value.get(), 0, contents.length);
 
     do {
         buffer.value[index++] = newChar;
@@ -1333,12 +1391,12 @@ String String::replace(char oldChar, char newChar) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 bool String::startsWith(const String& prefix) const {
-    return regionMatches(0, prefix, 0, prefix.contents->length);
+    return regionMatches(0, prefix, 0, prefix.contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 bool String::startsWith(const String& prefix, int start) const {
-    return regionMatches(start, prefix, 0, prefix.contents->length);
+    return regionMatches(start, prefix, 0, prefix.contents.length);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1348,8 +1406,8 @@ String String::substring(int start) const {
         return *this;
     }
 
-    if (0 <= start && start <= contents->length) {
-        return String(contents->offset + start, contents->length - start, contents->value);
+    if (0 <= start && start <= contents.length) {
+        return String(contents.offset + start, contents.length - start, contents);
     }
 
     throw StringIndexOutOfBoundsException(__FILE__, __LINE__, start);
@@ -1358,7 +1416,7 @@ String String::substring(int start) const {
 ////////////////////////////////////////////////////////////////////////////////
 String String::substring(int start, int end) const {
 
-    if (start == 0 && end == contents->length) {
+    if (start == 0 && end == contents.length) {
         return *this;
     }
 
@@ -1366,12 +1424,12 @@ String String::substring(int start, int end) const {
         throw StringIndexOutOfBoundsException(__FILE__, __LINE__, start);
     } else if (start > end) {
         throw StringIndexOutOfBoundsException(__FILE__, __LINE__, end - start);
-    } else if (end > contents->length) {
+    } else if (end > contents.length) {
         throw StringIndexOutOfBoundsException(__FILE__, __LINE__, end);
     }
 
     // NOTE last character not copied!
-    return String(contents->offset + start, end - start, contents->value);
+    return String(contents.offset + start, end - start, contents);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1397,19 +1455,19 @@ CharSequence* String::subSequence(int start DECAF_UNUSED, int end DECAF_UNUSED)
 
 ////////////////////////////////////////////////////////////////////////////////
 char* String::toCharArray() const {
-    char* buffer = new char[contents->length];
-    System::arraycopy((const char*)contents->value.get(), contents->offset, buffer, 0, contents->length);
+    char* buffer = new char[contents.length];
+    System::arraycopy((const char*)contents.value.get(), contents.offset, buffer, 0, contents.length);
     return buffer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 String String::toLowerCase() const {
 
-    Contents newContents(contents->length);
-    int offset = contents->offset;
+    Contents newContents(contents.length);
+    int offset = contents.offset;
 
-    for (int i = 0; i < contents->length; ++i) {
-        newContents.value[i] = Character::toLowerCase(contents->value[offset + i]);
+    for (int i = 0; i < contents.length; ++i) {
+        newContents.value[i] = Character::toLowerCase(contents.value[offset + i]);
     }
 
     return String(&newContents);
@@ -1418,11 +1476,11 @@ String String::toLowerCase() const {
 ////////////////////////////////////////////////////////////////////////////////
 String String::toUpperCase() const {
 
-    Contents newContents(contents->length);
-    int offset = contents->offset;
+    Contents newContents(contents.length);
+    int offset = contents.offset;
 
-    for (int i = 0; i < contents->length; ++i) {
-        newContents.value[i] = Character::toUpperCase(contents->value[offset + i]);
+    for (int i = 0; i < contents.length; ++i) {
+        newContents.value[i] = Character::toUpperCase(contents.value[offset + i]);
     }
 
     return String(&newContents);
@@ -1431,38 +1489,34 @@ String String::toUpperCase() const {
 ////////////////////////////////////////////////////////////////////////////////
 std::string String::toString() const {
 
-    if (this->contents == NULL) {
-        return "null";
-    }
-
-    if (this->contents->length == 0) {
+    if (this->contents.length == 0) {
         return "";
     }
 
-    return std::string((const char*) contents->value.get() + contents->offset, this->length());
+    return std::string((const char*) contents.value.get() + contents.offset, this->length());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 String String::trim() const {
 
-    int start = contents->offset;
-    int last = contents->offset + contents->length - 1;
+    int start = contents.offset;
+    int last = contents.offset + contents.length - 1;
 
     int end = last;
 
-    while ((start <= end) && (contents->value[start] <= 0x20)) {
+    while ((start <= end) && (contents.value[start] <= 0x20)) {
         start++;
     }
 
-    while ((end >= start) && (contents->value[end] <= 0x20)) {
+    while ((end >= start) && (contents.value[end] <= 0x20)) {
         end--;
     }
 
-    if (start == contents->offset && end == last) {
+    if (start == contents.offset && end == last) {
         return *this;
     }
 
-    return String(start, end - start + 1, contents->value);
+    return String(start, end - start + 1, contents);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
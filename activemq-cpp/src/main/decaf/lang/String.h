@@ -30,7 +30,6 @@
 namespace decaf {
 namespace lang {
 
-    class Contents;
     class AbstractStringBuilder;
 
     /**
@@ -52,12 +51,101 @@ namespace lang {
      * this where necessary, call the compact method which allocates a new array that
      * is just big enough to store the String's content.
      *
+     * Short strings are stored inline in the String object itself and never touch the
+     * heap, longer ones are held in a reference counted array so that copying a String
+     * or taking a substring of it only costs a reference count increment.  Short
+     * substrings of a long string are copied inline and so don't retain the long array.
+     *
      * @since 1.0
      */
     class DECAF_API String: public CharSequence {
     private:
 
-        mutable Contents* contents;
+        struct SharedChars;
+
+        /**
+         * The character array backing a String, arrays of up to INLINE_CAPACITY chars
+         * (including the NULL terminator) are held inline, larger ones are allocated
+         * together with their reference count and shared when copied.  The characters
+         * must not be modified once the array is shared.
+         */
+        class Chars {
+        public:
+
+            enum { INLINE_CAPACITY = 16 };
+
+        private:
+
+            char* data;
+            SharedChars* shared;
+            int size;
+            char local[INLINE_CAPACITY];
+
+        public:
+
+            Chars() : data(local), shared(NULL), size(0) {
+                local[0] = 0;
+            }
+
+            explicit Chars(int size);
+
+            Chars(const Chars& source);
+
+            ~Chars();
+
+            Chars& operator= (const Chars& source);
+
+            char* get() const {
+                return this->data;
+            }
+
+            char& operator[] (int index) const {
+                return this->data[index];
+            }
+
+            int length() const {
+                return this->size;
+            }
+
+            bool isInline() const {
+                return this->shared == NULL;
+            }
+
+        private:
+
+            void release();
+
+        };
+
+        class Contents {
+        public:
+
+            Chars value;
+            int length;
+            int offset;
+            int hashCode;
+
+        public:
+
+            /**
+             * Contents as empty string.
+             */
+            Contents();
+
+            /**
+             * Contents created with the given length, the array is length + 1 to add the
+             * null terminating character.
+             */
+            Contents(int length);
+
+            /**
+             * Contents is a view of some other String which can either be all or a
+             * window allowing for substring methods to not need to copy the contents.
+             */
+            Contents(int offset, int length, const Chars& value);
+        };
+
+        mutable Contents contents;
 
     public:
 
@@ -1185,7 +1273,7 @@ namespace lang {
         void getChars(int start, int end, char* buffer, int index) const;
 
         String(Contents* content);
-        String(int offset, int length, const ArrayPointer<char> content);
+        String(int offset, int length, const Contents& content);
 
         friend class AbstractStringBuilder;
     };
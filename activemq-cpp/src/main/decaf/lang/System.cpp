@@ -25,6 +25,7 @@
 #include <decaf/util/StlMap.h>
 #include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/Properties.h>
+#include <decaf/internal/util/concurrent/PlatformThread.h>
 #include <apr.h>
 #include <apr_errno.h>
 #include <apr_env.h>
@@ -63,6 +64,7 @@ using namespace decaf::lang;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
 using namespace decaf::internal;
+using namespace decaf::internal::util::concurrent;
 using namespace decaf::lang::exceptions;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -360,27 +362,56 @@ long long System::currentTimeMillis() {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long System::coarseTimeMillis() {
+
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_REALTIME_COARSE)
+
+    struct timespec ts;
+    if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+        return ((long long)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+    }
+
+#endif
+
+    // Elsewhere the precise clock is cheap enough or already advances by tick.
+    return System::currentTimeMillis();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long System::nanoTime() {
 
 #ifdef _WIN32
 
-    LARGE_INTEGER freq, i, multiplier;
-    long long result;
+    static LARGE_INTEGER freq = { 0 };
+    LARGE_INTEGER counter;
 
-    if (!::QueryPerformanceFrequency(&freq)) {
-        return ::GetTickCount();
+    if (freq.QuadPart == 0 && !::QueryPerformanceFrequency(&freq)) {
+        return (long long)::GetTickCount() * 1000000;
     }
 
-    multiplier.QuadPart = freq.QuadPart / 1000000;
+    ::QueryPerformanceCounter(&counter);
 
-    ::QueryPerformanceCounter(&i);
-    result = i.QuadPart / multiplier.QuadPart;
+    // Whole seconds and the remainder are scaled apart so neither loses precision
+    // nor overflows for counters of any frequency.
+    long long seconds = counter.QuadPart / freq.QuadPart;
+    long long remainder = counter.QuadPart % freq.QuadPart;
 
-    return result * 1000;
+    return seconds * 1000000000LL + (remainder * 1000000000LL) / freq.QuadPart;
 
 #else
 
+#if defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+
+    // The monotonic clock doesn't step when the wall clock is set, and is read without
+    // a system call through the vDSO on Linux.
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return ((long long)ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+    }
+
+#endif
+
     struct timeval tv;
     gettimeofday( &tv, NULL );
     return (((long long)tv.tv_sec * 1000000) + tv.tv_usec) * 1000;
@@ -529,6 +560,18 @@ int System::availableProcessors() {
     return numCpus;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+int System::availableNumaNodes() {
+    return PlatformThread::getNumaNodeCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<int> System::getNumaNodeProcessors(int node) {
+    std::vector<int> cpus;
+    PlatformThread::getNumaNodeProcessors(node, cpus);
+    return cpus;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 decaf::util::Properties& System::getProperties() {
     return System::sys->systemProperties;
@@ -25,6 +25,7 @@
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/internal/AprPool.h>
 #include <string>
+#include <vector>
 
 namespace decaf{
 namespace lang{
@@ -296,6 +297,20 @@ namespace lang{
          */
         static long long currentTimeMillis();
 
+        /**
+         * Returns the current time in milliseconds as currentTimeMillis does, read from a
+         * clock the operating system only advances on its timer tick where one is available.
+         * Reading it costs a fraction of a precise read but the value may lag the precise
+         * time by the length of a tick, a few milliseconds on most systems.
+         *
+         * Meant for checks made on every message that only need millisecond scale
+         * precision, such as whether a message has expired.
+         *
+         * @return the difference, measured in milliseconds, between the current time
+         *          and midnight, January 1, 1970 UTC.
+         */
+        static long long coarseTimeMillis();
+
         /**
          * Returns the current value of the most precise available system timer, in
          * nanoseconds.
@@ -331,6 +346,25 @@ namespace lang{
          */
         static int availableProcessors();
 
+        /**
+         * Returns the number of NUMA nodes the system's processors and memory are divided
+         * into, on platforms that don't expose their memory topology this is always one.
+         *
+         * @return the number of NUMA nodes, at least one.
+         */
+        static int availableNumaNodes();
+
+        /**
+         * Returns the indices of the processors that belong to the given NUMA node, these
+         * are the values that Thread::setAffinity accepts.
+         *
+         * @param node
+         *      The zero based index of the NUMA node.
+         *
+         * @return the node's processors, empty if there is no such node.
+         */
+        static std::vector<int> getNumaNodeProcessors(int node);
+
         /**
          * Gets the Properties object that holds the Properties accessed from calls to
          * getProperty and setProperty.
@@ -60,12 +60,14 @@ namespace lang {
         Runnable* task;
         ThreadHandle* handle;
         Thread::UncaughtExceptionHandler* exHandler;
+        std::vector<int> affinity;
         static unsigned int id;
         static Thread::UncaughtExceptionHandler* defaultHandler;
+        static volatile long long defaultStackSize;
 
     public:
 
-        ThreadProperties() : task(NULL), handle(NULL), exHandler(NULL) {}
+        ThreadProperties() : task(NULL), handle(NULL), exHandler(NULL), affinity() {}
 
     };
 
@@ -74,6 +76,7 @@ namespace lang {
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int ThreadProperties::id = 0;
 Thread::UncaughtExceptionHandler* ThreadProperties::defaultHandler = NULL;
+volatile long long ThreadProperties::defaultStackSize = -1;
 
 ////////////////////////////////////////////////////////////////////////////////
 Thread::Thread(ThreadHandle* handle) : Runnable(), properties(NULL) {
@@ -118,6 +121,10 @@ void Thread::initializeSelf(Runnable* task, const std::string& name, long long s
         threadName = name;
     }
 
+    if (stackSize == -1) {
+        stackSize = ThreadProperties::defaultStackSize;
+    }
+
     this->properties = new ThreadProperties();
     this->properties->handle =
         Threading::createNewThread(this, threadName.c_str(), stackSize);
@@ -257,6 +264,49 @@ int Thread::getPriority() const {
     return Threading::getThreadPriority(this->properties->handle);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+long long Thread::getStackSize() const {
+    return Threading::getThreadStackSize(this->properties->handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long Thread::getDefaultStackSize() {
+    return ThreadProperties::defaultStackSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Thread::setDefaultStackSize(long long stackSize) {
+
+    if (stackSize <= 0 && stackSize != -1) {
+        throw IllegalArgumentException(
+            __FILE__, __LINE__,
+            "Thread::setDefaultStackSize - Specified value {%lld} is not a valid stack size", stackSize);
+    }
+
+    ThreadProperties::defaultStackSize = stackSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<int> Thread::getAffinity() const {
+    return this->properties->affinity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Thread::setAffinity(const std::vector<int>& cpus) {
+
+    std::vector<int>::const_iterator iter = cpus.begin();
+    for (; iter != cpus.end(); ++iter) {
+        if (*iter < 0) {
+            throw IllegalArgumentException(
+                __FILE__, __LINE__,
+                "Thread::setAffinity - Processor index {%d} is negative", *iter);
+        }
+    }
+
+    this->properties->affinity = cpus;
+    return Threading::setThreadAffinity(this->properties->handle, cpus);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Thread::setUncaughtExceptionHandler(UncaughtExceptionHandler* handler) {
     this->properties->exHandler = handler;
@@ -25,6 +25,8 @@
 #include <decaf/lang/Runnable.h>
 #include <decaf/util/Config.h>
 
+#include <vector>
+
 namespace decaf {
 namespace internal {
 namespace util {
@@ -195,7 +197,8 @@ namespace lang {
          * @param name
          *      The name to assign to this Thread.
          * @param stackSize
-         *      The size of the newly allocated thread's stack.
+         *      The size of the newly allocated thread's stack, or -1 for the default
+         *      stack size given by getDefaultStackSize.
          */
         Thread(Runnable* task, const std::string& name, long long stackSize);
 
@@ -289,6 +292,39 @@ namespace lang {
          */
         void setPriority(int value);
 
+        /**
+         * Returns the stack size this Thread was created with.
+         *
+         * @return the stack size in bytes, or -1 if the platform default was used.
+         */
+        long long getStackSize() const;
+
+        /**
+         * Returns the set of processors this Thread was last restricted to by a call to
+         * setAffinity, an empty set means it may run on any processor.
+         *
+         * @return the zero based indices of the processors this Thread may run on.
+         */
+        std::vector<int> getAffinity() const;
+
+        /**
+         * Restricts this Thread to running on the given set of processors, the processor
+         * indices are those used by System::getNumaNodeProcessors.  Passing an empty set
+         * allows the Thread to run on any processor again.  The affinity can be set before
+         * the Thread is started.
+         *
+         * Placement is a hint to the OS, on a platform that doesn't support it, or when
+         * none of the given processors are usable, the call has no effect.
+         *
+         * @param cpus
+         *      The zero based indices of the processors this Thread may run on.
+         *
+         * @return true if the OS applied the new affinity.
+         *
+         * @throws IllegalArgumentException if any of the processor indices is negative.
+         */
+        bool setAffinity(const std::vector<int>& cpus);
+
         /**
          * Set the handler invoked when this thread abruptly terminates due to an uncaught exception.
          *
@@ -423,6 +459,27 @@ namespace lang {
          */
         static void setDefaultUncaughtExceptionHandler(UncaughtExceptionHandler* handler);
 
+        /**
+         * Returns the stack size given to every new Thread that isn't created with an
+         * explicit stack size, this includes all the threads the library creates itself.
+         *
+         * @return the default stack size in bytes, or -1 when the platform default is used.
+         */
+        static long long getDefaultStackSize();
+
+        /**
+         * Sets the stack size given to every new Thread that isn't created with an explicit
+         * stack size.  Threads that already exist keep the stack they were created with so
+         * this is normally set once at startup.  The size is rounded up to the platform's
+         * minimum stack size.
+         *
+         * @param stackSize
+         *      The stack size in bytes, or -1 to go back to the platform default.
+         *
+         * @throws IllegalArgumentException if the size is neither positive nor -1.
+         */
+        static void setDefaultStackSize(long long stackSize);
+
     private:
 
         // Initialize the Threads internal state
@@ -18,6 +18,8 @@
 #ifndef _DECAF_LANG_EXCEPTIONS_EXCEPTIONDEFINES_H_
 #define _DECAF_LANG_EXCEPTIONS_EXCEPTIONDEFINES_H_
 
+#include <decaf/lang/Exception.h>
+
 /**
  * Macro for catching and rethrowing an exception of
  * a given type.
@@ -26,7 +28,7 @@
  */
 #define DECAF_CATCH_RETHROW( type ) \
     catch( type& ex ){ \
-        ex.setMark( __FILE__, __LINE__ ); \
+        ::decaf::lang::markWithLiteral( ex, __FILE__, __LINE__ ); \
         throw; \
     }
 
@@ -39,7 +41,7 @@
 #define DECAF_CATCH_EXCEPTION_CONVERT( sourceType, targetType ) \
     catch( sourceType& ex ){ \
         targetType target( ex.clone() ); \
-        target.setMark( __FILE__, __LINE__ ); \
+        ::decaf::lang::markWithLiteral( target, __FILE__, __LINE__ ); \
         throw target; \
     }
 
@@ -73,7 +75,7 @@
  */
 #define DECAF_CATCH_NOTHROW( type ) \
     catch( type& ex ){ \
-        ex.setMark( __FILE__, __LINE__ ); \
+        ::decaf::lang::markWithLiteral( ex, __FILE__, __LINE__ ); \
     }
 
 #endif /*_DECAF_LANG_EXCEPTIONS_EXCEPTIONDEFINES_H_*/
@@ -23,15 +23,52 @@
 #include <decaf/net/Inet6Address.h>
 #include <decaf/net/UnknownHostException.h>
 #include <decaf/lang/exceptions/RuntimeException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
 
 #include <apr_network_io.h>
 #include <decaf/internal/AprPool.h>
+#include <decaf/internal/net/Network.h>
+#include <decaf/internal/net/ResolverCache.h>
+
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::net;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::internal;
+using namespace decaf::internal::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    ResolverCache* getResolverCache() {
+        try {
+            return Network::getNetworkRuntime()->getResolverCache();
+        } catch (IllegalStateException& ex) {
+            return NULL;
+        }
+    }
+
+    std::vector<unsigned char> resolveHost(const std::string& host) {
+
+        ResolverCache* cache = getResolverCache();
+        if (cache != NULL) {
+            return cache->resolve(host);
+        }
+
+        AprPool pool;
+        apr_sockaddr_t* address = NULL;
+        apr_status_t result = apr_sockaddr_info_get(&address, host.c_str(), APR_UNSPEC, 0, APR_IPV4_ADDR_OK, pool.getAprPool());
+
+        if (result != APR_SUCCESS || address == NULL) {
+            throw UnknownHostException(__FILE__, __LINE__, "Could not resolve host: %s", host.c_str());
+        }
+
+        const unsigned char* bytes = (const unsigned char*) address->ipaddr_ptr;
+        return std::vector<unsigned char>(bytes, bytes + address->ipaddr_len);
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 const unsigned char InetAddress::loopbackBytes[4] = { 127, 0, 0, 1 };
@@ -164,24 +201,64 @@ InetAddress InetAddress::getLocalHost() {
         } catch (...) {
         }
 
-        apr_sockaddr_t* address = NULL;
-        result = apr_sockaddr_info_get(&address, hostname, APR_UNSPEC, 0, APR_IPV4_ADDR_OK, pool.getAprPool());
+        std::vector<unsigned char> address;
 
-        if (result != APR_SUCCESS || address == NULL) {
+        try {
+            address = resolveHost(hostname);
+        } catch (UnknownHostException& ex) {
             throw UnknownHostException(__FILE__, __LINE__, "Could not resolve the IP Address of this host.");
         }
 
-        if (address->family == APR_INET) {
-            return Inet4Address(hostname, (const unsigned char*) address->ipaddr_ptr, address->ipaddr_len);
-        } else {
-            return Inet6Address(hostname, (const unsigned char*) address->ipaddr_ptr, address->ipaddr_len);
+        return getByAddress(hostname, &address[0], (int) address.size());
+    }
+    DECAF_CATCH_RETHROW( UnknownHostException)
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, UnknownHostException)
+    DECAF_CATCHALL_THROW( UnknownHostException)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string InetAddress::getLocalHostName() {
+
+    char hostname[APRMAXHOSTLEN + 1] = { 0 };
+
+    try {
+
+        AprPool pool;
+        if (apr_gethostname(hostname, APRMAXHOSTLEN + 1, pool.getAprPool()) == APR_SUCCESS && hostname[0] != '\0') {
+            return hostname;
         }
+
+    } catch (...) {
+    }
+
+    return "localhost";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+InetAddress InetAddress::getByName(const std::string& host) {
+
+    if (host.empty()) {
+        return getLoopbackAddress();
+    }
+
+    try {
+        std::vector<unsigned char> address = resolveHost(host);
+        return getByAddress(host, &address[0], (int) address.size());
     }
     DECAF_CATCH_RETHROW( UnknownHostException)
     DECAF_CATCH_EXCEPTION_CONVERT( Exception, UnknownHostException)
     DECAF_CATCHALL_THROW( UnknownHostException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void InetAddress::resolveAsync(const std::string& host) {
+
+    ResolverCache* cache = getResolverCache();
+    if (cache != NULL && !host.empty()) {
+        cache->resolveAsync(host);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 unsigned int InetAddress::bytesToInt(const unsigned char* bytes, int start) {
 
@@ -226,6 +226,38 @@ namespace net {
          */
         static InetAddress getLocalHost();
 
+        /**
+         * Gets the name this machine is configured with.  Unlike getLocalHost the name is
+         * not resolved to an address so the call never waits on the system resolver.
+         *
+         * @return the local host name, or "localhost" if the name can't be read.
+         */
+        static std::string getLocalHostName();
+
+        /**
+         * Resolves a host name to its address, an IPv4 address is preferred when the host
+         * has both kinds.  Lookups are cached by the network runtime for a limited time so
+         * repeated calls for one host don't each wait on the system resolver.  An empty
+         * host name gives the loopback address.
+         *
+         * @param host
+         *      The machine name or the text based representation of the IP Address.
+         *
+         * @return a new InetAddress object that contains the host's address.
+         *
+         * @throws UnknownHostException if the host name can't be resolved.
+         */
+        static InetAddress getByName(const std::string& host);
+
+        /**
+         * Starts resolving a host name in the background so that a later getByName for it
+         * finds the address cached.  Does nothing if the address is already cached.
+         *
+         * @param host
+         *      The machine name or the text based representation of the IP Address.
+         */
+        static void resolveAsync(const std::string& host);
+
     protected:
 
         /**
@@ -483,6 +483,95 @@ namespace net{
          */
         virtual void setTcpNoDelay(bool value);
 
+        /**
+         * @return the time in microseconds reads busy poll for data, SO_BUSY_POLL.
+         *
+         * @throws SocketException if the option can't be read or isn't supported on this platform.
+         */
+        virtual int getBusyPoll() const;
+
+        /**
+         * Sets the time in microseconds a blocking read busy polls the device queue for data
+         * before it sleeps, SO_BUSY_POLL.  Zero disables busy polling.
+         *
+         * @param microseconds
+         *      The time to busy poll for.
+         *
+         * @throws SocketException if the option can't be set or isn't supported on this platform.
+         */
+        virtual void setBusyPoll(int microseconds);
+
+        /**
+         * @return true if TCP_QUICKACK is enabled for the socket.
+         *
+         * @throws SocketException if the option can't be read or isn't supported on this platform.
+         */
+        virtual bool getTcpQuickAck() const;
+
+        /**
+         * Sets whether received segments are acknowledged at once rather than with a delayed
+         * ACK, TCP_QUICKACK.  Once enabled it is turned back on after each read.
+         *
+         * @param value
+         *      The setting for the socket's TCP_QUICKACK option, true to enable.
+         *
+         * @throws SocketException if the option can't be set or isn't supported on this platform.
+         */
+        virtual void setTcpQuickAck(bool value);
+
+        /**
+         * @return the number of unsent bytes allowed in the send buffer, TCP_NOTSENT_LOWAT.
+         *
+         * @throws SocketException if the option can't be read or isn't supported on this platform.
+         */
+        virtual int getTcpNotSentLowWater() const;
+
+        /**
+         * Sets the number of bytes that may sit unsent in the send buffer before writes block,
+         * TCP_NOTSENT_LOWAT.
+         *
+         * @param size
+         *      The number of unsent bytes allowed.
+         *
+         * @throws SocketException if the option can't be set or isn't supported on this platform.
+         */
+        virtual void setTcpNotSentLowWater(int size);
+
+        /**
+         * @return the highest rate in bytes per second the socket sends at, SO_MAX_PACING_RATE.
+         *
+         * @throws SocketException if the option can't be read or isn't supported on this platform.
+         */
+        virtual int getMaxPacingRate() const;
+
+        /**
+         * Sets the highest rate in bytes per second the socket sends at, SO_MAX_PACING_RATE.
+         *
+         * @param rate
+         *      The pacing rate in bytes per second.
+         *
+         * @throws SocketException if the option can't be set or isn't supported on this platform.
+         */
+        virtual void setMaxPacingRate(int rate);
+
+        /**
+         * @return the time in milliseconds sent data may remain unacknowledged, TCP_USER_TIMEOUT.
+         *
+         * @throws SocketException if the option can't be read or isn't supported on this platform.
+         */
+        virtual int getTcpUserTimeout() const;
+
+        /**
+         * Sets the time in milliseconds sent data may remain unacknowledged before the connection
+         * is dropped, TCP_USER_TIMEOUT.  Zero leaves it to the platform.
+         *
+         * @param timeout
+         *      The timeout in milliseconds.
+         *
+         * @throws SocketException if the option can't be set or isn't supported on this platform.
+         */
+        virtual void setTcpUserTimeout(int timeout);
+
         /**
          * Gets the Traffic Class setting for this Socket, sometimes referred to as Type of
          * Service setting.  This setting is dependent on the underlying network implementation
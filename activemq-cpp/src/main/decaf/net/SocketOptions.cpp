@@ -35,6 +35,11 @@ const int SocketOptions::SOCKET_OPTION_SNDBUF = 11;
 const int SocketOptions::SOCKET_OPTION_RCVBUF = 12;
 const int SocketOptions::SOCKET_OPTION_KEEPALIVE = 13;
 const int SocketOptions::SOCKET_OPTION_OOBINLINE = 14;
+const int SocketOptions::SOCKET_OPTION_BUSY_POLL = 15;
+const int SocketOptions::SOCKET_OPTION_TCP_QUICKACK = 16;
+const int SocketOptions::SOCKET_OPTION_TCP_NOTSENT_LOWAT = 17;
+const int SocketOptions::SOCKET_OPTION_MAX_PACING_RATE = 18;
+const int SocketOptions::SOCKET_OPTION_TCP_USER_TIMEOUT = 19;
 
 ////////////////////////////////////////////////////////////////////////////////
 SocketOptions::~SocketOptions() {
@@ -148,6 +148,40 @@ namespace net {
          */
         static const int SOCKET_OPTION_OOBINLINE;
 
+        /**
+         * The time in microseconds a blocking read on the socket busy polls the device queue
+         * for new data before it sleeps, SO_BUSY_POLL.  Zero disables busy polling.  Trades
+         * CPU for receive latency, only supported on some platforms.
+         */
+        static const int SOCKET_OPTION_BUSY_POLL;
+
+        /**
+         * When set the socket acknowledges received segments at once rather than delaying
+         * the ACK, TCP_QUICKACK.  The platform may drop back to delayed ACKs on its own so
+         * the socket sets it again after each read.  Only supported on some platforms.
+         */
+        static const int SOCKET_OPTION_TCP_QUICKACK;
+
+        /**
+         * The number of bytes that may sit unsent in the socket's send buffer before writes
+         * block, TCP_NOTSENT_LOWAT.  Keeps queued data small so a new write isn't delayed
+         * behind it.  Only supported on some platforms.
+         */
+        static const int SOCKET_OPTION_TCP_NOTSENT_LOWAT;
+
+        /**
+         * The highest rate in bytes per second the socket sends at, SO_MAX_PACING_RATE.
+         * Only supported on some platforms.
+         */
+        static const int SOCKET_OPTION_MAX_PACING_RATE;
+
+        /**
+         * The time in milliseconds sent data may remain unacknowledged before the connection
+         * is dropped, TCP_USER_TIMEOUT.  Zero leaves it to the platform.  Only supported on
+         * some platforms.
+         */
+        static const int SOCKET_OPTION_TCP_USER_TIMEOUT;
+
     public:
 
         virtual ~SocketOptions();
@@ -57,6 +57,15 @@ SSLParameters SSLSocket::getSSLParameters() const {
     return params;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void SSLSocket::setUseKernelTLS(bool value DECAF_UNUSED) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool SSLSocket::getUseKernelTLS() const {
+    return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void SSLSocket::setSSLParameters(const SSLParameters& value) {
 
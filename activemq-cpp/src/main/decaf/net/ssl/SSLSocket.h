@@ -277,6 +277,27 @@ namespace ssl {
          */
         virtual bool getWantClientAuth() const = 0;
 
+        /**
+         * Requests that once the handshake has completed the encryption of outgoing data is
+         * handed to the operating system's kernel TLS support, so that writes to the socket go
+         * to the kernel as plain data.  This is only a request, it is honored when both the
+         * platform and the SSL provider support kernel TLS for the negotiated cipher suite and
+         * the socket falls back to encrypting in user space otherwise.  This method must be
+         * called before the handshake starts.
+         *
+         * The default implementation ignores the request, providers that can make use of
+         * kernel TLS override it.
+         *
+         * @param value
+         *      True if kernel TLS should be used when available.
+         */
+        virtual void setUseKernelTLS(bool value);
+
+        /**
+         * @return true if kernel TLS was requested for this socket and the provider supports it.
+         */
+        virtual bool getUseKernelTLS() const;
+
     };
 
 }}}
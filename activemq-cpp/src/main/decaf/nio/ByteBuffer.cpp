@@ -23,6 +23,8 @@
 #include "decaf/lang/Float.h"
 #include "decaf/lang/Double.h"
 
+#include <string.h>
+
 using namespace std;
 using namespace decaf;
 using namespace decaf::nio;
@@ -30,6 +32,101 @@ using namespace decaf::internal::nio;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The storage at the buffer's position when it can be written to directly, NULL
+    // when the buffer has to be accessed through its get and put methods.
+    unsigned char* storageAt(ByteBuffer& buffer) {
+
+        if (!buffer.hasArray() || buffer.isReadOnly()) {
+            return NULL;
+        }
+
+        return buffer.array() + buffer.arrayOffset() + buffer.position();
+    }
+
+    template<typename T>
+    void getValues(ByteBuffer& buffer, T* values, int count, T (ByteBuffer::*getter)()) {
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "Negative count: %d", count);
+        }
+
+        if (count == 0) {
+            return;
+        }
+
+        if (values == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Passed Buffer is Null.");
+        }
+
+        if (count > buffer.remaining() / (int) sizeof(T)) {
+            throw BufferUnderflowException(__FILE__, __LINE__, "Not Enough Data to Fill Request.");
+        }
+
+        const unsigned char* bytes = storageAt(buffer);
+        if (bytes == NULL) {
+            for (int i = 0; i < count; ++i) {
+                values[i] = (buffer.*getter)();
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i, bytes += sizeof(T)) {
+            unsigned long long value = 0;
+            for (std::size_t j = 0; j < sizeof(T); ++j) {
+                value = (value << 8) | bytes[j];
+            }
+            values[i] = (T) value;
+        }
+
+        buffer.position(buffer.position() + count * (int) sizeof(T));
+    }
+
+    template<typename T>
+    void putValues(ByteBuffer& buffer, const T* values, int count, ByteBuffer& (ByteBuffer::*putter)(T)) {
+
+        if (buffer.isReadOnly()) {
+            throw ReadOnlyBufferException(__FILE__, __LINE__, "This buffer is Read Only.");
+        }
+
+        if (count < 0) {
+            throw IndexOutOfBoundsException(__FILE__, __LINE__, "Negative count: %d", count);
+        }
+
+        if (count == 0) {
+            return;
+        }
+
+        if (values == NULL) {
+            throw NullPointerException(__FILE__, __LINE__, "Passed Buffer is Null.");
+        }
+
+        if (count > buffer.remaining() / (int) sizeof(T)) {
+            throw BufferOverflowException(__FILE__, __LINE__, "Not Enough space to store requested Data.");
+        }
+
+        unsigned char* bytes = storageAt(buffer);
+        if (bytes == NULL) {
+            for (int i = 0; i < count; ++i) {
+                (buffer.*putter)(values[i]);
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i, bytes += sizeof(T)) {
+            unsigned long long value = (unsigned long long) values[i];
+            for (int j = (int) sizeof(T) - 1; j >= 0; --j) {
+                bytes[j] = (unsigned char) value;
+                value >>= 8;
+            }
+        }
+
+        buffer.position(buffer.position() + count * (int) sizeof(T));
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteBuffer::ByteBuffer( int capacity ) : Buffer( capacity ) {
 }
@@ -44,6 +141,16 @@ ByteBuffer* ByteBuffer::allocate( int capacity ) {
     DECAF_CATCHALL_THROW( IllegalArgumentException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer* ByteBuffer::allocateDirect( int capacity ) {
+
+    try{
+        return BufferFactory::createDirectByteBuffer( capacity );
+    }
+    DECAF_CATCH_RETHROW( IllegalArgumentException )
+    DECAF_CATCHALL_THROW( IllegalArgumentException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ByteBuffer* ByteBuffer::wrap( unsigned char* buffer, int size, int offset, int length ) {
 
@@ -128,6 +235,13 @@ ByteBuffer& ByteBuffer::get( unsigned char* buffer, int size, int offset, int le
                 "ByteBuffer::get - Not Enough Data to Fill Request.");
         }
 
+        const unsigned char* storage = storageAt( *this );
+        if( storage != NULL ) {
+            memcpy( buffer + offset, storage, length );
+            this->position( this->position() + length );
+            return *this;
+        }
+
         // read length bytes starting from the offset
         for( int ix = 0; ix < length; ++ix ) {
             buffer[ix + offset] = this->get();
@@ -165,6 +279,17 @@ ByteBuffer& ByteBuffer::put( ByteBuffer& src ) {
                 "ByteBuffer::put - Not enough space remaining to put src." );
         }
 
+        unsigned char* storage = storageAt( *this );
+        const unsigned char* source = storageAt( src );
+        if( storage != NULL && source != NULL ) {
+            // Views of one array may overlap.
+            int length = src.remaining();
+            memmove( storage, source, length );
+            this->position( this->position() + length );
+            src.position( src.limit() );
+            return *this;
+        }
+
         while( src.hasRemaining() ) {
             this->put( src.get() );
         }
@@ -210,6 +335,13 @@ ByteBuffer& ByteBuffer::put( const unsigned char* buffer, int size, int offset,
                 "ByteBuffer::put - Not Enough space to store requested Data.");
         }
 
+        unsigned char* storage = storageAt( *this );
+        if( storage != NULL ) {
+            memcpy( storage, buffer + offset, length );
+            this->position( this->position() + length );
+            return *this;
+        }
+
         // read length bytes starting from the offset
         for( int ix = 0; ix < length; ++ix ) {
             this->put( buffer[ix + offset] );
@@ -241,6 +373,93 @@ ByteBuffer& ByteBuffer::put( std::vector<unsigned char>& buffer ) {
     DECAF_CATCHALL_THROW( BufferOverflowException )
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::getShorts( short* values, int count ) {
+
+    try{
+        getValues<short>( *this, values, count, &ByteBuffer::getShort );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferUnderflowException )
+    DECAF_CATCHALL_THROW( BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::getInts( int* values, int count ) {
+
+    try{
+        getValues<int>( *this, values, count, &ByteBuffer::getInt );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferUnderflowException )
+    DECAF_CATCHALL_THROW( BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::getLongs( long long* values, int count ) {
+
+    try{
+        getValues<long long>( *this, values, count, &ByteBuffer::getLong );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferUnderflowException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferUnderflowException )
+    DECAF_CATCHALL_THROW( BufferUnderflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::putShorts( const short* values, int count ) {
+
+    try{
+        putValues<short>( *this, values, count, &ByteBuffer::putShort );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferOverflowException )
+    DECAF_CATCH_RETHROW( ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferOverflowException )
+    DECAF_CATCHALL_THROW( BufferOverflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::putInts( const int* values, int count ) {
+
+    try{
+        putValues<int>( *this, values, count, &ByteBuffer::putInt );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferOverflowException )
+    DECAF_CATCH_RETHROW( ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferOverflowException )
+    DECAF_CATCHALL_THROW( BufferOverflowException )
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ByteBuffer& ByteBuffer::putLongs( const long long* values, int count ) {
+
+    try{
+        putValues<long long>( *this, values, count, &ByteBuffer::putLong );
+        return *this;
+    }
+    DECAF_CATCH_RETHROW( BufferOverflowException )
+    DECAF_CATCH_RETHROW( ReadOnlyBufferException )
+    DECAF_CATCH_RETHROW( NullPointerException )
+    DECAF_CATCH_RETHROW( IndexOutOfBoundsException )
+    DECAF_CATCH_EXCEPTION_CONVERT( Exception, BufferOverflowException )
+    DECAF_CATCHALL_THROW( BufferOverflowException )
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int ByteBuffer::compareTo( const ByteBuffer& value ) const {
 
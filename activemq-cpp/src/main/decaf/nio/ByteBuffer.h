@@ -231,6 +231,86 @@ namespace nio{
          */
         ByteBuffer& put(std::vector<unsigned char>& buffer);
 
+        /**
+         * Relative bulk get method for big-endian short values, the typed form of
+         * get( buffer, size, offset, length ).  The count values are decoded from the
+         * bytes at the current position, which is then incremented by 2 * count.
+         *
+         * @param values
+         *      The array to fill, at least count elements long.
+         * @param count
+         *      The number of values to read.
+         *
+         * @return a reference to this buffer.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         * @throws BufferUnderflowException if fewer than 2 * count bytes remain.
+         */
+        virtual ByteBuffer& getShorts(short* values, int count);
+
+        /**
+         * Relative bulk get method for big-endian int values, the position is
+         * incremented by 4 * count.
+         *
+         * @see getShorts
+         */
+        virtual ByteBuffer& getInts(int* values, int count);
+
+        /**
+         * Relative bulk get method for big-endian long long values, the position is
+         * incremented by 8 * count.
+         *
+         * @see getShorts
+         */
+        virtual ByteBuffer& getLongs(long long* values, int count);
+
+        /**
+         * Relative bulk put method for short values, the typed form of
+         * put( buffer, size, offset, length ).  The count values are encoded big-endian
+         * at the current position, which is then incremented by 2 * count.
+         *
+         * @param values
+         *      The values to write, at least count elements long.
+         * @param count
+         *      The number of values to write.
+         *
+         * @return a reference to this buffer.
+         *
+         * @throws NullPointerException if values is NULL and count is not zero.
+         * @throws IndexOutOfBoundsException if count is negative.
+         * @throws BufferOverflowException if fewer than 2 * count bytes remain.
+         * @throws ReadOnlyBufferException if this buffer is read-only.
+         */
+        virtual ByteBuffer& putShorts(const short* values, int count);
+
+        /**
+         * Relative bulk put method for int values, the position is incremented by
+         * 4 * count.
+         *
+         * @see putShorts
+         */
+        virtual ByteBuffer& putInts(const int* values, int count);
+
+        /**
+         * Relative bulk put method for long long values, the position is incremented
+         * by 8 * count.
+         *
+         * @see putShorts
+         */
+        virtual ByteBuffer& putLongs(const long long* values, int count);
+
+        /**
+         * Tells whether or not this buffer is direct, its storage allocated by
+         * allocateDirect starting on a page boundary.  Views of a direct buffer created
+         * by duplicate and slice are direct as well.
+         *
+         * @return true if this buffer is direct.
+         */
+        virtual bool isDirect() const {
+            return false;
+        }
+
     public:   // Abstract Methods
 
         /**
@@ -879,6 +959,22 @@ namespace nio{
          */
         static ByteBuffer* allocate(int capacity);
 
+        /**
+         * Allocates a new direct byte buffer.  Its storage starts on a page boundary and
+         * is otherwise used as the storage of an allocated buffer, its position will be
+         * zero its limit will be its capacity and its mark is not set.  Reading into and
+         * writing from its array with the stream read( ByteBuffer* ) and
+         * write( ByteBuffer* ) methods passes the storage straight to the stream.
+         *
+         * @param capacity
+         *      The internal buffer's capacity.
+         *
+         * @return a newly allocated ByteBuffer which the caller owns.
+         *
+         * @throws IllegalArgumentException if capacity is negative.
+         */
+        static ByteBuffer* allocateDirect(int capacity);
+
         /**
          * Wraps the passed buffer with a new ByteBuffer.
          *
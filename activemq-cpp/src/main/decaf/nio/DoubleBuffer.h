@@ -226,7 +226,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        DoubleBuffer& get( double* buffer, int size, int offset, int length );
+        virtual DoubleBuffer& get( double* buffer, int size, int offset, int length );
 
         /**
          * Tells whether or not this buffer is backed by an accessible double array.
@@ -288,7 +288,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        DoubleBuffer& put( const double* buffer, int size, int offset, int length );
+        virtual DoubleBuffer& put( const double* buffer, int size, int offset, int length );
 
         /**
          * This method transfers the entire content of the given source doubles array into
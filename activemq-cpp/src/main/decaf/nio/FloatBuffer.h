@@ -224,7 +224,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        FloatBuffer& get( float* buffer, int size, int offset, int length );
+        virtual FloatBuffer& get( float* buffer, int size, int offset, int length );
 
         /**
          * Tells whether or not this buffer is backed by an accessible float array.
@@ -286,7 +286,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        FloatBuffer& put( const float* buffer, int size, int offset, int length );
+        virtual FloatBuffer& put( const float* buffer, int size, int offset, int length );
 
         /**
          * This method transfers the entire content of the given source floats array into
@@ -224,7 +224,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        IntBuffer& get( int* buffer, int size, int offset, int length );
+        virtual IntBuffer& get( int* buffer, int size, int offset, int length );
 
         /**
          * Tells whether or not this buffer is backed by an accessible int array.
@@ -286,7 +286,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        IntBuffer& put( const int* buffer, int size, int offset, int length );
+        virtual IntBuffer& put( const int* buffer, int size, int offset, int length );
 
         /**
          * This method transfers the entire content of the given source ints array into
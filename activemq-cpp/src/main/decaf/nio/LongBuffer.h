@@ -224,7 +224,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        LongBuffer& get( long long* buffer, int size, int offset, int length );
+        virtual LongBuffer& get( long long* buffer, int size, int offset, int length );
 
         /**
          * Tells whether or not this buffer is backed by an accessible long long array.
@@ -286,7 +286,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        LongBuffer& put( const long long* buffer, int size, int offset, int length );
+        virtual LongBuffer& put( const long long* buffer, int size, int offset, int length );
 
         /**
          * This method transfers the entire content of the given source long longs array long longo
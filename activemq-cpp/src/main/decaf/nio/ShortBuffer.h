@@ -224,7 +224,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        ShortBuffer& get( short* buffer, int size, int offset, int length );
+        virtual ShortBuffer& get( short* buffer, int size, int offset, int length );
 
         /**
          * Tells whether or not this buffer is backed by an accessible short array.
@@ -286,7 +286,7 @@ namespace nio{
          * @throws IndexOutOfBoundsException if the preconditions of size, offset, or length
          *         are not met.
          */
-        ShortBuffer& put( const short* buffer, int size, int offset, int length );
+        virtual ShortBuffer& put( const short* buffer, int size, int offset, int length );
 
         /**
          * This method transfers the entire content of the given source shorts array into
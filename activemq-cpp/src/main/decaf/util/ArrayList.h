@@ -181,6 +181,27 @@ namespace util {
             }
         }
 
+        /**
+         * A random access iterator over the list that is held by value, unlike the one
+         * returned from iterator() it needs no allocation and its calls are not virtual.
+         * It is invalidated by any change to the list.
+         */
+        typedef const E* const_iterator;
+
+        /**
+         * @return an iterator at the first element, equal to end() if the list is empty.
+         */
+        const_iterator begin() const {
+            return this->elements;
+        }
+
+        /**
+         * @return an iterator one past the last element.
+         */
+        const_iterator end() const {
+            return this->elements + this->curSize;
+        }
+
         virtual bool isEmpty() const {
             return this->curSize == 0;
         }
@@ -374,6 +395,19 @@ namespace util {
 
     private:
 
+        /**
+         * Grows by at least half the current capacity so that a list built up one
+         * element at a time is copied a logarithmic rather than linear number of times.
+         */
+        int grownCapacity(int amount) const {
+            int growth = this->capacity / 2;
+            if (growth < amount) {
+                growth = amount;
+            }
+
+            return this->capacity + growth + 11;
+        }
+
         void expandFront(int amount) {
 
             if (amount == 0) {
@@ -383,7 +417,7 @@ namespace util {
             E* previous = this->elements;
 
             if (amount > this->capacity - this->curSize) {
-                this->capacity = this->capacity + amount + 11;
+                this->capacity = grownCapacity(amount);
                 this->elements = new E[this->capacity];
             }
 
@@ -405,7 +439,7 @@ namespace util {
             E* previous = this->elements;
 
             if (amount > this->capacity - this->curSize) {
-                this->capacity = this->capacity + amount + 11;
+                this->capacity = grownCapacity(amount);
                 this->elements = new E[this->capacity];
                 System::arraycopy( previous, 0, this->elements, 0, this->curSize );
             }
@@ -424,7 +458,7 @@ namespace util {
             E* previous = this->elements;
 
             if (amount > this->capacity - this->curSize) {
-                this->capacity = this->capacity + amount + 11;
+                this->capacity = grownCapacity(amount);
                 this->elements = new E[this->capacity];
             }
 
@@ -23,6 +23,7 @@
 
 #include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
 #include <decaf/lang/Math.h>
 
 using namespace std;
@@ -62,13 +63,14 @@ namespace {
         0x1000000000000000ULL, 0x2000000000000000ULL, 0x4000000000000000ULL,
         0x8000000000000000ULL };
 
-    int pop(unsigned long long x) {
-        x = x - ((x >> 1) & 0x55555555);
-        x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
-        x = (x + (x >> 4)) & 0x0f0f0f0f;
-        x = x + (x >> 8);
-        x = x + (x >> 16);
-        return (int) x & 0x0000003f;
+    // Word scans use the population count and bit scan instructions behind the
+    // Long bit methods instead of testing one bit at a time.
+    inline int lowestBit(unsigned long long word) {
+        return Long::numberOfTrailingZeros((long long) word);
+    }
+
+    inline int highestBit(unsigned long long word) {
+        return (ELM_SIZE - 1) - Long::numberOfLeadingZeros((long long) word);
     }
 }
 
@@ -213,12 +215,9 @@ int BitSet::cardinality() {
         return 0;
     }
     int count = 0;
-    int length = bitsSize;
-    // FIXME: need to test performance, if still not satisfied, change it to
-    // 256-bits table based
+    int length = actualArrayLength;
     for (int idx = 0; idx < length; idx++) {
-        count += pop(bits[idx] & 0xffffffffL);
-        count += pop((bits[idx] >> 32));
+        count += Long::bitCount((long long) bits[idx]);
     }
     return count;
 }
@@ -543,12 +542,7 @@ int BitSet::length() const {
     if (idx == -1) {
         return 0;
     }
-    int i = ELM_SIZE - 1;
-    unsigned long long val = bits[idx];
-    while ((val & (TWO_N_ARRAY[i])) == 0 && i > 0) {
-        i--;
-    }
-    return (idx << OFFSET) + i + 1;
+    return (idx << OFFSET) + highestBit(bits[idx]) + 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -564,14 +558,12 @@ int BitSet::nextClearBit(int index) const {
     }
 
     int idx = index >> OFFSET;
-    // first check in the same bit set element
-    if (bits[idx] != (~0ULL)) {
-        for (int j = index % ELM_SIZE; j < ELM_SIZE; j++) {
-            if (((bits[idx] & (TWO_N_ARRAY[j])) == 0)) {
-                return idx * ELM_SIZE + j;
-            }
-        }
+    // first check in the same bit set element, ignoring the bits below the index
+    unsigned long long word = ~bits[idx] & ((~0ULL) << (index & RIGHT_BITS));
+    if (word != 0ULL) {
+        return (idx << OFFSET) + lowestBit(word);
     }
+
     idx++;
     while (idx < length && bits[idx] == (~0ULL)) {
         idx++;
@@ -580,15 +572,7 @@ int BitSet::nextClearBit(int index) const {
         return bssize;
     }
 
-    // we know for sure there is a bit set to true in this element
-    // since the bitset value is not 0ULL
-    for (int j = 0; j < ELM_SIZE; j++) {
-        if (((bits[idx] & (TWO_N_ARRAY[j])) == 0)) {
-            return (idx << OFFSET) + j;
-        }
-    }
-
-    return bssize;
+    return (idx << OFFSET) + lowestBit(~bits[idx]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -602,13 +586,10 @@ int BitSet::nextSetBit(int index) const {
     }
 
     int idx = index >> OFFSET;
-    // first check in the same bit set element
-    if (bits[idx] != 0ULL) {
-        for (int j = index & RIGHT_BITS; j < ELM_SIZE; j++) {
-            if (((bits[idx] & (TWO_N_ARRAY[j])) != 0)) {
-                return (idx << OFFSET) + j;
-            }
-        }
+    // first check in the same bit set element, ignoring the bits below the index
+    unsigned long long word = bits[idx] & ((~0ULL) << (index & RIGHT_BITS));
+    if (word != 0ULL) {
+        return (idx << OFFSET) + lowestBit(word);
     }
 
     idx++;
@@ -619,15 +600,7 @@ int BitSet::nextSetBit(int index) const {
         return -1;
     }
 
-    // we know for sure there is a bit set to true in this element
-    // since the bitset value is not 0ULL
-    for (int j = 0; j < ELM_SIZE; j++) {
-        if (((bits[idx] & (TWO_N_ARRAY[j])) != 0)) {
-            return (idx << OFFSET) + j;
-        }
-    }
-
-    return -1;
+    return (idx << OFFSET) + lowestBit(bits[idx]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -721,20 +694,17 @@ std::string BitSet::toString() const {
     sb.append("{");
     bool comma = false;
     for (int i = 0; i < bitsSize; i++) {
-        if (bits[i] == 0) {
-            bitCount += ELM_SIZE;
-            continue;
-        }
-        for (int j = 0; j < ELM_SIZE; j++) {
-            if (((bits[i] & (TWO_N_ARRAY[j])) != 0)) {
-                if (comma) {
-                    sb.append(", ");
-                }
-                sb.append(Integer::toString(bitCount));
-                comma = true;
+        unsigned long long word = bits[i];
+        while (word != 0ULL) {
+            if (comma) {
+                sb.append(", ");
             }
-            bitCount++;
+            sb.append(Integer::toString(bitCount + lowestBit(word)));
+            comma = true;
+            // Drop the lowest one-bit.
+            word &= word - 1;
         }
+        bitCount += ELM_SIZE;
     }
     sb.append("}");
     return sb;
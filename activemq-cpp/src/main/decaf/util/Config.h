@@ -166,4 +166,18 @@
     #define DECAF_STDCALL
 #endif
 
+/*
+ * Storage class for compiler supported thread local variables, left undefined where
+ * there is none or when DECAF_NO_NATIVE_TLS is defined, code using it must keep a
+ * fallback to the platform TLS keys.  Only plain data can be held this way, values
+ * get no constructor or destructor call.
+ */
+#if !defined(DECAF_NO_NATIVE_TLS)
+    #if defined(_MSC_VER)
+        #define DECAF_THREAD_LOCAL __declspec(thread)
+    #elif defined(__GNUC__) || defined(__SUNPRO_CC)
+        #define DECAF_THREAD_LOCAL __thread
+    #endif
+#endif
+
 #endif /*_DECAF_UTIL_CONFIG_H_*/
@@ -928,6 +928,79 @@ namespace util {
             return !this->equals(other);
         }
 
+    public:
+
+        /**
+         * A forward iterator over the map's entries in no particular order that is held by value, unlike the ones
+         * of entrySet(), keySet() and values() it needs no allocation and its calls
+         * are not virtual.  It is invalidated by any change to the map.
+         */
+        class const_iterator {
+        private:
+
+            const HashMap* map;
+            int bucket;
+            const HashMapEntry* entry;
+
+        public:
+
+            const_iterator() : map(NULL), bucket(0), entry(NULL) {}
+
+            const_iterator(const HashMap* map, int bucket) : map(map), bucket(bucket), entry(NULL) {
+                this->nextBucket();
+            }
+
+            const K& getKey() const {
+                return this->entry->getKey();
+            }
+
+            const V& getValue() const {
+                return this->entry->getValue();
+            }
+
+            const_iterator& operator++() {
+                this->entry = this->entry->next;
+                this->nextBucket();
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result(*this);
+                ++(*this);
+                return result;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return this->entry == other.entry;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return this->entry != other.entry;
+            }
+
+        private:
+
+            void nextBucket() {
+                while (this->entry == NULL && this->bucket < this->map->elementData.length()) {
+                    this->entry = this->map->elementData[this->bucket++];
+                }
+            }
+        };
+
+        /**
+         * @return an iterator at the first entry, equal to end() if the map is empty.
+         */
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        /**
+         * @return an iterator past the last entry.
+         */
+        const_iterator end() const {
+            return const_iterator(this, this->elementData.length());
+        }
+
     public:
 
         virtual void clear() {
@@ -699,6 +699,66 @@ namespace util {
 
     public:
 
+        /**
+         * A forward iterator over the map's entries in the map's order that is held by value, unlike the ones
+         * of entrySet(), keySet() and values() it needs no allocation and its calls
+         * are not virtual.  It is invalidated by any change to the map.
+         */
+        class const_iterator {
+        private:
+
+            const LinkedHashMapEntry* entry;
+
+        public:
+
+            const_iterator() : entry(NULL) {}
+
+            explicit const_iterator(const LinkedHashMapEntry* entry) : entry(entry) {}
+
+            const K& getKey() const {
+                return this->entry->getKey();
+            }
+
+            const V& getValue() const {
+                return this->entry->getValue();
+            }
+
+            const_iterator& operator++() {
+                this->entry = this->entry->chainForward;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result(*this);
+                this->entry = this->entry->chainForward;
+                return result;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return this->entry == other.entry;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return this->entry != other.entry;
+            }
+        };
+
+        /**
+         * Hides the HashMap iteration, which is not in the map's order.
+         *
+         * @return an iterator at the first entry, equal to end() if the map is empty.
+         */
+        const_iterator begin() const {
+            return const_iterator(this->head);
+        }
+
+        /**
+         * @return an iterator past the last entry.
+         */
+        const_iterator end() const {
+            return const_iterator(NULL);
+        }
+
         virtual bool containsValue(const V& value) const {
             LinkedHashMapEntry* entry = head;
             while (entry != NULL) {
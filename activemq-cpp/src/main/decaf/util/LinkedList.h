@@ -19,10 +19,13 @@
 #define _DECAF_UTIL_LINKEDLIST_H_
 
 #include <list>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <decaf/util/NoSuchElementException.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
 #include <decaf/util/Config.h>
@@ -86,15 +89,23 @@ namespace util {
         ListNode<E> head;
         ListNode<E> tail;
 
+        // Nodes of removed elements kept for reuse, chained through their next
+        // pointers, and the most this list keeps.
+        ListNode<E>* freeNodes;
+        int cachedNodes;
+        int nodeCacheSize;
+
     public:
 
-        LinkedList() : AbstractSequentialList<E>(), listSize(0), head(), tail() {
+        LinkedList() : AbstractSequentialList<E>(), listSize(0), head(), tail(),
+                       freeNodes(NULL), cachedNodes(0), nodeCacheSize(0) {
 
             this->head.next = &this->tail;
             this->tail.prev = &this->head;
         }
 
-        LinkedList(const LinkedList<E>& list) : AbstractSequentialList<E>(), listSize(0), head(), tail() {
+        LinkedList(const LinkedList<E>& list) : AbstractSequentialList<E>(), listSize(0), head(), tail(),
+                                                freeNodes(NULL), cachedNodes(0), nodeCacheSize(0) {
 
             this->head.next = &this->tail;
             this->tail.prev = &this->head;
@@ -102,7 +113,8 @@ namespace util {
             this->addAllAtLocation(0, list);
         }
 
-        LinkedList(const Collection<E>& collection) : AbstractSequentialList<E>(), listSize(0), head(), tail() {
+        LinkedList(const Collection<E>& collection) : AbstractSequentialList<E>(), listSize(0), head(), tail(),
+                                                    freeNodes(NULL), cachedNodes(0), nodeCacheSize(0) {
 
             this->head.next = &this->tail;
             this->tail.prev = &this->head;
@@ -112,7 +124,9 @@ namespace util {
 
         virtual ~LinkedList() {
             try{
+                this->nodeCacheSize = 0;
                 this->purgeList();
+                this->trimNodeCache(0);
             } catch(...) {}
         }
 
@@ -138,6 +152,104 @@ namespace util {
             return !this->equals(other);
         }
 
+    public:
+
+        /**
+         * A forward iterator over the list that is held by value, unlike the one
+         * returned from iterator() it needs no allocation and its calls are not virtual.
+         * It is invalidated by any change to the list.
+         */
+        class const_iterator {
+        public:
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef E value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const E* pointer;
+            typedef const E& reference;
+
+        private:
+
+            const ListNode<E>* node;
+
+        public:
+
+            const_iterator() : node(NULL) {}
+
+            explicit const_iterator(const ListNode<E>* node) : node(node) {}
+
+            const E& operator*() const {
+                return this->node->value;
+            }
+
+            const E* operator->() const {
+                return &this->node->value;
+            }
+
+            const_iterator& operator++() {
+                this->node = this->node->next;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result(*this);
+                this->node = this->node->next;
+                return result;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return this->node == other.node;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return this->node != other.node;
+            }
+        };
+
+        /**
+         * @return an iterator at the first element, equal to end() if the list is empty.
+         */
+        const_iterator begin() const {
+            return const_iterator(this->head.next);
+        }
+
+        /**
+         * @return an iterator one past the last element.
+         */
+        const_iterator end() const {
+            return const_iterator(&this->tail);
+        }
+
+    public:
+
+        /**
+         * @return the most nodes of removed elements this list keeps for reuse.
+         */
+        int getNodeCacheSize() const {
+            return this->nodeCacheSize;
+        }
+
+        /**
+         * Sets the most nodes of removed elements this list keeps to hold elements
+         * added later, zero, the default, frees each node as its element is removed.
+         * A list that is used as a queue and sees a steady flow of elements through
+         * it then adds most of them without allocating.  A cached node doesn't keep
+         * the element it held, it is assigned a default constructed element.
+         *
+         * @param size
+         *      The number of nodes to keep for reuse.
+         *
+         * @throws IllegalArgumentException if the size is negative.
+         */
+        void setNodeCacheSize(int size) {
+            if (size < 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Node cache size cannot be negative: %d", size);
+            }
+            this->nodeCacheSize = size;
+            this->trimNodeCache(size);
+        }
+
     public:
 
         virtual E get(int index) const {
@@ -583,7 +695,7 @@ namespace util {
                 }
                 this->current = previous;
 
-                delete this->lastReturned;
+                this->list->releaseNode(this->lastReturned);
                 this->lastReturned = NULL;
 
                 this->list->listSize--;
@@ -598,7 +710,7 @@ namespace util {
                         __FILE__, __LINE__, "List modified outside of this Iterator." );
                 }
 
-                ListNode<E>* newNode = new ListNode<E>( this->current, this->current->next, e );
+                ListNode<E>* newNode = this->list->createNode(this->current, this->current->next, e);
 
                 this->current->next->prev = newNode;
                 this->current->next = newNode;
@@ -813,7 +925,7 @@ namespace util {
                 next->next = prev;
                 prev->prev = next;
 
-                delete this->current;
+                this->list->releaseNode(this->current);
 
                 this->current = prev;
 
@@ -904,7 +1016,7 @@ namespace util {
             this->head.next = oldNode->next;
             this->head.next->prev = &this->head;
 
-            delete oldNode;
+            this->releaseNode(oldNode);
 
             this->listSize--;
             AbstractList<E>::modCount++;
@@ -925,7 +1037,7 @@ namespace util {
             this->tail.prev = oldNode->prev;
             this->tail.prev->next = &this->tail;
 
-            delete oldNode;
+            this->releaseNode(oldNode);
 
             this->listSize--;
             AbstractList<E>::modCount++;
@@ -935,7 +1047,7 @@ namespace util {
 
         void addToFront(const E& value) {
 
-            ListNode<E>* newHead = new ListNode<E> (&this->head, this->head.next, value);
+            ListNode<E>* newHead = this->createNode(&this->head, this->head.next, value);
 
             (this->head.next)->prev = newHead;
             this->head.next = newHead;
@@ -946,7 +1058,7 @@ namespace util {
 
         void addToEnd(const E& value) {
 
-            ListNode<E>* newTail = new ListNode<E> (this->tail.prev, &this->tail, value);
+            ListNode<E>* newTail = this->createNode(this->tail.prev, &this->tail, value);
 
             (this->tail.prev)->next = newTail;
             this->tail.prev = newTail;
@@ -971,7 +1083,7 @@ namespace util {
                 }
             }
 
-            ListNode<E>* newNode = new ListNode<E> (location->prev, location, value);
+            ListNode<E>* newNode = this->createNode(location->prev, location, value);
 
             (location->prev)->next = newNode;
             location->prev = newNode;
@@ -1018,7 +1130,7 @@ namespace util {
             }
 
             while (iter->hasNext()) {
-                newNode = new ListNode<E> (previous, previous->next, iter->next());
+                newNode = this->createNode(previous, previous->next, iter->next());
                 previous->next->prev = newNode;
                 previous->next = newNode;
                 previous = newNode;
@@ -1036,7 +1148,46 @@ namespace util {
             while (current != &this->tail) {
                 temp = current;
                 current = current->next;
-                delete temp;
+                this->releaseNode(temp);
+            }
+        }
+
+        ListNode<E>* createNode(ListNode<E>* prev, ListNode<E>* next, const E& value) {
+
+            if (this->freeNodes == NULL) {
+                return new ListNode<E>(prev, next, value);
+            }
+
+            ListNode<E>* node = this->freeNodes;
+            this->freeNodes = node->next;
+            this->cachedNodes--;
+
+            node->value = value;
+            node->prev = prev;
+            node->next = next;
+            return node;
+        }
+
+        void releaseNode(ListNode<E>* node) {
+
+            if (this->cachedNodes >= this->nodeCacheSize) {
+                delete node;
+                return;
+            }
+
+            node->value = E();
+            node->prev = NULL;
+            node->next = this->freeNodes;
+            this->freeNodes = node;
+            this->cachedNodes++;
+        }
+
+        void trimNodeCache(int size) {
+            while (this->cachedNodes > size) {
+                ListNode<E>* node = this->freeNodes;
+                this->freeNodes = node->next;
+                this->cachedNodes--;
+                delete node;
             }
         }
     };
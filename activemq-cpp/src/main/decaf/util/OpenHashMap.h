@@ -0,0 +1,864 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_OPENHASHMAP_H_
+#define _DECAF_UTIL_OPENHASHMAP_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/AbstractMap.h>
+#include <decaf/util/AbstractSet.h>
+#include <decaf/util/AbstractCollection.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/util/ConcurrentModificationException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/ArrayPointer.h>
+
+#include <algorithm>
+
+namespace decaf {
+namespace util {
+
+    /**
+     * Hash table based implementation of the Map interface that keeps its mappings in
+     * flat arrays using open addressing with Robin Hood linear probing, in place of the
+     * chains of individually allocated entries that HashMap uses.
+     *
+     * A lookup hashes the key once and then walks consecutive slots of a compact array
+     * of hash codes and probe distances, the key itself is only compared once a slot's
+     * hash code matches.  Robin Hood insertion keeps every run of slots ordered by the
+     * distance of its mappings from their home slot, so a lookup for a missing key stops
+     * as soon as it passes a mapping closer to home than the key would be, and a removal
+     * shifts the rest of the run back by one slot rather than leaving a tombstone.  Puts
+     * and removes allocate nothing unless the table has to grow, which it does by
+     * doubling once three quarters of its slots are in use.
+     *
+     * The keys and values live in the table's slots, so unlike HashMap a reference
+     * returned from get() is only valid until the next put of a new key or the next
+     * removal.  Keys and values must be default constructible and assignable.
+     *
+     * Note that this implementation is not synchronized, if multiple threads access the
+     * map concurrently and at least one of them modifies it, it must be synchronized
+     * externally.  The iterators of the collection views are fail-fast in the same way
+     * as those of HashMap.
+     *
+     * @since 3.9.0
+     */
+    template<typename K, typename V, typename HASHCODE = HashCode<K> >
+    class OpenHashMap : public AbstractMap<K, V> {
+    private:
+
+        // The hash code and probe distance of a slot, kept apart from the keys and values
+        // so probing reads a dense array.  A distance of zero marks an empty slot, an
+        // occupied slot holds one more than the number of slots it is past its home.
+        struct Control {
+            unsigned int hash;
+            int distance;
+
+            Control() : hash(0), distance(0) {}
+        };
+
+        struct Slot {
+            K key;
+            V value;
+
+            Slot() : key(), value() {}
+        };
+
+    private:
+
+        class AbstractMapIterator {
+        protected:
+
+            const OpenHashMap* associatedMap;
+
+            // NULL when iterating a const view, which can't remove.
+            OpenHashMap* modifiableMap;
+
+            int expectedModCount;
+
+            // Iteration starts just past an empty slot, no run of slots crosses it so
+            // removals never shift a visited mapping into the slots still to come.
+            int start;
+            mutable int step;
+            int current;
+
+        private:
+
+            AbstractMapIterator(const AbstractMapIterator&);
+            AbstractMapIterator& operator= (const AbstractMapIterator&);
+
+        public:
+
+            AbstractMapIterator(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                associatedMap(parent), modifiableMap(modifiable), expectedModCount(parent->modCount),
+                start(parent->firstEmptySlot()), step(0), current(-1) {
+            }
+
+            virtual ~AbstractMapIterator() {}
+
+            int slotAt(int index) const {
+                return (start + 1 + index) & associatedMap->mask;
+            }
+
+            bool checkHasNext() const {
+                int length = associatedMap->control.length();
+                while (step < length && associatedMap->control[slotAt(step)].distance == 0) {
+                    step++;
+                }
+                return step < length;
+            }
+
+            void checkConcurrentMod() const {
+                if (expectedModCount != associatedMap->modCount) {
+                    throw ConcurrentModificationException(
+                        __FILE__, __LINE__, "OpenHashMap modified outside this iterator");
+                }
+            }
+
+            const Slot& makeNext() {
+                checkConcurrentMod();
+
+                if (!checkHasNext()) {
+                    throw NoSuchElementException(__FILE__, __LINE__, "No next element");
+                }
+
+                current = slotAt(step++);
+                return associatedMap->slots[current];
+            }
+
+            void doRemove() {
+
+                if (modifiableMap == NULL) {
+                    throw lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Cannot write to a const Iterator.");
+                }
+
+                checkConcurrentMod();
+
+                if (current == -1) {
+                    throw decaf::lang::exceptions::IllegalStateException(
+                        __FILE__, __LINE__, "Remove called before call to next()");
+                }
+
+                modifiableMap->removeSlot(current);
+                current = -1;
+
+                // The removal may have shifted a mapping not yet visited into the slot.
+                step--;
+                expectedModCount = associatedMap->modCount;
+            }
+        };
+
+        class EntryIterator : public Iterator< MapEntry<K,V> >, public AbstractMapIterator {
+        private:
+
+            EntryIterator(const EntryIterator&);
+            EntryIterator& operator= (const EntryIterator&);
+
+        public:
+
+            EntryIterator(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractMapIterator(parent, modifiable) {
+            }
+
+            virtual ~EntryIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual MapEntry<K, V> next() {
+                const Slot& slot = this->makeNext();
+                return MapEntry<K, V>(slot.key, slot.value);
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class KeyIterator : public Iterator<K>, public AbstractMapIterator {
+        private:
+
+            KeyIterator(const KeyIterator&);
+            KeyIterator& operator= (const KeyIterator&);
+
+        public:
+
+            KeyIterator(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractMapIterator(parent, modifiable) {
+            }
+
+            virtual ~KeyIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual K next() {
+                return this->makeNext().key;
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class ValueIterator : public Iterator<V>, public AbstractMapIterator {
+        private:
+
+            ValueIterator(const ValueIterator&);
+            ValueIterator& operator= (const ValueIterator&);
+
+        public:
+
+            ValueIterator(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractMapIterator(parent, modifiable) {
+            }
+
+            virtual ~ValueIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual V next() {
+                return this->makeNext().value;
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+    protected:
+
+        // Views backed by this map, the modifiable pointer is NULL for the const views.
+        class OpenHashMapEntrySet : public AbstractSet< MapEntry<K, V> > {
+        private:
+
+            const OpenHashMap* associatedMap;
+            OpenHashMap* modifiableMap;
+
+        private:
+
+            OpenHashMapEntrySet(const OpenHashMapEntrySet&);
+            OpenHashMapEntrySet& operator= (const OpenHashMapEntrySet&);
+
+        public:
+
+            OpenHashMapEntrySet(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractSet< MapEntry<K,V> >(), associatedMap(parent), modifiableMap(modifiable) {
+            }
+
+            virtual ~OpenHashMapEntrySet() {}
+
+            virtual int size() const {
+                return associatedMap->elementCount;
+            }
+
+            virtual void clear() {
+                checkModifiable();
+                modifiableMap->clear();
+            }
+
+            virtual bool remove(const MapEntry<K,V>& entry) {
+                checkModifiable();
+                int index = associatedMap->findSlot(entry.getKey());
+                if (index != -1 && entry.getValue() == associatedMap->slots[index].value) {
+                    modifiableMap->removeSlot(index);
+                    return true;
+                }
+                return false;
+            }
+
+            virtual bool contains(const MapEntry<K,V>& entry) const {
+                int index = associatedMap->findSlot(entry.getKey());
+                return index != -1 && entry.getValue() == associatedMap->slots[index].value;
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() {
+                checkModifiable();
+                return new EntryIterator(associatedMap, modifiableMap);
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() const {
+                return new EntryIterator(associatedMap, NULL);
+            }
+
+        private:
+
+            void checkModifiable() const {
+                if (modifiableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+            }
+        };
+
+        class OpenHashMapKeySet : public AbstractSet<K> {
+        private:
+
+            const OpenHashMap* associatedMap;
+            OpenHashMap* modifiableMap;
+
+        private:
+
+            OpenHashMapKeySet(const OpenHashMapKeySet&);
+            OpenHashMapKeySet& operator= (const OpenHashMapKeySet&);
+
+        public:
+
+            OpenHashMapKeySet(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractSet<K>(), associatedMap(parent), modifiableMap(modifiable) {
+            }
+
+            virtual ~OpenHashMapKeySet() {}
+
+            virtual bool contains(const K& key) const {
+                return associatedMap->containsKey(key);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                checkModifiable();
+                modifiableMap->clear();
+            }
+
+            virtual bool remove(const K& key) {
+                checkModifiable();
+                int index = associatedMap->findSlot(key);
+                if (index != -1) {
+                    modifiableMap->removeSlot(index);
+                    return true;
+                }
+                return false;
+            }
+
+            virtual Iterator<K>* iterator() {
+                checkModifiable();
+                return new KeyIterator(associatedMap, modifiableMap);
+            }
+
+            virtual Iterator<K>* iterator() const {
+                return new KeyIterator(associatedMap, NULL);
+            }
+
+        private:
+
+            void checkModifiable() const {
+                if (modifiableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+            }
+        };
+
+        class OpenHashMapValueCollection : public AbstractCollection<V> {
+        private:
+
+            const OpenHashMap* associatedMap;
+            OpenHashMap* modifiableMap;
+
+        private:
+
+            OpenHashMapValueCollection(const OpenHashMapValueCollection&);
+            OpenHashMapValueCollection& operator= (const OpenHashMapValueCollection&);
+
+        public:
+
+            OpenHashMapValueCollection(const OpenHashMap* parent, OpenHashMap* modifiable) :
+                AbstractCollection<V>(), associatedMap(parent), modifiableMap(modifiable) {
+            }
+
+            virtual ~OpenHashMapValueCollection() {}
+
+            virtual bool contains(const V& value) const {
+                return associatedMap->containsValue(value);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                checkModifiable();
+                modifiableMap->clear();
+            }
+
+            virtual Iterator<V>* iterator() {
+                checkModifiable();
+                return new ValueIterator(associatedMap, modifiableMap);
+            }
+
+            virtual Iterator<V>* iterator() const {
+                return new ValueIterator(associatedMap, NULL);
+            }
+
+        private:
+
+            void checkModifiable() const {
+                if (modifiableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Can't modify a const collection");
+                }
+            }
+        };
+
+    private:
+
+        static const int MINIMUM_CAPACITY = 16;
+        static const int MAXIMUM_CAPACITY = 1 << 30;
+
+        /**
+         * The Hash Code generator for this map's keys.
+         */
+        HASHCODE hashFunc;
+
+        // Number of mappings held.
+        int elementCount;
+
+        // Hash codes and probe distances, and the keys and values, of each slot.
+        decaf::lang::ArrayPointer<Control> control;
+        decaf::lang::ArrayPointer<Slot> slots;
+
+        // The table length less one, and the shift that takes a spread hash code to its
+        // home slot.
+        int mask;
+        int shift;
+
+        // Number of mappings held before the table grows.
+        int threshold;
+
+        // Structural modification count that keeps the iterators fail-fast.
+        int modCount;
+
+        // Cached values that are only initialized once a request for them is made.
+        decaf::lang::Pointer<OpenHashMapEntrySet> cachedEntrySet;
+        decaf::lang::Pointer<OpenHashMapKeySet> cachedKeySet;
+        decaf::lang::Pointer<OpenHashMapValueCollection> cachedValueCollection;
+
+        mutable decaf::lang::Pointer<OpenHashMapEntrySet> cachedConstEntrySet;
+        mutable decaf::lang::Pointer<OpenHashMapKeySet> cachedConstKeySet;
+        mutable decaf::lang::Pointer<OpenHashMapValueCollection> cachedConstValueCollection;
+
+    public:
+
+        /**
+         * Creates a new empty OpenHashMap with the default capacity.
+         */
+        OpenHashMap() : AbstractMap<K,V>(), hashFunc(), elementCount(0), control(), slots(),
+                        mask(0), shift(0), threshold(0), modCount(0),
+                        cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+                        cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            allocate(MINIMUM_CAPACITY);
+        }
+
+        /**
+         * Creates a new empty OpenHashMap that holds at least the given number of mappings
+         * before it has to grow.
+         *
+         * @param capacity
+         *      The number of mappings to make room for.
+         *
+         * @throws IllegalArgumentException when the capacity is less than zero.
+         */
+        OpenHashMap(int capacity) : AbstractMap<K,V>(), hashFunc(), elementCount(0), control(), slots(),
+                                    mask(0), shift(0), threshold(0), modCount(0),
+                                    cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+                                    cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            if (capacity < 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Invalid capacity configuration");
+            }
+
+            allocate(tableLengthFor(capacity));
+        }
+
+        /**
+         * Creates a new OpenHashMap and fills it with the contents of the given map.
+         *
+         * @param map
+         *      The OpenHashMap instance whose mappings are copied into this one.
+         */
+        OpenHashMap(const OpenHashMap<K, V, HASHCODE>& map) :
+            AbstractMap<K,V>(), hashFunc(), elementCount(0), control(), slots(),
+            mask(0), shift(0), threshold(0), modCount(0),
+            cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+            cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            allocate(tableLengthFor(map.size()));
+            putAll(map);
+        }
+
+        /**
+         * Creates a new OpenHashMap and fills it with the contents of the given map.
+         *
+         * @param map
+         *      The Map instance whose mappings are copied into this OpenHashMap.
+         */
+        OpenHashMap(const Map<K,V>& map) : AbstractMap<K,V>(), hashFunc(), elementCount(0), control(), slots(),
+                                           mask(0), shift(0), threshold(0), modCount(0),
+                                           cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+                                           cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            allocate(tableLengthFor(map.size()));
+            putAll(map);
+        }
+
+        virtual ~OpenHashMap() {}
+
+    public:
+
+        OpenHashMap<K, V, HASHCODE>& operator= (const Map<K, V>& other) {
+            this->copy(other);
+            return *this;
+        }
+
+        OpenHashMap<K, V, HASHCODE>& operator= (const OpenHashMap<K, V, HASHCODE>& other) {
+            this->copy(other);
+            return *this;
+        }
+
+        bool operator==(const Map<K, V>& other) const {
+            return this->equals(other);
+        }
+
+        bool operator!=(const Map<K, V>& other) const {
+            return !this->equals(other);
+        }
+
+    public:
+
+        virtual void clear() {
+            if (elementCount > 0) {
+                for (int i = 0; i < control.length(); ++i) {
+                    if (control[i].distance != 0) {
+                        control[i] = Control();
+                        slots[i] = Slot();
+                    }
+                }
+                elementCount = 0;
+                modCount++;
+            }
+        }
+
+        virtual bool isEmpty() const {
+            return elementCount == 0;
+        }
+
+        virtual int size() const {
+            return elementCount;
+        }
+
+        virtual bool containsKey(const K& key) const {
+            return findSlot(key) != -1;
+        }
+
+        virtual bool containsValue(const V& value) const {
+            for (int i = 0; i < control.length(); ++i) {
+                if (control[i].distance != 0 && value == slots[i].value) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        virtual V& get(const K& key) {
+            int index = findSlot(key);
+            if (index != -1) {
+                return slots[index].value;
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "The specified key is not present in the Map");
+        }
+
+        virtual const V& get(const K& key) const {
+            int index = findSlot(key);
+            if (index != -1) {
+                return slots[index].value;
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "The specified key is not present in the Map");
+        }
+
+        virtual bool put(const K& key, const V& value) {
+            V oldValue;
+            return put(key, value, oldValue);
+        }
+
+        virtual bool put(const K& key, const V& value, V& oldValue) {
+
+            unsigned int hash = spread(hashFunc(key));
+
+            int index = findSlot(key, hash);
+            if (index != -1) {
+                oldValue = slots[index].value;
+                slots[index].value = value;
+                return true;
+            }
+
+            modCount++;
+            if (elementCount >= threshold && control.length() < MAXIMUM_CAPACITY) {
+                resize(control.length() << 1);
+            }
+
+            insert(hash, key, value);
+            elementCount++;
+            return false;
+        }
+
+        virtual void putAll(const Map<K, V>& map) {
+            if (map.isEmpty() || &map == this) {
+                return;
+            }
+
+            int capacity = tableLengthFor(elementCount + map.size());
+            if (capacity > control.length()) {
+                resize(capacity);
+            }
+
+            decaf::lang::Pointer<Iterator< MapEntry<K,V> > > iterator(map.entrySet().iterator());
+            while (iterator->hasNext()) {
+                MapEntry<K, V> entry = iterator->next();
+                this->put(entry.getKey(), entry.getValue());
+            }
+        }
+
+        virtual V remove(const K& key) {
+            int index = findSlot(key);
+            if (index != -1) {
+                V oldValue = slots[index].value;
+                removeSlot(index);
+                return oldValue;
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Specified key not present in the Map.");
+        }
+
+        virtual Set< MapEntry<K,V> >& entrySet() {
+            if (this->cachedEntrySet == NULL) {
+                this->cachedEntrySet.reset(new OpenHashMapEntrySet(this, this));
+            }
+            return *(this->cachedEntrySet);
+        }
+
+        virtual const Set< MapEntry<K,V> >& entrySet() const {
+            if (this->cachedConstEntrySet == NULL) {
+                this->cachedConstEntrySet.reset(new OpenHashMapEntrySet(this, NULL));
+            }
+            return *(this->cachedConstEntrySet);
+        }
+
+        virtual Set<K>& keySet() {
+            if (this->cachedKeySet == NULL) {
+                this->cachedKeySet.reset(new OpenHashMapKeySet(this, this));
+            }
+            return *(this->cachedKeySet);
+        }
+
+        virtual const Set<K>& keySet() const {
+            if (this->cachedConstKeySet == NULL) {
+                this->cachedConstKeySet.reset(new OpenHashMapKeySet(this, NULL));
+            }
+            return *(this->cachedConstKeySet);
+        }
+
+        virtual Collection<V>& values() {
+            if (this->cachedValueCollection == NULL) {
+                this->cachedValueCollection.reset(new OpenHashMapValueCollection(this, this));
+            }
+            return *(this->cachedValueCollection);
+        }
+
+        virtual const Collection<V>& values() const {
+            if (this->cachedConstValueCollection == NULL) {
+                this->cachedConstValueCollection.reset(new OpenHashMapValueCollection(this, NULL));
+            }
+            return *(this->cachedConstValueCollection);
+        }
+
+        virtual bool equals(const Map<K, V>& source) const {
+
+            if (this == &source) {
+                return true;
+            }
+
+            if (size() != source.size()) {
+                return false;
+            }
+
+            for (int i = 0; i < control.length(); ++i) {
+                if (control[i].distance == 0) {
+                    continue;
+                }
+
+                if (!source.containsKey(slots[i].key) || !(source.get(slots[i].key) == slots[i].value)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        virtual void copy(const Map<K, V>& source) {
+            if (&source == this) {
+                return;
+            }
+
+            this->clear();
+            putAll(source);
+        }
+
+        virtual std::string toString() const {
+            return "OpenHashMap";
+        }
+
+    private:
+
+        // Multiplies by the golden ratio so keys whose hash codes differ only in their
+        // high bits, or are all multiples of the table length, still spread over the
+        // table, the home slot is taken from the top bits of the result.
+        static unsigned int spread(int hash) {
+            return (unsigned int) hash * 0x9E3779B9U;
+        }
+
+        static int tableLengthFor(int mappings) {
+            int length = MINIMUM_CAPACITY;
+            while (length < MAXIMUM_CAPACITY && mappings > length - (length >> 2)) {
+                length <<= 1;
+            }
+            return length;
+        }
+
+        void allocate(int length) {
+            control = decaf::lang::ArrayPointer<Control>(length);
+            slots = decaf::lang::ArrayPointer<Slot>(length);
+            mask = length - 1;
+            shift = 32;
+            for (int bits = length; bits > 1; bits >>= 1) {
+                shift--;
+            }
+            threshold = length - (length >> 2);
+        }
+
+        int homeOf(unsigned int hash) const {
+            return (int) (hash >> shift);
+        }
+
+        int firstEmptySlot() const {
+            int index = 0;
+            while (control[index].distance != 0) {
+                index++;
+            }
+            return index;
+        }
+
+        int findSlot(const K& key) const {
+            return findSlot(key, spread(hashFunc(key)));
+        }
+
+        int findSlot(const K& key, unsigned int hash) const {
+            int index = homeOf(hash);
+            for (int distance = 1; ; ++distance) {
+                const Control& slot = control[index];
+                // A slot closer to its home than the key would be ends the search, the
+                // key would have taken that slot when it was inserted.
+                if (slot.distance < distance) {
+                    return -1;
+                }
+                if (slot.hash == hash && key == slots[index].key) {
+                    return index;
+                }
+                index = (index + 1) & mask;
+            }
+        }
+
+        // Places a key that isn't in the map, taking the slot of any mapping closer to
+        // its home than the key is and carrying that mapping on in its place.
+        void insert(unsigned int hash, const K& key, const V& value) {
+
+            Control carried;
+            carried.hash = hash;
+            carried.distance = 1;
+
+            Slot entry;
+            entry.key = key;
+            entry.value = value;
+
+            int index = homeOf(hash);
+            while (control[index].distance != 0) {
+                if (control[index].distance < carried.distance) {
+                    std::swap(control[index], carried);
+                    std::swap(slots[index], entry);
+                }
+                carried.distance++;
+                index = (index + 1) & mask;
+            }
+
+            control[index] = carried;
+            slots[index] = entry;
+        }
+
+        // Empties the slot and shifts the mappings after it that aren't in their home
+        // slot back by one.
+        void removeSlot(int index) {
+
+            int next = (index + 1) & mask;
+            while (control[next].distance > 1) {
+                control[index] = control[next];
+                control[index].distance--;
+                slots[index] = slots[next];
+                index = next;
+                next = (next + 1) & mask;
+            }
+
+            control[index] = Control();
+            slots[index] = Slot();
+
+            elementCount--;
+            modCount++;
+        }
+
+        void resize(int length) {
+
+            decaf::lang::ArrayPointer<Control> oldControl = control;
+            decaf::lang::ArrayPointer<Slot> oldSlots = slots;
+
+            allocate(length);
+
+            for (int i = 0; i < oldControl.length(); ++i) {
+                if (oldControl[i].distance != 0) {
+                    insert(oldControl[i].hash, oldSlots[i].key, oldSlots[i].value);
+                }
+            }
+        }
+
+    };
+
+}}
+
+#endif /* _DECAF_UTIL_OPENHASHMAP_H_ */
@@ -658,6 +658,65 @@ namespace util{
 
         virtual ~StlMap() {}
 
+        /**
+         * A forward iterator over the map's entries in key order that is held by value, unlike the ones
+         * of entrySet(), keySet() and values() it needs no allocation and its calls
+         * are not virtual.  It is invalidated by any change to the map.
+         */
+        class const_iterator {
+        private:
+
+            typename std::map<K, V, COMPARATOR>::const_iterator position;
+
+        public:
+
+            const_iterator() : position() {}
+
+            explicit const_iterator(typename std::map<K, V, COMPARATOR>::const_iterator position) :
+                position(position) {}
+
+            const K& getKey() const {
+                return this->position->first;
+            }
+
+            const V& getValue() const {
+                return this->position->second;
+            }
+
+            const_iterator& operator++() {
+                ++this->position;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result(*this);
+                ++this->position;
+                return result;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return this->position == other.position;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return this->position != other.position;
+            }
+        };
+
+        /**
+         * @return an iterator at the first entry, equal to end() if the map is empty.
+         */
+        const_iterator begin() const {
+            return const_iterator(this->valueMap.begin());
+        }
+
+        /**
+         * @return an iterator past the last entry.
+         */
+        const_iterator end() const {
+            return const_iterator(this->valueMap.end());
+        }
+
         /**
          * {@inheritDoc}
          */
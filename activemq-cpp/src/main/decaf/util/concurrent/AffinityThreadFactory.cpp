@@ -0,0 +1,73 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "AffinityThreadFactory.h"
+
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <memory>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+AffinityThreadFactory::AffinityThreadFactory(ThreadFactory* delegate, const std::vector<int>& affinity) :
+    ThreadFactory(), delegate(delegate), affinity(affinity) {
+
+    if (delegate == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "The delegate ThreadFactory cannot be NULL.");
+    }
+
+    std::vector<int>::const_iterator iter = affinity.begin();
+    for (; iter != affinity.end(); ++iter) {
+        if (*iter < 0) {
+            delete delegate;
+            throw IllegalArgumentException(
+                __FILE__, __LINE__, "Processor index {%d} is negative.", *iter);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AffinityThreadFactory::~AffinityThreadFactory() {
+    try {
+        delete this->delegate;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Thread* AffinityThreadFactory::newThread(Runnable* r) {
+
+    try {
+
+        std::auto_ptr<Thread> thread(this->delegate->newThread(r));
+
+        if (thread.get() != NULL && !this->affinity.empty()) {
+            thread->setAffinity(this->affinity);
+        }
+
+        return thread.release();
+    }
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _DECAF_UTIL_CONCURRENT_AFFINITYTHREADFACTORY_H_
+#define _DECAF_UTIL_CONCURRENT_AFFINITYTHREADFACTORY_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/concurrent/ThreadFactory.h>
+
+#include <vector>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    /**
+     * A ThreadFactory that restricts every Thread it creates to a fixed set of processors.
+     * The Threads themselves come from another ThreadFactory so this can be layered on
+     * top of the factory an Executor would otherwise use, for example to keep the workers
+     * of a pool on the processors of one NUMA node:
+     *
+     *    ThreadFactory* factory = new AffinityThreadFactory(
+     *        Executors::getDefaultThreadFactory(), System::getNumaNodeProcessors(0));
+     *
+     * @since 1.0
+     */
+    class DECAF_API AffinityThreadFactory : public ThreadFactory {
+    private:
+
+        ThreadFactory* delegate;
+        std::vector<int> affinity;
+
+    private:
+
+        AffinityThreadFactory(const AffinityThreadFactory&);
+        AffinityThreadFactory& operator= (const AffinityThreadFactory&);
+
+    public:
+
+        /**
+         * Creates a new factory that pins the Threads made by the delegate.
+         *
+         * @param delegate
+         *      The ThreadFactory that creates the Threads, this factory takes ownership of it.
+         * @param affinity
+         *      The zero based indices of the processors the Threads may run on, an empty
+         *      set leaves the Threads unrestricted.
+         *
+         * @throws NullPointerException if the delegate is NULL.
+         * @throws IllegalArgumentException if any of the processor indices is negative.
+         */
+        AffinityThreadFactory(ThreadFactory* delegate, const std::vector<int>& affinity);
+
+        virtual ~AffinityThreadFactory();
+
+        virtual decaf::lang::Thread* newThread(decaf::lang::Runnable* r);
+
+        /**
+         * @return the processors that the Threads created by this factory are restricted to.
+         */
+        std::vector<int> getAffinity() const {
+            return this->affinity;
+        }
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_AFFINITYTHREADFACTORY_H_ */
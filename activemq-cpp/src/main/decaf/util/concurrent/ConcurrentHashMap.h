@@ -20,15 +20,1193 @@
 
 #include <decaf/util/Config.h>
 
+#include <decaf/util/concurrent/ConcurrentMap.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/AbstractCollection.h>
+#include <decaf/util/AbstractSet.h>
+#include <decaf/util/HashCode.h>
+#include <decaf/util/Iterator.h>
+#include <decaf/util/MapEntry.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace decaf {
 namespace util {
 namespace concurrent {
 
-    class ConcurrentHashMap {
+    /**
+     * A hash table with adjustable expected concurrency for retrievals and updates.
+     * The table is divided into segments, each of which is a small hash table guarded
+     * by its own lock, and a key is always handled by the segment selected from the
+     * high bits of its hash.  Retrievals lock the segment too, so they contend only
+     * with operations on the same segment.  Operations on keys that fall in
+     * different segments never contend with each other, so threads doing lookups and
+     * updates on unrelated keys scale with the number of segments instead of queuing on
+     * a single lock as they would with a ConcurrentStlMap.
+     *
+     * Keys are hashed with the HASHCODE functor and compared with the EQUALS functor,
+     * a map keyed by Pointer instances is expected to use a functor that compares the
+     * pointed to values such as decaf::lang::PointerEquals, otherwise two different
+     * instances of the same id would not match.
+     *
+     * Aggregate operations such as size and putAll visit the segments one at a time and
+     * so are not atomic with respect to the whole map.  The iterators of the collection
+     * views are weakly consistent, each one copies the contents of a segment as it
+     * reaches it and never throws ConcurrentModificationException, it reflects the state
+     * of every segment at some point at or since the iterator was created.
+     *
+     * The lock and wait methods of the Synchronizable interface operate on a monitor of
+     * their own, holding it does not block the operations of the map.
+     *
+     * @since 3.9.0
+     */
+    template <typename K, typename V, typename HASHCODE = HashCode<K>, typename EQUALS = std::equal_to<K> >
+    class ConcurrentHashMap : public ConcurrentMap<K, V> {
     public:
 
-        ConcurrentHashMap() {}
-        virtual ~ConcurrentHashMap() {}
+        /**
+         * The default initial capacity of the whole table.
+         */
+        static const int DEFAULT_INITIAL_CAPACITY = 16;
+
+        /**
+         * The default number of concurrently updating threads the table is sized for.
+         */
+        static const int DEFAULT_CONCURRENCY_LEVEL = 16;
+
+    private:
+
+        static const int MAXIMUM_CAPACITY = 1 << 30;
+        static const int MAX_SEGMENTS = 1 << 16;
+
+        class HashEntry {
+        private:
+
+            HashEntry(const HashEntry&);
+            HashEntry& operator= (const HashEntry&);
+
+        public:
+
+            K key;
+            V value;
+            int hash;
+            HashEntry* next;
+
+            HashEntry(const K& key, const V& value, int hash, HashEntry* next) :
+                key(key), value(value), hash(hash), next(next) {
+            }
+        };
+
+        /**
+         * One lock protected portion of the table, every method expects the caller to
+         * be holding the segment's mutex.
+         */
+        class Segment {
+        private:
+
+            Segment(const Segment&);
+            Segment& operator= (const Segment&);
+
+        public:
+
+            mutable Mutex mutex;
+            std::vector<HashEntry*> table;
+            int count;
+            int threshold;
+            float loadFactor;
+
+        public:
+
+            Segment(int capacity, float loadFactor) :
+                mutex(), table(capacity, (HashEntry*) NULL), count(0),
+                threshold((int) ((float) capacity * loadFactor)), loadFactor(loadFactor) {
+            }
+
+            ~Segment() {
+                clear();
+            }
+
+            HashEntry* find(const K& key, int hash) const {
+                HashEntry* entry = table[hash & ((int) table.size() - 1)];
+                while (entry != NULL && (entry->hash != hash || !EQUALS()(key, entry->key))) {
+                    entry = entry->next;
+                }
+                return entry;
+            }
+
+            bool put(const K& key, int hash, const V& value, bool onlyIfAbsent, V* oldValue) {
+                HashEntry* entry = find(key, hash);
+                if (entry != NULL) {
+                    if (oldValue != NULL) {
+                        *oldValue = entry->value;
+                    }
+                    if (!onlyIfAbsent) {
+                        entry->value = value;
+                    }
+                    return true;
+                }
+
+                if (count >= threshold && (int) table.size() < MAXIMUM_CAPACITY) {
+                    rehash();
+                }
+
+                int index = hash & ((int) table.size() - 1);
+                table[index] = new HashEntry(key, value, hash, table[index]);
+                count++;
+                return false;
+            }
+
+            bool remove(const K& key, int hash, const V* expected, V* oldValue) {
+                int index = hash & ((int) table.size() - 1);
+                HashEntry* prev = NULL;
+                HashEntry* entry = table[index];
+                while (entry != NULL && (entry->hash != hash || !EQUALS()(key, entry->key))) {
+                    prev = entry;
+                    entry = entry->next;
+                }
+
+                if (entry == NULL || (expected != NULL && !(entry->value == *expected))) {
+                    return false;
+                }
+
+                if (prev == NULL) {
+                    table[index] = entry->next;
+                } else {
+                    prev->next = entry->next;
+                }
+
+                if (oldValue != NULL) {
+                    *oldValue = entry->value;
+                }
+
+                delete entry;
+                count--;
+                return true;
+            }
+
+            bool containsValue(const V& value) const {
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    for (HashEntry* entry = table[i]; entry != NULL; entry = entry->next) {
+                        if (entry->value == value) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            void snapshot(std::vector< MapEntry<K, V> >& entries) const {
+                entries.clear();
+                entries.reserve(count);
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    for (HashEntry* entry = table[i]; entry != NULL; entry = entry->next) {
+                        entries.push_back(MapEntry<K, V>(entry->key, entry->value));
+                    }
+                }
+            }
+
+            void clear() {
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    HashEntry* entry = table[i];
+                    while (entry != NULL) {
+                        HashEntry* next = entry->next;
+                        delete entry;
+                        entry = next;
+                    }
+                    table[i] = NULL;
+                }
+                count = 0;
+            }
+
+            void rehash() {
+                std::vector<HashEntry*> newTable(table.size() << 1, (HashEntry*) NULL);
+                int mask = (int) newTable.size() - 1;
+
+                for (std::size_t i = 0; i < table.size(); ++i) {
+                    HashEntry* entry = table[i];
+                    while (entry != NULL) {
+                        HashEntry* next = entry->next;
+                        int index = entry->hash & mask;
+                        entry->next = newTable[index];
+                        newTable[index] = entry;
+                        entry = next;
+                    }
+                }
+
+                table.swap(newTable);
+                threshold = (int) ((float) table.size() * loadFactor);
+            }
+        };
+
+    private:
+
+        std::vector<Segment*> segments;
+        int segmentShift;
+        int segmentMask;
+
+        mutable Mutex monitor;
+
+    private:
+
+        /**
+         * Applies a supplemental hash to the user's hash code so that keys whose hash
+         * codes differ only in the low or only in the high bits are still spread over
+         * the segments and the buckets within them.
+         */
+        static int hashOf(const K& key) {
+            unsigned int h = (unsigned int) HASHCODE()(key);
+            h += (h << 15) ^ 0xffffcd7d;
+            h ^= (h >> 10);
+            h += (h << 3);
+            h ^= (h >> 6);
+            h += (h << 2) + (h << 14);
+            return (int) (h ^ (h >> 16));
+        }
+
+        Segment& segmentFor(int hash) const {
+            // With a single segment the shift would be the full width of the hash.
+            if (segmentMask == 0) {
+                return *segments[0];
+            }
+
+            return *segments[((unsigned int) hash >> segmentShift) & segmentMask];
+        }
+
+        void initialize(int initialCapacity, float loadFactor, int concurrencyLevel) {
+
+            if (initialCapacity < 0 || !(loadFactor > 0) || concurrencyLevel <= 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Invalid ConcurrentHashMap construction arguments.");
+            }
+
+            if (concurrencyLevel > MAX_SEGMENTS) {
+                concurrencyLevel = MAX_SEGMENTS;
+            }
+
+            int shift = 0;
+            int count = 1;
+            while (count < concurrencyLevel) {
+                ++shift;
+                count <<= 1;
+            }
+
+            this->segmentShift = 32 - shift;
+            this->segmentMask = count - 1;
+
+            if (initialCapacity > MAXIMUM_CAPACITY) {
+                initialCapacity = MAXIMUM_CAPACITY;
+            }
+
+            int perSegment = initialCapacity / count;
+            if (perSegment * count < initialCapacity) {
+                ++perSegment;
+            }
+
+            int capacity = 1;
+            while (capacity < perSegment) {
+                capacity <<= 1;
+            }
+
+            this->segments.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                this->segments.push_back(new Segment(capacity, loadFactor));
+            }
+        }
+
+    private:
+
+        class AbstractMapIterator {
+        protected:
+
+            const ConcurrentHashMap* associatedMap;
+
+            // The map to remove entries from, NULL for the iterators of the const views.
+            ConcurrentHashMap* mutableMap;
+
+            mutable std::vector< MapEntry<K, V> > entries;
+            mutable std::size_t position;
+            mutable std::size_t nextSegment;
+            bool hasCurrent;
+            K currentKey;
+
+        private:
+
+            AbstractMapIterator(const AbstractMapIterator&);
+            AbstractMapIterator& operator= (const AbstractMapIterator&);
+
+        public:
+
+            AbstractMapIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                associatedMap(parent), mutableMap(mutableParent), entries(), position(0),
+                nextSegment(0), hasCurrent(false), currentKey() {
+            }
+
+            virtual ~AbstractMapIterator() {}
+
+            bool checkHasNext() const {
+                while (position >= entries.size()) {
+                    if (nextSegment >= associatedMap->segments.size()) {
+                        return false;
+                    }
+
+                    const Segment& segment = *associatedMap->segments[nextSegment++];
+                    synchronized(&segment.mutex) {
+                        segment.snapshot(entries);
+                    }
+                    position = 0;
+                }
+
+                return true;
+            }
+
+            const MapEntry<K, V>& makeNext() {
+                if (!checkHasNext()) {
+                    throw NoSuchElementException(__FILE__, __LINE__, "No next element");
+                }
+
+                const MapEntry<K, V>& entry = entries[position++];
+                currentKey = entry.getKey();
+                hasCurrent = true;
+                return entry;
+            }
+
+            void doRemove() {
+                if (mutableMap == NULL) {
+                    throw decaf::lang::exceptions::UnsupportedOperationException(
+                        __FILE__, __LINE__, "Cannot write to a const Iterator.");
+                }
+
+                if (!hasCurrent) {
+                    throw decaf::lang::exceptions::IllegalStateException(
+                        __FILE__, __LINE__, "Remove called before call to next()");
+                }
+
+                hasCurrent = false;
+                mutableMap->remove(currentKey);
+            }
+        };
+
+        class EntryIterator : public Iterator< MapEntry<K, V> >, public AbstractMapIterator {
+        private:
+
+            EntryIterator(const EntryIterator&);
+            EntryIterator& operator= (const EntryIterator&);
+
+        public:
+
+            EntryIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~EntryIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual MapEntry<K, V> next() {
+                return this->makeNext();
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class KeyIterator : public Iterator<K>, public AbstractMapIterator {
+        private:
+
+            KeyIterator(const KeyIterator&);
+            KeyIterator& operator= (const KeyIterator&);
+
+        public:
+
+            KeyIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~KeyIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual K next() {
+                return this->makeNext().getKey();
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+        class ValueIterator : public Iterator<V>, public AbstractMapIterator {
+        private:
+
+            ValueIterator(const ValueIterator&);
+            ValueIterator& operator= (const ValueIterator&);
+
+        public:
+
+            ValueIterator(const ConcurrentHashMap* parent, ConcurrentHashMap* mutableParent) :
+                AbstractMapIterator(parent, mutableParent) {
+            }
+
+            virtual ~ValueIterator() {}
+
+            virtual bool hasNext() const {
+                return this->checkHasNext();
+            }
+
+            virtual V next() {
+                return this->makeNext().getValue();
+            }
+
+            virtual void remove() {
+                this->doRemove();
+            }
+        };
+
+    private:
+
+        // Special Set implementation that is backed by this ConcurrentHashMap
+        class HashMapEntrySet : public AbstractSet< MapEntry<K, V> > {
+        private:
+
+            ConcurrentHashMap* associatedMap;
+
+        private:
+
+            HashMapEntrySet(const HashMapEntrySet&);
+            HashMapEntrySet& operator= (const HashMapEntrySet&);
+
+        public:
+
+            HashMapEntrySet(ConcurrentHashMap* parent) : AbstractSet< MapEntry<K, V> >(), associatedMap(parent) {
+            }
+
+            virtual ~HashMapEntrySet() {}
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                associatedMap->clear();
+            }
+
+            virtual bool remove(const MapEntry<K, V>& entry) {
+                return associatedMap->remove(entry.getKey(), entry.getValue());
+            }
+
+            virtual bool contains(const MapEntry<K, V>& entry) const {
+                return associatedMap->containsEntry(entry.getKey(), entry.getValue());
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() {
+                return new EntryIterator(associatedMap, associatedMap);
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() const {
+                return new EntryIterator(associatedMap, NULL);
+            }
+        };
+
+        // Special Set implementation that is backed by this ConcurrentHashMap
+        class ConstHashMapEntrySet : public AbstractSet< MapEntry<K, V> > {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+
+        private:
+
+            ConstHashMapEntrySet(const ConstHashMapEntrySet&);
+            ConstHashMapEntrySet& operator= (const ConstHashMapEntrySet&);
+
+        public:
+
+            ConstHashMapEntrySet(const ConcurrentHashMap* parent) : AbstractSet< MapEntry<K, V> >(), associatedMap(parent) {
+            }
+
+            virtual ~ConstHashMapEntrySet() {}
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't clear a const collection");
+            }
+
+            virtual bool remove(const MapEntry<K, V>& entry DECAF_UNUSED) {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't remove from const collection");
+            }
+
+            virtual bool contains(const MapEntry<K, V>& entry) const {
+                return associatedMap->containsEntry(entry.getKey(), entry.getValue());
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't return a non-const iterator for a const collection");
+            }
+
+            virtual Iterator< MapEntry<K, V> >* iterator() const {
+                return new EntryIterator(associatedMap, NULL);
+            }
+        };
+
+        // Special Set implementation that is backed by this ConcurrentHashMap
+        class HashMapKeySet : public AbstractSet<K> {
+        private:
+
+            ConcurrentHashMap* associatedMap;
+
+        private:
+
+            HashMapKeySet(const HashMapKeySet&);
+            HashMapKeySet& operator= (const HashMapKeySet&);
+
+        public:
+
+            HashMapKeySet(ConcurrentHashMap* parent) : AbstractSet<K>(), associatedMap(parent) {
+            }
+
+            virtual ~HashMapKeySet() {}
+
+            virtual bool contains(const K& key) const {
+                return associatedMap->containsKey(key);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                associatedMap->clear();
+            }
+
+            virtual bool remove(const K& key) {
+                return associatedMap->removeEntry(key, NULL, NULL);
+            }
+
+            virtual Iterator<K>* iterator() {
+                return new KeyIterator(associatedMap, associatedMap);
+            }
+
+            virtual Iterator<K>* iterator() const {
+                return new KeyIterator(associatedMap, NULL);
+            }
+        };
+
+        // Special Set implementation that is backed by this ConcurrentHashMap
+        class ConstHashMapKeySet : public AbstractSet<K> {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+
+        private:
+
+            ConstHashMapKeySet(const ConstHashMapKeySet&);
+            ConstHashMapKeySet& operator= (const ConstHashMapKeySet&);
+
+        public:
+
+            ConstHashMapKeySet(const ConcurrentHashMap* parent) : AbstractSet<K>(), associatedMap(parent) {
+            }
+
+            virtual ~ConstHashMapKeySet() {}
+
+            virtual bool contains(const K& key) const {
+                return associatedMap->containsKey(key);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't clear a const collection");
+            }
+
+            virtual bool remove(const K& key DECAF_UNUSED) {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't remove from const collection");
+            }
+
+            virtual Iterator<K>* iterator() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't return a non-const iterator for a const collection");
+            }
+
+            virtual Iterator<K>* iterator() const {
+                return new KeyIterator(associatedMap, NULL);
+            }
+        };
+
+        // Special Collection implementation that is backed by this ConcurrentHashMap
+        class HashMapValueCollection : public AbstractCollection<V> {
+        private:
+
+            ConcurrentHashMap* associatedMap;
+
+        private:
+
+            HashMapValueCollection(const HashMapValueCollection&);
+            HashMapValueCollection& operator= (const HashMapValueCollection&);
+
+        public:
+
+            HashMapValueCollection(ConcurrentHashMap* parent) : AbstractCollection<V>(), associatedMap(parent) {
+            }
+
+            virtual ~HashMapValueCollection() {}
+
+            virtual bool contains(const V& value) const {
+                return associatedMap->containsValue(value);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                associatedMap->clear();
+            }
+
+            virtual Iterator<V>* iterator() {
+                return new ValueIterator(associatedMap, associatedMap);
+            }
+
+            virtual Iterator<V>* iterator() const {
+                return new ValueIterator(associatedMap, NULL);
+            }
+        };
+
+        // Special Collection implementation that is backed by this ConcurrentHashMap
+        class ConstHashMapValueCollection : public AbstractCollection<V> {
+        private:
+
+            const ConcurrentHashMap* associatedMap;
+
+        private:
+
+            ConstHashMapValueCollection(const ConstHashMapValueCollection&);
+            ConstHashMapValueCollection& operator= (const ConstHashMapValueCollection&);
+
+        public:
+
+            ConstHashMapValueCollection(const ConcurrentHashMap* parent) : AbstractCollection<V>(), associatedMap(parent) {
+            }
+
+            virtual ~ConstHashMapValueCollection() {}
+
+            virtual bool contains(const V& value) const {
+                return associatedMap->containsValue(value);
+            }
+
+            virtual int size() const {
+                return associatedMap->size();
+            }
+
+            virtual void clear() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't clear a const collection");
+            }
+
+            virtual Iterator<V>* iterator() {
+                throw decaf::lang::exceptions::UnsupportedOperationException(
+                    __FILE__, __LINE__, "Can't return a non-const iterator for a const collection");
+            }
+
+            virtual Iterator<V>* iterator() const {
+                return new ValueIterator(associatedMap, NULL);
+            }
+        };
+
+    private:
+
+        // Cached values that are only initialized once a request for them is made.
+        decaf::lang::Pointer<HashMapEntrySet> cachedEntrySet;
+        decaf::lang::Pointer<HashMapKeySet> cachedKeySet;
+        decaf::lang::Pointer<HashMapValueCollection> cachedValueCollection;
+
+        // Cached values that are only initialized once a request for them is made.
+        mutable decaf::lang::Pointer<ConstHashMapEntrySet> cachedConstEntrySet;
+        mutable decaf::lang::Pointer<ConstHashMapKeySet> cachedConstKeySet;
+        mutable decaf::lang::Pointer<ConstHashMapValueCollection> cachedConstValueCollection;
+
+    private:
+
+        ConcurrentHashMap& operator= (const ConcurrentHashMap&);
+
+    public:
+
+        /**
+         * Creates a new empty map with the default capacity, load factor of 0.75 and
+         * concurrency level.
+         */
+        ConcurrentHashMap() : ConcurrentMap<K, V>(), segments(), segmentShift(0), segmentMask(0), monitor(),
+                              cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+                              cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            initialize(DEFAULT_INITIAL_CAPACITY, 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+        }
+
+        /**
+         * Creates a new empty map.
+         *
+         * @param initialCapacity
+         *      The number of elements the whole table can hold before it needs to grow.
+         * @param loadFactor
+         *      The fill ratio at which a segment's table is doubled in size.
+         * @param concurrencyLevel
+         *      The estimated number of threads updating the map at the same time, it is
+         *      rounded up to a power of two to give the number of segments.
+         *
+         * @throws IllegalArgumentException if the initial capacity is negative or the load
+         *         factor or concurrency level is not positive.
+         */
+        ConcurrentHashMap(int initialCapacity, float loadFactor = 0.75f,
+                          int concurrencyLevel = DEFAULT_CONCURRENCY_LEVEL) :
+            ConcurrentMap<K, V>(), segments(), segmentShift(0), segmentMask(0), monitor(),
+            cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+            cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            initialize(initialCapacity, loadFactor, concurrencyLevel);
+        }
+
+        /**
+         * Copy constructor - copies the content of the given map into this one.
+         *
+         * @param source
+         *      The source map.
+         */
+        ConcurrentHashMap(const ConcurrentHashMap& source) :
+            ConcurrentMap<K, V>(), segments(), segmentShift(0), segmentMask(0), monitor(),
+            cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+            cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            initialize(source.size() * 2, 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+            putAll(source);
+        }
+
+        /**
+         * Copy constructor - copies the content of the given map into this one.
+         *
+         * @param source
+         *      The source map.
+         */
+        ConcurrentHashMap(const Map<K, V>& source) :
+            ConcurrentMap<K, V>(), segments(), segmentShift(0), segmentMask(0), monitor(),
+            cachedEntrySet(), cachedKeySet(), cachedValueCollection(),
+            cachedConstEntrySet(), cachedConstKeySet(), cachedConstValueCollection() {
+            initialize(source.size() * 2, 0.75f, DEFAULT_CONCURRENCY_LEVEL);
+            putAll(source);
+        }
+
+        virtual ~ConcurrentHashMap() {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                delete segments[i];
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool equals(const Map<K, V>& source) const {
+            if (this == &source) {
+                return true;
+            }
+
+            if (this->size() != source.size()) {
+                return false;
+            }
+
+            std::auto_ptr< Iterator< MapEntry<K, V> > > iterator(this->entrySet().iterator());
+            while (iterator->hasNext()) {
+                MapEntry<K, V> entry = iterator->next();
+                if (!source.containsKey(entry.getKey()) ||
+                    !(entry.getValue() == source.get(entry.getKey()))) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void copy(const Map<K, V>& source) {
+            if (this != &source) {
+                this->clear();
+                this->putAll(source);
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void clear() {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    segments[i]->clear();
+                }
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool containsKey(const K& key) const {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return segment.find(key, hash) != NULL;
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool containsValue(const V& value) const {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    if (segments[i]->containsValue(value)) {
+                        return true;
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool isEmpty() const {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    if (segments[i]->count != 0) {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual int size() const {
+            int result = 0;
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    result += segments[i]->count;
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * {@inheritDoc}
+         *
+         * The returned reference remains valid until the mapping is removed.
+         */
+        virtual V& get(const K& key) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                if (entry != NULL) {
+                    return entry->value;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Key does not exist in map");
+        }
+
+        /**
+         * {@inheritDoc}
+         *
+         * The returned reference remains valid until the mapping is removed.
+         */
+        virtual const V& get(const K& key) const {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                if (entry != NULL) {
+                    return entry->value;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Key does not exist in map");
+        }
+
+        /**
+         * Copies the value mapped to the given key into the supplied value, unlike get
+         * this neither throws nor hands out a reference into the table when the key is
+         * not present, which makes it the cheaper lookup for keys that may be absent.
+         *
+         * @param key
+         *      The key to look up.
+         * @param value
+         *      Assigned the mapped value if the key is present, left unchanged otherwise.
+         *
+         * @return true if the key was present in the map.
+         */
+        bool tryGet(const K& key, V& value) const {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                if (entry != NULL) {
+                    value = entry->value;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool put(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return segment.put(key, hash, value, false, NULL);
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool put(const K& key, const V& value, V& oldValue) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return segment.put(key, hash, value, false, &oldValue);
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual void putAll(const Map<K, V>& other) {
+            if (this == &other) {
+                return;
+            }
+
+            std::auto_ptr< Iterator< MapEntry<K, V> > > iterator(other.entrySet().iterator());
+            while (iterator->hasNext()) {
+                MapEntry<K, V> entry = iterator->next();
+                this->put(entry.getKey(), entry.getValue());
+            }
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual V remove(const K& key) {
+            V result = V();
+            removeEntry(key, NULL, &result);
+            return result;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool putIfAbsent(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return !segment.put(key, hash, value, true, NULL);
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool remove(const K& key, const V& value) {
+            return removeEntry(key, &value, NULL);
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual bool replace(const K& key, const V& oldValue, const V& newValue) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                if (entry != NULL && entry->value == oldValue) {
+                    entry->value = newValue;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * {@inheritDoc}
+         */
+        virtual V replace(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                if (entry != NULL) {
+                    V result = entry->value;
+                    entry->value = value;
+                    return result;
+                }
+            }
+
+            throw NoSuchElementException(
+                __FILE__, __LINE__, "Value to Replace was not in the Map.");
+        }
+
+        virtual Set< MapEntry<K, V> >& entrySet() {
+            synchronized(&monitor) {
+                if (this->cachedEntrySet == NULL) {
+                    this->cachedEntrySet.reset(new HashMapEntrySet(this));
+                }
+            }
+            return *(this->cachedEntrySet);
+        }
+
+        virtual const Set< MapEntry<K, V> >& entrySet() const {
+            synchronized(&monitor) {
+                if (this->cachedConstEntrySet == NULL) {
+                    this->cachedConstEntrySet.reset(new ConstHashMapEntrySet(this));
+                }
+            }
+            return *(this->cachedConstEntrySet);
+        }
+
+        virtual Set<K>& keySet() {
+            synchronized(&monitor) {
+                if (this->cachedKeySet == NULL) {
+                    this->cachedKeySet.reset(new HashMapKeySet(this));
+                }
+            }
+            return *(this->cachedKeySet);
+        }
+
+        virtual const Set<K>& keySet() const {
+            synchronized(&monitor) {
+                if (this->cachedConstKeySet == NULL) {
+                    this->cachedConstKeySet.reset(new ConstHashMapKeySet(this));
+                }
+            }
+            return *(this->cachedConstKeySet);
+        }
+
+        virtual Collection<V>& values() {
+            synchronized(&monitor) {
+                if (this->cachedValueCollection == NULL) {
+                    this->cachedValueCollection.reset(new HashMapValueCollection(this));
+                }
+            }
+            return *(this->cachedValueCollection);
+        }
+
+        virtual const Collection<V>& values() const {
+            synchronized(&monitor) {
+                if (this->cachedConstValueCollection == NULL) {
+                    this->cachedConstValueCollection.reset(new ConstHashMapValueCollection(this));
+                }
+            }
+            return *(this->cachedConstValueCollection);
+        }
+
+        /**
+         * @return the number of independently locked segments the table is divided into.
+         */
+        int getSegmentCount() const {
+            return (int) segments.size();
+        }
+
+    private:
+
+        bool removeEntry(const K& key, const V* expected, V* oldValue) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                return segment.remove(key, hash, expected, oldValue);
+            }
+
+            return false;
+        }
+
+        bool containsEntry(const K& key, const V& value) const {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            synchronized(&segment.mutex) {
+                HashEntry* entry = segment.find(key, hash);
+                return entry != NULL && entry->value == value;
+            }
+
+            return false;
+        }
+
+    public:
+
+        virtual void lock() {
+            monitor.lock();
+        }
+
+        virtual bool tryLock() {
+            return monitor.tryLock();
+        }
+
+        virtual void unlock() {
+            monitor.unlock();
+        }
+
+        virtual void wait() {
+            monitor.wait();
+        }
+
+        virtual void wait(long long millisecs) {
+            monitor.wait(millisecs);
+        }
+
+        virtual void wait(long long millisecs, int nanos) {
+            monitor.wait(millisecs, nanos);
+        }
+
+        virtual void notify() {
+            monitor.notify();
+        }
+
+        virtual void notifyAll() {
+            monitor.notifyAll();
+        }
 
     };
 
@@ -0,0 +1,566 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHE_H_
+#define _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHE_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/HashCode.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <functional>
+#include <vector>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    /**
+     * A bounded cache that can be shared between threads without any outside locking,
+     * evicting entries in approximately least recently used order.
+     *
+     * The cache is divided into segments like a ConcurrentHashMap, each holding a fixed
+     * share of the maximum size in a slot array guarded by its own lock.  Eviction uses
+     * the CLOCK algorithm instead of a linked list: a hit only sets the entry's reference
+     * bit, and a full segment sweeps its slots from where the last sweep stopped, giving
+     * referenced entries a second chance and evicting the first one that isn't.  A get
+     * therefore never relinks, allocates or frees anything, its critical section is a
+     * probe of a small open addressed index, and threads using keys that fall in
+     * different segments don't contend at all.
+     *
+     * Eviction is per segment, so the entry dropped is the least recently used of its
+     * segment rather than of the whole cache.  Keys are hashed with the HASHCODE functor
+     * and compared with the EQUALS functor, both K and V must be default constructible
+     * and assignable.
+     *
+     * @since 3.9.0
+     */
+    template <typename K, typename V, typename HASHCODE = HashCode<K>, typename EQUALS = std::equal_to<K> >
+    class ConcurrentLRUCache {
+    public:
+
+        /**
+         * The default number of concurrently updating threads the cache is sized for.
+         */
+        static const int DEFAULT_CONCURRENCY_LEVEL = 16;
+
+    private:
+
+        static const int MAX_SEGMENTS = 1 << 16;
+
+        class Slot {
+        public:
+
+            K key;
+            V value;
+            int hash;
+            bool used;
+            bool referenced;
+
+            Slot() : key(), value(), hash(0), used(false), referenced(false) {}
+        };
+
+        /**
+         * One lock protected portion of the cache, every method expects the caller to
+         * be holding the segment's mutex.
+         */
+        class Segment {
+        private:
+
+            Segment(const Segment&);
+            Segment& operator= (const Segment&);
+
+        public:
+
+            mutable Mutex mutex;
+
+            std::vector<Slot> slots;
+
+            // Open addressed index from the hash of a key to its slot, -1 when empty.
+            std::vector<int> table;
+            int tableMask;
+
+            std::vector<int> freeSlots;
+            int hand;
+            int count;
+
+        public:
+
+            Segment(int capacity) : mutex(), slots(), table(), tableMask(0), freeSlots(), hand(0), count(0) {
+                allocate(capacity);
+            }
+
+            void allocate(int capacity) {
+
+                slots.assign(capacity, Slot());
+
+                int size = 4;
+                while (size < capacity * 2) {
+                    size <<= 1;
+                }
+                table.assign(size, -1);
+                tableMask = size - 1;
+
+                freeSlots.clear();
+                for (int i = capacity - 1; i >= 0; --i) {
+                    freeSlots.push_back(i);
+                }
+
+                hand = 0;
+                count = 0;
+            }
+
+            int find(const K& key, int hash) const {
+                int index = hash & tableMask;
+                while (table[index] != -1) {
+                    const Slot& slot = slots[table[index]];
+                    if (slot.hash == hash && EQUALS()(key, slot.key)) {
+                        return table[index];
+                    }
+                    index = (index + 1) & tableMask;
+                }
+                return -1;
+            }
+
+            bool get(const K& key, int hash, V& value) {
+                int index = find(key, hash);
+                if (index < 0) {
+                    return false;
+                }
+
+                Slot& slot = slots[index];
+                slot.referenced = true;
+                value = slot.value;
+                return true;
+            }
+
+            bool put(const K& key, int hash, const V& value, bool onlyIfAbsent, V* current) {
+
+                int index = find(key, hash);
+                if (index >= 0) {
+                    Slot& slot = slots[index];
+                    slot.referenced = true;
+                    if (!onlyIfAbsent) {
+                        slot.value = value;
+                    }
+                    if (current != NULL) {
+                        *current = slot.value;
+                    }
+                    return true;
+                }
+
+                if (slots.empty()) {
+                    if (current != NULL) {
+                        *current = value;
+                    }
+                    return false;
+                }
+
+                index = take();
+                Slot& slot = slots[index];
+                slot.key = key;
+                slot.value = value;
+                slot.hash = hash;
+                slot.used = true;
+                // New entries get no second chance, one that is never hit again goes
+                // on the next sweep.
+                slot.referenced = false;
+                insertIndex(index);
+                count++;
+
+                if (current != NULL) {
+                    *current = value;
+                }
+                return false;
+            }
+
+            bool remove(const K& key, int hash) {
+                int index = find(key, hash);
+                if (index < 0) {
+                    return false;
+                }
+
+                release(index);
+                return true;
+            }
+
+            void values(std::vector<V>& result) const {
+                for (std::size_t i = 0; i < slots.size(); ++i) {
+                    if (slots[i].used) {
+                        result.push_back(slots[i].value);
+                    }
+                }
+            }
+
+            void clear() {
+                allocate((int) slots.size());
+            }
+
+            /**
+             * Changes the number of slots, keeping the referenced entries first and then
+             * the others in the order the clock hand would reach them.
+             */
+            void resize(int capacity) {
+
+                std::vector<Slot> old;
+                old.swap(slots);
+                int oldHand = hand;
+
+                allocate(capacity);
+
+                for (int pass = 0; pass < 2; ++pass) {
+                    for (std::size_t i = 0; i < old.size(); ++i) {
+                        Slot& slot = old[(oldHand + i) % old.size()];
+                        if (slot.used && slot.referenced == (pass == 0) && !freeSlots.empty()) {
+                            int index = take();
+                            slots[index] = slot;
+                            insertIndex(index);
+                            count++;
+                        }
+                    }
+                }
+            }
+
+        private:
+
+            /**
+             * @return a free slot, evicting the entry the clock hand settles on when full.
+             */
+            int take() {
+
+                if (!freeSlots.empty()) {
+                    int index = freeSlots.back();
+                    freeSlots.pop_back();
+                    return index;
+                }
+
+                int size = (int) slots.size();
+                while (slots[hand].referenced) {
+                    slots[hand].referenced = false;
+                    hand = (hand + 1) % size;
+                }
+
+                int victim = hand;
+                hand = (hand + 1) % size;
+
+                release(victim);
+                freeSlots.pop_back();
+                return victim;
+            }
+
+            void release(int index) {
+                removeIndex(index);
+                slots[index] = Slot();
+                freeSlots.push_back(index);
+                count--;
+            }
+
+            void insertIndex(int slot) {
+                int index = slots[slot].hash & tableMask;
+                while (table[index] != -1) {
+                    index = (index + 1) & tableMask;
+                }
+                table[index] = slot;
+            }
+
+            void removeIndex(int slot) {
+
+                int index = slots[slot].hash & tableMask;
+                while (table[index] != slot) {
+                    index = (index + 1) & tableMask;
+                }
+                table[index] = -1;
+
+                // Shift back any entry whose probe sequence ran through the freed position.
+                int next = index;
+                while (true) {
+                    next = (next + 1) & tableMask;
+                    if (table[next] == -1) {
+                        break;
+                    }
+
+                    int home = slots[table[next]].hash & tableMask;
+                    bool stays = index <= next ? (index < home && home <= next) : (index < home || home <= next);
+                    if (!stays) {
+                        table[index] = table[next];
+                        table[next] = -1;
+                        index = next;
+                    }
+                }
+            }
+        };
+
+    private:
+
+        std::vector<Segment*> segments;
+        int segmentShift;
+        int segmentMask;
+        int maxCacheSize;
+
+    private:
+
+        ConcurrentLRUCache(const ConcurrentLRUCache&);
+        ConcurrentLRUCache& operator= (const ConcurrentLRUCache&);
+
+    public:
+
+        /**
+         * Creates an empty cache.
+         *
+         * @param maximumCacheSize
+         *      The maximum number of entries held before eviction begins.
+         * @param concurrencyLevel
+         *      The expected number of concurrently updating threads, the number of
+         *      segments is the next power of two but never more than the cache size.
+         *
+         * @throws IllegalArgumentException if either value is not positive.
+         */
+        ConcurrentLRUCache(int maximumCacheSize, int concurrencyLevel = DEFAULT_CONCURRENCY_LEVEL) :
+            segments(), segmentShift(0), segmentMask(0), maxCacheSize(maximumCacheSize) {
+
+            if (maximumCacheSize <= 0 || concurrencyLevel <= 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Cache size and concurrency level must be greater than zero.");
+            }
+
+            if (concurrencyLevel > MAX_SEGMENTS) {
+                concurrencyLevel = MAX_SEGMENTS;
+            }
+
+            int shift = 0;
+            int count = 1;
+            while (count < concurrencyLevel && count * 2 <= maximumCacheSize) {
+                ++shift;
+                count <<= 1;
+            }
+
+            this->segmentShift = 32 - shift;
+            this->segmentMask = count - 1;
+
+            this->segments.reserve(count);
+            for (int i = 0; i < count; ++i) {
+                this->segments.push_back(new Segment(shareOf(i)));
+            }
+        }
+
+        virtual ~ConcurrentLRUCache() {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                delete segments[i];
+            }
+        }
+
+        /**
+         * Looks up the key and marks its entry as recently used.
+         *
+         * @param key
+         *      The key to look up.
+         * @param value
+         *      Set to the cached value when the key is found, untouched otherwise.
+         *
+         * @return true if the key was found.
+         */
+        bool get(const K& key, V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            bool result = false;
+            synchronized(&segment.mutex) {
+                result = segment.get(key, hash, value);
+            }
+            return result;
+        }
+
+        /**
+         * @return true if the key is cached, without marking its entry as used.
+         */
+        bool containsKey(const K& key) const {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            bool result = false;
+            synchronized(&segment.mutex) {
+                result = segment.find(key, hash) >= 0;
+            }
+            return result;
+        }
+
+        /**
+         * Maps the key to the value, evicting an entry from the key's segment if it is
+         * full and the key is new.
+         *
+         * @return true if the key was already cached and its value was replaced.
+         */
+        bool put(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            bool result = false;
+            synchronized(&segment.mutex) {
+                result = segment.put(key, hash, value, false, NULL);
+            }
+            return result;
+        }
+
+        /**
+         * Maps the key to the value unless it is already cached.
+         *
+         * @return the value the key maps to when the call returns, the one already
+         *         cached if there was one and otherwise the given value.
+         */
+        V putIfAbsent(const K& key, const V& value) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            V current;
+            synchronized(&segment.mutex) {
+                segment.put(key, hash, value, true, &current);
+            }
+            return current;
+        }
+
+        /**
+         * @return true if the key was cached and has been removed.
+         */
+        bool remove(const K& key) {
+            int hash = hashOf(key);
+            Segment& segment = segmentFor(hash);
+            bool result = false;
+            synchronized(&segment.mutex) {
+                result = segment.remove(key, hash);
+            }
+            return result;
+        }
+
+        /**
+         * Removes all the entries, one segment at a time.
+         */
+        void clear() {
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    segments[i]->clear();
+                }
+            }
+        }
+
+        /**
+         * @return the number of entries, the segments are counted one at a time.
+         */
+        int size() const {
+            int result = 0;
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    result += segments[i]->count;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @return true if the cache holds no entries.
+         */
+        bool isEmpty() const {
+            return size() == 0;
+        }
+
+        /**
+         * @return a copy of the cached values, each segment as it was when reached.
+         */
+        std::vector<V> values() const {
+            std::vector<V> result;
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    segments[i]->values(result);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @return the maximum number of entries held.
+         */
+        int getMaxCacheSize() const {
+            return this->maxCacheSize;
+        }
+
+        /**
+         * Changes the maximum number of entries, evicting the least recently used ones
+         * of any segment that no longer has room for all of its entries.  The number of
+         * segments stays as it was created, a size smaller than that leaves some of them
+         * unable to hold anything.
+         *
+         * @param size
+         *      The new maximum cache size.
+         *
+         * @throws IllegalArgumentException if size is less than or equal to zero.
+         */
+        void setMaxCacheSize(int size) {
+
+            if (size <= 0) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Cache size must be greater than zero.");
+            }
+
+            this->maxCacheSize = size;
+            for (std::size_t i = 0; i < segments.size(); ++i) {
+                synchronized(&segments[i]->mutex) {
+                    segments[i]->resize(shareOf((int) i));
+                }
+            }
+        }
+
+        /**
+         * @return the number of independently locked segments the cache is divided into.
+         */
+        int getSegmentCount() const {
+            return (int) segments.size();
+        }
+
+    private:
+
+        /**
+         * Applies a supplemental hash to the user's hash code, the same one the
+         * ConcurrentHashMap uses, so that the high bits can pick the segment.
+         */
+        static int hashOf(const K& key) {
+            unsigned int h = (unsigned int) HASHCODE()(key);
+            h += (h << 15) ^ 0xffffcd7d;
+            h ^= (h >> 10);
+            h += (h << 3);
+            h ^= (h >> 6);
+            h += (h << 2) + (h << 14);
+            return (int) (h ^ (h >> 16));
+        }
+
+        Segment& segmentFor(int hash) const {
+            if (segmentMask == 0) {
+                return *segments[0];
+            }
+            return *segments[((unsigned int) hash >> segmentShift) & segmentMask];
+        }
+
+        /**
+         * @return the number of slots of the segment, the maximum size split as evenly
+         *         as possible so that the total is exact.
+         */
+        int shareOf(int segment) const {
+            int count = segmentMask + 1;
+            return maxCacheSize / count + (segment < maxCacheSize % count ? 1 : 0);
+        }
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHE_H_ */
@@ -127,6 +127,12 @@ bool CountDownLatch::await( long long timeout, const TimeUnit& unit ) {
 ////////////////////////////////////////////////////////////////////////////////
 void CountDownLatch::countDown() {
     try {
+        // Counting down an open latch changes nothing, skip the release and its look
+        // at the wait queue.
+        if (this->sync->getCount() == 0) {
+            return;
+        }
+
         this->sync->releaseShared(1);
     }
     DECAF_CATCHALL_NOTHROW()
@@ -23,6 +23,7 @@
 #include <decaf/lang/exceptions/NullPointerException.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
 #include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/WorkStealingExecutor.h>
 #include <decaf/util/concurrent/ThreadFactory.h>
 #include <decaf/util/concurrent/TimeUnit.h>
 #include <decaf/util/concurrent/LinkedBlockingQueue.h>
@@ -48,6 +49,7 @@ namespace {
         //ThreadGroup group;
         AtomicInteger threadNumber;
         std::string namePrefix;
+        long long stackSize;
 
     private:
 
@@ -56,7 +58,7 @@ namespace {
 
     public:
 
-        DefaultThreadFactory() : ThreadFactory(), threadNumber(1), namePrefix() {
+        DefaultThreadFactory(long long stackSize) : ThreadFactory(), threadNumber(1), namePrefix(), stackSize(stackSize) {
 
             if(DefaultThreadFactory::poolNumber == NULL) {
                 throw NullPointerException();
@@ -68,7 +70,7 @@ namespace {
         }
 
         Thread* newThread(Runnable* task) {
-            Thread* thread = new Thread(task, namePrefix + Integer::toString(threadNumber.getAndIncrement()));
+            Thread* thread = new Thread(task, namePrefix + Integer::toString(threadNumber.getAndIncrement()), stackSize);
 
             if (thread->getPriority() != Thread::NORM_PRIORITY) {
                 thread->setPriority(Thread::NORM_PRIORITY);
@@ -153,7 +155,17 @@ void Executors::shutdown() {
 
 ////////////////////////////////////////////////////////////////////////////////
 ThreadFactory* Executors::getDefaultThreadFactory() {
-    return new DefaultThreadFactory();
+    return new DefaultThreadFactory(-1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ThreadFactory* Executors::getDefaultThreadFactory(long long stackSize) {
+
+    if (stackSize <= 0 && stackSize != -1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Stack size must be positive or -1.");
+    }
+
+    return new DefaultThreadFactory(stackSize);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -276,6 +288,35 @@ ExecutorService* Executors::newSingleThreadExecutor(ThreadFactory* threadFactory
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+ExecutorService* Executors::newWorkStealingPool() {
+
+    try{
+        return new WorkStealingExecutor();
+    } catch(Exception& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        throw ex;
+    } catch(...) {
+        throw Exception();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ExecutorService* Executors::newWorkStealingPool(int parallelism) {
+
+    try{
+        return new WorkStealingExecutor(parallelism);
+    } catch(IllegalArgumentException& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        throw ex;
+    } catch(Exception& ex) {
+        ex.setMark(__FILE__, __LINE__);
+        throw ex;
+    } catch(...) {
+        throw Exception();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ExecutorService* Executors::unconfigurableExecutorService(ExecutorService* executor) {
 
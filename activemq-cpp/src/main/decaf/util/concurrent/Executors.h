@@ -102,6 +102,22 @@ namespace concurrent {
          */
         static ThreadFactory* getDefaultThreadFactory();
 
+        /**
+         * Creates and returns a new ThreadFactory that behaves like the one returned from
+         * getDefaultThreadFactory() but gives every thread it creates the given stack size,
+         * which lets the threads of one Executor use smaller or larger stacks than the
+         * process wide Thread::getDefaultStackSize.
+         *
+         * @param stackSize
+         *      The stack size in bytes of each new thread, or -1 for the default stack size.
+         *
+         * @return a new instance of the default thread factory used in Executors, the
+         *          caller takes ownership of the returned pointer.
+         *
+         * @throws IllegalArgumentException if the stack size is neither positive nor -1.
+         */
+        static ThreadFactory* getDefaultThreadFactory(long long stackSize);
+
         /**
          * Creates a new ThreadPoolExecutor with a fixed number of threads to process incoming
          * tasks.  The thread pool will use an unbounded queue to store pending tasks.  At any
@@ -172,6 +188,31 @@ namespace concurrent {
          */
         static ExecutorService* newSingleThreadExecutor(ThreadFactory* threadFactory);
 
+        /**
+         * Creates a work stealing thread pool with one worker thread per available processor.
+         * Each worker keeps its own queue of tasks and idle workers take work from the queues
+         * of the busy ones, so the workers don't all contend on a single queue.  No ordering
+         * of the submitted tasks is guaranteed.
+         *
+         * @return a new ExecutorService pointer that is owned by the caller.
+         */
+        static ExecutorService* newWorkStealingPool();
+
+        /**
+         * Creates a work stealing thread pool with the given number of worker threads.  Each
+         * worker keeps its own queue of tasks and idle workers take work from the queues of
+         * the busy ones, so the workers don't all contend on a single queue.  No ordering of
+         * the submitted tasks is guaranteed.
+         *
+         * @param parallelism
+         *      The number of worker threads in the pool.
+         *
+         * @return a new ExecutorService pointer that is owned by the caller.
+         *
+         * @throws IllegalArgumentException if parallelism is less than or equal to zero.
+         */
+        static ExecutorService* newWorkStealingPool(int parallelism);
+
         /**
          * Returns a new ExecutorService derived instance that wraps and takes ownership of the given
          * ExecutorService pointer.  The returned ExecutorService delegates all calls to the wrapped
@@ -0,0 +1,464 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUE_H_
+#define _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUE_H_
+
+#include <decaf/util/Config.h>
+
+#include <decaf/util/concurrent/BlockingQueue.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/util/Iterator.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    /**
+     * A bounded BlockingQueue that any number of threads can offer to and poll from
+     * without taking a lock.  The elements are held in a ring of cells, each with a
+     * sequence counter that tells producers and consumers whether the cell is free or
+     * filled for the current lap of the ring, so an offer or poll costs a single
+     * compare and set on the shared tail or head position and no memory is allocated
+     * once the queue has been created.
+     *
+     * The blocking operations first retry for a short while and then park on a monitor
+     * that is only signaled when some thread is actually waiting, so producers and
+     * consumers that never block never touch a lock.
+     *
+     * The capacity is rounded up to the next power of two.  Elements are copied into
+     * and out of the ring by assignment, which must not throw, so the queue is best
+     * suited to pointers and other small values.  An element's cell is reset to a
+     * default constructed value once it has been taken so that the ring does not keep
+     * Pointer instances alive.
+     *
+     * Because a cell can be refilled by a producer at any time, inspecting elements
+     * without taking them is not supported: peek, iterator and the operations built on
+     * it, such as contains, remove of a given value and toArray, throw an
+     * UnsupportedOperationException.  The size is exact only while the queue is not
+     * being modified.
+     *
+     * @since 3.9.0
+     */
+    template<typename E>
+    class MPMCArrayBlockingQueue : public BlockingQueue<E> {
+    private:
+
+        struct Cell {
+            volatile int sequence;
+            E value;
+
+            Cell() : sequence(0), value() {}
+        };
+
+        // Number of times the blocking operations retry before parking.
+        static const int SPIN_TRIES = 32;
+
+        // Padding that keeps the head and tail positions on separate cache lines.
+        static const int CACHE_LINE = 64;
+
+    private:
+
+        Cell* buffer;
+        int mask;
+
+        char pad0[CACHE_LINE];
+        volatile int enqueuePos;
+        char pad1[CACHE_LINE];
+        volatile int dequeuePos;
+        char pad2[CACHE_LINE];
+
+        // Number of threads parked, or about to park, waiting for an element or a free cell.
+        volatile int takers;
+        volatile int putters;
+
+        mutable Mutex notEmpty;
+        mutable Mutex notFull;
+
+    private:
+
+        MPMCArrayBlockingQueue(const MPMCArrayBlockingQueue&);
+        MPMCArrayBlockingQueue& operator= (const MPMCArrayBlockingQueue&);
+
+    public:
+
+        /**
+         * Create a new instance with room for at least the given number of elements.
+         *
+         * @param capacity
+         *      The minimum capacity, it is rounded up to the next power of two.
+         *
+         * @throws IllegalArgumentException if the capacity is not greater than zero or
+         *         is larger than 2^30.
+         */
+        MPMCArrayBlockingQueue(int capacity) : BlockingQueue<E>(), buffer(NULL), mask(0), pad0(),
+                                               enqueuePos(0), pad1(), dequeuePos(0), pad2(),
+                                               takers(0), putters(0), notEmpty(), notFull() {
+
+            if (capacity <= 0 || capacity > (1 << 30)) {
+                throw decaf::lang::exceptions::IllegalArgumentException(
+                    __FILE__, __LINE__, "Capacity value must be greater than zero and at most 2^30.");
+            }
+
+            // A ring of one cell cannot tell a filled cell from the next lap's free one.
+            int size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+
+            this->mask = size - 1;
+            this->buffer = new Cell[size];
+            for (int i = 0; i < size; ++i) {
+                this->buffer[i].sequence = i;
+            }
+        }
+
+        virtual ~MPMCArrayBlockingQueue() {
+            delete [] this->buffer;
+        }
+
+        /**
+         * @return the number of elements the queue can hold.
+         */
+        int getCapacity() const {
+            return this->mask + 1;
+        }
+
+    public:
+
+        virtual int size() const {
+            int size = (int) ((unsigned int) this->enqueuePos - (unsigned int) this->dequeuePos);
+            if (size < 0) {
+                return 0;
+            }
+            return size > this->mask + 1 ? this->mask + 1 : size;
+        }
+
+        virtual bool isEmpty() const {
+            return this->size() == 0;
+        }
+
+        virtual void clear() {
+            E value;
+            while (this->poll(value)) {
+            }
+        }
+
+        virtual int remainingCapacity() const {
+            return this->mask + 1 - this->size();
+        }
+
+        virtual bool offer(const E& value) {
+            if (!tryOffer(value)) {
+                return false;
+            }
+
+            signalNotEmpty();
+            return true;
+        }
+
+        virtual bool poll(E& result) {
+            if (!tryPoll(result)) {
+                return false;
+            }
+
+            signalNotFull();
+            return true;
+        }
+
+        virtual void put(const E& value) {
+
+            for (int i = 0; i < SPIN_TRIES; ++i) {
+                if (this->offer(value)) {
+                    return;
+                }
+                decaf::lang::Thread::yield();
+            }
+
+            synchronized(&this->notFull) {
+                decaf::internal::util::concurrent::Atomics::incrementAndGet(&this->putters);
+                try {
+                    while (!tryOffer(value)) {
+                        this->notFull.wait();
+                    }
+                } catch (decaf::lang::Exception& ex) {
+                    decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->putters);
+                    // Pass on a signal this thread may have consumed.
+                    this->notFull.notify();
+                    throw;
+                }
+                decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->putters);
+            }
+
+            signalNotEmpty();
+        }
+
+        virtual bool offer(const E& value, long long timeout, const TimeUnit& unit) {
+
+            long long deadline = decaf::lang::System::nanoTime() + unit.toNanos(timeout);
+
+            for (int i = 0; i < SPIN_TRIES; ++i) {
+                if (this->offer(value)) {
+                    return true;
+                }
+                if (decaf::lang::System::nanoTime() >= deadline) {
+                    return false;
+                }
+                decaf::lang::Thread::yield();
+            }
+
+            bool result = false;
+
+            synchronized(&this->notFull) {
+                decaf::internal::util::concurrent::Atomics::incrementAndGet(&this->putters);
+                try {
+                    result = awaitCell(this->notFull, deadline, &value, NULL);
+                } catch (decaf::lang::Exception& ex) {
+                    decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->putters);
+                    // Pass on a signal this thread may have consumed.
+                    this->notFull.notify();
+                    throw;
+                }
+                decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->putters);
+            }
+
+            if (result) {
+                signalNotEmpty();
+            }
+
+            return result;
+        }
+
+        virtual E take() {
+
+            E result;
+
+            for (int i = 0; i < SPIN_TRIES; ++i) {
+                if (this->poll(result)) {
+                    return result;
+                }
+                decaf::lang::Thread::yield();
+            }
+
+            synchronized(&this->notEmpty) {
+                decaf::internal::util::concurrent::Atomics::incrementAndGet(&this->takers);
+                try {
+                    while (!tryPoll(result)) {
+                        this->notEmpty.wait();
+                    }
+                } catch (decaf::lang::Exception& ex) {
+                    decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->takers);
+                    // Pass on a signal this thread may have consumed.
+                    this->notEmpty.notify();
+                    throw;
+                }
+                decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->takers);
+            }
+
+            signalNotFull();
+            return result;
+        }
+
+        virtual bool poll(E& result, long long timeout, const TimeUnit& unit) {
+
+            long long deadline = decaf::lang::System::nanoTime() + unit.toNanos(timeout);
+
+            for (int i = 0; i < SPIN_TRIES; ++i) {
+                if (this->poll(result)) {
+                    return true;
+                }
+                if (decaf::lang::System::nanoTime() >= deadline) {
+                    return false;
+                }
+                decaf::lang::Thread::yield();
+            }
+
+            bool taken = false;
+
+            synchronized(&this->notEmpty) {
+                decaf::internal::util::concurrent::Atomics::incrementAndGet(&this->takers);
+                try {
+                    taken = awaitCell(this->notEmpty, deadline, NULL, &result);
+                } catch (decaf::lang::Exception& ex) {
+                    decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->takers);
+                    // Pass on a signal this thread may have consumed.
+                    this->notEmpty.notify();
+                    throw;
+                }
+                decaf::internal::util::concurrent::Atomics::decrementAndGet(&this->takers);
+            }
+
+            if (taken) {
+                signalNotFull();
+            }
+
+            return taken;
+        }
+
+        virtual bool peek(E& result DECAF_UNUSED) const {
+            throw decaf::lang::exceptions::UnsupportedOperationException(
+                __FILE__, __LINE__, "MPMCArrayBlockingQueue does not support peek.");
+        }
+
+        virtual int drainTo(Collection<E>& c) {
+            return this->drainTo(c, decaf::lang::Integer::MAX_VALUE);
+        }
+
+        virtual int drainTo(Collection<E>& sink, int maxElements) {
+
+            if (&sink == this) {
+                throw decaf::lang::exceptions::IllegalArgumentException(__FILE__, __LINE__,
+                    "Cannot drain this Collection to itself.");
+            }
+
+            int result = 0;
+            E value;
+            while (result < maxElements && this->poll(value)) {
+                sink.add(value);
+                result++;
+            }
+
+            return result;
+        }
+
+        virtual std::string toString() const {
+            return std::string("MPMCArrayBlockingQueue [ current size = ") +
+                   decaf::lang::Integer::toString(this->size()) + "]";
+        }
+
+        virtual decaf::util::Iterator<E>* iterator() {
+            throw decaf::lang::exceptions::UnsupportedOperationException(
+                __FILE__, __LINE__, "MPMCArrayBlockingQueue cannot be traversed.");
+        }
+
+        virtual decaf::util::Iterator<E>* iterator() const {
+            throw decaf::lang::exceptions::UnsupportedOperationException(
+                __FILE__, __LINE__, "MPMCArrayBlockingQueue cannot be traversed.");
+        }
+
+    private:
+
+        bool tryOffer(const E& value) {
+
+            Cell* cell = NULL;
+            int pos = this->enqueuePos;
+
+            for (;;) {
+                cell = &this->buffer[pos & this->mask];
+                int sequence = decaf::internal::util::concurrent::Atomics::getAcquire(&cell->sequence);
+                int diff = (int) ((unsigned int) sequence - (unsigned int) pos);
+
+                if (diff == 0) {
+                    if (decaf::internal::util::concurrent::Atomics::compareAndSet32(&this->enqueuePos, pos, pos + 1)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // The cell still holds the element from the previous lap, the queue is full.
+                    return false;
+                }
+
+                pos = this->enqueuePos;
+            }
+
+            cell->value = value;
+
+            // Publishes the element, the full barrier orders the value store before it for the
+            // acquire load of the sequence in tryPoll and the store before the read of the
+            // waiter count in signalNotEmpty.
+            decaf::internal::util::concurrent::Atomics::getAndSet(&cell->sequence, pos + 1);
+            return true;
+        }
+
+        bool tryPoll(E& result) {
+
+            Cell* cell = NULL;
+            int pos = this->dequeuePos;
+
+            for (;;) {
+                cell = &this->buffer[pos & this->mask];
+                int sequence = decaf::internal::util::concurrent::Atomics::getAcquire(&cell->sequence);
+                int diff = (int) ((unsigned int) sequence - (unsigned int) (pos + 1));
+
+                if (diff == 0) {
+                    if (decaf::internal::util::concurrent::Atomics::compareAndSet32(&this->dequeuePos, pos, pos + 1)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    // The cell has not been filled for this lap yet, the queue is empty.
+                    return false;
+                }
+
+                pos = this->dequeuePos;
+            }
+
+            result = cell->value;
+            cell->value = E();
+
+            // Hands the cell to the producers of the next lap, a full barrier for the same
+            // reasons as in tryOffer.
+            decaf::internal::util::concurrent::Atomics::getAndSet(&cell->sequence, pos + this->mask + 1);
+            return true;
+        }
+
+        bool awaitCell(Mutex& monitor, long long deadline, const E* value, E* result) {
+            for (;;) {
+                if (value != NULL ? tryOffer(*value) : tryPoll(*result)) {
+                    return true;
+                }
+
+                long long nanos = deadline - decaf::lang::System::nanoTime();
+                if (nanos <= 0) {
+                    return false;
+                }
+
+                monitor.wait(nanos / 1000000, (int) (nanos % 1000000));
+            }
+
+            return false;
+        }
+
+        // The waiter counts are read after the full barrier that published the change so
+        // a thread that registered before that point is always woken, one that registers
+        // later finds the change when it retries while holding the monitor.
+        void signalNotEmpty() {
+            if (decaf::internal::util::concurrent::Atomics::getAcquire(&this->takers) > 0) {
+                synchronized(&this->notEmpty) {
+                    this->notEmpty.notify();
+                }
+            }
+        }
+
+        void signalNotFull() {
+            if (decaf::internal::util::concurrent::Atomics::getAcquire(&this->putters) > 0) {
+                synchronized(&this->notFull) {
+                    this->notFull.notify();
+                }
+            }
+        }
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUE_H_ */
@@ -18,6 +18,8 @@
 #include <decaf/util/concurrent/Mutex.h>
 
 #include <decaf/internal/util/concurrent/Threading.h>
+#include <decaf/internal/util/concurrent/LockProfiler.h>
+#include <decaf/lang/System.h>
 #include <decaf/lang/Integer.h>
 
 #include <list>
@@ -44,14 +46,14 @@ namespace concurrent {
 
     public:
 
-        MutexProperties() : monitor(NULL), name() {
+        MutexProperties() : monitor(NULL), name(), site(NULL), holder(NULL), depth(0), acquiredAt(0) {
             std::string idStr = Integer::toString(++id);
             this->name.reserve(DEFAULT_NAME_PREFIX.length() + idStr.length());
             this->name.append(DEFAULT_NAME_PREFIX);
             this->name.append(idStr);
         }
 
-        MutexProperties(const std::string& name) : monitor(NULL), name(name) {
+        MutexProperties(const std::string& name) : monitor(NULL), name(name), site(NULL), holder(NULL), depth(0), acquiredAt(0) {
             if (this->name.empty()) {
                 std::string idStr = Integer::toString(++id);
                 this->name.reserve(DEFAULT_NAME_PREFIX.length() + idStr.length());
@@ -63,6 +65,39 @@ namespace concurrent {
         MonitorHandle* monitor;
         std::string name;
 
+        // Profiling state, the depth and start of the hold are only touched by the
+        // thread that holds the monitor.  A hold that began while recording was off
+        // has no start and isn't recorded.
+        LockProfiler::Site* site;
+        ThreadHandle* holder;
+        int depth;
+        long long acquiredAt;
+
+        void entered(bool recording) {
+            if (depth++ == 0) {
+                holder = Threading::getCurrentThreadHandle();
+                acquiredAt = recording ? System::nanoTime() : 0;
+            }
+        }
+
+        void exiting() {
+            // A thread that doesn't hold the monitor fails in exitMonitor, it mustn't
+            // change the count of the one that does.
+            if (holder == Threading::getCurrentThreadHandle() && --depth == 0) {
+                holder = NULL;
+                endHold();
+            }
+        }
+
+        void endHold() {
+            if (acquiredAt != 0) {
+                if (LockProfiler::isEnabled()) {
+                    LockProfiler::recordHold(site, System::nanoTime() - acquiredAt);
+                }
+                acquiredAt = 0;
+            }
+        }
+
         static unsigned int id;
         static std::string DEFAULT_NAME_PREFIX;
 
@@ -103,6 +138,14 @@ std::string Mutex::toString() const {
     return this->properties->name;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Mutex::setProfilingSite(const std::string& site) {
+    this->properties->site = LockProfiler::getSite(site);
+    this->properties->holder = NULL;
+    this->properties->depth = 0;
+    this->properties->acquiredAt = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool Mutex::isLocked() const {
     if (this->properties->monitor != NULL) {
@@ -126,7 +169,24 @@ void Mutex::lock() {
         Threading::unlockThreadsLib();
     }
 
-    Threading::enterMonitor(this->properties->monitor);
+    if (this->properties->site == NULL) {
+        Threading::enterMonitor(this->properties->monitor);
+        return;
+    }
+
+    bool recording = LockProfiler::isEnabled();
+
+    if (!recording) {
+        Threading::enterMonitor(this->properties->monitor);
+    } else if (Threading::tryEnterMonitor(this->properties->monitor)) {
+        LockProfiler::recordAcquire(this->properties->site, 0, false);
+    } else {
+        long long start = System::nanoTime();
+        Threading::enterMonitor(this->properties->monitor);
+        LockProfiler::recordAcquire(this->properties->site, System::nanoTime() - start, true);
+    }
+
+    this->properties->entered(recording);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,7 +203,19 @@ bool Mutex::tryLock() {
         Threading::unlockThreadsLib();
     }
 
-    return Threading::tryEnterMonitor(this->properties->monitor);
+    if (!Threading::tryEnterMonitor(this->properties->monitor)) {
+        return false;
+    }
+
+    if (this->properties->site != NULL) {
+        bool recording = LockProfiler::isEnabled();
+        if (recording) {
+            LockProfiler::recordAcquire(this->properties->site, 0, false);
+        }
+        this->properties->entered(recording);
+    }
+
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -154,6 +226,10 @@ void Mutex::unlock() {
             "Call to unlock without prior call to lock or tryLock");
     }
 
+    if (this->properties->site != NULL) {
+        this->properties->exiting();
+    }
+
     Threading::exitMonitor(this->properties->monitor);
 }
 
@@ -183,7 +259,27 @@ void Mutex::wait( long long millisecs, int nanos ) {
             "Call to wait without prior call to lock or tryLock");
     }
 
-    Threading::waitOnMonitor(this->properties->monitor, millisecs, nanos);
+    if (this->properties->site == NULL || this->properties->holder != Threading::getCurrentThreadHandle()) {
+        Threading::waitOnMonitor(this->properties->monitor, millisecs, nanos);
+        return;
+    }
+
+    // The monitor is let go while waiting, the hold ends here and starts again once
+    // the monitor is taken back.
+    this->properties->endHold();
+
+    try {
+        Threading::waitOnMonitor(this->properties->monitor, millisecs, nanos);
+    } catch (...) {
+        if (LockProfiler::isEnabled()) {
+            this->properties->acquiredAt = System::nanoTime();
+        }
+        throw;
+    }
+
+    if (LockProfiler::isEnabled()) {
+        this->properties->acquiredAt = System::nanoTime();
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +60,16 @@ namespace concurrent {
 
         bool isLocked() const;
 
+        /**
+         * Reports the waits for and holds of this Mutex under the named site of the
+         * LockProfiler, the Mutex objects that share a site are counted together.  The
+         * site is set while no thread holds the Mutex, normally by its owner's constructor.
+         *
+         * @param site
+         *      The name the waits and holds are reported under.
+         */
+        void setProfilingSite(const std::string& site);
+
     public:
 
         virtual void lock();
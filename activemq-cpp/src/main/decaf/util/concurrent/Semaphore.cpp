@@ -119,11 +119,11 @@ namespace concurrent {
     protected:
 
         virtual int tryAcquireShared(int acquires) {
-            Thread* current = Thread::currentThread();
             for(;;) {
                 Thread* first = this->getFirstQueuedThread();
 
-                if (first != NULL && first != current) {
+                // The current thread is only looked up when another may be ahead of it.
+                if (first != NULL && first != Thread::currentThread()) {
                     return -1;
                 }
 
@@ -36,6 +36,7 @@
 #include <decaf/lang/Math.h>
 #include <decaf/lang/exceptions/IllegalArgumentException.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
 
 #include <algorithm>
 #include <iostream>
@@ -423,12 +424,11 @@ namespace concurrent{
                     delete worker;
                 }
 
-                Pointer< Iterator<Runnable*> > tasks(this->workQueue->iterator());
-                while(tasks->hasNext()) {
-                    delete tasks->next();
+                // Drained rather than iterated since not every queue can be traversed.
+                Runnable* task = NULL;
+                while(this->workQueue->poll(task)) {
+                    delete task;
                 }
-
-                this->workQueue->clear();
             }
             DECAF_CATCH_NOTHROW(Exception)
             DECAF_CATCHALL_NOTHROW()
@@ -1013,6 +1013,9 @@ namespace concurrent{
                     }
                 }
 
+            } catch (UnsupportedOperationException& ex) {
+                // The queue can't be traversed, cancelled tasks are skipped when they
+                // are taken instead.
             } catch (ConcurrentModificationException& ex) {
                 // Take slow path if we encounter interference during traversal.
                 // Make copy for traversal and call remove for cancelled entries.
@@ -1032,7 +1035,12 @@ namespace concurrent{
         }
 
         bool remove(Runnable* task) {
-            bool result = this->workQueue->remove(task);
+            bool result = false;
+            try {
+                result = this->workQueue->remove(task);
+            } catch (UnsupportedOperationException& ex) {
+                // Queues that can only be polled don't support removing a given task.
+            }
             this->tryTerminate();
             return result;
         }
@@ -1070,13 +1078,20 @@ namespace concurrent{
             this->workQueue->drainTo(unexecutedTasks);
             if (!this->workQueue->isEmpty()) {
 
-                std::vector<Runnable*> tasks = this->workQueue->toArray();
-                std::vector<Runnable*>::iterator iter = tasks.begin();
+                try {
+                    std::vector<Runnable*> tasks = this->workQueue->toArray();
+                    std::vector<Runnable*>::iterator iter = tasks.begin();
 
-                for (; iter != tasks.end(); ++iter) {
+                    for (; iter != tasks.end(); ++iter) {
 
-                    if (this->workQueue->remove(*iter)) {
-                        unexecutedTasks.add(*iter);
+                        if (this->workQueue->remove(*iter)) {
+                            unexecutedTasks.add(*iter);
+                        }
+                    }
+                } catch (UnsupportedOperationException& ex) {
+                    Runnable* task = NULL;
+                    while (this->workQueue->poll(task)) {
+                        unexecutedTasks.add(task);
                     }
                 }
             }
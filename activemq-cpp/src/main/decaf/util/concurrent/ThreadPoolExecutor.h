@@ -442,7 +442,9 @@ namespace concurrent{
          * @param task
          *      The task that is to be removed from the work queue.
          *
-         * @return true if the task was removed from the Queue.
+         * @return true if the task was removed from the Queue, false if it was not found or
+         *         the Queue can't remove a given element, as is the case for an
+         *         MPMCArrayBlockingQueue.
          */
         bool remove(decaf::lang::Runnable* task);
 
@@ -0,0 +1,814 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "WorkStealingExecutor.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/util/concurrent/Executors.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/RejectedExecutionException.h>
+
+#include <deque>
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    struct WorkItem {
+        Runnable* task;
+        bool owned;
+    };
+
+    // Distance between two indices that are allowed to wrap around.
+    inline int distance(int from, int to) {
+        return (int) ((unsigned int) to - (unsigned int) from);
+    }
+
+    /**
+     * Chase-Lev work stealing deque.  Only the owning worker pushes and pops at the
+     * bottom, any thread can steal from the top.  When the array fills up the owner
+     * copies it into one twice the size, a thief may still be reading from the old
+     * array so it is kept until the deque is destroyed.
+     */
+    class WorkDeque {
+    private:
+
+        static const int INITIAL_CAPACITY = 256;
+        static const int CACHE_LINE = 64;
+
+        struct Array {
+            int mask;
+            WorkItem* cells;
+
+            Array(int capacity) : mask(capacity - 1), cells(new WorkItem[capacity]) {}
+            ~Array() {
+                delete [] cells;
+            }
+
+        private:
+
+            Array(const Array&);
+            Array& operator= (const Array&);
+        };
+
+        // Thieves only touch top, keep it apart from the owner's bottom.
+        volatile int top;
+        char topPadding[CACHE_LINE - sizeof(int)];
+        volatile int bottom;
+        char bottomPadding[CACHE_LINE - sizeof(int)];
+        volatile void* array;
+        std::vector<Array*> retired;
+
+    private:
+
+        WorkDeque(const WorkDeque&);
+        WorkDeque& operator= (const WorkDeque&);
+
+    public:
+
+        WorkDeque() : top(0), topPadding(), bottom(0), bottomPadding(),
+                      array(new Array(INITIAL_CAPACITY)), retired() {
+        }
+
+        ~WorkDeque() {
+            delete (Array*) this->array;
+            std::vector<Array*>::iterator iter = retired.begin();
+            for (; iter != retired.end(); ++iter) {
+                delete *iter;
+            }
+        }
+
+        int size() {
+            int size = distance(Atomics::getAcquire(&this->top), Atomics::getAcquire(&this->bottom));
+            return size > 0 ? size : 0;
+        }
+
+        /**
+         * Owner only, adds the item at the bottom.
+         */
+        void push(const WorkItem& item) {
+            int b = this->bottom;
+            int t = Atomics::getAcquire(&this->top);
+            Array* a = (Array*) this->array;
+
+            if (distance(t, b) > a->mask) {
+                a = grow(a, t, b);
+            }
+
+            a->cells[b & a->mask] = item;
+            Atomics::lazySet(&this->bottom, b + 1);
+        }
+
+        /**
+         * Owner only, removes the item at the bottom, the most recently pushed.
+         */
+        bool pop(WorkItem& item) {
+            int b = this->bottom - 1;
+            Array* a = (Array*) this->array;
+
+            // The store of bottom must be visible before top is read, a thief does
+            // the same in the other order so that both can't take the last item.
+            Atomics::getAndSet(&this->bottom, b);
+            int t = this->top;
+
+            int size = distance(t, b);
+            if (size < 0) {
+                Atomics::lazySet(&this->bottom, b + 1);
+                return false;
+            }
+
+            item = a->cells[b & a->mask];
+            if (size > 0) {
+                return true;
+            }
+
+            bool won = Atomics::compareAndSet32(&this->top, t, t + 1);
+            Atomics::lazySet(&this->bottom, b + 1);
+            return won;
+        }
+
+        /**
+         * Any thread, removes the item at the top, the least recently pushed.
+         */
+        bool steal(WorkItem& item) {
+            while (true) {
+                int t = Atomics::addAndGet(&this->top, 0);
+                int b = Atomics::getAcquire(&this->bottom);
+
+                if (distance(t, b) <= 0) {
+                    return false;
+                }
+
+                Array* a = (Array*) Atomics::getAcquire(&this->array);
+                item = a->cells[t & a->mask];
+
+                if (Atomics::compareAndSet32(&this->top, t, t + 1)) {
+                    return true;
+                }
+            }
+        }
+
+    private:
+
+        Array* grow(Array* current, int t, int b) {
+            Array* grown = new Array((current->mask + 1) * 2);
+            for (int i = t; i != b; ++i) {
+                grown->cells[i & grown->mask] = current->cells[i & current->mask];
+            }
+
+            retired.push_back(current);
+            Atomics::lazySet(&this->array, grown);
+            return grown;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    class WorkStealingWorker : public Runnable {
+    private:
+
+        WorkStealingWorker(const WorkStealingWorker&);
+        WorkStealingWorker& operator= (const WorkStealingWorker&);
+
+    public:
+
+        WorkStealingExecutorKernel* kernel;
+        int index;
+        WorkDeque deque;
+        Thread* thread;
+        unsigned int seed;
+
+        // Only written by the worker itself.
+        volatile long long completedTasks;
+        volatile long long steals;
+
+    public:
+
+        WorkStealingWorker(WorkStealingExecutorKernel* kernel, int index) :
+            Runnable(), kernel(kernel), index(index), deque(), thread(NULL),
+            seed((unsigned int) index * 0x9E3779B9U + 1), completedTasks(0), steals(0) {
+        }
+
+        virtual ~WorkStealingWorker() {
+            delete this->thread;
+        }
+
+        virtual void run();
+
+        int nextVictim(int poolSize) {
+            this->seed ^= this->seed << 13;
+            this->seed ^= this->seed >> 17;
+            this->seed ^= this->seed << 5;
+            return (int) (this->seed % (unsigned int) poolSize);
+        }
+    };
+
+    class WorkStealingExecutorKernel {
+    private:
+
+        WorkStealingExecutorKernel(const WorkStealingExecutorKernel&);
+        WorkStealingExecutorKernel& operator= (const WorkStealingExecutorKernel&);
+
+    public:
+
+        static const int RUNNING = 0;
+        static const int SHUTDOWN = 1;
+        static const int STOP = 2;
+        static const int TERMINATED = 3;
+
+        // Most submissions a worker moves from the shared queue to its own at once.
+        static const int MAX_TRANSFER = 16;
+
+    public:
+
+        int parallelism;
+        bool asyncMode;
+        Pointer<ThreadFactory> factory;
+        std::vector<WorkStealingWorker*> workers;
+
+        // Guards the submission queue, the start of the workers and changes of state.
+        Mutex submissionLock;
+        std::deque<WorkItem> submissions;
+        volatile int submissionCount;
+        bool started;
+
+        volatile int state;
+
+        // Idle workers park on this monitor and register themselves in idleCount.
+        Mutex idleMonitor;
+        volatile int idleCount;
+
+        Mutex terminationMonitor;
+        volatile int liveWorkers;
+
+    public:
+
+        WorkStealingExecutorKernel(int parallelism, ThreadFactory* factory, bool asyncMode) :
+            parallelism(parallelism), asyncMode(asyncMode), factory(factory), workers(),
+            submissionLock(), submissions(), submissionCount(0), started(false),
+            state(RUNNING), idleMonitor(), idleCount(0), terminationMonitor(), liveWorkers(0) {
+
+            for (int i = 0; i < parallelism; ++i) {
+                workers.push_back(new WorkStealingWorker(this, i));
+            }
+        }
+
+        ~WorkStealingExecutorKernel() {
+            try {
+                shutdown();
+                awaitTermination(-1);
+
+                Thread* current = Thread::currentThread();
+                std::vector<WorkStealingWorker*>::iterator iter = workers.begin();
+                for (; iter != workers.end(); ++iter) {
+                    if ((*iter)->thread != NULL && (*iter)->thread != current) {
+                        (*iter)->thread->join();
+                    }
+                }
+
+                ArrayList<Runnable*> leftovers;
+                drain(leftovers, true);
+
+                for (iter = workers.begin(); iter != workers.end(); ++iter) {
+                    delete *iter;
+                }
+            }
+            DECAF_CATCH_NOTHROW(Exception)
+            DECAF_CATCHALL_NOTHROW()
+        }
+
+        void execute(Runnable* task, bool takeOwnership) {
+
+            WorkItem item = { task, takeOwnership };
+            WorkStealingWorker* worker = currentWorker();
+
+            if (worker != NULL) {
+                if (this->state != RUNNING) {
+                    reject(item);
+                }
+                worker->deque.push(item);
+            } else {
+                synchronized(&submissionLock) {
+                    if (this->state != RUNNING) {
+                        reject(item);
+                    }
+
+                    if (!started) {
+                        startWorkers();
+                    }
+
+                    submissions.push_back(item);
+                    Atomics::incrementAndGet(&this->submissionCount);
+                }
+            }
+
+            signalWork();
+        }
+
+        void shutdown() {
+            bool terminate = false;
+
+            synchronized(&submissionLock) {
+                if (this->state == RUNNING) {
+                    this->state = SHUTDOWN;
+                }
+                terminate = !started;
+            }
+
+            wakeAll();
+
+            if (terminate) {
+                terminated();
+            }
+        }
+
+        void shutdownNow(ArrayList<Runnable*>& unexecuted) {
+            bool terminate = false;
+
+            synchronized(&submissionLock) {
+                if (this->state < STOP) {
+                    this->state = STOP;
+                }
+                terminate = !started;
+            }
+
+            drain(unexecuted, false);
+
+            std::vector<WorkStealingWorker*>::iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                if ((*iter)->thread != NULL) {
+                    (*iter)->thread->interrupt();
+                }
+            }
+
+            wakeAll();
+
+            if (terminate) {
+                terminated();
+            }
+        }
+
+        /**
+         * Waits the given number of nanoseconds for the workers to exit, forever if the
+         * value is negative.
+         */
+        bool awaitTermination(long long nanos) {
+
+            if (currentWorker() != NULL) {
+                return this->state == TERMINATED;
+            }
+
+            long long deadline = System::nanoTime() + nanos;
+
+            synchronized(&terminationMonitor) {
+                while (this->state != TERMINATED) {
+                    if (nanos < 0) {
+                        terminationMonitor.wait();
+                        continue;
+                    }
+
+                    long long remaining = deadline - System::nanoTime();
+                    if (remaining <= 0) {
+                        return false;
+                    }
+
+                    terminationMonitor.wait(remaining / 1000000, (int) (remaining % 1000000));
+                }
+            }
+
+            return true;
+        }
+
+        void runWorker(WorkStealingWorker* worker) {
+
+            try {
+                WorkItem item;
+                while (this->state < STOP) {
+                    if (findWork(worker, item)) {
+                        runTask(worker, item);
+                    } else if (!awaitWork()) {
+                        break;
+                    }
+                }
+            }
+            DECAF_CATCH_NOTHROW(Exception)
+            DECAF_CATCHALL_NOTHROW()
+
+            if (Atomics::decrementAndGet(&this->liveWorkers) == 0) {
+                terminated();
+            }
+        }
+
+        long long getQueuedTaskCount() const {
+            long long count = this->submissionCount;
+            std::vector<WorkStealingWorker*>::const_iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                count += (*iter)->deque.size();
+            }
+            return count;
+        }
+
+        long long getStealCount() const {
+            long long count = 0;
+            std::vector<WorkStealingWorker*>::const_iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                count += (*iter)->steals;
+            }
+            return count;
+        }
+
+        long long getCompletedTaskCount() const {
+            long long count = 0;
+            std::vector<WorkStealingWorker*>::const_iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                count += (*iter)->completedTasks;
+            }
+            return count;
+        }
+
+    private:
+
+        WorkStealingWorker* currentWorker() const {
+            Thread* current = Thread::currentThread();
+            std::vector<WorkStealingWorker*>::const_iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                if ((*iter)->thread == current) {
+                    return *iter;
+                }
+            }
+            return NULL;
+        }
+
+        void reject(const WorkItem& item) {
+            if (item.owned) {
+                delete item.task;
+            }
+            throw RejectedExecutionException(__FILE__, __LINE__, "Executor has been shutdown.");
+        }
+
+        void startWorkers() {
+            this->liveWorkers = this->parallelism;
+
+            std::vector<WorkStealingWorker*>::iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                (*iter)->thread = this->factory->newThread(*iter);
+            }
+
+            this->started = true;
+
+            for (iter = workers.begin(); iter != workers.end(); ++iter) {
+                (*iter)->thread->start();
+            }
+        }
+
+        bool findWork(WorkStealingWorker* worker, WorkItem& item) {
+
+            bool found = this->asyncMode ? worker->deque.steal(item) : worker->deque.pop(item);
+            if (found || pollSubmissions(worker, item)) {
+                return true;
+            }
+
+            const int poolSize = (int) workers.size();
+            int start = worker->nextVictim(poolSize);
+            for (int i = 0; i < poolSize; ++i) {
+                WorkStealingWorker* victim = workers[(start + i) % poolSize];
+                if (victim != worker && victim->deque.steal(item)) {
+                    worker->steals++;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool pollSubmissions(WorkStealingWorker* worker, WorkItem& item) {
+
+            if (Atomics::getAcquire(&this->submissionCount) == 0) {
+                return false;
+            }
+
+            bool found = false;
+            int transferred = 0;
+
+            synchronized(&submissionLock) {
+                if (!submissions.empty()) {
+                    item = submissions.front();
+                    submissions.pop_front();
+                    found = true;
+
+                    // Take a share of whatever else is waiting so the others can steal it
+                    // from this worker instead of all contending on the shared queue.
+                    int share = (int) submissions.size() / this->parallelism;
+                    if (share > MAX_TRANSFER) {
+                        share = MAX_TRANSFER;
+                    }
+
+                    for (; transferred < share; ++transferred) {
+                        worker->deque.push(submissions.front());
+                        submissions.pop_front();
+                    }
+
+                    Atomics::addAndGet(&this->submissionCount, -(transferred + 1));
+                }
+            }
+
+            if (transferred > 0) {
+                signalWork();
+            }
+
+            return found;
+        }
+
+        bool hasQueuedWork() const {
+            if (Atomics::getAcquire(const_cast<volatile int*>(&this->submissionCount)) > 0) {
+                return true;
+            }
+
+            std::vector<WorkStealingWorker*>::const_iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                if ((*iter)->deque.size() > 0) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        /**
+         * Parks the calling worker until work is queued, returns false when the worker
+         * should exit instead.
+         */
+        bool awaitWork() {
+
+            synchronized(&idleMonitor) {
+                Atomics::incrementAndGet(&this->idleCount);
+
+                try {
+                    // Registered as idle before looking again so that a submitter either
+                    // sees this worker waiting or this worker sees the new work.
+                    if (this->state >= STOP) {
+                        Atomics::decrementAndGet(&this->idleCount);
+                        return false;
+                    }
+
+                    if (!hasQueuedWork()) {
+                        if (this->state == SHUTDOWN) {
+                            Atomics::decrementAndGet(&this->idleCount);
+                            return false;
+                        }
+
+                        idleMonitor.wait();
+                    }
+                } catch (InterruptedException& ex) {
+                }
+
+                Atomics::decrementAndGet(&this->idleCount);
+            }
+
+            return true;
+        }
+
+        void signalWork() {
+            if (Atomics::addAndGet(&this->idleCount, 0) > 0) {
+                synchronized(&idleMonitor) {
+                    idleMonitor.notify();
+                }
+            }
+        }
+
+        void wakeAll() {
+            synchronized(&idleMonitor) {
+                idleMonitor.notifyAll();
+            }
+        }
+
+        void runTask(WorkStealingWorker* worker, const WorkItem& item) {
+
+            try {
+                item.task->run();
+            }
+            DECAF_CATCH_NOTHROW(Exception)
+            DECAF_CATCHALL_NOTHROW()
+
+            if (item.owned) {
+                try {
+                    delete item.task;
+                }
+                DECAF_CATCH_NOTHROW(Exception)
+                DECAF_CATCHALL_NOTHROW()
+            }
+
+            worker->completedTasks++;
+        }
+
+        /**
+         * Removes every queued task, the ones the pool owns are deleted if requested and
+         * otherwise handed over along with the rest.
+         */
+        void drain(ArrayList<Runnable*>& unexecuted, bool deleteOwned) {
+
+            std::deque<WorkItem> pending;
+
+            synchronized(&submissionLock) {
+                pending.swap(submissions);
+                this->submissionCount = 0;
+            }
+
+            WorkItem item;
+            std::vector<WorkStealingWorker*>::iterator iter = workers.begin();
+            for (; iter != workers.end(); ++iter) {
+                while ((*iter)->deque.steal(item)) {
+                    pending.push_back(item);
+                }
+            }
+
+            std::deque<WorkItem>::iterator next = pending.begin();
+            for (; next != pending.end(); ++next) {
+                if (deleteOwned && next->owned) {
+                    delete next->task;
+                } else if (!deleteOwned) {
+                    unexecuted.add(next->task);
+                }
+            }
+        }
+
+        void terminated() {
+            synchronized(&terminationMonitor) {
+                this->state = TERMINATED;
+                terminationMonitor.notifyAll();
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingWorker::run() {
+    this->kernel->runWorker(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutor::WorkStealingExecutor() : AbstractExecutorService(), kernel(NULL) {
+    this->kernel = new WorkStealingExecutorKernel(
+        System::availableProcessors(), Executors::getDefaultThreadFactory(), false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutor::WorkStealingExecutor(int parallelism) : AbstractExecutorService(), kernel(NULL) {
+
+    if (parallelism < 1) {
+        throw IllegalArgumentException(__FILE__, __LINE__, "Parallelism must be at least one.");
+    }
+
+    this->kernel = new WorkStealingExecutorKernel(parallelism, Executors::getDefaultThreadFactory(), false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutor::WorkStealingExecutor(int parallelism, ThreadFactory* threadFactory, bool asyncMode) :
+    AbstractExecutorService(), kernel(NULL) {
+
+    if (threadFactory == NULL) {
+        throw NullPointerException(__FILE__, __LINE__, "ThreadFactory cannot be NULL.");
+    }
+
+    if (parallelism < 1) {
+        delete threadFactory;
+        throw IllegalArgumentException(__FILE__, __LINE__, "Parallelism must be at least one.");
+    }
+
+    this->kernel = new WorkStealingExecutorKernel(parallelism, threadFactory, asyncMode);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutor::~WorkStealingExecutor() {
+    try {
+        delete this->kernel;
+    }
+    DECAF_CATCH_NOTHROW(Exception)
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutor::execute(Runnable* task) {
+    this->execute(task, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutor::execute(Runnable* task, bool takeOwnership) {
+
+    try {
+
+        if (task == NULL) {
+            throw NullPointerException(__FILE__, __LINE__,
+                "WorkStealingExecutor::execute - Supplied Runnable pointer was NULL.");
+        }
+
+        this->kernel->execute(task, takeOwnership);
+    }
+    DECAF_CATCH_RETHROW(RejectedExecutionException)
+    DECAF_CATCH_RETHROW(NullPointerException)
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutor::shutdown() {
+
+    try {
+        this->kernel->shutdown();
+    }
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ArrayList<Runnable*> WorkStealingExecutor::shutdownNow() {
+
+    ArrayList<Runnable*> result;
+
+    try {
+        this->kernel->shutdownNow(result);
+        return result;
+    }
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WorkStealingExecutor::awaitTermination(long long timeout, const TimeUnit& unit) {
+
+    try {
+        long long nanos = unit.toNanos(timeout);
+        return this->kernel->awaitTermination(nanos < 0 ? 0 : nanos);
+    }
+    DECAF_CATCH_RETHROW(InterruptedException)
+    DECAF_CATCH_RETHROW(Exception)
+    DECAF_CATCHALL_THROW(Exception)
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WorkStealingExecutor::isShutdown() const {
+    return this->kernel->state != WorkStealingExecutorKernel::RUNNING;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WorkStealingExecutor::isTerminated() const {
+    return this->kernel->state == WorkStealingExecutorKernel::TERMINATED;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int WorkStealingExecutor::getParallelism() const {
+    return this->kernel->parallelism;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool WorkStealingExecutor::getAsyncMode() const {
+    return this->kernel->asyncMode;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long WorkStealingExecutor::getQueuedTaskCount() const {
+    return this->kernel->getQueuedTaskCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long WorkStealingExecutor::getStealCount() const {
+    return this->kernel->getStealCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long WorkStealingExecutor::getCompletedTaskCount() const {
+    return this->kernel->getCompletedTaskCount();
+}
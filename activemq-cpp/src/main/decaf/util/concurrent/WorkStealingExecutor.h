@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _DECAF_UTIL_CONCURRENT_WORKSTEALINGEXECUTOR_H_
+#define _DECAF_UTIL_CONCURRENT_WORKSTEALINGEXECUTOR_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/util/ArrayList.h>
+#include <decaf/util/concurrent/AbstractExecutorService.h>
+#include <decaf/util/concurrent/ThreadFactory.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    class WorkStealingExecutorKernel;
+
+    /**
+     * An ExecutorService whose worker threads each own a double ended queue of tasks
+     * instead of sharing a single work queue.  A task submitted from one of the pool's
+     * own workers is pushed onto that worker's deque without taking any lock, tasks
+     * submitted from other threads go to a shared submission queue.  A worker that runs
+     * out of work of its own takes from the submission queue and then steals from the
+     * other end of the busy workers' deques, a worker that finds nothing anywhere parks
+     * until new work is submitted.
+     *
+     * By default a worker runs the work it queued itself newest first, which keeps a task
+     * that splits into subtasks working on data that is still in cache.  In async mode the
+     * worker runs its own work oldest first instead, which suits event style tasks that
+     * are never joined and should be processed in the order they were queued.
+     *
+     * The pool does not preserve any ordering between tasks handed to different workers,
+     * work that must run in sequence needs to be serialized by the caller.
+     *
+     * @since 3.9
+     */
+    class DECAF_API WorkStealingExecutor : public AbstractExecutorService {
+    private:
+
+        WorkStealingExecutor(const WorkStealingExecutor&);
+        WorkStealingExecutor& operator= (const WorkStealingExecutor&);
+
+    private:
+
+        WorkStealingExecutorKernel* kernel;
+
+    public:
+
+        /**
+         * Creates a new pool with one worker for every available processor, the workers
+         * are created from the default ThreadFactory when the first task is submitted.
+         */
+        WorkStealingExecutor();
+
+        /**
+         * Creates a new pool with the given number of workers, the workers are created
+         * from the default ThreadFactory when the first task is submitted.
+         *
+         * @param parallelism
+         *      The number of worker threads in the pool.
+         *
+         * @throws IllegalArgumentException if parallelism is less than one.
+         */
+        WorkStealingExecutor(int parallelism);
+
+        /**
+         * Creates a new pool with the given number of workers.
+         *
+         * @param parallelism
+         *      The number of worker threads in the pool.
+         * @param threadFactory
+         *      The factory used to create the worker threads, ownership passes to the pool.
+         * @param asyncMode
+         *      If true each worker runs the tasks it queued itself in the order they were
+         *      queued, otherwise it runs the most recently queued one first.
+         *
+         * @throws NullPointerException if the thread factory is NULL.
+         * @throws IllegalArgumentException if parallelism is less than one.
+         */
+        WorkStealingExecutor(int parallelism, ThreadFactory* threadFactory, bool asyncMode = false);
+
+        virtual ~WorkStealingExecutor();
+
+    public:
+
+        virtual void execute(decaf::lang::Runnable* task);
+
+        virtual void execute(decaf::lang::Runnable* task, bool takeOwnership);
+
+        virtual void shutdown();
+
+        virtual ArrayList<decaf::lang::Runnable*> shutdownNow();
+
+        virtual bool awaitTermination(long long timeout, const TimeUnit& unit);
+
+        virtual bool isShutdown() const;
+
+        virtual bool isTerminated() const;
+
+    public:
+
+        /**
+         * @return the number of worker threads this pool runs.
+         */
+        int getParallelism() const;
+
+        /**
+         * @return true if the workers run the work they queued themselves oldest first.
+         */
+        bool getAsyncMode() const;
+
+        /**
+         * @return the number of tasks that are currently queued and not yet running, since
+         *         the workers keep running this is only an estimate.
+         */
+        long long getQueuedTaskCount() const;
+
+        /**
+         * @return the number of tasks that have been taken from another worker's deque.
+         */
+        long long getStealCount() const;
+
+        /**
+         * @return the number of tasks that have finished running.
+         */
+        long long getCompletedTaskCount() const;
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_WORKSTEALINGEXECUTOR_H_ */
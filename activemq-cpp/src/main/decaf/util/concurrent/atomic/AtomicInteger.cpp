@@ -42,6 +42,11 @@ int AtomicInteger::getAndSet(int newValue) {
     return Atomics::getAndSet(&this->value, newValue);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicInteger::lazySet(int newValue) {
+    Atomics::lazySet(&this->value, newValue);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool AtomicInteger::compareAndSet(int expect, int update) {
     return Atomics::compareAndSet32(&this->value, expect, update);
@@ -75,6 +75,14 @@ namespace atomic {
             this->value = newValue;
         }
 
+        /**
+         * Eventually sets to the given value, the store is ordered after every write the
+         * calling thread made before it but, unlike set, it may be delayed past later
+         * reads, which makes it cheaper on weakly ordered processors.
+         * @param newValue - the new value
+         */
+        void lazySet( int newValue );
+
         /**
          * Atomically sets to the given value and returns the old value.
          * @param newValue - the new value.
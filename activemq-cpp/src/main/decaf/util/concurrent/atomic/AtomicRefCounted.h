@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTED_H_
+#define _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTED_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+namespace decaf{
+namespace util{
+namespace concurrent{
+namespace atomic{
+
+    class AtomicRefCounter;
+
+    /**
+     * Base class for types that carry their own reference count.  A decaf::lang::Pointer
+     * that takes ownership of an AtomicRefCounted object uses the counter held in the
+     * object rather than allocating a separate one, so creating the Pointer costs no
+     * extra allocation and the count lives next to the object's own data.
+     *
+     * The count belongs to the object's identity, copying or assigning an object leaves
+     * the count of the target untouched.
+     *
+     * @since 3.9
+     */
+    class DECAF_API AtomicRefCounted {
+    public:
+
+        /**
+         * The count shared by the Pointers that own an object, it is either embedded
+         * in an AtomicRefCounted object or allocated on its own for other types.
+         */
+        struct ReferenceCount {
+            volatile int value;
+
+            // True if the count was allocated separately and must be freed with the last reference.
+            bool detached;
+
+            ReferenceCount( int initialValue, bool isDetached ) : value( initialValue ), detached( isDetached ) {}
+        };
+
+    private:
+
+        mutable ReferenceCount references;
+
+    protected:
+
+        AtomicRefCounted() : references( 0, false ) {}
+
+        AtomicRefCounted( const AtomicRefCounted& ) : references( 0, false ) {}
+
+        AtomicRefCounted& operator= ( const AtomicRefCounted& ) {
+            return *this;
+        }
+
+        ~AtomicRefCounted() {}
+
+    public:
+
+        /**
+         * @return the number of Pointers that currently own this object, an owner that
+         *         sees a count of one holds the only reference to it.
+         */
+        int getReferenceCount() const {
+            return decaf::internal::util::concurrent::Atomics::getAcquire(&this->references.value);
+        }
+
+    private:
+
+        friend void initializeReferenceCounter( AtomicRefCounter& refCounter, const AtomicRefCounted* value );
+
+    };
+
+}}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTED_H_ */
@@ -18,7 +18,8 @@
 #ifndef _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTER_H_
 #define _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTER_H_
 
-#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/concurrent/atomic/AtomicRefCounted.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
 #include <algorithm>
 
 namespace decaf{
@@ -26,10 +27,20 @@ namespace util{
 namespace concurrent{
 namespace atomic{
 
+    /**
+     * The default reference counter used by decaf::lang::Pointer.  A NULL Pointer
+     * holds no counter at all, when a Pointer takes ownership of an object it shares
+     * the counter embedded in the object if the object derives from AtomicRefCounted
+     * and otherwise allocates a counter for it.
+     *
+     * Taking another reference needs no ordering since the caller already holds one,
+     * only the release of the last reference has to order the owners' writes before
+     * the object is destroyed.
+     */
     class AtomicRefCounter {
     private:
 
-        decaf::util::concurrent::atomic::AtomicInteger* counter;
+        AtomicRefCounted::ReferenceCount* counter;
 
     private:
 
@@ -37,10 +48,11 @@ namespace atomic{
 
     public:
 
-        AtomicRefCounter() :
-            counter( new decaf::util::concurrent::atomic::AtomicInteger( 1 ) ) {}
+        AtomicRefCounter() : counter( NULL ) {}
         AtomicRefCounter( const AtomicRefCounter& other ) : counter( other.counter ) {
-            this->counter->incrementAndGet();
+            if( this->counter != NULL ) {
+                decaf::internal::util::concurrent::Atomics::incrementAndGetRelaxed(&this->counter->value);
+            }
         }
 
         virtual ~AtomicRefCounter() {}
@@ -66,14 +78,43 @@ namespace atomic{
          * @return true if the count is now zero.
          */
         bool release() {
-            if( this->counter->decrementAndGet() == 0 ) {
-                delete this->counter;
+            if( this->counter != NULL && decaf::internal::util::concurrent::Atomics::decrementAndGetRelease(&this->counter->value) == 0 ) {
+                if( this->counter->detached ) {
+                    delete this->counter;
+                }
                 return true;
             }
             return false;
         }
+
+    private:
+
+        friend void initializeReferenceCounter( AtomicRefCounter& refCounter, const void* value );
+        friend void initializeReferenceCounter( AtomicRefCounter& refCounter, const AtomicRefCounted* value );
+
     };
 
+    /**
+     * Called by Pointer when it takes ownership of an object that carries no counter
+     * of its own, allocates a new counter for it.
+     */
+    inline void initializeReferenceCounter( AtomicRefCounter& refCounter, const void* value ) {
+        if( value != NULL ) {
+            refCounter.counter = new AtomicRefCounted::ReferenceCount( 1, true );
+        }
+    }
+
+    /**
+     * Called by Pointer when it takes ownership of an AtomicRefCounted object, the
+     * object's own counter is shared instead of allocating one.
+     */
+    inline void initializeReferenceCounter( AtomicRefCounter& refCounter, const AtomicRefCounted* value ) {
+        if( value != NULL ) {
+            refCounter.counter = &( value->references );
+            decaf::internal::util::concurrent::Atomics::incrementAndGetRelaxed(&refCounter.counter->value);
+        }
+    }
+
 }}}}
 
 #endif /* _DECAF_UTIL_CONCURRENT_ATOMIC_ATOMICREFCOUNTER_H_ */
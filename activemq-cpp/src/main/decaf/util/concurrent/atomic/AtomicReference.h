@@ -66,6 +66,17 @@ namespace atomic {
             internal::util::concurrent::Atomics::getAndSet(&this->value, (void*)newValue);
         }
 
+        /**
+         * Eventually sets the Current value of this Reference, the store is ordered after
+         * every write the calling thread made before it but may be delayed past later reads.
+         *
+         * @param newValue
+         *        The new Value of this Reference.
+         */
+        void lazySet( T* newValue ) {
+            internal::util::concurrent::Atomics::lazySet(&this->value, (void*)newValue);
+        }
+
         /**
          * Atomically sets the value to the given updated value if the current value ==
          * the expected value.
@@ -37,8 +37,8 @@ using namespace decaf::util::concurrent::atomic;
 namespace {
 
     /**
-     * A counter for per-thread read hold counts. Maintained as a ThreadLocal;
-     * cached in cachedHoldCounter in class Sync
+     * A counter for per-thread read hold counts. Maintained as a ThreadLocal
+     * and updated in place.
      */
     struct HoldCounter {
         Thread* thread;
@@ -92,9 +92,11 @@ namespace {
     private:
 
         /**
-         * The number of reentrant read locks held by current thread.
-         * Initialized only in constructor and readObject.
-         * Removed whenever a thread's read hold count drops to 0.
+         * The number of reentrant read locks held by current thread.  A thread
+         * keeps its counter once created and it is changed through the reference
+         * ThreadLocal::get returns, setting or removing the value would allocate
+         * or free a counter on every read lock and unlock taken while another
+         * thread holds the read lock.
          */
         ThreadLocalHoldCounter readHolds;
 
@@ -187,17 +189,12 @@ namespace {
                     firstReaderHoldCount--;
                 }
             } else {
-                HoldCounter rh = readHolds.get();
-                int count = rh.count;
-                if (count <= 1) {
-                    readHolds.remove();
-                    if (count <= 0) {
-                        throw IllegalMonitorStateException(
-                            __FILE__, __LINE__, "attempt to unlock read lock, not locked by current thread");
-                    }
+                HoldCounter& rh = readHolds.get();
+                if (rh.count <= 0) {
+                    throw IllegalMonitorStateException(
+                        __FILE__, __LINE__, "attempt to unlock read lock, not locked by current thread");
                 }
                 --rh.count;
-                readHolds.set(rh);
             }
 
             for (;;) {
@@ -238,9 +235,7 @@ namespace {
                 } else if (firstReader == current) {
                     firstReaderHoldCount++;
                 } else {
-                    HoldCounter rh = readHolds.get();
-                    rh.count++;
-                    readHolds.set(rh);
+                    readHolds.get().count++;
                 }
                 return 1;
             }
@@ -254,7 +249,6 @@ namespace {
          */
         int fullTryAcquireShared(Thread* current) {
 
-            HoldCounter rh;
             for (;;) {
                 int c = getState();
                 if (exclusiveCount(c) != 0) {
@@ -269,15 +263,8 @@ namespace {
                         if (firstReaderHoldCount > 0) {
                             throw Exception(__FILE__, __LINE__, "Read lock should not be aquired reentrantlly.");
                         }
-                    } else {
-                        rh = readHolds.get();
-                        if (rh.count == 0) {
-                            readHolds.remove();
-                        }
-
-                        if (rh.count == 0) {
-                            return -1;
-                        }
+                    } else if (readHolds.get().count == 0) {
+                        return -1;
                     }
                 }
                 if (sharedCount(c) == MAX_COUNT) {
@@ -290,9 +277,7 @@ namespace {
                     } else if (firstReader == current) {
                         firstReaderHoldCount++;
                     } else {
-                        rh = readHolds.get();
-                        rh.count++;
-                        readHolds.set(rh);
+                        readHolds.get().count++;
                     }
                     return 1;
                 }
@@ -346,9 +331,7 @@ namespace {
                     } else if (firstReader == current) {
                         firstReaderHoldCount++;
                     } else {
-                        HoldCounter rh = readHolds.get();//cachedHoldCounter;
-                        rh.count++;
-                        readHolds.set(rh);
+                        readHolds.get().count++;
                     }
                     return true;
                 }
@@ -392,11 +375,7 @@ namespace {
                 return firstReaderHoldCount;
             }
 
-            int count = readHolds.get().count;
-            if (count == 0) {
-                readHolds.remove();
-            }
-            return count;
+            return readHolds.get().count;
         }
 
         int getCount() {
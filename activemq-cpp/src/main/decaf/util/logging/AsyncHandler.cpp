@@ -0,0 +1,394 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncHandler.h"
+
+#include <decaf/util/logging/Formatter.h>
+#include <decaf/util/logging/ErrorManager.h>
+#include <decaf/io/OutputStream.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+#include <memory>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::io;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::logging;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+const int AsyncHandler::DEFAULT_CAPACITY = 8192;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Upper bound on an idle wait, the producers wake the writer when they see it parked.
+    const long long PARK_TIMEOUT = 1000;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace util {
+namespace logging {
+
+    /**
+     * One entry in the ring.  The sequence tells the producers and the writer who
+     * owns the slot: it equals the position when the slot is free for the producer
+     * that claims that position, and position + 1 once the message has been stored.
+     */
+    struct RingSlot {
+        volatile long long sequence;
+        std::string message;
+
+        RingSlot() : sequence(0), message() {}
+    };
+
+    class AsyncHandlerImpl : public Runnable {
+    private:
+
+        AsyncHandlerImpl(const AsyncHandlerImpl&);
+        AsyncHandlerImpl& operator= (const AsyncHandlerImpl&);
+
+    public:
+
+        AsyncHandler* parent;
+        OutputStream* stream;
+
+        RingSlot* slots;
+        int capacity;
+        long long mask;
+
+        // Next position a producer will claim.
+        volatile long long enqueuePos;
+
+        // Next position the writer will take, only touched by the writer thread.
+        long long dequeuePos;
+
+        volatile long long dropped;
+        volatile int parked;
+        volatile int closed;
+
+        // Guarded by mutex.
+        long long written;
+        int flushers;
+        bool finished;
+
+        bool headWritten;
+
+        Mutex mutex;
+        std::auto_ptr<Thread> thread;
+
+    public:
+
+        AsyncHandlerImpl(AsyncHandler* parent, OutputStream* stream, int capacity) :
+            parent(parent), stream(stream), slots(NULL), capacity(1), mask(0), enqueuePos(0), dequeuePos(0),
+            dropped(0), parked(0), closed(0), written(0), flushers(0), finished(false),
+            headWritten(false), mutex(), thread() {
+
+            while (this->capacity < capacity && this->capacity < (1 << 30)) {
+                this->capacity <<= 1;
+            }
+
+            this->mask = this->capacity - 1;
+            this->slots = new RingSlot[this->capacity];
+            for (int i = 0; i < this->capacity; ++i) {
+                this->slots[i].sequence = i;
+            }
+        }
+
+        virtual ~AsyncHandlerImpl() {
+            delete [] this->slots;
+        }
+
+        void start() {
+            this->thread.reset(new Thread(this, "AsyncHandler"));
+            this->thread->start();
+        }
+
+        static long long load(volatile long long* value) {
+            return Atomics::addAndGet64(value, 0);
+        }
+
+        bool offer(std::string& message) {
+
+            long long pos = load(&this->enqueuePos);
+            RingSlot* slot = NULL;
+
+            for (;;) {
+                slot = &this->slots[pos & this->mask];
+                long long diff = load(&slot->sequence) - pos;
+
+                if (diff == 0) {
+                    if (Atomics::compareAndSet64(&this->enqueuePos, pos, pos + 1)) {
+                        break;
+                    }
+                    pos = load(&this->enqueuePos);
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = load(&this->enqueuePos);
+                }
+            }
+
+            slot->message.swap(message);
+
+            // Publish the message, the full barrier makes it visible before the sequence.
+            Atomics::addAndGet64(&slot->sequence, 1);
+
+            if (Atomics::getAndAdd(&this->parked, 0) != 0) {
+                synchronized(&this->mutex) {
+                    this->mutex.notifyAll();
+                }
+            }
+
+            return true;
+        }
+
+        bool isEmpty() {
+            return load(&this->slots[this->dequeuePos & this->mask].sequence) != this->dequeuePos + 1;
+        }
+
+        int drain(std::string& batch) {
+
+            int count = 0;
+
+            while (count < this->capacity && !isEmpty()) {
+                RingSlot* slot = &this->slots[this->dequeuePos & this->mask];
+                batch.append(slot->message);
+                slot->message.clear();
+
+                // Hand the slot back for the position one lap ahead.
+                Atomics::addAndGet64(&slot->sequence, this->mask);
+                this->dequeuePos++;
+                count++;
+            }
+
+            return count;
+        }
+
+        void write(const std::string& value) {
+
+            if (value.empty()) {
+                return;
+            }
+
+            try {
+                this->stream->write((const unsigned char*) value.c_str(), (int) value.length(), 0, (int) value.length());
+                this->stream->flush();
+            } catch (Exception& e) {
+                this->parent->getErrorManager()->error(
+                    "Failed to write to the OutputStream", &e, ErrorManager::WRITE_FAILURE);
+            }
+        }
+
+        void park() {
+            synchronized(&this->mutex) {
+                Atomics::getAndSet(&this->parked, 1);
+                if (isEmpty() && Atomics::getAndAdd(&this->closed, 0) == 0) {
+                    this->mutex.wait(PARK_TIMEOUT);
+                }
+                Atomics::getAndSet(&this->parked, 0);
+            }
+        }
+
+        virtual void run() {
+
+            try {
+
+                std::string batch;
+
+                for (;;) {
+
+                    batch.clear();
+                    if (!this->headWritten) {
+                        batch = this->parent->getFormatter()->getHead(this->parent);
+                        this->headWritten = true;
+                    }
+
+                    int count = drain(batch);
+                    write(batch);
+
+                    if (count > 0) {
+                        synchronized(&this->mutex) {
+                            this->written = this->dequeuePos;
+                            if (this->flushers > 0) {
+                                this->mutex.notifyAll();
+                            }
+                        }
+                    } else if (Atomics::getAndAdd(&this->closed, 0) != 0) {
+                        break;
+                    } else {
+                        park();
+                    }
+                }
+
+            } catch (Exception& e) {
+                this->parent->getErrorManager()->error(
+                    "AsyncHandler writer thread failed", &e, ErrorManager::GENERIC_FAILURE);
+            } catch (...) {
+            }
+
+            synchronized(&this->mutex) {
+                this->finished = true;
+                this->mutex.notifyAll();
+            }
+        }
+
+        void flush() {
+
+            long long target = load(&this->enqueuePos);
+
+            synchronized(&this->mutex) {
+                this->flushers++;
+                while (this->written < target && !this->finished) {
+                    this->mutex.notifyAll();
+                    this->mutex.wait();
+                }
+                this->flushers--;
+            }
+        }
+
+        void close() {
+
+            if (Atomics::getAndSet(&this->closed, 1) != 0) {
+                return;
+            }
+
+            synchronized(&this->mutex) {
+                this->mutex.notifyAll();
+            }
+
+            if (this->thread.get() != NULL) {
+                this->thread->join();
+            }
+
+            write(this->parent->getFormatter()->getTail(this->parent));
+
+            try {
+                this->stream->close();
+            } catch (Exception& e) {
+                this->parent->getErrorManager()->error(
+                    "Failed to close the OutputStream", &e, ErrorManager::CLOSE_FAILURE);
+            }
+        }
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+AsyncHandler::AsyncHandler( OutputStream* stream, Formatter* formatter, int capacity ) :
+    Handler(), impl(NULL) {
+
+    if( stream == NULL ) {
+        throw NullPointerException(
+            __FILE__, __LINE__, "OutputStream cannot be NULL." );
+    }
+
+    if( formatter == NULL ) {
+        throw NullPointerException(
+            __FILE__, __LINE__, "Formatter cannot be NULL." );
+    }
+
+    if( capacity <= 0 ) {
+        throw IllegalArgumentException(
+            __FILE__, __LINE__, "Capacity must be positive." );
+    }
+
+    setFormatter( formatter );
+
+    this->impl = new AsyncHandlerImpl( this, stream, capacity );
+    this->impl->start();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AsyncHandler::~AsyncHandler() {
+
+    try {
+        this->close();
+    }
+    DECAF_CATCH_NOTHROW( lang::Exception)
+    DECAF_CATCHALL_NOTHROW()
+
+    try {
+        delete this->impl;
+    }
+    DECAF_CATCHALL_NOTHROW()
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandler::close() {
+    this->impl->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandler::flush() {
+    this->impl->flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandler::publish( const LogRecord& record ) {
+
+    try {
+
+        if( this->isLoggable( record ) ) {
+
+            std::string msg;
+            try {
+                msg = getFormatter()->format( record );
+            } catch( Exception& e ) {
+                this->getErrorManager()->error(
+                    "Failed to format the LogRecord", &e, ErrorManager::FORMAT_FAILURE );
+                return;
+            }
+
+            if( !this->impl->offer( msg ) ) {
+                Atomics::addAndGet64( &this->impl->dropped, 1 );
+            }
+        }
+    } catch( Exception& e ) {
+        this->getErrorManager()->error(
+            "Failed to publish the LogRecord", &e, ErrorManager::GENERIC_FAILURE );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AsyncHandler::isLoggable( const LogRecord& record ) const {
+
+    if( Atomics::getAndAdd( &this->impl->closed, 0 ) == 0 && Handler::isLoggable( record ) ) {
+        return true;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long AsyncHandler::getDroppedCount() const {
+    return AsyncHandlerImpl::load( &this->impl->dropped );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int AsyncHandler::getCapacity() const {
+    return this->impl->capacity;
+}
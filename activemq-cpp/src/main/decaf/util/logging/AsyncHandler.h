@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_LOGGING_ASYNCHANDLER_H_
+#define _DECAF_UTIL_LOGGING_ASYNCHANDLER_H_
+
+#include <decaf/util/Config.h>
+#include <decaf/util/logging/Handler.h>
+
+namespace decaf{
+namespace io{
+    class OutputStream;
+}
+namespace util{
+namespace logging{
+
+    class AsyncHandlerImpl;
+
+    /**
+     * A Handler that moves the cost of writing log output off the logging thread.
+     * The LogRecord is formatted by the thread that publishes it and the result is
+     * placed in a bounded lock free ring, a background thread takes everything that
+     * is waiting in the ring and writes it to the OutputStream as a single batch.
+     *
+     * Publishing never blocks on the OutputStream, when the ring is full the record
+     * is dropped and counted instead so that a slow console or file cannot stall the
+     * threads doing the actual work.  The number of records lost this way can be read
+     * from getDroppedCount.
+     *
+     * As with the StreamHandler the OutputStream and Formatter are not owned by the
+     * handler and must remain valid until it has been closed.
+     *
+     * @since 3.9.0
+     */
+    class DECAF_API AsyncHandler : public Handler {
+    public:
+
+        /**
+         * Default number of formatted records the ring can hold.
+         */
+        static const int DEFAULT_CAPACITY;
+
+    private:
+
+        AsyncHandlerImpl* impl;
+
+    private:
+
+        AsyncHandler( const AsyncHandler& );
+        AsyncHandler& operator= ( const AsyncHandler& );
+
+    public:
+
+        /**
+         * Creates a new AsyncHandler and starts its writer thread.
+         *
+         * @param stream
+         *      The OutputStream that the formatted records are written to.
+         * @param formatter
+         *      The Formatter used to format each published LogRecord.
+         * @param capacity
+         *      The number of records the ring can hold, rounded up to a power of two.
+         *
+         * @throws NullPointerException if the stream or formatter is NULL.
+         * @throws IllegalArgumentException if the capacity is not positive.
+         */
+        AsyncHandler( decaf::io::OutputStream* stream, Formatter* formatter,
+                      int capacity = DEFAULT_CAPACITY );
+
+        virtual ~AsyncHandler();
+
+        /**
+         * Writes out any records that are still waiting in the ring, stops the writer
+         * thread and closes the OutputStream.  Records published afterwards are ignored.
+         */
+        virtual void close();
+
+        /**
+         * Blocks until every record published before the call has been written and
+         * then flushes the OutputStream.
+         */
+        virtual void flush();
+
+        /**
+         * Formats the record and queues it for the writer thread, the record is dropped
+         * if the ring is full.
+         *
+         * @param record
+         *      The <code>LogRecord</code> to Publish
+         */
+        virtual void publish( const LogRecord& record );
+
+        virtual bool isLoggable( const LogRecord& record ) const;
+
+        /**
+         * @return the number of records that were dropped because the ring was full.
+         */
+        long long getDroppedCount() const;
+
+        /**
+         * @return the number of records the ring can hold.
+         */
+        int getCapacity() const;
+
+    };
+
+}}}
+
+#endif /*_DECAF_UTIL_LOGGING_ASYNCHANDLER_H_*/
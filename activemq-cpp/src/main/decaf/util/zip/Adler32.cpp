@@ -46,7 +46,9 @@ long long Adler32::getValue() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 void Adler32::update(const std::vector<unsigned char>& buffer) {
-    this->update(&buffer[0], (int) buffer.size(), 0, (int) buffer.size());
+    if (!buffer.empty()) {
+        this->update(&buffer[0], (int) buffer.size(), 0, (int) buffer.size());
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,7 +58,8 @@ void Adler32::update(const std::vector<unsigned char>& buffer, int offset, int l
 
 ////////////////////////////////////////////////////////////////////////////////
 void Adler32::update(int byte) {
-    this->value = adler32((uLong) this->value, (const Bytef*) &byte, 1);
+    unsigned char value = (unsigned char) byte;
+    this->value = adler32((uLong) this->value, (const Bytef*) &value, 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -17,7 +17,12 @@
 
 #include "CRC32.h"
 
-#include <decaf/internal/util/zip/zlib.h>
+#include <decaf/lang/exceptions/IndexOutOfBoundsException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 using namespace decaf;
 using namespace decaf::lang;
@@ -25,6 +30,87 @@ using namespace decaf::lang::exceptions;
 using namespace decaf::util;
 using namespace decaf::util::zip;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // The reflected IEEE polynomial of the CRC-32 zlib and Java compute.
+    const unsigned int POLYNOMIAL = 0xEDB88320U;
+
+    // Tables for updating the CRC eight bytes at a time, table[k][n] is the CRC of the
+    // byte n followed by k zero bytes.
+    class Crc32Tables {
+    public:
+
+        unsigned int table[8][256];
+
+        Crc32Tables() {
+            for (unsigned int n = 0; n < 256; ++n) {
+                unsigned int crc = n;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 1) ? POLYNOMIAL ^ (crc >> 1) : crc >> 1;
+                }
+                table[0][n] = crc;
+            }
+
+            for (unsigned int n = 0; n < 256; ++n) {
+                for (int k = 1; k < 8; ++k) {
+                    table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xFF];
+                }
+            }
+        }
+    };
+
+#if !defined(__ARM_FEATURE_CRC32)
+    const Crc32Tables tables;
+
+    inline unsigned int loadLittleEndian(const unsigned char* data) {
+        return (unsigned int) data[0] | ((unsigned int) data[1] << 8) |
+               ((unsigned int) data[2] << 16) | ((unsigned int) data[3] << 24);
+    }
+#endif
+
+    unsigned int updateCrc(unsigned int crc, const unsigned char* data, std::size_t length) {
+
+        crc = ~crc;
+
+#if defined(__ARM_FEATURE_CRC32)
+
+        // ARMv8 computes this polynomial in a single instruction per word.
+        for (; length >= 8; data += 8, length -= 8) {
+            unsigned long long word = 0;
+            for (int i = 7; i >= 0; --i) {
+                word = (word << 8) | data[i];
+            }
+            crc = __crc32d(crc, word);
+        }
+
+        for (; length > 0; ++data, --length) {
+            crc = __crc32b(crc, *data);
+        }
+
+#else
+
+        const unsigned int (*table)[256] = tables.table;
+
+        for (; length >= 8; data += 8, length -= 8) {
+            unsigned int one = crc ^ loadLittleEndian(data);
+            unsigned int two = loadLittleEndian(data + 4);
+            crc = table[7][one & 0xFF] ^ table[6][(one >> 8) & 0xFF] ^
+                  table[5][(one >> 16) & 0xFF] ^ table[4][one >> 24] ^
+                  table[3][two & 0xFF] ^ table[2][(two >> 8) & 0xFF] ^
+                  table[1][(two >> 16) & 0xFF] ^ table[0][two >> 24];
+        }
+
+        for (; length > 0; ++data, --length) {
+            crc = table[0][(crc ^ *data) & 0xFF] ^ (crc >> 8);
+        }
+
+#endif
+
+        return ~crc;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CRC32::CRC32() : Checksum(), value(0) {
     this->reset();
@@ -36,7 +122,7 @@ CRC32::~CRC32() {
 
 ////////////////////////////////////////////////////////////////////////////////
 void CRC32::reset() {
-    this->value = crc32((uLong) this->value, NULL, 0);
+    this->value = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,7 +132,9 @@ long long CRC32::getValue() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 void CRC32::update(const std::vector<unsigned char>& buffer) {
-    this->update(&buffer[0], (int) buffer.size(), 0, (int) buffer.size());
+    if (!buffer.empty()) {
+        this->update(&buffer[0], (int) buffer.size(), 0, (int) buffer.size());
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,21 +145,29 @@ void CRC32::update(const std::vector<unsigned char>& buffer, int offset, int len
             __FILE__, __LINE__, "Given offset + length exceeds the length of the buffer.");
     }
 
-    this->update(&buffer[0], (int) buffer.size(), offset, length);
+    if (length > 0) {
+        this->update(&buffer[0], (int) buffer.size(), offset, length);
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void CRC32::update(int byte) {
-    this->value = crc32((uLong) this->value, (const Bytef*) &byte, 1);
+    unsigned char value = (unsigned char) byte;
+    this->value = updateCrc((unsigned int) this->value, &value, 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void CRC32::update(const unsigned char* buffer, int size, int offset, int length) {
 
-    if (offset + length > size) {
+    if (offset < 0 || length < 0 || offset + length > size) {
         throw IndexOutOfBoundsException(
             __FILE__, __LINE__, "Given offset + length exceeds the length of the buffer.");
     }
 
-    this->value = crc32((uLong) this->value, (const Bytef*) (buffer + offset), (uInt) length);
+    if (buffer == NULL) {
+        throw NullPointerException(
+            __FILE__, __LINE__, "Buffer pointer passed was NULL.");
+    }
+
+    this->value = updateCrc((unsigned int) this->value, buffer + offset, (std::size_t) length);
 }
@@ -73,7 +73,7 @@ long long CheckedInputStream::skip(long long num) {
                 return skipped;
             }
 
-            this->sum->update(buffer, 0, remaining);
+            this->sum->update(buffer, 0, result);
 
             skipped += result;
             remaining = (num - skipped) > (long long) buffer.size() ? (int) buffer.size() : (int) (num - skipped);
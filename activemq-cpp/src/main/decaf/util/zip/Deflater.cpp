@@ -162,6 +162,10 @@ const int Deflater::DEFLATED = 0;
 const int Deflater::FILTERED = 1;
 const int Deflater::HUFFMAN_ONLY = 2;
 
+const int Deflater::NO_FLUSH = 0;
+const int Deflater::SYNC_FLUSH = 2;
+const int Deflater::FULL_FLUSH = 3;
+
 ////////////////////////////////////////////////////////////////////////////////
 Deflater::Deflater(int level, bool nowrap) : data(new DeflaterData()) {
 
@@ -343,9 +347,29 @@ bool Deflater::finished() const {
 
 ////////////////////////////////////////////////////////////////////////////////
 int Deflater::deflate(unsigned char* buffer, int size, int offset, int length) {
+    return this->deflate(buffer, size, offset, length, NO_FLUSH);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Deflater::deflate(unsigned char* buffer, int size, int offset, int length, int flush) {
 
     try {
 
+        int mode = Z_NO_FLUSH;
+        if (flush == SYNC_FLUSH) {
+            mode = Z_SYNC_FLUSH;
+        } else if (flush == FULL_FLUSH) {
+            mode = Z_FULL_FLUSH;
+        } else if (flush != NO_FLUSH) {
+            throw IllegalArgumentException(
+                __FILE__, __LINE__, "Invalid flush mode: %d.", flush);
+        }
+
+        // Finishing takes precedence over any flush the caller asks for.
+        if (this->data->flush == Z_FINISH) {
+            mode = Z_FINISH;
+        }
+
         if (buffer == NULL) {
             throw NullPointerException(
                 __FILE__, __LINE__, "Buffer passed cannot be NULL.");
@@ -377,7 +401,7 @@ int Deflater::deflate(unsigned char* buffer, int size, int offset, int length) {
         this->data->stream->avail_out = (uInt) length;
 
         // Call ZLib and then process the resulting data to figure out what happened.
-        int result = ::deflate(this->data->stream, this->data->flush);
+        int result = ::deflate(this->data->stream, mode);
 
         if (result == Z_STREAM_END) {
             this->data->finished = true;
@@ -388,6 +412,7 @@ int Deflater::deflate(unsigned char* buffer, int size, int offset, int length) {
     DECAF_CATCH_RETHROW(NullPointerException)
     DECAF_CATCH_RETHROW(IllegalStateException)
     DECAF_CATCH_RETHROW(IndexOutOfBoundsException)
+    DECAF_CATCH_RETHROW(IllegalArgumentException)
     DECAF_CATCHALL_THROW(IllegalStateException)
 }
 
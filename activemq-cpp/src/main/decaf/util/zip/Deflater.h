@@ -94,6 +94,25 @@ namespace zip {
          */
         static const int DEFAULT_STRATEGY;
 
+        /**
+         * Flush mode that lets the compressor decide how much data to accumulate
+         * before producing output, the default.
+         */
+        static const int NO_FLUSH;
+
+        /**
+         * Flush mode that writes out all pending output and aligns it on a byte
+         * boundary so that everything given so far can be inflated, the compression
+         * state is kept so later data still refers back to earlier data.
+         */
+        static const int SYNC_FLUSH;
+
+        /**
+         * Flush mode that does what SYNC_FLUSH does and also resets the compression
+         * state so that decompression can restart from this point.
+         */
+        static const int FULL_FLUSH;
+
     private:
 
         // Class internal data used during compression.
@@ -285,6 +304,33 @@ namespace zip {
          */
         int deflate(unsigned char* buffer, int size, int offset, int length);
 
+        /**
+         * Fills specified buffer with compressed data using the given flush mode. Returns
+         * actual number of bytes of compressed data.  With SYNC_FLUSH or FULL_FLUSH a
+         * return value equal to length means the buffer was too small to hold all of the
+         * flushed data and this method must be called again with the same flush mode.
+         * Once finish has been called the data is always finished instead of flushed.
+         *
+         * @param buffer
+         *      The Buffer to write the compressed data to.
+         * @param size
+         *      The size of the passed buffer.
+         * @param offset
+         *      The position in the Buffer to start writing at.
+         * @param length
+         *      The maximum number of byte of data to write.
+         * @param flush
+         *      One of NO_FLUSH, SYNC_FLUSH or FULL_FLUSH.
+         *
+         * @return the actual number of bytes of compressed data.
+         *
+         * @throws NullPointerException if buffer is NULL.
+         * @throws IndexOutOfBoundsException if the offset + length > size of the buffer.
+         * @throws IllegalArgumentException if the flush mode is not valid.
+         * @throws IllegalStateException if in the end state.
+         */
+        int deflate(unsigned char* buffer, int size, int offset, int length, int flush);
+
         /**
          * Fills specified buffer with compressed data. Returns actual number of bytes of
          * compressed data. A return value of 0 indicates that needsInput() should be called
@@ -29,14 +29,14 @@ const std::size_t DeflaterOutputStream::DEFAULT_BUFFER_SIZE = 512;
 
 ////////////////////////////////////////////////////////////////////////////////
 DeflaterOutputStream::DeflaterOutputStream(OutputStream* outputStream, bool own) :
-    FilterOutputStream(outputStream, own), deflater(new Deflater()), buf(), ownDeflater(true), isDone(false) {
+    FilterOutputStream(outputStream, own), deflater(new Deflater()), buf(), ownDeflater(true), isDone(false), syncFlush(false) {
 
     this->buf.resize(DEFAULT_BUFFER_SIZE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 DeflaterOutputStream::DeflaterOutputStream(OutputStream* outputStream, Deflater* deflater, bool own, bool ownDeflater) :
-    FilterOutputStream(outputStream, own), deflater(deflater), buf(), ownDeflater(ownDeflater), isDone(false) {
+    FilterOutputStream(outputStream, own), deflater(deflater), buf(), ownDeflater(ownDeflater), isDone(false), syncFlush(false) {
 
     if (deflater == NULL) {
         throw NullPointerException(
@@ -47,8 +47,9 @@ DeflaterOutputStream::DeflaterOutputStream(OutputStream* outputStream, Deflater*
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-DeflaterOutputStream::DeflaterOutputStream(OutputStream* outputStream, Deflater* deflater, int bufferSize, bool own, bool ownDeflater) :
-    FilterOutputStream(outputStream, own), deflater(deflater), buf(), ownDeflater(ownDeflater), isDone(false) {
+DeflaterOutputStream::DeflaterOutputStream(OutputStream* outputStream, Deflater* deflater, int bufferSize,
+                                           bool own, bool ownDeflater, bool syncFlush) :
+    FilterOutputStream(outputStream, own), deflater(deflater), buf(), ownDeflater(ownDeflater), isDone(false), syncFlush(syncFlush) {
 
     if (deflater == NULL) {
         throw NullPointerException(
@@ -108,16 +109,51 @@ void DeflaterOutputStream::close() {
 
     try {
 
+        if (this->isClosed()) {
+            return;
+        }
+
         if (!this->deflater->finished()) {
             this->finish();
         }
-        this->deflater->end();
+
+        // A Deflater supplied by the caller is left for it to reset and reuse.
+        if (this->ownDeflater) {
+            this->deflater->end();
+        }
+
         FilterOutputStream::close();
     }
     DECAF_CATCH_RETHROW(IOException)
     DECAF_CATCHALL_THROW(IOException)
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void DeflaterOutputStream::flush() {
+
+    try {
+
+        if (isClosed()) {
+            throw IOException(
+                __FILE__, __LINE__, "The stream is already closed.");
+        }
+
+        if (this->syncFlush && !this->isDone) {
+
+            // A full buffer means the Deflater may still hold flushed data.
+            int result;
+            do {
+                result = this->deflater->deflate(&buf[0], (int) buf.size(), 0, (int) buf.size(), Deflater::SYNC_FLUSH);
+                this->outputStream->write(&buf[0], (int) buf.size(), 0, result);
+            } while (result == (int) buf.size());
+        }
+
+        this->outputStream->flush();
+    }
+    DECAF_CATCH_RETHROW(IOException)
+    DECAF_CATCHALL_THROW(IOException)
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void DeflaterOutputStream::doWriteByte(unsigned char value) {
 
@@ -51,6 +51,7 @@ namespace zip {
 
         bool ownDeflater;
         bool isDone;
+        bool syncFlush;
 
         static const std::size_t DEFAULT_BUFFER_SIZE;
 
@@ -107,12 +108,17 @@ namespace zip {
          *      Should this filter take ownership of the OutputStream pointer (default is false).
          * @param ownDeflater
          *      Should the filter take ownership of the passed Deflater object (default is false).
+         * @param syncFlush
+         *      If true flush writes out everything compressed so far with the Deflater's
+         *      SYNC_FLUSH mode before flushing the wrapped stream, so a reader can inflate
+         *      all of it without waiting for more (default is false).
          *
          * @throws NullPointerException if the Deflater given is NULL.
          * @throws IllegalArgumentException if bufferSize is 0.
          */
         DeflaterOutputStream(decaf::io::OutputStream* outputStream, Deflater* deflater,
-                             int bufferSize, bool own = false, bool ownDeflater = false);
+                             int bufferSize, bool own = false, bool ownDeflater = false,
+                             bool syncFlush = false);
 
         virtual ~DeflaterOutputStream();
 
@@ -131,6 +137,14 @@ namespace zip {
          */
         virtual void close();
 
+        /**
+         * {@inheritDoc}
+         *
+         * When the stream was created with syncFlush set the data compressed so far is
+         * written out first, otherwise only the wrapped stream is flushed.
+         */
+        virtual void flush();
+
     protected:
 
         virtual void doWriteByte(unsigned char value);
@@ -134,7 +134,12 @@ void InflaterInputStream::close() {
     try {
 
         if (!isClosed()) {
-            inflater->end();
+
+            // An Inflater supplied by the caller is left for it to reset and reuse.
+            if (this->ownInflater) {
+                inflater->end();
+            }
+
             this->atEOF = true;
             FilterInputStream::close();
         }
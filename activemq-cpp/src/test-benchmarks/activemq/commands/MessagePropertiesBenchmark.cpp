@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessagePropertiesBenchmark.h"
+
+#include <benchmark/BenchmarkResults.h>
+
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/System.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace benchmark;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::util;
+using namespace activemq::wireformat::openwire::marshal;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ROUNDS = 1000;
+    const int NUM_PROPERTIES = 16;
+
+    void receive( ActiveMQTextMessage& message, const std::vector<unsigned char>& properties ) {
+        message.setMarshalledProperties( properties );
+        message.afterUnmarshal( NULL );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagePropertiesBenchmark::MessagePropertiesBenchmark() : marshaledProperties(), nanos(), operations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MessagePropertiesBenchmark::~MessagePropertiesBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagePropertiesBenchmark::setUp() {
+
+    // Roughly what a market data feed puts on each message.
+    PrimitiveMap properties;
+    properties.setString( "symbol", "ACME" );
+    properties.setDouble( "bid", 101.25 );
+    properties.setDouble( "ask", 101.5 );
+    properties.setLong( "sequence", 1234567890LL );
+    for( int i = properties.size(); i < NUM_PROPERTIES; ++i ) {
+        properties.setString( "field" + Integer::toString( i ), "value" + Integer::toString( i ) );
+    }
+
+    this->marshaledProperties.clear();
+    PrimitiveTypesMarshaller::marshal( &properties, this->marshaledProperties );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagePropertiesBenchmark::run() {
+
+    long long start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        PrimitiveMap map;
+        PrimitiveTypesMarshaller::unmarshal( &map, this->marshaledProperties );
+        CPPUNIT_ASSERT( map.getString( "symbol" ) == "ACME" );
+    }
+    this->nanos["decodeAll"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        ActiveMQTextMessage message;
+        receive( message, this->marshaledProperties );
+    }
+    this->nanos["receiveOnly"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        ActiveMQTextMessage message;
+        receive( message, this->marshaledProperties );
+        CPPUNIT_ASSERT( message.getStringProperty( "symbol" ) == "ACME" );
+    }
+    this->nanos["readOne"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        ActiveMQTextMessage message;
+        receive( message, this->marshaledProperties );
+        std::vector<std::string> names = message.getPropertyNames();
+        for( std::size_t j = 0; j < names.size(); ++j ) {
+            message.getStringProperty( names[j] );
+        }
+    }
+    this->nanos["readAll"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        ActiveMQTextMessage message;
+        receive( message, this->marshaledProperties );
+        message.beforeMarshal( NULL );
+    }
+    this->nanos["forward"] += System::nanoTime() - start;
+
+    this->operations += ROUNDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessagePropertiesBenchmark::publishResults() {
+
+    std::map< std::string, long long >::const_iterator iter = this->nanos.begin();
+    for( ; iter != this->nanos.end(); ++iter ) {
+
+        double perOperation = (double) iter->second / (double) this->operations;
+        BenchmarkResults::record( "MessageProperties", iter->first, perOperation, "ns/op" );
+
+        std::cout << "MessageProperties " << iter->first << " = "
+                  << perOperation << " ns/op" << std::endl;
+    }
+}
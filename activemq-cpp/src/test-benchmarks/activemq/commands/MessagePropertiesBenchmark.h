@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_COMMANDS_MESSAGEPROPERTIESBENCHMARK_H_
+#define _ACTIVEMQ_COMMANDS_MESSAGEPROPERTIESBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+
+#include <activemq/commands/Message.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq{
+namespace commands{
+
+    /**
+     * Measures what a consumer pays for the properties of a received message,
+     * from decoding all of them up front as a plain PrimitiveMap does through
+     * to reading a single property or forwarding the message untouched.
+     */
+    class MessagePropertiesBenchmark :
+        public benchmark::BenchmarkBase<
+            activemq::commands::MessagePropertiesBenchmark, Message, 10 >
+    {
+    private:
+
+        std::vector<unsigned char> marshaledProperties;
+        std::map< std::string, long long > nanos;
+        long long operations;
+
+    public:
+
+        MessagePropertiesBenchmark();
+        virtual ~MessagePropertiesBenchmark();
+
+        void setUp();
+        void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_COMMANDS_MESSAGEPROPERTIESBENCHMARK_H_*/
@@ -0,0 +1,182 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ActiveMQConsumerBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkResults.h>
+
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <decaf/lang/System.h>
+
+using namespace std;
+using namespace benchmark;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::transport::mock;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ROUNDS = 500;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQConsumerBenchmark::LatencyListener::LatencyListener( LatencyHistogram& histogram ) :
+    histogram( histogram ), delivered( 0 ), dispatchTime( 0 ) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQConsumerBenchmark::LatencyListener::~LatencyListener() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerBenchmark::LatencyListener::onMessage( const cms::Message* message AMQCPP_UNUSED ) {
+    histogram.record( System::nanoTime() - dispatchTime );
+    delivered.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQConsumerBenchmark::ActiveMQConsumerBenchmark() :
+    connection(), transport( NULL ), syncSession(), asyncSession(), syncDestination(),
+    asyncDestination(), syncConsumer(), asyncConsumer(), receiveLatency(),
+    listenerLatency(), listener(), sequenceId(0), messagesReceived(0), allocations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQConsumerBenchmark::~ActiveMQConsumerBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerBenchmark::setUp() {
+
+    ActiveMQConnectionFactory factory( "mock://127.0.0.1:12345?wireFormat=openwire" );
+
+    connection.reset( dynamic_cast<ActiveMQConnection*>( factory.createConnection() ) );
+
+    // The mock transport is used to inject the dispatches as the broker would.
+    transport = dynamic_cast<MockTransport*>(
+        connection->getTransport().narrow( typeid( MockTransport ) ) );
+
+    connection->start();
+
+    syncSession.reset( connection->createSession( cms::Session::AUTO_ACKNOWLEDGE ) );
+    syncDestination.reset( syncSession->createQueue( "BENCHMARK.RECEIVE" ) );
+    syncConsumer.reset( syncSession->createConsumer( syncDestination.get() ) );
+
+    listener.reset( new LatencyListener( listenerLatency ) );
+
+    asyncSession.reset( connection->createSession( cms::Session::AUTO_ACKNOWLEDGE ) );
+    asyncDestination.reset( asyncSession->createQueue( "BENCHMARK.LISTENER" ) );
+    asyncConsumer.reset( asyncSession->createConsumer( asyncDestination.get() ) );
+    asyncConsumer->setMessageListener( listener.get() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerBenchmark::tearDown() {
+
+    if( connection.get() != NULL ) {
+        connection->close();
+    }
+
+    asyncConsumer.reset( NULL );
+    syncConsumer.reset( NULL );
+    asyncDestination.reset( NULL );
+    syncDestination.reset( NULL );
+    asyncSession.reset( NULL );
+    syncSession.reset( NULL );
+    listener.reset( NULL );
+    transport = NULL;
+    connection.reset( NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Pointer<MessageDispatch> ActiveMQConsumerBenchmark::createDispatch(
+    const cms::Destination* destination, const cms::MessageConsumer* consumer ) {
+
+    const Pointer<ConsumerId>& consumerId =
+        dynamic_cast<const ActiveMQConsumer*>( consumer )->getConsumerId();
+
+    Pointer<ProducerId> producerId( new ProducerId() );
+    producerId->setConnectionId( consumerId->getConnectionId() );
+    producerId->setSessionId( consumerId->getSessionId() );
+    producerId->setValue( 1 );
+
+    // Each message gets its own sequence id so none look like duplicates.
+    Pointer<MessageId> messageId( new MessageId() );
+    messageId->setProducerId( producerId );
+    messageId->setProducerSequenceId( ++sequenceId );
+
+    Pointer<ActiveMQTextMessage> message( new ActiveMQTextMessage() );
+    message->setText( std::string( 1024, 'a' ) );
+    message->setCMSDestination( destination );
+    message->setMessageId( messageId );
+
+    Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+    dispatch->setMessage( message );
+    dispatch->setConsumerId( Pointer<ConsumerId>( consumerId->cloneDataStructure() ) );
+
+    return dispatch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerBenchmark::run() {
+
+    for( int i = 0; i < ROUNDS; ++i ) {
+        Pointer<MessageDispatch> dispatch = createDispatch( syncDestination.get(), syncConsumer.get() );
+
+        AllocationCounter::start();
+        long long start = System::nanoTime();
+        transport->fireCommand( dispatch );
+        std::auto_ptr<cms::Message> message( syncConsumer->receive() );
+        receiveLatency.record( System::nanoTime() - start );
+        AllocationCounter::stop();
+
+        allocations += AllocationCounter::getAllocations();
+    }
+
+    for( int i = 0; i < ROUNDS; ++i ) {
+        Pointer<MessageDispatch> dispatch = createDispatch( asyncDestination.get(), asyncConsumer.get() );
+
+        listener->dispatchTime = System::nanoTime();
+        transport->fireCommand( dispatch );
+        listener->awaitDelivery();
+    }
+
+    messagesReceived += ROUNDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConsumerBenchmark::publishResults() {
+
+    const std::string name = "ActiveMQConsumer";
+
+    receiveLatency.publish( name, "receive.latency" );
+    listenerLatency.publish( name, "listener.latency" );
+
+    if( messagesReceived > 0 ) {
+        BenchmarkResults::record( name, "receive.allocations",
+                                  (double) allocations / (double) messagesReceived, "allocs/msg" );
+    }
+}
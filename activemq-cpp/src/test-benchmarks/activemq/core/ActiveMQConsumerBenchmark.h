@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACTIVEMQCONSUMERBENCHMARK_H_
+#define _ACTIVEMQ_CORE_ACTIVEMQCONSUMERBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQConsumer.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <cms/MessageListener.h>
+#include <cms/Session.h>
+#include <decaf/util/concurrent/Semaphore.h>
+
+#include <memory>
+
+namespace activemq{
+namespace core{
+
+    /**
+     * Measures the time from a MessageDispatch arriving at the connection until
+     * the message is handed to the application, both by MessageConsumer::receive
+     * and by a MessageListener.  The dispatches are injected with the mock
+     * transport so that the results show only the time spent in the client.
+     */
+    class ActiveMQConsumerBenchmark :
+        public benchmark::BenchmarkBase<
+            activemq::core::ActiveMQConsumerBenchmark, ActiveMQConsumer, 10 >
+    {
+    private:
+
+        class LatencyListener : public cms::MessageListener {
+        private:
+
+            benchmark::LatencyHistogram& histogram;
+            decaf::util::concurrent::Semaphore delivered;
+
+        public:
+
+            volatile long long dispatchTime;
+
+        public:
+
+            LatencyListener( benchmark::LatencyHistogram& histogram );
+            virtual ~LatencyListener();
+
+            virtual void onMessage( const cms::Message* message );
+
+            void awaitDelivery() {
+                delivered.acquire();
+            }
+        };
+
+    private:
+
+        std::auto_ptr<ActiveMQConnection> connection;
+        transport::mock::MockTransport* transport;
+        std::auto_ptr<cms::Session> syncSession;
+        std::auto_ptr<cms::Session> asyncSession;
+        std::auto_ptr<cms::Destination> syncDestination;
+        std::auto_ptr<cms::Destination> asyncDestination;
+        std::auto_ptr<cms::MessageConsumer> syncConsumer;
+        std::auto_ptr<cms::MessageConsumer> asyncConsumer;
+
+        benchmark::LatencyHistogram receiveLatency;
+        benchmark::LatencyHistogram listenerLatency;
+        std::auto_ptr<LatencyListener> listener;
+
+        long long sequenceId;
+        long long messagesReceived;
+        long long allocations;
+
+    public:
+
+        ActiveMQConsumerBenchmark();
+        virtual ~ActiveMQConsumerBenchmark();
+
+        void setUp();
+        void tearDown();
+        void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        decaf::lang::Pointer<commands::MessageDispatch> createDispatch(
+            const cms::Destination* destination, const cms::MessageConsumer* consumer );
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_CORE_ACTIVEMQCONSUMERBENCHMARK_H_*/
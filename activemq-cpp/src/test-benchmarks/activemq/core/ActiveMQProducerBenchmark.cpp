@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ActiveMQProducerBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkResults.h>
+
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <cms/DeliveryMode.h>
+#include <decaf/lang/System.h>
+
+using namespace std;
+using namespace benchmark;
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ROUNDS = 500;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQProducerBenchmark::ActiveMQProducerBenchmark() :
+    connection(), session(), destination(), producer(), message(),
+    persistentLatency(), nonPersistentLatency(), messagesSent(0),
+    persistentNanos(0), nonPersistentNanos(0), allocations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ActiveMQProducerBenchmark::~ActiveMQProducerBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerBenchmark::setUp() {
+
+    ActiveMQConnectionFactory factory( "mock://127.0.0.1:12345?wireFormat=openwire" );
+
+    connection.reset( dynamic_cast<ActiveMQConnection*>( factory.createConnection() ) );
+    connection->start();
+
+    session.reset( connection->createSession( cms::Session::AUTO_ACKNOWLEDGE ) );
+    destination.reset( session->createQueue( "BENCHMARK.PRODUCER" ) );
+    producer.reset( session->createProducer( destination.get() ) );
+    message.reset( session->createTextMessage( std::string( 1024, 'a' ) ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerBenchmark::tearDown() {
+
+    message.reset( NULL );
+    producer.reset( NULL );
+    destination.reset( NULL );
+    session.reset( NULL );
+
+    if( connection.get() != NULL ) {
+        connection->close();
+        connection.reset( NULL );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerBenchmark::run() {
+
+    AllocationCounter::start();
+    nonPersistentNanos += sendMessages( cms::DeliveryMode::NON_PERSISTENT, nonPersistentLatency );
+    persistentNanos += sendMessages( cms::DeliveryMode::PERSISTENT, persistentLatency );
+    AllocationCounter::stop();
+
+    allocations += AllocationCounter::getAllocations();
+    messagesSent += 2 * ROUNDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long ActiveMQProducerBenchmark::sendMessages( int deliveryMode, LatencyHistogram& histogram ) {
+
+    producer->setDeliveryMode( deliveryMode );
+
+    long long total = 0;
+    for( int i = 0; i < ROUNDS; ++i ) {
+        long long start = System::nanoTime();
+        producer->send( message.get() );
+        long long elapsed = System::nanoTime() - start;
+
+        histogram.record( elapsed );
+        total += elapsed;
+    }
+
+    return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQProducerBenchmark::publishResults() {
+
+    const std::string name = "ActiveMQProducer.send";
+    const double perMode = (double) messagesSent / 2.0;
+
+    if( nonPersistentNanos > 0 ) {
+        BenchmarkResults::record( name, "nonPersistent.throughput",
+                                  perMode * 1e9 / (double) nonPersistentNanos, "msgs/s" );
+    }
+    if( persistentNanos > 0 ) {
+        BenchmarkResults::record( name, "persistent.throughput",
+                                  perMode * 1e9 / (double) persistentNanos, "msgs/s" );
+    }
+
+    nonPersistentLatency.publish( name, "nonPersistent.latency" );
+    persistentLatency.publish( name, "persistent.latency" );
+
+    BenchmarkResults::record( name, "allocations",
+                              (double) allocations / (double) messagesSent, "allocs/msg" );
+}
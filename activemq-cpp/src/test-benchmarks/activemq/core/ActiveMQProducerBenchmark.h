@@ -0,0 +1,80 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_CORE_ACTIVEMQPRODUCERBENCHMARK_H_
+#define _ACTIVEMQ_CORE_ACTIVEMQPRODUCERBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <benchmark/LatencyHistogram.h>
+
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQProducer.h>
+#include <cms/Session.h>
+#include <cms/TextMessage.h>
+
+#include <memory>
+
+namespace activemq{
+namespace core{
+
+    /**
+     * Measures the cost of MessageProducer::send over the mock transport, which
+     * answers a send that needs a response straight away, so the results show
+     * the time spent in the client and its marshalling rather than the network.
+     */
+    class ActiveMQProducerBenchmark :
+        public benchmark::BenchmarkBase<
+            activemq::core::ActiveMQProducerBenchmark, ActiveMQProducer, 10 >
+    {
+    private:
+
+        std::auto_ptr<ActiveMQConnection> connection;
+        std::auto_ptr<cms::Session> session;
+        std::auto_ptr<cms::Destination> destination;
+        std::auto_ptr<cms::MessageProducer> producer;
+        std::auto_ptr<cms::TextMessage> message;
+
+        benchmark::LatencyHistogram persistentLatency;
+        benchmark::LatencyHistogram nonPersistentLatency;
+
+        long long messagesSent;
+        long long persistentNanos;
+        long long nonPersistentNanos;
+        long long allocations;
+
+    public:
+
+        ActiveMQProducerBenchmark();
+        virtual ~ActiveMQProducerBenchmark();
+
+        void setUp();
+        void tearDown();
+        void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        long long sendMessages( int deliveryMode, benchmark::LatencyHistogram& histogram );
+
+    };
+
+}}
+
+#endif /*_ACTIVEMQ_CORE_ACTIVEMQPRODUCERBENCHMARK_H_*/
@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenWireFormatBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkResults.h>
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQMapMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/ProducerInfo.h>
+#include <activemq/core/ActiveMQConstants.h>
+#include <activemq/transport/IOTransport.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/lang/System.h>
+#include <decaf/util/Properties.h>
+
+using namespace std;
+using namespace benchmark;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::transport;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ROUNDS = 1000;
+
+    template< typename T >
+    Pointer<T> createMessage( const Pointer<ProducerId>& producerId,
+                              const Pointer<ActiveMQDestination>& destination ) {
+
+        Pointer<MessageId> messageId( new MessageId() );
+        messageId->setProducerId( producerId );
+        messageId->setProducerSequenceId( 1 );
+
+        Pointer<T> message( new T() );
+        message->setProducerId( producerId );
+        message->setMessageId( messageId );
+        message->setDestination( destination );
+        message->setTimestamp( System::currentTimeMillis() );
+
+        return message;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFormatBenchmark::OpenWireFormatBenchmark() : commands(), measurements() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenWireFormatBenchmark::~OpenWireFormatBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::setUp() {
+
+    Pointer<ProducerId> producerId( new ProducerId() );
+    producerId->setConnectionId( "ID:benchmark-connection:1" );
+    producerId->setSessionId( 1 );
+    producerId->setValue( 1 );
+
+    Pointer<ConsumerId> consumerId( new ConsumerId() );
+    consumerId->setConnectionId( "ID:benchmark-connection:1" );
+    consumerId->setSessionId( 1 );
+    consumerId->setValue( 1 );
+
+    Pointer<ActiveMQDestination> destination( new ActiveMQQueue( "BENCHMARK.QUEUE" ) );
+
+    std::string text( 1024, 'a' );
+    std::vector<unsigned char> bytes( 1024, 'a' );
+
+    Pointer<ActiveMQTextMessage> textMessage =
+        createMessage<ActiveMQTextMessage>( producerId, destination );
+    textMessage->setText( text );
+
+    Pointer<ActiveMQBytesMessage> bytesMessage =
+        createMessage<ActiveMQBytesMessage>( producerId, destination );
+    bytesMessage->writeBytes( bytes );
+    bytesMessage->reset();
+
+    Pointer<ActiveMQMapMessage> mapMessage =
+        createMessage<ActiveMQMapMessage>( producerId, destination );
+    mapMessage->setString( "STRING", text );
+    mapMessage->setInt( "INT", 54275482 );
+    mapMessage->setLong( "LONG", 0xFFFFFFFFLL );
+    mapMessage->setBoolean( "BOOL", true );
+
+    Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+    dispatch->setConsumerId( consumerId );
+    dispatch->setDestination( destination );
+    dispatch->setMessage( textMessage );
+
+    Pointer<MessageAck> ack( new MessageAck() );
+    ack->setAckType( ActiveMQConstants::ACK_TYPE_CONSUMED );
+    ack->setConsumerId( consumerId );
+    ack->setDestination( destination );
+    ack->setFirstMessageId( textMessage->getMessageId() );
+    ack->setLastMessageId( textMessage->getMessageId() );
+    ack->setMessageCount( 1 );
+
+    Pointer<ProducerInfo> producerInfo( new ProducerInfo() );
+    producerInfo->setProducerId( producerId );
+    producerInfo->setDestination( destination );
+    producerInfo->setResponseRequired( true );
+
+    commands.push_back( std::make_pair( std::string( "TextMessage" ), textMessage.dynamicCast<Command>() ) );
+    commands.push_back( std::make_pair( std::string( "BytesMessage" ), bytesMessage.dynamicCast<Command>() ) );
+    commands.push_back( std::make_pair( std::string( "MapMessage" ), mapMessage.dynamicCast<Command>() ) );
+    commands.push_back( std::make_pair( std::string( "MessageDispatch" ), dispatch.dynamicCast<Command>() ) );
+    commands.push_back( std::make_pair( std::string( "MessageAck" ), ack.dynamicCast<Command>() ) );
+    commands.push_back( std::make_pair( std::string( "ProducerInfo" ), producerInfo.dynamicCast<Command>() ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::tearDown() {
+    commands.clear();
+    measurements.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::run() {
+
+    std::vector< std::pair< std::string, Pointer<Command> > >::const_iterator iter = commands.begin();
+    for( ; iter != commands.end(); ++iter ) {
+        runCommand( iter->first + ".loose", iter->second, false );
+        runCommand( iter->first + ".tight", iter->second, true );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::runCommand( const std::string& name,
+                                          const Pointer<Command>& command,
+                                          bool tightEncoding ) {
+
+    // Each pass uses a new pair of wire formats so that every pass starts with
+    // empty marshal caches, the same as a newly opened connection.
+    Properties properties;
+    OpenWireFormat writer( properties );
+    writer.setVersion( OpenWireFormat::MAX_SUPPORTED_VERSION );
+    writer.setTightEncodingEnabled( tightEncoding );
+
+    OpenWireFormat reader( properties );
+    reader.setVersion( OpenWireFormat::MAX_SUPPORTED_VERSION );
+    reader.setTightEncodingEnabled( tightEncoding );
+
+    IOTransport transport;
+    Measurement& measurement = measurements[name];
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut( &bytesOut );
+
+    AllocationCounter::start();
+    long long start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        writer.marshal( command, &transport, &dataOut );
+    }
+    measurement.marshalNanos += System::nanoTime() - start;
+    AllocationCounter::stop();
+    measurement.marshalAllocations += AllocationCounter::getAllocations();
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    measurement.bytes += array.second;
+
+    ByteArrayInputStream bytesIn( array.first, array.second, true );
+    DataInputStream dataIn( &bytesIn );
+
+    AllocationCounter::start();
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        reader.unmarshal( &transport, &dataIn );
+    }
+    measurement.unmarshalNanos += System::nanoTime() - start;
+    AllocationCounter::stop();
+    measurement.unmarshalAllocations += AllocationCounter::getAllocations();
+
+    measurement.operations += ROUNDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatBenchmark::publishResults() {
+
+    std::map< std::string, Measurement >::const_iterator iter = measurements.begin();
+    for( ; iter != measurements.end(); ++iter ) {
+
+        const std::string name = "OpenWireFormat." + iter->first;
+        const Measurement& measurement = iter->second;
+        double operations = (double) measurement.operations;
+
+        double marshalNanos = (double) measurement.marshalNanos / operations;
+        double unmarshalNanos = (double) measurement.unmarshalNanos / operations;
+
+        BenchmarkResults::record( name, "marshal", marshalNanos, "ns/op" );
+        BenchmarkResults::record( name, "unmarshal", unmarshalNanos, "ns/op" );
+        BenchmarkResults::record( name, "marshal.allocations",
+                                  (double) measurement.marshalAllocations / operations, "allocs/op" );
+        BenchmarkResults::record( name, "unmarshal.allocations",
+                                  (double) measurement.unmarshalAllocations / operations, "allocs/op" );
+        BenchmarkResults::record( name, "size", (double) measurement.bytes / operations, "bytes/op" );
+
+        std::cout << name << ": marshal = " << marshalNanos << " ns, unmarshal = "
+                  << unmarshalNanos << " ns" << std::endl;
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_
+#define _ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/commands/Command.h>
+#include <decaf/lang/Pointer.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace activemq{
+namespace wireformat{
+namespace openwire{
+
+    /**
+     * Measures the time taken to marshal and unmarshal the commands that make up
+     * most of the traffic between a client and the broker, using both the loose
+     * and the tight encodings.
+     */
+    class OpenWireFormatBenchmark :
+        public benchmark::BenchmarkBase<
+            activemq::wireformat::openwire::OpenWireFormatBenchmark, OpenWireFormat, 10 >
+    {
+    private:
+
+        struct Measurement {
+            long long operations;
+            long long marshalNanos;
+            long long unmarshalNanos;
+            long long marshalAllocations;
+            long long unmarshalAllocations;
+            long long bytes;
+
+            Measurement() : operations(0), marshalNanos(0), unmarshalNanos(0),
+                            marshalAllocations(0), unmarshalAllocations(0), bytes(0) {}
+        };
+
+        std::vector< std::pair< std::string, decaf::lang::Pointer<commands::Command> > > commands;
+        std::map< std::string, Measurement > measurements;
+
+    public:
+
+        OpenWireFormatBenchmark();
+        virtual ~OpenWireFormatBenchmark();
+
+        void setUp();
+        void tearDown();
+        void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        void runCommand( const std::string& name,
+                         const decaf::lang::Pointer<commands::Command>& command,
+                         bool tightEncoding );
+
+    };
+
+}}}
+
+#endif /*_ACTIVEMQ_WIREFORMAT_OPENWIRE_OPENWIREFORMATBENCHMARK_H_*/
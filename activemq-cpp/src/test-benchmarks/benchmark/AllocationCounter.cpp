@@ -0,0 +1,83 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AllocationCounter.h"
+
+#include <decaf/internal/util/concurrent/Atomics.h>
+
+#include <cstdlib>
+#include <new>
+
+using namespace benchmark;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    volatile int counting = 0;
+    volatile int allocations = 0;
+
+    void* countedAllocation( std::size_t size ) {
+
+        if( counting != 0 ) {
+            Atomics::incrementAndGet( &allocations );
+        }
+
+        void* block = std::malloc( size == 0 ? 1 : size );
+        if( block == NULL ) {
+            throw std::bad_alloc();
+        }
+
+        return block;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size ) throw( std::bad_alloc ) {
+    return countedAllocation( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size ) throw( std::bad_alloc ) {
+    return countedAllocation( size );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete( void* block ) throw() {
+    std::free( block );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* block ) throw() {
+    std::free( block );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AllocationCounter::start() {
+    Atomics::getAndSet( &allocations, 0 );
+    Atomics::getAndSet( &counting, 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AllocationCounter::stop() {
+    Atomics::getAndSet( &counting, 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long AllocationCounter::getAllocations() {
+    return allocations;
+}
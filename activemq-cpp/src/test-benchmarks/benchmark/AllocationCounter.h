@@ -0,0 +1,58 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_ALLOCATIONCOUNTER_H_
+#define _BENCHMARK_ALLOCATIONCOUNTER_H_
+
+namespace benchmark{
+
+    /**
+     * Counts the calls made to the global operator new while counting is enabled,
+     * the benchmark executable replaces the global allocation functions so that
+     * allocations made from every thread in the library are seen.
+     *
+     * Counting should only be enabled after the library has been initialized as
+     * the counters are updated atomically using the decaf Atomics.
+     */
+    class AllocationCounter {
+    private:
+
+        AllocationCounter();
+
+    public:
+
+        /**
+         * Clears the counters and starts counting allocations.
+         */
+        static void start();
+
+        /**
+         * Stops counting allocations, the counters keep their values until the
+         * next call to start.
+         */
+        static void stop();
+
+        /**
+         * @return the number of allocations made while counting was enabled.
+         */
+        static long long getAllocations();
+
+    };
+
+}
+
+#endif /*_BENCHMARK_ALLOCATIONCOUNTER_H_*/
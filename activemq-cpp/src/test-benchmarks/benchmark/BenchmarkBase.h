@@ -21,12 +21,33 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
 #include <benchmark/PerformanceTimer.h>
+#include <benchmark/BenchmarkResults.h>
+#include <benchmark/BenchmarkSettings.h>
+#include <benchmark/CpuCounters.h>
 #include <string>
+#include <sstream>
+#include <vector>
 #include <iostream>
+#include <typeinfo>
 
 namespace benchmark{
 
+    /**
+     * Base of the benchmarks, runs the benchmark's run() method a number of times
+     * untimed to warm up and then times each of a number of runs.  The counts, a
+     * time budget, the number of threads and whether the CPU counters are read come
+     * from the BenchmarkSettings, by default ITERATIONS runs are timed on a single
+     * thread.
+     *
+     * With more than one thread each extra thread runs its own instance of the
+     * benchmark, set up and torn down as CppUnit would, so that every benchmark can
+     * be run contended without being written to share its state.  The times taken
+     * on all the threads are reported together.
+     */
     template < class NAME, class TARGET, int ITERATIONS = 100 >
     class BenchmarkBase : public decaf::lang::Runnable,
                           public CppUnit::TestFixture
@@ -37,28 +58,242 @@ namespace benchmark{
 
     private:
 
-        PerformanceTimer timer;
+        /**
+         * Times the runs made on one thread.  Run on its own thread the worker
+         * creates the instance of the benchmark it runs, the calling thread uses
+         * warmup and measure directly with the instance CppUnit set up.
+         */
+        class Worker : public decaf::lang::Runnable {
+        private:
+
+            decaf::util::concurrent::CountDownLatch* warmedUp;
+            decaf::util::concurrent::CountDownLatch* go;
+
+        public:
+
+            PerformanceTimer timer;
+            bool failed;
+
+        private:
+
+            Worker( const Worker& );
+            Worker& operator= ( const Worker& );
+
+        public:
+
+            Worker( decaf::util::concurrent::CountDownLatch* warmedUp,
+                    decaf::util::concurrent::CountDownLatch* go ) :
+                Runnable(), warmedUp( warmedUp ), go( go ), timer(), failed( false ) {}
+
+            virtual ~Worker() {}
+
+            void warmup( BenchmarkBase* benchmark ) {
+                int count = getWarmupIterations();
+                for( int i = 0; i < count; ++i ) {
+                    benchmark->run();
+                }
+            }
+
+            void measure( BenchmarkBase* benchmark ) {
+
+                int count = getIterations();
+                long long budget = BenchmarkSettings::getTimeBudget() * 1000000LL;
+                long long start = decaf::lang::System::nanoTime();
+
+                for( int i = 0; i < count; ++i ) {
+                    timer.start();
+                    benchmark->run();
+                    timer.stop();
+
+                    if( budget > 0 && decaf::lang::System::nanoTime() - start >= budget ) {
+                        break;
+                    }
+                }
+            }
+
+            virtual void run() {
+
+                NAME* fixture = NULL;
+                bool arrived = false;
+
+                try {
+
+                    fixture = new NAME();
+                    static_cast<CppUnit::TestFixture*>( fixture )->setUp();
+
+                    warmup( fixture );
+                    arrived = true;
+                    warmedUp->countDown();
+                    go->await();
+                    measure( fixture );
+
+                    static_cast<CppUnit::TestFixture*>( fixture )->tearDown();
+
+                } catch(...) {
+                    failed = true;
+                    if( !arrived ) {
+                        warmedUp->countDown();
+                    }
+                }
+
+                delete fixture;
+            }
+        };
 
     public:
 
-        BenchmarkBase() : timer() {}
+        BenchmarkBase() : Runnable(), CppUnit::TestFixture() {}
         virtual ~BenchmarkBase() {}
 
-        int getIterations() const {
-            return ITERATIONS;
+        /**
+         * @return the number of timed runs to make, ITERATIONS unless the settings
+         *         give another count.
+         */
+        static int getIterations() {
+            int iterations = BenchmarkSettings::getIterations();
+            return iterations > 0 ? iterations : ITERATIONS;
+        }
+
+        /**
+         * @return the number of untimed runs made first, a tenth of the timed runs
+         *         unless the settings give another count.
+         */
+        static int getWarmupIterations() {
+            int warmup = BenchmarkSettings::getWarmupIterations();
+            if( warmup >= 0 ) {
+                return warmup;
+            }
+
+            return getIterations() < 10 ? 1 : getIterations() / 10;
         }
 
         void runBenchmark(){
 
-            for( int i = 0; i < ITERATIONS; ++i ){
-                timer.start();
-                this->run();
-                timer.stop();
+            int threads = BenchmarkSettings::getThreads();
+
+            std::string name( typeid( TARGET ).name() );
+            if( threads > 1 ) {
+                std::ostringstream stream;
+                stream << name << "/threads:" << threads;
+                name = stream.str();
+            }
+
+            CpuCounters counters;
+            if( BenchmarkSettings::isCountersEnabled() ) {
+                counters.open();
             }
 
-            std::cout << typeid( TARGET ).name() << " Benchmark Time = "
+            // The extra threads all warm up before any of them is timed and the
+            // counters only count the timed runs.
+            decaf::util::concurrent::CountDownLatch warmedUp( threads );
+            decaf::util::concurrent::CountDownLatch go( 1 );
+
+            Worker self( &warmedUp, &go );
+            std::vector<Worker*> workers;
+            std::vector<decaf::lang::Thread*> running;
+
+            for( int i = 1; i < threads; ++i ) {
+                workers.push_back( new Worker( &warmedUp, &go ) );
+                running.push_back( new decaf::lang::Thread( workers.back() ) );
+                running.back()->start();
+            }
+
+            try {
+                self.warmup( this );
+            } catch(...) {
+                go.countDown();
+                joinAll( running, workers );
+                throw;
+            }
+
+            warmedUp.countDown();
+            warmedUp.await();
+
+            counters.start();
+            long long start = decaf::lang::System::nanoTime();
+            go.countDown();
+
+            try {
+                self.measure( this );
+            } catch(...) {
+                joinAll( running, workers );
+                throw;
+            }
+
+            PerformanceTimer& timer = self.timer;
+            bool failed = false;
+
+            for( std::size_t i = 0; i < running.size(); ++i ) {
+                running[i]->join();
+                timer.merge( workers[i]->timer );
+                failed = failed || workers[i]->failed;
+            }
+
+            long long elapsed = decaf::lang::System::nanoTime() - start;
+            counters.stop();
+            joinAll( running, workers );
+
+            CPPUNIT_ASSERT_MESSAGE( "A benchmark thread failed", !failed );
+
+            std::cout << name << " Benchmark Time = "
                       << timer.getAverageTime() << " Millisecs"
                       << std::endl;
+
+            std::cout << name << " Run Time (us): mean = " << timer.getMeanNanos() / 1000.0
+                      << " +/- " << timer.getConfidenceIntervalNanos() / 1000.0
+                      << ", p50 = " << (double) timer.getPercentileNanos( 0.50 ) / 1000.0
+                      << ", p99 = " << (double) timer.getPercentileNanos( 0.99 ) / 1000.0
+                      << ", runs = " << timer.getNumberOfRuns()
+                      << std::endl;
+
+            BenchmarkResults::record( name, "time", (double) timer.getAverageTime(), "ms" );
+            BenchmarkResults::record( name, "time.mean", timer.getMeanNanos(), "ns" );
+            BenchmarkResults::record( name, "time.stddev", timer.getStandardDeviationNanos(), "ns" );
+            BenchmarkResults::record( name, "time.ci95", timer.getConfidenceIntervalNanos(), "ns" );
+            BenchmarkResults::record( name, "time.min", (double) timer.getMinimumNanos(), "ns" );
+            BenchmarkResults::record( name, "time.p50", (double) timer.getPercentileNanos( 0.50 ), "ns" );
+            BenchmarkResults::record( name, "time.p90", (double) timer.getPercentileNanos( 0.90 ), "ns" );
+            BenchmarkResults::record( name, "time.p99", (double) timer.getPercentileNanos( 0.99 ), "ns" );
+            BenchmarkResults::record( name, "time.max", (double) timer.getMaximumNanos(), "ns" );
+            BenchmarkResults::record( name, "runs", (double) timer.getNumberOfRuns(), "runs" );
+
+            if( elapsed > 0 ) {
+                BenchmarkResults::record( name, "throughput",
+                    (double) timer.getNumberOfRuns() * 1000000000.0 / (double) elapsed, "runs/s" );
+            }
+
+            for( int i = 0; i < CpuCounters::NUM_COUNTERS; ++i ) {
+                CpuCounters::Counter counter = (CpuCounters::Counter) i;
+                if( counters.isAvailable( counter ) && timer.getNumberOfRuns() > 0 ) {
+                    BenchmarkResults::record( name, CpuCounters::getName( counter ),
+                        (double) counters.getValue( counter ) / (double) timer.getNumberOfRuns(),
+                        "per run" );
+                }
+            }
+
+            this->publishResults();
+        }
+
+    protected:
+
+        /**
+         * Called once all the iterations have run, benchmarks that measure more
+         * than the time taken by run() record their measurements here.
+         */
+        virtual void publishResults() {}
+
+    private:
+
+        static void joinAll( std::vector<decaf::lang::Thread*>& running, std::vector<Worker*>& workers ) {
+
+            for( std::size_t i = 0; i < running.size(); ++i ) {
+                running[i]->join();
+                delete running[i];
+                delete workers[i];
+            }
+
+            running.clear();
+            workers.clear();
         }
 
     };
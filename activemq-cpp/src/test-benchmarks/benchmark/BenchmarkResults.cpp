@@ -0,0 +1,107 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkResults.h"
+
+#include <cstdio>
+#include <ostream>
+
+using namespace std;
+using namespace benchmark;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    void writeJsonString( std::ostream& out, const std::string& value ) {
+
+        out << '"';
+        std::string::const_iterator iter = value.begin();
+        for( ; iter != value.end(); ++iter ) {
+            unsigned char ch = (unsigned char) *iter;
+            if( ch == '"' || ch == '\\' ) {
+                out << '\\' << *iter;
+            } else if( ch < 0x20 ) {
+                char escaped[8];
+                ::sprintf( escaped, "\\u%04x", ch );
+                out << escaped;
+            } else {
+                out << *iter;
+            }
+        }
+        out << '"';
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<BenchmarkResults::Result>& BenchmarkResults::results() {
+    static std::vector<Result> results;
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkResults::record( const std::string& benchmark, const std::string& metric,
+                               double value, const std::string& unit ) {
+
+    Result result;
+    result.benchmark = benchmark;
+    result.metric = metric;
+    result.value = value;
+    result.unit = unit;
+
+    results().push_back( result );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkResults::writeTo( std::ostream& out ) {
+
+    out << "benchmark,metric,value,unit" << std::endl;
+
+    std::vector<Result>::const_iterator iter = results().begin();
+    for( ; iter != results().end(); ++iter ) {
+        out << iter->benchmark << "," << iter->metric << ","
+            << iter->value << "," << iter->unit << std::endl;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkResults::writeJsonTo( std::ostream& out ) {
+
+    out << "[" << std::endl;
+
+    std::vector<Result>::const_iterator iter = results().begin();
+    for( ; iter != results().end(); ++iter ) {
+
+        out << "  {\"benchmark\": ";
+        writeJsonString( out, iter->benchmark );
+        out << ", \"metric\": ";
+        writeJsonString( out, iter->metric );
+        out << ", \"value\": ";
+
+        // Infinity and NaN have no JSON form, x - x is only zero for finite values.
+        if( iter->value - iter->value == 0 ) {
+            out << iter->value;
+        } else {
+            out << "null";
+        }
+
+        out << ", \"unit\": ";
+        writeJsonString( out, iter->unit );
+        out << "}" << ( iter + 1 != results().end() ? "," : "" ) << std::endl;
+    }
+
+    out << "]" << std::endl;
+}
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_BENCHMARKRESULTS_H_
+#define _BENCHMARK_BENCHMARKRESULTS_H_
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+namespace benchmark{
+
+    /**
+     * Collects the measurements taken by the benchmarks so that a run can be
+     * saved in a machine readable form and compared against earlier runs.  The
+     * results are written as CSV with one line per measurement in the form:
+     *
+     *   benchmark,metric,value,unit
+     *
+     * or as a JSON array holding an object with the same four fields for each
+     * measurement.
+     */
+    class BenchmarkResults {
+    private:
+
+        struct Result {
+            std::string benchmark;
+            std::string metric;
+            double value;
+            std::string unit;
+        };
+
+        static std::vector<Result>& results();
+
+    private:
+
+        BenchmarkResults();
+
+    public:
+
+        /**
+         * Records a single measurement.
+         *
+         * @param benchmark
+         *      The name of the benchmark that took the measurement.
+         * @param metric
+         *      The name of the value that was measured.
+         * @param value
+         *      The measured value.
+         * @param unit
+         *      The unit the value is given in, e.g. ms, ns or msgs/s.
+         */
+        static void record( const std::string& benchmark, const std::string& metric,
+                            double value, const std::string& unit );
+
+        /**
+         * Writes all the measurements recorded so far to the given stream.
+         *
+         * @param out
+         *      The stream to write the CSV formatted results to.
+         */
+        static void writeTo( std::ostream& out );
+
+        /**
+         * Writes all the measurements recorded so far to the given stream as JSON,
+         * a value that is not a finite number is written as null.
+         *
+         * @param out
+         *      The stream to write the JSON formatted results to.
+         */
+        static void writeJsonTo( std::ostream& out );
+
+    };
+
+}
+
+#endif /*_BENCHMARK_BENCHMARKRESULTS_H_*/
@@ -0,0 +1,173 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkSettings.h"
+
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/exceptions/NumberFormatException.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    struct Settings {
+        int warmupIterations;
+        int iterations;
+        long long timeBudget;
+        int threads;
+        bool countersEnabled;
+        std::string csvFile;
+        std::string jsonFile;
+
+        Settings() : warmupIterations(-1), iterations(-1), timeBudget(0), threads(1),
+                     countersEnabled(false), csvFile(), jsonFile() {}
+    };
+
+    Settings& settings() {
+        static Settings settings;
+        return settings;
+    }
+
+    bool hasPrefix( const std::string& arg, const std::string& prefix ) {
+        return arg.compare( 0, prefix.size(), prefix ) == 0;
+    }
+
+    bool endsWith( const std::string& arg, const std::string& suffix ) {
+        return arg.size() >= suffix.size() &&
+               arg.compare( arg.size() - suffix.size(), suffix.size(), suffix ) == 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool BenchmarkSettings::parse( int argc, char** argv ) {
+
+    for( int i = 1; i < argc; ++i ) {
+
+        std::string arg( argv[i] );
+
+        try {
+
+            if( hasPrefix( arg, "--warmup=" ) ) {
+                settings().warmupIterations = Integer::parseInt( arg.substr( 9 ) );
+                if( settings().warmupIterations < 0 ) {
+                    throw NumberFormatException();
+                }
+            } else if( hasPrefix( arg, "--iterations=" ) ) {
+                settings().iterations = Integer::parseInt( arg.substr( 13 ) );
+                if( settings().iterations < 1 ) {
+                    throw NumberFormatException();
+                }
+            } else if( hasPrefix( arg, "--time-budget=" ) ) {
+                settings().timeBudget = Long::parseLong( arg.substr( 14 ) );
+                if( settings().timeBudget < 0 ) {
+                    throw NumberFormatException();
+                }
+            } else if( hasPrefix( arg, "--threads=" ) ) {
+                settings().threads = Integer::parseInt( arg.substr( 10 ) );
+                if( settings().threads < 1 ) {
+                    throw NumberFormatException();
+                }
+            } else if( arg == "--counters" ) {
+                settings().countersEnabled = true;
+            } else if( hasPrefix( arg, "--csv=" ) ) {
+                settings().csvFile = arg.substr( 6 );
+            } else if( hasPrefix( arg, "--json=" ) ) {
+                settings().jsonFile = arg.substr( 7 );
+            } else if( hasPrefix( arg, "--" ) ) {
+                std::cout << "Unknown benchmark option: " << arg << std::endl;
+                return false;
+            } else if( endsWith( arg, ".json" ) ) {
+                settings().jsonFile = arg;
+            } else {
+                settings().csvFile = arg;
+            }
+
+        } catch( NumberFormatException& ) {
+            std::cout << "Bad value for benchmark option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int BenchmarkSettings::getWarmupIterations() {
+    return settings().warmupIterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSettings::setWarmupIterations( int value ) {
+    settings().warmupIterations = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int BenchmarkSettings::getIterations() {
+    return settings().iterations;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSettings::setIterations( int value ) {
+    settings().iterations = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long BenchmarkSettings::getTimeBudget() {
+    return settings().timeBudget;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSettings::setTimeBudget( long long value ) {
+    settings().timeBudget = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int BenchmarkSettings::getThreads() {
+    return settings().threads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSettings::setThreads( int value ) {
+    settings().threads = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool BenchmarkSettings::isCountersEnabled() {
+    return settings().countersEnabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BenchmarkSettings::setCountersEnabled( bool value ) {
+    settings().countersEnabled = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& BenchmarkSettings::getCsvFile() {
+    return settings().csvFile;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::string& BenchmarkSettings::getJsonFile() {
+    return settings().jsonFile;
+}
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_BENCHMARKSETTINGS_H_
+#define _BENCHMARK_BENCHMARKSETTINGS_H_
+
+#include <string>
+
+namespace benchmark{
+
+    /**
+     * The settings shared by every benchmark in a run, set from the command line
+     * before the benchmarks start.  A setting left at its default lets each
+     * benchmark use the value it was written with.
+     */
+    class BenchmarkSettings {
+    private:
+
+        BenchmarkSettings();
+
+    public:
+
+        /**
+         * Reads the settings from the command line arguments, the recognized
+         * options are:
+         *
+         *   --warmup=N        untimed runs made before measuring, default a tenth
+         *                     of the benchmark's iterations.
+         *   --iterations=N    timed runs, default the benchmark's own count.
+         *   --time-budget=MS  stop measuring a benchmark once this many milliseconds
+         *                     have passed, at least one timed run is always made.
+         *   --threads=N       run each benchmark on N threads at once, each thread
+         *                     with its own instance of the benchmark.
+         *   --counters        read the CPU counters around the timed runs where
+         *                     the platform provides them.
+         *   --csv=FILE        save the results as CSV.
+         *   --json=FILE       save the results as JSON.
+         *
+         * A bare argument is taken as a results file, saved as JSON if its name ends
+         * with .json and as CSV otherwise.
+         *
+         * @return false if an argument was not recognized or has a bad value.
+         */
+        static bool parse( int argc, char** argv );
+
+        /**
+         * @return the number of warmup runs, or -1 to let the benchmark decide.
+         */
+        static int getWarmupIterations();
+        static void setWarmupIterations( int value );
+
+        /**
+         * @return the number of timed runs, or -1 to let the benchmark decide.
+         */
+        static int getIterations();
+        static void setIterations( int value );
+
+        /**
+         * @return the time budget in milliseconds for the timed runs, zero for none.
+         */
+        static long long getTimeBudget();
+        static void setTimeBudget( long long value );
+
+        static int getThreads();
+        static void setThreads( int value );
+
+        static bool isCountersEnabled();
+        static void setCountersEnabled( bool value );
+
+        static const std::string& getCsvFile();
+        static const std::string& getJsonFile();
+
+    };
+
+}
+
+#endif /*_BENCHMARK_BENCHMARKSETTINGS_H_*/
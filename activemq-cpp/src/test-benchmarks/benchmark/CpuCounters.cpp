@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CpuCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+using namespace benchmark;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+
+    int openCounter( unsigned int type, unsigned long long config, bool excludeKernel ) {
+
+        struct perf_event_attr attr;
+        ::memset( &attr, 0, sizeof( attr ) );
+        attr.size = sizeof( attr );
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = excludeKernel ? 1 : 0;
+        attr.exclude_hv = 1;
+
+        return (int) ::syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 );
+    }
+
+    int openCounter( unsigned int type, unsigned long long config ) {
+
+        // Kernel events are left out when the paranoid setting doesn't allow them,
+        // context switches then count only those seen from user space.
+        int descriptor = openCounter( type, config, false );
+        if( descriptor < 0 ) {
+            descriptor = openCounter( type, config, true );
+        }
+
+        return descriptor;
+    }
+
+#endif
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CpuCounters::CpuCounters() {
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        this->descriptors[i] = -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+CpuCounters::~CpuCounters() {
+    close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CpuCounters::open() {
+
+    close();
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+    this->descriptors[CYCLES] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+    this->descriptors[CACHE_MISSES] = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+    this->descriptors[CONTEXT_SWITCHES] = openCounter( PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES );
+#endif
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        if( this->descriptors[i] >= 0 ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CpuCounters::close() {
+
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+#if defined(__linux__)
+        if( this->descriptors[i] >= 0 ) {
+            ::close( this->descriptors[i] );
+        }
+#endif
+        this->descriptors[i] = -1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CpuCounters::start() {
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        if( this->descriptors[i] >= 0 ) {
+            ::ioctl( this->descriptors[i], PERF_EVENT_IOC_ENABLE, 0 );
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CpuCounters::stop() {
+
+#if defined(__linux__) && defined(__NR_perf_event_open)
+    for( int i = 0; i < NUM_COUNTERS; ++i ) {
+        if( this->descriptors[i] >= 0 ) {
+            ::ioctl( this->descriptors[i], PERF_EVENT_IOC_DISABLE, 0 );
+        }
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long CpuCounters::getValue( Counter counter ) const {
+
+    long long value = 0;
+
+#if defined(__linux__)
+    if( this->descriptors[counter] >= 0 &&
+        ::read( this->descriptors[counter], &value, sizeof( value ) ) != (ssize_t) sizeof( value ) ) {
+        value = 0;
+    }
+#endif
+
+    return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* CpuCounters::getName( Counter counter ) {
+
+    switch( counter ) {
+        case CYCLES:
+            return "cycles";
+        case CACHE_MISSES:
+            return "cache-misses";
+        case CONTEXT_SWITCHES:
+            return "context-switches";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_CPUCOUNTERS_H_
+#define _BENCHMARK_CPUCOUNTERS_H_
+
+namespace benchmark{
+
+    /**
+     * Reads the CPU performance counters of the calling thread and of the threads
+     * it starts after the counters were opened.  On Linux the counters are read
+     * with perf_event_open, elsewhere, or when the kernel refuses access, the
+     * counters are simply unavailable and the benchmarks report times only.
+     *
+     * The counters count only while started so the warmup runs can be left out.
+     */
+    class CpuCounters {
+    public:
+
+        enum Counter {
+            CYCLES,
+            CACHE_MISSES,
+            CONTEXT_SWITCHES,
+            NUM_COUNTERS
+        };
+
+    private:
+
+        int descriptors[NUM_COUNTERS];
+
+    private:
+
+        CpuCounters( const CpuCounters& );
+        CpuCounters& operator= ( const CpuCounters& );
+
+    public:
+
+        CpuCounters();
+        virtual ~CpuCounters();
+
+        /**
+         * Opens each counter the platform allows, stopped and at zero.
+         *
+         * @return true if at least one counter could be opened.
+         */
+        bool open();
+
+        /**
+         * Closes the open counters, they are then unavailable.
+         */
+        void close();
+
+        /**
+         * Starts the open counters counting from where they were stopped.
+         */
+        void start();
+
+        /**
+         * Stops the open counters, their values are kept.
+         */
+        void stop();
+
+        /**
+         * @return true if the counter was opened.
+         */
+        bool isAvailable( Counter counter ) const {
+            return this->descriptors[counter] >= 0;
+        }
+
+        /**
+         * @return the value counted so far, zero if the counter is unavailable.
+         */
+        long long getValue( Counter counter ) const;
+
+        /**
+         * @return the name used to report the counter, e.g. cycles.
+         */
+        static const char* getName( Counter counter );
+
+    };
+
+}
+
+#endif /*_BENCHMARK_CPUCOUNTERS_H_*/
@@ -0,0 +1,100 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <benchmark/BenchmarkResults.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+using namespace benchmark;
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram() : samples(), sorted(true) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::~LatencyHistogram() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::record( long long nanos ) {
+    this->samples.push_back( nanos );
+    this->sorted = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::reset() {
+    this->samples.clear();
+    this->sorted = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long LatencyHistogram::getPercentile( double fraction ) const {
+
+    if( this->samples.empty() ) {
+        return 0;
+    }
+
+    if( !this->sorted ) {
+        std::sort( this->samples.begin(), this->samples.end() );
+        this->sorted = true;
+    }
+
+    std::size_t index = (std::size_t)( fraction * (double) this->samples.size() );
+    if( index >= this->samples.size() ) {
+        index = this->samples.size() - 1;
+    }
+
+    return this->samples[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double LatencyHistogram::getMean() const {
+
+    if( this->samples.empty() ) {
+        return 0;
+    }
+
+    double total = 0;
+    std::vector<long long>::const_iterator iter = this->samples.begin();
+    for( ; iter != this->samples.end(); ++iter ) {
+        total += (double) *iter;
+    }
+
+    return total / (double) this->samples.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogram::publish( const std::string& benchmark, const std::string& metric ) const {
+
+    double mean = getMean() / 1000.0;
+    double p50 = (double) getPercentile( 0.50 ) / 1000.0;
+    double p99 = (double) getPercentile( 0.99 ) / 1000.0;
+    double p999 = (double) getPercentile( 0.999 ) / 1000.0;
+
+    BenchmarkResults::record( benchmark, metric + ".mean", mean, "us" );
+    BenchmarkResults::record( benchmark, metric + ".p50", p50, "us" );
+    BenchmarkResults::record( benchmark, metric + ".p99", p99, "us" );
+    BenchmarkResults::record( benchmark, metric + ".p999", p999, "us" );
+
+    std::cout << benchmark << " " << metric << " Latency (us): mean = " << mean
+              << ", p50 = " << p50 << ", p99 = " << p99 << ", p999 = " << p999
+              << std::endl;
+}
@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _BENCHMARK_LATENCYHISTOGRAM_H_
+#define _BENCHMARK_LATENCYHISTOGRAM_H_
+
+#include <string>
+#include <vector>
+
+namespace benchmark{
+
+    /**
+     * Keeps every latency sample recorded by a benchmark so that percentiles can
+     * be reported rather than just an average, which hides the outliers.
+     */
+    class LatencyHistogram {
+    private:
+
+        mutable std::vector<long long> samples;
+        mutable bool sorted;
+
+    public:
+
+        LatencyHistogram();
+        virtual ~LatencyHistogram();
+
+        /**
+         * Records a sample.
+         *
+         * @param nanos
+         *      The measured latency in nanoseconds.
+         */
+        void record( long long nanos );
+
+        /**
+         * Throws away all the recorded samples.
+         */
+        void reset();
+
+        /**
+         * @return the number of samples recorded.
+         */
+        long long getCount() const {
+            return (long long) samples.size();
+        }
+
+        /**
+         * Gets the latency below which the given fraction of the samples fall.
+         *
+         * @param fraction
+         *      The fraction of samples, 0.99 for the 99th percentile.
+         *
+         * @return the percentile in nanoseconds or 0 if there are no samples.
+         */
+        long long getPercentile( double fraction ) const;
+
+        /**
+         * @return the mean of the samples in nanoseconds or 0 if there are none.
+         */
+        double getMean() const;
+
+        /**
+         * Records the mean, p50, p99 and p999 latencies in microseconds with the
+         * BenchmarkResults, the metric names are prefixed with the given name.
+         *
+         * @param benchmark
+         *      The name of the benchmark the samples belong to.
+         * @param metric
+         *      The name the percentile metrics are prefixed with.
+         */
+        void publish( const std::string& benchmark, const std::string& metric ) const;
+
+    };
+
+}
+
+#endif /*_BENCHMARK_LATENCYHISTOGRAM_H_*/
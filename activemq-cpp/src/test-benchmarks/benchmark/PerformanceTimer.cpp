@@ -19,10 +19,37 @@
 
 #include <decaf/lang/System.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 using namespace benchmark;
 using namespace decaf::lang;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Two sided 95% critical values of Student's t for 1 to 30 degrees of freedom.
+    const double T_TABLE[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+
+    double criticalValue( long long degreesOfFreedom ) {
+
+        if( degreesOfFreedom <= 30 ) {
+            return T_TABLE[degreesOfFreedom - 1];
+        } else if( degreesOfFreedom <= 60 ) {
+            return 2.021;
+        } else if( degreesOfFreedom <= 120 ) {
+            return 2.000;
+        }
+
+        return 1.960;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 PerformanceTimer::PerformanceTimer() : numberOfRuns(0), times(), startTime(0), endTime(0) {
 }
@@ -33,37 +60,105 @@ PerformanceTimer::~PerformanceTimer(){
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::start(){
-    this->startTime = System::currentTimeMillis();
+    this->startTime = System::nanoTime();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::stop(){
 
-    this->endTime = System::currentTimeMillis();
+    this->endTime = System::nanoTime();
     times.push_back( endTime - startTime );
     numberOfRuns++;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void PerformanceTimer::reset(){
+    this->numberOfRuns = 0;
     this->startTime = 0;
     this->endTime = 0;
     this->times.clear();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void PerformanceTimer::merge( const PerformanceTimer& other ) {
+    this->times.insert( this->times.end(), other.times.begin(), other.times.end() );
+    this->numberOfRuns += other.numberOfRuns;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 long long PerformanceTimer::getAverageTime() const{
+    return (long long)( getMeanNanos() / 1000000.0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double PerformanceTimer::getMeanNanos() const {
+
+    if( times.empty() ) {
+        return 0;
+    }
+
+    double totalTime = 0;
+    std::vector<long long>::const_iterator iter = times.begin();
+    for( ; iter != times.end(); ++iter ) {
+        totalTime += (double) *iter;
+    }
+
+    return totalTime / (double) times.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double PerformanceTimer::getStandardDeviationNanos() const {
+
+    if( times.size() < 2 ) {
+        return 0;
+    }
 
+    double mean = getMeanNanos();
+    double squares = 0;
     std::vector<long long>::const_iterator iter = times.begin();
-    long long totalTime = 0;
+    for( ; iter != times.end(); ++iter ) {
+        double delta = (double) *iter - mean;
+        squares += delta * delta;
+    }
+
+    return std::sqrt( squares / (double)( times.size() - 1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double PerformanceTimer::getConfidenceIntervalNanos() const {
+
+    if( times.size() < 2 ) {
+        return 0;
+    }
 
-    do{
-        totalTime += *iter;
-    } while( ++iter != times.end() );
+    long long runs = (long long) times.size();
+    return criticalValue( runs - 1 ) * getStandardDeviationNanos() / std::sqrt( (double) runs );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long PerformanceTimer::getPercentileNanos( double fraction ) const {
 
-    if( totalTime == 0 || numberOfRuns == 0 ) {
+    if( times.empty() ) {
         return 0;
     }
 
-    return totalTime / numberOfRuns;
+    std::vector<long long> sorted( times );
+    std::sort( sorted.begin(), sorted.end() );
+
+    std::size_t index = (std::size_t)( fraction * (double) sorted.size() );
+    if( index >= sorted.size() ) {
+        index = sorted.size() - 1;
+    }
+
+    return sorted[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long PerformanceTimer::getMinimumNanos() const {
+    return times.empty() ? 0 : *std::min_element( times.begin(), times.end() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long PerformanceTimer::getMaximumNanos() const {
+    return times.empty() ? 0 : *std::max_element( times.begin(), times.end() );
 }
@@ -28,7 +28,11 @@ namespace benchmark{
      * maintains a running list of performance numbers for successive calls to
      * the method start and stop.  Once the desired number of tests has been run,
      * the user can call getAverageTime to find out the average time it took for
-     * all start / stop cycles.
+     * all start / stop cycles, or ask for the spread of the times through the
+     * percentile, standard deviation and confidence interval methods.
+     *
+     * Times are taken with System::nanoTime so that runs shorter than a
+     * millisecond are still measured.
      */
     class PerformanceTimer {
     private:
@@ -67,13 +71,60 @@ namespace benchmark{
             return numberOfRuns;
         }
 
+        /**
+         * Adds the times recorded by another timer to this one, used to combine
+         * the times taken on several threads.
+         *
+         * @param other
+         *      The timer whose times are added.
+         */
+        void merge( const PerformanceTimer& other );
+
         /**
          * Gets the overall average time that the count has recoreded
          * for all start / stop cycles.
-         * @return the average time for all the runs times / numberOfRuns
+         * @return the average time in milliseconds for all the runs times / numberOfRuns
          */
         long long getAverageTime() const;
 
+        /**
+         * @return the mean time of all the runs in nanoseconds, or zero if there were none.
+         */
+        double getMeanNanos() const;
+
+        /**
+         * @return the sample standard deviation of the run times in nanoseconds.
+         */
+        double getStandardDeviationNanos() const;
+
+        /**
+         * Gets the half width of the 95% confidence interval of the mean, the true
+         * mean lies within getMeanNanos() plus or minus this value.  Student's t
+         * distribution is used so that the interval is not understated for the small
+         * number of runs a benchmark usually makes.
+         *
+         * @return the half width of the interval in nanoseconds.
+         */
+        double getConfidenceIntervalNanos() const;
+
+        /**
+         * @param fraction
+         *      The fraction of runs that took no longer than the returned time, e.g. 0.99.
+         *
+         * @return the run time at the given percentile in nanoseconds.
+         */
+        long long getPercentileNanos( double fraction ) const;
+
+        /**
+         * @return the shortest run time in nanoseconds.
+         */
+        long long getMinimumNanos() const;
+
+        /**
+         * @return the longest run time in nanoseconds.
+         */
+        long long getMaximumNanos() const;
+
     };
 
 }
@@ -17,15 +17,22 @@
 
 #include "DataInputStreamBenchmark.h"
 
+#include <decaf/lang/System.h>
+
+#include <iostream>
+
 using namespace std;
+using namespace benchmark;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
 const int DataInputStreamBenchmark::bufferSize = 200000;
 
 ////////////////////////////////////////////////////////////////////////////////
-DataInputStreamBenchmark::DataInputStreamBenchmark() : buffer(), bis() {
+DataInputStreamBenchmark::DataInputStreamBenchmark() :
+    buffer(), bis(), shorts(), ints(), longs(), nanos(), operations(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +46,10 @@ void DataInputStreamBenchmark::setUp() {
     }
     buffer[bufferSize - 1] = 0;
     bis.setByteArray(buffer, bufferSize);
+
+    shorts.resize(bufferSize / sizeof(short));
+    ints.resize(bufferSize / sizeof(int));
+    longs.resize(bufferSize / sizeof(long long));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,4 +123,56 @@ void DataInputStreamBenchmark::run() {
         stringResult = dis.readString();
         bis.reset();
     }
+
+    long long start = System::nanoTime();
+    for (size_t iy = 0; iy < shorts.size(); ++iy) {
+        shorts[iy] = dis.readShort();
+    }
+    nanos["readShort"] += System::nanoTime() - start;
+    bis.reset();
+
+    start = System::nanoTime();
+    dis.readShorts(&shorts[0], (int) shorts.size());
+    nanos["readShorts"] += System::nanoTime() - start;
+    bis.reset();
+
+    start = System::nanoTime();
+    for (size_t iy = 0; iy < ints.size(); ++iy) {
+        ints[iy] = dis.readInt();
+    }
+    nanos["readInt"] += System::nanoTime() - start;
+    bis.reset();
+
+    start = System::nanoTime();
+    dis.readInts(&ints[0], (int) ints.size());
+    nanos["readInts"] += System::nanoTime() - start;
+    bis.reset();
+
+    start = System::nanoTime();
+    for (size_t iy = 0; iy < longs.size(); ++iy) {
+        longs[iy] = dis.readLong();
+    }
+    nanos["readLong"] += System::nanoTime() - start;
+    bis.reset();
+
+    start = System::nanoTime();
+    dis.readLongs(&longs[0], (int) longs.size());
+    nanos["readLongs"] += System::nanoTime() - start;
+    bis.reset();
+
+    operations += bufferSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamBenchmark::publishResults() {
+
+    std::map<std::string, long long>::const_iterator iter = nanos.begin();
+    for (; iter != nanos.end(); ++iter) {
+
+        double perByte = (double) iter->second / (double) operations;
+        BenchmarkResults::record("DataInputStream", iter->first, perByte, "ns/byte");
+
+        std::cout << "DataInputStream " << iter->first << " = "
+                  << perByte << " ns/byte" << std::endl;
+    }
 }
@@ -22,6 +22,10 @@
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace decaf{
 namespace io{
 
@@ -35,6 +39,14 @@ namespace io{
         ByteArrayInputStream bis;
         static const int bufferSize;
 
+        std::vector<short> shorts;
+        std::vector<int> ints;
+        std::vector<long long> longs;
+
+        // Time spent reading the buffer one value at a time and in bulk.
+        std::map< std::string, long long > nanos;
+        long long operations;
+
     private:
 
         DataInputStreamBenchmark( const DataInputStreamBenchmark& );
@@ -48,6 +60,11 @@ namespace io{
         virtual void setUp();
         virtual void tearDown();
         virtual void run();
+
+    protected:
+
+        virtual void publishResults();
+
     };
 
 }}
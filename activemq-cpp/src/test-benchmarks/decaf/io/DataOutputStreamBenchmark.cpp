@@ -17,13 +17,24 @@
 
 #include "DataOutputStreamBenchmark.h"
 #include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/lang/System.h>
+
+#include <iostream>
 
 using namespace std;
+using namespace benchmark;
 using namespace decaf;
 using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+    const int NUM_VALUES = 20000;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-DataOutputStreamBenchmark::DataOutputStreamBenchmark() : testString() {
+DataOutputStreamBenchmark::DataOutputStreamBenchmark() :
+    testString(), shorts(), ints(), longs(), nanos(), operations(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +43,16 @@ void DataOutputStreamBenchmark::setUp() {
     for (size_t i = 0; i < 8096; ++i) {
         testString += 'a';
     }
+
+    shorts.resize(NUM_VALUES);
+    ints.resize(NUM_VALUES);
+    longs.resize(NUM_VALUES);
+
+    for (int i = 0; i < NUM_VALUES; ++i) {
+        shorts[i] = (short) i;
+        ints[i] = i * 312568;
+        longs[i] = (long long) i * 0xFF00FF00FFLL;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,4 +101,56 @@ void DataOutputStreamBenchmark::run() {
     }
 
     bos.reset();
+
+    long long start = System::nanoTime();
+    for (int iy = 0; iy < NUM_VALUES; ++iy) {
+        dos.writeShort(shorts[iy]);
+    }
+    nanos["writeShort"] += System::nanoTime() - start;
+    bos.reset();
+
+    start = System::nanoTime();
+    dos.writeShorts(&shorts[0], NUM_VALUES);
+    nanos["writeShorts"] += System::nanoTime() - start;
+    bos.reset();
+
+    start = System::nanoTime();
+    for (int iy = 0; iy < NUM_VALUES; ++iy) {
+        dos.writeInt(ints[iy]);
+    }
+    nanos["writeInt"] += System::nanoTime() - start;
+    bos.reset();
+
+    start = System::nanoTime();
+    dos.writeInts(&ints[0], NUM_VALUES);
+    nanos["writeInts"] += System::nanoTime() - start;
+    bos.reset();
+
+    start = System::nanoTime();
+    for (int iy = 0; iy < NUM_VALUES; ++iy) {
+        dos.writeLong(longs[iy]);
+    }
+    nanos["writeLong"] += System::nanoTime() - start;
+    bos.reset();
+
+    start = System::nanoTime();
+    dos.writeLongs(&longs[0], NUM_VALUES);
+    nanos["writeLongs"] += System::nanoTime() - start;
+    bos.reset();
+
+    operations += NUM_VALUES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStreamBenchmark::publishResults() {
+
+    std::map<std::string, long long>::const_iterator iter = nanos.begin();
+    for (; iter != nanos.end(); ++iter) {
+
+        double perValue = (double) iter->second / (double) operations;
+        BenchmarkResults::record("DataOutputStream", iter->first, perValue, "ns/value");
+
+        std::cout << "DataOutputStream " << iter->first << " = "
+                  << perValue << " ns/value" << std::endl;
+    }
 }
@@ -21,6 +21,10 @@
 #include <benchmark/BenchmarkBase.h>
 #include <decaf/io/DataOutputStream.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace decaf{
 namespace io{
 
@@ -32,6 +36,14 @@ namespace io{
 
         std::string testString;
 
+        std::vector<short> shorts;
+        std::vector<int> ints;
+        std::vector<long long> longs;
+
+        // Time spent writing the arrays above one value at a time and in bulk.
+        std::map< std::string, long long > nanos;
+        long long operations;
+
     public:
 
         DataOutputStreamBenchmark();
@@ -39,6 +51,11 @@ namespace io{
 
         virtual void setUp();
         virtual void run();
+
+    protected:
+
+        virtual void publishResults();
+
     };
 
 }}
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "StringBenchmark.h"
+
+#include <benchmark/AllocationCounter.h>
+#include <benchmark/BenchmarkResults.h>
+#include <decaf/lang/StringBuilder.h>
+#include <decaf/lang/System.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int NUM_COPIES = 100000;
+    const int NUM_APPENDS = 1000;
+    const int NUM_BUILDS = 100;
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StringBenchmark::StringBenchmark() : measurements() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringBenchmark::copy(const std::string& name, const String& value) {
+
+    Measurement& measurement = measurements[name];
+    String target;
+
+    AllocationCounter::start();
+    long long start = System::nanoTime();
+
+    for (int i = 0; i < NUM_COPIES; ++i) {
+        String copy(value);
+        target = copy;
+    }
+
+    measurement.nanos += System::nanoTime() - start;
+    AllocationCounter::stop();
+    measurement.allocations += AllocationCounter::getAllocations();
+    measurement.operations += NUM_COPIES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringBenchmark::substring(const std::string& name, const String& value, int length) {
+
+    Measurement& measurement = measurements[name];
+    int limit = value.length() - length;
+
+    AllocationCounter::start();
+    long long start = System::nanoTime();
+
+    for (int i = 0; i < NUM_COPIES; ++i) {
+        int offset = i % limit;
+        String part = value.substring(offset, offset + length);
+    }
+
+    measurement.nanos += System::nanoTime() - start;
+    AllocationCounter::stop();
+    measurement.allocations += AllocationCounter::getAllocations();
+    measurement.operations += NUM_COPIES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringBenchmark::build(const std::string& name, bool reserve) {
+
+    Measurement& measurement = measurements[name];
+    String part("0123456789");
+
+    AllocationCounter::start();
+    long long start = System::nanoTime();
+
+    for (int i = 0; i < NUM_BUILDS; ++i) {
+        StringBuilder builder;
+
+        if (reserve) {
+            builder.ensureCapacity(NUM_APPENDS * part.length());
+        }
+
+        for (int j = 0; j < NUM_APPENDS; ++j) {
+            builder.append(part);
+        }
+
+        String result = builder.toString();
+    }
+
+    measurement.nanos += System::nanoTime() - start;
+    AllocationCounter::stop();
+    measurement.allocations += AllocationCounter::getAllocations();
+    measurement.operations += NUM_BUILDS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringBenchmark::run() {
+
+    String shortValue("short value");
+    String longValue("a considerably longer value that has to live on the heap");
+
+    copy("copy short", shortValue);
+    copy("copy long", longValue);
+    substring("substring short", longValue, 8);
+    substring("substring long", longValue, 32);
+    build("append", false);
+    build("append reserved", true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringBenchmark::publishResults() {
+
+    std::map<std::string, Measurement>::const_iterator iter = measurements.begin();
+    for (; iter != measurements.end(); ++iter) {
+
+        const Measurement& measurement = iter->second;
+        double nanosPerOp = (double) measurement.nanos / (double) measurement.operations;
+        double allocsPerOp = (double) measurement.allocations / (double) measurement.operations;
+
+        BenchmarkResults::record("String", iter->first, nanosPerOp, "ns/op");
+        BenchmarkResults::record("String", iter->first + " allocations", allocsPerOp, "allocs/op");
+
+        std::cout << "String " << iter->first << " = " << nanosPerOp << " ns/op, "
+                  << allocsPerOp << " allocs/op" << std::endl;
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _DECAF_LANG_STRINGBENCHMARK_H_
+#define _DECAF_LANG_STRINGBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <decaf/lang/String.h>
+
+#include <map>
+#include <string>
+
+namespace decaf {
+namespace lang {
+
+    /**
+     * Measures the time and the heap allocations needed to copy, assign and take
+     * substrings of short and long Strings and to build a String with a StringBuilder.
+     */
+    class StringBenchmark :
+        public benchmark::BenchmarkBase< decaf::lang::StringBenchmark, String, 10 >
+    {
+    private:
+
+        struct Measurement {
+            long long nanos;
+            long long allocations;
+            long long operations;
+
+            Measurement() : nanos(0), allocations(0), operations(0) {}
+        };
+
+        std::map< std::string, Measurement > measurements;
+
+    public:
+
+        StringBenchmark();
+        virtual ~StringBenchmark() {}
+
+        virtual void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        void copy( const std::string& name, const String& value );
+        void substring( const std::string& name, const String& value, int length );
+        void build( const std::string& name, bool reserve );
+
+    };
+
+}}
+
+#endif /* _DECAF_LANG_STRINGBENCHMARK_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIBenchmark.h"
+
+#include <benchmark/BenchmarkResults.h>
+
+#include <decaf/internal/net/URIView.h>
+#include <decaf/internal/net/URIEncoderDecoder.h>
+#include <decaf/lang/System.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::internal::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int ROUNDS = 1000;
+
+    // Splits the string the way the parser did before URIView, copying each
+    // component out before checking its characters.
+    std::size_t splitAndCopy( const std::string& uri ) {
+
+        std::string temp = uri;
+        std::string fragment;
+        std::string scheme;
+        std::string ssp;
+        std::string query;
+        std::string authority;
+        std::string path;
+
+        std::size_t index = temp.find( '#' );
+        if( index != std::string::npos ) {
+            fragment = temp.substr( index + 1 );
+            URIEncoderDecoder::validate( fragment, "_-!.~\'()*,;:$&+=?/[]@" );
+            temp = temp.substr( 0, index );
+        }
+
+        index = temp.find( ':' );
+        if( index != std::string::npos && temp.find( '/' ) > index && temp.find( '?' ) > index ) {
+            scheme = temp.substr( 0, index );
+            URIEncoderDecoder::validateSimple( scheme, "+-." );
+            ssp = temp.substr( index + 1 );
+        } else {
+            ssp = temp;
+        }
+
+        if( !scheme.empty() && ssp.at( 0 ) != '/' ) {
+            URIEncoderDecoder::validate( ssp, "_-!.~\'()*,;:$&+=?/[]@" );
+            return ssp.length();
+        }
+
+        temp = ssp;
+        index = temp.find( '?' );
+        if( index != std::string::npos ) {
+            query = temp.substr( index + 1 );
+            URIEncoderDecoder::validate( query, "_-!.~\'()*,;:$&+=?/[]@" );
+            temp = temp.substr( 0, index );
+        }
+
+        if( temp.size() >= 2 && temp.at( 0 ) == '/' && temp.at( 1 ) == '/' ) {
+            index = temp.find( '/', 2 );
+            authority = temp.substr( 2, index == std::string::npos ? std::string::npos : index - 2 );
+            URIEncoderDecoder::validate( authority, "@[]_-!.~\'()*,;:$&+=" );
+            if( index != std::string::npos ) {
+                path = temp.substr( index );
+            }
+        } else {
+            path = temp;
+        }
+
+        URIEncoderDecoder::validate( path, "/@_-!.~\'()*,;:$&+=" );
+
+        return authority.length() + path.length() + query.length();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIBenchmark::URIBenchmark() : uris(), nanos(), operations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIBenchmark::~URIBenchmark() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIBenchmark::setUp() {
+
+    this->uris.clear();
+    this->uris.push_back( "tcp://localhost:61616" );
+    this->uris.push_back( "tcp://broker1.example.com:61616?wireFormat.maxInactivityDuration=30000&soKeepAlive=true" );
+    this->uris.push_back( "ssl://user@10.0.0.12:61617?socket.verifyHostName=false" );
+    this->uris.push_back( "tcp://[fe80::1]:61616?transport.useInactivityMonitor=false" );
+    this->uris.push_back( "failover:(tcp://broker1:61616,tcp://broker2:61616)?randomize=false&maxReconnectAttempts=10" );
+    this->uris.push_back( "stomp://broker1.example.com:61613?wireFormat=stomp" );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIBenchmark::run() {
+
+    std::vector<std::string>::const_iterator iter;
+
+    long long start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        for( iter = this->uris.begin(); iter != this->uris.end(); ++iter ) {
+            URIView view;
+            view.scan( *iter );
+            CPPUNIT_ASSERT( view.isAbsolute() );
+        }
+    }
+    this->nanos["scan"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        for( iter = this->uris.begin(); iter != this->uris.end(); ++iter ) {
+            URIView view;
+            view.scan( *iter );
+            view.validate( false );
+        }
+    }
+    this->nanos["scanAndValidate"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        for( iter = this->uris.begin(); iter != this->uris.end(); ++iter ) {
+            URI uri( *iter );
+            CPPUNIT_ASSERT( uri.isAbsolute() );
+        }
+    }
+    this->nanos["construct"] += System::nanoTime() - start;
+
+    start = System::nanoTime();
+    for( int i = 0; i < ROUNDS; ++i ) {
+        for( iter = this->uris.begin(); iter != this->uris.end(); ++iter ) {
+            CPPUNIT_ASSERT( splitAndCopy( *iter ) > 0 );
+        }
+    }
+    this->nanos["splitAndCopy"] += System::nanoTime() - start;
+
+    this->operations += ROUNDS * (long long) this->uris.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIBenchmark::publishResults() {
+
+    std::map< std::string, long long >::const_iterator iter = this->nanos.begin();
+    for( ; iter != this->nanos.end(); ++iter ) {
+
+        double perOperation = (double) iter->second / (double) this->operations;
+        BenchmarkResults::record( "URI", iter->first, perOperation, "ns/op" );
+
+        std::cout << "URI " << iter->first << " = "
+                  << perOperation << " ns/op" << std::endl;
+    }
+}
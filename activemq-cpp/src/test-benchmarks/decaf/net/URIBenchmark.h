@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_NET_URIBENCHMARK_H_
+#define _DECAF_NET_URIBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+
+#include <decaf/net/URI.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace decaf{
+namespace net{
+
+    /**
+     * Measures parsing the kind of URIs a client sees, broker and failover URIs with
+     * their options.  Scanning into a URIView alone and with validation is set against
+     * constructing a URI and against splitting the string with copies and checking each
+     * copy with URIEncoderDecoder as the URI parser did before URIView.
+     */
+    class URIBenchmark :
+        public benchmark::BenchmarkBase<
+            decaf::net::URIBenchmark, URI, 10 >
+    {
+    private:
+
+        std::vector<std::string> uris;
+        std::map< std::string, long long > nanos;
+        long long operations;
+
+    public:
+
+        URIBenchmark();
+        virtual ~URIBenchmark();
+
+        void setUp();
+        void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    };
+
+}}
+
+#endif /*_DECAF_NET_URIBENCHMARK_H_*/
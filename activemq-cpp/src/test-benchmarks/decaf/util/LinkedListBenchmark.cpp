@@ -25,7 +25,8 @@ using namespace decaf::util;
 using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
-LinkedListBenchmark::LinkedListBenchmark() : intList(), stringList() {
+LinkedListBenchmark::LinkedListBenchmark() : intList(), stringList(), queue(), cachedQueue() {
+    cachedQueue.setNodeCacheSize(100);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -96,4 +97,17 @@ void LinkedListBenchmark::run(){
 
     stringList.clear();
     intList.clear();
+
+    // Used as a queue, once filled the cached list adds without allocating.
+    int value = 0;
+    for( int i = 0; i < numRuns * 10; ++i ) {
+        for( int j = 0; j < 100; ++j ) {
+            queue.offer( j );
+            cachedQueue.offer( j );
+        }
+        while( !queue.isEmpty() ) {
+            queue.poll( value );
+            cachedQueue.poll( value );
+        }
+    }
 }
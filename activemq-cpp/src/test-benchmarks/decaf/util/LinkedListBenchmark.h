@@ -31,6 +31,8 @@ namespace util {
 
         LinkedList<int> intList;
         LinkedList<std::string> stringList;
+        LinkedList<int> queue;
+        LinkedList<int> cachedQueue;
 
     public:
 
@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "BlockingQueueBenchmark.h"
+
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/MPMCArrayBlockingQueue.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int QUEUE_CAPACITY = 1024;
+    const int NUM_VALUES = 100000;
+
+    class Producer : public Runnable {
+    private:
+
+        BlockingQueue<int>* queue;
+        int count;
+
+    private:
+
+        Producer(const Producer&);
+        Producer& operator= (const Producer&);
+
+    public:
+
+        Producer(BlockingQueue<int>* queue, int count) : Runnable(), queue(queue), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                queue->put(i);
+            }
+        }
+    };
+
+    class Consumer : public Runnable {
+    private:
+
+        BlockingQueue<int>* queue;
+        int count;
+
+    private:
+
+        Consumer(const Consumer&);
+        Consumer& operator= (const Consumer&);
+
+    public:
+
+        Consumer(BlockingQueue<int>* queue, int count) : Runnable(), queue(queue), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                queue->take();
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BlockingQueueBenchmark::BlockingQueueBenchmark() : nanos(), operations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long long BlockingQueueBenchmark::transfer(BlockingQueue<int>& queue, int producers, int consumers) {
+
+    std::vector<Runnable*> tasks;
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < producers; ++i) {
+        tasks.push_back(new Producer(&queue, NUM_VALUES / producers));
+    }
+    for (int i = 0; i < consumers; ++i) {
+        tasks.push_back(new Consumer(&queue, NUM_VALUES / consumers));
+    }
+
+    long long start = System::nanoTime();
+
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        threads.push_back(new Thread(tasks[i]));
+        threads.back()->start();
+    }
+
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->join();
+    }
+
+    long long elapsed = System::nanoTime() - start;
+
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        delete threads[i];
+        delete tasks[i];
+    }
+
+    return elapsed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BlockingQueueBenchmark::run() {
+
+    {
+        LinkedBlockingQueue<int> queue(QUEUE_CAPACITY);
+        nanos["LinkedBlockingQueue 1x1"] += transfer(queue, 1, 1);
+        nanos["LinkedBlockingQueue 4x4"] += transfer(queue, 4, 4);
+    }
+
+    {
+        MPMCArrayBlockingQueue<int> queue(QUEUE_CAPACITY);
+        nanos["MPMCArrayBlockingQueue 1x1"] += transfer(queue, 1, 1);
+        nanos["MPMCArrayBlockingQueue 4x4"] += transfer(queue, 4, 4);
+    }
+
+    operations += NUM_VALUES;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BlockingQueueBenchmark::publishResults() {
+
+    std::map<std::string, long long>::const_iterator iter = nanos.begin();
+    for (; iter != nanos.end(); ++iter) {
+
+        double perSecond = (double) operations * 1000000000.0 / (double) iter->second;
+        BenchmarkResults::record("BlockingQueue", iter->first, perSecond, "ops/s");
+
+        std::cout << "BlockingQueue " << iter->first << " = "
+                  << perSecond << " ops/s" << std::endl;
+    }
+}
@@ -0,0 +1,314 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ContentionBenchmark.h"
+
+#include <decaf/internal/util/concurrent/SharedMutex.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/ConcurrentStlMap.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/locks/ReentrantLock.h>
+#include <decaf/util/concurrent/locks/ReentrantReadWriteLock.h>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::locks;
+using namespace decaf::internal::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    /**
+     * One operation on the primitive being measured, performed by many threads
+     * at once on the same instance.
+     */
+    class ContentionOperation {
+    public:
+
+        virtual ~ContentionOperation() {}
+
+        virtual void perform( int sequence ) = 0;
+
+    };
+
+}}}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int NUM_OPERATIONS = 200000;
+    const int MAX_THREADS = 8;
+    const int NUM_KEYS = 64;
+
+    // One operation in this many writes, the rest read.
+    const int WRITE_RATIO = 10;
+
+    class MutexOperation : public ContentionOperation {
+    private:
+
+        Mutex mutex;
+        int counter;
+
+    public:
+
+        MutexOperation() : mutex(), counter(0) {}
+
+        virtual void perform( int sequence DECAF_UNUSED ) {
+            mutex.lock();
+            ++counter;
+            mutex.unlock();
+        }
+    };
+
+    class ReentrantLockOperation : public ContentionOperation {
+    private:
+
+        ReentrantLock lock;
+        int counter;
+
+    public:
+
+        ReentrantLockOperation() : lock(), counter(0) {}
+
+        virtual void perform( int sequence DECAF_UNUSED ) {
+            lock.lock();
+            ++counter;
+            lock.unlock();
+        }
+    };
+
+    class ReadWriteLockOperation : public ContentionOperation {
+    private:
+
+        ReentrantReadWriteLock lock;
+        int counter;
+        volatile int seen;
+
+    public:
+
+        ReadWriteLockOperation() : lock(), counter(0), seen(0) {}
+
+        virtual void perform( int sequence ) {
+            if( sequence % WRITE_RATIO == 0 ) {
+                lock.writeLock().lock();
+                ++counter;
+                lock.writeLock().unlock();
+            } else {
+                lock.readLock().lock();
+                seen = counter;
+                lock.readLock().unlock();
+            }
+        }
+    };
+
+    class SharedMutexOperation : public ContentionOperation {
+    private:
+
+        SharedMutex mutex;
+        int counter;
+        volatile int seen;
+
+    public:
+
+        SharedMutexOperation() : mutex(), counter(0), seen(0) {}
+
+        virtual void perform( int sequence ) {
+            if( sequence % WRITE_RATIO == 0 ) {
+                mutex.writeLock();
+                ++counter;
+                mutex.unlock();
+            } else {
+                mutex.readLock();
+                seen = counter;
+                mutex.unlock();
+            }
+        }
+    };
+
+    template< typename MAP >
+    class MapOperation : public ContentionOperation {
+    private:
+
+        MAP map;
+        volatile int seen;
+
+    public:
+
+        MapOperation() : map(), seen(0) {
+            for( int i = 0; i < NUM_KEYS; ++i ) {
+                map.put( i, i );
+            }
+        }
+
+        virtual void perform( int sequence ) {
+            int key = sequence % NUM_KEYS;
+            if( sequence % WRITE_RATIO == 0 ) {
+                map.put( key, sequence );
+            } else {
+                seen = map.get( key );
+            }
+        }
+    };
+
+    class PointerCopyOperation : public ContentionOperation {
+    private:
+
+        Pointer<int> shared;
+        volatile int seen;
+
+    public:
+
+        PointerCopyOperation() : shared( new int( 42 ) ), seen(0) {}
+
+        virtual void perform( int sequence DECAF_UNUSED ) {
+            Pointer<int> copy( shared );
+            seen = *copy;
+        }
+    };
+
+    class Contender : public Runnable {
+    private:
+
+        ContentionOperation* operation;
+        CountDownLatch* go;
+        int first;
+        int count;
+
+    private:
+
+        Contender( const Contender& );
+        Contender& operator= ( const Contender& );
+
+    public:
+
+        Contender( ContentionOperation* operation, CountDownLatch* go, int first, int count ) :
+            Runnable(), operation( operation ), go( go ), first( first ), count( count ) {}
+
+        virtual void run() {
+            go->await();
+            for( int i = first; i < first + count; ++i ) {
+                operation->perform( i );
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ContentionBenchmark::ContentionBenchmark() : nanos(), operations(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ContentionBenchmark::contend( const std::string& name, ContentionOperation& operation ) {
+
+    for( int threads = 1; threads <= MAX_THREADS; threads *= 2 ) {
+
+        std::vector<Contender*> contenders;
+        std::vector<Thread*> running;
+        CountDownLatch go( 1 );
+
+        int share = NUM_OPERATIONS / threads;
+        for( int i = 0; i < threads; ++i ) {
+            contenders.push_back( new Contender( &operation, &go, i * share, share ) );
+            running.push_back( new Thread( contenders.back() ) );
+            running.back()->start();
+        }
+
+        // The threads are all started before the clock starts so that only the
+        // operations are timed.
+        long long start = System::nanoTime();
+        go.countDown();
+
+        for( std::size_t i = 0; i < running.size(); ++i ) {
+            running[i]->join();
+        }
+
+        long long elapsed = System::nanoTime() - start;
+
+        for( std::size_t i = 0; i < running.size(); ++i ) {
+            delete running[i];
+            delete contenders[i];
+        }
+
+        std::ostringstream key;
+        key << name << " x" << threads;
+        nanos[key.str()] += elapsed;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ContentionBenchmark::run() {
+
+    {
+        MutexOperation operation;
+        contend( "Mutex", operation );
+    }
+    {
+        ReentrantLockOperation operation;
+        contend( "ReentrantLock", operation );
+    }
+    {
+        ReadWriteLockOperation operation;
+        contend( "ReentrantReadWriteLock", operation );
+    }
+    {
+        SharedMutexOperation operation;
+        contend( "SharedMutex", operation );
+    }
+    {
+        MapOperation< ConcurrentStlMap<int, int> > operation;
+        contend( "ConcurrentStlMap", operation );
+    }
+    {
+        MapOperation< ConcurrentHashMap<int, int> > operation;
+        contend( "ConcurrentHashMap", operation );
+    }
+    {
+        PointerCopyOperation operation;
+        contend( "Pointer copy", operation );
+    }
+
+    operations += NUM_OPERATIONS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ContentionBenchmark::publishResults() {
+
+    std::map<std::string, long long>::const_iterator iter = nanos.begin();
+    for( ; iter != nanos.end(); ++iter ) {
+
+        double perSecond = (double) operations * 1000000000.0 / (double) iter->second;
+        BenchmarkResults::record( "Contention", iter->first, perSecond, "ops/s" );
+
+        std::cout << "Contention " << iter->first << " = "
+                  << perSecond << " ops/s" << std::endl;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_CONTENTIONBENCHMARK_H_
+#define _DECAF_UTIL_CONCURRENT_CONTENTIONBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <decaf/util/concurrent/locks/Lock.h>
+
+#include <map>
+#include <string>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    class ContentionOperation;
+
+    /**
+     * Measures how the decaf locking primitives, the concurrent maps and the reference
+     * counted Pointer scale as the number of threads using a single instance goes from
+     * one to eight.  Each thread makes its share of a fixed number of operations, so on
+     * a machine with enough cores a primitive that scales well keeps its throughput as
+     * threads are added while one that serializes the threads loses it.
+     */
+    class ContentionBenchmark :
+        public benchmark::BenchmarkBase<
+            decaf::util::concurrent::ContentionBenchmark, locks::Lock, 10 >
+    {
+    private:
+
+        // Time spent on all the operations of each primitive at each thread count.
+        std::map< std::string, long long > nanos;
+        long long operations;
+
+    public:
+
+        ContentionBenchmark();
+        virtual ~ContentionBenchmark() {}
+
+        virtual void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        void contend( const std::string& name, ContentionOperation& operation );
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_CONTENTIONBENCHMARK_H_ */
@@ -0,0 +1,163 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HandoffLatencyBenchmark.h"
+
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/MPMCArrayBlockingQueue.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace benchmark;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int QUEUE_CAPACITY = 16;
+    const int NUM_VALUES = 20000;
+
+    class Producer : public Runnable {
+    private:
+
+        BlockingQueue<long long>* queue;
+        int count;
+
+    private:
+
+        Producer(const Producer&);
+        Producer& operator= (const Producer&);
+
+    public:
+
+        Producer(BlockingQueue<long long>* queue, int count) : Runnable(), queue(queue), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                queue->put(System::nanoTime());
+            }
+        }
+    };
+
+    class Consumer : public Runnable {
+    private:
+
+        BlockingQueue<long long>* queue;
+        int count;
+
+    public:
+
+        // Kept by each consumer and only merged once it has finished.
+        std::vector<long long> samples;
+
+    private:
+
+        Consumer(const Consumer&);
+        Consumer& operator= (const Consumer&);
+
+    public:
+
+        Consumer(BlockingQueue<long long>* queue, int count) :
+            Runnable(), queue(queue), count(count), samples() {
+
+            samples.reserve(count);
+        }
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                long long stamp = queue->take();
+                samples.push_back(System::nanoTime() - stamp);
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HandoffLatencyBenchmark::HandoffLatencyBenchmark() : latencies() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HandoffLatencyBenchmark::handoff(const std::string& name, BlockingQueue<long long>& queue, int pairs) {
+
+    std::vector<Producer*> producers;
+    std::vector<Consumer*> consumers;
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < pairs; ++i) {
+        consumers.push_back(new Consumer(&queue, NUM_VALUES / pairs));
+        threads.push_back(new Thread(consumers.back()));
+    }
+    for (int i = 0; i < pairs; ++i) {
+        producers.push_back(new Producer(&queue, NUM_VALUES / pairs));
+        threads.push_back(new Thread(producers.back()));
+    }
+
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->start();
+    }
+
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    std::ostringstream key;
+    key << name << " " << pairs << "x" << pairs;
+    LatencyHistogram& histogram = latencies[key.str()];
+
+    for (int i = 0; i < pairs; ++i) {
+        std::vector<long long>::const_iterator iter = consumers[i]->samples.begin();
+        for (; iter != consumers[i]->samples.end(); ++iter) {
+            histogram.record(*iter);
+        }
+
+        delete consumers[i];
+        delete producers[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HandoffLatencyBenchmark::run() {
+
+    for (int pairs = 1; pairs <= 4; pairs *= 2) {
+        {
+            LinkedBlockingQueue<long long> queue(QUEUE_CAPACITY);
+            handoff("LinkedBlockingQueue", queue, pairs);
+        }
+        {
+            MPMCArrayBlockingQueue<long long> queue(QUEUE_CAPACITY);
+            handoff("MPMCArrayBlockingQueue", queue, pairs);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void HandoffLatencyBenchmark::publishResults() {
+
+    std::map<std::string, LatencyHistogram>::const_iterator iter = latencies.begin();
+    for (; iter != latencies.end(); ++iter) {
+        iter->second.publish("Handoff", iter->first);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_HANDOFFLATENCYBENCHMARK_H_
+#define _DECAF_UTIL_CONCURRENT_HANDOFFLATENCYBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <benchmark/LatencyHistogram.h>
+#include <decaf/util/concurrent/BlockingQueue.h>
+
+#include <map>
+#include <string>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    /**
+     * Measures the time from a producer putting a value into a blocking queue until
+     * a consumer takes it, with one, two and four producer and consumer pairs sharing
+     * the queue.  The queue is kept small so that the latency is that of the hand off
+     * and the wake up of the consumer rather than the time spent waiting behind a
+     * long backlog.
+     */
+    class HandoffLatencyBenchmark :
+        public benchmark::BenchmarkBase<
+            decaf::util::concurrent::HandoffLatencyBenchmark, BlockingQueue<long long>, 5 >
+    {
+    private:
+
+        std::map< std::string, benchmark::LatencyHistogram > latencies;
+
+    public:
+
+        HandoffLatencyBenchmark();
+        virtual ~HandoffLatencyBenchmark() {}
+
+        virtual void run();
+
+    protected:
+
+        virtual void publishResults();
+
+    private:
+
+        void handoff( const std::string& name, BlockingQueue<long long>& queue, int pairs );
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_HANDOFFLATENCYBENCHMARK_H_ */
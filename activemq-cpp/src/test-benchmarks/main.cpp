@@ -20,9 +20,16 @@
 #include <cppunit/TestResult.h>
 #include <activemq/util/Config.h>
 #include <activemq/library/ActiveMQCPP.h>
+#include <benchmark/BenchmarkResults.h>
+#include <benchmark/BenchmarkSettings.h>
 #include <iostream>
+#include <fstream>
 
-int main( int argc AMQCPP_UNUSED, char **argv AMQCPP_UNUSED ) {
+int main( int argc, char **argv ) {
+
+    if( !benchmark::BenchmarkSettings::parse( argc, argv ) ) {
+        return 1;
+    }
 
     activemq::library::ActiveMQCPP::initializeLibrary();
     bool wasSuccessful = false;
@@ -43,6 +50,17 @@ int main( int argc AMQCPP_UNUSED, char **argv AMQCPP_UNUSED ) {
         std::cout << "Finished with the Benchmarks." << std::endl;
         std::cout << "=====================================================\n";
 
+        // Optionally save the results as CSV or JSON so runs can be compared.
+        if( !benchmark::BenchmarkSettings::getCsvFile().empty() ) {
+            std::ofstream results( benchmark::BenchmarkSettings::getCsvFile().c_str() );
+            benchmark::BenchmarkResults::writeTo( results );
+        }
+
+        if( !benchmark::BenchmarkSettings::getJsonFile().empty() ) {
+            std::ofstream results( benchmark::BenchmarkSettings::getJsonFile().c_str() );
+            benchmark::BenchmarkResults::writeJsonTo( results );
+        }
+
     } catch(...) {
         std::cout << "----------------------------------------" << std::endl;
         std::cout << "- AN ERROR HAS OCCURED:                -" << std::endl;
@@ -18,11 +18,27 @@
 #include <activemq/util/PrimitiveMapBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::PrimitiveMapBenchmark );
 
+#include <activemq/commands/MessagePropertiesBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::MessagePropertiesBenchmark );
+
+#include <activemq/wireformat/openwire/OpenWireFormatBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::OpenWireFormatBenchmark );
+
+#include <activemq/core/ActiveMQProducerBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQProducerBenchmark );
+#include <activemq/core/ActiveMQConsumerBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ActiveMQConsumerBenchmark );
+
 #include <decaf/lang/BooleanBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::lang::BooleanBenchmark );
+#include <decaf/lang/StringBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::lang::StringBenchmark );
 #include <decaf/lang/ThreadBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::lang::ThreadBenchmark );
 
+#include <decaf/net/URIBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::net::URIBenchmark );
+
 #include <decaf/util/PropertiesBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::PropertiesBenchmark );
 #include <decaf/util/QueueBenchmark.h>
@@ -37,6 +53,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::HashMapBenchmark );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::StlListBenchmark );
 #include <decaf/util/LinkedListBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::LinkedListBenchmark );
+#include <decaf/util/concurrent/BlockingQueueBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::BlockingQueueBenchmark );
+#include <decaf/util/concurrent/ContentionBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ContentionBenchmark );
+#include <decaf/util/concurrent/HandoffLatencyBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::HandoffLatencyBenchmark );
 
 #include <decaf/io/ByteArrayOutputStreamBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::io::ByteArrayOutputStreamBenchmark );
@@ -33,6 +33,7 @@
 #include <decaf/lang/Pointer.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/util/LinkedHashSet.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
 #include <decaf/util/concurrent/atomic/AtomicInteger.h>
 
 using namespace std;
@@ -20,6 +20,7 @@
 #include <activemq/core/ActiveMQXAConnectionFactory.h>
 #include <activemq/core/ActiveMQXAConnection.h>
 #include <activemq/core/ActiveMQXASession.h>
+#include <activemq/core/ActiveMQTransactionContext.h>
 #include <activemq/exceptions/ActiveMQException.h>
 #include <activemq/commands/XATransactionId.h>
 
@@ -603,3 +604,88 @@ void OpenwireXATransactionsTest::testXAResource_Exception3() {
 
     xaResource->forget( ixId.get() );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenwireXATransactionsTest::testCommitBranches() {
+
+    std::auto_ptr<XAConnectionFactory> factory(
+        XAConnectionFactory::createCMSXAConnectionFactory(getBrokerURL()));
+    std::auto_ptr<XAConnection> connection(factory->createXAConnection());
+
+    std::auto_ptr<XASession> session1(connection->createXASession());
+    std::auto_ptr<XASession> session2(connection->createXASession());
+    std::auto_ptr<XASession> session3(connection->createXASession());
+
+    std::auto_ptr<Destination> destination(session1->createTemporaryQueue());
+    std::auto_ptr<MessageProducer> producer1(session1->createProducer(destination.get()));
+    std::auto_ptr<MessageProducer> producer2(session2->createProducer(destination.get()));
+    std::auto_ptr<MessageConsumer> consumer(session3->createConsumer(destination.get()));
+
+    std::vector<ActiveMQTransactionContext*> resources;
+    resources.push_back(dynamic_cast<ActiveMQTransactionContext*>(session1->getXAResource()));
+    resources.push_back(dynamic_cast<ActiveMQTransactionContext*>(session2->getXAResource()));
+    CPPUNIT_ASSERT(resources[0] != NULL);
+    CPPUNIT_ASSERT(resources[1] != NULL);
+
+    connection->start();
+
+    std::auto_ptr<cms::Xid> xid1(this->createXid());
+    std::auto_ptr<cms::Xid> xid2(this->createXid());
+    std::vector<const cms::Xid*> xids;
+    xids.push_back(xid1.get());
+    xids.push_back(xid2.get());
+
+    resources[0]->start(xid1.get(), 0);
+    resources[1]->start(xid2.get(), 0);
+
+    std::auto_ptr<TextMessage> message(session1->createTextMessage("Branch Message"));
+    for (int i = 0; i < batchSize; i++) {
+        producer1->send(message.get());
+        producer2->send(message.get());
+    }
+
+    resources[0]->end(xid1.get(), XAResource::TMSUCCESS);
+    resources[1]->end(xid2.get(), XAResource::TMSUCCESS);
+
+    std::auto_ptr<cms::Message> received(consumer->receive(500));
+    CPPUNIT_ASSERT_MESSAGE("Received a message before the commit", received.get() == NULL);
+
+    CPPUNIT_ASSERT_NO_THROW_MESSAGE(
+        "Should not have thrown an Exception committing both branches",
+        ActiveMQTransactionContext::commitBranches(resources, xids));
+
+    for (int i = 0; i < batchSize * 2; i++) {
+        received.reset(consumer->receive(5000));
+        CPPUNIT_ASSERT_MESSAGE("Failed to receive all committed messages", received.get() != NULL);
+    }
+
+    // A single branch is committed in one phase.
+    std::auto_ptr<cms::Xid> xid3(this->createXid());
+    resources.resize(1);
+    xids.clear();
+    xids.push_back(xid3.get());
+
+    resources[0]->start(xid3.get(), 0);
+    producer1->send(message.get());
+    resources[0]->end(xid3.get(), XAResource::TMSUCCESS);
+
+    Pointer<ActiveMQTransactionContext::XAFuture> vote = resources[0]->prepareAsync(xid3.get());
+    CPPUNIT_ASSERT_EQUAL((int) XAResource::XA_OK, vote->get());
+    CPPUNIT_ASSERT(vote->isDone());
+    resources[0]->rollbackAsync(xid3.get())->get();
+
+    received.reset(consumer->receive(500));
+    CPPUNIT_ASSERT_MESSAGE("Received a rolled back message", received.get() == NULL);
+
+    std::auto_ptr<cms::Xid> xid4(this->createXid());
+    xids[0] = xid4.get();
+
+    resources[0]->start(xid4.get(), 0);
+    producer1->send(message.get());
+    resources[0]->end(xid4.get(), XAResource::TMSUCCESS);
+
+    ActiveMQTransactionContext::commitBranches(resources, xids);
+
+    received.reset(consumer->receive(5000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+}
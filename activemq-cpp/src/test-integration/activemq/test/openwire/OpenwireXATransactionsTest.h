@@ -45,6 +45,7 @@ namespace openwire {
         CPPUNIT_TEST( testSendRollback );
         CPPUNIT_TEST( testWithTTLSet );
         CPPUNIT_TEST( testSendRollbackCommitRollback );
+        CPPUNIT_TEST( testCommitBranches );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -75,6 +76,7 @@ namespace openwire {
         void testSendRollback();
         void testWithTTLSet();
         void testSendRollbackCommitRollback();
+        void testCommitBranches();
         void testXAResource_Exception1();
         void testXAResource_Exception2();
         void testXAResource_Exception3();
@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageSelectorRouterTest.h"
+#include <activemq/cmsutil/MessageSelectorRouter.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+
+#include <cms/ExceptionListener.h>
+#include <cms/InvalidSelectorException.h>
+#include <cms/MessageListener.h>
+
+#include <stdexcept>
+#include <string>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::commands;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingListener : public cms::MessageListener {
+    public:
+
+        int count;
+        bool fail;
+
+        RecordingListener(bool fail = false) : count(0), fail(fail) {}
+        virtual ~RecordingListener() {}
+
+        virtual void onMessage(const cms::Message* message AMQCPP_UNUSED) {
+            count++;
+            if (fail) {
+                throw std::runtime_error("Listener failed");
+            }
+        }
+    };
+
+    class RecordingExceptionListener : public cms::ExceptionListener {
+    public:
+
+        int count;
+
+        RecordingExceptionListener() : count(0) {}
+        virtual ~RecordingExceptionListener() {}
+
+        virtual void onException(const cms::CMSException& ex AMQCPP_UNUSED) {
+            count++;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouterTest::testRouting() {
+
+    MessageSelectorRouter router;
+    RecordingListener orders;
+    RecordingListener urgent;
+    RecordingListener all;
+
+    router.addRoute("type = 'order'", &orders);
+    router.addRoute("JMSPriority > 6", &urgent);
+    router.addRoute("", &all);
+
+    // A listener matched by two selectors is only handed the message once.
+    router.addRoute("type IS NOT NULL", &orders);
+
+    CPPUNIT_ASSERT_EQUAL(4, router.getRouteCount());
+
+    ActiveMQTextMessage order;
+    order.setStringProperty("type", "order");
+    order.setCMSPriority(4);
+
+    CPPUNIT_ASSERT_EQUAL(2, router.route(&order));
+    CPPUNIT_ASSERT_EQUAL(1, orders.count);
+    CPPUNIT_ASSERT_EQUAL(0, urgent.count);
+    CPPUNIT_ASSERT_EQUAL(1, all.count);
+
+    ActiveMQTextMessage alert;
+    alert.setCMSPriority(9);
+
+    router.onMessage(&alert);
+    CPPUNIT_ASSERT_EQUAL(1, orders.count);
+    CPPUNIT_ASSERT_EQUAL(1, urgent.count);
+    CPPUNIT_ASSERT_EQUAL(2, all.count);
+
+    CPPUNIT_ASSERT_EQUAL(0, router.route(NULL));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouterTest::testUnmatched() {
+
+    MessageSelectorRouter router;
+    RecordingListener orders;
+    RecordingListener unmatched;
+
+    router.addRoute("type = 'order'", &orders);
+    router.setUnmatchedListener(&unmatched);
+    CPPUNIT_ASSERT(router.getUnmatchedListener() == &unmatched);
+
+    ActiveMQTextMessage order;
+    order.setStringProperty("type", "order");
+
+    ActiveMQTextMessage other;
+    other.setStringProperty("type", "invoice");
+
+    CPPUNIT_ASSERT_EQUAL(1, router.route(&order));
+    CPPUNIT_ASSERT_EQUAL(1, router.route(&other));
+    CPPUNIT_ASSERT_EQUAL(1, orders.count);
+    CPPUNIT_ASSERT_EQUAL(1, unmatched.count);
+
+    router.setUnmatchedListener(NULL);
+    CPPUNIT_ASSERT_EQUAL(0, router.route(&other));
+    CPPUNIT_ASSERT_EQUAL(1, unmatched.count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouterTest::testRemoveRoutes() {
+
+    MessageSelectorRouter router;
+    RecordingListener first;
+    RecordingListener second;
+
+    router.addRoute("a = 1", &first);
+    router.addRoute("a = 1", &second);
+    router.addRoute("a > 0", &first);
+    CPPUNIT_ASSERT_EQUAL(3, router.getRouteCount());
+
+    CPPUNIT_ASSERT(!router.removeRoute("a = 2", &first));
+    CPPUNIT_ASSERT(!router.removeRoute("a > 0", &second));
+    CPPUNIT_ASSERT(router.removeRoute("a = 1", &second));
+    CPPUNIT_ASSERT_EQUAL(2, router.getRouteCount());
+
+    ActiveMQTextMessage message;
+    message.setIntProperty("a", 1);
+
+    CPPUNIT_ASSERT_EQUAL(1, router.route(&message));
+    CPPUNIT_ASSERT_EQUAL(1, first.count);
+    CPPUNIT_ASSERT_EQUAL(0, second.count);
+
+    CPPUNIT_ASSERT_EQUAL(2, router.removeListener(&first));
+    CPPUNIT_ASSERT_EQUAL(0, router.removeListener(&first));
+    CPPUNIT_ASSERT_EQUAL(0, router.getRouteCount());
+    CPPUNIT_ASSERT_EQUAL(0, router.route(&message));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouterTest::testListenerErrors() {
+
+    MessageSelectorRouter router;
+    RecordingListener failing(true);
+    RecordingListener working;
+    RecordingExceptionListener errors;
+
+    router.addRoute("", &failing);
+    router.addRoute("", &working);
+
+    ActiveMQTextMessage message;
+
+    // Without an exception listener the error is dropped.
+    CPPUNIT_ASSERT_NO_THROW(router.onMessage(&message));
+    CPPUNIT_ASSERT_EQUAL(1, working.count);
+
+    router.setExceptionListener(&errors);
+    CPPUNIT_ASSERT(router.getExceptionListener() == &errors);
+
+    CPPUNIT_ASSERT_EQUAL(2, router.route(&message));
+    CPPUNIT_ASSERT_EQUAL(2, failing.count);
+    CPPUNIT_ASSERT_EQUAL(2, working.count);
+    CPPUNIT_ASSERT_EQUAL(1, errors.count);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException for a NULL listener",
+        router.addRoute("", NULL),
+        cms::CMSException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorRouterTest::testInvalidSelector() {
+
+    MessageSelectorRouter router;
+    RecordingListener listener;
+
+    router.addRoute("a = 1", &listener);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an InvalidSelectorException",
+        router.addRoute("a = ", &listener),
+        cms::InvalidSelectorException);
+
+    CPPUNIT_ASSERT_EQUAL(1, router.getRouteCount());
+}
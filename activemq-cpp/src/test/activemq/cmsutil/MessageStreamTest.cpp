@@ -0,0 +1,224 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageStreamTest.h"
+#include <activemq/cmsutil/MessageInputStream.h>
+#include <activemq/cmsutil/MessageOutputStream.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include "DummyConsumer.h"
+#include "DummyProducer.h"
+#include "DummySession.h"
+#include "MessageContext.h"
+
+#include <decaf/io/IOException.h>
+
+#include <deque>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::commands;
+using namespace decaf::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class BytesMessageSession : public DummySession {
+    public:
+
+        BytesMessageSession(MessageContext* context) : DummySession(context) {}
+
+        virtual ~BytesMessageSession() {}
+
+        virtual cms::BytesMessage* createBytesMessage() {
+            return new ActiveMQBytesMessage();
+        }
+    };
+
+    // Queues a read only copy of each message sent and hands them back in order.
+    class MessageQueue : public MessageContext::SendListener {
+    public:
+
+        std::deque<cms::Message*> messages;
+
+        MessageQueue() : messages() {}
+
+        virtual ~MessageQueue() {
+            while (!messages.empty()) {
+                delete messages.front();
+                messages.pop_front();
+            }
+        }
+
+        virtual void onSend(const cms::Destination* destination AMQCPP_UNUSED, cms::Message* message,
+                            int deliveryMode AMQCPP_UNUSED, int priority AMQCPP_UNUSED,
+                            long long timeToLive AMQCPP_UNUSED) {
+
+            cms::BytesMessage* copy = dynamic_cast<cms::BytesMessage*>(message)->clone();
+            copy->reset();
+            messages.push_back(copy);
+        }
+
+        virtual cms::Message* doReceive(const cms::Destination* dest AMQCPP_UNUSED,
+                                        const std::string& selector AMQCPP_UNUSED,
+                                        bool noLocal AMQCPP_UNUSED, long long timeout AMQCPP_UNUSED) {
+
+            if (messages.empty()) {
+                return NULL;
+            }
+
+            cms::Message* message = messages.front();
+            messages.pop_front();
+            return message;
+        }
+    };
+
+    class StreamFixture {
+    public:
+
+        MessageContext context;
+        MessageQueue queue;
+        BytesMessageSession session;
+        DummyProducer producer;
+        DummyConsumer consumer;
+
+        StreamFixture() : context(), queue(), session(&context), producer(&context, NULL),
+                          consumer(&context, NULL, "", false) {
+            context.setSendListener(&queue);
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageStreamTest::testRoundTrip() {
+
+    StreamFixture fixture;
+
+    std::vector<unsigned char> body(10000);
+    for (std::size_t i = 0; i < body.size(); ++i) {
+        body[i] = (unsigned char) (i % 251);
+    }
+
+    MessageOutputStream output(&fixture.session, &fixture.producer, 4096);
+    output.write(&body[0], (int) body.size(), 0, 100);
+    output.write(&body[0], (int) body.size(), 100, (int) body.size() - 100);
+    output.close();
+
+    CPPUNIT_ASSERT_EQUAL(3, output.getChunksSent());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 4, fixture.queue.messages.size());
+
+    const int expectedSequence[] = { 1, 2, 3, -1 };
+    const int expectedLength[] = { 4096, 4096, 1808, 0 };
+    for (int i = 0; i < 4; ++i) {
+        cms::BytesMessage* chunk = dynamic_cast<cms::BytesMessage*>(fixture.queue.messages[i]);
+        CPPUNIT_ASSERT(chunk != NULL);
+        CPPUNIT_ASSERT_EQUAL(output.getStreamId(), chunk->getStringProperty("JMSXGroupID"));
+        CPPUNIT_ASSERT_EQUAL(expectedSequence[i], chunk->getIntProperty("JMSXGroupSeq"));
+        CPPUNIT_ASSERT_EQUAL(expectedLength[i], chunk->getBodyLength());
+    }
+
+    MessageInputStream input(&fixture.consumer);
+
+    std::vector<unsigned char> received(body.size() + 10);
+    int total = 0;
+    int read = 0;
+    while ((read = input.read(&received[0], (int) received.size(), total, 3000)) != -1) {
+        total += read;
+        CPPUNIT_ASSERT(total <= (int) body.size());
+    }
+
+    CPPUNIT_ASSERT_EQUAL((int) body.size(), total);
+    received.resize(body.size());
+    CPPUNIT_ASSERT(received == body);
+    CPPUNIT_ASSERT_EQUAL(output.getStreamId(), input.getStreamId());
+    CPPUNIT_ASSERT_EQUAL(-1, input.read());
+    CPPUNIT_ASSERT(fixture.queue.messages.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageStreamTest::testEmptyStream() {
+
+    StreamFixture fixture;
+
+    MessageOutputStream output(&fixture.session, &fixture.producer);
+    output.flush();
+    output.close();
+    output.close();
+
+    CPPUNIT_ASSERT_EQUAL(0, output.getChunksSent());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, fixture.queue.messages.size());
+
+    MessageInputStream input(&fixture.consumer);
+    CPPUNIT_ASSERT_EQUAL(-1, input.read());
+    CPPUNIT_ASSERT_EQUAL(output.getStreamId(), input.getStreamId());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageStreamTest::testMissingChunk() {
+
+    StreamFixture fixture;
+
+    std::vector<unsigned char> body(30, 7);
+
+    {
+        MessageOutputStream output(&fixture.session, &fixture.producer, 10);
+        output.write(&body[0], (int) body.size());
+    }
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 4, fixture.queue.messages.size());
+
+    delete fixture.queue.messages[1];
+    fixture.queue.messages.erase(fixture.queue.messages.begin() + 1);
+
+    MessageInputStream input(&fixture.consumer);
+
+    unsigned char buffer[30];
+    CPPUNIT_ASSERT_EQUAL(10, input.read(buffer, 30));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when a chunk is missing",
+        input.read(buffer, 30),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageStreamTest::testWriteAfterClose() {
+
+    StreamFixture fixture;
+
+    MessageOutputStream output(&fixture.session, &fixture.producer);
+    output.write('a');
+    output.close();
+
+    CPPUNIT_ASSERT_EQUAL(1, output.getChunksSent());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when writing to a closed stream",
+        output.write('b'),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageStreamTest::testReceiveTimeout() {
+
+    StreamFixture fixture;
+
+    MessageInputStream input(&fixture.consumer, 10);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when no chunk arrives",
+        input.read(),
+        IOException);
+}
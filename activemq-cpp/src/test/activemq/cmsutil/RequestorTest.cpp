@@ -0,0 +1,290 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RequestorTest.h"
+#include <activemq/cmsutil/Requestor.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include "DummyConnection.h"
+#include "DummySession.h"
+#include "MessageContext.h"
+
+#include <cms/CMSException.h>
+#include <cms/TextMessage.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::cmsutil;
+using namespace activemq::commands;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class ReplySession : public DummySession {
+    public:
+
+        ReplySession(MessageContext* context) : DummySession(context) {}
+
+        virtual ~ReplySession() {}
+
+        virtual cms::TemporaryQueue* createTemporaryQueue() {
+            return new ActiveMQTempQueue("ID:reply-queue");
+        }
+    };
+
+    class ReplyConnection : public DummyConnection {
+    private:
+
+        MessageContext* context;
+
+    private:
+
+        ReplyConnection(const ReplyConnection&);
+        ReplyConnection& operator= (const ReplyConnection&);
+
+    public:
+
+        ReplyConnection(MessageContext* context) : DummyConnection(context), context(context) {}
+
+        virtual ~ReplyConnection() {}
+
+        virtual cms::Session* createSession(cms::Session::AcknowledgeMode ackMode) {
+            ReplySession* session = new ReplySession(context);
+            session->setAcknowledgeMode(ackMode);
+            return session;
+        }
+    };
+
+    // Answers each request with its text prefixed by "re:", or records the requests
+    // so the test can answer them later.
+    class Responder : public MessageContext::SendListener {
+    public:
+
+        Requestor* requestor;
+        bool respond;
+        std::vector<std::string> correlationIds;
+        std::vector<std::string> texts;
+
+        Responder() : requestor(NULL), respond(true), correlationIds(), texts() {}
+
+        virtual ~Responder() {}
+
+        virtual void onSend(const cms::Destination* destination AMQCPP_UNUSED, cms::Message* message,
+                            int deliveryMode AMQCPP_UNUSED, int priority AMQCPP_UNUSED,
+                            long long timeToLive AMQCPP_UNUSED) {
+
+            CPPUNIT_ASSERT(message->getCMSReplyTo() != NULL);
+            CPPUNIT_ASSERT(message->getCMSReplyTo()->equals(*requestor->getReplyDestination()));
+
+            std::string text = dynamic_cast<cms::TextMessage*>(message)->getText();
+
+            if (respond) {
+                reply(message->getCMSCorrelationID(), "re:" + text);
+            } else {
+                correlationIds.push_back(message->getCMSCorrelationID());
+                texts.push_back(text);
+            }
+        }
+
+        virtual cms::Message* doReceive(const cms::Destination* dest AMQCPP_UNUSED,
+                                        const std::string& selector AMQCPP_UNUSED,
+                                        bool noLocal AMQCPP_UNUSED, long long timeout AMQCPP_UNUSED) {
+            return NULL;
+        }
+
+        void reply(const std::string& correlationId, const std::string& text) {
+            ActiveMQTextMessage reply;
+            reply.setText(text);
+            reply.setCMSCorrelationID(correlationId);
+            requestor->onMessage(&reply);
+        }
+    };
+
+    std::string replyText(cms::Message* message) {
+        std::auto_ptr<cms::Message> owned(message);
+        CPPUNIT_ASSERT(owned.get() != NULL);
+        return dynamic_cast<cms::TextMessage*>(owned.get())->getText();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorTest::testSendAndReceive() {
+
+    MessageContext context;
+    Responder responder;
+    context.setSendListener(&responder);
+    ReplyConnection connection(&context);
+
+    Requestor requestor(&connection);
+    responder.requestor = &requestor;
+
+    ActiveMQQueue service("service");
+    ActiveMQTextMessage request;
+    request.setText("hello");
+
+    CPPUNIT_ASSERT_EQUAL(std::string("re:hello"), replyText(requestor.sendAndReceive(&service, &request, 0)));
+    CPPUNIT_ASSERT_EQUAL(0, requestor.getPendingCount());
+
+    request.setText("again");
+    CPPUNIT_ASSERT_EQUAL(std::string("re:again"), replyText(requestor.sendAndReceive(&service, &request, 5000)));
+    CPPUNIT_ASSERT_EQUAL(0, requestor.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorTest::testPipelinedRequests() {
+
+    MessageContext context;
+    Responder responder;
+    responder.respond = false;
+    context.setSendListener(&responder);
+    ReplyConnection connection(&context);
+
+    Requestor requestor(&connection);
+    responder.requestor = &requestor;
+
+    ActiveMQQueue service("service");
+    std::vector< Pointer<Requestor::Reply> > replies;
+
+    for (int i = 0; i < 5; ++i) {
+        ActiveMQTextMessage request;
+        request.setText(std::string(1, (char) ('a' + i)));
+        replies.push_back(requestor.request(&service, &request, 0));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(5, requestor.getPendingCount());
+    CPPUNIT_ASSERT(!replies[0]->isDone());
+    CPPUNIT_ASSERT(replies[0]->getReply(10) == NULL);
+
+    // Answered out of order, each reply still finds its request.
+    for (int i = 4; i >= 0; --i) {
+        responder.reply(responder.correlationIds[i], "re:" + responder.texts[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, requestor.getPendingCount());
+
+    for (int i = 0; i < 5; ++i) {
+        CPPUNIT_ASSERT(replies[i]->isDone());
+        CPPUNIT_ASSERT_EQUAL(Requestor::Reply::REPLIED, replies[i]->getState());
+        CPPUNIT_ASSERT_EQUAL("re:" + std::string(1, (char) ('a' + i)), replyText(replies[i]->getReply()));
+        CPPUNIT_ASSERT(replies[i]->getReply() == NULL);
+    }
+
+    // Replies for unknown requests are dropped.
+    responder.reply(responder.correlationIds[0], "duplicate");
+    responder.reply("ID:someone-else:1", "stray");
+    CPPUNIT_ASSERT_EQUAL(0, requestor.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorTest::testTimeout() {
+
+    MessageContext context;
+    Responder responder;
+    responder.respond = false;
+    context.setSendListener(&responder);
+    ReplyConnection connection(&context);
+
+    Requestor requestor(&connection);
+    responder.requestor = &requestor;
+
+    ActiveMQQueue service("service");
+    ActiveMQTextMessage request;
+    request.setText("slow");
+
+    Pointer<Requestor::Reply> reply = requestor.request(&service, &request, 50);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException when the request times out",
+        reply->getReply(),
+        cms::CMSException);
+
+    CPPUNIT_ASSERT_EQUAL(Requestor::Reply::TIMED_OUT, reply->getState());
+    CPPUNIT_ASSERT_EQUAL(0, requestor.getPendingCount());
+
+    // The late reply is dropped.
+    responder.reply(responder.correlationIds[0], "late");
+    CPPUNIT_ASSERT_EQUAL(Requestor::Reply::TIMED_OUT, reply->getState());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorTest::testClose() {
+
+    MessageContext context;
+    Responder responder;
+    responder.respond = false;
+    context.setSendListener(&responder);
+    ReplyConnection connection(&context);
+
+    Requestor requestor(&connection);
+    responder.requestor = &requestor;
+
+    ActiveMQQueue service("service");
+    ActiveMQTextMessage request;
+    request.setText("never");
+
+    Pointer<Requestor::Reply> reply = requestor.request(&service, &request, 0);
+    requestor.close();
+
+    CPPUNIT_ASSERT_EQUAL(Requestor::Reply::FAILED, reply->getState());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException when the requestor closed first",
+        reply->getReply(),
+        cms::CMSException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException when sending on a closed requestor",
+        requestor.request(&service, &request, 0),
+        cms::CMSException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RequestorTest::testTooManyPendingRequests() {
+
+    MessageContext context;
+    Responder responder;
+    responder.respond = false;
+    context.setSendListener(&responder);
+    ReplyConnection connection(&context);
+
+    Requestor requestor(&connection, 2);
+    responder.requestor = &requestor;
+
+    ActiveMQQueue service("service");
+    ActiveMQTextMessage request;
+    request.setText("busy");
+
+    Pointer<Requestor::Reply> first = requestor.request(&service, &request, 0);
+    Pointer<Requestor::Reply> second = requestor.request(&service, &request, 0);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException when every slot is waiting",
+        requestor.request(&service, &request, 0),
+        cms::CMSException);
+
+    // Answering the first frees a slot for the next request.
+    responder.reply(responder.correlationIds[0], "done");
+    Pointer<Requestor::Reply> third = requestor.request(&service, &request, 0);
+
+    CPPUNIT_ASSERT_EQUAL(2, requestor.getPendingCount());
+    CPPUNIT_ASSERT(!second->isDone());
+    CPPUNIT_ASSERT(!third->isDone());
+}
@@ -19,8 +19,38 @@
 #include "DummyConnection.h"
 #include <activemq/cmsutil/SessionPool.h>
 #include <activemq/cmsutil/ResourceLifecycleManager.h>
+#include <activemq/commands/ActiveMQQueue.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
 
 using namespace activemq::cmsutil;
+using namespace activemq::commands;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class TakeAndReturn : public decaf::lang::Runnable {
+    private:
+
+        TakeAndReturn(const TakeAndReturn&);
+        TakeAndReturn& operator= (const TakeAndReturn&);
+
+    public:
+
+        SessionPool* pool;
+        PooledSession* taken;
+
+        TakeAndReturn(SessionPool* pool) : pool(pool), taken(NULL) {}
+
+        virtual ~TakeAndReturn() {}
+
+        virtual void run() {
+            taken = pool->takeSession();
+            pool->returnSession(taken);
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void SessionPoolTest::testTakeSession() {
@@ -87,3 +117,90 @@ void SessionPoolTest::testCloseSession() {
     // Make sure they're the same object.
     CPPUNIT_ASSERT(pooledSession1 == pooledSession2); 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SessionPoolTest::testThreadAffinity() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    CPPUNIT_ASSERT(pool.isThreadAffinity());
+
+    PooledSession* pooledSession1 = pool.takeSession();
+    PooledSession* pooledSession2 = pool.takeSession();
+
+    // The first session returned is kept by this thread, the second is shared.
+    pool.returnSession(pooledSession1);
+    pool.returnSession(pooledSession2);
+
+    // Another thread can only get the shared session.
+    TakeAndReturn other(&pool);
+    decaf::lang::Thread thread(&other);
+    thread.start();
+    thread.join();
+    CPPUNIT_ASSERT(other.taken == pooledSession2);
+
+    CPPUNIT_ASSERT(pool.takeSession() == pooledSession1);
+
+    // The other thread kept the session it returned, so a new one is created.
+    PooledSession* pooledSession3 = pool.takeSession();
+    CPPUNIT_ASSERT(pooledSession3 != pooledSession1);
+    CPPUNIT_ASSERT(pooledSession3 != pooledSession2);
+
+    CPPUNIT_ASSERT_EQUAL(3, pool.getSessionCount());
+    CPPUNIT_ASSERT_EQUAL(1, pool.getThreadSessionTakes());
+    CPPUNIT_ASSERT_EQUAL(4, pool.getSharedSessionTakes());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SessionPoolTest::testNoThreadAffinity() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    pool.setThreadAffinity(false);
+
+    PooledSession* pooledSession1 = pool.takeSession();
+    pool.returnSession(pooledSession1);
+
+    TakeAndReturn other(&pool);
+    decaf::lang::Thread thread(&other);
+    thread.start();
+    thread.join();
+    CPPUNIT_ASSERT(other.taken == pooledSession1);
+
+    CPPUNIT_ASSERT_EQUAL(1, pool.getSessionCount());
+    CPPUNIT_ASSERT_EQUAL(0, pool.getThreadSessionTakes());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SessionPoolTest::testCachedProducers() {
+
+    DummyConnection connection(NULL);
+    ResourceLifecycleManager mgr;
+
+    SessionPool pool(&connection, cms::Session::AUTO_ACKNOWLEDGE, &mgr);
+    PooledSession* pooledSession = pool.takeSession();
+
+    ActiveMQQueue queue("A");
+    ActiveMQQueue sameName("A");
+
+    cms::MessageProducer* producer = pooledSession->createCachedProducer(&queue);
+    CPPUNIT_ASSERT(producer != NULL);
+    CPPUNIT_ASSERT(pooledSession->createCachedProducer(&queue) == producer);
+    CPPUNIT_ASSERT(pooledSession->createCachedProducer(&sameName) == producer);
+    CPPUNIT_ASSERT_EQUAL(2, pool.getProducerCacheHits());
+    CPPUNIT_ASSERT_EQUAL(1, pool.getProducerCacheMisses());
+
+    // The same object now naming another destination must not find the old producer.
+    queue.setPhysicalName("B");
+    cms::MessageProducer* other = pooledSession->createCachedProducer(&queue);
+    CPPUNIT_ASSERT(other != producer);
+    CPPUNIT_ASSERT(pooledSession->createCachedProducer(&queue) == other);
+    CPPUNIT_ASSERT_EQUAL(3, pool.getProducerCacheHits());
+    CPPUNIT_ASSERT_EQUAL(2, pool.getProducerCacheMisses());
+
+    pool.returnSession(pooledSession);
+}
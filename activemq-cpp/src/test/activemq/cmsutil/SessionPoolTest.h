@@ -30,6 +30,9 @@ namespace cmsutil{
         CPPUNIT_TEST( testTakeSession );
         CPPUNIT_TEST( testReturnSession );
         CPPUNIT_TEST( testCloseSession );
+        CPPUNIT_TEST( testThreadAffinity );
+        CPPUNIT_TEST( testNoThreadAffinity );
+        CPPUNIT_TEST( testCachedProducers );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +43,9 @@ namespace cmsutil{
         void testTakeSession();
         void testReturnSession();
         void testCloseSession();
+        void testThreadAffinity();
+        void testNoThreadAffinity();
+        void testCachedProducers();
     };
 
 }}
@@ -21,6 +21,8 @@
 #include <decaf/lang/Exception.h>
 #include <activemq/commands/ActiveMQBytesMessage.h>
 
+#include <memory>
+
 using namespace std;
 using namespace cms;
 using namespace activemq;
@@ -29,6 +31,24 @@ using namespace activemq::commands;
 using namespace decaf;
 using namespace decaf::lang;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class MyReleaser : public CopyOnWriteBytes::Releaser {
+    public:
+
+        int released;
+
+        MyReleaser() : released(0) {}
+
+        virtual ~MyReleaser() {}
+
+        virtual void release(const unsigned char* bytes AMQCPP_UNUSED, std::size_t length AMQCPP_UNUSED) {
+            this->released++;
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQBytesMessageTest::testGetBodyLength() {
     ActiveMQBytesMessage msg;
@@ -459,3 +479,116 @@ void ActiveMQBytesMessageTest::testWriteOnlyBody() {
     } catch( MessageNotReadableException& e ) {
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testCloneSharesContent() {
+
+    ActiveMQBytesMessage message;
+    message.writeInt(42);
+    message.writeLong(311);
+    message.setIntProperty("count", 3);
+    message.reset();
+
+    std::auto_ptr<ActiveMQBytesMessage> copy(message.cloneDataStructure());
+
+    const ActiveMQBytesMessage& original = message;
+    const ActiveMQBytesMessage& cloned = *copy;
+
+    // The body is shared by the clone until one of them changes it.
+    CPPUNIT_ASSERT(&original.getContent() == &cloned.getContent());
+    CPPUNIT_ASSERT_EQUAL(42, copy->readInt());
+    CPPUNIT_ASSERT_EQUAL(311LL, copy->readLong());
+    CPPUNIT_ASSERT_EQUAL(3, copy->getIntProperty("count"));
+
+    copy->clearBody();
+    copy->writeInt(7);
+    copy->reset();
+
+    CPPUNIT_ASSERT(&original.getContent() != &cloned.getContent());
+    CPPUNIT_ASSERT_EQUAL(7, copy->readInt());
+    CPPUNIT_ASSERT_EQUAL(42, message.readInt());
+    CPPUNIT_ASSERT_EQUAL(311LL, message.readLong());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testAttachBodyBytes() {
+
+    unsigned char body[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    MyReleaser releaser;
+
+    {
+        ActiveMQBytesMessage message;
+        message.attachBodyBytes(body, (int) sizeof(body), &releaser);
+
+        const ActiveMQBytesMessage& constMessage = message;
+        CPPUNIT_ASSERT(constMessage.getContentBytes().isAttached());
+        CPPUNIT_ASSERT(constMessage.getContentBytes().data() == body);
+        CPPUNIT_ASSERT(!message.isCompressed());
+
+        std::auto_ptr<ActiveMQBytesMessage> copy(message.cloneDataStructure());
+        const ActiveMQBytesMessage& constCopy = *copy;
+        CPPUNIT_ASSERT(constCopy.getContentBytes().data() == body);
+
+        message.reset();
+        CPPUNIT_ASSERT_EQUAL(8, message.getBodyLength());
+        CPPUNIT_ASSERT_EQUAL(1, (int) message.readByte());
+
+        // The copy still reads the attached bytes in place.
+        CPPUNIT_ASSERT_EQUAL(0, releaser.released);
+        CPPUNIT_ASSERT(constCopy.getContentBytes().isAttached());
+
+        copy->writeByte(9);
+        copy->reset();
+        CPPUNIT_ASSERT_EQUAL(9, copy->getBodyLength());
+        CPPUNIT_ASSERT_EQUAL(1, releaser.released);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, releaser.released);
+
+    ActiveMQBytesMessage readOnly;
+    readOnly.reset();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotWriteableException",
+        readOnly.attachBodyBytes(body, (int) sizeof(body), NULL),
+        MessageNotWriteableException);
+
+    ActiveMQBytesMessage negative;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        negative.attachBodyBytes(body, -1, NULL),
+        CMSException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQBytesMessageTest::testBodyView() {
+
+    ActiveMQBytesMessage message;
+    int length = -1;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotReadableException",
+        message.getBodyView(length),
+        MessageNotReadableException);
+
+    message.writeInt(42);
+    message.writeByte(7);
+    message.reset();
+
+    const unsigned char* view = message.getBodyView(length);
+    CPPUNIT_ASSERT_EQUAL(5, length);
+    CPPUNIT_ASSERT(view != NULL);
+    CPPUNIT_ASSERT_EQUAL(42, (int) view[3]);
+    CPPUNIT_ASSERT_EQUAL(7, (int) view[4]);
+
+    // The view is the content itself and doesn't move the read position.
+    const ActiveMQBytesMessage& constMessage = message;
+    CPPUNIT_ASSERT(view == constMessage.getContentBytes().data());
+    CPPUNIT_ASSERT_EQUAL(42, message.readInt());
+    CPPUNIT_ASSERT(message.getBodyView(length) == view);
+    CPPUNIT_ASSERT_EQUAL(7, (int) message.readByte());
+
+    ActiveMQBytesMessage empty;
+    empty.reset();
+    CPPUNIT_ASSERT(empty.getBodyView(length) == NULL);
+    CPPUNIT_ASSERT_EQUAL(0, length);
+}
@@ -43,6 +43,9 @@ namespace commands{
         CPPUNIT_TEST( testReset );
         CPPUNIT_TEST( testReadOnlyBody );
         CPPUNIT_TEST( testWriteOnlyBody );
+        CPPUNIT_TEST( testCloneSharesContent );
+        CPPUNIT_TEST( testAttachBodyBytes );
+        CPPUNIT_TEST( testBodyView );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -67,6 +70,9 @@ namespace commands{
         void testReset();
         void testReadOnlyBody();
         void testWriteOnlyBody();
+        void testCloneSharesContent();
+        void testAttachBodyBytes();
+        void testBodyView();
 
     };
 
@@ -136,3 +136,22 @@ void ActiveMQDestinationTest::testOptions(){
     CPPUNIT_ASSERT( std::string( properties.getProperty( "option1" ) ) == "test1" );
     CPPUNIT_ASSERT( std::string( properties.getProperty( "option2" ) ) == "test2" );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQDestinationTest::testMatchesWildcard(){
+
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "ORDERS.EU", "ORDERS.EU" ) );
+    CPPUNIT_ASSERT( !ActiveMQDestination::matchesWildcard( "ORDERS.EU", "ORDERS.EUROPE" ) );
+    CPPUNIT_ASSERT( !ActiveMQDestination::matchesWildcard( "ORDERS.EU", "ORDERS.EU.DE" ) );
+
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "ORDERS.*", "ORDERS.EU" ) );
+    CPPUNIT_ASSERT( !ActiveMQDestination::matchesWildcard( "ORDERS.*", "ORDERS" ) );
+    CPPUNIT_ASSERT( !ActiveMQDestination::matchesWildcard( "ORDERS.*", "ORDERS.EU.DE" ) );
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "*.EU.*", "ORDERS.EU.DE" ) );
+
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "ORDERS.>", "ORDERS.EU" ) );
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "ORDERS.>", "ORDERS.EU.DE" ) );
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( "ORDERS.>", "ORDERS" ) );
+    CPPUNIT_ASSERT( !ActiveMQDestination::matchesWildcard( "ORDERS.>", "PRICES.EU" ) );
+    CPPUNIT_ASSERT( ActiveMQDestination::matchesWildcard( ">", "ANY.NAME" ) );
+}
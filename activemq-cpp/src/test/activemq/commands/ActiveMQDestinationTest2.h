@@ -31,6 +31,7 @@ namespace commands{
         CPPUNIT_TEST_SUITE( ActiveMQDestinationTest );
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( testOptions );
+        CPPUNIT_TEST( testMatchesWildcard );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +41,7 @@ namespace commands{
 
         virtual void test();
         virtual void testOptions();
+        virtual void testMatchesWildcard();
 
     };
 
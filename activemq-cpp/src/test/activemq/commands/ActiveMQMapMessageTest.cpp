@@ -475,3 +475,49 @@ void ActiveMQMapMessageTest::testWriteOnlyBody() {
     msg.getShort( "short" );
     msg.getString( "string" );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMapMessageTest::testIndexedAccess() {
+
+    ActiveMQMapMessage msg;
+
+    std::vector<unsigned char> bytes( 3, 'a' );
+
+    msg.setBoolean( "boolean", true );
+    msg.setBytes( "bytes", bytes );
+    msg.setInt( "int", 42 );
+    msg.setLong( "long", 0xFFFAAA33345LL );
+    msg.setString( "string", "string" );
+    msg.beforeMarshal( NULL );
+
+    // Received as content only, fields are decoded as they are read.
+    ActiveMQMapMessage received;
+    received.setContent( msg.getContent() );
+
+    CPPUNIT_ASSERT( !received.isEmpty() );
+    CPPUNIT_ASSERT_EQUAL( (std::size_t)5, received.getMapNames().size() );
+    CPPUNIT_ASSERT( received.itemExists( "long" ) );
+    CPPUNIT_ASSERT( !received.itemExists( "doesntExist" ) );
+    CPPUNIT_ASSERT_EQUAL( 0xFFFAAA33345LL, received.getLong( "long" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "string" ), received.getString( "string" ) );
+    CPPUNIT_ASSERT_EQUAL( 42, received.getInt( "int" ) );
+    CPPUNIT_ASSERT( received.getBytes( "bytes" ) == bytes );
+    CPPUNIT_ASSERT_EQUAL( cms::Message::BOOLEAN_TYPE, received.getValueType( "boolean" ) );
+    CPPUNIT_ASSERT_THROW( received.getString( "doesntExist" ), cms::CMSException );
+
+    // Sent on unchanged the content is the one it arrived with.
+    std::vector<unsigned char> content = received.getContent();
+    received.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( content == received.getContent() );
+
+    // Once changed the whole map is encoded again.
+    received.setReadOnlyBody( false );
+    received.setInt( "int", 7 );
+    received.beforeMarshal( NULL );
+
+    ActiveMQMapMessage resent;
+    resent.setContent( received.getContent() );
+    CPPUNIT_ASSERT_EQUAL( 7, resent.getInt( "int" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "string" ), resent.getString( "string" ) );
+    CPPUNIT_ASSERT_EQUAL( (std::size_t)5, resent.getMapNames().size() );
+}
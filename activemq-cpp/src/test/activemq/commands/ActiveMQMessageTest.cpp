@@ -21,6 +21,7 @@
 #include <activemq/commands/ActiveMQTopic.h>
 #include <activemq/commands/ActiveMQTempTopic.h>
 #include <activemq/commands/ProducerId.h>
+#include <activemq/wireformat/openwire/marshal/PrimitiveTypesMarshaller.h>
 
 #include <decaf/lang/System.h>
 #include <decaf/lang/Pointer.h>
@@ -31,6 +32,7 @@ using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::core;
 using namespace activemq::commands;
+using namespace activemq::wireformat::openwire::marshal;
 using namespace decaf::lang;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -818,3 +820,139 @@ void ActiveMQMessageTest::testIsExpired() {
     msg.setCMSExpiration( System::currentTimeMillis() + 10000 );
     CPPUNIT_ASSERT( !msg.isExpired() );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testPropertiesUnmarshaledOnFirstUse() {
+
+    PrimitiveMap sent;
+    sent.setString( "symbol", "ACME" );
+    sent.setInt( "price", 42 );
+
+    std::vector<unsigned char> marshaled;
+    PrimitiveTypesMarshaller::marshal( &sent, marshaled );
+
+    ActiveMQMessage msg;
+    msg.setMarshalledProperties( marshaled );
+    msg.afterUnmarshal( NULL );
+
+    // Nothing is decoded until asked for, and an untouched message sends
+    // the properties on exactly as they arrived.
+    msg.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( msg.getMarshalledProperties() == marshaled );
+
+    Pointer<Message> copy = msg.copy();
+    CPPUNIT_ASSERT( copy->getMessageProperties().size() == 2 );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "ACME" ), msg.getStringProperty( "symbol" ) );
+    CPPUNIT_ASSERT_EQUAL( 42, msg.getIntProperty( "price" ) );
+    CPPUNIT_ASSERT( msg.propertyExists( "symbol" ) );
+    CPPUNIT_ASSERT( msg.getMessageProperties().equals( copy->getMessageProperties() ) );
+
+    // Once decoded a change to the properties is marshaled again.
+    msg.getMessageProperties().setString( "symbol", "XYZ" );
+    msg.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( msg.getMarshalledProperties() != marshaled );
+
+    ActiveMQMessage received;
+    received.setMarshalledProperties( msg.getMarshalledProperties() );
+    received.afterUnmarshal( NULL );
+    CPPUNIT_ASSERT_EQUAL( std::string( "XYZ" ), received.getStringProperty( "symbol" ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testUnchangedPropertiesNotRemarshaled() {
+
+    PrimitiveMap sent;
+    sent.setString( "symbol", "ACME" );
+    sent.setInt( "price", 42 );
+
+    std::vector<unsigned char> marshaled;
+    PrimitiveTypesMarshaller::marshal( &sent, marshaled );
+
+    ActiveMQMessage msg;
+    msg.setMarshalledProperties( marshaled );
+    msg.afterUnmarshal( NULL );
+
+    // Reading the properties leaves the received bytes in use.
+    CPPUNIT_ASSERT_EQUAL( 42, msg.getIntProperty( "price" ) );
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 2, msg.getPropertyNames().size() );
+
+    // Replace the bytes with a marker, if they survive a marshal nothing re-encoded them.
+    std::vector<unsigned char> marker( 1, 0xAB );
+    Pointer<Message> forwarded = msg.copy();
+    forwarded->setMarshalledProperties( marker );
+    forwarded->beforeMarshal( NULL );
+    CPPUNIT_ASSERT( forwarded->getMarshalledProperties() == marker );
+
+    // Any change means they have to be marshaled again.
+    msg.setIntProperty( "price", 43 );
+    msg.beforeMarshal( NULL );
+    CPPUNIT_ASSERT( msg.getMarshalledProperties() != marshaled );
+
+    ActiveMQMessage received;
+    received.setMarshalledProperties( msg.getMarshalledProperties() );
+    received.afterUnmarshal( NULL );
+    CPPUNIT_ASSERT_EQUAL( 43, received.getIntProperty( "price" ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "ACME" ), received.getStringProperty( "symbol" ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testCMSMessageIDCached() {
+
+    Pointer<ProducerId> producerId( new ProducerId( "ID:host-1:2:3:4" ) );
+    Pointer<MessageId> id( new MessageId() );
+    id->setProducerId( producerId );
+    id->setProducerSequenceId( 5 );
+
+    ActiveMQMessage msg;
+    msg.setMessageId( id );
+    CPPUNIT_ASSERT_EQUAL( std::string( "ID:host-1:2:3:4:5" ), msg.getCMSMessageID() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "ID:host-1:2:3:4:5" ), msg.getCMSMessageID() );
+
+    id->setProducerSequenceId( 6 );
+    CPPUNIT_ASSERT_EQUAL( std::string( "ID:host-1:2:3:4:6" ), msg.getCMSMessageID() );
+
+    MessageId parsed( "ID:host-1:2:3:4:6" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "ID:host-1:2:3:4:6" ), parsed.toString() );
+    CPPUNIT_ASSERT( parsed.equals( id.get() ) );
+    CPPUNIT_ASSERT_EQUAL( id->getHashCode(), parsed.getHashCode() );
+
+    ProducerId otherProducer( "ID:host-1:2:3:4" );
+    CPPUNIT_ASSERT_EQUAL( producerId->getHashCode(), otherProducer.getHashCode() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTest::testRareFieldsCopied() {
+
+    ActiveMQMessage plain;
+    CPPUNIT_ASSERT( plain.getCMSCorrelationID() == "" );
+    CPPUNIT_ASSERT( plain.getCMSReplyTo() == NULL );
+    CPPUNIT_ASSERT_EQUAL( 0, plain.getGroupSequence() );
+    plain.setGroupID( "" );
+    plain.setReplyTo( Pointer<ActiveMQDestination>() );
+
+    ActiveMQMessage msg;
+    msg.setCMSCorrelationID( "request-1" );
+    msg.setCMSType( "reading" );
+    msg.setGroupSequence( 3 );
+    Pointer<ActiveMQDestination> replyTo( new ActiveMQTopic( "replies" ) );
+    msg.setReplyTo( replyTo );
+
+    std::auto_ptr<ActiveMQMessage> copy( msg.cloneDataStructure() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "request-1" ), copy->getCMSCorrelationID() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "reading" ), copy->getCMSType() );
+    CPPUNIT_ASSERT_EQUAL( 3, copy->getGroupSequence() );
+    CPPUNIT_ASSERT( copy->getReplyTo()->equals( replyTo.get() ) );
+    CPPUNIT_ASSERT( copy->equals( &msg ) );
+
+    // The copy's fields are its own.
+    copy->setCMSCorrelationID( "request-2" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "request-1" ), msg.getCMSCorrelationID() );
+
+    // Copying a message without rare fields clears those of the target.
+    copy->copyDataStructure( &plain );
+    CPPUNIT_ASSERT( copy->getCMSCorrelationID() == "" );
+    CPPUNIT_ASSERT( copy->getReplyTo() == NULL );
+    CPPUNIT_ASSERT_EQUAL( 0, copy->getGroupSequence() );
+    CPPUNIT_ASSERT( copy->equals( &plain ) );
+}
@@ -75,6 +75,10 @@ namespace commands{
         CPPUNIT_TEST( testDoublePropertyConversion );
         CPPUNIT_TEST( testReadOnlyProperties );
         CPPUNIT_TEST( testIsExpired );
+        CPPUNIT_TEST( testPropertiesUnmarshaledOnFirstUse );
+        CPPUNIT_TEST( testUnchangedPropertiesNotRemarshaled );
+        CPPUNIT_TEST( testCMSMessageIDCached );
+        CPPUNIT_TEST( testRareFieldsCopied );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -142,6 +146,10 @@ namespace commands{
         void testStringPropertyConversion();
         void testReadOnlyProperties();
         void testIsExpired();
+        void testPropertiesUnmarshaledOnFirstUse();
+        void testUnchangedPropertiesNotRemarshaled();
+        void testCMSMessageIDCached();
+        void testRareFieldsCopied();
 
     };
 
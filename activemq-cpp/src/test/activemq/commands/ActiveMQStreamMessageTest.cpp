@@ -32,13 +32,19 @@
 #include <decaf/lang/Long.h>
 #include <decaf/lang/Float.h>
 #include <decaf/lang/Double.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <activemq/util/PrimitiveValueNode.h>
+#include <activemq/util/MarshallingSupport.h>
 
 using namespace cms;
 using namespace std;
 using namespace activemq;
 using namespace activemq::commands;
+using namespace activemq::util;
 using namespace decaf;
 using namespace decaf::lang;
+using namespace decaf::io;
 
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQStreamMessageTest::setUp() {
@@ -973,3 +979,106 @@ void ActiveMQStreamMessageTest::testWriteOnlyBody() {
     } catch( MessageNotReadableException& e ) {
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQStreamMessageTest::testEncoding() {
+
+    std::vector<unsigned char> bytes( 3, 'b' );
+    std::string bigString( Short::MAX_VALUE, 'c' );
+
+    ActiveMQStreamMessage msg;
+    msg.writeBoolean( true );
+    msg.writeByte( 0xF1 );
+    msg.writeChar( 'a' );
+    msg.writeShort( -2 );
+    msg.writeUnsignedShort( 65000 );
+    msg.writeInt( -3 );
+    msg.writeLong( 0xFFFAAA33345LL );
+    msg.writeFloat( 1.5f );
+    msg.writeDouble( -2.25 );
+    msg.writeString( "string" );
+    msg.writeString( bigString );
+    msg.writeBytes( bytes );
+    msg.reset();
+
+    // The body is what a DataOutputStream writing the same values produces.
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut( &bytesOut );
+    dataOut.write( PrimitiveValueNode::BOOLEAN_TYPE );
+    dataOut.writeBoolean( true );
+    dataOut.write( PrimitiveValueNode::BYTE_TYPE );
+    dataOut.writeByte( 0xF1 );
+    dataOut.write( PrimitiveValueNode::CHAR_TYPE );
+    dataOut.writeChar( 'a' );
+    dataOut.write( PrimitiveValueNode::SHORT_TYPE );
+    dataOut.writeShort( -2 );
+    dataOut.write( PrimitiveValueNode::SHORT_TYPE );
+    dataOut.writeUnsignedShort( 65000 );
+    dataOut.write( PrimitiveValueNode::INTEGER_TYPE );
+    dataOut.writeInt( -3 );
+    dataOut.write( PrimitiveValueNode::LONG_TYPE );
+    dataOut.writeLong( 0xFFFAAA33345LL );
+    dataOut.write( PrimitiveValueNode::FLOAT_TYPE );
+    dataOut.writeFloat( 1.5f );
+    dataOut.write( PrimitiveValueNode::DOUBLE_TYPE );
+    dataOut.writeDouble( -2.25 );
+    MarshallingSupport::writeString( dataOut, "string" );
+    MarshallingSupport::writeString( dataOut, bigString );
+    dataOut.write( PrimitiveValueNode::BYTE_ARRAY_TYPE );
+    dataOut.writeInt( 3 );
+    dataOut.write( &bytes[0], 3, 0, 3 );
+
+    std::pair<unsigned char*, int> expected = bytesOut.toByteArray();
+    std::vector<unsigned char> encoded( expected.first, expected.first + expected.second );
+    delete [] expected.first;
+
+    CPPUNIT_ASSERT( encoded == msg.getContent() );
+
+    CPPUNIT_ASSERT_EQUAL( true, msg.readBoolean() );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)0xF1, msg.readByte() );
+    CPPUNIT_ASSERT_EQUAL( 'a', msg.readChar() );
+    CPPUNIT_ASSERT_EQUAL( (short)-2, msg.readShort() );
+    CPPUNIT_ASSERT_EQUAL( (unsigned short)65000, msg.readUnsignedShort() );
+    CPPUNIT_ASSERT_EQUAL( -3, msg.readInt() );
+    CPPUNIT_ASSERT_EQUAL( 0xFFFAAA33345LL, msg.readLong() );
+    CPPUNIT_ASSERT_EQUAL( 1.5f, msg.readFloat() );
+    CPPUNIT_ASSERT_EQUAL( -2.25, msg.readDouble() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "string" ), msg.readString() );
+    CPPUNIT_ASSERT_EQUAL( bigString, msg.readString() );
+    CPPUNIT_ASSERT_EQUAL( cms::Message::BYTE_ARRAY_TYPE, msg.getNextValueType() );
+
+    std::vector<unsigned char> read( 3 );
+    CPPUNIT_ASSERT_EQUAL( 3, msg.readBytes( read ) );
+    CPPUNIT_ASSERT( read == bytes );
+    CPPUNIT_ASSERT_THROW( msg.getNextValueType(), cms::IllegalStateException );
+    CPPUNIT_ASSERT_EQUAL( -1, msg.readBytes( read ) );
+    CPPUNIT_ASSERT_THROW( msg.readInt(), MessageEOFException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQStreamMessageTest::testFailedReadKeepsPosition() {
+
+    ActiveMQStreamMessage msg;
+    msg.writeString( "not a number" );
+    msg.writeLong( 5LL );
+    msg.reset();
+
+    CPPUNIT_ASSERT_THROW( msg.readInt(), CMSException );
+    CPPUNIT_ASSERT_THROW( msg.readChar(), MessageFormatException );
+    CPPUNIT_ASSERT_EQUAL( std::string( "not a number" ), msg.readString() );
+
+    CPPUNIT_ASSERT_THROW( msg.readInt(), MessageFormatException );
+    CPPUNIT_ASSERT_EQUAL( 5LL, msg.readLong() );
+
+    // A value cut short is not read, the reader stays on it.
+    std::vector<unsigned char> truncated = msg.getContent();
+    truncated.resize( truncated.size() - 2 );
+
+    ActiveMQStreamMessage received;
+    received.setContent( truncated );
+    received.setReadOnlyBody( true );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "not a number" ), received.readString() );
+    CPPUNIT_ASSERT_THROW( received.readLong(), MessageEOFException );
+    CPPUNIT_ASSERT_EQUAL( cms::Message::LONG_TYPE, received.getNextValueType() );
+}
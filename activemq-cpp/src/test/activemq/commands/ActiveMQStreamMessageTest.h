@@ -43,6 +43,8 @@ namespace commands {
         CPPUNIT_TEST( testReset );
         CPPUNIT_TEST( testReadOnlyBody );
         CPPUNIT_TEST( testWriteOnlyBody );
+        CPPUNIT_TEST( testEncoding );
+        CPPUNIT_TEST( testFailedReadKeepsPosition );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -73,6 +75,8 @@ namespace commands {
         void testReset();
         void testReadOnlyBody();
         void testWriteOnlyBody();
+        void testEncoding();
+        void testFailedReadKeepsPosition();
 
     };
 
@@ -70,6 +70,44 @@ void ActiveMQTextMessageTest::testGetBytes() {
     CPPUNIT_ASSERT( msg2.getText() == str );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQTextMessageTest::testGetTextFromContent() {
+
+    const unsigned char body[] = { 0, 0, 0, 5, 'h', 'e', 0, 'l', 'o' };
+
+    ActiveMQTextMessage msg;
+    msg.setContent( std::vector<unsigned char>( body, body + sizeof( body ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "he\0lo", 5 ), msg.getText() );
+
+    const unsigned char empty[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0 };
+
+    ActiveMQTextMessage msg2;
+    msg2.setContent( std::vector<unsigned char>( empty, empty + sizeof( empty ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string(), msg2.getText() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQTextMessageTest::testGetTextView() {
+
+    const unsigned char body[] = { 0, 0, 0, 5, 'h', 'e', 'l', 'l', 'o' };
+
+    ActiveMQTextMessage msg;
+    msg.setContent( std::vector<unsigned char>( body, body + sizeof( body ) ) );
+
+    // The text is decoded once and the same string is returned after that.
+    const std::string& text = msg.getTextView();
+    CPPUNIT_ASSERT_EQUAL( std::string( "hello" ), text );
+    CPPUNIT_ASSERT( &text == &msg.getTextView() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "hello" ), msg.getText() );
+    CPPUNIT_ASSERT( &text == &msg.getTextView() );
+
+    msg.setText( "changed" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "changed" ), msg.getTextView() );
+
+    ActiveMQTextMessage empty;
+    CPPUNIT_ASSERT_EQUAL( std::string(), empty.getTextView() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQTextMessageTest::testClearBody() {
 
@@ -33,6 +33,8 @@ namespace commands{
         CPPUNIT_TEST( testWriteOnlyBody );
         CPPUNIT_TEST( testShallowCopy );
         CPPUNIT_TEST( testGetBytes );
+        CPPUNIT_TEST( testGetTextFromContent );
+        CPPUNIT_TEST( testGetTextView );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -46,6 +48,8 @@ namespace commands{
         void testWriteOnlyBody();
         void testShallowCopy();
         void testGetBytes();
+        void testGetTextFromContent();
+        void testGetTextView();
 
     };
 
@@ -0,0 +1,157 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataStructurePoolTest.h"
+
+#include <activemq/commands/DataStructurePool.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+
+#include <decaf/lang/Pointer.h>
+
+#include <memory>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testNoScope() {
+
+    DataStructurePool* pool = new DataStructurePool();
+
+    std::auto_ptr<MessageId> id(new MessageId());
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+
+    id.reset(NULL);
+    CPPUNIT_ASSERT_EQUAL(0, pool->getCachedBlockCount());
+
+    // A scope without a pool leaves allocation on the heap.
+    {
+        DataStructurePool::Scope scope(NULL);
+        id.reset(new MessageId());
+    }
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+
+    pool->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testRecycle() {
+
+    DataStructurePool* pool = new DataStructurePool();
+
+    MessageDispatch* first = NULL;
+    Pointer<ActiveMQTextMessage> message;
+    {
+        DataStructurePool::Scope scope(pool);
+        first = new MessageDispatch();
+        message.reset(new ActiveMQTextMessage());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, pool->getActiveBlockCount());
+
+    // Objects created once the scope has closed come from the heap.
+    std::auto_ptr<MessageDispatch> outside(new MessageDispatch());
+    CPPUNIT_ASSERT_EQUAL(2, pool->getActiveBlockCount());
+
+    void* address = first;
+    delete first;
+    message.reset(NULL);
+
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+    CPPUNIT_ASSERT_EQUAL(2, pool->getCachedBlockCount());
+
+    {
+        DataStructurePool::Scope scope(pool);
+        std::auto_ptr<MessageDispatch> second(new MessageDispatch());
+        CPPUNIT_ASSERT_EQUAL(address, (void*) second.get());
+        CPPUNIT_ASSERT_EQUAL(1, pool->getCachedBlockCount());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, pool->getCachedBlockCount());
+
+    pool->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testNestedScopes() {
+
+    DataStructurePool* outer = new DataStructurePool();
+    DataStructurePool* inner = new DataStructurePool();
+
+    {
+        DataStructurePool::Scope outerScope(outer);
+        std::auto_ptr<MessageId> id1(new MessageId());
+        {
+            DataStructurePool::Scope innerScope(inner);
+            std::auto_ptr<MessageId> id2(new MessageId());
+            CPPUNIT_ASSERT_EQUAL(1, inner->getActiveBlockCount());
+        }
+        std::auto_ptr<MessageId> id3(new MessageId());
+        CPPUNIT_ASSERT_EQUAL(2, outer->getActiveBlockCount());
+        CPPUNIT_ASSERT_EQUAL(0, inner->getActiveBlockCount());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, outer->getCachedBlockCount());
+    CPPUNIT_ASSERT_EQUAL(1, inner->getCachedBlockCount());
+
+    outer->close();
+    inner->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testCachedBlockLimit() {
+
+    DataStructurePool* pool = new DataStructurePool(2);
+
+    {
+        DataStructurePool::Scope scope(pool);
+        std::auto_ptr<MessageId> id1(new MessageId());
+        std::auto_ptr<MessageId> id2(new MessageId());
+        std::auto_ptr<MessageId> id3(new MessageId());
+        CPPUNIT_ASSERT_EQUAL(3, pool->getActiveBlockCount());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+    CPPUNIT_ASSERT_EQUAL(2, pool->getCachedBlockCount());
+
+    pool->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataStructurePoolTest::testCloseWithLiveObjects() {
+
+    DataStructurePool* pool = new DataStructurePool();
+
+    Pointer<MessageDispatch> dispatch;
+    {
+        DataStructurePool::Scope scope(pool);
+        dispatch.reset(new MessageDispatch());
+        std::auto_ptr<MessageId> id(new MessageId());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, pool->getCachedBlockCount());
+
+    // The pool has to outlive its owner while the dispatch is still referenced.
+    pool->close();
+
+    dispatch->setRedeliveryCounter(1);
+    dispatch.reset(NULL);
+}
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IdSupportTest.h"
+
+#include <activemq/commands/IdSupport.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/NumberFormatException.h>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupportTest::testParseLastNumber() {
+
+    long long value = -1;
+
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, IdSupport::parseLastNumber("", 0, value));
+    CPPUNIT_ASSERT_EQUAL(std::string::npos, IdSupport::parseLastNumber("ID-host", 7, value));
+    CPPUNIT_ASSERT_EQUAL(-1LL, value);
+
+    std::string text("ID:host-1:23:456");
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 12, IdSupport::parseLastNumber(text, text.length(), value));
+    CPPUNIT_ASSERT_EQUAL(456LL, value);
+
+    // Only the first length characters count.
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 9, IdSupport::parseLastNumber(text, 12, value));
+    CPPUNIT_ASSERT_EQUAL(23LL, value);
+
+    std::string negative("a:-42");
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, IdSupport::parseLastNumber(negative, negative.length(), value));
+    CPPUNIT_ASSERT_EQUAL(-42LL, value);
+
+    // Numbers too long for the fast path are still parsed.
+    std::string large("a:" + Long::toString(Long::MAX_VALUE));
+    IdSupport::parseLastNumber(large, large.length(), value);
+    CPPUNIT_ASSERT_EQUAL(Long::MAX_VALUE, value);
+
+    std::string empty("a:");
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NumberFormatException",
+        IdSupport::parseLastNumber(empty, empty.length(), value),
+        NumberFormatException);
+
+    std::string letters("a:12b");
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NumberFormatException",
+        IdSupport::parseLastNumber(letters, letters.length(), value),
+        NumberFormatException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupportTest::testAppendNumber() {
+
+    long long values[] = { 0, 7, -7, 1234567890123LL, Long::MAX_VALUE, Long::MIN_VALUE };
+
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        std::string buffer("x");
+        IdSupport::appendNumber(buffer, values[i]);
+        CPPUNIT_ASSERT_EQUAL("x" + Long::toString(values[i]), buffer);
+    }
+
+    std::string id;
+    IdSupport::appendId(id, "ID:host", 3, 14);
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host:3:14"), id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupportTest::testMessageIdRoundTrip() {
+
+    const std::string text("ID:host-12345-1234567890123-1:2:3:4");
+
+    MessageId id(text);
+    CPPUNIT_ASSERT_EQUAL(4LL, id.getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-12345-1234567890123-1"), id.getProducerId()->getConnectionId());
+    CPPUNIT_ASSERT_EQUAL(2LL, id.getProducerId()->getSessionId());
+    CPPUNIT_ASSERT_EQUAL(3LL, id.getProducerId()->getValue());
+    CPPUNIT_ASSERT_EQUAL(text, id.toString());
+
+    ProducerId producer("ID:host-12345-1234567890123-1:2:3");
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-12345-1234567890123-1"), producer.getConnectionId());
+    CPPUNIT_ASSERT_EQUAL(2LL, producer.getSessionId());
+    CPPUNIT_ASSERT_EQUAL(3LL, producer.getValue());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-12345-1234567890123-1:2:3"), producer.toString());
+
+    // Without separators the whole text is the connection id.
+    MessageId plain("plain");
+    CPPUNIT_ASSERT_EQUAL(std::string("plain"), plain.getProducerId()->getConnectionId());
+    CPPUNIT_ASSERT_EQUAL(0LL, plain.getProducerId()->getValue());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupportTest::testProducerIdShared() {
+
+    MessageId first("ID:host-1:1:1:1");
+    MessageId second("ID:host-1:1:1:2");
+    MessageId other("ID:host-1:1:2:1");
+    MessageId third("ID:host-1:1:2:2");
+
+    // Ids of the producer parsed last share its ProducerId.
+    CPPUNIT_ASSERT(first.getProducerId().get() == second.getProducerId().get());
+    CPPUNIT_ASSERT(other.getProducerId().get() == third.getProducerId().get());
+    CPPUNIT_ASSERT(first.getProducerId().get() != other.getProducerId().get());
+
+    CPPUNIT_ASSERT_EQUAL(1LL, first.getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(2LL, second.getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(2LL, other.getProducerId()->getValue());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-1:1:2:2"), third.toString());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IdSupportTest::testConsumerIdToString() {
+
+    ConsumerId id;
+    id.setConnectionId("ID:host-1");
+    id.setSessionId(5);
+    id.setValue(-6);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-1:5:-6"), id.toString());
+}
@@ -21,6 +21,7 @@
 #include <decaf/util/concurrent/Concurrent.h>
 #include <decaf/util/concurrent/Mutex.h>
 #include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/NumberFormatException.h>
 #include <activemq/core/ActiveMQConnectionFactory.h>
 #include <activemq/core/ActiveMQConnection.h>
 #include <activemq/core/ActiveMQSession.h>
@@ -306,7 +307,8 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
             "mock://127.0.0.1:23232?connection.dispatchAsync=true&"
             "connection.alwaysSyncSend=true&connection.useAsyncSend=true&"
             "connection.useCompression=true&connection.compressionLevel=7&"
-            "connection.closeTimeout=10000";
+            "connection.closeTimeout=10000&connection.threadPlacement=core&"
+            "connection.commitBatchWindow=500";
 
         ActiveMQConnectionFactory connectionFactory( URI );
 
@@ -316,6 +318,8 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( connectionFactory.isUseCompression() == true );
         CPPUNIT_ASSERT( connectionFactory.getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( connectionFactory.getCompressionLevel() == 7 );
+        CPPUNIT_ASSERT( connectionFactory.getThreadPlacement() == "core" );
+        CPPUNIT_ASSERT( connectionFactory.getCommitBatchWindow() == 500 );
 
         cms::Connection* connection =
             connectionFactory.createConnection();
@@ -330,6 +334,9 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
         CPPUNIT_ASSERT( amqConnection->isUseCompression() == true );
         CPPUNIT_ASSERT( amqConnection->getCloseTimeout() == 10000 );
         CPPUNIT_ASSERT( amqConnection->getCompressionLevel() == 7 );
+        CPPUNIT_ASSERT( amqConnection->getThreadPlacement() == "core" );
+        CPPUNIT_ASSERT( amqConnection->getThreadAffinity().size() == 1 );
+        CPPUNIT_ASSERT( amqConnection->getCommitBatchWindow() == 500 );
 
         delete connection;
 
@@ -340,3 +347,36 @@ void ActiveMQConnectionFactoryTest::testURIOptionsProcessing() {
 
     CPPUNIT_ASSERT( false );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionFactoryTest::testSharedURIOptions() {
+
+    std::string URI =
+        "mock://127.0.0.1:23232?connection.useAsyncSend=true&"
+        "connection.auditDepth=100&connection.threadPlacement=core";
+
+    ActiveMQConnectionFactory first(URI);
+    ActiveMQConnectionFactory second(URI);
+
+    CPPUNIT_ASSERT(second.isUseAsyncSend());
+    CPPUNIT_ASSERT_EQUAL(100, second.getAuditDepth());
+    CPPUNIT_ASSERT_EQUAL(std::string("core"), second.getThreadPlacement());
+
+    // Setting the URI again applies what it gives and leaves the rest alone.
+    second.setAlwaysSyncSend(true);
+    second.setUseAsyncSend(false);
+    second.setBrokerURI(URI);
+
+    CPPUNIT_ASSERT(second.isAlwaysSyncSend());
+    CPPUNIT_ASSERT(second.isUseAsyncSend());
+    CPPUNIT_ASSERT(!first.isAlwaysSyncSend());
+
+    // A malformed option fails every time, it is never cached.
+    std::string badURI = "mock://127.0.0.1:23232?connection.auditDepth=many";
+    for (int i = 0; i < 2; ++i) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw a NumberFormatException",
+            ActiveMQConnectionFactory bad(badURI),
+            decaf::lang::exceptions::NumberFormatException);
+    }
+}
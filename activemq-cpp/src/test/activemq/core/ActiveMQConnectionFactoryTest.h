@@ -36,6 +36,7 @@ namespace core{
         CPPUNIT_TEST( testTransportListener );
         CPPUNIT_TEST( testExceptionWithPortOutOfRange );
         CPPUNIT_TEST( testURIOptionsProcessing );
+        CPPUNIT_TEST( testSharedURIOptions );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -60,6 +61,7 @@ namespace core{
         void testCreateWithURIOptions();
         void testTransportListener();
         void testURIOptionsProcessing();
+        void testSharedURIOptions();
 
     };
 
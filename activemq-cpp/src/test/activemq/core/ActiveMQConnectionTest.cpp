@@ -25,6 +25,7 @@
 #include <decaf/lang/Pointer.h>
 #include <activemq/core/ActiveMQConnectionFactory.h>
 #include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ConsumerPressureMonitor.h>
 #include <activemq/transport/Transport.h>
 #include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/transport/mock/MockTransport.h>
@@ -250,3 +251,74 @@ void ActiveMQConnectionTest::testExceptionInOnException() {
         throw ex;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class MyPressureMonitor : public ConsumerPressureMonitor {
+    public:
+
+        bool pressure;
+        long long lastUsage;
+
+    public:
+
+        MyPressureMonitor() : pressure(false), lastUsage(-1) {}
+
+        virtual ~MyPressureMonitor() {}
+
+        virtual bool isUnderPressure(long long usage) {
+            lastUsage = usage;
+            return pressure;
+        }
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQConnectionTest::testConsumerPressure() {
+
+    std::auto_ptr<ActiveMQConnectionFactory> factory(
+        new ActiveMQConnectionFactory("mock://mock?connection.consumerMemoryLimit=1000"));
+    std::auto_ptr<cms::Connection> connection(factory->createConnection());
+
+    ActiveMQConnection* amqConnection = dynamic_cast<ActiveMQConnection*>(connection.get());
+    CPPUNIT_ASSERT(amqConnection != NULL);
+    CPPUNIT_ASSERT_EQUAL(1000LL, amqConnection->getConsumerMemoryLimit());
+    CPPUNIT_ASSERT(!amqConnection->isConsumersSuspended());
+
+    // Suspended above the budget, resumed only once back at half of it.
+    amqConnection->updateConsumerMemoryUsage(NULL, 1500);
+    CPPUNIT_ASSERT_EQUAL(1500LL, amqConnection->getConsumerMemoryUsage());
+    CPPUNIT_ASSERT(amqConnection->isConsumersSuspended());
+
+    amqConnection->updateConsumerMemoryUsage(NULL, -600);
+    CPPUNIT_ASSERT(amqConnection->isConsumersSuspended());
+
+    amqConnection->updateConsumerMemoryUsage(NULL, -400);
+    CPPUNIT_ASSERT_EQUAL(500LL, amqConnection->getConsumerMemoryUsage());
+    CPPUNIT_ASSERT(!amqConnection->isConsumersSuspended());
+
+    // The monitor suspends the consumers whatever the budget.
+    MyPressureMonitor monitor;
+    amqConnection->setConsumerPressureMonitor(&monitor);
+    CPPUNIT_ASSERT_EQUAL(500LL, monitor.lastUsage);
+    CPPUNIT_ASSERT(!amqConnection->isConsumersSuspended());
+
+    monitor.pressure = true;
+    amqConnection->checkConsumerPressure();
+    CPPUNIT_ASSERT(amqConnection->isConsumersSuspended());
+
+    monitor.pressure = false;
+    amqConnection->checkConsumerPressure();
+    CPPUNIT_ASSERT(!amqConnection->isConsumersSuspended());
+
+    // Removing the budget resumes consumers suspended by it.
+    amqConnection->setConsumerPressureMonitor(NULL);
+    amqConnection->updateConsumerMemoryUsage(NULL, 1000);
+    CPPUNIT_ASSERT(amqConnection->isConsumersSuspended());
+    amqConnection->setConsumerMemoryLimit(0);
+    CPPUNIT_ASSERT(!amqConnection->isConsumersSuspended());
+
+    connection->close();
+}
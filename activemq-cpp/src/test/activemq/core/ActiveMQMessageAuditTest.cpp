@@ -220,3 +220,78 @@ void ActiveMQMessageAuditTest::testGetLastSeqId() {
     }
 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageAuditTest::testWindowSlides() {
+
+    ActiveMQMessageAudit audit(100, 4);
+
+    Pointer<ProducerId> pid(new ProducerId);
+    pid->setConnectionId("test");
+    pid->setSessionId(0);
+    pid->setValue(1);
+    Pointer<MessageId> id(new MessageId);
+    id->setProducerId(pid);
+
+    id->setProducerSequenceId(5);
+    CPPUNIT_ASSERT(!audit.isDuplicate(id));
+    CPPUNIT_ASSERT(audit.isDuplicate(id));
+
+    // A jump far ahead moves the window past the old id, which is forgotten.
+    id->setProducerSequenceId(1000000);
+    CPPUNIT_ASSERT(!audit.isDuplicate(id));
+    CPPUNIT_ASSERT(audit.isDuplicate(id));
+    CPPUNIT_ASSERT_EQUAL(1000000LL, audit.getLastSeqId(pid));
+
+    id->setProducerSequenceId(5);
+    CPPUNIT_ASSERT(!audit.isDuplicate(id));
+    CPPUNIT_ASSERT(!audit.isDuplicate(id));
+
+    // Everything within the depth behind the newest id is still remembered.
+    id->setProducerSequenceId(1000000 - 100);
+    CPPUNIT_ASSERT(!audit.isDuplicate(id));
+    CPPUNIT_ASSERT(audit.isDuplicate(id));
+
+    id->setProducerSequenceId(1000000);
+    audit.rollback(id);
+    CPPUNIT_ASSERT_EQUAL(1000000LL - 100, audit.getLastSeqId(pid));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageAuditTest::testProducerEviction() {
+
+    const int producers = 8;
+    ActiveMQMessageAudit audit(64, 4);
+    ArrayList<Pointer<MessageId> > ids;
+
+    for (int i = 0; i < producers; i++) {
+        Pointer<ProducerId> pid(new ProducerId);
+        pid->setConnectionId("test");
+        pid->setSessionId(i % 2);
+        pid->setValue(i);
+
+        Pointer<MessageId> id(new MessageId);
+        id->setProducerId(pid);
+        id->setProducerSequenceId(1);
+        ids.add(id);
+
+        CPPUNIT_ASSERT(!audit.isDuplicate(id));
+    }
+
+    // Only the four most recently used producers are still tracked.
+    for (int i = 0; i < producers / 2; i++) {
+        CPPUNIT_ASSERT_EQUAL(-1LL, audit.getLastSeqId(ids.get(i)->getProducerId()));
+    }
+    for (int i = producers / 2; i < producers; i++) {
+        CPPUNIT_ASSERT(audit.isDuplicate(ids.get(i)));
+    }
+
+    audit.getMaximumNumberOfProducersToTrack(2);
+    CPPUNIT_ASSERT_EQUAL(2, audit.getMaximumNumberOfProducersToTrack());
+    CPPUNIT_ASSERT(audit.isDuplicate(ids.get(producers - 1)));
+    CPPUNIT_ASSERT(audit.isDuplicate(ids.get(producers - 2)));
+    CPPUNIT_ASSERT_EQUAL(-1LL, audit.getLastSeqId(ids.get(producers - 3)->getProducerId()));
+
+    audit.clear();
+    CPPUNIT_ASSERT(!audit.isDuplicate(ids.get(producers - 1)));
+}
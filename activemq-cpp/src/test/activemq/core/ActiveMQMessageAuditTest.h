@@ -34,6 +34,8 @@ namespace core {
         CPPUNIT_TEST( testRollbackString );
         CPPUNIT_TEST( testRollbackMessageId );
         CPPUNIT_TEST( testGetLastSeqId );
+        CPPUNIT_TEST( testWindowSlides );
+        CPPUNIT_TEST( testProducerEviction );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -48,6 +50,8 @@ namespace core {
         void testRollbackString();
         void testRollbackMessageId();
         void testGetLastSeqId();
+        void testWindowSlides();
+        void testProducerEviction();
 
     };
 
@@ -18,22 +18,33 @@
 #include "ActiveMQSessionTest.h"
 
 #include <cms/ExceptionListener.h>
+#include <cms/IllegalStateException.h>
+#include <cms/MessageFormatException.h>
 #include <activemq/transport/mock/MockTransportFactory.h>
 #include <activemq/transport/TransportRegistry.h>
 #include <activemq/commands/ActiveMQTextMessage.h>
 #include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/DestinationInfo.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConstants.h>
 #include <activemq/core/ActiveMQSession.h>
 #include <activemq/core/ActiveMQConsumer.h>
 #include <activemq/core/ActiveMQProducer.h>
+#include <activemq/core/SubscriptionMultiplexer.h>
+#include <activemq/util/MessageTracer.h>
 #include <decaf/util/Properties.h>
 #include <decaf/lang/System.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/Thread.h>
+#include <decaf/lang/Integer.h>
 #include <decaf/net/Socket.h>
 #include <decaf/net/ServerSocket.h>
 
+#include <vector>
+
 using namespace std;
 using namespace activemq;
 using namespace activemq::core;
@@ -101,6 +112,217 @@ namespace core {
             AMQ_CATCHALL_THROW( activemq::exceptions::ActiveMQException )
         }
     };
+
+    class MyBorrowingListener : public cms::MessageListener {
+    public:
+
+        std::vector<const cms::Message*> messages;
+        std::vector<std::string> texts;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyBorrowingListener() : messages(), texts(), mutex() {}
+
+        virtual ~MyBorrowingListener() {}
+
+        virtual void onMessage(const cms::Message* message) {
+            synchronized(&mutex) {
+                messages.push_back(message);
+                texts.push_back(dynamic_cast<const cms::TextMessage*>(message)->getText());
+                mutex.notifyAll();
+            }
+        }
+
+        void waitForMessages(unsigned int count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 10 && messages.size() < count; ++i) {
+                    mutex.wait(500);
+                }
+            }
+        }
+    };
+
+    class MyClosingListener : public cms::MessageListener {
+    public:
+
+        cms::MessageConsumer* consumer;
+        int count;
+
+    public:
+
+        MyClosingListener() : consumer(NULL), count(0) {}
+
+        virtual ~MyClosingListener() {}
+
+        virtual void onMessage(const cms::Message* message AMQCPP_UNUSED) {
+            count++;
+            consumer->close();
+        }
+    };
+
+    class MyDestinationInfoCounter : public transport::DefaultTransportListener {
+    public:
+
+        int adds;
+        int removes;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyDestinationInfoCounter() : adds(0), removes(0), mutex() {}
+
+        virtual ~MyDestinationInfoCounter() {}
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            commands::DestinationInfo* info = dynamic_cast<commands::DestinationInfo*>(command.get());
+            if (info != NULL) {
+                synchronized(&mutex) {
+                    if (info->getOperationType() == ActiveMQConstants::DESTINATION_ADD_OPERATION) {
+                        adds++;
+                    } else {
+                        removes++;
+                    }
+                }
+            }
+        }
+    };
+
+    class MyMessageTracer : public util::MessageTracer {
+    public:
+
+        std::vector<TracePoint> points;
+        std::vector<long long> timestamps;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyMessageTracer() : points(), timestamps(), mutex() {}
+
+        virtual ~MyMessageTracer() {}
+
+        virtual void onTrace(TracePoint point, const commands::Command& command AMQCPP_UNUSED, long long timestamp) {
+            synchronized(&mutex) {
+                points.push_back(point);
+                timestamps.push_back(timestamp);
+            }
+        }
+    };
+
+    class MySentMessages : public util::MessageTracer {
+    public:
+
+        std::vector< Pointer<commands::Message> > messages;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MySentMessages() : messages(), mutex() {}
+
+        virtual ~MySentMessages() {}
+
+        virtual void onTrace(TracePoint point, const commands::Command& command, long long timestamp AMQCPP_UNUSED) {
+            const commands::Message* message = dynamic_cast<const commands::Message*>(&command);
+            if (point == SESSION_SEND && message != NULL) {
+                synchronized(&mutex) {
+                    messages.push_back(Pointer<commands::Message>(message->cloneDataStructure()));
+                }
+            }
+        }
+    };
+
+    class MyExpiredAckListener : public transport::DefaultTransportListener {
+    public:
+
+        std::vector< Pointer<MessageAck> > acks;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyExpiredAckListener() : acks(), mutex() {}
+
+        virtual ~MyExpiredAckListener() {}
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            if (command->isMessageAck()) {
+                Pointer<MessageAck> ack = command.dynamicCast<MessageAck>();
+                if (ack->isExpiredAck()) {
+                    synchronized(&mutex) {
+                        acks.push_back(ack);
+                    }
+                }
+            }
+        }
+    };
+    class MyAckCounter : public transport::DefaultTransportListener {
+    public:
+
+        int acks;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyAckCounter() : acks(0), mutex() {}
+
+        virtual ~MyAckCounter() {}
+
+        virtual void onCommand(const Pointer<commands::Command> command) {
+            if (command->isMessageAck()) {
+                synchronized(&mutex) {
+                    acks++;
+                }
+            }
+        }
+
+        int getAcks() {
+            synchronized(&mutex) {
+                return acks;
+            }
+            return 0;
+        }
+    };
+
+    class MyReceiveCallback : public ReceiveCallback {
+    public:
+
+        std::vector<std::string> texts;
+        int errors;
+        decaf::util::concurrent::Mutex mutex;
+
+    public:
+
+        MyReceiveCallback() : texts(), errors(0), mutex() {}
+
+        virtual ~MyReceiveCallback() {}
+
+        virtual void onReceive(cms::Message* message) {
+            std::auto_ptr<cms::Message> owned(message);
+            synchronized(&mutex) {
+                if (message == NULL) {
+                    texts.push_back("<null>");
+                } else {
+                    texts.push_back(dynamic_cast<cms::TextMessage*>(message)->getText());
+                }
+                mutex.notifyAll();
+            }
+        }
+
+        virtual void onException(const cms::CMSException& ex AMQCPP_UNUSED) {
+            synchronized(&mutex) {
+                errors++;
+                mutex.notifyAll();
+            }
+        }
+
+        std::size_t waitForCompletions(std::size_t count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 10 && texts.size() < count; ++i) {
+                    mutex.wait(500);
+                }
+            }
+            return texts.size();
+        }
+    };
 }}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -613,6 +835,42 @@ void ActiveMQSessionTest::testExpiration() {
     CPPUNIT_ASSERT( text1 == "This is a Test 1" );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testExpiredRunAckedOnce() {
+
+    MyExpiredAckListener ackListener;
+
+    CPPUNIT_ASSERT( connection.get() != NULL );
+
+    std::auto_ptr<cms::Session> session( connection->createSession() );
+    std::auto_ptr<cms::Queue> queue( session->createQueue( "TestExpiredRun" ) );
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>( session->createConsumer( queue.get() ) ) );
+
+    dTransport->setOutgoingListener( &ackListener );
+
+    long long stale = decaf::lang::System::currentTimeMillis() - 1000;
+    for( int i = 0; i < 3; ++i ) {
+        injectTextMessage( "Expired", *queue, *( consumer->getConsumerId() ), stale, 1, 10 + i );
+    }
+    injectTextMessage( "Live", *queue, *( consumer->getConsumerId() ), -1, -1, 13 );
+
+    // Let all four reach the consumer so the expired ones are found as one run.
+    Thread::sleep( 500 );
+
+    std::auto_ptr<cms::Message> message( consumer->receive( 2000 ) );
+    CPPUNIT_ASSERT( message.get() != NULL );
+    CPPUNIT_ASSERT_EQUAL( std::string( "Live" ), dynamic_cast<cms::TextMessage*>( message.get() )->getText() );
+
+    dTransport->setOutgoingListener( NULL );
+
+    CPPUNIT_ASSERT_EQUAL( 1, (int)ackListener.acks.size() );
+    Pointer<MessageAck> ack = ackListener.acks[0];
+    CPPUNIT_ASSERT_EQUAL( 3, ack->getMessageCount() );
+    CPPUNIT_ASSERT_EQUAL( 10LL, ack->getFirstMessageId()->getProducerSequenceId() );
+    CPPUNIT_ASSERT_EQUAL( 12LL, ack->getLastMessageId()->getProducerSequenceId() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::testTransactionCommitAfterConsumerClosed() {
 
@@ -694,6 +952,57 @@ void ActiveMQSessionTest::testCreateTempTopicByName() {
     CPPUNIT_ASSERT(topic->getDestinationType() == cms::Destination::TEMPORARY_TOPIC);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testSessionDispatchPool() {
+
+    const int NUM_SESSIONS = 6;
+    const int NUM_MESSAGES = 10;
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    // More sessions than pool threads, each must still get all its messages.
+    connection->setSessionDispatchPoolSize(2);
+    CPPUNIT_ASSERT_EQUAL(2, connection->getSessionDispatchPoolSize());
+
+    std::vector<cms::Session*> sessions;
+    std::vector<cms::Topic*> topics;
+    std::vector<ActiveMQConsumer*> consumers;
+    std::vector<MyCMSMessageListener*> listeners;
+
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        sessions.push_back(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+        topics.push_back(sessions.back()->createTopic("TestTopic" + Integer::toString(i)));
+        consumers.push_back(dynamic_cast<ActiveMQConsumer*>(sessions.back()->createConsumer(topics.back())));
+        listeners.push_back(new MyCMSMessageListener());
+        consumers.back()->setMessageListener(listeners.back());
+    }
+
+    for (int message = 0; message < NUM_MESSAGES; ++message) {
+        for (int i = 0; i < NUM_SESSIONS; ++i) {
+            injectTextMessage("Message " + Integer::toString(message), *topics[i], *(consumers[i]->getConsumerId()));
+        }
+    }
+
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        listeners[i]->asyncWaitForMessages(NUM_MESSAGES);
+        CPPUNIT_ASSERT_EQUAL(NUM_MESSAGES, (int) listeners[i]->messages.size());
+
+        for (int message = 0; message < NUM_MESSAGES; ++message) {
+            Pointer<cms::TextMessage> text = listeners[i]->messages[message].dynamicCast<cms::TextMessage>();
+            CPPUNIT_ASSERT_EQUAL("Message " + Integer::toString(message), text->getText());
+        }
+    }
+
+    for (int i = 0; i < NUM_SESSIONS; ++i) {
+        consumers[i]->close();
+        sessions[i]->close();
+        delete consumers[i];
+        delete listeners[i];
+        delete topics[i];
+        delete sessions[i];
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ActiveMQSessionTest::setUp() {
 
@@ -725,7 +1034,8 @@ void ActiveMQSessionTest::injectTextMessage(const std::string message,
                                             const cms::Destination& destination,
                                             const commands::ConsumerId& id,
                                             const long long timeStamp,
-                                            const long long timeToLive) {
+                                            const long long timeToLive,
+                                            const long long sequenceId) {
 
     Pointer<ActiveMQTextMessage> msg(new ActiveMQTextMessage());
 
@@ -736,7 +1046,7 @@ void ActiveMQSessionTest::injectTextMessage(const std::string message,
 
     Pointer<MessageId> messageId(new MessageId());
     messageId->setProducerId(producerId);
-    messageId->setProducerSequenceId(2);
+    messageId->setProducerSequenceId(sequenceId);
 
     // Init Message
     msg->setText(message.c_str());
@@ -765,3 +1075,980 @@ void ActiveMQSessionTest::injectTextMessage(const std::string message,
 
     dTransport->fireCommand(dispatch);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testSendAssignsMessageId() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestSendAssignsMessageId"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+
+    producer->send(message.get());
+    std::string first = message->getCMSMessageID();
+
+    producer->send(message.get());
+    std::string second = message->getCMSMessageID();
+
+    CPPUNIT_ASSERT(first.find("ID:") == 0);
+    CPPUNIT_ASSERT(first != second);
+
+    // Both ids come from the same producer, only the sequence differs.
+    commands::MessageId firstId(first);
+    commands::MessageId secondId(second);
+    CPPUNIT_ASSERT(firstId.getProducerId()->equals(secondId.getProducerId().get()));
+    CPPUNIT_ASSERT_EQUAL(firstId.getProducerSequenceId() + 1, secondId.getProducerSequenceId());
+
+    ActiveMQTextMessage* amqMessage = dynamic_cast<ActiveMQTextMessage*>(message.get());
+    CPPUNIT_ASSERT(amqMessage != NULL);
+    CPPUNIT_ASSERT_EQUAL(secondId.getProducerSequenceId(), amqMessage->getMessageId()->getProducerSequenceId());
+
+    producer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testMetrics() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    connection->getMetrics().reset();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestMetrics"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+    producer->send(message.get());
+    producer->send(message.get());
+
+    injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()));
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    std::map<std::string, long long> values = connection->getMetricsSnapshot();
+
+    CPPUNIT_ASSERT_EQUAL(2LL, values["messages.sent"]);
+    CPPUNIT_ASSERT_EQUAL(1LL, values["messages.received"]);
+    CPPUNIT_ASSERT(values["acks.sent"] >= 1);
+    CPPUNIT_ASSERT_EQUAL(values["acks.sent"], values["ack.sendTime.count"]);
+    CPPUNIT_ASSERT(values["consumer.prefetchFill.count"] >= 1);
+    CPPUNIT_ASSERT(values["consumer.prefetchFill.max"] >= 1);
+    CPPUNIT_ASSERT(values.find("syncRequest.time.p99") != values.end());
+    CPPUNIT_ASSERT(values.find("flowControl.blockTime.count") != values.end());
+    CPPUNIT_ASSERT(values.find("session.dispatchQueueDepth.max") != values.end());
+    CPPUNIT_ASSERT(values.find("transport.bytesSent") != values.end());
+
+    connection->getMetrics().reset();
+    values = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(0LL, values["messages.sent"]);
+    CPPUNIT_ASSERT_EQUAL(0LL, values["ack.sendTime.count"]);
+
+    consumer->close();
+    producer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testMemoryAccounting() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::map<std::string, long long> values = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT(values.find("memory.total") == values.end());
+
+    connection->setMemoryAccountingEnabled(true);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestMemoryAccounting"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()));
+
+    // The message reaches the prefetch buffer once the session has dispatched it.
+    for (int i = 0; i < 200; ++i) {
+        values = connection->getMetricsSnapshot();
+        if (values["memory.prefetch"] > 0) {
+            break;
+        }
+        Thread::sleep(10);
+    }
+
+    CPPUNIT_ASSERT(values["memory.prefetch"] > 0);
+    CPPUNIT_ASSERT(values.find("memory.delivered") != values.end());
+    CPPUNIT_ASSERT(values.find("memory.dispatchQueue") != values.end());
+    CPPUNIT_ASSERT(values.find("memory.stateTracker") != values.end());
+    CPPUNIT_ASSERT(values.find("memory.audit") != values.end());
+    CPPUNIT_ASSERT(values.find("memory.compression") != values.end());
+    CPPUNIT_ASSERT(values["memory.total"] >= values["memory.prefetch"]);
+
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    values = connection->getMetricsSnapshot();
+    CPPUNIT_ASSERT_EQUAL(0LL, values["memory.prefetch"]);
+
+    connection->setMemoryAccountingEnabled(false);
+
+    consumer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testMessageTracer() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    MyMessageTracer tracer;
+    connection->setMessageTracer(&tracer);
+    CPPUNIT_ASSERT(connection->getMessageTracer() == &tracer);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestMessageTracer"));
+    std::auto_ptr<cms::MessageProducer> producer(session->createProducer(topic.get()));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+    producer->send(message.get());
+
+    injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()));
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+
+    connection->setMessageTracer(NULL);
+
+    synchronized(&tracer.mutex) {
+
+        CPPUNIT_ASSERT_EQUAL(6, (int) tracer.points.size());
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::PRODUCER_SEND, tracer.points[0]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::SESSION_SEND, tracer.points[1]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::CONNECTION_DISPATCH, tracer.points[2]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::CONSUMER_ENQUEUE, tracer.points[3]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::CONSUMER_DELIVER, tracer.points[4]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::CONSUMER_CONSUMED, tracer.points[5]);
+
+        for (std::size_t i = 1; i < tracer.timestamps.size(); ++i) {
+            CPPUNIT_ASSERT(tracer.timestamps[i - 1] <= tracer.timestamps[i]);
+        }
+    }
+
+    // Nothing more is recorded once the tracer is removed.
+    producer->send(message.get());
+    synchronized(&tracer.mutex) {
+        CPPUNIT_ASSERT_EQUAL(6, (int) tracer.points.size());
+    }
+
+    consumer->close();
+    producer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testBatchSend() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    connection->getMetrics().reset();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestBatchSend"));
+    std::auto_ptr<ActiveMQProducer> producer(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(topic.get())));
+
+    std::vector<cms::Message*> batch;
+    producer->send(batch);
+    CPPUNIT_ASSERT_EQUAL(0LL, connection->getMetrics().getMessagesSent().get());
+
+    std::auto_ptr<cms::TextMessage> first(session->createTextMessage("one"));
+    std::auto_ptr<cms::TextMessage> second(session->createTextMessage("two"));
+    std::auto_ptr<cms::TextMessage> third(session->createTextMessage("three"));
+    batch.push_back(first.get());
+    batch.push_back(second.get());
+    batch.push_back(third.get());
+
+    producer->send(batch);
+    CPPUNIT_ASSERT_EQUAL(3LL, connection->getMetrics().getMessagesSent().get());
+    CPPUNIT_ASSERT(first->getCMSMessageID() != second->getCMSMessageID());
+    CPPUNIT_ASSERT(second->getCMSMessageID() != third->getCMSMessageID());
+
+    std::auto_ptr<ActiveMQProducer> anonymous(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(NULL)));
+    anonymous->send(topic.get(), batch, cms::DeliveryMode::NON_PERSISTENT, 7, 0);
+    CPPUNIT_ASSERT_EQUAL(6LL, connection->getMetrics().getMessagesSent().get());
+    CPPUNIT_ASSERT_EQUAL(7, third->getCMSPriority());
+    anonymous->close();
+
+    producer->close();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        producer->send(batch),
+        cms::CMSException);
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testMultiDestinationSend() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    connection->getMetrics().reset();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> first(session->createQueue("TestMultiDestinationSend.1"));
+    std::auto_ptr<cms::Queue> second(session->createQueue("TestMultiDestinationSend.2"));
+    std::auto_ptr<cms::Topic> third(session->createTopic("TestMultiDestinationSend.3"));
+    std::auto_ptr<ActiveMQProducer> producer(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(NULL)));
+
+    std::vector<const cms::Destination*> destinations;
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("fan out"));
+    message->setIntProperty("index", 42);
+
+    producer->send(destinations, message.get());
+    CPPUNIT_ASSERT_EQUAL(0LL, connection->getMetrics().getMessagesSent().get());
+
+    destinations.push_back(first.get());
+    destinations.push_back(second.get());
+    destinations.push_back(third.get());
+
+    producer->send(destinations, message.get(), cms::DeliveryMode::NON_PERSISTENT, 7, 0);
+    CPPUNIT_ASSERT_EQUAL(3LL, connection->getMetrics().getMessagesSent().get());
+    CPPUNIT_ASSERT_EQUAL(7, message->getCMSPriority());
+    CPPUNIT_ASSERT(message->getCMSDestination()->equals(*third));
+    CPPUNIT_ASSERT_EQUAL(std::string("fan out"), message->getText());
+    CPPUNIT_ASSERT_EQUAL(42, message->getIntProperty("index"));
+
+    std::string lastId = message->getCMSMessageID();
+    producer->send(destinations, message.get());
+    CPPUNIT_ASSERT_EQUAL(6LL, connection->getMetrics().getMessagesSent().get());
+    CPPUNIT_ASSERT(lastId != message->getCMSMessageID());
+
+    std::auto_ptr<ActiveMQProducer> bound(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(first.get())));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        bound->send(destinations, message.get()),
+        cms::UnsupportedOperationException);
+    CPPUNIT_ASSERT_EQUAL(6LL, connection->getMetrics().getMessagesSent().get());
+
+    bound->close();
+    producer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testPreparedSend() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    MySentMessages sent;
+    connection->setMessageTracer(&sent);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestPreparedSend"));
+    std::auto_ptr<ActiveMQProducer> producer(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(topic.get())));
+    producer->setPriority(7);
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("ignored"));
+    message->setStringProperty("sensor", "north");
+    message->setCMSType("reading");
+
+    std::auto_ptr<PreparedMessage> prepared(producer->prepare(message.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("ignored"), message->getText());
+
+    producer->send(*prepared, std::string("one"));
+    producer->send(*prepared, std::string("two"));
+
+    std::auto_ptr<cms::BytesMessage> bytes(session->createBytesMessage());
+    std::auto_ptr<PreparedMessage> preparedBytes(producer->prepare(bytes.get()));
+    const unsigned char body[] = { 1, 2, 3 };
+    producer->send(*preparedBytes, body, 3);
+
+    connection->setMessageTracer(NULL);
+
+    synchronized(&sent.mutex) {
+
+        CPPUNIT_ASSERT_EQUAL(3, (int) sent.messages.size());
+
+        for (int i = 0; i < 2; ++i) {
+            cms::TextMessage* copy = dynamic_cast<cms::TextMessage*>(sent.messages[i].get());
+            CPPUNIT_ASSERT(copy != NULL);
+            CPPUNIT_ASSERT_EQUAL(std::string("north"), copy->getStringProperty("sensor"));
+            CPPUNIT_ASSERT_EQUAL(std::string("reading"), copy->getCMSType());
+            CPPUNIT_ASSERT_EQUAL(7, copy->getCMSPriority());
+            CPPUNIT_ASSERT(copy->getCMSDestination()->equals(*topic));
+        }
+
+        CPPUNIT_ASSERT_EQUAL(std::string("one"), dynamic_cast<cms::TextMessage*>(sent.messages[0].get())->getText());
+        CPPUNIT_ASSERT_EQUAL(std::string("two"), dynamic_cast<cms::TextMessage*>(sent.messages[1].get())->getText());
+        CPPUNIT_ASSERT(sent.messages[0]->getMessageId()->getProducerSequenceId() !=
+                       sent.messages[1]->getMessageId()->getProducerSequenceId());
+
+        cms::BytesMessage* copy = dynamic_cast<cms::BytesMessage*>(sent.messages[2].get());
+        CPPUNIT_ASSERT(copy != NULL);
+        CPPUNIT_ASSERT_EQUAL(3, copy->getBodyLength());
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageFormatException",
+        producer->send(*prepared, body, 3),
+        cms::MessageFormatException);
+
+    std::auto_ptr<ActiveMQProducer> other(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(topic.get())));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        other->send(*prepared, std::string("three")),
+        cms::IllegalStateException);
+
+    std::auto_ptr<cms::Message> plain(session->createMessage());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        producer->prepare(plain.get()),
+        cms::UnsupportedOperationException);
+
+    other->close();
+    producer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testPipelinedSends() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    CPPUNIT_ASSERT(dTransport != NULL);
+    connection->getMetrics().reset();
+
+    CPPUNIT_ASSERT_EQUAL(0, connection->getMaxPendingSends());
+    connection->setMaxPendingSends(4);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Queue> queue(session->createQueue("TestPipelinedSends"));
+    std::auto_ptr<ActiveMQProducer> producer(
+        dynamic_cast<ActiveMQProducer*>(session->createProducer(queue.get())));
+    producer->setDeliveryMode(cms::DeliveryMode::PERSISTENT);
+    CPPUNIT_ASSERT_EQUAL(4, producer->getMaxPendingSends());
+
+    std::auto_ptr<cms::TextMessage> message(session->createTextMessage("test"));
+    for (int i = 0; i < 10; ++i) {
+        producer->send(message.get());
+    }
+
+    producer->awaitPendingSends();
+    CPPUNIT_ASSERT_EQUAL(0, producer->getPendingSendCount());
+    CPPUNIT_ASSERT_EQUAL(10LL, connection->getMetrics().getMessagesSent().get());
+
+    // A send the transport refuses is thrown directly and gives back its slot.
+    dTransport->setFailOnSendMessage(true);
+    dTransport->setNumSentMessageBeforeFail(0);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        producer->send(message.get()),
+        cms::CMSException);
+    dTransport->setFailOnSendMessage(false);
+    CPPUNIT_ASSERT_EQUAL(0, producer->getPendingSendCount());
+
+    producer->send(message.get());
+    producer->awaitPendingSends();
+
+    producer->setMaxPendingSends(0);
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(0, producer->getPendingSendCount());
+
+    producer->close();
+    session->close();
+    connection->setMaxPendingSends(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAckCoalescing() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    CPPUNIT_ASSERT_EQUAL(0, connection->getAckCoalesceCount());
+    connection->setAckCoalesceCount(4);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestAckCoalescing"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    CPPUNIT_ASSERT_EQUAL(4, consumer->getAckCoalesceCount());
+
+    for (int i = 0; i < 10; ++i) {
+        injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()), -1, -1, 100 + i);
+    }
+
+    for (int i = 0; i < 200 && consumer->getMessageAvailableCount() < 10; ++i) {
+        Thread::sleep(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(10, consumer->getMessageAvailableCount());
+
+    connection->getMetrics().reset();
+
+    // Acks go out after every fourth message, and for the last once nothing is left.
+    for (int i = 0; i < 10; ++i) {
+        std::auto_ptr<cms::Message> received(consumer->receive(2000));
+        CPPUNIT_ASSERT(received.get() != NULL);
+    }
+    CPPUNIT_ASSERT_EQUAL(3LL, connection->getMetrics().getAcksSent().get());
+
+    // An idle consumer acks each message as it is consumed.
+    injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()), -1, -1, 200);
+    std::auto_ptr<cms::Message> received(consumer->receive(2000));
+    CPPUNIT_ASSERT(received.get() != NULL);
+    CPPUNIT_ASSERT_EQUAL(4LL, connection->getMetrics().getAcksSent().get());
+
+    consumer->close();
+    session->close();
+    connection->setAckCoalesceCount(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testBatchReceive() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestBatchReceive"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    std::vector<cms::Message*> messages;
+
+    CPPUNIT_ASSERT_EQUAL(0, consumer->receive(messages, 10, -1));
+    CPPUNIT_ASSERT_EQUAL(0, consumer->receive(messages, 10, 5));
+    CPPUNIT_ASSERT(messages.empty());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        consumer->receive(messages, 0, -1),
+        cms::CMSException);
+
+    for (int i = 0; i < 7; ++i) {
+        injectTextMessage("Message " + Integer::toString(i), *topic, *(consumer->getConsumerId()), -1, -1, 300 + i);
+    }
+
+    for (int i = 0; i < 200 && consumer->getMessageAvailableCount() < 7; ++i) {
+        Thread::sleep(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(7, consumer->getMessageAvailableCount());
+
+    connection->getMetrics().reset();
+
+    CPPUNIT_ASSERT_EQUAL(5, consumer->receive(messages, 5, 2000));
+    CPPUNIT_ASSERT_EQUAL(2, consumer->receive(messages, 5, 2000));
+    CPPUNIT_ASSERT_EQUAL(7, (int) messages.size());
+
+    // Each batch is acked once.
+    CPPUNIT_ASSERT_EQUAL(2LL, connection->getMetrics().getAcksSent().get());
+
+    for (int i = 0; i < 7; ++i) {
+        cms::TextMessage* text = dynamic_cast<cms::TextMessage*>(messages[i]);
+        CPPUNIT_ASSERT(text != NULL);
+        CPPUNIT_ASSERT_EQUAL("Message " + Integer::toString(i), text->getText());
+        delete messages[i];
+    }
+
+    consumer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testBorrowedMessages() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestBorrowedMessages"));
+
+    MyBorrowingListener copyListener;
+    std::auto_ptr<ActiveMQConsumer> copyConsumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    copyConsumer->setMessageListener(&copyListener);
+
+    connection->setUseBorrowedMessages(true);
+
+    MyBorrowingListener borrowListener;
+    std::auto_ptr<ActiveMQConsumer> borrowConsumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    borrowConsumer->setMessageListener(&borrowListener);
+
+    connection->setUseBorrowedMessages(false);
+
+    std::vector< Pointer<ActiveMQTextMessage> > sent;
+    ActiveMQConsumer* consumers[] = { copyConsumer.get(), borrowConsumer.get() };
+
+    for (int i = 0; i < 2; ++i) {
+
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId(consumers[i]->getConsumerId()->getConnectionId());
+        producerId->setSessionId(consumers[i]->getConsumerId()->getSessionId());
+        producerId->setValue(1);
+
+        Pointer<MessageId> messageId(new MessageId());
+        messageId->setProducerId(producerId);
+        messageId->setProducerSequenceId(400 + i);
+
+        Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+        message->setText("Message " + Integer::toString(i));
+        message->setCMSDestination(topic.get());
+        message->setMessageId(messageId);
+
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        dispatch->setMessage(message);
+        dispatch->setConsumerId(Pointer<ConsumerId>(consumers[i]->getConsumerId()->cloneDataStructure()));
+
+        sent.push_back(message);
+        dTransport->fireCommand(dispatch);
+    }
+
+    copyListener.waitForMessages(1);
+    borrowListener.waitForMessages(1);
+
+    CPPUNIT_ASSERT_EQUAL(1, (int) copyListener.messages.size());
+    CPPUNIT_ASSERT_EQUAL(1, (int) borrowListener.messages.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 0"), copyListener.texts[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 1"), borrowListener.texts[0]);
+
+    // Only the borrowing consumer hands out the dispatched message itself.
+    CPPUNIT_ASSERT(copyListener.messages[0] != dynamic_cast<cms::Message*>(sent[0].get()));
+    CPPUNIT_ASSERT(borrowListener.messages[0] == dynamic_cast<cms::Message*>(sent[1].get()));
+
+    CPPUNIT_ASSERT(sent[1]->isReadOnlyBody());
+    CPPUNIT_ASSERT(sent[1]->isReadOnlyProperties());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a MessageNotWriteableException",
+        sent[1]->setText("Changed"),
+        cms::MessageNotWriteableException);
+
+    copyConsumer->close();
+    borrowConsumer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testDispatcherLookup() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    // Dispatched on the transport's thread so a listener closing its consumer removes
+    // the dispatcher from within the dispatch.
+    connection->setAlwaysSessionAsync(false);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestDispatcherLookup"));
+
+    const int COUNT = 20;
+    std::vector<MyBorrowingListener*> listeners;
+    std::vector<ActiveMQConsumer*> consumers;
+
+    for (int i = 0; i < COUNT; ++i) {
+        listeners.push_back(new MyBorrowingListener());
+        consumers.push_back(dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+        consumers.back()->setMessageListener(listeners.back());
+    }
+
+    MyClosingListener closingListener;
+    std::auto_ptr<ActiveMQConsumer> closingConsumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    closingListener.consumer = closingConsumer.get();
+    closingConsumer->setMessageListener(&closingListener);
+
+    for (int i = 0; i < COUNT; ++i) {
+        injectTextMessage("Message " + Integer::toString(i), *topic, *consumers[i]->getConsumerId(), 0, 0, 500 + i);
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        listeners[i]->waitForMessages(1);
+        CPPUNIT_ASSERT_EQUAL(1, (int) listeners[i]->texts.size());
+        CPPUNIT_ASSERT_EQUAL("Message " + Integer::toString(i), listeners[i]->texts[0]);
+    }
+
+    // Closing a consumer from its own listener must not wait on that dispatch.
+    injectTextMessage("Closing", *topic, *closingConsumer->getConsumerId(), 0, 0, 600);
+    injectTextMessage("Closing", *topic, *closingConsumer->getConsumerId(), 0, 0, 601);
+    CPPUNIT_ASSERT_EQUAL(1, closingListener.count);
+
+    // Messages for closed consumers are dropped, the others still find theirs.
+    for (int i = 0; i < COUNT; i += 2) {
+        consumers[i]->close();
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        injectTextMessage("Again " + Integer::toString(i), *topic, *consumers[i]->getConsumerId(), 0, 0, 700 + i);
+    }
+
+    for (int i = 1; i < COUNT; i += 2) {
+        listeners[i]->waitForMessages(2);
+        CPPUNIT_ASSERT_EQUAL(2, (int) listeners[i]->texts.size());
+        CPPUNIT_ASSERT_EQUAL("Again " + Integer::toString(i), listeners[i]->texts[1]);
+    }
+
+    for (int i = 0; i < COUNT; i += 2) {
+        CPPUNIT_ASSERT_EQUAL(1, (int) listeners[i]->texts.size());
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        consumers[i]->close();
+        delete consumers[i];
+        delete listeners[i];
+    }
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testDirectDispatch() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    connection->setAlwaysSessionAsync(false);
+    connection->setDirectDispatch(true);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestDirectDispatch"));
+
+    MyBorrowingListener listener;
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    consumer->setMessageListener(&listener);
+
+    for (int i = 0; i < 5; ++i) {
+        injectTextMessage("Message " + Integer::toString(i), *topic, *consumer->getConsumerId(), 0, 0, 800 + i);
+    }
+
+    listener.waitForMessages(5);
+    CPPUNIT_ASSERT_EQUAL(5, (int) listener.texts.size());
+    for (int i = 0; i < 5; ++i) {
+        CPPUNIT_ASSERT_EQUAL("Message " + Integer::toString(i), listener.texts[i]);
+    }
+
+    // A listener closing its own consumer releases the dispatcher it was called from.
+    MyClosingListener closingListener;
+    std::auto_ptr<ActiveMQConsumer> closingConsumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    closingListener.consumer = closingConsumer.get();
+    closingConsumer->setMessageListener(&closingListener);
+
+    injectTextMessage("Closing", *topic, *closingConsumer->getConsumerId(), 0, 0, 900);
+    injectTextMessage("Closing", *topic, *closingConsumer->getConsumerId(), 0, 0, 901);
+    CPPUNIT_ASSERT_EQUAL(1, closingListener.count);
+
+    // Once closed its messages are dropped.
+    consumer->close();
+    injectTextMessage("Dropped", *topic, *consumer->getConsumerId(), 0, 0, 902);
+    CPPUNIT_ASSERT_EQUAL(5, (int) listener.texts.size());
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testTempDestinationBatch() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    MyDestinationInfoCounter counter;
+    connection->setTempDestinationBatchSize(4);
+    dTransport->setOutgoingListener(&counter);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+
+    // The first batch serves three queues, the fourth and fifth take a second one.
+    std::vector<cms::TemporaryQueue*> queues;
+    for (int i = 0; i < 3; ++i) {
+        queues.push_back(session->createTemporaryQueue());
+    }
+    CPPUNIT_ASSERT_EQUAL(4, counter.adds);
+
+    for (int i = 0; i < 2; ++i) {
+        queues.push_back(session->createTemporaryQueue());
+    }
+    CPPUNIT_ASSERT_EQUAL(8, counter.adds);
+
+    for (std::size_t i = 1; i < queues.size(); ++i) {
+        CPPUNIT_ASSERT(queues[i]->getQueueName() != queues[i - 1]->getQueueName());
+    }
+
+    // Topics have batches of their own.
+    std::auto_ptr<cms::TemporaryTopic> topic(session->createTemporaryTopic());
+    CPPUNIT_ASSERT_EQUAL(12, counter.adds);
+
+    queues[0]->destroy();
+    CPPUNIT_ASSERT_EQUAL(1, counter.removes);
+
+    connection->setDeleteTempDestinationsAsync(true);
+    queues[1]->destroy();
+    CPPUNIT_ASSERT_EQUAL(2, counter.removes);
+
+    // The remaining queues and the topic are removed together, the spares are kept.
+    connection->cleanUpTempDestinations();
+    CPPUNIT_ASSERT_EQUAL(6, counter.removes);
+
+    session->close();
+
+    // Closing removes the spares that were never handed out.
+    connection->close();
+    CPPUNIT_ASSERT_EQUAL(12, counter.removes);
+    CPPUNIT_ASSERT_EQUAL(12, counter.adds);
+
+    dTransport->setOutgoingListener(NULL);
+
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        delete queues[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAsyncCommit() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> autoAck(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        dynamic_cast<ActiveMQSession*>(autoAck.get())->commitAsync(),
+        cms::CMSException);
+    autoAck->close();
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::SESSION_TRANSACTED));
+    ActiveMQSession* amqSession = dynamic_cast<ActiveMQSession*>(session.get());
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestAsyncCommit"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    // Nothing to commit yet.
+    Pointer<ActiveMQTransactionContext::CommitFuture> future = amqSession->commitAsync();
+    CPPUNIT_ASSERT(future->isDone());
+    future->await();
+
+    for (int i = 0; i < 10; ++i) {
+        injectTextMessage("This is a Test", *topic, *(consumer->getConsumerId()), -1, -1, 400 + i);
+    }
+
+    for (int i = 0; i < 200 && consumer->getMessageAvailableCount() < 10; ++i) {
+        Thread::sleep(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(10, consumer->getMessageAvailableCount());
+
+    for (int i = 0; i < 5; ++i) {
+        std::auto_ptr<cms::Message> received(consumer->receive(2000));
+        CPPUNIT_ASSERT(received.get() != NULL);
+    }
+
+    connection->getMetrics().reset();
+
+    // The five messages are acked with a single range ack ahead of the commit.
+    future = amqSession->commitAsync();
+    CPPUNIT_ASSERT(future->await(2000));
+    CPPUNIT_ASSERT(future->isDone());
+    CPPUNIT_ASSERT_EQUAL(1LL, connection->getMetrics().getAcksSent().get());
+
+    // The next transaction starts while the earlier commit is left to the session.
+    for (int i = 0; i < 5; ++i) {
+        std::auto_ptr<cms::Message> received(consumer->receive(2000));
+        CPPUNIT_ASSERT(received.get() != NULL);
+    }
+
+    future = amqSession->commitAsync();
+    CPPUNIT_ASSERT_EQUAL(2LL, connection->getMetrics().getAcksSent().get());
+
+    // Committed messages aren't redelivered by a later rollback.
+    session->rollback();
+    CPPUNIT_ASSERT(future->isDone());
+    future->await();
+
+    std::auto_ptr<cms::Message> redelivered(consumer->receive(100));
+    CPPUNIT_ASSERT(redelivered.get() == NULL);
+
+    consumer->close();
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAsyncReceive() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestAsyncReceive"));
+    std::auto_ptr<ActiveMQConsumer> consumer(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a CMSException",
+        consumer->receiveAsync(NULL, 0),
+        cms::CMSException);
+
+    MyReceiveCallback callback;
+
+    // Nothing is prefetched, a receive that doesn't wait completes at once.
+    consumer->receiveAsync(&callback, -1);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, callback.texts.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("<null>"), callback.texts[0]);
+
+    // Waiting receives are completed by the messages in the order they were made.
+    consumer->receiveAsync(&callback, 0);
+    consumer->receiveAsync(&callback, 5000);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, callback.texts.size());
+
+    injectTextMessage("Message 1", *topic, *(consumer->getConsumerId()), -1, -1, 500);
+    injectTextMessage("Message 2", *topic, *(consumer->getConsumerId()), -1, -1, 501);
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 3, callback.waitForCompletions(3));
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 1"), callback.texts[1]);
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 2"), callback.texts[2]);
+
+    // A prefetched message completes the receive before it returns.
+    injectTextMessage("Message 3", *topic, *(consumer->getConsumerId()), -1, -1, 502);
+    for (int i = 0; i < 200 && consumer->getMessageAvailableCount() < 1; ++i) {
+        Thread::sleep(10);
+    }
+    consumer->receiveAsync(&callback, -1);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 4, callback.texts.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Message 3"), callback.texts[3]);
+
+    // The time runs out.
+    consumer->receiveAsync(&callback, 50);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 5, callback.waitForCompletions(5));
+    CPPUNIT_ASSERT_EQUAL(std::string("<null>"), callback.texts[4]);
+
+    // Closing completes whatever is still waiting.
+    consumer->receiveAsync(&callback, 0);
+    consumer->close();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 6, callback.texts.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("<null>"), callback.texts[5]);
+    CPPUNIT_ASSERT_EQUAL(0, callback.errors);
+
+    session->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testMultiplexedSubscriptions() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+
+    SubscriptionMultiplexer& multiplexer = connection->getSubscriptionMultiplexer();
+    connection->setMultiplexTopicSubscriptions(true);
+    connection->setUseBorrowedMessages(true);
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Session> clientAckSession(connection->createSession(cms::Session::CLIENT_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic(session->createTopic("TestMultiplexedSubscriptions"));
+
+    MyBorrowingListener listener1;
+    std::auto_ptr<ActiveMQConsumer> consumer1(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    consumer1->setMessageListener(&listener1);
+
+    MyBorrowingListener listener2;
+    std::auto_ptr<ActiveMQConsumer> consumer2(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get())));
+    consumer2->setMessageListener(&listener2);
+
+    std::auto_ptr<ActiveMQConsumer> selecting(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic.get(), "color = 'red'")));
+    std::auto_ptr<ActiveMQConsumer> clientAck(
+        dynamic_cast<ActiveMQConsumer*>(clientAckSession->createConsumer(topic.get())));
+
+    connection->setUseBorrowedMessages(false);
+
+    // The consumers with the same selector share, a client acknowledge one never does.
+    CPPUNIT_ASSERT_EQUAL(2, multiplexer.getSubscriptionCount());
+    CPPUNIT_ASSERT_EQUAL(3, multiplexer.getMemberCount());
+
+    Pointer<ConsumerId> shared = multiplexer.getSubscriptionId(*consumer1->getConsumerId());
+    CPPUNIT_ASSERT(shared != NULL);
+    CPPUNIT_ASSERT(*shared == *multiplexer.getSubscriptionId(*consumer2->getConsumerId()));
+    CPPUNIT_ASSERT(!(*shared == *multiplexer.getSubscriptionId(*selecting->getConsumerId())));
+    CPPUNIT_ASSERT(multiplexer.getSubscriptionId(*clientAck->getConsumerId()) == NULL);
+
+    // One dispatch from the broker reaches both members with the same message.
+    injectTextMessage("Shared", *topic, *shared, -1, -1, 800);
+
+    listener1.waitForMessages(1);
+    listener2.waitForMessages(1);
+    CPPUNIT_ASSERT_EQUAL(1, (int) listener1.messages.size());
+    CPPUNIT_ASSERT_EQUAL(1, (int) listener2.messages.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Shared"), listener1.texts[0]);
+    CPPUNIT_ASSERT_EQUAL(std::string("Shared"), listener2.texts[0]);
+    CPPUNIT_ASSERT(listener1.messages[0] == listener2.messages[0]);
+    CPPUNIT_ASSERT_EQUAL(0, selecting->getMessageAvailableCount());
+
+    // A member that closes gets nothing more, the subscription stays for the other.
+    consumer1->close();
+    CPPUNIT_ASSERT_EQUAL(2, multiplexer.getSubscriptionCount());
+    CPPUNIT_ASSERT_EQUAL(2, multiplexer.getMemberCount());
+
+    injectTextMessage("After", *topic, *shared, -1, -1, 801);
+
+    listener2.waitForMessages(2);
+    CPPUNIT_ASSERT_EQUAL(2, (int) listener2.messages.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("After"), listener2.texts[1]);
+    CPPUNIT_ASSERT_EQUAL(1, (int) listener1.messages.size());
+
+    // The last member out removes the subscription.
+    consumer2->close();
+    CPPUNIT_ASSERT_EQUAL(1, multiplexer.getSubscriptionCount());
+    CPPUNIT_ASSERT(multiplexer.getSubscriptionId(*consumer2->getConsumerId()) == NULL);
+
+    selecting->close();
+    clientAck->close();
+    CPPUNIT_ASSERT_EQUAL(0, multiplexer.getSubscriptionCount());
+    CPPUNIT_ASSERT_EQUAL(0, multiplexer.getMemberCount());
+
+    session->close();
+    clientAckSession->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQSessionTest::testAckAggregation() {
+
+    CPPUNIT_ASSERT(connection.get() != NULL);
+    CPPUNIT_ASSERT(connection->isAggregateSessionAcks());
+
+    MyAckCounter ackCounter;
+    MyCMSMessageListener listener1;
+    MyCMSMessageListener listener2;
+
+    std::auto_ptr<cms::Session> session(connection->createSession(cms::Session::AUTO_ACKNOWLEDGE));
+    std::auto_ptr<cms::Topic> topic1(session->createTopic("TestAckAggregation1"));
+    std::auto_ptr<cms::Topic> topic2(session->createTopic("TestAckAggregation2"));
+    std::auto_ptr<ActiveMQConsumer> consumer1(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic1.get())));
+    std::auto_ptr<ActiveMQConsumer> consumer2(
+        dynamic_cast<ActiveMQConsumer*>(session->createConsumer(topic2.get())));
+
+    consumer1->setMessageListener(&listener1);
+    consumer2->setMessageListener(&listener2);
+
+    dTransport->setOutgoingListener(&ackCounter);
+
+    for (int i = 0; i < 3; ++i) {
+        injectTextMessage("This is a Test", *topic1, *(consumer1->getConsumerId()), -1, -1, 400 + i);
+        injectTextMessage("This is a Test", *topic2, *(consumer2->getConsumerId()), -1, -1, 500 + i);
+    }
+
+    listener1.asyncWaitForMessages(3);
+    listener2.asyncWaitForMessages(3);
+    CPPUNIT_ASSERT_EQUAL(3, (int) listener1.messages.size());
+    CPPUNIT_ASSERT_EQUAL(3, (int) listener2.messages.size());
+
+    // The acks held during each round go out once it ends, none is left behind.
+    for (int i = 0; i < 200 && ackCounter.getAcks() < 6; ++i) {
+        Thread::sleep(10);
+    }
+    CPPUNIT_ASSERT_EQUAL(6, ackCounter.getAcks());
+
+    dTransport->setOutgoingListener(NULL);
+
+    consumer1->close();
+    consumer2->close();
+    session->close();
+}
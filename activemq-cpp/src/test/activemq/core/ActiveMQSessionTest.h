@@ -48,9 +48,29 @@ namespace core{
         CPPUNIT_TEST( testTransactionRollbackTwoConsumer );
         CPPUNIT_TEST( testTransactionCloseWithoutCommit );
         CPPUNIT_TEST( testExpiration );
+        CPPUNIT_TEST( testExpiredRunAckedOnce );
         CPPUNIT_TEST( testCreateManyConsumersAndSetListeners );
         CPPUNIT_TEST( testCreateTempQueueByName );
         CPPUNIT_TEST( testCreateTempTopicByName );
+        CPPUNIT_TEST( testSessionDispatchPool );
+        CPPUNIT_TEST( testSendAssignsMessageId );
+        CPPUNIT_TEST( testMetrics );
+        CPPUNIT_TEST( testMemoryAccounting );
+        CPPUNIT_TEST( testMessageTracer );
+        CPPUNIT_TEST( testBatchSend );
+        CPPUNIT_TEST( testMultiDestinationSend );
+        CPPUNIT_TEST( testPreparedSend );
+        CPPUNIT_TEST( testPipelinedSends );
+        CPPUNIT_TEST( testAckCoalescing );
+        CPPUNIT_TEST( testBatchReceive );
+        CPPUNIT_TEST( testBorrowedMessages );
+        CPPUNIT_TEST( testDispatcherLookup );
+        CPPUNIT_TEST( testDirectDispatch );
+        CPPUNIT_TEST( testTempDestinationBatch );
+        CPPUNIT_TEST( testAsyncCommit );
+        CPPUNIT_TEST( testAsyncReceive );
+        CPPUNIT_TEST( testMultiplexedSubscriptions );
+        CPPUNIT_TEST( testAckAggregation );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -88,7 +108,8 @@ namespace core{
                                const cms::Destination& destination,
                                const commands::ConsumerId& id,
                                const long long timeStamp = -1,
-                               const long long timeToLive = -1);
+                               const long long timeToLive = -1,
+                               const long long sequenceId = 2);
 
     public:
 
@@ -105,8 +126,28 @@ namespace core{
         void testTransactionCloseWithoutCommit();
         void testTransactionCommitAfterConsumerClosed();
         void testExpiration();
+        void testExpiredRunAckedOnce();
         void testCreateTempQueueByName();
         void testCreateTempTopicByName();
+        void testSessionDispatchPool();
+        void testSendAssignsMessageId();
+        void testMetrics();
+        void testMemoryAccounting();
+        void testMessageTracer();
+        void testBatchSend();
+        void testMultiDestinationSend();
+        void testPreparedSend();
+        void testPipelinedSends();
+        void testAckCoalescing();
+        void testBatchReceive();
+        void testBorrowedMessages();
+        void testDispatcherLookup();
+        void testDirectDispatch();
+        void testTempDestinationBatch();
+        void testAsyncCommit();
+        void testAsyncReceive();
+        void testMultiplexedSubscriptions();
+        void testAckAggregation();
 
     };
 
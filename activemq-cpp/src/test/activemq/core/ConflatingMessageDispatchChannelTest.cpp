@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConflatingMessageDispatchChannelTest.h"
+
+#include <activemq/core/ConflatingMessageDispatchChannel.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/Message.h>
+#include <decaf/lang/Pointer.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch(const std::string& symbol) {
+        Pointer<Message> message(new Message());
+        if (!symbol.empty()) {
+            message->getMessageProperties().setString("symbol", symbol);
+        }
+        Pointer<MessageDispatch> dispatch(new MessageDispatch());
+        dispatch->setMessage(message);
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testCtor() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "symbol" ), channel.getKeyProperty() );
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isClosed() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testClose() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+    channel.start();
+    channel.enqueue( createDispatch( "A" ) );
+    channel.close();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isClosed() == true );
+    CPPUNIT_ASSERT( channel.dequeue( -1 ) == NULL );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testConflate() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    Pointer<MessageDispatch> a1 = createDispatch( "A" );
+    Pointer<MessageDispatch> b1 = createDispatch( "B" );
+    Pointer<MessageDispatch> a2 = createDispatch( "A" );
+    Pointer<MessageDispatch> b2 = createDispatch( "B" );
+    Pointer<MessageDispatch> a3 = createDispatch( "A" );
+
+    channel.enqueue( a1 );
+    channel.enqueue( b1 );
+    channel.enqueue( a2 );
+    channel.enqueue( b2 );
+    channel.enqueue( a3 );
+
+    // One message per key, each in the place of the first one of its key.
+    CPPUNIT_ASSERT_EQUAL( 2, channel.size() );
+
+    std::vector< Pointer<MessageDispatch> > superseded;
+    CPPUNIT_ASSERT_EQUAL( 3, channel.takeSuperseded( superseded ) );
+    CPPUNIT_ASSERT( superseded[0] == a1 );
+    CPPUNIT_ASSERT( superseded[1] == b1 );
+    CPPUNIT_ASSERT( superseded[2] == a2 );
+    CPPUNIT_ASSERT_EQUAL( 0, channel.takeSuperseded( superseded ) );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.peek() == a3 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == a3 );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == b2 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+
+    // Once delivered a key starts over at the back of the queue.
+    Pointer<MessageDispatch> a4 = createDispatch( "A" );
+    channel.enqueue( a4 );
+    CPPUNIT_ASSERT_EQUAL( 1, channel.size() );
+    CPPUNIT_ASSERT_EQUAL( 0, channel.takeSuperseded( superseded ) );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == a4 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testConflateOnGroup() {
+
+    ConflatingMessageDispatchChannel channel( "JMSXGroupID" );
+
+    Pointer<MessageDispatch> first = createDispatch( "" );
+    Pointer<MessageDispatch> second = createDispatch( "" );
+    first->getMessage()->setGroupID( "G" );
+    second->getMessage()->setGroupID( "G" );
+
+    channel.enqueue( first );
+    channel.enqueue( second );
+    CPPUNIT_ASSERT_EQUAL( 1, channel.size() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == second );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testUnkeyed() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    Pointer<MessageDispatch> plain1 = createDispatch( "" );
+    Pointer<MessageDispatch> plain2 = createDispatch( "" );
+    Pointer<MessageDispatch> empty( new MessageDispatch() );
+
+    channel.enqueue( plain1 );
+    channel.enqueue( plain2 );
+    channel.enqueue( empty );
+    CPPUNIT_ASSERT_EQUAL( 3, channel.size() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == plain1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == plain2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == empty );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testEnqueueFront() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    Pointer<MessageDispatch> a1 = createDispatch( "A" );
+    Pointer<MessageDispatch> a2 = createDispatch( "A" );
+    Pointer<MessageDispatch> a3 = createDispatch( "A" );
+
+    // A message put back is not replaced, the newer pending one is.
+    channel.enqueue( a2 );
+    channel.enqueueFirst( a1 );
+    channel.enqueue( a3 );
+    CPPUNIT_ASSERT_EQUAL( 2, channel.size() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == a1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == a3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testDequeueAll() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    channel.enqueue( createDispatch( "A" ) );
+    channel.enqueue( createDispatch( "B" ) );
+    channel.enqueue( createDispatch( "C" ) );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+    CPPUNIT_ASSERT_EQUAL( 0, channel.dequeueAll( buffer, 10 ) );
+
+    channel.start();
+    CPPUNIT_ASSERT_EQUAL( 2, channel.dequeueAll( buffer, 2 ) );
+    CPPUNIT_ASSERT_EQUAL( 1, channel.size() );
+
+    // The keys taken no longer conflate with anything.
+    channel.enqueue( createDispatch( "A" ) );
+    CPPUNIT_ASSERT_EQUAL( 2, channel.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testRemoveAll() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    Pointer<MessageDispatch> a = createDispatch( "A" );
+    Pointer<MessageDispatch> b = createDispatch( "B" );
+
+    channel.enqueue( a );
+    channel.enqueue( b );
+
+    std::vector< Pointer<MessageDispatch> > result = channel.removeAll();
+    CPPUNIT_ASSERT_EQUAL( 2, (int) result.size() );
+    CPPUNIT_ASSERT( result[0] == a );
+    CPPUNIT_ASSERT( result[1] == b );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+
+    channel.enqueue( createDispatch( "A" ) );
+    CPPUNIT_ASSERT_EQUAL( 1, channel.size() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConflatingMessageDispatchChannelTest::testMemoryUsage() {
+
+    ConflatingMessageDispatchChannel channel( "symbol" );
+
+    Pointer<MessageDispatch> small = createDispatch( "A" );
+    Pointer<MessageDispatch> large = createDispatch( "A" );
+    small->getMessage()->setContent( std::vector<unsigned char>( 16 ) );
+    large->getMessage()->setContent( std::vector<unsigned char>( 4096 ) );
+
+    long long smallSize = small->getMessage()->getSize();
+    long long largeSize = large->getMessage()->getSize();
+
+    channel.enqueue( small );
+    CPPUNIT_ASSERT_EQUAL( smallSize, channel.getMemoryUsage() );
+
+    // Only the message that replaced the other counts.
+    channel.enqueue( large );
+    CPPUNIT_ASSERT_EQUAL( largeSize, channel.getMemoryUsage() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == large );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+}
@@ -24,7 +24,9 @@
 #include <activemq/commands/Message.h>
 #include <activemq/commands/ActiveMQDestination.h>
 #include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTopic.h>
 
+#include <decaf/lang/Integer.h>
 #include <decaf/util/ArrayList.h>
 
 using namespace std;
@@ -40,8 +42,16 @@ using namespace decaf::util;
 namespace {
 
     class MyDispatcher : public Dispatcher {
+    private:
+
+        int hashCode;
+
     public:
 
+        MyDispatcher() : hashCode(1) {}
+
+        MyDispatcher(int hashCode) : hashCode(hashCode) {}
+
         virtual ~MyDispatcher() {}
 
         virtual void dispatch(const Pointer<commands::MessageDispatch>& message) {
@@ -49,10 +59,27 @@ namespace {
         }
 
         virtual int getHashCode() const {
-            return 1;
+            return hashCode;
         }
 
     };
+
+    Pointer<Message> createMessage(ActiveMQDestination* destination, long long sequence) {
+
+        Pointer<ProducerId> pid(new ProducerId);
+        pid->setConnectionId("test");
+        pid->setSessionId(0);
+        pid->setValue(1);
+
+        Pointer<MessageId> id(new MessageId);
+        id->setProducerId(pid);
+        id->setProducerSequenceId(sequence);
+
+        Pointer<Message> message(new Message());
+        message->setMessageId(id);
+        message->setDestination(Pointer<ActiveMQDestination>(destination));
+        return message;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,3 +183,41 @@ void ConnectionAuditTest::testRollbackDuplicate() {
                                !audit.isDuplicate(dispatcher.get(), message));
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionAuditTest::testManyDestinations() {
+
+    ConnectionAudit audit;
+    MyDispatcher dispatcher1(1);
+    MyDispatcher dispatcher2(2);
+
+    // Queues are audited by name whichever consumer and destination instance are used.
+    for (int i = 0; i < 100; ++i) {
+        std::string name = std::string("TEST.QUEUE.") + Integer::toString(i);
+        CPPUNIT_ASSERT(!audit.isDuplicate(&dispatcher1, createMessage(new ActiveMQQueue(name), 1)));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        std::string name = std::string("TEST.QUEUE.") + Integer::toString(i);
+        CPPUNIT_ASSERT(audit.isDuplicate(&dispatcher2, createMessage(new ActiveMQQueue(name), 1)));
+        CPPUNIT_ASSERT(!audit.isDuplicate(&dispatcher2, createMessage(new ActiveMQQueue(name), 2)));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionAuditTest::testIsDuplicateTopic() {
+
+    ConnectionAudit audit;
+    MyDispatcher dispatcher1(1);
+    MyDispatcher dispatcher2(17);
+
+    // Topic messages are audited per dispatcher since every subscriber gets a copy.
+    CPPUNIT_ASSERT(!audit.isDuplicate(&dispatcher1, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+    CPPUNIT_ASSERT(!audit.isDuplicate(&dispatcher2, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+    CPPUNIT_ASSERT(audit.isDuplicate(&dispatcher1, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+    CPPUNIT_ASSERT(audit.isDuplicate(&dispatcher2, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+
+    audit.removeDispatcher(&dispatcher1);
+    CPPUNIT_ASSERT(!audit.isDuplicate(&dispatcher1, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+    CPPUNIT_ASSERT(audit.isDuplicate(&dispatcher2, createMessage(new ActiveMQTopic("TEST.TOPIC"), 1)));
+}
@@ -31,6 +31,8 @@ namespace core {
         CPPUNIT_TEST( testConstructor2 );
         CPPUNIT_TEST( testIsDuplicate );
         CPPUNIT_TEST( testRollbackDuplicate );
+        CPPUNIT_TEST( testManyDestinations );
+        CPPUNIT_TEST( testIsDuplicateTopic );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -42,6 +44,8 @@ namespace core {
         void testConstructor2();
         void testIsDuplicate();
         void testRollbackDuplicate();
+        void testManyDestinations();
+        void testIsDuplicateTopic();
 
     };
 
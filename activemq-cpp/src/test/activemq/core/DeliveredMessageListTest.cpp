@@ -0,0 +1,292 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DeliveredMessageListTest.h"
+
+#include <activemq/core/DeliveredMessageList.h>
+#include <activemq/commands/Message.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+
+#include <decaf/util/LinkedList.h>
+#include <decaf/util/NoSuchElementException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageId> createMessageId(long long sequence) {
+        Pointer<ProducerId> pid(new ProducerId);
+        pid->setConnectionId("test");
+        pid->setSessionId(0);
+        pid->setValue(1);
+
+        Pointer<MessageId> id(new MessageId);
+        id->setProducerId(pid);
+        id->setProducerSequenceId(sequence);
+        return id;
+    }
+
+    Pointer<MessageDispatch> createDispatch(long long sequence) {
+        Pointer<Message> message(new Message);
+        message->setMessageId(createMessageId(sequence));
+
+        Pointer<MessageDispatch> dispatch(new MessageDispatch);
+        dispatch->setMessage(message);
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageListTest::DeliveredMessageListTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DeliveredMessageListTest::~DeliveredMessageListTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testAddFirstOrdering() {
+
+    DeliveredMessageList list;
+    CPPUNIT_ASSERT(list.isEmpty());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.getFirst(),
+        NoSuchElementException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.getLast(),
+        NoSuchElementException);
+
+    Pointer<MessageDispatch> dispatch1 = createDispatch(1);
+    Pointer<MessageDispatch> dispatch2 = createDispatch(2);
+    Pointer<MessageDispatch> dispatch3 = createDispatch(3);
+
+    list.addFirst(dispatch1);
+    list.addFirst(dispatch2);
+    list.addFirst(dispatch3);
+
+    CPPUNIT_ASSERT_EQUAL(3, list.size());
+    CPPUNIT_ASSERT(list.getFirst() == dispatch3);
+    CPPUNIT_ASSERT(list.getLast() == dispatch1);
+
+    std::auto_ptr<Iterator<Pointer<MessageDispatch> > > iter(list.iterator());
+    CPPUNIT_ASSERT(iter->next() == dispatch3);
+    CPPUNIT_ASSERT(iter->next() == dispatch2);
+    CPPUNIT_ASSERT(iter->next() == dispatch1);
+    CPPUNIT_ASSERT(!iter->hasNext());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testRemoveLast() {
+
+    DeliveredMessageList list;
+
+    for (int i = 0; i < 10; ++i) {
+        list.addFirst(createDispatch(i));
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        Pointer<MessageDispatch> dispatch = list.removeLast();
+        CPPUNIT_ASSERT_EQUAL((long long) i, dispatch->getMessage()->getMessageId()->getProducerSequenceId());
+        CPPUNIT_ASSERT(!list.contains(dispatch));
+    }
+
+    CPPUNIT_ASSERT(list.isEmpty());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        list.removeLast(),
+        NoSuchElementException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testContainsAndRemove() {
+
+    DeliveredMessageList list;
+    Pointer<MessageDispatch> dispatch1 = createDispatch(1);
+    Pointer<MessageDispatch> dispatch2 = createDispatch(2);
+    Pointer<MessageDispatch> dispatch3 = createDispatch(3);
+
+    list.addFirst(dispatch1);
+    list.addFirst(dispatch2);
+    list.addFirst(dispatch3);
+
+    CPPUNIT_ASSERT(list.contains(dispatch2));
+
+    // Same MessageId but a different dispatch isn't an entry of the list.
+    CPPUNIT_ASSERT(!list.contains(createDispatch(2)));
+    CPPUNIT_ASSERT(!list.remove(createDispatch(2)));
+
+    CPPUNIT_ASSERT(list.remove(dispatch2));
+    CPPUNIT_ASSERT(!list.contains(dispatch2));
+    CPPUNIT_ASSERT(!list.remove(dispatch2));
+    CPPUNIT_ASSERT_EQUAL(2, list.size());
+    CPPUNIT_ASSERT(list.getFirst() == dispatch3);
+    CPPUNIT_ASSERT(list.getLast() == dispatch1);
+
+    CPPUNIT_ASSERT(list.remove(dispatch3));
+    CPPUNIT_ASSERT(list.getFirst() == dispatch1);
+    CPPUNIT_ASSERT(list.remove(dispatch1));
+    CPPUNIT_ASSERT(list.isEmpty());
+
+    list.addFirst(dispatch1);
+    list.clear();
+    CPPUNIT_ASSERT(list.isEmpty());
+    CPPUNIT_ASSERT(!list.contains(dispatch1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testRemoveByMessageId() {
+
+    DeliveredMessageList list;
+
+    for (int i = 0; i < 100; ++i) {
+        list.addFirst(createDispatch(i));
+    }
+
+    Pointer<MessageId> id = createMessageId(42);
+    Pointer<MessageDispatch> found = list.get(*id);
+    CPPUNIT_ASSERT(found != NULL);
+    CPPUNIT_ASSERT(found->getMessage()->getMessageId()->equals(id.get()));
+
+    Pointer<MessageDispatch> removed = list.remove(*id);
+    CPPUNIT_ASSERT(removed == found);
+    CPPUNIT_ASSERT_EQUAL(99, list.size());
+    CPPUNIT_ASSERT(list.get(*id) == NULL);
+    CPPUNIT_ASSERT(list.remove(*id) == NULL);
+    CPPUNIT_ASSERT(list.get(*createMessageId(100)) == NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testIteratorRemove() {
+
+    DeliveredMessageList list;
+
+    for (int i = 0; i < 10; ++i) {
+        list.addFirst(createDispatch(i));
+    }
+
+    std::auto_ptr<Iterator<Pointer<MessageDispatch> > > iter(list.iterator());
+    while (iter->hasNext()) {
+        Pointer<MessageDispatch> dispatch = iter->next();
+        if (dispatch->getMessage()->getMessageId()->getProducerSequenceId() % 2 == 0) {
+            iter->remove();
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(5, list.size());
+    CPPUNIT_ASSERT(list.get(*createMessageId(4)) == NULL);
+    CPPUNIT_ASSERT(list.get(*createMessageId(5)) != NULL);
+    CPPUNIT_ASSERT_EQUAL(9LL, list.getFirst()->getMessage()->getMessageId()->getProducerSequenceId());
+    CPPUNIT_ASSERT_EQUAL(1LL, list.getLast()->getMessage()->getMessageId()->getProducerSequenceId());
+
+    std::auto_ptr<Iterator<Pointer<MessageDispatch> > > fresh(list.iterator());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        fresh->remove(),
+        decaf::lang::exceptions::IllegalStateException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testDuplicateMessageIds() {
+
+    DeliveredMessageList list;
+    Pointer<MessageDispatch> original = createDispatch(1);
+    Pointer<MessageDispatch> duplicate = createDispatch(1);
+    Pointer<MessageDispatch> other = createDispatch(2);
+
+    list.addFirst(original);
+    list.addFirst(other);
+    list.addFirst(duplicate);
+
+    CPPUNIT_ASSERT(list.contains(original));
+    CPPUNIT_ASSERT(list.contains(duplicate));
+
+    CPPUNIT_ASSERT(list.remove(original));
+    CPPUNIT_ASSERT(list.contains(duplicate));
+    CPPUNIT_ASSERT(list.get(*createMessageId(1)) == duplicate);
+
+    CPPUNIT_ASSERT(list.remove(*createMessageId(1)) == duplicate);
+    CPPUNIT_ASSERT(list.get(*createMessageId(1)) == NULL);
+    CPPUNIT_ASSERT_EQUAL(1, list.size());
+
+    // Entries without a MessageId are kept but can only be found by identity.
+    Pointer<MessageDispatch> empty(new MessageDispatch);
+    list.addFirst(empty);
+    CPPUNIT_ASSERT(list.contains(empty));
+    CPPUNIT_ASSERT(list.remove(empty));
+    CPPUNIT_ASSERT(list.getFirst() == other);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testCopy() {
+
+    DeliveredMessageList list;
+
+    for (int i = 0; i < 5; ++i) {
+        list.addFirst(createDispatch(i));
+    }
+
+    LinkedList<Pointer<MessageDispatch> > copy;
+    copy.copy(list);
+
+    CPPUNIT_ASSERT_EQUAL(5, copy.size());
+    CPPUNIT_ASSERT(copy.getFirst() == list.getFirst());
+    CPPUNIT_ASSERT(copy.getLast() == list.getLast());
+
+    DeliveredMessageList other;
+    other.copy(copy);
+    CPPUNIT_ASSERT_EQUAL(5, other.size());
+    CPPUNIT_ASSERT(other.getFirst() == list.getFirst());
+    CPPUNIT_ASSERT(other.getLast() == list.getLast());
+    CPPUNIT_ASSERT(other.contains(list.getFirst()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DeliveredMessageListTest::testConstIterator() {
+
+    DeliveredMessageList list;
+    CPPUNIT_ASSERT(list.begin() == list.end());
+
+    for (int i = 0; i < 5; ++i) {
+        list.addFirst(createDispatch(i));
+    }
+
+    long long expected = 4;
+    DeliveredMessageList::const_iterator iter = list.begin();
+    for (; iter != list.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(expected--, (*iter)->getMessage()->getMessageId()->getProducerSequenceId());
+    }
+    CPPUNIT_ASSERT_EQUAL(-1LL, expected);
+
+    std::vector< Pointer<MessageDispatch> > copied(list.begin(), list.end());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 5, copied.size());
+    CPPUNIT_ASSERT(copied.front() == list.getFirst());
+}
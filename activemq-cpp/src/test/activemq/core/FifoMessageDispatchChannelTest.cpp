@@ -19,9 +19,12 @@
 
 #include <activemq/core/FifoMessageDispatchChannel.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/Message.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/System.h>
 
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::core;
 using namespace activemq::commands;
@@ -230,3 +233,85 @@ void FifoMessageDispatchChannelTest::testRemoveAll() {
     CPPUNIT_ASSERT( channel.size() == 0 );
     CPPUNIT_ASSERT( channel.isEmpty() == true );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void FifoMessageDispatchChannelTest::testDequeueAll() {
+
+    FifoMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 0 );
+    CPPUNIT_ASSERT( buffer.empty() );
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 2 ) == 2 );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+    CPPUNIT_ASSERT( buffer.size() == 2 );
+    CPPUNIT_ASSERT( buffer[0] == dispatch1 );
+    CPPUNIT_ASSERT( buffer[1] == dispatch2 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT( buffer.size() == 3 );
+    CPPUNIT_ASSERT( buffer[2] == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 0 );
+    CPPUNIT_ASSERT( buffer.size() == 3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FifoMessageDispatchChannelTest::testMemoryUsage() {
+
+    FifoMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> small( new MessageDispatch() );
+    Pointer<MessageDispatch> large( new MessageDispatch() );
+    Pointer<MessageDispatch> empty( new MessageDispatch() );
+
+    Pointer<Message> smallMessage( new Message() );
+    Pointer<Message> largeMessage( new Message() );
+
+    smallMessage->setContent( std::vector<unsigned char>( 16 ) );
+    largeMessage->setContent( std::vector<unsigned char>( 4096 ) );
+
+    small->setMessage( smallMessage );
+    large->setMessage( largeMessage );
+
+    long long smallSize = smallMessage->getSize();
+    long long largeSize = largeMessage->getSize();
+
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    channel.enqueueFirst( empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == small );
+    CPPUNIT_ASSERT_EQUAL( largeSize, channel.getMemoryUsage() );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    CPPUNIT_ASSERT( channel.removeAll().size() == 2 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( large );
+    channel.clear();
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+}
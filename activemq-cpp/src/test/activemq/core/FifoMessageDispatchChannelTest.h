@@ -37,6 +37,8 @@ namespace core {
         CPPUNIT_TEST( testDequeueNoWait );
         CPPUNIT_TEST( testDequeue );
         CPPUNIT_TEST( testRemoveAll );
+        CPPUNIT_TEST( testDequeueAll );
+        CPPUNIT_TEST( testMemoryUsage );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -54,6 +56,8 @@ namespace core {
         void testDequeueNoWait();
         void testDequeue();
         void testRemoveAll();
+        void testDequeueAll();
+        void testMemoryUsage();
 
     };
 
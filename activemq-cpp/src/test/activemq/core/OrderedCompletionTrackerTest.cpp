@@ -0,0 +1,167 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OrderedCompletionTrackerTest.h"
+
+#include <activemq/core/OrderedCompletionTracker.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch() {
+        return Pointer<MessageDispatch>(new MessageDispatch());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTrackerTest::testInOrder() {
+
+    OrderedCompletionTracker tracker;
+    CPPUNIT_ASSERT(tracker.isEmpty());
+
+    Pointer<MessageDispatch> one = createDispatch();
+    Pointer<MessageDispatch> two = createDispatch();
+
+    long long first = tracker.add(one);
+    long long second = tracker.add(two);
+    CPPUNIT_ASSERT_EQUAL(first + 1, second);
+    CPPUNIT_ASSERT_EQUAL(2, tracker.size());
+
+    Pointer<MessageDispatch> from;
+    Pointer<MessageDispatch> to;
+
+    CPPUNIT_ASSERT_EQUAL(1, tracker.complete(first, from, to));
+    CPPUNIT_ASSERT(from == one);
+    CPPUNIT_ASSERT(to == one);
+
+    CPPUNIT_ASSERT_EQUAL(1, tracker.complete(second, from, to));
+    CPPUNIT_ASSERT(from == two);
+    CPPUNIT_ASSERT(to == two);
+    CPPUNIT_ASSERT(tracker.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTrackerTest::testOutOfOrder() {
+
+    OrderedCompletionTracker tracker;
+
+    Pointer<MessageDispatch> dispatches[4];
+    long long sequences[4];
+    for (int i = 0; i < 4; ++i) {
+        dispatches[i] = createDispatch();
+        sequences[i] = tracker.add(dispatches[i]);
+    }
+
+    Pointer<MessageDispatch> from;
+    Pointer<MessageDispatch> to;
+
+    // Nothing is released while the oldest message is still being consumed.
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(sequences[2], from, to));
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(sequences[1], from, to));
+    CPPUNIT_ASSERT(from == NULL);
+    CPPUNIT_ASSERT_EQUAL(4, tracker.size());
+
+    CPPUNIT_ASSERT_EQUAL(3, tracker.complete(sequences[0], from, to));
+    CPPUNIT_ASSERT(from == dispatches[0]);
+    CPPUNIT_ASSERT(to == dispatches[2]);
+    CPPUNIT_ASSERT_EQUAL(1, tracker.size());
+
+    CPPUNIT_ASSERT_EQUAL(1, tracker.complete(sequences[3], from, to));
+    CPPUNIT_ASSERT(from == dispatches[3]);
+    CPPUNIT_ASSERT(to == dispatches[3]);
+    CPPUNIT_ASSERT(tracker.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTrackerTest::testExclude() {
+
+    OrderedCompletionTracker tracker;
+
+    Pointer<MessageDispatch> dispatches[4];
+    long long sequences[4];
+    for (int i = 0; i < 4; ++i) {
+        dispatches[i] = createDispatch();
+        sequences[i] = tracker.add(dispatches[i]);
+    }
+
+    Pointer<MessageDispatch> from;
+    Pointer<MessageDispatch> to;
+
+    CPPUNIT_ASSERT_EQUAL(0, tracker.exclude(sequences[1], from, to));
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(sequences[2], from, to));
+
+    // The excluded message is released but not counted or reported.
+    CPPUNIT_ASSERT_EQUAL(2, tracker.complete(sequences[0], from, to));
+    CPPUNIT_ASSERT(from == dispatches[0]);
+    CPPUNIT_ASSERT(to == dispatches[2]);
+    CPPUNIT_ASSERT_EQUAL(sequences[3], tracker.getHeadSequence());
+
+    // Excluding the head releases nothing to report.
+    from.reset(NULL);
+    CPPUNIT_ASSERT_EQUAL(0, tracker.exclude(sequences[3], from, to));
+    CPPUNIT_ASSERT(from == NULL);
+    CPPUNIT_ASSERT(tracker.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(sequences[3] + 1, tracker.getHeadSequence());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTrackerTest::testUnknownSequence() {
+
+    OrderedCompletionTracker tracker;
+
+    Pointer<MessageDispatch> from;
+    Pointer<MessageDispatch> to;
+
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(0, from, to));
+
+    long long sequence = tracker.add(createDispatch());
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(sequence + 1, from, to));
+    CPPUNIT_ASSERT_EQUAL(1, tracker.complete(sequence, from, to));
+
+    // Completing a message twice releases nothing the second time.
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(sequence, from, to));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OrderedCompletionTrackerTest::testClear() {
+
+    OrderedCompletionTracker tracker;
+
+    long long old = tracker.add(createDispatch());
+    tracker.add(createDispatch());
+    tracker.clear();
+    CPPUNIT_ASSERT(tracker.isEmpty());
+
+    Pointer<MessageDispatch> dispatch = createDispatch();
+    long long sequence = tracker.add(dispatch);
+    CPPUNIT_ASSERT(sequence > old + 1);
+
+    Pointer<MessageDispatch> from;
+    Pointer<MessageDispatch> to;
+
+    CPPUNIT_ASSERT_EQUAL(0, tracker.complete(old, from, to));
+    CPPUNIT_ASSERT_EQUAL(1, tracker.size());
+
+    CPPUNIT_ASSERT_EQUAL(1, tracker.complete(sequence, from, to));
+    CPPUNIT_ASSERT(from == dispatch);
+}
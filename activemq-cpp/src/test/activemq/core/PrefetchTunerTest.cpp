@@ -0,0 +1,140 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PrefetchTunerTest.h"
+
+#include <activemq/core/PrefetchTuner.h>
+
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const long long MILLIS = 1000000LL;
+
+    // Records the same processing time count times, returns how many changed the prefetch.
+    int record(PrefetchTuner& tuner, long long nanos, int count) {
+        int changes = 0;
+        for (int i = 0; i < count; ++i) {
+            if (tuner.recordProcessingTime(nanos)) {
+                changes++;
+            }
+        }
+        return changes;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testConstructor() {
+
+    PrefetchTuner tuner(1000, 100);
+
+    CPPUNIT_ASSERT_EQUAL(1000, tuner.getPrefetch());
+    CPPUNIT_ASSERT_EQUAL(1000, tuner.getMaximumPrefetch());
+    CPPUNIT_ASSERT_EQUAL(100LL, tuner.getTargetLatency());
+    CPPUNIT_ASSERT_EQUAL(0LL, tuner.getAverageProcessingTime());
+
+    CPPUNIT_ASSERT(!tuner.recordProcessingTime(-1));
+    CPPUNIT_ASSERT_EQUAL(0LL, tuner.getAverageProcessingTime());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        PrefetchTuner(0, 100),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        PrefetchTuner(100, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testSlowConsumer() {
+
+    PrefetchTuner tuner(1000, 100);
+
+    // Nothing changes until a quarter of the prefetch window has been sampled.
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, 10 * MILLIS, 249));
+    CPPUNIT_ASSERT_EQUAL(1000, tuner.getPrefetch());
+
+    // 10ms per message for a 100ms target allows ten prefetched messages.
+    CPPUNIT_ASSERT(tuner.recordProcessingTime(10 * MILLIS));
+    CPPUNIT_ASSERT_EQUAL(10, tuner.getPrefetch());
+    CPPUNIT_ASSERT_EQUAL(10 * MILLIS, tuner.getAverageProcessingTime());
+
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, 10 * MILLIS, 100));
+    CPPUNIT_ASSERT_EQUAL(10, tuner.getPrefetch());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testFastConsumer() {
+
+    PrefetchTuner tuner(500, 100);
+
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, 1000, 2000));
+    CPPUNIT_ASSERT_EQUAL(500, tuner.getPrefetch());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testConsumerSpeedsUp() {
+
+    PrefetchTuner tuner(1000, 100);
+
+    record(tuner, 10 * MILLIS, 250);
+    CPPUNIT_ASSERT_EQUAL(10, tuner.getPrefetch());
+
+    // Once the average settles at 1ms per message the prefetch grows to within a
+    // quarter of 100.
+    CPPUNIT_ASSERT(record(tuner, MILLIS, 400) > 0);
+    CPPUNIT_ASSERT(tuner.getPrefetch() >= 75);
+    CPPUNIT_ASSERT(tuner.getPrefetch() <= 100);
+
+    // And back up to the maximum for a consumer faster than the target allows for.
+    CPPUNIT_ASSERT(record(tuner, 1000, 400) > 0);
+    CPPUNIT_ASSERT_EQUAL(1000, tuner.getPrefetch());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testSmallChangesIgnored() {
+
+    PrefetchTuner tuner(100, 100);
+
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, MILLIS, 100));
+    CPPUNIT_ASSERT_EQUAL(100, tuner.getPrefetch());
+
+    // About 10% slower would mean a prefetch of about 90, not worth sending.
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, 1100000LL, 200));
+    CPPUNIT_ASSERT_EQUAL(100, tuner.getPrefetch());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PrefetchTunerTest::testMinimumPrefetch() {
+
+    PrefetchTuner tuner(50, 10);
+
+    CPPUNIT_ASSERT_EQUAL(1, record(tuner, 1000 * MILLIS, 12));
+    CPPUNIT_ASSERT_EQUAL(1, tuner.getPrefetch());
+
+    CPPUNIT_ASSERT_EQUAL(0, record(tuner, 1000 * MILLIS, 100));
+    CPPUNIT_ASSERT_EQUAL(1, tuner.getPrefetch());
+}
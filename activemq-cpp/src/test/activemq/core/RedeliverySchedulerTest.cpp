@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RedeliverySchedulerTest.h"
+
+#include <activemq/core/RedeliveryScheduler.h>
+#include <activemq/threads/TimingWheel.h>
+
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::threads;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    typedef std::vector< Pointer<MessageDispatch> > Batch;
+
+    // Keeps the messages handed back, newest redelivery first as executeFirst would.
+    class RecordingTarget : public RedeliveryScheduler::Target {
+    private:
+
+        mutable Mutex mutex;
+        Batch received;
+
+    public:
+
+        RecordingTarget() : mutex(), received() {}
+        virtual ~RecordingTarget() {}
+
+        virtual void redeliver(const Batch& messages) {
+            synchronized(&mutex) {
+                received.insert(received.begin(), messages.begin(), messages.end());
+            }
+        }
+
+        Batch getReceived() const {
+            Batch result;
+            synchronized(&mutex) {
+                result = received;
+            }
+            return result;
+        }
+    };
+
+    Batch createBatch(int count) {
+        Batch batch;
+        for (int i = 0; i < count; ++i) {
+            batch.push_back(Pointer<MessageDispatch>(new MessageDispatch()));
+        }
+        return batch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliverySchedulerTest::testConstructor() {
+
+    TimingWheel wheel("testConstructor", 5);
+    RecordingTarget target;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        RedeliveryScheduler(NULL, &wheel),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        RedeliveryScheduler(&target, NULL),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        RedeliveryScheduler(&target, &wheel, 0),
+        IllegalArgumentException);
+
+    RedeliveryScheduler scheduler(&target, &wheel);
+    CPPUNIT_ASSERT_EQUAL(RedeliveryScheduler::DEFAULT_MAX_PENDING_MESSAGES, scheduler.getMaxPendingMessages());
+    CPPUNIT_ASSERT_EQUAL(0, scheduler.getPendingCount());
+    CPPUNIT_ASSERT(!scheduler.isClosed());
+    CPPUNIT_ASSERT(!scheduler.schedule(Batch(), 100));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliverySchedulerTest::testNoDelay() {
+
+    TimingWheel wheel("testNoDelay", 5);
+    RecordingTarget target;
+    RedeliveryScheduler scheduler(&target, &wheel);
+
+    Batch batch = createBatch(3);
+    CPPUNIT_ASSERT(!scheduler.schedule(batch, 0));
+    CPPUNIT_ASSERT_EQUAL(0, scheduler.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    Batch received = target.getReceived();
+    CPPUNIT_ASSERT(received == batch);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliverySchedulerTest::testDelayedBatches() {
+
+    TimingWheel wheel("testDelayedBatches", 5);
+    RecordingTarget target;
+    RedeliveryScheduler scheduler(&target, &wheel);
+
+    Batch late = createBatch(2);
+    Batch early = createBatch(3);
+
+    CPPUNIT_ASSERT(scheduler.schedule(late, 300));
+    CPPUNIT_ASSERT(scheduler.schedule(early, 100));
+    CPPUNIT_ASSERT_EQUAL(5, scheduler.getPendingCount());
+    CPPUNIT_ASSERT(target.getReceived().empty());
+
+    Thread::sleep(200);
+    CPPUNIT_ASSERT_EQUAL(2, scheduler.getPendingCount());
+    CPPUNIT_ASSERT(target.getReceived() == early);
+
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(0, scheduler.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    // The later batch is handed back ahead of the one before it.
+    Batch expected(late);
+    expected.insert(expected.end(), early.begin(), early.end());
+    CPPUNIT_ASSERT(target.getReceived() == expected);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliverySchedulerTest::testMaxPendingMessages() {
+
+    TimingWheel wheel("testMaxPendingMessages", 5);
+    RecordingTarget target;
+    RedeliveryScheduler scheduler(&target, &wheel, 4);
+
+    Batch held = createBatch(3);
+    Batch overflow = createBatch(2);
+
+    CPPUNIT_ASSERT(scheduler.schedule(held, 5000));
+    CPPUNIT_ASSERT(!scheduler.schedule(overflow, 5000));
+    CPPUNIT_ASSERT_EQUAL(3, scheduler.getPendingCount());
+    CPPUNIT_ASSERT(target.getReceived() == overflow);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RedeliverySchedulerTest::testClose() {
+
+    TimingWheel wheel("testClose", 5);
+    RecordingTarget target;
+    RedeliveryScheduler scheduler(&target, &wheel);
+
+    Batch batch = createBatch(2);
+
+    CPPUNIT_ASSERT(scheduler.schedule(batch, 100));
+    CPPUNIT_ASSERT(scheduler.schedule(createBatch(1), 200));
+    CPPUNIT_ASSERT_EQUAL(2, wheel.getPendingCount());
+
+    scheduler.close();
+    CPPUNIT_ASSERT(scheduler.isClosed());
+    CPPUNIT_ASSERT_EQUAL(0, scheduler.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    CPPUNIT_ASSERT(!scheduler.schedule(createBatch(1), 0));
+
+    Thread::sleep(300);
+    CPPUNIT_ASSERT(target.getReceived().empty());
+}
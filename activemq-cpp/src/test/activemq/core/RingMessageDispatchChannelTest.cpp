@@ -0,0 +1,405 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RingMessageDispatchChannelTest.h"
+
+#include <activemq/core/RingMessageDispatchChannel.h>
+#include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/Message.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::core;
+using namespace activemq::commands;
+using namespace decaf;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class Producer : public Runnable {
+    private:
+
+        MessageDispatchChannel* channel;
+        std::vector< Pointer<MessageDispatch> >* messages;
+
+    public:
+
+        Producer(MessageDispatchChannel* channel, std::vector< Pointer<MessageDispatch> >* messages) :
+            Runnable(), channel(channel), messages(messages) {
+        }
+
+        virtual ~Producer() {}
+
+        virtual void run() {
+            for (std::size_t i = 0; i < messages->size(); ++i) {
+                channel->enqueue((*messages)[i]);
+                if (i % 16 == 0) {
+                    Thread::yield();
+                }
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testCtor() {
+
+    RingMessageDispatchChannel channel( 4 );
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isClosed() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testStart() {
+
+    RingMessageDispatchChannel channel( 4 );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testStop() {
+
+    RingMessageDispatchChannel channel( 4 );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    channel.stop();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testClose() {
+
+    RingMessageDispatchChannel channel( 4 );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    CPPUNIT_ASSERT( channel.isClosed() == false );
+    channel.close();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isClosed() == true );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.isClosed() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testEnqueue() {
+
+    RingMessageDispatchChannel channel( 4 );
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueue( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueue( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testEnqueueFront() {
+
+    RingMessageDispatchChannel channel( 4 );
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueueFirst( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueueFirst( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testPeek() {
+
+    RingMessageDispatchChannel channel( 4 );
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+
+    channel.enqueueFirst( dispatch1 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+
+    channel.enqueueFirst( dispatch2 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 2 );
+
+    CPPUNIT_ASSERT( channel.peek() == NULL );
+
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.peek() == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+    CPPUNIT_ASSERT( channel.peek() == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testDequeueNoWait() {
+
+    RingMessageDispatchChannel channel( 4 );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    CPPUNIT_ASSERT( channel.isRunning() == false );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testDequeue() {
+
+    RingMessageDispatchChannel channel( 4 );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+
+    long long timeStarted = System::currentTimeMillis();
+
+    CPPUNIT_ASSERT( channel.dequeue( 1000 ) == NULL );
+
+    CPPUNIT_ASSERT( System::currentTimeMillis() - timeStarted >= 999 );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.dequeue( -1 ) == dispatch1 );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == dispatch2 );
+    CPPUNIT_ASSERT( channel.dequeue( 1000 ) == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testRemoveAll() {
+
+    RingMessageDispatchChannel channel( 4 );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.isRunning() == true );
+    CPPUNIT_ASSERT( channel.isEmpty() == false );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+    CPPUNIT_ASSERT( channel.removeAll().size() == 3 );
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testWrapAndGrow() {
+
+    RingMessageDispatchChannel channel( 4 );
+    channel.start();
+
+    const int initialCapacity = channel.capacity();
+
+    std::vector< Pointer<MessageDispatch> > messages;
+    for( int i = 0; i < initialCapacity * 3; ++i ) {
+        messages.push_back( Pointer<MessageDispatch>( new MessageDispatch() ) );
+    }
+
+    // Move the head forward so that the contents wrap around the end of the ring.
+    for( int i = 0; i < initialCapacity - 1; ++i ) {
+        channel.enqueue( messages[0] );
+        CPPUNIT_ASSERT( channel.dequeueNoWait() == messages[0] );
+    }
+
+    for( std::size_t i = 1; i < messages.size(); ++i ) {
+        channel.enqueue( messages[i] );
+    }
+    channel.enqueueFirst( messages[0] );
+
+    CPPUNIT_ASSERT( channel.capacity() > initialCapacity );
+    CPPUNIT_ASSERT_EQUAL( (int) messages.size(), channel.size() );
+
+    for( std::size_t i = 0; i < messages.size(); ++i ) {
+        CPPUNIT_ASSERT( channel.dequeueNoWait() == messages[i] );
+    }
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testProducerConsumer() {
+
+    RingMessageDispatchChannel channel( 100 );
+    channel.start();
+
+    std::vector< Pointer<MessageDispatch> > messages;
+    for( int i = 0; i < 2000; ++i ) {
+        messages.push_back( Pointer<MessageDispatch>( new MessageDispatch() ) );
+    }
+
+    Producer producer( &channel, &messages );
+    Thread thread( &producer );
+    thread.start();
+
+    for( std::size_t i = 0; i < messages.size(); ++i ) {
+        Pointer<MessageDispatch> dispatch = channel.dequeue( 5000 );
+        CPPUNIT_ASSERT( dispatch == messages[i] );
+    }
+
+    thread.join();
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testDequeueAll() {
+
+    RingMessageDispatchChannel channel( 4 );
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 0 );
+    CPPUNIT_ASSERT( buffer.empty() );
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 2 ) == 2 );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+    CPPUNIT_ASSERT( buffer.size() == 2 );
+    CPPUNIT_ASSERT( buffer[0] == dispatch1 );
+    CPPUNIT_ASSERT( buffer[1] == dispatch2 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT( buffer.size() == 3 );
+    CPPUNIT_ASSERT( buffer[2] == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 0 );
+    CPPUNIT_ASSERT( buffer.size() == 3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RingMessageDispatchChannelTest::testMemoryUsage() {
+
+    RingMessageDispatchChannel channel( 4 );
+
+    Pointer<MessageDispatch> small( new MessageDispatch() );
+    Pointer<MessageDispatch> large( new MessageDispatch() );
+    Pointer<MessageDispatch> empty( new MessageDispatch() );
+
+    Pointer<Message> smallMessage( new Message() );
+    Pointer<Message> largeMessage( new Message() );
+
+    smallMessage->setContent( std::vector<unsigned char>( 16 ) );
+    largeMessage->setContent( std::vector<unsigned char>( 4096 ) );
+
+    small->setMessage( smallMessage );
+    large->setMessage( largeMessage );
+
+    long long smallSize = smallMessage->getSize();
+    long long largeSize = largeMessage->getSize();
+
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    channel.enqueueFirst( empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == small );
+    CPPUNIT_ASSERT_EQUAL( largeSize, channel.getMemoryUsage() );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    CPPUNIT_ASSERT( channel.removeAll().size() == 2 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( large );
+    channel.clear();
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+}
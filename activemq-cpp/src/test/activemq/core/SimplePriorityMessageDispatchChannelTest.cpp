@@ -19,9 +19,12 @@
 
 #include <activemq/core/SimplePriorityMessageDispatchChannel.h>
 #include <activemq/commands/MessageDispatch.h>
+#include <activemq/commands/Message.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/System.h>
 
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::core;
 using namespace activemq::commands;
@@ -284,3 +287,180 @@ void SimplePriorityMessageDispatchChannelTest::testRemoveAll() {
     CPPUNIT_ASSERT( channel.size() == 0 );
     CPPUNIT_ASSERT( channel.isEmpty() == true );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testDequeueAll() {
+
+    SimplePriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> dispatch1( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch2( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch3( new MessageDispatch() );
+    Pointer<MessageDispatch> dispatch4( new MessageDispatch() );
+
+    Pointer<Message> message1( new Message() );
+    Pointer<Message> message2( new Message() );
+    Pointer<Message> message3( new Message() );
+    Pointer<Message> message4( new Message() );
+
+    message1->setPriority( 2 );
+    message2->setPriority( 3 );
+    message3->setPriority( 1 );
+    message4->setPriority( 3 );
+
+    dispatch1->setMessage( message1 );
+    dispatch2->setMessage( message2 );
+    dispatch3->setMessage( message3 );
+    dispatch4->setMessage( message4 );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+
+    channel.enqueue( dispatch1 );
+    channel.enqueue( dispatch2 );
+    channel.enqueue( dispatch3 );
+    channel.enqueue( dispatch4 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 0 );
+    CPPUNIT_ASSERT( buffer.empty() );
+    channel.start();
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 3 ) == 3 );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+    CPPUNIT_ASSERT( buffer[0] == dispatch2 );
+    CPPUNIT_ASSERT( buffer[1] == dispatch4 );
+    CPPUNIT_ASSERT( buffer[2] == dispatch1 );
+
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT( buffer.size() == 4 );
+    CPPUNIT_ASSERT( buffer[3] == dispatch3 );
+
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<MessageDispatch> createDispatch( int priority, int sequence ) {
+        Pointer<Message> message( new Message() );
+        message->setPriority( (unsigned char) priority );
+        message->setRedeliveryCounter( sequence );
+
+        Pointer<MessageDispatch> dispatch( new MessageDispatch() );
+        dispatch->setMessage( message );
+        return dispatch;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testRingGrowth() {
+
+    SimplePriorityMessageDispatchChannel channel;
+    channel.start();
+
+    const int COUNT = 100;
+
+    // Enough messages per priority to wrap and grow the rings, with some put
+    // back at the front to wrap the head the other way.
+    for( int i = 0; i < COUNT; ++i ) {
+        channel.enqueue( createDispatch( 4, i ) );
+        channel.enqueue( createDispatch( 7, i ) );
+    }
+
+    channel.enqueueFirst( createDispatch( 7, -1 ) );
+    channel.enqueueFirst( createDispatch( 4, -1 ) );
+
+    CPPUNIT_ASSERT( channel.size() == 2 * COUNT + 2 );
+
+    for( int i = -1; i < COUNT; ++i ) {
+        Pointer<MessageDispatch> dispatch = channel.dequeueNoWait();
+        CPPUNIT_ASSERT( dispatch != NULL );
+        CPPUNIT_ASSERT( dispatch->getMessage()->getPriority() == 7 );
+        CPPUNIT_ASSERT( dispatch->getMessage()->getRedeliveryCounter() == i );
+    }
+
+    // A message above the highest priority is delivered as priority 9.
+    channel.enqueue( createDispatch( 12, 0 ) );
+    CPPUNIT_ASSERT( channel.peek()->getMessage()->getPriority() == 12 );
+    channel.dequeueNoWait();
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 1000 ) == COUNT + 1 );
+    for( int i = -1; i < COUNT; ++i ) {
+        CPPUNIT_ASSERT( buffer[i + 1]->getMessage()->getPriority() == 4 );
+        CPPUNIT_ASSERT( buffer[i + 1]->getMessage()->getRedeliveryCounter() == i );
+    }
+
+    CPPUNIT_ASSERT( channel.isEmpty() );
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testClear() {
+
+    SimplePriorityMessageDispatchChannel channel;
+
+    channel.enqueue( createDispatch( 1, 0 ) );
+    channel.enqueue( createDispatch( 5, 0 ) );
+    channel.enqueue( createDispatch( 9, 0 ) );
+    CPPUNIT_ASSERT( channel.size() == 3 );
+
+    channel.clear();
+    CPPUNIT_ASSERT( channel.size() == 0 );
+    CPPUNIT_ASSERT( channel.isEmpty() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == NULL );
+
+    channel.enqueue( createDispatch( 3, 0 ) );
+    CPPUNIT_ASSERT( channel.size() == 1 );
+    CPPUNIT_ASSERT( channel.dequeueNoWait()->getMessage()->getPriority() == 3 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SimplePriorityMessageDispatchChannelTest::testMemoryUsage() {
+
+    SimplePriorityMessageDispatchChannel channel;
+
+    Pointer<MessageDispatch> small( new MessageDispatch() );
+    Pointer<MessageDispatch> large( new MessageDispatch() );
+    Pointer<MessageDispatch> empty( new MessageDispatch() );
+
+    Pointer<Message> smallMessage( new Message() );
+    Pointer<Message> largeMessage( new Message() );
+
+    smallMessage->setContent( std::vector<unsigned char>( 16 ) );
+    largeMessage->setContent( std::vector<unsigned char>( 4096 ) );
+
+    small->setMessage( smallMessage );
+    large->setMessage( largeMessage );
+
+    long long smallSize = smallMessage->getSize();
+    long long largeSize = largeMessage->getSize();
+
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    channel.enqueueFirst( empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+
+    channel.start();
+    CPPUNIT_ASSERT( channel.dequeueNoWait() == empty );
+    CPPUNIT_ASSERT_EQUAL( smallSize + largeSize, channel.getMemoryUsage() );
+    CPPUNIT_ASSERT( channel.dequeue( 0 ) == small );
+    CPPUNIT_ASSERT_EQUAL( largeSize, channel.getMemoryUsage() );
+
+    std::vector< Pointer<MessageDispatch> > buffer;
+    CPPUNIT_ASSERT( channel.dequeueAll( buffer, 10 ) == 1 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( small );
+    channel.enqueue( large );
+    CPPUNIT_ASSERT( channel.removeAll().size() == 2 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+
+    channel.enqueue( large );
+    channel.clear();
+    CPPUNIT_ASSERT_EQUAL( 0LL, channel.getMemoryUsage() );
+}
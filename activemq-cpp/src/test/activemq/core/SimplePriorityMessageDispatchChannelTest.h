@@ -37,6 +37,10 @@ namespace core {
         CPPUNIT_TEST( testDequeueNoWait );
         CPPUNIT_TEST( testDequeue );
         CPPUNIT_TEST( testRemoveAll );
+        CPPUNIT_TEST( testDequeueAll );
+        CPPUNIT_TEST( testRingGrowth );
+        CPPUNIT_TEST( testClear );
+        CPPUNIT_TEST( testMemoryUsage );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -54,6 +58,10 @@ namespace core {
         void testDequeueNoWait();
         void testDequeue();
         void testRemoveAll();
+        void testDequeueAll();
+        void testRingGrowth();
+        void testClear();
+        void testMemoryUsage();
 
     };
 
@@ -19,14 +19,24 @@
 
 #include <activemq/transport/Transport.h>
 #include <activemq/wireformat/WireFormat.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
 #include <activemq/state/ConnectionStateTracker.h>
 #include <activemq/state/ConsumerState.h>
 #include <activemq/state/SessionState.h>
 #include <activemq/commands/ActiveMQTopic.h>
+#include <activemq/commands/ActiveMQMessage.h>
 #include <activemq/commands/Message.h>
 #include <activemq/commands/ConnectionInfo.h>
 #include <activemq/commands/SessionInfo.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/TransactionInfo.h>
+#include <activemq/core/ActiveMQConstants.h>
 #include <activemq/commands/Message.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
 #include <decaf/lang/Pointer.h>
 #include <decaf/lang/exceptions/UnsupportedOperationException.h>
 #include <decaf/util/LinkedList.h>
@@ -53,9 +63,15 @@ namespace {
         LinkedList< Pointer<Command> > consumers;
         LinkedList< Pointer<Command> > messages;
         LinkedList< Pointer<Command> > messagePulls;
+        LinkedList< Pointer<Command> > marshaled;
+
+        Pointer<wireformat::WireFormat> wireFormat;
 
     public:
 
+        TrackingTransport() : connections(), sessions(), producers(), consumers(), messages(),
+                              messagePulls(), marshaled(), wireFormat() {}
+
         virtual ~TrackingTransport() {}
 
         virtual void start() {}
@@ -77,6 +93,8 @@ namespace {
                 messages.add(command);
             } else if (command->isMessagePull()) {
                 messagePulls.add(command);
+            } else if (command.dynamicCast<openwire::MarshaledCommand>() != NULL) {
+                marshaled.add(command);
             }
         }
 
@@ -94,7 +112,7 @@ namespace {
         }
 
         virtual Pointer<wireformat::WireFormat> getWireFormat() const {
-            return Pointer<wireformat::WireFormat>();
+            return wireFormat;
         }
 
         virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat) {
@@ -216,24 +234,54 @@ void ConnectionStateTrackerTest::testMessageCache() {
 
     ConnectionData conn = createConnectionState(tracker);
 
-    int messageSize;
-    {
+    // Each marshaled message is a little over 1000 bytes so only three fit.
+    tracker.setMaxMessageCacheSize(3500);
+
+    int sequenceId = 1;
+
+    for (int i = 0; i < 100; ++i) {
         decaf::lang::Pointer<commands::MessageId> id(new commands::MessageId());
         id->setProducerId(conn.producer->getProducerId());
-        Pointer<Message> message(new Message);
-        messageSize = message->getSize();
+        id->setProducerSequenceId(sequenceId++);
+        Pointer<ActiveMQMessage> message(new ActiveMQMessage);
+        message->setMessageId(id);
+        message->setContent(std::vector<unsigned char>(1000, (unsigned char) i));
+
+        tracker.processMessage(message.get());
+        tracker.trackBack(message);
+    }
+
+    tracker.restore(transport);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three messages", 3, transport->messages.size());
+
+    // The newest messages are kept and come back in the order they were sent.
+    for (int i = 0; i < 3; ++i) {
+        Pointer<Message> message = transport->messages.get(i).dynamicCast<Message>();
+        CPPUNIT_ASSERT_EQUAL(98LL + i, message->getMessageId()->getProducerSequenceId());
+        CPPUNIT_ASSERT(message->getMessageId()->getProducerId()->equals(*conn.producer->getProducerId()));
+        CPPUNIT_ASSERT_EQUAL(1000, (int) message->getContent().size());
+        CPPUNIT_ASSERT_EQUAL((unsigned char) (97 + i), message->getContent()[0]);
     }
+}
 
-    tracker.setMaxMessageCacheSize(messageSize * 3);
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testMessageCacheOversizedMessage() {
 
-    int sequenceId = 1;
+    Pointer<TrackingTransport> transport(new TrackingTransport);
+    ConnectionStateTracker tracker;
+    tracker.setTrackMessages(true);
+    tracker.setMaxMessageCacheSize(2048);
 
-    for (int i = 0; i < 100; ++i) {
+    ConnectionData conn = createConnectionState(tracker);
+
+    for (int i = 0; i < 2; ++i) {
         decaf::lang::Pointer<commands::MessageId> id(new commands::MessageId());
         id->setProducerId(conn.producer->getProducerId());
-        id->setProducerSequenceId(sequenceId++);
-        Pointer<Message> message(new Message);
+        id->setProducerSequenceId(i + 1);
+        Pointer<ActiveMQMessage> message(new ActiveMQMessage);
         message->setMessageId(id);
+        message->setContent(std::vector<unsigned char>(i == 0 ? 100 : 4096, 'a'));
 
         tracker.processMessage(message.get());
         tracker.trackBack(message);
@@ -241,7 +289,67 @@ void ConnectionStateTrackerTest::testMessageCache() {
 
     tracker.restore(transport);
 
-    CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three messages", 4, transport->messages.size());
+    // A message larger than the whole cache isn't kept and doesn't push out the others.
+    CPPUNIT_ASSERT_EQUAL(1, transport->messages.size());
+    Pointer<Message> message = transport->messages.getFirst().dynamicCast<Message>();
+    CPPUNIT_ASSERT_EQUAL(1LL, message->getMessageId()->getProducerSequenceId());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testMessageCacheReplaysMarshaledFrames() {
+
+    Pointer<TrackingTransport> transport(new TrackingTransport);
+    ConnectionStateTracker tracker;
+    tracker.setTrackMessages(true);
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    for (int i = 0; i < 3; ++i) {
+        decaf::lang::Pointer<commands::MessageId> id(new commands::MessageId());
+        id->setProducerId(conn.producer->getProducerId());
+        id->setProducerSequenceId(i + 1);
+        Pointer<ActiveMQMessage> message(new ActiveMQMessage);
+        message->setMessageId(id);
+        message->setContent(std::vector<unsigned char>(100, (unsigned char) i));
+
+        tracker.processMessage(message.get());
+        tracker.trackBack(message);
+    }
+
+    // A connection that encodes the way the cache does is sent the cached frames.
+    decaf::util::Properties properties;
+    Pointer<openwire::OpenWireFormat> wireFormat(new openwire::OpenWireFormat(properties));
+    wireFormat->setVersion(openwire::OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat->setTightEncodingEnabled(false);
+    wireFormat->setCacheEnabled(false);
+    transport->wireFormat = wireFormat;
+
+    tracker.restore(transport);
+
+    CPPUNIT_ASSERT_EQUAL(0, transport->messages.size());
+    CPPUNIT_ASSERT_EQUAL(3, transport->marshaled.size());
+
+    for (int i = 0; i < 3; ++i) {
+        decaf::io::ByteArrayOutputStream bytes;
+        decaf::io::DataOutputStream bytesOut(&bytes);
+        wireFormat->marshal(transport->marshaled.get(i), transport.get(), &bytesOut);
+
+        std::pair<unsigned char*, int> frame = bytes.toByteArray();
+        decaf::io::ByteArrayInputStream bytesIn(frame.first, frame.second, true);
+        decaf::io::DataInputStream dataIn(&bytesIn);
+
+        Pointer<Message> message = wireFormat->unmarshal(transport.get(), &dataIn).dynamicCast<Message>();
+        CPPUNIT_ASSERT_EQUAL(1LL + i, message->getMessageId()->getProducerSequenceId());
+        CPPUNIT_ASSERT_EQUAL((unsigned char) i, message->getContent()[0]);
+    }
+
+    // One that uses the marshal cache is sent decoded messages.
+    Pointer<TrackingTransport> cached(new TrackingTransport);
+    cached->wireFormat.reset(new openwire::OpenWireFormat(properties));
+    tracker.restore(cached);
+
+    CPPUNIT_ASSERT_EQUAL(3, cached->messages.size());
+    CPPUNIT_ASSERT_EQUAL(0, cached->marshaled.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -266,3 +374,99 @@ void ConnectionStateTrackerTest::testMessagePullCache() {
 
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Should only be three message pulls", 10, transport->messagePulls.size());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testTransactedMessagesAreShared() {
+
+    Pointer<TrackingTransport> transport(new TrackingTransport);
+    ConnectionStateTracker tracker;
+    tracker.setTrackTransactions(true);
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    Pointer<LocalTransactionId> txId(new LocalTransactionId);
+    txId->setConnectionId(conn.connection->getConnectionId());
+    txId->setValue(1);
+
+    Pointer<TransactionInfo> begin(new TransactionInfo);
+    begin->setConnectionId(conn.connection->getConnectionId());
+    begin->setTransactionId(txId);
+    begin->setType(core::ActiveMQConstants::TRANSACTION_STATE_BEGIN);
+    CPPUNIT_ASSERT(tracker.track(begin) != NULL);
+
+    std::vector< Pointer<ActiveMQMessage> > sent;
+    for (int i = 0; i < 3; ++i) {
+        Pointer<commands::MessageId> id(new commands::MessageId());
+        id->setProducerId(conn.producer->getProducerId());
+        id->setProducerSequenceId(i + 1);
+        Pointer<ActiveMQMessage> message(new ActiveMQMessage);
+        message->setMessageId(id);
+        message->setProducerId(conn.producer->getProducerId());
+        message->setTransactionId(txId);
+
+        CPPUNIT_ASSERT_MESSAGE("Transacted send should be tracked", tracker.track(message) != NULL);
+        sent.push_back(message);
+    }
+
+    tracker.restore(transport);
+
+    // The transaction replays the very instances that were sent and none of them
+    // went through the message cache as well.
+    CPPUNIT_ASSERT_EQUAL(3, transport->messages.size());
+    for (int i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT(transport->messages.get(i).get() == sent[i].get());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConnectionStateTrackerTest::testTransactionSpool() {
+
+    Pointer<TrackingTransport> transport(new TrackingTransport);
+    ConnectionStateTracker tracker;
+    tracker.setTrackTransactions(true);
+
+    ConnectionData conn = createConnectionState(tracker);
+
+    Pointer<LocalTransactionId> txId(new LocalTransactionId);
+    txId->setConnectionId(conn.connection->getConnectionId());
+    txId->setValue(1);
+
+    Pointer<TransactionInfo> begin(new TransactionInfo);
+    begin->setConnectionId(conn.connection->getConnectionId());
+    begin->setTransactionId(txId);
+    begin->setType(core::ActiveMQConstants::TRANSACTION_STATE_BEGIN);
+    CPPUNIT_ASSERT(tracker.track(begin) != NULL);
+
+    std::vector< Pointer<ActiveMQMessage> > sent;
+    for (int i = 0; i < 5; ++i) {
+        Pointer<commands::MessageId> id(new commands::MessageId());
+        id->setProducerId(conn.producer->getProducerId());
+        id->setProducerSequenceId(i + 1);
+        Pointer<ActiveMQMessage> message(new ActiveMQMessage);
+        message->setMessageId(id);
+        message->setProducerId(conn.producer->getProducerId());
+        message->setTransactionId(txId);
+        message->setContent(std::vector<unsigned char>(1024, (unsigned char) i));
+
+        // Room for two messages, the rest go to the journal.
+        if (i == 0) {
+            tracker.setTransactionSpoolSize(2 * message->getSize());
+        }
+
+        CPPUNIT_ASSERT_MESSAGE("Transacted send should be tracked", tracker.track(message) != NULL);
+        sent.push_back(message);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2LL * sent[0]->getSize(), tracker.getMemoryUsage());
+
+    tracker.restore(transport);
+
+    // Those kept in memory replay as sent, the journaled ones are decoded after them.
+    CPPUNIT_ASSERT_EQUAL(5, transport->messages.size());
+    for (int i = 0; i < 5; ++i) {
+        Pointer<Message> message = transport->messages.get(i).dynamicCast<Message>();
+        CPPUNIT_ASSERT_EQUAL(1LL + i, message->getMessageId()->getProducerSequenceId());
+        CPPUNIT_ASSERT_EQUAL((unsigned char) i, message->getContent()[0]);
+        CPPUNIT_ASSERT_EQUAL(i < 2, message.get() == sent[i].get());
+    }
+}
@@ -29,7 +29,11 @@ namespace state {
         CPPUNIT_TEST_SUITE( ConnectionStateTrackerTest );
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( testMessageCache );
+        CPPUNIT_TEST( testMessageCacheOversizedMessage );
+        CPPUNIT_TEST( testMessageCacheReplaysMarshaledFrames );
         CPPUNIT_TEST( testMessagePullCache );
+        CPPUNIT_TEST( testTransactedMessagesAreShared );
+        CPPUNIT_TEST( testTransactionSpool );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -39,7 +43,11 @@ namespace state {
 
         void test();
         void testMessageCache();
+        void testMessageCacheOversizedMessage();
+        void testMessageCacheReplaysMarshaledFrames();
         void testMessagePullCache();
+        void testTransactedMessagesAreShared();
+        void testTransactionSpool();
 
     };
 
@@ -20,6 +20,7 @@
 #include <activemq/threads/CompositeTask.h>
 #include <activemq/threads/CompositeTaskRunner.h>
 #include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 
 #include <iostream>
 #include <iomanip>
@@ -28,6 +29,7 @@ using namespace std;
 using namespace activemq;
 using namespace activemq::threads;
 using namespace decaf::lang;
+using namespace decaf::util::concurrent::atomic;
 
 ////////////////////////////////////////////////////////////////////////////////
 namespace {
@@ -56,6 +58,49 @@ namespace {
         }
 
     };
+
+    class SignalledTask : public CompositeTask {
+    private:
+
+        AtomicInteger work;
+        AtomicInteger runs;
+        mutable AtomicInteger checks;
+
+    public:
+
+        SignalledTask() : work(), runs(), checks() {}
+
+        void addWork() {
+            work.incrementAndGet();
+        }
+
+        int getRuns() const {
+            return runs.get();
+        }
+
+        int getChecks() const {
+            return checks.get();
+        }
+
+        virtual bool isPending() const {
+            checks.incrementAndGet();
+            return work.get() > 0;
+        }
+
+        virtual bool iterate() {
+            work.decrementAndGet();
+            runs.incrementAndGet();
+            return false;
+        }
+
+    };
+
+    bool waitForRuns(const SignalledTask& task, int runs) {
+        for (int i = 0; i < 100 && task.getRuns() != runs; ++i) {
+            Thread::sleep(50);
+        }
+        return task.getRuns() == runs;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -98,3 +143,43 @@ void CompositeTaskRunnerTest::testCreateButNotStarted() {
     runner->shutdown();
     runner.reset(NULL);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void CompositeTaskRunnerTest::testWakeupOnlyChecksWokenTask() {
+
+    CompositeTaskRunner runner;
+
+    SignalledTask idle;
+    SignalledTask busy;
+
+    runner.addTask(&idle);
+    runner.addTask(&busy);
+
+    // Both are checked once on being added, the idle one ahead of the busy one.
+    busy.addWork();
+    runner.start();
+    CPPUNIT_ASSERT(waitForRuns(busy, 1));
+
+    int idleChecks = idle.getChecks();
+    CPPUNIT_ASSERT(idleChecks > 0);
+
+    for (int i = 0; i < 100; ++i) {
+        busy.addWork();
+        runner.wakeup(&busy);
+    }
+
+    CPPUNIT_ASSERT(waitForRuns(busy, 101));
+    CPPUNIT_ASSERT_EQUAL(idleChecks, idle.getChecks());
+    CPPUNIT_ASSERT_EQUAL(0, idle.getRuns());
+
+    // The untargeted wakeup still checks every task.
+    runner.wakeup();
+    for (int i = 0; i < 100 && idle.getChecks() == idleChecks; ++i) {
+        Thread::sleep(50);
+    }
+    CPPUNIT_ASSERT(idle.getChecks() > idleChecks);
+
+    runner.removeTask(&idle);
+    runner.removeTask(&busy);
+    runner.shutdown();
+}
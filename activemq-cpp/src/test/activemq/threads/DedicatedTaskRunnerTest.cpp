@@ -104,3 +104,29 @@ void DedicatedTaskRunnerTest::testSimple() {
     Thread::sleep( 250 );
     CPPUNIT_ASSERT( infiniteTask.getCount() == count );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DedicatedTaskRunnerTest::testThreadCreatedOnStart() {
+
+    SimpleCountingTask task;
+
+    DedicatedTaskRunner unstarted(&task);
+    CPPUNIT_ASSERT(!unstarted.isStarted());
+    unstarted.wakeup();
+    unstarted.shutdown();
+
+    // Once shutdown a runner never creates its thread.
+    unstarted.start();
+    CPPUNIT_ASSERT(!unstarted.isStarted());
+    CPPUNIT_ASSERT(task.getCount() == 0);
+
+    DedicatedTaskRunner runner(&task);
+    runner.start();
+    CPPUNIT_ASSERT(runner.isStarted());
+
+    runner.wakeup();
+    Thread::sleep(100);
+    CPPUNIT_ASSERT(task.getCount() >= 1);
+
+    runner.shutdown();
+}
@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeyedSerialExecutorTest.h"
+
+#include <activemq/threads/KeyedSerialExecutor.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/TimeUnit.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Checks that it runs after the Runnable given just before it with the same key.
+    class SequenceCheck : public Runnable {
+    private:
+
+        AtomicInteger* last;
+        int sequence;
+        AtomicInteger* errors;
+        AtomicInteger* completed;
+
+    private:
+
+        SequenceCheck(const SequenceCheck&);
+        SequenceCheck& operator= (const SequenceCheck&);
+
+    public:
+
+        SequenceCheck(AtomicInteger* last, int sequence, AtomicInteger* errors, AtomicInteger* completed) :
+            Runnable(), last(last), sequence(sequence), errors(errors), completed(completed) {
+        }
+
+        virtual ~SequenceCheck() {}
+
+        virtual void run() {
+            if (!last->compareAndSet(sequence - 1, sequence)) {
+                errors->incrementAndGet();
+            }
+            completed->incrementAndGet();
+        }
+    };
+
+    class BlockingTask : public Runnable {
+    private:
+
+        CountDownLatch* release;
+
+    private:
+
+        BlockingTask(const BlockingTask&);
+        BlockingTask& operator= (const BlockingTask&);
+
+    public:
+
+        BlockingTask(CountDownLatch* release) : Runnable(), release(release) {}
+
+        virtual ~BlockingTask() {}
+
+        virtual void run() {
+            release->await(10, TimeUnit::SECONDS);
+        }
+    };
+
+    class CountingTask : public Runnable {
+    private:
+
+        CountDownLatch* done;
+
+    private:
+
+        CountingTask(const CountingTask&);
+        CountingTask& operator= (const CountingTask&);
+
+    public:
+
+        CountingTask(CountDownLatch* done) : Runnable(), done(done) {}
+
+        virtual ~CountingTask() {}
+
+        virtual void run() {
+            done->countDown();
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutorTest::testInvalidArguments() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        KeyedSerialExecutor(0, "KeyedSerialExecutorTest"),
+        IllegalArgumentException);
+
+    KeyedSerialExecutor executor(2, "KeyedSerialExecutorTest");
+    CPPUNIT_ASSERT_EQUAL(2, executor.getPoolSize());
+    CPPUNIT_ASSERT_EQUAL(2 * KeyedSerialExecutor::LANES_PER_THREAD, executor.getLaneCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        executor.execute(1, NULL),
+        NullPointerException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutorTest::testOrderPerKey() {
+
+    const int NUM_KEYS = 20;
+    const int NUM_TASKS = 500;
+
+    KeyedSerialExecutor executor(4, "KeyedSerialExecutorTest");
+
+    std::vector<AtomicInteger*> sequences;
+    AtomicInteger errors;
+    AtomicInteger completed;
+
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        sequences.push_back(new AtomicInteger(0));
+    }
+
+    for (int i = 1; i <= NUM_TASKS; ++i) {
+        for (int key = 0; key < NUM_KEYS; ++key) {
+            executor.execute(key, new SequenceCheck(sequences[key], i, &errors, &completed));
+        }
+    }
+
+    for (int attempts = 0; attempts < 100 && completed.get() < NUM_KEYS * NUM_TASKS; ++attempts) {
+        Thread::sleep(100);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(NUM_KEYS * NUM_TASKS, completed.get());
+    CPPUNIT_ASSERT_EQUAL(0, errors.get());
+
+    executor.shutdown();
+
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        delete sequences[key];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutorTest::testSlowKeyDoesNotBlockOthers() {
+
+    KeyedSerialExecutor executor(2, "KeyedSerialExecutorTest");
+
+    CountDownLatch release(1);
+    CountDownLatch done(1);
+
+    executor.execute(0, new BlockingTask(&release));
+    executor.execute(1, new CountingTask(&done));
+
+    CPPUNIT_ASSERT_MESSAGE("Key in another lane was held up by a blocked key",
+                           done.await(5, TimeUnit::SECONDS));
+
+    release.countDown();
+    executor.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeyedSerialExecutorTest::testShutdownRunsRemaining() {
+
+    const int NUM_TASKS = 100;
+
+    KeyedSerialExecutor executor(1, "KeyedSerialExecutorTest");
+
+    CountDownLatch release(1);
+    CountDownLatch done(NUM_TASKS);
+
+    executor.execute(0, new BlockingTask(&release));
+    for (int i = 0; i < NUM_TASKS / 2; ++i) {
+        executor.execute(0, new CountingTask(&done));
+    }
+
+    release.countDown();
+    executor.shutdown();
+
+    // Runnables given after shutdown run on the caller.
+    for (int i = 0; i < NUM_TASKS / 2; ++i) {
+        executor.execute(0, new CountingTask(&done));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, done.getCount());
+}
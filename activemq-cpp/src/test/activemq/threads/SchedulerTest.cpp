@@ -18,6 +18,7 @@
 #include "SchedulerTest.h"
 
 #include <activemq/threads/Scheduler.h>
+#include <activemq/threads/TimingWheel.h>
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/Thread.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
@@ -261,3 +262,65 @@ void SchedulerTest::testShutdown() {
         CPPUNIT_ASSERT(scheduler.isStopped());
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SchedulerTest::testTimingWheel() {
+
+    TimingWheel wheel("testTimingWheel");
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        Scheduler("testTimingWheel", NULL),
+        NullPointerException);
+
+    {
+        Scheduler scheduler("testTimingWheel", &wheel);
+        CPPUNIT_ASSERT(scheduler.isUsingTimingWheel());
+        scheduler.start();
+
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should have thrown a NullPointerException",
+            scheduler.executePeriodically(NULL, 400),
+            NullPointerException);
+
+        CounterTask* periodic = new CounterTask();
+        scheduler.executePeriodically(periodic, 200);
+        CounterTask* delayed = new CounterTask();
+        scheduler.schedualPeriodically(delayed, 200);
+        CounterTask once;
+        scheduler.executeAfterDelay(&once, 200, false);
+        CPPUNIT_ASSERT_EQUAL(3, wheel.getPendingCount());
+
+        Thread::sleep(500);
+        CPPUNIT_ASSERT(periodic->getCount() >= 1);
+        CPPUNIT_ASSERT(delayed->getCount() >= 1);
+        CPPUNIT_ASSERT_EQUAL(1, once.getCount());
+
+        scheduler.cancel(periodic);
+        CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+
+        try{
+            scheduler.cancel(periodic);
+            CPPUNIT_FAIL("Should have thrown an exception");
+        } catch(...) {
+        }
+
+        // Tasks left behind are cancelled when the Scheduler shuts down.
+        scheduler.executeAfterDelay(&once, 200, false);
+        scheduler.shutdown();
+        CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+
+        Thread::sleep(400);
+        CPPUNIT_ASSERT_EQUAL(1, once.getCount());
+        CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+        scheduler.stop();
+    }
+
+    Scheduler scheduler("testTimingWheel", &TimingWheel::getSharedInstance());
+    scheduler.start();
+    CounterTask task;
+    scheduler.executeAfterDelay(&task, 100, false);
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(1, task.getCount());
+}
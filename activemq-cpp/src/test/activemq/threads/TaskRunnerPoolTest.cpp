@@ -0,0 +1,246 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TaskRunnerPoolTest.h"
+
+#include <activemq/threads/Task.h>
+#include <activemq/threads/TaskRunnerPool.h>
+
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SimpleCountingTask : public Task {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        SimpleCountingTask() : count(0) {}
+        virtual ~SimpleCountingTask() {}
+
+        virtual bool iterate() {
+            count.incrementAndGet();
+            return false;
+        }
+
+        int getCount() const { return count.get(); }
+    };
+
+    class InfiniteCountingTask : public Task {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        InfiniteCountingTask() : count(0) {}
+        virtual ~InfiniteCountingTask() {}
+
+        virtual bool iterate() {
+            count.incrementAndGet();
+            return true;
+        }
+
+        int getCount() const { return count.get(); }
+    };
+
+    // Counts down its work one iteration at a time and notes if it was ever
+    // iterated by two workers at once.
+    class OrderedTask : public Task {
+    private:
+
+        AtomicInteger active;
+        AtomicInteger work;
+        AtomicInteger done;
+        AtomicInteger overlaps;
+
+    public:
+
+        OrderedTask() : active(0), work(0), done(0), overlaps(0) {}
+        virtual ~OrderedTask() {}
+
+        void addWork() {
+            work.incrementAndGet();
+        }
+
+        virtual bool iterate() {
+
+            if (active.incrementAndGet() != 1) {
+                overlaps.incrementAndGet();
+            }
+
+            bool more = false;
+            if (work.get() > 0) {
+                work.decrementAndGet();
+                done.incrementAndGet();
+                Thread::yield();
+                more = work.get() > 0;
+            }
+
+            active.decrementAndGet();
+            return more;
+        }
+
+        int getDone() const { return done.get(); }
+        int getOverlaps() const { return overlaps.get(); }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPoolTest::testSimple() {
+
+    TaskRunnerPool pool(2, "TaskRunnerPoolTest");
+    CPPUNIT_ASSERT_EQUAL(2, pool.getPoolSize());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        pool.createTaskRunner(NULL),
+        NullPointerException);
+
+    SimpleCountingTask simpleTask;
+    CPPUNIT_ASSERT(simpleTask.getCount() == 0);
+    Pointer<TaskRunner> simpleTaskRunner = pool.createTaskRunner(&simpleTask);
+
+    simpleTaskRunner->start();
+    CPPUNIT_ASSERT(simpleTaskRunner->isStarted());
+
+    simpleTaskRunner->wakeup();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT(simpleTask.getCount() >= 1);
+    simpleTaskRunner->wakeup();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT(simpleTask.getCount() >= 2);
+
+    InfiniteCountingTask infiniteTask;
+    CPPUNIT_ASSERT(infiniteTask.getCount() == 0);
+    Pointer<TaskRunner> infiniteTaskRunner = pool.createTaskRunner(&infiniteTask);
+    infiniteTaskRunner->start();
+    Thread::sleep(500);
+    CPPUNIT_ASSERT(infiniteTask.getCount() != 0);
+
+    // The busy task mustn't keep the other one from running.
+    int simpleCount = simpleTask.getCount();
+    simpleTaskRunner->wakeup();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT(simpleTask.getCount() > simpleCount);
+
+    infiniteTaskRunner->shutdown();
+    int count = infiniteTask.getCount();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT(infiniteTask.getCount() == count);
+
+    simpleTaskRunner->shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPoolTest::testInvalidPoolSize() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        TaskRunnerPool(0, "TaskRunnerPoolTest"),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPoolTest::testManyRunners() {
+
+    const int NUM_TASKS = 50;
+    const int NUM_WAKEUPS = 200;
+
+    TaskRunnerPool pool(4, "TaskRunnerPoolTest");
+
+    std::vector<OrderedTask*> tasks;
+    std::vector< Pointer<TaskRunner> > runners;
+
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        tasks.push_back(new OrderedTask());
+        runners.push_back(pool.createTaskRunner(tasks.back()));
+        runners.back()->start();
+    }
+
+    for (int wakeup = 0; wakeup < NUM_WAKEUPS; ++wakeup) {
+        for (int i = 0; i < NUM_TASKS; ++i) {
+            tasks[i]->addWork();
+            runners[i]->wakeup();
+        }
+    }
+
+    for (int attempts = 0; attempts < 100; ++attempts) {
+        bool finished = true;
+        for (int i = 0; i < NUM_TASKS; ++i) {
+            if (tasks[i]->getDone() != NUM_WAKEUPS) {
+                finished = false;
+            }
+        }
+
+        if (finished) {
+            break;
+        }
+
+        Thread::sleep(100);
+    }
+
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        runners[i]->shutdown();
+        CPPUNIT_ASSERT_EQUAL(NUM_WAKEUPS, tasks[i]->getDone());
+        CPPUNIT_ASSERT_EQUAL(0, tasks[i]->getOverlaps());
+        delete tasks[i];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TaskRunnerPoolTest::testPoolShutdown() {
+
+    InfiniteCountingTask task;
+    SimpleCountingTask simpleTask;
+
+    TaskRunnerPool pool(1, "TaskRunnerPoolTest");
+    Pointer<TaskRunner> runner = pool.createTaskRunner(&task);
+    Pointer<TaskRunner> simpleRunner = pool.createTaskRunner(&simpleTask);
+    runner->start();
+    simpleRunner->start();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT(task.getCount() != 0);
+
+    pool.shutdown();
+    int count = task.getCount();
+    int simpleCount = simpleTask.getCount();
+
+    runner->wakeup();
+    simpleRunner->wakeup();
+    Thread::sleep(250);
+    CPPUNIT_ASSERT_EQUAL(count, task.getCount());
+    CPPUNIT_ASSERT_EQUAL(simpleCount, simpleTask.getCount());
+
+    runner->shutdown();
+    simpleRunner->shutdown();
+}
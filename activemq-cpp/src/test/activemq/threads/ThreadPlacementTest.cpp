@@ -0,0 +1,87 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ThreadPlacementTest.h"
+
+#include <activemq/threads/ThreadPlacement.h>
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <algorithm>
+
+using namespace activemq;
+using namespace activemq::threads;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadPlacementTest::testParse() {
+
+    CPPUNIT_ASSERT_EQUAL(ThreadPlacement::NONE, ThreadPlacement::parse("none"));
+    CPPUNIT_ASSERT_EQUAL(ThreadPlacement::CORE, ThreadPlacement::parse("core"));
+    CPPUNIT_ASSERT_EQUAL(ThreadPlacement::NODE, ThreadPlacement::parse("NODE"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("none"), ThreadPlacement::toString(ThreadPlacement::NONE));
+    CPPUNIT_ASSERT_EQUAL(std::string("core"), ThreadPlacement::toString(ThreadPlacement::CORE));
+    CPPUNIT_ASSERT_EQUAL(std::string("node"), ThreadPlacement::toString(ThreadPlacement::NODE));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        ThreadPlacement::parse("socket"),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadPlacementTest::testNoPlacement() {
+    CPPUNIT_ASSERT(ThreadPlacement::nextPlacement(ThreadPlacement::NONE).empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadPlacementTest::testCorePlacement() {
+
+    std::vector<int> cores;
+    for (int node = 0; node < System::availableNumaNodes(); ++node) {
+        std::vector<int> processors = System::getNumaNodeProcessors(node);
+        cores.insert(cores.end(), processors.begin(), processors.end());
+    }
+
+    std::vector<int> first = ThreadPlacement::nextPlacement(ThreadPlacement::CORE);
+    CPPUNIT_ASSERT_EQUAL(1, (int) first.size());
+    CPPUNIT_ASSERT(std::find(cores.begin(), cores.end(), first[0]) != cores.end());
+
+    // Consecutive connections land on different cores whenever there is more than one.
+    std::vector<int> second = ThreadPlacement::nextPlacement(ThreadPlacement::CORE);
+    CPPUNIT_ASSERT_EQUAL(1, (int) second.size());
+    if (cores.size() > 1) {
+        CPPUNIT_ASSERT(first[0] != second[0]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadPlacementTest::testNodePlacement() {
+
+    std::vector<int> placement = ThreadPlacement::nextPlacement(ThreadPlacement::NODE);
+
+    if (System::availableNumaNodes() == 1) {
+        CPPUNIT_ASSERT(placement.empty());
+    } else {
+        CPPUNIT_ASSERT(!placement.empty());
+    }
+}
@@ -0,0 +1,355 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TimingWheelTest.h"
+
+#include <activemq/threads/TimingWheel.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent::atomic;
+using namespace activemq;
+using namespace activemq::threads;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CounterTask : public Runnable {
+    private:
+
+        AtomicInteger count;
+
+    public:
+
+        CounterTask() : count(0) {
+        }
+
+        virtual ~CounterTask() {}
+
+        int getCount() const {
+            return count.get();
+        }
+
+        virtual void run() {
+            count.incrementAndGet();
+        }
+
+    };
+
+    class SelfCancellingTask : public Runnable {
+    private:
+
+        SelfCancellingTask(const SelfCancellingTask&);
+        SelfCancellingTask& operator= (const SelfCancellingTask&);
+
+    public:
+
+        AtomicInteger count;
+        Pointer<TimingWheel::Timeout> timeout;
+
+        SelfCancellingTask() : count(0), timeout() {
+        }
+
+        virtual ~SelfCancellingTask() {}
+
+        virtual void run() {
+            if (count.incrementAndGet() == 2) {
+                timeout->cancel();
+            }
+        }
+
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheelTest::TimingWheelTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TimingWheelTest::~TimingWheelTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testConstructor() {
+
+    TimingWheel wheel("testConstructor", 20, 500);
+    CPPUNIT_ASSERT_EQUAL(20LL, wheel.getTickDuration());
+    CPPUNIT_ASSERT_EQUAL(512, wheel.getTicksPerWheel());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    TimingWheel defaults("testConstructorDefaults");
+    CPPUNIT_ASSERT_EQUAL(TimingWheel::DEFAULT_TICK_DURATION, defaults.getTickDuration());
+    CPPUNIT_ASSERT_EQUAL(TimingWheel::DEFAULT_TICKS_PER_WHEEL, defaults.getTicksPerWheel());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        TimingWheel(""),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        TimingWheel("testConstructor", 0),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        TimingWheel("testConstructor", 10, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testScheduleInvalidArgsThrows() {
+
+    TimingWheel wheel("testScheduleInvalidArgsThrows");
+    Pointer<Runnable> task(new CounterTask());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        wheel.schedule(Pointer<Runnable>(), 100),
+        NullPointerException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        wheel.scheduleAtFixedRate(Pointer<Runnable>(), 100, 100),
+        NullPointerException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.schedule(task, -1),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.schedule(task, 100, 0),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        wheel.scheduleAtFixedRate(task, 100, -1),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testSchedule() {
+
+    TimingWheel wheel("testSchedule");
+    Pointer<CounterTask> task(new CounterTask());
+
+    Pointer<TimingWheel::Timeout> timeout = wheel.schedule(task, 300);
+    CPPUNIT_ASSERT(!timeout->isPeriodic());
+    CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+    CPPUNIT_ASSERT_EQUAL(0, task->getCount());
+
+    Thread::sleep(500);
+    CPPUNIT_ASSERT_EQUAL(1, task->getCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    // Cancelling after it has run has no effect.
+    CPPUNIT_ASSERT(!timeout->cancel());
+
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(1, task->getCount());
+
+    // A zero delay runs on the next tick.
+    wheel.schedule(task, 0);
+    Thread::sleep(200);
+    CPPUNIT_ASSERT_EQUAL(2, task->getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testScheduleBeyondOneRotation() {
+
+    // The whole wheel spans only 40ms so this task has to wait out several rotations.
+    TimingWheel wheel("testScheduleBeyondOneRotation", 5, 8);
+    Pointer<CounterTask> task(new CounterTask());
+
+    wheel.schedule(task, 300);
+
+    Thread::sleep(150);
+    CPPUNIT_ASSERT_EQUAL(0, task->getCount());
+    CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+
+    Thread::sleep(400);
+    CPPUNIT_ASSERT_EQUAL(1, task->getCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testScheduleAtFixedRate() {
+
+    TimingWheel wheel("testScheduleAtFixedRate");
+    Pointer<CounterTask> task(new CounterTask());
+
+    Pointer<TimingWheel::Timeout> timeout = wheel.scheduleAtFixedRate(task, 100, 100);
+    CPPUNIT_ASSERT(timeout->isPeriodic());
+
+    Thread::sleep(650);
+    int count = task->getCount();
+    CPPUNIT_ASSERT(count >= 4);
+    CPPUNIT_ASSERT(count <= 7);
+    CPPUNIT_ASSERT_EQUAL(1, wheel.getPendingCount());
+
+    CPPUNIT_ASSERT(timeout->cancel());
+    CPPUNIT_ASSERT(timeout->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    count = task->getCount();
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(count, task->getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testScheduleWithFixedDelay() {
+
+    TimingWheel wheel("testScheduleWithFixedDelay");
+    Pointer<CounterTask> task(new CounterTask());
+
+    Pointer<TimingWheel::Timeout> timeout = wheel.schedule(task, 0, 100);
+    CPPUNIT_ASSERT(timeout->isPeriodic());
+
+    Thread::sleep(550);
+    int count = task->getCount();
+    CPPUNIT_ASSERT(count >= 3);
+    CPPUNIT_ASSERT(count <= 7);
+
+    CPPUNIT_ASSERT(timeout->cancel());
+
+    count = task->getCount();
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(count, task->getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testCancel() {
+
+    TimingWheel wheel("testCancel");
+    Pointer<CounterTask> task(new CounterTask());
+
+    Pointer<TimingWheel::Timeout> timeout = wheel.schedule(task, 200);
+    CPPUNIT_ASSERT(!timeout->isCancelled());
+    CPPUNIT_ASSERT(timeout->cancel());
+    CPPUNIT_ASSERT(timeout->isCancelled());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    // Cancelling twice only succeeds the first time.
+    CPPUNIT_ASSERT(!timeout->cancel());
+
+    Thread::sleep(400);
+    CPPUNIT_ASSERT_EQUAL(0, task->getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testCancelFromTask() {
+
+    TimingWheel wheel("testCancelFromTask");
+    Pointer<SelfCancellingTask> task(new SelfCancellingTask());
+
+    task->timeout = wheel.scheduleAtFixedRate(task, 50, 50);
+
+    Thread::sleep(500);
+    CPPUNIT_ASSERT_EQUAL(2, task->count.get());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+    task->timeout.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testManyTimeouts() {
+
+    static const int COUNT = 10000;
+
+    TimingWheel wheel("testManyTimeouts");
+    Pointer<CounterTask> task(new CounterTask());
+    std::vector< Pointer<TimingWheel::Timeout> > timeouts;
+
+    for (int i = 0; i < COUNT; ++i) {
+        timeouts.push_back(wheel.schedule(task, 100 + (i % 200)));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT, wheel.getPendingCount());
+
+    for (int i = 0; i < COUNT; i += 2) {
+        CPPUNIT_ASSERT(timeouts[i]->cancel());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT / 2, wheel.getPendingCount());
+
+    Thread::sleep(800);
+    CPPUNIT_ASSERT_EQUAL(COUNT / 2, task->getCount());
+    CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testShutdown() {
+
+    Pointer<CounterTask> task(new CounterTask());
+    Pointer<TimingWheel::Timeout> timeout;
+
+    {
+        TimingWheel wheel("testShutdown");
+        timeout = wheel.schedule(task, 200);
+        wheel.scheduleAtFixedRate(task, 200, 200);
+        CPPUNIT_ASSERT_EQUAL(2, wheel.getPendingCount());
+
+        wheel.shutdown();
+        CPPUNIT_ASSERT_EQUAL(0, wheel.getPendingCount());
+
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should have thrown an IllegalStateException",
+            wheel.schedule(task, 100),
+            IllegalStateException);
+
+        // Shutting down again does nothing.
+        wheel.shutdown();
+    }
+
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(0, task->getCount());
+
+    // The handle stays usable once the wheel is gone.
+    CPPUNIT_ASSERT(!timeout->cancel());
+
+    // Destroying a wheel with pending tasks drops them.
+    {
+        TimingWheel wheel("testShutdown");
+        wheel.scheduleAtFixedRate(task, 1000, 1000);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, task->getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TimingWheelTest::testSharedInstance() {
+
+    TimingWheel& wheel = TimingWheel::getSharedInstance();
+    CPPUNIT_ASSERT(&wheel == &TimingWheel::getSharedInstance());
+
+    Pointer<CounterTask> task(new CounterTask());
+    Pointer<TimingWheel::Timeout> timeout = wheel.schedule(task, 100);
+
+    Thread::sleep(300);
+    CPPUNIT_ASSERT_EQUAL(1, task->getCount());
+    CPPUNIT_ASSERT(!timeout->cancel());
+}
@@ -0,0 +1,64 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_THREADS_TIMINGWHEELTEST_H_
+#define _ACTIVEMQ_THREADS_TIMINGWHEELTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace threads {
+
+    class TimingWheelTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( TimingWheelTest );
+        CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testScheduleInvalidArgsThrows );
+        CPPUNIT_TEST( testSchedule );
+        CPPUNIT_TEST( testScheduleBeyondOneRotation );
+        CPPUNIT_TEST( testScheduleAtFixedRate );
+        CPPUNIT_TEST( testScheduleWithFixedDelay );
+        CPPUNIT_TEST( testCancel );
+        CPPUNIT_TEST( testCancelFromTask );
+        CPPUNIT_TEST( testManyTimeouts );
+        CPPUNIT_TEST( testShutdown );
+        CPPUNIT_TEST( testSharedInstance );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        TimingWheelTest();
+        virtual ~TimingWheelTest();
+
+        void testConstructor();
+        void testScheduleInvalidArgsThrows();
+        void testSchedule();
+        void testScheduleBeyondOneRotation();
+        void testScheduleAtFixedRate();
+        void testScheduleWithFixedDelay();
+        void testCancel();
+        void testCancelFromTask();
+        void testManyTimeouts();
+        void testShutdown();
+        void testSharedInstance();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_THREADS_TIMINGWHEELTEST_H_ */
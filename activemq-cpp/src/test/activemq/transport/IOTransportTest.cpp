@@ -19,6 +19,9 @@
 
 #include <activemq/transport/IOTransport.h>
 #include <activemq/transport/TransportListener.h>
+#include <activemq/transport/WriteQueueFullException.h>
+#include <activemq/transport/logging/FrameCaptureFile.h>
+#include <activemq/transport/logging/FrameCaptureReader.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/commands/BaseCommand.h>
 #include <decaf/lang/exceptions/NullPointerException.h>
@@ -33,6 +36,9 @@
 #include <decaf/lang/Exception.h>
 #include <decaf/util/Random.h>
 
+#include <cstdio>
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::transport;
 using namespace activemq::exceptions;
@@ -62,14 +68,42 @@ public:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class MyMessageCommand : public MyCommand {
+public:
+
+    MyMessageCommand(char c) : MyCommand() {
+        this->c = c;
+    }
+
+    virtual ~MyMessageCommand() {}
+
+    virtual bool isMessage() const { return true; }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class MyWireFormat : public wireformat::WireFormat {
 public:
 
-    MyWireFormat() : throwException(false) {}
+    MyWireFormat() : throwException(false), framed(false) {}
     virtual ~MyWireFormat(){}
 
     bool throwException;
+    bool framed;
+
+    virtual bool isFramed() const { return framed; }
+
+    // Every frame is a single byte, an 'X' stands in for a broken stream.
+    virtual void readFrame( decaf::io::DataInputStream* inputStream,
+                            std::vector<unsigned char>& frame ) {
+
+        unsigned char value = inputStream->readByte();
+        if( value == 'X' ) {
+            throw IOException( __FILE__, __LINE__, "Bad frame" );
+        }
+
+        frame.assign( 1, value );
+    }
 
     virtual void setVersion( int version ) {}
 
@@ -159,6 +193,28 @@ public:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+class MyMessageTracer : public util::MessageTracer {
+public:
+
+    std::vector<TracePoint> points;
+    std::string received;
+    decaf::util::concurrent::Mutex mutex;
+
+    MyMessageTracer() : points(), received(), mutex() {}
+
+    virtual ~MyMessageTracer() {}
+
+    virtual void onTrace(TracePoint point, const commands::Command& command, long long timestamp AMQCPP_UNUSED) {
+        synchronized(&mutex) {
+            points.push_back(point);
+            if (point == TRANSPORT_MARSHAL || point == TRANSPORT_RECEIVE) {
+                received += dynamic_cast<const MyCommand&>(command).c;
+            }
+        }
+    }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class MyTransportListener : public TransportListener{
 private:
@@ -170,9 +226,10 @@ public:
     decaf::util::concurrent::Mutex mutex;
     bool caughtOne;
     std::string str;
+    std::string strAtException;
 
-    MyTransportListener() : latch(1), mutex(), caughtOne(false), str() {}
-    MyTransportListener(unsigned int num) : latch(num), mutex(), caughtOne(false), str() {}
+    MyTransportListener() : latch(1), mutex(), caughtOne(false), str(), strAtException() {}
+    MyTransportListener(unsigned int num) : latch(num), mutex(), caughtOne(false), str(), strAtException() {}
     virtual ~MyTransportListener(){}
 
     virtual void await() {
@@ -187,9 +244,10 @@ public:
 
     virtual void onException( const decaf::lang::Exception& ex AMQCPP_UNUSED){
 
-        this->caughtOne = true;
         synchronized( &mutex )
         {
+           this->strAtException = str;
+           this->caughtOne = true;
            mutex.notify();
         }
     }
@@ -342,6 +400,384 @@ void IOTransportTest::testWrite(){
     transport.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testBatchedWrite(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setWriteBatching( true );
+    transport.setMaxBatchBytes( 2 );
+    transport.setMaxBatchLinger( 10 );
+
+    CPPUNIT_ASSERT( transport.isWriteBatching() );
+    CPPUNIT_ASSERT_EQUAL( 2, transport.getMaxBatchBytes() );
+    CPPUNIT_ASSERT_EQUAL( 10LL, transport.getMaxBatchLinger() );
+
+    transport.start();
+
+    std::string expected = "12345";
+    for( std::size_t i = 0; i < expected.size(); ++i ) {
+        Pointer<MyCommand> cmd( new MyCommand() );
+        cmd->c = expected[i];
+        transport.oneway( cmd );
+    }
+
+    // Closing waits on the writer to flush everything that was queued.
+    transport.close();
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    std::string written( (const char*)array.first, array.second );
+    delete [] array.first;
+
+    CPPUNIT_ASSERT_EQUAL( expected, written );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testBoundedWriteQueue(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setWriteBatching( true );
+    transport.setMaxWriteQueueSize( 2 );
+    transport.setWriteQueuePolicy( IOTransport::DROP_OLDEST );
+
+    CPPUNIT_ASSERT_EQUAL( 2, transport.getMaxWriteQueueSize() );
+    CPPUNIT_ASSERT_EQUAL( IOTransport::DROP_OLDEST, transport.getWriteQueuePolicy() );
+
+    transport.start();
+
+    // The writer marshals under the stream's lock, holding it stalls the writer as a
+    // slow socket would.
+    synchronized( &output ) {
+
+        transport.oneway( Pointer<Command>( new MyMessageCommand( '1' ) ) );
+        decaf::lang::Thread::sleep( 100 );
+
+        transport.oneway( Pointer<Command>( new MyMessageCommand( '2' ) ) );
+        transport.oneway( Pointer<Command>( new MyMessageCommand( '3' ) ) );
+
+        // Both queued messages make way for the newer ones.
+        transport.oneway( Pointer<Command>( new MyMessageCommand( '4' ) ) );
+        transport.oneway( Pointer<Command>( new MyMessageCommand( '5' ) ) );
+        CPPUNIT_ASSERT_EQUAL( 2LL, transport.getWritesDropped() );
+
+        // A failing queue refuses the message but keeps the transport usable.
+        transport.setWriteQueuePolicy( IOTransport::FAIL );
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw a WriteQueueFullException",
+            transport.oneway( Pointer<Command>( new MyMessageCommand( '6' ) ) ),
+            WriteQueueFullException );
+    }
+
+    transport.oneway( Pointer<Command>( new MyMessageCommand( '7' ) ) );
+    transport.close();
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    std::string written( (const char*)array.first, array.second );
+    delete [] array.first;
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "1457" ), written );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testDeferredFlush(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::BufferedOutputStream buffered( &os );
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &buffered );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+
+    CPPUNIT_ASSERT( !transport.isFlushDeferred() );
+
+    transport.start();
+    transport.setFlushDeferred( true );
+    CPPUNIT_ASSERT( transport.isFlushDeferred() );
+
+    std::string expected = "123";
+    for( std::size_t i = 0; i < expected.size(); ++i ) {
+        Pointer<MyCommand> cmd( new MyCommand() );
+        cmd->c = expected[i];
+        transport.oneway( cmd );
+    }
+
+    // Nothing leaves the buffer until the deferred flush is released.
+    CPPUNIT_ASSERT_EQUAL( 0, (int)os.size() );
+
+    transport.setFlushDeferred( false );
+    CPPUNIT_ASSERT( !transport.isFlushDeferred() );
+    CPPUNIT_ASSERT_EQUAL( 3, (int)os.size() );
+
+    Pointer<MyCommand> cmd( new MyCommand() );
+    cmd->c = '4';
+    transport.oneway( cmd );
+    CPPUNIT_ASSERT_EQUAL( 4, (int)os.size() );
+
+    transport.close();
+
+    std::pair<const unsigned char*, int> array = os.toByteArray();
+    std::string written( (const char*)array.first, array.second );
+    delete [] array.first;
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "1234" ), written );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testPipelinedRead(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    wireFormat->framed = true;
+    MyTransportListener listener(10);
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setPipelinedReads( true );
+    transport.setMaxPendingFrames( 2 );
+
+    CPPUNIT_ASSERT( transport.isPipelinedReads() );
+    CPPUNIT_ASSERT_EQUAL( 2, transport.getMaxPendingFrames() );
+
+    transport.start();
+
+    unsigned char buffer[10] = { '1', '2', '3', '4', '5', '6', '7', '8', '9', '0' };
+    synchronized( &is ){
+        is.setByteArray( buffer, 10 );
+    }
+
+    listener.await();
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "1234567890" ), listener.str );
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testPipelinedReadException(){
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    wireFormat->framed = true;
+    MyTransportListener listener;
+    IOTransport transport;
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setWireFormat( wireFormat );
+    transport.setPipelinedReads( true );
+
+    unsigned char buffer[4] = { '1', '2', '3', 'X' };
+    synchronized( &is ){
+        is.setByteArray( buffer, 4 );
+    }
+
+    transport.start();
+
+    synchronized( &listener.mutex ) {
+        if( !listener.caughtOne ) {
+            listener.mutex.wait( 2000 );
+        }
+    }
+
+    // The read error is only reported after the frames ahead of it were dispatched.
+    CPPUNIT_ASSERT( listener.caughtOne );
+    CPPUNIT_ASSERT_EQUAL( std::string( "123" ), listener.strAtException );
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testFrameCapture(){
+
+    const std::string path = "IOTransportTest.capture";
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input( &is );
+    decaf::io::DataOutputStream output( &os );
+
+    Pointer<MyWireFormat> wireFormat( new MyWireFormat() );
+    wireFormat->framed = true;
+    MyTransportListener listener(3);
+    Pointer<logging::FrameCaptureFile> capture( new logging::FrameCaptureFile( path, 4096, 1 ) );
+
+    IOTransport transport( wireFormat );
+    transport.setInputStream( &input );
+    transport.setOutputStream( &output );
+    transport.setTransportListener( &listener );
+    transport.setFrameCapture( capture );
+    CPPUNIT_ASSERT( transport.getFrameCapture() == capture );
+
+    transport.start();
+
+    unsigned char buffer[3] = { 'a', 'b', 'c' };
+    synchronized( &is ){
+        is.setByteArray( buffer, 3 );
+    }
+
+    listener.await();
+    CPPUNIT_ASSERT_EQUAL( std::string( "abc" ), listener.str );
+
+    Pointer<MyCommand> command( new MyCommand() );
+    command->c = 'x';
+    transport.oneway( command );
+    command->c = 'y';
+    transport.oneway( command );
+
+    transport.close();
+    capture->close();
+
+    // The commands still reach the output stream.
+    std::pair<const unsigned char*, int> written = os.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( 2, written.second );
+    CPPUNIT_ASSERT_EQUAL( 'x', (char) written.first[0] );
+    CPPUNIT_ASSERT_EQUAL( 'y', (char) written.first[1] );
+    delete [] written.first;
+
+    std::string inbound;
+    std::string outbound;
+
+    {
+        logging::FrameCaptureReader reader( logging::FrameCaptureFile::getFileName( path, 0 ) );
+        while( reader.next() ) {
+            CPPUNIT_ASSERT_EQUAL( 1, reader.getFrameSize() );
+            if( reader.getDirection() == logging::FrameCaptureFile::INBOUND ) {
+                inbound += (char) reader.getFrame()[0];
+            } else {
+                outbound += (char) reader.getFrame()[0];
+            }
+        }
+    }
+
+    std::remove( logging::FrameCaptureFile::getFileName( path, 0 ).c_str() );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "abc" ), inbound );
+    CPPUNIT_ASSERT_EQUAL( std::string( "xy" ), outbound );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testCounters() {
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input(&is);
+    decaf::io::DataOutputStream output(&os);
+
+    Pointer<MyWireFormat> wireFormat(new MyWireFormat());
+    MyTransportListener listener(4);
+    IOTransport transport;
+    transport.setInputStream(&input);
+    transport.setOutputStream(&output);
+    transport.setTransportListener(&listener);
+    transport.setWireFormat(wireFormat);
+
+    transport.start();
+
+    Pointer<MyCommand> cmd(new MyCommand());
+    for (int i = 0; i < 3; ++i) {
+        cmd->c = (char) ('1' + i);
+        transport.oneway(cmd);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(3LL, transport.getCommandsSent());
+    CPPUNIT_ASSERT_EQUAL((long long) os.size(), transport.getBytesSent());
+
+    unsigned char buffer[4] = { 'a', 'b', 'c', 'd' };
+    synchronized(&is) {
+        is.setByteArray(buffer, 4);
+    }
+
+    listener.await();
+
+    CPPUNIT_ASSERT_EQUAL(4LL, transport.getCommandsReceived());
+
+    // Commands unmarshaled straight off the stream aren't read as frames so their size isn't known.
+    CPPUNIT_ASSERT_EQUAL(0LL, transport.getBytesReceived());
+
+    transport.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void IOTransportTest::testMessageTracer() {
+
+    decaf::io::BlockingByteArrayInputStream is;
+    decaf::io::ByteArrayOutputStream os;
+    decaf::io::DataInputStream input(&is);
+    decaf::io::DataOutputStream output(&os);
+
+    Pointer<MyWireFormat> wireFormat(new MyWireFormat());
+    MyTransportListener listener(1);
+    MyMessageTracer tracer;
+    IOTransport transport;
+    transport.setInputStream(&input);
+    transport.setOutputStream(&output);
+    transport.setTransportListener(&listener);
+    transport.setWireFormat(wireFormat);
+    transport.setMessageTracer(&tracer);
+    CPPUNIT_ASSERT(transport.getMessageTracer() == &tracer);
+
+    transport.start();
+
+    Pointer<MyCommand> cmd(new MyCommand());
+    cmd->c = '1';
+    transport.oneway(cmd);
+
+    unsigned char buffer[1] = { 'a' };
+    synchronized(&is) {
+        is.setByteArray(buffer, 1);
+    }
+
+    listener.await();
+    transport.close();
+
+    synchronized(&tracer.mutex) {
+        CPPUNIT_ASSERT_EQUAL(4, (int) tracer.points.size());
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::TRANSPORT_MARSHAL, tracer.points[0]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::TRANSPORT_WRITE, tracer.points[1]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::TRANSPORT_FLUSH, tracer.points[2]);
+        CPPUNIT_ASSERT_EQUAL(util::MessageTracer::TRANSPORT_RECEIVE, tracer.points[3]);
+        CPPUNIT_ASSERT_EQUAL(std::string("1a"), tracer.received);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void IOTransportTest::testException(){
 
@@ -32,6 +32,14 @@ namespace transport{
         CPPUNIT_TEST( testStressTransportStartClose );
         CPPUNIT_TEST( testRead );
         CPPUNIT_TEST( testWrite );
+        CPPUNIT_TEST( testBatchedWrite );
+        CPPUNIT_TEST( testBoundedWriteQueue );
+        CPPUNIT_TEST( testDeferredFlush );
+        CPPUNIT_TEST( testPipelinedRead );
+        CPPUNIT_TEST( testPipelinedReadException );
+        CPPUNIT_TEST( testFrameCapture );
+        CPPUNIT_TEST( testCounters );
+        CPPUNIT_TEST( testMessageTracer );
         CPPUNIT_TEST( testException );
         CPPUNIT_TEST( testNarrow );
         CPPUNIT_TEST_SUITE_END();
@@ -42,6 +50,14 @@ namespace transport{
 
         void testException();
         void testWrite();
+        void testBatchedWrite();
+        void testBoundedWriteQueue();
+        void testDeferredFlush();
+        void testPipelinedRead();
+        void testPipelinedReadException();
+        void testFrameCapture();
+        void testCounters();
+        void testMessageTracer();
         void testRead();
         void testStartClose();
         void testStressTransportStartClose();
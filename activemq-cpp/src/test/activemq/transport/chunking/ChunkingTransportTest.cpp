@@ -0,0 +1,283 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChunkingTransportTest.h"
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/LastPartialCommand.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/PartialCommand.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/chunking/ChunkingTransport.h>
+#include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/Properties.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::chunking;
+using namespace activemq::wireformat::openwire;
+using namespace decaf::lang;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordingTransport : public Transport {
+    public:
+
+        std::vector< Pointer<Command> > sent;
+        TransportListener* listener;
+
+    private:
+
+        RecordingTransport(const RecordingTransport&);
+        RecordingTransport& operator= (const RecordingTransport&);
+
+    public:
+
+        RecordingTransport() : sent(), listener(NULL) {}
+
+        virtual ~RecordingTransport() {}
+
+        virtual void oneway(const Pointer<Command> command) {
+            sent.push_back(command);
+        }
+
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
+                                                     const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<Response> request(const Pointer<Command> command AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<Response> request(const Pointer<Command> command AMQCPP_UNUSED,
+                                          unsigned int timeout AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const {
+            return Pointer<wireformat::WireFormat>();
+        }
+
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat AMQCPP_UNUSED) {}
+
+        virtual void setTransportListener(TransportListener* listener) {
+            this->listener = listener;
+        }
+
+        virtual TransportListener* getTransportListener() const {
+            return this->listener;
+        }
+
+        virtual void start() {}
+
+        virtual void stop() {}
+
+        virtual void close() {}
+
+        virtual Transport* narrow(const std::type_info& typeId) {
+            return typeid(*this) == typeId ? this : NULL;
+        }
+
+        virtual bool isFaultTolerant() const {
+            return false;
+        }
+
+        virtual bool isConnected() const {
+            return true;
+        }
+
+        virtual bool isClosed() const {
+            return false;
+        }
+
+        virtual bool isReconnectSupported() const {
+            return false;
+        }
+
+        virtual bool isUpdateURIsSupported() const {
+            return false;
+        }
+
+        virtual std::string getRemoteAddress() const {
+            return "";
+        }
+
+        virtual void reconnect(const decaf::net::URI& uri AMQCPP_UNUSED) {}
+
+        virtual void updateURIs(bool rebalance AMQCPP_UNUSED,
+                                const decaf::util::List<decaf::net::URI>& uris AMQCPP_UNUSED) {}
+    };
+
+    class RecordingListener : public DefaultTransportListener {
+    public:
+
+        std::vector< Pointer<Command> > received;
+        int errors;
+
+        RecordingListener() : received(), errors(0) {}
+
+        virtual ~RecordingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            received.push_back(command);
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            errors++;
+        }
+    };
+
+    Pointer<OpenWireFormat> createWireFormat(bool cacheEnabled) {
+        Properties properties;
+        Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+        wireFormat->setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+        wireFormat->setCacheEnabled(cacheEnabled);
+        return wireFormat;
+    }
+
+    Pointer<ActiveMQBytesMessage> createMessage(int commandId, std::size_t size) {
+        Pointer<ActiveMQBytesMessage> message(new ActiveMQBytesMessage());
+        message->setCommandId(commandId);
+        message->setResponseRequired(true);
+
+        std::vector<unsigned char> content(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            content[i] = (unsigned char) (i % 251);
+        }
+        message->setContent(content);
+
+        return message;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChunkingTransportTest::ChunkingTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ChunkingTransportTest::~ChunkingTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransportTest::testSmallMessageNotChunked() {
+
+    Pointer<RecordingTransport> next(new RecordingTransport());
+    ChunkingTransport transport(next, createWireFormat(false), 4096);
+
+    Pointer<Command> message = createMessage(1, 100);
+    CPPUNIT_ASSERT(!transport.isChunked(*message));
+
+    transport.oneway(message);
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, next->sent.size());
+    CPPUNIT_ASSERT(next->sent[0] == message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransportTest::testCacheEnabledNotChunked() {
+
+    Pointer<RecordingTransport> next(new RecordingTransport());
+    ChunkingTransport transport(next, createWireFormat(true), 1024);
+
+    Pointer<Command> message = createMessage(1, 10000);
+    CPPUNIT_ASSERT(!transport.isChunked(*message));
+
+    transport.oneway(message);
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, next->sent.size());
+    CPPUNIT_ASSERT(next->sent[0] == message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransportTest::testChunkedRoundTrip() {
+
+    Pointer<RecordingTransport> next(new RecordingTransport());
+    ChunkingTransport sender(next, createWireFormat(false), 1024);
+
+    Pointer<ActiveMQBytesMessage> message = createMessage(7, 10000);
+    CPPUNIT_ASSERT(sender.isChunked(*message));
+
+    sender.oneway(message);
+
+    std::size_t chunks = next->sent.size();
+    CPPUNIT_ASSERT(chunks >= 10);
+
+    for (std::size_t i = 0; i < chunks; ++i) {
+        Pointer<Command> chunk = next->sent[i];
+        unsigned char expected = i + 1 < chunks ? PartialCommand::ID_PARTIALCOMMAND : LastPartialCommand::ID_LASTPARTIALCOMMAND;
+        CPPUNIT_ASSERT_EQUAL(expected, chunk->getDataStructureType());
+        CPPUNIT_ASSERT_EQUAL(7, chunk->getCommandId());
+        if (i + 1 < chunks) {
+            CPPUNIT_ASSERT_EQUAL((std::size_t) 1024, chunk.dynamicCast<PartialCommand>()->getData().size());
+        }
+    }
+
+    RecordingListener listener;
+    ChunkingTransport receiver(Pointer<Transport>(new RecordingTransport()), createWireFormat(false), 1024);
+    receiver.setTransportListener(&listener);
+    receiver.start();
+
+    for (std::size_t i = 0; i < chunks; ++i) {
+        receiver.onCommand(next->sent[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, listener.errors);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, listener.received.size());
+
+    Pointer<ActiveMQBytesMessage> joined = listener.received[0].dynamicCast<ActiveMQBytesMessage>();
+    CPPUNIT_ASSERT_EQUAL(7, joined->getCommandId());
+    CPPUNIT_ASSERT(joined->isResponseRequired());
+    CPPUNIT_ASSERT(message->getContent() == joined->getContent());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChunkingTransportTest::testCommandsBetweenChunks() {
+
+    Pointer<RecordingTransport> next(new RecordingTransport());
+    ChunkingTransport sender(next, createWireFormat(false), 512);
+
+    sender.oneway(createMessage(1, 2000));
+    std::vector< Pointer<Command> > chunks = next->sent;
+    CPPUNIT_ASSERT(chunks.size() > 2);
+
+    RecordingListener listener;
+    ChunkingTransport receiver(Pointer<Transport>(new RecordingTransport()), createWireFormat(false), 512);
+    receiver.setTransportListener(&listener);
+    receiver.start();
+
+    Pointer<Command> ack(new MessageAck());
+    ack->setCommandId(2);
+
+    // A command read between the chunks is passed on at once.
+    receiver.onCommand(chunks[0]);
+    receiver.onCommand(ack);
+    for (std::size_t i = 1; i < chunks.size(); ++i) {
+        receiver.onCommand(chunks[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 2, listener.received.size());
+    CPPUNIT_ASSERT_EQUAL(2, listener.received[0]->getCommandId());
+    CPPUNIT_ASSERT_EQUAL(1, listener.received[1]->getCommandId());
+    CPPUNIT_ASSERT(listener.received[1]->isMessage());
+}
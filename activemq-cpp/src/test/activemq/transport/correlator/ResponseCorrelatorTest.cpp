@@ -19,6 +19,7 @@
 
 #include <activemq/util/Config.h>
 #include <activemq/commands/BaseCommand.h>
+#include <activemq/commands/ExceptionResponse.h>
 #include <activemq/wireformat/WireFormat.h>
 #include <activemq/transport/DefaultTransportListener.h>
 #include <activemq/transport/correlator/ResponseCorrelator.h>
@@ -264,6 +265,16 @@ namespace correlator {
         }
     };
 
+    class MySilentTransport : public MyTransport {
+    public:
+
+        MySilentTransport(){}
+        virtual ~MySilentTransport(){}
+
+        virtual void oneway(const Pointer<Command> command AMQCPP_UNUSED) {
+        }
+    };
+
     class MyListener : public DefaultTransportListener {
     public:
 
@@ -493,6 +504,37 @@ void ResponseCorrelatorTest::testMultiRequests(){
     correlator.close();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ResponseCorrelatorTest::testPendingRequestsFailedOnClose(){
+
+    MyListener listener;
+    Pointer<MySilentTransport> transport(new MySilentTransport());
+    ResponseCorrelator correlator(transport);
+    correlator.setTransportListener(&listener);
+    correlator.start();
+
+    // Enough requests that they are spread over all the internal request stripes.
+    const unsigned int numRequests = 100;
+    std::vector< Pointer<FutureResponse> > futures;
+    for (unsigned int ix = 0; ix < numRequests; ++ix) {
+        Pointer<MyCommand> cmd(new MyCommand);
+        futures.push_back(correlator.asyncRequest(cmd, Pointer<ResponseCallback>()));
+    }
+
+    correlator.close();
+
+    for (unsigned int ix = 0; ix < numRequests; ++ix) {
+        Pointer<Response> response = futures[ix]->getResponse(1000);
+        CPPUNIT_ASSERT(response != NULL);
+        CPPUNIT_ASSERT(response.dynamicCast<commands::ExceptionResponse>() != NULL);
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException once closed",
+        correlator.asyncRequest(Pointer<MyCommand>(new MyCommand), Pointer<ResponseCallback>()),
+        IOException);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ResponseCorrelatorTest::testNarrow(){
 
@@ -514,3 +556,28 @@ void ResponseCorrelatorTest::testNarrow(){
     narrowed = correlator.narrow(typeid( correlator ));
     CPPUNIT_ASSERT(narrowed == &correlator);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ResponseCorrelatorTest::testRepeatedRequests() {
+
+    MyListener listener;
+    Pointer<MyTransport> transport(new MyTransport());
+    ResponseCorrelator correlator(transport);
+    correlator.setTransportListener(&listener);
+
+    synchronized(&(transport->startedMutex)) {
+        correlator.start();
+        transport->startedMutex.wait();
+    }
+
+    // Enough requests to come back to every stripe several times, the futures left
+    // by earlier requests must carry only the response of the request reusing them.
+    for (int i = 0; i < 200; ++i) {
+        Pointer<MyCommand> cmd(new MyCommand);
+        Pointer<Response> resp = (i % 2 == 0) ? correlator.request(cmd) : correlator.request(cmd, 5000);
+        CPPUNIT_ASSERT(resp != NULL);
+        CPPUNIT_ASSERT_EQUAL(cmd->getCommandId(), resp->getCorrelationId());
+    }
+
+    correlator.close();
+}
@@ -32,7 +32,9 @@ namespace correlator{
         CPPUNIT_TEST( testOneway );
         CPPUNIT_TEST( testTransportException );
         CPPUNIT_TEST( testMultiRequests );
+        CPPUNIT_TEST( testPendingRequestsFailedOnClose );
         CPPUNIT_TEST( testNarrow );
+        CPPUNIT_TEST( testRepeatedRequests );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -43,7 +45,9 @@ namespace correlator{
         void testOneway();
         void testTransportException();
         void testMultiRequests();
+        void testPendingRequestsFailedOnClose();
         void testNarrow();
+        void testRepeatedRequests();
 
     };
 
@@ -634,6 +634,8 @@ void FailoverTransportTest::testUriOptionsApplied() {
             "timeout=500&"
             "updateURIsSupported=false&"
             "maxReconnectDelay=55555&"
+            "parallelConnects=3&"
+            "parallelConnectTimeout=4321&"
             "priorityURIs=mock://localhost:61617,mock://localhost:61619";
 
     DefaultTransportListener listener;
@@ -658,6 +660,8 @@ void FailoverTransportTest::testUriOptionsApplied() {
     CPPUNIT_ASSERT(failover->getMaxCacheSize() == 16543217);
     CPPUNIT_ASSERT(failover->isUpdateURIsSupported() == false);
     CPPUNIT_ASSERT(failover->getMaxReconnectDelay() == 55555);
+    CPPUNIT_ASSERT(failover->getParallelConnects() == 3);
+    CPPUNIT_ASSERT(failover->getParallelConnectTimeout() == 4321);
 
     const List<URI>& priorityUris = failover->getPriorityURIs();
     CPPUNIT_ASSERT(priorityUris.size() == 2);
@@ -1037,3 +1041,71 @@ void FailoverTransportTest::testConnectsToPriorityAfterInitialBackupFails() {
     broker3->stop();
     broker3->waitUntilStopped();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testParallelConnects() {
+
+    std::string uri = "failover://(mock://localhost:61616?failOnCreate=true,"
+            "mock://localhost:61617?failOnCreate=true,"
+            "mock://localhost:61618)?randomize=false&parallelConnects=2";
+
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+
+    CPPUNIT_ASSERT(failover != NULL);
+    CPPUNIT_ASSERT(failover->getParallelConnects() == 2);
+
+    transport->start();
+
+    int count = 0;
+    while (!failover->isConnected() && count++ < 20) {
+        Thread::sleep(100);
+    }
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FailoverTransportTest::testParallelConnectsToMockBroker() {
+
+    MockBrokerService broker(61648);
+
+    broker.start();
+    broker.waitUntilStarted();
+
+    std::string uri = "failover://(tcp://localhost:61646?transport.useInactivityMonitor=false,"
+            "tcp://localhost:61648?transport.useInactivityMonitor=false)?randomize=false&parallelConnects=2";
+
+    DefaultTransportListener listener;
+    FailoverTransportFactory factory;
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport != NULL);
+    transport->setTransportListener(&listener);
+
+    FailoverTransport* failover =
+        dynamic_cast<FailoverTransport*>(transport->narrow(typeid(FailoverTransport)));
+
+    CPPUNIT_ASSERT(failover != NULL);
+
+    transport->start();
+
+    int count = 0;
+    while (!failover->isConnected() && count++ < 20) {
+        Thread::sleep(200);
+    }
+    CPPUNIT_ASSERT(failover->isConnected() == true);
+
+    transport->close();
+
+    broker.stop();
+    broker.waitUntilStopped();
+}
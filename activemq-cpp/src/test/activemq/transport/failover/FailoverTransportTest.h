@@ -59,6 +59,8 @@ namespace failover {
         CPPUNIT_TEST( testStartupMaxReconnectsHonorsConfiguration );
         CPPUNIT_TEST( testConnectedToPriorityOnFirstTryThenFailover );
         CPPUNIT_TEST( testConnectsToPriorityOnceStarted );
+        CPPUNIT_TEST( testParallelConnects );
+        CPPUNIT_TEST( testParallelConnectsToMockBroker );
         //CPPUNIT_TEST( testConnectsToPriorityAfterInitialBackupFails );
         CPPUNIT_TEST_SUITE_END();
 
@@ -87,6 +89,8 @@ namespace failover {
         void testConnectedToPriorityOnFirstTryThenFailover();
         void testConnectsToPriorityOnceStarted();
         void testConnectsToPriorityAfterInitialBackupFails();
+        void testParallelConnects();
+        void testParallelConnectsToMockBroker();
 
     private:
 
@@ -0,0 +1,234 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OutboxTest.h"
+
+#include <activemq/transport/failover/Outbox.h>
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::string OUTBOX_PATH = "OutboxTest.outbox";
+
+    std::vector<unsigned char> makeFrame( int size, unsigned char value ) {
+        return std::vector<unsigned char>( (std::size_t) size, value );
+    }
+
+    bool append( Outbox& outbox, int size, unsigned char value ) {
+        std::vector<unsigned char> frame = makeFrame( size, value );
+        return outbox.append( &frame[0], size );
+    }
+
+    void assertNext( Outbox& outbox, int size, unsigned char value ) {
+        std::vector<unsigned char> frame;
+        CPPUNIT_ASSERT( outbox.peek( frame ) );
+        CPPUNIT_ASSERT( makeFrame( size, value ) == frame );
+        outbox.consume();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OutboxTest::OutboxTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OutboxTest::~OutboxTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::tearDown() {
+    std::remove( OUTBOX_PATH.c_str() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testConstructor() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        Outbox( "" ),
+        IllegalArgumentException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        Outbox( OUTBOX_PATH, Outbox::HEADER_SIZE ),
+        IllegalArgumentException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        Outbox( "no-such-directory/outbox", 1024 ),
+        IOException );
+
+    Outbox outbox( OUTBOX_PATH, 1024 );
+    CPPUNIT_ASSERT_EQUAL( OUTBOX_PATH, outbox.getPath() );
+    CPPUNIT_ASSERT_EQUAL( 1024LL, outbox.getFileSize() );
+    CPPUNIT_ASSERT( outbox.isEmpty() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, outbox.getPendingCount() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        append( outbox, 1024, 1 ),
+        IllegalArgumentException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testAppendPeekConsume() {
+
+    Outbox outbox( OUTBOX_PATH, 4096 );
+
+    std::vector<unsigned char> frame;
+    CPPUNIT_ASSERT( !outbox.peek( frame ) );
+
+    CPPUNIT_ASSERT( append( outbox, 10, 1 ) );
+    CPPUNIT_ASSERT( append( outbox, 20, 2 ) );
+    CPPUNIT_ASSERT( append( outbox, 30, 3 ) );
+    CPPUNIT_ASSERT_EQUAL( 3LL, outbox.getPendingCount() );
+    CPPUNIT_ASSERT_EQUAL( 60LL, outbox.getPendingBytes() );
+
+    // Peeking doesn't remove the frame.
+    CPPUNIT_ASSERT( outbox.peek( frame ) );
+    CPPUNIT_ASSERT_EQUAL( 3LL, outbox.getPendingCount() );
+
+    assertNext( outbox, 10, 1 );
+    assertNext( outbox, 20, 2 );
+    assertNext( outbox, 30, 3 );
+
+    CPPUNIT_ASSERT( outbox.isEmpty() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, outbox.getPendingBytes() );
+    CPPUNIT_ASSERT( !outbox.peek( frame ) );
+
+    CPPUNIT_ASSERT( outbox.sync() );
+    CPPUNIT_ASSERT( !outbox.sync() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testRecoverAfterReopen() {
+
+    {
+        Outbox outbox( OUTBOX_PATH, 4096 );
+        CPPUNIT_ASSERT( append( outbox, 100, 1 ) );
+        CPPUNIT_ASSERT( append( outbox, 200, 2 ) );
+        CPPUNIT_ASSERT( append( outbox, 300, 3 ) );
+        assertNext( outbox, 100, 1 );
+    }
+
+    {
+        Outbox outbox( OUTBOX_PATH, 4096 );
+        CPPUNIT_ASSERT_EQUAL( 2LL, outbox.getPendingCount() );
+        CPPUNIT_ASSERT_EQUAL( 500LL, outbox.getPendingBytes() );
+        assertNext( outbox, 200, 2 );
+        CPPUNIT_ASSERT( append( outbox, 40, 4 ) );
+    }
+
+    Outbox outbox( OUTBOX_PATH, 4096 );
+    CPPUNIT_ASSERT_EQUAL( 2LL, outbox.getPendingCount() );
+    assertNext( outbox, 300, 3 );
+    assertNext( outbox, 40, 4 );
+    CPPUNIT_ASSERT( outbox.isEmpty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testWrapAround() {
+
+    std::auto_ptr<Outbox> outbox( new Outbox( OUTBOX_PATH, 1024 ) );
+
+    // Keeping a frame in the ring while cycling moves the records around its end
+    // many times over, reopening part way through has to follow the wrap.
+    CPPUNIT_ASSERT( append( *outbox, 150, 0 ) );
+
+    for( int i = 1; i < 100; ++i ) {
+        CPPUNIT_ASSERT( append( *outbox, 150 + i % 7, (unsigned char) i ) );
+        assertNext( *outbox, 150 + ( i - 1 ) % 7, (unsigned char) ( i - 1 ) );
+
+        if( i % 13 == 0 ) {
+            outbox.reset( NULL );
+            outbox.reset( new Outbox( OUTBOX_PATH, 1024 ) );
+            CPPUNIT_ASSERT_EQUAL( 1LL, outbox->getPendingCount() );
+        }
+    }
+
+    assertNext( *outbox, 150 + 99 % 7, 99 );
+    CPPUNIT_ASSERT( outbox->isEmpty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testFull() {
+
+    Outbox outbox( OUTBOX_PATH, 1024 );
+
+    int appended = 0;
+    while( append( outbox, 100, (unsigned char) appended ) ) {
+        appended++;
+    }
+
+    CPPUNIT_ASSERT( appended > 2 );
+    CPPUNIT_ASSERT_EQUAL( (long long) appended, outbox.getPendingCount() );
+
+    // The writer stays behind the reader, so the space of two consumed frames makes
+    // room for one more.
+    assertNext( outbox, 100, 0 );
+    CPPUNIT_ASSERT( !append( outbox, 100, (unsigned char) appended ) );
+    assertNext( outbox, 100, 1 );
+    CPPUNIT_ASSERT( append( outbox, 100, (unsigned char) appended ) );
+
+    for( int i = 2; i <= appended; ++i ) {
+        assertNext( outbox, 100, (unsigned char) i );
+    }
+
+    CPPUNIT_ASSERT( outbox.isEmpty() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OutboxTest::testTornRecordIgnored() {
+
+    {
+        Outbox outbox( OUTBOX_PATH, 4096 );
+        CPPUNIT_ASSERT( append( outbox, 64, 1 ) );
+        CPPUNIT_ASSERT( append( outbox, 64, 2 ) );
+    }
+
+    {
+        // Damage the second frame as a crash part way through writing it would.
+        MappedFile file( OUTBOX_PATH, 4096, false );
+        long long second = Outbox::HEADER_SIZE + Outbox::RECORD_HEADER_SIZE + 64;
+        file.getAddress()[second + Outbox::RECORD_HEADER_SIZE + 10] ^= 0xFF;
+    }
+
+    Outbox outbox( OUTBOX_PATH, 4096 );
+    CPPUNIT_ASSERT_EQUAL( 1LL, outbox.getPendingCount() );
+    assertNext( outbox, 64, 1 );
+
+    // The damaged record is written over by the next append.
+    CPPUNIT_ASSERT( append( outbox, 32, 3 ) );
+    assertNext( outbox, 32, 3 );
+}
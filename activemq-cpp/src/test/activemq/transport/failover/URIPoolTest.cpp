@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIPoolTest.h"
+
+#include <activemq/transport/failover/URIPool.h>
+#include <decaf/net/URI.h>
+#include <decaf/util/LinkedList.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::failover;
+using namespace decaf::net;
+using namespace decaf::util;
+
+////////////////////////////////////////////////////////////////////////////////
+URIPoolTest::URIPoolTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+URIPoolTest::~URIPoolTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testGetURI() {
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://localhost:61616"));
+    uris.add(URI("tcp://localhost:61617"));
+
+    URIPool pool(uris);
+
+    CPPUNIT_ASSERT(pool.isPriority(URI("tcp://localhost:61616")));
+    CPPUNIT_ASSERT(pool.getURI().equals(URI("tcp://localhost:61616")));
+    CPPUNIT_ASSERT(pool.getURI().equals(URI("tcp://localhost:61617")));
+    CPPUNIT_ASSERT(pool.isEmpty());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NoSuchElementException",
+        pool.getURI(),
+        decaf::util::NoSuchElementException);
+
+    CPPUNIT_ASSERT(pool.addURIs(uris));
+    CPPUNIT_ASSERT(!pool.addURIs(uris));
+    CPPUNIT_ASSERT(pool.getURIList().size() == 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testRecordConnectTime() {
+
+    URI uri("tcp://localhost:61616");
+    URIPool pool;
+    pool.addURI(uri);
+
+    CPPUNIT_ASSERT_EQUAL(-1LL, pool.getConnectTime(uri));
+
+    pool.recordConnectTime(uri, 100);
+    CPPUNIT_ASSERT_EQUAL(100LL, pool.getConnectTime(uri));
+
+    pool.recordConnectTime(uri, 20);
+    CPPUNIT_ASSERT_EQUAL(80LL, pool.getConnectTime(uri));
+
+    pool.recordConnectTime(uri, -1);
+    CPPUNIT_ASSERT_EQUAL(80LL + (URIPool::FAILED_CONNECT_TIME - 80LL) / URIPool::DECAY_FACTOR,
+                         pool.getConnectTime(uri));
+
+    // The times are kept when the pool is copied.
+    URIPool copy(pool);
+    CPPUNIT_ASSERT_EQUAL(pool.getConnectTime(uri), copy.getConnectTime(uri));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testGetURIsByConnectTime() {
+
+    URI slow("tcp://localhost:61616");
+    URI fast("tcp://localhost:61617");
+    URI failed("tcp://localhost:61618");
+    URI untried("tcp://localhost:61619");
+
+    LinkedList<URI> uris;
+    uris.add(slow);
+    uris.add(fast);
+    uris.add(failed);
+    uris.add(untried);
+
+    URIPool pool(uris);
+    pool.recordConnectTime(slow, 500);
+    pool.recordConnectTime(fast, 5);
+    pool.recordConnectTime(failed, -1);
+
+    LinkedList<URI> result;
+    CPPUNIT_ASSERT_EQUAL(3, pool.getURIs(3, result, false));
+    CPPUNIT_ASSERT_EQUAL(3, result.size());
+    CPPUNIT_ASSERT(result.get(0).equals(untried));
+    CPPUNIT_ASSERT(result.get(1).equals(fast));
+    CPPUNIT_ASSERT(result.get(2).equals(slow));
+
+    CPPUNIT_ASSERT(pool.getURIList().size() == 1);
+    CPPUNIT_ASSERT(pool.contains(failed));
+
+    result.clear();
+    CPPUNIT_ASSERT_EQUAL(1, pool.getURIs(3, result, false));
+    CPPUNIT_ASSERT(result.get(0).equals(failed));
+    CPPUNIT_ASSERT(pool.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, pool.getURIs(3, result, false));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testGetURIsPriorityFirst() {
+
+    URI priority("tcp://localhost:61616");
+    URI fast("tcp://localhost:61617");
+    URI other("tcp://localhost:61618");
+
+    LinkedList<URI> uris;
+    uris.add(priority);
+    uris.add(fast);
+    uris.add(other);
+
+    URIPool pool(uris);
+    pool.recordConnectTime(priority, 1000);
+    pool.recordConnectTime(fast, 1);
+    pool.recordConnectTime(other, 10);
+
+    LinkedList<URI> result;
+    CPPUNIT_ASSERT_EQUAL(2, pool.getURIs(2, result, true));
+    CPPUNIT_ASSERT(result.get(0).equals(priority));
+    CPPUNIT_ASSERT(result.get(1).equals(fast));
+
+    pool.addURIs(result);
+    result.clear();
+
+    CPPUNIT_ASSERT_EQUAL(2, pool.getURIs(2, result, false));
+    CPPUNIT_ASSERT(result.get(0).equals(fast));
+    CPPUNIT_ASSERT(result.get(1).equals(other));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testHashedGetURI() {
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://broker1:61616"));
+    uris.add(URI("tcp://broker2:61616"));
+    uris.add(URI("tcp://broker3:61616"));
+    uris.add(URI("tcp://broker4:61616"));
+
+    LinkedList<URI> reversed;
+    for (int i = uris.size() - 1; i >= 0; --i) {
+        reversed.add(uris.get(i));
+    }
+
+    URIPool pool(uris);
+    pool.setHashKey("ID:client-1");
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:client-1"), pool.getHashKey());
+
+    // The same key prefers the same URI whatever the order of the list.
+    URIPool other(reversed);
+    other.setHashKey("ID:client-1");
+
+    URI preferred = pool.getURI();
+    CPPUNIT_ASSERT(preferred.equals(other.getURI()));
+
+    pool.addURI(preferred);
+    CPPUNIT_ASSERT(pool.isPreferred(preferred));
+
+    // Removing any other URI leaves the preference alone.
+    for (int i = 0; i < uris.size(); ++i) {
+        URI uri = uris.get(i);
+        if (!uri.equals(preferred)) {
+            CPPUNIT_ASSERT(!pool.isPreferred(uri));
+            pool.removeURI(uri);
+            CPPUNIT_ASSERT(pool.isPreferred(preferred));
+            break;
+        }
+    }
+
+    // Without a key the pool falls back to its priority URI.
+    pool.setHashKey("");
+    CPPUNIT_ASSERT(pool.isPreferred(pool.getPriorityURI()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIPoolTest::testHashedGetURIs() {
+
+    LinkedList<URI> uris;
+    uris.add(URI("tcp://broker1:61616"));
+    uris.add(URI("tcp://broker2:61616"));
+    uris.add(URI("tcp://broker3:61616"));
+
+    URIPool pool(uris);
+    pool.setHashKey("ID:client-2");
+
+    // Connect times don't reorder a hashed pool.
+    pool.recordConnectTime(uris.get(0), 1000);
+    pool.recordConnectTime(uris.get(1), 1);
+
+    URIPool copy(pool);
+
+    LinkedList<URI> result;
+    CPPUNIT_ASSERT_EQUAL(3, pool.getURIs(3, result, false));
+
+    for (int i = 0; i < result.size(); ++i) {
+        CPPUNIT_ASSERT(result.get(i).equals(copy.getURI()));
+    }
+}
@@ -110,6 +110,8 @@ void InactivityMonitorTest::testCreate() {
     CPPUNIT_ASSERT( monitor.getReadCheckTime() == 0 );
     CPPUNIT_ASSERT( monitor.getWriteCheckTime() == 0 );
     CPPUNIT_ASSERT( monitor.isKeepAliveResponseRequired() == false );
+    CPPUNIT_ASSERT( monitor.isUseKeepAliveService() == true );
+    CPPUNIT_ASSERT( monitor.isUseTimingWheel() == false );
     CPPUNIT_ASSERT( monitor.isClosed() == false );
 }
 
@@ -135,6 +137,57 @@ void InactivityMonitorTest::testReadTimeout() {
     CPPUNIT_ASSERT( listener.exceptionFired == true );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitorTest::testReadTimeoutOnTimers() {
+
+    MyTransportListener listener;
+    InactivityMonitor monitor( this->transport, this->transport->getWireFormat() );
+    monitor.setUseKeepAliveService( false );
+    monitor.setTransportListener( &listener );
+    monitor.start();
+
+    CPPUNIT_ASSERT( !monitor.isUseKeepAliveService() );
+
+    // Send the local one for the monitor to record.
+    monitor.oneway( this->localWireFormatInfo );
+
+    Thread::sleep( 2000 );
+
+    // Should not have timed out on Read yet.
+    CPPUNIT_ASSERT( listener.exceptionFired == false );
+
+    Thread::sleep( 5000 );
+
+    // Channel should have been inactive for to long.
+    CPPUNIT_ASSERT( listener.exceptionFired == true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitorTest::testReadTimeoutOnTimingWheel() {
+
+    MyTransportListener listener;
+    InactivityMonitor monitor( this->transport, this->transport->getWireFormat() );
+    monitor.setUseKeepAliveService( false );
+    monitor.setUseTimingWheel( true );
+    monitor.setTransportListener( &listener );
+    monitor.start();
+
+    CPPUNIT_ASSERT( monitor.isUseTimingWheel() );
+
+    // Send the local one for the monitor to record.
+    monitor.oneway( this->localWireFormatInfo );
+
+    Thread::sleep( 2000 );
+
+    // Should not have timed out on Read yet.
+    CPPUNIT_ASSERT( listener.exceptionFired == false );
+
+    Thread::sleep( 5000 );
+
+    // Channel should have been inactive for to long.
+    CPPUNIT_ASSERT( listener.exceptionFired == true );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void InactivityMonitorTest::testWriteMessageFail() {
 
@@ -185,3 +238,35 @@ void InactivityMonitorTest::testNonFailureSendCase() {
     // Channel should have been inactive for to long.
     CPPUNIT_ASSERT( listener.exceptionFired == false );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void InactivityMonitorTest::testNoKeepAlivesWhileBusy() {
+
+    // Only counts the keep alives sent, fails long after the test ends.
+    this->transport->setFailOnKeepAliveSends( true );
+    this->transport->setNumSentKeepAlivesBeforeFail( 1000 );
+
+    MyTransportListener listener;
+    InactivityMonitor monitor( this->transport, this->transport->getWireFormat() );
+    monitor.setTransportListener( &listener );
+    monitor.start();
+
+    // Send the local one for the monitor to record.
+    monitor.oneway( this->localWireFormatInfo );
+
+    Pointer<ActiveMQMessage> message( new ActiveMQMessage() );
+    for( int ix = 0; ix < 16; ++ix ) {
+        monitor.oneway( message );
+        this->transport->fireCommand( message );
+        Thread::sleep( 250 );
+    }
+
+    // Real traffic was sent well within every write check period.
+    CPPUNIT_ASSERT_EQUAL( 0, this->transport->getNumSentKeepAlives() );
+    CPPUNIT_ASSERT( listener.exceptionFired == false );
+
+    Thread::sleep( 2500 );
+
+    // Once idle the keep alives start.
+    CPPUNIT_ASSERT( this->transport->getNumSentKeepAlives() > 0 );
+}
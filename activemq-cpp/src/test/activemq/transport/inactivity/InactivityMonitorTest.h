@@ -36,8 +36,11 @@ namespace inactivity {
         CPPUNIT_TEST_SUITE( InactivityMonitorTest );
         CPPUNIT_TEST( testCreate );
         CPPUNIT_TEST( testReadTimeout );
+        CPPUNIT_TEST( testReadTimeoutOnTimers );
+        CPPUNIT_TEST( testReadTimeoutOnTimingWheel );
         CPPUNIT_TEST( testWriteMessageFail );
         CPPUNIT_TEST( testNonFailureSendCase );
+        CPPUNIT_TEST( testNoKeepAlivesWhileBusy );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -56,8 +59,11 @@ namespace inactivity {
 
         void testCreate();
         void testReadTimeout();
+        void testReadTimeoutOnTimers();
+        void testReadTimeoutOnTimingWheel();
         void testWriteMessageFail();
         void testNonFailureSendCase();
+        void testNoKeepAlivesWhileBusy();
 
     };
 
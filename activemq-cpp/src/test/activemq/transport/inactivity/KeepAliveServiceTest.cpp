@@ -0,0 +1,186 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "KeepAliveServiceTest.h"
+
+#include <activemq/transport/inactivity/KeepAliveService.h>
+#include <activemq/transport/inactivity/InactivityMonitor.h>
+#include <activemq/transport/mock/MockTransport.h>
+#include <activemq/transport/mock/MockTransportFactory.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/commands/WireFormatInfo.h>
+
+#include <decaf/net/URI.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::mock;
+using namespace activemq::transport::inactivity;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class KeepAliveCounter : public DefaultTransportListener {
+    public:
+
+        AtomicInteger keepAlives;
+        AtomicInteger exceptions;
+
+        KeepAliveCounter() : keepAlives(), exceptions() {}
+
+        virtual ~KeepAliveCounter() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            if (command->isKeepAliveInfo()) {
+                keepAlives.incrementAndGet();
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            exceptions.incrementAndGet();
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+KeepAliveServiceTest::KeepAliveServiceTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+KeepAliveServiceTest::~KeepAliveServiceTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveServiceTest::testConstructor() {
+
+    KeepAliveService service(50, 1);
+    CPPUNIT_ASSERT_EQUAL(50LL, service.getResolution());
+    CPPUNIT_ASSERT_EQUAL(0, service.getMonitorCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, service.getSweepCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        KeepAliveService(0),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        KeepAliveService(100, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveServiceTest::testRegisterInvalidArgsThrows() {
+
+    URI uri("mock://mock?wireformat=openwire");
+    MockTransportFactory factory;
+    Pointer<MockTransport> transport = factory.createComposite(uri).dynamicCast<MockTransport>();
+    InactivityMonitor monitor(transport, transport->getWireFormat());
+
+    KeepAliveService service;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        service.registerMonitor(NULL, 0, 1000, 1000),
+        NullPointerException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        service.registerMonitor(&monitor, 0, 0, 1000),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown an IllegalArgumentException",
+        service.registerMonitor(&monitor, 0, 1000, 0),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT(!service.unregisterMonitor(&monitor));
+    CPPUNIT_ASSERT_EQUAL(0, service.getMonitorCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveServiceTest::testSharedInstance() {
+
+    KeepAliveService& service = KeepAliveService::getInstance();
+    CPPUNIT_ASSERT(&service == &KeepAliveService::getInstance());
+    CPPUNIT_ASSERT_EQUAL(KeepAliveService::DEFAULT_RESOLUTION, service.getResolution());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void KeepAliveServiceTest::testSweepsAreShared() {
+
+    static const int COUNT = 20;
+
+    KeepAliveService& service = KeepAliveService::getInstance();
+    int registered = service.getMonitorCount();
+
+    URI uri("mock://mock?wireformat=openwire");
+    MockTransportFactory factory;
+
+    Pointer<WireFormatInfo> info(new WireFormatInfo());
+    info->setVersion(5);
+    info->setMaxInactivityDuration(3000);
+    info->setTightEncodingEnabled(false);
+
+    std::vector< Pointer<MockTransport> > transports;
+    std::vector< Pointer<InactivityMonitor> > monitors;
+    KeepAliveCounter counter;
+
+    for (int i = 0; i < COUNT; ++i) {
+        Pointer<MockTransport> transport = factory.createComposite(uri).dynamicCast<MockTransport>();
+        transport->setOutgoingListener(&counter);
+
+        Pointer<InactivityMonitor> monitor(new InactivityMonitor(transport, transport->getWireFormat()));
+        monitor->setTransportListener(&counter);
+        monitor->start();
+        monitor->oneway(info);
+
+        transports.push_back(transport);
+        monitors.push_back(monitor);
+    }
+
+    // Each monitor registers once the mock's WireFormatInfo reply arrives.
+    for (int i = 0; i < 100 && service.getMonitorCount() < registered + COUNT; ++i) {
+        Thread::sleep(20);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(registered + COUNT, service.getMonitorCount());
+
+    long long sweeps = service.getSweepCount();
+    Thread::sleep(2500);
+
+    // Every monitor is idle so each should have written at least one KeepAliveInfo,
+    // the sweeps run them together rather than waking once per monitor.
+    CPPUNIT_ASSERT(counter.keepAlives.get() >= COUNT);
+    CPPUNIT_ASSERT(service.getSweepCount() - sweeps < COUNT);
+    CPPUNIT_ASSERT_EQUAL(0, counter.exceptions.get());
+
+    for (int i = 0; i < COUNT; ++i) {
+        monitors[i]->close();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(registered, service.getMonitorCount());
+}
@@ -0,0 +1,335 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PriorityLaneTransportTest.h"
+
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/KeepAliveInfo.h>
+#include <activemq/commands/LocalTransactionId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/transport/lanes/PriorityLaneTransport.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/concurrent/Concurrent.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::lanes;
+using namespace decaf::lang;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Records what is sent, while closed the gate holds the sender inside oneway.
+    class GatedTransport : public Transport {
+    public:
+
+        Mutex mutex;
+        bool open;
+        bool failing;
+        int inside;
+        std::vector< Pointer<Command> > sent;
+        TransportListener* listener;
+
+    private:
+
+        GatedTransport(const GatedTransport&);
+        GatedTransport& operator= (const GatedTransport&);
+
+    public:
+
+        GatedTransport() : mutex(), open(true), failing(false), inside(0), sent(), listener(NULL) {}
+
+        virtual ~GatedTransport() {}
+
+        void setOpen(bool value) {
+            synchronized(&mutex) {
+                open = value;
+                mutex.notifyAll();
+            }
+        }
+
+        bool awaitInside(int count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 50 && inside < count; ++i) {
+                    mutex.wait(100);
+                }
+                return inside >= count;
+            }
+            return false;
+        }
+
+        bool awaitSent(std::size_t count) {
+            synchronized(&mutex) {
+                for (int i = 0; i < 50 && sent.size() < count; ++i) {
+                    mutex.wait(100);
+                }
+                return sent.size() >= count;
+            }
+            return false;
+        }
+
+        virtual void oneway(const Pointer<Command> command) {
+            synchronized(&mutex) {
+                inside++;
+                mutex.notifyAll();
+                while (!open) {
+                    mutex.wait();
+                }
+                if (failing) {
+                    throw decaf::io::IOException(__FILE__, __LINE__, "send failed");
+                }
+                sent.push_back(command);
+                mutex.notifyAll();
+            }
+        }
+
+        virtual Pointer<FutureResponse> asyncRequest(const Pointer<Command> command AMQCPP_UNUSED,
+                                                     const Pointer<ResponseCallback> responseCallback AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<Response> request(const Pointer<Command> command AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<Response> request(const Pointer<Command> command AMQCPP_UNUSED,
+                                          unsigned int timeout AMQCPP_UNUSED) {
+            throw decaf::lang::exceptions::UnsupportedOperationException(__FILE__, __LINE__, "not supported");
+        }
+
+        virtual Pointer<wireformat::WireFormat> getWireFormat() const {
+            return Pointer<wireformat::WireFormat>();
+        }
+
+        virtual void setWireFormat(const Pointer<wireformat::WireFormat> wireFormat AMQCPP_UNUSED) {}
+
+        virtual void setTransportListener(TransportListener* listener) {
+            this->listener = listener;
+        }
+
+        virtual TransportListener* getTransportListener() const {
+            return this->listener;
+        }
+
+        virtual void start() {}
+
+        virtual void stop() {}
+
+        virtual void close() {
+            setOpen(true);
+        }
+
+        virtual Transport* narrow(const std::type_info& typeId) {
+            return typeid(*this) == typeId ? this : NULL;
+        }
+
+        virtual bool isFaultTolerant() const {
+            return false;
+        }
+
+        virtual bool isConnected() const {
+            return true;
+        }
+
+        virtual bool isClosed() const {
+            return false;
+        }
+
+        virtual bool isReconnectSupported() const {
+            return false;
+        }
+
+        virtual bool isUpdateURIsSupported() const {
+            return false;
+        }
+
+        virtual std::string getRemoteAddress() const {
+            return "";
+        }
+
+        virtual void reconnect(const decaf::net::URI& uri AMQCPP_UNUSED) {}
+
+        virtual void updateURIs(bool rebalance AMQCPP_UNUSED,
+                                const decaf::util::List<decaf::net::URI>& uris AMQCPP_UNUSED) {}
+    };
+
+    class CountingListener : public DefaultTransportListener {
+    public:
+
+        Mutex mutex;
+        int errors;
+
+        CountingListener() : mutex(), errors(0) {}
+
+        virtual ~CountingListener() {}
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            synchronized(&mutex) {
+                errors++;
+                mutex.notifyAll();
+            }
+        }
+
+        bool awaitException() {
+            synchronized(&mutex) {
+                for (int i = 0; i < 50 && errors == 0; ++i) {
+                    mutex.wait(100);
+                }
+                return errors > 0;
+            }
+            return false;
+        }
+    };
+
+    Pointer<Command> createMessage(int id) {
+        Pointer<Command> message(new ActiveMQTextMessage());
+        message->setCommandId(id);
+        return message;
+    }
+
+    Pointer<Command> createAck(int id) {
+        Pointer<Command> ack(new MessageAck());
+        ack->setCommandId(id);
+        return ack;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityLaneTransportTest::PriorityLaneTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+PriorityLaneTransportTest::~PriorityLaneTransportTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransportTest::testIsPriorityCommand() {
+
+    MessageAck ack;
+    CPPUNIT_ASSERT(PriorityLaneTransport::isPriorityCommand(ack));
+
+    MessageAck transacted;
+    transacted.setTransactionId(Pointer<TransactionId>(new LocalTransactionId()));
+    CPPUNIT_ASSERT(!PriorityLaneTransport::isPriorityCommand(transacted));
+
+    KeepAliveInfo keepAlive;
+    CPPUNIT_ASSERT(PriorityLaneTransport::isPriorityCommand(keepAlive));
+
+    ActiveMQTextMessage message;
+    CPPUNIT_ASSERT(!PriorityLaneTransport::isPriorityCommand(message));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransportTest::testOnewayBeforeStart() {
+
+    Pointer<GatedTransport> next(new GatedTransport());
+    PriorityLaneTransport transport(next);
+
+    transport.oneway(createMessage(1));
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, next->sent.size());
+    CPPUNIT_ASSERT_EQUAL(0, transport.getPendingCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransportTest::testPriorityOvertakesBulk() {
+
+    Pointer<GatedTransport> next(new GatedTransport());
+    CountingListener listener;
+
+    PriorityLaneTransport transport(next);
+    transport.setTransportListener(&listener);
+    transport.start();
+
+    // Hold the writer inside the first send so the rest queue up behind it.
+    next->setOpen(false);
+    transport.oneway(createMessage(1));
+    CPPUNIT_ASSERT(next->awaitInside(1));
+
+    transport.oneway(createMessage(2));
+    transport.oneway(createMessage(3));
+    transport.oneway(createAck(4));
+    transport.oneway(createAck(5));
+    CPPUNIT_ASSERT_EQUAL(4, transport.getPendingCount());
+
+    next->setOpen(true);
+    CPPUNIT_ASSERT(next->awaitSent(5));
+
+    int expected[] = { 1, 4, 5, 2, 3 };
+    for (int i = 0; i < 5; ++i) {
+        CPPUNIT_ASSERT_EQUAL(expected[i], next->sent[i]->getCommandId());
+    }
+
+    transport.close();
+    CPPUNIT_ASSERT_EQUAL(0, listener.errors);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransportTest::testCloseSendsQueued() {
+
+    Pointer<GatedTransport> next(new GatedTransport());
+    CountingListener listener;
+
+    PriorityLaneTransport transport(next);
+    transport.setTransportListener(&listener);
+    transport.start();
+
+    for (int i = 1; i <= 10; ++i) {
+        transport.oneway(createMessage(i));
+    }
+
+    transport.close();
+
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 10, next->sent.size());
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i + 1, next->sent[i]->getCommandId());
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException once closed",
+        transport.oneway(createMessage(11)),
+        decaf::io::IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void PriorityLaneTransportTest::testWriterFailure() {
+
+    Pointer<GatedTransport> next(new GatedTransport());
+    CountingListener listener;
+
+    PriorityLaneTransport transport(next);
+    transport.setTransportListener(&listener);
+    transport.start();
+
+    next->failing = true;
+    transport.oneway(createMessage(1));
+    CPPUNIT_ASSERT(listener.awaitException());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException once the writer failed",
+        transport.oneway(createMessage(2)),
+        decaf::io::IOException);
+
+    transport.close();
+}
@@ -0,0 +1,210 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameCaptureFileTest.h"
+
+#include <activemq/transport/logging/FrameCaptureFile.h>
+#include <activemq/transport/logging/FrameCaptureReader.h>
+#include <decaf/internal/io/MappedFile.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::logging;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const std::string CAPTURE_PATH = "FrameCaptureFileTest.capture";
+
+    void fill( unsigned char* frame, int size, unsigned char value ) {
+        std::memset( frame, value, (std::size_t) size );
+    }
+
+    void assertFrame( FrameCaptureReader& reader, int direction, int size, unsigned char value ) {
+        CPPUNIT_ASSERT( reader.next() );
+        CPPUNIT_ASSERT_EQUAL( direction, reader.getDirection() );
+        CPPUNIT_ASSERT_EQUAL( size, reader.getFrameSize() );
+        for( int i = 0; i < size; ++i ) {
+            CPPUNIT_ASSERT_EQUAL( (int) value, (int) reader.getFrame()[i] );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureFileTest::FrameCaptureFileTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+FrameCaptureFileTest::~FrameCaptureFileTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::tearDown() {
+    for( int i = 0; i < 2; ++i ) {
+        std::remove( FrameCaptureFile::getFileName( CAPTURE_PATH, i ).c_str() );
+    }
+    std::remove( CAPTURE_PATH.c_str() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::testConstructor() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        FrameCaptureFile( "" ),
+        IllegalArgumentException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        FrameCaptureFile( CAPTURE_PATH, FrameCaptureFile::HEADER_SIZE ),
+        IllegalArgumentException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        FrameCaptureFile( CAPTURE_PATH, 1024, 0 ),
+        IllegalArgumentException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        FrameCaptureFile( "no-such-directory/capture", 1024 ),
+        IOException );
+
+    FrameCaptureFile capture( CAPTURE_PATH, 1024, 2 );
+    CPPUNIT_ASSERT_EQUAL( CAPTURE_PATH, capture.getPath() );
+    CPPUNIT_ASSERT_EQUAL( 1024LL, capture.getFileSize() );
+    CPPUNIT_ASSERT_EQUAL( 2, capture.getFileCount() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, capture.getFrameCount() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, capture.getDroppedCount() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::testCaptureAndRead() {
+
+    long long started = System::currentTimeMillis();
+
+    unsigned char frame[100];
+    {
+        FrameCaptureFile capture( CAPTURE_PATH, 4096, 2 );
+
+        fill( frame, 10, 'a' );
+        capture.capture( FrameCaptureFile::OUTBOUND, frame, 10 );
+        fill( frame, 100, 'b' );
+        capture.capture( FrameCaptureFile::INBOUND, frame, 100 );
+        fill( frame, 1, 'c' );
+        capture.capture( FrameCaptureFile::OUTBOUND, frame, 1 );
+
+        CPPUNIT_ASSERT_EQUAL( 3LL, capture.getFrameCount() );
+    }
+
+    FrameCaptureReader reader( FrameCaptureFile::getFileName( CAPTURE_PATH, 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 0LL, reader.getSequence() );
+    CPPUNIT_ASSERT( reader.getCreationTime() >= started );
+
+    assertFrame( reader, FrameCaptureFile::OUTBOUND, 10, 'a' );
+    long long first = reader.getTimestamp();
+    CPPUNIT_ASSERT( first >= reader.getCreationTime() * 1000 );
+
+    assertFrame( reader, FrameCaptureFile::INBOUND, 100, 'b' );
+    assertFrame( reader, FrameCaptureFile::OUTBOUND, 1, 'c' );
+    CPPUNIT_ASSERT( reader.getTimestamp() >= first );
+
+    CPPUNIT_ASSERT( !reader.next() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::testRollover() {
+
+    // Room for exactly two ten byte frames in each file.
+    const int frameSize = 10;
+    const long long fileSize = FrameCaptureFile::HEADER_SIZE + 2 * ( FrameCaptureFile::RECORD_HEADER_SIZE + frameSize );
+
+    unsigned char frame[frameSize];
+    {
+        FrameCaptureFile capture( CAPTURE_PATH, fileSize, 2 );
+
+        for( int i = 0; i < 5; ++i ) {
+            fill( frame, frameSize, (unsigned char) ( '0' + i ) );
+            capture.capture( FrameCaptureFile::INBOUND, frame, frameSize );
+        }
+
+        CPPUNIT_ASSERT_EQUAL( 5LL, capture.getFrameCount() );
+        CPPUNIT_ASSERT_EQUAL( 0LL, capture.getDroppedCount() );
+    }
+
+    // The oldest file was reused for the fifth frame.
+    FrameCaptureReader newest( FrameCaptureFile::getFileName( CAPTURE_PATH, 0 ) );
+    CPPUNIT_ASSERT_EQUAL( 2LL, newest.getSequence() );
+    assertFrame( newest, FrameCaptureFile::INBOUND, frameSize, '4' );
+    CPPUNIT_ASSERT( !newest.next() );
+
+    FrameCaptureReader older( FrameCaptureFile::getFileName( CAPTURE_PATH, 1 ) );
+    CPPUNIT_ASSERT_EQUAL( 1LL, older.getSequence() );
+    assertFrame( older, FrameCaptureFile::INBOUND, frameSize, '2' );
+    assertFrame( older, FrameCaptureFile::INBOUND, frameSize, '3' );
+    CPPUNIT_ASSERT( !older.next() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::testDroppedFrames() {
+
+    unsigned char frame[256];
+    fill( frame, 256, 'z' );
+
+    FrameCaptureFile capture( CAPTURE_PATH, 128, 2 );
+
+    // Too big for any file.
+    capture.capture( FrameCaptureFile::OUTBOUND, frame, 256 );
+    CPPUNIT_ASSERT_EQUAL( 1LL, capture.getDroppedCount() );
+
+    capture.capture( FrameCaptureFile::OUTBOUND, frame, 16 );
+    CPPUNIT_ASSERT_EQUAL( 1LL, capture.getFrameCount() );
+
+    capture.close();
+    capture.capture( FrameCaptureFile::OUTBOUND, frame, 16 );
+    CPPUNIT_ASSERT_EQUAL( 1LL, capture.getFrameCount() );
+    CPPUNIT_ASSERT_EQUAL( 2LL, capture.getDroppedCount() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FrameCaptureFileTest::testReadNonCaptureFile() {
+
+    {
+        MappedFile file( CAPTURE_PATH, 64 );
+        std::memcpy( file.getAddress(), "not a capture", 13 );
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        FrameCaptureReader reader( CAPTURE_PATH ),
+        IOException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        FrameCaptureReader reader( "no-such-capture-file" ),
+        IOException );
+}
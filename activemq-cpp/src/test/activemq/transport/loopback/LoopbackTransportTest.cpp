@@ -0,0 +1,459 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LoopbackTransportTest.h"
+
+#include <activemq/commands/ActiveMQTempQueue.h>
+#include <activemq/core/ActiveMQConnection.h>
+#include <activemq/core/ActiveMQConnectionFactory.h>
+#include <activemq/core/ActiveMQConsumer.h>
+#include <activemq/core/ActiveMQQueueBrowser.h>
+#include <activemq/core/ActiveMQSession.h>
+#include <activemq/transport/loopback/LoopbackTransport.h>
+#include <activemq/transport/loopback/LoopbackTransportFactory.h>
+
+#include <cms/Connection.h>
+#include <cms/MessageConsumer.h>
+#include <cms/MessageProducer.h>
+#include <cms/QueueBrowser.h>
+#include <cms/Session.h>
+#include <cms/TextMessage.h>
+
+#include <decaf/lang/Integer.h>
+#include <decaf/net/URI.h>
+
+#include <memory>
+
+using namespace std;
+using namespace cms;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::core;
+using namespace activemq::core::kernels;
+using namespace activemq::transport;
+using namespace activemq::transport::loopback;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string textOf(const Pointer<cms::Message>& message) {
+        const TextMessage* text = dynamic_cast<const TextMessage*>(message.get());
+        CPPUNIT_ASSERT(text != NULL);
+        return text->getText();
+    }
+
+    std::string receiveText(MessageConsumer* consumer) {
+        std::auto_ptr<cms::Message> message(consumer->receive(2000));
+        CPPUNIT_ASSERT_MESSAGE("No message received", message.get() != NULL);
+        TextMessage* text = dynamic_cast<TextMessage*>(message.get());
+        CPPUNIT_ASSERT(text != NULL);
+        return text->getText();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testFactory() {
+
+    URI uri("loopback://factory");
+
+    LoopbackTransportFactory factory;
+
+    Pointer<Transport> first(factory.createComposite(uri));
+    Pointer<Transport> second(factory.createComposite(uri));
+    Pointer<Transport> other(factory.createComposite(URI("loopback://other")));
+
+    LoopbackTransport* firstLoopback = dynamic_cast<LoopbackTransport*>(first->narrow(typeid(LoopbackTransport)));
+    LoopbackTransport* secondLoopback = dynamic_cast<LoopbackTransport*>(second->narrow(typeid(LoopbackTransport)));
+    LoopbackTransport* otherLoopback = dynamic_cast<LoopbackTransport*>(other->narrow(typeid(LoopbackTransport)));
+
+    CPPUNIT_ASSERT(firstLoopback != NULL);
+    CPPUNIT_ASSERT(firstLoopback->getBroker() == secondLoopback->getBroker());
+    CPPUNIT_ASSERT(firstLoopback->getBroker() != otherLoopback->getBroker());
+    CPPUNIT_ASSERT_EQUAL(std::string("factory"), firstLoopback->getBroker()->getName());
+
+    Pointer<Transport> transport(factory.create(uri));
+    CPPUNIT_ASSERT(transport->narrow(typeid(LoopbackTransport)) != NULL);
+
+    first->close();
+    CPPUNIT_ASSERT(first->isClosed());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException once closed",
+        first->start(),
+        decaf::io::IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testQueueRoundTrip() {
+
+    ActiveMQConnectionFactory factory("loopback://roundTrip");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("test.queue"));
+    std::auto_ptr<MessageConsumer> consumer(session->createConsumer(queue.get()));
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    connection->start();
+
+    for (int i = 0; i < 100; ++i) {
+        std::auto_ptr<TextMessage> message(session->createTextMessage(Integer::toString(i)));
+        producer->send(message.get());
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), receiveText(consumer.get()));
+    }
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testTopicFanOut() {
+
+    ActiveMQConnectionFactory factory("loopback://fanOut");
+    std::auto_ptr<Connection> producerConnection(factory.createConnection());
+    std::auto_ptr<Connection> consumerConnection(factory.createConnection());
+
+    std::auto_ptr<Session> consumerSession(consumerConnection->createSession());
+    std::auto_ptr<Topic> topic(consumerSession->createTopic("test.topic"));
+    std::auto_ptr<MessageConsumer> first(consumerSession->createConsumer(topic.get()));
+    std::auto_ptr<MessageConsumer> second(consumerSession->createConsumer(topic.get()));
+    consumerConnection->start();
+
+    std::auto_ptr<Session> producerSession(producerConnection->createSession());
+    std::auto_ptr<MessageProducer> producer(producerSession->createProducer(topic.get()));
+    producerConnection->start();
+
+    std::auto_ptr<TextMessage> message(producerSession->createTextMessage("fan out"));
+    producer->send(message.get());
+
+    CPPUNIT_ASSERT_EQUAL(std::string("fan out"), receiveText(first.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("fan out"), receiveText(second.get()));
+
+    producerConnection->close();
+    consumerConnection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testQueueHoldsMessagesForLateConsumer() {
+
+    ActiveMQConnectionFactory factory("loopback://lateConsumer");
+
+    {
+        std::auto_ptr<Connection> connection(factory.createConnection());
+        std::auto_ptr<Session> session(connection->createSession());
+        std::auto_ptr<Queue> queue(session->createQueue("test.late"));
+        std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+        connection->start();
+
+        std::auto_ptr<TextMessage> message(session->createTextMessage("held"));
+        producer->send(message.get());
+        connection->close();
+    }
+
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("test.late"));
+    std::auto_ptr<MessageConsumer> consumer(session->createConsumer(queue.get()));
+    connection->start();
+
+    CPPUNIT_ASSERT_EQUAL(std::string("held"), receiveText(consumer.get()));
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testTransactedSendRoutedOnCommit() {
+
+    ActiveMQConnectionFactory factory("loopback://transacted");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession(Session::SESSION_TRANSACTED));
+    std::auto_ptr<Session> consumerSession(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("test.transacted"));
+    std::auto_ptr<MessageConsumer> consumer(consumerSession->createConsumer(queue.get()));
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    connection->start();
+
+    std::auto_ptr<TextMessage> rolledBack(session->createTextMessage("rolled back"));
+    producer->send(rolledBack.get());
+    session->rollback();
+
+    std::auto_ptr<TextMessage> committed(session->createTextMessage("committed"));
+    producer->send(committed.get());
+
+    std::auto_ptr<cms::Message> early(consumer->receive(100));
+    CPPUNIT_ASSERT(early.get() == NULL);
+
+    session->commit();
+
+    CPPUNIT_ASSERT_EQUAL(std::string("committed"), receiveText(consumer.get()));
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testPipelinedStartup() {
+
+    ActiveMQConnectionFactory factory("loopback://pipelined?connection.pipelinedStartup=true");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    CPPUNIT_ASSERT(dynamic_cast<ActiveMQConnection*>(connection.get())->isPipelinedStartup());
+
+    std::auto_ptr<Session> session(connection->createSession());
+
+    const int count = 50;
+    std::vector<MessageConsumer*> consumers;
+    std::vector<MessageProducer*> producers;
+    for (int i = 0; i < count; ++i) {
+        std::auto_ptr<Queue> queue(session->createQueue("pipelined." + Integer::toString(i)));
+        consumers.push_back(session->createConsumer(queue.get()));
+        producers.push_back(session->createProducer(queue.get()));
+    }
+
+    connection->start();
+
+    for (int i = 0; i < count; ++i) {
+        std::auto_ptr<TextMessage> message(session->createTextMessage(Integer::toString(i)));
+        producers[i]->send(message.get());
+    }
+
+    for (int i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), receiveText(consumers[i]));
+        delete consumers[i];
+        delete producers[i];
+    }
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testPipelinedStartupRefusal() {
+
+    ActiveMQConnectionFactory factory("loopback://pipelinedRefusal");
+    factory.setPipelinedStartup(true);
+
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("test.queue"));
+    std::auto_ptr<MessageConsumer> good(session->createConsumer(queue.get()));
+
+    // No connection created this temporary queue, the broker refuses its consumer.
+    ActiveMQTempQueue unknown("ID:unknown:1:1");
+    std::auto_ptr<MessageConsumer> refused(session->createConsumer(&unknown));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should report the refused consumer",
+        connection->start(),
+        CMSException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "The refused consumer should be closed",
+        refused->receiveNoWait(),
+        CMSException);
+
+    // The rest of the batch is unaffected and the connection starts.
+    connection->start();
+
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    connection->start();
+
+    std::auto_ptr<TextMessage> message(session->createTextMessage("after refusal"));
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(std::string("after refusal"), receiveText(good.get()));
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testAsyncConsumerCreateAndClose() {
+
+    ActiveMQConnectionFactory factory("loopback://asyncConsumers");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    ActiveMQSession* amqSession = dynamic_cast<ActiveMQSession*>(session.get());
+    connection->start();
+
+    const int count = 20;
+    std::vector< Pointer<ActiveMQSessionKernel::ConsumerFuture> > pending;
+    for (int i = 0; i < count; ++i) {
+        std::auto_ptr<Queue> queue(session->createQueue("async." + Integer::toString(i)));
+        pending.push_back(amqSession->createConsumerAsync(queue.get()));
+    }
+
+    std::vector<MessageConsumer*> consumers;
+    for (int i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT(pending[i]->await(5000));
+        CPPUNIT_ASSERT(pending[i]->isDone());
+        consumers.push_back(pending[i]->get());
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "The consumer is handed out only once",
+        pending[0]->get(),
+        CMSException);
+
+    std::auto_ptr<MessageProducer> producer(session->createProducer(NULL));
+    for (int i = 0; i < count; ++i) {
+        std::auto_ptr<Queue> queue(session->createQueue("async." + Integer::toString(i)));
+        std::auto_ptr<TextMessage> message(session->createTextMessage(Integer::toString(i)));
+        producer->send(queue.get(), message.get());
+    }
+
+    std::vector< Pointer<ActiveMQSessionKernel::CloseFuture> > closing;
+    for (int i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), receiveText(consumers[i]));
+        closing.push_back(amqSession->closeConsumerAsync(consumers[i]));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        CPPUNIT_ASSERT(closing[i]->await(5000));
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "The consumer should be closed",
+            consumers[i]->receiveNoWait(),
+            CMSException);
+
+        // Closing again has nothing to send.
+        CPPUNIT_ASSERT(amqSession->closeConsumerAsync(consumers[i])->isDone());
+        delete consumers[i];
+    }
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testAsyncConsumerRefusal() {
+
+    ActiveMQConnectionFactory factory("loopback://asyncRefusal");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    ActiveMQSession* amqSession = dynamic_cast<ActiveMQSession*>(session.get());
+
+    // No connection created this temporary queue, the broker refuses its consumer.
+    ActiveMQTempQueue unknown("ID:unknown:1:1");
+    Pointer<ActiveMQSessionKernel::ConsumerFuture> refused = amqSession->createConsumerAsync(&unknown);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should report the refused consumer",
+        refused->get(),
+        CMSException);
+    CPPUNIT_ASSERT(refused->isDone());
+
+    // A future dropped without taking its consumer closes it.
+    std::auto_ptr<Queue> queue(session->createQueue("async.dropped"));
+    amqSession->createConsumerAsync(queue.get())->await(5000);
+
+    std::auto_ptr<MessageConsumer> consumer(session->createConsumer(queue.get()));
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    connection->start();
+
+    std::auto_ptr<TextMessage> message(session->createTextMessage("after refusal"));
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(std::string("after refusal"), receiveText(consumer.get()));
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testPullBatching() {
+
+    ActiveMQConnectionFactory factory(
+        "loopback://pullBatching?cms.prefetchPolicy.queuePrefetch=0&cms.prefetchPolicy.pullBatchSize=4");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("pull.batching"));
+
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    for (int i = 0; i < 10; ++i) {
+        std::auto_ptr<TextMessage> message(session->createTextMessage(Integer::toString(i)));
+        producer->send(message.get());
+    }
+
+    std::auto_ptr<MessageConsumer> first(session->createConsumer(queue.get()));
+    std::auto_ptr<MessageConsumer> second(session->createConsumer(queue.get()));
+    CPPUNIT_ASSERT_EQUAL(4, dynamic_cast<ActiveMQConsumer*>(first.get())->getPullBatchSize());
+    connection->start();
+
+    // The first receive pulls a window of four, the other consumer's pull gets the next.
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), receiveText(first.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("4"), receiveText(second.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), receiveText(first.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("2"), receiveText(first.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("3"), receiveText(first.get()));
+
+    // Only the second consumer's window is left with messages in it.
+    for (int i = 5; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), receiveText(second.get()));
+    }
+
+    // A window that comes back empty is reported once.
+    std::auto_ptr<cms::Message> none(first->receiveNoWait());
+    CPPUNIT_ASSERT(none.get() == NULL);
+
+    // The second consumer still has pulls outstanding, take it out of the way.
+    second->close();
+
+    std::auto_ptr<TextMessage> message(session->createTextMessage("after empty window"));
+    producer->send(message.get());
+    CPPUNIT_ASSERT_EQUAL(std::string("after empty window"), receiveText(first.get()));
+
+    connection->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoopbackTransportTest::testBrowseBatches() {
+
+    ActiveMQConnectionFactory factory("loopback://browseBatches");
+    std::auto_ptr<Connection> connection(factory.createConnection());
+    std::auto_ptr<Session> session(connection->createSession());
+    std::auto_ptr<Queue> queue(session->createQueue("browse.batches"));
+    connection->start();
+
+    std::auto_ptr<MessageProducer> producer(session->createProducer(queue.get()));
+    for (int i = 0; i < 10; ++i) {
+        std::auto_ptr<TextMessage> message(session->createTextMessage(Integer::toString(i)));
+        producer->send(message.get());
+    }
+
+    std::auto_ptr<QueueBrowser> browser(session->createBrowser(queue.get()));
+    ActiveMQQueueBrowser* amqBrowser = dynamic_cast<ActiveMQQueueBrowser*>(browser.get());
+
+    std::vector< Pointer<cms::Message> > head;
+    CPPUNIT_ASSERT_EQUAL(3, amqBrowser->sampleHead(head, 3));
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), textOf(head[0]));
+    CPPUNIT_ASSERT_EQUAL(std::string("2"), textOf(head[2]));
+
+    browser->getEnumeration();
+    std::vector< Pointer<cms::Message> > all;
+    while (amqBrowser->nextBatch(all, 4) > 0) {
+        CPPUNIT_ASSERT(all.size() <= 10);
+    }
+    CPPUNIT_ASSERT_EQUAL(10, (int) all.size());
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), textOf(all[i]));
+    }
+
+    std::vector< Pointer<cms::Message> > tail;
+    CPPUNIT_ASSERT_EQUAL(4, amqBrowser->sampleTail(tail, 4));
+    CPPUNIT_ASSERT_EQUAL(std::string("6"), textOf(tail[0]));
+    CPPUNIT_ASSERT_EQUAL(std::string("9"), textOf(tail[3]));
+
+    // Browsing leaves the messages on the queue.
+    std::auto_ptr<MessageConsumer> consumer(session->createConsumer(queue.get()));
+    CPPUNIT_ASSERT_EQUAL(std::string("0"), receiveText(consumer.get()));
+
+    connection->close();
+}
@@ -0,0 +1,65 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTTEST_H_
+#define _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace transport {
+namespace loopback {
+
+    class LoopbackTransportTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( LoopbackTransportTest );
+        CPPUNIT_TEST( testFactory );
+        CPPUNIT_TEST( testQueueRoundTrip );
+        CPPUNIT_TEST( testTopicFanOut );
+        CPPUNIT_TEST( testQueueHoldsMessagesForLateConsumer );
+        CPPUNIT_TEST( testTransactedSendRoutedOnCommit );
+        CPPUNIT_TEST( testPipelinedStartup );
+        CPPUNIT_TEST( testPipelinedStartupRefusal );
+        CPPUNIT_TEST( testAsyncConsumerCreateAndClose );
+        CPPUNIT_TEST( testAsyncConsumerRefusal );
+        CPPUNIT_TEST( testPullBatching );
+        CPPUNIT_TEST( testBrowseBatches );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        LoopbackTransportTest() {}
+        virtual ~LoopbackTransportTest() {}
+
+        void testFactory();
+        void testQueueRoundTrip();
+        void testTopicFanOut();
+        void testQueueHoldsMessagesForLateConsumer();
+        void testTransactedSendRoutedOnCommit();
+        void testPipelinedStartup();
+        void testPipelinedStartupRefusal();
+        void testAsyncConsumerCreateAndClose();
+        void testAsyncConsumerRefusal();
+        void testPullBatching();
+        void testBrowseBatches();
+
+    };
+
+}}}
+
+#endif /* _ACTIVEMQ_TRANSPORT_LOOPBACK_LOOPBACKTRANSPORTTEST_H_ */
@@ -0,0 +1,153 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripedTransportTest.h"
+
+#include <activemq/transport/striped/StripedTransport.h>
+#include <activemq/transport/striped/StripedTransportFactory.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/commands/RemoveInfo.h>
+#include <activemq/commands/SessionId.h>
+#include <activemq/commands/SessionInfo.h>
+#include <cms/Session.h>
+#include <decaf/io/IOException.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/net/URI.h>
+
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
+using namespace activemq::transport::striped;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    Pointer<SessionInfo> createSessionInfo(long long value, cms::Session::AcknowledgeMode ackMode) {
+
+        Pointer<SessionId> sessionId(new SessionId());
+        sessionId->setConnectionId("ID:StripedTransportTest:1");
+        sessionId->setValue(value);
+
+        Pointer<SessionInfo> info(new SessionInfo());
+        info->setSessionId(sessionId);
+        info->setAckMode(ackMode);
+
+        return info;
+    }
+
+    Pointer<StripedTransport> createTransport(int stripes) {
+
+        StripedTransportFactory factory;
+        Pointer<Transport> transport = factory.createComposite(
+            URI("striped://(mock://localhost:61616)?stripes=" + Integer::toString(stripes)));
+
+        return transport.dynamicCast<StripedTransport>();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransportTest::testTransportCreate() {
+
+    DefaultTransportListener listener;
+
+    Pointer<StripedTransport> transport = createTransport(3);
+    CPPUNIT_ASSERT(transport != NULL);
+    CPPUNIT_ASSERT_EQUAL(3, transport->getStripes());
+    transport->setTransportListener(&listener);
+
+    CPPUNIT_ASSERT(!transport->isConnected());
+    transport->start();
+    CPPUNIT_ASSERT(transport->isConnected());
+
+    transport->close();
+    CPPUNIT_ASSERT(transport->isClosed());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransportTest::testSessionsTakeStripesInTurn() {
+
+    DefaultTransportListener listener;
+
+    Pointer<StripedTransport> transport = createTransport(3);
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    for (long long i = 1; i <= 4; ++i) {
+        transport->oneway(createSessionInfo(i, cms::Session::AUTO_ACKNOWLEDGE));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, transport->getSessionStripe(1));
+    CPPUNIT_ASSERT_EQUAL(1, transport->getSessionStripe(2));
+    CPPUNIT_ASSERT_EQUAL(2, transport->getSessionStripe(3));
+    CPPUNIT_ASSERT_EQUAL(0, transport->getSessionStripe(4));
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransportTest::testTransactedSessionsUseFirstStripe() {
+
+    DefaultTransportListener listener;
+
+    Pointer<StripedTransport> transport = createTransport(2);
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    transport->oneway(createSessionInfo(1, cms::Session::AUTO_ACKNOWLEDGE));
+    transport->oneway(createSessionInfo(2, cms::Session::SESSION_TRANSACTED));
+    transport->oneway(createSessionInfo(3, cms::Session::CLIENT_ACKNOWLEDGE));
+
+    CPPUNIT_ASSERT_EQUAL(0, transport->getSessionStripe(1));
+    CPPUNIT_ASSERT_EQUAL(0, transport->getSessionStripe(2));
+    CPPUNIT_ASSERT_EQUAL(1, transport->getSessionStripe(3));
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransportTest::testRemovedSessionIsForgotten() {
+
+    DefaultTransportListener listener;
+
+    Pointer<StripedTransport> transport = createTransport(2);
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    Pointer<SessionInfo> info = createSessionInfo(1, cms::Session::AUTO_ACKNOWLEDGE);
+    transport->oneway(info);
+    CPPUNIT_ASSERT_EQUAL(0, transport->getSessionStripe(1));
+
+    Pointer<RemoveInfo> remove = info->createRemoveCommand();
+    transport->oneway(remove);
+    CPPUNIT_ASSERT_EQUAL(-1, transport->getSessionStripe(1));
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedTransportTest::testOnewayBeforeStartFails() {
+
+    Pointer<StripedTransport> transport = createTransport(2);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when not started",
+        transport->oneway(createSessionInfo(1, cms::Session::AUTO_ACKNOWLEDGE)),
+        IOException);
+}
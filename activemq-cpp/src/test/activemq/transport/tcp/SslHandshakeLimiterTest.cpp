@@ -0,0 +1,124 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SslHandshakeLimiterTest.h"
+
+#include <activemq/transport/tcp/SslHandshakeLimiter.h>
+
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+SslHandshakeLimiterTest::SslHandshakeLimiterTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SslHandshakeLimiterTest::~SslHandshakeLimiterTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiterTest::testConstructor() {
+
+    SslHandshakeLimiter limiter(3, 25);
+
+    CPPUNIT_ASSERT_EQUAL(3, limiter.getMaxConcurrent());
+    CPPUNIT_ASSERT_EQUAL(25, limiter.getStartInterval());
+    CPPUNIT_ASSERT_EQUAL(0, limiter.getActiveCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        SslHandshakeLimiter(0, 0),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        SslHandshakeLimiter(1, -1),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiterTest::testSharedInstance() {
+
+    SslHandshakeLimiter& limiter = SslHandshakeLimiter::getInstance();
+
+    CPPUNIT_ASSERT(limiter.getMaxConcurrent() > 0);
+    CPPUNIT_ASSERT(&limiter == &SslHandshakeLimiter::getInstance());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiterTest::testHandshakeNullSocketThrows() {
+
+    SslHandshakeLimiter limiter(1, 0);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        limiter.handshake(NULL, 0),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_EQUAL(0, limiter.getActiveCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiterTest::testConcurrencyLimit() {
+
+    SslHandshakeLimiter limiter(2, 0);
+
+    CPPUNIT_ASSERT(limiter.acquire(0));
+    CPPUNIT_ASSERT(limiter.acquire(0));
+    CPPUNIT_ASSERT_EQUAL(2, limiter.getActiveCount());
+
+    CPPUNIT_ASSERT_MESSAGE("A third turn should time out", !limiter.acquire(50));
+
+    limiter.release();
+    CPPUNIT_ASSERT_EQUAL(1, limiter.getActiveCount());
+
+    CPPUNIT_ASSERT(limiter.acquire(50));
+    CPPUNIT_ASSERT_EQUAL(2, limiter.getActiveCount());
+
+    limiter.release();
+    limiter.release();
+    CPPUNIT_ASSERT_EQUAL(0, limiter.getActiveCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SslHandshakeLimiterTest::testStartInterval() {
+
+    SslHandshakeLimiter limiter(4, 40);
+
+    long long start = System::currentTimeMillis();
+
+    for (int i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT(limiter.acquire(0));
+    }
+
+    long long elapsed = System::currentTimeMillis() - start;
+
+    for (int i = 0; i < 3; ++i) {
+        limiter.release();
+    }
+
+    // The first turn starts at once, the other two wait an interval each.
+    CPPUNIT_ASSERT_MESSAGE("Turns should have been spaced out", elapsed >= 75);
+}
@@ -0,0 +1,291 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TcpEventLoopTest.h"
+
+#include <activemq/transport/tcp/TcpEventLoop.h>
+
+#include <decaf/internal/net/tcp/TcpSocket.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/net/ServerSocket.h>
+#include <decaf/net/Socket.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::transport;
+using namespace activemq::transport::tcp;
+using namespace decaf;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::io;
+using namespace decaf::net;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CountingHandler : public TcpEventLoop::Handler {
+    private:
+
+        CountingHandler(const CountingHandler&);
+        CountingHandler& operator= (const CountingHandler&);
+
+    public:
+
+        TcpSocket* socket;
+        AtomicInteger bytes;
+        AtomicInteger calls;
+        AtomicBoolean closed;
+        Thread* volatile thread;
+
+        CountingHandler(TcpSocket* socket) :
+            TcpEventLoop::Handler(), socket(socket), bytes(), calls(), closed(), thread(NULL) {
+        }
+
+        virtual ~CountingHandler() {}
+
+        virtual bool onReadable() {
+
+            calls.incrementAndGet();
+            thread = Thread::currentThread();
+
+            unsigned char buffer[256];
+            while (true) {
+                int count = socket->read(buffer, sizeof(buffer), 0, sizeof(buffer));
+                if (count == 0) {
+                    return true;
+                } else if (count < 0) {
+                    closed.set(true);
+                    return false;
+                }
+
+                bytes.addAndGet(count);
+            }
+        }
+    };
+
+    TcpSocket* connect(ServerSocket& server) {
+        TcpSocket* socket = new TcpSocket();
+        socket->create();
+        socket->connect("127.0.0.1", server.getLocalPort(), 0);
+        socket->setNonBlocking(true);
+        return socket;
+    }
+
+    void writeTo(Socket* socket, int count) {
+        std::vector<unsigned char> data(count, 42);
+        socket->getOutputStream()->write(&data[0], count);
+        socket->getOutputStream()->flush();
+    }
+
+    bool waitForBytes(const CountingHandler& handler, int expected) {
+        long long deadline = System::currentTimeMillis() + 5000;
+        while (handler.bytes.get() < expected && System::currentTimeMillis() < deadline) {
+            Thread::sleep(10);
+        }
+        return handler.bytes.get() == expected;
+    }
+
+    bool waitForSocketCount(const TcpEventLoop& loop, int expected) {
+        long long deadline = System::currentTimeMillis() + 5000;
+        while (loop.getSocketCount() != expected && System::currentTimeMillis() < deadline) {
+            Thread::sleep(10);
+        }
+        return loop.getSocketCount() == expected;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoopTest::TcpEventLoopTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TcpEventLoopTest::~TcpEventLoopTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testConstructor() {
+
+    TcpEventLoop loop(3, 16);
+
+    CPPUNIT_ASSERT_EQUAL(3, loop.getLoopThreads());
+    CPPUNIT_ASSERT_EQUAL(0, loop.getSocketCount());
+    CPPUNIT_ASSERT_EQUAL(0, loop.getActiveLoopCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        TcpEventLoop(0, 16),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        TcpEventLoop(1, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testRegisterInvalidArgsThrows() {
+
+    TcpEventLoop loop(1, 16);
+    ServerSocket server(0);
+
+    Pointer<TcpSocket> socket(connect(server));
+    CountingHandler handler(socket.get());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        loop.registerSocket(NULL, &handler),
+        NullPointerException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        loop.registerSocket(socket.get(), NULL),
+        NullPointerException);
+
+    TcpSocket unconnected;
+    unconnected.create();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        loop.registerSocket(&unconnected, &handler),
+        IOException);
+    CPPUNIT_ASSERT_EQUAL(0, loop.getSocketCount());
+
+    CPPUNIT_ASSERT(!loop.unregisterSocket(socket.get()));
+
+    loop.registerSocket(socket.get(), &handler);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        loop.registerSocket(socket.get(), &handler),
+        IllegalStateException);
+
+    CPPUNIT_ASSERT(loop.unregisterSocket(socket.get()));
+    CPPUNIT_ASSERT(!loop.unregisterSocket(socket.get()));
+
+    loop.shutdown();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        loop.registerSocket(socket.get(), &handler),
+        IllegalStateException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testSharedInstance() {
+
+    TcpEventLoop& loop = TcpEventLoop::getInstance();
+    CPPUNIT_ASSERT(&loop == &TcpEventLoop::getInstance());
+    CPPUNIT_ASSERT_EQUAL(TcpEventLoop::DEFAULT_LOOP_THREADS, loop.getLoopThreads());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testSocketsShareLoopThreads() {
+
+    static const int COUNT = 8;
+
+    TcpEventLoop loop(1, 16);
+    ServerSocket server(0);
+
+    std::vector< Pointer<TcpSocket> > sockets;
+    std::vector< Pointer<Socket> > peers;
+    std::vector< Pointer<CountingHandler> > handlers;
+
+    for (int i = 0; i < COUNT; ++i) {
+        sockets.push_back(Pointer<TcpSocket>(connect(server)));
+        peers.push_back(Pointer<Socket>(server.accept()));
+        handlers.push_back(Pointer<CountingHandler>(new CountingHandler(sockets[i].get())));
+        loop.registerSocket(sockets[i].get(), handlers[i].get());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(COUNT, loop.getSocketCount());
+
+    for (int i = 0; i < COUNT; ++i) {
+        writeTo(peers[i].get(), 100 + i);
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        CPPUNIT_ASSERT(waitForBytes(*handlers[i], 100 + i));
+    }
+
+    // Every socket was read by the one loop thread.
+    CPPUNIT_ASSERT_EQUAL(1, loop.getActiveLoopCount());
+    for (int i = 1; i < COUNT; ++i) {
+        CPPUNIT_ASSERT(handlers[i]->thread == handlers[0]->thread);
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        CPPUNIT_ASSERT(loop.unregisterSocket(sockets[i].get()));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, loop.getSocketCount());
+    loop.shutdown();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testPeerCloseUnregisters() {
+
+    TcpEventLoop loop(2, 16);
+    ServerSocket server(0);
+
+    Pointer<TcpSocket> socket(connect(server));
+    Pointer<Socket> peer(server.accept());
+
+    CountingHandler handler(socket.get());
+    loop.registerSocket(socket.get(), &handler);
+    CPPUNIT_ASSERT_EQUAL(1, loop.getSocketCount());
+
+    writeTo(peer.get(), 10);
+    peer->close();
+
+    // The handler sees the end of the stream and asks to be removed.
+    CPPUNIT_ASSERT(waitForSocketCount(loop, 0));
+    CPPUNIT_ASSERT(handler.closed.get());
+    CPPUNIT_ASSERT_EQUAL(10, handler.bytes.get());
+    CPPUNIT_ASSERT(!loop.unregisterSocket(socket.get()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpEventLoopTest::testNoCallbacksAfterUnregister() {
+
+    TcpEventLoop loop(1, 16);
+    ServerSocket server(0);
+
+    Pointer<TcpSocket> socket(connect(server));
+    Pointer<Socket> peer(server.accept());
+
+    CountingHandler handler(socket.get());
+    loop.registerSocket(socket.get(), &handler);
+
+    writeTo(peer.get(), 50);
+    CPPUNIT_ASSERT(waitForBytes(handler, 50));
+
+    CPPUNIT_ASSERT(loop.unregisterSocket(socket.get()));
+    int calls = handler.calls.get();
+
+    writeTo(peer.get(), 50);
+    Thread::sleep(200);
+
+    CPPUNIT_ASSERT_EQUAL(calls, handler.calls.get());
+    CPPUNIT_ASSERT_EQUAL(50, handler.bytes.get());
+}
@@ -19,6 +19,10 @@
 
 #include <activemq/transport/tcp/TcpTransportFactory.h>
 #include <activemq/transport/tcp/TcpTransport.h>
+#include <activemq/transport/IOTransport.h>
+#include <activemq/transport/logging/LoggingTransport.h>
+#include <activemq/transport/DefaultTransportListener.h>
+#include <activemq/commands/ProducerInfo.h>
 
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
 
@@ -29,7 +33,16 @@
 #include <decaf/net/ServerSocket.h>
 #include <decaf/io/InputStream.h>
 #include <decaf/io/OutputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/util/Random.h>
+#include <decaf/util/zip/DeflaterOutputStream.h>
+#include <decaf/util/zip/InflaterInputStream.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+
+#include <cstdio>
+#include <vector>
 
 using namespace decaf;
 using namespace decaf::lang;
@@ -37,11 +50,15 @@ using namespace decaf::net;
 using namespace decaf::io;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::util::zip;
 using namespace activemq;
+using namespace activemq::commands;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
 using namespace activemq::transport;
 using namespace activemq::transport::tcp;
+using namespace activemq::transport::logging;
 
 ////////////////////////////////////////////////////////////////////////////////
 TcpTransportTest::TcpTransportTest() {
@@ -139,6 +156,54 @@ namespace {
     };
 
     TestServer* server;
+
+    class RecordingListener : public DefaultTransportListener {
+    public:
+
+        Mutex mutex;
+        std::vector<int> commandIds;
+        AtomicInteger exceptions;
+        Thread* volatile thread;
+
+        RecordingListener() : mutex(), commandIds(), exceptions(), thread(NULL) {}
+
+        virtual ~RecordingListener() {}
+
+        virtual void onCommand(const Pointer<Command> command) {
+            thread = Thread::currentThread();
+            synchronized(&mutex) {
+                commandIds.push_back(command->getCommandId());
+            }
+        }
+
+        virtual void onException(const decaf::lang::Exception& ex AMQCPP_UNUSED) {
+            exceptions.incrementAndGet();
+        }
+
+        int size() {
+            int result = 0;
+            synchronized(&mutex) {
+                result = (int) commandIds.size();
+            }
+            return result;
+        }
+    };
+
+    Pointer<OpenWireFormat> createWireFormat() {
+        Properties properties;
+        Pointer<OpenWireFormat> wireFormat(new OpenWireFormat(properties));
+        wireFormat->setCacheEnabled(false);
+        return wireFormat;
+    }
+
+    bool waitFor(RecordingListener& listener, int commands, int exceptions) {
+        long long deadline = System::currentTimeMillis() + 5000;
+        while ((listener.size() < commands || listener.exceptions.get() < exceptions) &&
+               System::currentTimeMillis() < deadline) {
+            Thread::sleep(10);
+        }
+        return listener.size() >= commands && listener.exceptions.get() >= exceptions;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -192,3 +257,246 @@ void TcpTransportTest::testTransportCreateWithRadomFailures() {
         } catch (Exception& ex) {}
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testEventLoopOption() {
+
+    TcpTransportFactory factory;
+    int port = server->getLocalPort();
+
+    Pointer<Transport> transport = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port)));
+    TcpTransport* tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcp != NULL);
+    CPPUNIT_ASSERT(!tcp->isEventLoop());
+
+    transport = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port) + "?transport.eventLoop=true"));
+    tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcp->isEventLoop());
+
+    transport = factory.createComposite(URI("nio://localhost:" + Integer::toString(port)));
+    tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcp->isEventLoop());
+
+    transport = factory.createComposite(URI("nio://localhost:" + Integer::toString(port) + "?transport.eventLoop=false"));
+    tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(!tcp->isEventLoop());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testLatencyOptions() {
+
+    TcpTransportFactory factory;
+    int port = server->getLocalPort();
+
+    Pointer<Transport> transport = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port)));
+    TcpTransport* tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcp != NULL);
+    CPPUNIT_ASSERT_EQUAL(-1, tcp->getBusyPoll());
+    CPPUNIT_ASSERT(!tcp->isTcpQuickAck());
+    CPPUNIT_ASSERT_EQUAL(-1, tcp->getTcpNotSentLowWater());
+    CPPUNIT_ASSERT_EQUAL(-1, tcp->getMaxPacingRate());
+    CPPUNIT_ASSERT_EQUAL(-1, tcp->getTcpUserTimeout());
+
+    transport = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port) +
+        "?soBusyPoll=50&tcpQuickAck=true&tcpNotSentLowWater=16384&soMaxPacingRate=1000000&tcpUserTimeout=5000"));
+    tcp = dynamic_cast<TcpTransport*>(transport->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT_EQUAL(50, tcp->getBusyPoll());
+    CPPUNIT_ASSERT(tcp->isTcpQuickAck());
+    CPPUNIT_ASSERT_EQUAL(16384, tcp->getTcpNotSentLowWater());
+    CPPUNIT_ASSERT_EQUAL(1000000, tcp->getMaxPacingRate());
+    CPPUNIT_ASSERT_EQUAL(5000, tcp->getTcpUserTimeout());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testEventLoopReadsFrames() {
+
+    static const int COUNT = 50;
+
+    ServerSocket peerServer(0);
+
+    Pointer<IOTransport> ioTransport(new IOTransport(createWireFormat()));
+    Pointer<TcpTransport> transport(
+        new TcpTransport(ioTransport, URI("tcp://127.0.0.1:" + Integer::toString(peerServer.getLocalPort()))));
+    transport->setEventLoop(true);
+
+    RecordingListener listener;
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    Pointer<Socket> peer(peerServer.accept());
+    CPPUNIT_ASSERT(ioTransport->isEventDriven());
+
+    Pointer<OpenWireFormat> peerWireFormat = createWireFormat();
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    for (int i = 0; i < COUNT; ++i) {
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId(i == COUNT / 2 ? std::string(60000, 'x') : "ID:test-connection");
+        producerId->setValue(i);
+
+        Pointer<ProducerInfo> info(new ProducerInfo());
+        info->setProducerId(producerId);
+        info->setCommandId(i);
+        peerWireFormat->marshal(info, ioTransport.get(), &dataOut);
+    }
+
+    // Write in small pieces so that frames arrive split across reads, one of them
+    // larger than the transport's input buffer.
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    OutputStream* peerOut = peer->getOutputStream();
+    for (int offset = 0; offset < array.second; offset += 1000) {
+        peerOut->write(array.first, array.second, offset, std::min(1000, array.second - offset));
+        peerOut->flush();
+    }
+    delete [] array.first;
+
+    CPPUNIT_ASSERT(waitFor(listener, COUNT, 0));
+    CPPUNIT_ASSERT_EQUAL(0, listener.exceptions.get());
+
+    synchronized(&listener.mutex) {
+        for (int i = 0; i < COUNT; ++i) {
+            CPPUNIT_ASSERT_EQUAL(i, listener.commandIds[i]);
+        }
+    }
+
+    // Delivered from the event loop rather than a reader thread of its own.
+    CPPUNIT_ASSERT(Thread::currentThread()->getName() != listener.thread->getName());
+    CPPUNIT_ASSERT(listener.thread->getName().find("TcpEventLoop") != std::string::npos);
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testEventLoopReportsPeerClose() {
+
+    ServerSocket peerServer(0);
+
+    Pointer<IOTransport> ioTransport(new IOTransport(createWireFormat()));
+    Pointer<TcpTransport> transport(
+        new TcpTransport(ioTransport, URI("tcp://127.0.0.1:" + Integer::toString(peerServer.getLocalPort()))));
+    transport->setEventLoop(true);
+
+    RecordingListener listener;
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    Pointer<Socket> peer(peerServer.accept());
+    peer->close();
+
+    CPPUNIT_ASSERT(waitFor(listener, 0, 1));
+
+    transport->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testFrameCaptureOption() {
+
+    const std::string path = "TcpTransportTest.capture";
+
+    TcpTransportFactory factory;
+    std::string uri = "tcp://localhost:" + Integer::toString(server->getLocalPort());
+
+    Pointer<Transport> transport = factory.createComposite(URI(uri + "?transport.trace=true"));
+    LoggingTransport* logging = dynamic_cast<LoggingTransport*>(transport->narrow(typeid(LoggingTransport)));
+    CPPUNIT_ASSERT(logging != NULL);
+    CPPUNIT_ASSERT(logging->getFrameCapture() == NULL);
+
+    transport = factory.createComposite(URI(uri + "?transport.captureFile=" + path +
+                                                  "&transport.captureFileSize=65536&transport.captureFileCount=1"));
+    logging = dynamic_cast<LoggingTransport*>(transport->narrow(typeid(LoggingTransport)));
+    CPPUNIT_ASSERT(logging != NULL);
+
+    Pointer<FrameCaptureFile> capture = logging->getFrameCapture();
+    CPPUNIT_ASSERT(capture != NULL);
+    CPPUNIT_ASSERT_EQUAL(path, capture->getPath());
+    CPPUNIT_ASSERT_EQUAL(65536LL, capture->getFileSize());
+    CPPUNIT_ASSERT_EQUAL(1, capture->getFileCount());
+
+    IOTransport* io = dynamic_cast<IOTransport*>(transport->narrow(typeid(IOTransport)));
+    CPPUNIT_ASSERT(io != NULL);
+    CPPUNIT_ASSERT(io->getFrameCapture() == capture);
+
+    capture.reset(NULL);
+    transport.reset(NULL);
+    std::remove(FrameCaptureFile::getFileName(path, 0).c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TcpTransportTest::testStreamCompression() {
+
+    static const int COUNT = 20;
+
+    TcpTransportFactory factory;
+    int port = server->getLocalPort();
+
+    Pointer<Transport> created = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port)));
+    TcpTransport* tcp = dynamic_cast<TcpTransport*>(created->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(!tcp->isStreamCompression());
+    CPPUNIT_ASSERT_EQUAL(-1, tcp->getStreamCompressionLevel());
+
+    created = factory.createComposite(URI("tcp://localhost:" + Integer::toString(port) +
+        "?transport.streamCompression=true&transport.streamCompressionLevel=1"));
+    tcp = dynamic_cast<TcpTransport*>(created->narrow(typeid(TcpTransport)));
+    CPPUNIT_ASSERT(tcp->isStreamCompression());
+    CPPUNIT_ASSERT_EQUAL(1, tcp->getStreamCompressionLevel());
+
+    ServerSocket peerServer(0);
+
+    Pointer<IOTransport> ioTransport(new IOTransport(createWireFormat()));
+    Pointer<TcpTransport> transport(
+        new TcpTransport(ioTransport, URI("tcp://127.0.0.1:" + Integer::toString(peerServer.getLocalPort()))));
+    transport->setStreamCompression(true);
+    transport->setEventLoop(true);
+
+    RecordingListener listener;
+    transport->setTransportListener(&listener);
+    transport->start();
+
+    Pointer<Socket> peer(peerServer.accept());
+
+    // The event loop reads raw frames, a compressed stream is read by a thread.
+    CPPUNIT_ASSERT(!ioTransport->isEventDriven());
+
+    Pointer<OpenWireFormat> peerWireFormat = createWireFormat();
+    DeflaterOutputStream peerDeflater(peer->getOutputStream(), new Deflater(), 512, false, true, true);
+    DataOutputStream peerOut(&peerDeflater);
+
+    for (int i = 0; i < COUNT; ++i) {
+        Pointer<ProducerId> producerId(new ProducerId());
+        producerId->setConnectionId("ID:test-connection");
+        producerId->setValue(i);
+
+        Pointer<ProducerInfo> info(new ProducerInfo());
+        info->setProducerId(producerId);
+        info->setCommandId(i);
+        peerWireFormat->marshal(info, ioTransport.get(), &peerOut);
+        peerOut.flush();
+    }
+
+    CPPUNIT_ASSERT(waitFor(listener, COUNT, 0));
+    CPPUNIT_ASSERT_EQUAL(0, listener.exceptions.get());
+
+    synchronized(&listener.mutex) {
+        for (int i = 0; i < COUNT; ++i) {
+            CPPUNIT_ASSERT_EQUAL(i, listener.commandIds[i]);
+        }
+    }
+
+    // And the other way, what the transport writes inflates back into its command.
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setValue(COUNT);
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setCommandId(COUNT);
+    transport->oneway(info);
+
+    InflaterInputStream peerInflater(peer->getInputStream());
+    DataInputStream peerIn(&peerInflater);
+    Pointer<Command> received = peerWireFormat->unmarshal(ioTransport.get(), &peerIn);
+    CPPUNIT_ASSERT(received->isProducerInfo());
+    CPPUNIT_ASSERT_EQUAL(COUNT, received->getCommandId());
+
+    transport->close();
+}
@@ -30,6 +30,12 @@ namespace tcp {
 
         CPPUNIT_TEST_SUITE( TcpTransportTest );
         CPPUNIT_TEST( testTransportCreateWithRadomFailures );
+        CPPUNIT_TEST( testEventLoopOption );
+        CPPUNIT_TEST( testLatencyOptions );
+        CPPUNIT_TEST( testEventLoopReadsFrames );
+        CPPUNIT_TEST( testEventLoopReportsPeerClose );
+        CPPUNIT_TEST( testFrameCaptureOption );
+        CPPUNIT_TEST( testStreamCompression );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -41,6 +47,12 @@ namespace tcp {
         virtual void tearDown();
 
         void testTransportCreateWithRadomFailures();
+        void testEventLoopOption();
+        void testLatencyOptions();
+        void testEventLoopReadsFrames();
+        void testEventLoopReportsPeerClose();
+        void testFrameCaptureOption();
+        void testStreamCompression();
 
     };
 
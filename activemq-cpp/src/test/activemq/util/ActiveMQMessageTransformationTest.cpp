@@ -22,6 +22,7 @@
 #include <activemq/commands/ActiveMQQueue.h>
 #include <activemq/util/ActiveMQProperties.h>
 #include <activemq/util/ActiveMQMessageTransformation.h>
+#include <activemq/util/NativeDestinationProvider.h>
 
 #include <cms/Destination.h>
 #include <cms/Destination.h>
@@ -82,6 +83,22 @@ namespace {
 
     };
 
+    class WrappedCmsTopic : public CustomCmsTopic, public NativeDestinationProvider {
+    private:
+
+        ActiveMQTopic topic;
+
+    public:
+
+        WrappedCmsTopic() : CustomCmsTopic(), NativeDestinationProvider(), topic("TEST-WRAPPED-TOPIC") {
+        }
+
+        virtual const ActiveMQDestination* getNativeDestination() const {
+            return &topic;
+        }
+
+    };
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,3 +149,15 @@ void ActiveMQMessageTransformationTest::testTransformDestination() {
     CPPUNIT_ASSERT(!transformed->isTopic());
     CPPUNIT_ASSERT(transformed->isQueue());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ActiveMQMessageTransformationTest::testTransformNativeDestination() {
+
+    WrappedCmsTopic wrappedTopic;
+    const ActiveMQDestination* transformed = NULL;
+
+    // The wrapped destination is handed over rather than rebuilt from the name.
+    CPPUNIT_ASSERT(!ActiveMQMessageTransformation::transformDestination(&wrappedTopic, &transformed));
+    CPPUNIT_ASSERT(transformed == wrappedTopic.getNativeDestination());
+    CPPUNIT_ASSERT_EQUAL(std::string("TEST-WRAPPED-TOPIC"), transformed->getPhysicalName());
+}
@@ -29,6 +29,7 @@ namespace util {
 
         CPPUNIT_TEST_SUITE( ActiveMQMessageTransformationTest );
         CPPUNIT_TEST( testTransformDestination );
+        CPPUNIT_TEST( testTransformNativeDestination );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +38,7 @@ namespace util {
         virtual ~ActiveMQMessageTransformationTest();
 
         void testTransformDestination();
+        void testTransformNativeDestination();
     };
 
 }}
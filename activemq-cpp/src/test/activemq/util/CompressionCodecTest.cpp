@@ -0,0 +1,284 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionCodecTest.h"
+#include <activemq/util/CompressionCodec.h>
+#include <activemq/util/BlockCompressionCodec.h>
+
+#include <decaf/io/InputStream.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/zip/DataFormatException.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> createInput(int size) {
+        std::vector<unsigned char> input(size);
+        for (int i = 0; i < size; ++i) {
+            input[i] = (unsigned char) ((i % 61) + (i / 1000));
+        }
+        return input;
+    }
+
+    void doTestRoundTrip(const std::string& name, const std::vector<unsigned char>& dictionary) {
+
+        std::auto_ptr<CompressionCodec> codec(CompressionCodec::create(name, dictionary));
+        CPPUNIT_ASSERT_EQUAL(name, codec->getName());
+
+        std::vector<unsigned char> input = createInput(100000);
+        std::string prefix = "compressed as one unit ";
+
+        const unsigned char* buffers[2] = { (const unsigned char*) prefix.data(), &input[0] };
+        int lengths[2] = { (int) prefix.size(), (int) input.size() };
+
+        // Output is appended after whatever the vector already holds.
+        std::vector<unsigned char> compressed(3, 0xFF);
+        codec->compress(-1, buffers, lengths, 2, compressed);
+        CPPUNIT_ASSERT(compressed.size() > 3);
+        CPPUNIT_ASSERT(compressed.size() < input.size());
+
+        std::vector<unsigned char> expected(prefix.begin(), prefix.end());
+        expected.insert(expected.end(), input.begin(), input.end());
+
+        std::vector<unsigned char> output;
+        codec->decompress(&compressed[3], (int) compressed.size() - 3, output, (int) expected.size());
+        CPPUNIT_ASSERT(expected == output);
+
+        // Every level must produce data the codec can read back.
+        for (int level = 0; level <= 9; ++level) {
+            std::vector<unsigned char> packed;
+            codec->compress(level, buffers, lengths, 2, packed);
+
+            std::vector<unsigned char> unpacked;
+            codec->decompress(&packed[0], (int) packed.size(), unpacked);
+            CPPUNIT_ASSERT(expected == unpacked);
+        }
+
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw an IllegalArgumentException",
+            codec->compress(10, buffers, lengths, 2, compressed),
+            IllegalArgumentException);
+
+        std::vector<unsigned char> truncated;
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw a DataFormatException",
+            codec->decompress(&compressed[3], (int) (compressed.size() - 3) / 2, truncated),
+            DataFormatException);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testKnownCodecs() {
+
+    CPPUNIT_ASSERT(CompressionCodec::isKnown(CompressionCodec::ZLIB));
+    CPPUNIT_ASSERT(CompressionCodec::isKnown(CompressionCodec::LZ4));
+    CPPUNIT_ASSERT(CompressionCodec::isKnown(CompressionCodec::ZSTD));
+    CPPUNIT_ASSERT(!CompressionCodec::isKnown("snappy"));
+
+    // zlib is always built in.
+    CPPUNIT_ASSERT(CompressionCodec::isSupported(CompressionCodec::ZLIB));
+    CPPUNIT_ASSERT(!CompressionCodec::isSupported("snappy"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testCreateUnknown() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        CompressionCodec::create("snappy"),
+        IllegalArgumentException);
+
+    if (!CompressionCodec::isSupported(CompressionCodec::LZ4)) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw an UnsupportedOperationException",
+            CompressionCodec::create(CompressionCodec::LZ4),
+            UnsupportedOperationException);
+    }
+
+    if (!CompressionCodec::isSupported(CompressionCodec::ZSTD)) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should throw an UnsupportedOperationException",
+            CompressionCodec::create(CompressionCodec::ZSTD),
+            UnsupportedOperationException);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testZlibRoundTrip() {
+    doTestRoundTrip(CompressionCodec::ZLIB, std::vector<unsigned char>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testLz4RoundTrip() {
+    if (CompressionCodec::isSupported(CompressionCodec::LZ4)) {
+        doTestRoundTrip(CompressionCodec::LZ4, std::vector<unsigned char>());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testZstdRoundTrip() {
+    if (CompressionCodec::isSupported(CompressionCodec::ZSTD)) {
+        doTestRoundTrip(CompressionCodec::ZSTD, std::vector<unsigned char>());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testDictionaryRoundTrip() {
+
+    std::vector<unsigned char> dictionary = createInput(4096);
+
+    if (CompressionCodec::isSupported(CompressionCodec::LZ4)) {
+        doTestRoundTrip(CompressionCodec::LZ4, dictionary);
+    }
+
+    if (CompressionCodec::isSupported(CompressionCodec::ZSTD)) {
+        doTestRoundTrip(CompressionCodec::ZSTD, dictionary);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testBlockCodecNames() {
+
+    std::string name = BlockCompressionCodec::toBlockCodecName(CompressionCodec::ZLIB);
+    CPPUNIT_ASSERT_EQUAL(std::string("zlib+blocks"), name);
+    CPPUNIT_ASSERT(BlockCompressionCodec::isBlockCodecName(name));
+    CPPUNIT_ASSERT(!BlockCompressionCodec::isBlockCodecName(CompressionCodec::ZLIB));
+    CPPUNIT_ASSERT(!BlockCompressionCodec::isBlockCodecName(BlockCompressionCodec::SUFFIX));
+    CPPUNIT_ASSERT_EQUAL(CompressionCodec::ZLIB, BlockCompressionCodec::toWrappedCodecName(name));
+
+    CPPUNIT_ASSERT(CompressionCodec::isKnown(name));
+    CPPUNIT_ASSERT(CompressionCodec::isSupported(name));
+    CPPUNIT_ASSERT(!CompressionCodec::isKnown("snappy+blocks"));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        BlockCompressionCodec(CompressionCodec::create(CompressionCodec::ZLIB), 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testBlockRoundTrip() {
+
+    doTestRoundTrip(BlockCompressionCodec::toBlockCodecName(CompressionCodec::ZLIB), std::vector<unsigned char>());
+
+    // Blocks smaller than the input, with block boundaries falling inside both buffers.
+    BlockCompressionCodec codec(CompressionCodec::create(CompressionCodec::ZLIB), 7000);
+
+    std::vector<unsigned char> input = createInput(100000);
+    std::string prefix = "spans the first block boundary ";
+
+    const unsigned char* buffers[2] = { (const unsigned char*) prefix.data(), &input[0] };
+    int lengths[2] = { (int) prefix.size(), (int) input.size() };
+
+    std::vector<unsigned char> compressed;
+    codec.compress(-1, buffers, lengths, 2, compressed);
+
+    int total = (int) (prefix.size() + input.size());
+    int blocks = (compressed[0] << 24) | (compressed[1] << 16) | (compressed[2] << 8) | compressed[3];
+    CPPUNIT_ASSERT_EQUAL((total + 6999) / 7000, blocks);
+
+    std::vector<unsigned char> expected(prefix.begin(), prefix.end());
+    expected.insert(expected.end(), input.begin(), input.end());
+
+    // Any block size decompresses, the sizes are recorded in the data.
+    std::auto_ptr<CompressionCodec> reader(
+        CompressionCodec::create(BlockCompressionCodec::toBlockCodecName(CompressionCodec::ZLIB)));
+
+    std::vector<unsigned char> output(2, 0xFF);
+    reader->decompress(&compressed[0], (int) compressed.size(), output, total);
+    CPPUNIT_ASSERT_EQUAL(total + 2, (int) output.size());
+    CPPUNIT_ASSERT(std::equal(expected.begin(), expected.end(), output.begin() + 2));
+
+    std::vector<unsigned char> wrongSize;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a DataFormatException",
+        reader->decompress(&compressed[0], (int) compressed.size(), wrongSize, total + 1),
+        DataFormatException);
+
+    // Damage the last block, the output must be left as it was.
+    std::vector<unsigned char> damaged(compressed);
+    for (std::size_t i = damaged.size() - 16; i < damaged.size(); ++i) {
+        damaged[i] ^= 0x5A;
+    }
+
+    std::vector<unsigned char> unchanged(1, 0x01);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a DataFormatException",
+        reader->decompress(&damaged[0], (int) damaged.size(), unchanged),
+        DataFormatException);
+    CPPUNIT_ASSERT_EQUAL(1, (int) unchanged.size());
+
+    std::vector<unsigned char> empty;
+    codec.compress(-1, NULL, NULL, 0, empty);
+    CPPUNIT_ASSERT_EQUAL(4, (int) empty.size());
+
+    std::vector<unsigned char> none;
+    reader->decompress(&empty[0], (int) empty.size(), none);
+    CPPUNIT_ASSERT(none.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionCodecTest::testBlockInputStream() {
+
+    BlockCompressionCodec codec(CompressionCodec::create(CompressionCodec::ZLIB), 7000);
+
+    std::vector<unsigned char> input = createInput(100000);
+    const unsigned char* buffers[1] = { &input[0] };
+    int lengths[1] = { (int) input.size() };
+
+    std::vector<unsigned char> compressed;
+    codec.compress(-1, buffers, lengths, 1, compressed);
+
+    std::auto_ptr<decaf::io::InputStream> stream(
+        codec.createInputStream(&compressed[0], (int) compressed.size(), (int) input.size()));
+
+    // Single bytes and reads that cross block boundaries.
+    std::vector<unsigned char> output;
+    output.push_back((unsigned char) stream->read());
+    CPPUNIT_ASSERT(stream->available() <= 7000);
+
+    unsigned char chunk[4096];
+    int count = 0;
+    while ((count = stream->read(chunk, (int) sizeof(chunk))) != -1) {
+        output.insert(output.end(), chunk, chunk + count);
+        CPPUNIT_ASSERT(stream->available() <= 7000);
+    }
+
+    CPPUNIT_ASSERT(input == output);
+    CPPUNIT_ASSERT_EQUAL(-1, stream->read());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a DataFormatException",
+        delete codec.createInputStream(&compressed[0], (int) compressed.size(), (int) input.size() + 1),
+        DataFormatException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a DataFormatException",
+        delete codec.createInputStream(&compressed[0], 10, 0),
+        DataFormatException);
+}
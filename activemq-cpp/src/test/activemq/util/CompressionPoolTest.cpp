@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CompressionPoolTest.h"
+#include <activemq/util/CompressionPool.h>
+
+#include <decaf/util/zip/Deflater.h>
+#include <decaf/util/zip/Inflater.h>
+#include <decaf/util/zip/DataFormatException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <string>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::util::zip;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> createInput(int size) {
+        std::vector<unsigned char> input(size);
+        for (int i = 0; i < size; ++i) {
+            input[i] = (unsigned char) ((i % 61) + (i / 1000));
+        }
+        return input;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPoolTest::testCompressDecompress() {
+
+    CompressionPool pool;
+
+    std::vector<unsigned char> input = createInput(200000);
+    const unsigned char* buffers[1] = { &input[0] };
+    int lengths[1] = { (int) input.size() };
+
+    std::vector<unsigned char> compressed;
+    pool.compress(Deflater::BEST_SPEED, buffers, lengths, 1, compressed);
+    CPPUNIT_ASSERT(!compressed.empty());
+    CPPUNIT_ASSERT(compressed.size() < input.size());
+
+    std::vector<unsigned char> output;
+    pool.decompress(&compressed[0], (int) compressed.size(), output);
+    CPPUNIT_ASSERT(input == output);
+
+    // Sizing the output up front must give the same result.
+    std::vector<unsigned char> sized;
+    pool.decompress(&compressed[0], (int) compressed.size(), sized, (int) input.size());
+    CPPUNIT_ASSERT(input == sized);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPoolTest::testCompressMultipleArrays() {
+
+    CompressionPool pool;
+
+    std::string first = "Hello ";
+    std::string second = "";
+    std::string third = "World";
+
+    const unsigned char* buffers[3] = { (const unsigned char*) first.data(),
+                                        (const unsigned char*) second.data(),
+                                        (const unsigned char*) third.data() };
+    int lengths[3] = { (int) first.length(), (int) second.length(), (int) third.length() };
+
+    // Compressed output is appended after whatever the vector already holds.
+    std::vector<unsigned char> compressed(2, 0xFF);
+    pool.compress(Deflater::DEFAULT_COMPRESSION, buffers, lengths, 3, compressed);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 0xFF, compressed[0]);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 0xFF, compressed[1]);
+
+    std::vector<unsigned char> output;
+    pool.decompress(&compressed[2], (int) compressed.size() - 2, output);
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), std::string(output.begin(), output.end()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPoolTest::testContextsAreReused() {
+
+    CompressionPool pool;
+
+    CPPUNIT_ASSERT_EQUAL(0, pool.getIdleDeflaters());
+    CPPUNIT_ASSERT_EQUAL(0, pool.getIdleInflaters());
+
+    std::vector<unsigned char> input = createInput(5000);
+    const unsigned char* buffers[1] = { &input[0] };
+    int lengths[1] = { (int) input.size() };
+
+    for (int i = 0; i < 10; ++i) {
+
+        std::vector<unsigned char> compressed;
+        pool.compress(i % 10, buffers, lengths, 1, compressed);
+        CPPUNIT_ASSERT_EQUAL(1, pool.getIdleDeflaters());
+
+        std::vector<unsigned char> output;
+        pool.decompress(&compressed[0], (int) compressed.size(), output);
+        CPPUNIT_ASSERT_EQUAL(1, pool.getIdleInflaters());
+
+        CPPUNIT_ASSERT(input == output);
+    }
+
+    Deflater* deflater = pool.takeDeflater(Deflater::BEST_COMPRESSION);
+    CPPUNIT_ASSERT(deflater != NULL);
+    CPPUNIT_ASSERT_EQUAL(0, pool.getIdleDeflaters());
+    pool.returnDeflater(deflater);
+    CPPUNIT_ASSERT_EQUAL(1, pool.getIdleDeflaters());
+
+    // An ended context can't be reset so it isn't kept.
+    Inflater* inflater = pool.takeInflater();
+    inflater->end();
+    pool.returnInflater(inflater);
+    CPPUNIT_ASSERT_EQUAL(0, pool.getIdleInflaters());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        pool.takeDeflater(42),
+        decaf::lang::exceptions::IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPoolTest::testMaxIdle() {
+
+    CompressionPool pool(2);
+    CPPUNIT_ASSERT_EQUAL(2, pool.getMaxIdle());
+
+    std::vector<Deflater*> deflaters;
+    std::vector<Inflater*> inflaters;
+
+    for (int i = 0; i < 4; ++i) {
+        deflaters.push_back(pool.takeDeflater(Deflater::DEFAULT_COMPRESSION));
+        inflaters.push_back(pool.takeInflater());
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        pool.returnDeflater(deflaters[i]);
+        pool.returnInflater(inflaters[i]);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(2, pool.getIdleDeflaters());
+    CPPUNIT_ASSERT_EQUAL(2, pool.getIdleInflaters());
+
+    CompressionPool disabled(0);
+    std::string text = "Not pooled";
+    const unsigned char* buffers[1] = { (const unsigned char*) text.data() };
+    int lengths[1] = { (int) text.length() };
+
+    std::vector<unsigned char> compressed;
+    disabled.compress(Deflater::DEFAULT_COMPRESSION, buffers, lengths, 1, compressed);
+    CPPUNIT_ASSERT_EQUAL(0, disabled.getIdleDeflaters());
+
+    std::vector<unsigned char> output;
+    disabled.decompress(&compressed[0], (int) compressed.size(), output);
+    CPPUNIT_ASSERT_EQUAL(0, disabled.getIdleInflaters());
+    CPPUNIT_ASSERT_EQUAL(text, std::string(output.begin(), output.end()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CompressionPoolTest::testTruncatedInput() {
+
+    CompressionPool pool;
+
+    std::vector<unsigned char> input = createInput(10000);
+    const unsigned char* buffers[1] = { &input[0] };
+    int lengths[1] = { (int) input.size() };
+
+    std::vector<unsigned char> compressed;
+    pool.compress(Deflater::DEFAULT_COMPRESSION, buffers, lengths, 1, compressed);
+
+    std::vector<unsigned char> output;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a DataFormatException",
+        pool.decompress(&compressed[0], (int) compressed.size() / 2, output),
+        DataFormatException);
+
+    // The context used for the failed stream is still good for the next one.
+    output.clear();
+    pool.decompress(&compressed[0], (int) compressed.size(), output);
+    CPPUNIT_ASSERT(input == output);
+}
@@ -0,0 +1,219 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CopyOnWriteBytesTest.h"
+#include <activemq/util/CopyOnWriteBytes.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::util;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::vector<unsigned char> createBytes(int count) {
+        std::vector<unsigned char> bytes;
+        for (int i = 0; i < count; ++i) {
+            bytes.push_back((unsigned char) i);
+        }
+        return bytes;
+    }
+
+    class CountingReleaser : public CopyOnWriteBytes::Releaser {
+    public:
+
+        int released;
+        const unsigned char* bytes;
+        std::size_t length;
+
+        CountingReleaser() : released(0), bytes(NULL), length(0) {}
+
+        virtual ~CountingReleaser() {}
+
+        virtual void release(const unsigned char* bytes, std::size_t length) {
+            this->released++;
+            this->bytes = bytes;
+            this->length = length;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testEmpty() {
+
+    CopyOnWriteBytes bytes;
+
+    CPPUNIT_ASSERT(bytes.isEmpty());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 0, bytes.size());
+    CPPUNIT_ASSERT(bytes.get().empty());
+    CPPUNIT_ASSERT(!bytes.isShared());
+
+    CopyOnWriteBytes copy(bytes);
+    CPPUNIT_ASSERT(!copy.isShared());
+
+    bytes.edit().push_back(1);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 1, bytes.size());
+    CPPUNIT_ASSERT(copy.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testCopySharesBytes() {
+
+    CopyOnWriteBytes bytes(createBytes(64));
+    CPPUNIT_ASSERT(!bytes.isShared());
+
+    CopyOnWriteBytes copy(bytes);
+    CPPUNIT_ASSERT(bytes.isShared());
+    CPPUNIT_ASSERT(copy.isShared());
+    CPPUNIT_ASSERT(&bytes.get() == &copy.get());
+
+    CopyOnWriteBytes assigned;
+    assigned = copy;
+    CPPUNIT_ASSERT(&bytes.get() == &assigned.get());
+
+    {
+        CopyOnWriteBytes scoped(bytes);
+    }
+
+    copy = CopyOnWriteBytes();
+    assigned = CopyOnWriteBytes();
+    CPPUNIT_ASSERT(!bytes.isShared());
+    CPPUNIT_ASSERT(createBytes(64) == bytes.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testEditCopiesSharedBytes() {
+
+    CopyOnWriteBytes bytes(createBytes(16));
+    CopyOnWriteBytes copy(bytes);
+
+    const std::vector<unsigned char>* shared = &bytes.get();
+
+    copy.edit()[0] = 99;
+
+    CPPUNIT_ASSERT(!bytes.isShared());
+    CPPUNIT_ASSERT(!copy.isShared());
+    CPPUNIT_ASSERT(shared == &bytes.get());
+    CPPUNIT_ASSERT_EQUAL(0, (int) bytes.get()[0]);
+    CPPUNIT_ASSERT_EQUAL(99, (int) copy.get()[0]);
+
+    // Bytes held by one buffer only are modified in place.
+    const std::vector<unsigned char>* owned = &copy.get();
+    copy.edit().push_back(100);
+    CPPUNIT_ASSERT(owned == &copy.get());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 17, copy.size());
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 16, bytes.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testAssign() {
+
+    CopyOnWriteBytes bytes(createBytes(8));
+    CopyOnWriteBytes copy(bytes);
+
+    copy = createBytes(4);
+    CPPUNIT_ASSERT(!bytes.isShared());
+    CPPUNIT_ASSERT(createBytes(8) == bytes.get());
+    CPPUNIT_ASSERT(createBytes(4) == copy.get());
+
+    const std::vector<unsigned char>* owned = &copy.get();
+    copy = createBytes(6);
+    CPPUNIT_ASSERT(owned == &copy.get());
+    CPPUNIT_ASSERT(createBytes(6) == copy.get());
+
+    copy = copy.get();
+    CPPUNIT_ASSERT(createBytes(6) == copy.get());
+
+    copy = std::vector<unsigned char>();
+    CPPUNIT_ASSERT(copy.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testClear() {
+
+    CopyOnWriteBytes bytes(createBytes(8));
+    CopyOnWriteBytes copy(bytes);
+
+    copy.clear();
+    CPPUNIT_ASSERT(copy.isEmpty());
+    CPPUNIT_ASSERT(!bytes.isShared());
+    CPPUNIT_ASSERT(createBytes(8) == bytes.get());
+
+    bytes.clear();
+    CPPUNIT_ASSERT(bytes.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testAttach() {
+
+    std::vector<unsigned char> external = createBytes(32);
+    CountingReleaser releaser;
+
+    {
+        CopyOnWriteBytes bytes;
+        bytes.attach(&external[0], external.size(), &releaser);
+
+        CPPUNIT_ASSERT(bytes.isAttached());
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 32, bytes.size());
+        CPPUNIT_ASSERT(bytes.data() == &external[0]);
+
+        CopyOnWriteBytes copy(bytes);
+        CPPUNIT_ASSERT(copy.isAttached());
+        CPPUNIT_ASSERT(copy.data() == &external[0]);
+
+        bytes.clear();
+        CPPUNIT_ASSERT(!bytes.isAttached());
+        CPPUNIT_ASSERT_EQUAL(0, releaser.released);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, releaser.released);
+    CPPUNIT_ASSERT(releaser.bytes == &external[0]);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 32, releaser.length);
+
+    // Replacing attached bytes releases them.
+    CountingReleaser second;
+    CopyOnWriteBytes bytes;
+    bytes.attach(&external[0], external.size(), &second);
+    bytes = createBytes(4);
+    CPPUNIT_ASSERT_EQUAL(1, second.released);
+    CPPUNIT_ASSERT(createBytes(4) == bytes.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CopyOnWriteBytesTest::testAttachedBytesCopiedToEdit() {
+
+    std::vector<unsigned char> external = createBytes(8);
+    CountingReleaser releaser;
+
+    CopyOnWriteBytes bytes;
+    bytes.attach(&external[0], external.size(), &releaser);
+
+    bytes.edit()[0] = 42;
+
+    CPPUNIT_ASSERT(!bytes.isAttached());
+    CPPUNIT_ASSERT_EQUAL(1, releaser.released);
+    CPPUNIT_ASSERT_EQUAL(0, (int) external[0]);
+    CPPUNIT_ASSERT_EQUAL(42, (int) bytes.get()[0]);
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 8, bytes.size());
+
+    CountingReleaser second;
+    bytes.attach(&external[0], external.size(), &second);
+    CPPUNIT_ASSERT(createBytes(8) == bytes.get());
+    CPPUNIT_ASSERT(!bytes.isAttached());
+    CPPUNIT_ASSERT_EQUAL(1, second.released);
+}
@@ -0,0 +1,56 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _ACTIVEMQ_UTIL_COPYONWRITEBYTESTEST_H_
+#define _ACTIVEMQ_UTIL_COPYONWRITEBYTESTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace activemq {
+namespace util {
+
+    class CopyOnWriteBytesTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( CopyOnWriteBytesTest );
+        CPPUNIT_TEST( testEmpty );
+        CPPUNIT_TEST( testCopySharesBytes );
+        CPPUNIT_TEST( testEditCopiesSharedBytes );
+        CPPUNIT_TEST( testAssign );
+        CPPUNIT_TEST( testClear );
+        CPPUNIT_TEST( testAttach );
+        CPPUNIT_TEST( testAttachedBytesCopiedToEdit );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        CopyOnWriteBytesTest() {}
+        virtual ~CopyOnWriteBytesTest() {}
+
+        void testEmpty();
+        void testCopySharesBytes();
+        void testEditCopiesSharedBytes();
+        void testAssign();
+        void testClear();
+        void testAttach();
+        void testAttachedBytesCopiedToEdit();
+
+    };
+
+}}
+
+#endif /* _ACTIVEMQ_UTIL_COPYONWRITEBYTESTEST_H_ */
@@ -142,3 +142,15 @@ void IdGeneratorTest::testThreadSafety() {
 
     CPPUNIT_ASSERT_MESSAGE( "One of the Thread Tester failed", !failed );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void IdGeneratorTest::testHostname() {
+
+    std::string hostname = IdGenerator::getHostname();
+    CPPUNIT_ASSERT( !hostname.empty() );
+
+    IdGenerator idGen;
+    std::string id = idGen.generateId();
+
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 0, id.find( "ID:" + hostname + "-" ) );
+}
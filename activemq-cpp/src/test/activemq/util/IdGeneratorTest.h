@@ -31,6 +31,7 @@ namespace util {
         CPPUNIT_TEST( testConstructor2 );
         CPPUNIT_TEST( testCompare );
         CPPUNIT_TEST( testThreadSafety );
+        CPPUNIT_TEST( testHostname );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -42,6 +43,7 @@ namespace util {
         void testConstructor2();
         void testCompare();
         void testThreadSafety();
+        void testHostname();
 
     };
 
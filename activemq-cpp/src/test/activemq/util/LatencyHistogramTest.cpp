@@ -0,0 +1,191 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LatencyHistogramTest.h"
+#include <activemq/util/LatencyHistogram.h>
+
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class RecordRunner : public decaf::lang::Runnable {
+    private:
+
+        RecordRunner(const RecordRunner&);
+        RecordRunner& operator= (const RecordRunner&);
+
+    private:
+
+        LatencyHistogram* histogram;
+        int count;
+
+    public:
+
+        RecordRunner(LatencyHistogram* histogram, int count) : histogram(histogram), count(count) {}
+
+        virtual void run() {
+            for (int i = 1; i <= this->count; ++i) {
+                this->histogram->record(i);
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testEmpty() {
+
+    LatencyHistogram histogram;
+
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getSum());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMax());
+    CPPUNIT_ASSERT_EQUAL(0.0, histogram.getMean());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getValueAtPercentile(99.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testBuckets() {
+
+    // Small values each have a bucket of their own.
+    for (int i = 0; i < LatencyHistogram::SUB_BUCKET_COUNT; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, LatencyHistogram::getBucketIndex(i));
+        CPPUNIT_ASSERT_EQUAL((long long) i, LatencyHistogram::getBucketUpperBound(i));
+    }
+
+    // Every bucket starts just above where the previous one ended, and the error of any
+    // value is within one sixteenth of it.
+    long long lower = 0;
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        long long upper = LatencyHistogram::getBucketUpperBound(i);
+        CPPUNIT_ASSERT(upper >= lower);
+        CPPUNIT_ASSERT_EQUAL(i, LatencyHistogram::getBucketIndex(lower));
+        CPPUNIT_ASSERT_EQUAL(i, LatencyHistogram::getBucketIndex(upper));
+        CPPUNIT_ASSERT(upper - lower <= lower / LatencyHistogram::SUB_BUCKET_COUNT);
+        if (i + 1 < LatencyHistogram::BUCKET_COUNT) {
+            lower = upper + 1;
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(Long::MAX_VALUE, LatencyHistogram::getBucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1));
+    CPPUNIT_ASSERT_EQUAL(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::getBucketIndex(Long::MAX_VALUE));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testRecord() {
+
+    LatencyHistogram histogram;
+
+    histogram.record(10);
+    histogram.record(20);
+    histogram.record(30);
+    histogram.record(-5);
+
+    CPPUNIT_ASSERT_EQUAL(4LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(60LL, histogram.getSum());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(30LL, histogram.getMax());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(15.0, histogram.getMean(), 0.001);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testPercentiles() {
+
+    LatencyHistogram histogram;
+
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.record(i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1LL, histogram.getValueAtPercentile(0.0));
+    CPPUNIT_ASSERT_EQUAL(1000LL, histogram.getValueAtPercentile(100.0));
+    CPPUNIT_ASSERT_EQUAL(1000LL, histogram.getValueAtPercentile(150.0));
+
+    long long p50 = histogram.getValueAtPercentile(50.0);
+    long long p99 = histogram.getValueAtPercentile(99.0);
+
+    CPPUNIT_ASSERT(p50 >= 500 && p50 <= 500 + 500 / LatencyHistogram::SUB_BUCKET_COUNT);
+    CPPUNIT_ASSERT(p99 >= 990 && p99 <= 1000);
+    CPPUNIT_ASSERT(p50 <= p99);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testExtremeValues() {
+
+    LatencyHistogram histogram;
+
+    histogram.record(0);
+    histogram.record(Long::MAX_VALUE);
+
+    CPPUNIT_ASSERT_EQUAL(2LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(Long::MAX_VALUE, histogram.getMax());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getValueAtPercentile(50.0));
+    CPPUNIT_ASSERT_EQUAL(Long::MAX_VALUE, histogram.getValueAtPercentile(100.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testReset() {
+
+    LatencyHistogram histogram;
+
+    histogram.record(100);
+    histogram.reset();
+
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL(0LL, histogram.getMax());
+
+    histogram.record(7);
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getMax());
+    CPPUNIT_ASSERT_EQUAL(7LL, histogram.getValueAtPercentile(50.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LatencyHistogramTest::testConcurrentRecord() {
+
+    const int THREADS = 4;
+    const int COUNT = 10000;
+
+    LatencyHistogram histogram;
+    RecordRunner runner(&histogram, COUNT);
+
+    std::vector<Thread*> threads;
+    for (int i = 0; i < THREADS; ++i) {
+        threads.push_back(new Thread(&runner));
+        threads.back()->start();
+    }
+
+    for (int i = 0; i < THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL((long long) THREADS * COUNT, histogram.getCount());
+    CPPUNIT_ASSERT_EQUAL((long long) THREADS * COUNT * (COUNT + 1) / 2, histogram.getSum());
+    CPPUNIT_ASSERT_EQUAL(1LL, histogram.getMin());
+    CPPUNIT_ASSERT_EQUAL((long long) COUNT, histogram.getMax());
+}
@@ -17,8 +17,45 @@
 
 #include "LongSequenceGeneratorTest.h"
 
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Runnable.h>
+
+#include <vector>
+
 using namespace activemq;
 using namespace activemq::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SequenceRunner : public Runnable {
+    private:
+
+        SequenceRunner(const SequenceRunner&);
+        SequenceRunner& operator= (const SequenceRunner&);
+
+    private:
+
+        LongSequenceGenerator* sequence;
+        int count;
+
+    public:
+
+        std::vector<long long> ids;
+
+        SequenceRunner(LongSequenceGenerator* sequence, int count) :
+            Runnable(), sequence(sequence), count(count), ids() {}
+
+        virtual ~SequenceRunner() {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                ids.push_back(sequence->getNextSequenceId());
+            }
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void LongSequenceGeneratorTest::test() {
@@ -33,3 +70,42 @@ void LongSequenceGeneratorTest::test() {
     CPPUNIT_ASSERT( result2 < sequence.getNextSequenceId() );
 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void LongSequenceGeneratorTest::testThreadSafety() {
+
+    static const int THREADS = 4;
+    static const int COUNT = 10000;
+
+    LongSequenceGenerator sequence;
+
+    std::vector<SequenceRunner*> runners;
+    std::vector<Thread*> threads;
+    for (int i = 0; i < THREADS; ++i) {
+        runners.push_back(new SequenceRunner(&sequence, COUNT));
+        threads.push_back(new Thread(runners.back()));
+        threads.back()->start();
+    }
+
+    std::vector<bool> seen(THREADS * COUNT + 1, false);
+    bool unique = true;
+
+    for (int i = 0; i < THREADS; ++i) {
+        threads[i]->join();
+
+        for (std::size_t j = 0; j < runners[i]->ids.size(); ++j) {
+            long long id = runners[i]->ids[j];
+            if (id < 1 || id > THREADS * COUNT || seen[(std::size_t) id]) {
+                unique = false;
+            } else {
+                seen[(std::size_t) id] = true;
+            }
+        }
+
+        delete threads[i];
+        delete runners[i];
+    }
+
+    CPPUNIT_ASSERT(unique);
+    CPPUNIT_ASSERT_EQUAL((long long) THREADS * COUNT, sequence.getLastSequenceId());
+}
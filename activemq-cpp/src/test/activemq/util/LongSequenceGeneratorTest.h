@@ -30,6 +30,7 @@ namespace util{
     {
         CPPUNIT_TEST_SUITE( LongSequenceGeneratorTest );
         CPPUNIT_TEST( test );
+        CPPUNIT_TEST( testThreadSafety );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -38,6 +39,7 @@ namespace util{
         virtual ~LongSequenceGeneratorTest() {}
 
         void test();
+        void testThreadSafety();
 
     };
 
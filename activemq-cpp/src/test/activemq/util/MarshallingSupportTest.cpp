@@ -336,3 +336,44 @@ void MarshallingSupportTest::testReadString32() {
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallingSupportTest::testModifiedUtf8LongRuns() {
+
+    // Runs of ASCII are copied a word at a time, the characters that need encoding
+    // are placed at every offset within and across those words.
+    std::string ascii;
+    for( int i = 0; i < 1000; ++i ) {
+        ascii += (char)( 'a' + i % 26 );
+    }
+
+    CPPUNIT_ASSERT( MarshallingSupport::asciiToModifiedUtf8( ascii ) == ascii );
+    CPPUNIT_ASSERT( MarshallingSupport::modifiedUtf8ToAscii( ascii ) == ascii );
+
+    const unsigned char special[] = { 0x00, 0x80, 0xFF };
+
+    for( int offset = 0; offset < 20; ++offset ) {
+        for( int i = 0; i < 3; ++i ) {
+
+            std::string testStr = ascii.substr( 0, 40 );
+            testStr[offset] = (char)special[i];
+            testStr[offset + 17] = (char)special[2 - i];
+
+            std::string encoded = MarshallingSupport::asciiToModifiedUtf8( testStr );
+            CPPUNIT_ASSERT_EQUAL( testStr.length() + 2, encoded.length() );
+            CPPUNIT_ASSERT( encoded.substr( 0, offset ) == testStr.substr( 0, offset ) );
+            CPPUNIT_ASSERT( ( (unsigned char)encoded[offset] & 0xE0 ) == 0xC0 );
+            CPPUNIT_ASSERT( encoded.find( '\0' ) == std::string::npos );
+
+            CPPUNIT_ASSERT( MarshallingSupport::modifiedUtf8ToAscii( encoded ) == testStr );
+        }
+    }
+
+    // A malformed character after a long run is still found.
+    std::string invalid = ascii;
+    invalid[999] = (char)0x80;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a UTFDataFormatException",
+        MarshallingSupport::modifiedUtf8ToAscii( invalid ),
+        UTFDataFormatException );
+}
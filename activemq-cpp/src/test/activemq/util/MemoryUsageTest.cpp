@@ -48,6 +48,49 @@ namespace {
             this->usage->decreaseUsage(this->usage->getUsage());
         }
     };
+
+    class EnqueueRunner : public decaf::lang::Runnable {
+    private:
+
+        EnqueueRunner(const EnqueueRunner&);
+        EnqueueRunner& operator= (const EnqueueRunner&);
+
+    private:
+
+        MemoryUsage* usage;
+        int count;
+        unsigned long long size;
+
+    public:
+
+        EnqueueRunner(MemoryUsage* usage, int count, unsigned long long size) :
+            usage(usage), count(count), size(size) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                this->usage->enqueueUsage(size);
+            }
+        }
+    };
+
+    class WaitRunner : public decaf::lang::Runnable {
+    private:
+
+        WaitRunner(const WaitRunner&);
+        WaitRunner& operator= (const WaitRunner&);
+
+    private:
+
+        MemoryUsage* usage;
+
+    public:
+
+        WaitRunner(MemoryUsage* usage) : usage(usage) {}
+
+        virtual void run() {
+            this->usage->waitForSpace();
+        }
+    };
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -121,3 +164,63 @@ void MemoryUsageTest::testWait() {
 
     myThread.join();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsageTest::testConcurrentEnqueueAndDecrease() {
+
+    static const int PRODUCERS = 2;
+    static const int COUNT = 5000;
+    static const unsigned long long SIZE = 100;
+
+    MemoryUsage usage(1000);
+
+    EnqueueRunner runner(&usage, COUNT, SIZE);
+    Thread* producers[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; ++i) {
+        producers[i] = new Thread(&runner);
+        producers[i]->start();
+    }
+
+    // Play the part of the ProducerAcks, returning space as it is used.
+    unsigned long long returned = 0;
+    long long deadline = System::currentTimeMillis() + 30000;
+    while (returned < PRODUCERS * COUNT * SIZE && System::currentTimeMillis() < deadline) {
+        unsigned long long used = usage.getUsage();
+        if (used == 0) {
+            Thread::yield();
+            continue;
+        }
+        usage.decreaseUsage(used);
+        returned += used;
+    }
+
+    for (int i = 0; i < PRODUCERS; ++i) {
+        producers[i]->join();
+        delete producers[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(PRODUCERS * COUNT * SIZE, returned);
+    CPPUNIT_ASSERT_EQUAL(0ULL, usage.getUsage());
+    CPPUNIT_ASSERT(!usage.isFull());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MemoryUsageTest::testSetLimitWakesWaiter() {
+
+    MemoryUsage usage(1024);
+    usage.increaseUsage(1024);
+    CPPUNIT_ASSERT(usage.isFull());
+
+    WaitRunner runner(&usage);
+    Thread waiter(&runner);
+    waiter.start();
+
+    Thread::sleep(50);
+    CPPUNIT_ASSERT(waiter.isAlive());
+
+    usage.setLimit(2048);
+    waiter.join(5000);
+
+    CPPUNIT_ASSERT(!waiter.isAlive());
+    CPPUNIT_ASSERT_EQUAL(1024ULL, usage.getUsage());
+}
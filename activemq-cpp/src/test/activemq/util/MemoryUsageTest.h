@@ -31,6 +31,8 @@ namespace util {
         CPPUNIT_TEST( testUsage );
         CPPUNIT_TEST( testTimedWait );
         CPPUNIT_TEST( testWait );
+        CPPUNIT_TEST( testConcurrentEnqueueAndDecrease );
+        CPPUNIT_TEST( testSetLimitWakesWaiter );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -42,6 +44,8 @@ namespace util {
         void testUsage();
         void testTimedWait();
         void testWait();
+        void testConcurrentEnqueueAndDecrease();
+        void testSetLimitWakesWaiter();
 
     };
 
@@ -0,0 +1,212 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MessageSelectorTest.h"
+#include <activemq/util/MessageSelector.h>
+#include <activemq/util/PrimitiveMap.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+
+#include <cms/DeliveryMode.h>
+#include <cms/InvalidSelectorException.h>
+
+#include <string>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace activemq::commands;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    PrimitiveMap createProperties() {
+        PrimitiveMap properties;
+        properties.setInt("a", 5);
+        properties.setString("s", "hello");
+        properties.setDouble("d", 2.5);
+        properties.setBool("b", true);
+        properties.setLong("big", 1234567890123LL);
+        properties.setString("u", "h\xc3\xa9llo");
+        return properties;
+    }
+
+    bool matches(const std::string& selector, const PrimitiveMap& properties) {
+        MessageSelector compiled(selector);
+        return compiled.matches(properties);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testEmptySelector() {
+
+    PrimitiveMap properties;
+
+    CPPUNIT_ASSERT(matches("", properties));
+    CPPUNIT_ASSERT(matches("  ", properties));
+
+    MessageSelector selector("a = 1");
+    CPPUNIT_ASSERT_EQUAL(std::string("a = 1"), selector.getSelector());
+    CPPUNIT_ASSERT(!selector.matches((const cms::Message*) NULL));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testComparisons() {
+
+    PrimitiveMap properties = createProperties();
+
+    CPPUNIT_ASSERT(matches("a = 5", properties));
+    CPPUNIT_ASSERT(matches("a = 5.0", properties));
+    CPPUNIT_ASSERT(!matches("a <> 5", properties));
+    CPPUNIT_ASSERT(matches("a > 4 AND a < 6", properties));
+    CPPUNIT_ASSERT(matches("a >= 5 AND a <= 5", properties));
+    CPPUNIT_ASSERT(matches("s = 'hello'", properties));
+    CPPUNIT_ASSERT(matches("s > 'a'", properties));
+    CPPUNIT_ASSERT(matches("b = TRUE", properties));
+    CPPUNIT_ASSERT(matches("big > 1234567890122", properties));
+
+    // Values of different types are neither equal nor unequal.
+    CPPUNIT_ASSERT(!matches("s = 5", properties));
+    CPPUNIT_ASSERT(!matches("s <> 5", properties));
+    CPPUNIT_ASSERT(!matches("b = 1", properties));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testArithmetic() {
+
+    PrimitiveMap properties = createProperties();
+
+    CPPUNIT_ASSERT(matches("d * 2 = 5", properties));
+    CPPUNIT_ASSERT(matches("a / 2 = 2", properties));
+    CPPUNIT_ASSERT(matches("a / 2.0 = 2.5", properties));
+    CPPUNIT_ASSERT(matches("-a = -5", properties));
+    CPPUNIT_ASSERT(matches("a + 1 * 2 = 7", properties));
+    CPPUNIT_ASSERT(matches("(a + 1) * 2 = 12", properties));
+    CPPUNIT_ASSERT(matches("a - 10 < 0", properties));
+
+    // Division by zero and arithmetic on missing values are unknown.
+    CPPUNIT_ASSERT(!matches("a / 0 = 1", properties));
+    CPPUNIT_ASSERT(!matches("NOT (a / 0 = 1)", properties));
+    CPPUNIT_ASSERT(!matches("missing + 1 > 0", properties));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testLogic() {
+
+    PrimitiveMap properties = createProperties();
+
+    CPPUNIT_ASSERT(matches("b", properties));
+    CPPUNIT_ASSERT(!matches("NOT b", properties));
+    CPPUNIT_ASSERT(matches("NOT a = 4", properties));
+    CPPUNIT_ASSERT(matches("a = 1 OR a = 5", properties));
+    CPPUNIT_ASSERT(!matches("a = 5 AND s LIKE 'H%'", properties));
+    CPPUNIT_ASSERT(matches("a = 5 and s like 'h%'", properties));
+
+    // Missing properties are unknown, which only OR with true can make true.
+    CPPUNIT_ASSERT(matches("missing IS NULL", properties));
+    CPPUNIT_ASSERT(matches("a IS NOT NULL", properties));
+    CPPUNIT_ASSERT(!matches("missing = 1", properties));
+    CPPUNIT_ASSERT(!matches("NOT missing = 1", properties));
+    CPPUNIT_ASSERT(matches("missing = 1 OR a = 5", properties));
+    CPPUNIT_ASSERT(!matches("missing = 1 AND a = 5", properties));
+    CPPUNIT_ASSERT(!matches("missing = 1 OR a = 4", properties));
+    CPPUNIT_ASSERT(matches("NOT (missing = 1 AND a = 4)", properties));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testBetweenInLike() {
+
+    PrimitiveMap properties = createProperties();
+
+    CPPUNIT_ASSERT(matches("a BETWEEN 1 AND 5", properties));
+    CPPUNIT_ASSERT(!matches("a BETWEEN 6 AND 9", properties));
+    CPPUNIT_ASSERT(matches("a NOT BETWEEN 1 AND 4", properties));
+    CPPUNIT_ASSERT(matches("d BETWEEN 2 AND 3", properties));
+
+    CPPUNIT_ASSERT(matches("s IN ('a', 'hello')", properties));
+    CPPUNIT_ASSERT(matches("s NOT IN ('a', 'b')", properties));
+    CPPUNIT_ASSERT(!matches("missing IN ('a')", properties));
+    CPPUNIT_ASSERT(!matches("missing NOT IN ('a')", properties));
+
+    CPPUNIT_ASSERT(matches("s LIKE 'h%o'", properties));
+    CPPUNIT_ASSERT(matches("s LIKE 'h_llo'", properties));
+    CPPUNIT_ASSERT(matches("s LIKE '%'", properties));
+    CPPUNIT_ASSERT(matches("s LIKE '%%l%'", properties));
+    CPPUNIT_ASSERT(!matches("s LIKE 'hel'", properties));
+    CPPUNIT_ASSERT(matches("s NOT LIKE 'x%'", properties));
+    CPPUNIT_ASSERT(matches("NOT s LIKE 'x%'", properties));
+
+    // '_' matches a whole UTF-8 encoded character.
+    CPPUNIT_ASSERT(matches("u LIKE 'h_llo'", properties));
+
+    properties.setString("p", "50% off_");
+    CPPUNIT_ASSERT(matches("p LIKE '50!% off!_' ESCAPE '!'", properties));
+    CPPUNIT_ASSERT(!matches("p LIKE '50!%' ESCAPE '!'", properties));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testLiterals() {
+
+    PrimitiveMap properties = createProperties();
+
+    CPPUNIT_ASSERT(matches("big > 0x10", properties));
+    CPPUNIT_ASSERT(matches("a = 05", properties));
+    CPPUNIT_ASSERT(matches("a = 5L", properties));
+    CPPUNIT_ASSERT(matches("d = 2.5e0", properties));
+    CPPUNIT_ASSERT(matches("d = 25E-1", properties));
+    CPPUNIT_ASSERT(matches("d > .5", properties));
+    CPPUNIT_ASSERT(matches("d < 3d", properties));
+
+    properties.setString("q", "it's");
+    CPPUNIT_ASSERT(matches("q = 'it''s'", properties));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testHeaders() {
+
+    ActiveMQTextMessage message;
+    message.setCMSPriority(7);
+    message.setCMSType("order");
+    message.setCMSDeliveryMode(cms::DeliveryMode::NON_PERSISTENT);
+    message.setIntProperty("a", 5);
+    message.setStringProperty("s", "hello");
+
+    CPPUNIT_ASSERT(MessageSelector("JMSPriority > 4").matches(&message));
+    CPPUNIT_ASSERT(MessageSelector("JMSType = 'order' AND a = 5").matches(&message));
+    CPPUNIT_ASSERT(MessageSelector("JMSDeliveryMode = 'NON_PERSISTENT'").matches(&message));
+    CPPUNIT_ASSERT(MessageSelector("JMSCorrelationID IS NULL").matches(&message));
+    CPPUNIT_ASSERT(MessageSelector("s LIKE 'he%' AND JMSRedelivered = FALSE").matches(&message));
+    CPPUNIT_ASSERT(!MessageSelector("missing = 1").matches(&message));
+
+    // Header fields have no value in a property map.
+    CPPUNIT_ASSERT(MessageSelector("JMSPriority IS NULL").matches(createProperties()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageSelectorTest::testInvalidSelectors() {
+
+    const char* invalid[] = {
+        "a +", "a = ", "'x'", "a + 1", "s = 'abc", "a LIKE 5", "NOT 'x'", "a IN (1)",
+        "a = 5 )", "(a = 5", "a # 5", "s LIKE 'x' ESCAPE 'ab'", "s LIKE 'x!' ESCAPE '!'",
+        "a BETWEEN 1", "'a' + 1 = 2", "TRUE AND 5", "a IS 5", "0x = 1", NULL
+    };
+
+    for (int i = 0; invalid[i] != NULL; ++i) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            std::string("Should throw an InvalidSelectorException for: ") + invalid[i],
+            MessageSelector selector(invalid[i]),
+            cms::InvalidSelectorException);
+    }
+}
@@ -288,3 +288,43 @@ void PrimitiveValueConverterTest::testConvertToString() {
         converter.convert<unsigned int>( 24567 ),
         UnsupportedOperationException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void PrimitiveValueConverterTest::testNumericStringLimits() {
+
+    PrimitiveValueConverter converter;
+
+    CPPUNIT_ASSERT_EQUAL( 2147483647, converter.convert<int>( PrimitiveValueNode( "2147483647" ) ) );
+    CPPUNIT_ASSERT_EQUAL( (int) 0x80000000, converter.convert<int>( PrimitiveValueNode( "-2147483648" ) ) );
+    CPPUNIT_ASSERT_EQUAL( 0, converter.convert<int>( PrimitiveValueNode( "-0" ) ) );
+    CPPUNIT_ASSERT_EQUAL( (long long) 0x8000000000000000ULL,
+                          converter.convert<long long>( PrimitiveValueNode( "-9223372036854775808" ) ) );
+    CPPUNIT_ASSERT_EQUAL( (short) -32768, converter.convert<short>( PrimitiveValueNode( "-32768" ) ) );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char) 255, converter.convert<unsigned char>( PrimitiveValueNode( "255" ) ) );
+
+    const char* invalid[] = { "", "-", "+1", " 1", "1 ", "2147483648", "-2147483649", "99999999999" };
+    for( std::size_t i = 0; i < sizeof( invalid ) / sizeof( invalid[0] ); ++i ) {
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            std::string( "Should throw an UnsupportedOperationException for: " ) + invalid[i],
+            converter.convert<int>( PrimitiveValueNode( invalid[i] ) ),
+            UnsupportedOperationException );
+    }
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        converter.convert<short>( PrimitiveValueNode( "32768" ) ),
+        UnsupportedOperationException );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        converter.convert<unsigned char>( PrimitiveValueNode( "-1" ) ),
+        UnsupportedOperationException );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "-2147483648" ),
+                          converter.convert<std::string>( PrimitiveValueNode( (int) 0x80000000 ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "-9223372036854775808" ),
+                          converter.convert<std::string>( PrimitiveValueNode( (long long) 0x8000000000000000ULL ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "0" ), converter.convert<std::string>( PrimitiveValueNode( 0 ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "200" ),
+                          converter.convert<std::string>( PrimitiveValueNode( (unsigned char) 200 ) ) );
+    CPPUNIT_ASSERT_EQUAL( std::string( "-5" ), converter.convert<std::string>( PrimitiveValueNode( (short) -5 ) ) );
+}
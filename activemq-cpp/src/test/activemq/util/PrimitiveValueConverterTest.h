@@ -36,6 +36,7 @@ namespace util {
         CPPUNIT_TEST( testConvertToFloat );
         CPPUNIT_TEST( testConvertToDouble );
         CPPUNIT_TEST( testConvertToString );
+        CPPUNIT_TEST( testNumericStringLimits );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -52,6 +53,7 @@ namespace util {
         void testConvertToFloat();
         void testConvertToDouble();
         void testConvertToString();
+        void testNumericStringLimits();
 
     };
 
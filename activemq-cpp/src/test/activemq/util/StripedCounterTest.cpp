@@ -0,0 +1,103 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StripedCounterTest.h"
+#include <activemq/util/StripedCounter.h>
+
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::util;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class IncrementRunner : public decaf::lang::Runnable {
+    private:
+
+        IncrementRunner(const IncrementRunner&);
+        IncrementRunner& operator= (const IncrementRunner&);
+
+    private:
+
+        StripedCounter* counter;
+        int count;
+
+    public:
+
+        IncrementRunner(StripedCounter* counter, int count) : counter(counter), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < this->count; ++i) {
+                this->counter->increment();
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedCounterTest::testAddAndGet() {
+
+    StripedCounter counter;
+    CPPUNIT_ASSERT_EQUAL(0LL, counter.get());
+
+    counter.increment();
+    counter.add(41);
+    CPPUNIT_ASSERT_EQUAL(42LL, counter.get());
+
+    counter.add(-2);
+    CPPUNIT_ASSERT_EQUAL(40LL, counter.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedCounterTest::testReset() {
+
+    StripedCounter counter;
+    counter.add(100);
+    counter.reset();
+    CPPUNIT_ASSERT_EQUAL(0LL, counter.get());
+
+    counter.increment();
+    CPPUNIT_ASSERT_EQUAL(1LL, counter.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StripedCounterTest::testConcurrentIncrement() {
+
+    const int THREADS = 8;
+    const int COUNT = 20000;
+
+    StripedCounter counter;
+    IncrementRunner runner(&counter, COUNT);
+
+    std::vector<Thread*> threads;
+    for (int i = 0; i < THREADS; ++i) {
+        threads.push_back(new Thread(&runner));
+        threads.back()->start();
+    }
+
+    for (int i = 0; i < THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL((long long) THREADS * COUNT, counter.get());
+}
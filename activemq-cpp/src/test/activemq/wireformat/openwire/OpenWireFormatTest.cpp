@@ -20,13 +20,30 @@
 #include <decaf/util/Properties.h>
 #include <activemq/wireformat/openwire/OpenWireFormatFactory.h>
 #include <activemq/wireformat/openwire/OpenWireFormat.h>
+#include <activemq/wireformat/openwire/MarshaledCommand.h>
 
 #include <activemq/core/ActiveMQConnectionMetaData.h>
+#include <activemq/commands/ProducerInfo.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/BrokerId.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQTextMessageMarshaller.h>
+#include <activemq/transport/IOTransport.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
 
 using namespace std;
 using namespace activemq;
 using namespace activemq::util;
 using namespace activemq::core;
+using namespace activemq::commands;
+using namespace activemq::transport;
 using namespace decaf::io;
 using namespace decaf::lang;
 using namespace decaf::util;
@@ -34,6 +51,32 @@ using namespace activemq::exceptions;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::openwire;
 
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Counts the reads made of it.
+    class CountingInputStream : public ByteArrayInputStream {
+    public:
+
+        int reads;
+
+        CountingInputStream(const std::vector<unsigned char>& buffer) : ByteArrayInputStream(buffer), reads(0) {}
+        virtual ~CountingInputStream() {}
+
+    protected:
+
+        virtual int doReadByte() {
+            reads++;
+            return ByteArrayInputStream::doReadByte();
+        }
+
+        virtual int doReadArrayBounded(unsigned char* buffer, int size, int offset, int length) {
+            reads++;
+            return ByteArrayInputStream::doReadArrayBounded(buffer, size, offset, length);
+        }
+    };
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void OpenWireFormatTest::testProviderInfoInWireFormat() {
     ActiveMQConnectionMetaData meta;
@@ -50,3 +93,704 @@ void OpenWireFormatTest::testProviderInfoInWireFormat() {
             myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("ProviderVersion"));
     CPPUNIT_ASSERT(!myWireFormat->getPreferedWireFormatInfo()->getProperties().getString("PlatformDetails").empty());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testLooseMarshalReusesBuffers() {
+    doTestMarshalRoundTrip(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testTightMarshalReusesBuffers() {
+    doTestMarshalRoundTrip(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testRecycleCommands() {
+
+    Properties properties;
+    CPPUNIT_ASSERT(!OpenWireFormat(properties).isRecycleCommands());
+
+    properties.setProperty("wireFormat.recycleCommands", "true");
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+
+    // Cached values would keep their blocks in use between commands.
+    wireFormat.setCacheEnabled(false);
+    CPPUNIT_ASSERT(wireFormat.isRecycleCommands());
+
+    const DataStructurePool* pool = wireFormat.getCommandPool();
+    CPPUNIT_ASSERT(pool != NULL);
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    info->setCommandId(42);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    wireFormat.marshal(info, &transport, &dataOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+
+    // Commands created outside of unmarshal don't come from the pool.
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    Pointer<Command> result = wireFormat.unmarshal(&transport, &dataIn);
+    CPPUNIT_ASSERT(info->equals(result.get()));
+
+    // The ProducerInfo, its ProducerId and the destination.
+    const int blocks = pool->getActiveBlockCount();
+    CPPUNIT_ASSERT_EQUAL(3, blocks);
+
+    result.reset(NULL);
+    CPPUNIT_ASSERT_EQUAL(0, pool->getActiveBlockCount());
+    CPPUNIT_ASSERT_EQUAL(blocks, pool->getCachedBlockCount());
+
+    // The second command reuses the blocks freed by the first.
+    result = wireFormat.unmarshal(&transport, &dataIn);
+    CPPUNIT_ASSERT(info->equals(result.get()));
+    CPPUNIT_ASSERT_EQUAL(blocks, pool->getActiveBlockCount());
+    CPPUNIT_ASSERT_EQUAL(0, pool->getCachedBlockCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testLooseMarshalCache() {
+    doTestMarshalCache(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testTightMarshalCache() {
+    doTestMarshalCache(true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testMarshalCacheEviction() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setTightEncodingEnabled(true);
+    wireFormat.setCacheSize(2);
+
+    OpenWireFormat peer(properties);
+    peer.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    peer.setTightEncodingEnabled(true);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    std::vector< Pointer<ProducerInfo> > infos;
+    for (int i = 0; i < 4; ++i) {
+        Pointer<ProducerInfo> info(new ProducerInfo());
+        info->setProducerId(producerId);
+        info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue(i % 2 == 0 ? "QUEUE.A" : "QUEUE.B")));
+        info->setCommandId(i);
+        infos.push_back(info);
+    }
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    // With two slots each new destination replaces the oldest entry, which is the
+    // ProducerId the same command referenced just before it.
+    for (std::size_t i = 0; i < infos.size(); ++i) {
+        wireFormat.marshal(infos[i], &transport, &dataOut);
+        wireFormat.marshal(infos[i], &transport, &dataOut);
+    }
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    for (std::size_t i = 0; i < infos.size(); ++i) {
+        Pointer<Command> result = peer.unmarshal(&transport, &dataIn);
+        CPPUNIT_ASSERT(infos[i]->equals(result.get()));
+        result = peer.unmarshal(&transport, &dataIn);
+        CPPUNIT_ASSERT(infos[i]->equals(result.get()));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::doTestMarshalCache(bool tightEncoding) {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setTightEncodingEnabled(tightEncoding);
+    CPPUNIT_ASSERT(wireFormat.isCacheEnabled());
+
+    OpenWireFormat peer(properties);
+    peer.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    peer.setTightEncodingEnabled(tightEncoding);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    info->setCommandId(42);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    wireFormat.marshal(info, &transport, &dataOut);
+    const long long first = bytesOut.size();
+
+    // The second time around the ids and destination are sent as cache indexes.
+    wireFormat.marshal(info, &transport, &dataOut);
+    const long long second = bytesOut.size() - first;
+    CPPUNIT_ASSERT(second < first);
+
+    // A different value at the same address must not be taken for the cached one,
+    // the ProducerId is sent in full again while the destination is still cached.
+    producerId->setValue(4);
+    wireFormat.marshal(info, &transport, &dataOut);
+    const long long third = bytesOut.size() - first - second;
+    CPPUNIT_ASSERT(second < third && third < first);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    Pointer<ProducerInfo> result1 = peer.unmarshal(&transport, &dataIn).dynamicCast<ProducerInfo>();
+    Pointer<ProducerInfo> result2 = peer.unmarshal(&transport, &dataIn).dynamicCast<ProducerInfo>();
+    Pointer<ProducerInfo> result3 = peer.unmarshal(&transport, &dataIn).dynamicCast<ProducerInfo>();
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+
+    CPPUNIT_ASSERT(result1->getDestination()->equals(info->getDestination().get()));
+    CPPUNIT_ASSERT(result2->getDestination()->equals(info->getDestination().get()));
+    CPPUNIT_ASSERT_EQUAL(3LL, result2->getProducerId()->getValue());
+    CPPUNIT_ASSERT(info->equals(result3.get()));
+
+    // The commands that referenced a cached value share a single instance of it.
+    CPPUNIT_ASSERT(result1->getDestination().get() == result2->getDestination().get());
+    CPPUNIT_ASSERT(result2->getDestination().get() == result3->getDestination().get());
+
+    // With the cache off every command carries its full values.
+    wireFormat.setCacheEnabled(false);
+    ByteArrayOutputStream uncachedOut;
+    DataOutputStream uncachedDataOut(&uncachedOut);
+    wireFormat.marshal(info, &transport, &uncachedDataOut);
+    const long long uncached = uncachedOut.size();
+    wireFormat.marshal(info, &transport, &uncachedDataOut);
+    CPPUNIT_ASSERT_EQUAL(uncached, uncachedOut.size() - uncached);
+    CPPUNIT_ASSERT(second < uncached);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testFrameReadAhead() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setCacheEnabled(false);
+    CPPUNIT_ASSERT_EQUAL(OpenWireFormat::DEFAULT_MAX_FRAME_READ_AHEAD, wireFormat.getMaxFrameReadAhead());
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    info->setCommandId(42);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> frames(array.first, array.first + array.second);
+    delete [] array.first;
+
+    // Each frame is taken from the stream with one read for the size prefix
+    // and one for the rest.
+    {
+        CountingInputStream bytesIn(frames);
+        DataInputStream dataIn(&bytesIn);
+
+        CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &dataIn).get()));
+        CPPUNIT_ASSERT_EQUAL(2, bytesIn.reads);
+        CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &dataIn).get()));
+        CPPUNIT_ASSERT_EQUAL(4, bytesIn.reads);
+        CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+    }
+
+    // Frames larger than the limit are decoded from the stream as before.
+    wireFormat.setMaxFrameReadAhead(16);
+    {
+        CountingInputStream bytesIn(frames);
+        DataInputStream dataIn(&bytesIn);
+
+        CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &dataIn).get()));
+        CPPUNIT_ASSERT(bytesIn.reads > 2);
+        CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &dataIn).get()));
+        CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+    }
+
+    properties.setProperty("wireFormat.maxFrameReadAhead", "0");
+    CPPUNIT_ASSERT_EQUAL(0, OpenWireFormat(properties).getMaxFrameReadAhead());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testReadFrame() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setCacheEnabled(false);
+    CPPUNIT_ASSERT(wireFormat.isFramed());
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setCommandId(42);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    // Each frame holds its size prefix and unmarshals to the command on its own.
+    std::vector<unsigned char> frame;
+    wireFormat.readFrame(&dataIn, frame);
+    CPPUNIT_ASSERT_EQUAL(array.second / 2, (int) frame.size());
+    wireFormat.readFrame(&dataIn, frame);
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+
+    ByteArrayInputStream frameIn(frame);
+    DataInputStream frameDataIn(&frameIn);
+    CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &frameDataIn).get()));
+    CPPUNIT_ASSERT_EQUAL(0, frameIn.available());
+
+    wireFormat.setSizePrefixDisabled(true);
+    CPPUNIT_ASSERT(!wireFormat.isFramed());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        wireFormat.readFrame(&dataIn, frame),
+        decaf::lang::exceptions::UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testGetFrameLength() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setCacheEnabled(false);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setCommandId(42);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> bytes(array.first, array.first + array.second);
+    delete [] array.first;
+
+    // Nothing can be said until the whole size prefix is there.
+    CPPUNIT_ASSERT_EQUAL(-1, wireFormat.getFrameLength(&bytes[0], 3));
+    CPPUNIT_ASSERT(wireFormat.inReceive());
+
+    // After that the length is known even though the frame is incomplete.
+    CPPUNIT_ASSERT_EQUAL((int) bytes.size(), wireFormat.getFrameLength(&bytes[0], 4));
+    CPPUNIT_ASSERT(wireFormat.inReceive());
+    CPPUNIT_ASSERT_EQUAL((int) bytes.size(), wireFormat.getFrameLength(&bytes[0], (int) bytes.size()));
+    CPPUNIT_ASSERT(!wireFormat.inReceive());
+
+    ByteArrayInputStream frameIn(bytes);
+    DataInputStream frameDataIn(&frameIn);
+    CPPUNIT_ASSERT(info->equals(wireFormat.unmarshal(&transport, &frameDataIn).get()));
+
+    unsigned char invalid[] = { 0x80, 0, 0, 0 };
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        wireFormat.getFrameLength(invalid, 4),
+        decaf::io::IOException);
+
+    wireFormat.setSizePrefixDisabled(true);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an UnsupportedOperationException",
+        wireFormat.getFrameLength(&bytes[0], (int) bytes.size()),
+        decaf::lang::exceptions::UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::doTestMarshalRoundTrip(bool tightEncoding) {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setTightEncodingEnabled(tightEncoding);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    info->setCommandId(42);
+    info->setWindowSize(1024);
+
+    Pointer<ProducerInfo> small(new ProducerInfo());
+    small->setCommandId(43);
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    // Marshal several times so that the second and later commands run against
+    // the reused internal buffers of the wire format.
+    wireFormat.marshal(info, &transport, &dataOut);
+    wireFormat.marshal(small, &transport, &dataOut);
+    wireFormat.marshal(info, &transport, &dataOut);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    Pointer<Command> result = wireFormat.unmarshal(&transport, &dataIn);
+    CPPUNIT_ASSERT(result->isProducerInfo());
+    CPPUNIT_ASSERT(info->equals(result.get()));
+
+    result = wireFormat.unmarshal(&transport, &dataIn);
+    CPPUNIT_ASSERT(result->isProducerInfo());
+    CPPUNIT_ASSERT(small->equals(result.get()));
+
+    result = wireFormat.unmarshal(&transport, &dataIn);
+    CPPUNIT_ASSERT(result->isProducerInfo());
+    CPPUNIT_ASSERT(info->equals(result.get()));
+
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testMessageFastPath() {
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ActiveMQTextMessage> text(new ActiveMQTextMessage());
+    text->setProducerId(producerId);
+    text->setMessageId(Pointer<MessageId>(new MessageId(producerId, 1)));
+    text->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    text->setCorrelationId("correlation");
+    text->setPersistent(true);
+    text->setTimestamp(1234567890LL);
+    text->setText("fast path");
+    text->setStringProperty("key", "value");
+    doTestMessageFastPath(text);
+
+    Pointer<ActiveMQBytesMessage> bytes(new ActiveMQBytesMessage());
+    bytes->setProducerId(producerId);
+    bytes->setMessageId(Pointer<MessageId>(new MessageId(producerId, 2)));
+    bytes->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    bytes->setExpiration(987654321LL);
+    bytes->setDroppable(true);
+    bytes->setJMSXGroupFirstForConsumer(true);
+    unsigned char body[] = { 1, 2, 3, 4, 5 };
+    bytes->setBodyBytes(body, (int) sizeof(body));
+    doTestMessageFastPath(bytes);
+
+    // A forwarded message with the rare fields set takes the generated marshaller.
+    Pointer<BrokerId> brokerId(new BrokerId());
+    brokerId->setValue("ID:broker");
+    text->getBrokerPath().push_back(brokerId);
+    text->setUserID("user");
+    text->setArrival(42);
+    doTestMessageFastPath(text);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testTightFormCache() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setTightEncodingEnabled(true);
+    wireFormat.setCacheEnabled(false);
+
+    OpenWireFormat peer(properties);
+    peer.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    peer.setTightEncodingEnabled(true);
+    peer.setCacheEnabled(false);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ProducerInfo> info(new ProducerInfo());
+    info->setProducerId(producerId);
+    info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    std::vector< Pointer<ProducerInfo> > sent;
+
+    // The held encodings must follow changes made to the values they were taken from.
+    for (int i = 0; i < 4; ++i) {
+        info->setCommandId(i);
+        if (i == 2) {
+            producerId->setValue(300000);
+            info->getDestination()->setPhysicalName("OTHER.QUEUE");
+        }
+
+        wireFormat.marshal(info, &transport, &dataOut);
+        sent.push_back(Pointer<ProducerInfo>(info->cloneDataStructure()));
+    }
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    for (std::size_t i = 0; i < sent.size(); ++i) {
+        Pointer<Command> result = peer.unmarshal(&transport, &dataIn);
+        CPPUNIT_ASSERT(sent[i]->equals(result.get()));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testInternDestinations() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setCacheEnabled(false);
+
+    OpenWireFormat peer(properties);
+    peer.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    peer.setCacheEnabled(false);
+
+    OpenWireFormat uninterned(properties);
+    uninterned.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    uninterned.setCacheEnabled(false);
+    uninterned.setInternDestinations(false);
+    CPPUNIT_ASSERT(!uninterned.isInternDestinations());
+
+    IOTransport transport;
+
+    const char* names[] = { "TEST.QUEUE", "TEST.QUEUE", "A.QUEUE,B.QUEUE", "A.QUEUE,B.QUEUE" };
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream dataOut(&bytesOut);
+
+    // Every destination is sent twice, once for each of the decoding wire formats.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < 4; ++i) {
+            Pointer<ProducerInfo> info(new ProducerInfo());
+            info->setCommandId(i);
+            info->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue(names[i])));
+            wireFormat.marshal(info, &transport, &dataOut);
+        }
+    }
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    ByteArrayInputStream bytesIn(array.first, array.second, true);
+    DataInputStream dataIn(&bytesIn);
+
+    std::vector< Pointer<ActiveMQDestination> > interned;
+    for (int i = 0; i < 4; ++i) {
+        Pointer<ProducerInfo> result = peer.unmarshal(&transport, &dataIn).dynamicCast<ProducerInfo>();
+        CPPUNIT_ASSERT_EQUAL(std::string(names[i]), result->getDestination()->getPhysicalName());
+        interned.push_back(result->getDestination());
+    }
+
+    std::vector< Pointer<ActiveMQDestination> > decoded;
+    for (int i = 0; i < 4; ++i) {
+        Pointer<ProducerInfo> result = uninterned.unmarshal(&transport, &dataIn).dynamicCast<ProducerInfo>();
+        decoded.push_back(result->getDestination());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+
+    // Plain names decode to the one canonical instance, composite names are kept apart.
+    CPPUNIT_ASSERT(interned[0].get() == interned[1].get());
+    CPPUNIT_ASSERT(interned[2].get() != interned[3].get());
+    CPPUNIT_ASSERT(interned[2]->equals(*interned[3]));
+
+    CPPUNIT_ASSERT(decoded[0].get() != decoded[1].get());
+    CPPUNIT_ASSERT(decoded[0].get() != interned[0].get());
+    CPPUNIT_ASSERT(decoded[0]->equals(*interned[0]));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::doTestMessageFastPath(const Pointer<Message>& message) {
+
+    const int versions[] = { 1, 2, 3, OpenWireFormat::MAX_SUPPORTED_VERSION };
+
+    IOTransport transport;
+    Properties properties;
+
+    for (std::size_t i = 0; i < sizeof(versions) / sizeof(int); ++i) {
+        for (int cache = 0; cache < 2; ++cache) {
+
+            OpenWireFormat fast(properties);
+            OpenWireFormat generic(properties);
+            generic.addMarshaller(new marshal::generated::ActiveMQTextMessageMarshaller());
+            generic.addMarshaller(new marshal::generated::ActiveMQBytesMessageMarshaller());
+
+            OpenWireFormat* formats[] = { &fast, &generic };
+            std::vector<unsigned char> output[2];
+
+            for (int j = 0; j < 2; ++j) {
+                formats[j]->setVersion(versions[i]);
+                formats[j]->setTightEncodingEnabled(true);
+                formats[j]->setCacheEnabled(cache == 1);
+
+                ByteArrayOutputStream bytesOut;
+                DataOutputStream dataOut(&bytesOut);
+
+                // The second send finds the producer and destination in the cache.
+                formats[j]->marshal(message, &transport, &dataOut);
+                formats[j]->marshal(message, &transport, &dataOut);
+
+                std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+                output[j].assign(array.first, array.first + array.second);
+                delete [] array.first;
+            }
+
+            CPPUNIT_ASSERT(output[0] == output[1]);
+
+            OpenWireFormat peer(properties);
+            peer.setVersion(versions[i]);
+            peer.setTightEncodingEnabled(true);
+            peer.setCacheEnabled(cache == 1);
+
+            ByteArrayInputStream bytesIn(output[0]);
+            DataInputStream dataIn(&bytesIn);
+
+            for (int j = 0; j < 2; ++j) {
+                Pointer<Command> result = peer.unmarshal(&transport, &dataIn);
+                CPPUNIT_ASSERT_EQUAL((int) message->getDataStructureType(), (int) result->getDataStructureType());
+                Pointer<Message> received = result.dynamicCast<Message>();
+                CPPUNIT_ASSERT(message->getMessageId()->equals(received->getMessageId().get()));
+                CPPUNIT_ASSERT(message->getContentBytes().size() == received->getContentBytes().size());
+            }
+
+            CPPUNIT_ASSERT_EQUAL(0, bytesIn.available());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenWireFormatTest::testMarshaledCommand() {
+
+    Properties properties;
+    OpenWireFormat wireFormat(properties);
+    wireFormat.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    wireFormat.setTightEncodingEnabled(false);
+    wireFormat.setCacheEnabled(false);
+
+    IOTransport transport;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:test-connection");
+    producerId->setSessionId(2);
+    producerId->setValue(3);
+
+    Pointer<ActiveMQTextMessage> text(new ActiveMQTextMessage());
+    text->setProducerId(producerId);
+    text->setMessageId(Pointer<MessageId>(new MessageId(producerId, 1)));
+    text->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    text->setText("marshaled");
+
+    ByteArrayOutputStream expected;
+    DataOutputStream expectedOut(&expected);
+    wireFormat.marshal(text, &transport, &expectedOut);
+
+    std::pair<unsigned char*, int> frame = expected.toByteArray();
+    std::vector<unsigned char> encoded(frame.first, frame.first + frame.second);
+    delete [] frame.first;
+
+    // Past the size prefix is the frame the command holds.
+    Pointer<MarshaledCommand> marshaled(
+        new MarshaledCommand(&encoded[4], (int) encoded.size() - 4, OpenWireFormat::MAX_SUPPORTED_VERSION));
+    CPPUNIT_ASSERT_EQUAL((int) ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE, (int) marshaled->getDataStructureType());
+    CPPUNIT_ASSERT(wireFormat.canWriteMarshaled(*marshaled));
+
+    ByteArrayOutputStream written;
+    DataOutputStream writtenOut(&written);
+    wireFormat.marshal(marshaled, &transport, &writtenOut);
+
+    frame = written.toByteArray();
+    std::vector<unsigned char> rewritten(frame.first, frame.first + frame.second);
+    delete [] frame.first;
+
+    CPPUNIT_ASSERT(encoded == rewritten);
+
+    ByteArrayInputStream bytesIn(&rewritten[0], (int) rewritten.size());
+    DataInputStream dataIn(&bytesIn);
+    Pointer<ActiveMQTextMessage> result = wireFormat.unmarshal(&transport, &dataIn).dynamicCast<ActiveMQTextMessage>();
+    CPPUNIT_ASSERT_EQUAL(std::string("marshaled"), result->getText());
+
+    // A format that encodes differently can't write the frame.
+    OpenWireFormat cached(properties);
+    cached.setVersion(OpenWireFormat::MAX_SUPPORTED_VERSION);
+    cached.setCacheEnabled(true);
+    CPPUNIT_ASSERT(!cached.canWriteMarshaled(*marshaled));
+
+    ByteArrayOutputStream rejected;
+    DataOutputStream rejectedOut(&rejected);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException",
+        cached.marshal(marshaled, &transport, &rejectedOut),
+        decaf::io::IOException);
+}
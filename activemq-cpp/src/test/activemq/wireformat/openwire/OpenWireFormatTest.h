@@ -21,6 +21,9 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <activemq/commands/Message.h>
+#include <decaf/lang/Pointer.h>
+
 namespace activemq {
 namespace wireformat {
 namespace openwire {
@@ -29,6 +32,19 @@ namespace openwire {
 
         CPPUNIT_TEST_SUITE( OpenWireFormatTest );
         CPPUNIT_TEST( testProviderInfoInWireFormat );
+        CPPUNIT_TEST( testLooseMarshalReusesBuffers );
+        CPPUNIT_TEST( testTightMarshalReusesBuffers );
+        CPPUNIT_TEST( testRecycleCommands );
+        CPPUNIT_TEST( testLooseMarshalCache );
+        CPPUNIT_TEST( testTightMarshalCache );
+        CPPUNIT_TEST( testMarshalCacheEviction );
+        CPPUNIT_TEST( testFrameReadAhead );
+        CPPUNIT_TEST( testReadFrame );
+        CPPUNIT_TEST( testGetFrameLength );
+        CPPUNIT_TEST( testMessageFastPath );
+        CPPUNIT_TEST( testTightFormCache );
+        CPPUNIT_TEST( testInternDestinations );
+        CPPUNIT_TEST( testMarshaledCommand );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +53,25 @@ namespace openwire {
         virtual ~OpenWireFormatTest() {}
 
         virtual void testProviderInfoInWireFormat();
+        virtual void testLooseMarshalReusesBuffers();
+        virtual void testTightMarshalReusesBuffers();
+        virtual void testRecycleCommands();
+        virtual void testLooseMarshalCache();
+        virtual void testTightMarshalCache();
+        virtual void testMarshalCacheEviction();
+        virtual void testFrameReadAhead();
+        virtual void testReadFrame();
+        virtual void testGetFrameLength();
+        virtual void testMessageFastPath();
+        virtual void testTightFormCache();
+        virtual void testInternDestinations();
+        virtual void testMarshaledCommand();
+
+    private:
+
+        void doTestMarshalRoundTrip(bool tightEncoding);
+        void doTestMarshalCache(bool tightEncoding);
+        void doTestMessageFastPath(const decaf::lang::Pointer<commands::Message>& message);
 
     };
 
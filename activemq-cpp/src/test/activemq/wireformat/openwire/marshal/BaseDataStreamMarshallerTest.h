@@ -23,6 +23,7 @@
 
 #include <activemq/wireformat/openwire/marshal/BaseDataStreamMarshaller.h>
 #include <activemq/commands/DataStructure.h>
+#include <decaf/lang/Pointer.h>
 
 namespace activemq{
 namespace wireformat{
@@ -224,7 +225,7 @@ namespace marshal{
         public:
 
             bool boolValue;
-            SimpleDataStructure* cachedChild;
+            decaf::lang::Pointer<SimpleDataStructure> cachedChild;
 
         private:
 
@@ -235,21 +236,13 @@ namespace marshal{
 
             const static unsigned char TYPE = 0xFE;
 
-            ComplexDataStructure() : boolValue(), cachedChild(NULL) {}
+            ComplexDataStructure() : boolValue(), cachedChild() {}
 
-            virtual ~ComplexDataStructure(){
-                setCachedChild( NULL );
-            }
+            virtual ~ComplexDataStructure(){}
 
+            // The unmarshaled child can be shared with the wire format's cache.
             void setCachedChild( SimpleDataStructure* child ) {
-                if( cachedChild != NULL ) {
-                    delete cachedChild;
-                    cachedChild = NULL;
-                }
-
-                if( child != NULL ) {
-                    cachedChild = child;
-                }
+                cachedChild.reset( child );
             }
 
             virtual unsigned char getDataStructureType() const {
@@ -269,13 +262,10 @@ namespace marshal{
                 }
                 boolValue = srcObj->boolValue;
 
-                if( cachedChild != NULL ) {
-                    delete cachedChild;
-                    cachedChild = NULL;
-                }
+                cachedChild.reset( NULL );
 
                 if( srcObj->cachedChild != NULL ) {
-                    cachedChild = dynamic_cast<SimpleDataStructure*>(srcObj->cachedChild->cloneDataStructure());
+                    cachedChild.reset( dynamic_cast<SimpleDataStructure*>(srcObj->cachedChild->cloneDataStructure()) );
                 }
             }
         };
@@ -317,7 +307,7 @@ namespace marshal{
 
                 int rc = BaseDataStreamMarshaller::tightMarshal1( wireFormat, dataStructure, bs );
                 bs->writeBoolean( info->boolValue );
-                rc += tightMarshalCachedObject1( wireFormat, info->cachedChild, bs );
+                rc += tightMarshalCachedObject1( wireFormat, info->cachedChild.get(), bs );
 
                 return rc;
             }
@@ -333,7 +323,7 @@ namespace marshal{
                     dynamic_cast<ComplexDataStructure*>( dataStructure );
 
                 bs->readBoolean();
-                tightMarshalCachedObject2( wireFormat, info->cachedChild, dataOut, bs );
+                tightMarshalCachedObject2( wireFormat, info->cachedChild.get(), dataOut, bs );
 
             }
 
@@ -359,7 +349,7 @@ namespace marshal{
                 BaseDataStreamMarshaller::looseMarshal( wireFormat, dataStructure, dataOut );
 
                 dataOut->writeBoolean( info->boolValue );
-                looseMarshalCachedObject( wireFormat, info->cachedChild, dataOut );
+                looseMarshalCachedObject( wireFormat, info->cachedChild.get(), dataOut );
             }
         };
 
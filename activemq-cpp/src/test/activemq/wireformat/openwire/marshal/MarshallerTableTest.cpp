@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MarshallerTableTest.h"
+
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/wireformat/openwire/marshal/DataStreamMarshaller.h>
+#include <activemq/wireformat/openwire/marshal/MarshallerTable.h>
+#include <activemq/wireformat/openwire/marshal/generated/ActiveMQTextMessageMarshaller.h>
+
+#include <memory>
+
+using namespace std;
+using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::marshal;
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTableTest::testStandard() {
+
+    std::auto_ptr<MarshallerTable> table(MarshallerTable::createStandard());
+
+    const unsigned char types[] = {
+        ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE,
+        ActiveMQQueue::ID_ACTIVEMQQUEUE,
+        ConnectionInfo::ID_CONNECTIONINFO
+    };
+
+    for (std::size_t i = 0; i < sizeof(types); ++i) {
+        CPPUNIT_ASSERT(table->get(types[i]) != NULL);
+        CPPUNIT_ASSERT_EQUAL(types[i], table->get(types[i])->getDataStructureType());
+    }
+
+    CPPUNIT_ASSERT(table->isCommand(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE));
+    CPPUNIT_ASSERT(table->isCommand(ConnectionInfo::ID_CONNECTIONINFO));
+    CPPUNIT_ASSERT(!table->isCommand(ActiveMQQueue::ID_ACTIVEMQQUEUE));
+
+    CPPUNIT_ASSERT(table->get(0) == NULL);
+    CPPUNIT_ASSERT(!table->isCommand(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTableTest::testShared() {
+
+    const MarshallerTable* shared = MarshallerTable::getShared();
+    CPPUNIT_ASSERT(shared != NULL);
+    CPPUNIT_ASSERT(shared == MarshallerTable::getShared());
+    CPPUNIT_ASSERT(shared->get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) != NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MarshallerTableTest::testDerived() {
+
+    std::auto_ptr<MarshallerTable> base(MarshallerTable::createStandard());
+    DataStreamMarshaller* standard = base->get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE);
+
+    {
+        MarshallerTable derived(base.get());
+        CPPUNIT_ASSERT(derived.get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) == standard);
+        CPPUNIT_ASSERT(derived.get(ActiveMQQueue::ID_ACTIVEMQQUEUE) == base->get(ActiveMQQueue::ID_ACTIVEMQQUEUE));
+
+        // Replacing an entry the table doesn't own leaves the base as it was.
+        DataStreamMarshaller* generic = new generated::ActiveMQTextMessageMarshaller();
+        derived.add(generic);
+        CPPUNIT_ASSERT(derived.get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) == generic);
+        CPPUNIT_ASSERT(derived.isCommand(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE));
+        CPPUNIT_ASSERT(base->get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) == standard);
+
+        // Replacing one it does own deletes the old one.
+        derived.add(new generated::ActiveMQTextMessageMarshaller());
+        CPPUNIT_ASSERT(derived.get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) != standard);
+    }
+
+    // The derived table is gone and the marshallers of the base are intact.
+    CPPUNIT_ASSERT(base->get(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE) == standard);
+    CPPUNIT_ASSERT_EQUAL(ActiveMQTextMessage::ID_ACTIVEMQTEXTMESSAGE, standard->getDataStructureType());
+}
@@ -158,3 +158,30 @@ void PrimitiveTypesMarshallerTest::testMaps() {
     CPPUNIT_ASSERT( newMap.get() != NULL );
     CPPUNIT_ASSERT( newMap->size() == 3 );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void PrimitiveTypesMarshallerTest::testLargeNumericList() {
+
+    const int COUNT = 10000;
+
+    PrimitiveList numbers;
+    for( int i = 0; i < COUNT; ++i ) {
+        numbers.add( i );
+    }
+
+    PrimitiveMap myMap;
+    myMap.put( "numbers", numbers );
+
+    std::vector<unsigned char> marshaled;
+    PrimitiveTypesMarshaller::marshal( &myMap, marshaled );
+
+    PrimitiveMap newMap;
+    PrimitiveTypesMarshaller::unmarshal( &newMap, marshaled );
+
+    const decaf::util::List<PrimitiveValueNode>& result = newMap.get( "numbers" ).getList();
+    CPPUNIT_ASSERT_EQUAL( COUNT, result.size() );
+    CPPUNIT_ASSERT_EQUAL( 0, result.get( 0 ).getInt() );
+    CPPUNIT_ASSERT_EQUAL( COUNT / 2, result.get( COUNT / 2 ).getInt() );
+    CPPUNIT_ASSERT_EQUAL( COUNT - 1, result.get( COUNT - 1 ).getInt() );
+    CPPUNIT_ASSERT( numbers.equals( result ) );
+}
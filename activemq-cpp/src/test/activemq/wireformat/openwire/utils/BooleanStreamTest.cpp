@@ -99,3 +99,85 @@ void BooleanStreamTest::test2(){
 
     delete [] array.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamTest::testReset() {
+
+    BooleanStream b1Stream;
+
+    for( int i = 0; i < 100; i++ ) {
+        b1Stream.writeBoolean( true );
+    }
+
+    b1Stream.reset();
+    CPPUNIT_ASSERT_EQUAL( 1, b1Stream.marshalledSize() );
+
+    b1Stream.writeBoolean( false );
+    b1Stream.writeBoolean( true );
+    b1Stream.writeBoolean( false );
+    CPPUNIT_ASSERT_EQUAL( 2, b1Stream.marshalledSize() );
+
+    io::ByteArrayOutputStream baoStream;
+    io::DataOutputStream daoStream( &baoStream );
+    b1Stream.marshal( &daoStream );
+
+    BooleanStream b2Stream;
+    std::pair<const unsigned char*, int> array = baoStream.toByteArray();
+    decaf::io::ByteArrayInputStream baiStream( array.first, array.second );
+    decaf::io::DataInputStream daiStream( &baiStream );
+
+    b2Stream.unmarshal( &daiStream );
+
+    // Bits from before the reset must not leak into the new data.
+    CPPUNIT_ASSERT( b2Stream.readBoolean() == false );
+    CPPUNIT_ASSERT( b2Stream.readBoolean() == true );
+    CPPUNIT_ASSERT( b2Stream.readBoolean() == false );
+    CPPUNIT_ASSERT( b2Stream.readBoolean() == false );
+
+    delete [] array.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BooleanStreamTest::testReuseAfterGrowing() {
+
+    BooleanStream bStream;
+
+    // Enough to spill out of the inline storage into the heap.
+    for( int i = 0; i < 600; i++ ) {
+        bStream.writeBoolean( i % 3 == 0 );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 2 + 75, bStream.marshalledSize() );
+
+    io::ByteArrayOutputStream baoStream;
+    io::DataOutputStream daoStream( &baoStream );
+    bStream.marshal( &daoStream );
+
+    std::pair<const unsigned char*, int> array = baoStream.toByteArray();
+    decaf::io::ByteArrayInputStream baiStream( array.first, array.second );
+    decaf::io::DataInputStream daiStream( &baiStream );
+
+    // Reads back into the stream that has already grown.
+    bStream.reset();
+    bStream.unmarshal( &daiStream );
+
+    for( int i = 0; i < 600; i++ ) {
+        CPPUNIT_ASSERT( bStream.readBoolean() == ( i % 3 == 0 ) );
+    }
+
+    delete [] array.first;
+
+    bStream.reset();
+    bStream.writeBoolean( false );
+    bStream.writeBoolean( true );
+    CPPUNIT_ASSERT_EQUAL( 2, bStream.marshalledSize() );
+
+    bStream.clear();
+    CPPUNIT_ASSERT( bStream.readBoolean() == false );
+    CPPUNIT_ASSERT( bStream.readBoolean() == true );
+
+    // The rest of the byte was zeroed by the reset.
+    for( int i = 0; i < 6; i++ ) {
+        CPPUNIT_ASSERT( bStream.readBoolean() == false );
+    }
+}
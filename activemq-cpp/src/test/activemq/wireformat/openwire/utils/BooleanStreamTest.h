@@ -31,6 +31,8 @@ namespace utils{
         CPPUNIT_TEST_SUITE( BooleanStreamTest );
         CPPUNIT_TEST( test );
         CPPUNIT_TEST( test2 );
+        CPPUNIT_TEST( testReset );
+        CPPUNIT_TEST( testReuseAfterGrowing );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -40,6 +42,8 @@ namespace utils{
 
         void test();
         void test2();
+        void testReset();
+        void testReuseAfterGrowing();
     };
 
 }}}}
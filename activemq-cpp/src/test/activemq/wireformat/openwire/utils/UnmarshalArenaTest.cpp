@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UnmarshalArenaTest.h"
+
+#include <activemq/wireformat/openwire/utils/UnmarshalArena.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <cstring>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::openwire;
+using namespace activemq::wireformat::openwire::utils;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+void UnmarshalArenaTest::testAllocate() {
+
+    UnmarshalArena arena(64);
+    CPPUNIT_ASSERT_EQUAL(0LL, arena.getCapacity());
+
+    unsigned char* first = arena.allocate(16);
+    unsigned char* second = arena.allocate(16);
+    CPPUNIT_ASSERT_EQUAL(64LL, arena.getCapacity());
+    CPPUNIT_ASSERT(second == first + 16);
+
+    std::memset(first, 'a', 16);
+    std::memset(second, 'b', 16);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 'a', first[15]);
+    CPPUNIT_ASSERT_EQUAL((unsigned char) 'b', second[0]);
+
+    // Too big for what is left of the first chunk.
+    arena.allocate(48);
+    CPPUNIT_ASSERT_EQUAL(128LL, arena.getCapacity());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnmarshalArenaTest::testLargeAllocation() {
+
+    UnmarshalArena arena(64);
+
+    unsigned char* block = arena.allocate(1000);
+    std::memset(block, 0, 1000);
+    CPPUNIT_ASSERT_EQUAL(1000LL, arena.getCapacity());
+
+    arena.allocate(0);
+    arena.allocate(8);
+    CPPUNIT_ASSERT_EQUAL(1064LL, arena.getCapacity());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnmarshalArenaTest::testReset() {
+
+    UnmarshalArena arena(64);
+
+    unsigned char* first = arena.allocate(32);
+    arena.allocate(64);
+    arena.allocate(64);
+    CPPUNIT_ASSERT_EQUAL(192LL, arena.getCapacity());
+
+    arena.reset();
+    CPPUNIT_ASSERT_EQUAL(64LL, arena.getCapacity());
+    CPPUNIT_ASSERT(arena.allocate(32) == first);
+    CPPUNIT_ASSERT_EQUAL(64LL, arena.getCapacity());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnmarshalArenaTest::testInvalidSizes() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        UnmarshalArena(0),
+        IllegalArgumentException);
+
+    UnmarshalArena arena;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        arena.allocate(-1),
+        IllegalArgumentException);
+}
@@ -0,0 +1,225 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StompFrameTest.h"
+
+#include <activemq/wireformat/stomp/StompFrame.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+#include <decaf/io/FilterInputStream.h>
+#include <decaf/io/IOException.h>
+
+#include <string>
+#include <vector>
+
+using namespace activemq;
+using namespace activemq::wireformat;
+using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Contains embedded nulls so it can't be held in a std::string literal.
+    const char TWO_FRAMES[] =
+        "\nMESSAGE\n"
+        "destination:/queue/test\n"
+        "message-id:ID:1\n"
+        "destination:/queue/ignored\n"
+        "\n"
+        "Hello\0\n"
+        "MESSAGE\n"
+        "destination:/topic/test\n"
+        "content-length:5\n"
+        "\n"
+        "Wo\0ld\0\n";
+
+    class NoMarkInputStream : public FilterInputStream {
+    public:
+
+        NoMarkInputStream(InputStream* inputStream) : FilterInputStream(inputStream, true) {
+        }
+
+        virtual bool markSupported() const {
+            return false;
+        }
+    };
+
+    void checkTwoFrames(DataInputStream& in) {
+
+        StompFrame first;
+        first.fromStream(&in);
+
+        CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), first.getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("/queue/test"), first.getProperty("destination"));
+        CPPUNIT_ASSERT_EQUAL(std::string("ID:1"), first.getProperty("message-id"));
+        CPPUNIT_ASSERT_EQUAL(std::string("Hello"), std::string((const char*) &first.getBody()[0]));
+
+        StompFrame second;
+        second.fromStream(&in);
+
+        CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), second.getCommand());
+        CPPUNIT_ASSERT_EQUAL(std::string("/topic/test"), second.getProperty("destination"));
+        CPPUNIT_ASSERT_EQUAL((std::size_t) 5, second.getBodyLength());
+        CPPUNIT_ASSERT_EQUAL(std::string("Wo\0ld", 5),
+                             std::string((const char*) &second.getBody()[0], second.getBodyLength()));
+
+        // Only the newline that trails the last frame should be left.
+        CPPUNIT_ASSERT_EQUAL(1, in.available());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameTest::StompFrameTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StompFrameTest::~StompFrameTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testFromStream() {
+
+    std::vector<unsigned char> bytes(TWO_FRAMES, TWO_FRAMES + sizeof(TWO_FRAMES) - 1);
+
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+    checkTwoFrames(in);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testFromStreamWithoutMark() {
+
+    std::vector<unsigned char> bytes(TWO_FRAMES, TWO_FRAMES + sizeof(TWO_FRAMES) - 1);
+
+    DataInputStream in(new NoMarkInputStream(new ByteArrayInputStream(bytes)), true);
+    CPPUNIT_ASSERT(!in.markSupported());
+    checkTwoFrames(in);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testFromStreamLongHeader() {
+
+    // A header longer than the read window has to be assembled from several reads.
+    std::string value(2000, 'x');
+    std::string data = "MESSAGE\nlong:" + value + "\n\nbody";
+    data.push_back('\0');
+
+    std::vector<unsigned char> bytes(data.begin(), data.end());
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+
+    StompFrame frame;
+    frame.fromStream(&in);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("MESSAGE"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(value, frame.getProperty("long"));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 5, frame.getBodyLength());
+    CPPUNIT_ASSERT_EQUAL(0, in.available());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testRoundTrip() {
+
+    StompFrame frame;
+    frame.setCommand("SEND");
+    frame.setProperty("destination", "/queue/test");
+    frame.setProperty("receipt", "1");
+    std::string text = "Hello World";
+    frame.setBody((const unsigned char*) text.c_str(), text.size());
+    frame.setProperty("content-length", "11");
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream out(&bytesOut);
+    frame.toStream(&out);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> bytes(array.first, array.first + array.second);
+    delete [] array.first;
+
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+
+    StompFrame result;
+    result.fromStream(&in);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("SEND"), result.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("/queue/test"), result.getProperty("destination"));
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), result.getProperty("receipt"));
+    CPPUNIT_ASSERT_EQUAL(text, std::string((const char*) &result.getBody()[0], result.getBodyLength()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testEscapedHeaders() {
+
+    StompFrame frame;
+    frame.setCommand("SEND");
+    frame.setProperty("destination", "/queue/test");
+    frame.setProperty("key:name", "line one\nline\\two");
+
+    ByteArrayOutputStream bytesOut;
+    DataOutputStream out(&bytesOut);
+    frame.toStream(&out, true);
+
+    std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+    std::vector<unsigned char> bytes(array.first, array.first + array.second);
+    delete [] array.first;
+
+    std::string written((const char*) &bytes[0], bytes.size());
+    CPPUNIT_ASSERT(written.find("key\\cname:line one\\nline\\\\two\n") != std::string::npos);
+
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+
+    StompFrame result;
+    result.fromStream(&in, true, false);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("/queue/test"), result.getProperty("destination"));
+    CPPUNIT_ASSERT_EQUAL(std::string("line one\nline\\two"), result.getProperty("key:name"));
+
+    std::string data = "MESSAGE\nbad:\\t\n\n";
+    data.push_back('\0');
+    std::vector<unsigned char> badBytes(data.begin(), data.end());
+    DataInputStream badIn(new ByteArrayInputStream(badBytes), true);
+
+    StompFrame bad;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException for an undefined escape",
+        bad.fromStream(&badIn, true, false),
+        decaf::io::IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompFrameTest::testHeartBeat() {
+
+    std::string data = "\n\nRECEIPT\nreceipt-id:1\n\n";
+    data.push_back('\0');
+    std::vector<unsigned char> bytes(data.begin(), data.end());
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+
+    StompFrame frame;
+    frame.fromStream(&in, false, true);
+    CPPUNIT_ASSERT(frame.isHeartBeat());
+
+    frame.fromStream(&in, false, true);
+    CPPUNIT_ASSERT(frame.isHeartBeat());
+
+    frame.fromStream(&in, false, true);
+    CPPUNIT_ASSERT(!frame.isHeartBeat());
+    CPPUNIT_ASSERT_EQUAL(std::string("RECEIPT"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), frame.getProperty("receipt-id"));
+}
@@ -47,6 +47,8 @@ void StompWireFormatFactoryTest::testCreateWireFormat() {
     properties.setProperty("wireFormat.queuePrefix", "/test-queue/");
     properties.setProperty("wireFormat.tempTopicPrefix", "/test-temp-topic/");
     properties.setProperty("wireFormat.tempQueuePrefix", "/test-temp-queue/");
+    properties.setProperty("wireFormat.outgoingHeartBeat", "10000");
+    properties.setProperty("wireFormat.incomingHeartBeat", "20000");
 
     Pointer<WireFormat> format(factory.createWireFormat(properties));
 
@@ -56,4 +58,7 @@ void StompWireFormatFactoryTest::testCreateWireFormat() {
     CPPUNIT_ASSERT_EQUAL(std::string("/test-queue/"), stomp->getQueuePrefix());
     CPPUNIT_ASSERT_EQUAL(std::string("/test-temp-topic/"), stomp->getTempTopicPrefix());
     CPPUNIT_ASSERT_EQUAL(std::string("/test-temp-queue/"), stomp->getTempQueuePrefix());
+    CPPUNIT_ASSERT_EQUAL(10000LL, stomp->getOutgoingHeartBeat());
+    CPPUNIT_ASSERT_EQUAL(20000LL, stomp->getIncomingHeartBeat());
+    CPPUNIT_ASSERT(stomp->hasNegotiator());
 }
@@ -20,10 +20,53 @@
 #include <activemq/wireformat/stomp/StompFrame.h>
 #include <activemq/wireformat/stomp/StompHelper.h>
 #include <activemq/wireformat/stomp/StompWireFormat.h>
+#include <activemq/commands/ActiveMQBytesMessage.h>
+#include <activemq/commands/ActiveMQQueue.h>
+#include <activemq/commands/ActiveMQTextMessage.h>
+#include <activemq/commands/ConnectionInfo.h>
+#include <activemq/commands/ConsumerId.h>
+#include <activemq/commands/MessageAck.h>
+#include <activemq/commands/MessageId.h>
+#include <activemq/commands/ProducerId.h>
+#include <activemq/commands/Response.h>
+#include <activemq/transport/IOTransport.h>
+
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/io/DataInputStream.h>
+#include <decaf/io/DataOutputStream.h>
+
+#include <string>
+#include <vector>
 
 using namespace activemq;
+using namespace activemq::commands;
+using namespace activemq::transport;
 using namespace activemq::wireformat;
 using namespace activemq::wireformat::stomp;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    // Marshals the command and reads the bytes written back as a frame.
+    void marshalAndRead(StompWireFormat& wireformat, const Pointer<Command>& command,
+                        StompFrame& frame, bool escaped = false) {
+
+        ByteArrayOutputStream bytesOut;
+        DataOutputStream out(&bytesOut);
+        wireformat.marshal(command, NULL, &out);
+
+        std::pair<unsigned char*, int> array = bytesOut.toByteArray();
+        std::vector<unsigned char> bytes(array.first, array.first + array.second);
+        delete [] array.first;
+
+        DataInputStream in(new ByteArrayInputStream(bytes), true);
+        frame.fromStream(&in, escaped, false);
+    }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 StompWireFormatTest::StompWireFormatTest() {
@@ -46,3 +89,147 @@ void StompWireFormatTest::testChangeDestinationPrefix() {
     frame.setProperty("subscription", "connection:1:1:0:1");
     frame.setProperty("message-id", "connection:1:1:0:1");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testMarshalTextMessage() {
+
+    StompWireFormat wireformat;
+
+    Pointer<ActiveMQTextMessage> message(new ActiveMQTextMessage());
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    message->setCommandId(12);
+    message->setResponseRequired(true);
+    message->setPriority(7);
+    message->setTimestamp(1234567890123LL);
+    message->setText("Hello World");
+    message->setIntProperty("count", -42);
+    message->setStringProperty("priority", "high");
+
+    StompFrame frame;
+    marshalAndRead(wireformat, message, frame);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("SEND"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("/queue/TEST.QUEUE"), frame.getProperty("destination"));
+    CPPUNIT_ASSERT_EQUAL(std::string("12"), frame.getProperty("receipt"));
+    CPPUNIT_ASSERT_EQUAL(std::string("1234567890123"), frame.getProperty("timestamp"));
+    CPPUNIT_ASSERT_EQUAL(std::string("-42"), frame.getProperty("count"));
+    CPPUNIT_ASSERT_EQUAL(std::string("high"), frame.getProperty("priority"));
+    CPPUNIT_ASSERT(!frame.hasProperty("content-length"));
+    CPPUNIT_ASSERT(frame.getBodyLength() >= 11);
+    CPPUNIT_ASSERT_EQUAL(std::string("Hello World"), std::string((const char*) &frame.getBody()[0], 11));
+
+    // The cached destination header must follow a change of destination.
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("OTHER.QUEUE")));
+
+    StompFrame second;
+    marshalAndRead(wireformat, message, second);
+    CPPUNIT_ASSERT_EQUAL(std::string("/queue/OTHER.QUEUE"), second.getProperty("destination"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testMarshalBytesMessage() {
+
+    StompWireFormat wireformat;
+
+    unsigned char bytes[] = { 1, 0, 2, 0, 3 };
+
+    Pointer<ActiveMQBytesMessage> message(new ActiveMQBytesMessage());
+    message->setDestination(Pointer<ActiveMQDestination>(new ActiveMQQueue("TEST.QUEUE")));
+    message->writeBytes(bytes, 0, 5);
+    message->onSend();
+
+    StompFrame frame;
+    marshalAndRead(wireformat, message, frame);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("SEND"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("5"), frame.getProperty("content-length"));
+    CPPUNIT_ASSERT(!frame.hasProperty("receipt"));
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 5, frame.getBodyLength());
+    CPPUNIT_ASSERT(std::vector<unsigned char>(bytes, bytes + 5) == frame.getBody());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testMarshalAck() {
+
+    StompWireFormat wireformat;
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:host-1234-1:0");
+    Pointer<MessageId> messageId(new MessageId());
+    messageId->setProducerId(producerId);
+
+    Pointer<MessageAck> ack(new MessageAck());
+    ack->setLastMessageId(messageId);
+    ack->setCommandId(5);
+    ack->setResponseRequired(true);
+
+    StompFrame frame;
+    marshalAndRead(wireformat, ack, frame);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ACK"), frame.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-1234-1:0"), frame.getProperty("message-id"));
+    CPPUNIT_ASSERT_EQUAL(std::string("ignore:5"), frame.getProperty("receipt"));
+    CPPUNIT_ASSERT(!frame.hasProperty("transaction"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StompWireFormatTest::testHeartBeatNegotiation() {
+
+    StompWireFormat wireformat;
+    CPPUNIT_ASSERT(!wireformat.hasNegotiator());
+
+    wireformat.setOutgoingHeartBeat(1000);
+    wireformat.setIncomingHeartBeat(2000);
+    CPPUNIT_ASSERT(wireformat.hasNegotiator());
+
+    Pointer<ConnectionInfo> info(new ConnectionInfo());
+    info->setClientId("client");
+    info->setCommandId(1);
+
+    StompFrame connect;
+    marshalAndRead(wireformat, info, connect);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("CONNECT"), connect.getCommand());
+    CPPUNIT_ASSERT_EQUAL(std::string("1.0,1.1"), connect.getProperty("accept-version"));
+    CPPUNIT_ASSERT_EQUAL(std::string("1000,2000"), connect.getProperty("heart-beat"));
+
+    // The broker can send every 5 seconds and wants a heart-beat every half second,
+    // followed by one heart-beat of its own.
+    std::string data = "CONNECTED\nversion:1.1\nheart-beat:5000,500\n\n";
+    data.push_back('\0');
+    data.append("\n");
+    std::vector<unsigned char> bytes(data.begin(), data.end());
+    DataInputStream in(new ByteArrayInputStream(bytes), true);
+
+    IOTransport transport;
+    Pointer<Command> response = wireformat.unmarshal(&transport, &in);
+    CPPUNIT_ASSERT(response->isResponse());
+    CPPUNIT_ASSERT_EQUAL(1, response.dynamicCast<Response>()->getCorrelationId());
+    CPPUNIT_ASSERT_EQUAL(1000LL, wireformat.getSendHeartBeatInterval());
+    CPPUNIT_ASSERT_EQUAL(5000LL, wireformat.getReceiveHeartBeatInterval());
+
+    CPPUNIT_ASSERT(wireformat.unmarshal(&transport, &in)->isKeepAliveInfo());
+
+    // Under STOMP 1.1 an ack names the subscription of the message.
+    Pointer<ConsumerId> consumerId(new ConsumerId());
+    consumerId->setConnectionId("ID:host-1234-1:0");
+    consumerId->setSessionId(1);
+    consumerId->setValue(2);
+
+    Pointer<ProducerId> producerId(new ProducerId());
+    producerId->setConnectionId("ID:host-1234-1:0");
+    Pointer<MessageId> messageId(new MessageId());
+    messageId->setProducerId(producerId);
+
+    Pointer<MessageAck> ack(new MessageAck());
+    ack->setLastMessageId(messageId);
+    ack->setConsumerId(consumerId);
+
+    StompFrame frame;
+    marshalAndRead(wireformat, ack, frame, true);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("ID:host-1234-1:0"), frame.getProperty("message-id"));
+
+    StompHelper helper(&wireformat);
+    CPPUNIT_ASSERT_EQUAL(helper.convertConsumerId(consumerId), frame.getProperty("subscription"));
+}
@@ -29,6 +29,10 @@ namespace stomp {
 
         CPPUNIT_TEST_SUITE( StompWireFormatTest );
         CPPUNIT_TEST( testChangeDestinationPrefix );
+        CPPUNIT_TEST( testMarshalTextMessage );
+        CPPUNIT_TEST( testMarshalBytesMessage );
+        CPPUNIT_TEST( testMarshalAck );
+        CPPUNIT_TEST( testHeartBeatNegotiation );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +41,10 @@ namespace stomp {
         virtual ~StompWireFormatTest();
 
         virtual void testChangeDestinationPrefix();
+        virtual void testMarshalTextMessage();
+        virtual void testMarshalBytesMessage();
+        virtual void testMarshalAck();
+        virtual void testHeartBeatNegotiation();
 
     };
 
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPoolTest.h"
+
+#include <decaf/internal/io/BufferPool.h>
+#include <decaf/io/BufferedInputStream.h>
+#include <decaf/io/BufferedOutputStream.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::internal;
+using namespace decaf::internal::io;
+
+////////////////////////////////////////////////////////////////////////////////
+BufferPoolTest::BufferPoolTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BufferPoolTest::~BufferPoolTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::tearDown() {
+    BufferPool::setEnabled(false);
+    BufferPool::setMaxReserved(BufferPool::DEFAULT_MAX_RESERVED);
+    BufferPool::resetStatistics();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testDisabledUsesHeap() {
+
+    BufferPool::setEnabled(false);
+    BufferPool::resetStatistics();
+
+    BufferPool::Statistics before = BufferPool::getStatistics();
+
+    unsigned char* buffer = BufferPool::allocate(8192);
+    CPPUNIT_ASSERT(buffer != NULL);
+    std::memset(buffer, 0xAB, 8192);
+    BufferPool::release(buffer);
+
+    BufferPool::Statistics after = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(0LL, after.hits);
+    CPPUNIT_ASSERT_EQUAL(0LL, after.misses);
+    CPPUNIT_ASSERT_EQUAL(before.slabs, after.slabs);
+    CPPUNIT_ASSERT_EQUAL(before.buffersInUse, after.buffersInUse);
+
+    BufferPool::release(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testReleasedBufferIsReused() {
+
+    BufferPool::setEnabled(true);
+    BufferPool::resetStatistics();
+
+    int inUse = BufferPool::getStatistics().buffersInUse;
+
+    unsigned char* first = BufferPool::allocate(8192);
+    BufferPool::Statistics statistics = BufferPool::getStatistics();
+    CPPUNIT_ASSERT_EQUAL(1LL, statistics.hits + statistics.misses);
+    CPPUNIT_ASSERT_EQUAL(inUse + 1, statistics.buffersInUse);
+    CPPUNIT_ASSERT(statistics.slabs > 0);
+    CPPUNIT_ASSERT_EQUAL((long long) statistics.slabs * BufferPool::SLAB_SIZE, statistics.reservedBytes);
+
+    std::memset(first, 0xCD, 8192);
+    BufferPool::release(first);
+    CPPUNIT_ASSERT_EQUAL(inUse, BufferPool::getStatistics().buffersInUse);
+
+    long long hits = BufferPool::getStatistics().hits;
+    unsigned char* second = BufferPool::allocate(8000);
+    CPPUNIT_ASSERT(first == second);
+    CPPUNIT_ASSERT_EQUAL(hits + 1, BufferPool::getStatistics().hits);
+
+    BufferPool::release(second);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testSizeClasses() {
+
+    BufferPool::setEnabled(true);
+
+    // Buffers of one class never overlap.
+    std::vector<unsigned char*> buffers;
+    for (int i = 0; i < 8; ++i) {
+        unsigned char* buffer = BufferPool::allocate(BufferPool::MIN_BUFFER_SIZE * 4);
+        std::memset(buffer, i, BufferPool::MIN_BUFFER_SIZE * 4);
+        buffers.push_back(buffer);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        CPPUNIT_ASSERT_EQUAL((unsigned char) i, buffers[i][0]);
+        CPPUNIT_ASSERT_EQUAL((unsigned char) i, buffers[i][BufferPool::MIN_BUFFER_SIZE * 4 - 1]);
+        BufferPool::release(buffers[i]);
+    }
+
+    // Small and oversized requests are served as well.
+    unsigned char* small = BufferPool::allocate(1);
+    unsigned char* empty = BufferPool::allocate(0);
+    unsigned char* large = BufferPool::allocate(BufferPool::SLAB_SIZE + 1);
+    large[BufferPool::SLAB_SIZE] = 1;
+
+    BufferPool::release(small);
+    BufferPool::release(empty);
+    BufferPool::release(large);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testReservationLimit() {
+
+    BufferPool::setEnabled(true);
+
+    // With no room for another slab a request no free buffer fits goes to the heap.
+    BufferPool::setMaxReserved(0);
+    BufferPool::resetStatistics();
+
+    int slabs = BufferPool::getStatistics().slabs;
+    int inUse = BufferPool::getStatistics().buffersInUse;
+
+    unsigned char* buffer = BufferPool::allocate(BufferPool::SLAB_SIZE);
+    BufferPool::Statistics statistics = BufferPool::getStatistics();
+
+    CPPUNIT_ASSERT_EQUAL(slabs, statistics.slabs);
+    if (statistics.misses == 1) {
+        CPPUNIT_ASSERT_EQUAL(inUse, statistics.buffersInUse);
+    }
+
+    BufferPool::release(buffer);
+    CPPUNIT_ASSERT_EQUAL(inUse, BufferPool::getStatistics().buffersInUse);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testReleaseAfterDisable() {
+
+    BufferPool::setEnabled(true);
+    int inUse = BufferPool::getStatistics().buffersInUse;
+
+    unsigned char* pooled = BufferPool::allocate(8192);
+
+    BufferPool::setEnabled(false);
+    unsigned char* heap = BufferPool::allocate(8192);
+
+    BufferPool::release(pooled);
+    BufferPool::release(heap);
+
+    CPPUNIT_ASSERT_EQUAL(inUse, BufferPool::getStatistics().buffersInUse);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferPoolTest::testBufferedStreams() {
+
+    BufferPool::setEnabled(true);
+    int inUse = BufferPool::getStatistics().buffersInUse;
+
+    std::vector<unsigned char> data(20000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = (unsigned char) (i % 251);
+    }
+
+    ByteArrayOutputStream sink;
+    {
+        BufferedOutputStream output(&sink, 8192);
+        CPPUNIT_ASSERT_EQUAL(inUse + 1, BufferPool::getStatistics().buffersInUse);
+        output.write(&data[0], (int) data.size());
+        output.flush();
+    }
+
+    std::pair<unsigned char*, int> written = sink.toByteArray();
+    std::vector<unsigned char> copy(written.first, written.first + written.second);
+    delete [] written.first;
+    CPPUNIT_ASSERT(copy == data);
+
+    {
+        ByteArrayInputStream source(copy);
+        BufferedInputStream input(&source, 8192);
+        CPPUNIT_ASSERT_EQUAL(inUse + 1, BufferPool::getStatistics().buffersInUse);
+
+        std::vector<unsigned char> read(data.size());
+        int total = 0;
+        while (total < (int) read.size()) {
+            int count = input.read(&read[0], (int) read.size(), total, (int) read.size() - total);
+            CPPUNIT_ASSERT(count > 0);
+            total += count;
+        }
+        CPPUNIT_ASSERT(read == data);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(inUse, BufferPool::getStatistics().buffersInUse);
+}
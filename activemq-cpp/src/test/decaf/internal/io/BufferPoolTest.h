@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_IO_BUFFERPOOLTEST_H_
+#define _DECAF_INTERNAL_IO_BUFFERPOOLTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace io {
+
+    class BufferPoolTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( BufferPoolTest );
+        CPPUNIT_TEST( testDisabledUsesHeap );
+        CPPUNIT_TEST( testReleasedBufferIsReused );
+        CPPUNIT_TEST( testSizeClasses );
+        CPPUNIT_TEST( testReservationLimit );
+        CPPUNIT_TEST( testReleaseAfterDisable );
+        CPPUNIT_TEST( testBufferedStreams );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        BufferPoolTest();
+        virtual ~BufferPoolTest();
+
+        virtual void tearDown();
+
+        void testDisabledUsesHeap();
+        void testReleasedBufferIsReused();
+        void testSizeClasses();
+        void testReservationLimit();
+        void testReleaseAfterDisable();
+        void testBufferedStreams();
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_IO_BUFFERPOOLTEST_H_ */
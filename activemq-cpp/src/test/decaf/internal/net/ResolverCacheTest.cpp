@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResolverCacheTest.h"
+
+#include <decaf/internal/net/ResolverCache.h>
+#include <decaf/lang/Thread.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::lang;
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCacheTest::testResolve() {
+
+    ResolverCache cache;
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    std::vector<unsigned char> address = cache.resolve("127.0.0.1");
+
+    CPPUNIT_ASSERT_EQUAL(4, (int) address.size());
+    CPPUNIT_ASSERT_EQUAL(127, (int) address[0]);
+    CPPUNIT_ASSERT_EQUAL(1, (int) address[3]);
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+
+    // The second lookup is answered from the cache.
+    CPPUNIT_ASSERT(address == cache.resolve("127.0.0.1"));
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCacheTest::testResolveAsync() {
+
+    ResolverCache cache;
+    cache.resolveAsync("127.0.0.1");
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+
+    // Waits for the background lookup if it is still in progress.
+    std::vector<unsigned char> address = cache.resolve("127.0.0.1");
+    CPPUNIT_ASSERT_EQUAL(4, (int) address.size());
+    CPPUNIT_ASSERT_EQUAL(127, (int) address[0]);
+
+    cache.shutdown();
+    cache.resolveAsync("127.0.0.2");
+    CPPUNIT_ASSERT_EQUAL(4, (int) cache.resolve("127.0.0.2").size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCacheTest::testStaleEntryServed() {
+
+    ResolverCache cache;
+    cache.setTimeToLive(0);
+    cache.setStaleTime(60 * 1000);
+
+    std::vector<unsigned char> address = cache.resolve("127.0.0.1");
+
+    // Every entry is stale at once, it is handed out while it is refreshed.
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT(address == cache.resolve("127.0.0.1"));
+        Thread::sleep(5);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ResolverCacheTest::testClear() {
+
+    ResolverCache cache;
+    cache.resolve("127.0.0.1");
+    cache.resolve("127.0.0.2");
+    CPPUNIT_ASSERT_EQUAL(2, cache.size());
+
+    cache.clear();
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+
+    CPPUNIT_ASSERT_EQUAL(4, (int) cache.resolve("127.0.0.1").size());
+}
@@ -0,0 +1,240 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "URIViewTest.h"
+
+#include <decaf/internal/net/URIView.h>
+#include <decaf/net/URISyntaxException.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::net;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    int errorIndex(const std::string& uri, bool forceServer = false) {
+        URIView view;
+        view.scan(uri);
+        try {
+            view.validate(forceServer);
+        } catch (URISyntaxException& ex) {
+            return ex.getIndex();
+        }
+        return -1;
+    }
+
+    bool isValidIPv4(const char* host) {
+        return URIView::isValidIPv4Address(host, ::strlen(host));
+    }
+
+    bool isValidIPv6(const char* host) {
+        return URIView::isValidIPv6Address(host, ::strlen(host));
+    }
+
+    bool isValidDomain(const char* host) {
+        return URIView::isValidDomainName(host, ::strlen(host));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testScanServerURI() {
+
+    std::string uri = "tcp://user@broker.example.com:61616/path?wireFormat.maxInactivityDuration=0#frag";
+
+    URIView view;
+    view.scan(uri);
+
+    CPPUNIT_ASSERT(view.isAbsolute());
+    CPPUNIT_ASSERT(!view.isOpaque());
+    CPPUNIT_ASSERT_EQUAL(std::string("tcp"), view.toString(view.getScheme()));
+    CPPUNIT_ASSERT_EQUAL(std::string("//user@broker.example.com:61616/path?wireFormat.maxInactivityDuration=0"),
+                         view.toString(view.getSchemeSpecificPart()));
+    CPPUNIT_ASSERT_EQUAL(std::string("user@broker.example.com:61616"), view.toString(view.getAuthority()));
+    CPPUNIT_ASSERT_EQUAL(std::string("user"), view.toString(view.getUserInfo()));
+    CPPUNIT_ASSERT_EQUAL(std::string("broker.example.com"), view.toString(view.getHost()));
+    CPPUNIT_ASSERT_EQUAL(61616, view.getPort());
+    CPPUNIT_ASSERT_EQUAL(std::string("/path"), view.toString(view.getPath()));
+    CPPUNIT_ASSERT_EQUAL(std::string("wireFormat.maxInactivityDuration=0"), view.toString(view.getQuery()));
+    CPPUNIT_ASSERT_EQUAL(std::string("frag"), view.toString(view.getFragment()));
+
+    // The components are offsets into the scanned string.
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 11, view.getHost().offset);
+    CPPUNIT_ASSERT(&uri == &view.getSource());
+
+    CPPUNIT_ASSERT(!view.isServerAuthority());
+    view.validate(false);
+    CPPUNIT_ASSERT(view.isServerAuthority());
+
+    std::string ipv6 = "tcp://[::1]:61616";
+    view.scan(ipv6);
+    CPPUNIT_ASSERT_EQUAL(std::string("[::1]"), view.toString(view.getHost()));
+    CPPUNIT_ASSERT_EQUAL(61616, view.getPort());
+    view.validate(true);
+    CPPUNIT_ASSERT(view.isServerAuthority());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testScanOpaqueURI() {
+
+    std::string uri = "failover:(tcp://a:61616,tcp://b:61616)?randomize=false";
+
+    URIView view;
+    view.scan(uri);
+    view.validate(false);
+
+    CPPUNIT_ASSERT(view.isAbsolute());
+    CPPUNIT_ASSERT(view.isOpaque());
+    CPPUNIT_ASSERT_EQUAL(std::string("failover"), view.toString(view.getScheme()));
+    CPPUNIT_ASSERT_EQUAL(std::string("(tcp://a:61616,tcp://b:61616)?randomize=false"),
+                         view.toString(view.getSchemeSpecificPart()));
+    CPPUNIT_ASSERT(view.getAuthority().isEmpty());
+    CPPUNIT_ASSERT(view.getPath().isEmpty());
+    CPPUNIT_ASSERT(view.getQuery().isEmpty());
+    CPPUNIT_ASSERT(!view.isServerAuthority());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testScanRelativeURI() {
+
+    std::string uri = "mai/lto:hey?joe#man";
+
+    URIView view;
+    view.scan(uri);
+    view.validate(false);
+
+    CPPUNIT_ASSERT(!view.isAbsolute());
+    CPPUNIT_ASSERT(!view.isOpaque());
+    CPPUNIT_ASSERT(view.getScheme().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(std::string("mai/lto:hey"), view.toString(view.getPath()));
+    CPPUNIT_ASSERT_EQUAL(std::string("joe"), view.toString(view.getQuery()));
+    CPPUNIT_ASSERT_EQUAL(std::string("man"), view.toString(view.getFragment()));
+
+    std::string authority = "//host?query";
+    view.scan(authority);
+    view.validate(false);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("host"), view.toString(view.getAuthority()));
+    CPPUNIT_ASSERT(view.getPath().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(std::string("query"), view.toString(view.getQuery()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testScanDoesNotValidate() {
+
+    std::string uri = "http://host name:8x/a path?a query";
+
+    URIView view;
+    CPPUNIT_ASSERT_NO_THROW(view.scan(uri));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("host name"), view.toString(view.getHost()));
+    CPPUNIT_ASSERT_EQUAL(-1, view.getPort());
+    CPPUNIT_ASSERT_EQUAL(std::string("/a path"), view.toString(view.getPath()));
+    CPPUNIT_ASSERT_EQUAL(std::string("a query"), view.toString(view.getQuery()));
+
+    CPPUNIT_ASSERT_THROW(view.validate(false), URISyntaxException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testValidate() {
+
+    CPPUNIT_ASSERT_EQUAL(-1, errorIndex("http://host/a%20path#frag"));
+    CPPUNIT_ASSERT_EQUAL(-1, errorIndex("ht123-+tp://www.google.com:80/test"));
+
+    // The index is the offset of the offending character in the whole string.
+    CPPUNIT_ASSERT_EQUAL(0, errorIndex(":abc@mymail.com"));
+    CPPUNIT_ASSERT_EQUAL(0, errorIndex("1http://host"));
+    CPPUNIT_ASSERT_EQUAL(8, errorIndex("ascheme:"));
+    CPPUNIT_ASSERT_EQUAL(4, errorIndex("path[one"));
+    CPPUNIT_ASSERT_EQUAL(13, errorIndex("http://host/a%path#frag"));
+    CPPUNIT_ASSERT_EQUAL(13, errorIndex("http://host#a frag"));
+    CPPUNIT_ASSERT_EQUAL(18, errorIndex("http://host/path?a query#frag"));
+    CPPUNIT_ASSERT_EQUAL(11, errorIndex("http://host name/path"));
+    CPPUNIT_ASSERT_EQUAL(11, errorIndex("mailto:user^name@fklkf.com"));
+    CPPUNIT_ASSERT_EQUAL(2, errorIndex("//"));
+    CPPUNIT_ASSERT_EQUAL(9, errorIndex("http://us[]er@host/path"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testValidateRegistryAuthority() {
+
+    std::string uri = "http://host:-8096/path";
+
+    URIView view;
+    view.scan(uri);
+    view.validate(false);
+
+    CPPUNIT_ASSERT(!view.isServerAuthority());
+    CPPUNIT_ASSERT_EQUAL(-1, view.getPort());
+
+    CPPUNIT_ASSERT_EQUAL(-1, errorIndex("http://host%20name/"));
+    CPPUNIT_ASSERT_EQUAL(-1, errorIndex("http://joe@:80"));
+
+    CPPUNIT_ASSERT_EQUAL(12, errorIndex("http://host:-8096/path", true));
+    CPPUNIT_ASSERT_EQUAL(11, errorIndex("http://joe@:80", true));
+    CPPUNIT_ASSERT_EQUAL(7, errorIndex("http://host%20name/", true));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testValidateServerAuthority() {
+
+    std::string uri = "//user@host:61616";
+
+    URIView view;
+    view.scan(uri);
+
+    CPPUNIT_ASSERT(view.validateServerAuthority(false));
+    CPPUNIT_ASSERT(view.isServerAuthority());
+
+    std::string registry = "//host:port";
+    view.scan(registry);
+
+    CPPUNIT_ASSERT(!view.validateServerAuthority(false));
+    CPPUNIT_ASSERT_THROW(view.validateServerAuthority(true), URISyntaxException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void URIViewTest::testHostAddresses() {
+
+    CPPUNIT_ASSERT(isValidIPv4("127.0.0.1"));
+    CPPUNIT_ASSERT(isValidIPv4("255.255.255.255"));
+    CPPUNIT_ASSERT(!isValidIPv4("256.0.0.1"));
+    CPPUNIT_ASSERT(!isValidIPv4("1.2.3"));
+    CPPUNIT_ASSERT(!isValidIPv4("1.2.3.4.5"));
+    CPPUNIT_ASSERT(!isValidIPv4("1..3.4"));
+    CPPUNIT_ASSERT(!isValidIPv4("1.2.3.a"));
+
+    CPPUNIT_ASSERT(isValidIPv6("[::1]"));
+    CPPUNIT_ASSERT(isValidIPv6("3ffe:2a00:100:7031::1"));
+    CPPUNIT_ASSERT(isValidIPv6("[::ffff:127.0.0.1]"));
+    CPPUNIT_ASSERT(isValidIPv6("1:2:3:4:5:6:7:8"));
+    CPPUNIT_ASSERT(!isValidIPv6("[ipv6address]"));
+    CPPUNIT_ASSERT(!isValidIPv6("3ffe:2x00:100:7031::1"));
+    CPPUNIT_ASSERT(!isValidIPv6("1:2:3:4:5:6:7"));
+    CPPUNIT_ASSERT(!isValidIPv6("1::2::3"));
+
+    CPPUNIT_ASSERT(isValidDomain("localhost"));
+    CPPUNIT_ASSERT(isValidDomain("broker-1.example.com"));
+    CPPUNIT_ASSERT(!isValidDomain("-broker.example.com"));
+    CPPUNIT_ASSERT(!isValidDomain("broker.example.1com"));
+    CPPUNIT_ASSERT(!isValidDomain("host%20name"));
+    CPPUNIT_ASSERT(!isValidDomain("."));
+}
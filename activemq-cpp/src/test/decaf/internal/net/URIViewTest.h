@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_NET_URIVIEWTEST_H_
+#define _DECAF_INTERNAL_NET_URIVIEWTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace decaf {
+namespace internal {
+namespace net {
+
+    class URIViewTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( URIViewTest );
+        CPPUNIT_TEST( testScanServerURI );
+        CPPUNIT_TEST( testScanOpaqueURI );
+        CPPUNIT_TEST( testScanRelativeURI );
+        CPPUNIT_TEST( testScanDoesNotValidate );
+        CPPUNIT_TEST( testValidate );
+        CPPUNIT_TEST( testValidateRegistryAuthority );
+        CPPUNIT_TEST( testValidateServerAuthority );
+        CPPUNIT_TEST( testHostAddresses );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        URIViewTest() {}
+        virtual ~URIViewTest() {}
+
+        void testScanServerURI();
+        void testScanOpaqueURI();
+        void testScanRelativeURI();
+        void testScanDoesNotValidate();
+        void testValidate();
+        void testValidateRegistryAuthority();
+        void testValidateServerAuthority();
+        void testHostAddresses();
+
+    };
+
+}}}
+
+#endif /* _DECAF_INTERNAL_NET_URIVIEWTEST_H_ */
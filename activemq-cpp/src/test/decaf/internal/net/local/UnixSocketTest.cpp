@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UnixSocketTest.h"
+
+#include <decaf/internal/net/local/UnixSocket.h>
+#include <decaf/io/InputStream.h>
+#include <decaf/io/OutputStream.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/System.h>
+#include <decaf/net/Socket.h>
+#include <decaf/net/SocketException.h>
+
+#include <memory>
+#include <stdio.h>
+
+using namespace decaf;
+using namespace decaf::internal;
+using namespace decaf::internal::net;
+using namespace decaf::internal::net::local;
+using namespace decaf::internal::net::tcp;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::net;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    std::string createPath() {
+        return "/tmp/decaf-unixsocket-" + Long::toString(System::nanoTime()) + ".sock";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocketTest::testTransfer() {
+
+    if (!UnixSocket::isSupported()) {
+        return;
+    }
+
+    std::string path = createPath();
+
+    UnixSocket server;
+    server.create();
+    server.bind(path, 0);
+    server.listen(1);
+
+    Socket client(new UnixSocket());
+    client.connect(path, 0, 1000);
+    CPPUNIT_ASSERT(client.isConnected());
+
+    TcpSocket worker;
+    server.accept(&worker);
+
+    client.getOutputStream()->write((const unsigned char*) "hello", 5, 0, 5);
+    client.getOutputStream()->flush();
+
+    unsigned char buffer[5] = { 0 };
+    int count = 0;
+    while (count < 5) {
+        count += worker.read(buffer, 5, count, 5 - count);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::string("hello"), std::string((const char*) buffer, 5));
+
+    client.close();
+    worker.close();
+    server.close();
+
+    // Closing the bound socket removes its path.
+    CPPUNIT_ASSERT(::remove(path.c_str()) != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocketTest::testConnectMissingPath() {
+
+    if (!UnixSocket::isSupported()) {
+        return;
+    }
+
+    Socket client(new UnixSocket());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IOException when nothing listens on the path",
+        client.connect(createPath(), 0, 1000),
+        IOException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void UnixSocketTest::testTcpOptionsIgnored() {
+
+    if (!UnixSocket::isSupported()) {
+        return;
+    }
+
+    Socket client(new UnixSocket());
+
+    client.setTcpNoDelay(true);
+    CPPUNIT_ASSERT(!client.getTcpNoDelay());
+
+    client.setReceiveBufferSize(65536);
+    CPPUNIT_ASSERT(client.getReceiveBufferSize() > 0);
+}
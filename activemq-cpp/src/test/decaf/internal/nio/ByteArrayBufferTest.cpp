@@ -19,10 +19,16 @@
 #include <decaf/lang/Integer.h>
 #include <decaf/lang/Double.h>
 #include <decaf/lang/Float.h>
+#include <decaf/lang/Short.h>
+#include <decaf/lang/Long.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/ByteArrayOutputStream.h>
 #include <string.h>
 
 using namespace std;
 using namespace decaf;
+using namespace decaf::io;
 using namespace decaf::nio;
 using namespace decaf::internal::nio;
 using namespace decaf::lang;
@@ -1234,3 +1240,114 @@ void ByteArrayBufferTest::testWrapNullArray() {
         testBuffer1->wrap( NULL, 0, 0, 3 ),
         NullPointerException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayBufferTest::testAllocateDirect() {
+
+    Pointer<ByteBuffer> direct( ByteBuffer::allocateDirect( 10000 ) );
+
+    CPPUNIT_ASSERT( direct->isDirect() );
+    CPPUNIT_ASSERT( !testBuffer1->isDirect() );
+    CPPUNIT_ASSERT_EQUAL( 10000, direct->capacity() );
+    CPPUNIT_ASSERT_EQUAL( 0, direct->position() );
+    CPPUNIT_ASSERT_EQUAL( 10000, direct->limit() );
+    CPPUNIT_ASSERT( ( (std::size_t)direct->array() & 4095 ) == 0 );
+
+    for( int i = 0; i < direct->capacity(); ++i ) {
+        CPPUNIT_ASSERT( direct->get( i ) == 0 );
+    }
+
+    direct->putInt( 42 );
+    Pointer<ByteBuffer> slice( direct->slice() );
+    CPPUNIT_ASSERT( slice->isDirect() );
+
+    direct->flip();
+    CPPUNIT_ASSERT_EQUAL( 42, direct->getInt() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a IllegalArgumentException",
+        ByteBuffer::allocateDirect( -1 ),
+        IllegalArgumentException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayBufferTest::testBulkTypedValues() {
+
+    const short shorts[] = { 1, -2, Short::MAX_VALUE, Short::MIN_VALUE };
+    const int ints[] = { 3, -4, Integer::MAX_VALUE };
+    const long long longs[] = { 5LL, -6LL, Long::MAX_VALUE };
+
+    testBuffer1->clear();
+    testBuffer1->putShorts( shorts, 4 );
+    testBuffer1->putInts( ints, 3 );
+    testBuffer1->putLongs( longs, 3 );
+    CPPUNIT_ASSERT_EQUAL( 4 * 2 + 3 * 4 + 3 * 8, testBuffer1->position() );
+
+    // The values are stored big-endian, as the single value methods store them.
+    testBuffer1->flip();
+    CPPUNIT_ASSERT_EQUAL( (short)1, testBuffer1->getShort( 0 ) );
+    CPPUNIT_ASSERT_EQUAL( -4, testBuffer1->getInt( 12 ) );
+    CPPUNIT_ASSERT_EQUAL( Long::MAX_VALUE, testBuffer1->getLong( 36 ) );
+
+    short shortsIn[4] = {0};
+    int intsIn[3] = {0};
+    long long longsIn[3] = {0};
+
+    // The read-only view takes the value by value path.
+    Pointer<ByteBuffer> readOnly( testBuffer1->asReadOnlyBuffer() );
+
+    testBuffer1->getShorts( shortsIn, 4 );
+    testBuffer1->getInts( intsIn, 3 );
+    readOnly->position( testBuffer1->position() );
+    readOnly->getLongs( longsIn, 3 );
+
+    CPPUNIT_ASSERT( memcmp( shorts, shortsIn, sizeof( shorts ) ) == 0 );
+    CPPUNIT_ASSERT( memcmp( ints, intsIn, sizeof( ints ) ) == 0 );
+    CPPUNIT_ASSERT( memcmp( longs, longsIn, sizeof( longs ) ) == 0 );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a BufferUnderflowException",
+        testBuffer1->getLongs( longsIn, 1 ),
+        BufferUnderflowException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a ReadOnlyBufferException",
+        readOnly->putInts( ints, 1 ),
+        ReadOnlyBufferException );
+
+    testBuffer1->clear();
+    testBuffer1->position( testBuffer1->limit() - 7 );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a BufferOverflowException",
+        testBuffer1->putLongs( longs, 1 ),
+        BufferOverflowException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayBufferTest::testStreamTransfer() {
+
+    Pointer<ByteBuffer> direct( ByteBuffer::allocateDirect( 64 ) );
+    for( int i = 0; i < 64; ++i ) {
+        direct->put( (unsigned char)i );
+    }
+    direct->flip();
+    direct->position( 10 );
+
+    ByteArrayOutputStream output;
+    output.write( *direct );
+    CPPUNIT_ASSERT_EQUAL( direct->limit(), direct->position() );
+    CPPUNIT_ASSERT_EQUAL( 54, (int)output.size() );
+
+    std::pair<unsigned char*, int> array = output.toByteArray();
+    ByteArrayInputStream input( array.first, array.second, true );
+
+    Pointer<ByteBuffer> target( ByteBuffer::allocateDirect( 100 ) );
+    target->position( 6 );
+    CPPUNIT_ASSERT_EQUAL( 54, input.read( *target ) );
+    CPPUNIT_ASSERT_EQUAL( 60, target->position() );
+    CPPUNIT_ASSERT_EQUAL( -1, input.read( *target ) );
+
+    for( int i = 0; i < 54; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( (int)( i + 10 ), (int)target->get( i + 6 ) );
+    }
+}
@@ -75,6 +75,9 @@ namespace nio{
         CPPUNIT_TEST( testPutShort );
         CPPUNIT_TEST( testPutShort2 );
         CPPUNIT_TEST( testWrapNullArray );
+        CPPUNIT_TEST( testAllocateDirect );
+        CPPUNIT_TEST( testBulkTypedValues );
+        CPPUNIT_TEST( testStreamTransfer );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -155,6 +158,9 @@ namespace nio{
         void testPutShort();
         void testPutShort2();
         void testWrapNullArray();
+        void testAllocateDirect();
+        void testBulkTypedValues();
+        void testStreamTransfer();
 
     };
 
@@ -19,6 +19,8 @@
 
 #include <decaf/lang/Double.h>
 #include <decaf/lang/Float.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Long.h>
 
 using namespace decaf;
 using namespace decaf::internal;
@@ -563,3 +565,87 @@ void ByteArrayAdapterTest::testGetDouble() {
         testBuffer1.getDouble( i ),
         IndexOutOfBoundsException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapterTest::testBulkValues() {
+
+    ByteArrayAdapter testBuffer1( testData1Size );
+
+    int ints[] = { 1, -1, 42, Integer::MIN_VALUE };
+    testBuffer1.putInts( 2, ints, 4 );
+
+    for( int i = 0; i < 4; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( ints[i], testBuffer1.getInt( i + 2 ) );
+    }
+
+    double doubles[3] = { 0 };
+    testBuffer1.putDouble( 5, 2.5 );
+    testBuffer1.getDoubles( 4, doubles, 3 );
+    CPPUNIT_ASSERT_EQUAL( 2.5, doubles[1] );
+
+    long long longs[2] = { 0 };
+    testBuffer1.getLongs( 0, longs, 0 );
+    testBuffer1.getLongs( 0, NULL, 0 );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a IndexOutOfBoundsException",
+        testBuffer1.getLongs( testBuffer1.getLongCapacity() - 1, longs, 2 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a IndexOutOfBoundsException",
+        testBuffer1.putInts( -1, ints, 1 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a IndexOutOfBoundsException",
+        testBuffer1.getInts( 0, ints, -1 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        testBuffer1.putShorts( 0, NULL, 1 ),
+        NullPointerException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayAdapterTest::testBulkValuesAt() {
+
+    ByteArrayAdapter testBuffer1( testData1Size );
+
+    // At an odd index, the values are unaligned in the array.
+    std::vector<short> shorts;
+    for( int i = 0; i < 45; ++i ) {
+        shorts.push_back( (short)( i * 1021 - 20000 ) );
+    }
+    testBuffer1.putShortsAt( 3, &shorts[0], (int)shorts.size() );
+
+    for( int i = 0; i < (int)shorts.size(); ++i ) {
+        CPPUNIT_ASSERT_EQUAL( shorts[i], testBuffer1.getShortAt( 3 + i * 2 ) );
+    }
+
+    std::vector<short> shortsIn( shorts.size() );
+    testBuffer1.getShortsAt( 3, &shortsIn[0], (int)shortsIn.size() );
+    CPPUNIT_ASSERT( shorts == shortsIn );
+
+    long long longs[] = { 0x0102030405060708LL, -2LL, Long::MAX_VALUE };
+    testBuffer1.putLongsAt( 1, longs, 3 );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)0x01, testBuffer1.get( 1 ) );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)0x08, testBuffer1.get( 8 ) );
+    CPPUNIT_ASSERT_EQUAL( -2LL, testBuffer1.getLongAt( 9 ) );
+
+    int ints[2] = { 0 };
+    testBuffer1.putIntAt( 50, 123456789 );
+    testBuffer1.getIntsAt( 46, ints, 2 );
+    CPPUNIT_ASSERT_EQUAL( 123456789, ints[1] );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a IndexOutOfBoundsException",
+        testBuffer1.putIntsAt( testData1Size - 7, ints, 2 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a NullPointerException",
+        testBuffer1.getLongsAt( 0, NULL, 1 ),
+        NullPointerException );
+}
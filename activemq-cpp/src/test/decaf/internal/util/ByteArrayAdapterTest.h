@@ -56,6 +56,8 @@ namespace util{
         CPPUNIT_TEST( testPutLong );
         CPPUNIT_TEST( testPutDouble );
         CPPUNIT_TEST( testPutFloat );
+        CPPUNIT_TEST( testBulkValues );
+        CPPUNIT_TEST( testBulkValuesAt );
         CPPUNIT_TEST_SUITE_END();
 
         unsigned char* testData1;
@@ -107,6 +109,8 @@ namespace util{
         void testPutLong();
         void testPutDouble();
         void testPutFloat();
+        void testBulkValues();
+        void testBulkValuesAt();
 
     };
 
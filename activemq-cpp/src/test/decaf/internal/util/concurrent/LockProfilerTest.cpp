@@ -0,0 +1,206 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LockProfilerTest.h"
+
+#include <decaf/internal/util/concurrent/LockProfiler.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/Mutex.h>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
+using namespace decaf::util::concurrent;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class LockingRunnable : public Runnable {
+    private:
+
+        Mutex* mutex;
+
+        LockingRunnable(const LockingRunnable&);
+        LockingRunnable& operator=(const LockingRunnable&);
+
+    public:
+
+        LockingRunnable(Mutex* mutex) : Runnable(), mutex(mutex) {}
+
+        virtual ~LockingRunnable() {}
+
+        virtual void run() {
+            mutex->lock();
+            mutex->unlock();
+        }
+    };
+
+    LockProfiler::Statistics statisticsOf(const std::string& site) {
+        LockProfiler::Statistics statistics;
+        CPPUNIT_ASSERT(LockProfiler::getStatistics(site, statistics));
+        return statistics;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LockProfilerTest::LockProfilerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LockProfilerTest::~LockProfilerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::tearDown() {
+    LockProfiler::setEnabled(false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testDisabledRecordsNothing() {
+
+    Mutex mutex;
+    mutex.setProfilingSite("LockProfilerTest.disabled");
+
+    LockProfiler::setEnabled(false);
+    mutex.lock();
+    mutex.unlock();
+    CPPUNIT_ASSERT(mutex.tryLock());
+    mutex.unlock();
+
+    LockProfiler::Statistics statistics = statisticsOf("LockProfilerTest.disabled");
+    CPPUNIT_ASSERT_EQUAL(0LL, statistics.acquisitions);
+    CPPUNIT_ASSERT_EQUAL(0LL, statistics.holds);
+
+    CPPUNIT_ASSERT(!LockProfiler::getStatistics("LockProfilerTest.unknown", statistics));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testUncontendedAcquire() {
+
+    Mutex mutex;
+    mutex.setProfilingSite("LockProfilerTest.uncontended");
+
+    LockProfiler::setEnabled(true);
+
+    // A reentrant lock is one hold that ends with the outermost unlock.
+    mutex.lock();
+    mutex.lock();
+    mutex.unlock();
+    mutex.unlock();
+
+    LockProfiler::Statistics statistics = statisticsOf("LockProfilerTest.uncontended");
+    CPPUNIT_ASSERT_EQUAL(2LL, statistics.acquisitions);
+    CPPUNIT_ASSERT_EQUAL(0LL, statistics.contended);
+    CPPUNIT_ASSERT_EQUAL(0LL, statistics.waitNanos);
+    CPPUNIT_ASSERT_EQUAL(1LL, statistics.holds);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testContendedAcquire() {
+
+    Mutex mutex;
+    mutex.setProfilingSite("LockProfilerTest.contended");
+
+    LockProfiler::setEnabled(true);
+
+    LockingRunnable runnable(&mutex);
+    Thread thread(&runnable);
+
+    mutex.lock();
+    thread.start();
+    Thread::sleep(50);
+    mutex.unlock();
+    thread.join();
+
+    LockProfiler::Statistics statistics = statisticsOf("LockProfilerTest.contended");
+    CPPUNIT_ASSERT_EQUAL(2LL, statistics.acquisitions);
+    CPPUNIT_ASSERT_EQUAL(1LL, statistics.contended);
+    CPPUNIT_ASSERT(statistics.waitNanos >= 20 * 1000 * 1000LL);
+    CPPUNIT_ASSERT_EQUAL(2LL, statistics.holds);
+    CPPUNIT_ASSERT(statistics.holdNanos >= 20 * 1000 * 1000LL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testHoldExcludesWait() {
+
+    Mutex mutex;
+    mutex.setProfilingSite("LockProfilerTest.wait");
+
+    LockProfiler::setEnabled(true);
+
+    mutex.lock();
+    mutex.wait(100);
+    mutex.unlock();
+
+    // The hold is split in two around the wait and neither part includes it.
+    LockProfiler::Statistics statistics = statisticsOf("LockProfilerTest.wait");
+    CPPUNIT_ASSERT_EQUAL(2LL, statistics.holds);
+    CPPUNIT_ASSERT(statistics.holdNanos < 50 * 1000 * 1000LL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testSitesAreShared() {
+
+    Mutex first;
+    Mutex second;
+    first.setProfilingSite("LockProfilerTest.shared");
+    second.setProfilingSite("LockProfilerTest.shared");
+
+    LockProfiler::setEnabled(true);
+
+    first.lock();
+    first.unlock();
+    second.lock();
+    second.unlock();
+
+    CPPUNIT_ASSERT_EQUAL(2LL, statisticsOf("LockProfilerTest.shared").acquisitions);
+
+    LockProfiler::reset();
+    CPPUNIT_ASSERT_EQUAL(0LL, statisticsOf("LockProfilerTest.shared").acquisitions);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testPercentile() {
+
+    std::vector<long long> histogram(LockProfiler::HISTOGRAM_BUCKETS, 0);
+    CPPUNIT_ASSERT_EQUAL(0LL, LockProfiler::Statistics::percentile(histogram, 0.5));
+
+    histogram[3] = 99;
+    histogram[10] = 1;
+
+    CPPUNIT_ASSERT_EQUAL(16LL, LockProfiler::Statistics::percentile(histogram, 0.5));
+    CPPUNIT_ASSERT_EQUAL(16LL, LockProfiler::Statistics::percentile(histogram, 0.99));
+    CPPUNIT_ASSERT_EQUAL(2048LL, LockProfiler::Statistics::percentile(histogram, 1.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LockProfilerTest::testReport() {
+
+    Mutex mutex;
+    mutex.setProfilingSite("LockProfilerTest.report");
+
+    LockProfiler::setEnabled(true);
+    mutex.lock();
+    mutex.unlock();
+
+    std::string report = LockProfiler::report();
+    CPPUNIT_ASSERT(report.find("LockProfilerTest.report") != std::string::npos);
+    CPPUNIT_ASSERT(report.find("acquired 1") != std::string::npos);
+}
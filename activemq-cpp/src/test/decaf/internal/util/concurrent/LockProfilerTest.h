@@ -0,0 +1,62 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILERTEST_H_
+#define _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILERTEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <decaf/util/Config.h>
+
+namespace decaf {
+namespace internal {
+namespace util {
+namespace concurrent {
+
+    class LockProfilerTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( LockProfilerTest );
+        CPPUNIT_TEST( testDisabledRecordsNothing );
+        CPPUNIT_TEST( testUncontendedAcquire );
+        CPPUNIT_TEST( testContendedAcquire );
+        CPPUNIT_TEST( testHoldExcludesWait );
+        CPPUNIT_TEST( testSitesAreShared );
+        CPPUNIT_TEST( testPercentile );
+        CPPUNIT_TEST( testReport );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        LockProfilerTest();
+        virtual ~LockProfilerTest();
+
+        virtual void tearDown();
+
+        void testDisabledRecordsNothing();
+        void testUncontendedAcquire();
+        void testContendedAcquire();
+        void testHoldExcludesWait();
+        void testSitesAreShared();
+        void testPercentile();
+        void testReport();
+
+    };
+
+}}}}
+
+#endif /* _DECAF_INTERNAL_UTIL_CONCURRENT_LOCKPROFILERTEST_H_ */
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SharedMutexTest.h"
+
+#include <decaf/internal/util/concurrent/SharedMutex.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/util/concurrent/atomic/AtomicBoolean.h>
+
+using namespace decaf;
+using namespace decaf::lang;
+using namespace decaf::internal;
+using namespace decaf::internal::util;
+using namespace decaf::internal::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class TryLockRunnable : public Runnable {
+    private:
+
+        SharedMutex* mutex;
+        bool shared;
+
+        TryLockRunnable(const TryLockRunnable&);
+        TryLockRunnable& operator=(const TryLockRunnable&);
+
+    public:
+
+        bool acquired;
+
+        TryLockRunnable(SharedMutex* mutex, bool shared) :
+            Runnable(), mutex(mutex), shared(shared), acquired(false) {}
+
+        virtual ~TryLockRunnable() {}
+
+        virtual void run() {
+            acquired = shared ? mutex->tryReadLock() : mutex->tryWriteLock();
+            if (acquired) {
+                mutex->unlock();
+            }
+        }
+    };
+
+    class WriterRunnable : public Runnable {
+    private:
+
+        SharedMutex* mutex;
+
+        WriterRunnable(const WriterRunnable&);
+        WriterRunnable& operator=(const WriterRunnable&);
+
+    public:
+
+        AtomicBoolean written;
+
+        WriterRunnable(SharedMutex* mutex) : Runnable(), mutex(mutex), written() {}
+
+        virtual ~WriterRunnable() {}
+
+        virtual void run() {
+            mutex->writeLock();
+            written.set(true);
+            mutex->unlock();
+        }
+    };
+
+    bool tryFromOtherThread(SharedMutex& mutex, bool shared) {
+        TryLockRunnable runnable(&mutex, shared);
+        Thread thread(&runnable);
+        thread.start();
+        thread.join();
+        return runnable.acquired;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedMutexTest::SharedMutexTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SharedMutexTest::~SharedMutexTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutexTest::testReadersShare() {
+
+    SharedMutex mutex;
+
+    mutex.readLock();
+    CPPUNIT_ASSERT(tryFromOtherThread(mutex, true));
+    CPPUNIT_ASSERT(!tryFromOtherThread(mutex, false));
+    mutex.unlock();
+
+    CPPUNIT_ASSERT(tryFromOtherThread(mutex, false));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutexTest::testWriterExcludes() {
+
+    SharedMutex mutex;
+
+    mutex.writeLock();
+    CPPUNIT_ASSERT(!tryFromOtherThread(mutex, true));
+    CPPUNIT_ASSERT(!tryFromOtherThread(mutex, false));
+    mutex.unlock();
+
+    CPPUNIT_ASSERT(mutex.tryReadLock());
+    mutex.unlock();
+    CPPUNIT_ASSERT(mutex.tryWriteLock());
+    mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SharedMutexTest::testWriterWaitsForReaders() {
+
+    SharedMutex mutex;
+    WriterRunnable writer(&mutex);
+    Thread thread(&writer);
+
+    mutex.readLock();
+    thread.start();
+    Thread::sleep(50);
+    CPPUNIT_ASSERT(!writer.written.get());
+    mutex.unlock();
+
+    thread.join();
+    CPPUNIT_ASSERT(writer.written.get());
+}
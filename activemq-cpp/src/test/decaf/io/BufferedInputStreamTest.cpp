@@ -661,3 +661,24 @@ void BufferedInputStreamTest::testSkipJ() {
         buf.skip( 10 ),
         IOException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferedInputStreamTest::testReadContiguous() {
+
+    ByteArrayInputStream stream;
+    stream.setByteArray( (const unsigned char*)testString.c_str(), (int)testString.length() );
+
+    BufferedInputStream is( &stream, 64 );
+
+    // Nothing is buffered before the first read.
+    CPPUNIT_ASSERT( is.readContiguous( 10 ) == NULL );
+
+    is.read();
+    const unsigned char* window = is.readContiguous( 10 );
+    CPPUNIT_ASSERT( window != NULL );
+    CPPUNIT_ASSERT_EQUAL( testString.substr( 1, 10 ), std::string( window, window + 10 ) );
+
+    // Only what the buffer holds is handed out, the wrapped stream isn't read.
+    CPPUNIT_ASSERT( is.readContiguous( 64 ) == NULL );
+    CPPUNIT_ASSERT_EQUAL( (int)testString.at( 11 ), is.read() );
+}
@@ -46,6 +46,7 @@ namespace io{
         CPPUNIT_TEST( testReset );
         CPPUNIT_TEST( testMarkI );
         CPPUNIT_TEST( testSkipJ );
+        CPPUNIT_TEST( testReadContiguous );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -74,6 +75,7 @@ namespace io{
         void testReset();
         void testMarkI();
         void testSkipJ();
+        void testReadContiguous();
 
     };
 
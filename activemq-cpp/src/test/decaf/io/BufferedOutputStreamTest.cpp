@@ -18,6 +18,7 @@
 #include "BufferedOutputStreamTest.h"
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/ByteArrayInputStream.h>
+#include <decaf/io/DataOutputStream.h>
 
 using namespace std;
 using namespace decaf;
@@ -65,6 +66,29 @@ namespace {
 
     };
 
+    // Records the number of times each kind of write reaches it.
+    class CountingOutputStream : public ByteArrayOutputStream {
+    public:
+
+        int arrayWrites;
+        int vectoredWrites;
+
+        CountingOutputStream() : ByteArrayOutputStream(), arrayWrites(0), vectoredWrites(0) {}
+        virtual ~CountingOutputStream() {}
+
+    protected:
+
+        virtual void doWriteArrayBounded( const unsigned char* buffer, int size, int offset, int length ) {
+            arrayWrites++;
+            ByteArrayOutputStream::doWriteArrayBounded( buffer, size, offset, length );
+        }
+
+        virtual void doWriteArrays( const unsigned char* const* buffers, const int* lengths, int count ) {
+            vectoredWrites++;
+            ByteArrayOutputStream::doWriteArrays( buffers, lengths, count );
+        }
+    };
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,3 +335,63 @@ void BufferedOutputStreamTest::testBiggerBuffer(){
     bufStream.flush();
     CPPUNIT_ASSERT( strcmp( buffer, "TESTTEST12345678910" ) == 0 );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferedOutputStreamTest::testWriteArrays() {
+
+    CountingOutputStream myStream;
+    BufferedOutputStream os( &myStream, 64 );
+
+    const unsigned char* buffers[3] = {
+        (const unsigned char*) &testString[0], NULL, (const unsigned char*) &testString[20] };
+    int lengths[3] = { 20, 0, 30 };
+
+    // Fits in the buffer so nothing should be written yet.
+    os.writeArrays( buffers, lengths, 3 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, myStream.size() );
+
+    // Doesn't fit so the buffered bytes go out along with these in one write.
+    buffers[0] = (const unsigned char*) &testString[50];
+    lengths[0] = 50;
+    os.writeArrays( buffers, lengths, 1 );
+    CPPUNIT_ASSERT_EQUAL( 100LL, myStream.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, myStream.vectoredWrites );
+
+    os.write( (const unsigned char*) &testString[100], 10 );
+    os.flush();
+
+    CPPUNIT_ASSERT_EQUAL( 110LL, myStream.size() );
+    std::pair<unsigned char*, int> result = myStream.toByteArray();
+    CPPUNIT_ASSERT_MESSAGE( "Incorrect data written",
+        memcmp( result.first, testString.c_str(), 110 ) == 0 );
+    delete [] result.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void BufferedOutputStreamTest::testWriteLargeArray() {
+
+    CountingOutputStream myStream;
+    BufferedOutputStream os( &myStream, 64 );
+    DataOutputStream dos( &os );
+
+    dos.writeInt( 200 );
+    dos.write( (const unsigned char*) &testString[0], 6 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, myStream.size() );
+
+    // Longer than the buffer so it should go out with the buffered bytes in a
+    // single write rather than being copied through the buffer.
+    dos.write( (const unsigned char*) &testString[6], 200 );
+    CPPUNIT_ASSERT_EQUAL( 210LL, myStream.size() );
+    CPPUNIT_ASSERT_EQUAL( 1, myStream.vectoredWrites );
+
+    dos.write( (const unsigned char*) &testString[206], 20 );
+    dos.flush();
+    CPPUNIT_ASSERT_EQUAL( 230LL, myStream.size() );
+    CPPUNIT_ASSERT_EQUAL( 230LL, dos.size() );
+
+    std::pair<unsigned char*, int> result = myStream.toByteArray();
+    CPPUNIT_ASSERT_EQUAL( 200, (int) result.first[3] );
+    CPPUNIT_ASSERT_MESSAGE( "Incorrect data written",
+        memcmp( result.first + 4, testString.c_str(), 226 ) == 0 );
+    delete [] result.first;
+}
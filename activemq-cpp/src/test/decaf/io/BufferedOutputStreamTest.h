@@ -43,6 +43,8 @@ namespace io{
       CPPUNIT_TEST( testWriteNullStreamNullArraySize );
       CPPUNIT_TEST( testWriteNullStreamSize );
       CPPUNIT_TEST( testWriteI );
+      CPPUNIT_TEST( testWriteArrays );
+      CPPUNIT_TEST( testWriteLargeArray );
       CPPUNIT_TEST_SUITE_END();
 
       std::string testString;
@@ -69,6 +71,8 @@ namespace io{
         void testWriteNullStream();
         void testWriteNullStreamSize();
         void testWriteI();
+        void testWriteArrays();
+        void testWriteLargeArray();
 
     };
 
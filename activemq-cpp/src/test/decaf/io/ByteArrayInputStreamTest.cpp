@@ -195,6 +195,33 @@ void ByteArrayInputStreamTest::testSkip() {
         string( (const char*)buf1, 10 ) == string( (const char*)&testBuffer[100], 10) );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ByteArrayInputStreamTest::testReadContiguous() {
+
+    std::vector<unsigned char> testBuffer;
+    for( int i = 0; i < 128; i++ ) {
+        testBuffer.push_back( (unsigned char)i );
+    }
+
+    ByteArrayInputStream is( testBuffer );
+
+    const unsigned char* window = is.readContiguous( 10 );
+    CPPUNIT_ASSERT( window != NULL );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)0, window[0] );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)9, window[9] );
+    CPPUNIT_ASSERT_EQUAL( 118, is.available() );
+
+    // More than is left leaves the stream where it was.
+    CPPUNIT_ASSERT( is.readContiguous( 119 ) == NULL );
+    CPPUNIT_ASSERT_EQUAL( 118, is.available() );
+
+    window = is.readContiguous( 118 );
+    CPPUNIT_ASSERT( window != NULL );
+    CPPUNIT_ASSERT_EQUAL( (unsigned char)10, window[0] );
+    CPPUNIT_ASSERT_EQUAL( 0, is.available() );
+    CPPUNIT_ASSERT_EQUAL( -1, is.read() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ByteArrayInputStreamTest::testStream()
 {
@@ -38,6 +38,7 @@ namespace io{
        CPPUNIT_TEST( testRead2 );
        CPPUNIT_TEST( testRead3 );
        CPPUNIT_TEST( testSkip );
+       CPPUNIT_TEST( testReadContiguous );
        CPPUNIT_TEST_SUITE_END();
 
    public:
@@ -54,6 +55,7 @@ namespace io{
        void testRead2();
        void testRead3();
        void testSkip();
+       void testReadContiguous();
 
    };
 
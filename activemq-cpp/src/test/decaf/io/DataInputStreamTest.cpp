@@ -584,6 +584,24 @@ void DataInputStreamTest::testHelper( unsigned char* input, int inputLength,
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamTest::testUTFUnbuffered() {
+
+    // A FilterInputStream holds no data so the strings are read through it.
+    unsigned char input[] = { 0x00, 0x03, 0x61, 0x62, 0x63, 0x00, 0x06, 0x61, 0xC3, 0x82, 0xC2, 0xA9, 0x62 };
+    unsigned char expect[] = { 0x61, 0xC2, 0xA9, 0x62 };
+
+    ByteArrayInputStream bytes( input, (int) sizeof(input) );
+    FilterInputStream filter( &bytes );
+    DataInputStream reader( &filter );
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "abc" ), reader.readUTF() );
+
+    std::string result = reader.readUTF();
+    CPPUNIT_ASSERT_EQUAL( std::string( (const char*) expect, sizeof(expect) ), result );
+    CPPUNIT_ASSERT_EQUAL( 0, reader.available() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void DataInputStreamTest::testUTFDecoding() {
 
@@ -676,3 +694,66 @@ void DataInputStreamTest::testUTFDecoding() {
     }
 
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamTest::test_readValues() {
+
+    // Enough values that each bulk read spans more than one block.
+    const int COUNT = 300;
+
+    for( int i = 0; i < COUNT; ++i ) {
+        os->writeShort( (short)( i * 97 - 15000 ) );
+    }
+    for( int i = 0; i < COUNT; ++i ) {
+        os->writeInt( i * 654321 - 100000000 );
+    }
+    for( int i = 0; i < COUNT; ++i ) {
+        os->writeLong( (long long) i * 908755555456LL - 0x7FFFFFFFFFFFLL );
+    }
+    os->writeInt( 42 );
+    os->close();
+    openDataInputStream();
+
+    short shorts[COUNT];
+    int ints[COUNT];
+    long long longs[COUNT];
+
+    is->readShorts( shorts, COUNT );
+    is->readInts( ints, COUNT );
+    is->readLongs( longs, COUNT );
+    is->readInts( ints, 0 );
+
+    for( int i = 0; i < COUNT; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( (short)( i * 97 - 15000 ), shorts[i] );
+        CPPUNIT_ASSERT_EQUAL( i * 654321 - 100000000, ints[i] );
+        CPPUNIT_ASSERT_EQUAL( (long long) i * 908755555456LL - 0x7FFFFFFFFFFFLL, longs[i] );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 42, is->readInt() );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw a NullPointerException",
+        is->readInts( NULL, 1 ),
+        NullPointerException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an IndexOutOfBoundsException",
+        is->readInts( ints, -1 ),
+        IndexOutOfBoundsException );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataInputStreamTest::test_readValuesEOF() {
+
+    os->writeInt( 1 );
+    os->writeInt( 2 );
+    os->writeShort( 3 );
+    os->close();
+    openDataInputStream();
+
+    int ints[3];
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an EOFException",
+        is->readInts( ints, 3 ),
+        EOFException );
+}
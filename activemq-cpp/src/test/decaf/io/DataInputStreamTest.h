@@ -27,6 +27,7 @@
 #include <decaf/io/ByteArrayOutputStream.h>
 #include <decaf/io/DataInputStream.h>
 #include <decaf/io/DataOutputStream.h>
+#include <decaf/io/FilterInputStream.h>
 #include <algorithm>
 #include <memory>
 
@@ -40,6 +41,7 @@ namespace io{
         CPPUNIT_TEST( testString );
         CPPUNIT_TEST( testUTF );
         CPPUNIT_TEST( testUTFDecoding );
+        CPPUNIT_TEST( testUTFUnbuffered );
         CPPUNIT_TEST( testConstructor );
         CPPUNIT_TEST( testRead1 );
         CPPUNIT_TEST( testRead2 );
@@ -59,6 +61,8 @@ namespace io{
         CPPUNIT_TEST( test_readUnsignedByte );
         CPPUNIT_TEST( test_readUnsignedShort );
         CPPUNIT_TEST( test_skipBytes );
+        CPPUNIT_TEST( test_readValues );
+        CPPUNIT_TEST( test_readValuesEOF );
         CPPUNIT_TEST_SUITE_END();
 
         std::auto_ptr<ByteArrayOutputStream> baos;
@@ -92,6 +96,7 @@ namespace io{
         void testString();
         void testUTF();
         void testUTFDecoding();
+        void testUTFUnbuffered();
         void testConstructor();
         void testRead1();
         void testRead2();
@@ -111,6 +116,8 @@ namespace io{
         void test_readUnsignedByte();
         void test_readUnsignedShort();
         void test_skipBytes();
+        void test_readValues();
+        void test_readValuesEOF();
 
     private:
 
@@ -413,3 +413,68 @@ void DataOutputStreamTest::test(){
 
     delete [] buffer.first;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStreamTest::testWriteValues() {
+
+    // Enough values that each bulk write spans more than one block.
+    const int COUNT = 300;
+
+    short shorts[COUNT];
+    int ints[COUNT];
+    long long longs[COUNT];
+
+    for( int i = 0; i < COUNT; ++i ) {
+        shorts[i] = (short)( i * 97 - 15000 );
+        ints[i] = i * 654321 - 100000000;
+        longs[i] = (long long) i * 908755555456LL - 0x7FFFFFFFFFFFLL;
+    }
+
+    os->writeShorts( shorts, COUNT );
+    os->writeInts( ints, COUNT );
+    os->writeLongs( longs, COUNT );
+    os->writeInts( ints, 0 );
+
+    CPPUNIT_ASSERT_EQUAL( (long long) COUNT * 14, os->size() );
+
+    os->close();
+    openDataInputStream();
+
+    for( int i = 0; i < COUNT; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( shorts[i], is->readShort() );
+    }
+    for( int i = 0; i < COUNT; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( ints[i], is->readInt() );
+    }
+    for( int i = 0; i < COUNT; ++i ) {
+        CPPUNIT_ASSERT_EQUAL( longs[i], is->readLong() );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 0, is->available() );
+    is->close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DataOutputStreamTest::testWriteValuesInvalidArgs() {
+
+    int ints[4] = { 1, 2, 3, 4 };
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw a NullPointerException",
+        os->writeInts( NULL, 4 ),
+        decaf::lang::exceptions::NullPointerException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an IndexOutOfBoundsException",
+        os->writeInts( ints, -1 ),
+        decaf::lang::exceptions::IndexOutOfBoundsException );
+
+    os->writeLongs( NULL, 0 );
+    CPPUNIT_ASSERT_EQUAL( 0LL, os->size() );
+
+    DataOutputStream nullStream( NULL );
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an IOException",
+        nullStream.writeShorts( NULL, 0 ),
+        IOException );
+}
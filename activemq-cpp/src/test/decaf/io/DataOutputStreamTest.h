@@ -52,6 +52,8 @@ namespace io{
         CPPUNIT_TEST( testWriteUTF );
         CPPUNIT_TEST( testWriteUTFStringLength );
         CPPUNIT_TEST( testWriteUTFEncoding );
+        CPPUNIT_TEST( testWriteValues );
+        CPPUNIT_TEST( testWriteValuesInvalidArgs );
         CPPUNIT_TEST_SUITE_END();
 
         std::auto_ptr<ByteArrayOutputStream> baos;
@@ -98,6 +100,8 @@ namespace io{
         void testWriteUTF();
         void testWriteUTFStringLength();
         void testWriteUTFEncoding();
+        void testWriteValues();
+        void testWriteValuesInvalidArgs();
 
     private:
 
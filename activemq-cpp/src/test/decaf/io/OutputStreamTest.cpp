@@ -71,3 +71,45 @@ void OutputStreamTest::test() {
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Written string not what was expected",
                                   std::string( "hello world" ), result );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void OutputStreamTest::testWriteArrays() {
+
+    MockOutputStream ostream;
+
+    const unsigned char* buffers[4] = {
+        (const unsigned char*) "hello", NULL, (const unsigned char*) " ", (const unsigned char*) "world" };
+    int lengths[4] = { 5, 0, 1, 5 };
+
+    ostream.writeArrays( buffers, lengths, 4 );
+    ostream.writeArrays( NULL, NULL, 0 );
+
+    std::string result( ostream.getBuffer().begin(), ostream.getBuffer().end() );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Written string not what was expected",
+                                  std::string( "hello world" ), result );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an IndexOutOfBoundsException",
+        ostream.writeArrays( buffers, lengths, -1 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw a NullPointerException",
+        ostream.writeArrays( NULL, lengths, 1 ),
+        NullPointerException );
+
+    lengths[1] = 1;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw a NullPointerException",
+        ostream.writeArrays( buffers, lengths, 2 ),
+        NullPointerException );
+
+    lengths[1] = -1;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "should throw an IndexOutOfBoundsException",
+        ostream.writeArrays( buffers, lengths, 2 ),
+        IndexOutOfBoundsException );
+
+    CPPUNIT_ASSERT_EQUAL( (std::size_t) 11, ostream.getBuffer().size() );
+}
@@ -28,6 +28,7 @@ namespace io {
 
         CPPUNIT_TEST_SUITE( OutputStreamTest );
         CPPUNIT_TEST( test );
+        CPPUNIT_TEST( testWriteArrays );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -36,6 +37,7 @@ namespace io {
         virtual ~OutputStreamTest();
 
         void test();
+        void testWriteArrays();
 
     };
 
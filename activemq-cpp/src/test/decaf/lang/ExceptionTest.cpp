@@ -128,3 +128,62 @@ void ExceptionTest::testMessage3(){
     CPPUNIT_ASSERT( strcmp( ex.getMessage().c_str(),
                     "This is a test 1 100 1000" ) == 0 );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ExceptionTest::testStackTrace() {
+
+    Exception ex("File1", 10, "Test");
+    ex.setMark("File2", 20);
+
+    Exception copy(ex);
+    copy.setMark("File3", 30);
+
+    std::vector< std::pair<std::string, int> > trace = copy.getStackTrace();
+    CPPUNIT_ASSERT_EQUAL(3, (int) trace.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("File1"), trace[0].first);
+    CPPUNIT_ASSERT_EQUAL(10, trace[0].second);
+    CPPUNIT_ASSERT_EQUAL(std::string("File3"), trace[2].first);
+    CPPUNIT_ASSERT_EQUAL(30, trace[2].second);
+
+    // The copy is marked on its own.
+    CPPUNIT_ASSERT_EQUAL(2, (int) ex.getStackTrace().size());
+
+    std::string text = copy.getStackTraceString();
+    CPPUNIT_ASSERT(text.find("Test") == 0);
+    CPPUNIT_ASSERT(text.find("FILE: File2, LINE: 20") != std::string::npos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ExceptionTest::testStackTraceLimit() {
+
+    Exception ex("File", 0, "Test");
+    for (int i = 1; i < 40; ++i) {
+        ex.setMark("File", i);
+    }
+
+    std::vector< std::pair<std::string, int> > trace = ex.getStackTrace();
+    CPPUNIT_ASSERT_EQUAL(32, (int) trace.size());
+    CPPUNIT_ASSERT_EQUAL(0, trace[0].second);
+    CPPUNIT_ASSERT_EQUAL(31, trace[31].second);
+    CPPUNIT_ASSERT(ex.getStackTraceString().find("... 8 more") != std::string::npos);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ExceptionTest::testStackTraceCopiesFile() {
+
+    Exception ex("File1", 10, "Test");
+    {
+        std::string file("Generated");
+        ex.setMark(file.c_str(), 20);
+        file.assign(file.size(), 'X');
+    }
+    ex.setMarkLiteral("File3", 30);
+
+    Exception copy;
+    copy = ex;
+
+    std::vector< std::pair<std::string, int> > trace = copy.getStackTrace();
+    CPPUNIT_ASSERT_EQUAL(3, (int) trace.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("Generated"), trace[1].first);
+    CPPUNIT_ASSERT_EQUAL(std::string("File3"), trace[2].first);
+}
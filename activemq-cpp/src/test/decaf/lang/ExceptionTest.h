@@ -36,6 +36,9 @@ namespace lang{
         CPPUNIT_TEST( testInitCause );
         CPPUNIT_TEST( testCtors );
         CPPUNIT_TEST( testAssign );
+        CPPUNIT_TEST( testStackTrace );
+        CPPUNIT_TEST( testStackTraceLimit );
+        CPPUNIT_TEST( testStackTraceCopiesFile );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -51,6 +54,9 @@ namespace lang{
         void testInitCause();
         void testMessage0();
         void testMessage3();
+        void testStackTrace();
+        void testStackTraceLimit();
+        void testStackTraceCopiesFile();
 
     };
 
@@ -106,4 +106,11 @@ void IntegerTest::test2() {
     // lowestOneBit
     CPPUNIT_ASSERT( Integer::lowestOneBit( 255 ) == 1 );
     CPPUNIT_ASSERT( Integer::lowestOneBit( 0xFF000000 ) == (int)0x01000000 );
+
+    // numberOfLeadingZeros
+    CPPUNIT_ASSERT( Integer::numberOfLeadingZeros( 0 ) == 32 );
+    CPPUNIT_ASSERT( Integer::numberOfLeadingZeros( 1 ) == 31 );
+    CPPUNIT_ASSERT( Integer::numberOfLeadingZeros( 512 ) == 22 );
+    CPPUNIT_ASSERT( Integer::numberOfLeadingZeros( 1023 ) == 22 );
+    CPPUNIT_ASSERT( Integer::numberOfLeadingZeros( -1 ) == 0 );
 }
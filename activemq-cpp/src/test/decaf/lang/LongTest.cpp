@@ -107,4 +107,19 @@ void LongTest::test2() {
     CPPUNIT_ASSERT( Long::lowestOneBit( 255 ) == 1 );
     CPPUNIT_ASSERT( Long::lowestOneBit( 0xFF000000 ) == (long long)0x01000000 );
 
+    CPPUNIT_ASSERT( Long::bitCount( -1 ) == 64 );
+    CPPUNIT_ASSERT( Long::bitCount( Long::MIN_VALUE ) == 1 );
+
+    // numberOfLeadingZeros
+    CPPUNIT_ASSERT( Long::numberOfLeadingZeros( 0 ) == 64 );
+    CPPUNIT_ASSERT( Long::numberOfLeadingZeros( 1 ) == 63 );
+    CPPUNIT_ASSERT( Long::numberOfLeadingZeros( 1023 ) == 54 );
+    CPPUNIT_ASSERT( Long::numberOfLeadingZeros( -1 ) == 0 );
+
+    // numberOfTrailingZeros
+    CPPUNIT_ASSERT( Long::numberOfTrailingZeros( 0 ) == 64 );
+    CPPUNIT_ASSERT( Long::numberOfTrailingZeros( 1 ) == 0 );
+    CPPUNIT_ASSERT( Long::numberOfTrailingZeros( 0x100000000LL ) == 32 );
+    CPPUNIT_ASSERT( Long::numberOfTrailingZeros( Long::MIN_VALUE ) == 63 );
+
 }
@@ -22,6 +22,7 @@
 #include <decaf/lang/Runnable.h>
 #include <decaf/lang/exceptions/ClassCastException.h>
 #include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/atomic/AtomicRefCounted.h>
 
 #include <map>
 #include <string>
@@ -32,6 +33,7 @@ using namespace decaf;
 using namespace decaf::lang;
 using namespace decaf::lang::exceptions;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
 
 ////////////////////////////////////////////////////////////////////////////////
 class TestClassBase {
@@ -554,3 +556,90 @@ void PointerTest::testThreadSafety() {
         thread[i]->join();
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+class CountedClass : public TestClassA, public AtomicRefCounted {
+private:
+
+    int* destroyed;
+
+public:
+
+    CountedClass(int* destroyed) : TestClassA(), AtomicRefCounted(), destroyed(destroyed) {
+    }
+
+    CountedClass(const CountedClass& other) : TestClassA(other), AtomicRefCounted(other), destroyed(other.destroyed) {
+    }
+
+    virtual ~CountedClass() {
+        (*destroyed)++;
+    }
+
+private:
+
+    CountedClass& operator= (const CountedClass&);
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void PointerTest::testIntrusiveCount() {
+
+    int destroyed = 0;
+
+    {
+        Pointer<CountedClass> pointer1(new CountedClass(&destroyed));
+        CPPUNIT_ASSERT_EQUAL(1, pointer1->getReferenceCount());
+        Pointer<CountedClass> pointer2(pointer1);
+        Pointer<TestClassBase> basePointer(pointer1);
+        CPPUNIT_ASSERT_EQUAL(3, pointer1->getReferenceCount());
+
+        pointer1.reset(NULL);
+        pointer2.reset(NULL);
+        CPPUNIT_ASSERT_EQUAL(0, destroyed);
+        CPPUNIT_ASSERT(basePointer->returnHello() == "Hello");
+
+        Pointer<CountedClass> casted = basePointer.dynamicCast<CountedClass>();
+        CPPUNIT_ASSERT_EQUAL(2, casted->getReferenceCount());
+        basePointer.reset(NULL);
+        CPPUNIT_ASSERT_EQUAL(1, casted->getReferenceCount());
+        CPPUNIT_ASSERT_EQUAL(0, destroyed);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, destroyed);
+
+    // The count lives in the object, so two Pointers made from the same raw pointer
+    // share it instead of each deleting the object.
+    destroyed = 0;
+    CountedClass* raw = new CountedClass(&destroyed);
+    {
+        Pointer<CountedClass> pointer1(raw);
+        Pointer<CountedClass> pointer2(raw);
+        pointer1.reset(NULL);
+        CPPUNIT_ASSERT_EQUAL(0, destroyed);
+    }
+    CPPUNIT_ASSERT_EQUAL(1, destroyed);
+
+    // A copy of an object starts out with its own count.
+    destroyed = 0;
+    {
+        Pointer<CountedClass> original(new CountedClass(&destroyed));
+        Pointer<CountedClass> copy(new CountedClass(*original));
+        copy.reset(NULL);
+        CPPUNIT_ASSERT_EQUAL(1, destroyed);
+        CPPUNIT_ASSERT(original->returnHello() == "Hello");
+    }
+    CPPUNIT_ASSERT_EQUAL(2, destroyed);
+
+    // Ownership can still be taken back from a Pointer.
+    destroyed = 0;
+    raw = new CountedClass(&destroyed);
+    {
+        Pointer<CountedClass> pointer(raw);
+        CPPUNIT_ASSERT(pointer.release() == raw);
+    }
+    CPPUNIT_ASSERT_EQUAL(0, destroyed);
+    {
+        Pointer<CountedClass> pointer(raw);
+    }
+    CPPUNIT_ASSERT_EQUAL(1, destroyed);
+}
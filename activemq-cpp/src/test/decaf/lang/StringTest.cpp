@@ -1224,3 +1224,61 @@ void StringTest::testGetChars() {
 
     delete [] buffer;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void StringTest::testCopyShortAndLong() {
+
+    // Lengths either side of the inline storage limit.
+    const char* values[] = { "", "a", "fifteen chars..", "sixteen chars...",
+                             "seventeen chars..", "a much longer string than fits inline" };
+
+    for (int i = 0; i < 6; ++i) {
+        String original(values[i]);
+        String copy(original);
+        CPPUNIT_ASSERT(copy.equals(values[i]));
+        CPPUNIT_ASSERT_EQUAL(std::string(values[i]), std::string(copy.c_str()));
+
+        String assigned("x");
+        assigned = copy;
+        CPPUNIT_ASSERT(assigned.equals(original));
+        CPPUNIT_ASSERT_EQUAL(original.hashCode(), assigned.hashCode());
+
+        assigned = assigned;
+        CPPUNIT_ASSERT(assigned.equals(values[i]));
+
+        {
+            String scoped(original);
+            assigned = scoped;
+        }
+        CPPUNIT_ASSERT(assigned.equals(values[i]));
+        CPPUNIT_ASSERT_EQUAL((int) std::string(values[i]).length(), assigned.length());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void StringTest::testSubstringOfLongString() {
+
+    String shortPart;
+    String longPart;
+    String suffix;
+
+    {
+        String source("The quick brown fox jumps over the lazy dog");
+
+        shortPart = source.substring(4, 9);
+        longPart = source.substring(4, 34);
+        suffix = source.substring(16);
+    }
+
+    CPPUNIT_ASSERT(shortPart.equals("quick"));
+    CPPUNIT_ASSERT_EQUAL(std::string("quick"), std::string(shortPart.c_str()));
+    CPPUNIT_ASSERT(longPart.equals("quick brown fox jumps over the"));
+    CPPUNIT_ASSERT_EQUAL(std::string("quick brown fox jumps over the"), std::string(longPart.c_str()));
+    CPPUNIT_ASSERT(suffix.equals("fox jumps over the lazy dog"));
+    CPPUNIT_ASSERT_EQUAL(std::string("fox jumps over the lazy dog"), std::string(suffix.c_str()));
+
+    String copy(longPart);
+    CPPUNIT_ASSERT(copy.equals(longPart));
+    CPPUNIT_ASSERT(copy.compact().equals(longPart));
+    CPPUNIT_ASSERT(longPart.trim().substring(6, 11).equals("brown"));
+}
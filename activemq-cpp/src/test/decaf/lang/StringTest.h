@@ -111,6 +111,8 @@ namespace lang {
         CPPUNIT_TEST( testFindFirstNotOf );
         CPPUNIT_TEST( testFindFirstNotOf2 );
         CPPUNIT_TEST( testGetChars );
+        CPPUNIT_TEST( testCopyShortAndLong );
+        CPPUNIT_TEST( testSubstringOfLongString );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -202,6 +204,8 @@ namespace lang {
         void testOperatorPlusStdString();
         void testOperatorPlusCString();
         void testGetChars();
+        void testCopyShortAndLong();
+        void testSubstringOfLongString();
 
     };
 
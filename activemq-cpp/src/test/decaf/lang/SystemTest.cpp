@@ -103,3 +103,19 @@ void SystemTest::test_nanoTime() {
 
     CPPUNIT_ASSERT_MESSAGE( "First Read isn't less than the second.", start < end );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SystemTest::test_coarseTimeMillis() {
+
+    // Lags the precise clock by at most a timer tick, allow generously for scheduling.
+    long long precise = System::currentTimeMillis();
+    long long coarse = System::coarseTimeMillis();
+    CPPUNIT_ASSERT( coarse > precise - 1000 && coarse < precise + 1000 );
+
+    long long last = System::nanoTime();
+    for( int i = 0; i < 10000; ++i ) {
+        long long now = System::nanoTime();
+        CPPUNIT_ASSERT_MESSAGE( "nanoTime went backwards", now >= last );
+        last = now;
+    }
+}
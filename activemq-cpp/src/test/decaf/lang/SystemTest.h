@@ -34,6 +34,7 @@ namespace lang{
 //        CPPUNIT_TEST( test_unsetenv );
 //        CPPUNIT_TEST( test_currentTimeMillis );
 //        CPPUNIT_TEST( test_nanoTime );
+        CPPUNIT_TEST( test_coarseTimeMillis );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -48,6 +49,7 @@ namespace lang{
         void test_unsetenv();
         void test_currentTimeMillis();
         void test_nanoTime();
+        void test_coarseTimeMillis();
 
     };
 
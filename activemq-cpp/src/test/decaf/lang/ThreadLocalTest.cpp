@@ -24,6 +24,7 @@
 #include <decaf/lang/exceptions/RuntimeException.h>
 
 #include <memory>
+#include <vector>
 
 using namespace std;
 using namespace decaf;
@@ -181,3 +182,73 @@ void ThreadLocalTest::testSet() {
     CPPUNIT_ASSERT_MESSAGE("ThreadLocal's value in this Thread should be 'updated'",
                            local.get() == "updated");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class TestManyThreadsRunnable : public Runnable {
+    private:
+
+        ThreadLocal<int>* local;
+        int value;
+
+    private:
+
+        TestManyThreadsRunnable(const TestManyThreadsRunnable&);
+        TestManyThreadsRunnable& operator= (const TestManyThreadsRunnable&);
+
+    public:
+
+        Thread* current;
+        bool intact;
+
+        TestManyThreadsRunnable() : Runnable(), local(NULL), value(0), current(NULL), intact(false) {}
+        virtual ~TestManyThreadsRunnable() {}
+
+        void init(ThreadLocal<int>* local, int value) {
+            this->local = local;
+            this->value = value;
+        }
+
+        virtual void run() {
+            current = Thread::currentThread();
+            local->set(value);
+            intact = true;
+            for (int i = 0; i < 1000; ++i) {
+                Thread::yield();
+                intact = intact && local->get() == value && Thread::currentThread() == current;
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadLocalTest::testManyThreads() {
+
+    static const int NUM_THREADS = 8;
+
+    ThreadLocal<int> local;
+    local.set(-1);
+
+    TestManyThreadsRunnable runnables[NUM_THREADS];
+    std::vector<Thread*> threads;
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        runnables[i].init(&local, i);
+        threads.push_back(new Thread(&runnables[i]));
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->start();
+    }
+
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        threads[i]->join();
+        CPPUNIT_ASSERT_MESSAGE("Thread saw another thread's value", runnables[i].intact);
+        CPPUNIT_ASSERT_MESSAGE("Thread::currentThread should be the running Thread",
+                               runnables[i].current == threads[i]);
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(-1, local.get());
+}
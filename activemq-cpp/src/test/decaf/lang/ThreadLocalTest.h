@@ -31,6 +31,7 @@ namespace lang {
         CPPUNIT_TEST( testGet );
         CPPUNIT_TEST( testRemove );
         CPPUNIT_TEST( testSet );
+        CPPUNIT_TEST( testManyThreads );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -42,6 +43,7 @@ namespace lang {
         void testGet();
         void testRemove();
         void testSet();
+        void testManyThreads();
 
     };
 
@@ -921,3 +921,69 @@ void ThreadTest::testCreatedButNotStarted() {
 
     threads.clear();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadTest::testSetAffinity() {
+
+    std::vector<int> processors = System::getNumaNodeProcessors(0);
+    CPPUNIT_ASSERT(!processors.empty());
+    CPPUNIT_ASSERT(System::availableNumaNodes() >= 1);
+    CPPUNIT_ASSERT(System::getNumaNodeProcessors(System::availableNumaNodes()).empty());
+
+    RunThread runnable;
+    Thread thread(&runnable);
+    CPPUNIT_ASSERT(thread.getAffinity().empty());
+
+    std::vector<int> affinity(1, processors[0]);
+    thread.setAffinity(affinity);
+    CPPUNIT_ASSERT(thread.getAffinity() == affinity);
+
+    thread.start();
+    thread.join();
+
+    CPPUNIT_ASSERT(runnable.didThreadRun);
+
+    std::vector<int> invalid(1, -1);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        thread.setAffinity(invalid),
+        IllegalArgumentException);
+
+    Thread other(&runnable);
+    other.setAffinity(processors);
+    other.setAffinity(std::vector<int>());
+    CPPUNIT_ASSERT(other.getAffinity().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ThreadTest::testDefaultStackSize() {
+
+    const long long STACK_SIZE = 512 * 1024;
+
+    CPPUNIT_ASSERT_EQUAL(-1LL, Thread::getDefaultStackSize());
+
+    RunThread runnable;
+    Thread platform(&runnable);
+    CPPUNIT_ASSERT_EQUAL(-1LL, platform.getStackSize());
+
+    Thread::setDefaultStackSize(STACK_SIZE);
+    CPPUNIT_ASSERT_EQUAL(STACK_SIZE, Thread::getDefaultStackSize());
+
+    Thread sized(&runnable);
+    Thread explicitSize(&runnable, "explicit", STACK_SIZE * 2);
+
+    Thread::setDefaultStackSize(-1);
+
+    CPPUNIT_ASSERT_EQUAL(STACK_SIZE, sized.getStackSize());
+    CPPUNIT_ASSERT_EQUAL(STACK_SIZE * 2, explicitSize.getStackSize());
+
+    sized.start();
+    sized.join();
+    CPPUNIT_ASSERT(runnable.didThreadRun);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        Thread::setDefaultStackSize(0),
+        IllegalArgumentException);
+    CPPUNIT_ASSERT_EQUAL(-1LL, Thread::getDefaultStackSize());
+}
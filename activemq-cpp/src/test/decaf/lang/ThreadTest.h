@@ -56,6 +56,8 @@ namespace lang{
       CPPUNIT_TEST( testRapidCreateAndDestroy );
       CPPUNIT_TEST( testConcurrentRapidCreateAndDestroy );
       CPPUNIT_TEST( testCreatedButNotStarted );
+      CPPUNIT_TEST( testSetAffinity );
+      CPPUNIT_TEST( testDefaultStackSize );
       CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -94,6 +96,8 @@ namespace lang{
         void testRapidCreateAndDestroy();
         void testConcurrentRapidCreateAndDestroy();
         void testCreatedButNotStarted();
+        void testSetAffinity();
+        void testDefaultStackSize();
 
     };
 
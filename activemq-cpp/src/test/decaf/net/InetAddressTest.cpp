@@ -84,3 +84,18 @@ void InetAddressTest::testGetLocalHost() {
     CPPUNIT_ASSERT( address.getHostName() != "" );
     CPPUNIT_ASSERT( address.getHostAddress() != "" );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void InetAddressTest::testGetByName() {
+
+    InetAddress address = InetAddress::getByName( "127.0.0.1" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "127.0.0.1" ), address.getHostAddress() );
+    CPPUNIT_ASSERT_EQUAL( std::string( "127.0.0.1" ), address.getHostName() );
+
+    InetAddress local = InetAddress::getLocalHost();
+    InetAddress byName = InetAddress::getByName( local.getHostName() );
+    CPPUNIT_ASSERT_EQUAL( local.getHostAddress(), byName.getHostAddress() );
+
+    InetAddress::resolveAsync( "127.0.0.1" );
+    CPPUNIT_ASSERT_EQUAL( std::string( "127.0.0.1" ), InetAddress::getByName( "127.0.0.1" ).getHostAddress() );
+}
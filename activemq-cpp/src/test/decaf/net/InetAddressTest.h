@@ -30,6 +30,7 @@ namespace net {
         CPPUNIT_TEST( testGetByAddress );
         CPPUNIT_TEST( testGetHostAddress );
         CPPUNIT_TEST( testGetLocalHost );
+        CPPUNIT_TEST( testGetByName );
         CPPUNIT_TEST( testClone );
         CPPUNIT_TEST_SUITE_END();
 
@@ -42,6 +43,7 @@ namespace net {
         void testGetByAddress();
         void testGetHostAddress();
         void testGetLocalHost();
+        void testGetByName();
 
     };
 
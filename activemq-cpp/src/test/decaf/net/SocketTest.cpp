@@ -822,3 +822,48 @@ void SocketTest::testTrxNoDelay() {
         printf( "%s\n", ex.getMessage().c_str() );
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void SocketTest::testWriteArrays() {
+
+    ServerSocket server(0);
+    Socket client( "127.0.0.1", server.getLocalPort() );
+    std::auto_ptr<Socket> worker( server.accept() );
+
+    // More arrays than go out in one vectored send, with some empty ones mixed in.
+    const int COUNT = 100;
+    const int LENGTH = 37;
+
+    std::vector<unsigned char> data( COUNT * LENGTH );
+    for( std::size_t i = 0; i < data.size(); ++i ) {
+        data[i] = (unsigned char) i;
+    }
+
+    std::vector<const unsigned char*> buffers;
+    std::vector<int> lengths;
+    for( int i = 0; i < COUNT; ++i ) {
+        buffers.push_back( &data[i * LENGTH] );
+        lengths.push_back( LENGTH );
+        if( i % 10 == 0 ) {
+            buffers.push_back( NULL );
+            lengths.push_back( 0 );
+        }
+    }
+
+    client.getOutputStream()->writeArrays( &buffers[0], &lengths[0], (int) buffers.size() );
+
+    std::vector<unsigned char> received( data.size() );
+    InputStream* in = worker->getInputStream();
+    int total = 0;
+    while( total < (int) received.size() ) {
+        int count = in->read( &received[0], (int) received.size(), total, (int) received.size() - total );
+        CPPUNIT_ASSERT_MESSAGE( "Unexpected end of stream", count > 0 );
+        total += count;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE( "Received data doesn't match what was sent", data == received );
+
+    client.close();
+    worker->close();
+    server.close();
+}
@@ -49,6 +49,7 @@ namespace net{
         CPPUNIT_TEST( testTrx );
         CPPUNIT_TEST( testTrxNoDelay );
         CPPUNIT_TEST( testRxFail );
+        CPPUNIT_TEST( testWriteArrays );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -78,6 +79,7 @@ namespace net{
         void testTx();
         void testTrx();
         void testRxFail();
+        void testWriteArrays();
         void testTrxNoDelay();
 
     };
@@ -190,3 +190,45 @@ void MessageDigestTest::testResults3() {
 //    result = digest->digest((const unsigned char*)bytes.data(), (int)bytes.size());
 //    CPPUNIT_ASSERT_EQUAL(std::string("2fd4e1c67a2d28fced849ee1bb76e7391b93eb12"), toString(result));
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MessageDigestTest::testResults4() {
+
+#ifdef HAVE_OPENSSL
+
+    // With OpenSSL both SHA digests are computed by it.
+    Pointer<MessageDigest> sha1(MessageDigest::getInstance("SHA1"));
+
+    std::string bytes = "The quick brown fox jumps over the lazy dog";
+    std::vector<unsigned char> result = sha1->digest((const unsigned char*)bytes.data(), (int)bytes.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("2fd4e1c67a2d28fced849ee1bb76e7391b93eb12"), toString(result));
+
+    Pointer<MessageDigest> digest(MessageDigest::getInstance("SHA-256"));
+    CPPUNIT_ASSERT_EQUAL(32, digest->getDigestLength());
+
+    bytes = "";
+    result = digest->digest((const unsigned char*)bytes.data(), (int)bytes.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"), toString(result));
+
+    // The digest resets once taken, a clone continues from the state it was taken in.
+    bytes = "The quick brown fox ";
+    digest->update(std::vector<unsigned char>(bytes.begin(), bytes.end()));
+    Pointer<MessageDigest> clone(digest->clone());
+
+    bytes = "jumps over the lazy dog";
+    digest->update(std::vector<unsigned char>(bytes.begin(), bytes.end()));
+    clone->update(std::vector<unsigned char>(bytes.begin(), bytes.end()));
+
+    std::string expected("d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592");
+    CPPUNIT_ASSERT_EQUAL(expected, toString(digest->digest()));
+    CPPUNIT_ASSERT_EQUAL(expected, toString(clone->digest()));
+
+#else
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "SHA-256 is only provided with OpenSSL",
+        MessageDigest::getInstance("SHA-256"),
+        NoSuchAlgorithmException);
+
+#endif
+}
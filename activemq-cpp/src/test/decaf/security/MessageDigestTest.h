@@ -34,6 +34,7 @@ namespace security {
         CPPUNIT_TEST( testResults1 );
         CPPUNIT_TEST( testResults2 );
         CPPUNIT_TEST( testResults3 );
+        CPPUNIT_TEST( testResults4 );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -49,6 +50,7 @@ namespace security {
         void testResults1();
         void testResults2();
         void testResults3();
+        void testResults4();
 
     };
 
@@ -857,3 +857,22 @@ void ArrayListTest::testListIterator2IndexOutOfBoundsException() {
         std::auto_ptr< ListIterator<int> > it( list.listIterator( 100 ) ),
         IndexOutOfBoundsException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void ArrayListTest::testConstIterator() {
+
+    ArrayList<int> list;
+    CPPUNIT_ASSERT(list.begin() == list.end());
+
+    for (int i = 0; i < 100; ++i) {
+        list.add(i);
+    }
+    list.remove(0);
+
+    int expected = 1;
+    for (ArrayList<int>::const_iterator iter = list.begin(); iter != list.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(expected++, *iter);
+    }
+    CPPUNIT_ASSERT_EQUAL(100, expected);
+    CPPUNIT_ASSERT_EQUAL(99, (int) (list.end() - list.begin()));
+}
@@ -61,6 +61,7 @@ namespace util {
         CPPUNIT_TEST( testRetainAll );
         CPPUNIT_TEST( testListIterator1IndexOutOfBoundsException );
         CPPUNIT_TEST( testListIterator2IndexOutOfBoundsException );
+        CPPUNIT_TEST( testConstIterator );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -106,6 +107,7 @@ namespace util {
         void testRetainAll();
         void testListIterator1IndexOutOfBoundsException();
         void testListIterator2IndexOutOfBoundsException();
+        void testConstIterator();
 
     };
 
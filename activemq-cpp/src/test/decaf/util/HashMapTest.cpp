@@ -692,3 +692,26 @@ void HashMapTest::testValuesIterator() {
         iterator->remove(),
         IllegalStateException);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void HashMapTest::testConstIterator() {
+
+    HashMap<int, std::string> map;
+    CPPUNIT_ASSERT(map.begin() == map.end());
+
+    for (int i = 0; i < 100; ++i) {
+        map.put(i, Integer::toString(i));
+    }
+    map.remove(50);
+
+    int count = 0;
+    int keySum = 0;
+    for (HashMap<int, std::string>::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(iter.getKey()), iter.getValue());
+        keySum += iter.getKey();
+        count++;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(99, count);
+    CPPUNIT_ASSERT_EQUAL(4950 - 50, keySum);
+}
@@ -50,6 +50,7 @@ namespace util {
         CPPUNIT_TEST( testKeySetIterator );
         CPPUNIT_TEST( testValuesIterator );
         CPPUNIT_TEST( testToString );
+        CPPUNIT_TEST( testConstIterator );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -81,6 +82,7 @@ namespace util {
         void testEntrySetIterator();
         void testKeySetIterator();
         void testValuesIterator();
+        void testConstIterator();
 
     };
 
@@ -880,3 +880,22 @@ void LinkedHashMapTest::testRemoveEldest() {
 
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Incorrect number of removals", 5, map.removals);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void LinkedHashMapTest::testConstIterator() {
+
+    LinkedHashMap<int, std::string> map;
+    CPPUNIT_ASSERT(map.begin() == map.end());
+
+    for (int i = 99; i >= 0; --i) {
+        map.put(i, Integer::toString(i));
+    }
+
+    int expected = 99;
+    for (LinkedHashMap<int, std::string>::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(expected, iter.getKey());
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(expected), iter.getValue());
+        expected--;
+    }
+    CPPUNIT_ASSERT_EQUAL(-1, expected);
+}
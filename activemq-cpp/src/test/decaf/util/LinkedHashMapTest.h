@@ -53,6 +53,7 @@ namespace util {
         CPPUNIT_TEST( testOrderedKeySet );
         CPPUNIT_TEST( testOrderedValues );
         CPPUNIT_TEST( testRemoveEldest );
+        CPPUNIT_TEST( testConstIterator );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -85,6 +86,7 @@ namespace util {
         void testOrderedKeySet();
         void testOrderedValues();
         void testRemoveEldest();
+        void testConstIterator();
 
     };
 
@@ -20,6 +20,7 @@
 #include <decaf/util/ArrayList.h>
 #include <decaf/util/LinkedList.h>
 #include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
 
 using namespace decaf;
 using namespace decaf::lang;
@@ -1257,3 +1258,108 @@ void LinkedListTest::testRemoveLastOccurrence() {
     CPPUNIT_ASSERT_EQUAL( 3, list.getLast() );
     CPPUNIT_ASSERT( !list.removeLastOccurrence(1) );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class Tracked {
+    public:
+
+        static int live;
+
+        Tracked() { live++; }
+        Tracked(const Tracked&) { live++; }
+        ~Tracked() { live--; }
+    };
+
+    int Tracked::live = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LinkedListTest::testNodeCache() {
+
+    LinkedList<int> list;
+    CPPUNIT_ASSERT_EQUAL(0, list.getNodeCacheSize());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        list.setNodeCacheSize(-1),
+        IllegalArgumentException);
+
+    list.setNodeCacheSize(8);
+    CPPUNIT_ASSERT_EQUAL(8, list.getNodeCacheSize());
+
+    // Nodes freed from either end, by iterators and by clear are handed out again.
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 20; ++i) {
+            list.addLast(i);
+        }
+        CPPUNIT_ASSERT_EQUAL(0, list.removeFirst());
+        CPPUNIT_ASSERT_EQUAL(19, list.removeLast());
+
+        std::auto_ptr< Iterator<int> > iter(list.iterator());
+        while (iter->hasNext()) {
+            if (iter->next() % 2 == 0) {
+                iter->remove();
+            }
+        }
+
+        CPPUNIT_ASSERT_EQUAL(9, list.size());
+        CPPUNIT_ASSERT_EQUAL(1, list.getFirst());
+        CPPUNIT_ASSERT_EQUAL(17, list.getLast());
+
+        list.addFirst(100);
+        list.add(5, 200);
+        CPPUNIT_ASSERT_EQUAL(100, list.getFirst());
+        CPPUNIT_ASSERT_EQUAL(200, list.get(5));
+
+        list.clear();
+        CPPUNIT_ASSERT(list.isEmpty());
+    }
+
+    list.setNodeCacheSize(0);
+    list.add(1);
+    CPPUNIT_ASSERT_EQUAL(1, list.removeFirst());
+
+    // A cached node must not keep its element alive.
+    {
+        LinkedList< Pointer<Tracked> > tracked;
+        tracked.setNodeCacheSize(4);
+        for (int i = 0; i < 4; ++i) {
+            tracked.add(Pointer<Tracked>(new Tracked()));
+        }
+        CPPUNIT_ASSERT_EQUAL(4, Tracked::live);
+
+        tracked.removeFirst();
+        tracked.clear();
+        CPPUNIT_ASSERT_EQUAL(0, Tracked::live);
+
+        tracked.add(Pointer<Tracked>(new Tracked()));
+        CPPUNIT_ASSERT_EQUAL(1, Tracked::live);
+    }
+    CPPUNIT_ASSERT_EQUAL(0, Tracked::live);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LinkedListTest::testConstIterator() {
+
+    LinkedList<int> list;
+    CPPUNIT_ASSERT(list.begin() == list.end());
+
+    for (int i = 0; i < 10; ++i) {
+        list.add(i);
+    }
+
+    int expected = 0;
+    for (LinkedList<int>::const_iterator iter = list.begin(); iter != list.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(expected++, *iter);
+    }
+    CPPUNIT_ASSERT_EQUAL(10, expected);
+
+    list.removeFirst();
+    list.addLast(10);
+
+    LinkedList<int>::const_iterator iter = list.begin();
+    CPPUNIT_ASSERT_EQUAL(1, *iter++);
+    CPPUNIT_ASSERT_EQUAL(2, *iter);
+}
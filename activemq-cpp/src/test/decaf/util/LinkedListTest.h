@@ -81,6 +81,8 @@ namespace util {
         CPPUNIT_TEST( testDescendingIterator );
         CPPUNIT_TEST( testRemoveFirstOccurrence );
         CPPUNIT_TEST( testRemoveLastOccurrence );
+        CPPUNIT_TEST( testNodeCache );
+        CPPUNIT_TEST( testConstIterator );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -146,6 +148,8 @@ namespace util {
         void testDescendingIterator();
         void testRemoveFirstOccurrence();
         void testRemoveLastOccurrence();
+        void testNodeCache();
+        void testConstIterator();
 
     };
 
@@ -0,0 +1,372 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenHashMapTest.h"
+
+#include <decaf/util/Set.h>
+#include <decaf/util/Iterator.h>
+#include <decaf/util/OpenHashMap.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/util/StlMap.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MAP_SIZE = 1000;
+
+    void populateMap(OpenHashMap<int, std::string>& map) {
+        for (int i = 0; i < MAP_SIZE; ++i) {
+            map.put(i, Integer::toString(i));
+        }
+    }
+
+    // Sends every key to one of a handful of home slots so the keys share long runs.
+    struct CollidingHashCode {
+        int operator()(const int& key) const {
+            return key % 5;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenHashMapTest::OpenHashMapTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+OpenHashMapTest::~OpenHashMapTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testConstructor() {
+
+    OpenHashMap<int, std::string> map;
+    CPPUNIT_ASSERT(map.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, map.size());
+
+    OpenHashMap<int, std::string> sized(100);
+    CPPUNIT_ASSERT(sized.isEmpty());
+    sized.put(1, "one");
+    CPPUNIT_ASSERT_EQUAL(std::string("one"), sized.get(1));
+
+    typedef OpenHashMap<int, std::string> IntStringMap;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown IllegalArgumentException",
+        IntStringMap(-1),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testConstructorMap() {
+
+    HashMap<int, std::string> source;
+    for (int i = 0; i < 100; ++i) {
+        source.put(i, Integer::toString(i));
+    }
+
+    OpenHashMap<int, std::string> map(source);
+    CPPUNIT_ASSERT_EQUAL(100, map.size());
+    CPPUNIT_ASSERT(map.equals(source));
+    CPPUNIT_ASSERT(source.equals(map));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testCopyConstructor() {
+
+    OpenHashMap<int, std::string> map1;
+    populateMap(map1);
+
+    OpenHashMap<int, std::string> map2(map1);
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map2.size());
+    CPPUNIT_ASSERT(map1.equals(map2));
+
+    OpenHashMap<int, std::string> map3;
+    map3.put(-1, "gone");
+    map3 = map1;
+    CPPUNIT_ASSERT(map3.equals(map1));
+    CPPUNIT_ASSERT(!map3.containsKey(-1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testClear() {
+
+    OpenHashMap<int, std::string> map;
+    for (int i = -32767; i < 32768; i++) {
+        map.put(i, "foobar");
+    }
+    map.clear();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Failed to reset size on large integer map", 0, map.size());
+    for (int i = -32767; i < 32768; i++) {
+        CPPUNIT_ASSERT_MESSAGE("Failed to clear all elements", !map.containsKey(i));
+    }
+
+    map.put(7, "seven");
+    CPPUNIT_ASSERT_EQUAL(std::string("seven"), map.get(7));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testContainsKey() {
+
+    OpenHashMap<int, std::string> map;
+    map.put(876, "test");
+
+    CPPUNIT_ASSERT_MESSAGE("Returned false for valid key", map.containsKey(876));
+    CPPUNIT_ASSERT_MESSAGE("Returned true for invalid key", !map.containsKey(1));
+
+    map.put(0, "test");
+    CPPUNIT_ASSERT_MESSAGE("Failed with key", map.containsKey(0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testContainsValue() {
+
+    OpenHashMap<int, std::string> map;
+    map.put(876, "test");
+
+    CPPUNIT_ASSERT_MESSAGE("Returned false for valid value", map.containsValue("test"));
+    CPPUNIT_ASSERT_MESSAGE("Returned true for invalid value", !map.containsValue(""));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testGet() {
+
+    OpenHashMap<int, std::string> map;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown NoSuchElementException",
+        map.get(1),
+        NoSuchElementException);
+
+    map.put(22, "HELLO");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Get returned incorrect value for existing key",
+                                 std::string("HELLO"), map.get(22));
+
+    const OpenHashMap<int, std::string>& constMap = map;
+    CPPUNIT_ASSERT_EQUAL(std::string("HELLO"), constMap.get(22));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testPut() {
+
+    OpenHashMap<int, std::string> map;
+
+    CPPUNIT_ASSERT_MESSAGE("New key reported as replaced", !map.put(1, "one"));
+
+    std::string oldValue;
+    CPPUNIT_ASSERT_MESSAGE("Existing key not reported as replaced", map.put(1, "uno", oldValue));
+    CPPUNIT_ASSERT_EQUAL(std::string("one"), oldValue);
+    CPPUNIT_ASSERT_EQUAL(std::string("uno"), map.get(1));
+    CPPUNIT_ASSERT_EQUAL(1, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testRemove() {
+
+    OpenHashMap<int, std::string> map;
+    populateMap(map);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), map.remove(1));
+    CPPUNIT_ASSERT(!map.containsKey(1));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, map.size());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown NoSuchElementException",
+        map.remove(1),
+        NoSuchElementException);
+
+    for (int i = 2; i < MAP_SIZE; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), map.get(i));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testRemoveCollidingKeys() {
+
+    OpenHashMap<int, int, CollidingHashCode> map;
+    for (int i = 0; i < 200; ++i) {
+        map.put(i, i * 10);
+    }
+
+    // Removing from the middle of the runs shifts the rest back, every other key
+    // must still be found where the shift left it.
+    for (int i = 0; i < 200; i += 3) {
+        CPPUNIT_ASSERT_EQUAL(i * 10, map.remove(i));
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        if (i % 3 == 0) {
+            CPPUNIT_ASSERT(!map.containsKey(i));
+        } else {
+            CPPUNIT_ASSERT_EQUAL(i * 10, map.get(i));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testRehash() {
+
+    OpenHashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i) {
+        map.put(i << 8, i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(100000, map.size());
+    for (int i = 0; i < 100000; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, map.get(i << 8));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testEntrySet() {
+
+    OpenHashMap<int, std::string> map;
+    for (int i = 0; i < 50; i++) {
+        map.put(i, Integer::toString(i));
+    }
+
+    Set<MapEntry<int, std::string> >& set = map.entrySet();
+    CPPUNIT_ASSERT_EQUAL(50, set.size());
+    CPPUNIT_ASSERT(set.contains(MapEntry<int, std::string>(7, "7")));
+    CPPUNIT_ASSERT(!set.contains(MapEntry<int, std::string>(7, "8")));
+
+    CPPUNIT_ASSERT(set.remove(MapEntry<int, std::string>(7, "7")));
+    CPPUNIT_ASSERT_EQUAL(49, map.size());
+
+    const OpenHashMap<int, std::string>& constMap = map;
+    Pointer< Iterator<MapEntry<int, std::string> > > iterator(constMap.entrySet().iterator());
+    iterator->next();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown UnsupportedOperationException",
+        iterator->remove(),
+        UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testKeySet() {
+
+    OpenHashMap<int, std::string> map;
+    populateMap(map);
+
+    Set<int>& keys = map.keySet();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, keys.size());
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        CPPUNIT_ASSERT(keys.contains(i));
+    }
+
+    CPPUNIT_ASSERT(keys.remove(5));
+    CPPUNIT_ASSERT(!keys.remove(5));
+    CPPUNIT_ASSERT(!map.containsKey(5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testValues() {
+
+    OpenHashMap<int, std::string> map;
+    populateMap(map);
+
+    Collection<std::string>& values = map.values();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, values.size());
+    CPPUNIT_ASSERT(values.contains("50"));
+
+    values.clear();
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testEntrySetIterator() {
+
+    OpenHashMap<int, std::string> map;
+    populateMap(map);
+
+    StlMap<int, std::string> seen;
+    Pointer< Iterator<MapEntry<int, std::string> > > iterator(map.entrySet().iterator());
+    while (iterator->hasNext()) {
+        MapEntry<int, std::string> entry = iterator->next();
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(entry.getKey()), entry.getValue());
+        CPPUNIT_ASSERT_MESSAGE("Key visited twice", !seen.put(entry.getKey(), entry.getValue()));
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Iterator didn't cover the expected range", MAP_SIZE, seen.size());
+
+    iterator.reset(map.entrySet().iterator());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalStateException",
+        iterator->remove(),
+        IllegalStateException);
+
+    int count = 0;
+    while (iterator->hasNext()) {
+        iterator->next();
+        iterator->remove();
+        count++;
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Iterator didn't remove the expected range", MAP_SIZE, count);
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testIteratorRemoveCollidingKeys() {
+
+    OpenHashMap<int, int, CollidingHashCode> map;
+    for (int i = 0; i < 500; ++i) {
+        map.put(i, i);
+    }
+
+    // Removals shift the following keys back into slots already passed, each key must
+    // still be visited exactly once.
+    StlMap<int, int> seen;
+    Pointer< Iterator<int> > iterator(map.keySet().iterator());
+    while (iterator->hasNext()) {
+        int key = iterator->next();
+        CPPUNIT_ASSERT_MESSAGE("Key visited twice", !seen.put(key, key));
+        if (key % 2 == 0) {
+            iterator->remove();
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(500, seen.size());
+    CPPUNIT_ASSERT_EQUAL(250, map.size());
+    for (int i = 1; i < 500; i += 2) {
+        CPPUNIT_ASSERT(map.containsKey(i));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void OpenHashMapTest::testConcurrentModification() {
+
+    OpenHashMap<int, std::string> map;
+    populateMap(map);
+
+    Pointer< Iterator<int> > iterator(map.keySet().iterator());
+    iterator->next();
+
+    map.put(-1, "new");
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw a ConcurrentModificationException",
+        iterator->next(),
+        ConcurrentModificationException);
+}
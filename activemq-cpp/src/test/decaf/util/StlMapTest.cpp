@@ -459,3 +459,22 @@ void StlMapTest::testValuesIterator() {
         iterator->remove(),
         IllegalStateException);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void StlMapTest::testConstIterator() {
+
+    StlMap<int, std::string> map;
+    CPPUNIT_ASSERT(map.begin() == map.end());
+
+    for (int i = 9; i >= 0; --i) {
+        map.put(i, Integer::toString(i));
+    }
+
+    int expected = 0;
+    for (StlMap<int, std::string>::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
+        CPPUNIT_ASSERT_EQUAL(expected, iter.getKey());
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(expected), iter.getValue());
+        expected++;
+    }
+    CPPUNIT_ASSERT_EQUAL(10, expected);
+}
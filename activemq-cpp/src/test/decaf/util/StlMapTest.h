@@ -44,6 +44,7 @@ namespace util {
         CPPUNIT_TEST( testEntrySetIterator );
         CPPUNIT_TEST( testKeySetIterator );
         CPPUNIT_TEST( testValuesIterator );
+        CPPUNIT_TEST( testConstIterator );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -68,6 +69,7 @@ namespace util {
         void testEntrySetIterator();
         void testKeySetIterator();
         void testValuesIterator();
+        void testConstIterator();
 
     };
 
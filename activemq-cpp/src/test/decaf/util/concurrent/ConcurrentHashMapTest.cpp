@@ -15,12 +15,99 @@
  * limitations under the License.
  */
 
+
 #include "ConcurrentHashMapTest.h"
 
+#include <decaf/util/concurrent/ConcurrentHashMap.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/HashMap.h>
+#include <decaf/util/StlMap.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/IllegalStateException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+
+#include <memory>
+#include <string>
+
 using namespace std;
 using namespace decaf;
 using namespace decaf::util;
 using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    const int MAP_SIZE = 1000;
+
+    void populateMap(ConcurrentHashMap<int, std::string>& map) {
+        for (int i = 0; i < MAP_SIZE; ++i) {
+            map.put(i, Integer::toString(i));
+        }
+    }
+
+    class Key {
+    public:
+
+        int value;
+
+        Key(int value) : value(value) {}
+
+        int getHashCode() const {
+            return value;
+        }
+
+        bool operator==(const Key& other) const {
+            return value == other.value;
+        }
+    };
+
+    class PutRemoveRunnable : public Runnable {
+    private:
+
+        ConcurrentHashMap<int, int>* map;
+        AtomicInteger* failures;
+        int base;
+
+    private:
+
+        PutRemoveRunnable(const PutRemoveRunnable&);
+        PutRemoveRunnable operator= (const PutRemoveRunnable&);
+
+    public:
+
+        PutRemoveRunnable(ConcurrentHashMap<int, int>* map, AtomicInteger* failures, int base) :
+            Runnable(), map(map), failures(failures), base(base) {
+        }
+
+        virtual ~PutRemoveRunnable() {}
+
+        virtual void run() {
+            for (int i = base; i < base + 500; ++i) {
+                map->put(i, i);
+            }
+
+            for (int i = base; i < base + 500; ++i) {
+                int value = -1;
+                if (!map->tryGet(i, value) || value != i) {
+                    failures->incrementAndGet();
+                }
+            }
+
+            for (int i = base; i < base + 500; i += 2) {
+                if (!map->remove(i, i)) {
+                    failures->incrementAndGet();
+                }
+            }
+        }
+    };
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ConcurrentHashMapTest::ConcurrentHashMapTest() {
@@ -33,4 +120,381 @@ ConcurrentHashMapTest::~ConcurrentHashMapTest() {
 ////////////////////////////////////////////////////////////////////////////////
 void ConcurrentHashMapTest::testConstructor() {
 
+    ConcurrentHashMap<string, int> map1;
+    CPPUNIT_ASSERT(map1.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, map1.size());
+    CPPUNIT_ASSERT_EQUAL(16, map1.getSegmentCount());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        map1.get("TEST"),
+        decaf::util::NoSuchElementException);
+
+    ConcurrentHashMap<string, int> map2(64, 0.5f, 5);
+    CPPUNIT_ASSERT_EQUAL(8, map2.getSegmentCount());
+
+    ConcurrentHashMap<string, int> map3(0, 0.75f, 1);
+    CPPUNIT_ASSERT_EQUAL(1, map3.getSegmentCount());
+    map3.put("A", 1);
+    map3.put("B", 2);
+    CPPUNIT_ASSERT_EQUAL(2, map3.size());
+
+    HashMap<string, int> srcMap;
+    srcMap.put("A", 1);
+    srcMap.put("B", 1);
+    srcMap.put("C", 1);
+
+    ConcurrentHashMap<string, int> destMap(srcMap);
+
+    CPPUNIT_ASSERT_EQUAL(3, destMap.size());
+    CPPUNIT_ASSERT_EQUAL(1, destMap.get("B"));
+
+    ConcurrentHashMap<string, int> copyMap(destMap);
+    CPPUNIT_ASSERT_EQUAL(3, copyMap.size());
+    CPPUNIT_ASSERT(copyMap.equals(destMap));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testConstructorInvalidArgs() {
+
+    typedef ConcurrentHashMap<int, int> IntMap;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        IntMap(-1),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        IntMap(16, 0.0f),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        IntMap(16, 0.75f, 0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPutGet() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map.size());
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        CPPUNIT_ASSERT(map.containsKey(i));
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), map.get(i));
+    }
+
+    CPPUNIT_ASSERT(!map.containsKey(MAP_SIZE));
+    CPPUNIT_ASSERT(map.containsValue("10"));
+    CPPUNIT_ASSERT(!map.containsValue("Test"));
+
+    std::string oldValue;
+    CPPUNIT_ASSERT(map.put(10, "Ten", oldValue));
+    CPPUNIT_ASSERT_EQUAL(std::string("10"), oldValue);
+    CPPUNIT_ASSERT_EQUAL(std::string("Ten"), map.get(10));
+    CPPUNIT_ASSERT(!map.put(MAP_SIZE, "Last"));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE + 1, map.size());
+
+    std::string value = "unchanged";
+    CPPUNIT_ASSERT(!map.tryGet(-1, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("unchanged"), value);
+    CPPUNIT_ASSERT(map.tryGet(5, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("5"), value);
+
+    const ConcurrentHashMap<int, std::string>& constMap = map;
+    CPPUNIT_ASSERT_EQUAL(std::string("7"), constMap.get(7));
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        constMap.get(-1),
+        decaf::util::NoSuchElementException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testRemove() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("1"), map.remove(1));
+    CPPUNIT_ASSERT(!map.containsKey(1));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, map.size());
+
+    CPPUNIT_ASSERT_EQUAL(std::string(), map.remove(1));
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE - 1, map.size());
+
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        map.remove(i);
+    }
+
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPutIfAbsent() {
+
+    ConcurrentHashMap<std::string, int> map;
+
+    CPPUNIT_ASSERT(map.putIfAbsent("A", 1));
+    CPPUNIT_ASSERT(!map.putIfAbsent("A", 2));
+    CPPUNIT_ASSERT_EQUAL(1, map.get("A"));
+    CPPUNIT_ASSERT_EQUAL(1, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testRemoveIfMapped() {
+
+    ConcurrentHashMap<std::string, int> map;
+    map.put("A", 1);
+
+    CPPUNIT_ASSERT(!map.remove("A", 2));
+    CPPUNIT_ASSERT(map.containsKey("A"));
+    CPPUNIT_ASSERT(!map.remove("B", 1));
+    CPPUNIT_ASSERT(map.remove("A", 1));
+    CPPUNIT_ASSERT(!map.containsKey("A"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testReplace() {
+
+    ConcurrentHashMap<std::string, int> map;
+    map.put("A", 1);
+
+    CPPUNIT_ASSERT(!map.replace("A", 2, 3));
+    CPPUNIT_ASSERT_EQUAL(1, map.get("A"));
+    CPPUNIT_ASSERT(map.replace("A", 1, 3));
+    CPPUNIT_ASSERT_EQUAL(3, map.get("A"));
+
+    CPPUNIT_ASSERT_EQUAL(3, map.replace("A", 4));
+    CPPUNIT_ASSERT_EQUAL(4, map.get("A"));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        map.replace("B", 1),
+        decaf::util::NoSuchElementException);
+    CPPUNIT_ASSERT(!map.containsKey("B"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testClear() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    map.clear();
+    CPPUNIT_ASSERT(map.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, map.size());
+    CPPUNIT_ASSERT(!map.containsKey(1));
+
+    populateMap(map);
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, map.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testRehash() {
+
+    // A single segment with a tiny table has to grow many times over.
+    ConcurrentHashMap<int, int> map(1, 0.75f, 1);
+
+    for (int i = 0; i < 10000; ++i) {
+        map.put(i * 31, i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(10000, map.size());
+    for (int i = 0; i < 10000; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, map.get(i * 31));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testEntrySet() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    Set< MapEntry<int, std::string> >& entries = map.entrySet();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, entries.size());
+    CPPUNIT_ASSERT(entries.contains(MapEntry<int, std::string>(5, "5")));
+    CPPUNIT_ASSERT(!entries.contains(MapEntry<int, std::string>(5, "6")));
+
+    StlMap<int, std::string> seen;
+    std::auto_ptr< Iterator< MapEntry<int, std::string> > > iter(entries.iterator());
+    while (iter->hasNext()) {
+        MapEntry<int, std::string> entry = iter->next();
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(entry.getKey()), entry.getValue());
+        seen.put(entry.getKey(), entry.getValue());
+    }
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, seen.size());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        iter->next(),
+        decaf::util::NoSuchElementException);
+
+    CPPUNIT_ASSERT(entries.remove(MapEntry<int, std::string>(5, "5")));
+    CPPUNIT_ASSERT(!map.containsKey(5));
+
+    const ConcurrentHashMap<int, std::string>& constMap = map;
+    std::auto_ptr< Iterator< MapEntry<int, std::string> > > constIter(constMap.entrySet().iterator());
+    CPPUNIT_ASSERT(constIter->hasNext());
+    constIter->next();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an UnsupportedOperationException",
+        constIter->remove(),
+        UnsupportedOperationException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testKeySetIteratorRemove() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    std::auto_ptr< Iterator<int> > iter(map.keySet().iterator());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalStateException",
+        iter->remove(),
+        IllegalStateException);
+
+    int removed = 0;
+    while (iter->hasNext()) {
+        int key = iter->next();
+        if (key >= MAP_SIZE) {
+            continue;
+        }
+
+        if (key % 2 == 0) {
+            iter->remove();
+            removed++;
+        }
+
+        // Changes made while iterating never invalidate the iterator.
+        map.put(key + MAP_SIZE, "extra");
+    }
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE / 2, removed);
+    for (int i = 0; i < MAP_SIZE; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i % 2 != 0, map.containsKey(i));
+    }
+
+    CPPUNIT_ASSERT(map.keySet().remove(1));
+    CPPUNIT_ASSERT(!map.keySet().remove(1));
+    CPPUNIT_ASSERT(!map.containsKey(1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testValues() {
+
+    ConcurrentHashMap<int, std::string> map;
+    populateMap(map);
+
+    Collection<std::string>& values = map.values();
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, values.size());
+    CPPUNIT_ASSERT(values.contains("999"));
+    CPPUNIT_ASSERT(!values.contains("1000"));
+
+    int count = 0;
+    std::auto_ptr< Iterator<std::string> > iter(values.iterator());
+    while (iter->hasNext()) {
+        iter->next();
+        count++;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(MAP_SIZE, count);
+
+    values.clear();
+    CPPUNIT_ASSERT(map.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testEquals() {
+
+    ConcurrentHashMap<int, std::string> map1;
+    ConcurrentHashMap<int, std::string> map2;
+    populateMap(map1);
+    populateMap(map2);
+
+    CPPUNIT_ASSERT(map1.equals(map2));
+
+    map2.put(0, "Zero");
+    CPPUNIT_ASSERT(!map1.equals(map2));
+
+    map2.remove(0);
+    CPPUNIT_ASSERT(!map1.equals(map2));
+
+    map2.copy(map1);
+    CPPUNIT_ASSERT(map1.equals(map2));
+
+    HashMap<int, std::string> hashMap;
+    hashMap.putAll(map1);
+    CPPUNIT_ASSERT(map1.equals(hashMap));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testPointerKeys() {
+
+    ConcurrentHashMap< Pointer<Key>, int, HashCode< Pointer<Key> >, PointerEquals<Key> > map;
+
+    Pointer<Key> key1(new Key(1));
+    map.put(key1, 1);
+
+    // A different instance with the same value finds the same mapping.
+    Pointer<Key> key2(new Key(1));
+    CPPUNIT_ASSERT(map.containsKey(key2));
+    CPPUNIT_ASSERT_EQUAL(1, map.get(key2));
+
+    CPPUNIT_ASSERT(!map.containsKey(Pointer<Key>(new Key(2))));
+    CPPUNIT_ASSERT(!map.containsKey(Pointer<Key>()));
+
+    map.put(Pointer<Key>(), 0);
+    CPPUNIT_ASSERT(map.containsKey(Pointer<Key>()));
+    CPPUNIT_ASSERT_EQUAL(2, map.size());
+
+    CPPUNIT_ASSERT_EQUAL(1, map.remove(key2));
+    CPPUNIT_ASSERT(!map.containsKey(key1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testConcurrentPutRemove() {
+
+    ConcurrentHashMap<int, int> map;
+    AtomicInteger failures;
+
+    ThreadPoolExecutor executor(8, 8, 60LL, TimeUnit::SECONDS, new LinkedBlockingQueue<Runnable*>());
+
+    for (int i = 0; i < 40; i++) {
+        executor.execute(new PutRemoveRunnable(&map, &failures, i * 500));
+    }
+
+    executor.shutdown();
+    CPPUNIT_ASSERT_MESSAGE("executor terminated", executor.awaitTermination(45, TimeUnit::SECONDS));
+
+    CPPUNIT_ASSERT_EQUAL(0, failures.get());
+    CPPUNIT_ASSERT_EQUAL(40 * 250, map.size());
+
+    for (int i = 0; i < 40 * 500; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i % 2 != 0, map.containsKey(i));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentHashMapTest::testSingleSegment() {
+
+    ConcurrentHashMap<int, std::string> map(16, 0.75f, 1);
+
+    for (int i = 0; i < 100; ++i) {
+        map.put(i, Integer::toString(i));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(100, map.size());
+    for (int i = 0; i < 100; ++i) {
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), map.get(i));
+    }
+
+    map.remove(50);
+    CPPUNIT_ASSERT(!map.containsKey(50));
+    CPPUNIT_ASSERT_EQUAL(99, map.size());
 }
@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+
 #ifndef _DECAF_UTIL_CONCURRENT_CONCURRENTHASHMAPTEST_H_
 #define _DECAF_UTIL_CONCURRENT_CONCURRENTHASHMAPTEST_H_
 
@@ -29,6 +30,21 @@ namespace concurrent {
 
         CPPUNIT_TEST_SUITE( ConcurrentHashMapTest );
         CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testConstructorInvalidArgs );
+        CPPUNIT_TEST( testPutGet );
+        CPPUNIT_TEST( testRemove );
+        CPPUNIT_TEST( testPutIfAbsent );
+        CPPUNIT_TEST( testRemoveIfMapped );
+        CPPUNIT_TEST( testReplace );
+        CPPUNIT_TEST( testClear );
+        CPPUNIT_TEST( testRehash );
+        CPPUNIT_TEST( testEntrySet );
+        CPPUNIT_TEST( testKeySetIteratorRemove );
+        CPPUNIT_TEST( testValues );
+        CPPUNIT_TEST( testEquals );
+        CPPUNIT_TEST( testPointerKeys );
+        CPPUNIT_TEST( testConcurrentPutRemove );
+        CPPUNIT_TEST( testSingleSegment );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -37,6 +53,22 @@ namespace concurrent {
         virtual ~ConcurrentHashMapTest();
 
         void testConstructor();
+        void testConstructorInvalidArgs();
+        void testPutGet();
+        void testRemove();
+        void testPutIfAbsent();
+        void testRemoveIfMapped();
+        void testReplace();
+        void testClear();
+        void testRehash();
+        void testEntrySet();
+        void testKeySetIteratorRemove();
+        void testValues();
+        void testEquals();
+        void testPointerKeys();
+        void testConcurrentPutRemove();
+        void testSingleSegment();
+
     };
 
 }}}
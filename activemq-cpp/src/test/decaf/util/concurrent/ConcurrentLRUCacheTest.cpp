@@ -0,0 +1,294 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConcurrentLRUCacheTest.h"
+
+#include <decaf/util/concurrent/ConcurrentLRUCache.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/LinkedBlockingQueue.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class PutGetRunnable : public Runnable {
+    private:
+
+        ConcurrentLRUCache<int, int>* cache;
+        AtomicInteger* failures;
+        int base;
+
+    private:
+
+        PutGetRunnable(const PutGetRunnable&);
+        PutGetRunnable operator= (const PutGetRunnable&);
+
+    public:
+
+        PutGetRunnable(ConcurrentLRUCache<int, int>* cache, AtomicInteger* failures, int base) :
+            Runnable(), cache(cache), failures(failures), base(base) {
+        }
+
+        virtual ~PutGetRunnable() {}
+
+        virtual void run() {
+            for (int round = 0; round < 20; ++round) {
+                for (int i = base; i < base + 100; ++i) {
+                    cache->put(i, i);
+
+                    // Entries may be evicted at any time but never hold another key's value.
+                    int value = -1;
+                    if (cache->get(i, value) && value != i) {
+                        failures->incrementAndGet();
+                    }
+                }
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentLRUCacheTest::ConcurrentLRUCacheTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ConcurrentLRUCacheTest::~ConcurrentLRUCacheTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testConstructor() {
+
+    ConcurrentLRUCache<int, std::string> cache(100);
+    CPPUNIT_ASSERT_EQUAL(100, cache.getMaxCacheSize());
+    CPPUNIT_ASSERT_EQUAL(0, cache.size());
+    CPPUNIT_ASSERT(cache.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(16, cache.getSegmentCount());
+
+    // Never more segments than entries.
+    ConcurrentLRUCache<int, std::string> small(5, 64);
+    CPPUNIT_ASSERT_EQUAL(4, small.getSegmentCount());
+
+    ConcurrentLRUCache<int, std::string> single(100, 1);
+    CPPUNIT_ASSERT_EQUAL(1, single.getSegmentCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testConstructorInvalidArgs() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        (ConcurrentLRUCache<int, int>(0)),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        (ConcurrentLRUCache<int, int>(10, 0)),
+        IllegalArgumentException);
+
+    ConcurrentLRUCache<int, int> cache(10);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        cache.setMaxCacheSize(0),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testPutGet() {
+
+    ConcurrentLRUCache<int, std::string> cache(1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        CPPUNIT_ASSERT(!cache.put(i, Integer::toString(i)));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1000, cache.size());
+
+    for (int i = 0; i < 1000; ++i) {
+        std::string value;
+        CPPUNIT_ASSERT(cache.get(i, value));
+        CPPUNIT_ASSERT_EQUAL(Integer::toString(i), value);
+        CPPUNIT_ASSERT(cache.containsKey(i));
+    }
+
+    std::string value("untouched");
+    CPPUNIT_ASSERT(!cache.get(1000, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("untouched"), value);
+
+    CPPUNIT_ASSERT(cache.put(5, "five"));
+    CPPUNIT_ASSERT(cache.get(5, value));
+    CPPUNIT_ASSERT_EQUAL(std::string("five"), value);
+    CPPUNIT_ASSERT_EQUAL(1000, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testRemove() {
+
+    ConcurrentLRUCache<int, int> cache(1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        cache.put(i, i);
+    }
+
+    for (int i = 0; i < 1000; i += 3) {
+        CPPUNIT_ASSERT(cache.remove(i));
+    }
+
+    CPPUNIT_ASSERT(!cache.remove(0));
+
+    for (int i = 0; i < 1000; ++i) {
+        int value = -1;
+        CPPUNIT_ASSERT_EQUAL(i % 3 != 0, cache.get(i, value));
+        if (i % 3 != 0) {
+            CPPUNIT_ASSERT_EQUAL(i, value);
+        }
+    }
+
+    cache.clear();
+    CPPUNIT_ASSERT(cache.isEmpty());
+    CPPUNIT_ASSERT(!cache.containsKey(1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testPutIfAbsent() {
+
+    ConcurrentLRUCache<std::string, int> cache(10);
+
+    CPPUNIT_ASSERT_EQUAL(1, cache.putIfAbsent("one", 1));
+    CPPUNIT_ASSERT_EQUAL(1, cache.putIfAbsent("one", 2));
+
+    int value = -1;
+    CPPUNIT_ASSERT(cache.get("one", value));
+    CPPUNIT_ASSERT_EQUAL(1, value);
+    CPPUNIT_ASSERT_EQUAL(1, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testEvictsUnreferenced() {
+
+    ConcurrentLRUCache<std::string, int> cache(3, 1);
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.put("c", 3);
+
+    // Gives "a" a second chance, the sweep passes over it and evicts "b".
+    int value = 0;
+    CPPUNIT_ASSERT(cache.get("a", value));
+    cache.put("d", 4);
+
+    CPPUNIT_ASSERT_EQUAL(3, cache.size());
+    CPPUNIT_ASSERT(cache.containsKey("a"));
+    CPPUNIT_ASSERT(!cache.containsKey("b"));
+    CPPUNIT_ASSERT(cache.containsKey("c"));
+    CPPUNIT_ASSERT(cache.containsKey("d"));
+
+    // The hand has used up the second chance of "a", "c" is next.
+    cache.put("e", 5);
+    CPPUNIT_ASSERT(!cache.containsKey("c"));
+    CPPUNIT_ASSERT(cache.containsKey("a"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testSizeIsBounded() {
+
+    ConcurrentLRUCache<int, int> cache(100);
+
+    for (int i = 0; i < 10000; ++i) {
+        cache.put(i, i);
+        CPPUNIT_ASSERT(cache.size() <= 100);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(100, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testSetMaxCacheSize() {
+
+    ConcurrentLRUCache<int, int> cache(10, 1);
+
+    for (int i = 0; i < 10; ++i) {
+        cache.put(i, i);
+    }
+
+    // Only the referenced entries are sure to survive shrinking.
+    int value = 0;
+    CPPUNIT_ASSERT(cache.get(7, value));
+    CPPUNIT_ASSERT(cache.get(8, value));
+
+    cache.setMaxCacheSize(4);
+    CPPUNIT_ASSERT_EQUAL(4, cache.getMaxCacheSize());
+    CPPUNIT_ASSERT_EQUAL(4, cache.size());
+    CPPUNIT_ASSERT(cache.containsKey(7));
+    CPPUNIT_ASSERT(cache.containsKey(8));
+
+    cache.setMaxCacheSize(20);
+    for (int i = 100; i < 116; ++i) {
+        cache.put(i, i);
+    }
+    CPPUNIT_ASSERT_EQUAL(20, cache.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testValues() {
+
+    ConcurrentLRUCache<int, int> cache(100);
+
+    for (int i = 0; i < 50; ++i) {
+        cache.put(i, i * 2);
+    }
+
+    std::vector<int> values = cache.values();
+    CPPUNIT_ASSERT_EQUAL((std::size_t) 50, values.size());
+
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < 50; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i * 2, values[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ConcurrentLRUCacheTest::testConcurrentPutGet() {
+
+    ConcurrentLRUCache<int, int> cache(256);
+    AtomicInteger failures;
+
+    ThreadPoolExecutor executor(8, 8, 60LL, TimeUnit::SECONDS, new LinkedBlockingQueue<Runnable*>());
+
+    for (int i = 0; i < 40; i++) {
+        executor.execute(new PutGetRunnable(&cache, &failures, i * 100));
+    }
+
+    executor.shutdown();
+    CPPUNIT_ASSERT_MESSAGE("executor terminated", executor.awaitTermination(45, TimeUnit::SECONDS));
+
+    CPPUNIT_ASSERT_EQUAL(0, failures.get());
+    CPPUNIT_ASSERT_EQUAL(256, cache.size());
+}
@@ -0,0 +1,63 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHETEST_H_
+#define _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHETEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    class ConcurrentLRUCacheTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( ConcurrentLRUCacheTest );
+        CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testConstructorInvalidArgs );
+        CPPUNIT_TEST( testPutGet );
+        CPPUNIT_TEST( testRemove );
+        CPPUNIT_TEST( testPutIfAbsent );
+        CPPUNIT_TEST( testEvictsUnreferenced );
+        CPPUNIT_TEST( testSizeIsBounded );
+        CPPUNIT_TEST( testSetMaxCacheSize );
+        CPPUNIT_TEST( testValues );
+        CPPUNIT_TEST( testConcurrentPutGet );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        ConcurrentLRUCacheTest();
+        virtual ~ConcurrentLRUCacheTest();
+
+        void testConstructor();
+        void testConstructorInvalidArgs();
+        void testPutGet();
+        void testRemove();
+        void testPutIfAbsent();
+        void testEvictsUnreferenced();
+        void testSizeIsBounded();
+        void testSetMaxCacheSize();
+        void testValues();
+        void testConcurrentPutGet();
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_CONCURRENTLRUCACHETEST_H_ */
@@ -348,3 +348,35 @@ void CountDownLatchTest::testToString() {
     std::string s2 = s.toString();
     CPPUNIT_ASSERT((int)s2.find_first_of("Count = 0") >= 0);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void CountDownLatchTest::testAwaitInterruptedOnEntry() {
+    CountDownLatch l(0);
+
+    l.await();
+    CPPUNIT_ASSERT(l.await(0));
+
+    Thread::currentThread()->interrupt();
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an InterruptedException",
+        l.await(),
+        InterruptedException);
+
+    // The failed await cleared the interrupt, the next one completes.
+    CPPUNIT_ASSERT(!Thread::interrupted());
+    l.await();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void CountDownLatchTest::testCountDownOpenLatch() {
+    CountDownLatch l(1);
+
+    l.countDown();
+    CPPUNIT_ASSERT_EQUAL(0, (int)l.getCount());
+
+    // Further count downs leave the latch open.
+    l.countDown();
+    l.countDown();
+    CPPUNIT_ASSERT_EQUAL(0, (int)l.getCount());
+    CPPUNIT_ASSERT(l.await(0));
+}
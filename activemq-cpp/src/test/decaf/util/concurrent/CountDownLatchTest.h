@@ -42,6 +42,8 @@ namespace concurrent{
         CPPUNIT_TEST( testAwaitInterruptedException );
         CPPUNIT_TEST( testTimedAwaitInterruptedException );
         CPPUNIT_TEST( testAwaitTimeout );
+        CPPUNIT_TEST( testAwaitInterruptedOnEntry );
+        CPPUNIT_TEST( testCountDownOpenLatch );
         CPPUNIT_TEST( testToString );
         CPPUNIT_TEST_SUITE_END();
 
@@ -88,6 +90,8 @@ namespace concurrent{
         void testAwaitInterruptedException();
         void testTimedAwaitInterruptedException();
         void testAwaitTimeout();
+        void testAwaitInterruptedOnEntry();
+        void testCountDownOpenLatch();
         void testToString();
 
     };
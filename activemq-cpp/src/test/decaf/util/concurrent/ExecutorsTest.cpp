@@ -138,6 +138,34 @@ void ExecutorsTest::testDefaultThreadFactory() {
     delete runner;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ExecutorsTest::testDefaultThreadFactoryStackSize() {
+
+    const long long STACK_SIZE = 256 * 1024;
+
+    CountDownLatch shutdown(1);
+    Pointer<ThreadFactory> defaultFactory(Executors::getDefaultThreadFactory(STACK_SIZE));
+    DefaultThreadFactoryRunnable* runner = new DefaultThreadFactoryRunnable(&shutdown);
+
+    Thread* theThread = defaultFactory->newThread(runner);
+
+    CPPUNIT_ASSERT(theThread != NULL);
+    CPPUNIT_ASSERT_EQUAL(STACK_SIZE, theThread->getStackSize());
+
+    theThread->start();
+
+    shutdown.countDown();
+    theThread->join();
+
+    delete theThread;
+    delete runner;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        Executors::getDefaultThreadFactory(0),
+        IllegalArgumentException);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ExecutorsTest::testNewFixedThreadPool1() {
     Pointer<ExecutorService> e(Executors::newFixedThreadPool(2));
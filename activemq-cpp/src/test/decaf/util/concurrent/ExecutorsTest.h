@@ -28,6 +28,7 @@ namespace concurrent {
 
         CPPUNIT_TEST_SUITE( ExecutorsTest );
         CPPUNIT_TEST( testDefaultThreadFactory );
+        CPPUNIT_TEST( testDefaultThreadFactoryStackSize );
         CPPUNIT_TEST( testNewFixedThreadPool1 );
         CPPUNIT_TEST( testNewFixedThreadPool2 );
         CPPUNIT_TEST( testNewFixedThreadPool3 );
@@ -50,6 +51,7 @@ namespace concurrent {
         virtual ~ExecutorsTest();
 
         void testDefaultThreadFactory();
+        void testDefaultThreadFactoryStackSize();
         void testNewFixedThreadPool1();
         void testNewFixedThreadPool2();
         void testNewFixedThreadPool3();
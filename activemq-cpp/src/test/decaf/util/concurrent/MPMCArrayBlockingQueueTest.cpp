@@ -0,0 +1,501 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "MPMCArrayBlockingQueueTest.h"
+
+#include <decaf/util/concurrent/MPMCArrayBlockingQueue.h>
+#include <decaf/util/concurrent/ThreadPoolExecutor.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/util/ArrayList.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/UnsupportedOperationException.h>
+#include <decaf/util/NoSuchElementException.h>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class DelayedOffer : public Runnable {
+    private:
+
+        MPMCArrayBlockingQueue<int>* queue;
+        int value;
+
+    private:
+
+        DelayedOffer(const DelayedOffer&);
+        DelayedOffer& operator= (const DelayedOffer&);
+
+    public:
+
+        DelayedOffer(MPMCArrayBlockingQueue<int>* queue, int value) : Runnable(), queue(queue), value(value) {}
+
+        virtual void run() {
+            Thread::sleep(100);
+            queue->offer(value);
+        }
+    };
+
+    class DelayedTake : public Runnable {
+    private:
+
+        MPMCArrayBlockingQueue<int>* queue;
+
+    private:
+
+        DelayedTake(const DelayedTake&);
+        DelayedTake& operator= (const DelayedTake&);
+
+    public:
+
+        int taken;
+
+        DelayedTake(MPMCArrayBlockingQueue<int>* queue) : Runnable(), queue(queue), taken(-1) {}
+
+        virtual void run() {
+            Thread::sleep(100);
+            taken = queue->take();
+        }
+    };
+
+    class InterruptedTake : public Runnable {
+    private:
+
+        MPMCArrayBlockingQueue<int>* queue;
+
+    private:
+
+        InterruptedTake(const InterruptedTake&);
+        InterruptedTake& operator= (const InterruptedTake&);
+
+    public:
+
+        bool interrupted;
+
+        InterruptedTake(MPMCArrayBlockingQueue<int>* queue) : Runnable(), queue(queue), interrupted(false) {}
+
+        virtual void run() {
+            try {
+                queue->take();
+            } catch (InterruptedException& ex) {
+                interrupted = true;
+            }
+        }
+    };
+
+    class Producer : public Runnable {
+    private:
+
+        MPMCArrayBlockingQueue<int>* queue;
+        int count;
+
+    private:
+
+        Producer(const Producer&);
+        Producer& operator= (const Producer&);
+
+    public:
+
+        Producer(MPMCArrayBlockingQueue<int>* queue, int count) : Runnable(), queue(queue), count(count) {}
+
+        virtual void run() {
+            for (int i = 1; i <= count; ++i) {
+                queue->put(i);
+            }
+        }
+    };
+
+    class Consumer : public Runnable {
+    private:
+
+        MPMCArrayBlockingQueue<int>* queue;
+        AtomicInteger* sum;
+        int count;
+
+    private:
+
+        Consumer(const Consumer&);
+        Consumer& operator= (const Consumer&);
+
+    public:
+
+        Consumer(MPMCArrayBlockingQueue<int>* queue, AtomicInteger* sum, int count) :
+            Runnable(), queue(queue), sum(sum), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                sum->addAndGet(queue->take());
+            }
+        }
+    };
+
+    class CountingTask : public Runnable {
+    private:
+
+        CountDownLatch* done;
+
+    private:
+
+        CountingTask(const CountingTask&);
+        CountingTask& operator= (const CountingTask&);
+
+    public:
+
+        CountingTask(CountDownLatch* done) : Runnable(), done(done) {}
+
+        virtual void run() {
+            done->countDown();
+        }
+    };
+
+    class Tracked {
+    public:
+
+        static AtomicInteger instances;
+
+        Tracked() { instances.incrementAndGet(); }
+        virtual ~Tracked() { instances.decrementAndGet(); }
+    };
+
+    AtomicInteger Tracked::instances;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MPMCArrayBlockingQueueTest::MPMCArrayBlockingQueueTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+MPMCArrayBlockingQueueTest::~MPMCArrayBlockingQueueTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testConstructor() {
+
+    MPMCArrayBlockingQueue<int> queue1(1);
+    CPPUNIT_ASSERT_EQUAL(2, queue1.getCapacity());
+
+    MPMCArrayBlockingQueue<int> queue2(100);
+    CPPUNIT_ASSERT_EQUAL(128, queue2.getCapacity());
+    CPPUNIT_ASSERT_EQUAL(128, queue2.remainingCapacity());
+    CPPUNIT_ASSERT(queue2.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0, queue2.size());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        MPMCArrayBlockingQueue<int>(0),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        MPMCArrayBlockingQueue<int>(-1),
+        IllegalArgumentException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testOfferPoll() {
+
+    MPMCArrayBlockingQueue<int> queue(4);
+
+    int value = -1;
+    CPPUNIT_ASSERT(!queue.poll(value));
+    CPPUNIT_ASSERT_EQUAL(-1, value);
+
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT(queue.offer(i));
+        CPPUNIT_ASSERT_EQUAL(i + 1, queue.size());
+    }
+
+    CPPUNIT_ASSERT(!queue.offer(4));
+    CPPUNIT_ASSERT_EQUAL(0, queue.remainingCapacity());
+
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT(queue.poll(value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+    }
+
+    CPPUNIT_ASSERT(!queue.poll(value));
+    CPPUNIT_ASSERT(queue.isEmpty());
+
+    CPPUNIT_ASSERT(queue.add(5));
+    CPPUNIT_ASSERT_EQUAL(5, queue.remove());
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NoSuchElementException",
+        queue.remove(),
+        NoSuchElementException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testWrapAround() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        CPPUNIT_ASSERT(queue.offer(i));
+        CPPUNIT_ASSERT(queue.offer(i + 1));
+        CPPUNIT_ASSERT(!queue.offer(i + 2));
+        CPPUNIT_ASSERT(queue.poll(value));
+        CPPUNIT_ASSERT_EQUAL(i, value);
+        CPPUNIT_ASSERT(queue.poll(value));
+        CPPUNIT_ASSERT_EQUAL(i + 1, value);
+    }
+
+    CPPUNIT_ASSERT(queue.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testPutTake() {
+
+    MPMCArrayBlockingQueue<int> queue(8);
+
+    for (int i = 0; i < 8; ++i) {
+        queue.put(i);
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, queue.take());
+    }
+
+    CPPUNIT_ASSERT(queue.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testTimedOffer() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+    queue.put(1);
+    queue.put(2);
+
+    long long start = System::currentTimeMillis();
+    CPPUNIT_ASSERT(!queue.offer(3, 50, TimeUnit::MILLISECONDS));
+    CPPUNIT_ASSERT(System::currentTimeMillis() - start >= 40);
+
+    CPPUNIT_ASSERT_EQUAL(1, queue.take());
+    CPPUNIT_ASSERT(queue.offer(3, 50, TimeUnit::MILLISECONDS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testTimedPoll() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+
+    int value = -1;
+    long long start = System::currentTimeMillis();
+    CPPUNIT_ASSERT(!queue.poll(value, 50, TimeUnit::MILLISECONDS));
+    CPPUNIT_ASSERT(System::currentTimeMillis() - start >= 40);
+    CPPUNIT_ASSERT(!queue.poll(value, 0, TimeUnit::MILLISECONDS));
+
+    DelayedOffer offer(&queue, 42);
+    Thread thread(&offer);
+    thread.start();
+
+    CPPUNIT_ASSERT(queue.poll(value, 5000, TimeUnit::MILLISECONDS));
+    CPPUNIT_ASSERT_EQUAL(42, value);
+    thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testBlockingTake() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+
+    DelayedOffer offer(&queue, 7);
+    Thread thread(&offer);
+    thread.start();
+
+    CPPUNIT_ASSERT_EQUAL(7, queue.take());
+    thread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testBlockingPut() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+    queue.put(1);
+    queue.put(2);
+
+    DelayedTake take(&queue);
+    Thread thread(&take);
+    thread.start();
+
+    queue.put(3);
+    thread.join();
+
+    CPPUNIT_ASSERT_EQUAL(1, take.taken);
+    CPPUNIT_ASSERT_EQUAL(2, queue.take());
+    CPPUNIT_ASSERT_EQUAL(3, queue.take());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testInterruptedTake() {
+
+    MPMCArrayBlockingQueue<int> queue(2);
+
+    InterruptedTake take(&queue);
+    Thread thread(&take);
+    thread.start();
+
+    Thread::sleep(100);
+    thread.interrupt();
+    thread.join();
+
+    CPPUNIT_ASSERT(take.interrupted);
+
+    // The queue is still usable by others.
+    queue.put(1);
+    CPPUNIT_ASSERT_EQUAL(1, queue.take());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testDrainTo() {
+
+    MPMCArrayBlockingQueue<int> queue(8);
+    for (int i = 0; i < 8; ++i) {
+        queue.put(i);
+    }
+
+    ArrayList<int> sink;
+    CPPUNIT_ASSERT_EQUAL(3, queue.drainTo(sink, 3));
+    CPPUNIT_ASSERT_EQUAL(3, sink.size());
+    CPPUNIT_ASSERT_EQUAL(0, sink.get(0));
+    CPPUNIT_ASSERT_EQUAL(2, sink.get(2));
+
+    CPPUNIT_ASSERT_EQUAL(5, queue.drainTo(sink));
+    CPPUNIT_ASSERT_EQUAL(8, sink.size());
+    CPPUNIT_ASSERT_EQUAL(7, sink.get(7));
+    CPPUNIT_ASSERT(queue.isEmpty());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        queue.drainTo(queue),
+        IllegalArgumentException);
+
+    queue.put(1);
+    queue.clear();
+    CPPUNIT_ASSERT(queue.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testUnsupportedOperations() {
+
+    MPMCArrayBlockingQueue<int> queue(4);
+    queue.put(1);
+
+    int value = 0;
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an UnsupportedOperationException",
+        queue.peek(value),
+        UnsupportedOperationException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an UnsupportedOperationException",
+        queue.iterator(),
+        UnsupportedOperationException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an UnsupportedOperationException",
+        queue.contains(1),
+        UnsupportedOperationException);
+
+    CPPUNIT_ASSERT_EQUAL(1, queue.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testReleasesTakenElements() {
+
+    MPMCArrayBlockingQueue< Pointer<Tracked> > queue(4);
+
+    queue.put(Pointer<Tracked>(new Tracked()));
+    queue.put(Pointer<Tracked>(new Tracked()));
+    CPPUNIT_ASSERT_EQUAL(2, Tracked::instances.get());
+
+    queue.take();
+    CPPUNIT_ASSERT_EQUAL(1, Tracked::instances.get());
+
+    queue.clear();
+    CPPUNIT_ASSERT_EQUAL(0, Tracked::instances.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testConcurrentPutAndTake() {
+
+    const int THREADS = 4;
+    const int COUNT = 10000;
+
+    MPMCArrayBlockingQueue<int> queue(16);
+    AtomicInteger sum;
+
+    ArrayList< Pointer<Runnable> > tasks;
+    ArrayList< Pointer<Thread> > threads;
+
+    for (int i = 0; i < THREADS; ++i) {
+        tasks.add(Pointer<Runnable>(new Producer(&queue, COUNT)));
+        tasks.add(Pointer<Runnable>(new Consumer(&queue, &sum, COUNT)));
+    }
+
+    for (int i = 0; i < tasks.size(); ++i) {
+        Pointer<Thread> thread(new Thread(tasks.get(i).get()));
+        threads.add(thread);
+        thread->start();
+    }
+
+    for (int i = 0; i < threads.size(); ++i) {
+        threads.get(i)->join();
+    }
+
+    int expected = THREADS * (COUNT * (COUNT + 1) / 2);
+    CPPUNIT_ASSERT_EQUAL(expected, sum.get());
+    CPPUNIT_ASSERT(queue.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MPMCArrayBlockingQueueTest::testThreadPoolExecutor() {
+
+    const int TASKS = 200;
+
+    CountDownLatch done(TASKS);
+    ThreadPoolExecutor executor(4, 4, 60LL, TimeUnit::SECONDS,
+                                new MPMCArrayBlockingQueue<Runnable*>(TASKS));
+
+    for (int i = 0; i < TASKS; ++i) {
+        executor.execute(new CountingTask(&done));
+    }
+
+    CPPUNIT_ASSERT(done.await(10000));
+
+    // Removing a given task isn't supported by the queue so it is never found.
+    CountingTask task(&done);
+    CPPUNIT_ASSERT(!executor.remove(&task));
+    executor.purge();
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+}
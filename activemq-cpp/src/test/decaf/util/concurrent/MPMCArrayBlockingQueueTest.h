@@ -0,0 +1,72 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUETEST_H_
+#define _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUETEST_H_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace decaf {
+namespace util {
+namespace concurrent {
+
+    class MPMCArrayBlockingQueueTest : public CppUnit::TestFixture {
+
+        CPPUNIT_TEST_SUITE( MPMCArrayBlockingQueueTest );
+        CPPUNIT_TEST( testConstructor );
+        CPPUNIT_TEST( testOfferPoll );
+        CPPUNIT_TEST( testWrapAround );
+        CPPUNIT_TEST( testPutTake );
+        CPPUNIT_TEST( testTimedOffer );
+        CPPUNIT_TEST( testTimedPoll );
+        CPPUNIT_TEST( testBlockingTake );
+        CPPUNIT_TEST( testBlockingPut );
+        CPPUNIT_TEST( testInterruptedTake );
+        CPPUNIT_TEST( testDrainTo );
+        CPPUNIT_TEST( testUnsupportedOperations );
+        CPPUNIT_TEST( testReleasesTakenElements );
+        CPPUNIT_TEST( testConcurrentPutAndTake );
+        CPPUNIT_TEST( testThreadPoolExecutor );
+        CPPUNIT_TEST_SUITE_END();
+
+    public:
+
+        MPMCArrayBlockingQueueTest();
+        virtual ~MPMCArrayBlockingQueueTest();
+
+        void testConstructor();
+        void testOfferPoll();
+        void testWrapAround();
+        void testPutTake();
+        void testTimedOffer();
+        void testTimedPoll();
+        void testBlockingTake();
+        void testBlockingPut();
+        void testInterruptedTake();
+        void testDrainTo();
+        void testUnsupportedOperations();
+        void testReleasesTakenElements();
+        void testConcurrentPutAndTake();
+        void testThreadPoolExecutor();
+
+    };
+
+}}}
+
+#endif /* _DECAF_UTIL_CONCURRENT_MPMCARRAYBLOCKINGQUEUETEST_H_ */
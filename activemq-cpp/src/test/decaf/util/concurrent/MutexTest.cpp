@@ -24,6 +24,12 @@
 #include <decaf/util/Random.h>
 
 #include <decaf/internal/util/concurrent/SynchronizableImpl.h>
+#include <decaf/internal/util/concurrent/Threading.h>
+#include <decaf/lang/System.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+
+#include <list>
+#include <vector>
 
 #include <time.h>
 
@@ -784,3 +790,160 @@ void MutexTest::testStressMutex(){
 
     CPPUNIT_ASSERT( true );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class SpinCountRestorer {
+    private:
+
+        int previous;
+
+    public:
+
+        SpinCountRestorer(int spinCount) : previous(Threading::getMonitorSpinCount()) {
+            Threading::setMonitorSpinCount(spinCount);
+        }
+
+        ~SpinCountRestorer() {
+            Threading::setMonitorSpinCount(previous);
+        }
+    };
+
+    class CountingRunnable : public Runnable {
+    private:
+
+        Mutex* mutex;
+        int* counter;
+        int iterations;
+
+    private:
+
+        CountingRunnable(const CountingRunnable&);
+        CountingRunnable& operator= (const CountingRunnable&);
+
+    public:
+
+        CountingRunnable(Mutex* mutex, int* counter, int iterations) :
+            Runnable(), mutex(mutex), counter(counter), iterations(iterations) {}
+
+        virtual ~CountingRunnable() {}
+
+        virtual void run() {
+            for (int i = 0; i < iterations; ++i) {
+                synchronized(mutex) {
+                    (*counter)++;
+                }
+            }
+        }
+    };
+
+    class HandoffConsumer : public Runnable {
+    private:
+
+        Mutex* mutex;
+        std::list<int>* queue;
+        int expected;
+
+    private:
+
+        HandoffConsumer(const HandoffConsumer&);
+        HandoffConsumer& operator= (const HandoffConsumer&);
+
+    public:
+
+        int received;
+        bool inOrder;
+
+        HandoffConsumer(Mutex* mutex, std::list<int>* queue, int expected) :
+            Runnable(), mutex(mutex), queue(queue), expected(expected), received(0), inOrder(true) {}
+
+        virtual ~HandoffConsumer() {}
+
+        virtual void run() {
+            while (received < expected) {
+                synchronized(mutex) {
+                    while (queue->empty()) {
+                        mutex->wait();
+                    }
+                    if (queue->front() != received) {
+                        inOrder = false;
+                    }
+                    queue->pop_front();
+                    received++;
+                }
+            }
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MutexTest::testSpinningMutex() {
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should throw an IllegalArgumentException",
+        Threading::setMonitorSpinCount(-1),
+        IllegalArgumentException);
+
+    SpinCountRestorer restorer(100);
+
+    if (System::availableProcessors() > 1) {
+        CPPUNIT_ASSERT_EQUAL(100, Threading::getMonitorSpinCount());
+    } else {
+        CPPUNIT_ASSERT_EQUAL(0, Threading::getMonitorSpinCount());
+    }
+
+    static const int THREADS = 4;
+    static const int ITERATIONS = 20000;
+
+    Mutex mutex;
+    int counter = 0;
+
+    CountingRunnable task(&mutex, &counter, ITERATIONS);
+    std::vector<Thread*> threads;
+    for (int i = 0; i < THREADS; ++i) {
+        threads.push_back(new Thread(&task));
+        threads.back()->start();
+    }
+
+    for (int i = 0; i < THREADS; ++i) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    CPPUNIT_ASSERT_EQUAL(THREADS * ITERATIONS, counter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MutexTest::testSpinningHandoff() {
+
+    SpinCountRestorer restorer(100);
+
+    static const int COUNT = 20000;
+
+    Mutex mutex;
+    std::list<int> queue;
+
+    HandoffConsumer consumer(&mutex, &queue, COUNT);
+    Thread thread(&consumer);
+    thread.start();
+
+    for (int i = 0; i < COUNT; ++i) {
+        synchronized(&mutex) {
+            queue.push_back(i);
+            mutex.notify();
+        }
+    }
+
+    thread.join(30000);
+
+    CPPUNIT_ASSERT(!thread.isAlive());
+    CPPUNIT_ASSERT_EQUAL(COUNT, consumer.received);
+    CPPUNIT_ASSERT(consumer.inOrder);
+
+    // Notifying with nobody waiting is a no-op.
+    synchronized(&mutex) {
+        mutex.notify();
+        mutex.notifyAll();
+    }
+}
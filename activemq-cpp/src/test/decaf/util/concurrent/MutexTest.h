@@ -37,6 +37,8 @@ namespace concurrent{
         CPPUNIT_TEST( testRecursiveLock );
         CPPUNIT_TEST( testDoubleLock );
         CPPUNIT_TEST( testStressMutex );
+        CPPUNIT_TEST( testSpinningMutex );
+        CPPUNIT_TEST( testSpinningHandoff );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -54,6 +56,8 @@ namespace concurrent{
         void testRecursiveLock();
         void testDoubleLock();
         void testStressMutex();
+        void testSpinningMutex();
+        void testSpinningHandoff();
 
     };
 
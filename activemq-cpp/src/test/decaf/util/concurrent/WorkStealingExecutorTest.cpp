@@ -0,0 +1,494 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "WorkStealingExecutorTest.h"
+
+#include <decaf/util/concurrent/WorkStealingExecutor.h>
+#include <decaf/util/concurrent/Executors.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/concurrent/Callable.h>
+#include <decaf/util/concurrent/Future.h>
+#include <decaf/util/concurrent/Mutex.h>
+#include <decaf/util/concurrent/RejectedExecutionException.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Runnable.h>
+#include <decaf/lang/Pointer.h>
+#include <decaf/lang/exceptions/InterruptedException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::concurrent::atomic;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class CountingTask : public Runnable {
+    private:
+
+        CountDownLatch* done;
+
+    private:
+
+        CountingTask(const CountingTask&);
+        CountingTask& operator= (const CountingTask&);
+
+    public:
+
+        static AtomicInteger instances;
+
+        CountingTask(CountDownLatch* done) : Runnable(), done(done) {
+            instances.incrementAndGet();
+        }
+
+        virtual ~CountingTask() {
+            instances.decrementAndGet();
+        }
+
+        virtual void run() {
+            done->countDown();
+        }
+    };
+
+    AtomicInteger CountingTask::instances;
+
+    class SleepingTask : public Runnable {
+    private:
+
+        CountDownLatch* done;
+
+    private:
+
+        SleepingTask(const SleepingTask&);
+        SleepingTask& operator= (const SleepingTask&);
+
+    public:
+
+        SleepingTask(CountDownLatch* done) : Runnable(), done(done) {}
+
+        virtual void run() {
+            Thread::sleep(5);
+            done->countDown();
+        }
+    };
+
+    class SpawningTask : public Runnable {
+    private:
+
+        Executor* executor;
+        CountDownLatch* done;
+        int count;
+
+    private:
+
+        SpawningTask(const SpawningTask&);
+        SpawningTask& operator= (const SpawningTask&);
+
+    public:
+
+        SpawningTask(Executor* executor, CountDownLatch* done, int count) :
+            Runnable(), executor(executor), done(done), count(count) {}
+
+        virtual void run() {
+            for (int i = 0; i < count; ++i) {
+                executor->execute(new SleepingTask(done));
+            }
+        }
+    };
+
+    class SplittingTask : public Runnable {
+    private:
+
+        Executor* executor;
+        AtomicInteger* sum;
+        CountDownLatch* done;
+        int low;
+        int high;
+
+    private:
+
+        SplittingTask(const SplittingTask&);
+        SplittingTask& operator= (const SplittingTask&);
+
+    public:
+
+        SplittingTask(Executor* executor, AtomicInteger* sum, CountDownLatch* done, int low, int high) :
+            Runnable(), executor(executor), sum(sum), done(done), low(low), high(high) {}
+
+        virtual void run() {
+            if (high - low <= 8) {
+                for (int i = low; i < high; ++i) {
+                    sum->addAndGet(i);
+                    done->countDown();
+                }
+            } else {
+                int middle = low + (high - low) / 2;
+                executor->execute(new SplittingTask(executor, sum, done, low, middle));
+                executor->execute(new SplittingTask(executor, sum, done, middle, high));
+            }
+        }
+    };
+
+    class RecordingTask : public Runnable {
+    private:
+
+        Mutex* mutex;
+        std::vector<int>* order;
+        int value;
+
+    private:
+
+        RecordingTask(const RecordingTask&);
+        RecordingTask& operator= (const RecordingTask&);
+
+    public:
+
+        RecordingTask(Mutex* mutex, std::vector<int>* order, int value) :
+            Runnable(), mutex(mutex), order(order), value(value) {}
+
+        virtual void run() {
+            synchronized(mutex) {
+                order->push_back(value);
+            }
+        }
+    };
+
+    class OrderingTask : public Runnable {
+    private:
+
+        Executor* executor;
+        Mutex* mutex;
+        std::vector<int>* order;
+        CountDownLatch* done;
+
+    private:
+
+        OrderingTask(const OrderingTask&);
+        OrderingTask& operator= (const OrderingTask&);
+
+    public:
+
+        OrderingTask(Executor* executor, Mutex* mutex, std::vector<int>* order, CountDownLatch* done) :
+            Runnable(), executor(executor), mutex(mutex), order(order), done(done) {}
+
+        virtual void run() {
+            for (int i = 0; i < 10; ++i) {
+                executor->execute(new RecordingTask(mutex, order, i));
+            }
+            executor->execute(new CountingTask(done));
+        }
+    };
+
+    class BlockingTask : public Runnable {
+    private:
+
+        CountDownLatch* started;
+        CountDownLatch* release;
+
+    private:
+
+        BlockingTask(const BlockingTask&);
+        BlockingTask& operator= (const BlockingTask&);
+
+    public:
+
+        bool interrupted;
+
+        BlockingTask(CountDownLatch* started, CountDownLatch* release) :
+            Runnable(), started(started), release(release), interrupted(false) {}
+
+        virtual void run() {
+            started->countDown();
+            try {
+                release->await();
+            } catch (InterruptedException& ex) {
+                interrupted = true;
+            }
+        }
+    };
+
+    class ValueCallable : public Callable<int> {
+    public:
+
+        virtual int call() {
+            return 42;
+        }
+    };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutorTest::WorkStealingExecutorTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WorkStealingExecutorTest::~WorkStealingExecutorTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testConstructor() {
+
+    WorkStealingExecutor executor(3);
+    CPPUNIT_ASSERT_EQUAL(3, executor.getParallelism());
+    CPPUNIT_ASSERT(!executor.getAsyncMode());
+    CPPUNIT_ASSERT(!executor.isShutdown());
+    CPPUNIT_ASSERT(!executor.isTerminated());
+    CPPUNIT_ASSERT_EQUAL(0LL, executor.getQueuedTaskCount());
+
+    WorkStealingExecutor defaults;
+    CPPUNIT_ASSERT(defaults.getParallelism() >= 1);
+
+    WorkStealingExecutor async(2, Executors::getDefaultThreadFactory(), true);
+    CPPUNIT_ASSERT(async.getAsyncMode());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        WorkStealingExecutor(0),
+        IllegalArgumentException);
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a NullPointerException",
+        WorkStealingExecutor(2, NULL),
+        NullPointerException);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testExecute() {
+
+    const int TASKS = 500;
+
+    CountDownLatch done(TASKS);
+
+    {
+        WorkStealingExecutor executor(4);
+        for (int i = 0; i < TASKS; ++i) {
+            executor.execute(new CountingTask(&done));
+        }
+
+        CPPUNIT_ASSERT(done.await(10000));
+
+        executor.shutdown();
+        CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+        CPPUNIT_ASSERT_EQUAL((long long) TASKS, executor.getCompletedTaskCount());
+
+        CPPUNIT_ASSERT_THROW_MESSAGE(
+            "Should Throw a NullPointerException",
+            executor.execute(NULL),
+            NullPointerException);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(0, CountingTask::instances.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testSubmit() {
+
+    WorkStealingExecutor executor(2);
+
+    Pointer< Future<int> > future(executor.submit(new ValueCallable()));
+    CPPUNIT_ASSERT_EQUAL(42, future->get());
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testUnownedTask() {
+
+    CountDownLatch done(1);
+    CountingTask task(&done);
+
+    {
+        WorkStealingExecutor executor(2);
+        executor.execute(&task, false);
+        CPPUNIT_ASSERT(done.await(10000));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(1, CountingTask::instances.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testNestedTasksAreStolen() {
+
+    const int TASKS = 200;
+
+    CountDownLatch done(TASKS);
+    WorkStealingExecutor executor(4);
+
+    // All the subtasks are queued on the worker that runs the spawning task, the
+    // other workers can only get to them by stealing.
+    executor.execute(new SpawningTask(&executor, &done, TASKS));
+
+    CPPUNIT_ASSERT(done.await(30000));
+    CPPUNIT_ASSERT(executor.getStealCount() > 0);
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testRecursiveTasks() {
+
+    const int COUNT = 4096;
+
+    AtomicInteger sum;
+    CountDownLatch done(COUNT);
+    WorkStealingExecutor executor(4);
+
+    executor.execute(new SplittingTask(&executor, &sum, &done, 0, COUNT));
+
+    CPPUNIT_ASSERT(done.await(30000));
+    CPPUNIT_ASSERT_EQUAL(COUNT * (COUNT - 1) / 2, sum.get());
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testLocalTaskOrder() {
+
+    Mutex mutex;
+    std::vector<int> order;
+    CountDownLatch done(1);
+
+    WorkStealingExecutor executor(1);
+    executor.execute(new OrderingTask(&executor, &mutex, &order, &done));
+    CPPUNIT_ASSERT(done.await(10000));
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+
+    // A single worker runs the work it queued itself newest first, the latch task
+    // was queued last so it ran before any of the recording tasks.
+    CPPUNIT_ASSERT_EQUAL(10, (int) order.size());
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(9 - i, order[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testAsyncModeLocalTaskOrder() {
+
+    Mutex mutex;
+    std::vector<int> order;
+    CountDownLatch done(1);
+
+    WorkStealingExecutor executor(1, Executors::getDefaultThreadFactory(), true);
+    executor.execute(new OrderingTask(&executor, &mutex, &order, &done));
+    CPPUNIT_ASSERT(done.await(10000));
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+
+    CPPUNIT_ASSERT_EQUAL(10, (int) order.size());
+    for (int i = 0; i < 10; ++i) {
+        CPPUNIT_ASSERT_EQUAL(i, order[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testShutdown() {
+
+    const int TASKS = 50;
+
+    CountDownLatch done(TASKS);
+    WorkStealingExecutor executor(2);
+
+    for (int i = 0; i < TASKS; ++i) {
+        executor.execute(new SleepingTask(&done));
+    }
+
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.isShutdown());
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw a RejectedExecutionException",
+        executor.execute(new CountingTask(&done)),
+        RejectedExecutionException);
+    CPPUNIT_ASSERT_EQUAL(0, CountingTask::instances.get());
+
+    // Work queued before the shutdown still runs.
+    CPPUNIT_ASSERT(executor.awaitTermination(30, TimeUnit::SECONDS));
+    CPPUNIT_ASSERT(executor.isTerminated());
+    CPPUNIT_ASSERT_EQUAL(0, done.getCount());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testShutdownUnused() {
+
+    WorkStealingExecutor executor(2);
+    executor.shutdown();
+    CPPUNIT_ASSERT(executor.awaitTermination(0, TimeUnit::MILLISECONDS));
+    CPPUNIT_ASSERT(executor.isTerminated());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testShutdownNow() {
+
+    CountDownLatch started(1);
+    CountDownLatch release(1);
+    CountDownLatch done(5);
+
+    BlockingTask blocker(&started, &release);
+    WorkStealingExecutor executor(1);
+
+    executor.execute(&blocker, false);
+    CPPUNIT_ASSERT(started.await(10000));
+
+    for (int i = 0; i < 5; ++i) {
+        executor.execute(new CountingTask(&done));
+    }
+
+    ArrayList<Runnable*> unexecuted = executor.shutdownNow();
+    CPPUNIT_ASSERT_EQUAL(5, unexecuted.size());
+    for (int i = 0; i < unexecuted.size(); ++i) {
+        delete unexecuted.get(i);
+    }
+
+    CPPUNIT_ASSERT(executor.awaitTermination(10, TimeUnit::SECONDS));
+    CPPUNIT_ASSERT(blocker.interrupted);
+    CPPUNIT_ASSERT_EQUAL(5, done.getCount());
+    CPPUNIT_ASSERT_EQUAL(0, CountingTask::instances.get());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void WorkStealingExecutorTest::testNewWorkStealingPool() {
+
+    CountDownLatch done(10);
+
+    Pointer<ExecutorService> executor(Executors::newWorkStealingPool(2));
+    for (int i = 0; i < 10; ++i) {
+        executor->execute(new CountingTask(&done));
+    }
+
+    CPPUNIT_ASSERT(done.await(10000));
+    executor->shutdown();
+    CPPUNIT_ASSERT(executor->awaitTermination(10, TimeUnit::SECONDS));
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should Throw an IllegalArgumentException",
+        Pointer<ExecutorService>(Executors::newWorkStealingPool(0)),
+        IllegalArgumentException);
+}
@@ -49,6 +49,16 @@ void AtomicIntegerTest::testGetSet() {
     CPPUNIT_ASSERT( 6 == ai.get() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicIntegerTest::testLazySet() {
+    AtomicInteger ai( 1 );
+    CPPUNIT_ASSERT( 1 == ai.get() );
+    ai.lazySet( 2 );
+    CPPUNIT_ASSERT( 2 == ai.get() );
+    ai.lazySet( -3 );
+    CPPUNIT_ASSERT( -3 == ai.get() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicIntegerTest::testCompareAndSet() {
     AtomicInteger ai( 25 );
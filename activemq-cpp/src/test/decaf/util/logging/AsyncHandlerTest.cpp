@@ -0,0 +1,261 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncHandlerTest.h"
+
+#include <decaf/util/logging/AsyncHandler.h>
+#include <decaf/util/logging/Formatter.h>
+#include <decaf/util/logging/LogRecord.h>
+#include <decaf/util/logging/Level.h>
+#include <decaf/io/ByteArrayOutputStream.h>
+#include <decaf/lang/Thread.h>
+#include <decaf/lang/Integer.h>
+#include <decaf/lang/exceptions/NullPointerException.h>
+#include <decaf/lang/exceptions/IllegalArgumentException.h>
+#include <decaf/util/concurrent/CountDownLatch.h>
+#include <decaf/util/StringTokenizer.h>
+
+#include <vector>
+
+using namespace std;
+using namespace decaf;
+using namespace decaf::io;
+using namespace decaf::lang;
+using namespace decaf::lang::exceptions;
+using namespace decaf::util;
+using namespace decaf::util::concurrent;
+using namespace decaf::util::logging;
+
+////////////////////////////////////////////////////////////////////////////////
+namespace {
+
+    class LineFormatter : public Formatter {
+    public:
+
+        virtual std::string format( const LogRecord& record ) const {
+            return record.getMessage() + "\n";
+        }
+
+        virtual std::string getTail( const Handler* handler DECAF_UNUSED ) {
+            return "END\n";
+        }
+    };
+
+    class GatedOutputStream : public ByteArrayOutputStream {
+    public:
+
+        CountDownLatch entered;
+        CountDownLatch released;
+        bool closed;
+
+        GatedOutputStream() : ByteArrayOutputStream(), entered( 1 ), released( 1 ), closed( false ) {}
+
+        virtual ~GatedOutputStream() {}
+
+        virtual void close() {
+            this->closed = true;
+        }
+
+    protected:
+
+        virtual void doWriteArrayBounded( const unsigned char* buffer, int size, int offset, int length ) {
+            entered.countDown();
+            released.await();
+            ByteArrayOutputStream::doWriteArrayBounded( buffer, size, offset, length );
+        }
+    };
+
+    class Publisher : public Runnable {
+    private:
+
+        Handler* handler;
+        std::string prefix;
+        int count;
+
+    public:
+
+        Publisher( Handler* handler, const std::string& prefix, int count ) :
+            handler( handler ), prefix( prefix ), count( count ) {}
+
+        virtual ~Publisher() {}
+
+        virtual void run() {
+            for( int i = 0; i < count; ++i ) {
+                LogRecord record;
+                record.setLevel( Level::INFO );
+                record.setMessage( prefix + Integer::toString( i ) );
+                handler->publish( record );
+            }
+        }
+    };
+
+    void publish( Handler& handler, const std::string& message ) {
+        LogRecord record;
+        record.setLevel( Level::INFO );
+        record.setMessage( message );
+        handler.publish( record );
+    }
+
+    int countLines( const std::string& value ) {
+        StringTokenizer tokenizer( value, "\n" );
+        return tokenizer.countTokens();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AsyncHandlerTest::AsyncHandlerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AsyncHandlerTest::~AsyncHandlerTest() {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandlerTest::testConstructor() {
+
+    ByteArrayOutputStream stream;
+    LineFormatter formatter;
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        AsyncHandler( NULL, &formatter ),
+        NullPointerException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a NullPointerException",
+        AsyncHandler( &stream, NULL ),
+        NullPointerException );
+
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "Should have thrown a IllegalArgumentException",
+        AsyncHandler( &stream, &formatter, 0 ),
+        IllegalArgumentException );
+
+    AsyncHandler handler( &stream, &formatter, 100 );
+    CPPUNIT_ASSERT_EQUAL( 128, handler.getCapacity() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, handler.getDroppedCount() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandlerTest::testPublishAndFlush() {
+
+    ByteArrayOutputStream stream;
+    LineFormatter formatter;
+    AsyncHandler handler( &stream, &formatter );
+
+    std::string expected;
+    for( int i = 0; i < 500; ++i ) {
+        std::string message = std::string( "record-" ) + Integer::toString( i );
+        publish( handler, message );
+        expected += message + "\n";
+    }
+
+    handler.flush();
+
+    CPPUNIT_ASSERT_EQUAL( expected, stream.toString() );
+    CPPUNIT_ASSERT_EQUAL( 0LL, handler.getDroppedCount() );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandlerTest::testDropsWhenFull() {
+
+    GatedOutputStream stream;
+    LineFormatter formatter;
+    AsyncHandler handler( &stream, &formatter, 4 );
+
+    // The writer takes the first record and then blocks in the stream.
+    publish( handler, "first" );
+    CPPUNIT_ASSERT( stream.entered.await( 5000 ) );
+
+    for( int i = 0; i < 10; ++i ) {
+        publish( handler, "queued" );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 6LL, handler.getDroppedCount() );
+
+    stream.released.countDown();
+    handler.flush();
+
+    CPPUNIT_ASSERT_EQUAL( 5, countLines( stream.toString() ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandlerTest::testConcurrentPublishers() {
+
+    static const int PUBLISHERS = 4;
+    static const int RECORDS = 1000;
+
+    ByteArrayOutputStream stream;
+    LineFormatter formatter;
+    AsyncHandler handler( &stream, &formatter, PUBLISHERS * RECORDS );
+
+    std::vector<Publisher*> publishers;
+    std::vector<Thread*> threads;
+
+    for( int i = 0; i < PUBLISHERS; ++i ) {
+        publishers.push_back( new Publisher( &handler, std::string( "p" ) + Integer::toString( i ) + "-", RECORDS ) );
+        threads.push_back( new Thread( publishers.back() ) );
+        threads.back()->start();
+    }
+
+    for( int i = 0; i < PUBLISHERS; ++i ) {
+        threads[i]->join();
+        delete threads[i];
+        delete publishers[i];
+    }
+
+    handler.flush();
+
+    CPPUNIT_ASSERT_EQUAL( 0LL, handler.getDroppedCount() );
+
+    std::string output = stream.toString();
+    CPPUNIT_ASSERT_EQUAL( PUBLISHERS * RECORDS, countLines( output ) );
+
+    for( int i = 0; i < PUBLISHERS; ++i ) {
+        std::string prefix = std::string( "p" ) + Integer::toString( i ) + "-";
+        CPPUNIT_ASSERT( output.find( prefix + "0\n" ) != std::string::npos );
+        CPPUNIT_ASSERT( output.find( prefix + Integer::toString( RECORDS - 1 ) + "\n" ) != std::string::npos );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AsyncHandlerTest::testClose() {
+
+    GatedOutputStream stream;
+    stream.released.countDown();
+
+    LineFormatter formatter;
+    AsyncHandler handler( &stream, &formatter );
+
+    publish( handler, "one" );
+    publish( handler, "two" );
+
+    handler.close();
+
+    CPPUNIT_ASSERT( stream.closed );
+    CPPUNIT_ASSERT_EQUAL( std::string( "one\ntwo\nEND\n" ), stream.toString() );
+
+    LogRecord record;
+    record.setLevel( Level::INFO );
+    CPPUNIT_ASSERT( !handler.isLoggable( record ) );
+
+    publish( handler, "three" );
+    handler.flush();
+    handler.close();
+
+    CPPUNIT_ASSERT_EQUAL( std::string( "one\ntwo\nEND\n" ), stream.toString() );
+}
@@ -175,3 +175,35 @@ void CRC32Test::testUpdateArrayIndexed() {
         crc.update( byteArray, SIZE, offError, len ),
         IndexOutOfBoundsException );
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void CRC32Test::testUpdateInPieces() {
+
+    // The standard check value of the CRC-32 is the CRC of "123456789".
+    const unsigned char check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    CRC32 crc;
+    crc.update( check, 9, 0, 9 );
+    CPPUNIT_ASSERT_EQUAL( 0xCBF43926LL, crc.getValue() );
+
+    std::vector<unsigned char> buffer( 100 );
+    for( std::size_t i = 0; i < buffer.size(); ++i ) {
+        buffer[i] = (unsigned char)( i * 37 + 11 );
+    }
+
+    CRC32 whole;
+    whole.update( buffer );
+
+    // Bytes are taken eight at a time, splitting anywhere must give the same value.
+    for( int split = 0; split <= 100; ++split ) {
+        crc.reset();
+        crc.update( buffer, 0, split );
+        crc.update( buffer, split, 100 - split );
+        CPPUNIT_ASSERT_EQUAL( whole.getValue(), crc.getValue() );
+    }
+
+    crc.reset();
+    for( std::size_t i = 0; i < buffer.size(); ++i ) {
+        crc.update( buffer[i] );
+    }
+    CPPUNIT_ASSERT_EQUAL( whole.getValue(), crc.getValue() );
+}
@@ -34,6 +34,7 @@ namespace zip {
         CPPUNIT_TEST( testUpdateI );
         CPPUNIT_TEST( testUpdateArray );
         CPPUNIT_TEST( testUpdateArrayIndexed );
+        CPPUNIT_TEST( testUpdateInPieces );
         CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -47,6 +48,7 @@ namespace zip {
         void testUpdateI();
         void testUpdateArray();
         void testUpdateArrayIndexed();
+        void testUpdateInPieces();
 
     };
 
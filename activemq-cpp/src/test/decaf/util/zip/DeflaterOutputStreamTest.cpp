@@ -316,3 +316,43 @@ void DeflaterOutputStreamTest::testDeflate() {
     CPPUNIT_ASSERT( dos.getDaflateFlag() );
     dos.close();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void DeflaterOutputStreamTest::testSyncFlush() {
+
+    std::string message = "ID:client-host-41234-1428571600000-1:1:1:1 queue://TEST.QUEUE persistent";
+
+    ByteArrayOutputStream baos;
+    DeflaterOutputStream dos( &baos, new Deflater(), 512, false, true, true );
+    Inflater inflater;
+    std::vector<unsigned char> result( 1024 );
+
+    // Each flush makes everything written so far inflatable without finishing the stream.
+    int lengths[2];
+    int consumed = 0;
+    for( int i = 0; i < 2; i++ ) {
+
+        dos.write( (const unsigned char*)message.c_str(), (int)message.length() );
+        dos.flush();
+
+        std::pair<unsigned char*, int> array = baos.toByteArray();
+        lengths[i] = array.second - consumed;
+        inflater.setInput( array.first, array.second, consumed, lengths[i] );
+        int inflated = inflater.inflate( &result[0], (int)result.size(), 0, (int)result.size() );
+        consumed = array.second;
+        delete [] array.first;
+
+        CPPUNIT_ASSERT_EQUAL( (int)message.length(), inflated );
+        CPPUNIT_ASSERT_EQUAL( message, std::string( (const char*)&result[0], inflated ) );
+        CPPUNIT_ASSERT( !inflater.finished() );
+    }
+
+    // The second copy is compressed against the first one.
+    CPPUNIT_ASSERT( lengths[1] < lengths[0] / 2 );
+
+    // Nothing new to flush, nothing written.
+    dos.flush();
+    CPPUNIT_ASSERT_EQUAL( consumed, (int)baos.size() );
+
+    dos.close();
+}
@@ -38,6 +38,7 @@ namespace zip {
         CPPUNIT_TEST( testDeflate );
         CPPUNIT_TEST( testWriteI );
         CPPUNIT_TEST( testWriteBIII );
+        CPPUNIT_TEST( testSyncFlush );
         CPPUNIT_TEST_SUITE_END();
 
     private:
@@ -60,6 +61,7 @@ namespace zip {
         void testDeflate();
         void testWriteI();
         void testWriteBIII();
+        void testSyncFlush();
 
     };
 
@@ -19,20 +19,46 @@
 // enable them easily in one place.
 
 
+#include <activemq/commands/IdSupportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::commands::IdSupportTest );
 #include <activemq/transport/failover/FailoverTransportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::failover::FailoverTransportTest );
+#include <activemq/transport/failover/OutboxTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::failover::OutboxTest );
+#include <activemq/transport/failover/URIPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::failover::URIPoolTest );
 
+#include <activemq/transport/striped/StripedTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::striped::StripedTransportTest );
+
+#include <activemq/transport/tcp/SslHandshakeLimiterTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::tcp::SslHandshakeLimiterTest );
+#include <activemq/transport/tcp/TcpEventLoopTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::tcp::TcpEventLoopTest );
 #include <activemq/transport/tcp/TcpTransportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::tcp::TcpTransportTest );
 
+#include <activemq/transport/chunking/ChunkingTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::chunking::ChunkingTransportTest );
+
 #include <activemq/transport/correlator/ResponseCorrelatorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::correlator::ResponseCorrelatorTest );
 
 #include <activemq/transport/mock/MockTransportFactoryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::mock::MockTransportFactoryTest );
 
+#include <activemq/transport/loopback/LoopbackTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::loopback::LoopbackTransportTest );
+
 #include <activemq/transport/inactivity/InactivityMonitorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::inactivity::InactivityMonitorTest );
+#include <activemq/transport/inactivity/KeepAliveServiceTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::inactivity::KeepAliveServiceTest );
+#include <activemq/transport/lanes/PriorityLaneTransportTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::lanes::PriorityLaneTransportTest );
+
+#include <activemq/transport/logging/FrameCaptureFileTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::logging::FrameCaptureFileTest );
 
 #include <activemq/transport/TransportRegistryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::transport::TransportRegistryTest );
@@ -46,6 +72,12 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::exceptions::ActiveMQExceptionTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::AdvisorySupportTest );
 #include <activemq/util/ActiveMQMessageTransformationTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::ActiveMQMessageTransformationTest );
+#include <activemq/util/CompressionCodecTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::CompressionCodecTest );
+#include <activemq/util/CompressionPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::CompressionPoolTest );
+#include <activemq/util/CopyOnWriteBytesTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::CopyOnWriteBytesTest );
 #include <activemq/util/IdGeneratorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::IdGeneratorTest );
 #include <activemq/util/LongSequenceGeneratorTest.h>
@@ -64,22 +96,60 @@ CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::URISupportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MemoryUsageTest );
 #include <activemq/util/MarshallingSupportTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MarshallingSupportTest );
+#include <activemq/util/LatencyHistogramTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::LatencyHistogramTest );
+#include <activemq/util/MessageSelectorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::MessageSelectorTest );
+#include <activemq/util/StripedCounterTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::util::StripedCounterTest );
+
+#include <activemq/core/ConflatingMessageDispatchChannelTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::ConflatingMessageDispatchChannelTest );
+#include <activemq/core/OrderedCompletionTrackerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::OrderedCompletionTrackerTest );
+#include <activemq/core/PrefetchTunerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::PrefetchTunerTest );
+#include <activemq/core/RedeliverySchedulerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::core::RedeliverySchedulerTest );
+
+#include <activemq/cmsutil/MessageSelectorRouterTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::MessageSelectorRouterTest );
+#include <activemq/cmsutil/MessageStreamTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::MessageStreamTest );
+#include <activemq/cmsutil/RequestorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::cmsutil::RequestorTest );
 
 #include <activemq/threads/SchedulerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::SchedulerTest );
 #include <activemq/threads/DedicatedTaskRunnerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::DedicatedTaskRunnerTest );
+#include <activemq/threads/TaskRunnerPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::TaskRunnerPoolTest );
+#include <activemq/threads/ThreadPlacementTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::ThreadPlacementTest );
+#include <activemq/threads/TimingWheelTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::TimingWheelTest );
 #include <activemq/threads/CompositeTaskRunnerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::CompositeTaskRunnerTest );
+#include <activemq/threads/KeyedSerialExecutorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::threads::KeyedSerialExecutorTest );
 
 #include <activemq/wireformat/WireFormatRegistryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::WireFormatRegistryTest );
 
+#include <decaf/internal/io/BufferPoolTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::io::BufferPoolTest );
+#include <decaf/internal/util/concurrent/LockProfilerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::concurrent::LockProfilerTest );
+#include <decaf/internal/util/concurrent/SharedMutexTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::concurrent::SharedMutexTest );
 #include <decaf/internal/util/ByteArrayAdapterTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::ByteArrayAdapterTest );
 #include <decaf/internal/util/TimerTaskHeapTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::util::TimerTaskHeapTest );
 
+#include <decaf/internal/net/local/UnixSocketTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::local::UnixSocketTest );
 #include <decaf/internal/net/ssl/DefaultSSLSocketFactoryTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::ssl::DefaultSSLSocketFactoryTest );
 
@@ -100,10 +170,14 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::nio::IntArrayBufferTest );
 #include <decaf/internal/nio/ShortArrayBufferTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::nio::ShortArrayBufferTest );
 
+#include <decaf/internal/net/ResolverCacheTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::ResolverCacheTest );
 #include <decaf/internal/net/URIEncoderDecoderTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIEncoderDecoderTest );
 #include <decaf/internal/net/URIHelperTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIHelperTest );
+#include <decaf/internal/net/URIViewTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::internal::net::URIViewTest );
 
 #include <decaf/nio/BufferTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::nio::BufferTest );
@@ -214,12 +288,16 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::CountDownLatchTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::MutexTest );
 #include <decaf/util/concurrent/ThreadPoolExecutorTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ThreadPoolExecutorTest );
+#include <decaf/util/concurrent/WorkStealingExecutorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::WorkStealingExecutorTest );
 #include <decaf/util/concurrent/ExecutorsTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ExecutorsTest );
 #include <decaf/util/concurrent/TimeUnitTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::TimeUnitTest );
 #include <decaf/util/concurrent/LinkedBlockingQueueTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::LinkedBlockingQueueTest );
+#include <decaf/util/concurrent/MPMCArrayBlockingQueueTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::MPMCArrayBlockingQueueTest );
 #include <decaf/util/concurrent/SemaphoreTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::SemaphoreTest );
 #include <decaf/util/concurrent/FutureTaskTest.h>
@@ -228,6 +306,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::FutureTaskTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::AbstractExecutorServiceTest );
 #include <decaf/util/concurrent/ConcurrentHashMapTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ConcurrentHashMapTest );
+#include <decaf/util/concurrent/ConcurrentLRUCacheTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::ConcurrentLRUCacheTest );
 
 #include <decaf/util/concurrent/atomic/AtomicBooleanTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::concurrent::atomic::AtomicBooleanTest );
@@ -295,6 +375,11 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::TimerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::PriorityQueueTest );
 #include <decaf/util/LRUCacheTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::LRUCacheTest );
+#include <decaf/util/OpenHashMapTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::OpenHashMapTest );
+
+#include <decaf/util/logging/AsyncHandlerTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::logging::AsyncHandlerTest );
 
 #include <decaf/util/zip/DeflaterTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( decaf::util::zip::DeflaterTest );
@@ -322,6 +407,10 @@ CPPUNIT_TEST_SUITE_REGISTRATION( decaf::security::MessageDigestTest );
 // Marshaler Tests
 //
 
+#include <activemq/wireformat/openwire/marshal/MarshallerTableTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::MarshallerTableTest );
+#include <activemq/wireformat/openwire/utils/UnmarshalArenaTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::utils::UnmarshalArenaTest );
 #include <activemq/wireformat/openwire/marshal/generated/ActiveMQBlobMessageMarshallerTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( activemq::wireformat::openwire::marshal::generated::ActiveMQBlobMessageMarshallerTest );
 #include <activemq/wireformat/openwire/marshal/generated/ActiveMQBytesMessageMarshallerTest.h>